@@ -20,6 +20,7 @@ LOCAL_CPP_FEATURES := exceptions
 
 LOCAL_STATIC_LIBRARIES := libjsireact libjsi
 LOCAL_SHARED_LIBRARIES := libfolly_json libfb libreactnativejni libhermes
+LOCAL_LDLIBS := -lz
 
 include $(BUILD_SHARED_LIBRARY)
 
@@ -0,0 +1,86 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "CompactSampledTrace.h"
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <folly/Bits.h>
+#include <folly/Conv.h>
+#include <folly/json.h>
+
+namespace facebook {
+namespace jsi {
+namespace jni {
+
+namespace {
+
+constexpr uint32_t kCompactTraceMagic = 0x54505348; // "HSPT"
+constexpr uint32_t kCompactTraceVersion = 1;
+constexpr uint32_t kNoParent = 0xffffffff;
+
+template <typename T>
+void write(std::ofstream &file, T value) {
+  value = folly::Endian::little(value);
+  file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// Hermes writes most numbers of the trace as strings.
+template <typename T>
+T toInteger(const folly::dynamic &value) {
+  return value.isString() ? folly::to<T>(value.getString())
+                          : folly::to<T>(value.asInt());
+}
+
+} // namespace
+
+void writeCompactSampledTrace(
+    const std::string &chromeTracePath,
+    const std::string &outputPath) {
+  std::ifstream input(chromeTracePath);
+  if (!input) {
+    throw std::runtime_error("Could not read sampled trace " + chromeTracePath);
+  }
+  std::string json(
+      (std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+  folly::dynamic trace = folly::parseJson(json);
+  json.clear();
+
+  std::ofstream file(outputPath, std::ofstream::binary | std::ofstream::trunc);
+  write(file, kCompactTraceMagic);
+  write(file, kCompactTraceVersion);
+
+  const folly::dynamic *frames = trace.get_ptr("stackFrames");
+  write(file, static_cast<uint32_t>(frames ? frames->size() : 0));
+  if (frames) {
+    for (const auto &frame : frames->items()) {
+      write(file, toInteger<uint32_t>(frame.first));
+      const folly::dynamic *parent = frame.second.get_ptr("parent");
+      write(file, parent ? toInteger<uint32_t>(*parent) : kNoParent);
+      const folly::dynamic *name = frame.second.get_ptr("name");
+      const std::string nameString = name ? name->asString() : "";
+      write(file, static_cast<uint32_t>(nameString.size()));
+      file.write(nameString.data(), nameString.size());
+    }
+  }
+
+  const folly::dynamic *samples = trace.get_ptr("samples");
+  write(file, static_cast<uint32_t>(samples ? samples->size() : 0));
+  if (samples) {
+    for (const auto &sample : *samples) {
+      write(file, toInteger<uint64_t>(sample.getDefault("ts", 0)));
+      write(file, toInteger<uint32_t>(sample.getDefault("tid", 0)));
+      write(file, toInteger<uint32_t>(sample["sf"]));
+    }
+  }
+
+  if (!file) {
+    throw std::runtime_error("Could not write sampled trace " + outputPath);
+  }
+}
+
+} // namespace jni
+} // namespace jsi
+} // namespace facebook
@@ -0,0 +1,31 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#ifndef COMPACTSAMPLEDTRACE_H_
+#define COMPACTSAMPLEDTRACE_H_
+
+#include <string>
+
+namespace facebook {
+namespace jsi {
+namespace jni {
+
+/// Converts a sampled trace in the Chrome trace format, as dumped by the
+/// Hermes sampling profiler, into a compact binary format. All values are
+/// little-endian:
+///
+///   u32 magic ("HSPT"), u32 version,
+///   u32 frame count, per frame: u32 id, u32 parent id (0xffffffff for
+///     none), u32 name length, name (UTF-8),
+///   u32 sample count, per sample: u64 timestamp (microseconds), u32 thread
+///     id, u32 frame id.
+///
+/// Throws std::runtime_error if the trace can't be read or written.
+void writeCompactSampledTrace(
+    const std::string &chromeTracePath,
+    const std::string &outputPath);
+
+} // namespace jni
+} // namespace jsi
+} // namespace facebook
+
+#endif /* COMPACTSAMPLEDTRACE_H_ */
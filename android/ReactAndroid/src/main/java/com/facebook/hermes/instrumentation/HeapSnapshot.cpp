@@ -0,0 +1,205 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "HeapSnapshot.h"
+
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <ostream>
+#include <thread>
+
+#include <fb/log.h>
+
+namespace facebook {
+namespace jsi {
+namespace jni {
+
+namespace {
+
+// Adding 16 to the window bits makes zlib write a gzip header and trailer.
+constexpr int kGzipWindowBits = 15 + 16;
+constexpr int kMemLevel = 8;
+
+// A snapshot of a large heap can take a while, but a child which takes longer
+// than this is assumed to be stuck (e.g. on a lock held by a thread of the
+// parent which doesn't exist in the child).
+constexpr auto kChildTimeout = std::chrono::minutes(5);
+constexpr auto kChildPollInterval = std::chrono::milliseconds(100);
+
+bool writeCompressedHeapSnapshot(
+    Instrumentation &instrumentation,
+    const std::string &path) {
+  GzipFileStreamBuf buffer(path);
+  std::ostream os(&buffer);
+  return instrumentation.createSnapshotToStream(os, true) && os.flush() &&
+      buffer.close();
+}
+
+#ifndef NDEBUG
+// Reaps the child writing a snapshot and reports its outcome, on a thread of
+// its own.
+void waitForSnapshotChild(
+    pid_t pid,
+    std::string path,
+    HeapSnapshotCallback callback) {
+  std::thread([pid, path = std::move(path), callback = std::move(callback)] {
+    const auto deadline = std::chrono::steady_clock::now() + kChildTimeout;
+    int status = 0;
+    pid_t result;
+    bool isTimedOut = false;
+    while ((result = waitpid(pid, &status, WNOHANG)) == 0) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        FBLOGW("Heap snapshot %s timed out", path.c_str());
+        kill(pid, SIGKILL);
+        waitpid(pid, &status, 0);
+        isTimedOut = true;
+        break;
+      }
+      std::this_thread::sleep_for(kChildPollInterval);
+    }
+    const bool success = !isTimedOut && result == pid && WIFEXITED(status) &&
+        WEXITSTATUS(status) == 0;
+    if (success) {
+      FBLOGI("Heap snapshot written to %s", path.c_str());
+    } else if (!isTimedOut) {
+      FBLOGW("Could not write heap snapshot %s", path.c_str());
+    }
+    callback(success);
+  }).detach();
+}
+#endif
+
+} // namespace
+
+GzipFileStreamBuf::GzipFileStreamBuf(std::string path)
+    : path_(std::move(path)), temporaryPath_(path_ + ".XXXXXX") {
+  const int fd = mkstemp(&temporaryPath_[0]);
+  if (fd >= 0) {
+    file_ = fdopen(fd, "wb");
+    if (!file_) {
+      ::close(fd);
+      std::remove(temporaryPath_.c_str());
+    }
+  }
+  isStreamInitialized_ = file_ &&
+      deflateInit2(
+          &stream_,
+          Z_DEFAULT_COMPRESSION,
+          Z_DEFLATED,
+          kGzipWindowBits,
+          kMemLevel,
+          Z_DEFAULT_STRATEGY) == Z_OK;
+  hasFailed_ = !isStreamInitialized_;
+  setp(input_.data(), input_.data() + input_.size());
+}
+
+GzipFileStreamBuf::~GzipFileStreamBuf() {
+  if (file_) {
+    discard();
+  }
+}
+
+GzipFileStreamBuf::int_type GzipFileStreamBuf::overflow(int_type ch) {
+  if (!deflateInput(Z_NO_FLUSH)) {
+    return traits_type::eof();
+  }
+  if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+bool GzipFileStreamBuf::deflateInput(int flush) {
+  if (hasFailed_) {
+    return false;
+  }
+  stream_.next_in = reinterpret_cast<Bytef *>(pbase());
+  stream_.avail_in = static_cast<uInt>(pptr() - pbase());
+  int result;
+  do {
+    stream_.next_out = output_.data();
+    stream_.avail_out = static_cast<uInt>(output_.size());
+    result = deflate(&stream_, flush);
+    const size_t size = output_.size() - stream_.avail_out;
+    if (result == Z_STREAM_ERROR ||
+        std::fwrite(output_.data(), 1, size, file_) != size) {
+      hasFailed_ = true;
+      return false;
+    }
+  } while (stream_.avail_out == 0 ||
+           (flush == Z_FINISH && result != Z_STREAM_END));
+  setp(input_.data(), input_.data() + input_.size());
+  return true;
+}
+
+bool GzipFileStreamBuf::close() {
+  if (!file_) {
+    return false;
+  }
+  if (!deflateInput(Z_FINISH) || std::fflush(file_) != 0) {
+    discard();
+    return false;
+  }
+  deflateEnd(&stream_);
+  isStreamInitialized_ = false;
+  const bool isClosed = std::fclose(file_) == 0;
+  file_ = nullptr;
+  if (!isClosed || std::rename(temporaryPath_.c_str(), path_.c_str()) != 0) {
+    std::remove(temporaryPath_.c_str());
+    return false;
+  }
+  return true;
+}
+
+void GzipFileStreamBuf::discard() {
+  if (isStreamInitialized_) {
+    deflateEnd(&stream_);
+    isStreamInitialized_ = false;
+  }
+  std::fclose(file_);
+  file_ = nullptr;
+  std::remove(temporaryPath_.c_str());
+  hasFailed_ = true;
+}
+
+bool createCompressedHeapSnapshot(
+    Instrumentation &instrumentation,
+    const std::string &path) {
+  return writeCompressedHeapSnapshot(instrumentation, path);
+}
+
+void createCompressedHeapSnapshotInForkedProcess(
+    Instrumentation &instrumentation,
+    const std::string &path,
+    HeapSnapshotCallback callback) {
+#ifndef NDEBUG
+  const pid_t pid = fork();
+  if (pid == 0) {
+    // Only this thread exists in the child, and the heap can't change under
+    // it. Exit without running any of the parent's exit handlers.
+    _exit(writeCompressedHeapSnapshot(instrumentation, path) ? 0 : 1);
+  }
+  if (pid > 0) {
+    waitForSnapshotChild(pid, path, std::move(callback));
+    return;
+  }
+  FBLOGW("Could not fork for heap snapshot, writing it in process");
+#endif
+  callback(writeCompressedHeapSnapshot(instrumentation, path));
+}
+
+bool stopHeapSamplingToCompressedFile(
+    Instrumentation &instrumentation,
+    const std::string &path) {
+  GzipFileStreamBuf buffer(path);
+  std::ostream os(&buffer);
+  return instrumentation.stopHeapSampling(os) && os.flush() && buffer.close();
+}
+
+} // namespace jni
+} // namespace jsi
+} // namespace facebook
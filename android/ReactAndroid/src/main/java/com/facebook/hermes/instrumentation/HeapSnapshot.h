@@ -0,0 +1,92 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#ifndef HEAPSNAPSHOT_H_
+#define HEAPSNAPSHOT_H_
+
+#include <array>
+#include <cstdio>
+#include <functional>
+#include <streambuf>
+#include <string>
+
+#include <jsi/instrumentation.h>
+#include <zlib.h>
+
+namespace facebook {
+namespace jsi {
+namespace jni {
+
+/// A stream buffer which gzip-compresses everything written through it into
+/// a file, in chunks, so neither the uncompressed nor the compressed output is
+/// ever held in memory. It writes to a temporary file of its own next to path,
+/// which close() renames to path, so path never exists half-written and
+/// concurrent writers of the same path don't clobber each other's output.
+class GzipFileStreamBuf : public std::streambuf {
+ public:
+  explicit GzipFileStreamBuf(std::string path);
+  /// Discards the file if close() wasn't called.
+  ~GzipFileStreamBuf() override;
+
+  GzipFileStreamBuf(const GzipFileStreamBuf &) = delete;
+  GzipFileStreamBuf &operator=(const GzipFileStreamBuf &) = delete;
+
+  /// Finishes the file. Returns whether everything was written.
+  bool close();
+
+ protected:
+  int_type overflow(int_type ch) override;
+
+ private:
+  bool deflateInput(int flush);
+  void discard();
+
+  const std::string path_;
+  std::string temporaryPath_;
+  FILE *file_{nullptr};
+  z_stream stream_{};
+  bool isStreamInitialized_{false};
+  bool hasFailed_{false};
+  std::array<char, 64 * 1024> input_;
+  std::array<unsigned char, 64 * 1024> output_;
+};
+
+/// Writes a compact heap snapshot of the runtime, gzip-compressed, to path.
+/// The snapshot must see a consistent heap, so JS is frozen while it is
+/// written.
+///
+/// Must be called on the JS thread. Returns whether the snapshot was written.
+bool createCompressedHeapSnapshot(
+    Instrumentation &instrumentation,
+    const std::string &path);
+
+/// Called with whether the snapshot was written, once path is complete.
+using HeapSnapshotCallback = std::function<void(bool success)>;
+
+/// UNSAFE, for debugging only: like createCompressedHeapSnapshot, but the
+/// process is forked on the JS thread, which only freezes JS for the duration
+/// of the fork, and the child process writes the snapshot of its
+/// copy-on-write copy of the heap while JS carries on. Only the forking thread
+/// exists in the child, so the snapshot deadlocks if it needs a lock another
+/// thread held at the time of the fork (the child is then killed after a
+/// timeout), and the pages JS writes to meanwhile are duplicated in memory.
+///
+/// callback is called on a thread of its own once the child exits. In builds
+/// with NDEBUG, or if the fork fails, the snapshot is written in this process
+/// and callback is called before this returns.
+void createCompressedHeapSnapshotInForkedProcess(
+    Instrumentation &instrumentation,
+    const std::string &path,
+    HeapSnapshotCallback callback);
+
+/// Stops heap sampling and writes the sampled allocations, gzip-compressed,
+/// to path. Returns false if heap sampling isn't supported or running, or if
+/// the profile could not be written.
+bool stopHeapSamplingToCompressedFile(
+    Instrumentation &instrumentation,
+    const std::string &path);
+
+} // namespace jni
+} // namespace jsi
+} // namespace facebook
+
+#endif /* HEAPSNAPSHOT_H_ */
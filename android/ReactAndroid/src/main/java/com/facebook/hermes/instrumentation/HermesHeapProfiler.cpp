@@ -0,0 +1,89 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "HermesHeapProfiler.h"
+
+#include <stdexcept>
+
+#include <jsi/instrumentation.h>
+
+#include "HeapSnapshot.h"
+
+namespace facebook {
+namespace jsi {
+namespace jni {
+
+namespace {
+
+jsi::Instrumentation &instrumentationOf(jlong jsContext) {
+  return reinterpret_cast<jsi::Runtime *>(jsContext)->instrumentation();
+}
+
+} // namespace
+
+void JHeapSnapshotCallback::onHeapSnapshotFinished(bool success) const {
+  static auto method =
+      javaClassStatic()->getMethod<void(jboolean)>("onHeapSnapshotFinished");
+  method(self(), success);
+}
+
+jboolean HermesHeapProfiler::createHeapSnapshot(
+    jni::alias_ref<jclass>,
+    jlong jsContext,
+    std::string filename) {
+  return createCompressedHeapSnapshot(instrumentationOf(jsContext), filename);
+}
+
+void HermesHeapProfiler::createHeapSnapshotInForkedProcess(
+    jni::alias_ref<jclass>,
+    jlong jsContext,
+    std::string filename,
+    jni::alias_ref<JHeapSnapshotCallback::javaobject> callback) {
+  auto globalCallback = jni::make_global(callback);
+  createCompressedHeapSnapshotInForkedProcess(
+      instrumentationOf(jsContext),
+      filename,
+      [globalCallback](bool success) mutable {
+        // Possibly on a thread which isn't attached to the VM yet. The
+        // reference is dropped while attached.
+        jni::ThreadScope::WithClassLoader([&] {
+          globalCallback->onHeapSnapshotFinished(success);
+          globalCallback.reset();
+        });
+      });
+}
+
+jboolean HermesHeapProfiler::startHeapSampling(
+    jni::alias_ref<jclass>,
+    jlong jsContext,
+    jlong samplingInterval) {
+  if (samplingInterval <= 0) {
+    throw std::invalid_argument("Heap sampling needs a positive interval");
+  }
+  return instrumentationOf(jsContext).startHeapSampling(
+      static_cast<size_t>(samplingInterval));
+}
+
+jboolean HermesHeapProfiler::stopHeapSampling(
+    jni::alias_ref<jclass>,
+    jlong jsContext,
+    std::string filename) {
+  return stopHeapSamplingToCompressedFile(
+      instrumentationOf(jsContext), filename);
+}
+
+void HermesHeapProfiler::registerNatives() {
+  javaClassLocal()->registerNatives({
+      makeNativeMethod(
+          "createHeapSnapshot", HermesHeapProfiler::createHeapSnapshot),
+      makeNativeMethod(
+          "createHeapSnapshotInForkedProcess",
+          HermesHeapProfiler::createHeapSnapshotInForkedProcess),
+      makeNativeMethod(
+          "startHeapSampling", HermesHeapProfiler::startHeapSampling),
+      makeNativeMethod("stopHeapSampling", HermesHeapProfiler::stopHeapSampling),
+  });
+}
+
+} // namespace jni
+} // namespace jsi
+} // namespace facebook
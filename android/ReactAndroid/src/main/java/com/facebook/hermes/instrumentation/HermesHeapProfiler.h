@@ -0,0 +1,55 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#ifndef HERMESHEAPPROFILER_H_
+#define HERMESHEAPPROFILER_H_
+
+#include <fb/fbjni.h>
+#include <jni/Registration.h>
+#include <jsi/jsi.h>
+
+namespace facebook {
+namespace jsi {
+namespace jni {
+
+namespace jni = ::facebook::jni;
+
+class JHeapSnapshotCallback : public jni::JavaClass<JHeapSnapshotCallback> {
+ public:
+  constexpr static auto kJavaDescriptor =
+      "Lcom/facebook/hermes/instrumentation/HermesHeapProfiler$HeapSnapshotCallback;";
+  void onHeapSnapshotFinished(bool success) const;
+};
+
+class HermesHeapProfiler : public jni::JavaClass<HermesHeapProfiler> {
+ public:
+  constexpr static auto kJavaDescriptor =
+      "Lcom/facebook/hermes/instrumentation/HermesHeapProfiler;";
+  static jboolean createHeapSnapshot(
+      jni::alias_ref<jclass>,
+      jlong jsContext,
+      std::string filename);
+  static void createHeapSnapshotInForkedProcess(
+      jni::alias_ref<jclass>,
+      jlong jsContext,
+      std::string filename,
+      jni::alias_ref<JHeapSnapshotCallback::javaobject> callback);
+  static jboolean startHeapSampling(
+      jni::alias_ref<jclass>,
+      jlong jsContext,
+      jlong samplingInterval);
+  static jboolean stopHeapSampling(
+      jni::alias_ref<jclass>,
+      jlong jsContext,
+      std::string filename);
+
+  static void registerNatives();
+
+ private:
+  HermesHeapProfiler();
+};
+
+} // namespace jni
+} // namespace jsi
+} // namespace facebook
+
+#endif /* HERMESHEAPPROFILER_H_ */
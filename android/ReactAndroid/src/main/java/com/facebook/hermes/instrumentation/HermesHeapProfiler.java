@@ -0,0 +1,65 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+package com.facebook.hermes.instrumentation;
+
+import com.facebook.proguard.annotations.DoNotStrip;
+import com.facebook.soloader.SoLoader;
+
+/**
+ * Hermes heap profiler static JSI API. All of its methods must be called on the JS thread, with
+ * the value of {@code CatalystInstance.getJavaScriptContextHolder().get()} of a Hermes instance as
+ * {@code jsContext}. The files it writes are gzip-compressed.
+ */
+public class HermesHeapProfiler {
+  static {
+    SoLoader.loadLibrary("jsijniprofiler");
+  }
+
+  /** Called once the file of {@link #createHeapSnapshotInForkedProcess} is complete. */
+  @DoNotStrip
+  public interface HeapSnapshotCallback {
+    /** @param success whether the snapshot was written. */
+    @DoNotStrip
+    void onHeapSnapshotFinished(boolean success);
+  }
+
+  /**
+   * Write a heap snapshot to file. Since the snapshot must see a consistent heap, JS is frozen
+   * while it is written. The file only appears once it is complete.
+   *
+   * @return whether the snapshot was written.
+   */
+  public static native boolean createHeapSnapshot(long jsContext, String filename);
+
+  /**
+   * UNSAFE, for debugging only. Like {@link #createHeapSnapshot}, but the process is forked,
+   * which only freezes JS for the duration of the fork, and the child process writes the
+   * snapshot. Only the JS thread exists in the child, so it can deadlock on a lock held by
+   * another thread at the time of the fork (it is then killed after a few minutes), and it
+   * duplicates every page the app writes to meanwhile.
+   *
+   * <p>{@code callback} is called on a background thread once the child exits. In release builds
+   * of the native code, or if forking fails, the snapshot is written like {@link
+   * #createHeapSnapshot} does, and {@code callback} is called before this returns.
+   */
+  public static native void createHeapSnapshotInForkedProcess(
+      long jsContext, String filename, HeapSnapshotCallback callback);
+
+  /**
+   * Start recording a sample of the allocations with the JS stack trace which made them, about
+   * one allocation every {@code samplingInterval} bytes. This is cheap enough for telemetry.
+   *
+   * @return whether the runtime supports heap sampling.
+   */
+  public static native boolean startHeapSampling(long jsContext, long samplingInterval);
+
+  /**
+   * Stop heap sampling, and write the sampled allocations which are still alive to file, as a
+   * Chrome heap profile.
+   *
+   * @return whether heap sampling was running and the profile was written.
+   */
+  public static native boolean stopHeapSampling(long jsContext, String filename);
+
+  private HermesHeapProfiler() {}
+}
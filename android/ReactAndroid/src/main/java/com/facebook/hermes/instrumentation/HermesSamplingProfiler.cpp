@@ -2,12 +2,101 @@
 
 #include "HermesSamplingProfiler.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <fb/log.h>
+#include <folly/Conv.h>
 #include <hermes/hermes.h>
+#include <jsi/instrumentation.h>
+
+#include "CompactSampledTrace.h"
 
 namespace facebook {
 namespace jsi {
 namespace jni {
 
+namespace {
+
+/// Samples for sampleWindow out of every period, and dumps the samples of
+/// each window into the next of maxChunkCount files in directory, named
+/// sampled-trace-<n>.hspt, overwriting the oldest one. Hermes only keeps the
+/// samples of one window in memory, since it drops them when dumping them.
+class ContinuousSampler {
+ public:
+  ContinuousSampler(
+      std::string directory,
+      std::chrono::milliseconds period,
+      std::chrono::milliseconds sampleWindow,
+      unsigned maxChunkCount)
+      : directory_(std::move(directory)),
+        period_(period),
+        sampleWindow_(std::min(sampleWindow, period)),
+        maxChunkCount_(std::max(maxChunkCount, 1u)),
+        thread_([this] { run(); }) {}
+
+  ~ContinuousSampler() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      isStopped_ = true;
+    }
+    condition_.notify_all();
+    thread_.join();
+  }
+
+ private:
+  // Returns false if the sampler was stopped while waiting.
+  bool waitFor(std::chrono::milliseconds duration) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return !condition_.wait_for(lock, duration, [this] { return isStopped_; });
+  }
+
+  void run() {
+    for (unsigned chunk = 0;; chunk = (chunk + 1) % maxChunkCount_) {
+      hermes::HermesRuntime::enableSamplingProfiler();
+      bool isRunning = waitFor(sampleWindow_);
+      hermes::HermesRuntime::disableSamplingProfiler();
+      dumpChunk(chunk);
+      if (!isRunning || !waitFor(period_ - sampleWindow_)) {
+        return;
+      }
+    }
+  }
+
+  void dumpChunk(unsigned chunk) {
+    const auto chunkPath =
+        folly::to<std::string>(directory_, "/sampled-trace-", chunk, ".hspt");
+    const auto chromeTracePath = chunkPath + ".json";
+    try {
+      hermes::HermesRuntime::dumpSampledTraceToFile(chromeTracePath);
+      writeCompactSampledTrace(chromeTracePath, chunkPath);
+    } catch (const std::exception &e) {
+      FBLOGW("Could not dump sampled trace: %s", e.what());
+    }
+    std::remove(chromeTracePath.c_str());
+  }
+
+  const std::string directory_;
+  const std::chrono::milliseconds period_;
+  const std::chrono::milliseconds sampleWindow_;
+  const unsigned maxChunkCount_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool isStopped_{false};
+  std::thread thread_;
+};
+
+std::mutex continuousSamplerMutex;
+std::unique_ptr<ContinuousSampler> continuousSampler;
+
+} // namespace
+
 void HermesSamplingProfiler::enable(jni::alias_ref<jclass>) {
   hermes::HermesRuntime::enableSamplingProfiler();
 }
@@ -22,13 +111,53 @@ void HermesSamplingProfiler::dumpSampledTraceToFile(
   hermes::HermesRuntime::dumpSampledTraceToFile(filename);
 }
 
+void HermesSamplingProfiler::enableContinuous(
+    jni::alias_ref<jclass>,
+    std::string directory,
+    jint periodMs,
+    jint sampleWindowMs,
+    jint maxChunkCount) {
+  if (periodMs <= 0 || sampleWindowMs <= 0 || maxChunkCount <= 0) {
+    throw std::invalid_argument(
+        "Continuous sampling needs a positive period, window and chunk count");
+  }
+  std::lock_guard<std::mutex> lock(continuousSamplerMutex);
+  // Stops the previous sampler first.
+  continuousSampler.reset();
+  continuousSampler = std::make_unique<ContinuousSampler>(
+      std::move(directory),
+      std::chrono::milliseconds(periodMs),
+      std::chrono::milliseconds(sampleWindowMs),
+      static_cast<unsigned>(maxChunkCount));
+}
+
+void HermesSamplingProfiler::disableContinuous(jni::alias_ref<jclass>) {
+  std::lock_guard<std::mutex> lock(continuousSamplerMutex);
+  continuousSampler.reset();
+}
+
+void HermesSamplingProfiler::dumpProfilerSymbolsToFile(
+    jni::alias_ref<jclass>,
+    jlong jsContext,
+    std::string filename) {
+  auto runtime = reinterpret_cast<jsi::Runtime *>(jsContext);
+  runtime->instrumentation().dumpProfilerSymbolsToFile(filename);
+}
+
 void HermesSamplingProfiler::registerNatives() {
   javaClassLocal()->registerNatives({
       makeNativeMethod("enable", HermesSamplingProfiler::enable),
-      makeNativeMethod("disable", HermesSamplingProfiler::enable),
+      makeNativeMethod("disable", HermesSamplingProfiler::disable),
       makeNativeMethod(
           "dumpSampledTraceToFile",
           HermesSamplingProfiler::dumpSampledTraceToFile),
+      makeNativeMethod(
+          "enableContinuous", HermesSamplingProfiler::enableContinuous),
+      makeNativeMethod(
+          "disableContinuous", HermesSamplingProfiler::disableContinuous),
+      makeNativeMethod(
+          "dumpProfilerSymbolsToFile",
+          HermesSamplingProfiler::dumpProfilerSymbolsToFile),
   });
 }
 
@@ -22,6 +22,17 @@ class HermesSamplingProfiler : public jni::JavaClass<HermesSamplingProfiler> {
   static void dumpSampledTraceToFile(
       jni::alias_ref<jclass>,
       std::string filename);
+  static void enableContinuous(
+      jni::alias_ref<jclass>,
+      std::string directory,
+      jint periodMs,
+      jint sampleWindowMs,
+      jint maxChunkCount);
+  static void disableContinuous(jni::alias_ref<jclass>);
+  static void dumpProfilerSymbolsToFile(
+      jni::alias_ref<jclass>,
+      jlong jsContext,
+      std::string filename);
 
   static void registerNatives();
 
@@ -23,5 +23,29 @@ public class HermesSamplingProfiler {
    */
   public static native void dumpSampledTraceToFile(String filename);
 
+  /**
+   * Start sampling continuously at a low rate, with bounded memory and disk use: samples are
+   * only taken for {@code sampleWindowMs} out of every {@code periodMs}, and the samples of each
+   * window are written to the next of {@code maxChunkCount} files named {@code
+   * sampled-trace-<n>.hspt} in {@code directory}, replacing the oldest one. See
+   * CompactSampledTrace.h for their format. Don't call {@link #enable} or {@link #disable} while
+   * sampling continuously.
+   */
+  public static native void enableContinuous(
+      String directory, int periodMs, int sampleWindowMs, int maxChunkCount);
+
+  /** Stop sampling continuously, after writing the current window. */
+  public static native void disableContinuous();
+
+  /**
+   * Dump the symbols of JIT-compiled and native code, which symbolicating profiles needs.
+   * Must be called on the JS thread.
+   *
+   * @param jsContext the value of {@code
+   *     CatalystInstance.getJavaScriptContextHolder().get()} of a Hermes instance.
+   * @param filename the file to dump the symbols to.
+   */
+  public static native void dumpProfilerSymbolsToFile(long jsContext, String filename);
+
   private HermesSamplingProfiler() {}
 }
@@ -1,9 +1,11 @@
 // Copyright 2004-present Facebook. All Rights Reserved.
 
+#include "HermesHeapProfiler.h"
 #include "HermesSamplingProfiler.h"
 
 JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
   return facebook::jni::initialize(vm, [] {
     facebook::jsi::jni::HermesSamplingProfiler::registerNatives();
+    facebook::jsi::jni::HermesHeapProfiler::registerNatives();
   });
 }
@@ -60,6 +60,11 @@ class HermesExecutorRuntimeAdapter
     });
   }
 
+  bool runOnJSThread(std::function<void()> func) override {
+    thread_->runOnQueue(std::move(func));
+    return true;
+  }
+
  private:
   std::shared_ptr<Runtime> runtime_;
   HermesRuntime &hermesRuntime_;
@@ -69,6 +74,26 @@ class HermesExecutorRuntimeAdapter
 
 #endif
 
+void installHostCallStats(
+    Runtime &runtime,
+    std::shared_ptr<HostCallStatsCollector> collector) {
+  runtime.global().setProperty(
+      runtime,
+      "__hostCallStats",
+      Function::createFromHostFunction(
+          runtime,
+          PropNameID::forAscii(runtime, "__hostCallStats"),
+          1,
+          [collector = std::move(collector)](
+              Runtime &rt, const Value &, const Value *args, size_t count) {
+            auto json = collector->toJSON();
+            if (count > 0 && args[0].isBool() && args[0].getBool()) {
+              collector->reset();
+            }
+            return String::createFromUtf8(rt, json);
+          }));
+}
+
 struct ReentrancyCheck {
 // This is effectively a very subtle and complex assert, so only
 // include it in builds which would include asserts.
@@ -147,17 +172,24 @@ class DecoratedRuntime : public jsi::WithRuntimeDecorator<ReentrancyCheck> {
   DecoratedRuntime(
       std::unique_ptr<Runtime> runtime,
       HermesRuntime &hermesRuntime,
-      std::shared_ptr<MessageQueueThread> jsQueue)
+      std::shared_ptr<MessageQueueThread> jsQueue,
+      const std::string &profilerTraceDirectory)
       : jsi::WithRuntimeDecorator<ReentrancyCheck>(*runtime, reentrancyCheck_),
         runtime_(std::move(runtime)),
         hermesRuntime_(hermesRuntime) {
 #ifdef HERMES_ENABLE_DEBUGGER
     auto adapter = std::make_unique<HermesExecutorRuntimeAdapter>(
         runtime_, hermesRuntime_, jsQueue);
-    facebook::hermes::inspector::chrome::enableDebugging(
-        std::move(adapter), "Hermes React Native");
+    if (profilerTraceDirectory.empty()) {
+      facebook::hermes::inspector::chrome::enableDebugging(
+          std::move(adapter), "Hermes React Native");
+    } else {
+      facebook::hermes::inspector::chrome::enableProfiling(
+          std::move(adapter), "Hermes React Native", profilerTraceDirectory);
+    }
 #else
     (void)hermesRuntime_;
+    (void)profilerTraceDirectory;
 #endif
   }
 
@@ -183,19 +215,31 @@ class DecoratedRuntime : public jsi::WithRuntimeDecorator<ReentrancyCheck> {
 
 } // namespace
 
+JSIWorker::RuntimeFactory HermesExecutorFactory::workerRuntimeFactory() const {
+  auto runtimeConfig = runtimeConfig_;
+  return [runtimeConfig]() -> std::unique_ptr<Runtime> {
+    return makeHermesRuntimeSystraced(runtimeConfig);
+  };
+}
+
 std::unique_ptr<JSExecutor> HermesExecutorFactory::createJSExecutor(
     std::shared_ptr<ExecutorDelegate> delegate,
     std::shared_ptr<MessageQueueThread> jsQueue) {
   std::unique_ptr<HermesRuntime> hermesRuntime =
       makeHermesRuntimeSystraced(runtimeConfig_);
   HermesRuntime& hermesRuntimeRef = *hermesRuntime;
+  std::unique_ptr<Runtime> runtime =
+      makeTracingHermesRuntime(std::move(hermesRuntime), runtimeConfig_);
+  if (hostCallStatsCollector_) {
+    runtime = std::make_unique<HostCallTracingRuntime>(
+        std::move(runtime), hostCallStatsCollector_);
+  }
   auto decoratedRuntime = std::make_shared<DecoratedRuntime>(
-      makeTracingHermesRuntime(std::move(hermesRuntime), runtimeConfig_),
-      hermesRuntimeRef,
-      jsQueue);
+      std::move(runtime), hermesRuntimeRef, jsQueue, profilerTraceDirectory_);
 
   // So what do we have now?
-  // DecoratedRuntime -> TracingRuntime -> HermesRuntime
+  // DecoratedRuntime -> [HostCallTracingRuntime ->] TracingRuntime ->
+  // HermesRuntime
   //
   // DecoratedRuntime is held by JSIExecutor.  When it gets used, it
   // will check that it's on the right thread, do any necessary trace
@@ -212,6 +256,10 @@ std::unique_ptr<JSExecutor> HermesExecutorFactory::createJSExecutor(
           .getPropertyAsObject(*decoratedRuntime, "prototype");
   errorPrototype.setProperty(*decoratedRuntime, "jsEngine", "hermes");
 
+  if (hostCallStatsCollector_) {
+    installHostCallStats(*decoratedRuntime, hostCallStatsCollector_);
+  }
+
   return std::make_unique<HermesExecutor>(
       decoratedRuntime, delegate, jsQueue, timeoutInvoker_, runtimeInstaller_);
 }
@@ -3,7 +3,9 @@
 #pragma once
 
 #include <hermes/hermes.h>
+#include <jsi/hostcalltracing.h>
 #include <jsireact/JSIExecutor.h>
+#include <jsireact/JSIWorker.h>
 #include <functional>
 #include <utility>
 
@@ -23,6 +25,29 @@ class HermesExecutorFactory : public JSExecutorFactory {
     assert(timeoutInvoker_ && "Should not have empty timeoutInvoker");
   }
 
+  // Records the time spent in every host function and host object of the
+  // runtimes created afterwards (TurboModules, UIManagerBinding, ...) in
+  // the collector. JS can read the stats as JSON by calling
+  // __hostCallStats(), or __hostCallStats(true) to also reset them.
+  void setHostCallStatsCollector(
+      std::shared_ptr<jsi::HostCallStatsCollector> collector) {
+    hostCallStatsCollector_ = std::move(collector);
+  }
+
+  // In builds with the debugger, attaches the inspector to the runtimes
+  // created afterwards in profiler-only mode: the debugger and its hooks are
+  // never installed, so only the sampling profiler and heap statistics are
+  // served, and timings aren't skewed by them. Sampled traces are dumped to
+  // traceDirectory while they're sent to the client. An empty directory
+  // attaches the full debugger again.
+  void setProfilerOnlyInspector(std::string traceDirectory) {
+    profilerTraceDirectory_ = std::move(traceDirectory);
+  }
+
+  // Makes the runtimes of JSIWorkers, with the same config as the executors'
+  // runtimes but without the inspector, tracing or thread checks.
+  JSIWorker::RuntimeFactory workerRuntimeFactory() const;
+
   std::unique_ptr<JSExecutor> createJSExecutor(
       std::shared_ptr<ExecutorDelegate> delegate,
       std::shared_ptr<MessageQueueThread> jsQueue) override;
@@ -31,6 +56,8 @@ class HermesExecutorFactory : public JSExecutorFactory {
   JSIExecutor::RuntimeInstaller runtimeInstaller_;
   JSIScopedTimeoutInvoker timeoutInvoker_;
   ::hermes::vm::RuntimeConfig runtimeConfig_;
+  std::shared_ptr<jsi::HostCallStatsCollector> hostCallStatsCollector_;
+  std::string profilerTraceDirectory_;
 };
 
 class HermesExecutor : public JSIExecutor {
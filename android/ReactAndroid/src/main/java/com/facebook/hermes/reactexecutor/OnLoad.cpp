@@ -87,8 +87,8 @@ static ::hermes::vm::RuntimeConfig makeRuntimeConfig(
 static void installBindings(jsi::Runtime &runtime) {
   react::Logger androidLogger =
       static_cast<void (*)(const std::string &, unsigned int)>(
-          &reactAndroidLoggingHook);
-  react::bindNativeLogger(runtime, androidLogger);
+          &reactAndroidAsyncLoggingHook);
+  react::bindNativeLogger(runtime, androidLogger, &reactAndroidShouldLog);
 }
 
 class HermesExecutorHolder
@@ -0,0 +1,381 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * <p>This source code is licensed under the MIT license found in the LICENSE file in the root
+ * directory of this source tree.
+ */
+package com.facebook.react.bridge;
+
+import com.facebook.proguard.annotations.DoNotStrip;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.Charset;
+import java.util.Arrays;
+
+/**
+ * Reads a {@link ReadableNativeMap} or {@link ReadableNativeArray} with a single JNI call, instead
+ * of one per key and value: native code serializes the whole value into a flat buffer (see
+ * FlatDynamic.h for its layout), which is then parsed in Java. This is much faster for large
+ * values, like JSON API responses.
+ *
+ * <p>{@link Builder} does the reverse, for building large results (like query results) for JS
+ * without a JNI call per put.
+ */
+@DoNotStrip
+public final class FlatDynamic {
+  static {
+    ReactBridge.staticInit();
+  }
+
+  private static final Charset UTF_8 = Charset.forName("UTF-8");
+
+  private static final byte TYPE_NULL = 0;
+  private static final byte TYPE_FALSE = 1;
+  private static final byte TYPE_TRUE = 2;
+  private static final byte TYPE_NUMBER = 3;
+  private static final byte TYPE_STRING = 4;
+  private static final byte TYPE_ARRAY = 5;
+  private static final byte TYPE_MAP = 6;
+
+  /** Copies the contents of a native map into a {@link JavaOnlyMap}. */
+  public static JavaOnlyMap toJavaOnlyMap(ReadableNativeMap map) {
+    return readMap(serializeMap(map));
+  }
+
+  /** Copies the contents of a native array into a {@link JavaOnlyArray}. */
+  public static JavaOnlyArray toJavaOnlyArray(ReadableNativeArray array) {
+    return readArray(serializeArray(array));
+  }
+
+  /** Reads a serialized map, e.g. one returned by {@link #serializeMap}. */
+  public static JavaOnlyMap readMap(ByteBuffer buffer) {
+    Reader reader = new Reader(buffer);
+    reader.expectType(TYPE_MAP);
+    return reader.readMapContents();
+  }
+
+  /** Reads a serialized array, e.g. one returned by {@link #serializeArray}. */
+  public static JavaOnlyArray readArray(ByteBuffer buffer) {
+    Reader reader = new Reader(buffer);
+    reader.expectType(TYPE_ARRAY);
+    return reader.readArrayContents();
+  }
+
+  /** Serializes a native map into a new direct buffer. */
+  public static native ByteBuffer serializeMap(NativeMap map);
+
+  /** Serializes a native array into a new direct buffer. */
+  public static native ByteBuffer serializeArray(NativeArray array);
+
+  /** Makes a native map from the first size bytes of a direct buffer holding a serialized map. */
+  public static native WritableNativeMap deserializeMap(ByteBuffer buffer, int size);
+
+  /**
+   * Makes a native array from the first size bytes of a direct buffer holding a serialized array.
+   */
+  public static native WritableNativeArray deserializeArray(ByteBuffer buffer, int size);
+
+  /**
+   * Builds a {@link WritableNativeMap} or {@link WritableNativeArray} in Java and hands it to
+   * native code in a single JNI call. Values are added in order, with maps and arrays opened and
+   * closed around their contents, e.g. for an array of rows:
+   *
+   * <pre>
+   * FlatDynamic.Builder builder = new FlatDynamic.Builder().beginArray();
+   * for (Row row : rows) {
+   *   builder.beginMap().key("id").value(row.id).key("name").value(row.name).endMap();
+   * }
+   * WritableNativeArray result = builder.endArray().buildArray();
+   * </pre>
+   *
+   * A builder is not thread safe, and can be reused after {@link #reset}.
+   */
+  public static final class Builder {
+    private ByteBuffer mBuffer;
+    // The position of the count of each open map or array, and its count so far.
+    private int[] mOpenPositions = new int[8];
+    private int[] mOpenCounts = new int[8];
+    private boolean[] mOpenIsMap = new boolean[8];
+    private int mDepth;
+    private boolean mHasKey;
+    private boolean mIsDone;
+
+    public Builder() {
+      this(4096);
+    }
+
+    public Builder(int initialCapacity) {
+      mBuffer =
+          ByteBuffer.allocateDirect(Math.max(initialCapacity, 16)).order(ByteOrder.LITTLE_ENDIAN);
+    }
+
+    /** Discards everything added, keeping the buffer. */
+    public Builder reset() {
+      mBuffer.clear();
+      mDepth = 0;
+      mHasKey = false;
+      mIsDone = false;
+      return this;
+    }
+
+    /** Sets the key of the next value in the innermost map. */
+    public Builder key(String key) {
+      if (mDepth == 0 || !mOpenIsMap[mDepth - 1] || mHasKey) {
+        throw new IllegalStateException("A key is only expected before a value in a map");
+      }
+      putString(key);
+      mHasKey = true;
+      return this;
+    }
+
+    public Builder nullValue() {
+      beginValue(TYPE_NULL);
+      return this;
+    }
+
+    public Builder value(boolean value) {
+      beginValue(value ? TYPE_TRUE : TYPE_FALSE);
+      return this;
+    }
+
+    public Builder value(double value) {
+      beginValue(TYPE_NUMBER);
+      ensureCapacity(8);
+      mBuffer.putDouble(value);
+      return this;
+    }
+
+    /** Adds a string, or null if value is null. */
+    public Builder value(String value) {
+      if (value == null) {
+        return nullValue();
+      }
+      beginValue(TYPE_STRING);
+      putString(value);
+      return this;
+    }
+
+    public Builder beginMap() {
+      beginContainer(TYPE_MAP);
+      return this;
+    }
+
+    public Builder endMap() {
+      endContainer(true);
+      return this;
+    }
+
+    public Builder beginArray() {
+      beginContainer(TYPE_ARRAY);
+      return this;
+    }
+
+    public Builder endArray() {
+      endContainer(false);
+      return this;
+    }
+
+    /** Makes a native map of the map which was built. */
+    public WritableNativeMap buildMap() {
+      checkDone(TYPE_MAP);
+      return deserializeMap(mBuffer, mBuffer.position());
+    }
+
+    /** Makes a native array of the array which was built. */
+    public WritableNativeArray buildArray() {
+      checkDone(TYPE_ARRAY);
+      return deserializeArray(mBuffer, mBuffer.position());
+    }
+
+    /**
+     * The array which was built, serialized in the first {@link #getSerializedSize} bytes of a
+     * direct buffer, for native code which reads it itself (e.g. the arguments of a JS call which
+     * native code turns into JS values without a {@link NativeArray}). Only valid until the
+     * builder changes.
+     */
+    public ByteBuffer getSerializedArray() {
+      checkDone(TYPE_ARRAY);
+      return mBuffer;
+    }
+
+    public int getSerializedSize() {
+      return mBuffer.position();
+    }
+
+    private void beginValue(byte type) {
+      if (mDepth == 0) {
+        throw new IllegalStateException("Values must be in a map or array");
+      }
+      if (mOpenIsMap[mDepth - 1]) {
+        if (!mHasKey) {
+          throw new IllegalStateException("Values in a map need a key");
+        }
+        mHasKey = false;
+      }
+      mOpenCounts[mDepth - 1]++;
+      ensureCapacity(1);
+      mBuffer.put(type);
+    }
+
+    private void beginContainer(byte type) {
+      if (mDepth == 0) {
+        if (mIsDone || mBuffer.position() != 0) {
+          throw new IllegalStateException("Only one value can be built, call reset() first");
+        }
+        ensureCapacity(1);
+        mBuffer.put(type);
+      } else {
+        beginValue(type);
+      }
+      if (mDepth == mOpenPositions.length) {
+        mOpenPositions = Arrays.copyOf(mOpenPositions, 2 * mDepth);
+        mOpenCounts = Arrays.copyOf(mOpenCounts, 2 * mDepth);
+        mOpenIsMap = Arrays.copyOf(mOpenIsMap, 2 * mDepth);
+      }
+      mOpenPositions[mDepth] = mBuffer.position();
+      mOpenCounts[mDepth] = 0;
+      mOpenIsMap[mDepth] = type == TYPE_MAP;
+      mDepth++;
+      // The count and byte size, filled in by endContainer.
+      ensureCapacity(8);
+      mBuffer.putLong(0);
+    }
+
+    private void endContainer(boolean isMap) {
+      if (mDepth == 0 || mOpenIsMap[mDepth - 1] != isMap || mHasKey) {
+        throw new IllegalStateException(
+            isMap ? "No map to end, or its last key has no value" : "No array to end");
+      }
+      mDepth--;
+      int position = mOpenPositions[mDepth];
+      mBuffer.putInt(position, mOpenCounts[mDepth]);
+      mBuffer.putInt(position + 4, mBuffer.position() - position - 8);
+      mIsDone = mDepth == 0;
+    }
+
+    private void checkDone(byte type) {
+      if (!mIsDone || mBuffer.get(0) != type) {
+        throw new IllegalStateException(
+            type == TYPE_MAP ? "No complete map was built" : "No complete array was built");
+      }
+    }
+
+    private void putString(String string) {
+      byte[] bytes = string.getBytes(UTF_8);
+      ensureCapacity(4 + bytes.length);
+      mBuffer.putInt(bytes.length);
+      mBuffer.put(bytes);
+    }
+
+    private void ensureCapacity(int size) {
+      if (mBuffer.remaining() >= size) {
+        return;
+      }
+      int capacity = Math.max(2 * mBuffer.capacity(), mBuffer.position() + size);
+      ByteBuffer buffer = ByteBuffer.allocateDirect(capacity).order(ByteOrder.LITTLE_ENDIAN);
+      mBuffer.flip();
+      buffer.put(mBuffer);
+      mBuffer = buffer;
+    }
+  }
+
+  private static final class Reader {
+    private final ByteBuffer mBuffer;
+    private byte[] mStringBytes = new byte[64];
+
+    Reader(ByteBuffer buffer) {
+      mBuffer = buffer.duplicate().order(ByteOrder.LITTLE_ENDIAN);
+      mBuffer.rewind();
+    }
+
+    void expectType(byte type) {
+      byte actual = mBuffer.get();
+      if (actual != type) {
+        throw new UnexpectedNativeTypeException(
+            "Expected serialized value of type " + type + ", got " + actual);
+      }
+    }
+
+    JavaOnlyMap readMapContents() {
+      int count = mBuffer.getInt();
+      mBuffer.getInt(); // The byte size of the entries, for skipping them.
+      JavaOnlyMap map = new JavaOnlyMap();
+      for (int i = 0; i < count; i++) {
+        String key = readStringContents();
+        byte type = mBuffer.get();
+        switch (type) {
+          case TYPE_NULL:
+            map.putNull(key);
+            break;
+          case TYPE_FALSE:
+            map.putBoolean(key, false);
+            break;
+          case TYPE_TRUE:
+            map.putBoolean(key, true);
+            break;
+          case TYPE_NUMBER:
+            map.putDouble(key, mBuffer.getDouble());
+            break;
+          case TYPE_STRING:
+            map.putString(key, readStringContents());
+            break;
+          case TYPE_ARRAY:
+            map.putArray(key, readArrayContents());
+            break;
+          case TYPE_MAP:
+            map.putMap(key, readMapContents());
+            break;
+          default:
+            throw new UnexpectedNativeTypeException("Unknown serialized type " + type);
+        }
+      }
+      return map;
+    }
+
+    JavaOnlyArray readArrayContents() {
+      int count = mBuffer.getInt();
+      mBuffer.getInt(); // The byte size of the elements, for skipping them.
+      JavaOnlyArray array = new JavaOnlyArray();
+      for (int i = 0; i < count; i++) {
+        byte type = mBuffer.get();
+        switch (type) {
+          case TYPE_NULL:
+            array.pushNull();
+            break;
+          case TYPE_FALSE:
+            array.pushBoolean(false);
+            break;
+          case TYPE_TRUE:
+            array.pushBoolean(true);
+            break;
+          case TYPE_NUMBER:
+            array.pushDouble(mBuffer.getDouble());
+            break;
+          case TYPE_STRING:
+            array.pushString(readStringContents());
+            break;
+          case TYPE_ARRAY:
+            array.pushArray(readArrayContents());
+            break;
+          case TYPE_MAP:
+            array.pushMap(readMapContents());
+            break;
+          default:
+            throw new UnexpectedNativeTypeException("Unknown serialized type " + type);
+        }
+      }
+      return array;
+    }
+
+    private String readStringContents() {
+      int length = mBuffer.getInt();
+      if (length > mStringBytes.length) {
+        mStringBytes = new byte[Math.max(length, 2 * mStringBytes.length)];
+      }
+      mBuffer.get(mStringBytes, 0, length);
+      return new String(mStringBytes, 0, length, UTF_8);
+    }
+  }
+
+  private FlatDynamic() {}
+}
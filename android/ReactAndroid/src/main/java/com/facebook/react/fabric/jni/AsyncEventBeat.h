@@ -39,6 +39,11 @@ class AsyncEventBeat : public EventBeat {
   }
 
   void induce() const override {
+    if (eventBeatManager_->isFrameAligned()) {
+      // The beat happens with the next frame, see
+      // `EventBeatManager::beatForFrame`.
+      return;
+    }
     runtimeExecutor_([=](jsi::Runtime &runtime) {
       this->beat(runtime);
     });
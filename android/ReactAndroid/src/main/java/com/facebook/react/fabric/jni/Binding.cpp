@@ -5,10 +5,12 @@
 #include "Binding.h"
 #include "AsyncEventBeat.h"
 #include "EventEmitterWrapper.h"
+#include "MountItemsBuffer.h"
 #include "ReactNativeConfigHolder.h"
 #include "StateWrapperImpl.h"
 
 #include <fb/fbjni.h>
+#include <fb/fbjni/ByteBuffer.h>
 #include <jsi/JSIDynamic.h>
 #include <jsi/jsi.h>
 #include <react/components/scrollview/ScrollViewProps.h>
@@ -23,6 +25,7 @@
 #include <react/uimanager/primitives.h>
 #include <react/utils/ContextContainer.h>
 #include <react/utils/TimeUtils.h>
+#include <yoga/WorkerPool.h>
 
 #include <Glog/logging.h>
 
@@ -42,6 +45,9 @@ struct JMountItem : public JavaClass<JMountItem> {
 static constexpr auto UIManagerJavaDescriptor =
     "com/facebook/react/fabric/FabricUIManager";
 
+// The number of queued preliminary view allocations sent to Java at once.
+static constexpr size_t kPreallocationBatchSize = 128;
+
 } // namespace
 
 jni::local_ref<Binding::jhybriddata> Binding::initHybrid(
@@ -103,6 +109,7 @@ void Binding::startSurfaceWithConstraints(
 
   LayoutContext context;
   context.pointScaleFactor = {pointScaleFactor_};
+  context.visibleRect = Rect{{0, 0}, maximumSize};
   LayoutConstraints constraints = {};
   constraints.minimumSize = minimumSize;
   constraints.maximumSize = maximumSize;
@@ -163,6 +170,7 @@ void Binding::setConstraints(
 
   LayoutContext context;
   context.pointScaleFactor = {pointScaleFactor_};
+  context.visibleRect = Rect{{0, 0}, maximumSize};
   LayoutConstraints constraints = {};
   constraints.minimumSize = minimumSize;
   constraints.maximumSize = maximumSize;
@@ -220,6 +228,10 @@ void Binding::installFabricUIManager(
 
   std::shared_ptr<const ReactNativeConfig> config =
       std::make_shared<const ReactNativeConfigHolder>(reactNativeConfig);
+  usePackedMountItems_ =
+      config->getBool("react_fabric:enable_packed_mount_items_android");
+  useBatchedPreallocation_ =
+      config->getBool("react_fabric:enable_batched_preallocation_android");
   contextContainer->insert("ReactNativeConfig", config);
   contextContainer->insert("FabricUIManager", javaUIManager_);
 
@@ -229,10 +241,50 @@ void Binding::installFabricUIManager(
   toolbox.runtimeExecutor = runtimeExecutor;
   toolbox.synchronousEventBeatFactory = synchronousBeatFactory;
   toolbox.asynchronousEventBeatFactory = asynchronousBeatFactory;
+
+  if (config->getBool("react_fabric:enable_background_executor_android")) {
+    layoutThread_ = std::make_unique<LayoutThread>();
+    toolbox.backgroundExecutor =
+        [layoutThread = layoutThread_.get()](std::function<void()> &&callback) {
+          layoutThread->runOnQueue(std::move(callback));
+        };
+  }
+
+  if (config->getBool("react_fabric:enable_parallel_state_updates_android")) {
+    toolbox.stateUpdateExecutor =
+        [](size_t count, std::function<void(size_t)> const &task) {
+          // `WorkerPool` tasks must not throw, the first exception is
+          // rethrown on this thread once all of them have run.
+          auto exception = std::exception_ptr{};
+          std::mutex exceptionMutex;
+          yoga::detail::WorkerPool::forEach(count, [&](size_t index) {
+            try {
+              // Layout measures text and mounting calls the `FabricUIManager`
+              // from the pool's threads.
+              jni::ThreadScope::WithClassLoader([&]() { task(index); });
+            } catch (...) {
+              std::lock_guard<std::mutex> lock(exceptionMutex);
+              if (!exception) {
+                exception = std::current_exception();
+              }
+            }
+          });
+          if (exception) {
+            std::rethrow_exception(exception);
+          }
+        };
+  }
+
   scheduler_ = std::make_shared<Scheduler>(toolbox, this);
 }
 
 void Binding::uninstallFabricUIManager() {
+  // Finishing commits that are in flight before locking, because mounting them
+  // requires the mutexes.
+  if (layoutThread_) {
+    layoutThread_->quitSynchronous();
+  }
+
   // Use std::lock and std::adopt_lock to prevent deadlocks by locking mutexes at the same time
   std::lock(schedulerMutex_, javaUIManagerMutex_);
   std::lock_guard<std::mutex> schedulerLock(schedulerMutex_, std::adopt_lock);
@@ -240,6 +292,10 @@ void Binding::uninstallFabricUIManager() {
 
   scheduler_ = nullptr;
   javaUIManager_ = nullptr;
+  layoutThread_ = nullptr;
+
+  std::lock_guard<std::mutex> preallocationsLock(pendingPreallocationsMutex_);
+  pendingPreallocations_.clear();
 }
 
 inline local_ref<ReadableMap::javaobject> castReadableMap(
@@ -253,18 +309,19 @@ inline local_ref<ReadableArray::javaobject> castReadableArray(
 }
 
 // TODO: this method will be removed when binding for components are code-gen
-local_ref<JString> getPlatformComponentName(const ShadowView &shadowView) {
-  local_ref<JString> componentName;
-  auto newViewProps =
-      std::dynamic_pointer_cast<const ScrollViewProps>(shadowView.props);
+ComponentName getPlatformComponentNameString(const ShadowView &shadowView) {
+  auto const newViewProps =
+      dynamic_cast<ScrollViewProps const *>(shadowView.props.get());
 
   if (newViewProps &&
       newViewProps->getProbablyMoreHorizontalThanVertical_DEPRECATED()) {
-    componentName = make_jstring("AndroidHorizontalScrollView");
-  } else {
-    componentName = make_jstring(shadowView.componentName);
+    return "AndroidHorizontalScrollView";
   }
-  return componentName;
+  return shadowView.componentName;
+}
+
+local_ref<JString> getPlatformComponentName(const ShadowView &shadowView) {
+  return make_jstring(getPlatformComponentNameString(shadowView));
 }
 
 local_ref<JMountItem::javaobject> createUpdateEventEmitterMountItem(
@@ -291,30 +348,24 @@ local_ref<JMountItem::javaobject> createUpdateEventEmitterMountItem(
 
 local_ref<JMountItem::javaobject> createUpdatePropsMountItem(
     const jni::global_ref<jobject> &javaUIManager,
-    const ShadowViewMutation &mutation) {
-  auto shadowView = mutation.newChildShadowView;
-  auto newViewProps =
-      *std::dynamic_pointer_cast<const ViewProps>(shadowView.props);
-
+    Tag tag,
+    const folly::dynamic &rawProps) {
   // TODO: move props from map to a typed object.
-  auto newProps = shadowView.props->rawProps;
-
   local_ref<ReadableMap::javaobject> readableMap =
-      castReadableMap(ReadableNativeMap::newObjectCxxArgs(newProps));
+      castReadableMap(ReadableNativeMap::newObjectCxxArgs(rawProps));
   static auto updatePropsInstruction =
       jni::findClassStatic(UIManagerJavaDescriptor)
           ->getMethod<alias_ref<JMountItem>(jint, ReadableMap::javaobject)>(
               "updatePropsMountItem");
 
-  return updatePropsInstruction(
-      javaUIManager, mutation.newChildShadowView.tag, readableMap.get());
+  return updatePropsInstruction(javaUIManager, tag, readableMap.get());
 }
 
 local_ref<JMountItem::javaobject> createUpdateLayoutMountItem(
     const jni::global_ref<jobject> &javaUIManager,
     const ShadowViewMutation &mutation) {
-  auto oldChildShadowView = mutation.oldChildShadowView;
-  auto newChildShadowView = mutation.newChildShadowView;
+  auto const &oldChildShadowView = mutation.oldChildShadowView;
+  auto const &newChildShadowView = mutation.newChildShadowView;
 
   if (newChildShadowView.layoutMetrics != EmptyLayoutMetrics &&
       oldChildShadowView.layoutMetrics != newChildShadowView.layoutMetrics) {
@@ -322,7 +373,7 @@ local_ref<JMountItem::javaobject> createUpdateLayoutMountItem(
         jni::findClassStatic(UIManagerJavaDescriptor)
             ->getMethod<alias_ref<JMountItem>(jint, jint, jint, jint, jint, jint)>(
                 "updateLayoutMountItem");
-    auto layoutMetrics = newChildShadowView.layoutMetrics;
+    auto const &layoutMetrics = newChildShadowView.layoutMetrics;
     auto pointScaleFactor = layoutMetrics.pointScaleFactor;
     auto frame = layoutMetrics.frame;
 
@@ -361,7 +412,7 @@ local_ref<JMountItem::javaobject> createUpdateLocalData(
           ->getMethod<alias_ref<JMountItem>(jint, ReadableMap::javaobject)>(
               "updateLocalDataMountItem");
 
-  auto localData = mutation.newChildShadowView.localData;
+  auto const &localData = mutation.newChildShadowView.localData;
 
   folly::dynamic newLocalData = folly::dynamic::object();
   if (localData) {
@@ -438,7 +489,7 @@ local_ref<JMountItem::javaobject> createCreateMountItem(
           ->getMethod<alias_ref<JMountItem>(jstring, ReadableMap::javaobject, jobject, jint, jint, jboolean)>(
               "createMountItem");
 
-  auto newChildShadowView = mutation.newChildShadowView;
+  auto const &newChildShadowView = mutation.newChildShadowView;
 
   local_ref<JString> componentName =
       getPlatformComponentName(newChildShadowView);
@@ -469,6 +520,241 @@ local_ref<JMountItem::javaobject> createCreateMountItem(
       isLayoutable);
 }
 
+local_ref<jobject> createJavaStateWrapper(State::Shared const &state) {
+  // Do not hold onto Java object from C
+  // We DO want to hold onto C object from Java, since we don't know the
+  // lifetime of the Java object
+  if (state == nullptr) {
+    return nullptr;
+  }
+  local_ref<StateWrapperImpl::JavaPart> javaStateWrapper =
+      StateWrapperImpl::newObjectJavaArgs();
+  StateWrapperImpl *cStateWrapper = cthis(javaStateWrapper);
+  cStateWrapper->state_ = state;
+  return javaStateWrapper;
+}
+
+/*
+ * Same as the list of mount items built in `schedulerDidFinishTransaction` but
+ * packed into a single buffer, see `MountItemsBuffer` for the layout.
+ * Returns `nullptr` if there is nothing to mount.
+ */
+local_ref<JMountItem::javaobject> createPackedMountItem(
+    const jni::global_ref<jobject> &javaUIManager,
+    ShadowViewMutationList const &mutations,
+    SurfaceId surfaceId,
+    int64_t commitNumber) {
+  SystraceSection s("FabricUIManagerBinding::createPackedMountItem");
+
+  auto buffer = MountItemsBuffer{};
+
+  // Every mutation consumes at most four objects.
+  local_ref<JArrayClass<jobject>> objectsArray =
+      JArrayClass<jobject>::newArray(mutations.size() * 4);
+  auto objects = *(objectsArray);
+  int objectsPosition = 0;
+
+  auto writeProps = [&](folly::dynamic const &rawProps) {
+    objects[objectsPosition++] =
+        castReadableMap(ReadableNativeMap::newObjectCxxArgs(rawProps));
+  };
+  auto writeLocalData = [&](ShadowView const &shadowView) {
+    buffer.writeInstruction(MountItemsBuffer::UpdateLocalData);
+    buffer.writeInt(shadowView.tag);
+    folly::dynamic newLocalData = folly::dynamic::object();
+    if (shadowView.localData) {
+      newLocalData = shadowView.localData->getDynamic();
+    }
+    objects[objectsPosition++] =
+        castReadableMap(ReadableNativeMap::newObjectCxxArgs(newLocalData));
+  };
+  auto writeState = [&](ShadowView const &shadowView) {
+    buffer.writeInstruction(MountItemsBuffer::UpdateState);
+    buffer.writeInt(shadowView.tag);
+    objects[objectsPosition++] = createJavaStateWrapper(shadowView.state);
+  };
+  auto writeLayout = [&](ShadowViewMutation const &mutation) {
+    auto const &layoutMetrics = mutation.newChildShadowView.layoutMetrics;
+    if (layoutMetrics == EmptyLayoutMetrics ||
+        layoutMetrics == mutation.oldChildShadowView.layoutMetrics) {
+      return;
+    }
+    auto const pointScaleFactor = layoutMetrics.pointScaleFactor;
+    auto const &frame = layoutMetrics.frame;
+    buffer.writeInstruction(MountItemsBuffer::UpdateLayout);
+    buffer.writeInt(mutation.newChildShadowView.tag);
+    buffer.writeInt(round(frame.origin.x * pointScaleFactor));
+    buffer.writeInt(round(frame.origin.y * pointScaleFactor));
+    buffer.writeInt(round(frame.size.width * pointScaleFactor));
+    buffer.writeInt(round(frame.size.height * pointScaleFactor));
+    buffer.writeInt(toInt(layoutMetrics.layoutDirection));
+  };
+  auto writeEventEmitter = [&](ShadowView const &shadowView) {
+    if (!shadowView.eventEmitter) {
+      return;
+    }
+    buffer.writeInstruction(MountItemsBuffer::UpdateEventEmitter);
+    buffer.writeInt(shadowView.tag);
+    // Do not hold a reference to javaEventEmitter from the C++ side.
+    auto javaEventEmitter = EventEmitterWrapper::newObjectJavaArgs();
+    EventEmitterWrapper *cEventEmitter = cthis(javaEventEmitter);
+    cEventEmitter->eventEmitter = shadowView.eventEmitter;
+    objects[objectsPosition++] = javaEventEmitter;
+  };
+
+  std::unordered_set<Tag> deletedViewTags;
+
+  for (const auto &mutation : mutations) {
+    auto const &oldChildShadowView = mutation.oldChildShadowView;
+    auto const &newChildShadowView = mutation.newChildShadowView;
+
+    bool isVirtual = newChildShadowView.layoutMetrics == EmptyLayoutMetrics &&
+        oldChildShadowView.layoutMetrics == EmptyLayoutMetrics;
+
+    switch (mutation.type) {
+      case ShadowViewMutation::Create: {
+        if (newChildShadowView.props->revision > 1 ||
+            deletedViewTags.find(newChildShadowView.tag) !=
+                deletedViewTags.end()) {
+          buffer.writeInstruction(MountItemsBuffer::Create);
+          buffer.writeInt(newChildShadowView.tag);
+          buffer.writeInt(
+              newChildShadowView.layoutMetrics != EmptyLayoutMetrics);
+          buffer.writeString(getPlatformComponentNameString(newChildShadowView));
+          writeProps(newChildShadowView.props->rawProps);
+          objects[objectsPosition++] =
+              createJavaStateWrapper(newChildShadowView.state);
+        }
+        break;
+      }
+      case ShadowViewMutation::Remove: {
+        if (!isVirtual) {
+          buffer.writeInstruction(MountItemsBuffer::Remove);
+          buffer.writeInt(oldChildShadowView.tag);
+          buffer.writeInt(mutation.parentShadowView.tag);
+          buffer.writeInt(mutation.index);
+        }
+        break;
+      }
+      case ShadowViewMutation::Delete: {
+        buffer.writeInstruction(MountItemsBuffer::Delete);
+        buffer.writeInt(oldChildShadowView.tag);
+
+        deletedViewTags.insert(oldChildShadowView.tag);
+        break;
+      }
+      case ShadowViewMutation::Update: {
+        if (!isVirtual) {
+          if (oldChildShadowView.props != newChildShadowView.props) {
+            auto const rawPropsDelta = diffRawProps(
+                *oldChildShadowView.props, *newChildShadowView.props);
+            if (!rawPropsDelta.empty()) {
+              buffer.writeInstruction(MountItemsBuffer::UpdateProps);
+              buffer.writeInt(newChildShadowView.tag);
+              writeProps(rawPropsDelta);
+            }
+          }
+          if (oldChildShadowView.localData != newChildShadowView.localData) {
+            writeLocalData(newChildShadowView);
+          }
+          if (oldChildShadowView.state != newChildShadowView.state) {
+            writeState(newChildShadowView);
+          }
+          writeLayout(mutation);
+        }
+
+        if (oldChildShadowView.eventEmitter !=
+            newChildShadowView.eventEmitter) {
+          writeEventEmitter(newChildShadowView);
+        }
+        break;
+      }
+      case ShadowViewMutation::Insert: {
+        if (!isVirtual) {
+          buffer.writeInstruction(MountItemsBuffer::Insert);
+          buffer.writeInt(newChildShadowView.tag);
+          buffer.writeInt(mutation.parentShadowView.tag);
+          buffer.writeInt(mutation.index);
+
+          if (newChildShadowView.props->revision > 1 ||
+              deletedViewTags.find(newChildShadowView.tag) !=
+                  deletedViewTags.end()) {
+            buffer.writeInstruction(MountItemsBuffer::UpdateProps);
+            buffer.writeInt(newChildShadowView.tag);
+            writeProps(newChildShadowView.props->rawProps);
+          }
+          if (newChildShadowView.state) {
+            writeState(newChildShadowView);
+          }
+          if (newChildShadowView.localData) {
+            writeLocalData(newChildShadowView);
+          }
+          writeLayout(mutation);
+        }
+
+        writeEventEmitter(newChildShadowView);
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+
+  if (buffer.getItemCount() == 0) {
+    return nullptr;
+  }
+
+  // The buffer is allocated by Java, so it stays valid for as long as the Java
+  // side needs it.
+  static auto allocateDirect =
+      JByteBuffer::javaClassStatic()
+          ->getStaticMethod<local_ref<JByteBuffer>(jint)>("allocateDirect");
+  auto byteBuffer = allocateDirect(
+      JByteBuffer::javaClassStatic(), buffer.getByteSize());
+  memcpy(
+      byteBuffer->getDirectBytes(), buffer.getBytes(), buffer.getByteSize());
+
+  static auto createPackedMountItemContainer =
+      jni::findClassStatic(UIManagerJavaDescriptor)
+          ->getMethod<alias_ref<JMountItem>(
+              JByteBuffer::javaobject, jtypeArray<jobject>, jint, jint, jint)>(
+              "createPackedMountItem");
+
+  return createPackedMountItemContainer(
+      javaUIManager,
+      byteBuffer.get(),
+      objectsArray.get(),
+      buffer.getItemCount(),
+      surfaceId,
+      commitNumber);
+}
+
+void scheduleMountItem(
+    const jni::global_ref<jobject> &javaUIManager,
+    local_ref<JMountItem::javaobject> const &mountItem,
+    MountingTelemetry const &telemetry,
+    long finishTransactionStartTime) {
+  static auto scheduleMountItem =
+      jni::findClassStatic(UIManagerJavaDescriptor)
+          ->getMethod<void(JMountItem::javaobject, jint, jlong, jlong, jlong, jlong, jlong, jlong, jlong)>(
+              "scheduleMountItem");
+
+  long finishTransactionEndTime = getTime();
+
+  scheduleMountItem(
+      javaUIManager,
+      mountItem.get(),
+      telemetry.getCommitNumber(),
+      telemetry.getCommitStartTime(),
+      telemetry.getDiffStartTime(),
+      telemetry.getDiffEndTime(),
+      telemetry.getLayoutStartTime(),
+      telemetry.getLayoutEndTime(),
+      finishTransactionStartTime,
+      finishTransactionEndTime);
+}
+
 void Binding::schedulerDidFinishTransaction(
     MountingCoordinator::Shared const &mountingCoordinator) {
   std::lock_guard<std::recursive_mutex> lock(commitMutex_);
@@ -482,6 +768,9 @@ void Binding::schedulerDidFinishTransaction(
     return;
   }
 
+  // Views must be preallocated before the transaction creates them.
+  flushPendingPreallocations(localJavaUIManager);
+
   auto mountingTransaction = mountingCoordinator->pullTransaction();
 
   if (!mountingTransaction.has_value()) {
@@ -489,11 +778,24 @@ void Binding::schedulerDidFinishTransaction(
   }
 
   auto telemetry = mountingTransaction->getTelemetry();
+  telemetry.willMount();
   auto surfaceId = mountingTransaction->getSurfaceId();
   auto &mutations = mountingTransaction->getMutations();
 
   int64_t commitNumber = telemetry.getCommitNumber();
 
+  if (usePackedMountItems_) {
+    auto mountItem = createPackedMountItem(
+        localJavaUIManager, mutations, surfaceId, commitNumber);
+    if (mountItem) {
+      telemetry.didMount();
+      telemetryBuffer_.push(surfaceId, telemetry);
+      scheduleMountItem(
+          localJavaUIManager, mountItem, telemetry, finishTransactionStartTime);
+    }
+    return;
+  }
+
   std::vector<local_ref<jobject>> queue;
   // Upper bound estimation of mount items to be delivered to Java side.
   int size = mutations.size() * 3 + 42;
@@ -506,8 +808,8 @@ void Binding::schedulerDidFinishTransaction(
 
   int position = 0;
   for (const auto &mutation : mutations) {
-    auto oldChildShadowView = mutation.oldChildShadowView;
-    auto newChildShadowView = mutation.newChildShadowView;
+    auto const &oldChildShadowView = mutation.oldChildShadowView;
+    auto const &newChildShadowView = mutation.newChildShadowView;
 
     bool isVirtual = newChildShadowView.layoutMetrics == EmptyLayoutMetrics &&
         oldChildShadowView.layoutMetrics == EmptyLayoutMetrics;
@@ -540,8 +842,17 @@ void Binding::schedulerDidFinishTransaction(
         if (!isVirtual) {
           if (mutation.oldChildShadowView.props !=
               mutation.newChildShadowView.props) {
-            mountItems[position++] =
-                createUpdatePropsMountItem(localJavaUIManager, mutation);
+            // Only the props that changed since the mounted ones, e.g. a
+            // single animated value, are converted and sent.
+            auto const rawPropsDelta = diffRawProps(
+                *mutation.oldChildShadowView.props,
+                *mutation.newChildShadowView.props);
+            if (!rawPropsDelta.empty()) {
+              mountItems[position++] = createUpdatePropsMountItem(
+                  localJavaUIManager,
+                  mutation.newChildShadowView.tag,
+                  rawPropsDelta);
+            }
           }
           if (mutation.oldChildShadowView.localData !=
               mutation.newChildShadowView.localData) {
@@ -580,8 +891,10 @@ void Binding::schedulerDidFinishTransaction(
           if (mutation.newChildShadowView.props->revision > 1 ||
               deletedViewTags.find(mutation.newChildShadowView.tag) !=
                   deletedViewTags.end()) {
-            mountItems[position++] =
-                createUpdatePropsMountItem(localJavaUIManager, mutation);
+            mountItems[position++] = createUpdatePropsMountItem(
+                localJavaUIManager,
+                mutation.newChildShadowView.tag,
+                mutation.newChildShadowView.props->rawProps);
           }
 
           // State
@@ -633,24 +946,10 @@ void Binding::schedulerDidFinishTransaction(
   auto batch = createMountItemsBatchContainer(
       localJavaUIManager, mountItemsArray.get(), position, commitNumber);
 
-  static auto scheduleMountItem =
-      jni::findClassStatic(UIManagerJavaDescriptor)
-          ->getMethod<void(JMountItem::javaobject, jint, jlong, jlong, jlong, jlong, jlong, jlong, jlong)>(
-              "scheduleMountItem");
-
-  long finishTransactionEndTime = getTime();
-
+  telemetry.didMount();
+  telemetryBuffer_.push(surfaceId, telemetry);
   scheduleMountItem(
-      localJavaUIManager,
-      batch.get(),
-      telemetry.getCommitNumber(),
-      telemetry.getCommitStartTime(),
-      telemetry.getDiffStartTime(),
-      telemetry.getDiffEndTime(),
-      telemetry.getLayoutStartTime(),
-      telemetry.getLayoutEndTime(),
-      finishTransactionStartTime,
-      finishTransactionEndTime);
+      localJavaUIManager, batch, telemetry, finishTransactionStartTime);
 }
 
 void Binding::setPixelDensity(float pointScaleFactor) {
@@ -667,6 +966,22 @@ void Binding::schedulerDidRequestPreliminaryViewAllocation(
     return;
   }
 
+  if (useBatchedPreallocation_) {
+    bool isBatchFull;
+    {
+      std::lock_guard<std::mutex> lock(pendingPreallocationsMutex_);
+      pendingPreallocations_.emplace_back(surfaceId, shadowView);
+      isBatchFull =
+          pendingPreallocations_.size() >= kPreallocationBatchSize;
+    }
+    // Sending full batches right away (instead of with the next transaction)
+    // lets Java allocate views while JavaScript is still rendering.
+    if (isBatchFull) {
+      flushPendingPreallocations(localJavaUIManager);
+    }
+    return;
+  }
+
   bool isLayoutableShadowNode = shadowView.layoutMetrics != EmptyLayoutMetrics;
 
   static auto preallocateView =
@@ -699,6 +1014,50 @@ void Binding::schedulerDidRequestPreliminaryViewAllocation(
       isLayoutableShadowNode);
 }
 
+void Binding::flushPendingPreallocations(
+    jni::global_ref<jobject> const &javaUIManager) {
+  std::vector<std::pair<SurfaceId, ShadowView>> preallocations;
+  {
+    std::lock_guard<std::mutex> lock(pendingPreallocationsMutex_);
+    if (pendingPreallocations_.empty()) {
+      return;
+    }
+    preallocations.swap(pendingPreallocations_);
+  }
+
+  SystraceSection s("FabricUIManagerBinding::flushPendingPreallocations");
+
+  // Each view is described by three ints (surface id, tag, whether it is
+  // layoutable) and three objects (component name, props and state).
+  auto const count = preallocations.size();
+  local_ref<JArrayInt> intsArray = JArrayInt::newArray(count * 3);
+  local_ref<JArrayClass<jobject>> objectsArray =
+      JArrayClass<jobject>::newArray(count * 3);
+  auto objects = *(objectsArray);
+  {
+    auto ints = intsArray->pin();
+    size_t position = 0;
+    for (auto const &preallocation : preallocations) {
+      auto const &shadowView = preallocation.second;
+      ints[position * 3] = preallocation.first;
+      ints[position * 3 + 1] = shadowView.tag;
+      ints[position * 3 + 2] = shadowView.layoutMetrics != EmptyLayoutMetrics;
+      objects[position * 3] = getPlatformComponentName(shadowView);
+      objects[position * 3 + 1] = castReadableMap(
+          ReadableNativeMap::newObjectCxxArgs(shadowView.props->rawProps));
+      objects[position * 3 + 2] = createJavaStateWrapper(shadowView.state);
+      position++;
+    }
+  }
+
+  static auto preallocateViews =
+      jni::findClassStatic(UIManagerJavaDescriptor)
+          ->getMethod<void(jintArray, jtypeArray<jobject>)>(
+              "preallocateViews");
+
+  preallocateViews(javaUIManager, intsArray.get(), objectsArray.get());
+}
+
 void Binding::schedulerDidDispatchCommand(
   const ShadowView &shadowView,
   std::string const &commandName,
@@ -6,13 +6,17 @@
 
 #include <fb/fbjni.h>
 #include <react/jni/JMessageQueueThread.h>
+#include <react/mounting/MountingTelemetryBuffer.h>
 #include <react/jni/ReadableNativeMap.h>
 #include <react/uimanager/Scheduler.h>
 #include <react/uimanager/SchedulerDelegate.h>
 #include <memory>
 #include <mutex>
+#include <utility>
+#include <vector>
 #include "ComponentFactoryDelegate.h"
 #include "EventBeatManager.h"
+#include "LayoutThread.h"
 
 namespace facebook {
 namespace react {
@@ -36,10 +40,40 @@ class Binding : public jni::HybridClass<Binding>, public SchedulerDelegate {
 
   float pointScaleFactor_ = 1;
 
+  /*
+   * Delivers mount items to Java packed into a single buffer instead of one
+   * Java object per item.
+   */
+  bool usePackedMountItems_ = false;
+
+  /*
+   * Queues preliminary view allocations and sends them to Java in batches,
+   * instead of with a JNI call each. Batches are sent when they are full and
+   * before every transaction is mounted.
+   */
+  bool useBatchedPreallocation_ = false;
+  std::vector<std::pair<SurfaceId, ShadowView>> pendingPreallocations_;
+  std::mutex pendingPreallocationsMutex_;
+
+  /*
+   * Telemetry of the recently mounted transactions; can be sampled from any
+   * thread.
+   */
+  MountingTelemetryBuffer telemetryBuffer_;
+
+  /*
+   * Commits, lays out and diffs shadow trees completed by JavaScript off the
+   * JavaScript thread. Only exists if the background executor is enabled.
+   */
+  std::unique_ptr<LayoutThread> layoutThread_;
+
  private:
   jni::global_ref<jobject> getJavaUIManager();
   std::shared_ptr<Scheduler> getScheduler();
 
+  void flushPendingPreallocations(
+      jni::global_ref<jobject> const &javaUIManager);
+
   void setConstraints(
       jint surfaceId,
       jfloat minWidth,
@@ -44,10 +44,38 @@ void EventBeatManager::beat() {
   }
 }
 
+void EventBeatManager::beatForFrame(jlong frameTimeNanos) {
+  lastFrameTimeNanos_ = frameTimeNanos;
+
+  runtimeExecutor_([this](jsi::Runtime &runtime) {
+    // The beats are looked up when the task runs, so the ones destroyed in
+    // the meantime are skipped.
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto eventBeat : registeredEventBeats_) {
+      eventBeat->beat(runtime);
+    }
+  });
+}
+
+void EventBeatManager::setFrameAligned(bool frameAligned) {
+  frameAligned_ = frameAligned;
+}
+
+bool EventBeatManager::isFrameAligned() const {
+  return frameAligned_;
+}
+
+int64_t EventBeatManager::lastFrameTimeNanos() const {
+  return lastFrameTimeNanos_;
+}
+
 void EventBeatManager::registerNatives() {
   registerHybrid({
       makeNativeMethod("initHybrid", EventBeatManager::initHybrid),
       makeNativeMethod("beat", EventBeatManager::beat),
+      makeNativeMethod("beatForFrame", EventBeatManager::beatForFrame),
+      makeNativeMethod("setFrameAligned", EventBeatManager::setFrameAligned),
   });
 }
 
@@ -8,6 +8,7 @@
 #include <jsi/jsi.h>
 #include <react/core/EventBeat.h>
 #include <react/utils/RuntimeExecutor.h>
+#include <atomic>
 #include <mutex>
 #include <unordered_set>
 
@@ -33,6 +34,26 @@ class EventBeatManager : public jni::HybridClass<EventBeatManager> {
 
   void beat();
 
+  /*
+   * Beats all registered event beats in a single JS task, as part of the
+   * frame which started at `frameTimeNanos` (a Choreographer timestamp).
+   */
+  void beatForFrame(jlong frameTimeNanos);
+
+  /*
+   * In frame aligned mode, inducing a beat doesn't schedule it right away:
+   * it happens with the other beats of the next frame, in `beatForFrame`,
+   * so event dispatching lines up with layout and mounting.
+   */
+  void setFrameAligned(bool frameAligned);
+
+  bool isFrameAligned() const;
+
+  /*
+   * The timestamp of the last frame passed to `beatForFrame`, or 0.
+   */
+  int64_t lastFrameTimeNanos() const;
+
   EventBeatManager(jni::alias_ref<EventBeatManager::jhybriddata> jhybridobject);
 
  private:
@@ -45,6 +66,9 @@ class EventBeatManager : public jni::HybridClass<EventBeatManager> {
 
   mutable std::mutex mutex_;
 
+  std::atomic<bool> frameAligned_{false};
+  std::atomic<int64_t> lastFrameTimeNanos_{0};
+
   static jni::local_ref<EventBeatManager::jhybriddata> initHybrid(
       jni::alias_ref<EventBeatManager::jhybriddata> jhybridobject);
 };
@@ -0,0 +1,63 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "LayoutThread.h"
+
+#include <fb/Environment.h>
+
+namespace facebook {
+namespace react {
+
+LayoutThread::LayoutThread() : thread_([this]() { run(); }) {}
+
+LayoutThread::~LayoutThread() {
+  quitSynchronous();
+}
+
+void LayoutThread::runOnQueue(std::function<void()> &&runnable) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isQuitting_) {
+      return;
+    }
+    queue_.push_back(std::move(runnable));
+  }
+  condition_.notify_one();
+}
+
+void LayoutThread::quitSynchronous() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    isQuitting_ = true;
+  }
+  condition_.notify_one();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void LayoutThread::run() {
+  // The class loader is needed to look up application classes (e.g. the
+  // `FabricUIManager`) when mounting from this thread.
+  jni::ThreadScope::WithClassLoader([this]() {
+    while (true) {
+      auto runnable = std::function<void()>{};
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(
+            lock, [this]() { return isQuitting_ || !queue_.empty(); });
+        if (queue_.empty()) {
+          return;
+        }
+        runnable = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      runnable();
+    }
+  });
+}
+
+} // namespace react
+} // namespace facebook
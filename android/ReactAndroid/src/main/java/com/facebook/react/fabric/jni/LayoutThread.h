@@ -0,0 +1,51 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace facebook {
+namespace react {
+
+/*
+ * A dedicated native thread (attached to the JVM) that runs the functions
+ * given to it one by one, in order. Fabric commits, lays out and diffs shadow
+ * trees completed by JavaScript on this thread when the background executor
+ * is enabled.
+ */
+class LayoutThread final {
+ public:
+  LayoutThread();
+
+  /*
+   * Runs the remaining functions and stops the thread.
+   */
+  ~LayoutThread();
+
+  void runOnQueue(std::function<void()> &&runnable);
+
+  /*
+   * Runs the functions that are already queued, then stops the thread and
+   * waits for it. Functions given afterwards are ignored.
+   * Must not be called on the thread itself.
+   */
+  void quitSynchronous();
+
+ private:
+  void run();
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<std::function<void()>> queue_; // Protected by `mutex_`.
+  bool isQuitting_{false}; // Protected by `mutex_`.
+  std::thread thread_;
+};
+
+} // namespace react
+} // namespace facebook
@@ -0,0 +1,44 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MountItemsBuffer.h"
+
+#include <cstring>
+
+namespace facebook {
+namespace react {
+
+void MountItemsBuffer::writeInstruction(Instruction instruction) {
+  words_.push_back(instruction);
+  itemCount_++;
+}
+
+void MountItemsBuffer::writeInt(int32_t value) {
+  words_.push_back(value);
+}
+
+void MountItemsBuffer::writeString(char const *string) {
+  auto const length = string ? strlen(string) : 0;
+  auto const offset = words_.size();
+  words_.push_back(length);
+  words_.resize(offset + 1 + (length + sizeof(int32_t) - 1) / sizeof(int32_t));
+  if (length > 0) {
+    memcpy(words_.data() + offset + 1, string, length);
+  }
+}
+
+int MountItemsBuffer::getItemCount() const {
+  return itemCount_;
+}
+
+uint8_t const *MountItemsBuffer::getBytes() const {
+  return reinterpret_cast<uint8_t const *>(words_.data());
+}
+
+size_t MountItemsBuffer::getByteSize() const {
+  return words_.size() * sizeof(int32_t);
+}
+
+} // namespace react
+} // namespace facebook
@@ -0,0 +1,70 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace facebook {
+namespace react {
+
+/*
+ * Packs the mount items of a transaction into a flat list of 32-bit words that
+ * is handed to Java as a single direct `ByteBuffer` (in native byte order), so
+ * a transaction costs one JNI call instead of one per mount item.
+ * Values that only exist as Java objects (props, local data and the state and
+ * event emitter wrappers) are passed in a separate array of objects, which the
+ * items consume in order.
+ *
+ * Every item starts with its `Instruction` followed by its operands:
+ *   Create:             tag, isLayoutable, name length, name (UTF-8, padded
+ *                       with zeros to whole words); objects: props, state
+ *   Delete:             tag
+ *   Insert, Remove:     tag, parent tag, index
+ *   UpdateProps:        tag; objects: props
+ *   UpdateLocalData:    tag; objects: local data
+ *   UpdateState:        tag; objects: state
+ *   UpdateLayout:       tag, x, y, width, height, layout direction
+ *   UpdateEventEmitter: tag; objects: event emitter
+ * Frames are in pixels. State objects can be `null`.
+ */
+class MountItemsBuffer final {
+ public:
+  enum Instruction : int32_t {
+    Create = 1,
+    Delete = 2,
+    Insert = 3,
+    Remove = 4,
+    UpdateProps = 5,
+    UpdateLocalData = 6,
+    UpdateState = 7,
+    UpdateLayout = 8,
+    UpdateEventEmitter = 9,
+  };
+
+  /*
+   * Starts a new item. Its operands have to be written right after.
+   */
+  void writeInstruction(Instruction instruction);
+
+  void writeInt(int32_t value);
+  void writeString(char const *string);
+
+  /*
+   * Returns the number of items written so far.
+   */
+  int getItemCount() const;
+
+  uint8_t const *getBytes() const;
+  size_t getByteSize() const;
+
+ private:
+  std::vector<int32_t> words_;
+  int itemCount_{0};
+};
+
+} // namespace react
+} // namespace facebook
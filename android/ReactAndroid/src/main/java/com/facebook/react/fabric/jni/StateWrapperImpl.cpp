@@ -33,11 +33,21 @@ void StateWrapperImpl::updateStateImpl(NativeMap* map) {
   state_->updateState(dynamicMap);
 }
 
+jboolean StateWrapperImpl::updateStatePointImpl(jfloat x, jfloat y) {
+  return state_->updateStatePoint(Point{x, y});
+}
+
+jboolean StateWrapperImpl::updateStateSizeImpl(jfloat width, jfloat height) {
+  return state_->updateStateSize(Size{width, height});
+}
+
 void StateWrapperImpl::registerNatives() {
   registerHybrid({
       makeNativeMethod("initHybrid",      StateWrapperImpl::initHybrid),
       makeNativeMethod("getState",        StateWrapperImpl::getState),
       makeNativeMethod("updateStateImpl", StateWrapperImpl::updateStateImpl),
+      makeNativeMethod("updateStatePointImpl", StateWrapperImpl::updateStatePointImpl),
+      makeNativeMethod("updateStateSizeImpl", StateWrapperImpl::updateStateSizeImpl),
   });
 }
 
@@ -22,6 +22,10 @@ class StateWrapperImpl : public jni::HybridClass<StateWrapperImpl> {
 
   jni::local_ref<ReadableNativeMap::jhybridobject> getState();
   void updateStateImpl(NativeMap *map);
+  // Typed updates of high frequency states (scroll offset, modal size...),
+  // false if the state needs `updateStateImpl` instead.
+  jboolean updateStatePointImpl(jfloat x, jfloat y);
+  jboolean updateStateSizeImpl(jfloat width, jfloat height);
 
   State::Shared state_;
  private:
@@ -25,8 +25,8 @@ class JSCExecutorFactory : public JSExecutorFactory {
     auto installBindings = [](jsi::Runtime &runtime) {
       react::Logger androidLogger =
           static_cast<void (*)(const std::string &, unsigned int)>(
-              &reactAndroidLoggingHook);
-      react::bindNativeLogger(runtime, androidLogger);
+              &reactAndroidAsyncLoggingHook);
+      react::bindNativeLogger(runtime, androidLogger, &reactAndroidShouldLog);
     };
     return folly::make_unique<JSIExecutor>(
         jsc::makeJSCRuntime(),
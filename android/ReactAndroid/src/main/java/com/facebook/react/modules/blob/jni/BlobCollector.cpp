@@ -7,6 +7,7 @@
 #include <fb/fbjni.h>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 using namespace facebook;
 
@@ -16,6 +17,50 @@ namespace react {
 static constexpr auto kBlobModuleJavaDescriptor =
     "com/facebook/react/modules/blob/BlobModule";
 
+namespace {
+
+// The bytes of a blob, owned by the ArrayBuffer which exposes them to JS.
+class BlobBuffer : public jsi::MutableBuffer {
+ public:
+  explicit BlobBuffer(size_t size) : data_(size) {}
+
+  size_t size() const override {
+    return data_.size();
+  }
+
+  uint8_t *data() override {
+    return data_.data();
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+// Copies the bytes of a blob straight from the Java array BlobModule keeps
+// into native memory, which the ArrayBuffer then uses without another copy.
+jsi::Value createBlobArrayBuffer(
+    jsi::Runtime &rt,
+    const jni::global_ref<jobject> &blobModule,
+    const std::string &blobId,
+    jint offset,
+    jint size) {
+  static auto resolveMethod =
+      jni::findClassStatic(kBlobModuleJavaDescriptor)
+          ->getMethod<jni::JArrayByte::javaobject(jstring, jint, jint)>(
+              "resolve");
+  auto bytes = resolveMethod(
+      blobModule, jni::make_jstring(blobId).get(), offset, size);
+  if (!bytes) {
+    return jsi::Value::null();
+  }
+  const jsize length = bytes->size();
+  auto buffer = std::make_shared<BlobBuffer>(length);
+  bytes->getRegion(0, length, reinterpret_cast<jbyte *>(buffer->data()));
+  return jsi::ArrayBuffer(rt, std::move(buffer));
+}
+
+} // namespace
+
 BlobCollector::BlobCollector(
     jni::global_ref<jobject> blobModule,
     const std::string &blobId)
@@ -52,6 +97,34 @@ void BlobCollector::nativeInstall(
                 std::make_shared<BlobCollector>(blobModuleRef, blobId);
             return jsi::Object::createFromHostObject(rt, blobCollector);
           }));
+  // __blobArrayBufferProvider(blobId, offset, size) returns the bytes of
+  // [offset, offset + size) of a blob (all of it from offset if size is -1)
+  // as an ArrayBuffer, or null if the blob doesn't exist. Requires a runtime
+  // which supports native ArrayBuffers.
+  runtime.global().setProperty(
+      runtime,
+      "__blobArrayBufferProvider",
+      jsi::Function::createFromHostFunction(
+          runtime,
+          jsi::PropNameID::forAscii(runtime, "__blobArrayBufferProvider"),
+          3,
+          [blobModuleRef](
+              jsi::Runtime &rt,
+              const jsi::Value &thisVal,
+              const jsi::Value *args,
+              size_t count) {
+            if (count < 1) {
+              throw jsi::JSError(
+                  rt, "__blobArrayBufferProvider requires a blob id");
+            }
+            auto blobId = args[0].asString(rt).utf8(rt);
+            jint offset =
+                count > 1 ? static_cast<jint>(args[1].asNumber()) : 0;
+            jint size =
+                count > 2 ? static_cast<jint>(args[2].asNumber()) : -1;
+            return createBlobArrayBuffer(
+                rt, blobModuleRef, blobId, offset, size);
+          }));
 }
 
 void BlobCollector::registerNatives() {
@@ -54,7 +54,7 @@ void TurboModuleManager::installJSIBindings() {
   if (!runtime_) {
     return; // Runtime doesn't exist when attached to Chrome debugger.
   }
-  TurboModuleBinding::install(*runtime_, std::make_shared<TurboModuleBinding>(
+  binding_ = std::make_shared<TurboModuleBinding>(
       [this](const std::string &name) -> std::shared_ptr<TurboModule> {
         auto turboModuleLookup = turboModuleCache_.find(name);
         if (turboModuleLookup != turboModuleCache_.end()) {
@@ -86,8 +86,29 @@ void TurboModuleManager::installJSIBindings() {
         }
 
         return std::shared_ptr<TurboModule>(nullptr);
-      })
-  );
+      });
+  TurboModuleBinding::install(*runtime_, binding_);
+}
+
+TurboModuleManager::~TurboModuleManager() {
+  if (prebindThread_.joinable()) {
+    prebindThread_.join();
+  }
+}
+
+void TurboModuleManager::prebindModules(std::vector<std::string> moduleNames) {
+  if (!binding_ || prebindThread_.joinable()) {
+    return;
+  }
+
+  TurboModuleBinding::prebindModules(
+      binding_,
+      std::move(moduleNames),
+      [this](std::function<void()> &&work) {
+        prebindThread_ = std::thread([work = std::move(work)]() mutable {
+          jni::ThreadScope::WithClassLoader(std::move(work));
+        });
+      });
 }
 
 } // namespace react
@@ -8,10 +8,14 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 #include <fb/fbjni.h>
 #include <jsi/jsi.h>
 #include <ReactCommon/TurboModule.h>
+#include <ReactCommon/TurboModuleBinding.h>
 #include <ReactCommon/JavaTurboModule.h>
 #include <react/jni/CxxModuleWrapper.h>
 #include <react/jni/JMessageQueueThread.h>
@@ -31,6 +35,16 @@ public:
     jni::alias_ref<TurboModuleManagerDelegate::javaobject> delegate
   );
   static void registerNatives();
+
+  ~TurboModuleManager();
+
+  /**
+   * Creates the given modules on a background thread (attached to the JVM),
+   * e.g. while the bundle is loading, so that JS doesn't wait for them on its
+   * first lookup. Must be called after the JSI bindings are installed.
+   */
+  void prebindModules(std::vector<std::string> moduleNames);
+
 private:
   friend HybridBase;
   jni::global_ref<TurboModuleManager::javaobject> javaPart_;
@@ -46,6 +60,11 @@ private:
    */
   std::unordered_map<std::string, std::shared_ptr<react::TurboModule>> turboModuleCache_;
 
+  std::shared_ptr<TurboModuleBinding> binding_;
+  // The provider of binding_ uses this manager, so the thread is joined before
+  // the manager is destroyed.
+  std::thread prebindThread_;
+
   void installJSIBindings();
   explicit TurboModuleManager(
     jni::alias_ref<TurboModuleManager::jhybridobject> jThis,
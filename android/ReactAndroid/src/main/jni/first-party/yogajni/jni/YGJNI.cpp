@@ -13,6 +13,7 @@
 #include <cstring>
 #include <iostream>
 #include <map>
+#include <vector>
 
 #include "YGJTypes.h"
 
@@ -72,6 +73,7 @@ const short int LAYOUT_DIRECTION_INDEX = 5;
 const short int LAYOUT_MARGIN_START_INDEX = 6;
 const short int LAYOUT_PADDING_START_INDEX = 10;
 const short int LAYOUT_BORDER_START_INDEX = 14;
+const short int LAYOUT_MAX_SIZE = 18;
 
 namespace {
 
@@ -145,23 +147,10 @@ static void YGTransferLayoutDirection(
       layoutDirectionField, static_cast<jint>(YGNodeLayoutGetDirection(node)));
 }
 
-static void YGTransferLayoutOutputsRecursive(
-    YGNodeRef root,
-    void* layoutContext) {
-  if (!root->getHasNewLayout()) {
-    return;
-  }
-  auto obj = YGNodeJobject(root, layoutContext);
-  if (!obj) {
-    Log::log(
-        root,
-        YGLogLevelError,
-        nullptr,
-        "Java YGNode was GCed during layout calculation\n");
-    return;
-  }
-
-  auto edgesSet = YGNodeEdges{root};
+// Writes the layout of the node in the layout of the `arr` field of the Java
+// node, returns how many values that took
+static int YGNodeGetLayoutOutputs(YGNodeRef node, float* arr) {
+  auto edgesSet = YGNodeEdges{node};
 
   bool marginFieldSet = edgesSet.has(YGNodeEdges::MARGIN);
   bool paddingFieldSet = edgesSet.has(YGNodeEdges::PADDING);
@@ -169,46 +158,67 @@ static void YGTransferLayoutOutputsRecursive(
 
   int fieldFlags = edgesSet.get();
   fieldFlags |= HAS_NEW_LAYOUT;
-  if (YGNodeLayoutGetDidLegacyStretchFlagAffectLayout(root)) {
+  if (YGNodeLayoutGetDidLegacyStretchFlagAffectLayout(node)) {
     fieldFlags |= DOES_LEGACY_STRETCH_BEHAVIOUR;
   }
 
   const int arrSize = 6 + (marginFieldSet ? 4 : 0) + (paddingFieldSet ? 4 : 0) +
       (borderFieldSet ? 4 : 0);
-  float arr[18];
   arr[LAYOUT_EDGE_SET_FLAG_INDEX] = fieldFlags;
-  arr[LAYOUT_WIDTH_INDEX] = YGNodeLayoutGetWidth(root);
-  arr[LAYOUT_HEIGHT_INDEX] = YGNodeLayoutGetHeight(root);
-  arr[LAYOUT_LEFT_INDEX] = YGNodeLayoutGetLeft(root);
-  arr[LAYOUT_TOP_INDEX] = YGNodeLayoutGetTop(root);
+  arr[LAYOUT_WIDTH_INDEX] = YGNodeLayoutGetWidth(node);
+  arr[LAYOUT_HEIGHT_INDEX] = YGNodeLayoutGetHeight(node);
+  arr[LAYOUT_LEFT_INDEX] = YGNodeLayoutGetLeft(node);
+  arr[LAYOUT_TOP_INDEX] = YGNodeLayoutGetTop(node);
   arr[LAYOUT_DIRECTION_INDEX] =
-      static_cast<jint>(YGNodeLayoutGetDirection(root));
+      static_cast<jint>(YGNodeLayoutGetDirection(node));
   if (marginFieldSet) {
-    arr[LAYOUT_MARGIN_START_INDEX] = YGNodeLayoutGetMargin(root, YGEdgeLeft);
-    arr[LAYOUT_MARGIN_START_INDEX + 1] = YGNodeLayoutGetMargin(root, YGEdgeTop);
+    arr[LAYOUT_MARGIN_START_INDEX] = YGNodeLayoutGetMargin(node, YGEdgeLeft);
+    arr[LAYOUT_MARGIN_START_INDEX + 1] = YGNodeLayoutGetMargin(node, YGEdgeTop);
     arr[LAYOUT_MARGIN_START_INDEX + 2] =
-        YGNodeLayoutGetMargin(root, YGEdgeRight);
+        YGNodeLayoutGetMargin(node, YGEdgeRight);
     arr[LAYOUT_MARGIN_START_INDEX + 3] =
-        YGNodeLayoutGetMargin(root, YGEdgeBottom);
+        YGNodeLayoutGetMargin(node, YGEdgeBottom);
   }
   if (paddingFieldSet) {
     int paddingStartIndex =
         LAYOUT_PADDING_START_INDEX - (marginFieldSet ? 0 : 4);
-    arr[paddingStartIndex] = YGNodeLayoutGetPadding(root, YGEdgeLeft);
-    arr[paddingStartIndex + 1] = YGNodeLayoutGetPadding(root, YGEdgeTop);
-    arr[paddingStartIndex + 2] = YGNodeLayoutGetPadding(root, YGEdgeRight);
-    arr[paddingStartIndex + 3] = YGNodeLayoutGetPadding(root, YGEdgeBottom);
+    arr[paddingStartIndex] = YGNodeLayoutGetPadding(node, YGEdgeLeft);
+    arr[paddingStartIndex + 1] = YGNodeLayoutGetPadding(node, YGEdgeTop);
+    arr[paddingStartIndex + 2] = YGNodeLayoutGetPadding(node, YGEdgeRight);
+    arr[paddingStartIndex + 3] = YGNodeLayoutGetPadding(node, YGEdgeBottom);
   }
 
   if (borderFieldSet) {
     int borderStartIndex = LAYOUT_BORDER_START_INDEX -
         (marginFieldSet ? 0 : 4) - (paddingFieldSet ? 0 : 4);
-    arr[borderStartIndex] = YGNodeLayoutGetBorder(root, YGEdgeLeft);
-    arr[borderStartIndex + 1] = YGNodeLayoutGetBorder(root, YGEdgeTop);
-    arr[borderStartIndex + 2] = YGNodeLayoutGetBorder(root, YGEdgeRight);
-    arr[borderStartIndex + 3] = YGNodeLayoutGetBorder(root, YGEdgeBottom);
+    arr[borderStartIndex] = YGNodeLayoutGetBorder(node, YGEdgeLeft);
+    arr[borderStartIndex + 1] = YGNodeLayoutGetBorder(node, YGEdgeTop);
+    arr[borderStartIndex + 2] = YGNodeLayoutGetBorder(node, YGEdgeRight);
+    arr[borderStartIndex + 3] = YGNodeLayoutGetBorder(node, YGEdgeBottom);
+  }
+
+  return arrSize;
+}
+
+static void YGTransferLayoutOutputsRecursive(
+    YGNodeRef root,
+    void* layoutContext) {
+  if (!root->getHasNewLayout()) {
+    return;
+  }
+  auto obj = YGNodeJobject(root, layoutContext);
+  if (!obj) {
+    Log::log(
+        root,
+        YGLogLevelError,
+        nullptr,
+        "Java YGNode was GCed during layout calculation\n");
+    return;
   }
 
+  float arr[LAYOUT_MAX_SIZE];
+  const int arrSize = YGNodeGetLayoutOutputs(root, arr);
+
   static auto arrField = obj->getClass()->getField<jfloatArray>("arr");
   local_ref<jfloatArray> arrFinal = make_float_array(arrSize);
   arrFinal->setRegion(0, arrSize, arr);
@@ -415,6 +425,45 @@ void jni_YGNodeCalculateLayout(
   YGTransferLayoutOutputsRecursive(root, layoutContext);
 }
 
+// Same as jni_YGNodeCalculateLayout, but rather than setting `arr` on every
+// Java node with a new layout, which is three JNI calls per node, writes the
+// layouts of all nodes in `nativePointers` to `layouts` with one. The layout of
+// the i-th node starts at `i * LAYOUT_MAX_SIZE`, a zero flags value means that
+// the node has no new layout.
+void jni_YGNodeCalculateLayoutBatch(
+    alias_ref<jclass>,
+    jlong nativePointer,
+    jfloat width,
+    jfloat height,
+    alias_ref<JArrayLong> nativePointers,
+    alias_ref<JArrayClass<JYogaNode::javaobject>> javaNodes,
+    alias_ref<JArrayFloat> layouts) {
+  auto map = PtrJNodeMap{nativePointers, javaNodes};
+
+  const YGNodeRef root = _jlong2YGNodeRef(nativePointer);
+  YGNodeCalculateLayoutWithContext(
+      root,
+      static_cast<float>(width),
+      static_cast<float>(height),
+      YGNodeStyleGetDirection(root),
+      &map);
+
+  const size_t size = nativePointers->size();
+  std::vector<float> outputs(size * LAYOUT_MAX_SIZE, 0.0f);
+  {
+    auto pin = nativePointers->pinCritical();
+    auto ptrs = pin.get();
+    for (size_t i = 0; i < size; i++) {
+      const YGNodeRef node = _jlong2YGNodeRef(ptrs[i]);
+      if (node->getHasNewLayout()) {
+        YGNodeGetLayoutOutputs(node, &outputs[i * LAYOUT_MAX_SIZE]);
+        node->setHasNewLayout(false);
+      }
+    }
+  }
+  layouts->setRegion(0, outputs.size(), outputs.data());
+}
+
 void jni_YGNodeMarkDirty(jlong nativePointer) {
   YGNodeMarkDirty(_jlong2YGNodeRef(nativePointer));
 }
@@ -818,6 +867,37 @@ void jni_YGNodeSetStyleInputs(
   YGNodeSetStyleInputs(_jlong2YGNodeRef(nativePointer), result, size);
 }
 
+// Sets the style inputs of several nodes in one call. The inputs of the i-th
+// node in `nativePointers` are the next `sizes[i]` values of `styleInputs`, in
+// the same format as for jni_YGNodeSetStyleInputs.
+void jni_YGNodeSetStyleInputsBatch(
+    alias_ref<jclass>,
+    alias_ref<JArrayLong> nativePointers,
+    alias_ref<JArrayInt> sizes,
+    alias_ref<JArrayFloat> styleInputs) {
+  const size_t nodeCount = nativePointers->size();
+  std::vector<jlong> ptrs(nodeCount);
+  std::vector<jint> inputCounts(nodeCount);
+  std::vector<float> inputs(styleInputs->size());
+  nativePointers->getRegion(0, nodeCount, ptrs.data());
+  sizes->getRegion(0, nodeCount, inputCounts.data());
+  styleInputs->getRegion(0, inputs.size(), inputs.data());
+
+  size_t offset = 0;
+  for (size_t i = 0; i < nodeCount; i++) {
+    const size_t count = static_cast<size_t>(inputCounts[i]);
+    if (offset + count > inputs.size()) {
+      throwNewJavaException(
+          "java/lang/IllegalArgumentException",
+          "Style inputs of node %zu are out of bounds",
+          i);
+    }
+    YGNodeSetStyleInputs(
+        _jlong2YGNodeRef(ptrs[i]), &inputs[offset], static_cast<int>(count));
+    offset += count;
+  }
+}
+
 jlong jni_YGNodeStyleGetMargin(jlong nativePointer, jint edge) {
   YGNodeRef yogaNodeRef = _jlong2YGNodeRef(nativePointer);
   if (!YGNodeEdges{yogaNodeRef}.has(YGNodeEdges::MARGIN)) {
@@ -910,6 +990,7 @@ jint JNI_OnLoad(JavaVM* vm, void*) {
             YGMakeCriticalNativeMethod(jni_YGNodeSetIsReferenceBaseline),
             YGMakeCriticalNativeMethod(jni_YGNodeIsReferenceBaseline),
             YGMakeNativeMethod(jni_YGNodeCalculateLayout),
+            YGMakeNativeMethod(jni_YGNodeCalculateLayoutBatch),
             YGMakeCriticalNativeMethod(jni_YGNodeMarkDirty),
             YGMakeCriticalNativeMethod(
                 jni_YGNodeMarkDirtyAndPropogateToDescendants),
@@ -984,6 +1065,7 @@ jint JNI_OnLoad(JavaVM* vm, void*) {
             YGMakeCriticalNativeMethod(jni_YGNodePrint),
             YGMakeNativeMethod(jni_YGNodeClone),
             YGMakeNativeMethod(jni_YGNodeSetStyleInputs),
+            YGMakeNativeMethod(jni_YGNodeSetStyleInputsBatch),
             YGMakeNativeMethod(jni_YGConfigNew),
             YGMakeNativeMethod(jni_YGConfigFree),
             YGMakeNativeMethod(jni_YGConfigSetExperimentalFeatureEnabled),
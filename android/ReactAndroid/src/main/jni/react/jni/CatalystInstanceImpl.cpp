@@ -10,6 +10,7 @@
 #include <sstream>
 #include <vector>
 
+#include <cxxreact/CxxModuleQueues.h>
 #include <cxxreact/CxxNativeModule.h>
 #include <cxxreact/Instance.h>
 #include <cxxreact/JSBigString.h>
@@ -29,6 +30,7 @@
 #include <ReactCommon/JSCallInvokerHolder.h>
 
 #include "CxxModuleWrapper.h"
+#include "FlatDynamic.h"
 #include "JavaScriptExecutorHolder.h"
 #include "JNativeRunnable.h"
 #include "JniJSModulesUnbundle.h"
@@ -111,6 +113,8 @@ void CatalystInstanceImpl::registerNatives() {
     makeNativeMethod("jniLoadScriptFromDeltaBundle", CatalystInstanceImpl::jniLoadScriptFromDeltaBundle),
     makeNativeMethod("jniCallJSFunction", CatalystInstanceImpl::jniCallJSFunction),
     makeNativeMethod("jniCallJSCallback", CatalystInstanceImpl::jniCallJSCallback),
+    makeNativeMethod("jniCallJSFunctionFlat", CatalystInstanceImpl::jniCallJSFunctionFlat),
+    makeNativeMethod("jniCallJSCallbackFlat", CatalystInstanceImpl::jniCallJSCallbackFlat),
     makeNativeMethod("setGlobalVariable", CatalystInstanceImpl::setGlobalVariable),
     makeNativeMethod("getJavaScriptContext", CatalystInstanceImpl::getJavaScriptContext),
     makeNativeMethod("getJSCallInvokerHolder", CatalystInstanceImpl::getJSCallInvokerHolder),
@@ -131,6 +135,11 @@ void CatalystInstanceImpl::initializeBridge(
   // TODO mhorowitz: how to assert here?
   // Assertions.assertCondition(mBridge == null, "initializeBridge should be called once");
   moduleMessageQueue_ = std::make_shared<JMessageQueueThread>(nativeModulesQueue);
+  cxxModuleQueues_ = std::make_shared<CxxModuleQueues>(
+    [](std::function<void()>&& loop) {
+      // Modules may call into Java, like on the native modules queue.
+      jni::ThreadScope::WithClassLoader(std::move(loop));
+    });
 
   // This used to be:
   //
@@ -153,7 +162,8 @@ void CatalystInstanceImpl::initializeBridge(
        std::weak_ptr<Instance>(instance_),
        javaModules,
        cxxModules,
-       moduleMessageQueue_));
+       moduleMessageQueue_,
+       cxxModuleQueues_));
 
   instance_->initializeBridge(
     std::make_unique<JInstanceCallback>(
@@ -171,7 +181,8 @@ void CatalystInstanceImpl::extendNativeModules(
     std::weak_ptr<Instance>(instance_),
     javaModules,
     cxxModules,
-    moduleMessageQueue_));
+    moduleMessageQueue_,
+    cxxModuleQueues_));
 }
 
 void CatalystInstanceImpl::jniSetSourceURL(const std::string& sourceURL) {
@@ -210,13 +221,25 @@ void CatalystInstanceImpl::jniLoadScriptFromAssets(
 void CatalystInstanceImpl::jniLoadScriptFromFile(const std::string& fileName,
                                                  const std::string& sourceURL,
                                                  bool loadSynchronously) {
-  if (Instance::isIndexedRAMBundle(fileName.c_str())) {
+  auto scriptTag = Instance::getScriptTag(fileName.c_str());
+  if (scriptTag == ScriptTag::RAMBundle) {
     instance_->loadRAMBundleFromFile(fileName, sourceURL, loadSynchronously);
   } else {
     std::unique_ptr<const JSBigFileString> script;
     RecoverableError::runRethrowingAsRecoverable<std::system_error>(
-      [&fileName, &script]() {
-        script = JSBigFileString::fromPath(fileName);
+      [&fileName, &script, scriptTag]() {
+        JSBigFileMappingPolicy policy;
+        if (scriptTag != ScriptTag::HBCBundle) {
+          // The engine parses a plain bundle from the beginning to the end,
+          // so it is read in eagerly.
+          policy.access = JSBigFileMappingPolicy::Access::Sequential;
+          policy.populateSize = SIZE_MAX;
+        }
+        // Bytecode is run straight from the mapping, which starts at a page
+        // (the beginning of the file), and only the pages of the functions
+        // which run are read. They stay clean page cache pages, shared with
+        // anything else mapping the file.
+        script = JSBigFileString::fromPath(fileName, policy);
       });
     instance_->loadScriptFromString(std::move(script), sourceURL, loadSynchronously);
   }
@@ -260,6 +283,24 @@ void CatalystInstanceImpl::jniCallJSCallback(jint callbackId, NativeArray* argum
   instance_->callJSCallback(callbackId, arguments->consume());
 }
 
+void CatalystInstanceImpl::jniCallJSFunctionFlat(
+    std::string module,
+    std::string method,
+    jni::alias_ref<jni::JByteBuffer> arguments,
+    jint size) {
+  instance_->callJSFunction(std::move(module),
+                            std::move(method),
+                            FlatDynamicArguments::fromBuffer(arguments, size));
+}
+
+void CatalystInstanceImpl::jniCallJSCallbackFlat(
+    jint callbackId,
+    jni::alias_ref<jni::JByteBuffer> arguments,
+    jint size) {
+  instance_->callJSCallback(
+    callbackId, FlatDynamicArguments::fromBuffer(arguments, size));
+}
+
 void CatalystInstanceImpl::setGlobalVariable(std::string propName,
                                              std::string&& jsonValue) {
   // This is only ever called from Java with short strings, and only
@@ -279,7 +320,10 @@ void CatalystInstanceImpl::handleMemoryPressure(int pressureLevel) {
 
 jni::alias_ref<JSCallInvokerHolder::javaobject> CatalystInstanceImpl::getJSCallInvokerHolder() {
   if (!javaInstanceHolder_) {
-    jsCallInvoker_ = std::make_shared<BridgeJSCallInvoker>(instance_);
+    // TurboModules resolve callbacks through it, so the callbacks resolved in
+    // a burst run in one JS thread task.
+    jsCallInvoker_ = std::make_shared<BatchedJSCallInvoker>(
+      std::make_shared<BridgeJSCallInvoker>(instance_));
     javaInstanceHolder_ = jni::make_global(JSCallInvokerHolder::newObjectCxxArgs(jsCallInvoker_));
   }
 
@@ -6,8 +6,10 @@
 #include <string>
 
 #include <fb/fbjni.h>
+#include <fb/fbjni/ByteBuffer.h>
 #include <folly/Memory.h>
 #include <ReactCommon/JSCallInvokerHolder.h>
+#include <ReactCommon/BatchedJSCallInvoker.h>
 #include <ReactCommon/BridgeJSCallInvoker.h>
 
 #include "CxxModuleWrapper.h"
@@ -20,6 +22,7 @@
 namespace facebook {
 namespace react {
 
+class CxxModuleQueues;
 class Instance;
 class JavaScriptExecutorHolder;
 class NativeArray;
@@ -76,6 +79,19 @@ class CatalystInstanceImpl : public jni::HybridClass<CatalystInstanceImpl> {
   void jniLoadScriptFromDeltaBundle(const std::string& sourceURL, jni::alias_ref<NativeDeltaClient::jhybridobject> deltaClient, bool loadSynchronously);
   void jniCallJSFunction(std::string module, std::string method, NativeArray* arguments);
   void jniCallJSCallback(jint callbackId, NativeArray* arguments);
+  // Same as above, with the arguments serialized by FlatDynamic.Builder into
+  // the first size bytes of a direct ByteBuffer. The JS thread makes JS values
+  // of them directly, which saves building (and then converting) a
+  // folly::dynamic per call, e.g. for high-rate device events.
+  void jniCallJSFunctionFlat(
+    std::string module,
+    std::string method,
+    jni::alias_ref<jni::JByteBuffer> arguments,
+    jint size);
+  void jniCallJSCallbackFlat(
+    jint callbackId,
+    jni::alias_ref<jni::JByteBuffer> arguments,
+    jint size);
   jni::alias_ref<JSCallInvokerHolder::javaobject> getJSCallInvokerHolder();
   void setGlobalVariable(std::string propName,
                          std::string&& jsonValue);
@@ -87,8 +103,10 @@ class CatalystInstanceImpl : public jni::HybridClass<CatalystInstanceImpl> {
   std::shared_ptr<Instance> instance_;
   std::shared_ptr<ModuleRegistry> moduleRegistry_;
   std::shared_ptr<JMessageQueueThread> moduleMessageQueue_;
+  // The queues of C++ modules which don't run on moduleMessageQueue_.
+  std::shared_ptr<CxxModuleQueues> cxxModuleQueues_;
   jni::global_ref<JSCallInvokerHolder::javaobject> javaInstanceHolder_;
-  std::shared_ptr<BridgeJSCallInvoker> jsCallInvoker_;
+  std::shared_ptr<BatchedJSCallInvoker> jsCallInvoker_;
 };
 
 }}
@@ -0,0 +1,375 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "FlatDynamic.h"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <folly/Bits.h>
+
+using namespace facebook::jni;
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+constexpr size_t kTypeSize = 1;
+constexpr size_t kLengthSize = sizeof(uint32_t);
+
+void checkLength(size_t length) {
+  if (length > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Value too large to be serialized");
+  }
+}
+
+uint8_t* writeType(FlatDynamicType type, uint8_t* out) {
+  *out = static_cast<uint8_t>(type);
+  return out + kTypeSize;
+}
+
+uint8_t* writeLength(size_t length, uint8_t* out) {
+  checkLength(length);
+  uint32_t value = folly::Endian::little(static_cast<uint32_t>(length));
+  std::memcpy(out, &value, sizeof(value));
+  return out + sizeof(value);
+}
+
+uint8_t* writeString(const std::string& string, uint8_t* out) {
+  out = writeLength(string.size(), out);
+  std::memcpy(out, string.data(), string.size());
+  return out + string.size();
+}
+
+// The size of the contents of an array or map, after its count and size.
+// The writer fills in the size afterwards instead, so nested values are only
+// measured once.
+size_t contentsSize(const folly::dynamic& value) {
+  size_t size = 0;
+  if (value.isArray()) {
+    for (const auto& element : value) {
+      size += flatDynamicSize(element);
+    }
+  } else {
+    for (const auto& entry : value.items()) {
+      size += kLengthSize + entry.first.getString().size() +
+          flatDynamicSize(entry.second);
+    }
+  }
+  return size;
+}
+
+local_ref<JByteBuffer> serialize(const folly::dynamic& value) {
+  static auto allocateDirect =
+      JByteBuffer::javaClassStatic()
+          ->getStaticMethod<local_ref<JByteBuffer>(jint)>("allocateDirect");
+  const size_t size = flatDynamicSize(value);
+  if (size > static_cast<size_t>(std::numeric_limits<jint>::max())) {
+    throw std::length_error("Value too large to be serialized");
+  }
+  auto buffer = allocateDirect(
+      JByteBuffer::javaClassStatic(), static_cast<jint>(size));
+  writeFlatDynamic(value, buffer->getDirectBytes());
+  return buffer;
+}
+
+class FlatDynamicReader {
+ public:
+  FlatDynamicReader(const uint8_t* data, size_t size)
+      : in_(data), end_(data + size) {}
+
+  bool atEnd() const {
+    return in_ == end_;
+  }
+
+  FlatDynamicType readType() {
+    return static_cast<FlatDynamicType>(*take(kTypeSize));
+  }
+
+  folly::dynamic readValue(FlatDynamicType type) {
+    switch (type) {
+      case FlatDynamicType::Null:
+        return nullptr;
+      case FlatDynamicType::False:
+        return false;
+      case FlatDynamicType::True:
+        return true;
+      case FlatDynamicType::Number:
+        return readNumber();
+      case FlatDynamicType::String:
+        return readString();
+      case FlatDynamicType::Array: {
+        uint32_t count = readLength();
+        readLength();
+        folly::dynamic array = folly::dynamic::array();
+        for (uint32_t i = 0; i < count; i++) {
+          array.push_back(readValue(readType()));
+        }
+        return array;
+      }
+      case FlatDynamicType::Map: {
+        uint32_t count = readLength();
+        readLength();
+        folly::dynamic map = folly::dynamic::object();
+        for (uint32_t i = 0; i < count; i++) {
+          std::string key = readString();
+          map.insert(std::move(key), readValue(readType()));
+        }
+        return map;
+      }
+      default:
+        throw std::invalid_argument("Unknown serialized type");
+    }
+  }
+
+  jsi::Value readJSValue(jsi::Runtime& runtime, FlatDynamicType type) {
+    switch (type) {
+      case FlatDynamicType::Null:
+        return jsi::Value::null();
+      case FlatDynamicType::False:
+        return jsi::Value(false);
+      case FlatDynamicType::True:
+        return jsi::Value(true);
+      case FlatDynamicType::Number:
+        return jsi::Value(readNumber());
+      case FlatDynamicType::String: {
+        uint32_t length = readLength();
+        return jsi::String::createFromUtf8(runtime, take(length), length);
+      }
+      case FlatDynamicType::Array: {
+        uint32_t count = readLength();
+        readLength();
+        jsi::Array array(runtime, count);
+        for (uint32_t i = 0; i < count; i++) {
+          array.setValueAtIndex(runtime, i, readJSValue(runtime, readType()));
+        }
+        return std::move(array);
+      }
+      case FlatDynamicType::Map: {
+        uint32_t count = readLength();
+        readLength();
+        jsi::Object map(runtime);
+        for (uint32_t i = 0; i < count; i++) {
+          uint32_t length = readLength();
+          auto key = jsi::PropNameID::forUtf8(runtime, take(length), length);
+          map.setProperty(runtime, key, readJSValue(runtime, readType()));
+        }
+        return std::move(map);
+      }
+      default:
+        throw std::invalid_argument("Unknown serialized type");
+    }
+  }
+
+ private:
+  const uint8_t* take(size_t size) {
+    if (static_cast<size_t>(end_ - in_) < size) {
+      throw std::invalid_argument("Serialized value is truncated");
+    }
+    const uint8_t* data = in_;
+    in_ += size;
+    return data;
+  }
+
+  uint32_t readLength() {
+    uint32_t value;
+    std::memcpy(&value, take(sizeof(value)), sizeof(value));
+    return folly::Endian::little(value);
+  }
+
+  double readNumber() {
+    uint64_t bits;
+    std::memcpy(&bits, take(sizeof(bits)), sizeof(bits));
+    bits = folly::Endian::little(bits);
+    double number;
+    std::memcpy(&number, &bits, sizeof(number));
+    return number;
+  }
+
+  std::string readString() {
+    uint32_t length = readLength();
+    return std::string(reinterpret_cast<const char*>(take(length)), length);
+  }
+
+  const uint8_t* in_;
+  const uint8_t* end_;
+};
+
+void checkBuffer(alias_ref<JByteBuffer> buffer, jint size) {
+  if (!buffer->isDirect()) {
+    throw std::invalid_argument("Serialized value must be in a direct buffer");
+  }
+  if (size < 0 || static_cast<size_t>(size) > buffer->getDirectSize()) {
+    throw std::invalid_argument("Serialized size exceeds the buffer");
+  }
+}
+
+folly::dynamic deserialize(
+    alias_ref<JByteBuffer> buffer,
+    jint size,
+    FlatDynamicType expectedType) {
+  checkBuffer(buffer, size);
+  FlatDynamicReader reader(buffer->getDirectBytes(), size);
+  if (reader.readType() != expectedType) {
+    throw std::invalid_argument("Serialized value has the wrong type");
+  }
+  folly::dynamic value = reader.readValue(expectedType);
+  if (!reader.atEnd()) {
+    throw std::invalid_argument("Serialized value is followed by garbage");
+  }
+  return value;
+}
+
+} // namespace
+
+size_t flatDynamicSize(const folly::dynamic& value) {
+  switch (value.type()) {
+    case folly::dynamic::Type::BOOL:
+      return kTypeSize;
+    case folly::dynamic::Type::INT64:
+    case folly::dynamic::Type::DOUBLE:
+      return kTypeSize + sizeof(double);
+    case folly::dynamic::Type::STRING:
+      return kTypeSize + kLengthSize + value.getString().size();
+    case folly::dynamic::Type::ARRAY:
+    case folly::dynamic::Type::OBJECT:
+      return kTypeSize + 2 * kLengthSize + contentsSize(value);
+    default:
+      return kTypeSize;
+  }
+}
+
+uint8_t* writeFlatDynamic(const folly::dynamic& value, uint8_t* out) {
+  switch (value.type()) {
+    case folly::dynamic::Type::BOOL:
+      return writeType(
+          value.getBool() ? FlatDynamicType::True : FlatDynamicType::False,
+          out);
+    case folly::dynamic::Type::INT64:
+    case folly::dynamic::Type::DOUBLE: {
+      out = writeType(FlatDynamicType::Number, out);
+      uint64_t bits;
+      double number = value.asDouble();
+      std::memcpy(&bits, &number, sizeof(bits));
+      bits = folly::Endian::little(bits);
+      std::memcpy(out, &bits, sizeof(bits));
+      return out + sizeof(bits);
+    }
+    case folly::dynamic::Type::STRING:
+      return writeString(value.getString(), writeType(FlatDynamicType::String, out));
+    case folly::dynamic::Type::ARRAY: {
+      out = writeType(FlatDynamicType::Array, out);
+      out = writeLength(value.size(), out);
+      uint8_t* contents = out + kLengthSize;
+      out = contents;
+      for (const auto& element : value) {
+        out = writeFlatDynamic(element, out);
+      }
+      writeLength(out - contents, contents - kLengthSize);
+      return out;
+    }
+    case folly::dynamic::Type::OBJECT: {
+      out = writeType(FlatDynamicType::Map, out);
+      out = writeLength(value.size(), out);
+      uint8_t* contents = out + kLengthSize;
+      out = contents;
+      for (const auto& entry : value.items()) {
+        out = writeString(entry.first.getString(), out);
+        out = writeFlatDynamic(entry.second, out);
+      }
+      writeLength(out - contents, contents - kLengthSize);
+      return out;
+    }
+    default:
+      return writeType(FlatDynamicType::Null, out);
+  }
+}
+
+folly::dynamic readFlatDynamic(const uint8_t* data, size_t size) {
+  FlatDynamicReader reader(data, size);
+  folly::dynamic value = reader.readValue(reader.readType());
+  if (!reader.atEnd()) {
+    throw std::invalid_argument("Serialized value is followed by garbage");
+  }
+  return value;
+}
+
+jsi::Value readFlatDynamicValue(
+    jsi::Runtime& runtime,
+    const uint8_t* data,
+    size_t size) {
+  FlatDynamicReader reader(data, size);
+  jsi::Value value = reader.readJSValue(runtime, reader.readType());
+  if (!reader.atEnd()) {
+    throw std::invalid_argument("Serialized value is followed by garbage");
+  }
+  return value;
+}
+
+std::shared_ptr<const FlatDynamicArguments> FlatDynamicArguments::fromBuffer(
+    alias_ref<JByteBuffer> buffer,
+    jint size) {
+  checkBuffer(buffer, size);
+  const uint8_t* data = buffer->getDirectBytes();
+  if (size == 0 || data[0] != static_cast<uint8_t>(FlatDynamicType::Array)) {
+    throw std::invalid_argument("Serialized arguments must be an array");
+  }
+  return std::make_shared<FlatDynamicArguments>(
+      std::vector<uint8_t>(data, data + size));
+}
+
+jsi::Value FlatDynamicArguments::toJSValue(jsi::Runtime& runtime) const {
+  return readFlatDynamicValue(runtime, bytes_.data(), bytes_.size());
+}
+
+folly::dynamic FlatDynamicArguments::toDynamic() const {
+  return readFlatDynamic(bytes_.data(), bytes_.size());
+}
+
+local_ref<JByteBuffer> FlatDynamic::serializeMap(
+    alias_ref<jclass>,
+    alias_ref<NativeMap::jhybridobject> map) {
+  auto nativeMap = map->cthis();
+  nativeMap->throwIfConsumed();
+  return serialize(nativeMap->map_);
+}
+
+local_ref<JByteBuffer> FlatDynamic::serializeArray(
+    alias_ref<jclass>,
+    alias_ref<NativeArray::jhybridobject> array) {
+  auto nativeArray = array->cthis();
+  nativeArray->throwIfConsumed();
+  return serialize(nativeArray->array_);
+}
+
+local_ref<WritableNativeMap::jhybridobject> FlatDynamic::deserializeMap(
+    alias_ref<jclass>,
+    alias_ref<JByteBuffer> buffer,
+    jint size) {
+  return WritableNativeMap::newObjectCxxArgs(
+      deserialize(buffer, size, FlatDynamicType::Map));
+}
+
+local_ref<WritableNativeArray::jhybridobject> FlatDynamic::deserializeArray(
+    alias_ref<jclass>,
+    alias_ref<JByteBuffer> buffer,
+    jint size) {
+  return WritableNativeArray::newObjectCxxArgs(
+      deserialize(buffer, size, FlatDynamicType::Array));
+}
+
+void FlatDynamic::registerNatives() {
+  javaClassStatic()->registerNatives({
+      makeNativeMethod("serializeMap", FlatDynamic::serializeMap),
+      makeNativeMethod("serializeArray", FlatDynamic::serializeArray),
+      makeNativeMethod("deserializeMap", FlatDynamic::deserializeMap),
+      makeNativeMethod("deserializeArray", FlatDynamic::deserializeArray),
+  });
+}
+
+} // namespace react
+} // namespace facebook
@@ -0,0 +1,114 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <cxxreact/JSExecutor.h>
+#include <fb/fbjni.h>
+#include <fb/fbjni/ByteBuffer.h>
+#include <folly/dynamic.h>
+
+#include "NativeArray.h"
+#include "NativeMap.h"
+#include "WritableNativeArray.h"
+#include "WritableNativeMap.h"
+
+namespace facebook {
+namespace react {
+
+// Serializes a folly::dynamic into a flat buffer which Java can read without
+// any JNI calls (see FlatDynamic.java), and the other way around, so Java can
+// build a whole map or array with a single JNI call. All numbers are little-endian. A value
+// is a type byte, followed by:
+//   Null, False, True: nothing.
+//   Number: an IEEE 754 double (integers are converted to doubles, like
+//     everywhere else in the bridge).
+//   String: a uint32 byte length and the UTF-8 bytes.
+//   Array: a uint32 element count, the uint32 byte size of the elements, and
+//     the elements.
+//   Map: a uint32 entry count, the uint32 byte size of the entries, and the
+//     entries, each of which is a key (as the payload of a string) and a
+//     value.
+// The byte sizes let readers skip over nested values.
+enum class FlatDynamicType : uint8_t {
+  Null = 0,
+  False = 1,
+  True = 2,
+  Number = 3,
+  String = 4,
+  Array = 5,
+  Map = 6,
+};
+
+// The size of the serialization of value.
+size_t flatDynamicSize(const folly::dynamic& value);
+
+// Writes the serialization of value to out, which must have room for
+// flatDynamicSize(value) bytes, and returns the end of what was written.
+uint8_t* writeFlatDynamic(const folly::dynamic& value, uint8_t* out);
+
+// Reads the serialization of a value from [data, data + size). Throws
+// std::invalid_argument if it is malformed or doesn't fill the range.
+folly::dynamic readFlatDynamic(const uint8_t* data, size_t size);
+
+// Same as readFlatDynamic, but makes JS values directly.
+jsi::Value readFlatDynamicValue(
+    jsi::Runtime& runtime,
+    const uint8_t* data,
+    size_t size);
+
+// The arguments of a call into JS as a serialized array, e.g. from
+// FlatDynamic.Builder, which the JS thread turns into JS values without
+// building a folly::dynamic.
+class FlatDynamicArguments : public JSArguments {
+ public:
+  // Copies the first size bytes of a direct ByteBuffer, which must hold a
+  // serialized array.
+  static std::shared_ptr<const FlatDynamicArguments> fromBuffer(
+      jni::alias_ref<jni::JByteBuffer> buffer,
+      jint size);
+
+  explicit FlatDynamicArguments(std::vector<uint8_t> bytes)
+      : bytes_(std::move(bytes)) {}
+
+  jsi::Value toJSValue(jsi::Runtime& runtime) const override;
+  folly::dynamic toDynamic() const override;
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+struct FlatDynamic : jni::JavaClass<FlatDynamic> {
+  static auto constexpr kJavaDescriptor =
+      "Lcom/facebook/react/bridge/FlatDynamic;";
+
+  // Each returns a new direct ByteBuffer holding the serialization.
+  static jni::local_ref<jni::JByteBuffer> serializeMap(
+      jni::alias_ref<jclass>,
+      jni::alias_ref<NativeMap::jhybridobject> map);
+  static jni::local_ref<jni::JByteBuffer> serializeArray(
+      jni::alias_ref<jclass>,
+      jni::alias_ref<NativeArray::jhybridobject> array);
+
+  // Each makes a new native map or array from the first size bytes of a
+  // direct ByteBuffer, which must hold a serialized map or array.
+  static jni::local_ref<WritableNativeMap::jhybridobject> deserializeMap(
+      jni::alias_ref<jclass>,
+      jni::alias_ref<jni::JByteBuffer> buffer,
+      jint size);
+  static jni::local_ref<WritableNativeArray::jhybridobject> deserializeArray(
+      jni::alias_ref<jclass>,
+      jni::alias_ref<jni::JByteBuffer> buffer,
+      jint size);
+
+  static void registerNatives();
+};
+
+} // namespace react
+} // namespace facebook
@@ -45,17 +45,31 @@ std::function<void()> wrapRunnable(std::function<void()>&& runnable) {
 }
 
 JMessageQueueThread::JMessageQueueThread(alias_ref<JavaMessageQueueThread::javaobject> jobj) :
-    m_jobj(make_global(jobj)) {
+    m_jobj(make_global(jobj)),
+    m_tasks(std::make_shared<PriorityTaskQueue>()) {
 }
 
 void JMessageQueueThread::runOnQueue(std::function<void()>&& runnable) {
+  runOnQueueWithPriority(std::move(runnable), MessageQueuePriority::Normal);
+}
+
+void JMessageQueueThread::runOnQueueWithPriority(
+    std::function<void()>&& runnable,
+    MessageQueuePriority priority,
+    MessageQueueDeadline deadline) {
+  m_tasks->push(wrapRunnable(std::move(runnable)), priority, deadline);
+
   // For C++ modules, this can be called from an arbitrary thread
   // managed by the module, via callJSCallback or callJSFunction.  So,
   // we ensure that it is registered with the JVM.
   jni::ThreadScope guard;
   static auto method = JavaMessageQueueThread::javaClassStatic()->
     getMethod<void(Runnable::javaobject)>("runOnQueue");
-  method(m_jobj, JNativeRunnable::newObjectCxxArgs(wrapRunnable(std::move(runnable))).get());
+  method(m_jobj, JNativeRunnable::newObjectCxxArgs([tasks=m_tasks] {
+    if (auto task = tasks->pop()) {
+      task();
+    }
+  }).get());
 }
 
 void JMessageQueueThread::runOnQueueSync(std::function<void()>&& runnable) {
@@ -69,6 +83,9 @@ void JMessageQueueThread::runOnQueueSync(std::function<void()>&& runnable) {
     std::condition_variable signalCv;
     bool runnableComplete = false;
 
+    // Same lane as runOnQueue. Callers (Instance::initializeBridge,
+    // NativeToJsBridge::destroy) expect the work queued before them to run
+    // first, as on queues without lanes.
     runOnQueue([&] () mutable {
       std::lock_guard<std::mutex> lock(signalMutex);
 
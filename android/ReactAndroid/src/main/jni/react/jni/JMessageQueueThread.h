@@ -6,8 +6,10 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 
 #include <cxxreact/MessageQueueThread.h>
+#include <cxxreact/PriorityTaskQueue.h>
 #include <fb/fbjni.h>
 
 using namespace facebook::jni;
@@ -29,10 +31,21 @@ public:
    */
   void runOnQueue(std::function<void()>&& runnable) override;
 
+  /**
+   * Enqueues the given function to run on this MessageQueueThread before
+   * functions of lower priority which haven't started yet.
+   */
+  void runOnQueueWithPriority(
+      std::function<void()>&& runnable,
+      MessageQueuePriority priority,
+      MessageQueueDeadline deadline = MessageQueueDeadline::max()) override;
+
   /**
    * Synchronously executes the given function to run on this
    * MessageQueueThread, waiting until it completes.  Can be called from any
    * thread, but will block if not called on this MessageQueueThread.
+   * The function is queued in the Normal lane like `runOnQueue`, so it runs
+   * after the work queued there before it.
    */
   void runOnQueueSync(std::function<void()>&& runnable) override;
 
@@ -48,6 +61,10 @@ public:
 
 private:
   global_ref<JavaMessageQueueThread::javaobject> m_jobj;
+  // The Java queue runs in order, so each runnable posted to it runs the
+  // next native task by priority. Shared with the runnables, which can
+  // outlive this object.
+  std::shared_ptr<PriorityTaskQueue> m_tasks;
 };
 
 } }
@@ -6,6 +6,7 @@
 #include "JReactMarker.h"
 #include <mutex>
 #include <cxxreact/ReactMarker.h>
+#include <cxxreact/ReactMarkerTimeline.h>
 #include <fb/fbjni.h>
 
 namespace facebook {
@@ -31,6 +32,10 @@ void JReactMarker::logMarker(const std::string& marker, const std::string& tag)
 }
 
 void JReactMarker::logPerfMarker(const ReactMarker::ReactMarkerId markerId, const char* tag) {
+  // Every marker is available natively from the timeline, with a precise
+  // timestamp. Only the ones Java listens to pay for a JNI call.
+  ReactMarker::Timeline::global().record(markerId, tag);
+
   switch (markerId) {
     case ReactMarker::RUN_JS_BUNDLE_START:
       JReactMarker::logMarker("RUN_JS_BUNDLE_START", tag);
@@ -61,7 +66,14 @@ void JReactMarker::logPerfMarker(const ReactMarker::ReactMarkerId markerId, cons
       break;
     case ReactMarker::NATIVE_REQUIRE_START:
     case ReactMarker::NATIVE_REQUIRE_STOP:
-      // These are not used on Android.
+      // These are too frequent to send to Java one by one; they are only
+      // recorded in the timeline.
+      break;
+    case ReactMarker::RUN_JS_BUNDLE_MAJOR_PAGE_FAULTS:
+    case ReactMarker::LOAD_BYTECODE_START:
+    case ReactMarker::LOAD_BYTECODE_STOP:
+      // ReactMarkerConstants has no constants for these, Java would fail to
+      // look them up; they are only recorded in the timeline.
       break;
   }
 }
@@ -6,7 +6,9 @@
 #include "JSLoader.h"
 
 #include <android/asset_manager_jni.h>
+#include <unistd.h>
 #include <cxxreact/JSBigString.h>
+#include <cxxreact/JSBundleType.h>
 #include <fb/fbjni.h>
 #include <fb/log.h>
 #include <folly/Conv.h>
@@ -32,6 +34,56 @@ AAssetManager *extractAssetManager(alias_ref<JAssetManager::javaobject> assetMan
   return AAssetManager_fromJava(env, assetManager.get());
 }
 
+__attribute__((visibility("default")))
+std::unique_ptr<const JSBigString> loadAsset(
+    AAssetManager *manager,
+    const std::string& assetName,
+    JSBigFileMappingPolicy policy) {
+  if (!manager) {
+    return nullptr;
+  }
+  auto asset = AAssetManager_open(
+    manager,
+    assetName.c_str(),
+    AASSET_MODE_STREAMING); // Optimized for sequential read: see AssetManager.java for docs
+  if (!asset) {
+    return nullptr;
+  }
+
+  // An uncompressed asset is a region of the APK, which is mapped instead
+  // of copied, so the engine reads it straight from the page cache.
+  off_t start;
+  off_t length;
+  int fd = AAsset_openFileDescriptor(asset, &start, &length);
+  if (fd >= 0) {
+    // Bytecode is run straight from the mapping, so only the pages of the
+    // functions which run are read rather than all of them.
+    BundleHeader header;
+    if (pread(fd, &header, sizeof(header), start) == sizeof(header) &&
+        parseTypeFromHeader(header) == ScriptTag::HBCBundle) {
+      policy = JSBigFileMappingPolicy();
+    }
+    // JSBigFileString duplicates the file descriptor.
+    auto script = folly::make_unique<JSBigFileString>(fd, length, start, policy);
+    close(fd);
+    AAsset_close(asset);
+    return std::move(script);
+  }
+
+  // A compressed asset has to be inflated into memory either way.
+  auto buf = folly::make_unique<JSBigBufferString>(AAsset_getLength(asset));
+  size_t offset = 0;
+  int readbytes;
+  while ((readbytes = AAsset_read(asset, buf->data() + offset, buf->size() - offset)) > 0) {
+    offset += readbytes;
+  }
+  AAsset_close(asset);
+  if (offset != buf->size()) {
+    return nullptr;
+  }
+  return std::move(buf);
+}
+
 __attribute__((visibility("default")))
 std::unique_ptr<const JSBigString> loadScriptFromAssets(
     AAssetManager *manager,
@@ -40,23 +92,13 @@ std::unique_ptr<const JSBigString> loadScriptFromAssets(
   FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "reactbridge_jni_loadScriptFromAssets",
     "assetName", assetName);
   #endif
-  if (manager) {
-    auto asset = AAssetManager_open(
-      manager,
-      assetName.c_str(),
-      AASSET_MODE_STREAMING); // Optimized for sequential read: see AssetManager.java for docs
-    if (asset) {
-      auto buf = folly::make_unique<JSBigBufferString>(AAsset_getLength(asset));
-      size_t offset = 0;
-      int readbytes;
-      while ((readbytes = AAsset_read(asset, buf->data() + offset, buf->size() - offset)) > 0) {
-        offset += readbytes;
-      }
-      AAsset_close(asset);
-      if (offset == buf->size()) {
-        return std::move(buf);
-      }
-    }
+  // The engine parses a plain bundle from the beginning to the end, so it is
+  // read in eagerly.
+  JSBigFileMappingPolicy policy;
+  policy.access = JSBigFileMappingPolicy::Access::Sequential;
+  policy.populateSize = SIZE_MAX;
+  if (auto script = loadAsset(manager, assetName, policy)) {
+    return script;
   }
 
   throw std::runtime_error(folly::to<std::string>("Unable to load script. Make sure you're "
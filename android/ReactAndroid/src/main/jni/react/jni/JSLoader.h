@@ -8,6 +8,7 @@
 #include <string>
 
 #include <android/asset_manager.h>
+#include <cxxreact/JSBigString.h>
 #include <cxxreact/JSExecutor.h>
 #include <fb/fbjni.h>
 
@@ -25,4 +26,14 @@ AAssetManager *extractAssetManager(jni::alias_ref<JAssetManager::javaobject> ass
 
 std::unique_ptr<const JSBigString> loadScriptFromAssets(AAssetManager *assetManager, const std::string& assetName);
 
+/**
+ * Like loadScriptFromAssets, but returns nullptr if the asset can't be read.
+ * Uncompressed assets are mapped rather than copied, Hermes bytecode with the
+ * default policy.
+ */
+std::unique_ptr<const JSBigString> loadAsset(
+  AAssetManager *assetManager,
+  const std::string& assetName,
+  JSBigFileMappingPolicy policy = {});
+
 } }
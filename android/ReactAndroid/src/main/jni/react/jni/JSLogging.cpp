@@ -5,11 +5,182 @@
 
 #include "JSLogging.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include <fb/log.h>
 
 namespace facebook {
 namespace react {
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<int> minPriority{ANDROID_LOG_DEBUG};
+
+android_LogPriority priorityFromJSLevel(unsigned int logLevel) {
+  return static_cast<android_LogPriority>(logLevel + ANDROID_LOG_DEBUG);
+}
+
+// A bounded multi-producer, single-consumer queue of messages. Each slot has
+// a sequence number telling whether it's free for the producer of a position,
+// or filled for the consumer, so neither ever takes a lock.
+class JSLogQueue {
+ public:
+  static constexpr size_t kCapacity = 1024;
+
+  JSLogQueue() {
+    for (size_t i = 0; i < kCapacity; i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Returns false if the queue is full.
+  bool push(const std::string& message, android_LogPriority priority) {
+    size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[position % kCapacity];
+      size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+      if (difference == 0) {
+        if (enqueuePosition_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = enqueuePosition_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->message = message;
+    slot->priority = priority;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer thread only. Returns false if the queue is empty.
+  bool pop(std::string& message, android_LogPriority& priority) {
+    Slot& slot = slots_[dequeuePosition_ % kCapacity];
+    if (slot.sequence.load(std::memory_order_acquire) !=
+        dequeuePosition_ + 1) {
+      return false;
+    }
+    message.swap(slot.message);
+    slot.message.clear();
+    priority = slot.priority;
+    slot.sequence.store(
+        dequeuePosition_ + kCapacity, std::memory_order_release);
+    dequeuePosition_++;
+    return true;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    std::string message;
+    android_LogPriority priority;
+  };
+
+  Slot slots_[kCapacity];
+  std::atomic<size_t> enqueuePosition_{0};
+  size_t dequeuePosition_{0};
+};
+
+class JSLogSink {
+ public:
+  JSLogSink() : thread_(&JSLogSink::run, this) {
+    thread_.detach();
+  }
+
+  void log(const std::string& message, android_LogPriority priority) {
+    if (!takeToken() || !queue_.push(message, priority)) {
+      droppedCount_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    if (sleeping_.load(std::memory_order_acquire)) {
+      // The consumer also wakes up periodically, a lost notification only
+      // delays the message.
+      wakeUp_.notify_one();
+    }
+  }
+
+ private:
+  // A token bucket refilled with kJSLogRateLimit tokens per second, holding
+  // at most one second of them.
+  bool takeToken() {
+    auto now = Clock::now().time_since_epoch().count();
+    auto last = lastRefill_.load(std::memory_order_relaxed);
+    auto interval = std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::seconds(1))
+                        .count() /
+        kJSLogRateLimit;
+    if (now - last >= interval &&
+        lastRefill_.compare_exchange_strong(last, now)) {
+      int refill = static_cast<int>((now - last) / interval);
+      int tokens = tokens_.load(std::memory_order_relaxed);
+      while (!tokens_.compare_exchange_weak(
+          tokens, std::min<int>(tokens + refill, kJSLogRateLimit))) {
+      }
+    }
+    if (tokens_.fetch_sub(1, std::memory_order_relaxed) > 0) {
+      return true;
+    }
+    tokens_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  void run() {
+    std::string message;
+    android_LogPriority priority;
+    std::mutex mutex;
+    while (true) {
+      while (queue_.pop(message, priority)) {
+        reportDropped();
+        FBLOG_PRI(priority, "ReactNativeJS", "%s", message.c_str());
+      }
+      reportDropped();
+      std::unique_lock<std::mutex> lock(mutex);
+      sleeping_.store(true, std::memory_order_release);
+      wakeUp_.wait_for(lock, std::chrono::milliseconds(100));
+      sleeping_.store(false, std::memory_order_release);
+    }
+  }
+
+  void reportDropped() {
+    auto dropped = droppedCount_.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+      FBLOG_PRI(
+          ANDROID_LOG_WARN,
+          "ReactNativeJS",
+          "%u messages dropped (rate limit or full buffer)",
+          dropped);
+    }
+  }
+
+  JSLogQueue queue_;
+  std::atomic<unsigned int> droppedCount_{0};
+  std::atomic<int> tokens_{static_cast<int>(kJSLogRateLimit)};
+  std::atomic<Clock::rep> lastRefill_{Clock::now().time_since_epoch().count()};
+  std::atomic<bool> sleeping_{false};
+  std::condition_variable wakeUp_;
+  std::thread thread_;
+};
+
+JSLogSink& jsLogSink() {
+  // Never destroyed, its thread runs until the process exits.
+  static auto sink = new JSLogSink();
+  return *sink;
+}
+
+} // namespace
+
 void reactAndroidLoggingHook(
     const std::string& message,
     android_LogPriority logLevel) {
@@ -19,8 +190,25 @@ void reactAndroidLoggingHook(
 void reactAndroidLoggingHook(
     const std::string& message,
     unsigned int logLevel) {
-  reactAndroidLoggingHook(
-      message, static_cast<android_LogPriority>(logLevel + ANDROID_LOG_DEBUG));
+  reactAndroidLoggingHook(message, priorityFromJSLevel(logLevel));
+}
+
+void reactAndroidAsyncLoggingHook(
+    const std::string& message,
+    unsigned int logLevel) {
+  if (!reactAndroidShouldLog(logLevel)) {
+    return;
+  }
+  jsLogSink().log(message, priorityFromJSLevel(logLevel));
+}
+
+bool reactAndroidShouldLog(unsigned int logLevel) {
+  return static_cast<int>(priorityFromJSLevel(logLevel)) >=
+      minPriority.load(std::memory_order_relaxed);
+}
+
+void setReactAndroidLogMinPriority(android_LogPriority priority) {
+  minPriority.store(priority, std::memory_order_relaxed);
 }
 
 } // namespace react
@@ -18,5 +18,24 @@ void reactAndroidLoggingHook(
     const std::string& message,
     unsigned int logLevel);
 
+// Like reactAndroidLoggingHook, but only enqueues the message: a background
+// thread writes it to the log later, so the JS thread never waits on logd.
+// A lock-free ring buffer holds the pending messages. Messages are dropped
+// (and counted in a later "dropped" line) when it is full, or when JS logs
+// faster than kJSLogRateLimit messages per second for longer than a burst.
+void reactAndroidAsyncLoggingHook(
+    const std::string& message,
+    unsigned int logLevel);
+
+// Whether a JS message of logLevel passes the minimum priority, checked
+// before the message is converted to a std::string (see bindNativeLogger).
+bool reactAndroidShouldLog(unsigned int logLevel);
+
+// Sets the minimum priority of the messages from JS which are logged,
+// ANDROID_LOG_DEBUG (everything) by default. Can be called on any thread.
+void setReactAndroidLogMinPriority(android_LogPriority priority);
+
+constexpr unsigned int kJSLogRateLimit = 1000;
+
 } // namespace react
 } // namespace facebook
@@ -6,18 +6,24 @@
 #include "JniJSModulesUnbundle.h"
 
 #include <cstdint>
+#include <cstring>
 #include <fb/assert.h>
 #include <libgen.h>
 #include <memory>
 #include <sstream>
 #include <sys/endian.h>
 #include <utility>
+#include <vector>
 
 #include <folly/Memory.h>
 
+#include "JSLoader.h"
+
 using magic_number_t = uint32_t;
 const magic_number_t MAGIC_FILE_HEADER = 0xFB0BD1E5;
 const char* MAGIC_FILE_NAME = "UNBUNDLE";
+const char* INDEXED_FILE_NAME = "modules.indexed";
+const char* PREFETCH_FILE_NAME = "modules.indexed.prefetch";
 
 namespace facebook {
 namespace react {
@@ -47,9 +53,39 @@ std::unique_ptr<JniJSModulesUnbundle> JniJSModulesUnbundle::fromEntryFile(
     return folly::make_unique<JniJSModulesUnbundle>(assetManager, jsModulesDir(entryFile));
   }
 
+static std::vector<uint32_t> readModuleIds(
+    AAssetManager *manager,
+    const std::string& fileName) {
+  auto asset = openAsset(manager, fileName, AASSET_MODE_BUFFER);
+  const char *buffer = nullptr;
+  if (asset != nullptr) {
+    buffer = static_cast<const char *>(AAsset_getBuffer(asset.get()));
+  }
+  if (buffer == nullptr) {
+    return {};
+  }
+  std::vector<uint32_t> moduleIds(AAsset_getLength(asset.get()) / sizeof(uint32_t));
+  std::memcpy(moduleIds.data(), buffer, moduleIds.size() * sizeof(uint32_t));
+  for (auto& moduleId : moduleIds) {
+    moduleId = letoh32(moduleId);
+  }
+  return moduleIds;
+}
+
 JniJSModulesUnbundle::JniJSModulesUnbundle(AAssetManager *assetManager, const std::string& moduleDirectory) :
   m_assetManager(assetManager),
-  m_moduleDirectory(moduleDirectory) {}
+  m_moduleDirectory(moduleDirectory) {
+  // Modules are read all over the container, and only the pages which are
+  // read are loaded.
+  JSBigFileMappingPolicy policy;
+  policy.access = JSBigFileMappingPolicy::Access::Random;
+  auto container = loadAsset(assetManager, moduleDirectory + INDEXED_FILE_NAME, policy);
+  if (container) {
+    m_indexedModules = folly::make_unique<JSIndexedRAMBundle>(std::move(container));
+    m_indexedModules->prefetchModules(
+      readModuleIds(assetManager, moduleDirectory + PREFETCH_FILE_NAME));
+  }
+}
 
 bool JniJSModulesUnbundle::isUnbundle(
     AAssetManager *assetManager,
@@ -73,6 +109,10 @@ JSModulesUnbundle::Module JniJSModulesUnbundle::getModule(uint32_t moduleId) con
   // can be nullptr for default constructor.
   FBASSERTMSGF(m_assetManager != nullptr, "Unbundle has not been initialized with an asset manager");
 
+  if (m_indexedModules) {
+    return m_indexedModules->getModule(moduleId);
+  }
+
   std::ostringstream sourceUrlBuilder;
   sourceUrlBuilder << moduleId << ".js";
   auto sourceUrl = sourceUrlBuilder.str();
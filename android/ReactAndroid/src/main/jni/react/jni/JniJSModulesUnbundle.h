@@ -8,6 +8,7 @@
 #include <memory>
 
 #include <android/asset_manager.h>
+#include <cxxreact/JSIndexedRAMBundle.h>
 #include <cxxreact/JSModulesUnbundle.h>
 
 namespace facebook {
@@ -15,7 +16,13 @@ namespace react {
 
 class JniJSModulesUnbundle : public JSModulesUnbundle {
   /**
-   * This implementation reads modules as single file from the assets of an apk.
+   * This implementation reads modules from the assets of an apk: either each
+   * module from a file of its own, or all of them from an indexed container
+   * (modules.indexed, in the format of an indexed RAM bundle whose startup
+   * code is ignored) next to them. An uncompressed container is mapped once
+   * and its modules are returned without copying them. The modules listed in
+   * modules.indexed.prefetch (as little-endian 32-bit ids) are read ahead of
+   * time.
    */
 public:
   JniJSModulesUnbundle() = default;
@@ -32,6 +39,7 @@ public:
 private:
   AAssetManager *m_assetManager = nullptr;
   std::string m_moduleDirectory;
+  std::unique_ptr<JSIndexedRAMBundle> m_indexedModules;
 };
 
 }
@@ -75,83 +75,142 @@ local_ref<JCxxCallbackImpl::jhybridobject> extractCallback(std::weak_ptr<Instanc
   }
 }
 
-local_ref<JPromiseImpl::javaobject> extractPromise(std::weak_ptr<Instance>& instance, dynamic_iterator& it, dynamic_iterator& end) {
+local_ref<JPromiseImpl::javaobject> extractPromise(std::weak_ptr<Instance>& instance, dynamic_iterator& it) {
   auto resolve = extractCallback(instance, *it++);
-  CHECK(it != end);
   auto reject = extractCallback(instance, *it++);
   return JPromiseImpl::create(resolve, reject);
 }
 
-bool isNullable(char type) {
-  switch (type) {
-    case 'Z':
-    case 'I':
-    case 'F':
-    case 'S':
-    case 'A':
-    case 'M':
-    case 'X':
-      return true;
-    default:
-      return false;;
-  }
+// Converters of a single JS argument to a Java argument.
+
+jvalue toBoolean(std::weak_ptr<Instance>&, const folly::dynamic& arg) {
+  jvalue value;
+  value.z = static_cast<jboolean>(arg.getBool());
+  return value;
 }
 
-jvalue extract(std::weak_ptr<Instance>& instance, char type, dynamic_iterator& it, dynamic_iterator& end) {
-  CHECK(it != end);
+jvalue toBoxedBoolean(std::weak_ptr<Instance>&, const folly::dynamic& arg) {
   jvalue value;
-  if (type == 'P') {
-    value.l = extractPromise(instance, it, end).release();
-    return value;
-  }
+  value.l = JBoolean::valueOf(static_cast<jboolean>(arg.getBool())).release();
+  return value;
+}
 
+jvalue toInteger(std::weak_ptr<Instance>&, const folly::dynamic& arg) {
+  jvalue value;
+  value.i = extractInteger(arg);
+  return value;
+}
+
+jvalue toBoxedInteger(std::weak_ptr<Instance>&, const folly::dynamic& arg) {
+  jvalue value;
+  value.l = JInteger::valueOf(extractInteger(arg)).release();
+  return value;
+}
+
+jvalue toFloat(std::weak_ptr<Instance>&, const folly::dynamic& arg) {
+  jvalue value;
+  value.f = static_cast<jfloat>(extractDouble(arg));
+  return value;
+}
+
+jvalue toBoxedFloat(std::weak_ptr<Instance>&, const folly::dynamic& arg) {
+  jvalue value;
+  value.l = JFloat::valueOf(static_cast<jfloat>(extractDouble(arg))).release();
+  return value;
+}
+
+jvalue toDouble(std::weak_ptr<Instance>&, const folly::dynamic& arg) {
+  jvalue value;
+  value.d = extractDouble(arg);
+  return value;
+}
+
+jvalue toBoxedDouble(std::weak_ptr<Instance>&, const folly::dynamic& arg) {
+  jvalue value;
+  value.l = JDouble::valueOf(extractDouble(arg)).release();
+  return value;
+}
+
+jvalue toString(std::weak_ptr<Instance>&, const folly::dynamic& arg) {
+  jvalue value;
+  value.l = make_jstring(arg.getString().c_str()).release();
+  return value;
+}
+
+jvalue toArray(std::weak_ptr<Instance>&, const folly::dynamic& arg) {
+  jvalue value;
+  value.l = ReadableNativeArray::newObjectCxxArgs(arg).release();
+  return value;
+}
+
+jvalue toMap(std::weak_ptr<Instance>&, const folly::dynamic& arg) {
+  jvalue value;
+  value.l = ReadableNativeMap::newObjectCxxArgs(arg).release();
+  return value;
+}
+
+jvalue toCallback(std::weak_ptr<Instance>& instance, const folly::dynamic& arg) {
+  jvalue value;
+  value.l = extractCallback(instance, arg).release();
+  return value;
+}
+
+// The steps of an argument plan, which consume their JS arguments.
+
+template <jvalue (*convert)(std::weak_ptr<Instance>&, const folly::dynamic&)>
+jvalue extractArg(std::weak_ptr<Instance>& instance, dynamic_iterator& it) {
+  return convert(instance, *it++);
+}
+
+template <jvalue (*convert)(std::weak_ptr<Instance>&, const folly::dynamic&)>
+jvalue extractNullableArg(std::weak_ptr<Instance>& instance, dynamic_iterator& it) {
   const auto& arg = *it++;
-  if (isNullable(type) && arg.isNull()) {
+  if (arg.isNull()) {
+    jvalue value;
     value.l = nullptr;
     return value;
   }
+  return convert(instance, arg);
+}
+
+jvalue extractPromiseArgs(std::weak_ptr<Instance>& instance, dynamic_iterator& it) {
+  jvalue value;
+  value.l = extractPromise(instance, it).release();
+  return value;
+}
 
+MethodInvoker::ArgExtractor argExtractor(char type) {
   switch (type) {
     case 'z':
-      value.z = static_cast<jboolean>(arg.getBool());
-      break;
+      return extractArg<toBoolean>;
     case 'Z':
-      value.l = JBoolean::valueOf(static_cast<jboolean>(arg.getBool())).release();
-      break;
+      return extractNullableArg<toBoxedBoolean>;
     case 'i':
-      value.i = extractInteger(arg);
-      break;
+      return extractArg<toInteger>;
     case 'I':
-      value.l = JInteger::valueOf(extractInteger(arg)).release();
-      break;
+      return extractNullableArg<toBoxedInteger>;
     case 'f':
-      value.f = static_cast<jfloat>(extractDouble(arg));
-      break;
+      return extractArg<toFloat>;
     case 'F':
-      value.l = JFloat::valueOf(static_cast<jfloat>(extractDouble(arg))).release();
-      break;
+      return extractNullableArg<toBoxedFloat>;
     case 'd':
-      value.d = extractDouble(arg);
-      break;
+      return extractArg<toDouble>;
     case 'D':
-      value.l = JDouble::valueOf(extractDouble(arg)).release();
-      break;
+      return extractArg<toBoxedDouble>;
     case 'S':
-      value.l = make_jstring(arg.getString().c_str()).release();
-      break;
+      return extractNullableArg<toString>;
     case 'A':
-      value.l = ReadableNativeArray::newObjectCxxArgs(arg).release();
-      break;
+      return extractNullableArg<toArray>;
     case 'M':
-      value.l = ReadableNativeMap::newObjectCxxArgs(arg).release();
-      break;
+      return extractNullableArg<toMap>;
     case 'X':
-      value.l = extractCallback(instance, arg).release();
-      break;
+      return extractNullableArg<toCallback>;
+    case 'P':
+      return extractPromiseArgs;
     default:
       LOG(FATAL) << "Unknown param type: " << type;
+      return nullptr;
   }
-  return value;
 }
 
 std::size_t countJsArgs(const std::string& signature) {
@@ -179,6 +238,11 @@ MethodInvoker::MethodInvoker(alias_ref<JReflectMethod::javaobject> method, std::
  isSync_(isSync) {
      CHECK(signature_.at(1) == '.') << "Improper module method signature";
      CHECK(isSync_ || signature_.at(0) == 'v') << "Non-sync hooks cannot have a non-void return type";
+     // The signature is decoded once here, rather than on every call.
+     argPlan_.reserve(signature_.size() - 2);
+     for (auto it = signature_.begin() + 2; it != signature_.end(); ++it) {
+       argPlan_.push_back(argExtractor(*it));
+     }
 }
 
 MethodCallResult MethodInvoker::invoke(std::weak_ptr<Instance>& instance, alias_ref<JBaseJavaModule::javaobject> module, const folly::dynamic& params) {
@@ -195,16 +259,14 @@ MethodCallResult MethodInvoker::invoke(std::weak_ptr<Instance>& instance, alias_
   }
 
   auto env = Environment::current();
-  auto argCount = signature_.size() - 2;
+  auto argCount = argPlan_.size();
   JniLocalScope scope(env, argCount);
   jvalue args[argCount];
-  std::transform(
-    signature_.begin() + 2,
-    signature_.end(),
-    args,
-    [&instance, it = params.begin(), end = params.end()] (char type) mutable {
-      return extract(instance, type, it, end);
-  });
+  // The argument count was checked above, so every step has its arguments.
+  auto it = params.begin();
+  for (size_t i = 0; i < argCount; i++) {
+    args[i] = argPlan_[i](instance, it);
+  }
 
 #define PRIMITIVE_CASE(METHOD) {                                             \
   auto result = env->Call ## METHOD ## MethodA(module.get(), method_, args); \
@@ -32,6 +32,9 @@ struct JBaseJavaModule : public jni::JavaClass<JBaseJavaModule> {
 
 class MethodInvoker {
 public:
+  // Converts the next JS argument(s) to a Java argument.
+  using ArgExtractor = jvalue (*)(std::weak_ptr<Instance>&, folly::dynamic::const_iterator&);
+
   MethodInvoker(jni::alias_ref<JReflectMethod::javaobject> method, std::string signature, std::string traceName, bool isSync);
 
   MethodCallResult invoke(std::weak_ptr<Instance>& instance, jni::alias_ref<JBaseJavaModule::javaobject> module, const folly::dynamic& params);
@@ -42,6 +45,9 @@ public:
 private:
   jmethodID method_;
   std::string signature_;
+  // How each Java argument is made from the JS arguments, compiled from the
+  // signature.
+  std::vector<ArgExtractor> argPlan_;
   std::size_t jsArgCount_;
   std::string traceName_;
   bool isSync_;
@@ -41,7 +41,8 @@ std::vector<std::unique_ptr<NativeModule>> buildNativeModuleList(
     std::weak_ptr<Instance> winstance,
     jni::alias_ref<jni::JCollection<JavaModuleWrapper::javaobject>::javaobject> javaModules,
     jni::alias_ref<jni::JCollection<ModuleHolder::javaobject>::javaobject> cxxModules,
-    std::shared_ptr<MessageQueueThread> moduleMessageQueue) {
+    std::shared_ptr<MessageQueueThread> moduleMessageQueue,
+    std::shared_ptr<CxxModuleQueues> cxxModuleQueues) {
   std::vector<std::unique_ptr<NativeModule>> modules;
   if (javaModules) {
     for (const auto& jm : *javaModules) {
@@ -53,7 +54,8 @@ std::vector<std::unique_ptr<NativeModule>> buildNativeModuleList(
     for (const auto& cm : *cxxModules) {
       std::string moduleName = cm->getName();
       modules.emplace_back(folly::make_unique<CxxNativeModule>(
-                             winstance, moduleName, cm->getProvider(moduleName), moduleMessageQueue));
+                             winstance, moduleName, cm->getProvider(moduleName), moduleMessageQueue,
+                             cxxModuleQueues));
     }
   }
   return modules;
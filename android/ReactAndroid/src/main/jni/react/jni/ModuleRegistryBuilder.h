@@ -15,6 +15,7 @@
 namespace facebook {
 namespace react {
 
+class CxxModuleQueues;
 class MessageQueueThread;
 
 class ModuleHolder : public jni::JavaClass<ModuleHolder> {
@@ -30,6 +31,7 @@ std::vector<std::unique_ptr<NativeModule>> buildNativeModuleList(
   std::weak_ptr<Instance> winstance,
   jni::alias_ref<jni::JCollection<JavaModuleWrapper::javaobject>::javaobject> javaModules,
   jni::alias_ref<jni::JCollection<ModuleHolder::javaobject>::javaobject> cxxModules,
-  std::shared_ptr<MessageQueueThread> moduleMessageQueue);
+  std::shared_ptr<MessageQueueThread> moduleMessageQueue,
+  std::shared_ptr<CxxModuleQueues> cxxModuleQueues = nullptr);
 }
 }
@@ -32,6 +32,7 @@ class NativeArray : public jni::HybridClass<NativeArray> {
   folly::dynamic array_;
 
   friend HybridBase;
+  friend struct FlatDynamic;
   explicit NativeArray(folly::dynamic array);
 };
 
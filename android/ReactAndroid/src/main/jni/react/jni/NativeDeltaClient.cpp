@@ -5,7 +5,7 @@
 
 #include "NativeDeltaClient.h"
 
-#include <sstream>
+#include <string>
 #include <fb/fbjni/ByteBuffer.h>
 #include <folly/json.h>
 
@@ -28,7 +28,9 @@ void NativeDeltaClient::registerNatives() {
 void NativeDeltaClient::jniProcessDelta(
     jni::alias_ref<jni::JReadableByteChannel> delta) {
 
-  std::ostringstream deltaMessage;
+  // Appended to directly: an ostringstream would copy the whole message once
+  // more to hand it out as a string.
+  std::string deltaMessage;
   std::vector<uint8_t> buffer(8192);
   auto byteBuffer = jni::JByteBuffer::wrapBytes(buffer.data(), buffer.size());
 
@@ -37,7 +39,7 @@ void NativeDeltaClient::jniProcessDelta(
   do {
     read = delta->read(byteBuffer);
     if (read < 1) {
-      deltaMessage.write(reinterpret_cast<const char *>(buffer.data()), pos);
+      deltaMessage.append(reinterpret_cast<const char *>(buffer.data()), pos);
       byteBuffer->rewind();
       pos = 0;
     } else {
@@ -46,7 +48,10 @@ void NativeDeltaClient::jniProcessDelta(
   } while (read != -1);
 
 
-  deltaClient_->patch(folly::parseJson(deltaMessage.str()));
+  auto parsedDelta = folly::parseJson(deltaMessage);
+  // Not needed once parsed, so it is not kept around while patching.
+  std::string().swap(deltaMessage);
+  deltaClient_->patch(std::move(parsedDelta));
 }
 
 void NativeDeltaClient::jniReset() {
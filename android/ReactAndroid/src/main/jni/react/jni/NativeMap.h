@@ -32,6 +32,7 @@ class NativeMap : public jni::HybridClass<NativeMap> {
   folly::dynamic map_;
 
   friend HybridBase;
+  friend struct FlatDynamic;
   friend struct ReadableNativeMapKeySetIterator;
   explicit NativeMap(folly::dynamic s) : isConsumed(false), map_(s) {}
 };
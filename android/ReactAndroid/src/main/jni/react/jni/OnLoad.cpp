@@ -13,6 +13,7 @@
 
 #include "CatalystInstanceImpl.h"
 #include "CxxModuleWrapper.h"
+#include "FlatDynamic.h"
 #include "JavaScriptExecutorHolder.h"
 #include "JCallback.h"
 #include "NativeDeltaClient.h"
@@ -68,6 +69,7 @@ extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
     CatalystInstanceImpl::registerNatives();
     CxxModuleWrapperBase::registerNatives();
     CxxModuleWrapper::registerNatives();
+    FlatDynamic::registerNatives();
     JCxxCallbackImpl::registerNatives();
     NativeArray::registerNatives();
     NativeDeltaClient::registerNatives();
@@ -10,6 +10,7 @@
 #include <cxxreact/SystraceSection.h>
 #include <fb/assert.h>
 #include <fb/Environment.h>
+#include <folly/hash/SpookyHashV2.h>
 #include <folly/json.h>
 #include <folly/Memory.h>
 #include <jni/LocalReference.h>
@@ -52,6 +53,9 @@ ProxyExecutor::~ProxyExecutor() {
 void ProxyExecutor::loadApplicationScript(
     std::unique_ptr<const JSBigString>,
     std::string sourceURL) {
+  // Loading a script starts a new session of the remote debugger, which has
+  // none of the globals sent so far.
+  m_globalVariableDigests.clear();
 
   folly::dynamic nativeModuleConfig = folly::dynamic::array;
 
@@ -112,11 +116,43 @@ void ProxyExecutor::invokeCallback(const double callbackId, const folly::dynamic
   m_delegate->callNativeModules(*this, folly::parseJson(result), true);
 }
 
+void ProxyExecutor::callFunctions(std::vector<JSCall>&& calls) {
+  // The remote debugger has no way to skip flushing the queue, but the calls
+  // still end a single batch.
+  for (size_t i = 0; i < calls.size(); i++) {
+    auto& call = calls[i];
+    auto arguments = call.encodedArguments
+      ? call.encodedArguments->toDynamic()
+      : std::move(call.arguments);
+    std::string result = call.isCallback()
+      ? executeJSCallWithProxy(
+          m_executor.get(),
+          "invokeCallbackAndReturnFlushedQueue",
+          folly::dynamic::array(call.callbackId, std::move(arguments)))
+      : executeJSCallWithProxy(
+          m_executor.get(),
+          "callFunctionReturnFlushedQueue",
+          folly::dynamic::array(call.moduleId, call.methodId, std::move(arguments)));
+    m_delegate->callNativeModules(*this, folly::parseJson(result), i + 1 == calls.size());
+  }
+}
+
 void ProxyExecutor::setGlobalVariable(std::string propName,
                                       std::unique_ptr<const JSBigString> jsonValue) {
   static auto setGlobalVariable =
     jni::findClassStatic(EXECUTOR_BASECLASS)->getMethod<void(jstring, jstring)>("setGlobalVariable");
 
+  auto digest = GlobalVariableDigest{
+    jsonValue->size(),
+    folly::hash::SpookyHashV2::Hash64(jsonValue->c_str(), jsonValue->size(), 0)};
+  auto lastDigest = m_globalVariableDigests.find(propName);
+  if (lastDigest != m_globalVariableDigests.end() &&
+      lastDigest->second.size == digest.size &&
+      lastDigest->second.hash == digest.hash) {
+    return;
+  }
+  m_globalVariableDigests[propName] = digest;
+
   setGlobalVariable(
     m_executor.get(),
     jni::make_jstring(propName).get(),
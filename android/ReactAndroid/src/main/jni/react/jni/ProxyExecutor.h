@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
 #include <cxxreact/JSExecutor.h>
 #include <fb/fbjni.h>
 #include <jni.h>
@@ -49,6 +53,7 @@ public:
   virtual void invokeCallback(
     const double callbackId,
     const folly::dynamic& arguments) override;
+  virtual void callFunctions(std::vector<JSCall>&& calls) override;
   virtual void setGlobalVariable(
     std::string propName,
     std::unique_ptr<const JSBigString> jsonValue) override;
@@ -57,6 +62,15 @@ public:
 private:
   jni::global_ref<jobject> m_executor;
   std::shared_ptr<ExecutorDelegate> m_delegate;
+  struct GlobalVariableDigest {
+    size_t size;
+    uint64_t hash;
+  };
+
+  // The digest of the last value sent for each global in the current session
+  // of the remote debugger, so that unchanged values aren't sent over the
+  // websocket again.
+  std::unordered_map<std::string, GlobalVariableDigest> m_globalVariableDigests;
 };
 
 } }
@@ -25,6 +25,7 @@ struct WritableNativeArray
   static constexpr const char* kJavaDescriptor = "Lcom/facebook/react/bridge/WritableNativeArray;";
 
   WritableNativeArray();
+  WritableNativeArray(folly::dynamic&& val);
   static jni::local_ref<jhybriddata> initHybrid(jni::alias_ref<jclass>);
 
   void pushNull();
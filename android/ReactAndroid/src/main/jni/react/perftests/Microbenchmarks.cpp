@@ -0,0 +1,205 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Microbenchmarks.h"
+
+#include <algorithm>
+#include <unistd.h>
+
+#include <cxxreact/MethodCall.h>
+#include <fb/log.h>
+#include <folly/json.h>
+#include <react/jni/FlatDynamic.h>
+#include <react/jni/ReadableNativeMap.h>
+
+using namespace facebook::jni;
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string quoted(const std::string& s) {
+  return folly::toJson(folly::dynamic(s));
+}
+
+// A queue of method calls like the ones JS flushes to native, with the
+// typical mix of argument types.
+folly::dynamic makeMethodQueue(size_t calls) {
+  folly::dynamic moduleIds = folly::dynamic::array();
+  folly::dynamic methodIds = folly::dynamic::array();
+  folly::dynamic params = folly::dynamic::array();
+  for (size_t i = 0; i < calls; i++) {
+    moduleIds.push_back(static_cast<int64_t>(i % 40));
+    methodIds.push_back(static_cast<int64_t>(i % 7));
+    params.push_back(folly::dynamic::array(
+        static_cast<int64_t>(i),
+        "someString",
+        folly::dynamic::object("x", 1.5)("y", true)("tag", "view")));
+  }
+  return folly::dynamic::array(
+      std::move(moduleIds), std::move(methodIds), std::move(params), 1);
+}
+
+// Rows like a database query or API response returns to JS.
+folly::dynamic makeRows(size_t count) {
+  folly::dynamic rows = folly::dynamic::array();
+  for (size_t i = 0; i < count; i++) {
+    rows.push_back(folly::dynamic::object("id", static_cast<int64_t>(i))(
+        "name", "Row name " + std::to_string(i))("score", i * 0.5)(
+        "active", i % 2 == 0));
+  }
+  return folly::dynamic::object("rows", std::move(rows));
+}
+
+template <typename F>
+std::chrono::nanoseconds timeIterations(size_t iterations, F&& f) {
+  auto start = Clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    f(i);
+  }
+  return Clock::now() - start;
+}
+
+// Keeps the compiler from optimizing away a result.
+template <typename T>
+void doNotOptimizeAway(T&& value) {
+  asm volatile("" : : "r"(&value) : "memory");
+}
+
+} // namespace
+
+std::string MicrobenchmarkResult::toJSON() const {
+  return "{\"name\":" + quoted(name) +
+      ",\"iterations\":" + std::to_string(iterations) +
+      ",\"samples\":" + std::to_string(samples) +
+      ",\"minNanos\":" + folly::to<std::string>(minNanos) +
+      ",\"medianNanos\":" + folly::to<std::string>(medianNanos) +
+      ",\"maxNanos\":" + folly::to<std::string>(maxNanos) + "}";
+}
+
+MicrobenchmarkRunner::MicrobenchmarkRunner(
+    const std::string& outputPath,
+    size_t samples)
+    : samples_(std::max<size_t>(samples, 1)) {
+  if (!outputPath.empty()) {
+    output_ = std::fopen(outputPath.c_str(), "a");
+    if (!output_) {
+      FBLOGW("Could not open %s for benchmark results", outputPath.c_str());
+    }
+  }
+}
+
+MicrobenchmarkRunner::~MicrobenchmarkRunner() {
+  if (output_) {
+    std::fclose(output_);
+  }
+}
+
+const MicrobenchmarkResult& MicrobenchmarkRunner::run(
+    const std::string& name,
+    size_t iterations,
+    const Microbenchmark& benchmark) {
+  iterations = std::max<size_t>(iterations, 1);
+  benchmark(iterations);
+
+  std::vector<double> perIteration;
+  perIteration.reserve(samples_);
+  for (size_t i = 0; i < samples_; i++) {
+    perIteration.push_back(
+        static_cast<double>(benchmark(iterations).count()) / iterations);
+  }
+  std::sort(perIteration.begin(), perIteration.end());
+
+  results_.push_back(MicrobenchmarkResult{name,
+                                          iterations,
+                                          samples_,
+                                          perIteration.front(),
+                                          perIteration[perIteration.size() / 2],
+                                          perIteration.back()});
+  append(results_.back());
+  return results_.back();
+}
+
+void MicrobenchmarkRunner::append(const MicrobenchmarkResult& result) {
+  if (!output_) {
+    return;
+  }
+  std::string line = result.toJSON() + "\n";
+  std::fwrite(line.data(), 1, line.size(), output_);
+  std::fflush(output_);
+  fsync(fileno(output_));
+}
+
+std::string MicrobenchmarkRunner::toJSON() const {
+  std::string json = "[";
+  for (const auto& result : results_) {
+    if (json.size() > 1) {
+      json += ",";
+    }
+    json += result.toJSON();
+  }
+  return json + "]";
+}
+
+void runBridgeMicrobenchmarks(MicrobenchmarkRunner& runner, size_t scale) {
+  const folly::dynamic queue = makeMethodQueue(scale);
+  const std::string queueJson = folly::toJson(queue);
+  const folly::dynamic rows = makeRows(scale);
+
+  runner.run("MethodQueue.parseJson", 20, [&](size_t iterations) {
+    return timeIterations(iterations, [&](size_t) {
+      auto parsed = folly::parseJson(queueJson);
+      doNotOptimizeAway(parsed);
+    });
+  });
+
+  runner.run("MethodQueue.parseMethodCalls", 20, [&](size_t iterations) {
+    // parseMethodCalls consumes the queue, so the copies are made up front.
+    std::vector<folly::dynamic> queues(iterations, queue);
+    return timeIterations(iterations, [&](size_t i) {
+      auto calls = parseMethodCalls(std::move(queues[i]));
+      doNotOptimizeAway(calls);
+    });
+  });
+
+  runner.run("Result.toJson", 20, [&](size_t iterations) {
+    return timeIterations(iterations, [&](size_t) {
+      auto json = folly::toJson(rows);
+      doNotOptimizeAway(json);
+    });
+  });
+
+  runner.run("ReadableNativeMap.newObject", 20, [&](size_t iterations) {
+    return timeIterations(iterations, [&](size_t) {
+      auto map = ReadableNativeMap::newObjectCxxArgs(rows);
+      doNotOptimizeAway(map);
+    });
+  });
+
+  runner.run("FlatDynamic.write", 20, [&](size_t iterations) {
+    std::vector<uint8_t> buffer(flatDynamicSize(rows));
+    return timeIterations(iterations, [&](size_t) {
+      auto end = writeFlatDynamic(rows, buffer.data());
+      doNotOptimizeAway(end);
+    });
+  });
+}
+
+local_ref<jstring> runMicrobenchmarks(
+    alias_ref<jclass>,
+    alias_ref<jstring> outputPath,
+    jint samples) {
+  MicrobenchmarkRunner runner(
+      outputPath ? outputPath->toStdString() : "",
+      static_cast<size_t>(std::max(samples, 1)));
+  runBridgeMicrobenchmarks(runner, 1000);
+  return make_jstring(runner.toJSON());
+}
+
+} // namespace react
+} // namespace facebook
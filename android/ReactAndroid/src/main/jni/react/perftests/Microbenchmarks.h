@@ -0,0 +1,84 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <fb/fbjni.h>
+
+namespace facebook {
+namespace react {
+
+// Runs `iterations` iterations of the measured operation and returns how long
+// they took, excluding any setup it does first.
+using Microbenchmark =
+    std::function<std::chrono::nanoseconds(size_t iterations)>;
+
+struct MicrobenchmarkResult {
+  std::string name;
+  size_t iterations;
+  size_t samples;
+  // Per iteration, over all samples.
+  double minNanos;
+  double medianNanos;
+  double maxNanos;
+
+  // A JSON object with all of the above.
+  std::string toJSON() const;
+};
+
+// Runs microbenchmarks on device and records their results. Each result is
+// appended to the output file as a line of JSON and synced to disk as soon as
+// it is known, so the results of a run which crashes (or is killed by a
+// watchdog) are still there for the instrumentation to collect.
+class MicrobenchmarkRunner {
+ public:
+  // An empty outputPath only keeps the results in memory.
+  MicrobenchmarkRunner(const std::string& outputPath, size_t samples);
+  ~MicrobenchmarkRunner();
+
+  MicrobenchmarkRunner(const MicrobenchmarkRunner&) = delete;
+  MicrobenchmarkRunner& operator=(const MicrobenchmarkRunner&) = delete;
+
+  // Runs one warmup sample and then `samples` timed ones.
+  const MicrobenchmarkResult& run(
+      const std::string& name,
+      size_t iterations,
+      const Microbenchmark& benchmark);
+
+  const std::vector<MicrobenchmarkResult>& results() const {
+    return results_;
+  }
+
+  // All results as a JSON array.
+  std::string toJSON() const;
+
+ private:
+  void append(const MicrobenchmarkResult& result);
+
+  FILE* output_{nullptr};
+  size_t samples_;
+  std::vector<MicrobenchmarkResult> results_;
+};
+
+// Runs the built-in benchmarks of the bridge's native hot paths: parsing
+// method call queues from JS, JSON serialization of module results, and
+// marshalling of native maps to Java.
+void runBridgeMicrobenchmarks(MicrobenchmarkRunner& runner, size_t scale);
+
+// CatalystBridgeBenchmarks.nativeRunMicrobenchmarks(outputPath, samples):
+// runs the built-in benchmarks and returns their results as a JSON array.
+jni::local_ref<jstring> runMicrobenchmarks(
+    jni::alias_ref<jclass>,
+    jni::alias_ref<jstring> outputPath,
+    jint samples);
+
+} // namespace react
+} // namespace facebook
@@ -11,6 +11,8 @@
 #include <mutex>
 #include <condition_variable>
 
+#include "Microbenchmarks.h"
+
 namespace facebook {
 namespace react {
 
@@ -202,6 +204,7 @@ extern "C" jint JNI_OnLoad(JavaVM* vm, void*) {
           makeNativeMethod("runNativeBounce", runBounce),
           makeNativeMethod("nativeSetUp", setUp),
           makeNativeMethod("nativeTearDown", tearDown),
+          makeNativeMethod("nativeRunMicrobenchmarks", runMicrobenchmarks),
         });
       });
 }
@@ -58,5 +58,12 @@ namespace better {
 #define BETTER_USE_FOLLY_CONTAINERS
 #endif
 
+/*
+ * `better::flat_hash_map` and `better::flat_map` are implemented in Better
+ * itself, so code which uses them directly (instead of `better::map`) behaves
+ * the same way on all platforms, with or without Folly containers.
+ * `tests/benchmarks` compares them with the other maps on typical workloads.
+ */
+
 } // namespace better
 } // namespace facebook
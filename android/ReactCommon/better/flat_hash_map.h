@@ -0,0 +1,400 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <better/better.h>
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace facebook {
+namespace better {
+
+/*
+ * Hash map which stores its values in one flat array of slots (open
+ * addressing with linear probing), so a lookup usually touches a single cache
+ * line and inserting does not allocate (unless the map grows).
+ * Unlike `better::map`, it does not depend on Folly on any platform.
+ * The interface is a subset of `std::unordered_map`. Note that (unlike with
+ * `std::unordered_map`) inserting or erasing an element invalidates all
+ * iterators, pointers and references to elements.
+ */
+template <
+    typename Key,
+    typename T,
+    typename Hash = std::hash<Key>,
+    typename KeyEqual = std::equal_to<Key>>
+class flat_hash_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key const, T>;
+  using size_type = std::size_t;
+
+ private:
+  /*
+   * Storage for one (possibly absent) element. It is not `better::optional`
+   * because that aliases a Folly type on some platforms.
+   */
+  class Slot final {
+   public:
+    Slot() = default;
+
+    Slot(Slot const &other) {
+      if (other.has_value()) {
+        emplace(*other);
+      }
+    }
+
+    Slot(Slot &&other) {
+      if (other.has_value()) {
+        emplace(std::move(*other));
+      }
+    }
+
+    Slot &operator=(Slot const &other) {
+      if (this != &other) {
+        reset();
+        if (other.has_value()) {
+          emplace(*other);
+        }
+      }
+      return *this;
+    }
+
+    Slot &operator=(Slot &&other) {
+      if (this != &other) {
+        reset();
+        if (other.has_value()) {
+          emplace(std::move(*other));
+        }
+      }
+      return *this;
+    }
+
+    ~Slot() {
+      reset();
+    }
+
+    bool has_value() const {
+      return hasValue_;
+    }
+
+    template <typename... Args>
+    void emplace(Args &&... args) {
+      new (&storage_) value_type(std::forward<Args>(args)...);
+      hasValue_ = true;
+    }
+
+    void reset() {
+      if (hasValue_) {
+        (**this).~value_type();
+        hasValue_ = false;
+      }
+    }
+
+    value_type &operator*() {
+      return *reinterpret_cast<value_type *>(&storage_);
+    }
+
+    value_type const &operator*() const {
+      return *reinterpret_cast<value_type const *>(&storage_);
+    }
+
+    value_type *operator->() {
+      return &**this;
+    }
+
+    value_type const *operator->() const {
+      return &**this;
+    }
+
+   private:
+    typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type
+        storage_;
+    bool hasValue_{false};
+  };
+
+  template <typename ValueT, typename SlotT>
+  class basic_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ValueT;
+    using difference_type = std::ptrdiff_t;
+    using pointer = ValueT *;
+    using reference = ValueT &;
+
+    basic_iterator() = default;
+    basic_iterator(SlotT *slot, SlotT *end) : slot_(slot), end_(end) {
+      skipEmptySlots();
+    }
+
+    template <typename OtherValueT, typename OtherSlotT>
+    basic_iterator(basic_iterator<OtherValueT, OtherSlotT> const &other)
+        : slot_(other.slot_), end_(other.end_) {}
+
+    reference operator*() const {
+      return **slot_;
+    }
+
+    pointer operator->() const {
+      return &**slot_;
+    }
+
+    basic_iterator &operator++() {
+      slot_++;
+      skipEmptySlots();
+      return *this;
+    }
+
+    basic_iterator operator++(int) {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(basic_iterator const &rhs) const {
+      return slot_ == rhs.slot_;
+    }
+
+    bool operator!=(basic_iterator const &rhs) const {
+      return slot_ != rhs.slot_;
+    }
+
+   private:
+    friend class flat_hash_map;
+
+    void skipEmptySlots() {
+      while (slot_ != end_ && !slot_->has_value()) {
+        slot_++;
+      }
+    }
+
+    SlotT *slot_{nullptr};
+    SlotT *end_{nullptr};
+  };
+
+ public:
+  using iterator = basic_iterator<value_type, Slot>;
+  using const_iterator = basic_iterator<value_type const, Slot const>;
+
+  flat_hash_map() = default;
+
+  iterator begin() {
+    return {slots_.data(), slots_.data() + slots_.size()};
+  }
+
+  iterator end() {
+    return {slots_.data() + slots_.size(), slots_.data() + slots_.size()};
+  }
+
+  const_iterator begin() const {
+    return {slots_.data(), slots_.data() + slots_.size()};
+  }
+
+  const_iterator end() const {
+    return {slots_.data() + slots_.size(), slots_.data() + slots_.size()};
+  }
+
+  size_type size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  void clear() {
+    slots_.clear();
+    size_ = 0;
+    mask_ = 0;
+  }
+
+  /*
+   * Makes the map able to store `count` elements without growing.
+   */
+  void reserve(size_type count) {
+    auto capacity = size_type{kMinimalCapacity};
+    while (capacity * kMaxLoadNumerator < count * kMaxLoadDenominator) {
+      capacity *= 2;
+    }
+
+    if (capacity > slots_.size()) {
+      rehash(capacity);
+    }
+  }
+
+  iterator find(Key const &key) {
+    auto index = findIndex(key);
+    return index == kNotFound ? end() : iteratorAt(index);
+  }
+
+  const_iterator find(Key const &key) const {
+    auto index = findIndex(key);
+    return index == kNotFound
+        ? end()
+        : const_iterator{slots_.data() + index, slots_.data() + slots_.size()};
+  }
+
+  size_type count(Key const &key) const {
+    return findIndex(key) == kNotFound ? 0 : 1;
+  }
+
+  T &at(Key const &key) {
+    auto index = findIndex(key);
+    if (index == kNotFound) {
+      throw std::out_of_range("better::flat_hash_map::at");
+    }
+    return slots_[index]->second;
+  }
+
+  T const &at(Key const &key) const {
+    auto index = findIndex(key);
+    if (index == kNotFound) {
+      throw std::out_of_range("better::flat_hash_map::at");
+    }
+    return slots_[index]->second;
+  }
+
+  T &operator[](Key const &key) {
+    return emplace(key, T{}).first->second;
+  }
+
+  /*
+   * Inserts a value constructed from `args` for `key` unless the map already
+   * contains the key.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Key const &key, Args &&... args) {
+    auto index = findIndex(key);
+    if (index != kNotFound) {
+      return {iteratorAt(index), false};
+    }
+
+    reserve(size_ + 1);
+
+    index = idealIndex(key);
+    while (slots_[index].has_value()) {
+      index = (index + 1) & mask_;
+    }
+
+    slots_[index].emplace(
+        std::piecewise_construct,
+        std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    size_++;
+    return {iteratorAt(index), true};
+  }
+
+  std::pair<iterator, bool> insert(value_type const &value) {
+    return emplace(value.first, value.second);
+  }
+
+  size_type erase(Key const &key) {
+    auto index = findIndex(key);
+    if (index == kNotFound) {
+      return 0;
+    }
+
+    eraseAt(index);
+    return 1;
+  }
+
+  void erase(iterator position) {
+    eraseAt(position.slot_ - slots_.data());
+  }
+
+ private:
+  static constexpr size_type kNotFound = static_cast<size_type>(-1);
+  static constexpr size_type kMinimalCapacity = 8;
+
+  /*
+   * The map grows when it becomes more than 3/4 full.
+   */
+  static constexpr size_type kMaxLoadNumerator = 3;
+  static constexpr size_type kMaxLoadDenominator = 4;
+
+  iterator iteratorAt(size_type index) {
+    return {slots_.data() + index, slots_.data() + slots_.size()};
+  }
+
+  size_type idealIndex(Key const &key) const {
+    // Fibonacci hashing spreads sequential keys (such as tags, which
+    // `std::hash` maps to themselves) evenly.
+    auto hash = static_cast<uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_type>(hash >> 32) & mask_;
+  }
+
+  size_type findIndex(Key const &key) const {
+    if (size_ == 0) {
+      return kNotFound;
+    }
+
+    auto index = idealIndex(key);
+    while (slots_[index].has_value()) {
+      if (KeyEqual{}(slots_[index]->first, key)) {
+        return index;
+      }
+      index = (index + 1) & mask_;
+    }
+
+    return kNotFound;
+  }
+
+  void eraseAt(size_type index) {
+    slots_[index].reset();
+    size_--;
+
+    // Backward-shift deletion: moves the following elements of the probe
+    // sequence into the hole, so lookups never need tombstones.
+    auto hole = index;
+    auto next = (hole + 1) & mask_;
+    while (slots_[next].has_value()) {
+      auto ideal = idealIndex(slots_[next]->first);
+      // The element can fill the hole if the hole is between its ideal slot
+      // and its current slot (cyclically).
+      if (((next - ideal) & mask_) >= ((next - hole) & mask_)) {
+        slots_[hole].emplace(std::move(*slots_[next]));
+        slots_[next].reset();
+        hole = next;
+      }
+      next = (next + 1) & mask_;
+    }
+  }
+
+  void rehash(size_type capacity) {
+    auto slots = std::vector<Slot>(capacity);
+    std::swap(slots, slots_);
+    mask_ = capacity - 1;
+
+    for (auto &slot : slots) {
+      if (!slot.has_value()) {
+        continue;
+      }
+
+      auto index = idealIndex(slot->first);
+      while (slots_[index].has_value()) {
+        index = (index + 1) & mask_;
+      }
+      slots_[index].emplace(std::move(*slot));
+    }
+  }
+
+  std::vector<Slot> slots_{};
+  size_type size_{0};
+  size_type mask_{0};
+};
+
+} // namespace better
+} // namespace facebook
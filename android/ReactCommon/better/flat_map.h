@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <better/better.h>
+#include <better/small_vector.h>
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace facebook {
+namespace better {
+
+/*
+ * Ordered map which stores its elements in a vector sorted by key (modeled
+ * after C++23 `std::flat_map`), so lookups are binary searches over
+ * contiguous memory and a map with at most `Size` elements does not allocate
+ * (on platforms where `better::small_vector` has inline storage).
+ * It is meant for maps with a few dozen elements at most: inserting and erasing
+ * are linear, and they invalidate all iterators, pointers and references to
+ * elements. Keys must not be modified through iterators.
+ */
+template <
+    typename Key,
+    typename T,
+    std::size_t Size = 8,
+    typename Compare = std::less<Key>>
+class flat_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using size_type = std::size_t;
+
+ private:
+  using Container = better::small_vector<value_type, Size>;
+
+ public:
+  using iterator = typename Container::iterator;
+  using const_iterator = typename Container::const_iterator;
+
+  flat_map() = default;
+
+  iterator begin() {
+    return container_.begin();
+  }
+
+  iterator end() {
+    return container_.end();
+  }
+
+  const_iterator begin() const {
+    return container_.begin();
+  }
+
+  const_iterator end() const {
+    return container_.end();
+  }
+
+  size_type size() const {
+    return container_.size();
+  }
+
+  bool empty() const {
+    return container_.empty();
+  }
+
+  void clear() {
+    container_.clear();
+  }
+
+  void reserve(size_type count) {
+    container_.reserve(count);
+  }
+
+  iterator find(Key const &key) {
+    auto iterator = lowerBound(key);
+    return isMatch(iterator, key) ? iterator : end();
+  }
+
+  const_iterator find(Key const &key) const {
+    auto iterator = lowerBound(key);
+    return isMatch(iterator, key) ? iterator : end();
+  }
+
+  size_type count(Key const &key) const {
+    return isMatch(lowerBound(key), key) ? 1 : 0;
+  }
+
+  T &at(Key const &key) {
+    auto iterator = find(key);
+    if (iterator == end()) {
+      throw std::out_of_range("better::flat_map::at");
+    }
+    return iterator->second;
+  }
+
+  T const &at(Key const &key) const {
+    auto iterator = find(key);
+    if (iterator == end()) {
+      throw std::out_of_range("better::flat_map::at");
+    }
+    return iterator->second;
+  }
+
+  T &operator[](Key const &key) {
+    return emplace(key, T{}).first->second;
+  }
+
+  /*
+   * Inserts a value constructed from `args` for `key` unless the map already
+   * contains the key. Inserting keys in increasing order is the fastest.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Key const &key, Args &&... args) {
+    if (container_.empty() || Compare{}(container_.back().first, key)) {
+      container_.emplace_back(
+          std::piecewise_construct,
+          std::forward_as_tuple(key),
+          std::forward_as_tuple(std::forward<Args>(args)...));
+      return {container_.end() - 1, true};
+    }
+
+    auto iterator = lowerBound(key);
+    if (isMatch(iterator, key)) {
+      return {iterator, false};
+    }
+
+    iterator = container_.emplace(
+        iterator,
+        std::piecewise_construct,
+        std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    return {iterator, true};
+  }
+
+  std::pair<iterator, bool> insert(value_type const &value) {
+    return emplace(value.first, value.second);
+  }
+
+  size_type erase(Key const &key) {
+    auto iterator = find(key);
+    if (iterator == end()) {
+      return 0;
+    }
+
+    container_.erase(iterator);
+    return 1;
+  }
+
+  iterator erase(const_iterator position) {
+    return container_.erase(position);
+  }
+
+ private:
+  iterator lowerBound(Key const &key) {
+    return std::lower_bound(
+        container_.begin(), container_.end(), key, compareWithKey);
+  }
+
+  const_iterator lowerBound(Key const &key) const {
+    return std::lower_bound(
+        container_.begin(), container_.end(), key, compareWithKey);
+  }
+
+  bool isMatch(const_iterator iterator, Key const &key) const {
+    return iterator != container_.end() && !Compare{}(key, iterator->first);
+  }
+
+  static bool compareWithKey(value_type const &value, Key const &key) {
+    return Compare{}(value.first, key);
+  }
+
+  Container container_{};
+};
+
+} // namespace better
+} // namespace facebook
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <benchmark/benchmark.h>
+#include <better/flat_hash_map.h>
+#include <better/flat_map.h>
+#include <better/map.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace facebook {
+namespace better {
+
+/*
+ * Tags of children of a view (as the differentiator sees them): increasing
+ * odd numbers, like the ones the JavaScript side allocates.
+ */
+static std::vector<int> makeTags(int count) {
+  auto tags = std::vector<int>{};
+  tags.reserve(count);
+  for (auto index = 0; index < count; index++) {
+    tags.push_back(index * 2 + 1);
+  }
+  return tags;
+}
+
+/*
+ * Names of props of a typical view, in the order they are stored.
+ */
+static std::vector<std::string> const propNames = {
+    "accessibilityLabel",
+    "backgroundColor",
+    "borderRadius",
+    "flex",
+    "flexDirection",
+    "height",
+    "margin",
+    "nativeID",
+    "opacity",
+    "padding",
+    "pointerEvents",
+    "position",
+    "testID",
+    "transform",
+    "width",
+    "zIndex",
+};
+
+/*
+ * Builds a map of child tags to their indices and looks every child up once
+ * (in reverse order), which is what reordering a list of children does.
+ */
+template <typename Map>
+static void childIndexMap(benchmark::State &state) {
+  auto const tags = makeTags(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    auto map = Map{};
+    map.reserve(tags.size());
+    for (auto index = 0; index < tags.size(); index++) {
+      map.emplace(tags[index], index);
+    }
+
+    auto sum = 0;
+    for (auto it = tags.rbegin(); it != tags.rend(); it++) {
+      sum += map.find(*it)->second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK_TEMPLATE(childIndexMap, std::unordered_map<int, int>)
+    ->Arg(8)
+    ->Arg(100)
+    ->Arg(1000);
+BENCHMARK_TEMPLATE(childIndexMap, map<int, int>)->Arg(8)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(childIndexMap, flat_hash_map<int, int>)
+    ->Arg(8)
+    ->Arg(100)
+    ->Arg(1000);
+BENCHMARK_TEMPLATE(childIndexMap, flat_map<int, int, 8>)
+    ->Arg(8)
+    ->Arg(100)
+    ->Arg(1000);
+
+/*
+ * Looks up values in a long-living map of prop names.
+ */
+template <typename Map>
+static void propNameLookup(benchmark::State &state) {
+  auto map = Map{};
+  for (auto index = 0; index < propNames.size(); index++) {
+    map.emplace(propNames[index], index);
+  }
+
+  for (auto _ : state) {
+    auto sum = 0;
+    for (auto const &name : propNames) {
+      sum += map.find(name)->second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK_TEMPLATE(propNameLookup, std::unordered_map<std::string, int>);
+BENCHMARK_TEMPLATE(propNameLookup, map<std::string, int>);
+BENCHMARK_TEMPLATE(propNameLookup, flat_hash_map<std::string, int>);
+BENCHMARK_TEMPLATE(propNameLookup, flat_map<std::string, int, 16>);
+
+} // namespace better
+} // namespace facebook
+
+BENCHMARK_MAIN();
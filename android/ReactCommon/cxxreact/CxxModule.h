@@ -11,6 +11,7 @@
 #include <vector>
 
 #include <folly/dynamic.h>
+#include <jsi/jsi.h>
 
 using namespace std::placeholders;
 
@@ -72,11 +73,30 @@ public:
 
     std::function<folly::dynamic(folly::dynamic)> syncFunc;
 
+    // Sync methods which take and return JS values as they are, instead of
+    // converting them to and from folly::dynamic.
+    typedef std::function<facebook::jsi::Value(
+      facebook::jsi::Runtime&, const facebook::jsi::Value* args, size_t count)>
+      JSISyncFunc;
+    JSISyncFunc jsiSyncFunc;
+    bool isInline = false;
+
     const char *getType() {
-      assert(func || syncFunc);
+      assert(func || syncFunc || jsiSyncFunc);
       return func ? (isPromise ? "promise" : "async") : "sync";
     }
 
+    /**
+     * @return a copy of this asynchronous method which runs right away on the
+     * JS thread instead of being queued (see getDispatch), for methods which
+     * are trivially cheap and thread safe (e.g. they only set a flag).
+     */
+    Method inlined() const {
+      Method method = *this;
+      method.isInline = true;
+      return method;
+    }
+
     // std::function/lambda ctors
 
     Method(std::string aname,
@@ -179,8 +199,42 @@ public:
       , isPromise(false)
       , syncFunc(std::move(afunc))
       {}
+
+    Method(std::string aname,
+           JSISyncFunc&& afunc,
+           SyncTagType)
+      : name(std::move(aname))
+      , callbacks(0)
+      , isPromise(false)
+      , jsiSyncFunc(std::move(afunc))
+      {}
   };
 
+  /**
+   * @return an ArrayBuffer which owns bytes, for JSI sync methods which
+   * return binary data.
+   */
+  static facebook::jsi::Value makeArrayBuffer(
+      facebook::jsi::Runtime& runtime, std::vector<uint8_t> bytes) {
+    class VectorBuffer : public facebook::jsi::MutableBuffer {
+    public:
+      explicit VectorBuffer(std::vector<uint8_t> bytes)
+        : bytes_(std::move(bytes)) {}
+      size_t size() const override {
+        return bytes_.size();
+      }
+      uint8_t* data() override {
+        return bytes_.data();
+      }
+
+    private:
+      std::vector<uint8_t> bytes_;
+    };
+
+    return facebook::jsi::ArrayBuffer(
+      runtime, std::make_shared<VectorBuffer>(std::move(bytes)));
+  }
+
   /**
    * This may block, if necessary to complete cleanup before the
    * object is destroyed.
@@ -204,6 +258,27 @@ public:
    */
   virtual auto getMethods() -> std::vector<Method> = 0;
 
+  /**
+   * Where the asynchronous methods of a module run.
+   */
+  enum class Dispatch {
+    // In order on the native modules queue, which all modules share.
+    SharedQueue,
+    // In order on a queue of the module's own, so that slow methods (e.g.
+    // file I/O or hashing) don't delay the calls of other modules.
+    DedicatedQueue,
+    // Concurrently on a pool of threads shared by such modules. Only for
+    // reentrant modules, since calls may overlap and finish out of order.
+    Concurrent,
+  };
+
+  /**
+   * @return where the asynchronous methods of this module run, except for
+   * the inlined ones. Platforms which don't provide the queues (see
+   * CxxModuleQueues) run all of them on the shared queue.
+   */
+  virtual Dispatch getDispatch() { return Dispatch::SharedQueue; }
+
   /**
    *  Called during the construction of CxxNativeModule.
    */
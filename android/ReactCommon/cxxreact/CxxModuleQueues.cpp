@@ -0,0 +1,120 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "CxxModuleQueues.h"
+
+#include <algorithm>
+#include <future>
+
+namespace facebook {
+namespace react {
+
+ThreadPoolMessageQueueThread::ThreadPoolMessageQueueThread(
+    size_t threadCount,
+    ThreadRunner threadRunner)
+    : m_state(std::make_shared<State>()) {
+  for (size_t index = 0; index < std::max<size_t>(threadCount, 1); index++) {
+    m_threads.emplace_back([state = m_state, threadRunner] {
+      if (threadRunner) {
+        threadRunner([state] { loop(*state); });
+      } else {
+        loop(*state);
+      }
+    });
+  }
+}
+
+ThreadPoolMessageQueueThread::~ThreadPoolMessageQueueThread() {
+  quitSynchronous();
+}
+
+void ThreadPoolMessageQueueThread::runOnQueue(
+    std::function<void()>&& runnable) {
+  {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    if (m_state->quit) {
+      return;
+    }
+    m_state->queue.push_back(std::move(runnable));
+  }
+  m_state->condition.notify_one();
+}
+
+void ThreadPoolMessageQueueThread::runOnQueueSync(
+    std::function<void()>&& runnable) {
+  // If the queue quits first, the dropped runnable releases the promise,
+  // which makes the future ready too.
+  auto promise = std::make_shared<std::promise<void>>();
+  auto future = promise->get_future();
+  runOnQueue([&runnable, promise = std::move(promise)] {
+    runnable();
+    promise->set_value();
+  });
+  future.wait();
+}
+
+void ThreadPoolMessageQueueThread::quitSynchronous() {
+  std::deque<std::function<void()>> dropped;
+  {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    if (m_state->quit) {
+      return;
+    }
+    m_state->quit = true;
+    dropped.swap(m_state->queue);
+  }
+  m_state->condition.notify_all();
+
+  for (auto& thread : m_threads) {
+    if (thread.get_id() == std::this_thread::get_id()) {
+      // Quitting from a runnable, the thread exits once it returns. It keeps
+      // the state alive in case this object is destroyed by then.
+      thread.detach();
+    } else {
+      thread.join();
+    }
+  }
+}
+
+void ThreadPoolMessageQueueThread::loop(State& state) {
+  while (true) {
+    std::function<void()> runnable;
+    {
+      std::unique_lock<std::mutex> lock(state.mutex);
+      state.condition.wait(
+          lock, [&state] { return state.quit || !state.queue.empty(); });
+      if (state.quit) {
+        return;
+      }
+      runnable = std::move(state.queue.front());
+      state.queue.pop_front();
+    }
+    runnable();
+  }
+}
+
+CxxModuleQueues::CxxModuleQueues(
+    ThreadPoolMessageQueueThread::ThreadRunner threadRunner,
+    size_t concurrency)
+    : m_threadRunner(std::move(threadRunner)),
+      m_concurrency(
+          concurrency
+              ? concurrency
+              : std::max<size_t>(std::thread::hardware_concurrency() / 2, 2)) {}
+
+std::shared_ptr<MessageQueueThread> CxxModuleQueues::makeDedicatedQueue() {
+  return std::make_shared<ThreadPoolMessageQueueThread>(1, m_threadRunner);
+}
+
+std::shared_ptr<MessageQueueThread> CxxModuleQueues::getConcurrentQueue() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_concurrentQueue) {
+    m_concurrentQueue = std::make_shared<ThreadPoolMessageQueueThread>(
+        m_concurrency, m_threadRunner);
+  }
+  return m_concurrentQueue;
+}
+
+}}
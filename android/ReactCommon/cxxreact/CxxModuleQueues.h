@@ -0,0 +1,83 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <cxxreact/MessageQueueThread.h>
+
+#ifndef RN_EXPORT
+#define RN_EXPORT __attribute__((visibility("default")))
+#endif
+
+namespace facebook {
+namespace react {
+
+// A MessageQueueThread which runs its work on threads of its own. With one
+// thread it runs work in order like any other MessageQueueThread, with more
+// the work starts in order but runs concurrently.
+class RN_EXPORT ThreadPoolMessageQueueThread : public MessageQueueThread {
+public:
+  // Runs the loop of each thread, e.g. to attach the threads to the JVM.
+  using ThreadRunner = std::function<void(std::function<void()>&& loop)>;
+
+  ThreadPoolMessageQueueThread(
+    size_t threadCount,
+    ThreadRunner threadRunner = nullptr);
+  ~ThreadPoolMessageQueueThread() override;
+
+  void runOnQueue(std::function<void()>&& runnable) override;
+  void runOnQueueSync(std::function<void()>&& runnable) override;
+  // Waits for the runnables which are running, and drops the queued ones.
+  void quitSynchronous() override;
+
+private:
+  struct State {
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void()>> queue;
+    bool quit{false};
+  };
+
+  static void loop(State& state);
+
+  // Shared with the threads, which outlive this object when it's destroyed
+  // from one of its runnables.
+  std::shared_ptr<State> m_state;
+  std::vector<std::thread> m_threads;
+};
+
+// The queues which C++ modules can run their calls on instead of the native
+// modules queue shared by all modules (see CxxModule::getDispatch). Threads
+// are only started once a module asks for them.
+// Can be used from any thread.
+class RN_EXPORT CxxModuleQueues {
+public:
+  // A concurrency of 0 uses half of the cores, but at least two threads.
+  explicit CxxModuleQueues(
+    ThreadPoolMessageQueueThread::ThreadRunner threadRunner = nullptr,
+    size_t concurrency = 0);
+
+  // Makes a new serial queue for the calls of one module.
+  std::shared_ptr<MessageQueueThread> makeDedicatedQueue();
+
+  // Returns the pool which all reentrant modules share.
+  std::shared_ptr<MessageQueueThread> getConcurrentQueue();
+
+private:
+  const ThreadPoolMessageQueueThread::ThreadRunner m_threadRunner;
+  const size_t m_concurrency;
+  std::mutex m_mutex;
+  std::shared_ptr<MessageQueueThread> m_concurrentQueue;
+};
+
+}}
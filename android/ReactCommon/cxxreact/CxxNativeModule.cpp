@@ -4,6 +4,7 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "CxxNativeModule.h"
+#include "CxxModuleQueues.h"
 #include "Instance.h"
 
 #include <iterator>
@@ -48,6 +49,36 @@ CxxModule::Callback convertCallback(
   };
 }
 
+void callMethod(
+    const CxxModule::Method& method,
+    folly::dynamic&& params,
+    const CxxModule::Callback& first,
+    const CxxModule::Callback& second,
+    int callId) {
+#ifdef WITH_FBSYSTRACE
+  if (callId != -1) {
+    fbsystrace_end_async_flow(TRACE_TAG_REACT_APPS, "native", callId);
+  }
+#else
+  (void)(callId);
+#endif
+  TraceSection<TraceCategory::NativeModules> s(method.name.c_str());
+  try {
+    method.func(std::move(params), first, second);
+  } catch (const facebook::xplat::JsArgumentException& ex) {
+    throw;
+  } catch (std::exception& e) {
+    LOG(ERROR) << "std::exception. Method call " << method.name.c_str() << " failed: " << e.what();
+    std::terminate();
+  } catch (std::string& error) {
+    LOG(ERROR) << "std::string. Method call " << method.name.c_str() << " failed: " << error.c_str();
+    std::terminate();
+  } catch (...) {
+    LOG(ERROR) << "Method call " << method.name.c_str() << " failed. unknown error";
+    std::terminate();
+  }
+}
+
 }
 
 std::string CxxNativeModule::getName() {
@@ -131,30 +162,25 @@ void CxxNativeModule::invoke(unsigned int reactMethodId, folly::dynamic&& params
   // stack.  I'm told that will be possible in the future.  TODO
   // mhorowitz #7128529: convert C++ exceptions to Java
 
-  messageQueueThread_->runOnQueue([method, params=std::move(params), first, second, callId] () {
-  #ifdef WITH_FBSYSTRACE
-    if (callId != -1) {
-      fbsystrace_end_async_flow(TRACE_TAG_REACT_APPS, "native", callId);
-    }
-  #else
-    (void)(callId);
-  #endif
-    SystraceSection s(method.name.c_str());
-    try {
-      method.func(std::move(params), first, second);
-    } catch (const facebook::xplat::JsArgumentException& ex) {
-      throw;
-    } catch (std::exception& e) {
-      LOG(ERROR) << "std::exception. Method call " << method.name.c_str() << " failed: " << e.what();
-      std::terminate();
-    } catch (std::string& error) {
-      LOG(ERROR) << "std::string. Method call " << method.name.c_str() << " failed: " << error.c_str();
-      std::terminate();
-    } catch (...) {
-      LOG(ERROR) << "Method call " << method.name.c_str() << " failed. unknown error";
-      std::terminate();
-    }
-  });
+  queueCounters_->totalCalls++;
+  if (method.isInline) {
+    callMethod(method, std::move(params), first, second, callId);
+    return;
+  }
+
+  auto pendingCalls = ++queueCounters_->pendingCalls;
+  auto maxPendingCalls = queueCounters_->maxPendingCalls.load();
+  while (pendingCalls > maxPendingCalls &&
+         !queueCounters_->maxPendingCalls.compare_exchange_weak(
+           maxPendingCalls, pendingCalls)) {
+  }
+
+  dispatchQueue_->runOnQueue(
+    [module = module_, counters = queueCounters_, method,
+     params = std::move(params), first, second, callId] () mutable {
+      callMethod(method, std::move(params), first, second, callId);
+      counters->pendingCalls--;
+    });
 }
 
 MethodCallResult CxxNativeModule::callSerializableNativeHook(unsigned int hookId, folly::dynamic&& args) {
@@ -165,6 +191,12 @@ MethodCallResult CxxNativeModule::callSerializableNativeHook(unsigned int hookId
 
   const auto& method = methods_[hookId];
 
+  if (method.jsiSyncFunc) {
+    throw std::runtime_error(
+      folly::to<std::string>("Method ", method.name,
+                             " can only be invoked synchronously through JSI"));
+  }
+
   if (!method.syncFunc) {
     throw std::runtime_error(
       folly::to<std::string>("Method ", method.name,
@@ -174,6 +206,28 @@ MethodCallResult CxxNativeModule::callSerializableNativeHook(unsigned int hookId
   return method.syncFunc(std::move(args));
 }
 
+folly::Optional<jsi::Value> CxxNativeModule::callJSINativeHook(
+    jsi::Runtime& runtime, unsigned int hookId, const jsi::Value* args, size_t count) {
+  if (hookId >= methods_.size()) {
+    throw std::invalid_argument(
+      folly::to<std::string>("methodId ", hookId, " out of range [0..", methods_.size(), "]"));
+  }
+
+  const auto& method = methods_[hookId];
+  if (!method.jsiSyncFunc) {
+    return folly::none;
+  }
+  return method.jsiSyncFunc(runtime, args, count);
+}
+
+folly::Optional<NativeModuleQueueStats> CxxNativeModule::getQueueStats() {
+  NativeModuleQueueStats stats;
+  stats.pendingCalls = queueCounters_->pendingCalls;
+  stats.maxPendingCalls = queueCounters_->maxPendingCalls;
+  stats.totalCalls = queueCounters_->totalCalls;
+  return stats;
+}
+
 void CxxNativeModule::lazyInit() {
   if (module_ || !provider_) {
     return;
@@ -186,6 +240,20 @@ void CxxNativeModule::lazyInit() {
     methods_ = module_->getMethods();
     module_->setInstance(instance_);
   }
+
+  dispatchQueue_ = messageQueueThread_;
+  if (module_ && moduleQueues_) {
+    switch (module_->getDispatch()) {
+      case CxxModule::Dispatch::SharedQueue:
+        break;
+      case CxxModule::Dispatch::DedicatedQueue:
+        dispatchQueue_ = moduleQueues_->makeDedicatedQueue();
+        break;
+      case CxxModule::Dispatch::Concurrent:
+        dispatchQueue_ = moduleQueues_->getConcurrentQueue();
+        break;
+    }
+  }
 }
 
 }
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include <cxxreact/CxxModule.h>
 #include <cxxreact/NativeModule.h>
 
@@ -15,6 +17,7 @@
 namespace facebook {
 namespace react {
 
+class CxxModuleQueues;
 class Instance;
 class MessageQueueThread;
 
@@ -23,30 +26,50 @@ std::function<void(folly::dynamic)> makeCallback(
 
 class RN_EXPORT CxxNativeModule : public NativeModule {
 public:
+  // Calls run on messageQueueThread unless the module asks for another
+  // queue (see CxxModule::getDispatch), which moduleQueues provides.
   CxxNativeModule(std::weak_ptr<Instance> instance,
                   std::string name,
                   xplat::module::CxxModule::Provider provider,
-                  std::shared_ptr<MessageQueueThread> messageQueueThread)
+                  std::shared_ptr<MessageQueueThread> messageQueueThread,
+                  std::shared_ptr<CxxModuleQueues> moduleQueues = nullptr)
   : instance_(instance)
   , name_(std::move(name))
   , provider_(provider)
-  , messageQueueThread_(messageQueueThread) {}
+  , messageQueueThread_(messageQueueThread)
+  , moduleQueues_(std::move(moduleQueues)) {}
 
   std::string getName() override;
   std::vector<MethodDescriptor> getMethods() override;
   folly::dynamic getConstants() override;
   void invoke(unsigned int reactMethodId, folly::dynamic&& params, int callId) override;
   MethodCallResult callSerializableNativeHook(unsigned int hookId, folly::dynamic&& args) override;
+  folly::Optional<jsi::Value> callJSINativeHook(
+      jsi::Runtime& runtime, unsigned int hookId, const jsi::Value* args, size_t count) override;
+  folly::Optional<NativeModuleQueueStats> getQueueStats() override;
 
 private:
+  struct QueueCounters {
+    std::atomic<size_t> pendingCalls{0};
+    std::atomic<size_t> maxPendingCalls{0};
+    std::atomic<uint64_t> totalCalls{0};
+  };
+
   void lazyInit();
 
   std::weak_ptr<Instance> instance_;
   std::string name_;
   xplat::module::CxxModule::Provider provider_;
   std::shared_ptr<MessageQueueThread> messageQueueThread_;
-  std::unique_ptr<xplat::module::CxxModule> module_;
+  std::shared_ptr<CxxModuleQueues> moduleQueues_;
+  // Queued calls keep the module alive.
+  std::shared_ptr<xplat::module::CxxModule> module_;
   std::vector<xplat::module::CxxModule::Method> methods_;
+  std::shared_ptr<QueueCounters> queueCounters_ =
+    std::make_shared<QueueCounters>();
+  // The queue the module's calls run on. It's destroyed first, which waits for
+  // the running calls if the queue is the module's own.
+  std::shared_ptr<MessageQueueThread> dispatchQueue_;
 };
 
 }
@@ -31,6 +31,10 @@ namespace facebook {
 namespace react {
 
 Instance::~Instance() {
+  if (m_isInitializingAsync) {
+    std::unique_lock<std::mutex> lock(m_syncMutex);
+    m_syncCV.wait(lock, [this] { return m_syncReady; });
+  }
   if (nativeToJsBridge_) {
     nativeToJsBridge_->destroy();
   }
@@ -55,6 +59,37 @@ void Instance::initializeBridge(
   CHECK(nativeToJsBridge_);
 }
 
+void Instance::initializeBridgeAsync(
+    std::unique_ptr<InstanceCallback> callback,
+    std::shared_ptr<JSExecutorFactory> jsef,
+    std::shared_ptr<MessageQueueThread> jsQueue,
+    std::shared_ptr<ModuleRegistry> moduleRegistry,
+    std::function<void()> onInitialized) {
+  callback_ = std::move(callback);
+  moduleRegistry_ = std::move(moduleRegistry);
+  m_isInitializingAsync = true;
+  jsQueue->runOnQueue([this, jsef, jsQueue, onInitialized]() mutable {
+    SystraceSection s("Instance::initializeBridgeAsync");
+    auto nativeToJsBridge = folly::make_unique<NativeToJsBridge>(
+        jsef.get(), moduleRegistry_, jsQueue, callback_);
+
+    {
+      std::lock_guard<std::mutex> lock(m_syncMutex);
+      nativeToJsBridge_ = std::move(nativeToJsBridge);
+      m_syncReady = true;
+      m_syncCV.notify_all();
+    }
+    if (onInitialized) {
+      onInitialized();
+    }
+  });
+}
+
+bool Instance::isInitialized() {
+  std::lock_guard<std::mutex> lock(m_syncMutex);
+  return m_syncReady;
+}
+
 void Instance::loadApplication(std::unique_ptr<RAMBundleRegistry> bundleRegistry,
                                std::unique_ptr<const JSBigString> string,
                                std::string sourceURL) {
@@ -96,16 +131,20 @@ void Instance::loadScriptFromString(std::unique_ptr<const JSBigString> string,
   }
 }
 
-bool Instance::isIndexedRAMBundle(const char *sourcePath) {
+ScriptTag Instance::getScriptTag(const char *sourcePath) {
   std::ifstream bundle_stream(sourcePath, std::ios_base::in);
   BundleHeader header;
 
   if (!bundle_stream ||
       !bundle_stream.read(reinterpret_cast<char *>(&header), sizeof(header))) {
-    return false;
+    return ScriptTag::String;
   }
 
-  return parseTypeFromHeader(header) == ScriptTag::RAMBundle;
+  return parseTypeFromHeader(header);
+}
+
+bool Instance::isIndexedRAMBundle(const char *sourcePath) {
+  return getScriptTag(sourcePath) == ScriptTag::RAMBundle;
 }
 
 bool Instance::isIndexedRAMBundle(std::unique_ptr<const JSBigString>* script) {
@@ -158,6 +197,13 @@ void Instance::setGlobalVariable(std::string propName,
                                        std::move(jsonValue));
 }
 
+void Instance::setGlobalVariableLazily(
+    std::string propName,
+    std::unique_ptr<const JSBigString> jsonValue) {
+  nativeToJsBridge_->setGlobalVariableLazily(std::move(propName),
+                                             std::move(jsonValue));
+}
+
 void *Instance::getJavaScriptContext() {
   return nativeToJsBridge_ ? nativeToJsBridge_->getJavaScriptContext()
                            : nullptr;
@@ -172,16 +218,40 @@ bool Instance::isBatchActive() {
 }
 
 void Instance::callJSFunction(std::string &&module, std::string &&method,
-                              folly::dynamic &&params) {
+                              folly::dynamic &&params,
+                              MessageQueuePriority priority) {
+  callback_->incrementPendingJSCalls();
+  nativeToJsBridge_->callFunction(std::move(module), std::move(method),
+                                  std::move(params), priority);
+}
+
+void Instance::callJSCallback(uint64_t callbackId, folly::dynamic &&params,
+                              MessageQueuePriority priority) {
+  SystraceSection s("Instance::callJSCallback");
+  callback_->incrementPendingJSCalls();
+  nativeToJsBridge_->invokeCallback((double)callbackId, std::move(params),
+                                    priority);
+}
+
+void Instance::callJSFunction(std::string &&module, std::string &&method,
+                              std::shared_ptr<const JSArguments> params,
+                              MessageQueuePriority priority) {
   callback_->incrementPendingJSCalls();
   nativeToJsBridge_->callFunction(std::move(module), std::move(method),
-                                  std::move(params));
+                                  std::move(params), priority);
 }
 
-void Instance::callJSCallback(uint64_t callbackId, folly::dynamic &&params) {
+void Instance::callJSCallback(uint64_t callbackId,
+                              std::shared_ptr<const JSArguments> params,
+                              MessageQueuePriority priority) {
   SystraceSection s("Instance::callJSCallback");
   callback_->incrementPendingJSCalls();
-  nativeToJsBridge_->invokeCallback((double)callbackId, std::move(params));
+  nativeToJsBridge_->invokeCallback((double)callbackId, std::move(params),
+                                    priority);
+}
+
+void Instance::setCallCoalescingEnabled(bool enabled) {
+  nativeToJsBridge_->setCallCoalescingEnabled(enabled);
 }
 
 void Instance::registerBundle(uint32_t bundleId, const std::string& bundlePath) {
@@ -198,11 +268,12 @@ void Instance::handleMemoryPressure(int pressureLevel) {
   nativeToJsBridge_->handleMemoryPressure(pressureLevel);
 }
 
-void Instance::invokeAsync(std::function<void()>&& func) {
+void Instance::invokeAsync(std::function<void()>&& func,
+                           MessageQueuePriority priority) {
   nativeToJsBridge_->runOnExecutorQueue([func=std::move(func)](JSExecutor *executor) {
     func();
     executor->flush();
-  });
+  }, priority);
 }
 
 } // namespace react
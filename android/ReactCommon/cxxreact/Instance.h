@@ -6,8 +6,10 @@
 #pragma once
 
 #include <condition_variable>
+#include <functional>
 #include <memory>
 
+#include <cxxreact/JSBundleType.h>
 #include <cxxreact/NativeToJsBridge.h>
 
 #ifndef RN_EXPORT
@@ -41,11 +43,24 @@ public:
                         std::shared_ptr<JSExecutorFactory> jsef,
                         std::shared_ptr<MessageQueueThread> jsQueue,
                         std::shared_ptr<ModuleRegistry> moduleRegistry);
+  // Like initializeBridge, but returns right away instead of waiting for the
+  // executor (and JS runtime) to be made on the JS queue, e.g. to prepare an
+  // instance before it is needed. Nothing but loadScriptFromString with
+  // loadSynchronously, which waits, may be called before onInitialized is
+  // called (on the JS queue) or isInitialized() returns true.
+  void initializeBridgeAsync(std::unique_ptr<InstanceCallback> callback,
+                             std::shared_ptr<JSExecutorFactory> jsef,
+                             std::shared_ptr<MessageQueueThread> jsQueue,
+                             std::shared_ptr<ModuleRegistry> moduleRegistry,
+                             std::function<void()> onInitialized = nullptr);
+  bool isInitialized();
 
   void setSourceURL(std::string sourceURL);
 
   void loadScriptFromString(std::unique_ptr<const JSBigString> string,
                             std::string sourceURL, bool loadSynchronously);
+  // The format of the bundle in the file, String if it can't be read.
+  static ScriptTag getScriptTag(const char *sourcePath);
   static bool isIndexedRAMBundle(const char *sourcePath);
   static bool isIndexedRAMBundle(std::unique_ptr<const JSBigString>* string);
   void loadRAMBundleFromString(std::unique_ptr<const JSBigString> script, const std::string& sourceURL);
@@ -58,12 +73,29 @@ public:
   bool supportsProfiling();
   void setGlobalVariable(std::string propName,
                          std::unique_ptr<const JSBigString> jsonValue);
+  // See JSExecutor::setGlobalVariableLazily.
+  void setGlobalVariableLazily(std::string propName,
+                               std::unique_ptr<const JSBigString> jsonValue);
   void *getJavaScriptContext();
   bool isInspectable();
   bool isBatchActive();
-  void callJSFunction(std::string &&module, std::string &&method,
-                      folly::dynamic &&params);
-  void callJSCallback(uint64_t callbackId, folly::dynamic &&params);
+  void callJSFunction(
+      std::string &&module, std::string &&method, folly::dynamic &&params,
+      MessageQueuePriority priority = MessageQueuePriority::Normal);
+  void callJSCallback(
+      uint64_t callbackId, folly::dynamic &&params,
+      MessageQueuePriority priority = MessageQueuePriority::Normal);
+  // Same as above, for arguments which the executor turns into JS values
+  // itself (see JSArguments).
+  void callJSFunction(
+      std::string &&module, std::string &&method,
+      std::shared_ptr<const JSArguments> params,
+      MessageQueuePriority priority = MessageQueuePriority::Normal);
+  void callJSCallback(
+      uint64_t callbackId, std::shared_ptr<const JSArguments> params,
+      MessageQueuePriority priority = MessageQueuePriority::Normal);
+  // See NativeToJsBridge::setCallCoalescingEnabled.
+  void setCallCoalescingEnabled(bool enabled);
 
   // This method is experimental, and may be modified or removed.
   void registerBundle(uint32_t bundleId, const std::string& bundlePath);
@@ -73,7 +105,9 @@ public:
 
   void handleMemoryPressure(int pressureLevel);
 
-  void invokeAsync(std::function<void()>&& func);
+  void invokeAsync(
+      std::function<void()>&& func,
+      MessageQueuePriority priority = MessageQueuePriority::Normal);
 
 private:
   void callNativeModules(folly::dynamic &&calls, bool isEndOfBatch);
@@ -91,6 +125,9 @@ private:
   std::mutex m_syncMutex;
   std::condition_variable m_syncCV;
   bool m_syncReady = false;
+  // Set by initializeBridgeAsync, whose task refers to this instance until it
+  // has run.
+  bool m_isInitializingAsync = false;
 };
 
 } // namespace react
@@ -0,0 +1,124 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "InstancePool.h"
+
+#include <algorithm>
+
+#include "Instance.h"
+#include "SystraceSection.h"
+
+namespace facebook {
+namespace react {
+
+InstancePool::InstancePool(Factory factory, size_t size)
+    : m_factory(std::move(factory)),
+      m_size(size),
+      m_state(std::make_shared<State>()) {}
+
+InstancePool::~InstancePool() {
+  clear();
+}
+
+void InstancePool::prewarm() {
+  SystraceSection s("InstancePool::prewarm");
+  while (true) {
+    uint64_t id;
+    {
+      std::lock_guard<std::mutex> lock(m_state->mutex);
+      if (m_state->entries.size() >= m_size) {
+        return;
+      }
+      // The entry is added before the instance is made, as it may be
+      // initialized before the factory returns.
+      id = m_state->nextId++;
+      m_state->entries.push_back(Entry{id, nullptr, false});
+    }
+
+    std::weak_ptr<State> weakState = m_state;
+    std::unique_ptr<Instance> instance;
+    try {
+      instance = m_factory([weakState, id]() {
+        auto state = weakState.lock();
+        if (!state) {
+          return;
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        for (auto &entry : state->entries) {
+          if (entry.id == id) {
+            entry.isReady = true;
+          }
+        }
+      });
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(m_state->mutex);
+      m_state->entries.erase(std::remove_if(
+        m_state->entries.begin(),
+        m_state->entries.end(),
+        [id](const Entry &entry) { return entry.id == id; }),
+        m_state->entries.end());
+      throw;
+    }
+
+    // Destroyed outside of the lock, if it was cleared in the meantime.
+    std::unique_ptr<Instance> discarded;
+    {
+      std::lock_guard<std::mutex> lock(m_state->mutex);
+      auto entry = std::find_if(
+        m_state->entries.begin(),
+        m_state->entries.end(),
+        [id](const Entry &entry) { return entry.id == id; });
+      if (entry == m_state->entries.end()) {
+        discarded = std::move(instance);
+      } else if (!instance) {
+        // The factory failed; trying again won't help.
+        m_state->entries.erase(entry);
+        return;
+      } else {
+        entry->instance = std::move(instance);
+      }
+    }
+  }
+}
+
+std::unique_ptr<Instance> InstancePool::acquire() {
+  std::unique_ptr<Instance> instance;
+  {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    auto entry = std::find_if(
+      m_state->entries.begin(),
+      m_state->entries.end(),
+      [](const Entry &entry) { return entry.isReady && entry.instance; });
+    if (entry == m_state->entries.end()) {
+      return nullptr;
+    }
+    instance = std::move(entry->instance);
+    m_state->entries.erase(entry);
+  }
+  prewarm();
+  return instance;
+}
+
+size_t InstancePool::readyCount() const {
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  return std::count_if(
+    m_state->entries.begin(),
+    m_state->entries.end(),
+    [](const Entry &entry) { return entry.isReady && entry.instance; });
+}
+
+void InstancePool::clear() {
+  std::vector<Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    entries.swap(m_state->entries);
+  }
+  // Instances wait for their initialization when destroyed, which must not
+  // happen under the lock their callback takes.
+  entries.clear();
+}
+
+}  // namespace react
+}  // namespace facebook
@@ -0,0 +1,69 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef RN_EXPORT
+#define RN_EXPORT __attribute__((visibility("default")))
+#endif
+
+namespace facebook {
+namespace react {
+
+class Instance;
+
+// Keeps instances whose bridges (executor, JS runtime and native modules) are
+// made ahead of time, so that opening an app (or reloading it) only has to
+// load its bundle. Instances are initialized on their own JS queues, so the
+// pool needs no thread of its own. Thread safe.
+class RN_EXPORT InstancePool {
+public:
+  // Makes an instance and starts initializing it with
+  // Instance::initializeBridgeAsync, passing it onInitialized.
+  using Factory = std::function<std::unique_ptr<Instance>(
+    std::function<void()> onInitialized)>;
+
+  InstancePool(Factory factory, size_t size);
+  ~InstancePool();
+
+  // Makes instances until the pool has `size` of them, initialized or not.
+  void prewarm();
+
+  // Returns an initialized instance, and starts making another one in its
+  // place. Returns nullptr if no instance is initialized yet, for the caller
+  // to make one itself rather than wait.
+  std::unique_ptr<Instance> acquire();
+
+  // Number of initialized instances.
+  size_t readyCount() const;
+
+  // Destroys all instances, e.g. when memory is low.
+  void clear();
+
+private:
+  struct Entry {
+    uint64_t id;
+    std::unique_ptr<Instance> instance;
+    bool isReady;
+  };
+  // Shared with the callbacks of instances, which may outlive the pool.
+  struct State {
+    std::mutex mutex;
+    std::vector<Entry> entries;
+    uint64_t nextId{0};
+  };
+
+  Factory m_factory;
+  size_t m_size;
+  std::shared_ptr<State> m_state;
+};
+
+}  // namespace react
+}  // namespace facebook
@@ -9,6 +9,9 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstring>
+
 #include <glog/logging.h>
 
 #include <folly/Memory.h>
@@ -18,9 +21,70 @@
 namespace facebook {
 namespace react {
 
-JSBigFileString::JSBigFileString(int fd, size_t size, off_t offset /*= 0*/)
+JSBigSegmentedString::JSBigSegmentedString(
+    std::vector<std::shared_ptr<const JSBigString>> segments)
+  : m_segments(std::move(segments)) {
+  for (const auto& segment : m_segments) {
+    m_size += segment->size();
+    m_isAscii = m_isAscii && segment->isAscii();
+  }
+}
+
+JSBigSegmentedString::~JSBigSegmentedString() {
+  if (m_mappingSize) {
+    munmap((void *)m_data, m_mappingSize);
+  }
+}
+
+const char* JSBigSegmentedString::c_str() const {
+  std::call_once(m_joined, [this] { join(); });
+  return m_data;
+}
+
+void JSBigSegmentedString::forEachSegment(
+    const std::function<void(const char* data, size_t size)>& visit) const {
+  if (m_data) {
+    visit(m_data, m_size);
+    return;
+  }
+  for (const auto& segment : m_segments) {
+    visit(segment->c_str(), segment->size());
+  }
+}
+
+void JSBigSegmentedString::join() const {
+  if (m_size == 0) {
+    m_data = "";
+  } else {
+    // Unlike the heap, the mapping goes back to the system as a whole when
+    // the code is destroyed (e.g. on reload).
+    auto size = m_size + 1;
+    auto data = (char *) mmap(
+      0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CHECK(data != MAP_FAILED)
+      << " size: " << size
+      << " error: " << std::strerror(errno);
+    auto end = data;
+    for (const auto& segment : m_segments) {
+      std::memcpy(end, segment->c_str(), segment->size());
+      end += segment->size();
+    }
+    *end = '\0';
+    mprotect(data, size, PROT_READ);
+    m_data = data;
+    m_mappingSize = size;
+  }
+  std::vector<std::shared_ptr<const JSBigString>>().swap(m_segments);
+}
+
+JSBigFileString::JSBigFileString(
+    int fd,
+    size_t size,
+    off_t offset /*= 0*/,
+    JSBigFileMappingPolicy policy /*= {}*/)
   : m_fd { -1 }
-  , m_data { nullptr } {
+  , m_data { nullptr }
+  , m_policy { policy } {
   folly::checkUnixError(m_fd = dup(fd),
     "Could not duplicate file descriptor");
 
@@ -32,7 +96,7 @@ JSBigFileString::JSBigFileString(int fd, size_t size, off_t offset /*= 0*/)
     const static auto ps = getpagesize();
     auto d = lldiv(offset, ps);
 
-    m_mapOff = d.quot;
+    m_mapOff = d.quot * ps;
     m_pageOff = d.rem;
     m_size = size + m_pageOff;
   } else {
@@ -114,8 +178,7 @@ const char *JSBigFileString::c_str() const {
     return "";
   }
   if (!m_data) {
-    m_data =
-      (const char *) mmap(0, m_size, PROT_READ, MAP_PRIVATE, m_fd, m_mapOff);
+    m_data = map();
     CHECK(m_data != MAP_FAILED)
       << " fd: " << m_fd
       << " size: " << m_size
@@ -127,10 +190,84 @@ const char *JSBigFileString::c_str() const {
       m_pageOff = maybeRemap(const_cast<char *>(m_data), m_size, m_fd);
     }
 #endif // WITH_FBREMAP
+    applyPolicy();
   }
   return m_data + m_pageOff;
 }
 
+const char *JSBigFileString::map() const {
+  int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+  if (m_policy.populateSize >= m_size && !m_policy.lockPopulated) {
+    flags |= MAP_POPULATE;
+  }
+#endif
+
+#ifdef MADV_HUGEPAGE
+  if (m_policy.useHugePages) {
+    // Reserves an address range big enough to contain a huge page-aligned
+    // mapping of the requested size, maps the file over it and releases the
+    // rest of the range.
+    static const size_t kHugePageSize = 2 * 1024 * 1024;
+    const static size_t ps = getpagesize();
+    const size_t reservedSize = m_size + kHugePageSize;
+    auto reserved = (char *) mmap(
+      0, reservedSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved != MAP_FAILED) {
+      auto aligned = (char *)
+        (((uintptr_t) reserved + kHugePageSize - 1) & ~(kHugePageSize - 1));
+      auto data = (char *) mmap(
+        aligned, m_size, PROT_READ, flags | MAP_FIXED, m_fd, m_mapOff);
+      if (data == MAP_FAILED) {
+        munmap(reserved, reservedSize);
+        return (const char *) MAP_FAILED;
+      }
+      auto end = (char *) (((uintptr_t) data + m_size + ps - 1) & ~(ps - 1));
+      if (aligned != reserved) {
+        munmap(reserved, aligned - reserved);
+      }
+      if (end < reserved + reservedSize) {
+        munmap(end, reserved + reservedSize - end);
+      }
+      madvise(data, m_size, MADV_HUGEPAGE);
+      return data;
+    }
+  }
+#endif
+
+  return (const char *) mmap(0, m_size, PROT_READ, flags, m_fd, m_mapOff);
+}
+
+void JSBigFileString::applyPolicy() const {
+  auto data = const_cast<char *>(m_data);
+
+  switch (m_policy.access) {
+    case JSBigFileMappingPolicy::Access::Default:
+      break;
+    case JSBigFileMappingPolicy::Access::Sequential:
+      madvise(data, m_size, MADV_SEQUENTIAL);
+      break;
+    case JSBigFileMappingPolicy::Access::Random:
+      madvise(data, m_size, MADV_RANDOM);
+      break;
+  }
+
+  const size_t populateSize =
+    std::min(m_size, m_pageOff + m_policy.populateSize);
+  if (populateSize == 0) {
+    return;
+  }
+
+  if (m_policy.lockPopulated) {
+    // Fails if the memory lock limit is exceeded; the pages are read in on
+    // demand then.
+    if (mlock(data, populateSize) == 0) {
+      return;
+    }
+  }
+  madvise(data, populateSize, MADV_WILLNEED);
+}
+
 size_t JSBigFileString::size() const {
   // Ensure mapping has been initialized.
   c_str();
@@ -141,7 +278,9 @@ int JSBigFileString::fd() const {
   return m_fd;
 }
 
-std::unique_ptr<const JSBigFileString> JSBigFileString::fromPath(const std::string& sourceURL) {
+std::unique_ptr<const JSBigFileString> JSBigFileString::fromPath(
+    const std::string& sourceURL,
+    JSBigFileMappingPolicy policy /*= {}*/) {
   int fd = ::open(sourceURL.c_str(), O_RDONLY);
   folly::checkUnixError(fd, "Could not open file", sourceURL);
   SCOPE_EXIT { CHECK(::close(fd) == 0); };
@@ -149,7 +288,8 @@ std::unique_ptr<const JSBigFileString> JSBigFileString::fromPath(const std::stri
   struct stat fileInfo;
   folly::checkUnixError(::fstat(fd, &fileInfo), "fstat on bundle failed.");
 
-  return folly::make_unique<const JSBigFileString>(fd, fileInfo.st_size);
+  return folly::make_unique<const JSBigFileString>(
+    fd, fileInfo.st_size, 0, policy);
 }
 
 }  // namespace react
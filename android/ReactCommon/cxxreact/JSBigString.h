@@ -8,6 +8,11 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include <folly/Exception.h>
 
 #ifndef RN_EXPORT
@@ -111,11 +116,113 @@ private:
   size_t m_size;
 };
 
+// Concrete JSBigString implementation which refers to a part of another
+// JSBigString (e.g. a module inside of a memory-mapped bundle) without
+// copying it. The part must be followed by a \0 byte in the parent string.
+// The parent string is kept alive by the slice.
+class RN_EXPORT JSBigStringSlice : public JSBigString {
+public:
+  JSBigStringSlice(
+      std::shared_ptr<const JSBigString> parent,
+      size_t offset,
+      size_t size)
+  : m_parent(std::move(parent))
+  , m_data(m_parent->c_str() + offset)
+  , m_size(size) {}
+
+  bool isAscii() const override {
+    return m_parent->isAscii();
+  }
+
+  const char* c_str() const override {
+    return m_data;
+  }
+
+  size_t size() const override {
+    return m_size;
+  }
+
+private:
+  std::shared_ptr<const JSBigString> m_parent;
+  const char* m_data;
+  size_t m_size;
+};
+
+// Concrete JSBigString implementation made of segments (e.g. the parts of a
+// delta bundle), which are only joined once c_str() is first called: into an
+// anonymous memory mapping instead of a std::string, after which the segments
+// are released. As long as nothing else holds on to them, the code is only in
+// memory twice while it is being joined.
+// Consumers which can take the code in pieces use forEachSegment() instead,
+// and it is never joined.
+class RN_EXPORT JSBigSegmentedString : public JSBigString {
+public:
+  explicit JSBigSegmentedString(
+    std::vector<std::shared_ptr<const JSBigString>> segments);
+  ~JSBigSegmentedString();
+
+  bool isAscii() const override {
+    return m_isAscii;
+  }
+
+  // Joins the segments the first time. Can be called from any thread.
+  const char* c_str() const override;
+
+  size_t size() const override {
+    return m_size;
+  }
+
+  // Calls visit with each segment in order, or with the joined code once it
+  // has been joined. Must not run concurrently with the first c_str().
+  void forEachSegment(
+    const std::function<void(const char* data, size_t size)>& visit) const;
+
+private:
+  void join() const;
+
+  mutable std::vector<std::shared_ptr<const JSBigString>> m_segments;
+  size_t m_size{0};
+  bool m_isAscii{true};
+  mutable std::once_flag m_joined;
+  mutable const char* m_data{nullptr};
+  mutable size_t m_mappingSize{0};
+};
+
+// How a JSBigFileString maps its file. All of these are hints: whatever the
+// system does not support is silently ignored.
+struct JSBigFileMappingPolicy {
+  enum class Access {
+    Default,
+    // The file is read from the beginning to the end (e.g. a plain bundle
+    // which is parsed in one go): more readahead, pages dropped sooner.
+    Sequential,
+    // The file is read in small pieces all over the place (e.g. a RAM
+    // bundle): no readahead.
+    Random,
+  };
+
+  Access access{Access::Default};
+  // Number of bytes from the beginning of the mapping (e.g. the startup code
+  // of a bundle) which are read in ahead of time when the file is mapped.
+  // Mapping the whole file this way uses a single populating mmap where
+  // supported.
+  size_t populateSize{0};
+  // Also locks the populated bytes in memory (which reads them in before
+  // c_str() returns), as far as the memory lock limit allows.
+  bool lockPopulated{false};
+  // Aligns the mapping to (and advises the kernel to back it with) huge pages.
+  bool useHugePages{false};
+};
+
 // JSBigString interface implemented by a file-backed mmap region.
 class RN_EXPORT JSBigFileString : public JSBigString {
 public:
 
-  JSBigFileString(int fd, size_t size, off_t offset = 0);
+  JSBigFileString(
+    int fd,
+    size_t size,
+    off_t offset = 0,
+    JSBigFileMappingPolicy policy = {});
   ~JSBigFileString();
 
   bool isAscii() const override {
@@ -127,14 +234,20 @@ public:
   size_t size() const override;
   int fd() const;
 
-  static std::unique_ptr<const JSBigFileString> fromPath(const std::string& sourceURL);
+  static std::unique_ptr<const JSBigFileString> fromPath(
+    const std::string& sourceURL,
+    JSBigFileMappingPolicy policy = {});
 
 private:
+  const char *map() const;
+  void applyPolicy() const;
+
   int m_fd;                     // The file descriptor being mmaped
   size_t m_size;                // The size of the mmaped region
   mutable off_t m_pageOff;      // The offset in the mmaped region to the data.
   off_t m_mapOff;               // The offset in the file to the mmaped region.
   mutable const char *m_data;   // Pointer to the mmaped region.
+  JSBigFileMappingPolicy m_policy;
 };
 
 } }
@@ -0,0 +1,162 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "JSBundleStream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ios>
+#include <stdexcept>
+
+#include <folly/Bits.h>
+#include <folly/Memory.h>
+
+namespace facebook {
+namespace react {
+
+namespace {
+// Magic number, number of module table entries and startup code size.
+constexpr size_t kRAMBundleHeaderSize = 12;
+// Offset and length of the code of a module.
+constexpr size_t kRAMBundleTableEntrySize = 8;
+
+uint32_t readUInt32(const char *data) {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return folly::Endian::little(value);
+}
+}
+
+JSBundleStream::JSBundleStream(
+    size_t expectedSize,
+    ModuleCallback onModuleReceived)
+    : m_onModuleReceived(std::move(onModuleReceived)) {
+  m_hash.Init(0, 0);
+  reserve(std::max<size_t>(expectedSize, 4096));
+}
+
+void JSBundleStream::append(const char *data, size_t size) {
+  if (m_isFinished) {
+    throw std::logic_error("Cannot append to a finished JSBundleStream");
+  }
+  if (size == 0) {
+    return;
+  }
+
+  if (m_buffer->size() - m_size < size) {
+    reserve(std::max(m_buffer->size() * 2, m_size + size));
+  }
+  std::memcpy(m_buffer->data() + m_size, data, size);
+  m_size += size;
+  m_hash.Update(data, size);
+
+  if (!m_hasHeader) {
+    readHeader();
+  }
+  if (m_scriptTag == ScriptTag::RAMBundle) {
+    if (!m_hasModuleTable) {
+      readModuleTable();
+    }
+    emitReceivedModules();
+  }
+}
+
+uint64_t JSBundleStream::hash() const {
+  uint64_t hash1, hash2;
+  m_hash.Final(&hash1, &hash2);
+  return hash1;
+}
+
+std::unique_ptr<const JSBigString> JSBundleStream::finish() {
+  if (m_isFinished) {
+    throw std::logic_error("JSBundleStream can only be finished once");
+  }
+  m_isFinished = true;
+
+  if (m_scriptTag == ScriptTag::RAMBundle &&
+      (!m_hasModuleTable || m_nextPendingModule < m_pendingModules.size())) {
+    throw std::ios_base::failure("Unexpected end of RAM Bundle stream");
+  }
+
+  // The buffer always has a byte to spare for the terminating \0.
+  m_buffer->data()[m_size] = '\0';
+  std::shared_ptr<const JSBigString> buffer = std::move(m_buffer);
+  return folly::make_unique<JSBigStringSlice>(std::move(buffer), 0, m_size);
+}
+
+void JSBundleStream::reserve(size_t size) {
+  // JSBigBufferString terminates its buffer, which is where the \0 goes if
+  // the bundle fills it up completely.
+  auto buffer = folly::make_unique<JSBigBufferString>(size);
+  if (m_buffer) {
+    std::memcpy(buffer->data(), m_buffer->c_str(), m_size);
+  }
+  m_buffer = std::move(buffer);
+}
+
+void JSBundleStream::readHeader() {
+  BundleHeader header;
+  if (m_size < sizeof(header)) {
+    return;
+  }
+  std::memcpy(&header, m_buffer->c_str(), sizeof(header));
+  m_scriptTag = parseTypeFromHeader(header);
+  m_hasHeader = true;
+}
+
+void JSBundleStream::readModuleTable() {
+  const char *data = m_buffer->c_str();
+  if (m_tableEnd == 0) {
+    const size_t numTableEntries = readUInt32(data + 4);
+    m_tableEnd = kRAMBundleHeaderSize + numTableEntries * kRAMBundleTableEntrySize;
+  }
+  if (m_size < m_tableEnd) {
+    return;
+  }
+
+  // Module offsets are relative to the startup code, which follows the table.
+  for (size_t offset = kRAMBundleHeaderSize; offset < m_tableEnd;
+       offset += kRAMBundleTableEntrySize) {
+    const uint32_t moduleOffset = readUInt32(data + offset);
+    const uint32_t length = readUInt32(data + offset + 4);
+    // Entries without code have offset = 0 and length = 0.
+    if (length == 0) {
+      continue;
+    }
+    m_pendingModules.push_back(PendingModule{
+      static_cast<uint32_t>(
+        (offset - kRAMBundleHeaderSize) / kRAMBundleTableEntrySize),
+      m_tableEnd + moduleOffset,
+      length});
+  }
+  std::sort(
+    m_pendingModules.begin(),
+    m_pendingModules.end(),
+    [](const PendingModule &lhs, const PendingModule &rhs) {
+      return lhs.offset + lhs.length < rhs.offset + rhs.length;
+    });
+  m_hasModuleTable = true;
+}
+
+void JSBundleStream::emitReceivedModules() {
+  for (; m_nextPendingModule < m_pendingModules.size(); m_nextPendingModule++) {
+    const auto &module = m_pendingModules[m_nextPendingModule];
+    if (module.offset + module.length > m_size) {
+      return;
+    }
+    if (!m_onModuleReceived) {
+      continue;
+    }
+    // The buffer may still be reallocated, so the code is copied out of it
+    // (without the terminating \0, which its JSBigBufferString adds).
+    auto code = folly::make_unique<JSBigBufferString>(module.length - 1);
+    std::memcpy(
+      code->data(), m_buffer->c_str() + module.offset, module.length - 1);
+    m_onModuleReceived(module.moduleId, std::move(code));
+  }
+}
+
+}  // namespace react
+}  // namespace facebook
@@ -0,0 +1,97 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <cxxreact/JSBigString.h>
+#include <cxxreact/JSBundleType.h>
+#include <folly/hash/SpookyHashV2.h>
+
+#ifndef RN_EXPORT
+#define RN_EXPORT __attribute__((visibility("default")))
+#endif
+
+namespace facebook {
+namespace react {
+
+// Receives a bundle in chunks, as it is downloaded (e.g. for an update), so
+// that the work which follows the download overlaps with it instead: the
+// bundle is hashed as it arrives, and each module of an indexed RAM bundle is
+// handed out (e.g. to be parsed or compiled ahead of time) as soon as all of
+// it has been received.
+// Once the download is complete, finish() returns the bundle without copying
+// it, for Instance::loadScriptFromString or loadRAMBundleFromString.
+// Not thread safe: all calls must be made on the same thread (or be
+// synchronized), normally the one reading the download.
+class RN_EXPORT JSBundleStream {
+public:
+  // Called on the appending thread, so it should only hand the work off
+  // (e.g. to a background queue) if it is expensive.
+  using ModuleCallback = std::function<
+    void(uint32_t moduleId, std::unique_ptr<const JSBigString> code)>;
+
+  // expectedSize is the size of the bundle if it is known up front (e.g. from
+  // Content-Length), which saves reallocations, or 0.
+  explicit JSBundleStream(
+    size_t expectedSize = 0,
+    ModuleCallback onModuleReceived = nullptr);
+
+  // Throws std::logic_error after finish().
+  void append(const char *data, size_t size);
+
+  // The format of the bundle, once its header has been received (String
+  // until then).
+  ScriptTag getScriptTag() const {
+    return m_scriptTag;
+  }
+
+  size_t size() const {
+    return m_size;
+  }
+
+  // A 64 bit SpookyHashV2 (seeded with 0) of everything received so far,
+  // which is the same as hashing the whole bundle once it is complete.
+  uint64_t hash() const;
+
+  // Returns the whole bundle. Throws std::ios_base::failure if an indexed RAM
+  // bundle is incomplete, and std::logic_error if called twice.
+  std::unique_ptr<const JSBigString> finish();
+
+private:
+  struct PendingModule {
+    uint32_t moduleId;
+    // From the beginning of the bundle, including the terminating \0 byte.
+    size_t offset;
+    size_t length;
+  };
+
+  void reserve(size_t size);
+  void readHeader();
+  void readModuleTable();
+  void emitReceivedModules();
+
+  ModuleCallback m_onModuleReceived;
+  std::unique_ptr<JSBigBufferString> m_buffer;
+  size_t m_size{0};
+  bool m_isFinished{false};
+  folly::hash::SpookyHashV2 m_hash;
+
+  ScriptTag m_scriptTag{ScriptTag::String};
+  bool m_hasHeader{false};
+  // For indexed RAM bundles: the size of the header and module table, once
+  // known, and the modules which are not complete yet, by end offset.
+  size_t m_tableEnd{0};
+  bool m_hasModuleTable{false};
+  std::vector<PendingModule> m_pendingModules;
+  size_t m_nextPendingModule{0};
+};
+
+}  // namespace react
+}  // namespace facebook
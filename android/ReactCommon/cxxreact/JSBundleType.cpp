@@ -12,6 +12,9 @@ namespace react {
 
 static uint32_t constexpr RAMBundleMagicNumber = 0xFB0BD1E5;
 static uint32_t constexpr BCBundleMagicNumber  = 0x6D657300;
+// The two halves of Hermes' 64 bit bytecode magic number, 0x1F1903C103BC1FC6.
+static uint32_t constexpr HBCBundleMagicNumber  = 0x03BC1FC6;
+static uint32_t constexpr HBCBundleMagicNumberHigh = 0x1F1903C1;
 
 ScriptTag parseTypeFromHeader(const BundleHeader& header) {
   switch (folly::Endian::little(header.magic)) {
@@ -19,6 +22,11 @@ ScriptTag parseTypeFromHeader(const BundleHeader& header) {
     return ScriptTag::RAMBundle;
   case BCBundleMagicNumber:
     return ScriptTag::BCBundle;
+  case HBCBundleMagicNumber:
+    if (folly::Endian::little(header.reserved_) == HBCBundleMagicNumberHigh) {
+      return ScriptTag::HBCBundle;
+    }
+    return ScriptTag::String;
   default:
     return ScriptTag::String;
   }
@@ -32,6 +40,8 @@ const char *stringForScriptTag(const ScriptTag& tag) {
       return "RAM Bundle";
     case ScriptTag::BCBundle:
       return "BC Bundle";
+    case ScriptTag::HBCBundle:
+      return "HBC Bundle";
   }
   return "";
 }
@@ -26,13 +26,15 @@ enum struct ScriptTag {
   String = 0,
   RAMBundle,
   BCBundle,
+  HBCBundle,
 };
 
 /**
  * BundleHeader
  *
  * RAM bundles and BC bundles begin with headers. For RAM bundles this is
- * 4 bytes, for BC bundles this is 12 bytes. This structure holds the first 12
+ * 4 bytes, for BC bundles this is 12 bytes. Hermes bytecode begins with an
+ * 8 byte magic number. This structure holds the first 12
  * bytes from a bundle in a way that gives access to that information.
  */
 FOLLY_PACK_PUSH
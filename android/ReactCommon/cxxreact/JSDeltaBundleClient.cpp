@@ -5,36 +5,41 @@
 
 #include "JSDeltaBundleClient.h"
 
-#include <sstream>
-
 #include <folly/Memory.h>
 
 namespace facebook {
 namespace react {
 
 namespace {
-  std::string startupCode(const folly::dynamic *pre, const folly::dynamic *post) {
-    std::ostringstream startupCode;
-
+  std::shared_ptr<const JSBigSegmentedString> startupCode(
+      folly::dynamic *pre, folly::dynamic *post) {
+    static const auto newline = std::make_shared<JSBigStdString>("\n", true);
+    std::vector<std::shared_ptr<const JSBigString>> segments;
     for (auto section : {pre, post}) {
       if (section != nullptr) {
-        startupCode << section->getString() << '\n';
+        segments.push_back(
+          std::make_shared<JSBigStdString>(std::move(section->getString())));
+        segments.push_back(newline);
       }
     }
 
-    return startupCode.str();
+    return std::make_shared<JSBigSegmentedString>(std::move(segments));
   }
 } // namespace
 
-void JSDeltaBundleClient::patchModules(const folly::dynamic *modules) {
-  for (const folly::dynamic pair : *modules) {
+void JSDeltaBundleClient::patchModules(folly::dynamic *modules) {
+  for (folly::dynamic& pair : *modules) {
     auto id = pair[0].getInt();
-    auto module = pair[1];
-    modules_[id] = std::move(module.getString());
+    modules_[id] =
+      std::make_shared<JSBigStdString>(std::move(pair[1].getString()));
   }
 }
 
 void JSDeltaBundleClient::patch(const folly::dynamic& delta) {
+  patch(folly::dynamic(delta));
+}
+
+void JSDeltaBundleClient::patch(folly::dynamic&& delta) {
   auto const base = delta.get_ptr("base");
 
   if (base != nullptr && base->asBool()) {
@@ -45,31 +50,31 @@ void JSDeltaBundleClient::patch(const folly::dynamic& delta) {
 
     startupCode_ = startupCode(pre, post);
 
-    const folly::dynamic *modules = delta.get_ptr("modules");
+    folly::dynamic *modules = delta.get_ptr("modules");
     if (modules != nullptr) {
       patchModules(modules);
     }
   } else {
     const folly::dynamic *deleted = delta.get_ptr("deleted");
     if (deleted != nullptr) {
-      for (const folly::dynamic id : *deleted) {
+      for (const folly::dynamic& id : *deleted) {
         modules_.erase(id.getInt());
       }
     }
 
     // TODO T37123645 This is deprecated but necessary in order to support older
     // versions of the Metro server.
-    const folly::dynamic *modules = delta.get_ptr("modules");
+    folly::dynamic *modules = delta.get_ptr("modules");
     if (modules != nullptr) {
       patchModules(modules);
     }
 
-    const folly::dynamic *added = delta.get_ptr("added");
+    folly::dynamic *added = delta.get_ptr("added");
     if (added != nullptr) {
       patchModules(added);
     }
 
-    const folly::dynamic *modified = delta.get_ptr("modified");
+    folly::dynamic *modified = delta.get_ptr("modified");
     if (modified != nullptr) {
       patchModules(modified);
     }
@@ -80,19 +85,28 @@ void JSDeltaBundleClient::patch(const folly::dynamic& delta) {
 JSModulesUnbundle::Module JSDeltaBundleClient::getModule(uint32_t moduleId) const {
   auto search = modules_.find(moduleId);
   if (search != modules_.end()) {
-    return {folly::to<std::string>(search->first, ".js"), search->second};
+    const auto& code = search->second;
+    return {
+      folly::to<std::string>(search->first, ".js"),
+      "",
+      folly::make_unique<JSBigStringSlice>(code, 0, code->size()),
+    };
   }
 
   throw JSModulesUnbundle::ModuleNotFound(moduleId);
 }
 
 std::unique_ptr<const JSBigString> JSDeltaBundleClient::getStartupCode() const {
-  return folly::make_unique<JSBigStdString>(startupCode_);
+  if (!startupCode_) {
+    return folly::make_unique<JSBigStdString>("");
+  }
+  return folly::make_unique<JSBigStringSlice>(
+    startupCode_, 0, startupCode_->size());
 }
 
 void JSDeltaBundleClient::clear() {
   modules_.clear();
-  startupCode_.clear();
+  startupCode_ = nullptr;
 }
 
 } // namespace react
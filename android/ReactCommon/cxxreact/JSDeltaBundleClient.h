@@ -20,15 +20,22 @@ namespace react {
 class JSDeltaBundleClient {
 public:
   void patch(const folly::dynamic& delta);
+  // Moves the code out of the delta instead of copying it.
+  void patch(folly::dynamic&& delta);
   JSModulesUnbundle::Module getModule(uint32_t moduleId) const;
   std::unique_ptr<const JSBigString> getStartupCode() const;
   void clear();
 
 private:
-  std::unordered_map<uint32_t, std::string> modules_;
-  std::string startupCode_;
-
-  void patchModules(const folly::dynamic *delta);
+  // The code is never modified once patched in (patches replace it), so it
+  // is shared with the strings handed out by getModule() and
+  // getStartupCode() instead of being copied on every reload.
+  std::unordered_map<uint32_t, std::shared_ptr<const JSBigStdString>> modules_;
+  // Made of the pre and post sections moved out of the delta, only joined
+  // when it's first loaded.
+  std::shared_ptr<const JSBigSegmentedString> startupCode_;
+
+  void patchModules(folly::dynamic *delta);
 };
 
 class JSDeltaBundleClientRAMBundle : public JSModulesUnbundle {
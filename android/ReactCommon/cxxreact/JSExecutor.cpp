@@ -5,6 +5,8 @@
 
 #include "JSExecutor.h"
 
+#include "JSBigString.h"
+
 #include "RAMBundleRegistry.h"
 
 #include <folly/Conv.h>
@@ -12,6 +14,12 @@
 namespace facebook {
 namespace react {
 
+void JSExecutor::setGlobalVariableLazily(
+    std::string propName,
+    std::unique_ptr<const JSBigString> jsonValue) {
+  setGlobalVariable(std::move(propName), std::move(jsonValue));
+}
+
 std::string JSExecutor::getSyntheticBundlePath(
     uint32_t bundleId,
     const std::string& bundlePath) {
@@ -7,7 +7,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include <cxxreact/MethodCall.h>
 #include <cxxreact/NativeModule.h>
 #include <folly/dynamic.h>
 
@@ -35,8 +37,20 @@ class ExecutorDelegate {
 
   virtual void callNativeModules(
     JSExecutor& executor, folly::dynamic&& calls, bool isEndOfBatch) = 0;
+  // Same as above, for calls which the executor already parsed (e.g. from
+  // the binary format, see parseMethodCalls).
+  virtual void callNativeModules(
+    JSExecutor& executor, std::vector<MethodCall>&& calls, bool isEndOfBatch) = 0;
   virtual MethodCallResult callSerializableNativeHook(
     JSExecutor& executor, unsigned int moduleId, unsigned int methodId, folly::dynamic&& args) = 0;
+  // Same as above, for methods which take and return JS values as they are.
+  // Returns none if the method doesn't, so the executor falls back to
+  // callSerializableNativeHook.
+  virtual folly::Optional<jsi::Value> callJSINativeHook(
+      JSExecutor& executor, jsi::Runtime& runtime, unsigned int moduleId,
+      unsigned int methodId, const jsi::Value* args, size_t count) {
+    return folly::none;
+  }
 };
 
 using NativeExtensionsProvider = std::function<folly::dynamic(const std::string&)>;
@@ -49,6 +63,56 @@ public:
   virtual ~JSExecutorFactory() {}
 };
 
+// The arguments of a call from native code into JS, in a form which
+// executors can turn into JS values directly instead of building a
+// folly::dynamic first (e.g. bytes serialized by Java on Android). Can be
+// used from any thread.
+class JSArguments {
+ public:
+  virtual ~JSArguments() {}
+  // The array of arguments as a JS value.
+  virtual jsi::Value toJSValue(jsi::Runtime& runtime) const = 0;
+  // The array of arguments, for executors which don't use JSI.
+  virtual folly::dynamic toDynamic() const = 0;
+};
+
+// A call from native code into JS: either a method of a JS module, or a
+// callback (if moduleId is empty).
+struct JSCall {
+  std::string moduleId;
+  std::string methodId;
+  double callbackId;
+  folly::dynamic arguments;
+  // If set, the arguments instead of `arguments`.
+  std::shared_ptr<const JSArguments> encodedArguments;
+
+  static JSCall function(std::string moduleId, std::string methodId, folly::dynamic arguments) {
+    return JSCall{std::move(moduleId), std::move(methodId), 0, std::move(arguments), nullptr};
+  }
+
+  static JSCall function(
+      std::string moduleId, std::string methodId, std::shared_ptr<const JSArguments> arguments) {
+    return JSCall{std::move(moduleId), std::move(methodId), 0, nullptr, std::move(arguments)};
+  }
+
+  static JSCall callback(double callbackId, folly::dynamic arguments) {
+    return JSCall{"", "", callbackId, std::move(arguments), nullptr};
+  }
+
+  static JSCall callback(double callbackId, std::shared_ptr<const JSArguments> arguments) {
+    return JSCall{"", "", callbackId, nullptr, std::move(arguments)};
+  }
+
+  bool isCallback() const {
+    return moduleId.empty();
+  }
+
+  // The arguments as a folly::dynamic, however they're held.
+  folly::dynamic dynamicArguments() const {
+    return encodedArguments ? encodedArguments->toDynamic() : arguments;
+  }
+};
+
 class RN_EXPORT JSExecutor {
 public:
   /**
@@ -82,8 +146,24 @@ public:
    */
   virtual void invokeCallback(const double callbackId, const folly::dynamic& arguments) = 0;
 
+  /**
+   * Executes the calls in order, like callFunction and invokeCallback, but
+   * flushes the queue of native module calls and ends the batch only once,
+   * after the last call. Used to deliver calls which were queued from native
+   * code in a burst (e.g. events) with a single round trip.
+   */
+  virtual void callFunctions(std::vector<JSCall>&& calls) = 0;
+
   virtual void setGlobalVariable(std::string propName, std::unique_ptr<const JSBigString> jsonValue) = 0;
 
+  /**
+   * Like setGlobalVariable, but the JSON is only parsed when JS first reads
+   * the variable (if ever), so that large values (e.g. configs or manifests)
+   * don't delay running the bundle. Executors which can't defer parsing set
+   * the variable right away.
+   */
+  virtual void setGlobalVariableLazily(std::string propName, std::unique_ptr<const JSBigString> jsonValue);
+
   virtual void* getJavaScriptContext() {
     return nullptr;
   }
@@ -6,8 +6,11 @@
 #include "JSIndexedRAMBundle.h"
 
 #include <glog/logging.h>
-#include <fstream>
-#include <sstream>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <ios>
 #include <folly/Memory.h>
 
 namespace facebook {
@@ -19,101 +22,139 @@ std::function<std::unique_ptr<JSModulesUnbundle>(std::string)> JSIndexedRAMBundl
   };
 }
 
-JSIndexedRAMBundle::JSIndexedRAMBundle(const char *sourcePath) {
-  m_bundle = std::make_unique<std::ifstream>(sourcePath, std::ifstream::binary);
-  if (!m_bundle) {
-    throw std::ios_base::failure(
-      folly::to<std::string>("Bundle ", sourcePath,
-                             "cannot be opened: ", m_bundle->rdstate()));
-  }
+JSIndexedRAMBundle::JSIndexedRAMBundle(const char *sourcePath) :
+    m_bundle(JSBigFileString::fromPath(sourcePath)) {
   init();
+  m_startupProfile = folly::make_unique<RAMBundleStartupProfile>(
+    folly::to<std::string>(sourcePath, ".startup-profile"), m_size);
+  prefetchModules(m_startupProfile->getPreviousModuleIds());
 }
 
-JSIndexedRAMBundle::JSIndexedRAMBundle(std::unique_ptr<const JSBigString> script) {
-  // tmpStream is needed because m_bundle is std::istream type
-  // which has no member 'write'
-  std::unique_ptr<std::stringstream> tmpStream = std::make_unique<std::stringstream>();
-  tmpStream->write(script->c_str(), script->size());
-  m_bundle = std::move(tmpStream);
-  if (!m_bundle) {
-    throw std::ios_base::failure(
-      folly::to<std::string>("Bundle from string cannot be opened: ", m_bundle->rdstate()));
-  }
+JSIndexedRAMBundle::JSIndexedRAMBundle(std::unique_ptr<const JSBigString> script) :
+    m_bundle(std::move(script)) {
   init();
 }
 
 void JSIndexedRAMBundle::init() {
+  // Maps the whole file (for file-backed bundles); only the pages which are
+  // actually read are loaded.
+  m_data = m_bundle->c_str();
+  m_size = m_bundle->size();
+
   // read in magic header, number of entries, and length of the startup section
   uint32_t header[3];
   static_assert(
     sizeof(header) == 12,
     "header size must exactly match the input file format");
 
-  readBundle(reinterpret_cast<char *>(header), sizeof(header));
+  if (m_size < sizeof(header)) {
+    throw std::ios_base::failure("Unexpected end of RAM Bundle file");
+  }
+  std::memcpy(header, m_data, sizeof(header));
   const size_t numTableEntries = folly::Endian::little(header[1]);
   const size_t startupCodeSize = folly::Endian::little(header[2]);
 
-  // allocate memory for meta data and lookup table.
-  m_table = ModuleTable(numTableEntries);
-  m_baseOffset = sizeof(header) + m_table.byteLength();
-
-  // read the lookup table from the file
-  readBundle(
-    reinterpret_cast<char *>(m_table.data.get()), m_table.byteLength());
-
-  // read the startup code
-  m_startupCode = std::unique_ptr<JSBigBufferString>(new JSBigBufferString{startupCodeSize - 1});
+  if (numTableEntries > (m_size - sizeof(header)) / sizeof(ModuleData)) {
+    throw std::ios_base::failure("Unexpected end of RAM Bundle file");
+  }
+  m_table = m_data + sizeof(header);
+  m_numTableEntries = numTableEntries;
+  m_baseOffset = sizeof(header) + numTableEntries * sizeof(ModuleData);
 
-  readBundle(m_startupCode->data(), startupCodeSize - 1);
+  m_startupCode = getCode(m_baseOffset, startupCodeSize);
 }
 
 JSIndexedRAMBundle::Module JSIndexedRAMBundle::getModule(uint32_t moduleId) const {
+  ModuleData moduleData;
+  if (!getModuleData(moduleId, moduleData)) {
+    throw std::ios_base::failure(
+      folly::to<std::string>("Error loading module", moduleId, "from RAM Bundle"));
+  }
+
+  if (m_startupProfile) {
+    m_startupProfile->recordModule(moduleId);
+  }
+
   Module ret;
   ret.name = folly::to<std::string>(moduleId, ".js");
-  ret.code = getModuleCode(moduleId);
+  ret.source = getCode(moduleData.offset, moduleData.length);
   return ret;
 }
 
-std::unique_ptr<const JSBigString> JSIndexedRAMBundle::getStartupCode() {
-  CHECK(m_startupCode) << "startup code for a RAM Bundle can only be retrieved once";
-  return std::move(m_startupCode);
-}
+// Returns the offset (from the beginning of the bundle) and the length of the
+// code of a module, or `false` if the module has no code.
+bool JSIndexedRAMBundle::getModuleData(
+    uint32_t moduleId,
+    ModuleData& moduleData) const {
+  if (moduleId >= m_numTableEntries) {
+    return false;
+  }
 
-std::string JSIndexedRAMBundle::getModuleCode(const uint32_t id) const {
-  const auto moduleData = id < m_table.numEntries ? &m_table.data[id] : nullptr;
+  std::memcpy(
+    &moduleData, m_table + moduleId * sizeof(ModuleData), sizeof(ModuleData));
+  moduleData.offset = folly::Endian::little(moduleData.offset);
+  moduleData.length = folly::Endian::little(moduleData.length);
 
   // entries without associated code have offset = 0 and length = 0
-  const uint32_t length = moduleData ? folly::Endian::little(moduleData->length) : 0;
-  if (length == 0) {
-    throw std::ios_base::failure(
-      folly::to<std::string>("Error loading module", id, "from RAM Bundle"));
+  if (moduleData.length == 0 ||
+      moduleData.offset > UINT32_MAX - m_baseOffset) {
+    return false;
   }
-
-  std::string ret(length - 1, '\0');
-  readBundle(&ret.front(), length - 1, m_baseOffset + folly::Endian::little(moduleData->offset));
-  return ret;
+  moduleData.offset += m_baseOffset;
+  return true;
 }
 
-void JSIndexedRAMBundle::readBundle(char *buffer, const std::streamsize bytes) const {
-  if (!m_bundle->read(buffer, bytes)) {
-    if (m_bundle->rdstate() & std::ios::eofbit) {
-      throw std::ios_base::failure("Unexpected end of RAM Bundle file");
+void JSIndexedRAMBundle::prefetchModules(
+    const std::vector<uint32_t>& moduleIds) const {
+  const static uintptr_t pageSize = getpagesize();
+
+  // Adjacent modules usually share pages, so contiguous ranges are merged to
+  // save system calls.
+  std::vector<std::pair<uintptr_t, uintptr_t>> ranges;
+  for (const auto moduleId : moduleIds) {
+    ModuleData moduleData;
+    if (!getModuleData(moduleId, moduleData) ||
+        moduleData.offset > m_size ||
+        moduleData.length > m_size - moduleData.offset) {
+      continue;
     }
-    throw std::ios_base::failure(
-      folly::to<std::string>("Error reading RAM Bundle: ", m_bundle->rdstate()));
+    const auto begin = reinterpret_cast<uintptr_t>(m_data + moduleData.offset);
+    ranges.emplace_back(begin & ~(pageSize - 1), begin + moduleData.length);
+  }
+  std::sort(ranges.begin(), ranges.end());
+
+  for (size_t index = 0; index < ranges.size();) {
+    auto begin = ranges[index].first;
+    auto end = ranges[index].second;
+    for (index++; index < ranges.size() && ranges[index].first <= end; index++) {
+      end = std::max(end, ranges[index].second);
+    }
+    // The kernel reads the pages asynchronously; failures only mean that the
+    // pages are read later, on demand.
+    madvise(reinterpret_cast<void *>(begin), end - begin, MADV_WILLNEED);
   }
 }
 
-void JSIndexedRAMBundle::readBundle(
-    char *buffer,
-    const std::streamsize bytes,
-    const std::ifstream::pos_type position) const {
+std::unique_ptr<const JSBigString> JSIndexedRAMBundle::getStartupCode() {
+  CHECK(m_startupCode) << "startup code for a RAM Bundle can only be retrieved once";
+  return std::move(m_startupCode);
+}
 
-  if (!m_bundle->seekg(position)) {
-    throw std::ios_base::failure(
-      folly::to<std::string>("Error reading RAM Bundle: ", m_bundle->rdstate()));
+std::unique_ptr<const JSBigString> JSIndexedRAMBundle::getCode(
+    size_t offset,
+    size_t length) const {
+  if (length == 0 || offset > m_size || length > m_size - offset) {
+    throw std::ios_base::failure("Unexpected end of RAM Bundle file");
+  }
+
+  // The length includes the terminating \0 byte.
+  if (m_data[offset + length - 1] == '\0') {
+    return folly::make_unique<JSBigStringSlice>(m_bundle, offset, length - 1);
   }
-  readBundle(buffer, bytes);
+
+  auto code = folly::make_unique<JSBigBufferString>(length - 1);
+  std::memcpy(code->data(), m_data + offset, length - 1);
+  return std::move(code);
 }
 
 }  // namespace react
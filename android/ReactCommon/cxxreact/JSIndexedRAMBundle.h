@@ -5,11 +5,14 @@
 
 #pragma once
 
-#include <istream>
+#include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <cxxreact/JSBigString.h>
 #include <cxxreact/JSModulesUnbundle.h>
+#include <cxxreact/RAMBundleStartupProfile.h>
 
 #ifndef RN_EXPORT
 #define RN_EXPORT __attribute__((visibility("default")))
@@ -18,6 +21,12 @@
 namespace facebook {
 namespace react {
 
+// Reads modules from a bundle kept in memory (for bundle files, in a read-only
+// memory mapping), so loading a module needs neither a syscall nor a copy:
+// getModule() returns a `source` which refers into the bundle.
+// Bundle files also keep a RAMBundleStartupProfile next to them (at
+// `<bundle path>.startup-profile`), which is used to read the modules
+// required during startup ahead of time.
 class RN_EXPORT JSIndexedRAMBundle : public JSModulesUnbundle {
 public:
   static std::function<std::unique_ptr<JSModulesUnbundle>(std::string)> buildFactory();
@@ -30,6 +39,9 @@ public:
   std::unique_ptr<const JSBigString> getStartupCode();
   // Throws std::runtime_error on failure.
   Module getModule(uint32_t moduleId) const override;
+  // Asks the kernel to read the code of the modules ahead of time. Ids of
+  // modules which the bundle doesn't contain are ignored.
+  void prefetchModules(const std::vector<uint32_t>& moduleIds) const;
 
 private:
   struct ModuleData {
@@ -40,30 +52,25 @@ private:
     sizeof(ModuleData) == 8,
     "ModuleData must not have any padding and use sizes matching input files");
 
-  struct ModuleTable {
-    size_t numEntries;
-    std::unique_ptr<ModuleData[]> data;
-    ModuleTable() : numEntries(0) {};
-    ModuleTable(size_t entries) :
-      numEntries(entries),
-      data(std::unique_ptr<ModuleData[]>(new ModuleData[numEntries])) {};
-    size_t byteLength() const {
-      return numEntries * sizeof(ModuleData);
-    }
-  };
-
   void init();
-  std::string getModuleCode(const uint32_t id) const;
-  void readBundle(char *buffer, const std::streamsize bytes) const;
-  void readBundle(
-    char *buffer, const
-    std::streamsize bytes,
-    const std::istream::pos_type position) const;
+  bool getModuleData(uint32_t moduleId, ModuleData& moduleData) const;
+  // Returns a string which refers to `length` bytes at `offset` of the
+  // bundle, including the terminating \0 byte (copying them if the
+  // terminating byte is missing).
+  std::unique_ptr<const JSBigString> getCode(
+    size_t offset,
+    size_t length) const;
 
-  mutable std::unique_ptr<std::istream> m_bundle;
-  ModuleTable m_table;
+  std::shared_ptr<const JSBigString> m_bundle;
+  // Cached m_bundle->c_str() and m_bundle->size().
+  const char *m_data;
+  size_t m_size;
+  // Points into m_bundle, not necessarily aligned.
+  const char *m_table;
+  size_t m_numTableEntries;
   size_t m_baseOffset;
-  std::unique_ptr<JSBigBufferString> m_startupCode;
+  std::unique_ptr<const JSBigString> m_startupCode;
+  std::unique_ptr<RAMBundleStartupProfile> m_startupProfile;
 };
 
 }  // namespace react
@@ -6,9 +6,11 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <stdexcept>
 
+#include <cxxreact/JSBigString.h>
 #include <folly/Conv.h>
 
 namespace facebook {
@@ -32,6 +34,9 @@ public:
   struct Module {
     std::string name;
     std::string code;
+    // If set, the code of the module (and `code` is empty). Unbundles which
+    // keep their modules in memory use it to avoid copying them.
+    std::unique_ptr<const JSBigString> source{};
   };
   JSModulesUnbundle() {}
   virtual ~JSModulesUnbundle() {}
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <mutex>
@@ -12,10 +13,32 @@
 namespace facebook {
 namespace react {
 
+// The lanes of work on a MessageQueueThread, from the one which runs first.
+enum class MessageQueuePriority {
+  // Work which the user is waiting for (e.g. input events).
+  High,
+  Normal,
+  // Work which only runs when there is nothing else to do (e.g. analytics).
+  Idle,
+};
+
+using MessageQueueDeadline = std::chrono::steady_clock::time_point;
+
 class MessageQueueThread {
  public:
   virtual ~MessageQueueThread() {}
   virtual void runOnQueue(std::function<void()>&&) = 0;
+  // Queues work in a lane. Once its deadline passed, its lane runs
+  // before all others until the work ran. Work in the same lane always runs
+  // in order. Queues which don't support priorities run everything in order.
+  virtual void runOnQueueWithPriority(
+      std::function<void()>&& runnable,
+      MessageQueuePriority priority,
+      MessageQueueDeadline deadline = MessageQueueDeadline::max()) {
+    (void)priority;
+    (void)deadline;
+    runOnQueue(std::move(runnable));
+  }
   // runOnQueueSync and quitSynchronous are dangerous.  They should only be
   // used for initialization and cleanup.
   virtual void runOnQueueSync(std::function<void()>&&) = 0;
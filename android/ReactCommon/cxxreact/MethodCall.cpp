@@ -5,7 +5,9 @@
 
 #include "MethodCall.h"
 
+#include <folly/Bits.h>
 #include <folly/json.h>
+#include <cstring>
 #include <stdexcept>
 
 namespace facebook {
@@ -76,4 +78,142 @@ std::vector<MethodCall> parseMethodCalls(folly::dynamic&& jsonData) {
   return methodCalls;
 }
 
+namespace {
+
+enum class ValueTag : uint8_t {
+  Null = 0,
+  False = 1,
+  True = 2,
+  Double = 3,
+  Int32 = 4,
+  String = 5,
+  Array = 6,
+  Object = 7,
+};
+
+// Deeper values are most likely corrupted data; this keeps parsing them from
+// exhausting the stack.
+static const size_t kMaxValueDepth = 256;
+
+class MethodCallReader {
+public:
+  MethodCallReader(const uint8_t* data, size_t size)
+    : m_data(data)
+    , m_end(data + size) {}
+
+  bool atEnd() const {
+    return m_data == m_end;
+  }
+
+  template <typename T>
+  T read() {
+    T value;
+    readBytes(&value, sizeof(value));
+    return folly::Endian::little(value);
+  }
+
+  std::string readString() {
+    const auto size = read<uint32_t>();
+    ensureAvailable(size);
+    std::string string(reinterpret_cast<const char*>(m_data), size);
+    m_data += size;
+    return string;
+  }
+
+  folly::dynamic readValue(size_t depth = 0) {
+    if (depth > kMaxValueDepth) {
+      throw std::invalid_argument(
+        folly::to<std::string>(errorPrefix, "values are nested too deeply"));
+    }
+
+    const auto tag = static_cast<ValueTag>(read<uint8_t>());
+    switch (tag) {
+      case ValueTag::Null:
+        return nullptr;
+      case ValueTag::False:
+        return false;
+      case ValueTag::True:
+        return true;
+      case ValueTag::Double: {
+        uint64_t bits = read<uint64_t>();
+        double value;
+        static_assert(sizeof(value) == sizeof(bits), "double must be 64-bit");
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+      }
+      case ValueTag::Int32:
+        return static_cast<double>(read<int32_t>());
+      case ValueTag::String:
+        return readString();
+      case ValueTag::Array: {
+        const auto count = read<uint32_t>();
+        // Every element takes at least one byte.
+        ensureAvailable(count);
+        folly::dynamic array = folly::dynamic::array();
+        for (uint32_t i = 0; i < count; i++) {
+          array.push_back(readValue(depth + 1));
+        }
+        return array;
+      }
+      case ValueTag::Object: {
+        const auto count = read<uint32_t>();
+        folly::dynamic object = folly::dynamic::object();
+        for (uint32_t i = 0; i < count; i++) {
+          auto name = readString();
+          object.insert(std::move(name), readValue(depth + 1));
+        }
+        return object;
+      }
+    }
+
+    throw std::invalid_argument(
+      folly::to<std::string>(errorPrefix, "unknown value tag ", (int)tag));
+  }
+
+private:
+  void ensureAvailable(size_t size) const {
+    if (size > static_cast<size_t>(m_end - m_data)) {
+      throw std::invalid_argument(
+        folly::to<std::string>(errorPrefix, "unexpected end of buffer"));
+    }
+  }
+
+  void readBytes(void* destination, size_t size) {
+    ensureAvailable(size);
+    memcpy(destination, m_data, size);
+    m_data += size;
+  }
+
+  const uint8_t* m_data;
+  const uint8_t* const m_end;
+};
+
+}
+
+std::vector<MethodCall> parseMethodCalls(const uint8_t* data, size_t size) {
+  MethodCallReader header(data, size);
+  const auto length = header.read<uint32_t>();
+  if (length > size - sizeof(uint32_t)) {
+    throw std::invalid_argument(
+      folly::to<std::string>(errorPrefix, "length ", length, " exceeds buffer size ", size));
+  }
+
+  MethodCallReader reader(data + sizeof(uint32_t), length);
+  std::vector<MethodCall> methodCalls;
+  while (!reader.atEnd()) {
+    const auto moduleId = reader.read<uint32_t>();
+    const auto methodId = reader.read<uint32_t>();
+    const auto callId = reader.read<int32_t>();
+    auto arguments = reader.readValue();
+    if (!arguments.isArray()) {
+      throw std::invalid_argument(
+        folly::to<std::string>(errorPrefix, "method arguments isn't array but ", arguments.typeName()));
+    }
+
+    methodCalls.emplace_back(moduleId, methodId, std::move(arguments), callId);
+  }
+
+  return methodCalls;
+}
+
 }}
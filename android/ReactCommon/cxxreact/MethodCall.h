@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -30,4 +31,25 @@ struct MethodCall {
 /// \throws std::invalid_argument
 std::vector<MethodCall> parseMethodCalls(folly::dynamic&& calls);
 
+/// Parses method calls which JS wrote into an ArrayBuffer instead of building
+/// the `[moduleIds, methodIds, params, callId]` queue, which saves creating a
+/// JS value for every argument and converting it one property at a time.
+///
+/// The buffer starts with the uint32 byte length of the calls which follow
+/// it (so JS can reuse a larger buffer). Each call is:
+///   uint32 moduleId, uint32 methodId, int32 callId (-1 if none),
+///   the arguments (an array value).
+/// A value is a one-byte tag followed by its payload:
+///   0 null, 1 false, 2 true,
+///   3 number: float64,
+///   4 number: int32 (converted to double, like all numbers from JS),
+///   5 string: uint32 byte length, UTF-8 bytes,
+///   6 array: uint32 element count, values,
+///   7 object: uint32 property count, properties (a string payload for the
+///     name without a tag, and a value) in order.
+/// All numbers are little-endian.
+///
+/// \throws std::invalid_argument
+std::vector<MethodCall> parseMethodCalls(const uint8_t* data, size_t size);
+
 } }
@@ -78,8 +78,8 @@ std::vector<std::string> ModuleRegistry::moduleNames() {
   return names;
 }
 
-folly::Optional<ModuleConfig> ModuleRegistry::getConfig(const std::string& name) {
-  SystraceSection s("ModuleRegistry::getConfig", "module", name);
+folly::Optional<ModuleConfig> ModuleRegistry::getConfig(const std::string& name, bool allowLazyConstants) {
+  TraceSection<TraceCategory::NativeModules> s("ModuleRegistry::getConfig", "module", name);
 
   // Initialize modulesByName_
   if (modulesByName_.empty() && !modules_.empty()) {
@@ -107,13 +107,16 @@ folly::Optional<ModuleConfig> ModuleRegistry::getConfig(const std::string& name)
   // string name, object constants, array methodNames (methodId is index), [array promiseMethodIds], [array syncMethodIds]
   folly::dynamic config = folly::dynamic::array(name);
 
-  {
-    SystraceSection s_("ModuleRegistry::getConstants", "module", name);
+  const bool hasLazyConstants = allowLazyConstants && module->hasLazyConstants();
+  if (hasLazyConstants) {
+    config.push_back(folly::dynamic::object());
+  } else {
+    TraceSection<TraceCategory::NativeModules> s_("ModuleRegistry::getConstants", "module", name);
     config.push_back(module->getConstants());
   }
 
   {
-    SystraceSection s_("ModuleRegistry::getMethods", "module", name);
+    TraceSection<TraceCategory::NativeModules> s_("ModuleRegistry::getMethods", "module", name);
     std::vector<MethodDescriptor> methods = module->getMethods();
 
     folly::dynamic methodNames = folly::dynamic::array;
@@ -141,14 +144,23 @@ folly::Optional<ModuleConfig> ModuleRegistry::getConfig(const std::string& name)
     }
   }
 
-  if (config.size() == 2 && config[1].empty()) {
+  if (config.size() == 2 && config[1].empty() && !hasLazyConstants) {
     // no constants or methods
     return folly::none;
   } else {
-    return ModuleConfig{index, config};
+    return ModuleConfig{index, config, hasLazyConstants};
   }
 }
 
+folly::dynamic ModuleRegistry::getConstants(unsigned int moduleId) {
+  if (moduleId >= modules_.size()) {
+    throw std::runtime_error(
+      folly::to<std::string>("moduleId ", moduleId, " out of range [0..", modules_.size(), ")"));
+  }
+  SystraceSection s_("ModuleRegistry::getConstants");
+  return modules_[moduleId]->getConstants();
+}
+
 void ModuleRegistry::callNativeMethod(unsigned int moduleId, unsigned int methodId, folly::dynamic&& params, int callId) {
   if (moduleId >= modules_.size()) {
     throw std::runtime_error(
@@ -165,4 +177,24 @@ MethodCallResult ModuleRegistry::callSerializableNativeHook(unsigned int moduleI
   return modules_[moduleId]->callSerializableNativeHook(methodId, std::move(params));
 }
 
+folly::Optional<jsi::Value> ModuleRegistry::callJSINativeHook(
+    jsi::Runtime& runtime, unsigned int moduleId, unsigned int methodId,
+    const jsi::Value* args, size_t count) {
+  if (moduleId >= modules_.size()) {
+    throw std::runtime_error(
+      folly::to<std::string>("moduleId ", moduleId, "out of range [0..", modules_.size(), ")"));
+  }
+  return modules_[moduleId]->callJSINativeHook(runtime, methodId, args, count);
+}
+
+std::unordered_map<std::string, NativeModuleQueueStats> ModuleRegistry::getQueueStats() {
+  std::unordered_map<std::string, NativeModuleQueueStats> stats;
+  for (auto& module : modules_) {
+    if (auto moduleStats = module->getQueueStats()) {
+      stats.emplace(module->getName(), *moduleStats);
+    }
+  }
+  return stats;
+}
+
 }}
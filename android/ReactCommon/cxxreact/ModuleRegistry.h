@@ -6,6 +6,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -25,6 +26,9 @@ class NativeModule;
 struct ModuleConfig {
   size_t index;
   folly::dynamic config;
+  // If true, the constants in config are empty, and are only available from
+  // ModuleRegistry::getConstants().
+  bool hasLazyConstants = false;
 };
 
 class RN_EXPORT ModuleRegistry {
@@ -43,10 +47,20 @@ class RN_EXPORT ModuleRegistry {
 
   std::vector<std::string> moduleNames();
 
-  folly::Optional<ModuleConfig> getConfig(const std::string& name);
+  // If allowLazyConstants is true, the caller gets the constants of modules
+  // which have lazy constants from getConstants() when they are needed.
+  folly::Optional<ModuleConfig> getConfig(const std::string& name, bool allowLazyConstants = false);
+  folly::dynamic getConstants(unsigned int moduleId);
 
   void callNativeMethod(unsigned int moduleId, unsigned int methodId, folly::dynamic&& params, int callId);
   MethodCallResult callSerializableNativeHook(unsigned int moduleId, unsigned int methodId, folly::dynamic&& args);
+  folly::Optional<jsi::Value> callJSINativeHook(
+      jsi::Runtime& runtime, unsigned int moduleId, unsigned int methodId,
+      const jsi::Value* args, size_t count);
+
+  // How the calls of the modules which keep stats queued up, by module name
+  // (see NativeModule::getQueueStats).
+  std::unordered_map<std::string, NativeModuleQueueStats> getQueueStats();
 
  private:
   // This is always populated
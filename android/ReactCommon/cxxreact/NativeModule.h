@@ -5,11 +5,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include <folly/Optional.h>
 #include <folly/dynamic.h>
+#include <jsi/jsi.h>
 
 namespace facebook {
 namespace react {
@@ -26,14 +28,41 @@ struct MethodDescriptor {
 
   using MethodCallResult = folly::Optional<folly::dynamic>;
 
+// How a module's asynchronous calls queued up (see NativeModule::getQueueStats).
+struct NativeModuleQueueStats {
+  // Calls which are queued or running.
+  size_t pendingCalls = 0;
+  // The most calls which were pending at once.
+  size_t maxPendingCalls = 0;
+  // All calls so far, including the ones which ran inline.
+  uint64_t totalCalls = 0;
+};
+
 class NativeModule {
  public:
   virtual ~NativeModule() {}
   virtual std::string getName() = 0;
   virtual std::vector<MethodDescriptor> getMethods() = 0;
   virtual folly::dynamic getConstants() = 0;
+  // If true, executors which can (see ModuleRegistry::getConfig) only call
+  // getConstants() once JS reads a constant, instead of when the module is
+  // first required. Meant for modules with large constants.
+  virtual bool hasLazyConstants() {
+    return false;
+  }
   virtual void invoke(unsigned int reactMethodId, folly::dynamic&& params, int callId) = 0;
   virtual MethodCallResult callSerializableNativeHook(unsigned int reactMethodId, folly::dynamic&& args) = 0;
+  // Calls a sync method with the JS arguments as they are. Returns none if the
+  // method only takes folly::dynamic, see callSerializableNativeHook.
+  virtual folly::Optional<jsi::Value> callJSINativeHook(
+      jsi::Runtime& runtime, unsigned int reactMethodId, const jsi::Value* args, size_t count) {
+    return folly::none;
+  }
+  // Modules which run calls on queues they're in charge of report how these
+  // calls queued up.
+  virtual folly::Optional<NativeModuleQueueStats> getQueueStats() {
+    return folly::none;
+  }
 };
 
 }
@@ -43,7 +43,12 @@ public:
   }
 
   void callNativeModules(
-      __unused JSExecutor& executor, folly::dynamic&& calls, bool isEndOfBatch) override {
+      JSExecutor& executor, folly::dynamic&& calls, bool isEndOfBatch) override {
+    callNativeModules(executor, parseMethodCalls(std::move(calls)), isEndOfBatch);
+  }
+
+  void callNativeModules(
+      __unused JSExecutor& executor, std::vector<MethodCall>&& calls, bool isEndOfBatch) override {
 
     CHECK(m_registry || calls.empty()) <<
       "native module calls cannot be completed with no native modules";
@@ -52,7 +57,7 @@ public:
     // An exception anywhere in here stops processing of the batch.  This
     // was the behavior of the Android bridge, and since exception handling
     // terminates the whole bridge, there's not much point in continuing.
-    for (auto& call : parseMethodCalls(std::move(calls))) {
+    for (auto& call : calls) {
       m_registry->callNativeMethod(call.moduleId, call.methodId, std::move(call.arguments), call.callId);
     }
     if (isEndOfBatch) {
@@ -67,12 +72,26 @@ public:
     }
   }
 
+  // The JS calls which were delivered together account for one end of batch
+  // only, so the rest are accounted for here.
+  void didCoalesceJSCalls(size_t count) {
+    for (size_t i = 1; i < count; i++) {
+      m_callback->decrementPendingJSCalls();
+    }
+  }
+
   MethodCallResult callSerializableNativeHook(
       __unused JSExecutor& executor, unsigned int moduleId, unsigned int methodId,
       folly::dynamic&& args) override {
     return m_registry->callSerializableNativeHook(moduleId, methodId, std::move(args));
   }
 
+  folly::Optional<jsi::Value> callJSINativeHook(
+      __unused JSExecutor& executor, jsi::Runtime& runtime, unsigned int moduleId,
+      unsigned int methodId, const jsi::Value* args, size_t count) override {
+    return m_registry->callJSINativeHook(runtime, moduleId, methodId, args, count);
+  }
+
 private:
 
   // These methods are always invoked from an Executor.  The NativeToJsBridge
@@ -144,7 +163,13 @@ void NativeToJsBridge::loadApplicationSync(
 void NativeToJsBridge::callFunction(
     std::string&& module,
     std::string&& method,
-    folly::dynamic&& arguments) {
+    folly::dynamic&& arguments,
+    MessageQueuePriority priority) {
+  if (m_isCallCoalescingEnabled && priority == MessageQueuePriority::Normal) {
+    coalesceCall(JSCall::function(std::move(module), std::move(method), std::move(arguments)));
+    return;
+  }
+
   int systraceCookie = -1;
   #ifdef WITH_FBSYSTRACE
   systraceCookie = m_systraceCookie++;
@@ -174,10 +199,18 @@ void NativeToJsBridge::callFunction(
       // destruct until after it's been unregistered (which we check above) and
       // that will happen on this thread
       executor->callFunction(module, method, arguments);
-    });
+    }, priority);
 }
 
-void NativeToJsBridge::invokeCallback(double callbackId, folly::dynamic&& arguments) {
+void NativeToJsBridge::invokeCallback(
+    double callbackId,
+    folly::dynamic&& arguments,
+    MessageQueuePriority priority) {
+  if (m_isCallCoalescingEnabled && priority == MessageQueuePriority::Normal) {
+    coalesceCall(JSCall::callback(callbackId, std::move(arguments)));
+    return;
+  }
+
   int systraceCookie = -1;
   #ifdef WITH_FBSYSTRACE
   systraceCookie = m_systraceCookie++;
@@ -203,7 +236,86 @@ void NativeToJsBridge::invokeCallback(double callbackId, folly::dynamic&& argume
       (void)(systraceCookie);
       #endif
       executor->invokeCallback(callbackId, arguments);
-    });
+    }, priority);
+}
+
+void NativeToJsBridge::callFunction(
+    std::string&& module,
+    std::string&& method,
+    std::shared_ptr<const JSArguments> arguments,
+    MessageQueuePriority priority) {
+  runEncodedCall(
+    JSCall::function(std::move(module), std::move(method), std::move(arguments)),
+    priority);
+}
+
+void NativeToJsBridge::invokeCallback(
+    double callbackId,
+    std::shared_ptr<const JSArguments> arguments,
+    MessageQueuePriority priority) {
+  runEncodedCall(JSCall::callback(callbackId, std::move(arguments)), priority);
+}
+
+void NativeToJsBridge::runEncodedCall(JSCall&& call, MessageQueuePriority priority) {
+  if (m_isCallCoalescingEnabled && priority == MessageQueuePriority::Normal) {
+    coalesceCall(std::move(call));
+    return;
+  }
+
+  runOnExecutorQueue([this, call = std::move(call)] (JSExecutor* executor) mutable {
+      if (m_applicationScriptHasFailure) {
+        LOG(ERROR) << "Attempting to call JS on a bad application bundle";
+        throw std::runtime_error("Attempting to call JS on a bad application bundle.");
+      }
+      SystraceSection s("NativeToJsBridge::runEncodedCall");
+      std::vector<JSCall> calls;
+      calls.push_back(std::move(call));
+      executor->callFunctions(std::move(calls));
+    }, priority);
+}
+
+void NativeToJsBridge::setCallCoalescingEnabled(bool enabled) {
+  m_isCallCoalescingEnabled = enabled;
+}
+
+void NativeToJsBridge::coalesceCall(JSCall&& call) {
+  if (*m_destroyed) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_coalescedCallsMutex);
+  if (m_coalescedCalls) {
+    m_coalescedCalls->push_back(std::move(call));
+    return;
+  }
+
+  auto calls = std::make_shared<std::vector<JSCall>>();
+  calls->push_back(std::move(call));
+  m_coalescedCalls = calls;
+  postToExecutorQueue([this, calls=std::move(calls)] (JSExecutor* executor) {
+    runCoalescedCalls(executor, calls);
+  });
+}
+
+void NativeToJsBridge::runCoalescedCalls(
+    JSExecutor* executor,
+    const std::shared_ptr<std::vector<JSCall>>& calls) {
+  {
+    // Later calls go into a new task from now on.
+    std::lock_guard<std::mutex> lock(m_coalescedCallsMutex);
+    if (m_coalescedCalls == calls) {
+      m_coalescedCalls = nullptr;
+    }
+  }
+
+  if (m_applicationScriptHasFailure) {
+    LOG(ERROR) << "Attempting to call JS functions on a bad application bundle";
+    throw std::runtime_error("Attempting to call JS functions on a bad application bundle.");
+  }
+
+  SystraceSection s("NativeToJsBridge::runCoalescedCalls");
+  m_delegate->didCoalesceJSCalls(calls->size());
+  executor->callFunctions(std::move(*calls));
 }
 
 void NativeToJsBridge::registerBundle(uint32_t bundleId, const std::string& bundlePath) {
@@ -220,6 +332,14 @@ void NativeToJsBridge::setGlobalVariable(std::string propName,
     });
 }
 
+void NativeToJsBridge::setGlobalVariableLazily(std::string propName,
+                                               std::unique_ptr<const JSBigString> jsonValue) {
+  runOnExecutorQueue([propName=std::move(propName), jsonValue=folly::makeMoveWrapper(std::move(jsonValue))]
+    (JSExecutor* executor) mutable {
+      executor->setGlobalVariableLazily(propName, jsonValue.move());
+    });
+}
+
 void* NativeToJsBridge::getJavaScriptContext() {
   // TODO(cjhopman): this seems unsafe unless we require that it is only called on the main js queue.
   return m_executor->getJavaScriptContext();
@@ -251,13 +371,27 @@ void NativeToJsBridge::destroy() {
   });
 }
 
-void NativeToJsBridge::runOnExecutorQueue(std::function<void(JSExecutor*)> task) {
+void NativeToJsBridge::runOnExecutorQueue(
+    std::function<void(JSExecutor*)> task,
+    MessageQueuePriority priority,
+    MessageQueueDeadline deadline) {
   if (*m_destroyed) {
     return;
   }
 
+  // Coalescing calls queued after this task into an earlier one would run
+  // them before it.
+  std::lock_guard<std::mutex> lock(m_coalescedCallsMutex);
+  m_coalescedCalls = nullptr;
+  postToExecutorQueue(std::move(task), priority, deadline);
+}
+
+void NativeToJsBridge::postToExecutorQueue(
+    std::function<void(JSExecutor*)> task,
+    MessageQueuePriority priority,
+    MessageQueueDeadline deadline) {
   std::shared_ptr<bool> isDestroyed = m_destroyed;
-  m_executorMessageQueueThread->runOnQueue([this, isDestroyed, task=std::move(task)] {
+  m_executorMessageQueueThread->runOnQueueWithPriority([this, isDestroyed, task=std::move(task)] {
     if (*isDestroyed) {
       return;
     }
@@ -267,7 +401,7 @@ void NativeToJsBridge::runOnExecutorQueue(std::function<void(JSExecutor*)> task)
     // 2. the executor is unregistered on this queue
     // 3. we just confirmed that the executor hasn't been unregistered above
     task(m_executor.get());
-  });
+  }, priority, deadline);
 }
 
 } }
@@ -8,9 +8,11 @@
 #include <atomic>
 #include <functional>
 #include <map>
+#include <mutex>
 #include <vector>
 
 #include <cxxreact/JSExecutor.h>
+#include <cxxreact/MessageQueueThread.h>
 
 namespace folly {
 struct dynamic;
@@ -21,7 +23,6 @@ namespace react {
 
 struct InstanceCallback;
 class JsToNativeBridge;
-class MessageQueueThread;
 class ModuleRegistry;
 class RAMBundleRegistry;
 
@@ -48,14 +49,48 @@ public:
 
   /**
    * Executes a function with the module ID and method ID and any additional
-   * arguments in JS.
+   * arguments in JS. Calls with a higher priority (e.g. for user input) run
+   * before queued calls with a lower priority.
    */
-  void callFunction(std::string&& module, std::string&& method, folly::dynamic&& args);
+  void callFunction(
+    std::string&& module,
+    std::string&& method,
+    folly::dynamic&& args,
+    MessageQueuePriority priority = MessageQueuePriority::Normal);
 
   /**
    * Invokes a callback with the cbID, and optional additional arguments in JS.
    */
-  void invokeCallback(double callbackId, folly::dynamic&& args);
+  void invokeCallback(
+    double callbackId,
+    folly::dynamic&& args,
+    MessageQueuePriority priority = MessageQueuePriority::Normal);
+
+  /**
+   * Same as callFunction() and invokeCallback() above, for arguments which
+   * the executor turns into JS values itself (see JSArguments). The call is
+   * delivered through JSExecutor::callFunctions.
+   */
+  void callFunction(
+    std::string&& module,
+    std::string&& method,
+    std::shared_ptr<const JSArguments> args,
+    MessageQueuePriority priority = MessageQueuePriority::Normal);
+  void invokeCallback(
+    double callbackId,
+    std::shared_ptr<const JSArguments> args,
+    MessageQueuePriority priority = MessageQueuePriority::Normal);
+
+  /**
+   * If enabled, calls from callFunction() and invokeCallback() which are
+   * queued before the JS thread gets to the first of them are coalesced (if
+   * they have the normal priority), and
+   * delivered to JS with a single flush and batch of native module calls
+   * (see JSExecutor::callFunctions). This saves a round trip per call for
+   * sources which emit many events in a burst. Calls are never reordered
+   * with respect to each other or to other work queued on the JS thread.
+   */
+  void setCallCoalescingEnabled(bool enabled);
 
   /**
    * Starts the JS application.  If bundleRegistry is non-null, then it is
@@ -73,6 +108,8 @@ public:
 
   void registerBundle(uint32_t bundleId, const std::string& bundlePath);
   void setGlobalVariable(std::string propName, std::unique_ptr<const JSBigString> jsonValue);
+  // See JSExecutor::setGlobalVariableLazily.
+  void setGlobalVariableLazily(std::string propName, std::unique_ptr<const JSBigString> jsonValue);
   void* getJavaScriptContext();
   bool isInspectable();
   bool isBatchActive();
@@ -84,9 +121,20 @@ public:
    */
   void destroy();
 
-  void runOnExecutorQueue(std::function<void(JSExecutor*)> task);
+  void runOnExecutorQueue(
+    std::function<void(JSExecutor*)> task,
+    MessageQueuePriority priority = MessageQueuePriority::Normal,
+    MessageQueueDeadline deadline = MessageQueueDeadline::max());
 
 private:
+  void coalesceCall(JSCall&& call);
+  void runEncodedCall(JSCall&& call, MessageQueuePriority priority);
+  void runCoalescedCalls(JSExecutor* executor, const std::shared_ptr<std::vector<JSCall>>& calls);
+  void postToExecutorQueue(
+    std::function<void(JSExecutor*)> task,
+    MessageQueuePriority priority = MessageQueuePriority::Normal,
+    MessageQueueDeadline deadline = MessageQueueDeadline::max());
+
   // This is used to avoid a race condition where a proxyCallback gets queued
   // after ~NativeToJsBridge(), on the same thread. In that case, the callback
   // will try to run the task on m_callback which will have been destroyed
@@ -106,6 +154,12 @@ private:
   // likely fail as well, so this flag can help prevent them.
   bool m_applicationScriptHasFailure = false;
 
+  std::atomic_bool m_isCallCoalescingEnabled{false};
+  std::mutex m_coalescedCallsMutex;
+  // The calls which were coalesced into the last task queued on the JS
+  // thread, as long as it hasn't started and nothing else was queued after it.
+  std::shared_ptr<std::vector<JSCall>> m_coalescedCalls;
+
   #ifdef WITH_FBSYSTRACE
   std::atomic_uint_least32_t m_systraceCookie = ATOMIC_VAR_INIT();
   #endif
@@ -0,0 +1,67 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "PriorityTaskQueue.h"
+
+namespace facebook {
+namespace react {
+
+void PriorityTaskQueue::push(
+    std::function<void()>&& task,
+    MessageQueuePriority priority,
+    MessageQueueDeadline deadline) {
+  const auto lane = static_cast<size_t>(priority);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto sequence = m_nextSequence++;
+  m_lanes[lane].emplace(sequence, std::move(task));
+  m_size++;
+  if (deadline != MessageQueueDeadline::max()) {
+    m_deadlines.push(Deadline{deadline, lane, sequence});
+  }
+}
+
+std::function<void()> PriorityTaskQueue::pop() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (!m_deadlines.empty()) {
+    const auto now = std::chrono::steady_clock::now();
+    while (!m_deadlines.empty()) {
+      const auto& deadline = m_deadlines.top();
+      auto& lane = m_lanes[deadline.lane];
+      if (lane.find(deadline.sequence) == lane.end()) {
+        m_deadlines.pop();
+        continue;
+      }
+      if (deadline.time <= now) {
+        // Running the tasks before the late one first keeps the lane in order.
+        return popFront(lane);
+      }
+      break;
+    }
+  }
+
+  for (auto& lane : m_lanes) {
+    if (!lane.empty()) {
+      return popFront(lane);
+    }
+  }
+  return {};
+}
+
+size_t PriorityTaskQueue::size() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_size;
+}
+
+std::function<void()> PriorityTaskQueue::popFront(Lane& lane) {
+  auto front = lane.begin();
+  auto task = std::move(front->second);
+  lane.erase(front);
+  m_size--;
+  return task;
+}
+
+} // namespace react
+} // namespace facebook
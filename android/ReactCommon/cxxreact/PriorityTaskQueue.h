@@ -0,0 +1,69 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+#include <cxxreact/MessageQueueThread.h>
+
+#ifndef RN_EXPORT
+#define RN_EXPORT __attribute__((visibility("default")))
+#endif
+
+namespace facebook {
+namespace react {
+
+// The tasks of a MessageQueueThread which supports priorities (see
+// MessageQueueThread::runOnQueueWithPriority). Platform queues which can
+// only run tasks in order post one runnable per push() which runs the task
+// returned by pop(), so the tasks run in order of priority instead.
+// Can be used from any thread.
+class RN_EXPORT PriorityTaskQueue {
+public:
+  void push(
+    std::function<void()>&& task,
+    MessageQueuePriority priority,
+    MessageQueueDeadline deadline = MessageQueueDeadline::max());
+
+  // Removes and returns the task to run next, or an empty function if there
+  // is none.
+  std::function<void()> pop();
+
+  size_t size() const;
+
+private:
+  struct Deadline {
+    MessageQueueDeadline time;
+    size_t lane;
+    uint64_t sequence;
+
+    bool operator>(const Deadline& other) const {
+      return time > other.time;
+    }
+  };
+
+  using Lane = std::map<uint64_t, std::function<void()>>;
+
+  std::function<void()> popFront(Lane& lane);
+
+  mutable std::mutex m_mutex;
+  uint64_t m_nextSequence{0};
+  size_t m_size{0};
+  std::array<Lane, 3> m_lanes;
+  // The deadlines of the tasks which have one, including tasks which already
+  // ran (which are skipped when they get to the top).
+  std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>>
+    m_deadlines;
+};
+
+} // namespace react
+} // namespace facebook
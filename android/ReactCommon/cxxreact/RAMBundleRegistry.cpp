@@ -29,34 +29,36 @@ RAMBundleRegistry::RAMBundleRegistry(
     std::unique_ptr<JSModulesUnbundle> mainBundle,
     std::function<std::unique_ptr<JSModulesUnbundle>(std::string)> factory):
       m_factory(std::move(factory)) {
-  m_bundles.emplace(MAIN_BUNDLE_ID, std::move(mainBundle));
+  std::promise<std::shared_ptr<JSModulesUnbundle>> promise;
+  promise.set_value(std::move(mainBundle));
+  m_bundles.emplace(MAIN_BUNDLE_ID, promise.get_future().share());
 }
 
 void RAMBundleRegistry::registerBundle(
     uint32_t bundleId, std::string bundlePath) {
-  m_bundlePaths.emplace(bundleId, std::move(bundlePath));
+  if (!m_factory) {
+    // getModule() reports the error if the bundle is actually needed.
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_bundles.find(bundleId) != m_bundles.end()) {
+    return;
+  }
+
+  auto factory = m_factory;
+  // An exception thrown by the factory is rethrown by getModule().
+  // The destructor of the registry waits for bundles which are still being
+  // opened.
+  m_bundles.emplace(bundleId, std::async(
+    std::launch::async,
+    [factory, bundlePath = std::move(bundlePath)]() {
+      return std::shared_ptr<JSModulesUnbundle>(factory(bundlePath));
+    }).share());
 }
 
 JSModulesUnbundle::Module RAMBundleRegistry::getModule(
     uint32_t bundleId, uint32_t moduleId) {
-  if (m_bundles.find(bundleId) == m_bundles.end()) {
-    if (!m_factory) {
-      throw std::runtime_error(
-        "You need to register factory function in order to "
-        "support multiple RAM bundles."
-      );
-    }
-
-    auto bundlePath = m_bundlePaths.find(bundleId);
-    if (bundlePath == m_bundlePaths.end()) {
-      throw std::runtime_error(
-        "In order to fetch RAM bundle from the registry, its file "
-        "path needs to be registered first."
-      );
-    }
-    m_bundles.emplace(bundleId, m_factory(bundlePath->second));
-  }
-
   auto module = getBundle(bundleId)->getModule(moduleId);
   if (bundleId == MAIN_BUNDLE_ID) {
     return module;
@@ -64,11 +66,33 @@ JSModulesUnbundle::Module RAMBundleRegistry::getModule(
   return {
     folly::to<std::string>("seg-", bundleId, '_', std::move(module.name)),
     std::move(module.code),
+    std::move(module.source),
   };
 }
 
-JSModulesUnbundle* RAMBundleRegistry::getBundle(uint32_t bundleId) const {
-  return m_bundles.at(bundleId).get();
+std::shared_ptr<JSModulesUnbundle> RAMBundleRegistry::getBundle(
+    uint32_t bundleId) {
+  BundleFuture bundle;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_bundles.find(bundleId);
+    if (it == m_bundles.end()) {
+      if (!m_factory) {
+        throw std::runtime_error(
+          "You need to register factory function in order to "
+          "support multiple RAM bundles."
+        );
+      }
+      throw std::runtime_error(
+        "In order to fetch RAM bundle from the registry, its file "
+        "path needs to be registered first."
+      );
+    }
+    bundle = it->second;
+  }
+
+  // Waits without holding the lock, so other bundles stay available.
+  return bundle.get();
 }
 
 }  // namespace react
@@ -7,7 +7,9 @@
 
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 
@@ -35,18 +37,23 @@ public:
       std::function<
         std::unique_ptr<JSModulesUnbundle>(std::string)> factory = nullptr);
 
-  RAMBundleRegistry(RAMBundleRegistry&&) = default;
-  RAMBundleRegistry& operator=(RAMBundleRegistry&&) = default;
-
+  // Registers the file of a bundle and starts opening it (and parsing its
+  // module table) on a background thread, so registering does not block the
+  // JS thread, and requiring the first module of the bundle usually does not
+  // either.
   void registerBundle(uint32_t bundleId, std::string bundlePath);
+  // Thread-safe as long as getModule() of the bundles is; waits for the
+  // bundle to be opened if that has not completed yet.
   JSModulesUnbundle::Module getModule(uint32_t bundleId, uint32_t moduleId);
   virtual ~RAMBundleRegistry() {};
 private:
-  JSModulesUnbundle* getBundle(uint32_t bundleId) const;
+  using BundleFuture = std::shared_future<std::shared_ptr<JSModulesUnbundle>>;
+
+  std::shared_ptr<JSModulesUnbundle> getBundle(uint32_t bundleId);
 
-  std::function<std::unique_ptr<JSModulesUnbundle>(std::string)> m_factory;
-  std::unordered_map<uint32_t, std::string> m_bundlePaths;
-  std::unordered_map<uint32_t, std::unique_ptr<JSModulesUnbundle>> m_bundles;
+  const std::function<std::unique_ptr<JSModulesUnbundle>(std::string)> m_factory;
+  std::mutex m_mutex;
+  std::unordered_map<uint32_t, BundleFuture> m_bundles;
 };
 
 }  // namespace react
@@ -0,0 +1,153 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RAMBundleStartupProfile.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <folly/Conv.h>
+#include <glog/logging.h>
+
+namespace facebook {
+namespace react {
+
+constexpr size_t RAMBundleStartupProfile::kMaxModuleCount;
+
+// File format: magic, version, bundle size, module count, module ids.
+// All values are little-endian 32-bit integers except for the bundle size.
+static constexpr uint32_t kProfileMagic = 0x52425350; // "RBSP"
+static constexpr uint32_t kProfileVersion = 1;
+
+namespace {
+struct ProfileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t bundleSize;
+  uint32_t moduleCount;
+  uint32_t reserved;
+};
+static_assert(
+  sizeof(ProfileHeader) == 24,
+  "ProfileHeader must not have any padding");
+}
+
+RAMBundleStartupProfile::RAMBundleStartupProfile(
+    std::string path,
+    uint64_t bundleSize,
+    std::chrono::milliseconds duration) :
+      m_path(std::move(path)),
+      m_bundleSize(bundleSize),
+      m_deadline(std::chrono::steady_clock::now() + duration) {
+  std::ifstream file(m_path, std::ifstream::binary);
+  ProfileHeader header;
+  if (!file || !file.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    return;
+  }
+
+  const size_t moduleCount = folly::Endian::little(header.moduleCount);
+  if (folly::Endian::little(header.magic) != kProfileMagic ||
+      folly::Endian::little(header.version) != kProfileVersion ||
+      folly::Endian::little(header.bundleSize) != m_bundleSize ||
+      moduleCount > kMaxModuleCount) {
+    return;
+  }
+
+  std::vector<uint32_t> moduleIds(moduleCount);
+  if (!file.read(
+        reinterpret_cast<char *>(moduleIds.data()),
+        moduleCount * sizeof(uint32_t))) {
+    return;
+  }
+  for (auto &moduleId : moduleIds) {
+    moduleId = folly::Endian::little(moduleId);
+  }
+  m_previousModuleIds = std::move(moduleIds);
+}
+
+RAMBundleStartupProfile::~RAMBundleStartupProfile() {
+  finish();
+}
+
+const std::vector<uint32_t>& RAMBundleStartupProfile::getPreviousModuleIds() const {
+  return m_previousModuleIds;
+}
+
+void RAMBundleStartupProfile::recordModule(uint32_t moduleId) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_isRecording) {
+    return;
+  }
+
+  if (std::chrono::steady_clock::now() > m_deadline) {
+    finishLocked();
+    return;
+  }
+
+  if (moduleId >= m_isRecorded.size()) {
+    m_isRecorded.resize(moduleId + 1);
+  }
+  if (m_isRecorded[moduleId]) {
+    return;
+  }
+  m_isRecorded[moduleId] = true;
+  m_moduleIds.push_back(moduleId);
+
+  if (m_moduleIds.size() == kMaxModuleCount) {
+    finishLocked();
+  }
+}
+
+void RAMBundleStartupProfile::finish() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_isRecording) {
+    finishLocked();
+  }
+}
+
+void RAMBundleStartupProfile::finishLocked() {
+  m_isRecording = false;
+  m_isRecorded.clear();
+
+  if (m_moduleIds.empty() || m_moduleIds == m_previousModuleIds) {
+    return;
+  }
+
+  ProfileHeader header;
+  header.magic = folly::Endian::little(kProfileMagic);
+  header.version = folly::Endian::little(kProfileVersion);
+  header.bundleSize = folly::Endian::little(m_bundleSize);
+  header.moduleCount =
+    folly::Endian::little(static_cast<uint32_t>(m_moduleIds.size()));
+  header.reserved = 0;
+  for (auto &moduleId : m_moduleIds) {
+    moduleId = folly::Endian::little(moduleId);
+  }
+
+  // Writing into a temporary file and renaming it guarantees that the
+  // profile is never read half-written.
+  const auto temporaryPath = m_path + ".tmp";
+  {
+    std::ofstream file(
+      temporaryPath, std::ofstream::binary | std::ofstream::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(
+      reinterpret_cast<const char *>(m_moduleIds.data()),
+      m_moduleIds.size() * sizeof(uint32_t));
+    if (!file) {
+      LOG(WARNING) << "Could not write RAM bundle startup profile " << m_path;
+      std::remove(temporaryPath.c_str());
+      return;
+    }
+  }
+
+  if (std::rename(temporaryPath.c_str(), m_path.c_str()) != 0) {
+    LOG(WARNING) << "Could not write RAM bundle startup profile " << m_path;
+    std::remove(temporaryPath.c_str());
+  }
+}
+
+}  // namespace react
+}  // namespace facebook
@@ -0,0 +1,69 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef RN_EXPORT
+#define RN_EXPORT __attribute__((visibility("default")))
+#endif
+
+namespace facebook {
+namespace react {
+
+// Records the ids of the modules of a RAM bundle in the order they are
+// required during startup, and stores them in a file next to the bundle.
+// On the next launch, the bundle uses the previous profile to ask the kernel
+// to read the pages of those modules ahead of time, so the serial small reads
+// done by nativeRequire() are served from the page cache.
+//
+// Startup is the period of `duration` after the bundle was opened (which
+// covers the first render of typical applications), unless finish() is
+// called earlier. A profile from a different version of the bundle only
+// makes prefetching useless, so it is recognized by the bundle size only.
+class RN_EXPORT RAMBundleStartupProfile {
+public:
+  static constexpr size_t kMaxModuleCount = 4096;
+
+  // Throws nothing; a profile which cannot be read is treated as empty.
+  RAMBundleStartupProfile(
+    std::string path,
+    uint64_t bundleSize,
+    std::chrono::milliseconds duration = std::chrono::seconds(5));
+  ~RAMBundleStartupProfile();
+
+  RAMBundleStartupProfile(const RAMBundleStartupProfile&) = delete;
+  RAMBundleStartupProfile& operator=(const RAMBundleStartupProfile&) = delete;
+
+  // Ids of the modules recorded during the previous launch.
+  const std::vector<uint32_t>& getPreviousModuleIds() const;
+
+  // Records that a module was required. Can be called from any thread.
+  void recordModule(uint32_t moduleId);
+
+  // Stops recording and stores the profile if it changed.
+  void finish();
+
+private:
+  void finishLocked();
+
+  const std::string m_path;
+  const uint64_t m_bundleSize;
+  const std::chrono::steady_clock::time_point m_deadline;
+  std::vector<uint32_t> m_previousModuleIds;
+
+  std::mutex m_mutex;
+  bool m_isRecording{true};
+  std::vector<uint32_t> m_moduleIds;
+  std::vector<bool> m_isRecorded;
+};
+
+}  // namespace react
+}  // namespace facebook
@@ -24,7 +24,17 @@ enum ReactMarkerId {
   NATIVE_MODULE_SETUP_START,
   NATIVE_MODULE_SETUP_STOP,
   REGISTER_JS_SEGMENT_START,
-  REGISTER_JS_SEGMENT_STOP
+  REGISTER_JS_SEGMENT_STOP,
+  // Logged right after RUN_JS_BUNDLE_STOP; the tag is the number of major
+  // page faults (reads of bundle pages which were not in memory yet) which
+  // happened on the JS thread while the bundle was running. Only recorded in
+  // the native timeline on Android.
+  RUN_JS_BUNDLE_MAJOR_PAGE_FAULTS,
+  // Around loading (but not running) a bundle which is Hermes bytecode,
+  // inside of RUN_JS_BUNDLE_START and RUN_JS_BUNDLE_STOP. Only recorded in the
+  // native timeline on Android.
+  LOAD_BYTECODE_START,
+  LOAD_BYTECODE_STOP
 };
 
 #ifdef __APPLE__
@@ -0,0 +1,101 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ReactMarkerTimeline.h"
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+namespace facebook {
+namespace react {
+namespace ReactMarker {
+
+constexpr size_t Timeline::kMaxTagLength;
+
+namespace {
+// Enough for the markers of a startup which requires a lot of modules.
+const size_t kGlobalTimelineCapacity = 2048;
+
+uint64_t currentThreadId() {
+  static thread_local const uint64_t threadId =
+    std::hash<std::thread::id>()(std::this_thread::get_id());
+  return threadId;
+}
+}
+
+Timeline::Timeline(size_t capacity)
+  : m_capacity(capacity)
+  , m_slots(new Slot[capacity]) {}
+
+Timeline& Timeline::global() {
+  static Timeline* timeline = new Timeline(kGlobalTimelineCapacity);
+  return *timeline;
+}
+
+void Timeline::record(const ReactMarkerId markerId, const char* tag) {
+  const auto timestamp = std::chrono::steady_clock::now().time_since_epoch();
+  const auto index = m_nextIndex.fetch_add(1, std::memory_order_relaxed);
+  auto& slot = m_slots[index % m_capacity];
+
+  slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.markerId.store(markerId, std::memory_order_relaxed);
+  slot.timestampNanos.store(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp).count(),
+    std::memory_order_relaxed);
+  slot.threadId.store(currentThreadId(), std::memory_order_relaxed);
+
+  std::array<uint64_t, kTagWords> words{};
+  if (tag != nullptr) {
+    memcpy(words.data(), tag, strnlen(tag, kMaxTagLength));
+  }
+  for (size_t i = 0; i < kTagWords; i++) {
+    slot.tag[i].store(words[i], std::memory_order_relaxed);
+  }
+
+  slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+std::vector<MarkerEvent> Timeline::snapshot() const {
+  const auto end = m_nextIndex.load(std::memory_order_acquire);
+  const auto begin = end > m_capacity ? end - m_capacity : 0;
+
+  std::vector<MarkerEvent> events;
+  events.reserve(end - begin);
+  for (auto index = begin; index < end; index++) {
+    const auto& slot = m_slots[index % m_capacity];
+    const auto complete = 2 * index + 2;
+    if (slot.sequence.load(std::memory_order_acquire) != complete) {
+      continue;
+    }
+
+    MarkerEvent event;
+    event.markerId =
+      static_cast<ReactMarkerId>(slot.markerId.load(std::memory_order_relaxed));
+    event.timestampNanos = slot.timestampNanos.load(std::memory_order_relaxed);
+    event.threadId = slot.threadId.load(std::memory_order_relaxed);
+    std::array<uint64_t, kTagWords> words;
+    for (size_t i = 0; i < kTagWords; i++) {
+      words[i] = slot.tag[i].load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != complete) {
+      continue;
+    }
+
+    const auto tag = reinterpret_cast<const char*>(words.data());
+    event.tag.assign(tag, strnlen(tag, sizeof(words)));
+    events.push_back(std::move(event));
+  }
+  return events;
+}
+
+}
+}
+}
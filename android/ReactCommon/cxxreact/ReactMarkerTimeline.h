@@ -0,0 +1,82 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cxxreact/ReactMarker.h>
+
+#ifndef RN_EXPORT
+#define RN_EXPORT __attribute__((visibility("default")))
+#endif
+
+namespace facebook {
+namespace react {
+namespace ReactMarker {
+
+struct MarkerEvent {
+  ReactMarkerId markerId;
+  // std::chrono::steady_clock time.
+  int64_t timestampNanos;
+  uint64_t threadId;
+  // Truncated to Timeline::kMaxTagLength bytes.
+  std::string tag;
+};
+
+// A fixed-size ring of the latest markers, which can be written from any
+// thread without locking or allocating. Platforms record every marker in it
+// and read the markers they care about in one go (e.g. when startup is
+// done), instead of crossing into Java or Objective-C for each of them.
+class RN_EXPORT Timeline {
+public:
+  static constexpr size_t kMaxTagLength = 47;
+
+  explicit Timeline(size_t capacity);
+
+  Timeline(const Timeline&) = delete;
+  Timeline& operator=(const Timeline&) = delete;
+
+  // The timeline used by the platforms.
+  static Timeline& global();
+
+  void record(const ReactMarkerId markerId, const char* tag);
+
+  // The markers which are still in the ring, oldest first. Markers which
+  // are being overwritten while this runs are skipped.
+  std::vector<MarkerEvent> snapshot() const;
+
+  size_t capacity() const {
+    return m_capacity;
+  }
+
+private:
+  static constexpr size_t kTagWords = (kMaxTagLength + 1) / sizeof(uint64_t);
+
+  // All fields are atomic so concurrent writers and readers are well
+  // defined; `sequence` tells whether the others belong together: it is odd
+  // while the slot is written, and 2 * (index + 1) once the marker with the
+  // given index is complete.
+  struct Slot {
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<int> markerId{0};
+    std::atomic<int64_t> timestampNanos{0};
+    std::atomic<uint64_t> threadId{0};
+    std::array<std::atomic<uint64_t>, kTagWords> tag{};
+  };
+
+  const size_t m_capacity;
+  std::unique_ptr<Slot[]> m_slots;
+  std::atomic<uint64_t> m_nextIndex{0};
+};
+
+}
+}
+}
@@ -5,13 +5,39 @@
 
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
+
 #ifdef WITH_FBSYSTRACE
 #include <fbsystrace.h>
+#include <folly/Optional.h>
+#endif
+
+/**
+ * The trace categories which are compiled in, as a mask of TraceCategory
+ * values. Sections and counters of the other categories compile to nothing
+ * even when WITH_FBSYSTRACE is defined, e.g. to keep only the bridge's
+ * sections in production builds.
+ */
+#ifndef REACT_NATIVE_TRACE_CATEGORIES
+#define REACT_NATIVE_TRACE_CATEGORIES 0xffffffffu
 #endif
 
 namespace facebook {
 namespace react {
 
+enum class TraceCategory : uint32_t {
+  Bridge = 1 << 0,
+  NativeModules = 1 << 1,
+  JSI = 1 << 2,
+  TurboModules = 1 << 3,
+  Fabric = 1 << 4,
+};
+
+constexpr bool isTraceCategoryCompiledIn(TraceCategory category) {
+  return (REACT_NATIVE_TRACE_CATEGORIES & static_cast<uint32_t>(category)) != 0;
+}
+
 /**
  * This is a convenience class to avoid lots of verbose profiling
  * #ifdefs.  If WITH_FBSYSTRACE is not defined, the optimizer will
@@ -20,21 +46,29 @@ namespace react {
  * to ensure that the ODR rule isn't violated, that is, if WITH_FBSYSTRACE has
  * different values in different files, there is no inconsistency in the sizes
  * of defined symbols.
+ *
+ * Whether tracing is enabled is checked once, before the section or any of its
+ * arguments is formatted, so sections cost a single atomic load while nothing
+ * is being traced.
  */
 #ifdef WITH_FBSYSTRACE
-struct ConcreteSystraceSection {
+template <TraceCategory Category>
+struct ConcreteTraceSection {
 public:
   template<typename... ConvertsToStringPiece>
   explicit
-  ConcreteSystraceSection(__unused const char* name, __unused ConvertsToStringPiece&&... args)
-    : m_section(TRACE_TAG_REACT_CXX_BRIDGE, name, args...)
-  {}
+  ConcreteTraceSection(__unused const char* name, __unused ConvertsToStringPiece&&... args) {
+    if (fbsystrace_is_tracing(TRACE_TAG_REACT_CXX_BRIDGE)) {
+      m_section.emplace(TRACE_TAG_REACT_CXX_BRIDGE, name, args...);
+    }
+  }
 
 private:
-  fbsystrace::FbSystraceSection m_section;
+  folly::Optional<fbsystrace::FbSystraceSection> m_section;
 };
-using SystraceSection = ConcreteSystraceSection;
-#else
+using ConcreteSystraceSection = ConcreteTraceSection<TraceCategory::Bridge>;
+#endif
+
 struct DummySystraceSection {
 public:
   template<typename... ConvertsToStringPiece>
@@ -42,7 +76,32 @@ public:
   DummySystraceSection(__unused const char* name, __unused ConvertsToStringPiece&&... args)
     {}
 };
-using SystraceSection = DummySystraceSection;
+
+#ifdef WITH_FBSYSTRACE
+template <TraceCategory Category>
+using TraceSection = typename std::conditional<
+  isTraceCategoryCompiledIn(Category),
+  ConcreteTraceSection<Category>,
+  DummySystraceSection>::type;
+#else
+template <TraceCategory Category>
+using TraceSection = DummySystraceSection;
+#endif
+
+using SystraceSection = TraceSection<TraceCategory::Bridge>;
+
+/**
+ * Records the value of a counter track (e.g. the number of pending calls),
+ * which the trace shows as a graph over time.
+ */
+template <TraceCategory Category = TraceCategory::Bridge>
+inline void traceCounter(__unused const char* name, __unused int64_t value) {
+#ifdef WITH_FBSYSTRACE
+  if (isTraceCategoryCompiledIn(Category) &&
+      fbsystrace_is_tracing(TRACE_TAG_REACT_CXX_BRIDGE)) {
+    fbsystrace_counter(TRACE_TAG_REACT_CXX_BRIDGE, name, value);
+  }
 #endif
+}
 
 }}
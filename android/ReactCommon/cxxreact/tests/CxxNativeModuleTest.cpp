@@ -0,0 +1,266 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include <cxxreact/CxxModuleQueues.h>
+#include <cxxreact/CxxNativeModule.h>
+
+using namespace facebook::react;
+using namespace facebook::xplat::module;
+
+namespace {
+class TestModule : public CxxModule {
+public:
+  TestModule(Dispatch dispatch, std::thread::id& callThread)
+    : dispatch_(dispatch), callThread_(callThread) {}
+
+  std::string getName() override {
+    return "TestModule";
+  }
+
+  auto getConstants() -> std::map<std::string, folly::dynamic> override {
+    return {};
+  }
+
+  auto getMethods() -> std::vector<Method> override {
+    auto& callThread = callThread_;
+    auto call = Method("call", [&callThread] {
+      callThread = std::this_thread::get_id();
+    });
+    auto jsiCall = Method(
+      "jsiCall",
+      [](facebook::jsi::Runtime&, const facebook::jsi::Value*, size_t) {
+        return facebook::jsi::Value(true);
+      },
+      SyncTag);
+    return {call, Method(call).inlined(), jsiCall};
+  }
+
+  Dispatch getDispatch() override {
+    return dispatch_;
+  }
+
+private:
+  Dispatch dispatch_;
+  std::thread::id& callThread_;
+};
+
+// Runs nothing until it's asked to, so tests can look at queued calls.
+class ManualMessageQueueThread : public MessageQueueThread {
+public:
+  void runOnQueue(std::function<void()>&& runnable) override {
+    queue_.push_back(std::move(runnable));
+  }
+
+  void runOnQueueSync(std::function<void()>&& runnable) override {
+    runnable();
+  }
+
+  void quitSynchronous() override {}
+
+  void runAll() {
+    for (auto& runnable : queue_) {
+      runnable();
+    }
+    queue_.clear();
+  }
+
+  size_t size() const {
+    return queue_.size();
+  }
+
+private:
+  std::vector<std::function<void()>> queue_;
+};
+
+const unsigned int kCall = 0;
+const unsigned int kInlinedCall = 1;
+const unsigned int kJSISyncCall = 2;
+
+std::unique_ptr<CxxNativeModule> makeModule(
+    CxxModule::Dispatch dispatch,
+    std::thread::id& callThread,
+    std::shared_ptr<MessageQueueThread> messageQueueThread,
+    std::shared_ptr<CxxModuleQueues> moduleQueues) {
+  auto module = std::make_unique<CxxNativeModule>(
+    std::weak_ptr<Instance>(),
+    "TestModule",
+    [dispatch, &callThread] {
+      return std::make_unique<TestModule>(dispatch, callThread);
+    },
+    messageQueueThread,
+    moduleQueues);
+  // Like ModuleRegistry, which asks for the methods before calling them.
+  module->getMethods();
+  return module;
+}
+}
+
+TEST(CxxNativeModule, RunsCallsOnTheSharedQueue) {
+  std::thread::id callThread;
+  auto queue = std::make_shared<ManualMessageQueueThread>();
+  auto module = makeModule(
+    CxxModule::Dispatch::SharedQueue,
+    callThread,
+    queue,
+    std::make_shared<CxxModuleQueues>());
+
+  module->invoke(kCall, folly::dynamic::array(), -1);
+  module->invoke(kCall, folly::dynamic::array(), -1);
+  EXPECT_EQ(2, queue->size());
+
+  auto stats = module->getQueueStats();
+  ASSERT_TRUE(stats.hasValue());
+  EXPECT_EQ(2, stats->pendingCalls);
+  EXPECT_EQ(2, stats->maxPendingCalls);
+  EXPECT_EQ(2, stats->totalCalls);
+
+  queue->runAll();
+  EXPECT_EQ(std::this_thread::get_id(), callThread);
+  stats = module->getQueueStats();
+  EXPECT_EQ(0, stats->pendingCalls);
+  EXPECT_EQ(2, stats->maxPendingCalls);
+  EXPECT_EQ(2, stats->totalCalls);
+}
+
+TEST(CxxNativeModule, RunsInlinedCallsRightAway) {
+  std::thread::id callThread;
+  auto queue = std::make_shared<ManualMessageQueueThread>();
+  auto module = makeModule(
+    CxxModule::Dispatch::SharedQueue, callThread, queue, nullptr);
+
+  module->invoke(kInlinedCall, folly::dynamic::array(), -1);
+  EXPECT_EQ(0, queue->size());
+  EXPECT_EQ(std::this_thread::get_id(), callThread);
+
+  auto stats = module->getQueueStats();
+  EXPECT_EQ(0, stats->maxPendingCalls);
+  EXPECT_EQ(1, stats->totalCalls);
+}
+
+TEST(CxxNativeModule, RunsCallsOnADedicatedQueue) {
+  std::thread::id callThread;
+  auto queue = std::make_shared<ManualMessageQueueThread>();
+  auto module = makeModule(
+    CxxModule::Dispatch::DedicatedQueue,
+    callThread,
+    queue,
+    std::make_shared<CxxModuleQueues>());
+
+  module->invoke(kCall, folly::dynamic::array(), -1);
+  EXPECT_EQ(0, queue->size());
+
+  // Destroying the module waits for the calls which are running.
+  while (module->getQueueStats()->pendingCalls) {
+    std::this_thread::yield();
+  }
+  module.reset();
+  EXPECT_NE(std::thread::id(), callThread);
+  EXPECT_NE(std::this_thread::get_id(), callThread);
+}
+
+TEST(CxxNativeModule, FallsBackToTheSharedQueueWithoutModuleQueues) {
+  std::thread::id callThread;
+  auto queue = std::make_shared<ManualMessageQueueThread>();
+  auto module = makeModule(
+    CxxModule::Dispatch::Concurrent, callThread, queue, nullptr);
+
+  module->invoke(kCall, folly::dynamic::array(), -1);
+  EXPECT_EQ(1, queue->size());
+  queue->runAll();
+  EXPECT_EQ(std::this_thread::get_id(), callThread);
+}
+
+TEST(CxxNativeModule, OnlyCallsJSISyncMethodsThroughJSI) {
+  std::thread::id callThread;
+  auto queue = std::make_shared<ManualMessageQueueThread>();
+  auto module = makeModule(
+    CxxModule::Dispatch::SharedQueue, callThread, queue, nullptr);
+
+  EXPECT_EQ("sync", module->getMethods()[kJSISyncCall].type);
+  EXPECT_THROW(
+    module->callSerializableNativeHook(kJSISyncCall, folly::dynamic::array()),
+    std::runtime_error);
+}
+
+TEST(ThreadPoolMessageQueueThread, RunsWorkConcurrently) {
+  ThreadPoolMessageQueueThread queue(2);
+  std::mutex mutex;
+  std::condition_variable condition;
+  int started = 0;
+
+  // Each runnable waits for the other one to start.
+  auto runnable = [&] {
+    std::unique_lock<std::mutex> lock(mutex);
+    started++;
+    condition.notify_all();
+    condition.wait(lock, [&] { return started == 2; });
+  };
+  queue.runOnQueue(runnable);
+  queue.runOnQueue(runnable);
+  queue.runOnQueueSync([] {});
+  queue.quitSynchronous();
+  EXPECT_EQ(2, started);
+}
+
+TEST(ThreadPoolMessageQueueThread, DropsQueuedWorkWhenQuitting) {
+  ThreadPoolMessageQueueThread queue(1);
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool isRunning = false;
+  std::atomic<int> runCount{0};
+
+  queue.runOnQueue([&] {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      isRunning = true;
+    }
+    condition.notify_all();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    runCount++;
+  });
+  queue.runOnQueue([&] { runCount++; });
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&] { return isRunning; });
+  }
+
+  queue.quitSynchronous();
+  EXPECT_EQ(1, runCount);
+
+  queue.runOnQueue([&] { runCount++; });
+  queue.runOnQueueSync([&] { runCount++; });
+  EXPECT_EQ(1, runCount);
+}
+
+TEST(ThreadPoolMessageQueueThread, RunsTheLoopInTheThreadRunner) {
+  std::atomic<int> runnerCount{0};
+  ThreadPoolMessageQueueThread queue(3, [&](std::function<void()>&& loop) {
+    runnerCount++;
+    loop();
+  });
+  queue.quitSynchronous();
+  EXPECT_EQ(3, runnerCount);
+}
+
+TEST(ThreadPoolMessageQueueThread, CanBeDestroyedFromItsRunnable) {
+  auto queue = std::make_shared<ThreadPoolMessageQueueThread>(1);
+  std::promise<void> destroyed;
+  auto future = destroyed.get_future();
+
+  queue->runOnQueue([&] {
+    queue.reset();
+    destroyed.set_value();
+  });
+  future.wait();
+  EXPECT_EQ(nullptr, queue);
+}
@@ -0,0 +1,83 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <vector>
+
+#include <cxxreact/Instance.h>
+#include <cxxreact/InstancePool.h>
+
+using namespace facebook::react;
+
+namespace {
+// Makes instances without bridges, which are initialized once the test calls
+// their callbacks.
+struct FakeFactory {
+  std::vector<std::function<void()>> pendingInitializations;
+  std::vector<Instance *> instances;
+
+  InstancePool::Factory get() {
+    return [this](std::function<void()> onInitialized) {
+      pendingInitializations.push_back(std::move(onInitialized));
+      auto instance = std::make_unique<Instance>();
+      instances.push_back(instance.get());
+      return instance;
+    };
+  }
+
+  void initializeAll() {
+    auto initializations = std::move(pendingInitializations);
+    pendingInitializations.clear();
+    for (auto &initialize : initializations) {
+      initialize();
+    }
+  }
+};
+}
+
+TEST(InstancePool, PrewarmsUpToItsSize) {
+  FakeFactory factory;
+  InstancePool pool(factory.get(), 2);
+
+  pool.prewarm();
+  pool.prewarm();
+  EXPECT_EQ(factory.instances.size(), 2);
+  EXPECT_EQ(pool.readyCount(), 0);
+
+  factory.initializeAll();
+  EXPECT_EQ(pool.readyCount(), 2);
+}
+
+TEST(InstancePool, OnlyHandsOutInitializedInstances) {
+  FakeFactory factory;
+  InstancePool pool(factory.get(), 1);
+  pool.prewarm();
+
+  EXPECT_EQ(pool.acquire(), nullptr);
+
+  factory.initializeAll();
+  auto instance = pool.acquire();
+  EXPECT_EQ(instance.get(), factory.instances[0]);
+
+  // The acquired instance is replaced.
+  EXPECT_EQ(factory.instances.size(), 2);
+  EXPECT_EQ(pool.acquire(), nullptr);
+  factory.initializeAll();
+  auto replacement = pool.acquire();
+  EXPECT_EQ(replacement.get(), factory.instances[1]);
+}
+
+TEST(InstancePool, IgnoresInitializationsAfterClear) {
+  FakeFactory factory;
+  InstancePool pool(factory.get(), 1);
+  pool.prewarm();
+  pool.clear();
+
+  factory.initializeAll();
+  EXPECT_EQ(pool.readyCount(), 0);
+  EXPECT_EQ(pool.acquire(), nullptr);
+}
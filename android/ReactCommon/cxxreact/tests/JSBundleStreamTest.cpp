@@ -0,0 +1,112 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <ios>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cxxreact/JSBundleStream.h>
+#include <cxxreact/JSIndexedRAMBundle.h>
+
+using namespace facebook::react;
+
+namespace {
+void appendUInt32(std::string &data, uint32_t value) {
+  data.append(reinterpret_cast<char *>(&value), sizeof(value));
+}
+
+std::string makeBundle(
+    const std::string &startupCode,
+    const std::vector<std::string> &modules) {
+  std::string table;
+  std::string code;
+  for (const auto &module : modules) {
+    if (module.empty()) {
+      appendUInt32(table, 0);
+      appendUInt32(table, 0);
+      continue;
+    }
+    appendUInt32(table, startupCode.size() + 1 + code.size());
+    appendUInt32(table, module.size() + 1);
+    code += module;
+    code += '\0';
+  }
+
+  std::string data;
+  appendUInt32(data, 0xFB0BD1E5);
+  appendUInt32(data, modules.size());
+  appendUInt32(data, startupCode.size() + 1);
+  data += table;
+  data += startupCode;
+  data += '\0';
+  data += code;
+  return data;
+}
+
+void appendInChunks(
+    JSBundleStream &stream,
+    const std::string &data,
+    size_t chunkSize) {
+  for (size_t offset = 0; offset < data.size(); offset += chunkSize) {
+    stream.append(
+      data.data() + offset, std::min(chunkSize, data.size() - offset));
+  }
+}
+}
+
+TEST(JSBundleStream, ReturnsPlainBundles) {
+  const std::string source(10000, 'x');
+  JSBundleStream stream;
+  appendInChunks(stream, source, 1000);
+
+  EXPECT_EQ(stream.getScriptTag(), ScriptTag::String);
+  EXPECT_EQ(stream.size(), source.size());
+  EXPECT_EQ(
+    stream.hash(),
+    folly::hash::SpookyHashV2::Hash64(source.data(), source.size(), 0));
+
+  auto script = stream.finish();
+  EXPECT_EQ(script->size(), source.size());
+  EXPECT_EQ(std::string(script->c_str()), source);
+}
+
+TEST(JSBundleStream, HandsOutModulesAsTheyAreReceived) {
+  const auto bundle = makeBundle("startup", {"module0", "", "module2"});
+  std::map<uint32_t, std::string> modules;
+  size_t sizeWhenModule0Received = 0;
+  JSBundleStream stream(
+    bundle.size(),
+    [&](uint32_t moduleId, std::unique_ptr<const JSBigString> code) {
+      if (moduleId == 0) {
+        sizeWhenModule0Received = stream.size();
+      }
+      modules[moduleId] = code->c_str();
+    });
+
+  appendInChunks(stream, bundle, 3);
+  EXPECT_EQ(stream.getScriptTag(), ScriptTag::RAMBundle);
+  EXPECT_EQ(modules.size(), 2);
+  EXPECT_EQ(modules[0], "module0");
+  EXPECT_EQ(modules[2], "module2");
+  EXPECT_LT(sizeWhenModule0Received, bundle.size());
+
+  JSIndexedRAMBundle ramBundle(stream.finish());
+  EXPECT_STREQ(ramBundle.getStartupCode()->c_str(), "startup");
+  EXPECT_STREQ(ramBundle.getModule(2).source->c_str(), "module2");
+}
+
+TEST(JSBundleStream, ThrowsForIncompleteRAMBundles) {
+  const auto bundle = makeBundle("startup", {"module0"});
+  JSBundleStream stream;
+  stream.append(bundle.data(), bundle.size() - 2);
+
+  EXPECT_THROW(stream.finish(), std::ios_base::failure);
+  EXPECT_THROW(stream.append("x", 1), std::logic_error);
+}
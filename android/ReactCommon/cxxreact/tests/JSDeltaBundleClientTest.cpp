@@ -62,8 +62,8 @@ TEST(JSDeltaBundleClient, PatchModule) {
 
   client.patch(delta1);
 
-  EXPECT_EQ(client.getModule(0).code, "0");
-  EXPECT_EQ(client.getModule(1).code, "1");
+  EXPECT_STREQ(client.getModule(0).source->c_str(), "0");
+  EXPECT_STREQ(client.getModule(1).source->c_str(), "1");
 
   ASSERT_THROW(client.getModule(2), JSModulesUnbundle::ModuleNotFound);
 
@@ -81,8 +81,8 @@ TEST(JSDeltaBundleClient, PatchModule) {
 
   client.patch(delta2);
 
-  EXPECT_EQ(client.getModule(0).code, "0.1");
-  EXPECT_EQ(client.getModule(2).code, "2");
+  EXPECT_STREQ(client.getModule(0).source->c_str(), "0.1");
+  EXPECT_STREQ(client.getModule(2).source->c_str(), "2");
   ASSERT_THROW(client.getModule(1), JSModulesUnbundle::ModuleNotFound);
 
   folly::dynamic delta3 = folly::parseJson(R"({
@@ -102,8 +102,8 @@ TEST(JSDeltaBundleClient, PatchModule) {
   ASSERT_THROW(client.getModule(1), JSModulesUnbundle::ModuleNotFound);
   ASSERT_THROW(client.getModule(2), JSModulesUnbundle::ModuleNotFound);
 
-  EXPECT_EQ(client.getModule(3).code, "3");
-  EXPECT_EQ(client.getModule(4).code, "4");
+  EXPECT_STREQ(client.getModule(3).source->c_str(), "3");
+  EXPECT_STREQ(client.getModule(4).source->c_str(), "4");
 }
 
 TEST(JSDeltaBundleClient, Clear) {
@@ -129,3 +129,38 @@ TEST(JSDeltaBundleClient, Clear) {
 
   EXPECT_STREQ(client.getStartupCode()->c_str(), "");
 }
+
+TEST(JSDeltaBundleClient, SharesCodeWithoutCopying) {
+  JSDeltaBundleClient client;
+
+  client.patch(folly::parseJson(R"({
+    "base": true,
+    "revisionId": "rev0",
+    "pre": "pre",
+    "post": "post",
+    "modules": [
+      [0, "0"]
+    ]
+  })"));
+
+  EXPECT_EQ(client.getStartupCode()->c_str(), client.getStartupCode()->c_str());
+  EXPECT_EQ(client.getModule(0).source->c_str(), client.getModule(0).source->c_str());
+
+  // Code handed out before a patch stays valid.
+  auto module = client.getModule(0);
+  auto startupCode = client.getStartupCode();
+  client.patch(folly::parseJson(R"({
+    "base": true,
+    "revisionId": "rev1",
+    "pre": "pre1",
+    "post": "post1",
+    "modules": [
+      [0, "0.1"]
+    ]
+  })"));
+
+  EXPECT_STREQ(module.source->c_str(), "0");
+  EXPECT_STREQ(startupCode->c_str(), "pre\npost\n");
+  EXPECT_STREQ(client.getModule(0).source->c_str(), "0.1");
+  EXPECT_STREQ(client.getStartupCode()->c_str(), "pre1\npost1\n");
+}
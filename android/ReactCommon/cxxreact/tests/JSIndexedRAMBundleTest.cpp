@@ -0,0 +1,89 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cxxreact/JSIndexedRAMBundle.h>
+
+using namespace facebook::react;
+
+namespace {
+void appendUInt32(std::string &data, uint32_t value) {
+  data.append(reinterpret_cast<char *>(&value), sizeof(value));
+}
+
+// Builds a RAM bundle with the given startup code and modules; empty
+// modules have no code.
+std::string makeBundle(
+    const std::string &startupCode,
+    const std::vector<std::string> &modules) {
+  std::string table;
+  std::string code;
+  for (const auto &module : modules) {
+    if (module.empty()) {
+      appendUInt32(table, 0);
+      appendUInt32(table, 0);
+      continue;
+    }
+    appendUInt32(table, startupCode.size() + 1 + code.size());
+    appendUInt32(table, module.size() + 1);
+    code += module;
+    code += '\0';
+  }
+
+  std::string data;
+  appendUInt32(data, 0xFB0BD1E5);
+  appendUInt32(data, modules.size());
+  appendUInt32(data, startupCode.size() + 1);
+  data += table;
+  data += startupCode;
+  data += '\0';
+  data += code;
+  return data;
+}
+}
+
+TEST(JSIndexedRAMBundle, ReadsStartupCodeAndModules) {
+  auto script = std::make_unique<JSBigStdString>(
+    makeBundle("startup", {"module0", "", "module2"}));
+  const auto begin = script->c_str();
+  const auto end = begin + script->size();
+
+  JSIndexedRAMBundle bundle(std::move(script));
+
+  EXPECT_STREQ(bundle.getStartupCode()->c_str(), "startup");
+
+  auto module = bundle.getModule(2);
+  EXPECT_EQ(module.name, "2.js");
+  ASSERT_TRUE(module.source != nullptr);
+  EXPECT_STREQ(module.source->c_str(), "module2");
+  EXPECT_EQ(module.source->size(), 7);
+  // The code is not copied out of the bundle.
+  EXPECT_GE(module.source->c_str(), begin);
+  EXPECT_LT(module.source->c_str(), end);
+
+  EXPECT_STREQ(bundle.getModule(0).source->c_str(), "module0");
+}
+
+TEST(JSIndexedRAMBundle, ThrowsForMissingModules) {
+  JSIndexedRAMBundle bundle(
+    std::make_unique<JSBigStdString>(makeBundle("startup", {"module0", ""})));
+
+  EXPECT_THROW(bundle.getModule(1), std::ios_base::failure);
+  EXPECT_THROW(bundle.getModule(2), std::ios_base::failure);
+}
+
+TEST(JSIndexedRAMBundle, ThrowsForTruncatedBundles) {
+  auto data = makeBundle("startup", {"module0"});
+
+  EXPECT_THROW(
+    JSIndexedRAMBundle(std::make_unique<JSBigStdString>(data.substr(0, 16))),
+    std::ios_base::failure);
+}
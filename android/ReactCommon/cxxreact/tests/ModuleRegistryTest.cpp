@@ -0,0 +1,87 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cxxreact/ModuleRegistry.h>
+#include <cxxreact/NativeModule.h>
+
+using namespace facebook::react;
+
+namespace {
+class ConstantsModule : public NativeModule {
+public:
+  ConstantsModule(bool hasLazyConstants, int& constantsCalls)
+    : m_hasLazyConstants(hasLazyConstants)
+    , m_constantsCalls(constantsCalls) {}
+
+  std::string getName() override {
+    return "Constants";
+  }
+  std::vector<MethodDescriptor> getMethods() override {
+    return {};
+  }
+  folly::dynamic getConstants() override {
+    m_constantsCalls++;
+    return folly::dynamic::object("foo", 1);
+  }
+  bool hasLazyConstants() override {
+    return m_hasLazyConstants;
+  }
+  void invoke(unsigned int, folly::dynamic&&, int) override {}
+  MethodCallResult callSerializableNativeHook(unsigned int, folly::dynamic&&) override {
+    return folly::none;
+  }
+
+private:
+  bool m_hasLazyConstants;
+  int& m_constantsCalls;
+};
+
+std::vector<std::unique_ptr<NativeModule>> makeModules(
+    bool hasLazyConstants,
+    int& constantsCalls) {
+  std::vector<std::unique_ptr<NativeModule>> modules;
+  modules.push_back(
+    std::make_unique<ConstantsModule>(hasLazyConstants, constantsCalls));
+  return modules;
+}
+}
+
+TEST(ModuleRegistry, DefersLazyConstants) {
+  int constantsCalls = 0;
+  ModuleRegistry registry(makeModules(true, constantsCalls));
+
+  auto config = registry.getConfig("Constants", true);
+  ASSERT_TRUE(config.hasValue());
+  EXPECT_TRUE(config->hasLazyConstants);
+  EXPECT_TRUE(config->config[1].isObject());
+  EXPECT_TRUE(config->config[1].empty());
+  EXPECT_EQ(0, constantsCalls);
+
+  EXPECT_EQ(folly::dynamic(folly::dynamic::object("foo", 1)), registry.getConstants(config->index));
+  EXPECT_EQ(1, constantsCalls);
+  EXPECT_THROW(registry.getConstants(1), std::runtime_error);
+}
+
+TEST(ModuleRegistry, ComputesConstantsEagerlyUnlessAllowed) {
+  int constantsCalls = 0;
+  ModuleRegistry lazyRegistry(makeModules(true, constantsCalls));
+  auto config = lazyRegistry.getConfig("Constants");
+  ASSERT_TRUE(config.hasValue());
+  EXPECT_FALSE(config->hasLazyConstants);
+  EXPECT_EQ(folly::dynamic(folly::dynamic::object("foo", 1)), config->config[1]);
+
+  ModuleRegistry eagerRegistry(makeModules(false, constantsCalls));
+  config = eagerRegistry.getConfig("Constants", true);
+  ASSERT_TRUE(config.hasValue());
+  EXPECT_FALSE(config->hasLazyConstants);
+  EXPECT_EQ(folly::dynamic(folly::dynamic::object("foo", 1)), config->config[1]);
+  EXPECT_EQ(2, constantsCalls);
+}
@@ -0,0 +1,304 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cxxreact/Instance.h>
+#include <cxxreact/JSBigString.h>
+#include <cxxreact/JSExecutor.h>
+#include <cxxreact/MessageQueueThread.h>
+#include <cxxreact/ModuleRegistry.h>
+#include <cxxreact/NativeToJsBridge.h>
+#include <cxxreact/RAMBundleRegistry.h>
+#include <folly/json.h>
+
+using namespace facebook::react;
+
+namespace {
+
+// Runs its tasks when the test asks it to.
+class ManualMessageQueueThread : public MessageQueueThread {
+public:
+  void runOnQueue(std::function<void()>&& task) override {
+    tasks.push_back(std::move(task));
+  }
+
+  void runOnQueueSync(std::function<void()>&& task) override {
+    task();
+  }
+
+  void quitSynchronous() override {}
+
+  void runAll() {
+    while (!tasks.empty()) {
+      auto task = std::move(tasks.front());
+      tasks.pop_front();
+      task();
+    }
+  }
+
+  std::deque<std::function<void()>> tasks;
+};
+
+struct RecordingCallback : public InstanceCallback {
+  void onBatchComplete() override {
+    batches++;
+  }
+  void incrementPendingJSCalls() override {
+    pendingJSCalls++;
+  }
+  void decrementPendingJSCalls() override {
+    pendingJSCalls--;
+  }
+
+  int batches = 0;
+  int pendingJSCalls = 0;
+};
+
+// Records the calls it gets as "<entry> <module>.<method>" or
+// "<entry> <callback id>" (followed by the arguments if they're encoded), and
+// ends a batch with a native module call
+// whenever JS would flush its queue.
+class RecordingExecutor : public JSExecutor {
+public:
+  RecordingExecutor(
+      std::shared_ptr<ExecutorDelegate> delegate,
+      std::vector<std::string>& log)
+    : m_delegate(std::move(delegate))
+    , m_log(log) {}
+
+  void loadApplicationScript(std::unique_ptr<const JSBigString>, std::string) override {}
+  void setBundleRegistry(std::unique_ptr<RAMBundleRegistry>) override {}
+  void registerBundle(uint32_t, const std::string&) override {}
+
+  void callFunction(
+      const std::string& moduleId,
+      const std::string& methodId,
+      const folly::dynamic&) override {
+    m_log.push_back("callFunction " + moduleId + "." + methodId);
+    flush(true);
+  }
+
+  void invokeCallback(const double callbackId, const folly::dynamic&) override {
+    m_log.push_back(folly::to<std::string>("invokeCallback ", callbackId));
+    flush(true);
+  }
+
+  void callFunctions(std::vector<JSCall>&& calls) override {
+    for (const auto& call : calls) {
+      if (call.isCallback()) {
+        m_log.push_back(folly::to<std::string>("callFunctions ", call.callbackId));
+      } else {
+        m_log.push_back("callFunctions " + call.moduleId + "." + call.methodId);
+      }
+      if (call.encodedArguments) {
+        m_log.back() += " " + folly::toJson(call.dynamicArguments());
+      }
+    }
+    flush(true);
+  }
+
+  void setGlobalVariable(std::string propName, std::unique_ptr<const JSBigString>) override {
+    m_log.push_back("setGlobalVariable " + propName);
+  }
+
+  std::string getDescription() override {
+    return "RecordingExecutor";
+  }
+
+private:
+  void flush(bool isEndOfBatch) {
+    std::vector<MethodCall> calls;
+    calls.emplace_back(0, 0, folly::dynamic::array(), -1);
+    m_delegate->callNativeModules(*this, std::move(calls), isEndOfBatch);
+  }
+
+  std::shared_ptr<ExecutorDelegate> m_delegate;
+  std::vector<std::string>& m_log;
+};
+
+class RecordingExecutorFactory : public JSExecutorFactory {
+public:
+  explicit RecordingExecutorFactory(std::vector<std::string>& log)
+    : m_log(log) {}
+
+  std::unique_ptr<JSExecutor> createJSExecutor(
+      std::shared_ptr<ExecutorDelegate> delegate,
+      std::shared_ptr<MessageQueueThread>) override {
+    return std::make_unique<RecordingExecutor>(std::move(delegate), m_log);
+  }
+
+private:
+  std::vector<std::string>& m_log;
+};
+
+class NoOpModule : public NativeModule {
+public:
+  std::string getName() override {
+    return "NoOp";
+  }
+  std::vector<MethodDescriptor> getMethods() override {
+    return {MethodDescriptor("noOp", "async")};
+  }
+  folly::dynamic getConstants() override {
+    return nullptr;
+  }
+  void invoke(unsigned int, folly::dynamic&&, int) override {}
+  MethodCallResult callSerializableNativeHook(unsigned int, folly::dynamic&&) override {
+    return folly::none;
+  }
+};
+
+class DynamicArguments : public JSArguments {
+public:
+  explicit DynamicArguments(folly::dynamic arguments)
+    : m_arguments(std::move(arguments)) {}
+
+  facebook::jsi::Value toJSValue(facebook::jsi::Runtime&) const override {
+    throw std::logic_error("Not used by RecordingExecutor");
+  }
+
+  folly::dynamic toDynamic() const override {
+    return m_arguments;
+  }
+
+private:
+  folly::dynamic m_arguments;
+};
+
+class NativeToJsBridgeTest : public ::testing::Test {
+protected:
+  NativeToJsBridgeTest()
+    : queue(std::make_shared<ManualMessageQueueThread>())
+    , callback(std::make_shared<RecordingCallback>()) {
+    std::vector<std::unique_ptr<NativeModule>> modules;
+    modules.push_back(std::make_unique<NoOpModule>());
+    RecordingExecutorFactory factory(log);
+    bridge = std::make_unique<NativeToJsBridge>(
+      &factory,
+      std::make_shared<ModuleRegistry>(std::move(modules)),
+      queue,
+      callback);
+  }
+
+  ~NativeToJsBridgeTest() {
+    bridge->destroy();
+  }
+
+  void callFunction(const std::string& module, const std::string& method) {
+    callback->incrementPendingJSCalls();
+    bridge->callFunction(std::string(module), std::string(method), folly::dynamic::array());
+  }
+
+  void invokeCallback(double callbackId) {
+    callback->incrementPendingJSCalls();
+    bridge->invokeCallback(callbackId, folly::dynamic::array());
+  }
+
+  std::vector<std::string> log;
+  std::shared_ptr<ManualMessageQueueThread> queue;
+  std::shared_ptr<RecordingCallback> callback;
+  std::unique_ptr<NativeToJsBridge> bridge;
+};
+
+}
+
+TEST_F(NativeToJsBridgeTest, DeliversCallsSeparatelyByDefault) {
+  callFunction("A", "a");
+  invokeCallback(1);
+  queue->runAll();
+
+  EXPECT_EQ(
+    (std::vector<std::string>{"callFunction A.a", "invokeCallback 1"}),
+    log);
+  EXPECT_EQ(2, callback->batches);
+  EXPECT_EQ(0, callback->pendingJSCalls);
+}
+
+TEST_F(NativeToJsBridgeTest, CoalescesQueuedCalls) {
+  bridge->setCallCoalescingEnabled(true);
+  callFunction("A", "a");
+  invokeCallback(1);
+  callFunction("B", "b");
+  EXPECT_EQ(1, queue->tasks.size());
+  queue->runAll();
+
+  EXPECT_EQ(
+    (std::vector<std::string>{
+      "callFunctions A.a", "callFunctions 1", "callFunctions B.b"}),
+    log);
+  EXPECT_EQ(1, callback->batches);
+  EXPECT_EQ(0, callback->pendingJSCalls);
+
+  // Calls queued once the batch started go into the next one.
+  callFunction("C", "c");
+  queue->runAll();
+  EXPECT_EQ("callFunctions C.c", log.back());
+  EXPECT_EQ(2, callback->batches);
+  EXPECT_EQ(0, callback->pendingJSCalls);
+}
+
+TEST_F(NativeToJsBridgeTest, DoesNotCoalesceCallsAcrossOtherWork) {
+  bridge->setCallCoalescingEnabled(true);
+  callFunction("A", "a");
+  bridge->setGlobalVariable(
+    "foo", std::make_unique<JSBigStdString>("1"));
+  callFunction("B", "b");
+  queue->runAll();
+
+  EXPECT_EQ(
+    (std::vector<std::string>{
+      "callFunctions A.a", "setGlobalVariable foo", "callFunctions B.b"}),
+    log);
+  EXPECT_EQ(0, callback->pendingJSCalls);
+}
+
+TEST_F(NativeToJsBridgeTest, DeliversEncodedArgumentsThroughCallFunctions) {
+  callback->incrementPendingJSCalls();
+  bridge->callFunction(
+    "A", "a", std::make_shared<DynamicArguments>(folly::dynamic::array(1)));
+  callback->incrementPendingJSCalls();
+  bridge->invokeCallback(
+    2, std::make_shared<DynamicArguments>(folly::dynamic::array("x")));
+  EXPECT_EQ(2, queue->tasks.size());
+  queue->runAll();
+
+  EXPECT_EQ(
+    (std::vector<std::string>{
+      "callFunctions A.a [1]", "callFunctions 2 [\"x\"]"}),
+    log);
+  EXPECT_EQ(2, callback->batches);
+  EXPECT_EQ(0, callback->pendingJSCalls);
+}
+
+TEST_F(NativeToJsBridgeTest, CoalescesCallsWithEncodedArguments) {
+  bridge->setCallCoalescingEnabled(true);
+  callFunction("A", "a");
+  callback->incrementPendingJSCalls();
+  bridge->callFunction(
+    "B", "b", std::make_shared<DynamicArguments>(folly::dynamic::array(1)));
+  EXPECT_EQ(1, queue->tasks.size());
+  queue->runAll();
+
+  EXPECT_EQ(
+    (std::vector<std::string>{"callFunctions A.a", "callFunctions B.b [1]"}),
+    log);
+  EXPECT_EQ(0, callback->pendingJSCalls);
+}
+
+TEST_F(NativeToJsBridgeTest, SetsGlobalVariablesLazilyWhereSupported) {
+  // The executor doesn't defer parsing, so the variable is set right away.
+  bridge->setGlobalVariableLazily(
+    "foo", std::make_unique<JSBigStdString>("1"));
+  queue->runAll();
+
+  EXPECT_EQ((std::vector<std::string>{"setGlobalVariable foo"}), log);
+}
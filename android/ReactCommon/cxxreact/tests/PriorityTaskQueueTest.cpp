@@ -0,0 +1,61 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <cxxreact/PriorityTaskQueue.h>
+
+using namespace facebook::react;
+
+namespace {
+void runAll(PriorityTaskQueue& queue) {
+  while (auto task = queue.pop()) {
+    task();
+  }
+}
+
+void push(
+    PriorityTaskQueue& queue,
+    std::string& order,
+    char name,
+    MessageQueuePriority priority,
+    MessageQueueDeadline deadline = MessageQueueDeadline::max()) {
+  queue.push([&order, name] { order += name; }, priority, deadline);
+}
+}
+
+TEST(PriorityTaskQueue, RunsLanesInOrderOfPriority) {
+  PriorityTaskQueue queue;
+  std::string order;
+  push(queue, order, 'a', MessageQueuePriority::Idle);
+  push(queue, order, 'b', MessageQueuePriority::Normal);
+  push(queue, order, 'c', MessageQueuePriority::High);
+  push(queue, order, 'd', MessageQueuePriority::Normal);
+  push(queue, order, 'e', MessageQueuePriority::High);
+  EXPECT_EQ(5, queue.size());
+
+  runAll(queue);
+  EXPECT_EQ("cebda", order);
+  EXPECT_EQ(0, queue.size());
+  EXPECT_FALSE(queue.pop());
+}
+
+TEST(PriorityTaskQueue, PromotesLanesWithLateTasks) {
+  PriorityTaskQueue queue;
+  std::string order;
+  const auto past = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+  const auto future = std::chrono::steady_clock::now() + std::chrono::hours(1);
+  push(queue, order, 'a', MessageQueuePriority::Idle);
+  push(queue, order, 'b', MessageQueuePriority::Idle, past);
+  push(queue, order, 'c', MessageQueuePriority::Idle);
+  push(queue, order, 'd', MessageQueuePriority::Normal, future);
+  push(queue, order, 'e', MessageQueuePriority::High);
+
+  // The idle lane runs until the late task ran, in order.
+  runAll(queue);
+  EXPECT_EQ("abedc", order);
+}
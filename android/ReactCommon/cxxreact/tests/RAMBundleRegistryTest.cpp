@@ -0,0 +1,90 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cxxreact/RAMBundleRegistry.h>
+
+using namespace facebook::react;
+
+namespace {
+class TestBundle : public JSModulesUnbundle {
+public:
+  explicit TestBundle(std::string name) : m_name(std::move(name)) {}
+
+  Module getModule(uint32_t moduleId) const override {
+    return {
+      folly::to<std::string>(moduleId, ".js"),
+      folly::to<std::string>(m_name, ":", moduleId),
+    };
+  }
+
+private:
+  std::string m_name;
+};
+}
+
+TEST(RAMBundleRegistry, OpensRegisteredBundles) {
+  std::atomic<int> openCount{0};
+  auto registry = RAMBundleRegistry::multipleBundlesRegistry(
+    std::make_unique<TestBundle>("main"),
+    [&openCount](std::string path) -> std::unique_ptr<JSModulesUnbundle> {
+      openCount++;
+      if (path == "broken") {
+        throw std::runtime_error("Bundle cannot be opened");
+      }
+      return std::make_unique<TestBundle>(path);
+    });
+
+  registry->registerBundle(1, "first");
+  registry->registerBundle(2, "broken");
+
+  EXPECT_EQ(registry->getModule(0, 3).code, "main:3");
+  EXPECT_EQ(registry->getModule(0, 3).name, "3.js");
+  EXPECT_EQ(registry->getModule(1, 3).code, "first:3");
+  EXPECT_EQ(registry->getModule(1, 3).name, "seg-1_3.js");
+  EXPECT_THROW(registry->getModule(2, 3), std::runtime_error);
+  EXPECT_THROW(registry->getModule(3, 3), std::runtime_error);
+  EXPECT_EQ(openCount, 2);
+}
+
+TEST(RAMBundleRegistry, CanBeUsedFromMultipleThreads) {
+  auto registry = RAMBundleRegistry::multipleBundlesRegistry(
+    std::make_unique<TestBundle>("main"),
+    [](std::string path) -> std::unique_ptr<JSModulesUnbundle> {
+      return std::make_unique<TestBundle>(path);
+    });
+
+  std::vector<std::thread> threads;
+  for (uint32_t bundleId = 1; bundleId <= 4; bundleId++) {
+    threads.emplace_back([&registry, bundleId]() {
+      registry->registerBundle(bundleId, folly::to<std::string>(bundleId));
+      for (uint32_t moduleId = 0; moduleId < 100; moduleId++) {
+        EXPECT_EQ(
+          registry->getModule(bundleId, moduleId).code,
+          folly::to<std::string>(bundleId, ":", moduleId));
+        registry->getModule(0, moduleId);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(RAMBundleRegistry, RequiresFactoryForMultipleBundles) {
+  auto registry =
+    RAMBundleRegistry::singleBundleRegistry(std::make_unique<TestBundle>("main"));
+
+  registry->registerBundle(1, "first");
+  EXPECT_THROW(registry->getModule(1, 0), std::runtime_error);
+}
@@ -0,0 +1,76 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <cxxreact/RAMBundleStartupProfile.h>
+
+using namespace facebook::react;
+
+namespace {
+std::string temporaryProfilePath() {
+  const char *tmpDir = getenv("TMPDIR");
+  if (tmpDir == nullptr) {
+    tmpDir = "/tmp";
+  }
+  auto path = std::string{tmpDir} + "/startup-profile-test";
+  std::remove(path.c_str());
+  return path;
+}
+}
+
+TEST(RAMBundleStartupProfile, StoresModulesInOrderOfFirstRequire) {
+  const auto path = temporaryProfilePath();
+
+  {
+    RAMBundleStartupProfile profile(path, 100);
+    EXPECT_TRUE(profile.getPreviousModuleIds().empty());
+    profile.recordModule(3);
+    profile.recordModule(1);
+    profile.recordModule(3);
+    profile.recordModule(2);
+    profile.finish();
+    // Modules required after startup are not recorded.
+    profile.recordModule(4);
+  }
+
+  RAMBundleStartupProfile profile(path, 100);
+  EXPECT_EQ(profile.getPreviousModuleIds(), (std::vector<uint32_t>{3, 1, 2}));
+
+  std::remove(path.c_str());
+}
+
+TEST(RAMBundleStartupProfile, IgnoresProfilesOfOtherBundles) {
+  const auto path = temporaryProfilePath();
+
+  {
+    RAMBundleStartupProfile profile(path, 100);
+    profile.recordModule(1);
+  }
+
+  RAMBundleStartupProfile profile(path, 200);
+  EXPECT_TRUE(profile.getPreviousModuleIds().empty());
+
+  std::remove(path.c_str());
+}
+
+TEST(RAMBundleStartupProfile, StopsRecordingAfterStartup) {
+  const auto path = temporaryProfilePath();
+
+  {
+    RAMBundleStartupProfile profile(path, 100, std::chrono::milliseconds(0));
+    profile.recordModule(1);
+  }
+
+  RAMBundleStartupProfile profile(path, 100);
+  EXPECT_TRUE(profile.getPreviousModuleIds().empty());
+
+  std::remove(path.c_str());
+}
@@ -0,0 +1,72 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cxxreact/ReactMarkerTimeline.h>
+
+using namespace facebook::react::ReactMarker;
+
+TEST(ReactMarkerTimeline, RecordsMarkersInOrder) {
+  Timeline timeline(4);
+  timeline.record(NATIVE_REQUIRE_START, "1");
+  timeline.record(NATIVE_REQUIRE_STOP, nullptr);
+
+  auto events = timeline.snapshot();
+  ASSERT_EQ(2, events.size());
+  EXPECT_EQ(NATIVE_REQUIRE_START, events[0].markerId);
+  EXPECT_EQ("1", events[0].tag);
+  EXPECT_EQ(NATIVE_REQUIRE_STOP, events[1].markerId);
+  EXPECT_EQ("", events[1].tag);
+  EXPECT_LE(events[0].timestampNanos, events[1].timestampNanos);
+  EXPECT_EQ(events[0].threadId, events[1].threadId);
+}
+
+TEST(ReactMarkerTimeline, KeepsTheLatestMarkers) {
+  Timeline timeline(2);
+  timeline.record(RUN_JS_BUNDLE_START, "a");
+  timeline.record(RUN_JS_BUNDLE_STOP, "b");
+  timeline.record(CREATE_REACT_CONTEXT_STOP, "c");
+
+  auto events = timeline.snapshot();
+  ASSERT_EQ(2, events.size());
+  EXPECT_EQ("b", events[0].tag);
+  EXPECT_EQ("c", events[1].tag);
+}
+
+TEST(ReactMarkerTimeline, TruncatesLongTags) {
+  Timeline timeline(1);
+  timeline.record(REGISTER_JS_SEGMENT_START, std::string(100, 'x').c_str());
+
+  auto events = timeline.snapshot();
+  ASSERT_EQ(1, events.size());
+  EXPECT_EQ(std::string(Timeline::kMaxTagLength, 'x'), events[0].tag);
+}
+
+TEST(ReactMarkerTimeline, RecordsFromManyThreads) {
+  Timeline timeline(64);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&timeline] {
+      for (int j = 0; j < 1000; j++) {
+        timeline.record(NATIVE_REQUIRE_START, "tag");
+      }
+    });
+  }
+  for (int i = 0; i < 100; i++) {
+    for (const auto& event : timeline.snapshot()) {
+      EXPECT_EQ("tag", event.tag);
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(64, timeline.snapshot().size());
+}
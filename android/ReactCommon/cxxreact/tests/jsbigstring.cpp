@@ -61,6 +61,21 @@ TEST(JSBigFileString, MapPartTest) {
   }
 }
 
+TEST(JSBigFileString, MapPartAfterFirstPageTest) {
+  // E.g. an uncompressed asset inside of an APK.
+  const size_t ps = getpagesize();
+  std::string data(2 * ps + 100, 'x');
+  std::string needle {"Hello, world"};
+  const off_t offset = ps + 10;
+  data.replace(offset, needle.size(), needle);
+
+  int fd = tempFileFromString(data);
+  JSBigFileString bigStr {fd, needle.size(), offset};
+
+  ASSERT_EQ(needle.length(), bigStr.size());
+  ASSERT_EQ(needle, std::string(bigStr.c_str(), bigStr.size()));
+}
+
 TEST(JSBigFileString, RemapTest) {
   static const uint8_t kRemapMagic[] = {
     0xc6, 0x1f, 0xbc, 0x03, 0xc1, 0x03, 0x19, 0x1f, 0xa1, 0xd0, 0xeb, 0x73
@@ -103,3 +118,66 @@ TEST(JSBigFileString, RemapTest) {
     ASSERT_EQ(0x11, remapped[i]);
   }
 }
+
+TEST(JSBigFileString, MappingPolicyTest) {
+  std::string data {"Hello, world"};
+
+  JSBigFileMappingPolicy policies[4];
+  policies[1].access = JSBigFileMappingPolicy::Access::Sequential;
+  policies[1].populateSize = SIZE_MAX;
+  policies[2].access = JSBigFileMappingPolicy::Access::Random;
+  policies[2].populateSize = 5;
+  policies[2].lockPopulated = true;
+  policies[3].useHugePages = true;
+
+  for (const auto &policy : policies) {
+    int fd = tempFileFromString(data);
+    JSBigFileString bigStr {fd, data.size(), 0, policy};
+
+    ASSERT_EQ(data.size(), bigStr.size());
+    ASSERT_STREQ(data.c_str(), bigStr.c_str());
+  }
+}
+
+TEST(JSBigSegmentedString, JoinsSegmentsTest) {
+  JSBigSegmentedString bigStr {{
+    std::make_shared<JSBigStdString>("Hello", true),
+    std::make_shared<JSBigStdString>(", ", true),
+    std::make_shared<JSBigStdString>("world", true),
+  }};
+
+  ASSERT_TRUE(bigStr.isAscii());
+  ASSERT_EQ(12, bigStr.size());
+
+  std::vector<std::string> segments;
+  bigStr.forEachSegment([&](const char *data, size_t size) {
+    segments.emplace_back(data, size);
+  });
+  ASSERT_EQ((std::vector<std::string>{"Hello", ", ", "world"}), segments);
+
+  ASSERT_STREQ("Hello, world", bigStr.c_str());
+  ASSERT_EQ(bigStr.c_str(), bigStr.c_str());
+
+  // Once joined, it's a single segment.
+  segments.clear();
+  bigStr.forEachSegment([&](const char *data, size_t size) {
+    segments.emplace_back(data, size);
+  });
+  ASSERT_EQ((std::vector<std::string>{"Hello, world"}), segments);
+}
+
+TEST(JSBigSegmentedString, ReleasesSegmentsWhenJoinedTest) {
+  auto segment = std::make_shared<JSBigStdString>("Hello, world");
+  JSBigSegmentedString bigStr {{segment}};
+  ASSERT_FALSE(bigStr.isAscii());
+  ASSERT_EQ(2, segment.use_count());
+
+  ASSERT_STREQ("Hello, world", bigStr.c_str());
+  ASSERT_EQ(1, segment.use_count());
+}
+
+TEST(JSBigSegmentedString, EmptyTest) {
+  JSBigSegmentedString bigStr {{}};
+  ASSERT_EQ(0, bigStr.size());
+  ASSERT_STREQ("", bigStr.c_str());
+}
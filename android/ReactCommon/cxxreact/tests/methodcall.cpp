@@ -153,3 +153,122 @@ TEST(parseMethodCalls, ParseTwoCalls) {
   auto returnedCalls = parseMethodCalls(folly::parseJson(jsText));
   ASSERT_EQ(2, returnedCalls.size());
 }
+
+namespace {
+// Little-endian, like the hosts the tests run on.
+template <typename T>
+void append(std::string& data, T value) {
+  data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendString(std::string& data, const std::string& string) {
+  append<uint32_t>(data, string.size());
+  data += string;
+}
+
+std::string withLength(const std::string& calls) {
+  std::string data;
+  append<uint32_t>(data, calls.size());
+  return data + calls;
+}
+
+std::vector<MethodCall> parseBinary(const std::string& data) {
+  return parseMethodCalls(
+    reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+}
+
+TEST(parseMethodCalls, BinaryCalls) {
+  std::string calls;
+  append<uint32_t>(calls, 7);
+  append<uint32_t>(calls, 3);
+  append<int32_t>(calls, -1);
+  append<uint8_t>(calls, 6);
+  append<uint32_t>(calls, 0);
+
+  append<uint32_t>(calls, 2);
+  append<uint32_t>(calls, 4);
+  append<int32_t>(calls, 11);
+  append<uint8_t>(calls, 6);
+  append<uint32_t>(calls, 7);
+  append<uint8_t>(calls, 0);
+  append<uint8_t>(calls, 1);
+  append<uint8_t>(calls, 2);
+  append<uint8_t>(calls, 3);
+  append<double>(calls, 1.5);
+  append<uint8_t>(calls, 4);
+  append<int32_t>(calls, -42);
+  append<uint8_t>(calls, 5);
+  appendString(calls, "foo");
+  append<uint8_t>(calls, 7);
+  append<uint32_t>(calls, 1);
+  appendString(calls, "bar");
+  append<uint8_t>(calls, 6);
+  append<uint32_t>(calls, 1);
+  append<uint8_t>(calls, 2);
+
+  // Bytes after the calls are ignored.
+  auto returnedCalls = parseBinary(withLength(calls) + "garbage");
+  ASSERT_EQ(2, returnedCalls.size());
+  ASSERT_EQ(7, returnedCalls[0].moduleId);
+  ASSERT_EQ(3, returnedCalls[0].methodId);
+  ASSERT_EQ(-1, returnedCalls[0].callId);
+  ASSERT_EQ(dynamic::array(), returnedCalls[0].arguments);
+
+  ASSERT_EQ(2, returnedCalls[1].moduleId);
+  ASSERT_EQ(4, returnedCalls[1].methodId);
+  ASSERT_EQ(11, returnedCalls[1].callId);
+  auto expected = dynamic::array(
+    nullptr, false, true, 1.5, -42.0, "foo",
+    dynamic::object("bar", dynamic::array(true)));
+  ASSERT_EQ(expected, returnedCalls[1].arguments);
+  ASSERT_TRUE(returnedCalls[1].arguments[4].isDouble());
+}
+
+TEST(parseMethodCalls, BinaryEmpty) {
+  ASSERT_EQ(0, parseBinary(withLength("")).size());
+}
+
+TEST(parseMethodCalls, InvalidBinaryFormat) {
+  std::string call;
+  append<uint32_t>(call, 1);
+  append<uint32_t>(call, 2);
+  append<int32_t>(call, -1);
+
+  // Missing length.
+  EXPECT_THROW(parseBinary(""), std::invalid_argument);
+  // Length past the end of the buffer.
+  EXPECT_THROW(
+    parseBinary(withLength(call + "\x06").substr(0, call.size())),
+    std::invalid_argument);
+  // Missing arguments.
+  EXPECT_THROW(parseBinary(withLength(call)), std::invalid_argument);
+  // Arguments which are not an array.
+  EXPECT_THROW(parseBinary(withLength(call + '\x00')), std::invalid_argument);
+  // Unknown tag.
+  EXPECT_THROW(parseBinary(withLength(call + '\x2a')), std::invalid_argument);
+
+  // Truncated string.
+  std::string string = call;
+  append<uint8_t>(string, 6);
+  append<uint32_t>(string, 1);
+  append<uint8_t>(string, 5);
+  append<uint32_t>(string, 100);
+  string += "foo";
+  EXPECT_THROW(parseBinary(withLength(string)), std::invalid_argument);
+
+  // More elements than bytes.
+  std::string array = call;
+  append<uint8_t>(array, 6);
+  append<uint32_t>(array, 0xffffffff);
+  EXPECT_THROW(parseBinary(withLength(array)), std::invalid_argument);
+
+  // Nested too deeply.
+  std::string nested = call;
+  for (int i = 0; i < 1000; i++) {
+    append<uint8_t>(nested, 6);
+    append<uint32_t>(nested, 1);
+  }
+  append<uint8_t>(nested, 0);
+  EXPECT_THROW(parseBinary(withLength(nested)), std::invalid_argument);
+}
@@ -32,62 +32,159 @@ bool Fragment::operator!=(const Fragment &rhs) const {
 
 #pragma mark - AttributedString
 
+static std::shared_ptr<Fragments const> const &emptyFragments() {
+  static auto const fragments = std::shared_ptr<Fragments const>{
+      std::make_shared<Fragments>()};
+  return fragments;
+}
+
+AttributedString::AttributedString() : fragments_(emptyFragments()) {}
+
+AttributedString::AttributedString(const AttributedString &other)
+    : Sealable(other),
+      fragments_(other.fragments_),
+      hash_(other.hash_.load(std::memory_order_relaxed)) {}
+
+AttributedString::AttributedString(AttributedString &&other) noexcept
+    : Sealable(std::move(other)),
+      fragments_(std::move(other.fragments_)),
+      hash_(other.hash_.load(std::memory_order_relaxed)) {
+  other.fragments_ = emptyFragments();
+  other.hash_.store(0, std::memory_order_relaxed);
+}
+
+AttributedString &AttributedString::operator=(const AttributedString &other) {
+  Sealable::operator=(other);
+  fragments_ = other.fragments_;
+  hash_.store(
+      other.hash_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  return *this;
+}
+
+AttributedString &AttributedString::operator=(
+    AttributedString &&other) noexcept {
+  Sealable::operator=(std::move(other));
+  fragments_ = std::move(other.fragments_);
+  other.fragments_ = emptyFragments();
+  hash_.store(
+      other.hash_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  other.hash_.store(0, std::memory_order_relaxed);
+  return *this;
+}
+
 void AttributedString::appendFragment(const Fragment &fragment) {
   ensureUnsealed();
+  hash_.store(0, std::memory_order_relaxed);
 
   if (fragment.string.empty()) {
     return;
   }
 
-  fragments_.push_back(fragment);
+  editFragments().push_back(fragment);
 }
 
 void AttributedString::prependFragment(const Fragment &fragment) {
   ensureUnsealed();
+  hash_.store(0, std::memory_order_relaxed);
 
   if (fragment.string.empty()) {
     return;
   }
 
-  fragments_.insert(fragments_.begin(), fragment);
+  auto &fragments = editFragments();
+  fragments.insert(fragments.begin(), fragment);
 }
 
 void AttributedString::appendAttributedString(
     const AttributedString &attributedString) {
   ensureUnsealed();
-  fragments_.insert(
-      fragments_.end(),
-      attributedString.fragments_.begin(),
-      attributedString.fragments_.end());
+
+  if (fragments_->empty()) {
+    // Sharing the fragments instead of copying them.
+    fragments_ = attributedString.fragments_;
+    hash_.store(
+        attributedString.hash_.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    return;
+  }
+
+  hash_.store(0, std::memory_order_relaxed);
+  auto &fragments = editFragments();
+  fragments.insert(
+      fragments.end(),
+      attributedString.fragments_->begin(),
+      attributedString.fragments_->end());
 }
 
 void AttributedString::prependAttributedString(
     const AttributedString &attributedString) {
   ensureUnsealed();
-  fragments_.insert(
-      fragments_.begin(),
-      attributedString.fragments_.begin(),
-      attributedString.fragments_.end());
+
+  if (fragments_->empty()) {
+    fragments_ = attributedString.fragments_;
+    hash_.store(
+        attributedString.hash_.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    return;
+  }
+
+  hash_.store(0, std::memory_order_relaxed);
+  auto &fragments = editFragments();
+  fragments.insert(
+      fragments.begin(),
+      attributedString.fragments_->begin(),
+      attributedString.fragments_->end());
 }
 
 const Fragments &AttributedString::getFragments() const {
-  return fragments_;
+  return *fragments_;
+}
+
+Fragments &AttributedString::editFragments() {
+  if (fragments_.use_count() != 1) {
+    fragments_ = std::make_shared<Fragments>(*fragments_);
+  }
+
+  // The list is not shared, so it can be mutated.
+  return const_cast<Fragments &>(*fragments_);
 }
 
 std::string AttributedString::getString() const {
   auto string = std::string{};
-  for (const auto &fragment : fragments_) {
+  for (const auto &fragment : *fragments_) {
     string += fragment.string;
   }
   return string;
 }
 
 bool AttributedString::isEmpty() const {
-  return fragments_.empty();
+  return fragments_->empty();
+}
+
+size_t AttributedString::getHash() const {
+  auto hash = hash_.load(std::memory_order_relaxed);
+  if (hash != 0) {
+    return hash;
+  }
+
+  for (const auto &fragment : *fragments_) {
+    hash = folly::hash::hash_combine(hash, fragment);
+  }
+
+  // `0` is reserved for "not computed yet".
+  hash = hash != 0 ? hash : 1;
+  hash_.store(hash, std::memory_order_relaxed);
+  return hash;
 }
 
 bool AttributedString::operator==(const AttributedString &rhs) const {
-  return fragments_ == rhs.fragments_;
+  auto lhsHash = hash_.load(std::memory_order_relaxed);
+  auto rhsHash = rhs.hash_.load(std::memory_order_relaxed);
+  if (lhsHash != 0 && rhsHash != 0 && lhsHash != rhsHash) {
+    return false;
+  }
+
+  return fragments_ == rhs.fragments_ || *fragments_ == *rhs.fragments_;
 }
 
 bool AttributedString::operator!=(const AttributedString &rhs) const {
@@ -100,7 +197,7 @@ bool AttributedString::operator!=(const AttributedString &rhs) const {
 SharedDebugStringConvertibleList AttributedString::getDebugChildren() const {
   auto list = SharedDebugStringConvertibleList{};
 
-  for (auto &&fragment : fragments_) {
+  for (auto &&fragment : *fragments_) {
     auto propsList =
         fragment.textAttributes.DebugStringConvertible::getDebugProps();
 
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
 
@@ -30,6 +31,8 @@ using SharedAttributedString = std::shared_ptr<const AttributedString>;
  * (aka spanned string).
  * `AttributedString` is basically a list of `Fragments` which have `string` and
  * `textAttributes` + `shadowNode` associated with the `string`.
+ * The list is shared between copies of the string and copied on the first
+ * mutation, so copying and comparing copies is cheap.
  */
 class AttributedString : public Sealable, public DebugStringConvertible {
  public:
@@ -46,6 +49,12 @@ class AttributedString : public Sealable, public DebugStringConvertible {
 
   using Fragments = better::small_vector<Fragment, 1>;
 
+  AttributedString();
+  AttributedString(const AttributedString &other);
+  AttributedString(AttributedString &&other) noexcept;
+  AttributedString &operator=(const AttributedString &other);
+  AttributedString &operator=(AttributedString &&other) noexcept;
+
   /*
    * Appends and prepends a `fragment` to the string.
    */
@@ -74,6 +83,13 @@ class AttributedString : public Sealable, public DebugStringConvertible {
    */
   bool isEmpty() const;
 
+  /*
+   * Returns a hash of the content of the string (the same value as
+   * `std::hash<AttributedString>`), computed once and reused afterwards.
+   * Can be called from any thread.
+   */
+  size_t getHash() const;
+
   bool operator==(const AttributedString &rhs) const;
   bool operator!=(const AttributedString &rhs) const;
 
@@ -84,7 +100,21 @@ class AttributedString : public Sealable, public DebugStringConvertible {
 #endif
 
  private:
-  Fragments fragments_;
+  /*
+   * Returns the list of fragments for mutation, copying it first if it is
+   * shared with other strings.
+   */
+  Fragments &editFragments();
+
+  /*
+   * Never `nullptr`.
+   */
+  std::shared_ptr<Fragments const> fragments_;
+
+  /*
+   * Lazily computed `getHash()` value; `0` means "not computed yet".
+   */
+  mutable std::atomic<size_t> hash_{0};
 };
 
 } // namespace react
@@ -108,13 +138,7 @@ template <>
 struct hash<facebook::react::AttributedString> {
   size_t operator()(
       const facebook::react::AttributedString &attributedString) const {
-    auto seed = size_t{0};
-
-    for (const auto &fragment : attributedString.getFragments()) {
-      seed = folly::hash::hash_combine(seed, fragment);
-    }
-
-    return seed;
+    return attributedString.getHash();
   }
 };
 } // namespace std
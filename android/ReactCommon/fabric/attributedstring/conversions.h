@@ -480,7 +480,7 @@ inline folly::dynamic toDynamic(const TextAttributes &textAttributes) {
 inline folly::dynamic toDynamic(const AttributedString &attributedString) {
   auto value = folly::dynamic::object();
   auto fragments = folly::dynamic::array();
-  for (auto fragment : attributedString.getFragments()) {
+  for (auto const &fragment : attributedString.getFragments()) {
     folly::dynamic dynamicFragment = folly::dynamic::object();
     dynamicFragment["string"] = fragment.string;
     if (fragment.parentShadowView.componentHandle) {
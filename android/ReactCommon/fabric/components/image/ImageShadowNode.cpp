@@ -17,21 +17,39 @@ namespace react {
 
 const char ImageComponentName[] = "Image";
 
+/*
+ * Makes `size` and `scale` of the source describe the area the image is
+ * displayed in, so image loaders can decode it at that size.
+ */
+static ImageSource
+withDisplaySize(ImageSource imageSource, Size size, Float scale) {
+  imageSource.size = size;
+  imageSource.scale = scale;
+  return imageSource;
+}
+
 void ImageShadowNode::setImageManager(const SharedImageManager &imageManager) {
   ensureUnsealed();
   imageManager_ = imageManager;
 }
 
-void ImageShadowNode::updateLocalData() {
+void ImageShadowNode::updateLocalData(ImageRequestPriority priority) {
   const auto &imageSource = getImageSource();
   const auto &currentLocalData = getLocalData();
   if (currentLocalData) {
     assert(std::dynamic_pointer_cast<const ImageLocalData>(currentLocalData));
     auto currentImageLocalData =
         std::static_pointer_cast<const ImageLocalData>(currentLocalData);
-    if (currentImageLocalData->getImageSource() == imageSource) {
-      // Same `imageSource` is already in `localData`,
-      // no need to (re)request an image resource.
+    auto const &currentImageSource = currentImageLocalData->getImageSource();
+    auto currentDecodeSize = getImageDecodeSize(currentImageSource);
+    auto decodeSize = getImageDecodeSize(imageSource);
+    if (currentImageSource == imageSource &&
+        (currentDecodeSize.width == 0 ||
+         (currentDecodeSize.width >= decodeSize.width &&
+          currentDecodeSize.height >= decodeSize.height))) {
+      // Same `imageSource` is already in `localData` (decoded at a size which
+      // is large enough), no need to (re)request an image resource.
+      currentImageLocalData->getImageRequest().setPriority(priority);
       return;
     }
   }
@@ -39,7 +57,7 @@ void ImageShadowNode::updateLocalData() {
   // Now we are about to mutate the Shadow Node.
   ensureUnsealed();
 
-  auto imageRequest = imageManager_->requestImage(imageSource);
+  auto imageRequest = imageManager_->requestImage(imageSource, priority);
   auto imageLocalData =
       std::make_shared<ImageLocalData>(imageSource, std::move(imageRequest));
   setLocalData(imageLocalData);
@@ -54,13 +72,14 @@ ImageSource ImageShadowNode::getImageSource() const {
     };
   }
 
-  if (sources.size() == 1) {
-    return sources[0];
-  }
-
   auto layoutMetrics = getLayoutMetrics();
   auto size = layoutMetrics.getContentFrame().size;
   auto scale = layoutMetrics.pointScaleFactor;
+
+  if (sources.size() == 1) {
+    return withDisplaySize(sources[0], size, scale);
+  }
+
   auto targetImageArea = size.width * size.height * scale * scale;
   auto bestFit = std::numeric_limits<Float>::infinity();
 
@@ -80,13 +99,26 @@ ImageSource ImageShadowNode::getImageSource() const {
     }
   }
 
-  return bestSource;
+  return withDisplaySize(bestSource, size, scale);
+}
+
+ImageRequestPriority ImageShadowNode::getImageRequestPriority(
+    LayoutContext const &layoutContext) const {
+  if (!layoutContext.visibleRect) {
+    return ImageRequestPriority::High;
+  }
+
+  auto frame =
+      Rect{layoutContext.absolutePosition, getLayoutMetrics().frame.size};
+  return frame.intersects(*layoutContext.visibleRect)
+      ? ImageRequestPriority::High
+      : ImageRequestPriority::Low;
 }
 
 #pragma mark - LayoutableShadowNode
 
 void ImageShadowNode::layout(LayoutContext layoutContext) {
-  updateLocalData();
+  updateLocalData(getImageRequestPriority(layoutContext));
   ConcreteViewShadowNode::layout(layoutContext);
 }
 
@@ -39,9 +39,17 @@ class ImageShadowNode final : public ConcreteViewShadowNode<
 
  private:
   /*
-   * (Re)Creates a `LocalData` object (with `ImageRequest`) if needed.
+   * (Re)Creates a `LocalData` object (with `ImageRequest`) if needed;
+   * otherwise, updates the priority of the existing request.
    */
-  void updateLocalData();
+  void updateLocalData(ImageRequestPriority priority);
+
+  /*
+   * Returns `High` priority if the node is inside the visible area described
+   * by `layoutContext` (or the area is unknown).
+   */
+  ImageRequestPriority getImageRequestPriority(
+      LayoutContext const &layoutContext) const;
 
   ImageSource getImageSource() const;
 
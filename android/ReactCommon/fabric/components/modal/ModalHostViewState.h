@@ -32,6 +32,8 @@ class ModalHostViewState final {
   ModalHostViewState(folly::dynamic data)
       : screenSize(Size{(Float)data["screenWidth"].getDouble(),
                         (Float)data["screenHeight"].getDouble()}){};
+  ModalHostViewState(ModalHostViewState const &previous, Size screenSize_)
+      : screenSize(screenSize_){};
 #endif
 
   const Size screenSize{};
@@ -120,7 +120,16 @@ ScrollViewProps::ScrollViewProps(
       snapToAlignment(convertRawProp(
           rawProps,
           "snapToAlignment",
-          sourceProps.snapToAlignment)) {}
+          sourceProps.snapToAlignment)),
+      removeClippedSubviews(convertRawProp(
+          rawProps,
+          "removeClippedSubviews",
+          sourceProps.removeClippedSubviews)),
+      clippedSubviewsOverscan(convertRawProp(
+          rawProps,
+          "clippedSubviewsOverscan",
+          sourceProps.clippedSubviewsOverscan,
+          (Float)1.0)) {}
 
 #pragma mark - DebugStringConvertible
 
@@ -224,6 +233,14 @@ SharedDebugStringConvertibleList ScrollViewProps::getDebugProps() const {
               "snapToAlignment",
               snapToAlignment,
               defaultScrollViewProps.snapToAlignment),
+          debugStringConvertibleItem(
+              "removeClippedSubviews",
+              removeClippedSubviews,
+              defaultScrollViewProps.removeClippedSubviews),
+          debugStringConvertibleItem(
+              "clippedSubviewsOverscan",
+              clippedSubviewsOverscan,
+              defaultScrollViewProps.clippedSubviewsOverscan),
       };
 }
 #endif
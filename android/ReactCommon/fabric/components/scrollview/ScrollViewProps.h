@@ -46,6 +46,10 @@ class ScrollViewProps final : public ViewProps {
   const EdgeInsets scrollIndicatorInsets{};
   const int snapToInterval{};
   const ScrollViewSnapToAlignment snapToAlignment{};
+  // Children which are further than `clippedSubviewsOverscan` viewport lengths
+  // away from the viewport are not mounted (see `ScrollViewShadowNode`).
+  const bool removeClippedSubviews{};
+  const Float clippedSubviewsOverscan{1.0};
 
 #pragma mark - DebugStringConvertible
 
@@ -7,6 +7,8 @@
 
 #include "ScrollViewShadowNode.h"
 
+#include <algorithm>
+
 #include <react/core/LayoutMetrics.h>
 
 namespace facebook {
@@ -33,10 +35,40 @@ void ScrollViewShadowNode::updateStateIfNeeded() {
 #pragma mark - LayoutableShadowNode
 
 void ScrollViewShadowNode::layout(LayoutContext layoutContext) {
+  // The content is shifted by the content offset (see `getTransform()`) and
+  // is visible only inside the frame of the scroll view.
+  auto frame = Rect{layoutContext.absolutePosition,
+                    getLayoutMetrics().frame.size};
+  auto visibleRect = layoutContext.visibleRect.value_or(frame);
+  visibleRect.intersectInPlace(frame);
+
+  auto contentOffset = getStateData().contentOffset;
+  layoutContext.absolutePosition.x -= contentOffset.x;
+  layoutContext.absolutePosition.y -= contentOffset.y;
+  layoutContext.visibleRect = visibleRect;
+
   ConcreteViewShadowNode::layout(layoutContext);
   updateStateIfNeeded();
 }
 
+bool ScrollViewShadowNode::shouldMountChild(
+    LayoutMetrics const &childLayoutMetrics) const {
+  auto const &props = getProps();
+  if (!props->removeClippedSubviews) {
+    return true;
+  }
+
+  auto size = getLayoutMetrics().frame.size;
+  auto overscan = std::max(props->clippedSubviewsOverscan, Float{0});
+  auto window = Rect{getStateData().contentOffset, size};
+  window.origin.x -= size.width * overscan;
+  window.origin.y -= size.height * overscan;
+  window.size.width += 2 * size.width * overscan;
+  window.size.height += 2 * size.height * overscan;
+
+  return window.intersects(childLayoutMetrics.frame);
+}
+
 Transform ScrollViewShadowNode::getTransform() const {
   auto transform = ConcreteViewShadowNode::getTransform();
   auto contentOffset = getStateData().contentOffset;
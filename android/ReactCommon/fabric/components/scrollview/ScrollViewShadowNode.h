@@ -34,6 +34,13 @@ class ScrollViewShadowNode final : public ConcreteViewShadowNode<
   void layout(LayoutContext layoutContext) override;
   Transform getTransform() const override;
 
+  /*
+   * With `removeClippedSubviews`, only children within the overscan window
+   * around the current viewport (given by the content offset in the state)
+   * are mounted; others are mounted as they approach it.
+   */
+  bool shouldMountChild(LayoutMetrics const &childLayoutMetrics) const override;
+
  private:
   void updateStateIfNeeded();
 };
@@ -30,6 +30,9 @@ class ScrollViewState final {
 #ifdef ANDROID
   ScrollViewState() = default;
   ScrollViewState(folly::dynamic data){};
+  ScrollViewState(ScrollViewState const &previous, Point contentOffset)
+      : contentOffset(contentOffset),
+        contentBoundingRect(previous.contentBoundingRect){};
   folly::dynamic getDynamic() const {
     return {};
   };
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "ParagraphMeasurementCache.h"
+#include "ParagraphMeasurementPersistentCache.h"
 #include "ParagraphShadowNode.h"
 
 #include <folly/container/EvictingCacheMap.h>
@@ -36,6 +37,13 @@ class ParagraphComponentDescriptor final
     // a shared `EvictingCacheMap`, a simple LRU cache for Paragraph
     // measurements.
     measureCache_ = std::make_unique<ParagraphMeasurementCache>();
+    // The host application may provide a cache of measurements made during
+    // previous launches.
+    persistentMeasureCache_ =
+        contextContainer
+            ->find<ParagraphMeasurementPersistentCache::Shared>(
+                "ParagraphMeasurementPersistentCache")
+            .value_or(nullptr);
   }
 
  protected:
@@ -54,6 +62,7 @@ class ParagraphComponentDescriptor final
     // measurements.
     paragraphShadowNode->setMeasureCache(
         measureCache_ ? measureCache_.get() : nullptr);
+    paragraphShadowNode->setPersistentMeasureCache(persistentMeasureCache_);
 
     paragraphShadowNode->dirtyLayout();
 
@@ -65,6 +74,7 @@ class ParagraphComponentDescriptor final
  private:
   SharedTextLayoutManager textLayoutManager_;
   std::unique_ptr<ParagraphMeasurementCache const> measureCache_;
+  ParagraphMeasurementPersistentCache::Shared persistentMeasureCache_;
 };
 
 } // namespace react
@@ -15,6 +15,10 @@
 namespace facebook {
 namespace react {
 
+/*
+ * `AttributedString` caches its hash, so hashing a key and comparing keys that
+ * are not equal does not depend on the length of the text.
+ */
 using ParagraphMeasurementCacheKey =
     std::tuple<AttributedString, ParagraphAttributes, LayoutConstraints>;
 using ParagraphMeasurementCacheValue = Size;
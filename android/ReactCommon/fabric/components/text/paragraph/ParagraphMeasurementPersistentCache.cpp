@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "ParagraphMeasurementPersistentCache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+
+#include <folly/hash/Hash.h>
+
+namespace facebook {
+namespace react {
+
+static uint64_t const kMagic = 0x52434e5450434d31; // "RCNTPCM1"
+static uint64_t const kVersion = 1;
+
+/*
+ * Number of consecutive slots where an entry for a key can be stored.
+ */
+static size_t const kProbeCount = 8;
+
+struct ParagraphMeasurementPersistentCache::Header {
+  uint64_t magic;
+  uint64_t version;
+  uint64_t environment;
+  uint64_t capacity;
+};
+
+/*
+ * A slot with zero `key` is empty. `checksum` guards against entries which
+ * were only partially written when the process was terminated.
+ */
+struct ParagraphMeasurementPersistentCache::Entry {
+  uint64_t key;
+  uint64_t textHash;
+  float width;
+  float height;
+  uint64_t checksum;
+};
+
+ParagraphMeasurementPersistentCache::ParagraphMeasurementPersistentCache(
+    std::string const &path,
+    std::string const &environment,
+    size_t capacity) {
+  if (capacity == 0) {
+    return;
+  }
+
+  auto fileDescriptor = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+  if (fileDescriptor < 0) {
+    return;
+  }
+
+  auto const dataSize = sizeof(Header) + capacity * sizeof(Entry);
+
+  struct stat fileStat;
+  if (fstat(fileDescriptor, &fileStat) != 0 ||
+      static_cast<size_t>(fileStat.st_size) != dataSize) {
+    // Extending a file fills it with zeros, which represent empty slots.
+    if (ftruncate(fileDescriptor, 0) != 0 ||
+        ftruncate(fileDescriptor, dataSize) != 0) {
+      close(fileDescriptor);
+      return;
+    }
+  }
+
+  auto data = mmap(
+      nullptr,
+      dataSize,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED,
+      fileDescriptor,
+      0);
+  close(fileDescriptor);
+
+  if (data == MAP_FAILED) {
+    return;
+  }
+
+  data_ = data;
+  dataSize_ = dataSize;
+  capacity_ = capacity;
+
+  auto const environmentHash = folly::hash::fnv64(environment);
+  auto &header = *static_cast<Header *>(data_);
+  if (header.magic != kMagic || header.version != kVersion ||
+      header.environment != environmentHash || header.capacity != capacity) {
+    std::memset(getEntries(), 0, capacity * sizeof(Entry));
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.environment = environmentHash;
+    header.capacity = capacity;
+  }
+}
+
+ParagraphMeasurementPersistentCache::~ParagraphMeasurementPersistentCache() {
+  if (data_) {
+    munmap(data_, dataSize_);
+  }
+}
+
+better::optional<Size> ParagraphMeasurementPersistentCache::get(
+    ParagraphMeasurementCacheKey const &key) const {
+  if (!data_) {
+    return {};
+  }
+
+  auto const hash = persistentHash(key);
+  auto const textHash = persistentTextHash(key);
+  auto const entries = getEntries();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t probe = 0; probe < kProbeCount; probe++) {
+    auto const &entry = entries[(hash + probe) % capacity_];
+    if (entry.key == 0) {
+      break;
+    }
+
+    if (entry.key == hash && entry.textHash == textHash &&
+        entry.checksum == checksum(entry)) {
+      return Size{entry.width, entry.height};
+    }
+  }
+
+  return {};
+}
+
+void ParagraphMeasurementPersistentCache::set(
+    ParagraphMeasurementCacheKey const &key,
+    Size const &size) const {
+  if (!data_) {
+    return;
+  }
+
+  auto const hash = persistentHash(key);
+  auto const textHash = persistentTextHash(key);
+  auto const entries = getEntries();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto slot = &entries[hash % capacity_];
+  for (size_t probe = 0; probe < kProbeCount; probe++) {
+    auto &entry = entries[(hash + probe) % capacity_];
+    if (entry.key == 0 || (entry.key == hash && entry.textHash == textHash)) {
+      slot = &entry;
+      break;
+    }
+  }
+
+  slot->key = hash;
+  slot->textHash = textHash;
+  slot->width = static_cast<float>(size.width);
+  slot->height = static_cast<float>(size.height);
+  slot->checksum = checksum(*slot);
+}
+
+uint64_t ParagraphMeasurementPersistentCache::persistentHash(
+    ParagraphMeasurementCacheKey const &key) {
+  auto hash = uint64_t{0};
+  for (auto const &fragment : std::get<0>(key).getFragments()) {
+    hash = folly::hash::hash_combine(
+        hash, fragment.string, fragment.textAttributes);
+  }
+
+  hash = folly::hash::hash_combine(hash, std::get<1>(key), std::get<2>(key));
+
+  // Zero `key` marks an empty slot.
+  return hash == 0 ? 1 : hash;
+}
+
+uint64_t ParagraphMeasurementPersistentCache::persistentTextHash(
+    ParagraphMeasurementCacheKey const &key) {
+  auto hash = folly::hash::FNV_64_HASH_START;
+  for (auto const &fragment : std::get<0>(key).getFragments()) {
+    hash = folly::hash::fnv64(fragment.string, hash);
+  }
+  return hash;
+}
+
+uint64_t ParagraphMeasurementPersistentCache::checksum(Entry const &entry) {
+  return folly::hash::fnv64_buf(
+      &entry, offsetof(Entry, checksum), folly::hash::FNV_64_HASH_START);
+}
+
+ParagraphMeasurementPersistentCache::Entry *
+ParagraphMeasurementPersistentCache::getEntries() const {
+  return reinterpret_cast<Entry *>(static_cast<Header *>(data_) + 1);
+}
+
+} // namespace react
+} // namespace facebook
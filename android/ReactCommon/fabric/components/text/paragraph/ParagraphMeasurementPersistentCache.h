@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <better/optional.h>
+#include <react/components/text/ParagraphMeasurementCache.h>
+
+namespace facebook {
+namespace react {
+
+/*
+ * Persistent (surviving application restarts) storage of text measurements
+ * kept in a memory-mapped file.
+ * It is meant to be registered by the host application in `ContextContainer`
+ * (with "ParagraphMeasurementPersistentCache" key) before the first surface
+ * starts, so measurements of static content (tab labels, headers and so on)
+ * made during previous launches are reused during the first layout.
+ *
+ * Because the results of text measurement depend on things which are not
+ * part of a `ParagraphMeasurementCacheKey` (fonts, locale, font scale), the
+ * host must pass an `environment` string describing all of them; the content
+ * of the file is discarded when the environment changes.
+ * The environment should also describe the application build because keys
+ * are hashes which are not guaranteed to be stable between different builds.
+ *
+ * A storage that cannot be opened or mapped silently stores nothing.
+ */
+class ParagraphMeasurementPersistentCache final {
+ public:
+  using Shared = std::shared_ptr<ParagraphMeasurementPersistentCache const>;
+
+  ParagraphMeasurementPersistentCache(
+      std::string const &path,
+      std::string const &environment,
+      size_t capacity = 4096);
+  ~ParagraphMeasurementPersistentCache();
+
+  ParagraphMeasurementPersistentCache(
+      ParagraphMeasurementPersistentCache const &) = delete;
+  ParagraphMeasurementPersistentCache &operator=(
+      ParagraphMeasurementPersistentCache const &) = delete;
+
+  /*
+   * Returns a previously stored measurement for `key` or empty optional.
+   * Can be called from any thread.
+   */
+  better::optional<Size> get(ParagraphMeasurementCacheKey const &key) const;
+
+  /*
+   * Stores a measurement for `key`, replacing some other measurement if
+   * the slots where `key` can be stored are all used.
+   * Can be called from any thread.
+   */
+  void set(ParagraphMeasurementCacheKey const &key, Size const &size) const;
+
+ private:
+  struct Header;
+  struct Entry;
+
+  /*
+   * Hashes of `key` which do not depend on memory addresses (which
+   * `std::hash<AttributedString>` does depend on), so they are the same in
+   * different processes.
+   */
+  static uint64_t persistentHash(ParagraphMeasurementCacheKey const &key);
+  static uint64_t persistentTextHash(ParagraphMeasurementCacheKey const &key);
+
+  static uint64_t checksum(Entry const &entry);
+
+  Entry *getEntries() const;
+
+  mutable std::mutex mutex_;
+  void *data_{nullptr};
+  size_t dataSize_{0};
+  size_t capacity_{0};
+};
+
+} // namespace react
+} // namespace facebook
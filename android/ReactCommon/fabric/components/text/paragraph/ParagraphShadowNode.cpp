@@ -14,13 +14,17 @@ namespace react {
 
 char const ParagraphComponentName[] = "Paragraph";
 
-AttributedString ParagraphShadowNode::getAttributedString() const {
+AttributedString const &ParagraphShadowNode::getAttributedString() const {
   if (!cachedAttributedString_.has_value()) {
     auto textAttributes = TextAttributes::defaultTextAttributes();
     textAttributes.apply(getProps()->textAttributes);
 
     cachedAttributedString_ = BaseTextShadowNode::getAttributedString(
         textAttributes, shared_from_this());
+
+    // Computing the hash once here makes all copies of the string (in the
+    // state and in measurement cache keys) cheap to hash and compare.
+    cachedAttributedString_->getHash();
   }
 
   return cachedAttributedString_.value();
@@ -38,10 +42,16 @@ void ParagraphShadowNode::setMeasureCache(
   measureCache_ = cache;
 }
 
+void ParagraphShadowNode::setPersistentMeasureCache(
+    ParagraphMeasurementPersistentCache::Shared const &persistentCache) {
+  ensureUnsealed();
+  persistentMeasureCache_ = persistentCache;
+}
+
 void ParagraphShadowNode::updateStateIfNeeded() {
   ensureUnsealed();
 
-  auto attributedString = getAttributedString();
+  auto const &attributedString = getAttributedString();
   auto const &state = getStateData();
   if (state.attributedString == attributedString) {
     return;
@@ -53,7 +63,7 @@ void ParagraphShadowNode::updateStateIfNeeded() {
 #pragma mark - LayoutableShadowNode
 
 Size ParagraphShadowNode::measure(LayoutConstraints layoutConstraints) const {
-  AttributedString attributedString = getAttributedString();
+  auto const &attributedString = getAttributedString();
 
   if (attributedString.isEmpty()) {
     return {0, 0};
@@ -68,8 +78,21 @@ Size ParagraphShadowNode::measure(LayoutConstraints layoutConstraints) const {
       ParagraphMeasurementCacheKey{
           attributedString, paragraphAttributes, layoutConstraints},
       [&](ParagraphMeasurementCacheKey const &key) {
-        return textLayoutManager_->measure(
+        if (persistentMeasureCache_) {
+          auto persistentSize = persistentMeasureCache_->get(key);
+          if (persistentSize) {
+            return *persistentSize;
+          }
+        }
+
+        auto size = textLayoutManager_->measure(
             attributedString, paragraphAttributes, layoutConstraints);
+
+        if (persistentMeasureCache_) {
+          persistentMeasureCache_->set(key, size);
+        }
+
+        return size;
       });
 
   return textLayoutManager_->measure(
@@ -9,6 +9,7 @@
 
 #include <folly/Optional.h>
 #include <react/components/text/ParagraphMeasurementCache.h>
+#include <react/components/text/ParagraphMeasurementPersistentCache.h>
 #include <react/components/text/ParagraphProps.h>
 #include <react/components/text/ParagraphState.h>
 #include <react/components/text/TextShadowNode.h>
@@ -42,7 +43,7 @@ class ParagraphShadowNode : public ConcreteViewShadowNode<
   /*
    * Returns a `AttributedString` which represents text content of the node.
    */
-  AttributedString getAttributedString() const;
+  AttributedString const &getAttributedString() const;
 
   /*
    * Associates a shared TextLayoutManager with the node.
@@ -60,6 +61,13 @@ class ParagraphShadowNode : public ConcreteViewShadowNode<
    */
   void setMeasureCache(ParagraphMeasurementCache const *cache);
 
+  /*
+   * Associates an optional persistent cache of measurements with the node.
+   * It is consulted when a measurement is not found in the LRU cache.
+   */
+  void setPersistentMeasureCache(
+      ParagraphMeasurementPersistentCache::Shared const &persistentCache);
+
 #pragma mark - LayoutableShadowNode
 
   void layout(LayoutContext layoutContext) override;
@@ -74,6 +82,7 @@ class ParagraphShadowNode : public ConcreteViewShadowNode<
 
   SharedTextLayoutManager textLayoutManager_;
   ParagraphMeasurementCache const *measureCache_;
+  ParagraphMeasurementPersistentCache::Shared persistentMeasureCache_;
 
   /*
    * Cached attributed string that represents the content of the subtree started
@@ -7,6 +7,9 @@
 
 #include "TouchEventEmitter.h"
 
+#include <utility>
+#include <vector>
+
 namespace facebook {
 namespace react {
 
@@ -27,27 +30,59 @@ static jsi::Value touchPayload(jsi::Runtime &runtime, Touch const &touch) {
   return object;
 }
 
-static jsi::Value touchesPayload(
-    jsi::Runtime &runtime,
-    Touches const &touches) {
-  auto array = jsi::Array(runtime, touches.size());
-  int i = 0;
-  for (auto const &touch : touches) {
-    array.setValueAtIndex(runtime, i++, touchPayload(runtime, touch));
-  }
-  return array;
+static bool isSameTouch(Touch const &lhs, Touch const &rhs) {
+  return lhs.identifier == rhs.identifier && lhs.target == rhs.target &&
+      lhs.pagePoint == rhs.pagePoint && lhs.offsetPoint == rhs.offsetPoint &&
+      lhs.screenPoint == rhs.screenPoint && lhs.force == rhs.force &&
+      lhs.timestamp == rhs.timestamp;
 }
 
+/*
+ * Builds JavaScript objects for the touches of a single event.
+ * The same touch usually appears in several lists of the event (e.g. in
+ * `touches`, `changedTouches` and `targetTouches` of a `touchMove`); its object
+ * is built once and shared between the lists, as it is in the DOM.
+ */
+class TouchesPayloadBuilder {
+ public:
+  TouchesPayloadBuilder(jsi::Runtime &runtime) : runtime_(runtime) {}
+
+  jsi::Value touchesPayload(Touches const &touches) {
+    auto array = jsi::Array(runtime_, touches.size());
+    int i = 0;
+    for (auto const &touch : touches) {
+      array.setValueAtIndex(runtime_, i++, getTouchPayload(touch));
+    }
+    return array;
+  }
+
+ private:
+  jsi::Value getTouchPayload(Touch const &touch) {
+    for (auto const &entry : touchObjects_) {
+      if (isSameTouch(entry.first, touch)) {
+        return jsi::Value(runtime_, entry.second);
+      }
+    }
+
+    auto object = touchPayload(runtime_, touch).getObject(runtime_);
+    touchObjects_.emplace_back(touch, jsi::Value(runtime_, object));
+    return jsi::Value(std::move(object));
+  }
+
+  jsi::Runtime &runtime_;
+  std::vector<std::pair<Touch, jsi::Value>> touchObjects_;
+};
+
 static jsi::Value touchEventPayload(
     jsi::Runtime &runtime,
     TouchEvent const &event) {
+  auto builder = TouchesPayloadBuilder{runtime};
   auto object = jsi::Object(runtime);
+  object.setProperty(runtime, "touches", builder.touchesPayload(event.touches));
   object.setProperty(
-      runtime, "touches", touchesPayload(runtime, event.touches));
-  object.setProperty(
-      runtime, "changedTouches", touchesPayload(runtime, event.changedTouches));
+      runtime, "changedTouches", builder.touchesPayload(event.changedTouches));
   object.setProperty(
-      runtime, "targetTouches", touchesPayload(runtime, event.targetTouches));
+      runtime, "targetTouches", builder.touchesPayload(event.targetTouches));
   return object;
 }
 
@@ -68,7 +103,12 @@ void TouchEventEmitter::onTouchStart(TouchEvent const &event) const {
 }
 
 void TouchEventEmitter::onTouchMove(TouchEvent const &event) const {
-  dispatchTouchEvent("touchMove", event, EventPriority::SynchronousBatched);
+  dispatchUniqueEvent(
+      "touchMove",
+      [event](jsi::Runtime &runtime) {
+        return touchEventPayload(runtime, event);
+      },
+      EventPriority::SynchronousBatched);
 }
 
 void TouchEventEmitter::onTouchEnd(TouchEvent const &event) const {
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "TouchEventFilter.h"
+
+#include <cmath>
+
+namespace facebook {
+namespace react {
+
+/*
+ * How fast the velocity follows the moves: each move's own velocity gets
+ * weighted by `1 - exp(-dt / kVelocityTimeConstant)`, so a burst of moves
+ * within a couple of milliseconds doesn't make it jump.
+ */
+static Float const kVelocityTimeConstant = 0.05;
+
+TouchEventFilter::TouchEventFilter(Float slop) : slop_(slop) {}
+
+void TouchEventFilter::touchStarted(
+    Touch const &touch,
+    TouchEventTypes types) {
+  touches_[touch.identifier] = TouchState{
+      /* .types = */ types,
+      /* .startPoint = */ touch.pagePoint,
+      /* .lastPoint = */ touch.pagePoint,
+      /* .lastTimestamp = */ touch.timestamp,
+      /* .velocity = */ {},
+      /* .hasLeftSlop = */ slop_ <= 0,
+  };
+}
+
+bool TouchEventFilter::touchMoved(TouchEvent const &event) {
+  auto shouldDispatch = false;
+  for (auto const &touch : event.changedTouches) {
+    auto iterator = touches_.find(touch.identifier);
+    if (iterator == touches_.end()) {
+      shouldDispatch = true;
+      continue;
+    }
+    auto &state = iterator->second;
+
+    auto const dt = touch.timestamp - state.lastTimestamp;
+    if (dt > 0) {
+      auto const weight = 1 - std::exp(-dt / kVelocityTimeConstant);
+      auto const delta = touch.pagePoint - state.lastPoint;
+      state.velocity.x += (delta.x / dt - state.velocity.x) * weight;
+      state.velocity.y += (delta.y / dt - state.velocity.y) * weight;
+      state.lastTimestamp = touch.timestamp;
+    }
+    state.lastPoint = touch.pagePoint;
+
+    if (!state.hasLeftSlop) {
+      auto const distance = touch.pagePoint - state.startPoint;
+      state.hasLeftSlop =
+          distance.x * distance.x + distance.y * distance.y > slop_ * slop_;
+    }
+
+    if (state.hasLeftSlop &&
+        (state.types & TouchEventTypes::Move) == TouchEventTypes::Move) {
+      shouldDispatch = true;
+    }
+  }
+  return shouldDispatch;
+}
+
+void TouchEventFilter::touchEnded(Touch const &touch) {
+  touches_.erase(touch.identifier);
+}
+
+Point TouchEventFilter::getVelocity(int identifier) const {
+  auto iterator = touches_.find(identifier);
+  if (iterator == touches_.end()) {
+    return {};
+  }
+  return iterator->second.velocity;
+}
+
+} // namespace react
+} // namespace facebook
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <unordered_map>
+
+#include <react/components/view/TouchEvent.h>
+#include <react/components/view/primitives.h>
+#include <react/graphics/Geometry.h>
+
+namespace facebook {
+namespace react {
+
+/*
+ * Decides natively which touch moves are worth dispatching to JS, which is
+ * otherwise woken up by every move of every touch (at up to 120 Hz):
+ *  - Moves are only dispatched for touches which started on views where JS
+ *    handles them (the types passed to `touchStarted`, usually the ones of the
+ *    target and all of its ancestors, see `ViewProps::getTouchEventTypes()`).
+ *  - Moves within `slop` points of where a touch started are dropped until the
+ *    touch leaves that circle for the first time.
+ * The velocity of every touch is tracked, whether its moves are dispatched or
+ * not. Moves which are dispatched are still coalesced until JS gets to them
+ * (see `TouchEventEmitter::onTouchMove`).
+ * Not thread-safe: it's used on the thread which receives the touches.
+ */
+class TouchEventFilter final {
+ public:
+  TouchEventFilter(Float slop = 0);
+
+  /*
+   * At the `touchStart` of `touch`, with the types of the events JS handles
+   * for it.
+   */
+  void touchStarted(Touch const &touch, TouchEventTypes types);
+
+  /*
+   * At a `touchMove`, returns whether it should be dispatched: whether any of
+   * its changed touches is handled and has left the slop. Touches which didn't
+   * start through `touchStarted` are always dispatched.
+   */
+  bool touchMoved(TouchEvent const &event);
+
+  /*
+   * At the `touchEnd` or `touchCancel` of `touch`.
+   */
+  void touchEnded(Touch const &touch);
+
+  /*
+   * The velocity of the touch with `identifier` in points per second, a zero
+   * vector if it isn't known (or has ended already).
+   */
+  Point getVelocity(int identifier) const;
+
+ private:
+  struct TouchState {
+    TouchEventTypes types;
+    Point startPoint;
+    Point lastPoint;
+    Float lastTimestamp;
+    Point velocity{};
+    bool hasLeftSlop;
+  };
+
+  Float const slop_;
+  std::unordered_map<int, TouchState> touches_;
+};
+
+} // namespace react
+} // namespace facebook
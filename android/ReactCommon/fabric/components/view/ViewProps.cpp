@@ -71,6 +71,20 @@ ViewProps::ViewProps(ViewProps const &sourceProps, RawProps const &rawProps)
           convertRawProp(rawProps, "pointerEvents", sourceProps.pointerEvents)),
       hitSlop(convertRawProp(rawProps, "hitSlop", sourceProps.hitSlop)),
       onLayout(convertRawProp(rawProps, "onLayout", sourceProps.onLayout)),
+      onTouchMove(
+          convertRawProp(rawProps, "onTouchMove", sourceProps.onTouchMove)),
+      onMoveShouldSetResponder(convertRawProp(
+          rawProps,
+          "onMoveShouldSetResponder",
+          sourceProps.onMoveShouldSetResponder)),
+      onMoveShouldSetResponderCapture(convertRawProp(
+          rawProps,
+          "onMoveShouldSetResponderCapture",
+          sourceProps.onMoveShouldSetResponderCapture)),
+      onResponderMove(convertRawProp(
+          rawProps,
+          "onResponderMove",
+          sourceProps.onResponderMove)),
       collapsable(convertRawProp(
           rawProps,
           "collapsable",
@@ -150,6 +164,16 @@ bool ViewProps::getClipsContentToBounds() const {
   return yogaStyle.overflow() != YGOverflowVisible;
 }
 
+TouchEventTypes ViewProps::getTouchEventTypes() const {
+  auto types =
+      TouchEventTypes::Start | TouchEventTypes::End | TouchEventTypes::Cancel;
+  if (onTouchMove || onMoveShouldSetResponder ||
+      onMoveShouldSetResponderCapture || onResponderMove) {
+    types = types | TouchEventTypes::Move;
+  }
+  return types;
+}
+
 #ifdef ANDROID
 bool ViewProps::getProbablyMoreHorizontalThanVertical_DEPRECATED() const {
   return yogaStyle.flexDirection() == YGFlexDirectionRow;
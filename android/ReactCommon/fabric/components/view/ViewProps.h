@@ -59,6 +59,11 @@ class ViewProps : public Props,
   PointerEventsMode const pointerEvents{};
   EdgeInsets const hitSlop{};
   bool const onLayout{};
+  // Handlers which need moves, from JS and the responder system.
+  bool const onTouchMove{};
+  bool const onMoveShouldSetResponder{};
+  bool const onMoveShouldSetResponderCapture{};
+  bool const onResponderMove{};
 
   bool const collapsable{true};
 
@@ -67,6 +72,12 @@ class ViewProps : public Props,
   BorderMetrics resolveBorderMetrics(LayoutMetrics const &layoutMetrics) const;
   bool getClipsContentToBounds() const;
 
+  /*
+   * The touch events JS handles on this view. Starts, ends and cancels are
+   * always handled (e.g. the responder system keeps track of all touches).
+   */
+  TouchEventTypes getTouchEventTypes() const;
+
 #ifdef ANDROID
   bool getProbablyMoreHorizontalThanVertical_DEPRECATED() const;
 #endif
@@ -15,23 +15,34 @@
 namespace facebook {
 namespace react {
 
+static PropsGroup<AccessibilityStringProps> convertRawProps(
+    RawProps const &rawProps,
+    PropsGroup<AccessibilityStringProps> const &sourceGroup) {
+  auto group = sourceGroup;
+  setRawProp(
+      rawProps,
+      "accessibilityLabel",
+      group,
+      &AccessibilityStringProps::accessibilityLabel);
+  setRawProp(
+      rawProps,
+      "accessibilityHint",
+      group,
+      &AccessibilityStringProps::accessibilityHint);
+  setRawProp(
+      rawProps,
+      "accessibilityActions",
+      group,
+      &AccessibilityStringProps::accessibilityActions);
+  setRawProp(rawProps, "testId", group, &AccessibilityStringProps::testId);
+  return group;
+}
+
 AccessibilityProps::AccessibilityProps(
     AccessibilityProps const &sourceProps,
     RawProps const &rawProps)
     : accessible(
           convertRawProp(rawProps, "accessible", sourceProps.accessible)),
-      accessibilityLabel(convertRawProp(
-          rawProps,
-          "accessibilityLabel",
-          sourceProps.accessibilityLabel)),
-      accessibilityHint(convertRawProp(
-          rawProps,
-          "accessibilityHint",
-          sourceProps.accessibilityHint)),
-      accessibilityActions(convertRawProp(
-          rawProps,
-          "accessibilityActions",
-          sourceProps.accessibilityActions)),
       accessibilityViewIsModal(convertRawProp(
           rawProps,
           "accessibilityViewIsModal",
@@ -44,7 +55,8 @@ AccessibilityProps::AccessibilityProps(
           rawProps,
           "accessibilityIgnoresInvertColors",
           sourceProps.accessibilityIgnoresInvertColors)),
-      testId(convertRawProp(rawProps, "testId", sourceProps.testId)) {}
+      accessibilityStrings(
+          convertRawProps(rawProps, sourceProps.accessibilityStrings)) {}
 
 #pragma mark - DebugStringConvertible
 
@@ -52,7 +64,10 @@ AccessibilityProps::AccessibilityProps(
 SharedDebugStringConvertibleList AccessibilityProps::getDebugProps() const {
   auto const &defaultProps = AccessibilityProps();
   return SharedDebugStringConvertibleList{
-      debugStringConvertibleItem("testId", testId, defaultProps.testId),
+      debugStringConvertibleItem(
+          "testId",
+          accessibilityStrings->testId,
+          defaultProps.accessibilityStrings->testId),
   };
 }
 #endif // RN_DEBUG_STRING_CONVERTIBLE
@@ -9,12 +9,31 @@
 
 #include <react/components/view/AccessibilityPrimitives.h>
 #include <react/core/Props.h>
+#include <react/core/PropsGroup.h>
 #include <react/core/ReactPrimitives.h>
 #include <react/debug/DebugStringConvertible.h>
 
 namespace facebook {
 namespace react {
 
+/*
+ * Accessibility props that own heap memory. They rarely change, so they are
+ * kept in a `PropsGroup` shared between props objects.
+ */
+struct AccessibilityStringProps {
+  std::string accessibilityLabel{""};
+  std::string accessibilityHint{""};
+  std::vector<std::string> accessibilityActions{};
+  std::string testId{""};
+
+  bool operator==(AccessibilityStringProps const &rhs) const {
+    return accessibilityLabel == rhs.accessibilityLabel &&
+        accessibilityHint == rhs.accessibilityHint &&
+        accessibilityActions == rhs.accessibilityActions &&
+        testId == rhs.testId;
+  }
+};
+
 class AccessibilityProps {
  public:
   AccessibilityProps() = default;
@@ -26,13 +45,32 @@ class AccessibilityProps {
 
   bool const accessible{false};
   AccessibilityTraits const accessibilityTraits{AccessibilityTraits::None};
-  std::string const accessibilityLabel{""};
-  std::string const accessibilityHint{""};
-  std::vector<std::string> const accessibilityActions{};
   bool const accessibilityViewIsModal{false};
   bool const accessibilityElementsHidden{false};
   bool const accessibilityIgnoresInvertColors{false};
-  std::string const testId{""};
+  PropsGroup<AccessibilityStringProps> const accessibilityStrings{};
+
+#pragma mark - Accessors
+
+  /*
+   * The props of `accessibilityStrings`, under the names they had before they
+   * were grouped.
+   */
+  std::string const &accessibilityLabel() const {
+    return accessibilityStrings->accessibilityLabel;
+  }
+
+  std::string const &accessibilityHint() const {
+    return accessibilityStrings->accessibilityHint;
+  }
+
+  std::vector<std::string> const &accessibilityActions() const {
+    return accessibilityStrings->accessibilityActions;
+  }
+
+  std::string const &testId() const {
+    return accessibilityStrings->testId;
+  }
 
 #pragma mark - DebugStringConvertible
 
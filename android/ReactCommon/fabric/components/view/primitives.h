@@ -22,6 +22,29 @@ enum class BackfaceVisibility { Auto, Visible, Hidden };
 
 enum class BorderStyle { Solid, Dotted, Dashed };
 
+/*
+ * Kinds of touch events, as flags (e.g. the ones JS handles for a view).
+ */
+enum class TouchEventTypes : uint32_t {
+  None = 0,
+  Start = (1 << 0),
+  Move = (1 << 1),
+  End = (1 << 2),
+  Cancel = (1 << 3),
+};
+
+constexpr TouchEventTypes operator|(
+    TouchEventTypes const lhs,
+    TouchEventTypes const rhs) {
+  return (TouchEventTypes)((uint32_t)lhs | (uint32_t)rhs);
+}
+
+constexpr TouchEventTypes operator&(
+    TouchEventTypes const lhs,
+    TouchEventTypes const rhs) {
+  return (TouchEventTypes)((uint32_t)lhs & (uint32_t)rhs);
+}
+
 template <typename T>
 struct CascadedRectangleEdges {
   using Counterpart = RectangleEdges<T>;
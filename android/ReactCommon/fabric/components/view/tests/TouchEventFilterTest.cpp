@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/dynamic.h>
+#include <gtest/gtest.h>
+#include <react/components/view/TouchEventFilter.h>
+#include <react/components/view/ViewComponentDescriptor.h>
+#include <react/core/EventDispatcher.h>
+#include <react/core/RawProps.h>
+#include <react/utils/ContextContainer.h>
+
+using namespace facebook::react;
+
+static Touch makeTouch(int identifier, Point pagePoint, Float timestamp) {
+  auto touch = Touch{};
+  touch.identifier = identifier;
+  touch.pagePoint = pagePoint;
+  touch.timestamp = timestamp;
+  return touch;
+}
+
+static TouchEvent makeMove(Touch const &touch) {
+  auto event = TouchEvent{};
+  event.touches.insert(touch);
+  event.changedTouches.insert(touch);
+  return event;
+}
+
+static auto const allTypes = TouchEventTypes::Start | TouchEventTypes::Move |
+    TouchEventTypes::End | TouchEventTypes::Cancel;
+static auto const typesWithoutMove =
+    TouchEventTypes::Start | TouchEventTypes::End | TouchEventTypes::Cancel;
+
+TEST(TouchEventFilterTest, testMovesOnlyDispatchedWhenHandled) {
+  auto filter = TouchEventFilter{};
+  filter.touchStarted(makeTouch(1, {0, 0}, 0), allTypes);
+  filter.touchStarted(makeTouch(2, {0, 0}, 0), typesWithoutMove);
+
+  EXPECT_TRUE(filter.touchMoved(makeMove(makeTouch(1, {5, 0}, 0.01))));
+  EXPECT_FALSE(filter.touchMoved(makeMove(makeTouch(2, {5, 0}, 0.01))));
+
+  auto event = makeMove(makeTouch(2, {10, 0}, 0.02));
+  event.changedTouches.insert(makeTouch(1, {10, 0}, 0.02));
+  EXPECT_TRUE(filter.touchMoved(event));
+
+  // Touches which weren't started through the filter aren't filtered.
+  EXPECT_TRUE(filter.touchMoved(makeMove(makeTouch(3, {5, 0}, 0.01))));
+  filter.touchEnded(makeTouch(2, {10, 0}, 0.03));
+  EXPECT_TRUE(filter.touchMoved(makeMove(makeTouch(2, {15, 0}, 0.04))));
+}
+
+TEST(TouchEventFilterTest, testMovesWithinSlopDropped) {
+  auto filter = TouchEventFilter{10};
+  filter.touchStarted(makeTouch(1, {100, 100}, 0), allTypes);
+
+  EXPECT_FALSE(filter.touchMoved(makeMove(makeTouch(1, {106, 106}, 0.01))));
+  EXPECT_TRUE(filter.touchMoved(makeMove(makeTouch(1, {108, 108}, 0.02))));
+  // Once it has left the slop, every move is dispatched.
+  EXPECT_TRUE(filter.touchMoved(makeMove(makeTouch(1, {100, 100}, 0.03))));
+}
+
+TEST(TouchEventFilterTest, testVelocity) {
+  auto filter = TouchEventFilter{};
+  filter.touchStarted(makeTouch(1, {0, 0}, 0), typesWithoutMove);
+  EXPECT_EQ(Point{}, filter.getVelocity(1));
+
+  for (auto i = 1; i <= 60; i++) {
+    filter.touchMoved(makeMove(makeTouch(1, {i * 10.0, 0}, i * 0.01)));
+  }
+  auto velocity = filter.getVelocity(1);
+  EXPECT_NEAR(1000, velocity.x, 1);
+  EXPECT_NEAR(0, velocity.y, 0.001);
+
+  filter.touchEnded(makeTouch(1, {600, 0}, 0.61));
+  EXPECT_EQ(Point{}, filter.getVelocity(1));
+}
+
+TEST(TouchEventFilterTest, testViewPropsTouchEventTypes) {
+  auto componentDescriptor = ViewComponentDescriptor{
+      std::shared_ptr<EventDispatcher>{nullptr},
+      std::make_shared<ContextContainer const>()};
+  auto props = componentDescriptor.cloneProps(nullptr, RawProps{});
+  EXPECT_EQ(
+      typesWithoutMove,
+      std::static_pointer_cast<ViewProps const>(props)->getTouchEventTypes());
+
+  for (auto name : {"onTouchMove",
+                    "onMoveShouldSetResponder",
+                    "onMoveShouldSetResponderCapture",
+                    "onResponderMove"}) {
+    auto handlerProps = componentDescriptor.cloneProps(
+        props, RawProps{folly::dynamic::object(name, true)});
+    EXPECT_EQ(
+        allTypes,
+        std::static_pointer_cast<ViewProps const>(handlerProps)
+            ->getTouchEventTypes());
+
+    auto removedHandlerProps = componentDescriptor.cloneProps(
+        handlerProps, RawProps{folly::dynamic::object(name, nullptr)});
+    EXPECT_EQ(
+        typesWithoutMove,
+        std::static_pointer_cast<ViewProps const>(removedHandlerProps)
+            ->getTouchEventTypes());
+  }
+}
@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <memory>
+
+#include <folly/dynamic.h>
+#include <gtest/gtest.h>
+#include <react/components/view/ViewComponentDescriptor.h>
+#include <react/core/EventDispatcher.h>
+#include <react/core/LayoutContext.h>
+#include <react/core/RawProps.h>
+#include <react/utils/ContextContainer.h>
+
+using namespace facebook::react;
+
+static auto const viewComponentDescriptor = ViewComponentDescriptor{
+    std::shared_ptr<EventDispatcher>{nullptr},
+    std::make_shared<ContextContainer const>()};
+
+static SharedProps makeProps(folly::dynamic const &rawProps) {
+  return viewComponentDescriptor.cloneProps(nullptr, RawProps{rawProps});
+}
+
+static ShadowNode::Shared makeView(
+    Tag tag,
+    SharedProps const &props,
+    SharedShadowNodeList const &children = {}) {
+  return viewComponentDescriptor.createShadowNode(ShadowNodeFragment{
+      /* .tag = */ tag,
+      /* .surfaceId = */ 1,
+      /* .props = */ props,
+      /* .eventEmitter = */
+      viewComponentDescriptor.createEventEmitter(nullptr, tag),
+      /* .children = */ std::make_shared<SharedShadowNodeList>(children),
+  });
+}
+
+static LayoutMetrics layoutMetricsOfChild(
+    ShadowNode const &shadowNode,
+    int index) {
+  return std::static_pointer_cast<ViewShadowNode const>(
+             shadowNode.getChildren().at(index))
+      ->getLayoutMetrics();
+}
+
+static void layoutAndSeal(ShadowNode::Shared const &shadowNode) {
+  auto layoutableShadowNode = const_cast<ViewShadowNode *>(
+      std::static_pointer_cast<ViewShadowNode const>(shadowNode).get());
+  layoutableShadowNode->layout(LayoutContext{});
+  shadowNode->sealRecursive();
+}
+
+TEST(YogaLayoutableShadowNodeTest, testLayoutLeavesSharedChildrenAlone) {
+  auto const rootProps = makeProps(
+      folly::dynamic::object("collapsable", false)("width", 100)(
+          "height", 100));
+  auto const leaf = makeView(3, makeProps(folly::dynamic::object("height", 20)));
+  auto const firstRevision = makeView(
+      1,
+      rootProps,
+      {makeView(2, makeProps(folly::dynamic::object("height", 10))), leaf});
+  layoutAndSeal(firstRevision);
+  EXPECT_EQ(layoutMetricsOfChild(*firstRevision, 1).frame.origin.y, 10);
+
+  // The second revision only changes the first child and shares the leaf.
+  auto const secondRevision = firstRevision->clone(ShadowNodeFragment{
+      /* .tag = */ ShadowNodeFragment::tagPlaceholder(),
+      /* .surfaceId = */ ShadowNodeFragment::surfaceIdPlaceholder(),
+      /* .props = */ ShadowNodeFragment::propsPlaceholder(),
+      /* .eventEmitter = */ ShadowNodeFragment::eventEmitterPlaceholder(),
+      /* .children = */
+      std::make_shared<SharedShadowNodeList>(SharedShadowNodeList{
+          makeView(2, makeProps(folly::dynamic::object("height", 30))),
+          leaf}),
+  });
+  // Laying it out must not touch the committed (sealed) first revision.
+  layoutAndSeal(secondRevision);
+
+  EXPECT_EQ(layoutMetricsOfChild(*secondRevision, 1).frame.origin.y, 30);
+  EXPECT_EQ(layoutMetricsOfChild(*firstRevision, 1).frame.origin.y, 10);
+  EXPECT_EQ(
+      std::static_pointer_cast<ViewShadowNode const>(leaf)
+          ->getLayoutMetrics()
+          .frame.origin.y,
+      10);
+}
+
+TEST(YogaLayoutableShadowNodeTest, testLayoutOfCloneLeavesSealedSourceAlone) {
+  auto const source = makeView(
+      1,
+      makeProps(
+          folly::dynamic::object("collapsable", false)("width", 100)(
+              "height", 100)),
+      {makeView(2, makeProps(folly::dynamic::object("height", 10))),
+       makeView(3, makeProps(folly::dynamic::object("height", 20)))});
+  // As the scheduler does before committing completed nodes on another thread.
+  source->sealRecursive();
+  auto const sourceLayoutMetrics = layoutMetricsOfChild(*source, 1);
+
+  auto const clone = viewComponentDescriptor.cloneShadowNode(*source, {});
+  layoutAndSeal(clone);
+
+  EXPECT_EQ(layoutMetricsOfChild(*clone, 1).frame.origin.y, 10);
+  EXPECT_EQ(layoutMetricsOfChild(*source, 1), sourceLayoutMetrics);
+  EXPECT_NE(clone->getChildren().at(1), source->getChildren().at(1));
+}
@@ -0,0 +1,547 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Layout benchmarks over trees recorded with `facebook::yoga::YGNodeToJson`.
+// Every snapshot passed on the command line gets three benchmarks: the first
+// layout of the whole tree, a relayout after one text leaf changed its size,
+// and a relayout after the width available to the root changed. Without any
+// snapshot a synthetic feed screen is used.
+//
+//   benchmarks [--benchmark_filter=...] snapshot.json...
+//
+// Nodes that got measured in the app replay the recorded size, wrapping like
+// text when they get less width than that. Measure callbacks, layouts and
+// cache hits are reported per iteration, which requires Yoga to be built with
+// YG_ENABLE_EVENTS.
+
+#include <benchmark/benchmark.h>
+#include <folly/FileUtil.h>
+#include <folly/dynamic.h>
+#include <folly/json.h>
+#include <yoga/Yoga.h>
+#include <yoga/event/event.h>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace facebook {
+namespace react {
+
+using yoga::Event;
+
+struct LayoutCounters {
+  double measureCallbacks = 0;
+  double layouts = 0;
+  double measures = 0;
+  double cacheHits = 0;
+};
+
+static LayoutCounters counters;
+
+static void subscribeToLayoutEvents() {
+  Event::subscribe([](YGNode const &, Event::Type type, Event::Data data) {
+    switch (type) {
+      case Event::MeasureCallbackEnd:
+        counters.measureCallbacks++;
+        break;
+      case Event::LayoutPassEnd: {
+        auto layoutData = data.get<Event::LayoutPassEnd>().layoutData;
+        counters.layouts += layoutData->layouts;
+        counters.measures += layoutData->measures;
+        counters.cacheHits +=
+            layoutData->cachedLayouts + layoutData->cachedMeasures;
+        break;
+      }
+      default:
+        break;
+    }
+  });
+}
+
+static void reportCounters(benchmark::State &state) {
+  auto perIteration = [](double value) {
+    return benchmark::Counter(value, benchmark::Counter::kAvgIterations);
+  };
+  state.counters["measureCallbacks"] = perIteration(counters.measureCallbacks);
+  state.counters["layouts"] = perIteration(counters.layouts);
+  state.counters["measures"] = perIteration(counters.measures);
+  state.counters["cacheHits"] = perIteration(counters.cacheHits);
+}
+
+#pragma mark - Snapshot loading
+
+template <typename T>
+static T enumFromString(const char *(*toString)(T), std::string const &name) {
+  for (auto i = 0; i < yoga::enums::count<T>(); i++) {
+    if (name == toString(static_cast<T>(i))) {
+      return static_cast<T>(i);
+    }
+  }
+  throw std::invalid_argument("Unknown Yoga value: " + name);
+}
+
+static float floatFromDynamic(folly::dynamic const &value) {
+  return value.isNull() ? YGUndefined : static_cast<float>(value.asDouble());
+}
+
+struct ValueSetters {
+  char const *name;
+  void (*point)(YGNodeRef, float);
+  void (*percent)(YGNodeRef, float);
+  void (*automatic)(YGNodeRef);
+};
+
+struct EdgeSetters {
+  char const *name;
+  void (*point)(YGNodeRef, YGEdge, float);
+  void (*percent)(YGNodeRef, YGEdge, float);
+  void (*automatic)(YGNodeRef, YGEdge);
+};
+
+static ValueSetters const valueSetters[] = {
+    {"flexBasis",
+     YGNodeStyleSetFlexBasis,
+     YGNodeStyleSetFlexBasisPercent,
+     YGNodeStyleSetFlexBasisAuto},
+    {"width",
+     YGNodeStyleSetWidth,
+     YGNodeStyleSetWidthPercent,
+     YGNodeStyleSetWidthAuto},
+    {"height",
+     YGNodeStyleSetHeight,
+     YGNodeStyleSetHeightPercent,
+     YGNodeStyleSetHeightAuto},
+    {"minWidth", YGNodeStyleSetMinWidth, YGNodeStyleSetMinWidthPercent},
+    {"minHeight", YGNodeStyleSetMinHeight, YGNodeStyleSetMinHeightPercent},
+    {"maxWidth", YGNodeStyleSetMaxWidth, YGNodeStyleSetMaxWidthPercent},
+    {"maxHeight", YGNodeStyleSetMaxHeight, YGNodeStyleSetMaxHeightPercent},
+};
+
+static EdgeSetters const edgeSetters[] = {
+    {"margin",
+     YGNodeStyleSetMargin,
+     YGNodeStyleSetMarginPercent,
+     YGNodeStyleSetMarginAuto},
+    {"position", YGNodeStyleSetPosition, YGNodeStyleSetPositionPercent},
+    {"padding", YGNodeStyleSetPadding, YGNodeStyleSetPaddingPercent},
+    {"border", YGNodeStyleSetBorder},
+};
+
+static YGValue valueFromDynamic(
+    std::string const &name,
+    folly::dynamic const &value) {
+  if (!value.isString()) {
+    auto number = floatFromDynamic(value);
+    return {number, YGFloatIsUndefined(number) ? YGUnitUndefined : YGUnitPoint};
+  }
+  auto string = value.getString();
+  if (string == "auto") {
+    return {YGUndefined, YGUnitAuto};
+  }
+  if (!string.empty() && string.back() == '%') {
+    return {std::stof(string), YGUnitPercent};
+  }
+  throw std::invalid_argument("Unsupported value for " + name + ": " + string);
+}
+
+static void unsupportedUnit(std::string const &name) {
+  throw std::invalid_argument("Unsupported unit for " + name);
+}
+
+static void applyValue(
+    YGNodeRef node,
+    ValueSetters const &setters,
+    YGValue value) {
+  if (value.unit == YGUnitPercent && setters.percent) {
+    setters.percent(node, value.value);
+  } else if (value.unit == YGUnitAuto && setters.automatic) {
+    setters.automatic(node);
+  } else if (value.unit == YGUnitPoint || value.unit == YGUnitUndefined) {
+    setters.point(node, value.value);
+  } else {
+    unsupportedUnit(setters.name);
+  }
+}
+
+static void applyValue(
+    YGNodeRef node,
+    EdgeSetters const &setters,
+    YGEdge edge,
+    YGValue value) {
+  if (value.unit == YGUnitPercent && setters.percent) {
+    setters.percent(node, edge, value.value);
+  } else if (value.unit == YGUnitAuto && setters.automatic) {
+    setters.automatic(node, edge);
+  } else if (value.unit == YGUnitPoint || value.unit == YGUnitUndefined) {
+    setters.point(node, edge, value.value);
+  } else {
+    unsupportedUnit(setters.name);
+  }
+}
+
+static void applyStyle(YGNodeRef node, folly::dynamic const &style) {
+  for (auto const &item : style.items()) {
+    auto const &name = item.first.getString();
+    auto const &value = item.second;
+
+    if (name == "direction") {
+      YGNodeStyleSetDirection(
+          node, enumFromString(YGDirectionToString, value.getString()));
+    } else if (name == "flexDirection") {
+      YGNodeStyleSetFlexDirection(
+          node, enumFromString(YGFlexDirectionToString, value.getString()));
+    } else if (name == "justifyContent") {
+      YGNodeStyleSetJustifyContent(
+          node, enumFromString(YGJustifyToString, value.getString()));
+    } else if (name == "alignContent") {
+      YGNodeStyleSetAlignContent(
+          node, enumFromString(YGAlignToString, value.getString()));
+    } else if (name == "alignItems") {
+      YGNodeStyleSetAlignItems(
+          node, enumFromString(YGAlignToString, value.getString()));
+    } else if (name == "alignSelf") {
+      YGNodeStyleSetAlignSelf(
+          node, enumFromString(YGAlignToString, value.getString()));
+    } else if (name == "positionType") {
+      YGNodeStyleSetPositionType(
+          node, enumFromString(YGPositionTypeToString, value.getString()));
+    } else if (name == "flexWrap") {
+      YGNodeStyleSetFlexWrap(
+          node, enumFromString(YGWrapToString, value.getString()));
+    } else if (name == "overflow") {
+      YGNodeStyleSetOverflow(
+          node, enumFromString(YGOverflowToString, value.getString()));
+    } else if (name == "display") {
+      YGNodeStyleSetDisplay(
+          node, enumFromString(YGDisplayToString, value.getString()));
+    } else if (name == "flex") {
+      YGNodeStyleSetFlex(node, floatFromDynamic(value));
+    } else if (name == "flexGrow") {
+      YGNodeStyleSetFlexGrow(node, floatFromDynamic(value));
+    } else if (name == "flexShrink") {
+      YGNodeStyleSetFlexShrink(node, floatFromDynamic(value));
+    } else if (name == "aspectRatio") {
+      YGNodeStyleSetAspectRatio(node, floatFromDynamic(value));
+    } else {
+      auto applied = false;
+      for (auto const &setters : valueSetters) {
+        if (name == setters.name) {
+          applyValue(node, setters, valueFromDynamic(name, value));
+          applied = true;
+        }
+      }
+      for (auto const &setters : edgeSetters) {
+        if (name != setters.name) {
+          continue;
+        }
+        for (auto const &edge : value.items()) {
+          applyValue(
+              node,
+              setters,
+              enumFromString(YGEdgeToString, edge.first.getString()),
+              valueFromDynamic(name, edge.second));
+        }
+        applied = true;
+      }
+      if (!applied) {
+        throw std::invalid_argument("Unknown style property: " + name);
+      }
+    }
+  }
+}
+
+// Size a node got measured to in the app, `height` changes to simulate an
+// update of its content
+struct RecordedSize {
+  float width;
+  float height;
+};
+
+static YGSize replayMeasure(
+    YGNodeRef node,
+    float width,
+    YGMeasureMode widthMode,
+    float height,
+    YGMeasureMode heightMode) {
+  auto recorded = static_cast<RecordedSize *>(YGNodeGetContext(node));
+  auto size = YGSize{recorded->width, recorded->height};
+
+  if (widthMode == YGMeasureModeExactly ||
+      (widthMode == YGMeasureModeAtMost && width < size.width)) {
+    // Wraps into as many lines as it takes to fit the recorded width
+    if (width > 0 && size.width > width) {
+      size.height *= std::ceil(size.width / width);
+    }
+    size.width = width;
+  }
+  if (heightMode == YGMeasureModeExactly ||
+      (heightMode == YGMeasureModeAtMost && height < size.height)) {
+    size.height = height;
+  }
+  return size;
+}
+
+class Snapshot {
+ public:
+  explicit Snapshot(folly::dynamic const &json) {
+    ownerWidth_ = floatFromDynamic(json["ownerWidth"]);
+    ownerHeight_ = floatFromDynamic(json["ownerHeight"]);
+    ownerDirection_ =
+        enumFromString(YGDirectionToString, json["ownerDirection"].getString());
+
+    auto const &config = json["config"];
+    config_ = YGConfigNew();
+    YGConfigSetPointScaleFactor(
+        config_, floatFromDynamic(config["pointScaleFactor"]));
+    YGConfigSetUseWebDefaults(config_, config["useWebDefaults"].asBool());
+    YGConfigSetUseLegacyStretchBehaviour(
+        config_, config["useLegacyStretchBehaviour"].asBool());
+
+    // Every node keeps a pointer into it, so it must not reallocate
+    recordedSizes_.reserve(countMeasuredNodes(json["root"]));
+    root_ = createNode(json["root"]);
+  }
+
+  Snapshot(Snapshot const &) = delete;
+  Snapshot &operator=(Snapshot const &) = delete;
+
+  ~Snapshot() {
+    YGNodeFreeRecursive(root_);
+    YGConfigFree(config_);
+  }
+
+  YGNodeRef root() const {
+    return root_;
+  }
+
+  std::vector<YGNodeRef> const &measuredNodes() const {
+    return measuredNodes_;
+  }
+
+  float ownerWidth() const {
+    return ownerWidth_;
+  }
+
+  void layout(float ownerWidth) const {
+    YGNodeCalculateLayout(root_, ownerWidth, ownerHeight_, ownerDirection_);
+  }
+
+  void layout() const {
+    layout(ownerWidth_);
+  }
+
+ private:
+  float ownerWidth_;
+  float ownerHeight_;
+  YGDirection ownerDirection_;
+  YGConfigRef config_;
+  YGNodeRef root_;
+  std::vector<RecordedSize> recordedSizes_;
+  std::vector<YGNodeRef> measuredNodes_;
+
+  static size_t countMeasuredNodes(folly::dynamic const &json) {
+    auto count = json.count("measured");
+    if (auto children = json.get_ptr("children")) {
+      for (auto const &child : *children) {
+        count += countMeasuredNodes(child);
+      }
+    }
+    return count;
+  }
+
+  YGNodeRef createNode(folly::dynamic const &json) {
+    auto node = YGNodeNewWithConfig(config_);
+    if (auto style = json.get_ptr("style")) {
+      applyStyle(node, *style);
+    }
+    if (auto nodeType = json.get_ptr("nodeType")) {
+      YGNodeSetNodeType(
+          node, enumFromString(YGNodeTypeToString, nodeType->getString()));
+    }
+    if (auto measured = json.get_ptr("measured")) {
+      auto width = floatFromDynamic((*measured)["width"]);
+      auto height = floatFromDynamic((*measured)["height"]);
+      // Nodes that never got laid out in the app have nothing recorded
+      recordedSizes_.push_back(
+          {std::isnan(width) ? 0 : width, std::isnan(height) ? 0 : height});
+      YGNodeSetContext(node, &recordedSizes_.back());
+      YGNodeSetMeasureFunc(node, replayMeasure);
+      measuredNodes_.push_back(node);
+    }
+    if (auto children = json.get_ptr("children")) {
+      for (auto const &child : *children) {
+        YGNodeInsertChild(node, createNode(child), YGNodeGetChildCount(node));
+      }
+    }
+    return node;
+  }
+};
+
+#pragma mark - Synthetic snapshot
+
+static folly::dynamic text(float width, float height) {
+  return folly::dynamic::object("nodeType", "text")(
+      "measured", folly::dynamic::object("width", width)("height", height));
+}
+
+// A header and a scrollable feed of rows with an avatar and two lines of text
+static folly::dynamic syntheticSnapshot() {
+  auto rows = folly::dynamic::array();
+  for (auto i = 0; i < 200; i++) {
+    folly::dynamic avatar = folly::dynamic::object(
+        "style",
+        folly::dynamic::object("width", 48)("height", 48)(
+            "margin", folly::dynamic::object("right", 8)));
+    folly::dynamic body = folly::dynamic::object(
+        "style", folly::dynamic::object("flexGrow", 1)("flexShrink", 1))(
+        "children",
+        folly::dynamic::array(
+            text(60 + (i * 37) % 140, 17), text(200 + (i * 53) % 400, 17)));
+    rows.push_back(folly::dynamic::object(
+        "style",
+        folly::dynamic::object("flexDirection", "row")(
+            "padding", folly::dynamic::object("all", 12)))(
+        "children", folly::dynamic::array(avatar, body)));
+  }
+
+  folly::dynamic header = folly::dynamic::object(
+      "style",
+      folly::dynamic::object("height", 56)("flexDirection", "row")(
+          "alignItems", "center")(
+          "padding", folly::dynamic::object("horizontal", 16)))(
+      "children", folly::dynamic::array(text(120, 22)));
+  folly::dynamic feed = folly::dynamic::object(
+      "style", folly::dynamic::object("flexGrow", 1)("overflow", "scroll"))(
+      "children",
+      folly::dynamic::array(folly::dynamic::object(
+          "style", folly::dynamic::object("flexShrink", 0))(
+          "children", rows)));
+
+  return folly::dynamic::object("ownerWidth", 390)("ownerHeight", 844)(
+      "ownerDirection", "ltr")(
+      "config",
+      folly::dynamic::object("pointScaleFactor", 3)("useWebDefaults", false)(
+          "useLegacyStretchBehaviour", false))(
+      "root",
+      folly::dynamic::object("style", folly::dynamic::object("flex", 1))(
+          "children", folly::dynamic::array(header, feed)));
+}
+
+#pragma mark - Benchmarks
+
+static void firstLayout(benchmark::State &state, folly::dynamic const &json) {
+  counters = {};
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto snapshot = std::make_unique<Snapshot>(json);
+    state.ResumeTiming();
+
+    snapshot->layout();
+
+    state.PauseTiming();
+    snapshot.reset();
+    state.ResumeTiming();
+  }
+  reportCounters(state);
+}
+
+static void relayoutAfterLeafChange(
+    benchmark::State &state,
+    folly::dynamic const &json) {
+  Snapshot snapshot{json};
+  auto const &leaves = snapshot.measuredNodes();
+  if (leaves.empty()) {
+    state.SkipWithError("The snapshot has no measured nodes");
+    return;
+  }
+  snapshot.layout();
+
+  counters = {};
+  auto iteration = size_t{0};
+  for (auto _ : state) {
+    // Grows and shrinks back a different leaf every two iterations
+    auto leaf = leaves[(iteration / 2) % leaves.size()];
+    auto recorded = static_cast<RecordedSize *>(YGNodeGetContext(leaf));
+    recorded->height += iteration % 2 == 0 ? 1 : -1;
+    YGNodeMarkDirty(leaf);
+    iteration++;
+
+    snapshot.layout();
+  }
+  reportCounters(state);
+}
+
+static void relayoutAfterWidthChange(
+    benchmark::State &state,
+    folly::dynamic const &json) {
+  Snapshot snapshot{json};
+  if (YGFloatIsUndefined(snapshot.ownerWidth())) {
+    state.SkipWithError("The snapshot has no owner width");
+    return;
+  }
+  snapshot.layout();
+
+  counters = {};
+  auto iteration = size_t{0};
+  for (auto _ : state) {
+    // Alternates between two widths, like resizing a split screen
+    auto scale = iteration++ % 2 == 0 ? 0.8f : 1.0f;
+    snapshot.layout(snapshot.ownerWidth() * scale);
+  }
+  reportCounters(state);
+}
+
+static void registerBenchmarks(
+    std::string const &name,
+    folly::dynamic const &json) {
+  benchmark::RegisterBenchmark(
+      ("firstLayout/" + name).c_str(), firstLayout, json);
+  benchmark::RegisterBenchmark(
+      ("relayoutAfterLeafChange/" + name).c_str(),
+      relayoutAfterLeafChange,
+      json);
+  benchmark::RegisterBenchmark(
+      ("relayoutAfterWidthChange/" + name).c_str(),
+      relayoutAfterWidthChange,
+      json);
+}
+
+} // namespace react
+} // namespace facebook
+
+int main(int argc, char **argv) {
+  using namespace facebook::react;
+
+  benchmark::Initialize(&argc, argv);
+  subscribeToLayoutEvents();
+
+  // What's left after the benchmark flags are snapshot files
+  if (argc <= 1) {
+    registerBenchmarks("synthetic", syntheticSnapshot());
+  }
+  for (auto i = 1; i < argc; i++) {
+    std::string contents;
+    if (!folly::readFile(argv[i], contents)) {
+      fprintf(stderr, "Can't read %s\n", argv[i]);
+      return 1;
+    }
+    auto json = folly::parseJson(contents);
+    try {
+      Snapshot{json};
+    } catch (std::exception const &e) {
+      fprintf(stderr, "Can't load %s: %s\n", argv[i], e.what());
+      return 1;
+    }
+    registerBenchmarks(argv[i], json);
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
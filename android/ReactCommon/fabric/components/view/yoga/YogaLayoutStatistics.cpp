@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "YogaLayoutStatistics.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <mutex>
+
+namespace facebook {
+namespace react {
+
+using yoga::Event;
+
+static thread_local YogaLayoutStatistics *currentStatistics = nullptr;
+static thread_local std::chrono::steady_clock::time_point passStartTime;
+
+static void accumulate(
+    YogaLayoutStatistics &statistics,
+    yoga::LayoutData const &data,
+    int64_t passTime) {
+  statistics.passes++;
+  statistics.layouts += data.layouts;
+  statistics.measures += data.measures;
+  statistics.cachedLayouts += data.cachedLayouts;
+  statistics.cachedMeasures += data.cachedMeasures;
+  statistics.measureCallbacks += data.measureCallbacks;
+  for (size_t i = 0; i < statistics.measureCallbacksByReason.size(); i++) {
+    statistics.measureCallbacksByReason[i] +=
+        data.measureCallbackReasonsCount[i];
+  }
+  statistics.maxDepth = std::max(statistics.maxDepth, data.maxDepth);
+  statistics.time += passTime;
+  statistics.maxPassTime = std::max(statistics.maxPassTime, passTime);
+}
+
+static bool isCollecting(void const *layoutContext) {
+  return currentStatistics != nullptr && layoutContext == currentStatistics;
+}
+
+static void subscribeOnce() {
+  static std::once_flag onceFlag;
+  std::call_once(onceFlag, [] {
+    // Start and end of a pass are published on the thread that runs it, also
+    // with parallel layout. Passes that someone else started carry a
+    // different (or no) layout context and are ignored.
+    Event::subscribe([](YGNode const &, Event::Type type, Event::Data data) {
+      if (type == Event::LayoutPassStart) {
+        if (isCollecting(data.get<Event::LayoutPassStart>().layoutContext)) {
+          passStartTime = std::chrono::steady_clock::now();
+        }
+      } else if (type == Event::LayoutPassEnd) {
+        auto const &passData = data.get<Event::LayoutPassEnd>();
+        if (isCollecting(passData.layoutContext)) {
+          auto passTime = std::chrono::steady_clock::now() - passStartTime;
+          accumulate(
+              *currentStatistics,
+              *passData.layoutData,
+              std::chrono::duration_cast<std::chrono::nanoseconds>(passTime)
+                  .count());
+        }
+      }
+    });
+  });
+}
+
+double YogaLayoutStatistics::getCacheHitRate() const {
+  auto cached = cachedLayouts + cachedMeasures;
+  auto visits = cached + layouts + measures;
+  return visits == 0 ? 0 : static_cast<double>(cached) / visits;
+}
+
+void YogaLayoutStatistics::beginCollecting(YogaLayoutStatistics *statistics) {
+  assert(currentStatistics == nullptr && "Collecting doesn't nest.");
+  subscribeOnce();
+  currentStatistics = statistics;
+}
+
+void YogaLayoutStatistics::endCollecting() {
+  currentStatistics = nullptr;
+}
+
+YogaLayoutStatistics *YogaLayoutStatistics::current() {
+  return currentStatistics;
+}
+
+} // namespace react
+} // namespace facebook
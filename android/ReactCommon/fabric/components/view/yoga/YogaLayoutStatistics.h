@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <yoga/event/event.h>
+
+namespace facebook {
+namespace react {
+
+/*
+ * Aggregated counters of all Yoga layout passes that ran while the object was
+ * collecting, e.g. during the layout phase of a single commit.
+ * The counters come from `yoga::Event`s, so they stay zero unless Yoga is
+ * built with `YG_ENABLE_EVENTS`.
+ */
+struct YogaLayoutStatistics final {
+  using ReasonCounts = std::array<
+      int,
+      static_cast<size_t>(yoga::LayoutPassReason::COUNT)>;
+
+  /*
+   * Number of `YGNodeCalculateLayout` calls.
+   */
+  int passes{0};
+
+  /*
+   * Nodes that got laid out or measured, and those where Yoga could reuse
+   * the result of a previous pass instead.
+   */
+  int layouts{0};
+  int measures{0};
+  int cachedLayouts{0};
+  int cachedMeasures{0};
+
+  /*
+   * Calls of measure functions (e.g. text measurement), in total and by the
+   * reason Yoga needed the size.
+   */
+  int measureCallbacks{0};
+  ReasonCounts measureCallbacksByReason{};
+
+  /*
+   * Deepest node visited, counted from the root of a pass.
+   */
+  int maxDepth{0};
+
+  /*
+   * Duration of all passes and of the longest one, in nanoseconds.
+   */
+  int64_t time{0};
+  int64_t maxPassTime{0};
+
+  /*
+   * Share of node visits answered from the layout cache, in [0, 1].
+   */
+  double getCacheHitRate() const;
+
+  /*
+   * Makes Yoga layout passes on the calling thread that get started by
+   * `YogaLayoutableShadowNode` add to `statistics` until `endCollecting()`.
+   * Collecting doesn't nest.
+   */
+  static void beginCollecting(YogaLayoutStatistics *statistics);
+  static void endCollecting();
+
+  /*
+   * The object collecting on the calling thread, or `nullptr`. Meant to be
+   * passed as the `layoutContext` of a Yoga layout pass.
+   */
+  static YogaLayoutStatistics *current();
+};
+
+} // namespace react
+} // namespace facebook
@@ -11,6 +11,8 @@
 #include <limits>
 #include <memory>
 
+#include <microprofiler/MicroProfiler.h>
+#include <react/components/view/YogaLayoutStatistics.h>
 #include <react/components/view/conversions.h>
 #include <react/core/LayoutConstraints.h>
 #include <react/core/LayoutContext.h>
@@ -165,9 +167,14 @@ void YogaLayoutableShadowNode::layout(LayoutContext layoutContext) {
 
     {
       SystraceSection s("YogaLayoutableShadowNode::YGNodeCalculateLayout");
-
-      YGNodeCalculateLayout(
-          &yogaNode_, YGUndefined, YGUndefined, YGDirectionInherit);
+      MICRO_PROFILER_SCOPE("YGNodeCalculateLayout");
+
+      YGNodeCalculateLayoutWithContext(
+          &yogaNode_,
+          YGUndefined,
+          YGUndefined,
+          YGDirectionInherit,
+          YogaLayoutStatistics::current());
     }
   }
 
@@ -23,7 +23,9 @@ namespace facebook {
 namespace react {
 
 class YogaLayoutableShadowNode : public LayoutableShadowNode,
+#if RN_DEBUG_STRING_CONVERTIBLE
                                  public virtual DebugStringConvertible,
+#endif
                                  public virtual Sealable {
  public:
   using UnsharedList = better::small_vector<
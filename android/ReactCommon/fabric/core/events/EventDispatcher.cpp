@@ -48,6 +48,22 @@ void EventDispatcher::dispatchEvent(
     const RawEvent &rawEvent,
     EventPriority priority) const {
   getEventQueue(priority).enqueueEvent(std::move(rawEvent));
+  induceBeatIfNeeded(priority);
+}
+
+void EventDispatcher::dispatchUniqueEvent(
+    const RawEvent &rawEvent,
+    EventPriority priority) const {
+  getEventQueue(priority).enqueueUniqueEvent(rawEvent);
+  induceBeatIfNeeded(priority);
+}
+
+int64_t EventDispatcher::getCoalescedEventCount() const {
+  auto count = int64_t{0};
+  for (const auto &eventQueue : eventQueues_) {
+    count += eventQueue->getCoalescedEventCount();
+  }
+  return count;
 }
 
 void EventDispatcher::dispatchStateUpdate(
@@ -64,5 +80,18 @@ const EventQueue &EventDispatcher::getEventQueue(EventPriority priority) const {
   return *eventQueues_[(int)priority];
 }
 
+void EventDispatcher::induceBeatIfNeeded(EventPriority priority) const {
+#ifdef REACT_FABRIC_SYNC_EVENT_DISPATCHING_DISABLED
+  // All events go through the same (batched) queue to keep their order, so
+  // discrete events (e.g. a touch start) flush the queue as soon as possible
+  // instead of waiting for the coming beat. Continuous events enqueued before
+  // them are coalesced, so the flush stays short.
+  if (priority == EventPriority::SynchronousUnbatched ||
+      priority == EventPriority::AsynchronousUnbatched) {
+    getEventQueue(priority).induceBeat();
+  }
+#endif
+}
+
 } // namespace react
 } // namespace facebook
@@ -41,6 +41,19 @@ class EventDispatcher {
    */
   void dispatchEvent(const RawEvent &rawEvent, EventPriority priority) const;
 
+  /*
+   * Dispatches a raw event with given priority using event-delivery pipe,
+   * coalescing it with a not yet delivered event of the same type for the same
+   * target (see `EventQueue::enqueueUniqueEvent`).
+   */
+  void dispatchUniqueEvent(const RawEvent &rawEvent, EventPriority priority)
+      const;
+
+  /*
+   * Returns the total number of events that were coalesced by all queues.
+   */
+  int64_t getCoalescedEventCount() const;
+
   /*
    * Dispatches a state update with given priority.
    */
@@ -50,6 +63,12 @@ class EventDispatcher {
  private:
   const EventQueue &getEventQueue(EventPriority priority) const;
 
+  /*
+   * Induces a beat of the queue used for `priority` if the priority is
+   * unbatched and all priorities share the same queue.
+   */
+  void induceBeatIfNeeded(EventPriority priority) const;
+
   std::array<std::unique_ptr<EventQueue>, 4> eventQueues_;
 };
 
@@ -31,11 +31,6 @@ static std::string normalizeEventType(const std::string &type) {
   return prefixedType;
 }
 
-std::mutex &EventEmitter::DispatchMutex() {
-  static std::mutex mutex;
-  return mutex;
-}
-
 ValueFactory EventEmitter::defaultPayloadFactory() {
   static auto payloadFactory =
       ValueFactory{[](jsi::Runtime &runtime) { return jsi::Object(runtime); }};
@@ -77,6 +72,22 @@ void EventEmitter::dispatchEvent(
       priority);
 }
 
+void EventEmitter::dispatchUniqueEvent(
+    const std::string &type,
+    const ValueFactory &payloadFactory,
+    const EventPriority &priority) const {
+  SystraceSection s("EventEmitter::dispatchUniqueEvent");
+
+  auto eventDispatcher = eventDispatcher_.lock();
+  if (!eventDispatcher) {
+    return;
+  }
+
+  eventDispatcher->dispatchUniqueEvent(
+      RawEvent(normalizeEventType(type), payloadFactory, eventTarget_),
+      priority);
+}
+
 void EventEmitter::setEnabled(bool enabled) const {
   enableCounter_ += enabled ? 1 : -1;
 
@@ -7,7 +7,6 @@
 #pragma once
 
 #include <memory>
-#include <mutex>
 
 #include <folly/dynamic.h>
 #include <react/core/EventDispatcher.h>
@@ -37,8 +36,6 @@ class EventEmitter {
  public:
   using Shared = std::shared_ptr<EventEmitter const>;
 
-  static std::mutex &DispatchMutex();
-
   static ValueFactory defaultPayloadFactory();
 
   EventEmitter(
@@ -56,7 +53,7 @@ class EventEmitter {
    * a possibility to extract JSI value from it.
    * The enable state is additive; a number of `enable` calls should be equal to
    * a number of `disable` calls to release the event target.
-   * `DispatchMutex` must be acquired before calling.
+   * Calls must not run concurrently (see `ShadowNode::setMounted`).
    */
   void setEnabled(bool enabled) const;
 
@@ -82,6 +79,17 @@ class EventEmitter {
       const folly::dynamic &payload,
       const EventPriority &priority = EventPriority::AsynchronousBatched) const;
 
+  /*
+   * Initiates an event delivery process for a continuous event (e.g. scroll),
+   * only the latest payload of which is delivered if the previous one was not
+   * delivered yet.
+   * Is used by particular subclasses only.
+   */
+  void dispatchUniqueEvent(
+      const std::string &type,
+      const ValueFactory &payloadFactory,
+      const EventPriority &priority = EventPriority::AsynchronousBatched) const;
+
  private:
   void toggleEventTargetOwnership_() const;
 
@@ -7,6 +7,10 @@
 
 #include "EventQueue.h"
 
+#include <algorithm>
+
+#include <react/core/ShadowNode.h>
+
 #include "EventEmitter.h"
 
 namespace facebook {
@@ -32,6 +36,42 @@ void EventQueue::enqueueEvent(const RawEvent &rawEvent) const {
   onEnqueue();
 }
 
+void EventQueue::enqueueUniqueEvent(const RawEvent &rawEvent) const {
+  {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+
+    auto repeatedEvent = eventQueue_.rend();
+    // Events without a target cannot be told apart and are never coalesced.
+    auto it = rawEvent.eventTarget ? eventQueue_.rbegin() : eventQueue_.rend();
+    for (; it != eventQueue_.rend(); ++it) {
+      if (it->eventTarget != rawEvent.eventTarget) {
+        continue;
+      }
+
+      // Any other event for the same target in between prevents coalescing,
+      // otherwise the events would be dispatched out of order.
+      if (it->type == rawEvent.type) {
+        repeatedEvent = it;
+      }
+      break;
+    }
+
+    if (repeatedEvent == eventQueue_.rend()) {
+      eventQueue_.push_back(rawEvent);
+    } else {
+      repeatedEvent->payloadFactory = rawEvent.payloadFactory;
+      coalescedEventCount_++;
+    }
+  }
+
+  onEnqueue();
+}
+
+int64_t EventQueue::getCoalescedEventCount() const {
+  std::lock_guard<std::mutex> lock(queueMutex_);
+  return coalescedEventCount_;
+}
+
 void EventQueue::enqueueStateUpdate(const StateUpdate &stateUpdate) const {
   {
     std::lock_guard<std::mutex> lock(queueMutex_);
@@ -41,6 +81,11 @@ void EventQueue::enqueueStateUpdate(const StateUpdate &stateUpdate) const {
   onEnqueue();
 }
 
+void EventQueue::induceBeat() const {
+  eventBeat_->request();
+  eventBeat_->induce();
+}
+
 void EventQueue::onEnqueue() const {
   // Default implementation does nothing.
 }
@@ -56,7 +101,8 @@ void EventQueue::flushEvents(jsi::Runtime &runtime) const {
   {
     std::lock_guard<std::mutex> lock(queueMutex_);
 
-    if (eventQueue_.size() == 0) {
+    // Retained targets that got disabled are still released on such beat.
+    if (eventQueue_.size() == 0 && retainedEventTargets_.size() == 0) {
       return;
     }
 
@@ -64,13 +110,12 @@ void EventQueue::flushEvents(jsi::Runtime &runtime) const {
     eventQueue_.clear();
   }
 
-  {
-    std::lock_guard<std::mutex> lock(EventEmitter::DispatchMutex());
-
-    for (const auto &event : queue) {
-      if (event.eventTarget) {
-        event.eventTarget->retain(runtime);
-      }
+  // A target that gets disabled concurrently still has its `instanceHandle`
+  // alive here: it can only be collected on this (JavaScript) thread.
+  // Each distinct target is retained once, the first time it's seen.
+  for (const auto &event : queue) {
+    if (event.eventTarget && event.eventTarget->retain(runtime)) {
+      retainedEventTargets_.push_back(event.eventTarget);
     }
   }
 
@@ -79,15 +124,21 @@ void EventQueue::flushEvents(jsi::Runtime &runtime) const {
         runtime, event.eventTarget.get(), event.type, event.payloadFactory);
   }
 
-  // No need to lock `EventEmitter::DispatchMutex()` here.
-  // The mutex protects from a situation when the `instanceHandle` can be
-  // deallocated during accessing, but that's impossible at this point because
-  // we have a strong pointer to it.
-  for (const auto &event : queue) {
-    if (event.eventTarget) {
-      event.eventTarget->release(runtime);
-    }
-  }
+  // The `instanceHandle` can't be deallocated during accessing at this point
+  // because we have a strong pointer to it. Targets that are still enabled
+  // stay retained for the coming beats, the others are released now.
+  retainedEventTargets_.erase(
+      std::remove_if(
+          retainedEventTargets_.begin(),
+          retainedEventTargets_.end(),
+          [&](const SharedEventTarget &eventTarget) {
+            if (eventTarget->isEnabled()) {
+              return false;
+            }
+            eventTarget->release(runtime);
+            return true;
+          }),
+      retainedEventTargets_.end());
 }
 
 void EventQueue::flushStateUpdates() const {
@@ -104,10 +155,30 @@ void EventQueue::flushStateUpdates() const {
     stateUpdateQueue_.clear();
   }
 
+  // Every update replaces the state data of the target node entirely, so only
+  // the latest update for each family of nodes has to be applied.
+  auto stateUpdates = std::vector<std::pair<StateTarget, StateData::Shared>>{};
+  stateUpdates.reserve(stateUpdateQueue.size());
   for (const auto &stateUpdate : stateUpdateQueue) {
     auto pair = stateUpdate();
-    statePipe_(pair.second, pair.first);
+    if (!pair.first) {
+      continue;
+    }
+
+    auto const &shadowNode = pair.first.getShadowNode();
+    stateUpdates.erase(
+        std::remove_if(
+            stateUpdates.begin(),
+            stateUpdates.end(),
+            [&](const std::pair<StateTarget, StateData::Shared> &other) {
+              return ShadowNode::sameFamily(
+                  other.first.getShadowNode(), shadowNode);
+            }),
+        stateUpdates.end());
+    stateUpdates.push_back(std::move(pair));
   }
+
+  statePipe_(stateUpdates);
 }
 
 } // namespace react
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -14,6 +15,7 @@
 #include <jsi/jsi.h>
 #include <react/core/EventBeat.h>
 #include <react/core/EventPipe.h>
+#include <react/core/EventTarget.h>
 #include <react/core/RawEvent.h>
 #include <react/core/StatePipe.h>
 #include <react/core/StateUpdate.h>
@@ -39,6 +41,30 @@ class EventQueue {
    */
   void enqueueEvent(const RawEvent &rawEvent) const;
 
+  /*
+   * Enqueues and (probably later) dispatch a given event, replacing the
+   * payload of an already enqueued event of the same type for the same target
+   * (if there is no other event for this target enqueued after it).
+   * Is used for continuous events (e.g. scroll or touch move) where only
+   * the latest payload matters.
+   * Can be called on any thread.
+   */
+  void enqueueUniqueEvent(const RawEvent &rawEvent) const;
+
+  /*
+   * Makes the queue dispatch the enqueued events as soon as possible instead
+   * of waiting for the coming beat (see `EventBeat::induce`).
+   * Can be called on any thread.
+   */
+  void induceBeat() const;
+
+  /*
+   * Returns the number of events that were replaced by newer unique events
+   * instead of being dispatched.
+   * Can be called on any thread.
+   */
+  int64_t getCoalescedEventCount() const;
+
   /*
    * Enqueues and (probably later) dispatch a given state update.
    * Can be called on any thread.
@@ -63,7 +89,13 @@ class EventQueue {
   // Thread-safe, protected by `queueMutex_`.
   mutable std::vector<RawEvent> eventQueue_;
   mutable std::vector<StateUpdate> stateUpdateQueue_;
+  mutable int64_t coalescedEventCount_{0};
   mutable std::mutex queueMutex_;
+  // Targets whose `instanceHandle` is kept retained between beats while they
+  // stay enabled (mounted), so that a stream of events (e.g. touches) for the
+  // same targets doesn't lock their weak handles over and over.
+  // Accessed on the JavaScript thread only.
+  mutable std::vector<SharedEventTarget> retainedEventTargets_;
 };
 
 } // namespace react
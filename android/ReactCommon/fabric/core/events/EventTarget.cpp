@@ -25,9 +25,13 @@ void EventTarget::setEnabled(bool enabled) const {
   enabled_ = enabled;
 }
 
-void EventTarget::retain(jsi::Runtime &runtime) const {
-  if (!enabled_) {
-    return;
+bool EventTarget::isEnabled() const {
+  return enabled_;
+}
+
+bool EventTarget::retain(jsi::Runtime &runtime) const {
+  if (!enabled_ || !strongInstanceHandle_.isNull()) {
+    return false;
   }
 
   strongInstanceHandle_ = weakInstanceHandle_.lock(runtime);
@@ -40,6 +44,7 @@ void EventTarget::retain(jsi::Runtime &runtime) const {
   // that case will lead to a crash in those environments.
   assert(!strongInstanceHandle_.isNull());
   assert(!strongInstanceHandle_.isUndefined());
+  return true;
 }
 
 void EventTarget::release(jsi::Runtime &runtime) const {
@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <memory>
 
 #include <jsi/jsi.h>
@@ -38,15 +39,21 @@ class EventTarget {
 
   /*
    * Sets the `enabled` flag that allows creating a strong instance handle from
-   * a weak one.
+   * a weak one. Can be called from any thread.
    */
   void setEnabled(bool enabled) const;
 
+  /*
+   * Returns the value of the `enabled` flag. Can be called from any thread.
+   */
+  bool isEnabled() const;
+
   /*
    * Retains an instance handler by creating a strong reference to it.
-   * If the EventTarget is disabled, does nothing.
+   * If the EventTarget is disabled or already retained, does nothing.
+   * Returns `true` if a new strong reference was created.
    */
-  void retain(jsi::Runtime &runtime) const;
+  bool retain(jsi::Runtime &runtime) const;
 
   /*
    * Releases the instance handler by nulling a strong reference to it.
@@ -65,7 +72,7 @@ class EventTarget {
   Tag getTag() const;
 
  private:
-  mutable bool enabled_{false}; // Protected by `EventEmitter::DispatchMutex()`.
+  mutable std::atomic<bool> enabled_{false};
   mutable jsi::WeakObject weakInstanceHandle_; // Protected by `jsi::Runtime &`.
   mutable jsi::Value strongInstanceHandle_; // Protected by `jsi::Runtime &`.
   Tag tag_;
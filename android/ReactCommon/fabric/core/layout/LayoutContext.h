@@ -9,6 +9,7 @@
 
 #include <vector>
 
+#include <better/optional.h>
 #include <react/core/LayoutableShadowNode.h>
 #include <react/graphics/Geometry.h>
 
@@ -25,6 +26,14 @@ struct LayoutContext {
    */
   Point absolutePosition{0, 0};
 
+  /*
+   * The part of the screen (in the same coordinate space as
+   * `absolutePosition`) where the node can be visible, if known.
+   * Scrollable containers narrow it down for their content. Nodes
+   * positioned outside of it are off-screen.
+   */
+  better::optional<Rect> visibleRect{};
+
   /*
    * Reflects the scale factor needed to convert from the logical coordinate
    * space into the device coordinate space of the physical screen.
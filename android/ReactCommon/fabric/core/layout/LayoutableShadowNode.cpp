@@ -36,6 +36,11 @@ bool LayoutableShadowNode::LayoutableShadowNode::isLayoutOnly() const {
   return false;
 }
 
+bool LayoutableShadowNode::shouldMountChild(
+    LayoutMetrics const &childLayoutMetrics) const {
+  return true;
+}
+
 Transform LayoutableShadowNode::getTransform() const {
   return Transform::Identity();
 }
@@ -104,7 +109,7 @@ void LayoutableShadowNode::layout(LayoutContext layoutContext) {
     auto childLayoutContext = LayoutContext(layoutContext);
     childLayoutContext.absolutePosition += childLayoutMetrics.frame.origin;
 
-    child->layout(layoutContext);
+    child->layout(childLayoutContext);
   }
 }
 
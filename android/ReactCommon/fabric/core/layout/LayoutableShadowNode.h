@@ -65,6 +65,15 @@ class LayoutableShadowNode : public virtual Sealable {
    */
   virtual bool isLayoutOnly() const;
 
+  /*
+   * Returns `false` if a child with given layout metrics (relative to this
+   * node) must not be mounted. Such children stay in the shadow tree and are
+   * laid out, but are excluded from the generated mutations (see
+   * `Differentiator`). This allows virtualizing long content natively.
+   * Default implementation returns `true`.
+   */
+  virtual bool shouldMountChild(LayoutMetrics const &childLayoutMetrics) const;
+
   /*
    * Returns a transform object that represents transformations that will/should
    * be applied on top of regular layout metrics by mounting layer.
@@ -59,6 +59,11 @@ void RawProps::parse(RawPropsParser const &parser) const {
  * will be removed as soon Android implementation does not need it.
  */
 RawProps::operator folly::dynamic() const noexcept {
+  return toDynamic();
+}
+#endif
+
+folly::dynamic RawProps::toDynamic() const noexcept {
   switch (mode_) {
     case Mode::Empty:
       return folly::dynamic::object();
@@ -68,7 +73,6 @@ RawProps::operator folly::dynamic() const noexcept {
       return dynamic_;
   }
 }
-#endif
 
 /*
  * Returns `true` if the object is empty.
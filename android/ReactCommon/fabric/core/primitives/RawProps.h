@@ -91,6 +91,13 @@ class RawProps final {
    */
   bool isEmpty() const noexcept;
 
+  /*
+   * Returns all stored props as `folly::dynamic` (an empty object if there are
+   * none), e.g. for comparing or hashing them.
+   * Converts all the values, so it's as expensive as parsing them.
+   */
+  folly::dynamic toDynamic() const noexcept;
+
   /*
    * Returns a const unowning pointer to `RawValue` of a prop with a given name.
    * Returns `nullptr` if a prop with the given name does not exist.
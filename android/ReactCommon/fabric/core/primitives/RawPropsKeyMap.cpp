@@ -8,21 +8,24 @@
 #include "RawPropsKeyMap.h"
 
 #include <cassert>
-#include <cstdlib>
 #include <cstring>
 
 namespace facebook {
 namespace react {
 
-int RawPropsKeyMap::comparator(void const *lhs, void const *rhs) {
-  auto a = static_cast<RawPropsKeyMap::Item const *>(lhs);
-  auto b = static_cast<RawPropsKeyMap::Item const *>(rhs);
+constexpr RawPropsKeyMap::ItemIndex RawPropsKeyMap::kItemIndexEmpty;
 
-  if (a->length != b->length) {
-    return a->length - b->length;
+uint32_t RawPropsKeyMap::hash(
+    char const *name,
+    RawPropsPropNameLength length,
+    uint32_t seed) {
+  // FNV-1a, with the seed mixed into the offset basis.
+  auto hash = uint32_t{2166136261} ^ seed;
+  for (auto i = 0; i < length; i++) {
+    hash ^= static_cast<uint8_t>(name[i]);
+    hash *= uint32_t{16777619};
   }
-
-  return std::memcmp(a->name, b->name, a->length);
+  return hash ^ (hash >> 16);
 }
 
 void RawPropsKeyMap::insert(RawPropsKey const &key, RawPropsValueIndex value) {
@@ -32,29 +35,47 @@ void RawPropsKeyMap::insert(RawPropsKey const &key, RawPropsValueIndex value) {
   items_.push_back(item);
 }
 
-void RawPropsKeyMap::reindex() {
-  // Sorting `items_` by property names length and then lexicographically.
-  std::qsort(
-      items_.data(),
-      items_.size(),
-      sizeof(decltype(items_)::value_type),
-      &RawPropsKeyMap::comparator);
-
-  buckets_.resize(kPropNameLengthHardCap);
-
-  auto length = RawPropsPropNameLength{0};
+bool RawPropsKeyMap::tryReindex(size_t size, uint32_t seed) {
+  slots_.assign(size, kItemIndexEmpty);
+  auto const mask = size - 1;
   for (auto i = 0; i < items_.size(); i++) {
-    auto &item = items_[i];
-    if (item.length != length) {
-      for (auto j = length; j < item.length; j++) {
-        buckets_[j] = i;
+    auto const &item = items_[i];
+    auto &slot = slots_[hash(item.name, item.length, seed) & mask];
+    if (slot != kItemIndexEmpty) {
+      auto const &otherItem = items_[slot];
+      if (otherItem.length == item.length &&
+          std::memcmp(otherItem.name, item.name, item.length) == 0) {
+        // The same key was inserted twice; the first one wins.
+        continue;
       }
-      length = item.length;
+      return false;
     }
+    slot = i;
   }
+  return true;
+}
+
+void RawPropsKeyMap::reindex() {
+  assert(items_.size() < kItemIndexEmpty);
 
-  for (auto j = length; j < buckets_.size(); j++) {
-    buckets_[j] = items_.size();
+  // Looking for a seed that gives every key a slot of its own, starting with a
+  // table twice as large as the number of keys and growing it if necessary.
+  // Props of a component are known ahead of time, so this runs once per
+  // component.
+  auto size = size_t{2};
+  while (size < items_.size() * 2) {
+    size *= 2;
+  }
+
+  while (true) {
+    for (auto seed = uint32_t{0}; seed < 256; seed++) {
+      if (tryReindex(size, seed)) {
+        seed_ = seed;
+        mask_ = size - 1;
+        return;
+      }
+    }
+    size *= 2;
   }
 }
 
@@ -63,25 +84,19 @@ RawPropsValueIndex RawPropsKeyMap::at(
     RawPropsPropNameLength length) {
   assert(length > 0);
   assert(length < kPropNameLengthHardCap);
-  // 1. Find the bucket.
-  auto lower = int{buckets_[length - 1]};
-  auto upper = int{buckets_[length]} - 1;
-  assert(lower - 1 <= upper);
+  assert(!slots_.empty() && "The map must be reindexed before reading.");
 
-  // 2. Binary search in the bucket.
-  while (lower <= upper) {
-    auto median = (lower + upper) / 2;
-    auto condition = std::memcmp(items_[median].name, name, length);
-    if (condition < 0) {
-      lower = median + 1;
-    } else if (condition == 0) {
-      return items_[median].value;
-    } else /* if (condition > 0) */ {
-      upper = median - 1;
-    }
+  auto const itemIndex = slots_[hash(name, length, seed_) & mask_];
+  if (itemIndex == kItemIndexEmpty) {
+    return kRawPropsValueIndexEmpty;
+  }
+
+  auto const &item = items_[itemIndex];
+  if (item.length != length || std::memcmp(item.name, name, length) != 0) {
+    return kRawPropsValueIndexEmpty;
   }
 
-  return kRawPropsValueIndexEmpty;
+  return item.value;
 }
 
 } // namespace react
@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <limits>
+
 #include <better/small_vector.h>
 
 #include <react/core/RawPropsKey.h>
@@ -17,8 +20,9 @@ namespace react {
 
 /*
  * A map especially optimized to hold `{name: index}` relations.
- * The implementation is conceptually similar to a classic hash map with a hash
- * function that returns the length of the string.
+ * The set of keys is known ahead of time (all props of a component), so after
+ * reindexing the map is a perfect hash table: every key has a slot of its own,
+ * and a lookup takes one hash computation and one comparison.
  * The map is optimized for reads only (the map must be reindexed before a bunch
  * of reads).
  */
@@ -42,7 +46,21 @@ class RawPropsKeyMap final {
   RawPropsValueIndex at(char const *name, RawPropsPropNameLength length);
 
  private:
-  static int comparator(void const *lhs, void const *rhs);
+  using ItemIndex = uint16_t;
+  static constexpr ItemIndex kItemIndexEmpty =
+      std::numeric_limits<ItemIndex>::max();
+
+  static uint32_t hash(
+      char const *name,
+      RawPropsPropNameLength length,
+      uint32_t seed);
+
+  /*
+   * Tries to place all items into `slots_` of the given size with the given
+   * seed. Returns `false` (leaving `slots_` in an unspecified state) if two
+   * items collide.
+   */
+  bool tryReindex(size_t size, uint32_t seed);
 
   struct Item {
     RawPropsValueIndex value;
@@ -51,8 +69,9 @@ class RawPropsKeyMap final {
   };
 
   better::small_vector<Item, kNumberOfExplicitlySpecifedPropsSoftCap> items_{};
-  better::small_vector<RawPropsPropNameLength, kPropNameLengthHardCap>
-      buckets_{};
+  better::small_vector<ItemIndex, kNumberOfPropsPerComponentSoftCap> slots_{};
+  uint32_t seed_{0};
+  uint32_t mask_{0};
 };
 
 } // namespace react
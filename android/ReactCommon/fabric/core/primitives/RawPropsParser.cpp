@@ -7,6 +7,8 @@
 
 #include "RawPropsParser.h"
 
+#include <algorithm>
+
 #include <folly/Likely.h>
 #include <react/core/RawProps.h>
 
@@ -61,20 +63,22 @@ void RawPropsParser::preparse(RawProps const &rawProps) const {
       auto count = names.size(runtime);
       auto valueIndex = RawPropsValueIndex{0};
 
+      rawProps.values_.reserve(std::min<size_t>(count, size_));
+
       for (auto i = 0; i < count; i++) {
         auto nameValue = names.getValueAtIndex(runtime, i).getString(runtime);
-        auto value = object.getProperty(runtime, nameValue);
-
         auto name = nameValue.utf8(runtime);
 
+        // Props which the component doesn't declare are skipped before
+        // their values are read from the JavaScript object.
         auto keyIndex = nameToIndex_.at(name.data(), name.size());
         if (keyIndex == kRawPropsValueIndexEmpty) {
           continue;
         }
 
+        auto value = object.getProperty(runtime, nameValue);
         rawProps.keyIndexToValueIndex_[keyIndex] = valueIndex;
-        rawProps.values_.push_back(
-            RawValue(jsi::dynamicFromValue(runtime, value)));
+        rawProps.values_.push_back(RawValue(runtime, std::move(value)));
         valueIndex++;
       }
 
@@ -22,6 +22,13 @@ namespace react {
 /*
  * Specialized (to a particular type of Props) parser that provides the most
  * efficient access to `RawProps` content.
+ * `prepare` records the keys which the Props type reads, in the order it reads
+ * them, and builds a perfect-hash table of them. `preparse` then makes a
+ * single pass over the raw props: keys the component doesn't declare are
+ * skipped after one probe into the table, before their values are read. The
+ * `convertRawProp` calls of the Props constructor find their values in order
+ * through a cursor. The tables are built at run time once per component;
+ * no parsers are generated from component schemas.
  */
 class RawPropsParser final {
  public:
@@ -52,6 +59,8 @@ class RawPropsParser final {
   friend class RawProps;
 
   /*
+   * Maps the values of `rawProps` to the keys of the parser, skipping the
+   * undeclared ones.
    * To be used by `RawProps` only.
    */
   void preparse(RawProps const &rawProps) const;
@@ -24,10 +24,10 @@ class RawPropsParser;
  *
  * The main intention of the class is to abstract React props parsing infra from
  * JSI, to enable support for any non-JSI-based data sources. The particular
- * implementation of the interface is a very slim abstraction around
- * `folly::dynamic` though.
- * In the near future, this class will hold a `jsi::Runtime` and `jsi::Value`
- * pair instead of `folly::dynamic`.
+ * implementation of the interface holds either a `jsi::Runtime` and
+ * `jsi::Value` pair (and reads typed values straight out of JavaScript values
+ * on demand, without creating `folly::dynamic` intermediates) or a
+ * `folly::dynamic` (for non-JSI-based sources).
  *
  * How `RawValue` is different from `JSI::Value`:
  *  * `RawValue` provides much more scoped API without any references to
@@ -52,10 +52,15 @@ class RawValue {
    */
   RawValue() noexcept : dynamic_(nullptr){};
 
-  RawValue(RawValue &&other) noexcept : dynamic_(std::move(other.dynamic_)) {}
+  RawValue(RawValue &&other) noexcept
+      : runtime_(other.runtime_),
+        value_(std::move(other.value_)),
+        dynamic_(std::move(other.dynamic_)) {}
 
   RawValue &operator=(RawValue &&other) noexcept {
     if (this != &other) {
+      runtime_ = other.runtime_;
+      value_ = std::move(other.value_);
       dynamic_ = std::move(other.dynamic_);
     }
     return *this;
@@ -72,15 +77,26 @@ class RawValue {
 
   RawValue(folly::dynamic &&dynamic) noexcept : dynamic_(std::move(dynamic)){};
 
+  RawValue(jsi::Runtime &runtime, jsi::Value &&value) noexcept
+      : runtime_(&runtime), value_(std::move(value)), dynamic_(nullptr){};
+
   /*
    * Copy constructor and copy assignment operator are private and only for
    * internal use. Basically, it's implementation details. Other particular
    * implementations of the `RawValue` interface may not have them.
    */
-  RawValue(RawValue const &other) noexcept : dynamic_(other.dynamic_) {}
+  RawValue(RawValue const &other) noexcept
+      : runtime_(other.runtime_),
+        value_(
+            other.runtime_ ? jsi::Value(*other.runtime_, other.value_)
+                           : jsi::Value()),
+        dynamic_(other.dynamic_) {}
 
   RawValue &operator=(const RawValue &other) noexcept {
     if (this != &other) {
+      runtime_ = other.runtime_;
+      value_ = other.runtime_ ? jsi::Value(*other.runtime_, other.value_)
+                              : jsi::Value();
       dynamic_ = other.dynamic_;
     }
     return *this;
@@ -92,10 +108,16 @@ class RawValue {
    */
   template <typename T>
   explicit operator T() const noexcept {
+    if (runtime_) {
+      return castValue(*runtime_, value_, (T *)nullptr);
+    }
     return castValue(dynamic_, (T *)nullptr);
   }
 
   inline explicit operator folly::dynamic() const {
+    if (runtime_) {
+      return jsi::dynamicFromValue(*runtime_, value_);
+    }
     return dynamic_;
   }
 
@@ -104,6 +126,9 @@ class RawValue {
    */
   template <typename T>
   bool hasType() const noexcept {
+    if (runtime_) {
+      return checkValueType(*runtime_, value_, (T *)nullptr);
+    }
     return checkValueType(dynamic_, (T *)nullptr);
   };
 
@@ -111,10 +136,18 @@ class RawValue {
    * Checks if the stored value is *not* `null`.
    */
   bool hasValue() const noexcept {
+    if (runtime_) {
+      return !value_.isNull() && !value_.isUndefined();
+    }
     return !dynamic_.isNull();
   }
 
  private:
+  // Case 1: The value is a JavaScript value (`runtime_` is not `nullptr`).
+  jsi::Runtime *runtime_{nullptr};
+  jsi::Value value_;
+
+  // Case 2: The value is a `folly::dynamic`.
   folly::dynamic dynamic_;
 
   static bool checkValueType(
@@ -262,6 +295,188 @@ class RawValue {
     }
     return result;
   }
+
+  // Type checks of JavaScript values
+  static bool checkValueType(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      RawValue *type) noexcept {
+    return true;
+  }
+
+  static bool checkValueType(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      bool *type) noexcept {
+    return value.isBool();
+  }
+
+  static bool checkValueType(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      int *type) noexcept {
+    return value.isNumber();
+  }
+
+  static bool checkValueType(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      int64_t *type) noexcept {
+    return value.isNumber();
+  }
+
+  static bool checkValueType(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      float *type) noexcept {
+    return value.isNumber();
+  }
+
+  static bool checkValueType(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      double *type) noexcept {
+    return value.isNumber();
+  }
+
+  static bool checkValueType(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      std::string *type) noexcept {
+    return value.isString();
+  }
+
+  template <typename T>
+  static bool checkValueType(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      std::vector<T> *type) noexcept {
+    if (!value.isObject()) {
+      return false;
+    }
+
+    auto object = value.getObject(runtime);
+    if (!object.isArray(runtime)) {
+      return false;
+    }
+
+    auto array = object.getArray(runtime);
+    if (array.size(runtime) == 0) {
+      return true;
+    }
+
+    // Note: We test only one element.
+    return checkValueType(
+        runtime, array.getValueAtIndex(runtime, 0), (T *)nullptr);
+  }
+
+  template <typename T>
+  static bool checkValueType(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      better::map<std::string, T> *type) noexcept {
+    if (!value.isObject()) {
+      return false;
+    }
+
+    auto object = value.getObject(runtime);
+    if (object.isArray(runtime) || object.isFunction(runtime)) {
+      return false;
+    }
+
+    auto names = object.getPropertyNames(runtime);
+    if (names.size(runtime) == 0) {
+      return true;
+    }
+
+    // Note: We test only one element.
+    auto name = names.getValueAtIndex(runtime, 0).getString(runtime);
+    return checkValueType(
+        runtime, object.getProperty(runtime, name), (T *)nullptr);
+  }
+
+  // Casts of JavaScript values
+  static RawValue castValue(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      RawValue *type) noexcept {
+    return RawValue(runtime, jsi::Value(runtime, value));
+  }
+
+  static bool castValue(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      bool *type) noexcept {
+    return value.getBool();
+  }
+
+  static int castValue(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      int *type) noexcept {
+    return value.getNumber();
+  }
+
+  static int64_t castValue(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      int64_t *type) noexcept {
+    return value.getNumber();
+  }
+
+  static float castValue(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      float *type) noexcept {
+    return value.getNumber();
+  }
+
+  static double castValue(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      double *type) noexcept {
+    return value.getNumber();
+  }
+
+  static std::string castValue(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      std::string *type) noexcept {
+    return value.getString(runtime).utf8(runtime);
+  }
+
+  template <typename T>
+  static std::vector<T> castValue(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      std::vector<T> *type) noexcept {
+    auto array = value.getObject(runtime).getArray(runtime);
+    auto size = array.size(runtime);
+    auto result = std::vector<T>{};
+    result.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+      result.push_back(castValue(
+          runtime, array.getValueAtIndex(runtime, i), (T *)nullptr));
+    }
+    return result;
+  }
+
+  template <typename T>
+  static better::map<std::string, T> castValue(
+      jsi::Runtime &runtime,
+      const jsi::Value &value,
+      better::map<std::string, T> *type) noexcept {
+    auto object = value.getObject(runtime);
+    auto names = object.getPropertyNames(runtime);
+    auto size = names.size(runtime);
+    auto result = better::map<std::string, T>{};
+    for (size_t i = 0; i < size; i++) {
+      auto name = names.getValueAtIndex(runtime, i).getString(runtime);
+      result[name.utf8(runtime)] = castValue(
+          runtime, object.getProperty(runtime, name), (T *)nullptr);
+    }
+    return result;
+  }
 };
 
 } // namespace react
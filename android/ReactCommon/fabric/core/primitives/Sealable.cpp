@@ -24,7 +24,7 @@ namespace react {
  * http://en.cppreference.com/w/cpp/language/rule_of_three
  */
 
-#ifndef NDEBUG
+#if RN_SEALABLE_CHECKS
 
 Sealable::Sealable() : sealed_(false) {}
 
@@ -47,18 +47,8 @@ Sealable &Sealable::operator=(Sealable &&other) noexcept {
   return *this;
 }
 
-void Sealable::seal() const {
-  sealed_ = true;
-}
-
-bool Sealable::getSealed() const {
-  return sealed_;
-}
-
-void Sealable::ensureUnsealed() const {
-  if (sealed_) {
-    throw std::runtime_error("Attempt to mutate a sealed object.");
-  }
+void Sealable::throwSealedMutation() {
+  throw std::runtime_error("Attempt to mutate a sealed object.");
 }
 
 #endif
@@ -40,17 +40,28 @@ namespace react {
  * detect problems earlier.)
  *   3. Call `seal()` at some point from which any modifications
  *      must be prevented.
+ *
+ * The checks only exist in debug builds: in release builds `Sealable` has no
+ * state (so it takes no space as a base class) and all of its methods are
+ * empty static ones, which leave nothing behind in the hot paths calling them
+ * (or in the `this` adjustments to reach a virtual base). Strict builds for QA
+ * can keep the checks in release by defining `RN_SEALABLE_CHECKS` to `1`,
+ * which needs to be the same for everything that includes this file.
  */
 
-#ifdef NDEBUG
+#if !defined(NDEBUG) && !defined(RN_SEALABLE_CHECKS)
+#define RN_SEALABLE_CHECKS 1
+#endif
+
+#if !RN_SEALABLE_CHECKS
 
 class Sealable {
  public:
-  inline void seal() const {}
-  inline bool getSealed() const {
+  static inline void seal() {}
+  static inline bool getSealed() {
     return true;
   }
-  inline void ensureUnsealed() const {}
+  static inline void ensureUnsealed() {}
 };
 
 #else
@@ -67,21 +78,34 @@ class Sealable {
   /*
    * Seals the object. This operation is irreversible;
    * the object cannot be "unsealed" after being sealing.
+   * The flag is only a check: sealed objects get to other threads through
+   * something which synchronizes them anyway (e.g. a commit), so relaxed
+   * accesses are enough and keep the checks cheap.
    */
-  void seal() const;
+  inline void seal() const {
+    sealed_.store(true, std::memory_order_relaxed);
+  }
 
   /*
    * Returns if the object already sealed or not.
    */
-  bool getSealed() const;
+  inline bool getSealed() const {
+    return sealed_.load(std::memory_order_relaxed);
+  }
 
   /*
    * Throws an exception if the object is sealed.
    * Call this from all non-`const` methods.
    */
-  void ensureUnsealed() const;
+  inline void ensureUnsealed() const {
+    if (sealed_.load(std::memory_order_relaxed)) {
+      throwSealedMutation();
+    }
+  }
 
  private:
+  [[noreturn]] static void throwSealedMutation();
+
   mutable std::atomic<bool> sealed_{false};
 };
 
@@ -10,6 +10,7 @@
 #include <better/optional.h>
 #include <folly/Likely.h>
 #include <folly/dynamic.h>
+#include <react/core/PropsGroup.h>
 #include <react/core/RawProps.h>
 #include <react/graphics/Color.h>
 #include <react/graphics/Geometry.h>
@@ -96,5 +97,34 @@ static better::optional<T> convertRawProp(
   return better::optional<T>{result};
 }
 
+/*
+ * Sets the `field` of the props `group` from `rawProps`, copying the group
+ * only if the prop is present and its value actually differs.
+ */
+template <typename GroupT, typename T, typename U = T>
+void setRawProp(
+    RawProps const &rawProps,
+    char const *name,
+    PropsGroup<GroupT> &group,
+    T GroupT::*field,
+    U const &defaultValue = U()) {
+  const auto *rawValue = rawProps.at(name, nullptr, nullptr);
+
+  if (LIKELY(rawValue == nullptr)) {
+    return;
+  }
+
+  T result = defaultValue;
+  if (LIKELY(rawValue->hasValue())) {
+    fromRawValue(*rawValue, result);
+  }
+
+  if ((*group).*field == result) {
+    return;
+  }
+
+  group.edit().*field = std::move(result);
+}
+
 } // namespace react
 } // namespace facebook
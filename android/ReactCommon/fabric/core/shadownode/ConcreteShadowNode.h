@@ -11,6 +11,7 @@
 #include <react/core/Props.h>
 #include <react/core/ShadowNode.h>
 #include <react/core/StateData.h>
+#include <react/utils/SimpleThreadSafeCache.h>
 
 namespace facebook {
 namespace react {
@@ -50,13 +51,31 @@ class ConcreteShadowNode : public ShadowNode {
     return ComponentHandle(concreteComponentName);
   }
 
+  /*
+   * Creates props from given `rawProps` on top of `baseProps` (or the default
+   * props). Props are immutable, so structurally identical ones are shared:
+   * empty `rawProps` return `baseProps` as is, and props created from scratch
+   * come from a cache keyed by the raw props, because sibling nodes (e.g. list
+   * items) often have identical ones. Sharing saves memory and makes the
+   * pointer comparisons of the differentiator succeed more often.
+   */
   static SharedConcreteProps Props(
       const RawProps &rawProps,
       const SharedProps &baseProps = nullptr) {
+    if (rawProps.isEmpty()) {
+      return baseProps ? std::static_pointer_cast<const PropsT>(baseProps)
+                       : defaultSharedProps();
+    }
+
+    if (!baseProps) {
+      return propsCache().get(
+          rawProps.toDynamic(), [&](folly::dynamic const &) {
+            return std::make_shared<const PropsT>(PropsT(), rawProps);
+          });
+    }
+
     return std::make_shared<const PropsT>(
-        baseProps ? *std::static_pointer_cast<const PropsT>(baseProps)
-                  : PropsT(),
-        rawProps);
+        *std::static_pointer_cast<const PropsT>(baseProps), rawProps);
   }
 
   static SharedConcreteProps defaultSharedProps() {
@@ -65,6 +84,7 @@ class ConcreteShadowNode : public ShadowNode {
     return defaultSharedProps;
   }
 
+
   static ConcreteStateData initialStateData(
       ShadowNodeFragment const &fragment,
       ComponentDescriptor const &componentDescriptor) {
@@ -128,6 +148,16 @@ class ConcreteShadowNode : public ShadowNode {
     }
     return children;
   }
+
+ private:
+  using PropsCache =
+      SimpleThreadSafeCache<folly::dynamic, SharedConcreteProps, 256>;
+
+  static PropsCache const &propsCache() {
+    // Leaked, so that props can be created during static destruction.
+    static auto const *propsCache = new PropsCache();
+    return *propsCache;
+  }
 };
 
 } // namespace react
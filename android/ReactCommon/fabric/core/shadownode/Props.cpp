@@ -13,14 +13,52 @@
 namespace facebook {
 namespace react {
 
+#ifdef ANDROID
+static folly::dynamic mergeRawProps(
+    folly::dynamic const &sourceRawProps,
+    RawProps const &rawProps) {
+  auto changedRawProps = (folly::dynamic)rawProps;
+  if (!sourceRawProps.isObject() || !changedRawProps.isObject()) {
+    return changedRawProps;
+  }
+  return folly::dynamic::merge(sourceRawProps, changedRawProps);
+}
+#endif
+
 Props::Props(const Props &sourceProps, const RawProps &rawProps)
     : nativeId(convertRawProp(rawProps, "nativeID", sourceProps.nativeId)),
       revision(sourceProps.revision + 1)
 #ifdef ANDROID
       ,
-      rawProps((folly::dynamic)rawProps)
+      rawProps(mergeRawProps(sourceProps.rawProps, rawProps))
 #endif
           {};
 
+folly::dynamic diffRawProps(
+    folly::dynamic const &oldRawProps,
+    folly::dynamic const &newRawProps) {
+  if (!oldRawProps.isObject() || !newRawProps.isObject()) {
+    return newRawProps;
+  }
+
+  folly::dynamic delta = folly::dynamic::object();
+  for (auto const &pair : newRawProps.items()) {
+    auto const oldValue = oldRawProps.get_ptr(pair.first);
+    if (!oldValue || *oldValue != pair.second) {
+      delta.insert(pair.first, pair.second);
+    }
+  }
+  return delta;
+}
+
+#ifdef ANDROID
+folly::dynamic diffRawProps(Props const &oldProps, Props const &newProps) {
+  if (&oldProps == &newProps) {
+    return folly::dynamic::object();
+  }
+  return diffRawProps(oldProps.rawProps, newProps.rawProps);
+}
+#endif
+
 } // namespace react
 } // namespace facebook
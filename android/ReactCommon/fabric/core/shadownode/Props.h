@@ -22,8 +22,14 @@ using SharedProps = std::shared_ptr<Props const>;
 
 /*
  * Represents the most generic props object.
+ * Release builds omit the `DebugStringConvertible` base, along with the
+ * virtual base bookkeeping that it would cost every props object.
  */
-class Props : public virtual Sealable, public virtual DebugStringConvertible {
+class Props :
+#if RN_DEBUG_STRING_CONVERTIBLE
+    public virtual DebugStringConvertible,
+#endif
+    public virtual Sealable {
  public:
   using Shared = std::shared_ptr<Props const>;
 
@@ -43,9 +49,29 @@ class Props : public virtual Sealable, public virtual DebugStringConvertible {
   int const revision{0};
 
 #ifdef ANDROID
+  /*
+   * All raw props the object was built from: the ones of the source `Props`
+   * object with the ones it was cloned with merged on top of them.
+   */
   folly::dynamic const rawProps = folly::dynamic::object();
 #endif
 };
 
+/*
+ * Returns the entries of `newRawProps` which have to be sent to a view which
+ * has `oldRawProps` mounted, i.e. all of them except the ones that have the
+ * same values in both.
+ */
+folly::dynamic diffRawProps(
+    folly::dynamic const &oldRawProps,
+    folly::dynamic const &newRawProps);
+
+#ifdef ANDROID
+/*
+ * Same as above, for the `rawProps` of the given `Props`.
+ */
+folly::dynamic diffRawProps(Props const &oldProps, Props const &newProps);
+#endif
+
 } // namespace react
 } // namespace facebook
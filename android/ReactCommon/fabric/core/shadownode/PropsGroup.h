@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+
+namespace facebook {
+namespace react {
+
+/*
+ * Holds a group of props that is shared between `Props` objects until one of
+ * them changes a prop of the group (copy-on-write).
+ * Cloning `Props` with raw props that do not touch the group costs a reference
+ * count increment instead of copying (and allocating) every prop of the group.
+ * `GroupT` must be copyable and default constructible; a default constructed
+ * group is shared by all default `Props` objects.
+ */
+template <typename GroupT>
+class PropsGroup final {
+ public:
+  PropsGroup() : group_(getDefaultGroup()) {}
+
+  GroupT const &operator*() const {
+    return *group_;
+  }
+
+  GroupT const *operator->() const {
+    return group_.get();
+  }
+
+  /*
+   * Returns a mutable group, copying the shared one first if this object is
+   * not its only owner.
+   * Must only be used while the owning `Props` object is being constructed.
+   */
+  GroupT &edit() {
+    if (group_.use_count() != 1) {
+      group_ = std::make_shared<GroupT>(*group_);
+    }
+    return *group_;
+  }
+
+  /*
+   * Returns `true` if both objects share the same group.
+   */
+  bool isSharedWith(PropsGroup const &rhs) const {
+    return group_ == rhs.group_;
+  }
+
+  /*
+   * Groups are equal if they are shared or if their props are equal.
+   */
+  bool operator==(PropsGroup const &rhs) const {
+    return isSharedWith(rhs) || *group_ == *rhs.group_;
+  }
+
+  bool operator!=(PropsGroup const &rhs) const {
+    return !(*this == rhs);
+  }
+
+ private:
+  static std::shared_ptr<GroupT> const &getDefaultGroup() {
+    static auto const defaultGroup = std::make_shared<GroupT>();
+    return defaultGroup;
+  }
+
+  std::shared_ptr<GroupT> group_;
+};
+
+} // namespace react
+} // namespace facebook
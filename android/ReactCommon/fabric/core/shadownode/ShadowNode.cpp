@@ -14,6 +14,7 @@
 #include <react/core/ShadowNodeFragment.h>
 #include <react/debug/DebugStringConvertible.h>
 #include <react/debug/debugStringConvertibleUtils.h>
+#include <react/utils/PoolAllocator.h>
 
 namespace facebook {
 namespace react {
@@ -26,6 +27,12 @@ SharedShadowNodeSharedList ShadowNode::emptySharedShadowNodeSharedList() {
   return emptySharedShadowNodeSharedList;
 }
 
+SharedShadowNodeUnsharedList ShadowNode::makeSharedShadowNodeList(
+    SharedShadowNodeList const &children) {
+  return std::allocate_shared<SharedShadowNodeList>(
+      PoolAllocator<SharedShadowNodeList>{}, children);
+}
+
 bool ShadowNode::sameFamily(const ShadowNode &first, const ShadowNode &second) {
   return first.family_ == second.family_;
 }
@@ -45,14 +52,11 @@ ShadowNode::ShadowNode(
           fragment.surfaceId,
           fragment.eventEmitter,
           componentDescriptor)),
-      childrenAreShared_(true),
-      revision_(1) {
+      childrenAreShared_(true) {
   assert(props_);
   assert(children_);
 
-  for (const auto &child : *children_) {
-    child->family_->setParent(family_);
-  }
+  adoptChildren();
 }
 
 ShadowNode::ShadowNode(
@@ -68,8 +72,11 @@ ShadowNode::ShadowNode(
           fragment.state ? fragment.state
                          : sourceShadowNode.getMostRecentState()),
       family_(sourceShadowNode.family_),
-      childrenAreShared_(true),
-      revision_(sourceShadowNode.revision_ + 1) {
+      childrenAreShared_(true) {
+#if RN_DEBUG_STRING_CONVERTIBLE
+  revision_ = sourceShadowNode.revision_ + 1;
+#endif
+
   // `tag`, `surfaceId`, and `eventEmitter` cannot be changed with cloning.
   assert(fragment.tag == ShadowNodeFragment::tagPlaceholder());
   assert(fragment.surfaceId == ShadowNodeFragment::surfaceIdPlaceholder());
@@ -80,9 +87,7 @@ ShadowNode::ShadowNode(
   assert(children_);
 
   if (fragment.children) {
-    for (const auto &child : *children_) {
-      child->family_->setParent(family_);
-    }
+    adoptChildren();
   }
 }
 
@@ -145,7 +150,7 @@ void ShadowNode::sealRecursive() const {
 
   props_->seal();
 
-  for (auto child : *children_) {
+  for (auto const &child : *children_) {
     child->sealRecursive();
   }
 }
@@ -161,6 +166,9 @@ void ShadowNode::appendChild(const SharedShadowNode &child) {
   nonConstChildren->push_back(child);
 
   child->family_->setParent(family_);
+  child->family_->childIndexHint_.store(
+      static_cast<int>(nonConstChildren->size()) - 1,
+      std::memory_order_relaxed);
 }
 
 void ShadowNode::replaceChild(
@@ -197,7 +205,16 @@ void ShadowNode::cloneChildrenIfShared() {
     return;
   }
   childrenAreShared_ = false;
-  children_ = std::make_shared<SharedShadowNodeList>(*children_);
+  children_ = makeSharedShadowNodeList(*children_);
+}
+
+void ShadowNode::adoptChildren() const {
+  auto childIndex = int{0};
+  for (auto const &child : *children_) {
+    child->family_->setParent(family_);
+    child->family_->childIndexHint_.store(
+        childIndex++, std::memory_order_relaxed);
+  }
 }
 
 void ShadowNode::setMounted(bool mounted) const {
@@ -228,22 +245,32 @@ AncestorList ShadowNode::getAncestors(
   auto parentNode = &ancestorShadowNode;
   for (auto it = families.rbegin(); it != families.rend(); it++) {
     auto childFamily = *it;
-    auto found = bool{false};
-    auto childIndex = int{0};
-    for (const auto &childNode : *parentNode->children_) {
-      if (childNode->family_.get() == childFamily) {
-        ancestors.push_back({*parentNode, childIndex});
-        parentNode = childNode.get();
-        found = true;
-        break;
+    auto const &children = *parentNode->children_;
+    auto const childrenCount = static_cast<int>(children.size());
+
+    // Children lists rarely change between revisions, so the index of the
+    // child in the most recently built list is usually right.
+    auto childIndex =
+        childFamily->childIndexHint_.load(std::memory_order_relaxed);
+    if (childIndex >= childrenCount ||
+        children[childIndex]->family_.get() != childFamily) {
+      childIndex = 0;
+      while (childIndex < childrenCount &&
+             children[childIndex]->family_.get() != childFamily) {
+        childIndex++;
+      }
+
+      if (childIndex == childrenCount) {
+        ancestors.clear();
+        return ancestors;
       }
-      childIndex++;
-    }
 
-    if (!found) {
-      ancestors.clear();
-      return ancestors;
+      childFamily->childIndexHint_.store(
+          childIndex, std::memory_order_relaxed);
     }
+
+    ancestors.push_back({*parentNode, childIndex});
+    parentNode = children[childIndex].get();
   }
 
   return ancestors;
@@ -39,8 +39,15 @@ using SharedShadowNodeList =
 using SharedShadowNodeSharedList = std::shared_ptr<const SharedShadowNodeList>;
 using SharedShadowNodeUnsharedList = std::shared_ptr<SharedShadowNodeList>;
 
+/*
+ * Release builds omit the `DebugStringConvertible` base and the debug-only
+ * data, so debug descriptions (which are built lazily, only when requested)
+ * cost shadow nodes neither memory nor vtable entries.
+ */
 class ShadowNode : public virtual Sealable,
+#if RN_DEBUG_STRING_CONVERTIBLE
                    public virtual DebugStringConvertible,
+#endif
                    public std::enable_shared_from_this<ShadowNode> {
  public:
   using Shared = std::shared_ptr<ShadowNode const>;
@@ -59,6 +66,14 @@ class ShadowNode : public virtual Sealable,
 
   static SharedShadowNodeSharedList emptySharedShadowNodeSharedList();
 
+  /*
+   * Creates a new list of children with the given nodes.
+   * Lists are copied on every change of children of every cloned node, so
+   * their memory is recycled (see `PoolAllocator`).
+   */
+  static SharedShadowNodeUnsharedList makeSharedShadowNodeList(
+      SharedShadowNodeList const &children = {});
+
   /*
    * Returns `true` if nodes belong to the same family (they were cloned one
    * from each other or from the same source node).
@@ -147,7 +162,8 @@ class ShadowNode : public virtual Sealable,
   /*
    * Performs all side effects associated with mounting/unmounting in one place.
    * This is not `virtual` on purpose, do not override this.
-   * `EventEmitter::DispatchMutex()` must be acquired before calling.
+   * Calls for nodes of the same tree must not run concurrently and must follow
+   * the order of commits (which `ShadowTree` ensures).
    */
   void setMounted(bool mounted) const;
 
@@ -158,7 +174,9 @@ class ShadowNode : public virtual Sealable,
    * node and an index of the child of the parent node.
    * Returns an empty array if there is no ancestor-descendant relationship.
    * Can be called from any thread.
-   * The theoretical complexity of the algorithm is `O(ln(n))`. Use it wisely.
+   * The complexity of the algorithm is `O(depth)` as long as the positions of
+   * the ancestors among their siblings match the most recently sealed tree,
+   * and `O(depth * siblings)` in the worst case. Use it wisely.
    */
   AncestorList getAncestors(ShadowNode const &ancestorShadowNode) const;
 
@@ -184,6 +202,12 @@ class ShadowNode : public virtual Sealable,
    */
   void cloneChildrenIfShared();
 
+  /*
+   * Makes this node's family the parent of the families of `children_` and
+   * sets their child index hints.
+   */
+  void adoptChildren() const;
+
   /*
    * Pointer to a family object that this shadow node belongs to.
    */
@@ -195,12 +219,14 @@ class ShadowNode : public virtual Sealable,
    */
   bool childrenAreShared_;
 
+#if RN_DEBUG_STRING_CONVERTIBLE
   /*
    * A number of the generation of the ShadowNode instance;
    * is used and useful for debug-printing purposes *only*.
    * Do not access this value in any circumstances.
    */
-  const int revision_;
+  int revision_{1};
+#endif
 };
 
 } // namespace react
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 
 #include <react/core/EventEmitter.h>
@@ -73,6 +74,14 @@ class ShadowNodeFamily {
    * For optimization purposes only.
    */
   mutable bool hasParent_{false};
+
+  /*
+   * Index of a node of the family in the children list of its parent node
+   * that was most recently built (or searched by `getAncestors`).
+   * A hint only: children lists of other revisions might differ, so it must be
+   * checked before being used.
+   */
+  mutable std::atomic<int> childIndexHint_{0};
 };
 
 } // namespace react
@@ -9,6 +9,7 @@
 
 #include <functional>
 #include <memory>
+#include <type_traits>
 
 #include <react/core/State.h>
 
@@ -92,9 +93,37 @@ class ConcreteState : public State {
   void updateState(folly::dynamic data) const override {
     updateState(std::move(Data(data)));
   }
+
+  /*
+   * Supported if `Data` has a constructor taking the old data and a `Point`
+   * (or a `Size`) respectively.
+   */
+  bool updateStatePoint(Point point) const override {
+    return updateStateWithValue(
+        point, std::is_constructible<Data, Data const &, Point>{});
+  }
+
+  bool updateStateSize(Size size) const override {
+    return updateStateWithValue(
+        size, std::is_constructible<Data, Data const &, Size>{});
+  }
 #endif
 
  private:
+#ifdef ANDROID
+  template <typename ValueT>
+  bool updateStateWithValue(ValueT value, std::true_type) const {
+    updateState(
+        [value](Data const &oldData) -> Data { return Data(oldData, value); });
+    return true;
+  }
+
+  template <typename ValueT>
+  bool updateStateWithValue(ValueT value, std::false_type) const {
+    return false;
+  }
+#endif
+
   DataT data_;
 };
 
@@ -48,6 +48,12 @@ void State::updateState(folly::dynamic data) const {
       << "State::updateState should never be called (some virtual method of a concrete implementation should be called instead).";
   abort();
 }
+bool State::updateStatePoint(Point point) const {
+  return false;
+}
+bool State::updateStateSize(Size size) const {
+  return false;
+}
 #endif
 
 } // namespace react
@@ -9,6 +9,7 @@
 
 #include <folly/dynamic.h>
 #include <react/core/StateCoordinator.h>
+#include <react/graphics/Geometry.h>
 
 namespace facebook {
 namespace react {
@@ -31,6 +32,16 @@ class State {
 #ifdef ANDROID
   virtual const folly::dynamic getDynamic() const;
   virtual void updateState(folly::dynamic data) const;
+
+  /*
+   * Typed alternatives to `updateState(folly::dynamic)` for the kinds of
+   * state updated at high frequency from native code (e.g. scroll offsets or
+   * sizes of modals): no `folly::dynamic` is built and parsed for them.
+   * Return `false` if the state does not support the kind of update (then the
+   * caller should fall back to `updateState(folly::dynamic)`).
+   */
+  virtual bool updateStatePoint(Point point) const;
+  virtual bool updateStateSize(Size size) const;
 #endif
 
  protected:
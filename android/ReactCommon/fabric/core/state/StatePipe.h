@@ -8,6 +8,8 @@
 #pragma once
 
 #include <functional>
+#include <utility>
+#include <vector>
 
 #include <react/core/StateData.h>
 #include <react/core/StateTarget.h>
@@ -15,8 +17,13 @@
 namespace facebook {
 namespace react {
 
-using StatePipe = std::function<
-    void(const StateData::Shared &data, const StateTarget &target)>;
+/*
+ * Applies all state updates that were enqueued within one beat (pairs of
+ * a target and new state data, in order of enqueueing) at once.
+ */
+using StatePipe = std::function<void(
+    const std::vector<std::pair<StateTarget, StateData::Shared>>
+        &stateUpdates)>;
 
 } // namespace react
 } // namespace facebook
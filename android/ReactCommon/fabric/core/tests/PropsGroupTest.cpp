@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include <react/core/PropsGroup.h>
+
+using namespace facebook::react;
+
+namespace {
+struct TestGroup {
+  std::string label{""};
+  int count{0};
+
+  bool operator==(TestGroup const &rhs) const {
+    return label == rhs.label && count == rhs.count;
+  }
+};
+} // namespace
+
+TEST(PropsGroupTest, defaultGroupsAreShared) {
+  PropsGroup<TestGroup> first;
+  PropsGroup<TestGroup> second;
+  EXPECT_TRUE(first.isSharedWith(second));
+  EXPECT_EQ(first->label, "");
+  EXPECT_EQ(first->count, 0);
+}
+
+TEST(PropsGroupTest, editCopiesSharedGroups) {
+  PropsGroup<TestGroup> source;
+  source.edit().label = "source";
+
+  auto copy = source;
+  EXPECT_TRUE(copy.isSharedWith(source));
+
+  copy.edit().label = "copy";
+  EXPECT_FALSE(copy.isSharedWith(source));
+  EXPECT_EQ(source->label, "source");
+  EXPECT_EQ(copy->label, "copy");
+  EXPECT_FALSE(PropsGroup<TestGroup>{}.isSharedWith(source));
+  EXPECT_EQ(PropsGroup<TestGroup>{}->label, "");
+}
+
+TEST(PropsGroupTest, editKeepsGroupsOwnedByOneObject) {
+  PropsGroup<TestGroup> group;
+  auto &edited = group.edit();
+  edited.count = 1;
+
+  EXPECT_EQ(&group.edit(), &edited);
+  EXPECT_EQ(&*group, &edited);
+  EXPECT_EQ(group->count, 1);
+}
+
+TEST(PropsGroupTest, groupsWithEqualPropsAreEqual) {
+  PropsGroup<TestGroup> first;
+  first.edit().label = "label";
+  auto shared = first;
+  PropsGroup<TestGroup> second;
+  second.edit().label = "label";
+  PropsGroup<TestGroup> different;
+  different.edit().label = "other";
+
+  EXPECT_EQ(first, shared);
+  EXPECT_FALSE(first.isSharedWith(second));
+  EXPECT_EQ(first, second);
+  EXPECT_NE(first, different);
+  EXPECT_NE(first, PropsGroup<TestGroup>{});
+}
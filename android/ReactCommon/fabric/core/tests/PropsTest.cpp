@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <react/core/Props.h>
+#include <react/core/RawPropsParser.h>
+
+#include "TestComponent.h"
+
+using namespace facebook::react;
+
+TEST(PropsTest, diffRawPropsKeepsOnlyChangedValues) {
+  folly::dynamic const oldRawProps = folly::dynamic::object("opacity", 0.5)(
+      "backgroundColor", 0xff0000ff)("transform", folly::dynamic::array(1, 2));
+  folly::dynamic const newRawProps = folly::dynamic::object("opacity", 0.6)(
+      "backgroundColor", 0xff0000ff)("transform", folly::dynamic::array(1, 2))(
+      "nativeID", "view");
+  folly::dynamic const delta =
+      folly::dynamic::object("opacity", 0.6)("nativeID", "view");
+
+  EXPECT_EQ(diffRawProps(oldRawProps, newRawProps), delta);
+}
+
+TEST(PropsTest, diffRawPropsKeepsValuesMissingInOldProps) {
+  folly::dynamic const emptyRawProps = folly::dynamic::object();
+  folly::dynamic const oldRawProps = folly::dynamic::object("opacity", 0.5);
+  folly::dynamic const newRawProps =
+      folly::dynamic::object("opacity", 0.5)("pointerEvents", nullptr);
+  folly::dynamic const delta = folly::dynamic::object("pointerEvents", nullptr);
+
+  EXPECT_EQ(diffRawProps(emptyRawProps, newRawProps), newRawProps);
+  EXPECT_EQ(diffRawProps(oldRawProps, newRawProps), delta);
+  EXPECT_EQ(diffRawProps(newRawProps, newRawProps), emptyRawProps);
+}
+
+static SharedTestProps testProps(
+    folly::dynamic const &rawPropsValue,
+    SharedProps const &baseProps = nullptr) {
+  auto parser = RawPropsParser();
+  parser.prepare<TestProps>();
+  auto const &rawProps = RawProps(rawPropsValue);
+  rawProps.parse(parser);
+  return TestShadowNode::Props(rawProps, baseProps);
+}
+
+TEST(PropsTest, identicalRawPropsShareProps) {
+  auto const props = testProps(folly::dynamic::object("nativeID", "item"));
+  EXPECT_EQ(props->nativeId, "item");
+  EXPECT_EQ(testProps(folly::dynamic::object("nativeID", "item")), props);
+  EXPECT_NE(testProps(folly::dynamic::object("nativeID", "other")), props);
+}
+
+TEST(PropsTest, emptyRawPropsReuseBaseProps) {
+  auto const props = testProps(folly::dynamic::object("nativeID", "base"));
+  auto const &emptyRawProps = RawProps();
+  EXPECT_EQ(TestShadowNode::Props(emptyRawProps, props), props);
+  EXPECT_EQ(
+      TestShadowNode::Props(emptyRawProps), TestShadowNode::defaultSharedProps());
+
+  auto const cloned =
+      testProps(folly::dynamic::object("nativeID", "cloned"), props);
+  EXPECT_NE(cloned, props);
+  EXPECT_EQ(cloned->nativeId, "cloned");
+}
+
+#ifdef ANDROID
+TEST(PropsTest, clonedPropsKeepSourceRawProps) {
+  auto const props = testProps(
+      folly::dynamic::object("nativeID", "item")("opacity", 0.5));
+  auto const cloned = testProps(folly::dynamic::object("opacity", 1), props);
+  folly::dynamic const rawProps =
+      folly::dynamic::object("nativeID", "item")("opacity", 1);
+  folly::dynamic const delta = folly::dynamic::object("opacity", 1);
+
+  EXPECT_EQ(cloned->rawProps, rawProps);
+  EXPECT_EQ(diffRawProps(*props, *cloned), delta);
+}
+#endif
@@ -8,6 +8,8 @@
 #include <benchmark/benchmark.h>
 #include <folly/dynamic.h>
 #include <folly/json.h>
+#include <jsi/JSCRuntime.h>
+#include <jsi/JSIDynamic.h>
 #include <react/components/view/ViewComponentDescriptor.h>
 #include <react/core/EventDispatcher.h>
 #include <react/core/RawProps.h>
@@ -32,6 +34,16 @@ auto propsStringWithSomeUnsupportedProps = std::string{
 auto unsupportedPropsDynamic =
     folly::parseJson(propsStringWithSomeUnsupportedProps);
 
+auto propsStringWithArraysAndObjects = std::string{
+    "{\"flex\": 1, \"nativeID\": \"some-id\", \"pointerEvents\": \"box-none\", \"transform\": [{\"translateX\": 10}, {\"scale\": 2}, {\"rotate\": \"45deg\"}], \"hitSlop\": {\"top\": 10, \"left\": 10, \"bottom\": 10, \"right\": 10}}"};
+auto propsDynamicWithArraysAndObjects =
+    folly::parseJson(propsStringWithArraysAndObjects);
+
+auto runtime = jsc::makeJSCRuntime();
+auto propsValue = jsi::valueFromDynamic(*runtime, propsDynamic);
+auto propsValueWithArraysAndObjects =
+    jsi::valueFromDynamic(*runtime, propsDynamicWithArraysAndObjects);
+
 auto sourceProps = ViewProps{};
 auto sharedSourceProps = ViewShadowNode::defaultSharedProps();
 
@@ -74,6 +86,31 @@ static void propParsingRegularRawPropsWithNoSourceProps(
 }
 BENCHMARK(propParsingRegularRawPropsWithNoSourceProps);
 
+static void propParsingRegularJSIRawProps(benchmark::State &state) {
+  for (auto _ : state) {
+    viewComponentDescriptor.cloneProps(
+        sharedSourceProps, RawProps{*runtime, propsValue});
+  }
+}
+BENCHMARK(propParsingRegularJSIRawProps);
+
+static void propParsingRawPropsWithArraysAndObjects(benchmark::State &state) {
+  for (auto _ : state) {
+    viewComponentDescriptor.cloneProps(
+        sharedSourceProps, RawProps{propsDynamicWithArraysAndObjects});
+  }
+}
+BENCHMARK(propParsingRawPropsWithArraysAndObjects);
+
+static void propParsingJSIRawPropsWithArraysAndObjects(
+    benchmark::State &state) {
+  for (auto _ : state) {
+    viewComponentDescriptor.cloneProps(
+        sharedSourceProps, RawProps{*runtime, propsValueWithArraysAndObjects});
+  }
+}
+BENCHMARK(propParsingJSIRawPropsWithArraysAndObjects);
+
 } // namespace react
 } // namespace facebook
 
@@ -5,13 +5,37 @@
 
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
+
 #ifdef WITH_FBSYSTRACE
 #include <fbsystrace.h>
+#include <folly/Optional.h>
+#endif
+
+/**
+ * The trace categories which are compiled in, as a mask of TraceCategory
+ * values (see cxxreact/SystraceSection.h, which defines the same ones).
+ */
+#ifndef REACT_NATIVE_TRACE_CATEGORIES
+#define REACT_NATIVE_TRACE_CATEGORIES 0xffffffffu
 #endif
 
 namespace facebook {
 namespace react {
 
+enum class TraceCategory : uint32_t {
+  Bridge = 1 << 0,
+  NativeModules = 1 << 1,
+  JSI = 1 << 2,
+  TurboModules = 1 << 3,
+  Fabric = 1 << 4,
+};
+
+constexpr bool isTraceCategoryCompiledIn(TraceCategory category) {
+  return (REACT_NATIVE_TRACE_CATEGORIES & static_cast<uint32_t>(category)) != 0;
+}
+
 /**
  * This is a convenience class to avoid lots of verbose profiling
  * #ifdefs.  If WITH_FBSYSTRACE is not defined, the optimizer will
@@ -20,21 +44,30 @@ namespace react {
  * to ensure that the ODR rule isn't violated, that is, if WITH_FBSYSTRACE has
  * different values in different files, there is no inconsistency in the sizes
  * of defined symbols.
+ *
+ * Whether tracing is enabled is checked once, before the section or any of its
+ * arguments is formatted, so sections cost a single atomic load while nothing
+ * is being traced.
  */
 #ifdef WITH_FBSYSTRACE
-struct ConcreteSystraceSection {
+template <TraceCategory Category>
+struct ConcreteTraceSection {
  public:
   template <typename... ConvertsToStringPiece>
-  explicit ConcreteSystraceSection(
+  explicit ConcreteTraceSection(
       const char *name,
-      ConvertsToStringPiece &&... args)
-      : m_section(TRACE_TAG_REACT_CXX_BRIDGE, name, args...) {}
+      ConvertsToStringPiece &&... args) {
+    if (fbsystrace_is_tracing(TRACE_TAG_REACT_CXX_BRIDGE)) {
+      m_section.emplace(TRACE_TAG_REACT_CXX_BRIDGE, name, args...);
+    }
+  }
 
  private:
-  fbsystrace::FbSystraceSection m_section;
+  folly::Optional<fbsystrace::FbSystraceSection> m_section;
 };
-using SystraceSection = ConcreteSystraceSection;
-#else
+using ConcreteSystraceSection = ConcreteTraceSection<TraceCategory::Fabric>;
+#endif
+
 struct DummySystraceSection {
  public:
   template <typename... ConvertsToStringPiece>
@@ -42,8 +75,33 @@ struct DummySystraceSection {
       const char *name,
       ConvertsToStringPiece &&... args) {}
 };
-using SystraceSection = DummySystraceSection;
+
+#ifdef WITH_FBSYSTRACE
+template <TraceCategory Category>
+using TraceSection = typename std::conditional<
+    isTraceCategoryCompiledIn(Category),
+    ConcreteTraceSection<Category>,
+    DummySystraceSection>::type;
+#else
+template <TraceCategory Category>
+using TraceSection = DummySystraceSection;
+#endif
+
+using SystraceSection = TraceSection<TraceCategory::Fabric>;
+
+/**
+ * Records the value of a counter track (e.g. the number of pending
+ * transactions), which the trace shows as a graph over time.
+ */
+template <TraceCategory Category = TraceCategory::Fabric>
+inline void traceCounter(const char *name, int64_t value) {
+#ifdef WITH_FBSYSTRACE
+  if (isTraceCategoryCompiledIn(Category) &&
+      fbsystrace_is_tracing(TRACE_TAG_REACT_CXX_BRIDGE)) {
+    fbsystrace_counter(TRACE_TAG_REACT_CXX_BRIDGE, name, value);
+  }
 #endif
+}
 
 } // namespace react
 } // namespace facebook
@@ -28,6 +28,12 @@ struct Point {
     return *this;
   }
 
+  Point &operator-=(const Point &point) {
+    x -= point.x;
+    y -= point.y;
+    return *this;
+  }
+
   Point &operator*=(const Point &point) {
     x *= point.x;
     y *= point.y;
@@ -38,6 +44,10 @@ struct Point {
     return lhs += rhs;
   }
 
+  friend Point operator-(Point lhs, const Point &rhs) {
+    return lhs -= rhs;
+  }
+
   bool operator==(const Point &rhs) const {
     return std::tie(this->x, this->y) == std::tie(rhs.x, rhs.y);
   }
@@ -112,6 +122,23 @@ struct Rect {
     origin = {x1, y1};
     size = {x2 - x1, y2 - y1};
   }
+
+  void intersectInPlace(const Rect &rect) {
+    auto x1 = std::max(getMinX(), rect.getMinX());
+    auto y1 = std::max(getMinY(), rect.getMinY());
+    auto x2 = std::max(x1, std::min(getMaxX(), rect.getMaxX()));
+    auto y2 = std::max(y1, std::min(getMaxY(), rect.getMaxY()));
+    origin = {x1, y1};
+    size = {x2 - x1, y2 - y1};
+  }
+
+  /*
+   * Returns `true` if the rectangles overlap or touch each other.
+   */
+  bool intersects(const Rect &rect) const {
+    return getMinX() <= rect.getMaxX() && rect.getMinX() <= getMaxX() &&
+        getMinY() <= rect.getMaxY() && rect.getMinY() <= getMaxY();
+  }
 };
 
 /*
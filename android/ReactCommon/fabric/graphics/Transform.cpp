@@ -7,6 +7,12 @@
 
 #include <cmath>
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 namespace facebook {
 namespace react {
 
@@ -97,55 +103,192 @@ bool Transform::operator!=(Transform const &rhs) const {
   return !(*this == rhs);
 }
 
+namespace {
+
+/*
+ * What a matrix does, as far as multiplying by it is concerned. The kind is
+ * derived from the matrix itself (and not stored), because `matrix` is public
+ * and is filled in directly (e.g. from a `matrix` transform prop).
+ */
+enum class TransformKind {
+  Identity,
+  // Only the translation row (`at(3, 0..2)`) differs from the identity.
+  Translate,
+  // Only the diagonal (`at(0..2, 0..2)`) differs from the identity.
+  Scale,
+  // Only the 2D part (`at(0..1, 0..1)` and `at(3, 0..1)`) differs from the
+  // identity: rotations around, scales and skews in, and translations along
+  // the XY plane.
+  Affine2D,
+  Arbitrary,
+};
+
+TransformKind transformKind(std::array<Float, 16> const &m) {
+  if (m[2] != 0 || m[3] != 0 || m[6] != 0 || m[7] != 0 || m[8] != 0 ||
+      m[9] != 0 || m[11] != 0 || m[15] != 1) {
+    return TransformKind::Arbitrary;
+  }
+  auto const isLinearIdentity =
+      m[0] == 1 && m[1] == 0 && m[4] == 0 && m[5] == 1 && m[10] == 1;
+  auto const isTranslationZero = m[12] == 0 && m[13] == 0 && m[14] == 0;
+  if (isLinearIdentity) {
+    return isTranslationZero ? TransformKind::Identity
+                             : TransformKind::Translate;
+  }
+  if (isTranslationZero && m[1] == 0 && m[4] == 0) {
+    return TransformKind::Scale;
+  }
+  return m[10] == 1 && m[14] == 0 ? TransformKind::Affine2D
+                                  : TransformKind::Arbitrary;
+}
+
+/*
+ * For all of these: `result.at(i, j)` is the sum of
+ * `rhs.at(i, k) * lhs.at(k, j)` over `k`, as `Transform::operator*` defines.
+ */
+template <typename T>
+void multiplyArbitrary(T const *lhs, T const *rhs, T *result) {
+  auto lhs00 = lhs[0], lhs01 = lhs[1], lhs02 = lhs[2], lhs03 = lhs[3],
+       lhs10 = lhs[4], lhs11 = lhs[5], lhs12 = lhs[6], lhs13 = lhs[7],
+       lhs20 = lhs[8], lhs21 = lhs[9], lhs22 = lhs[10], lhs23 = lhs[11],
+       lhs30 = lhs[12], lhs31 = lhs[13], lhs32 = lhs[14], lhs33 = lhs[15];
+
+  auto rhs0 = rhs[0], rhs1 = rhs[1], rhs2 = rhs[2], rhs3 = rhs[3];
+  result[0] = rhs0 * lhs00 + rhs1 * lhs10 + rhs2 * lhs20 + rhs3 * lhs30;
+  result[1] = rhs0 * lhs01 + rhs1 * lhs11 + rhs2 * lhs21 + rhs3 * lhs31;
+  result[2] = rhs0 * lhs02 + rhs1 * lhs12 + rhs2 * lhs22 + rhs3 * lhs32;
+  result[3] = rhs0 * lhs03 + rhs1 * lhs13 + rhs2 * lhs23 + rhs3 * lhs33;
+
+  rhs0 = rhs[4];
+  rhs1 = rhs[5];
+  rhs2 = rhs[6];
+  rhs3 = rhs[7];
+  result[4] = rhs0 * lhs00 + rhs1 * lhs10 + rhs2 * lhs20 + rhs3 * lhs30;
+  result[5] = rhs0 * lhs01 + rhs1 * lhs11 + rhs2 * lhs21 + rhs3 * lhs31;
+  result[6] = rhs0 * lhs02 + rhs1 * lhs12 + rhs2 * lhs22 + rhs3 * lhs32;
+  result[7] = rhs0 * lhs03 + rhs1 * lhs13 + rhs2 * lhs23 + rhs3 * lhs33;
+
+  rhs0 = rhs[8];
+  rhs1 = rhs[9];
+  rhs2 = rhs[10];
+  rhs3 = rhs[11];
+  result[8] = rhs0 * lhs00 + rhs1 * lhs10 + rhs2 * lhs20 + rhs3 * lhs30;
+  result[9] = rhs0 * lhs01 + rhs1 * lhs11 + rhs2 * lhs21 + rhs3 * lhs31;
+  result[10] = rhs0 * lhs02 + rhs1 * lhs12 + rhs2 * lhs22 + rhs3 * lhs32;
+  result[11] = rhs0 * lhs03 + rhs1 * lhs13 + rhs2 * lhs23 + rhs3 * lhs33;
+
+  rhs0 = rhs[12];
+  rhs1 = rhs[13];
+  rhs2 = rhs[14];
+  rhs3 = rhs[15];
+  result[12] = rhs0 * lhs00 + rhs1 * lhs10 + rhs2 * lhs20 + rhs3 * lhs30;
+  result[13] = rhs0 * lhs01 + rhs1 * lhs11 + rhs2 * lhs21 + rhs3 * lhs31;
+  result[14] = rhs0 * lhs02 + rhs1 * lhs12 + rhs2 * lhs22 + rhs3 * lhs32;
+  result[15] = rhs0 * lhs03 + rhs1 * lhs13 + rhs2 * lhs23 + rhs3 * lhs33;
+}
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+void multiplyArbitrary(float const *lhs, float const *rhs, float *result) {
+  auto const lhs0 = vld1q_f32(lhs);
+  auto const lhs1 = vld1q_f32(lhs + 4);
+  auto const lhs2 = vld1q_f32(lhs + 8);
+  auto const lhs3 = vld1q_f32(lhs + 12);
+  for (auto i = 0; i < 16; i += 4) {
+    auto row = vmulq_n_f32(lhs0, rhs[i]);
+    row = vmlaq_n_f32(row, lhs1, rhs[i + 1]);
+    row = vmlaq_n_f32(row, lhs2, rhs[i + 2]);
+    row = vmlaq_n_f32(row, lhs3, rhs[i + 3]);
+    vst1q_f32(result + i, row);
+  }
+}
+#elif defined(__SSE__)
+void multiplyArbitrary(float const *lhs, float const *rhs, float *result) {
+  auto const lhs0 = _mm_loadu_ps(lhs);
+  auto const lhs1 = _mm_loadu_ps(lhs + 4);
+  auto const lhs2 = _mm_loadu_ps(lhs + 8);
+  auto const lhs3 = _mm_loadu_ps(lhs + 12);
+  for (auto i = 0; i < 16; i += 4) {
+    auto row = _mm_mul_ps(lhs0, _mm_set1_ps(rhs[i]));
+    row = _mm_add_ps(row, _mm_mul_ps(lhs1, _mm_set1_ps(rhs[i + 1])));
+    row = _mm_add_ps(row, _mm_mul_ps(lhs2, _mm_set1_ps(rhs[i + 2])));
+    row = _mm_add_ps(row, _mm_mul_ps(lhs3, _mm_set1_ps(rhs[i + 3])));
+    _mm_storeu_ps(result + i, row);
+  }
+}
+#endif
+
+} // namespace
+
 Transform Transform::operator*(Transform const &rhs) const {
-  if (*this == Transform::Identity()) {
+  const auto &lhs = *this;
+  auto const lhsKind = transformKind(lhs.matrix);
+  auto const rhsKind = transformKind(rhs.matrix);
+
+  if (lhsKind == TransformKind::Identity) {
     return rhs;
   }
+  if (rhsKind == TransformKind::Identity) {
+    return lhs;
+  }
 
-  const auto &lhs = *this;
   auto result = Transform{};
+  auto &m = result.matrix;
+  auto const &l = lhs.matrix;
+  auto const &r = rhs.matrix;
+
+  if (lhsKind == TransformKind::Translate) {
+    // Adds the translation, weighted by the last column of `rhs`.
+    m = r;
+    for (auto i = 0; i < 16; i += 4) {
+      m[i] += r[i + 3] * l[12];
+      m[i + 1] += r[i + 3] * l[13];
+      m[i + 2] += r[i + 3] * l[14];
+    }
+    return result;
+  }
+
+  if (rhsKind == TransformKind::Translate) {
+    // Only the last row changes.
+    m = l;
+    for (auto j = 0; j < 4; j++) {
+      m[12 + j] = r[12] * l[j] + r[13] * l[4 + j] + r[14] * l[8 + j] + l[12 + j];
+    }
+    return result;
+  }
+
+  if (lhsKind == TransformKind::Scale) {
+    // Scales the columns of `rhs`.
+    for (auto i = 0; i < 16; i += 4) {
+      m[i] = r[i] * l[0];
+      m[i + 1] = r[i + 1] * l[5];
+      m[i + 2] = r[i + 2] * l[10];
+      m[i + 3] = r[i + 3];
+    }
+    return result;
+  }
 
-  auto lhs00 = lhs.matrix[0], lhs01 = lhs.matrix[1], lhs02 = lhs.matrix[2],
-       lhs03 = lhs.matrix[3], lhs10 = lhs.matrix[4], lhs11 = lhs.matrix[5],
-       lhs12 = lhs.matrix[6], lhs13 = lhs.matrix[7], lhs20 = lhs.matrix[8],
-       lhs21 = lhs.matrix[9], lhs22 = lhs.matrix[10], lhs23 = lhs.matrix[11],
-       lhs30 = lhs.matrix[12], lhs31 = lhs.matrix[13], lhs32 = lhs.matrix[14],
-       lhs33 = lhs.matrix[15];
-
-  auto rhs0 = rhs.matrix[0], rhs1 = rhs.matrix[1], rhs2 = rhs.matrix[2],
-       rhs3 = rhs.matrix[3];
-  result.matrix[0] = rhs0 * lhs00 + rhs1 * lhs10 + rhs2 * lhs20 + rhs3 * lhs30;
-  result.matrix[1] = rhs0 * lhs01 + rhs1 * lhs11 + rhs2 * lhs21 + rhs3 * lhs31;
-  result.matrix[2] = rhs0 * lhs02 + rhs1 * lhs12 + rhs2 * lhs22 + rhs3 * lhs32;
-  result.matrix[3] = rhs0 * lhs03 + rhs1 * lhs13 + rhs2 * lhs23 + rhs3 * lhs33;
-
-  rhs0 = rhs.matrix[4];
-  rhs1 = rhs.matrix[5];
-  rhs2 = rhs.matrix[6];
-  rhs3 = rhs.matrix[7];
-  result.matrix[4] = rhs0 * lhs00 + rhs1 * lhs10 + rhs2 * lhs20 + rhs3 * lhs30;
-  result.matrix[5] = rhs0 * lhs01 + rhs1 * lhs11 + rhs2 * lhs21 + rhs3 * lhs31;
-  result.matrix[6] = rhs0 * lhs02 + rhs1 * lhs12 + rhs2 * lhs22 + rhs3 * lhs32;
-  result.matrix[7] = rhs0 * lhs03 + rhs1 * lhs13 + rhs2 * lhs23 + rhs3 * lhs33;
-
-  rhs0 = rhs.matrix[8];
-  rhs1 = rhs.matrix[9];
-  rhs2 = rhs.matrix[10];
-  rhs3 = rhs.matrix[11];
-  result.matrix[8] = rhs0 * lhs00 + rhs1 * lhs10 + rhs2 * lhs20 + rhs3 * lhs30;
-  result.matrix[9] = rhs0 * lhs01 + rhs1 * lhs11 + rhs2 * lhs21 + rhs3 * lhs31;
-  result.matrix[10] = rhs0 * lhs02 + rhs1 * lhs12 + rhs2 * lhs22 + rhs3 * lhs32;
-  result.matrix[11] = rhs0 * lhs03 + rhs1 * lhs13 + rhs2 * lhs23 + rhs3 * lhs33;
-
-  rhs0 = rhs.matrix[12];
-  rhs1 = rhs.matrix[13];
-  rhs2 = rhs.matrix[14];
-  rhs3 = rhs.matrix[15];
-  result.matrix[12] = rhs0 * lhs00 + rhs1 * lhs10 + rhs2 * lhs20 + rhs3 * lhs30;
-  result.matrix[13] = rhs0 * lhs01 + rhs1 * lhs11 + rhs2 * lhs21 + rhs3 * lhs31;
-  result.matrix[14] = rhs0 * lhs02 + rhs1 * lhs12 + rhs2 * lhs22 + rhs3 * lhs32;
-  result.matrix[15] = rhs0 * lhs03 + rhs1 * lhs13 + rhs2 * lhs23 + rhs3 * lhs33;
+  if (rhsKind == TransformKind::Scale) {
+    // Scales the rows of `lhs`.
+    for (auto j = 0; j < 4; j++) {
+      m[j] = r[0] * l[j];
+      m[4 + j] = r[5] * l[4 + j];
+      m[8 + j] = r[10] * l[8 + j];
+      m[12 + j] = l[12 + j];
+    }
+    return result;
+  }
+
+  if (lhsKind == TransformKind::Affine2D && rhsKind == TransformKind::Affine2D) {
+    m[0] = r[0] * l[0] + r[1] * l[4];
+    m[1] = r[0] * l[1] + r[1] * l[5];
+    m[4] = r[4] * l[0] + r[5] * l[4];
+    m[5] = r[4] * l[1] + r[5] * l[5];
+    m[12] = r[12] * l[0] + r[13] * l[4] + l[12];
+    m[13] = r[12] * l[1] + r[13] * l[5] + l[13];
+    return result;
+  }
 
+  multiplyArbitrary(l.data(), r.data(), m.data());
   return result;
 }
 
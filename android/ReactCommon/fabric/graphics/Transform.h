@@ -68,6 +68,8 @@ struct Transform {
 
   /*
    * Concatenates (multiplies) transform matrices.
+   * Identity, translation, scale and 2D affine matrices take shortcuts, so
+   * composing the usual transforms is much cheaper than a full 4x4 multiply.
    */
   Transform operator*(Transform const &rhs) const;
 };
@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include <mutex>
+#include <unordered_map>
+
 #include <better/map.h>
 #include <folly/dynamic.h>
 #include <react/core/RawProps.h>
@@ -18,31 +21,63 @@ namespace react {
 
 #pragma mark - Color
 
-inline void fromRawValue(const RawValue &value, SharedColor &result) {
-  float red;
-  float green;
-  float blue;
-  float alpha;
+/*
+ * Returns the color with given packed ARGB components.
+ * Colors are interned: all calls with the same value share one platform color
+ * object (e.g. `CGColorRef` on iOS) instead of allocating one per call, which
+ * is what makes parsing of the few dozen colors used by a theme across
+ * thousands of nodes cheap.
+ * Can be called from any thread.
+ */
+inline SharedColor colorFromARGB(uint32_t argb) {
+  // Interning stops at this many distinct colors (e.g. for animated ones),
+  // which are then allocated per call as before.
+  constexpr size_t maxInternedColorCount = 1024;
+
+  static std::mutex mutex;
+  // Leaked, so that colors can be parsed during static destruction.
+  static auto &colors = *new std::unordered_map<uint32_t, SharedColor>();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iterator = colors.find(argb);
+    if (iterator != colors.end()) {
+      return iterator->second;
+    }
+  }
+
+  auto ratio = 256.f;
+  auto color = colorFromComponents({((argb >> 16) & 0xFF) / ratio,
+                                    ((argb >> 8) & 0xFF) / ratio,
+                                    (argb & 0xFF) / ratio,
+                                    ((argb >> 24) & 0xFF) / ratio});
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (colors.size() < maxInternedColorCount) {
+    // Another thread might have interned the color meanwhile; its value wins.
+    return colors.emplace(argb, color).first->second;
+  }
+  return color;
+}
 
+inline void fromRawValue(const RawValue &value, SharedColor &result) {
   if (value.hasType<int>()) {
-    auto argb = (int64_t)value;
-    auto ratio = 256.f;
-    alpha = ((argb >> 24) & 0xFF) / ratio;
-    red = ((argb >> 16) & 0xFF) / ratio;
-    green = ((argb >> 8) & 0xFF) / ratio;
-    blue = (argb & 0xFF) / ratio;
-  } else if (value.hasType<std::vector<float>>()) {
+    result = colorFromARGB((uint32_t)(int64_t)value);
+    return;
+  }
+
+  if (value.hasType<std::vector<float>>()) {
     auto items = (std::vector<float>)value;
     auto length = items.size();
     assert(length == 3 || length == 4);
-    red = items.at(0);
-    green = items.at(1);
-    blue = items.at(2);
-    alpha = length == 4 ? items.at(3) : 1.0;
-  } else {
-    abort();
+    result = colorFromComponents({items.at(0),
+                                  items.at(1),
+                                  items.at(2),
+                                  length == 4 ? items.at(3) : 1.0f});
+    return;
   }
-  result = colorFromComponents({red, green, blue, alpha});
+
+  abort();
 }
 
 #ifdef ANDROID
@@ -28,7 +28,9 @@ class ImageManager {
   ImageManager(ContextContainer::Shared const &contextContainer);
   ~ImageManager();
 
-  ImageRequest requestImage(const ImageSource &imageSource) const;
+  ImageRequest requestImage(
+      const ImageSource &imageSource,
+      ImageRequestPriority priority = ImageRequestPriority::High) const;
 
  private:
   void *self_;
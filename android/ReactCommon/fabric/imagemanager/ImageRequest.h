@@ -30,6 +30,14 @@ class ImageRequest final {
    */
   ImageRequest(const ImageSource &imageSource);
 
+  /*
+   * Constructs a request which shares given `coordinator` with other requests
+   * (of the same image source).
+   */
+  ImageRequest(
+      const ImageSource &imageSource,
+      std::shared_ptr<const ImageResponseObserverCoordinator> coordinator);
+
   /*
    * The move constructor.
    */
@@ -47,6 +55,19 @@ class ImageRequest final {
    */
   void setCancelationFunction(std::function<void(void)> cancelationFunction);
 
+  /*
+   * Sets a function which changes the priority of the request.
+   */
+  void setPriorityFunction(
+      std::function<void(ImageRequestPriority)> priorityFunction);
+
+  /*
+   * Changes the priority of the request (e.g. when the image moves in or out
+   * of the screen). Does nothing if the image loader does not support
+   * priorities.
+   */
+  void setPriority(ImageRequestPriority priority) const;
+
   /*
    * Returns stored observer coordinator as a shared pointer.
    * Retain this *or* `ImageRequest` to ensure a correct lifetime of the object.
@@ -77,6 +98,11 @@ class ImageRequest final {
    */
   std::function<void(void)> cancelRequest_;
 
+  /*
+   * Function we can call to change the priority of the request.
+   */
+  std::function<void(ImageRequestPriority)> prioritizeRequest_;
+
   /*
    * Indicates that the object was moved and hence cannot be used anymore.
    */
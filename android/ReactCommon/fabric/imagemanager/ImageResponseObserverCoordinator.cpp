@@ -8,32 +8,52 @@
 #include "ImageResponseObserverCoordinator.h"
 
 #include <algorithm>
+#include <chrono>
 
 namespace facebook {
 namespace react {
 
-ImageResponseObserverCoordinator::ImageResponseObserverCoordinator() {
+/*
+ * Minimal interval between two progress notifications (one frame at 60 FPS).
+ */
+static int64_t const kProgressInterval = 16 * 1000 * 1000;
+
+ImageResponseObserverCoordinator::ImageResponseObserverCoordinator()
+    : observers_(std::make_shared<Observers const>()) {
   status_ = ImageResponse::Status::Loading;
 }
 
 ImageResponseObserverCoordinator::~ImageResponseObserverCoordinator() {}
 
+std::shared_ptr<ImageResponseObserverCoordinator::Observers const>
+ImageResponseObserverCoordinator::getObservers() const {
+  return std::atomic_load(&observers_);
+}
+
 void ImageResponseObserverCoordinator::addObserver(
     ImageResponseObserver *observer) const {
-  ImageResponse::Status status = [this] {
-    std::shared_lock<better::shared_mutex> read(mutex_);
-    return status_;
-  }();
+  ImageResponse::Status status;
+  std::shared_ptr<void> imageData;
 
-  if (status == ImageResponse::Status::Loading) {
+  {
+    // Checking the status and adding the observer under the same lock makes
+    // the observer either receive the completion (or the failure) as soon as
+    // it happens or see the final status here.
     std::unique_lock<better::shared_mutex> write(mutex_);
-    observers_.push_back(observer);
-  } else if (status == ImageResponse::Status::Completed) {
-    ImageResponse imageResponseCopy = [this] {
-      std::unique_lock<better::shared_mutex> read(mutex_);
-      return ImageResponse(imageData_);
-    }();
-    observer->didReceiveImage(imageResponseCopy);
+    status = status_;
+    imageData = imageData_;
+
+    if (status == ImageResponse::Status::Loading) {
+      auto observers = std::make_shared<Observers>(*observers_);
+      observers->push_back(observer);
+      std::atomic_store(
+          &observers_, std::shared_ptr<Observers const>{std::move(observers)});
+      return;
+    }
+  }
+
+  if (status == ImageResponse::Status::Completed) {
+    observer->didReceiveImage(ImageResponse(imageData));
   } else {
     observer->didReceiveFailure();
   }
@@ -43,58 +63,69 @@ void ImageResponseObserverCoordinator::removeObserver(
     ImageResponseObserver *observer) const {
   std::unique_lock<better::shared_mutex> write(mutex_);
 
-  auto position = std::find(observers_.begin(), observers_.end(), observer);
-  if (position != observers_.end()) {
-    observers_.erase(position, observers_.end());
+  auto position = std::find(observers_->begin(), observers_->end(), observer);
+  if (position == observers_->end()) {
+    return;
   }
+
+  auto observers = std::make_shared<Observers>(*observers_);
+  observers->erase(observers->begin() + (position - observers_->begin()));
+  std::atomic_store(
+      &observers_, std::shared_ptr<Observers const>{std::move(observers)});
 }
 
 void ImageResponseObserverCoordinator::nativeImageResponseProgress(
     float progress) const {
-  std::vector<ImageResponseObserver *> observersCopy = [this] {
-    std::shared_lock<better::shared_mutex> read(mutex_);
-    return observers_;
-  }();
+  auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+                 .count();
+
+  if (progress < 1) {
+    auto lastProgressTime = lastProgressTime_.load(std::memory_order_relaxed);
+    if (now - lastProgressTime < kProgressInterval ||
+        !lastProgressTime_.compare_exchange_strong(
+            lastProgressTime, now, std::memory_order_relaxed)) {
+      // Too soon after the previous notification (or another thread is
+      // delivering one for the same interval right now).
+      return;
+    }
+  } else {
+    lastProgressTime_.store(now, std::memory_order_relaxed);
+  }
 
-  for (auto observer : observersCopy) {
+  auto observers = getObservers();
+  for (auto observer : *observers) {
     observer->didReceiveProgress(progress);
   }
 }
 
 void ImageResponseObserverCoordinator::nativeImageResponseComplete(
     const ImageResponse &imageResponse) const {
+  auto observers = std::shared_ptr<Observers const>{};
+  auto imageData = imageResponse.getImage();
+
   {
     std::unique_lock<better::shared_mutex> write(mutex_);
-    imageData_ = imageResponse.getImage();
+    imageData_ = imageData;
     status_ = ImageResponse::Status::Completed;
+    observers = observers_;
   }
 
-  std::vector<ImageResponseObserver *> observersCopy = [this] {
-    std::shared_lock<better::shared_mutex> read(mutex_);
-    return observers_;
-  }();
-
-  for (auto observer : observersCopy) {
-    ImageResponse imageResponseCopy = [this] {
-      std::unique_lock<better::shared_mutex> read(mutex_);
-      return ImageResponse(imageData_);
-    }();
-    observer->didReceiveImage(imageResponseCopy);
+  for (auto observer : *observers) {
+    observer->didReceiveImage(ImageResponse(imageData));
   }
 }
 
 void ImageResponseObserverCoordinator::nativeImageResponseFailed() const {
+  auto observers = std::shared_ptr<Observers const>{};
+
   {
     std::unique_lock<better::shared_mutex> write(mutex_);
     status_ = ImageResponse::Status::Failed;
+    observers = observers_;
   }
 
-  std::vector<ImageResponseObserver *> observersCopy = [this] {
-    std::shared_lock<better::shared_mutex> read(mutex_);
-    return observers_;
-  }();
-
-  for (auto observer : observersCopy) {
+  for (auto observer : *observers) {
     observer->didReceiveFailure();
   }
 }
@@ -10,7 +10,9 @@
 #include <react/imagemanager/ImageResponse.h>
 #include <react/imagemanager/ImageResponseObserver.h>
 
+#include <atomic>
 #include <better/mutex.h>
+#include <memory>
 #include <vector>
 
 namespace facebook {
@@ -21,6 +23,9 @@ namespace react {
  * data from native image loaders and sends events to any observers attached
  * to the coordinator. The Coordinator also keeps track of response status
  * and caches completed images.
+ * Notifications iterate over an immutable snapshot of the list of observers
+ * without taking a lock; adding and removing an observer replaces the
+ * snapshot. Progress notifications are throttled to one per frame.
  */
 class ImageResponseObserverCoordinator {
  public:
@@ -46,6 +51,8 @@ class ImageResponseObserverCoordinator {
 
   /*
    * Platform-specific image loader will call this method with progress updates.
+   * Updates which come sooner than a frame after the previously delivered
+   * one are dropped (except the final one).
    */
   void nativeImageResponseProgress(float) const;
 
@@ -62,11 +69,25 @@ class ImageResponseObserverCoordinator {
   void nativeImageResponseFailed() const;
 
  private:
+  using Observers = std::vector<ImageResponseObserver *>;
+
   /*
-   * List of observers.
-   * Mutable: protected by mutex_.
+   * Returns the current snapshot of the list of observers.
+   */
+  std::shared_ptr<Observers const> getObservers() const;
+
+  /*
+   * Immutable snapshot of the list of observers.
+   * Mutable: read with `std::atomic_load`; replaced with `std::atomic_store`
+   * while `mutex_` is locked.
+   */
+  mutable std::shared_ptr<Observers const> observers_;
+
+  /*
+   * Time (in `std::chrono::steady_clock` nanoseconds) when the last progress
+   * notification was delivered.
    */
-  mutable std::vector<ImageResponseObserver *> observers_;
+  mutable std::atomic<int64_t> lastProgressTime_{0};
 
   /*
    * Current status of image loading.
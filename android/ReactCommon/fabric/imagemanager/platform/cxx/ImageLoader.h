@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <react/imagemanager/primitives.h>
+#include <react/utils/BackgroundExecutor.h>
+
+namespace facebook {
+namespace react {
+
+/*
+ * Decoded image bitmap (in a platform-specific representation) and the amount
+ * of memory it occupies.
+ */
+struct DecodedImage {
+  std::shared_ptr<void> image{};
+  size_t byteSize{0};
+};
+
+/*
+ * Platform-specific primitives `ImageManager` loads images with.
+ * Must be registered in `ContextContainer` with "ImageLoader" key; without it
+ * all image requests fail.
+ */
+struct ImageLoader {
+  using ProgressCallback = std::function<void(float progress)>;
+  using CompletionCallback =
+      std::function<void(std::shared_ptr<void> const &encodedImage)>;
+
+  /*
+   * Starts loading encoded data of an image. Calls `onProgress` any number of
+   * times and then `onCompletion` exactly once (with `nullptr` in case of
+   * failure). The callbacks can be called from any thread.
+   */
+  std::function<void(
+      ImageSource const &imageSource,
+      ImageRequestPriority priority,
+      ProgressCallback const &onProgress,
+      CompletionCallback const &onCompletion)>
+      fetch;
+
+  /*
+   * Optional. Changes the priority of a fetch which has been started but not
+   * completed yet. The priority of a fetch is the highest priority among all
+   * the requests which share it.
+   */
+  std::function<void(
+      ImageSource const &imageSource,
+      ImageRequestPriority priority)>
+      prioritize;
+
+  /*
+   * Decodes data produced by `fetch`. Returns an image with `nullptr` `image`
+   * in case of failure.
+   * The image should be decoded (using subsampling where the format allows)
+   * at the smallest resolution not smaller than `getImageDecodeSize()` of the
+   * source. The decoded image is shared by all requests of the same source
+   * and decode size.
+   */
+  std::function<DecodedImage(
+      ImageSource const &imageSource,
+      std::shared_ptr<void> const &encodedImage)>
+      decode;
+
+  /*
+   * Optional. If set, images are decoded on this executor; otherwise, an image
+   * is decoded on the thread which completes its fetching.
+   */
+  BackgroundExecutor decodeExecutor;
+
+  /*
+   * The maximum total size of decoded images kept in memory.
+   */
+  size_t memoryCacheByteLimit{32 * 1024 * 1024};
+};
+
+} // namespace react
+} // namespace facebook
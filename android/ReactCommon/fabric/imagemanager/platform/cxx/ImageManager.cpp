@@ -7,22 +7,358 @@
 
 #include "ImageManager.h"
 
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "ImageLoader.h"
+
 namespace facebook {
 namespace react {
 
+/*
+ * Shares one fetch and one decode between all requests of the same image
+ * source and keeps recently decoded images in memory.
+ */
+class CxxImageManager final
+    : public std::enable_shared_from_this<CxxImageManager> {
+ public:
+  CxxImageManager(ImageLoader imageLoader)
+      : imageLoader_(std::move(imageLoader)) {}
+
+  ImageRequest requestImage(
+      ImageSource const &imageSource,
+      ImageRequestPriority priority) {
+    auto key = keyForImageSource(imageSource);
+    auto coordinator = std::shared_ptr<ImageResponseObserverCoordinator>{};
+    auto isNewFetch = false;
+    auto isPriorityChanged = false;
+    auto fetchPriority = ImageRequestPriority::Low;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      auto cacheIterator = cache_.find(key);
+      if (cacheIterator != cache_.end()) {
+        auto &entry = cacheIterator->second;
+        recentKeys_.splice(
+            recentKeys_.begin(), recentKeys_, entry.recentKeyIterator);
+
+        auto cachedCoordinator =
+            std::make_shared<ImageResponseObserverCoordinator>();
+        cachedCoordinator->nativeImageResponseComplete(
+            ImageResponse(entry.decodedImage.image));
+        return ImageRequest(imageSource, cachedCoordinator);
+      }
+
+      auto &pendingImage = pendingImages_[key];
+      coordinator = std::const_pointer_cast<ImageResponseObserverCoordinator>(
+          pendingImage.coordinator.lock());
+      if (!coordinator) {
+        coordinator = std::make_shared<ImageResponseObserverCoordinator>();
+        pendingImage = PendingImage{coordinator};
+        isNewFetch = true;
+      }
+
+      auto previousFetchPriority = getFetchPriority(pendingImage);
+      pendingImage.requestCount++;
+      if (priority == ImageRequestPriority::High) {
+        pendingImage.highPriorityRequestCount++;
+      }
+      fetchPriority = getFetchPriority(pendingImage);
+      isPriorityChanged = fetchPriority != previousFetchPriority;
+    }
+
+    auto imageRequest =
+        makeImageRequest(imageSource, key, coordinator, priority);
+
+    if (isNewFetch) {
+      fetch(imageSource, key, coordinator, fetchPriority);
+    } else if (isPriorityChanged && imageLoader_.prioritize) {
+      imageLoader_.prioritize(imageSource, fetchPriority);
+    }
+
+    return imageRequest;
+  }
+
+ private:
+  struct CacheEntry {
+    DecodedImage decodedImage;
+    std::list<std::string>::iterator recentKeyIterator;
+  };
+
+  /*
+   * A fetch shared by all requests of an image source.
+   */
+  struct PendingImage {
+    std::weak_ptr<ImageResponseObserverCoordinator const> coordinator;
+    int requestCount{0};
+    int highPriorityRequestCount{0};
+  };
+
+  static std::string keyForImageSource(ImageSource const &imageSource) {
+    // Must agree with `ImageSource::operator==`; images decoded at different
+    // sizes are different entries.
+    auto decodeSize = getImageDecodeSize(imageSource);
+    return std::to_string(static_cast<int>(decodeSize.width)) + "x" +
+        std::to_string(static_cast<int>(decodeSize.height)) + ":" +
+        std::to_string(static_cast<int>(imageSource.type)) + ":" +
+        imageSource.uri;
+  }
+
+  static ImageRequestPriority getFetchPriority(
+      PendingImage const &pendingImage) {
+    return pendingImage.highPriorityRequestCount > 0
+        ? ImageRequestPriority::High
+        : ImageRequestPriority::Low;
+  }
+
+  /*
+   * Returns `true` if `pendingImage` is the fetch of `coordinator`.
+   */
+  static bool isFetchOf(
+      PendingImage const &pendingImage,
+      std::weak_ptr<ImageResponseObserverCoordinator const> const
+          &coordinator) {
+    return !pendingImage.coordinator.owner_before(coordinator) &&
+        !coordinator.owner_before(pendingImage.coordinator);
+  }
+
+  ImageRequest makeImageRequest(
+      ImageSource const &imageSource,
+      std::string const &key,
+      std::shared_ptr<ImageResponseObserverCoordinator const> const
+          &coordinator,
+      ImageRequestPriority priority) {
+    auto imageRequest = ImageRequest(imageSource, coordinator);
+
+    auto self = shared_from_this();
+    auto weakCoordinator =
+        std::weak_ptr<ImageResponseObserverCoordinator const>{coordinator};
+    // Protected by `mutex_`.
+    auto requestPriority = std::make_shared<ImageRequestPriority>(priority);
+
+    imageRequest.setPriorityFunction(
+        [self, imageSource, key, weakCoordinator, requestPriority](
+            ImageRequestPriority priority) {
+          self->setRequestPriority(
+              imageSource, key, weakCoordinator, *requestPriority, priority);
+        });
+
+    imageRequest.setCancelationFunction(
+        [self, imageSource, key, weakCoordinator, requestPriority]() {
+          self->cancelRequest(
+              imageSource, key, weakCoordinator, *requestPriority);
+        });
+
+    return imageRequest;
+  }
+
+  void setRequestPriority(
+      ImageSource const &imageSource,
+      std::string const &key,
+      std::weak_ptr<ImageResponseObserverCoordinator const> const &coordinator,
+      ImageRequestPriority &requestPriority,
+      ImageRequestPriority priority) {
+    auto fetchPriority = ImageRequestPriority::Low;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      if (requestPriority == priority) {
+        return;
+      }
+      requestPriority = priority;
+
+      auto pendingIterator = pendingImages_.find(key);
+      if (pendingIterator == pendingImages_.end() ||
+          !isFetchOf(pendingIterator->second, coordinator)) {
+        return;
+      }
+
+      auto &pendingImage = pendingIterator->second;
+      auto previousFetchPriority = getFetchPriority(pendingImage);
+      pendingImage.highPriorityRequestCount +=
+          priority == ImageRequestPriority::High ? 1 : -1;
+      fetchPriority = getFetchPriority(pendingImage);
+
+      if (fetchPriority == previousFetchPriority) {
+        return;
+      }
+    }
+
+    if (imageLoader_.prioritize) {
+      imageLoader_.prioritize(imageSource, fetchPriority);
+    }
+  }
+
+  void cancelRequest(
+      ImageSource const &imageSource,
+      std::string const &key,
+      std::weak_ptr<ImageResponseObserverCoordinator const> const &coordinator,
+      ImageRequestPriority requestPriority) {
+    auto fetchPriority = ImageRequestPriority::Low;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      auto pendingIterator = pendingImages_.find(key);
+      if (pendingIterator == pendingImages_.end() ||
+          !isFetchOf(pendingIterator->second, coordinator)) {
+        return;
+      }
+
+      auto &pendingImage = pendingIterator->second;
+      auto previousFetchPriority = getFetchPriority(pendingImage);
+      pendingImage.requestCount--;
+      if (requestPriority == ImageRequestPriority::High) {
+        pendingImage.highPriorityRequestCount--;
+      }
+      fetchPriority = getFetchPriority(pendingImage);
+
+      if (pendingImage.requestCount == 0) {
+        // Nobody needs the image anymore, so the fetch is no longer shared
+        // with new requests (and its result is not decoded unless someone
+        // else retains the coordinator).
+        pendingImages_.erase(pendingIterator);
+      }
+
+      if (fetchPriority == previousFetchPriority) {
+        return;
+      }
+    }
+
+    if (imageLoader_.prioritize) {
+      imageLoader_.prioritize(imageSource, fetchPriority);
+    }
+  }
+
+  void fetch(
+      ImageSource const &imageSource,
+      std::string const &key,
+      std::shared_ptr<ImageResponseObserverCoordinator const> const
+          &coordinator,
+      ImageRequestPriority priority) {
+    if (!imageLoader_.fetch || !imageLoader_.decode) {
+      finishRequest(key, coordinator, DecodedImage{});
+      return;
+    }
+
+    auto self = shared_from_this();
+    auto weakCoordinator =
+        std::weak_ptr<ImageResponseObserverCoordinator const>{coordinator};
+
+    imageLoader_.fetch(
+        imageSource,
+        priority,
+        [weakCoordinator](float progress) {
+          auto coordinator = weakCoordinator.lock();
+          if (coordinator) {
+            coordinator->nativeImageResponseProgress(progress);
+          }
+        },
+        [self, key, imageSource, weakCoordinator](
+            std::shared_ptr<void> const &encodedImage) {
+          auto decode = [self,
+                         key,
+                         imageSource,
+                         weakCoordinator,
+                         encodedImage] {
+            auto coordinator = weakCoordinator.lock();
+            if (!coordinator) {
+              // All requests were destroyed; nobody needs the image anymore.
+              return;
+            }
+
+            auto decodedImage = encodedImage
+                ? self->imageLoader_.decode(imageSource, encodedImage)
+                : DecodedImage{};
+            self->finishRequest(key, coordinator, decodedImage);
+          };
+
+          if (self->imageLoader_.decodeExecutor) {
+            self->imageLoader_.decodeExecutor(std::move(decode));
+          } else {
+            decode();
+          }
+        });
+  }
+
+  void finishRequest(
+      std::string const &key,
+      std::shared_ptr<ImageResponseObserverCoordinator const> const
+          &coordinator,
+      DecodedImage const &decodedImage) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      auto pendingIterator = pendingImages_.find(key);
+      if (pendingIterator != pendingImages_.end() &&
+          isFetchOf(pendingIterator->second, coordinator)) {
+        pendingImages_.erase(pendingIterator);
+      }
+
+      if (decodedImage.image) {
+        storeLocked(key, decodedImage);
+      }
+    }
+
+    if (decodedImage.image) {
+      coordinator->nativeImageResponseComplete(
+          ImageResponse(decodedImage.image));
+    } else {
+      coordinator->nativeImageResponseFailed();
+    }
+  }
+
+  void storeLocked(std::string const &key, DecodedImage const &decodedImage) {
+    if (decodedImage.byteSize > imageLoader_.memoryCacheByteLimit ||
+        cache_.find(key) != cache_.end()) {
+      return;
+    }
+
+    while (cacheByteSize_ + decodedImage.byteSize >
+           imageLoader_.memoryCacheByteLimit) {
+      auto iterator = cache_.find(recentKeys_.back());
+      cacheByteSize_ -= iterator->second.decodedImage.byteSize;
+      cache_.erase(iterator);
+      recentKeys_.pop_back();
+    }
+
+    recentKeys_.push_front(key);
+    cache_[key] = CacheEntry{decodedImage, recentKeys_.begin()};
+    cacheByteSize_ += decodedImage.byteSize;
+  }
+
+  ImageLoader const imageLoader_;
+
+  std::mutex mutex_;
+  // Protected by `mutex_`.
+  std::unordered_map<std::string, PendingImage> pendingImages_;
+  std::unordered_map<std::string, CacheEntry> cache_;
+  // The most recently used keys go first.
+  std::list<std::string> recentKeys_;
+  size_t cacheByteSize_{0};
+};
+
 ImageManager::ImageManager(ContextContainer::Shared const &contextContainer) {
-  // Silence unused-private-field warning.
-  (void)self_;
-  // Not implemented.
+  auto imageLoader = contextContainer->find<ImageLoader>("ImageLoader")
+                         .value_or(ImageLoader{});
+  self_ = new std::shared_ptr<CxxImageManager>(
+      std::make_shared<CxxImageManager>(std::move(imageLoader)));
 }
 
 ImageManager::~ImageManager() {
-  // Not implemented.
+  delete static_cast<std::shared_ptr<CxxImageManager> *>(self_);
+  self_ = nullptr;
 }
 
-ImageRequest ImageManager::requestImage(const ImageSource &imageSource) const {
-  // Not implemented.
-  return ImageRequest(imageSource);
+ImageRequest ImageManager::requestImage(
+    const ImageSource &imageSource,
+    ImageRequestPriority priority) const {
+  auto &imageManager = *static_cast<std::shared_ptr<CxxImageManager> *>(self_);
+  return imageManager->requestImage(imageSource, priority);
 }
 
 } // namespace react
@@ -28,8 +28,10 @@ ImageManager::~ImageManager()
   self_ = nullptr;
 }
 
-ImageRequest ImageManager::requestImage(const ImageSource &imageSource) const
+ImageRequest ImageManager::requestImage(const ImageSource &imageSource, ImageRequestPriority priority) const
 {
+  // `RCTImageLoader` does not support priorities.
+  (void)priority;
   RCTImageManager *imageManager = (__bridge RCTImageManager *)self_;
   return [imageManager requestImage:imageSource];
 }
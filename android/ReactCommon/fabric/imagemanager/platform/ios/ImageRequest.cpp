@@ -15,12 +15,20 @@ ImageRequest::ImageRequest(const ImageSource &imageSource)
   coordinator_ = std::make_shared<ImageResponseObserverCoordinator>();
 }
 
+ImageRequest::ImageRequest(
+    const ImageSource &imageSource,
+    std::shared_ptr<const ImageResponseObserverCoordinator> coordinator)
+    : imageSource_(imageSource), coordinator_(std::move(coordinator)) {}
+
 ImageRequest::ImageRequest(ImageRequest &&other) noexcept
     : imageSource_(std::move(other.imageSource_)),
-      coordinator_(std::move(other.coordinator_)) {
+      coordinator_(std::move(other.coordinator_)),
+      cancelRequest_(std::move(other.cancelRequest_)),
+      prioritizeRequest_(std::move(other.prioritizeRequest_)) {
   other.moved_ = true;
   other.coordinator_ = nullptr;
   other.cancelRequest_ = nullptr;
+  other.prioritizeRequest_ = nullptr;
 }
 
 ImageRequest::~ImageRequest() {
@@ -34,6 +42,17 @@ void ImageRequest::setCancelationFunction(
   cancelRequest_ = cancelationFunction;
 }
 
+void ImageRequest::setPriorityFunction(
+    std::function<void(ImageRequestPriority)> priorityFunction) {
+  prioritizeRequest_ = priorityFunction;
+}
+
+void ImageRequest::setPriority(ImageRequestPriority priority) const {
+  if (prioritizeRequest_) {
+    prioritizeRequest_(priority);
+  }
+}
+
 const ImageResponseObserverCoordinator &ImageRequest::getObserverCoordinator()
     const {
   return *coordinator_;
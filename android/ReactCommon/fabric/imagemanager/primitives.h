@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <cmath>
 #include <string>
 #include <vector>
 
@@ -36,6 +37,34 @@ class ImageSource {
 
 using ImageSources = std::vector<ImageSource>;
 
+/*
+ * Returns the size (in pixels) an image requested with `imageSource` should be
+ * decoded at, given that `size` and `scale` of the source describe the area
+ * the image is displayed in. Both dimensions are rounded up to a power of two,
+ * so layouts of similar sizes share the same decoded image.
+ * Returns a zero size (which means the full resolution) if the area is
+ * unknown.
+ */
+inline Size getImageDecodeSize(const ImageSource &imageSource) {
+  auto width = imageSource.size.width * imageSource.scale;
+  auto height = imageSource.size.height * imageSource.scale;
+  if (!(width > 0 && height > 0) || std::isinf(width) || std::isinf(height)) {
+    return {0, 0};
+  }
+
+  return {std::exp2(std::ceil(std::log2(width))),
+          std::exp2(std::ceil(std::log2(height)))};
+}
+
+/*
+ * Relative importance of an image request. Image loaders may use it to
+ * decide which images to load first.
+ */
+enum class ImageRequestPriority {
+  Low, // The image is off-screen.
+  High, // The image is (or might be) visible.
+};
+
 enum class ImageResizeMode {
   Cover,
   Contain,
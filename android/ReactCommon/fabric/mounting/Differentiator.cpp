@@ -5,10 +5,15 @@
 
 #include "Differentiator.h"
 
-#include <better/map.h>
+#include <algorithm>
+#include <vector>
+
+#include <better/flat_hash_map.h>
 #include <better/small_vector.h>
+#include <microprofiler/MicroProfiler.h>
 #include <react/core/LayoutableShadowNode.h>
 #include <react/debug/SystraceSection.h>
+#include <yoga/WorkerPool.h>
 #include "ShadowView.h"
 
 namespace facebook {
@@ -77,10 +82,126 @@ class TinyMap final {
   better::small_vector<Pair, DefaultSize> vector_;
 };
 
+/*
+ * Maps tags of child views to their indices. Uses `TinyMap` while there are
+ * only a few children and a hash map for long lists (e.g. a big list that is
+ * being sorted), where linear lookups would make diffing quadratic.
+ */
+class ChildIndexMap final {
+ public:
+  static constexpr size_t kHashedIndexThreshold = 64;
+
+  ChildIndexMap(ShadowViewNodePair::List const &pairs, int begin)
+      : hashed_(pairs.size() - begin > kHashedIndexThreshold) {
+    if (hashed_) {
+      hashMap_.reserve(pairs.size() - begin);
+    }
+    for (auto index = begin; index < pairs.size(); index++) {
+      auto const tag = pairs[index].shadowView.tag;
+      if (hashed_) {
+        hashMap_.emplace(tag, index);
+      } else {
+        tinyMap_.insert({tag, index});
+      }
+    }
+  }
+
+  /*
+   * Returns the index of the child with the given tag, or `-1`.
+   */
+  int find(Tag tag) {
+    if (hashed_) {
+      auto const it = hashMap_.find(tag);
+      return it == hashMap_.end() ? -1 : it->second;
+    }
+    auto const it = tinyMap_.find(tag);
+    return it == tinyMap_.end() ? -1 : it->second;
+  }
+
+ private:
+  bool const hashed_;
+  TinyMap<Tag, int> tinyMap_;
+  better::flat_hash_map<Tag, int> hashMap_;
+};
+
+/*
+ * Views which are removed from their parent while diffing a subtree but may be
+ * inserted again somewhere else in it, keyed by tag. That's what happens to the
+ * children of a node which starts or stops being layout-only (e.g. a wrapper
+ * which gets a background color or loses its opacity): they move between the
+ * node and the ancestor it was flattened into. Such views are reparented
+ * instead of being deleted and created again together with their subtrees.
+ */
+class ReparentingCandidates final {
+ public:
+  struct Candidate {
+    ShadowViewNodePair pair;
+    bool isReused;
+  };
+
+  void insert(ShadowViewNodePair const &pair, bool isReused) {
+    map_.emplace(pair.shadowView.tag, Candidate{pair, isReused});
+  }
+
+  /*
+   * Returns the candidate with the given tag, or `nullptr`.
+   * Concurrent subtree diffs may mark (different) candidates as reused.
+   */
+  Candidate *find(Tag tag) {
+    auto const it = map_.find(tag);
+    return it == map_.end() ? nullptr : &it->second;
+  }
+
+ private:
+  better::flat_hash_map<Tag, Candidate> map_;
+};
+
+/*
+ * Marks the elements of the longest strictly increasing subsequence of
+ * `values`, ignoring negative ones. These are the children that keep their
+ * relative order, so all other children can be moved around them with the least
+ * number of `Remove`/`Insert` pairs.
+ */
+static std::vector<bool> longestIncreasingSubsequence(
+    std::vector<int> const &values) {
+  // `tails[length - 1]` is the index of the smallest last value among the
+  // increasing subsequences of that length found so far.
+  auto tails = std::vector<int>{};
+  auto predecessors = std::vector<int>(values.size(), -1);
+
+  for (auto index = 0; index < values.size(); index++) {
+    auto const value = values[index];
+    if (value < 0) {
+      continue;
+    }
+
+    auto const position = std::lower_bound(
+        tails.begin(), tails.end(), value, [&](int tailIndex, int value) {
+          return values[tailIndex] < value;
+        });
+    if (position != tails.begin()) {
+      predecessors[index] = *(position - 1);
+    }
+    if (position == tails.end()) {
+      tails.push_back(index);
+    } else {
+      *position = index;
+    }
+  }
+
+  auto result = std::vector<bool>(values.size(), false);
+  for (auto index = tails.empty() ? -1 : tails.back(); index != -1;
+       index = predecessors[index]) {
+    result[index] = true;
+  }
+  return result;
+}
+
 static void sliceChildShadowNodeViewPairsRecursively(
     ShadowViewNodePair::List &pairList,
     Point layoutOffset,
-    ShadowNode const &shadowNode) {
+    ShadowNode const &shadowNode,
+    LayoutableShadowNode const *mountingShadowNode) {
   for (auto const &childShadowNode : shadowNode.getChildren()) {
     auto shadowView = ShadowView(*childShadowNode);
 
@@ -100,10 +221,16 @@ static void sliceChildShadowNodeViewPairsRecursively(
       sliceChildShadowNodeViewPairsRecursively(
           pairList,
           layoutOffset + shadowView.layoutMetrics.frame.origin,
-          *childShadowNode);
+          *childShadowNode,
+          mountingShadowNode);
     } else {
       shadowView.layoutMetrics.frame.origin += layoutOffset;
-      pairList.push_back({shadowView, childShadowNode.get()});
+      // Culled children are treated as if they were not there.
+      if (mountingShadowNode &&
+          !mountingShadowNode->shouldMountChild(shadowView.layoutMetrics)) {
+        continue;
+      }
+      pairList.push_back({std::move(shadowView), childShadowNode.get()});
     }
   }
 }
@@ -111,10 +238,53 @@ static void sliceChildShadowNodeViewPairsRecursively(
 ShadowViewNodePair::List sliceChildShadowNodeViewPairs(
     ShadowNode const &shadowNode) {
   auto pairList = ShadowViewNodePair::List{};
-  sliceChildShadowNodeViewPairsRecursively(pairList, {0, 0}, shadowNode);
+  sliceChildShadowNodeViewPairsRecursively(
+      pairList,
+      {0, 0},
+      shadowNode,
+      dynamic_cast<LayoutableShadowNode const *>(&shadowNode));
   return pairList;
 }
 
+/*
+ * Returns whether the views of two pairs of the same view differ. Shadow nodes
+ * are immutable once committed, so the views of the same node can only differ
+ * in their origin, which is offset by the layout-only ancestors they are
+ * flattened into. Comparing just that is much cheaper than comparing the whole
+ * views (props, state, event emitter and all of the layout metrics), which
+ * matters after clone-along-path commits where most siblings are shared.
+ */
+static inline bool shadowViewsDiffer(
+    ShadowViewNodePair const &oldPair,
+    ShadowViewNodePair const &newPair) {
+  if (oldPair.shadowNode == newPair.shadowNode) {
+    return oldPair.shadowView.layoutMetrics.frame.origin !=
+        newPair.shadowView.layoutMetrics.frame.origin;
+  }
+  return oldPair.shadowView != newPair.shadowView;
+}
+
+/*
+ * Returns whether both lists consist of the same views, in which case there is
+ * nothing to diff.
+ */
+static bool childPairsAreEqual(
+    ShadowViewNodePair::List const &oldChildPairs,
+    ShadowViewNodePair::List const &newChildPairs) {
+  if (oldChildPairs.size() != newChildPairs.size()) {
+    return false;
+  }
+  for (auto index = 0; index < oldChildPairs.size(); index++) {
+    auto const &oldChildPair = oldChildPairs[index];
+    auto const &newChildPair = newChildPairs[index];
+    if (oldChildPair != newChildPair ||
+        shadowViewsDiffer(oldChildPair, newChildPair)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /*
  * Before we start to diff, let's make sure all our core data structures are in
  * good shape to deliver the best performance.
@@ -138,15 +308,36 @@ static_assert(
     std::is_move_assignable<ShadowViewNodePair>::value,
     "`ShadowViewNodePair` must be `move assignable`.");
 
+/*
+ * A diff of a subtree which is postponed in parallel mode to be run together
+ * with its siblings. It collects its own mutations which are then appended to
+ * `destination`.
+ */
+struct SubtreeDiff {
+  ShadowViewMutation::List *destination;
+  ShadowView parentShadowView;
+  ShadowViewNodePair::List oldChildPairs;
+  ShadowViewNodePair::List newChildPairs;
+  ReparentingCandidates *candidates;
+  ShadowViewMutation::List mutations;
+};
+
 static void calculateShadowViewMutations(
     ShadowViewMutation::List &mutations,
     ShadowView const &parentShadowView,
     ShadowViewNodePair::List const &oldChildPairs,
-    ShadowViewNodePair::List const &newChildPairs) {
+    ShadowViewNodePair::List const &newChildPairs,
+    DifferentiatorMode mode,
+    ReparentingCandidates *candidates = nullptr) {
   // The current version of the algorithm is optimized for simplicity,
   // not for performance or optimal result.
+  // Shadow nodes are immutable once committed, so a child which is the same
+  // node in both trees has the same subtree and is never descended into: the
+  // cost of a diff is proportional to the changed nodes (and their siblings),
+  // not to the size of the tree. Layout never breaks this, because a node
+  // whose layout metrics change is cloned first.
 
-  if (oldChildPairs == newChildPairs) {
+  if (childPairsAreEqual(oldChildPairs, newChildPairs)) {
     return;
   }
 
@@ -156,8 +347,64 @@ static void calculateShadowViewMutations(
 
   auto index = int{0};
 
-  // Maps inserted node tags to pointers to them in `newChildPairs`.
-  auto insertedPairs = TinyMap<Tag, ShadowViewNodePair const *>{};
+  // In parallel mode, the diffs of the subtrees are only collected here and
+  // run concurrently right before all mutations are put together.
+  auto subtreeDiffs = std::vector<SubtreeDiff>{};
+  auto const diffSubtree = [&](ShadowViewMutation::List &destination,
+                               ShadowView const &shadowView,
+                               ShadowViewNodePair::List oldGrandChildPairs,
+                               ShadowViewNodePair::List newGrandChildPairs,
+                               ReparentingCandidates *subtreeCandidates) {
+    if (mode == DifferentiatorMode::Sequential) {
+      calculateShadowViewMutations(
+          destination,
+          shadowView,
+          oldGrandChildPairs,
+          newGrandChildPairs,
+          DifferentiatorMode::Sequential,
+          subtreeCandidates);
+      return;
+    }
+
+    if (childPairsAreEqual(oldGrandChildPairs, newGrandChildPairs)) {
+      // The subtree is unchanged, there is nothing to fork.
+      return;
+    }
+
+    subtreeDiffs.push_back({&destination,
+                            shadowView,
+                            std::move(oldGrandChildPairs),
+                            std::move(newGrandChildPairs),
+                            subtreeCandidates,
+                            {}});
+  };
+
+  auto const runSubtreeDiffs = [&](size_t begin) {
+    auto const count = subtreeDiffs.size() - begin;
+    if (count == 1) {
+      // A single subtree (e.g. the only child of the root) is not worth
+      // forking, the parallelism only starts where the tree branches.
+      auto &subtreeDiff = subtreeDiffs[begin];
+      calculateShadowViewMutations(
+          subtreeDiff.mutations,
+          subtreeDiff.parentShadowView,
+          subtreeDiff.oldChildPairs,
+          subtreeDiff.newChildPairs,
+          DifferentiatorMode::Parallel,
+          subtreeDiff.candidates);
+    } else if (count > 1) {
+      yoga::detail::WorkerPool::forEach(count, [&](size_t subtreeIndex) {
+        auto &subtreeDiff = subtreeDiffs[begin + subtreeIndex];
+        calculateShadowViewMutations(
+            subtreeDiff.mutations,
+            subtreeDiff.parentShadowView,
+            subtreeDiff.oldChildPairs,
+            subtreeDiff.newChildPairs,
+            DifferentiatorMode::Sequential,
+            subtreeDiff.candidates);
+      });
+    }
+  };
 
   // Lists of mutations
   auto createMutations = ShadowViewMutation::List{};
@@ -179,7 +426,7 @@ static void calculateShadowViewMutations(
       break;
     }
 
-    if (oldChildPair.shadowView != newChildPair.shadowView) {
+    if (shadowViewsDiffer(oldChildPair, newChildPair)) {
       updateMutations.push_back(ShadowViewMutation::UpdateMutation(
           parentShadowView,
           oldChildPair.shadowView,
@@ -187,102 +434,233 @@ static void calculateShadowViewMutations(
           index));
     }
 
-    auto const oldGrandChildPairs =
+    if (oldChildPair == newChildPair) {
+      // The same node, so the whole subtree is the same.
+      continue;
+    }
+
+    auto oldGrandChildPairs =
         sliceChildShadowNodeViewPairs(*oldChildPair.shadowNode);
-    auto const newGrandChildPairs =
+    auto newGrandChildPairs =
         sliceChildShadowNodeViewPairs(*newChildPair.shadowNode);
-    calculateShadowViewMutations(
-        *(newGrandChildPairs.size() ? &downwardMutations
-                                    : &destructiveDownwardMutations),
+    auto &destination = newGrandChildPairs.size()
+        ? downwardMutations
+        : destructiveDownwardMutations;
+    diffSubtree(
+        destination,
         oldChildPair.shadowView,
-        oldGrandChildPairs,
-        newGrandChildPairs);
+        std::move(oldGrandChildPairs),
+        std::move(newGrandChildPairs),
+        nullptr);
   }
 
   int lastIndexAfterFirstStage = index;
 
-  // Stage 2: Collecting `Insert` mutations
-  for (; index < newChildPairs.size(); index++) {
-    auto const &newChildPair = newChildPairs[index];
-
-    insertMutations.push_back(ShadowViewMutation::InsertMutation(
-        parentShadowView, newChildPair.shadowView, index));
+  // Stage 2: Matching the remaining old children with the new ones
+  auto newIndices = ChildIndexMap{newChildPairs, lastIndexAfterFirstStage};
 
-    insertedPairs.insert({newChildPair.shadowView.tag, &newChildPair});
+  // New indices of the remaining old children, `-1` for the removed ones.
+  auto oldToNewIndices =
+      std::vector<int>(oldChildPairs.size() - lastIndexAfterFirstStage);
+  for (index = lastIndexAfterFirstStage; index < oldChildPairs.size();
+       index++) {
+    oldToNewIndices[index - lastIndexAfterFirstStage] =
+        newIndices.find(oldChildPairs[index].shadowView.tag);
   }
 
-  // Stage 3: Collecting `Delete` and `Remove` mutations
+  // The children in the longest run that keeps its relative order stay where
+  // they are, only the others are removed and (re)inserted.
+  auto const oldStays = longestIncreasingSubsequence(oldToNewIndices);
+  auto newExisted =
+      std::vector<bool>(newChildPairs.size() - lastIndexAfterFirstStage, false);
+  auto newStays = newExisted;
+  auto removedChildPairs = std::vector<ShadowViewNodePair const *>{};
+
+  // Stage 3: Collecting `Remove` and `Update` mutations
   for (index = lastIndexAfterFirstStage; index < oldChildPairs.size();
        index++) {
     auto const &oldChildPair = oldChildPairs[index];
+    auto const newIndex = oldToNewIndices[index - lastIndexAfterFirstStage];
+    auto const stays = oldStays[index - lastIndexAfterFirstStage];
+
+    if (!stays) {
+      // Even if the old view is (re)inserted, we have to generate `remove`
+      // mutation.
+      removeMutations.push_back(ShadowViewMutation::RemoveMutation(
+          parentShadowView, oldChildPair.shadowView, index));
+    }
 
-    // Even if the old view was (re)inserted, we have to generate `remove`
-    // mutation.
-    removeMutations.push_back(ShadowViewMutation::RemoveMutation(
-        parentShadowView, oldChildPair.shadowView, index));
+    if (newIndex == -1) {
+      // The old view was *not* (re)inserted here. Unless it's reparented, we
+      // have to generate `delete` mutation for it in Stage 5.
+      removedChildPairs.push_back(&oldChildPair);
+      continue;
+    }
 
-    auto const it = insertedPairs.find(oldChildPair.shadowView.tag);
+    // The old view still exists, hence we don't have to generate `create`
+    // mutation for it.
+    auto const &newChildPair = newChildPairs[newIndex];
+    newExisted[newIndex - lastIndexAfterFirstStage] = true;
 
-    if (it == insertedPairs.end()) {
-      // The old view was *not* (re)inserted.
-      // We have to generate `delete` mutation and apply the algorithm
-      // recursively.
-      deleteMutations.push_back(
-          ShadowViewMutation::DeleteMutation(oldChildPair.shadowView));
+    if (stays) {
+      // The view is neither removed nor inserted, same as in Stage 1.
+      newStays[newIndex - lastIndexAfterFirstStage] = true;
 
-      // We also have to call the algorithm recursively to clean up the entire
-      // subtree starting from the removed view.
-      calculateShadowViewMutations(
-          destructiveDownwardMutations,
-          oldChildPair.shadowView,
-          sliceChildShadowNodeViewPairs(*oldChildPair.shadowNode),
-          {});
-    } else {
-      // The old view *was* (re)inserted.
-      // We have to call the algorithm recursively if the inserted view
-      // is *not* the same as removed one.
-      auto const &newChildPair = *it->second;
-
-      if (newChildPair != oldChildPair) {
-        auto const oldGrandChildPairs =
-            sliceChildShadowNodeViewPairs(*oldChildPair.shadowNode);
-        auto const newGrandChildPairs =
-            sliceChildShadowNodeViewPairs(*newChildPair.shadowNode);
-        calculateShadowViewMutations(
-            *(newGrandChildPairs.size() ? &downwardMutations
-                                        : &destructiveDownwardMutations),
+      if (shadowViewsDiffer(oldChildPair, newChildPair)) {
+        updateMutations.push_back(ShadowViewMutation::UpdateMutation(
+            parentShadowView,
+            oldChildPair.shadowView,
             newChildPair.shadowView,
-            oldGrandChildPairs,
-            newGrandChildPairs);
+            newIndex));
       }
+    }
+
+    if (newChildPair == oldChildPair) {
+      // The (re)inserted or staying view is the same node as the old one, so
+      // the whole subtree is the same.
+      continue;
+    }
+
+    auto oldGrandChildPairs =
+        sliceChildShadowNodeViewPairs(*oldChildPair.shadowNode);
+    auto newGrandChildPairs =
+        sliceChildShadowNodeViewPairs(*newChildPair.shadowNode);
+    auto &destination = newGrandChildPairs.size()
+        ? downwardMutations
+        : destructiveDownwardMutations;
+    diffSubtree(
+        destination,
+        newChildPair.shadowView,
+        std::move(oldGrandChildPairs),
+        std::move(newGrandChildPairs),
+        nullptr);
+  }
 
-      // In any case we have to remove the view from `insertedPairs` as
-      // indication that the view was actually removed (which means that
-      // the view existed before), hence we don't have to generate
-      // `create` mutation.
-      insertedPairs.erase(it);
+  // Removed views (and the children of removed layout-only ones) which might
+  // be inserted again.
+  auto removedGrandChildPairs =
+      std::vector<ShadowViewNodePair::List>(removedChildPairs.size());
+  for (auto removedIndex = 0; removedIndex < removedChildPairs.size();
+       removedIndex++) {
+    removedGrandChildPairs[removedIndex] = sliceChildShadowNodeViewPairs(
+        *removedChildPairs[removedIndex]->shadowNode);
+  }
+  auto ownCandidates = ReparentingCandidates{};
+  if (!candidates && !removedChildPairs.empty() &&
+      lastIndexAfterFirstStage < newChildPairs.size()) {
+    for (auto removedIndex = 0; removedIndex < removedChildPairs.size();
+         removedIndex++) {
+      ownCandidates.insert(*removedChildPairs[removedIndex], false);
+      for (auto const &grandChildPair : removedGrandChildPairs[removedIndex]) {
+        // The removed view is flattened now, so its child moved here.
+        if (newIndices.find(grandChildPair.shadowView.tag) != -1) {
+          ownCandidates.insert(grandChildPair, true);
+        }
+      }
     }
+    candidates = &ownCandidates;
   }
 
-  // Stage 4: Collecting `Create` mutations
+  // Stage 4: Collecting `Insert` and `Create` mutations
   for (index = lastIndexAfterFirstStage; index < newChildPairs.size();
        index++) {
     auto const &newChildPair = newChildPairs[index];
 
-    if (insertedPairs.find(newChildPair.shadowView.tag) ==
-        insertedPairs.end()) {
+    if (newStays[index - lastIndexAfterFirstStage]) {
+      continue;
+    }
+
+    insertMutations.push_back(ShadowViewMutation::InsertMutation(
+        parentShadowView, newChildPair.shadowView, index));
+
+    if (newExisted[index - lastIndexAfterFirstStage]) {
       // The new view was (re)inserted, so there is no need to create it.
       continue;
     }
 
+    auto const candidate =
+        candidates ? candidates->find(newChildPair.shadowView.tag) : nullptr;
+    if (candidate) {
+      // The view was removed from another parent, so it only has to be updated
+      // like a view which stays.
+      candidate->isReused = true;
+      auto const &oldChildPair = candidate->pair;
+      if (shadowViewsDiffer(oldChildPair, newChildPair)) {
+        updateMutations.push_back(ShadowViewMutation::UpdateMutation(
+            parentShadowView,
+            oldChildPair.shadowView,
+            newChildPair.shadowView,
+            index));
+      }
+
+      if (oldChildPair == newChildPair) {
+        continue;
+      }
+
+      auto oldGrandChildPairs =
+          sliceChildShadowNodeViewPairs(*oldChildPair.shadowNode);
+      auto newGrandChildPairs =
+          sliceChildShadowNodeViewPairs(*newChildPair.shadowNode);
+      auto &destination = newGrandChildPairs.size()
+          ? downwardMutations
+          : destructiveDownwardMutations;
+      diffSubtree(
+          destination,
+          newChildPair.shadowView,
+          std::move(oldGrandChildPairs),
+          std::move(newGrandChildPairs),
+          nullptr);
+      continue;
+    }
+
     createMutations.push_back(
         ShadowViewMutation::CreateMutation(newChildPair.shadowView));
 
-    calculateShadowViewMutations(
+    diffSubtree(
         downwardMutations,
         newChildPair.shadowView,
         {},
-        sliceChildShadowNodeViewPairs(*newChildPair.shadowNode));
+        sliceChildShadowNodeViewPairs(*newChildPair.shadowNode),
+        candidates);
+  }
+
+  // Reparented views are only known once the subtrees they can be inserted
+  // into are diffed.
+  auto const deletionsBegin = subtreeDiffs.size();
+  runSubtreeDiffs(0);
+
+  // Stage 5: Collecting `Delete` mutations
+  for (auto removedIndex = 0; removedIndex < removedChildPairs.size();
+       removedIndex++) {
+    auto const &oldChildPair = *removedChildPairs[removedIndex];
+    auto const candidate =
+        candidates ? candidates->find(oldChildPair.shadowView.tag) : nullptr;
+    if (candidate && candidate->isReused) {
+      continue;
+    }
+
+    deleteMutations.push_back(
+        ShadowViewMutation::DeleteMutation(oldChildPair.shadowView));
+
+    // We also have to call the algorithm recursively to clean up the entire
+    // subtree starting from the removed view.
+    diffSubtree(
+        destructiveDownwardMutations,
+        oldChildPair.shadowView,
+        std::move(removedGrandChildPairs[removedIndex]),
+        {},
+        candidates);
+  }
+
+  runSubtreeDiffs(deletionsBegin);
+
+  // Appending in the order the diffs were collected produces exactly the same
+  // lists as the sequential walk.
+  for (auto &subtreeDiff : subtreeDiffs) {
+    std::move(
+        subtreeDiff.mutations.begin(),
+        subtreeDiff.mutations.end(),
+        std::back_inserter(*subtreeDiff.destination));
   }
 
   // All mutations in an optimal order:
@@ -318,8 +696,10 @@ static void calculateShadowViewMutations(
 
 ShadowViewMutation::List calculateShadowViewMutations(
     ShadowNode const &oldRootShadowNode,
-    ShadowNode const &newRootShadowNode) {
+    ShadowNode const &newRootShadowNode,
+    DifferentiatorMode mode) {
   SystraceSection s("calculateShadowViewMutations");
+  MICRO_PROFILER_SCOPE("calculateShadowViewMutations");
 
   // Root shadow nodes must be belong the same family.
   assert(ShadowNode::sameFamily(oldRootShadowNode, newRootShadowNode));
@@ -337,9 +717,10 @@ ShadowViewMutation::List calculateShadowViewMutations(
 
   calculateShadowViewMutations(
       mutations,
-      ShadowView(oldRootShadowNode),
+      oldRootShadowView,
       sliceChildShadowNodeViewPairs(oldRootShadowNode),
-      sliceChildShadowNodeViewPairs(newRootShadowNode));
+      sliceChildShadowNodeViewPairs(newRootShadowNode),
+      mode);
 
   return mutations;
 }
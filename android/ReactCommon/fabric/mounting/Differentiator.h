@@ -11,6 +11,16 @@
 namespace facebook {
 namespace react {
 
+/*
+ * Defines how `calculateShadowViewMutations` walks the trees.
+ * `Parallel` diffs sibling subtrees concurrently on a shared pool of worker
+ * threads, starting from the first node with more than one changed child. It
+ * produces exactly the same list of mutations as `Sequential` and only pays off
+ * for big surfaces that consist of independent subtrees (e.g. tabs or sections
+ * of a list).
+ */
+enum class DifferentiatorMode { Sequential, Parallel };
+
 /*
  * Calculates a list of view mutations which describes how the old
  * `ShadowTree` can be transformed to the new one.
@@ -18,7 +28,8 @@ namespace react {
  */
 ShadowViewMutationList calculateShadowViewMutations(
     ShadowNode const &oldRootShadowNode,
-    ShadowNode const &newRootShadowNode);
+    ShadowNode const &newRootShadowNode,
+    DifferentiatorMode mode = DifferentiatorMode::Sequential);
 
 /*
  * Generates a list of `ShadowViewNodePair`s that represents a layer of a
@@ -20,7 +20,8 @@ namespace react {
 
 MountingCoordinator::MountingCoordinator(ShadowTreeRevision baseRevision)
     : surfaceId_(baseRevision.getRootShadowNode().getSurfaceId()),
-      baseRevision_(baseRevision) {
+      baseRevision_(baseRevision),
+      mountedRootShadowNode_(baseRevision.rootShadowNode_) {
 #ifdef RN_SHADOW_TREE_INTROSPECTION
   stubViewTree_ = stubViewTreeFromShadowNode(baseRevision_.getRootShadowNode());
 #endif
@@ -55,12 +56,16 @@ better::optional<MountingTransaction> MountingCoordinator::pullTransaction()
   number_++;
 
   auto telemetry = lastRevision_->getTelemetry();
+  // Revision numbers are consecutive, so any gap consists of revisions that
+  // were replaced in `push` without being diffed.
+  telemetry.didSkipRevisions(
+      lastRevision_->getNumber() - baseRevision_.getNumber() - 1);
   telemetry.willDiff();
 
   auto mutations = calculateShadowViewMutations(
       baseRevision_.getRootShadowNode(), lastRevision_->getRootShadowNode());
 
-  telemetry.didDiff();
+  telemetry.didDiff(mutations);
 
 #ifdef RN_SHADOW_TREE_INTROSPECTION
   stubViewTree_.mutate(mutations);
@@ -84,10 +89,15 @@ better::optional<MountingTransaction> MountingCoordinator::pullTransaction()
 
   baseRevision_ = std::move(*lastRevision_);
   lastRevision_.reset();
+  std::atomic_store(&mountedRootShadowNode_, baseRevision_.rootShadowNode_);
 
   return MountingTransaction{
       surfaceId_, number_, std::move(mutations), telemetry};
 }
 
+ShadowNode::Shared MountingCoordinator::getMountedRootShadowNode() const {
+  return std::atomic_load(&mountedRootShadowNode_);
+}
+
 } // namespace react
 } // namespace facebook
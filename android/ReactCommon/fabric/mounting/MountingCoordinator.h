@@ -52,12 +52,27 @@ class MountingCoordinator final {
    */
   better::optional<MountingTransaction> pullTransaction() const;
 
+  /*
+   * Returns the root node of the revision of the most recently pulled
+   * transaction, i.e. the tree which is (or is being) mounted.
+   * Thread safe and lock-free: it never waits for commits or for a transaction
+   * being diffed.
+   */
+  ShadowNode::Shared getMountedRootShadowNode() const;
+
  private:
   friend class ShadowTree;
 
   /*
    * Methods from this section are meant to be used by `ShadowTree` only.
    */
+
+  /*
+   * Stores the revision as the one to mount next, replacing a previously
+   * pushed one that is not pulled yet. Diffing is deferred until
+   * `pullTransaction`, so a transaction is always diffed once, against the
+   * last mounted revision, no matter how many revisions it accumulates.
+   */
   void push(ShadowTreeRevision &&revision) const;
 
  private:
@@ -68,6 +83,11 @@ class MountingCoordinator final {
   mutable better::optional<ShadowTreeRevision> lastRevision_{};
   mutable MountingTransaction::Number number_{0};
 
+  /*
+   * The root of `baseRevision_`. Accessed only with `std::atomic_*` functions.
+   */
+  mutable ShadowNode::Shared mountedRootShadowNode_;
+
 #ifdef RN_SHADOW_TREE_INTROSPECTION
   mutable StubViewTree stubViewTree_; // Protected by `mutex_`.
 #endif
@@ -33,22 +33,44 @@ void MountingTelemetry::willDiff() {
   diffStartTime_ = getTime();
 }
 
-void MountingTelemetry::didDiff() {
+void MountingTelemetry::didDiff(ShadowViewMutation::List const &mutations) {
   assert(diffStartTime_ != kUndefinedTime);
   assert(diffEndTime_ == kUndefinedTime);
   diffEndTime_ = getTime();
+  for (auto const &mutation : mutations) {
+    mutationCounts_[mutation.type]++;
+  }
 }
 
 void MountingTelemetry::willLayout() {
   assert(layoutStartTime_ == kUndefinedTime);
   assert(layoutEndTime_ == kUndefinedTime);
   layoutStartTime_ = getTime();
+  YogaLayoutStatistics::beginCollecting(&layoutStatistics_);
 }
 
 void MountingTelemetry::didLayout() {
   assert(layoutStartTime_ != kUndefinedTime);
   assert(layoutEndTime_ == kUndefinedTime);
   layoutEndTime_ = getTime();
+  YogaLayoutStatistics::endCollecting();
+}
+
+void MountingTelemetry::didSkipRevisions(int64_t count) {
+  assert(count >= 0);
+  skippedRevisionCount_ += count;
+}
+
+void MountingTelemetry::willMount() {
+  assert(mountStartTime_ == kUndefinedTime);
+  assert(mountEndTime_ == kUndefinedTime);
+  mountStartTime_ = getTime();
+}
+
+void MountingTelemetry::didMount() {
+  assert(mountStartTime_ != kUndefinedTime);
+  assert(mountEndTime_ == kUndefinedTime);
+  mountEndTime_ = getTime();
 }
 
 int64_t MountingTelemetry::getDiffStartTime() const {
@@ -67,6 +89,32 @@ int64_t MountingTelemetry::getCommitNumber() const {
   return commitNumber_;
 }
 
+int64_t MountingTelemetry::getMountStartTime() const {
+  assert(mountStartTime_ != kUndefinedTime);
+  assert(mountEndTime_ != kUndefinedTime);
+  return mountStartTime_;
+}
+
+int64_t MountingTelemetry::getMountEndTime() const {
+  assert(mountStartTime_ != kUndefinedTime);
+  assert(mountEndTime_ != kUndefinedTime);
+  return mountEndTime_;
+}
+
+int MountingTelemetry::getMutationCount(ShadowViewMutation::Type type) const {
+  return mutationCounts_[type];
+}
+
+int64_t MountingTelemetry::getSkippedRevisionCount() const {
+  return skippedRevisionCount_;
+}
+
+int64_t MountingTelemetry::getPullLatency() const {
+  assert(commitEndTime_ != kUndefinedTime);
+  assert(diffStartTime_ != kUndefinedTime);
+  return diffStartTime_ - commitEndTime_;
+}
+
 int64_t MountingTelemetry::getCommitStartTime() const {
   assert(commitStartTime_ != kUndefinedTime);
   assert(commitEndTime_ != kUndefinedTime);
@@ -91,5 +139,11 @@ int64_t MountingTelemetry::getLayoutEndTime() const {
   return layoutEndTime_;
 }
 
+YogaLayoutStatistics const &MountingTelemetry::getLayoutStatistics() const {
+  assert(layoutStartTime_ != kUndefinedTime);
+  assert(layoutEndTime_ != kUndefinedTime);
+  return layoutStatistics_;
+}
+
 } // namespace react
 } // namespace facebook
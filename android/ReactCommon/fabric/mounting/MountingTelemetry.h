@@ -7,9 +7,13 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <limits>
 
+#include <react/components/view/YogaLayoutStatistics.h>
+#include <react/mounting/ShadowViewMutation.h>
+
 namespace facebook {
 namespace react {
 
@@ -23,11 +27,14 @@ class MountingTelemetry final {
    * Signaling
    */
   void willDiff();
-  void didDiff();
+  void didDiff(ShadowViewMutation::List const &mutations);
   void willCommit();
   void didCommit();
   void willLayout();
   void didLayout();
+  void didSkipRevisions(int64_t count);
+  void willMount();
+  void didMount();
 
   /*
    * Reading
@@ -40,6 +47,38 @@ class MountingTelemetry final {
   int64_t getCommitEndTime() const;
   int64_t getCommitNumber() const;
 
+  /*
+   * The time the platform mounting layer spends on the transaction after
+   * pulling it (on Android, converting the mutations into mount items and
+   * handing them over to the UI thread).
+   */
+  int64_t getMountStartTime() const;
+  int64_t getMountEndTime() const;
+
+  /*
+   * Number of mutations of the given type the diff produced.
+   */
+  int getMutationCount(ShadowViewMutation::Type type) const;
+
+  /*
+   * Number of committed revisions that were superseded by this one before the
+   * mounting side pulled them. Their changes are mounted as part of this
+   * revision and were never diffed on their own.
+   */
+  int64_t getSkippedRevisionCount() const;
+
+  /*
+   * Time between the end of the commit and the start of the diff, i.e. how
+   * long the revision waited for the mounting side to pull it.
+   */
+  int64_t getPullLatency() const;
+
+  /*
+   * Counters of the Yoga layout passes that ran between `willLayout()` and
+   * `didLayout()`.
+   */
+  YogaLayoutStatistics const &getLayoutStatistics() const;
+
  private:
   constexpr static int64_t kUndefinedTime = std::numeric_limits<int64_t>::max();
 
@@ -50,6 +89,11 @@ class MountingTelemetry final {
   int64_t commitEndTime_{kUndefinedTime};
   int64_t layoutStartTime_{kUndefinedTime};
   int64_t layoutEndTime_{kUndefinedTime};
+  int64_t mountStartTime_{kUndefinedTime};
+  int64_t mountEndTime_{kUndefinedTime};
+  int64_t skippedRevisionCount_{0};
+  std::array<int, ShadowViewMutation::Update + 1> mutationCounts_{};
+  YogaLayoutStatistics layoutStatistics_{};
 };
 
 } // namespace react
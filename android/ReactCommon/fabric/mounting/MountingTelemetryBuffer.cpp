@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "MountingTelemetryBuffer.h"
+
+#include <type_traits>
+
+namespace facebook {
+namespace react {
+
+static_assert(
+    std::is_trivially_copyable<MountingTelemetryBuffer::Record>::value &&
+        sizeof(MountingTelemetryBuffer::Record) % sizeof(int64_t) == 0,
+    "`Record` must consist of `int64_t` fields only.");
+
+constexpr int MountingTelemetryBuffer::kCapacity;
+
+void MountingTelemetryBuffer::push(
+    SurfaceId surfaceId,
+    MountingTelemetry const &telemetry) {
+  auto record = Record{};
+  record.surfaceId = surfaceId;
+  record.commitNumber = telemetry.getCommitNumber();
+  record.commitStartTime = telemetry.getCommitStartTime();
+  record.commitEndTime = telemetry.getCommitEndTime();
+  record.layoutStartTime = telemetry.getLayoutStartTime();
+  record.layoutEndTime = telemetry.getLayoutEndTime();
+  record.diffStartTime = telemetry.getDiffStartTime();
+  record.diffEndTime = telemetry.getDiffEndTime();
+  record.mountStartTime = telemetry.getMountStartTime();
+  record.mountEndTime = telemetry.getMountEndTime();
+  record.skippedRevisionCount = telemetry.getSkippedRevisionCount();
+  record.createCount = telemetry.getMutationCount(ShadowViewMutation::Create);
+  record.deleteCount = telemetry.getMutationCount(ShadowViewMutation::Delete);
+  record.insertCount = telemetry.getMutationCount(ShadowViewMutation::Insert);
+  record.removeCount = telemetry.getMutationCount(ShadowViewMutation::Remove);
+  record.updateCount = telemetry.getMutationCount(ShadowViewMutation::Update);
+
+  auto const fields = reinterpret_cast<int64_t const *>(&record);
+
+  auto const writeCount = writeCount_.load(std::memory_order_relaxed);
+  auto &slot = slots_[writeCount % kCapacity];
+  auto const sequence = 2 * (writeCount / kCapacity);
+
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (auto index = 0; index < kFieldCount; index++) {
+    slot.fields[index].store(fields[index], std::memory_order_relaxed);
+  }
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+
+  writeCount_.store(writeCount + 1, std::memory_order_release);
+}
+
+std::vector<MountingTelemetryBuffer::Record>
+MountingTelemetryBuffer::getRecords() const {
+  auto const writeCount = writeCount_.load(std::memory_order_acquire);
+  auto const firstIndex = writeCount > kCapacity ? writeCount - kCapacity : 0;
+
+  auto records = std::vector<Record>{};
+  records.reserve(writeCount - firstIndex);
+
+  for (auto index = firstIndex; index < writeCount; index++) {
+    auto const &slot = slots_[index % kCapacity];
+    auto const sequence = 2 * (index / kCapacity + 1);
+
+    if (slot.sequence.load(std::memory_order_acquire) != sequence) {
+      // The slot is being overwritten by a newer record.
+      continue;
+    }
+
+    auto record = Record{};
+    auto const fields = reinterpret_cast<int64_t *>(&record);
+    for (auto field = 0; field < kFieldCount; field++) {
+      fields[field] = slot.fields[field].load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+      continue;
+    }
+
+    records.push_back(record);
+  }
+
+  return records;
+}
+
+} // namespace react
+} // namespace facebook
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <react/core/ReactPrimitives.h>
+#include <react/mounting/MountingTelemetry.h>
+
+namespace facebook {
+namespace react {
+
+/*
+ * Keeps the telemetry of the most recently mounted transactions in a fixed-size
+ * ring, so a sampling profiler can compute commit-to-mount latencies without
+ * enabling systrace.
+ * Writing must be serialized (the mounting layer does it for every transaction
+ * it mounts); reading can happen on any thread at any time and never blocks
+ * the writer. Every slot is guarded by a sequence number (a seqlock), and
+ * records that are overwritten while being read are skipped.
+ */
+class MountingTelemetryBuffer final {
+ public:
+  /*
+   * A flattened copy of `MountingTelemetry` of a mounted transaction.
+   * Times are in the units of `getTime()`.
+   */
+  struct Record {
+    int64_t surfaceId;
+    int64_t commitNumber;
+    int64_t commitStartTime;
+    int64_t commitEndTime;
+    int64_t layoutStartTime;
+    int64_t layoutEndTime;
+    int64_t diffStartTime;
+    int64_t diffEndTime;
+    int64_t mountStartTime;
+    int64_t mountEndTime;
+    int64_t skippedRevisionCount;
+    int64_t createCount;
+    int64_t deleteCount;
+    int64_t insertCount;
+    int64_t removeCount;
+    int64_t updateCount;
+  };
+
+  static constexpr int kCapacity = 256;
+
+  /*
+   * Stores the telemetry of a mounted transaction, replacing the oldest one if
+   * the buffer is full. The telemetry must have all the times set.
+   */
+  void push(SurfaceId surfaceId, MountingTelemetry const &telemetry);
+
+  /*
+   * Returns the stored records, oldest first.
+   * Can be called from any thread.
+   */
+  std::vector<Record> getRecords() const;
+
+ private:
+  static constexpr int kFieldCount = sizeof(Record) / sizeof(int64_t);
+
+  struct Slot {
+    /*
+     * Odd while the slot is being written; `2 * (n + 1)` once the `n`-th write
+     * into the slot finished.
+     */
+    std::atomic<int64_t> sequence{0};
+    std::array<std::atomic<int64_t>, kFieldCount> fields;
+  };
+
+  std::array<Slot, kCapacity> slots_;
+  std::atomic<int64_t> writeCount_{0};
+};
+
+} // namespace react
+} // namespace facebook
@@ -5,6 +5,10 @@
 
 #include "ShadowTree.h"
 
+#include <better/flat_hash_map.h>
+#include <better/small_vector.h>
+#include <microprofiler/MicroProfiler.h>
+
 #include <react/components/root/RootComponentDescriptor.h>
 #include <react/components/view/ViewShadowNode.h>
 #include <react/core/LayoutContext.h>
@@ -26,6 +30,9 @@ static void updateMountedFlag(
   // `mounted` flag on `ShadowNode`s. The algorithm sets "mounted" flag before
   // "unmounted" to allow `ShadowNode` detect a situation where the node was
   // remounted.
+  // Like the differentiator, it only walks subtrees that changed, and it
+  // matches reordered children by tag, so moved (and otherwise unchanged)
+  // children are neither remounted nor walked.
 
   if (&oldChildren == &newChildren) {
     // Lists are identical, nothing to do.
@@ -63,16 +70,71 @@ static void updateMountedFlag(
 
   int lastIndexAfterFirstStage = index;
 
-  // State 2: Mount new children.
+  // Remaining old children that are not matched yet, by tag. Long lists (e.g.
+  // a big list that is being sorted) are indexed to keep this linear.
+  auto remainingOldChildren = better::small_vector<ShadowNode const *, 16>{};
+  auto remainingOldChildIndices = better::flat_hash_map<Tag, int>{};
+  auto const isIndexed = oldChildren.size() - lastIndexAfterFirstStage > 64;
+  for (index = lastIndexAfterFirstStage; index < oldChildren.size(); index++) {
+    if (isIndexed) {
+      remainingOldChildIndices.emplace(
+          oldChildren[index]->getTag(), remainingOldChildren.size());
+    }
+    remainingOldChildren.push_back(oldChildren[index].get());
+  }
+
+  auto takeRemainingOldChild = [&](Tag tag) -> ShadowNode const * {
+    auto position = -1;
+    if (isIndexed) {
+      auto const it = remainingOldChildIndices.find(tag);
+      if (it != remainingOldChildIndices.end()) {
+        position = it->second;
+      }
+    } else {
+      for (auto i = 0; i < remainingOldChildren.size(); i++) {
+        if (remainingOldChildren[i] &&
+            remainingOldChildren[i]->getTag() == tag) {
+          position = i;
+          break;
+        }
+      }
+    }
+
+    if (position == -1 || !remainingOldChildren[position]) {
+      return nullptr;
+    }
+
+    auto const oldChild = remainingOldChildren[position];
+    remainingOldChildren[position] = nullptr;
+    return oldChild;
+  };
+
+  // Stage 2: Mount new children, matching the remaining old ones by tag.
   for (index = lastIndexAfterFirstStage; index < newChildren.size(); index++) {
     const auto &newChild = newChildren[index];
+    auto const oldChild = takeRemainingOldChild(newChild->getTag());
+
+    if (oldChild == newChild.get()) {
+      // The node was moved but is identical, skipping the subtree.
+      continue;
+    }
+
     newChild->setMounted(true);
-    updateMountedFlag({}, newChild->getChildren());
+
+    if (oldChild) {
+      oldChild->setMounted(false);
+      updateMountedFlag(oldChild->getChildren(), newChild->getChildren());
+    } else {
+      updateMountedFlag({}, newChild->getChildren());
+    }
   }
 
-  // State 3: Unmount old children.
-  for (index = lastIndexAfterFirstStage; index < oldChildren.size(); index++) {
-    const auto &oldChild = oldChildren[index];
+  // Stage 3: Unmount old children which are gone.
+  for (auto const oldChild : remainingOldChildren) {
+    if (!oldChild) {
+      continue;
+    }
+
     oldChild->setMounted(false);
     updateMountedFlag(oldChild->getChildren(), {});
   }
@@ -124,6 +186,7 @@ Tag ShadowTree::getSurfaceId() const {
 
 void ShadowTree::commit(ShadowTreeCommitTransaction transaction) const {
   SystraceSection s("ShadowTree::commit");
+  MICRO_PROFILER_SCOPE("ShadowTree::commit");
 
   int attempts = 0;
 
@@ -148,8 +211,7 @@ bool ShadowTree::tryCommit(ShadowTreeCommitTransaction transaction) const {
   SharedRootShadowNode oldRootShadowNode;
 
   {
-    // Reading `rootShadowNode_` in shared manner.
-    std::shared_lock<better::shared_mutex> lock(commitMutex_);
+    std::lock_guard<std::mutex> lock(commitMutex_);
     oldRootShadowNode = rootShadowNode_;
   }
 
@@ -171,25 +233,29 @@ bool ShadowTree::tryCommit(ShadowTreeCommitTransaction transaction) const {
   auto revisionNumber = ShadowTreeRevision::Number{};
 
   {
-    // Updating `rootShadowNode_` in unique manner if it hasn't changed.
-    std::unique_lock<better::shared_mutex> lock(commitMutex_);
+    // Replacing `rootShadowNode_` only if it hasn't changed.
+    std::lock_guard<std::mutex> lock(commitMutex_);
 
     if (rootShadowNode_ != oldRootShadowNode) {
+      conflictCount_++;
       return false;
     }
 
     rootShadowNode_ = newRootShadowNode;
+    revisionNumber = ++revisionNumber_;
+  }
 
-    {
-      std::lock_guard<std::mutex> dispatchLock(EventEmitter::DispatchMutex());
+  commitCount_++;
 
-      updateMountedFlag(
-          oldRootShadowNode->getChildren(), newRootShadowNode->getChildren());
-    }
+  std::unique_lock<std::mutex> lock(mountMutex_);
 
-    revisionNumber_++;
-    revisionNumber = revisionNumber_;
-  }
+  // The previous commit might still be updating `mounted` flags or calling
+  // the delegate.
+  mountCondition_.wait(
+      lock, [&] { return mountedRevisionNumber_ == revisionNumber - 1; });
+
+  updateMountedFlag(
+      oldRootShadowNode->getChildren(), newRootShadowNode->getChildren());
 
   emitLayoutEvents(affectedLayoutableNodes);
 
@@ -202,9 +268,24 @@ bool ShadowTree::tryCommit(ShadowTreeCommitTransaction transaction) const {
     delegate_->shadowTreeDidCommit(*this, mountingCoordinator_);
   }
 
+  mountedRevisionNumber_ = revisionNumber;
+  lock.unlock();
+  mountCondition_.notify_all();
+
   return true;
 }
 
+MountingCoordinator::Shared ShadowTree::getMountingCoordinator() const {
+  return mountingCoordinator_;
+}
+
+ShadowTreeCommitStatistics ShadowTree::getCommitStatistics() const {
+  auto statistics = ShadowTreeCommitStatistics{};
+  statistics.commitCount = commitCount_;
+  statistics.conflictCount = conflictCount_;
+  return statistics;
+}
+
 void ShadowTree::emitLayoutEvents(
     std::vector<LayoutableShadowNode const *> &affectedLayoutableNodes) const {
   SystraceSection s("ShadowTree::emitLayoutEvents");
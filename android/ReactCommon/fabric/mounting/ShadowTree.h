@@ -6,8 +6,10 @@
 #pragma once
 
 
-#include <better/mutex.h>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 
 #include <react/components/root/RootComponentDescriptor.h>
 #include <react/components/root/RootShadowNode.h>
@@ -24,6 +26,22 @@ namespace react {
 using ShadowTreeCommitTransaction = std::function<UnsharedRootShadowNode(
     const SharedRootShadowNode &oldRootShadowNode)>;
 
+/*
+ * Counters describing how commits to a shadow tree went.
+ */
+struct ShadowTreeCommitStatistics {
+  /*
+   * Number of successful commits.
+   */
+  int64_t commitCount{0};
+
+  /*
+   * Number of commits that failed because another commit changed the tree
+   * concurrently (and had to be retried by `commit`).
+   */
+  int64_t conflictCount{0};
+};
+
 /*
  * Represents the shadow tree and its lifecycle.
  */
@@ -50,6 +68,8 @@ class ShadowTree final {
    * and expecting a `newRootShadowNode` as a return value.
    * The `transaction` function can abort commit returning `nullptr`.
    * Returns `true` if the operation finished successfully.
+   * `transaction` and layout run without locking: the commit fails if another
+   * one changed the tree since `transaction` was called.
    */
   bool tryCommit(ShadowTreeCommitTransaction transaction) const;
 
@@ -58,6 +78,18 @@ class ShadowTree final {
    */
   void commit(ShadowTreeCommitTransaction transaction) const;
 
+  /*
+   * Returns the commit counters accumulated so far.
+   * Can be called from any thread.
+   */
+  ShadowTreeCommitStatistics getCommitStatistics() const;
+
+  /*
+   * Returns the `MountingCoordinator` of the shadow tree.
+   * Can be called from any thread.
+   */
+  MountingCoordinator::Shared getMountingCoordinator() const;
+
 #pragma mark - Delegate
 
   /*
@@ -78,10 +110,26 @@ class ShadowTree final {
       std::vector<LayoutableShadowNode const *> &affectedLayoutableNodes) const;
 
   SurfaceId const surfaceId_;
-  mutable better::shared_mutex commitMutex_;
+
+  /*
+   * Only held to read or swap the root, never while a commit runs.
+   */
+  mutable std::mutex commitMutex_;
   mutable SharedRootShadowNode rootShadowNode_; // Protected by `commitMutex_`.
   mutable ShadowTreeRevision::Number revisionNumber_{
       0}; // Protected by `commitMutex_`.
+
+  /*
+   * A commit waits for the previous revision to be mounted before updating
+   * the `mounted` flags, pushing to the `MountingCoordinator` and calling the
+   * delegate, which keeps those in commit order.
+   */
+  mutable std::mutex mountMutex_;
+  mutable std::condition_variable mountCondition_;
+  mutable ShadowTreeRevision::Number mountedRevisionNumber_{
+      0}; // Protected by `mountMutex_`.
+  mutable std::atomic<int64_t> commitCount_{0};
+  mutable std::atomic<int64_t> conflictCount_{0};
   ShadowTreeDelegate const *delegate_;
   MountingCoordinator::Shared mountingCoordinator_;
 };
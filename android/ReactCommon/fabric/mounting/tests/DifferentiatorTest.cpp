@@ -0,0 +1,553 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <react/components/view/ViewComponentDescriptor.h>
+#include <react/mounting/Differentiator.h>
+
+using namespace facebook::react;
+
+char const CollapsableViewComponentName[] = "CollapsableView";
+char const CullingViewComponentName[] = "CullingView";
+char const LayoutOnlyViewComponentName[] = "LayoutOnlyView";
+char const PositionedViewComponentName[] = "PositionedView";
+
+/*
+ * A view whose layout metrics can be set directly.
+ */
+class PositionedViewShadowNode final : public ConcreteViewShadowNode<
+                                           PositionedViewComponentName,
+                                           ViewProps,
+                                           ViewEventEmitter> {
+ public:
+  using ConcreteViewShadowNode::ConcreteViewShadowNode;
+  using ConcreteViewShadowNode::setLayoutMetrics;
+};
+
+/*
+ * A positioned view which is always flattened into its parent.
+ */
+class LayoutOnlyViewShadowNode final : public ConcreteViewShadowNode<
+                                           LayoutOnlyViewComponentName,
+                                           ViewProps,
+                                           ViewEventEmitter> {
+ public:
+  using ConcreteViewShadowNode::ConcreteViewShadowNode;
+  using ConcreteViewShadowNode::setLayoutMetrics;
+
+  bool isLayoutOnly() const override {
+    return true;
+  }
+};
+
+/*
+ * A positioned view which (like a <View>) is flattened into its parent while
+ * it's `collapsable`.
+ */
+class CollapsableViewShadowNode final : public ConcreteViewShadowNode<
+                                            CollapsableViewComponentName,
+                                            ViewProps,
+                                            ViewEventEmitter> {
+ public:
+  using ConcreteViewShadowNode::ConcreteViewShadowNode;
+  using ConcreteViewShadowNode::setLayoutMetrics;
+
+  bool isLayoutOnly() const override {
+    return getProps()->collapsable;
+  }
+};
+
+/*
+ * A view which (like a <ScrollView> with `removeClippedSubviews`) mounts only
+ * the children above y = 100.
+ */
+class CullingViewShadowNode final : public ConcreteViewShadowNode<
+                                        CullingViewComponentName,
+                                        ViewProps,
+                                        ViewEventEmitter> {
+ public:
+  using ConcreteViewShadowNode::ConcreteViewShadowNode;
+
+  bool shouldMountChild(LayoutMetrics const &childLayoutMetrics) const override {
+    return childLayoutMetrics.frame.origin.y < 100;
+  }
+};
+
+static SharedViewProps nonCollapsableViewProps() {
+  auto const &raw = RawProps(folly::dynamic::object("collapsable", false));
+  auto parser = RawPropsParser();
+  parser.prepare<ViewProps>();
+  raw.parse(parser);
+  return std::make_shared<ViewProps const>(ViewProps(), raw);
+}
+
+static ShadowNode::Shared makeNode(
+    ComponentDescriptor const &componentDescriptor,
+    Tag tag,
+    SharedShadowNodeList const &children = {}) {
+  static auto const props = nonCollapsableViewProps();
+
+  return std::make_shared<ViewShadowNode>(
+      ShadowNodeFragment{
+          /* .tag = */ tag,
+          /* .surfaceId = */ 1,
+          /* .props = */ props,
+          /* .eventEmitter = */ ShadowNodeFragment::eventEmitterPlaceholder(),
+          /* .children = */
+          std::make_shared<SharedShadowNodeList>(children),
+      },
+      componentDescriptor);
+}
+
+static ShadowNode::Shared cloneNode(
+    ShadowNode const &shadowNode,
+    SharedShadowNodeList const &children) {
+  return shadowNode.clone(ShadowNodeFragment{
+      /* .tag = */ ShadowNodeFragment::tagPlaceholder(),
+      /* .surfaceId = */ ShadowNodeFragment::surfaceIdPlaceholder(),
+      /* .props = */ ShadowNodeFragment::propsPlaceholder(),
+      /* .eventEmitter = */ ShadowNodeFragment::eventEmitterPlaceholder(),
+      /* .children = */ std::make_shared<SharedShadowNodeList>(children),
+  });
+}
+
+/*
+ * Builds a root node with the children `oldChildTags` and a clone of it with
+ * the children `newChildTags`. Children with the same tag are the same node in
+ * both trees, as they are after a commit which only reorders them.
+ */
+static std::pair<ShadowNode::Shared, ShadowNode::Shared> makeTrees(
+    ComponentDescriptor const &componentDescriptor,
+    std::vector<Tag> const &oldChildTags,
+    std::vector<Tag> const &newChildTags,
+    Tag rootTag = 1) {
+  auto nodes = std::map<Tag, ShadowNode::Shared>{};
+  auto makeChildren = [&](std::vector<Tag> const &childTags) {
+    auto children = SharedShadowNodeList{};
+    for (auto const childTag : childTags) {
+      auto &node = nodes[childTag];
+      if (!node) {
+        node = makeNode(componentDescriptor, childTag);
+      }
+      children.push_back(node);
+    }
+    return children;
+  };
+
+  auto oldRootShadowNode =
+      makeNode(componentDescriptor, rootTag, makeChildren(oldChildTags));
+  auto newRootShadowNode =
+      cloneNode(*oldRootShadowNode, makeChildren(newChildTags));
+  return {oldRootShadowNode, newRootShadowNode};
+}
+
+/*
+ * Applies the mutations to the list of child tags of the root view, checking
+ * that every `Remove` refers to the view at its index.
+ */
+static void applyMutations(
+    std::vector<Tag> &childTags,
+    ShadowViewMutation::List const &mutations) {
+  for (auto const &mutation : mutations) {
+    switch (mutation.type) {
+      case ShadowViewMutation::Insert:
+        ASSERT_LE(mutation.index, childTags.size());
+        childTags.insert(
+            childTags.begin() + mutation.index,
+            mutation.newChildShadowView.tag);
+        break;
+      case ShadowViewMutation::Remove:
+        ASSERT_LT(mutation.index, childTags.size());
+        ASSERT_EQ(
+            childTags[mutation.index], mutation.oldChildShadowView.tag);
+        childTags.erase(childTags.begin() + mutation.index);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+static std::vector<std::tuple<int, Tag, Tag, Tag, int>> describeMutations(
+    ShadowViewMutation::List const &mutations) {
+  auto descriptions = std::vector<std::tuple<int, Tag, Tag, Tag, int>>{};
+  for (auto const &mutation : mutations) {
+    descriptions.push_back(std::make_tuple(
+        mutation.type,
+        mutation.parentShadowView.tag,
+        mutation.oldChildShadowView.tag,
+        mutation.newChildShadowView.tag,
+        mutation.index));
+  }
+  return descriptions;
+}
+
+static int countMutations(
+    ShadowViewMutation::List const &mutations,
+    ShadowViewMutation::Type type) {
+  return std::count_if(
+      mutations.begin(), mutations.end(), [&](auto const &mutation) {
+        return mutation.type == type;
+      });
+}
+
+static std::vector<Tag> makeTags(int count, Tag firstTag = 100) {
+  auto tags = std::vector<Tag>(count);
+  for (auto index = 0; index < count; index++) {
+    tags[index] = firstTag + index;
+  }
+  return tags;
+}
+
+TEST(DifferentiatorTest, movingOneChildProducesOneRemoveInsertPair) {
+  auto componentDescriptor = ViewComponentDescriptor(nullptr);
+
+  for (auto const count : {8, 600}) {
+    auto const oldTags = makeTags(count);
+    auto newTags = oldTags;
+    std::rotate(newTags.begin(), newTags.end() - 1, newTags.end());
+
+    auto const trees = makeTrees(componentDescriptor, oldTags, newTags);
+    auto const mutations =
+        calculateShadowViewMutations(*trees.first, *trees.second);
+
+    EXPECT_EQ(countMutations(mutations, ShadowViewMutation::Remove), 1);
+    EXPECT_EQ(countMutations(mutations, ShadowViewMutation::Insert), 1);
+    EXPECT_EQ(countMutations(mutations, ShadowViewMutation::Create), 0);
+    EXPECT_EQ(countMutations(mutations, ShadowViewMutation::Delete), 0);
+
+    auto childTags = oldTags;
+    applyMutations(childTags, mutations);
+    EXPECT_EQ(childTags, newTags);
+  }
+}
+
+TEST(DifferentiatorTest, swappingTwoChildrenProducesTwoRemoveInsertPairs) {
+  auto componentDescriptor = ViewComponentDescriptor(nullptr);
+
+  auto const oldTags = makeTags(500);
+  auto newTags = oldTags;
+  std::swap(newTags[10], newTags[400]);
+
+  auto const trees = makeTrees(componentDescriptor, oldTags, newTags);
+  auto const mutations =
+      calculateShadowViewMutations(*trees.first, *trees.second);
+
+  EXPECT_EQ(countMutations(mutations, ShadowViewMutation::Remove), 2);
+  EXPECT_EQ(countMutations(mutations, ShadowViewMutation::Insert), 2);
+
+  auto childTags = oldTags;
+  applyMutations(childTags, mutations);
+  EXPECT_EQ(childTags, newTags);
+}
+
+TEST(DifferentiatorTest, shufflingChildrenProducesTheNewOrder) {
+  auto componentDescriptor = ViewComponentDescriptor(nullptr);
+  auto random = std::mt19937{};
+
+  for (auto const count : {0, 1, 5, 16, 64, 65, 300}) {
+    for (auto iteration = 0; iteration < 20; iteration++) {
+      auto oldTags = makeTags(count);
+      auto newTags = makeTags(count / 3, 10000);
+      std::copy_if(
+          oldTags.begin(),
+          oldTags.end(),
+          std::back_inserter(newTags),
+          [&](Tag) { return random() % 4 != 0; });
+      if (iteration % 2 == 0) {
+        std::shuffle(newTags.begin(), newTags.end(), random);
+      } else {
+        // Mostly ordered, as when a few rows of a list move.
+        for (auto index = 0; index + 1 < newTags.size(); index += 7) {
+          std::swap(newTags[index], newTags[random() % newTags.size()]);
+        }
+      }
+
+      auto const trees = makeTrees(componentDescriptor, oldTags, newTags);
+      auto const mutations =
+          calculateShadowViewMutations(*trees.first, *trees.second);
+
+      auto childTags = oldTags;
+      applyMutations(childTags, mutations);
+      EXPECT_EQ(childTags, newTags);
+
+      auto const removedCount = std::count_if(
+          oldTags.begin(), oldTags.end(), [&](Tag tag) {
+            return std::find(newTags.begin(), newTags.end(), tag) ==
+                newTags.end();
+          });
+      EXPECT_EQ(
+          countMutations(mutations, ShadowViewMutation::Delete), removedCount);
+      EXPECT_EQ(
+          countMutations(mutations, ShadowViewMutation::Create), count / 3);
+    }
+  }
+}
+
+TEST(DifferentiatorTest, parallelModeProducesTheSameMutations) {
+  auto componentDescriptor = ViewComponentDescriptor(nullptr);
+  auto random = std::mt19937{};
+
+  auto oldSections = SharedShadowNodeList{};
+  auto newSections = SharedShadowNodeList{};
+  for (auto section = 0; section < 12; section++) {
+    auto const firstTag = Tag{1000 * (section + 1)};
+    auto const oldTags = makeTags(40, firstTag);
+    auto newTags = makeTags(5, firstTag + 500);
+    std::copy_if(
+        oldTags.begin(),
+        oldTags.end(),
+        std::back_inserter(newTags),
+        [&](Tag) { return random() % 5 != 0; });
+    std::shuffle(newTags.begin(), newTags.end(), random);
+
+    auto const trees =
+        makeTrees(componentDescriptor, oldTags, newTags, 100 + section);
+    oldSections.push_back(trees.first);
+    switch (section % 4) {
+      case 0: // Unchanged.
+        newSections.push_back(trees.first);
+        break;
+      case 1: // Removed.
+        break;
+      default:
+        newSections.push_back(trees.second);
+        break;
+    }
+  }
+  // An added section.
+  newSections.push_back(
+      makeTrees(componentDescriptor, {}, makeTags(30, 9000), 200).second);
+
+  // The sections are in a container which is the only child of the root.
+  auto const oldContainer = makeNode(componentDescriptor, 2, oldSections);
+  auto const oldRoot = makeNode(componentDescriptor, 1, {oldContainer});
+  auto const newRoot =
+      cloneNode(*oldRoot, {cloneNode(*oldContainer, newSections)});
+
+  auto const sequentialMutations = calculateShadowViewMutations(
+      *oldRoot, *newRoot, DifferentiatorMode::Sequential);
+  auto const parallelMutations = calculateShadowViewMutations(
+      *oldRoot, *newRoot, DifferentiatorMode::Parallel);
+
+  EXPECT_FALSE(sequentialMutations.empty());
+  EXPECT_EQ(
+      describeMutations(parallelMutations),
+      describeMutations(sequentialMutations));
+}
+
+TEST(DifferentiatorTest, culledChildrenAreNotMounted) {
+  auto positionedComponentDescriptor =
+      ConcreteComponentDescriptor<PositionedViewShadowNode>(nullptr);
+  auto cullingComponentDescriptor =
+      ConcreteComponentDescriptor<CullingViewShadowNode>(nullptr);
+
+  // The children are at y = 0, 75 and 150.
+  auto children = SharedShadowNodeList{};
+  for (auto const tag : makeTags(3)) {
+    auto child = std::make_shared<PositionedViewShadowNode>(
+        ShadowNodeFragment{
+            /* .tag = */ tag,
+            /* .surfaceId = */ 1,
+            /* .props = */ nonCollapsableViewProps(),
+            /* .eventEmitter = */
+            ShadowNodeFragment::eventEmitterPlaceholder(),
+        },
+        positionedComponentDescriptor);
+    auto layoutMetrics = EmptyLayoutMetrics;
+    layoutMetrics.frame = Rect{{0, Float(75 * (tag - 100))}, {100, 50}};
+    child->setLayoutMetrics(layoutMetrics);
+    children.push_back(child);
+  }
+
+  auto const cullingShadowNode = std::make_shared<CullingViewShadowNode>(
+      ShadowNodeFragment{
+          /* .tag = */ 1,
+          /* .surfaceId = */ 1,
+          /* .props = */ nonCollapsableViewProps(),
+          /* .eventEmitter = */ ShadowNodeFragment::eventEmitterPlaceholder(),
+          /* .children = */
+          std::make_shared<SharedShadowNodeList>(children),
+      },
+      cullingComponentDescriptor);
+
+  auto tags = std::vector<Tag>{};
+  for (auto const &pair : sliceChildShadowNodeViewPairs(*cullingShadowNode)) {
+    tags.push_back(pair.shadowView.tag);
+  }
+  EXPECT_EQ(tags, (std::vector<Tag>{100, 101}));
+}
+
+TEST(DifferentiatorTest, sharedChildOfMovedLayoutOnlyViewIsUpdated) {
+  auto componentDescriptor = ViewComponentDescriptor(nullptr);
+  auto positionedComponentDescriptor =
+      ConcreteComponentDescriptor<PositionedViewShadowNode>(nullptr);
+  auto layoutOnlyComponentDescriptor =
+      ConcreteComponentDescriptor<LayoutOnlyViewShadowNode>(nullptr);
+
+  auto const child = std::make_shared<PositionedViewShadowNode>(
+      ShadowNodeFragment{
+          /* .tag = */ 100,
+          /* .surfaceId = */ 1,
+          /* .props = */ nonCollapsableViewProps(),
+          /* .eventEmitter = */ ShadowNodeFragment::eventEmitterPlaceholder(),
+      },
+      positionedComponentDescriptor);
+  auto childLayoutMetrics = EmptyLayoutMetrics;
+  childLayoutMetrics.frame = Rect{{5, 5}, {10, 10}};
+  child->setLayoutMetrics(childLayoutMetrics);
+
+  auto const oldLayoutOnlyShadowNode =
+      std::make_shared<LayoutOnlyViewShadowNode>(
+          ShadowNodeFragment{
+              /* .tag = */ 2,
+              /* .surfaceId = */ 1,
+              /* .props = */ nonCollapsableViewProps(),
+              /* .eventEmitter = */
+              ShadowNodeFragment::eventEmitterPlaceholder(),
+              /* .children = */
+              std::make_shared<SharedShadowNodeList>(
+                  SharedShadowNodeList{child}),
+          },
+          layoutOnlyComponentDescriptor);
+
+  // Only the layout-only view moves, its child is shared by both trees.
+  auto const newLayoutOnlyShadowNode =
+      std::static_pointer_cast<LayoutOnlyViewShadowNode>(
+          oldLayoutOnlyShadowNode->clone(ShadowNodeFragment{}));
+  auto layoutOnlyLayoutMetrics = EmptyLayoutMetrics;
+  layoutOnlyLayoutMetrics.frame = Rect{{0, 20}, {100, 100}};
+  newLayoutOnlyShadowNode->setLayoutMetrics(layoutOnlyLayoutMetrics);
+
+  auto const oldRoot =
+      makeNode(componentDescriptor, 1, {oldLayoutOnlyShadowNode});
+  auto const newRoot = cloneNode(*oldRoot, {newLayoutOnlyShadowNode});
+
+  EXPECT_TRUE(calculateShadowViewMutations(*oldRoot, *oldRoot).empty());
+
+  auto const mutations = calculateShadowViewMutations(*oldRoot, *newRoot);
+  ASSERT_EQ(mutations.size(), 1);
+  EXPECT_EQ(mutations[0].type, ShadowViewMutation::Update);
+  EXPECT_EQ(mutations[0].newChildShadowView.tag, 100);
+  EXPECT_EQ(
+      mutations[0].newChildShadowView.layoutMetrics.frame.origin,
+      (Point{5, 25}));
+}
+
+TEST(DifferentiatorTest, childrenOfFlattenedOrUnflattenedViewAreReparented) {
+  auto componentDescriptor = ViewComponentDescriptor(nullptr);
+  auto positionedComponentDescriptor =
+      ConcreteComponentDescriptor<PositionedViewShadowNode>(nullptr);
+  auto collapsableComponentDescriptor =
+      ConcreteComponentDescriptor<CollapsableViewShadowNode>(nullptr);
+
+  auto const child = std::make_shared<PositionedViewShadowNode>(
+      ShadowNodeFragment{
+          /* .tag = */ 100,
+          /* .surfaceId = */ 1,
+          /* .props = */ nonCollapsableViewProps(),
+          /* .eventEmitter = */ ShadowNodeFragment::eventEmitterPlaceholder(),
+      },
+      positionedComponentDescriptor);
+  auto childLayoutMetrics = EmptyLayoutMetrics;
+  childLayoutMetrics.frame = Rect{{5, 5}, {10, 10}};
+  child->setLayoutMetrics(childLayoutMetrics);
+
+  auto const collapsedShadowNode = std::make_shared<CollapsableViewShadowNode>(
+      ShadowNodeFragment{
+          /* .tag = */ 2,
+          /* .surfaceId = */ 1,
+          /* .props = */ std::make_shared<ViewProps const>(),
+          /* .eventEmitter = */ ShadowNodeFragment::eventEmitterPlaceholder(),
+          /* .children = */
+          std::make_shared<SharedShadowNodeList>(SharedShadowNodeList{child}),
+      },
+      collapsableComponentDescriptor);
+  auto wrapperLayoutMetrics = EmptyLayoutMetrics;
+  wrapperLayoutMetrics.frame = Rect{{0, 20}, {100, 100}};
+  collapsedShadowNode->setLayoutMetrics(wrapperLayoutMetrics);
+
+  // The wrapper is not layout-only anymore, e.g. because it got an opacity.
+  auto const uncollapsedShadowNode = collapsedShadowNode->clone(
+      ShadowNodeFragment{
+          /* .tag = */ ShadowNodeFragment::tagPlaceholder(),
+          /* .surfaceId = */ ShadowNodeFragment::surfaceIdPlaceholder(),
+          /* .props = */ nonCollapsableViewProps(),
+      });
+
+  auto const collapsedRoot =
+      makeNode(componentDescriptor, 1, {collapsedShadowNode});
+  auto const uncollapsedRoot =
+      cloneNode(*collapsedRoot, {uncollapsedShadowNode});
+
+  auto const findMutation = [](ShadowViewMutation::List const &mutations,
+                               ShadowViewMutation::Type type,
+                               Tag tag) -> ShadowViewMutation const * {
+    for (auto const &mutation : mutations) {
+      auto const &shadowView = type == ShadowViewMutation::Remove ||
+              type == ShadowViewMutation::Delete
+          ? mutation.oldChildShadowView
+          : mutation.newChildShadowView;
+      if (mutation.type == type && shadowView.tag == tag) {
+        return &mutation;
+      }
+    }
+    return nullptr;
+  };
+
+  // The child moves into the wrapper's new view.
+  auto mutations =
+      calculateShadowViewMutations(*collapsedRoot, *uncollapsedRoot);
+  EXPECT_EQ(mutations.size(), 5);
+  EXPECT_EQ(countMutations(mutations, ShadowViewMutation::Delete), 0);
+  EXPECT_EQ(countMutations(mutations, ShadowViewMutation::Create), 1);
+  ASSERT_NE(findMutation(mutations, ShadowViewMutation::Create, 2), nullptr);
+  auto remove = findMutation(mutations, ShadowViewMutation::Remove, 100);
+  ASSERT_NE(remove, nullptr);
+  EXPECT_EQ(remove->parentShadowView.tag, 1);
+  auto insert = findMutation(mutations, ShadowViewMutation::Insert, 100);
+  ASSERT_NE(insert, nullptr);
+  EXPECT_EQ(insert->parentShadowView.tag, 2);
+  EXPECT_GT(insert, remove);
+  auto update = findMutation(mutations, ShadowViewMutation::Update, 100);
+  ASSERT_NE(update, nullptr);
+  EXPECT_EQ(
+      update->newChildShadowView.layoutMetrics.frame.origin, (Point{5, 5}));
+  ASSERT_NE(findMutation(mutations, ShadowViewMutation::Insert, 2), nullptr);
+
+  // And back into the root's view.
+  mutations = calculateShadowViewMutations(*uncollapsedRoot, *collapsedRoot);
+  EXPECT_EQ(mutations.size(), 5);
+  EXPECT_EQ(countMutations(mutations, ShadowViewMutation::Create), 0);
+  EXPECT_EQ(countMutations(mutations, ShadowViewMutation::Delete), 1);
+  ASSERT_NE(findMutation(mutations, ShadowViewMutation::Delete, 2), nullptr);
+  ASSERT_NE(findMutation(mutations, ShadowViewMutation::Remove, 2), nullptr);
+  remove = findMutation(mutations, ShadowViewMutation::Remove, 100);
+  ASSERT_NE(remove, nullptr);
+  EXPECT_EQ(remove->parentShadowView.tag, 2);
+  insert = findMutation(mutations, ShadowViewMutation::Insert, 100);
+  ASSERT_NE(insert, nullptr);
+  EXPECT_EQ(insert->parentShadowView.tag, 1);
+  EXPECT_GT(insert, remove);
+  update = findMutation(mutations, ShadowViewMutation::Update, 100);
+  ASSERT_NE(update, nullptr);
+  EXPECT_EQ(
+      update->newChildShadowView.layoutMetrics.frame.origin, (Point{5, 25}));
+
+  EXPECT_EQ(
+      describeMutations(mutations),
+      describeMutations(calculateShadowViewMutations(
+          *uncollapsedRoot, *collapsedRoot, DifferentiatorMode::Parallel)));
+}
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+#include <react/mounting/MountingTelemetryBuffer.h>
+
+using namespace facebook::react;
+
+static MountingTelemetry makeTelemetry(int skippedRevisionCount) {
+  auto telemetry = MountingTelemetry{};
+  telemetry.willCommit();
+  telemetry.willLayout();
+  telemetry.didLayout();
+  telemetry.didCommit();
+  telemetry.willDiff();
+  auto mutations = ShadowViewMutation::List{};
+  mutations.push_back(ShadowViewMutation::CreateMutation(ShadowView{}));
+  mutations.push_back(ShadowViewMutation::CreateMutation(ShadowView{}));
+  mutations.push_back(ShadowViewMutation::DeleteMutation(ShadowView{}));
+  telemetry.didDiff(mutations);
+  telemetry.didSkipRevisions(skippedRevisionCount);
+  telemetry.willMount();
+  telemetry.didMount();
+  return telemetry;
+}
+
+TEST(MountingTelemetryBufferTest, recordsTransactionsOldestFirst) {
+  auto buffer = std::make_unique<MountingTelemetryBuffer>();
+  EXPECT_TRUE(buffer->getRecords().empty());
+
+  for (auto index = 0; index < 3; index++) {
+    buffer->push(index + 1, makeTelemetry(index));
+  }
+
+  auto const records = buffer->getRecords();
+  ASSERT_EQ(records.size(), 3);
+  for (auto index = 0; index < 3; index++) {
+    EXPECT_EQ(records[index].surfaceId, index + 1);
+    EXPECT_EQ(records[index].skippedRevisionCount, index);
+    EXPECT_EQ(records[index].createCount, 2);
+    EXPECT_EQ(records[index].deleteCount, 1);
+    EXPECT_EQ(records[index].updateCount, 0);
+    EXPECT_LE(records[index].commitStartTime, records[index].mountEndTime);
+  }
+}
+
+TEST(MountingTelemetryBufferTest, keepsOnlyTheMostRecentTransactions) {
+  auto buffer = std::make_unique<MountingTelemetryBuffer>();
+  auto const count = MountingTelemetryBuffer::kCapacity + 10;
+
+  for (auto index = 0; index < count; index++) {
+    buffer->push(index, makeTelemetry(0));
+  }
+
+  auto const records = buffer->getRecords();
+  ASSERT_EQ(records.size(), MountingTelemetryBuffer::kCapacity);
+  EXPECT_EQ(records.front().surfaceId, 10);
+  EXPECT_EQ(records.back().surfaceId, count - 1);
+}
@@ -0,0 +1,255 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <benchmark/benchmark.h>
+#include <folly/dynamic.h>
+#include <react/components/root/RootComponentDescriptor.h>
+#include <react/components/view/ViewComponentDescriptor.h>
+#include <react/core/EventDispatcher.h>
+#include <react/core/RawProps.h>
+#include <react/mounting/Differentiator.h>
+#include <react/mounting/ShadowTree.h>
+#include <react/utils/ContextContainer.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace facebook {
+namespace react {
+
+auto contextContainer = std::make_shared<ContextContainer const>();
+auto eventDispatcher = std::shared_ptr<EventDispatcher>{nullptr};
+auto viewComponentDescriptor =
+    ViewComponentDescriptor(eventDispatcher, contextContainer);
+auto rootComponentDescriptor =
+    RootComponentDescriptor(eventDispatcher, contextContainer);
+
+auto const surfaceId = SurfaceId{1};
+auto nextTag = Tag{2};
+
+// Not `collapsable`, so none of the views is flattened away.
+auto viewProps = viewComponentDescriptor.cloneProps(
+    nullptr,
+    RawProps{folly::dynamic::object("collapsable", false)("height", 10)});
+auto changedViewProps = viewComponentDescriptor.cloneProps(
+    viewProps, RawProps{folly::dynamic::object("opacity", 0.5)});
+
+static ShadowNode::Shared makeView(SharedShadowNodeList const &children = {}) {
+  auto const tag = nextTag++;
+  return viewComponentDescriptor.createShadowNode(ShadowNodeFragment{
+      /* .tag = */ tag,
+      /* .surfaceId = */ surfaceId,
+      /* .props = */ viewProps,
+      /* .eventEmitter = */
+      viewComponentDescriptor.createEventEmitter(nullptr, tag),
+      /* .children = */ std::make_shared<SharedShadowNodeList>(children),
+  });
+}
+
+static ShadowNode::Shared cloneView(
+    ShadowNode const &shadowNode,
+    SharedShadowNodeList const &children) {
+  return shadowNode.clone(ShadowNodeFragment{
+      /* .tag = */ ShadowNodeFragment::tagPlaceholder(),
+      /* .surfaceId = */ ShadowNodeFragment::surfaceIdPlaceholder(),
+      /* .props = */ ShadowNodeFragment::propsPlaceholder(),
+      /* .eventEmitter = */ ShadowNodeFragment::eventEmitterPlaceholder(),
+      /* .children = */ std::make_shared<SharedShadowNodeList>(children),
+  });
+}
+
+/*
+ * A row of a list: a view with a couple of leaf views.
+ */
+static ShadowNode::Shared makeRow() {
+  return makeView({makeView(), makeView()});
+}
+
+static SharedShadowNodeList makeRows(int count) {
+  auto rows = SharedShadowNodeList{};
+  for (auto index = 0; index < count; index++) {
+    rows.push_back(makeRow());
+  }
+  return rows;
+}
+
+/*
+ * Children of the root view before and after a typical update.
+ */
+struct TreeUpdate {
+  SharedShadowNodeList oldChildren;
+  SharedShadowNodeList newChildren;
+};
+
+static TreeUpdate initialRender(int rowCount) {
+  return {{}, {makeView(makeRows(rowCount))}};
+}
+
+static TreeUpdate listInsertAtHead(int rowCount) {
+  auto const oldRows = makeRows(rowCount);
+  auto newRows = oldRows;
+  newRows.insert(newRows.begin(), makeRow());
+  auto const oldList = makeView(oldRows);
+  return {{oldList}, {cloneView(*oldList, newRows)}};
+}
+
+static TreeUpdate listReorder(int rowCount) {
+  auto const oldRows = makeRows(rowCount);
+  auto newRows = oldRows;
+  std::reverse(newRows.begin(), newRows.end());
+  auto const oldList = makeView(oldRows);
+  return {{oldList}, {cloneView(*oldList, newRows)}};
+}
+
+/*
+ * Changes the props of the leaf at the end of a path of `depth` views, each
+ * of them with a couple of siblings, cloning the path like a commit from JS
+ * does.
+ */
+static TreeUpdate deepLeafPropChange(int depth) {
+  auto path = SharedShadowNodeList{makeView()};
+  for (auto level = 0; level < depth; level++) {
+    path.push_back(makeView({makeView(), path.back(), makeView()}));
+  }
+
+  auto newNode = ShadowNode::Shared{path.front()->clone(ShadowNodeFragment{
+      /* .tag = */ ShadowNodeFragment::tagPlaceholder(),
+      /* .surfaceId = */ ShadowNodeFragment::surfaceIdPlaceholder(),
+      /* .props = */ changedViewProps,
+  })};
+  for (auto level = 1; level < path.size(); level++) {
+    auto children = path[level]->getChildren();
+    children[1] = newNode;
+    newNode = cloneView(*path[level], children);
+  }
+  return {{path.back()}, {newNode}};
+}
+
+static TreeUpdate fullReplacement(int rowCount) {
+  return {{makeView(makeRows(rowCount))}, {makeView(makeRows(rowCount))}};
+}
+
+#pragma mark - Differentiator
+
+static void diff(benchmark::State &state, TreeUpdate update) {
+  auto const oldRoot = makeView(update.oldChildren);
+  auto const newRoot = cloneView(*oldRoot, update.newChildren);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(calculateShadowViewMutations(*oldRoot, *newRoot));
+  }
+}
+
+static void diffInitialRender(benchmark::State &state) {
+  diff(state, initialRender(state.range(0)));
+}
+BENCHMARK(diffInitialRender)->Arg(100)->Arg(1000);
+
+static void diffListInsertAtHead(benchmark::State &state) {
+  diff(state, listInsertAtHead(state.range(0)));
+}
+BENCHMARK(diffListInsertAtHead)->Arg(100)->Arg(1000);
+
+static void diffListReorder(benchmark::State &state) {
+  diff(state, listReorder(state.range(0)));
+}
+BENCHMARK(diffListReorder)->Arg(100)->Arg(1000);
+
+static void diffDeepLeafPropChange(benchmark::State &state) {
+  diff(state, deepLeafPropChange(state.range(0)));
+}
+BENCHMARK(diffDeepLeafPropChange)->Arg(10)->Arg(100);
+
+static void diffFullReplacement(benchmark::State &state) {
+  diff(state, fullReplacement(state.range(0)));
+}
+BENCHMARK(diffFullReplacement)->Arg(100)->Arg(1000);
+
+#pragma mark - Committing and mounting
+
+static void commitChildren(
+    ShadowTree const &shadowTree,
+    SharedShadowNodeList const &children) {
+  shadowTree.commit([&](SharedRootShadowNode const &oldRootShadowNode) {
+    return std::make_shared<RootShadowNode>(
+        *oldRootShadowNode,
+        ShadowNodeFragment{
+            /* .tag = */ ShadowNodeFragment::tagPlaceholder(),
+            /* .surfaceId = */ ShadowNodeFragment::surfaceIdPlaceholder(),
+            /* .props = */ ShadowNodeFragment::propsPlaceholder(),
+            /* .eventEmitter = */
+            ShadowNodeFragment::eventEmitterPlaceholder(),
+            /* .children = */
+            std::make_shared<SharedShadowNodeList>(children),
+        });
+  });
+}
+
+/*
+ * Commits the update back and forth, so every commit changes the tree. This
+ * includes layout and updating the `mounted` flags, and (with
+ * `pullsTransactions`) diffing the mounted tree against the committed one.
+ */
+static void commit(
+    benchmark::State &state,
+    TreeUpdate update,
+    bool pullsTransactions) {
+  ShadowTree shadowTree{
+      surfaceId, LayoutConstraints{}, LayoutContext{}, rootComponentDescriptor};
+  auto const mountingCoordinator = shadowTree.getMountingCoordinator();
+
+  commitChildren(shadowTree, update.oldChildren);
+  mountingCoordinator->pullTransaction();
+
+  auto isUpdated = false;
+  for (auto _ : state) {
+    isUpdated = !isUpdated;
+    commitChildren(
+        shadowTree, isUpdated ? update.newChildren : update.oldChildren);
+    if (pullsTransactions) {
+      benchmark::DoNotOptimize(mountingCoordinator->pullTransaction());
+    }
+  }
+
+  if (!pullsTransactions) {
+    mountingCoordinator->pullTransaction();
+  }
+}
+
+static void commitListInsertAtHead(benchmark::State &state) {
+  commit(state, listInsertAtHead(state.range(0)), false);
+}
+BENCHMARK(commitListInsertAtHead)->Arg(100)->Arg(1000);
+
+static void commitDeepLeafPropChange(benchmark::State &state) {
+  commit(state, deepLeafPropChange(state.range(0)), false);
+}
+BENCHMARK(commitDeepLeafPropChange)->Arg(10)->Arg(100);
+
+static void commitAndPullListInsertAtHead(benchmark::State &state) {
+  commit(state, listInsertAtHead(state.range(0)), true);
+}
+BENCHMARK(commitAndPullListInsertAtHead)->Arg(100)->Arg(1000);
+
+static void commitAndPullListReorder(benchmark::State &state) {
+  commit(state, listReorder(state.range(0)), true);
+}
+BENCHMARK(commitAndPullListReorder)->Arg(100)->Arg(1000);
+
+static void commitAndPullDeepLeafPropChange(benchmark::State &state) {
+  commit(state, deepLeafPropChange(state.range(0)), true);
+}
+BENCHMARK(commitAndPullDeepLeafPropChange)->Arg(10)->Arg(100);
+
+static void commitAndPullFullReplacement(benchmark::State &state) {
+  commit(state, fullReplacement(state.range(0)), true);
+}
+BENCHMARK(commitAndPullFullReplacement)->Arg(100)->Arg(1000);
+
+} // namespace react
+} // namespace facebook
+
+BENCHMARK_MAIN();
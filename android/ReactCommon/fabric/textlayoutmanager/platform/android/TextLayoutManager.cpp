@@ -7,6 +7,8 @@
 
 #include "TextLayoutManager.h"
 
+#include <unordered_map>
+
 #include <react/attributedstring/conversions.h>
 #include <react/core/conversions.h>
 #include <react/jni/ReadableNativeMap.h>
@@ -22,13 +24,20 @@ void *TextLayoutManager::getNativeTextLayoutManager() const {
   return self_;
 }
 
-Size TextLayoutManager::measure(
-    AttributedString attributedString,
-    ParagraphAttributes paragraphAttributes,
-    LayoutConstraints layoutConstraints) const {
-  const jni::global_ref<jobject> &fabricUIManager =
-      contextContainer_->at<jni::global_ref<jobject>>("FabricUIManager");
+static local_ref<ReadableMap::javaobject> toReadableMap(
+    folly::dynamic const &value) {
+  local_ref<ReadableNativeMap::javaobject> readableNativeMap =
+      ReadableNativeMap::newObjectCxxArgs(value);
+  return make_local(
+      reinterpret_cast<ReadableMap::javaobject>(readableNativeMap.get()));
+}
 
+static Size measureWithFabricUIManager(
+    jni::global_ref<jobject> const &fabricUIManager,
+    alias_ref<JString> componentName,
+    alias_ref<ReadableMap::javaobject> attributedString,
+    alias_ref<ReadableMap::javaobject> paragraphAttributes,
+    LayoutConstraints const &layoutConstraints) {
   static auto measure =
       jni::findClassStatic("com/facebook/react/fabric/FabricUIManager")
           ->getMethod<jlong(
@@ -44,21 +53,11 @@ Size TextLayoutManager::measure(
   auto minimumSize = layoutConstraints.minimumSize;
   auto maximumSize = layoutConstraints.maximumSize;
 
-  local_ref<JString> componentName = make_jstring("RCTText");
-  local_ref<ReadableNativeMap::javaobject> attributedStringRNM =
-      ReadableNativeMap::newObjectCxxArgs(toDynamic(attributedString));
-  local_ref<ReadableNativeMap::javaobject> paragraphAttributesRNM =
-      ReadableNativeMap::newObjectCxxArgs(toDynamic(paragraphAttributes));
-
-  local_ref<ReadableMap::javaobject> attributedStringRM = make_local(
-      reinterpret_cast<ReadableMap::javaobject>(attributedStringRNM.get()));
-  local_ref<ReadableMap::javaobject> paragraphAttributesRM = make_local(
-      reinterpret_cast<ReadableMap::javaobject>(paragraphAttributesRNM.get()));
   return yogaMeassureToSize(measure(
       fabricUIManager,
       componentName.get(),
-      attributedStringRM.get(),
-      paragraphAttributesRM.get(),
+      attributedString.get(),
+      paragraphAttributes.get(),
       nullptr,
       minimumSize.width,
       maximumSize.width,
@@ -66,5 +65,81 @@ Size TextLayoutManager::measure(
       maximumSize.height));
 }
 
+Size TextLayoutManager::measure(
+    AttributedString const &attributedString,
+    ParagraphAttributes const &paragraphAttributes,
+    LayoutConstraints const &layoutConstraints) const {
+  const jni::global_ref<jobject> &fabricUIManager = *fabricUIManager_;
+
+  return measureWithFabricUIManager(
+      fabricUIManager,
+      make_jstring("RCTText"),
+      toReadableMap(toDynamic(attributedString)),
+      toReadableMap(toDynamic(paragraphAttributes)),
+      layoutConstraints);
+}
+
+std::vector<Size> TextLayoutManager::measure(
+    std::vector<TextMeasureRequest> const &requests) const {
+  auto sizes = std::vector<Size>{};
+  sizes.reserve(requests.size());
+
+  if (requests.empty()) {
+    return sizes;
+  }
+
+  const jni::global_ref<jobject> &fabricUIManager = *fabricUIManager_;
+
+  local_ref<JString> componentName = make_jstring("RCTText");
+
+  // Paragraph attributes are usually the same for consecutive requests, so the
+  // Java map for them is reused until they change.
+  ParagraphAttributes const *lastParagraphAttributes = nullptr;
+  local_ref<ReadableMap::javaobject> paragraphAttributesRM;
+
+  // Maps a hash of an attributed string to the indices of the requests with
+  // that string which were measured already.
+  auto measuredIndices = std::unordered_multimap<size_t, size_t>{};
+
+  for (size_t index = 0; index < requests.size(); index++) {
+    auto const &request = requests[index];
+    auto const hash = request.attributedString.getHash();
+
+    auto equalIndex = index;
+    auto range = measuredIndices.equal_range(hash);
+    for (auto it = range.first; it != range.second; it++) {
+      auto const &other = requests[it->second];
+      if (other.layoutConstraints == request.layoutConstraints &&
+          other.paragraphAttributes == request.paragraphAttributes &&
+          other.attributedString == request.attributedString) {
+        equalIndex = it->second;
+        break;
+      }
+    }
+
+    if (equalIndex != index) {
+      sizes.push_back(sizes[equalIndex]);
+      continue;
+    }
+
+    if (!lastParagraphAttributes ||
+        !(*lastParagraphAttributes == request.paragraphAttributes)) {
+      paragraphAttributesRM =
+          toReadableMap(toDynamic(request.paragraphAttributes));
+      lastParagraphAttributes = &request.paragraphAttributes;
+    }
+
+    sizes.push_back(measureWithFabricUIManager(
+        fabricUIManager,
+        componentName,
+        toReadableMap(toDynamic(request.attributedString)),
+        paragraphAttributesRM,
+        request.layoutConstraints));
+    measuredIndices.emplace(hash, index);
+  }
+
+  return sizes;
+}
+
 } // namespace react
 } // namespace facebook
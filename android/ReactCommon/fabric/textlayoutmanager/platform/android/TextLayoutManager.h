@@ -8,6 +8,9 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+
+#include <fb/fbjni.h>
 
 #include <react/attributedstring/AttributedString.h>
 #include <react/attributedstring/ParagraphAttributes.h>
@@ -21,22 +24,44 @@ class TextLayoutManager;
 
 using SharedTextLayoutManager = std::shared_ptr<const TextLayoutManager>;
 
+/*
+ * Describes a single measurement of a batch passed to
+ * `TextLayoutManager::measure`.
+ */
+struct TextMeasureRequest {
+  AttributedString attributedString;
+  ParagraphAttributes paragraphAttributes;
+  LayoutConstraints layoutConstraints;
+};
+
 /*
  * Cross platform facade for Android-specific TextLayoutManager.
  */
 class TextLayoutManager {
  public:
   TextLayoutManager(const ContextContainer::Shared &contextContainer)
-      : contextContainer_(contextContainer){};
+      : contextContainer_(contextContainer),
+        fabricUIManager_(
+            contextContainer->resolve<jni::global_ref<jobject>>(
+                "FabricUIManager")){};
   ~TextLayoutManager();
 
   /*
    * Measures `attributedString` using native text rendering infrastructure.
    */
   Size measure(
-      AttributedString attributedString,
-      ParagraphAttributes paragraphAttributes,
-      LayoutConstraints layoutConstraints) const;
+      AttributedString const &attributedString,
+      ParagraphAttributes const &paragraphAttributes,
+      LayoutConstraints const &layoutConstraints) const;
+
+  /*
+   * Measures all `requests` at once and returns the sizes in the same order.
+   * Identical requests are measured only once, and the lookups and Java
+   * objects which don't depend on a particular string are shared by the whole
+   * batch.
+   */
+  std::vector<Size> measure(
+      std::vector<TextMeasureRequest> const &requests) const;
 
   /*
    * Returns an opaque pointer to platform-specific TextLayoutManager.
@@ -48,6 +73,8 @@ class TextLayoutManager {
   void *self_;
 
   ContextContainer::Shared contextContainer_;
+  // Measurements are hot, so the lookup is only done once.
+  ContextContainer::Key<jni::global_ref<jobject>> fabricUIManager_;
 };
 
 } // namespace react
@@ -33,6 +33,7 @@ void ComponentDescriptorRegistry::add(
   _registryByHandle[componentDescriptorProvider.handle] =
       sharedComponentDescriptor;
   _registryByName[componentDescriptorProvider.name] = sharedComponentDescriptor;
+  generation_.fetch_add(1, std::memory_order_release);
 
   if (strcmp(componentDescriptorProvider.name, "UnimplementedNativeView") ==
       0) {
@@ -54,6 +55,7 @@ void ComponentDescriptorRegistry::remove(
 
   _registryByHandle.erase(componentDescriptorProvider.handle);
   _registryByName.erase(componentDescriptorProvider.name);
+  generation_.fetch_add(1, std::memory_order_release);
 }
 
 void ComponentDescriptorRegistry::registerComponentDescriptor(
@@ -63,6 +65,7 @@ void ComponentDescriptorRegistry::registerComponentDescriptor(
 
   ComponentName componentName = componentDescriptor->getComponentName();
   _registryByName[componentName] = componentDescriptor;
+  generation_.fetch_add(1, std::memory_order_release);
 }
 
 static std::string componentNameByReactViewName(std::string viewName) {
@@ -177,5 +180,9 @@ ComponentDescriptorRegistry::getFallbackComponentDescriptor() const {
   return _fallbackComponentDescriptor;
 }
 
+uint64_t ComponentDescriptorRegistry::getGeneration() const {
+  return generation_.load(std::memory_order_acquire);
+}
+
 } // namespace react
 } // namespace facebook
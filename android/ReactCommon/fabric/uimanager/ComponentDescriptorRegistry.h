@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 
 #include <better/map.h>
@@ -58,6 +59,14 @@ class ComponentDescriptorRegistry {
   void setFallbackComponentDescriptor(SharedComponentDescriptor descriptor);
   ComponentDescriptor::Shared getFallbackComponentDescriptor() const;
 
+  /*
+   * Returns a number which changes every time a `ComponentDescriptor` is added
+   * or removed. Callers which cache descriptors returned by `at` must look
+   * them up again once it changes.
+   * Thread safe, lock-free.
+   */
+  uint64_t getGeneration() const;
+
  private:
   friend class ComponentDescriptorProviderRegistry;
 
@@ -76,6 +85,7 @@ class ComponentDescriptorRegistry {
   mutable better::map<std::string, SharedComponentDescriptor> _registryByName;
   ComponentDescriptor::Shared _fallbackComponentDescriptor;
   ComponentDescriptorParameters parameters_{};
+  mutable std::atomic<uint64_t> generation_{0};
 };
 
 } // namespace react
@@ -9,6 +9,7 @@
 #include <jsi/jsi.h>
 
 #include <react/core/LayoutContext.h>
+#include <react/core/LayoutableShadowNode.h>
 #include <react/debug/SystraceSection.h>
 #include <react/uimanager/ComponentDescriptorRegistry.h>
 #include <react/uimanager/UIManager.h>
@@ -22,6 +23,20 @@ Scheduler::Scheduler(
     SchedulerToolbox schedulerToolbox,
     SchedulerDelegate *delegate) {
   runtimeExecutor_ = schedulerToolbox.runtimeExecutor;
+  backgroundExecutor_ = schedulerToolbox.backgroundExecutor;
+  viewPreallocationPolicy_ = schedulerToolbox.viewPreallocationPolicy;
+  if (!viewPreallocationPolicy_) {
+    // Matches the nodes which the differentiator flattens away.
+    viewPreallocationPolicy_ = [](ShadowNode const &shadowNode) {
+      auto layoutableShadowNode =
+          dynamic_cast<LayoutableShadowNode const *>(&shadowNode);
+#ifndef ANDROID
+      return layoutableShadowNode && !layoutableShadowNode->isLayoutOnly();
+#else
+      return !layoutableShadowNode || !layoutableShadowNode->isLayoutOnly();
+#endif
+    };
+  }
 
   reactNativeConfig_ =
       schedulerToolbox.contextContainer
@@ -39,12 +54,10 @@ Scheduler::Scheduler(
     uiManagerBinding->dispatchEvent(runtime, eventTarget, type, payloadFactory);
   };
 
-  auto statePipe = [uiManager = &uiManagerRef](
-                       const StateData::Shared &data,
-                       const StateTarget &stateTarget) {
-    uiManager->updateState(
-        stateTarget.getShadowNode().shared_from_this(), data);
-  };
+  auto statePipe =
+      [uiManager = &uiManagerRef](
+          const std::vector<std::pair<StateTarget, StateData::Shared>>
+              &stateUpdates) { uiManager->updateState(stateUpdates); };
 
   auto eventDispatcher = std::make_shared<EventDispatcher>(
       eventPipe,
@@ -63,6 +76,9 @@ Scheduler::Scheduler(
   uiManagerRef.setDelegate(this);
   uiManagerRef.setShadowTreeRegistry(&shadowTreeRegistry_);
   uiManagerRef.setComponentDescriptorRegistry(componentDescriptorRegistry_);
+  uiManagerRef.setStateUpdateExecutor(schedulerToolbox.stateUpdateExecutor);
+  uiManagerRef.setBackgroundExecutor(schedulerToolbox.backgroundExecutor);
+  uiManagerRef.setRuntimeExecutor(schedulerToolbox.runtimeExecutor);
 
   runtimeExecutor_([=](jsi::Runtime &runtime) {
     UIManagerBinding::install(runtime, uiManagerBinding_);
@@ -72,6 +88,9 @@ Scheduler::Scheduler(
       "ComponentDescriptorRegistry_DO_NOT_USE_PRETTY_PLEASE",
       std::weak_ptr<ComponentDescriptorRegistry const>(
           componentDescriptorRegistry_));
+
+  // Everything is registered by now, so lookups can skip locking.
+  schedulerToolbox.contextContainer->freeze();
 }
 
 Scheduler::~Scheduler() {
@@ -107,10 +126,16 @@ void Scheduler::renderTemplateToSurface(
       return;
     }
     NativeModuleRegistry nMR;
+    auto compiledTemplate = uiTemplateCache_.get(
+        uiTemplate, [&](const std::string &content) {
+          return UITemplateProcessor::compileTemplate(
+              content,
+              folly::dynamic::object(),
+              *componentDescriptorRegistry_);
+        });
     auto tree = UITemplateProcessor::buildShadowTree(
-        uiTemplate,
+        *compiledTemplate,
         surfaceId,
-        folly::dynamic::object(),
         *componentDescriptorRegistry_,
         nMR,
         reactNativeConfig_);
@@ -139,6 +164,23 @@ void Scheduler::renderTemplateToSurface(
   }
 }
 
+#ifdef ANDROID
+std::string Scheduler::serializeSurface(SurfaceId surfaceId) const {
+  SystraceSection s("Scheduler::serializeSurface");
+
+  auto uiTemplate = std::string{};
+  shadowTreeRegistry_.visit(surfaceId, [&](const ShadowTree &shadowTree) {
+    auto rootShadowNode =
+        shadowTree.getMountingCoordinator()->getMountedRootShadowNode();
+    auto const &children = rootShadowNode->getChildren();
+    if (children.size() == 1) {
+      uiTemplate = UITemplateProcessor::serializeShadowTree(*children.at(0));
+    }
+  });
+  return uiTemplate;
+}
+#endif
+
 void Scheduler::stopSurface(SurfaceId surfaceId) const {
   SystraceSection s("Scheduler::stopSurface");
 
@@ -235,6 +277,33 @@ void Scheduler::uiManagerDidFinishTransaction(
     const SharedShadowNodeUnsharedList &rootChildNodes) {
   SystraceSection s("Scheduler::uiManagerDidFinishTransaction");
 
+  if (backgroundExecutor_) {
+    // JavaScript never mutates the children it finished, but its next render
+    // clones them while they are committed on the other thread. They are
+    // sealed here, before the handoff, and the commit lays out clones of them:
+    // Yoga then clones the descendants it lays out instead of writing to them.
+    for (auto const &rootChildNode : *rootChildNodes) {
+      rootChildNode->sealRecursive();
+    }
+    backgroundExecutor_([this, surfaceId, rootChildNodes]() {
+      auto clonedRootChildNodes = ShadowNode::makeSharedShadowNodeList({});
+      clonedRootChildNodes->reserve(rootChildNodes->size());
+      for (auto const &rootChildNode : *rootChildNodes) {
+        clonedRootChildNodes->push_back(rootChildNode->clone({}));
+      }
+      commitRootChildNodes(surfaceId, clonedRootChildNodes);
+    });
+    return;
+  }
+
+  commitRootChildNodes(surfaceId, rootChildNodes);
+}
+
+void Scheduler::commitRootChildNodes(
+    SurfaceId surfaceId,
+    const SharedShadowNodeUnsharedList &rootChildNodes) const {
+  SystraceSection s("Scheduler::commitRootChildNodes");
+
   shadowTreeRegistry_.visit(surfaceId, [&](const ShadowTree &shadowTree) {
     shadowTree.commit([&](const SharedRootShadowNode &oldRootShadowNode) {
       return std::make_shared<RootShadowNode>(
@@ -255,7 +324,7 @@ void Scheduler::uiManagerDidCreateShadowNode(
     const SharedShadowNode &shadowNode) {
   SystraceSection s("Scheduler::uiManagerDidCreateShadowNode");
 
-  if (delegate_) {
+  if (delegate_ && viewPreallocationPolicy_(*shadowNode)) {
     auto shadowView = ShadowView(*shadowNode);
     delegate_->schedulerDidRequestPreliminaryViewAllocation(
         shadowNode->getSurfaceId(), shadowView);
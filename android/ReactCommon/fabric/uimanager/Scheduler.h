@@ -21,8 +21,11 @@
 #include <react/uimanager/SchedulerToolbox.h>
 #include <react/uimanager/UIManagerBinding.h>
 #include <react/uimanager/UIManagerDelegate.h>
+#include <react/uimanager/UITemplateProcessor.h>
+#include <react/utils/BackgroundExecutor.h>
 #include <react/utils/ContextContainer.h>
 #include <react/utils/RuntimeExecutor.h>
+#include <react/utils/SimpleThreadSafeCache.h>
 
 namespace facebook {
 namespace react {
@@ -48,6 +51,19 @@ class Scheduler final : public UIManagerDelegate, public ShadowTreeDelegate {
       SurfaceId surfaceId,
       const std::string &uiTemplate);
 
+#ifdef ANDROID
+  /*
+   * Serializes the mounted tree of a surface into a UI template (see
+   * `UITemplateProcessor::serializeShadowTree`), e.g. after its first render,
+   * so that a next launch can pass it to `renderTemplateToSurface` to show an
+   * identical first frame right away. The frame is replaced as soon as JS
+   * renders the surface; its views have tags of their own and no events.
+   * Returns an empty string if the surface doesn't have exactly one root child.
+   * Can be called from any thread.
+   */
+  std::string serializeSurface(SurfaceId surfaceId) const;
+#endif
+
   void stopSurface(SurfaceId surfaceId) const;
 
   Size measureSurface(
@@ -103,13 +119,28 @@ class Scheduler final : public UIManagerDelegate, public ShadowTreeDelegate {
       MountingCoordinator::Shared const &mountingCoordinator) const override;
 
  private:
+  /*
+   * Commits a new root with the given children to the surface's shadow tree.
+   */
+  void commitRootChildNodes(
+      SurfaceId surfaceId,
+      const SharedShadowNodeUnsharedList &rootChildNodes) const;
+
   SchedulerDelegate *delegate_;
   SharedComponentDescriptorRegistry componentDescriptorRegistry_;
   std::unique_ptr<const RootComponentDescriptor> rootComponentDescriptor_;
   ShadowTreeRegistry shadowTreeRegistry_;
   RuntimeExecutor runtimeExecutor_;
+  BackgroundExecutor backgroundExecutor_;
+  ViewPreallocationPolicy viewPreallocationPolicy_;
   std::shared_ptr<UIManagerBinding> uiManagerBinding_;
   std::shared_ptr<const ReactNativeConfig> reactNativeConfig_;
+
+  /*
+   * UI templates compiled for `componentDescriptorRegistry_`, keyed by their
+   * JSON content.
+   */
+  SimpleThreadSafeCache<std::string, UITemplate::Shared, 8> uiTemplateCache_;
 };
 
 } // namespace react
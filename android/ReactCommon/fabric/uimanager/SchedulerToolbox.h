@@ -5,14 +5,25 @@
 
 #pragma once
 
+#include <functional>
+
 #include <react/core/EventBeat.h>
+#include <react/core/ShadowNode.h>
 #include <react/uimanager/ComponentDescriptorFactory.h>
+#include <react/utils/BackgroundExecutor.h>
 #include <react/utils/ContextContainer.h>
+#include <react/utils/ParallelExecutor.h>
 #include <react/utils/RuntimeExecutor.h>
 
 namespace facebook {
 namespace react {
 
+/*
+ * Decides whether the platform should allocate a view for a newly created
+ * shadow node ahead of mounting it.
+ */
+using ViewPreallocationPolicy = std::function<bool(ShadowNode const &)>;
+
 /*
  * Contains all external dependencies of Scheduler.
  * Copyable.
@@ -41,6 +52,30 @@ struct SchedulerToolbox final {
    */
   EventBeatFactory asynchronousEventBeatFactory;
   EventBeatFactory synchronousEventBeatFactory;
+
+  /*
+   * Optional. If set, shadow trees that JavaScript completes are committed
+   * (laid out, diffed and handed over for mounting) on this executor, so
+   * JavaScript continues right away and overlaps with layout.
+   * The executor must not call anything after the `Scheduler` is destroyed.
+   */
+  BackgroundExecutor backgroundExecutor;
+
+  /*
+   * Optional. If not set, views are preallocated for all shadow nodes except
+   * layout-only ones, which are flattened away and never mounted.
+   * Platforms can skip more, e.g. nodes in offscreen list windows.
+   */
+  ViewPreallocationPolicy viewPreallocationPolicy;
+
+  /*
+   * Optional. If set, state updates which native components dispatch for
+   * several surfaces at once (e.g. a modal and the screen under it) are
+   * committed with this executor, one surface per task, so they can be laid
+   * out and diffed in parallel. Measure functions and the `SchedulerDelegate`
+   * are then called from the executor's threads.
+   */
+  ParallelExecutor stateUpdateExecutor;
 };
 
 } // namespace react
@@ -2,6 +2,11 @@
 
 #include "UIManager.h"
 
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <unordered_map>
+
 #include <react/core/ShadowNodeFragment.h>
 #include <react/debug/SystraceSection.h>
 
@@ -14,9 +19,24 @@ SharedShadowNode UIManager::createNode(
     SurfaceId surfaceId,
     const RawProps &rawProps,
     SharedEventTarget eventTarget) const {
+  return createNode(
+      tag,
+      componentDescriptorRegistry_->at(name),
+      name,
+      surfaceId,
+      rawProps,
+      std::move(eventTarget));
+}
+
+SharedShadowNode UIManager::createNode(
+    Tag tag,
+    ComponentDescriptor const &componentDescriptor,
+    std::string const &name,
+    SurfaceId surfaceId,
+    const RawProps &rawProps,
+    SharedEventTarget eventTarget) const {
   SystraceSection s("UIManager::createNode");
 
-  auto &componentDescriptor = componentDescriptorRegistry_->at(name);
   auto fallbackDescriptor =
       componentDescriptorRegistry_->getFallbackComponentDescriptor();
 
@@ -157,29 +177,237 @@ LayoutMetrics UIManager::getRelativeLayoutMetrics(
       *layoutableAncestorShadowNode);
 }
 
-void UIManager::updateState(
-    const SharedShadowNode &shadowNode,
-    const StateData::Shared &rawStateData) const {
-  auto &componentDescriptor = shadowNode->getComponentDescriptor();
-  auto state =
-      componentDescriptor.createState(shadowNode->getState(), rawStateData);
-  auto newShadowNode = shadowNode->clone({
-      /* .tag = */ ShadowNodeFragment::tagPlaceholder(),
-      /* .surfaceId = */ ShadowNodeFragment::surfaceIdPlaceholder(),
-      /* .props = */ ShadowNodeFragment::propsPlaceholder(),
-      /* .eventEmitter = */ ShadowNodeFragment::eventEmitterPlaceholder(),
-      /* .children = */ ShadowNodeFragment::childrenPlaceholder(),
-      /* .localData = */ ShadowNodeFragment::localDataPlaceholder(),
-      /* .state = */ state,
-  });
+MeasureRequest::Shared UIManager::measureAsync(
+    std::vector<MeasureRequest::Item> items,
+    MeasureRequest::Callback callback) const {
+  assert(runtimeExecutor_ && "`measureAsync` requires a runtime executor.");
+
+  auto request = std::make_shared<MeasureRequest const>();
+  auto runtimeExecutor = runtimeExecutor_;
+  auto measure = [this,
+                  request,
+                  runtimeExecutor,
+                  items = std::move(items),
+                  callback = std::move(callback)]() {
+    if (request->isCancelled()) {
+      return;
+    }
+
+    auto layoutMetrics = measureInMountedTrees(items);
+
+    runtimeExecutor([request,
+                     callback = std::move(callback),
+                     layoutMetrics =
+                         std::move(layoutMetrics)](jsi::Runtime &runtime) {
+      if (!request->isCancelled()) {
+        callback(runtime, layoutMetrics);
+      }
+    });
+  };
+
+  if (backgroundExecutor_) {
+    backgroundExecutor_(std::move(measure));
+  } else {
+    runtimeExecutor_([measure = std::move(measure)](jsi::Runtime &) mutable {
+      measure();
+    });
+  }
 
-  shadowTreeRegistry_->visit(
-      shadowNode->getSurfaceId(), [&](const ShadowTree &shadowTree) {
-        shadowTree.tryCommit(
-            [&](const SharedRootShadowNode &oldRootShadowNode) {
-              return oldRootShadowNode->clone(shadowNode, newShadowNode);
-            });
+  return request;
+}
+
+std::vector<LayoutMetrics> UIManager::measureInMountedTrees(
+    std::vector<MeasureRequest::Item> const &items) const {
+  SystraceSection s("UIManager::measureInMountedTrees");
+
+  auto rootShadowNodes = std::unordered_map<SurfaceId, ShadowNode::Shared>{};
+  // The sum of the (transformed) origins of the node and of its ancestors,
+  // for every mounted node on the paths to measured nodes.
+  auto offsets = std::unordered_map<ShadowNode const *, Point>{};
+
+  auto getRootShadowNode = [&](SurfaceId surfaceId) -> ShadowNode const * {
+    auto iterator = rootShadowNodes.find(surfaceId);
+    if (iterator == rootShadowNodes.end()) {
+      auto rootShadowNode = ShadowNode::Shared{};
+      shadowTreeRegistry_->visit(surfaceId, [&](const ShadowTree &shadowTree) {
+        rootShadowNode =
+            shadowTree.getMountingCoordinator()->getMountedRootShadowNode();
       });
+      iterator = rootShadowNodes.emplace(surfaceId, rootShadowNode).first;
+    }
+    return iterator->second.get();
+  };
+
+  // Returns the offset of the last of the `ancestors`, reusing the offsets of
+  // the ancestors which were already computed.
+  auto getOffset = [&](ShadowNode::AncestorList const &ancestors,
+                       Point &offset) -> bool {
+    auto index = static_cast<int>(ancestors.size());
+    offset = Point{};
+    while (index > 0) {
+      auto iterator = offsets.find(&ancestors[index - 1].first.get());
+      if (iterator != offsets.end()) {
+        offset = iterator->second;
+        break;
+      }
+      index--;
+    }
+
+    for (; index < static_cast<int>(ancestors.size()); index++) {
+      auto const &shadowNode = ancestors[index].first.get();
+      auto layoutableShadowNode =
+          dynamic_cast<LayoutableShadowNode const *>(&shadowNode);
+      if (!layoutableShadowNode) {
+        return false;
+      }
+
+      offset += layoutableShadowNode->getLayoutMetrics().frame.origin *
+          layoutableShadowNode->getTransform();
+      offsets[&shadowNode] = offset;
+    }
+    return true;
+  };
+
+  auto result = std::vector<LayoutMetrics>{};
+  result.reserve(items.size());
+
+  for (auto const &item : items) {
+    auto const &shadowNode = *item.first;
+    auto const rootShadowNode = getRootShadowNode(shadowNode.getSurfaceId());
+    if (!rootShadowNode) {
+      result.push_back(EmptyLayoutMetrics);
+      continue;
+    }
+
+    auto ancestors = shadowNode.getAncestors(*rootShadowNode);
+    if (ancestors.empty()) {
+      result.push_back(EmptyLayoutMetrics);
+      continue;
+    }
+
+    // The version of the node which is mounted.
+    auto const &parentShadowNode = ancestors.back().first.get();
+    auto const &mountedShadowNode =
+        *parentShadowNode.getChildren().at(ancestors.back().second);
+    auto layoutableShadowNode =
+        dynamic_cast<LayoutableShadowNode const *>(&mountedShadowNode);
+
+    auto offset = Point{};
+    if (!layoutableShadowNode || !getOffset(ancestors, offset)) {
+      result.push_back(EmptyLayoutMetrics);
+      continue;
+    }
+
+    // Measuring relatively to an ancestor excludes the offsets of the
+    // ancestor's own ancestors.
+    if (item.second &&
+        !ShadowNode::sameFamily(*item.second, *rootShadowNode)) {
+      auto const &ancestorShadowNode = *item.second;
+      auto isAncestor = std::any_of(
+          ancestors.begin(), ancestors.end(), [&](auto const &ancestor) {
+            return ShadowNode::sameFamily(
+                ancestor.first.get(), ancestorShadowNode);
+          });
+      auto ancestorOffset = Point{};
+      if (!isAncestor ||
+          !getOffset(
+              ancestorShadowNode.getAncestors(*rootShadowNode),
+              ancestorOffset)) {
+        result.push_back(EmptyLayoutMetrics);
+        continue;
+      }
+      offset -= ancestorOffset;
+    }
+
+    auto layoutMetrics = layoutableShadowNode->getLayoutMetrics();
+    layoutMetrics.frame.origin += offset;
+    result.push_back(layoutMetrics);
+  }
+
+  return result;
+}
+
+void UIManager::updateState(
+    const std::vector<std::pair<StateTarget, StateData::Shared>> &stateUpdates)
+    const {
+  SystraceSection s("UIManager::updateState");
+
+  auto surfaceIds = std::vector<SurfaceId>{};
+  auto replacementsBySurface = std::unordered_map<
+      SurfaceId,
+      std::vector<std::pair<SharedShadowNode, SharedShadowNode>>>{};
+
+  for (const auto &stateUpdate : stateUpdates) {
+    auto shadowNode = stateUpdate.first.getShadowNode().shared_from_this();
+    auto &componentDescriptor = shadowNode->getComponentDescriptor();
+    auto state = componentDescriptor.createState(
+        shadowNode->getState(), stateUpdate.second);
+    auto newShadowNode = shadowNode->clone({
+        /* .tag = */ ShadowNodeFragment::tagPlaceholder(),
+        /* .surfaceId = */ ShadowNodeFragment::surfaceIdPlaceholder(),
+        /* .props = */ ShadowNodeFragment::propsPlaceholder(),
+        /* .eventEmitter = */ ShadowNodeFragment::eventEmitterPlaceholder(),
+        /* .children = */ ShadowNodeFragment::childrenPlaceholder(),
+        /* .localData = */ ShadowNodeFragment::localDataPlaceholder(),
+        /* .state = */ state,
+    });
+
+    auto &replacements = replacementsBySurface[shadowNode->getSurfaceId()];
+    if (replacements.empty()) {
+      surfaceIds.push_back(shadowNode->getSurfaceId());
+    }
+    replacements.emplace_back(std::move(shadowNode), std::move(newShadowNode));
+  }
+
+  // Shadow trees are independent of each other and the registry only takes a
+  // shared lock to visit one, so several surfaces can commit at once.
+  auto const commitSurface = [&](size_t index) {
+    auto const surfaceId = surfaceIds[index];
+    auto const &replacements = replacementsBySurface.at(surfaceId);
+    shadowTreeRegistry_->visit(surfaceId, [&](const ShadowTree &shadowTree) {
+      shadowTree.tryCommit(
+          [&](const SharedRootShadowNode &oldRootShadowNode) {
+            auto newRootShadowNode = UnsharedRootShadowNode{};
+            for (const auto &replacement : replacements) {
+              auto const &rootShadowNode = newRootShadowNode
+                  ? SharedRootShadowNode{newRootShadowNode}
+                  : oldRootShadowNode;
+              auto clonedRootShadowNode = rootShadowNode->clone(
+                  replacement.first, replacement.second);
+              // The node might be already removed from the tree.
+              if (clonedRootShadowNode) {
+                newRootShadowNode = std::move(clonedRootShadowNode);
+              }
+            }
+            return newRootShadowNode;
+          });
+    });
+  };
+
+  if (stateUpdateExecutor_ && surfaceIds.size() > 1) {
+    // An exception must not escape a task of the executor: the first one is
+    // kept and rethrown once every surface has committed.
+    auto exception = std::exception_ptr{};
+    std::mutex exceptionMutex;
+    stateUpdateExecutor_(surfaceIds.size(), [&](size_t index) {
+      try {
+        commitSurface(index);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(exceptionMutex);
+        if (!exception) {
+          exception = std::current_exception();
+        }
+      }
+    });
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+    return;
+  }
+
+  for (size_t index = 0; index < surfaceIds.size(); index++) {
+    commitSurface(index);
+  }
 }
 
 void UIManager::dispatchCommand(
@@ -200,6 +428,26 @@ void UIManager::setComponentDescriptorRegistry(
   componentDescriptorRegistry_ = componentDescriptorRegistry;
 }
 
+void UIManager::setStateUpdateExecutor(ParallelExecutor stateUpdateExecutor) {
+  stateUpdateExecutor_ = std::move(stateUpdateExecutor);
+}
+
+void UIManager::setBackgroundExecutor(BackgroundExecutor backgroundExecutor) {
+  backgroundExecutor_ = std::move(backgroundExecutor);
+}
+
+void UIManager::setRuntimeExecutor(RuntimeExecutor runtimeExecutor) {
+  runtimeExecutor_ = std::move(runtimeExecutor);
+}
+
+void MeasureRequest::cancel() const {
+  cancelled_ = true;
+}
+
+bool MeasureRequest::isCancelled() const {
+  return cancelled_;
+}
+
 void UIManager::setDelegate(UIManagerDelegate *delegate) {
   delegate_ = delegate;
 }
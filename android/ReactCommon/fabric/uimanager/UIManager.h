@@ -2,19 +2,60 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <vector>
+
 #include <folly/Optional.h>
 #include <folly/dynamic.h>
 #include <jsi/jsi.h>
 
 #include <react/core/ShadowNode.h>
 #include <react/core/StateData.h>
+#include <react/core/StateTarget.h>
 #include <react/mounting/ShadowTreeRegistry.h>
 #include <react/uimanager/ComponentDescriptorRegistry.h>
 #include <react/uimanager/UIManagerDelegate.h>
+#include <react/utils/BackgroundExecutor.h>
+#include <react/utils/ParallelExecutor.h>
+#include <react/utils/RuntimeExecutor.h>
 
 namespace facebook {
 namespace react {
 
+/*
+ * A batch of measurements requested with `UIManager::measureAsync`.
+ */
+class MeasureRequest final {
+ public:
+  using Shared = std::shared_ptr<MeasureRequest const>;
+
+  /*
+   * A node to measure and the node to measure it relatively to (the root of
+   * its surface if it's `nullptr`).
+   */
+  using Item = std::pair<SharedShadowNode, SharedShadowNode>;
+
+  /*
+   * Called on the JavaScript thread with the layout metrics of the items, in
+   * the same order. Items which aren't mounted get `EmptyLayoutMetrics`.
+   */
+  using Callback = std::function<void(
+      jsi::Runtime &runtime,
+      std::vector<LayoutMetrics> const &layoutMetrics)>;
+
+  /*
+   * Prevents the callback from being called (and the measurements from being
+   * done, if they weren't yet).
+   * Can be called on any thread.
+   */
+  void cancel() const;
+  bool isCancelled() const;
+
+ private:
+  mutable std::atomic<bool> cancelled_{false};
+};
+
 class UIManager {
  public:
   void setShadowTreeRegistry(ShadowTreeRegistry *shadowTreeRegistry);
@@ -22,6 +63,20 @@ class UIManager {
   void setComponentDescriptorRegistry(
       const SharedComponentDescriptorRegistry &componentDescriptorRegistry);
 
+  /*
+   * Sets the executor which commits state updates of several surfaces in
+   * parallel. If it's not set, they are committed one after the other.
+   */
+  void setStateUpdateExecutor(ParallelExecutor stateUpdateExecutor);
+
+  /*
+   * Sets the executors used by `measureAsync`: measurements are done on the
+   * background executor (on the JavaScript thread if it's not set) and their
+   * results are delivered with the runtime executor.
+   */
+  void setBackgroundExecutor(BackgroundExecutor backgroundExecutor);
+  void setRuntimeExecutor(RuntimeExecutor runtimeExecutor);
+
   /*
    * Sets and gets the UIManager's delegate.
    * The delegate is stored as a raw pointer, so the owner must null
@@ -41,6 +96,18 @@ class UIManager {
       const RawProps &props,
       SharedEventTarget eventTarget) const;
 
+  /*
+   * Same as above, but with the `ComponentDescriptor` already looked up
+   * (e.g. via an interned component handle, see `UIManagerBinding`).
+   */
+  SharedShadowNode createNode(
+      Tag tag,
+      ComponentDescriptor const &componentDescriptor,
+      std::string const &componentName,
+      SurfaceId surfaceId,
+      const RawProps &props,
+      SharedEventTarget eventTarget) const;
+
   SharedShadowNode cloneNode(
       const SharedShadowNode &shadowNode,
       const SharedShadowNodeSharedList &children = nullptr,
@@ -74,12 +141,29 @@ class UIManager {
       const ShadowNode *ancestorShadowNode) const;
 
   /*
-   * Creates a new shadow node with given state data, clones what's necessary
-   * and performs a commit.
+   * Asynchronously measures a batch of nodes like `getRelativeLayoutMetrics`
+   * does, but in the trees which are mounted (see
+   * `MountingCoordinator::getMountedRootShadowNode`) instead of the latest
+   * committed ones, so it never waits for a commit. The results match what
+   * is on the screen. All items are measured in one pass from a single
+   * snapshot per surface, sharing the work for their common ancestors.
+   * Returns the request, which can be cancelled.
+   */
+  MeasureRequest::Shared measureAsync(
+      std::vector<MeasureRequest::Item> items,
+      MeasureRequest::Callback callback) const;
+
+  std::vector<LayoutMetrics> measureInMountedTrees(
+      std::vector<MeasureRequest::Item> const &items) const;
+
+  /*
+   * Creates new shadow nodes with given state data, clones what's necessary
+   * and performs a single commit per affected surface. The commits of
+   * different surfaces run on the state update executor, if there is one.
    */
   void updateState(
-      const SharedShadowNode &shadowNode,
-      const StateData::Shared &rawStateData) const;
+      const std::vector<std::pair<StateTarget, StateData::Shared>>
+          &stateUpdates) const;
 
   void dispatchCommand(
       const SharedShadowNode &shadowNode,
@@ -89,6 +173,9 @@ class UIManager {
   ShadowTreeRegistry *shadowTreeRegistry_;
   SharedComponentDescriptorRegistry componentDescriptorRegistry_;
   UIManagerDelegate *delegate_;
+  ParallelExecutor stateUpdateExecutor_;
+  BackgroundExecutor backgroundExecutor_;
+  RuntimeExecutor runtimeExecutor_;
 };
 
 } // namespace react
@@ -115,6 +115,237 @@ void UIManagerBinding::dispatchEvent(
        std::move(payload)});
 }
 
+int UIManagerBinding::internComponentName(
+    std::string const &componentName) const {
+  auto it = internedHandles_.find(componentName);
+  if (it != internedHandles_.end()) {
+    return it->second;
+  }
+
+  auto internedHandle = static_cast<int>(internedComponents_.size());
+  internedComponents_.push_back({componentName, nullptr});
+  internedHandles_[componentName] = internedHandle;
+  return internedHandle;
+}
+
+ComponentDescriptor const &
+UIManagerBinding::componentDescriptorForInternedHandle(
+    int internedHandle) const {
+  if (internedHandle < 0 ||
+      internedHandle >= static_cast<int>(internedComponents_.size())) {
+    throw std::invalid_argument(
+        "Unknown interned component handle " +
+        folly::to<std::string>(internedHandle));
+  }
+
+  auto const &componentDescriptorRegistry =
+      *uiManager_->componentDescriptorRegistry_;
+
+  // Descriptors looked up before the registry changed may be gone (or may
+  // have been the fallback for a component which is now registered).
+  auto generation = componentDescriptorRegistry.getGeneration();
+  if (generation != internedGeneration_) {
+    for (auto &internedComponent : internedComponents_) {
+      internedComponent.componentDescriptor = nullptr;
+    }
+    internedGeneration_ = generation;
+  }
+
+  auto &internedComponent = internedComponents_[internedHandle];
+  if (!internedComponent.componentDescriptor) {
+    internedComponent.componentDescriptor =
+        &componentDescriptorRegistry.at(internedComponent.name);
+  }
+  return *internedComponent.componentDescriptor;
+}
+
+SharedShadowNode UIManagerBinding::createNode(
+    jsi::Runtime &runtime,
+    const jsi::Value *arguments) const {
+  auto &uiManager = *uiManager_;
+
+  if (arguments[1].isNumber()) {
+    auto internedHandle = static_cast<int>(arguments[1].getNumber());
+    auto const &componentDescriptor =
+        componentDescriptorForInternedHandle(internedHandle);
+    return uiManager.createNode(
+        tagFromValue(runtime, arguments[0]),
+        componentDescriptor,
+        internedComponents_[internedHandle].name,
+        surfaceIdFromValue(runtime, arguments[2]),
+        RawProps(runtime, arguments[3]),
+        eventTargetFromValue(runtime, arguments[4], arguments[0]));
+  }
+
+  return uiManager.createNode(
+      tagFromValue(runtime, arguments[0]),
+      stringFromValue(runtime, arguments[1]),
+      surfaceIdFromValue(runtime, arguments[2]),
+      RawProps(runtime, arguments[3]),
+      eventTargetFromValue(runtime, arguments[4], arguments[0]));
+}
+
+jsi::Value UIManagerBinding::applyCommands(
+    jsi::Runtime &runtime,
+    const jsi::Array &commands) const {
+  SystraceSection s("UIManagerBinding::applyCommands");
+
+  auto &uiManager = *uiManager_;
+  auto const size = commands.size(runtime);
+  auto index = size_t{0};
+
+  auto next = [&]() -> jsi::Value {
+    if (index >= size) {
+      throw std::invalid_argument("Truncated UIManager command batch");
+    }
+    return commands.getValueAtIndex(runtime, index++);
+  };
+
+  auto shadowNodes = SharedShadowNodeList{};
+  auto shadowNodeLists = std::vector<SharedShadowNodeUnsharedList>{};
+
+  auto nextShadowNode = [&]() -> SharedShadowNode {
+    auto value = next();
+    if (value.isNumber()) {
+      return shadowNodes.at(static_cast<size_t>(value.getNumber()));
+    }
+    return shadowNodeFromValue(runtime, value);
+  };
+
+  auto nextShadowNodeList = [&]() -> SharedShadowNodeUnsharedList {
+    auto value = next();
+    if (value.isNumber()) {
+      return shadowNodeLists.at(static_cast<size_t>(value.getNumber()));
+    }
+    return shadowNodeListFromValue(runtime, value);
+  };
+
+  while (index < size) {
+    auto opcode = static_cast<UIManagerCommand>(next().getNumber());
+    switch (opcode) {
+      case UIManagerCommand::CreateNode: {
+        jsi::Value arguments[5];
+        for (auto &argument : arguments) {
+          argument = next();
+        }
+        shadowNodes.push_back(createNode(runtime, arguments));
+        break;
+      }
+      case UIManagerCommand::CloneNode: {
+        shadowNodes.push_back(uiManager.cloneNode(nextShadowNode()));
+        break;
+      }
+      case UIManagerCommand::CloneNodeWithNewChildren: {
+        shadowNodes.push_back(uiManager.cloneNode(
+            nextShadowNode(), ShadowNode::emptySharedShadowNodeSharedList()));
+        break;
+      }
+      case UIManagerCommand::CloneNodeWithNewProps: {
+        auto shadowNode = nextShadowNode();
+        auto const &rawProps = RawProps(runtime, next());
+        shadowNodes.push_back(
+            uiManager.cloneNode(shadowNode, nullptr, &rawProps));
+        break;
+      }
+      case UIManagerCommand::CloneNodeWithNewChildrenAndProps: {
+        auto shadowNode = nextShadowNode();
+        auto const &rawProps = RawProps(runtime, next());
+        shadowNodes.push_back(uiManager.cloneNode(
+            shadowNode,
+            ShadowNode::emptySharedShadowNodeSharedList(),
+            &rawProps));
+        break;
+      }
+      case UIManagerCommand::AppendChild: {
+        auto parentShadowNode = nextShadowNode();
+        auto childShadowNode = nextShadowNode();
+        uiManager.appendChild(parentShadowNode, childShadowNode);
+        break;
+      }
+      case UIManagerCommand::CreateChildSet: {
+        next();
+        shadowNodeLists.push_back(ShadowNode::makeSharedShadowNodeList());
+        break;
+      }
+      case UIManagerCommand::AppendChildToSet: {
+        auto shadowNodeList = nextShadowNodeList();
+        shadowNodeList->push_back(nextShadowNode());
+        break;
+      }
+      case UIManagerCommand::CompleteRoot: {
+        auto surfaceId = surfaceIdFromValue(runtime, next());
+        uiManager.completeSurface(surfaceId, nextShadowNodeList());
+        break;
+      }
+      default:
+        throw std::invalid_argument(
+            "Unknown UIManager command " +
+            folly::to<std::string>(static_cast<int>(opcode)));
+    }
+  }
+
+  auto result = jsi::Array(runtime, shadowNodes.size());
+  for (size_t i = 0; i < shadowNodes.size(); i++) {
+    result.setValueAtIndex(
+        runtime, i, valueFromShadowNode(runtime, shadowNodes[i]));
+  }
+  return std::move(result);
+}
+
+int UIManagerBinding::measureAsync(
+    jsi::Runtime &runtime,
+    std::vector<MeasureRequest::Item> items,
+    jsi::Function callback) const {
+  auto requestId = nextMeasureRequestId_++;
+
+  // The binding outlives the JavaScript runtime, which is the only thing
+  // that can run the callback.
+  auto request = uiManager_->measureAsync(
+      std::move(items),
+      [this, requestId](
+          jsi::Runtime &runtime,
+          std::vector<LayoutMetrics> const &layoutMetrics) {
+        auto iterator = pendingMeasureRequests_.find(requestId);
+        if (iterator == pendingMeasureRequests_.end()) {
+          return;
+        }
+        auto callback = std::move(iterator->second.callback);
+        pendingMeasureRequests_.erase(iterator);
+
+        auto frames = jsi::Array(runtime, layoutMetrics.size());
+        for (size_t i = 0; i < layoutMetrics.size(); i++) {
+          if (layoutMetrics[i] == EmptyLayoutMetrics) {
+            frames.setValueAtIndex(runtime, i, jsi::Value::null());
+            continue;
+          }
+          auto frame = layoutMetrics[i].frame;
+          frames.setValueAtIndex(
+              runtime,
+              i,
+              jsi::Array::createWithElements(
+                  runtime,
+                  {jsi::Value{runtime, (double)frame.origin.x},
+                   jsi::Value{runtime, (double)frame.origin.y},
+                   jsi::Value{runtime, (double)frame.size.width},
+                   jsi::Value{runtime, (double)frame.size.height}}));
+        }
+        callback.call(runtime, std::move(frames));
+      });
+
+  pendingMeasureRequests_.emplace(
+      requestId, PendingMeasureRequest{request, std::move(callback)});
+  return requestId;
+}
+
+void UIManagerBinding::cancelMeasureAsync(int requestId) const {
+  auto iterator = pendingMeasureRequests_.find(requestId);
+  if (iterator == pendingMeasureRequests_.end()) {
+    return;
+  }
+  iterator->second.request->cancel();
+  pendingMeasureRequests_.erase(iterator);
+}
+
 void UIManagerBinding::invalidate() const {
   uiManager_->setShadowTreeRegistry(nullptr);
   uiManager_->setDelegate(nullptr);
@@ -126,25 +357,53 @@ jsi::Value UIManagerBinding::get(
   auto methodName = name.utf8(runtime);
   auto &uiManager = *uiManager_;
 
+  // Semantic: Returns the interned component handle for the given component
+  // name, which can be passed to `createNode` instead of the name.
+  if (methodName == "internComponentName") {
+    return jsi::Function::createFromHostFunction(
+        runtime,
+        name,
+        1,
+        [this](
+            jsi::Runtime &runtime,
+            const jsi::Value &thisValue,
+            const jsi::Value *arguments,
+            size_t count) -> jsi::Value {
+          return jsi::Value(
+              internComponentName(stringFromValue(runtime, arguments[0])));
+        });
+  }
+
   // Semantic: Creates a new node with given pieces.
+  // The component is given by its name or by its interned handle.
   if (methodName == "createNode") {
     return jsi::Function::createFromHostFunction(
         runtime,
         name,
         5,
-        [&uiManager](
+        [this](
             jsi::Runtime &runtime,
             const jsi::Value &thisValue,
             const jsi::Value *arguments,
             size_t count) -> jsi::Value {
-          return valueFromShadowNode(
-              runtime,
-              uiManager.createNode(
-                  tagFromValue(runtime, arguments[0]),
-                  stringFromValue(runtime, arguments[1]),
-                  surfaceIdFromValue(runtime, arguments[2]),
-                  RawProps(runtime, arguments[3]),
-                  eventTargetFromValue(runtime, arguments[4], arguments[0])));
+          return valueFromShadowNode(runtime, createNode(runtime, arguments));
+        });
+  }
+
+  // Semantic: Runs a batch of `UIManagerCommand`s and returns the array of
+  // nodes it created.
+  if (methodName == "applyCommands") {
+    return jsi::Function::createFromHostFunction(
+        runtime,
+        name,
+        1,
+        [this](
+            jsi::Runtime &runtime,
+            const jsi::Value &thisValue,
+            const jsi::Value *arguments,
+            size_t count) -> jsi::Value {
+          return applyCommands(
+              runtime, arguments[0].getObject(runtime).getArray(runtime));
         });
   }
 
@@ -286,8 +545,7 @@ jsi::Value UIManagerBinding::get(
            const jsi::Value &thisValue,
            const jsi::Value *arguments,
            size_t count) -> jsi::Value {
-          auto shadowNodeList =
-              std::make_shared<SharedShadowNodeList>(SharedShadowNodeList({}));
+          auto shadowNodeList = ShadowNode::makeSharedShadowNodeList();
           return valueFromShadowNodeList(runtime, shadowNodeList);
         });
   }
@@ -476,6 +734,61 @@ jsi::Value UIManagerBinding::get(
         });
   }
 
+  // Semantic: Measures an array of nodes (relatively to the nodes of the same
+  // index in the optional array of ancestors) in the mounted trees, and calls
+  // the callback with the array of their frames later.
+  // Returns the id of the request for `cancelMeasureAsync`.
+  if (methodName == "measureAsync") {
+    return jsi::Function::createFromHostFunction(
+        runtime,
+        name,
+        3,
+        [this](
+            jsi::Runtime &runtime,
+            const jsi::Value &thisValue,
+            const jsi::Value *arguments,
+            size_t count) -> jsi::Value {
+          auto nodes = arguments[0].getObject(runtime).getArray(runtime);
+          auto ancestors = arguments[1].isObject()
+              ? better::optional<jsi::Array>(
+                    arguments[1].getObject(runtime).getArray(runtime))
+              : better::optional<jsi::Array>{};
+
+          auto items = std::vector<MeasureRequest::Item>{};
+          auto size = nodes.size(runtime);
+          items.reserve(size);
+          for (size_t i = 0; i < size; i++) {
+            auto ancestor = ancestors
+                ? ancestors->getValueAtIndex(runtime, i)
+                : jsi::Value::null();
+            items.emplace_back(
+                shadowNodeFromValue(runtime, nodes.getValueAtIndex(runtime, i)),
+                ancestor.isObject() ? shadowNodeFromValue(runtime, ancestor)
+                                    : nullptr);
+          }
+
+          return measureAsync(
+              runtime,
+              std::move(items),
+              arguments[2].getObject(runtime).getFunction(runtime));
+        });
+  }
+
+  if (methodName == "cancelMeasureAsync") {
+    return jsi::Function::createFromHostFunction(
+        runtime,
+        name,
+        1,
+        [this](
+            jsi::Runtime &runtime,
+            const jsi::Value &thisValue,
+            const jsi::Value *arguments,
+            size_t count) -> jsi::Value {
+          cancelMeasureAsync(static_cast<int>(arguments[0].getNumber()));
+          return jsi::Value::undefined();
+        });
+  }
+
   if (methodName == "setNativeProps") {
     return jsi::Function::createFromHostFunction(
         runtime,
@@ -2,6 +2,10 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
+#include <better/map.h>
 #include <folly/dynamic.h>
 #include <jsi/jsi.h>
 #include <react/uimanager/UIManager.h>
@@ -10,6 +14,25 @@
 namespace facebook {
 namespace react {
 
+/*
+ * Opcodes of the commands passed to `nativeFabricUIManager.applyCommands`.
+ * Each command mirrors the binding's method of the same name and is followed
+ * by that method's arguments. Arguments which are nodes (or child sets) are
+ * either node objects or numbers, which refer to the nodes (or child sets)
+ * created by earlier commands of the same batch, in order.
+ */
+enum class UIManagerCommand {
+  CreateNode = 0, // tag, component, surfaceId, props, instanceHandle
+  CloneNode = 1, // node
+  CloneNodeWithNewChildren = 2, // node
+  CloneNodeWithNewProps = 3, // node, props
+  CloneNodeWithNewChildrenAndProps = 4, // node, props
+  AppendChild = 5, // parentNode, childNode
+  CreateChildSet = 6, // surfaceId
+  AppendChildToSet = 7, // childSet, node
+  CompleteRoot = 8, // surfaceId, childSet
+};
+
 /*
  * Exposes UIManager to JavaScript realm.
  */
@@ -66,8 +89,64 @@ class UIManagerBinding : public jsi::HostObject {
   jsi::Value get(jsi::Runtime &runtime, const jsi::PropNameID &name) override;
 
  private:
+  /*
+   * Interned component handles are small numbers which JavaScript gets once
+   * per component name (via `internComponentName`) and then passes to
+   * `createNode` instead of the name. They index `internedComponents_`, which
+   * caches the `ComponentDescriptor`s, so creating a node takes neither the
+   * registry's lock nor a string lookup.
+   * Must be called on the JavaScript thread.
+   */
+  int internComponentName(std::string const &componentName) const;
+  ComponentDescriptor const &componentDescriptorForInternedHandle(
+      int internedHandle) const;
+
+  /*
+   * Creates a node from the 5 arguments of `createNode`.
+   */
+  SharedShadowNode createNode(
+      jsi::Runtime &runtime,
+      const jsi::Value *arguments) const;
+
+  /*
+   * Runs a batch of `UIManagerCommand`s (see above) built by JavaScript in a
+   * single call, instead of calling a host function per node operation.
+   * Returns the array of the nodes created by the batch.
+   */
+  jsi::Value applyCommands(jsi::Runtime &runtime, const jsi::Array &commands)
+      const;
+
+  /*
+   * Measures the nodes with `UIManager::measureAsync` and calls `callback`
+   * with the array of their frames (`[x, y, width, height]`, or `null` for
+   * nodes which aren't mounted). Returns the id of the request, which can be
+   * passed to `cancelMeasureAsync`.
+   */
+  int measureAsync(
+      jsi::Runtime &runtime,
+      std::vector<MeasureRequest::Item> items,
+      jsi::Function callback) const;
+  void cancelMeasureAsync(int requestId) const;
+
+  struct PendingMeasureRequest {
+    MeasureRequest::Shared request;
+    jsi::Function callback;
+  };
+
+  struct InternedComponent {
+    std::string name;
+    ComponentDescriptor const *componentDescriptor;
+  };
+
   std::unique_ptr<UIManager> uiManager_;
   std::unique_ptr<const EventHandler> eventHandler_;
+  mutable std::vector<InternedComponent> internedComponents_;
+  mutable better::map<std::string, int> internedHandles_;
+  mutable uint64_t internedGeneration_{0};
+  // Callbacks are JavaScript values, so they stay on the JavaScript thread.
+  mutable std::unordered_map<int, PendingMeasureRequest>
+      pendingMeasureRequests_;
+  mutable int nextMeasureRequestId_{1};
 };
 
 } // namespace react
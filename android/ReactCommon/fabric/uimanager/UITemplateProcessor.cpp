@@ -7,6 +7,8 @@
 
 #include "UITemplateProcessor.h"
 
+#include <algorithm>
+
 #include <folly/json.h>
 #include <glog/logging.h>
 #include <react/components/view/ViewComponentDescriptor.h>
@@ -23,95 +25,77 @@ namespace react {
 
 bool constexpr DEBUG_FLY = false;
 
-struct RBCContext {
-  const Tag rootTag;
-  const std::vector<SharedShadowNode> &nodes;
-  const std::vector<folly::dynamic> &registers;
-  const ComponentDescriptorRegistry &componentDescriptorRegistry;
-  const NativeModuleRegistry &nativeModuleRegistry;
-};
+static int constexpr kTagOffset = 420000;
 
-// TODO: use RBCContext instead of all the separate arguments.
-SharedShadowNode UITemplateProcessor::runCommand(
+void UITemplateProcessor::compileCommand(
     const folly::dynamic &command,
-    Tag rootTag,
-    std::vector<SharedShadowNode> &nodes,
-    std::vector<folly::dynamic> &registers,
-    const ComponentDescriptorRegistry &componentDescriptorRegistry,
-    const NativeModuleRegistry &nativeModuleRegistry,
-    const std::shared_ptr<const ReactNativeConfig> reactNativeConfig) {
+    bool isNested,
+    UITemplate &uiTemplate,
+    const ComponentDescriptorRegistry &componentDescriptorRegistry) {
+  auto &instructions = uiTemplate.instructions_;
   const std::string &opcode = command[0].asString();
-  const int tagOffset = 420000;
-  // TODO: change to integer codes and a switch statement
+  auto instruction = UITemplate::Instruction{};
+
   if (opcode == "createNode") {
-    int tag = command[1].asInt();
-    const auto &type = command[2].asString();
-    const auto parentTag = command[3].asInt();
-    const auto &props = command[4];
-    nodes[tag] = componentDescriptorRegistry.createNode(
-        tag + tagOffset, type, rootTag, props, nullptr);
-    if (parentTag > -1) { // parentTag == -1 indicates root node
-      auto parentShadowNode = nodes[parentTag];
-      auto const &componentDescriptor = componentDescriptorRegistry.at(
-          parentShadowNode->getComponentHandle());
-      componentDescriptor.appendChild(parentShadowNode, nodes[tag]);
+    instruction.opcode = UITemplate::Opcode::CreateNode;
+    instruction.tag = command[1].asInt();
+    instruction.parentTag = command[3].asInt();
+    if (instruction.tag < 0) {
+      throw std::runtime_error(
+          "invalid node tag " + folly::to<std::string>(instruction.tag));
     }
+    auto const &componentDescriptor =
+        componentDescriptorRegistry.at(command[2].asString());
+    instruction.componentHandle = componentDescriptor.getComponentHandle();
+    instruction.props =
+        componentDescriptor.cloneProps(nullptr, RawProps(command[4]));
+    uiTemplate.nodeCount_ = std::max(
+        uiTemplate.nodeCount_,
+        std::max(instruction.tag, instruction.parentTag) + 1);
+    instructions.push_back(std::move(instruction));
   } else if (opcode == "returnRoot") {
-    if (DEBUG_FLY) {
-      LOG(INFO)
-          << "(stop) UITemplateProcessor inject serialized 'server rendered' view tree";
+    // Only a top-level `returnRoot` finishes building the tree.
+    if (!isNested) {
+      instruction.opcode = UITemplate::Opcode::ReturnRoot;
+      instruction.tag = command[1].asInt();
+      instructions.push_back(std::move(instruction));
     }
-    return nodes[command[1].asInt()];
   } else if (opcode == "loadNativeBool") {
-    int registerNumber = command[1].asInt();
-    std::string param = command[4][0].asString();
-    registers[registerNumber] = reactNativeConfig->getBool(param);
+    instruction.opcode = UITemplate::Opcode::LoadNativeBool;
+    instruction.registerNumber = command[1].asInt();
+    instruction.param = command[4][0].asString();
+    instructions.push_back(std::move(instruction));
   } else if (opcode == "conditional") {
-    int registerNumber = command[1].asInt();
-    auto conditionDynamic = registers[registerNumber];
-    if (conditionDynamic.isNull()) {
-      // TODO: provide original command or command line?
-      auto err = std::runtime_error(
-          "register " + command[1].asString() + " wasn't loaded before access");
-      throw err;
-    } else if (conditionDynamic.type() != folly::dynamic::BOOL) {
-      // TODO: provide original command or command line?
-      auto err = std::runtime_error(
-          "register " + command[1].asString() + " had type '" +
-          conditionDynamic.typeName() +
-          "' but needs to be 'boolean' for conditionals");
-      throw err;
+    auto conditionalIndex = instructions.size();
+    instruction.opcode = UITemplate::Opcode::JumpIfFalse;
+    instruction.registerNumber = command[1].asInt();
+    instructions.push_back(std::move(instruction));
+
+    for (const auto &nextCommand : command[2]) {
+      compileCommand(
+          nextCommand, true, uiTemplate, componentDescriptorRegistry);
     }
-    const auto &nextCommands =
-        conditionDynamic.asBool() ? command[2] : command[3];
-    for (const auto &nextCommand : nextCommands) {
-      runCommand(
-          nextCommand,
-          rootTag,
-          nodes,
-          registers,
-          componentDescriptorRegistry,
-          nativeModuleRegistry,
-          reactNativeConfig);
+
+    auto jumpIndex = instructions.size();
+    instructions.push_back(UITemplate::Instruction{UITemplate::Opcode::Jump});
+
+    instructions[conditionalIndex].jumpIndex = instructions.size();
+    for (const auto &nextCommand : command[3]) {
+      compileCommand(
+          nextCommand, true, uiTemplate, componentDescriptorRegistry);
     }
+
+    instructions[jumpIndex].jumpIndex = instructions.size();
+    instructions[conditionalIndex].endIndex = instructions.size();
   } else {
     throw std::runtime_error("Unsupported opcode: " + command[0].asString());
   }
-  return nullptr;
 }
 
-SharedShadowNode UITemplateProcessor::buildShadowTree(
+UITemplate::Shared UITemplateProcessor::compileTemplate(
     const std::string &jsonStr,
-    Tag rootTag,
     const folly::dynamic &params,
-    const ComponentDescriptorRegistry &componentDescriptorRegistry,
-    const NativeModuleRegistry &nativeModuleRegistry,
-    const std::shared_ptr<const ReactNativeConfig> reactNativeConfig) {
-  if (DEBUG_FLY) {
-    LOG(INFO)
-        << "(strt) UITemplateProcessor inject hardcoded 'server rendered' view tree";
-  }
-
+    const ComponentDescriptorRegistry &componentDescriptorRegistry) {
   std::string content = jsonStr;
   for (const auto &param : params.items()) {
     const auto &key = param.first.asString();
@@ -121,35 +105,173 @@ SharedShadowNode UITemplateProcessor::buildShadowTree(
     }
   }
   auto parsed = folly::parseJson(content);
-  auto commands = parsed["commands"];
-  std::vector<SharedShadowNode> nodes(commands.size() * 2);
-  std::vector<folly::dynamic> registers(32);
+  auto const &commands = parsed["commands"];
+
+  auto uiTemplate = std::make_shared<UITemplate>();
   for (const auto &command : commands) {
     try {
-      if (DEBUG_FLY) {
-        LOG(INFO) << "try to run command " << folly::toJson(command);
-      }
-      auto ret = runCommand(
-          command,
-          rootTag,
-          nodes,
-          registers,
-          componentDescriptorRegistry,
-          nativeModuleRegistry,
-          reactNativeConfig);
-      if (ret != nullptr) {
-        return ret;
-      }
+      compileCommand(command, false, *uiTemplate, componentDescriptorRegistry);
     } catch (const std::exception &e) {
-      LOG(ERROR) << "   >>> Exception <<<    running previous command '"
+      LOG(ERROR) << "   >>> Exception <<<    compiling command '"
                  << folly::toJson(command) << "': '" << e.what() << "'";
     }
   }
-  LOG(ERROR) << "react ui template missing returnRoot command :(";
-  throw std::runtime_error(
-      "Missing returnRoot command in template content:\n" + content);
+
+  auto const &instructions = uiTemplate->instructions_;
+  auto hasReturnRoot = std::any_of(
+      instructions.begin(),
+      instructions.end(),
+      [](const UITemplate::Instruction &instruction) {
+        return instruction.opcode == UITemplate::Opcode::ReturnRoot;
+      });
+  if (!hasReturnRoot) {
+    LOG(ERROR) << "react ui template missing returnRoot command :(";
+    throw std::runtime_error(
+        "Missing returnRoot command in template content:\n" + content);
+  }
+
+  return uiTemplate;
+}
+
+SharedShadowNode UITemplateProcessor::buildShadowTree(
+    const UITemplate &uiTemplate,
+    Tag rootTag,
+    const ComponentDescriptorRegistry &componentDescriptorRegistry,
+    const NativeModuleRegistry &nativeModuleRegistry,
+    const std::shared_ptr<const ReactNativeConfig> reactNativeConfig) {
+  if (DEBUG_FLY) {
+    LOG(INFO)
+        << "(strt) UITemplateProcessor inject hardcoded 'server rendered' view tree";
+  }
+
+  auto const &instructions = uiTemplate.instructions_;
+  auto nodes = std::vector<SharedShadowNode>(uiTemplate.nodeCount_);
+  auto registers = std::vector<folly::dynamic>(32);
+
+  auto index = size_t{0};
+  while (index < instructions.size()) {
+    auto const &instruction = instructions[index++];
+    try {
+      switch (instruction.opcode) {
+        case UITemplate::Opcode::CreateNode: {
+          auto const &componentDescriptor =
+              componentDescriptorRegistry.at(instruction.componentHandle);
+          auto const tag = instruction.tag + kTagOffset;
+          auto const eventEmitter =
+              componentDescriptor.createEventEmitter(nullptr, tag);
+          auto const state =
+              componentDescriptor.createInitialState(ShadowNodeFragment{
+                  tag, rootTag, instruction.props, eventEmitter});
+          nodes[instruction.tag] = componentDescriptor.createShadowNode({
+              /* .tag = */ tag,
+              /* .surfaceId = */ rootTag,
+              /* .props = */ instruction.props,
+              /* .eventEmitter = */ eventEmitter,
+              /* .children = */ ShadowNodeFragment::childrenPlaceholder(),
+              /* .localData = */ ShadowNodeFragment::localDataPlaceholder(),
+              /* .state = */ state,
+          });
+          // parentTag == -1 indicates root node
+          if (instruction.parentTag > -1) {
+            auto const &parentShadowNode = nodes[instruction.parentTag];
+            componentDescriptorRegistry
+                .at(parentShadowNode->getComponentHandle())
+                .appendChild(parentShadowNode, nodes[instruction.tag]);
+          }
+          break;
+        }
+        case UITemplate::Opcode::ReturnRoot:
+          if (DEBUG_FLY) {
+            LOG(INFO)
+                << "(stop) UITemplateProcessor inject serialized 'server rendered' view tree";
+          }
+          return nodes[instruction.tag];
+        case UITemplate::Opcode::LoadNativeBool:
+          registers[instruction.registerNumber] =
+              reactNativeConfig->getBool(instruction.param);
+          break;
+        case UITemplate::Opcode::JumpIfFalse: {
+          auto const &conditionDynamic = registers[instruction.registerNumber];
+          if (conditionDynamic.isNull()) {
+            throw std::runtime_error(
+                "register " +
+                folly::to<std::string>(instruction.registerNumber) +
+                " wasn't loaded before access");
+          } else if (conditionDynamic.type() != folly::dynamic::BOOL) {
+            throw std::runtime_error(
+                "register " +
+                folly::to<std::string>(instruction.registerNumber) +
+                " had type '" + conditionDynamic.typeName() +
+                "' but needs to be 'boolean' for conditionals");
+          }
+          if (!conditionDynamic.asBool()) {
+            index = instruction.jumpIndex;
+          }
+          break;
+        }
+        case UITemplate::Opcode::Jump:
+          index = instruction.jumpIndex;
+          break;
+      }
+    } catch (const std::exception &e) {
+      LOG(ERROR) << "   >>> Exception <<<    running instruction " << index - 1
+                 << ": '" << e.what() << "'";
+      if (instruction.opcode == UITemplate::Opcode::JumpIfFalse) {
+        // Neither branch of a conditional that cannot be evaluated runs.
+        index = instruction.endIndex;
+      }
+    }
+  }
+
+  throw std::runtime_error("Missing returnRoot command in template");
   return SharedShadowNode{};
 }
 
+#ifdef ANDROID
+static void appendCreateNodeCommands(
+    const ShadowNode &shadowNode,
+    int parentTag,
+    folly::dynamic &commands) {
+  auto const tag = static_cast<int>(commands.size());
+  commands.push_back(folly::dynamic::array(
+      "createNode",
+      tag,
+      shadowNode.getComponentName(),
+      parentTag,
+      shadowNode.getProps()->rawProps));
+
+  for (auto const &child : shadowNode.getChildren()) {
+    appendCreateNodeCommands(*child, tag, commands);
+  }
+}
+
+std::string UITemplateProcessor::serializeShadowTree(
+    const ShadowNode &shadowNode) {
+  auto commands = folly::dynamic::array();
+  appendCreateNodeCommands(shadowNode, -1, commands);
+  commands.push_back(folly::dynamic::array("returnRoot", 0));
+
+  return folly::toJson(
+      folly::dynamic::object("version", 0.1)("commands", std::move(commands)));
+}
+#endif
+
+SharedShadowNode UITemplateProcessor::buildShadowTree(
+    const std::string &jsonStr,
+    Tag rootTag,
+    const folly::dynamic &params,
+    const ComponentDescriptorRegistry &componentDescriptorRegistry,
+    const NativeModuleRegistry &nativeModuleRegistry,
+    const std::shared_ptr<const ReactNativeConfig> reactNativeConfig) {
+  auto uiTemplate =
+      compileTemplate(jsonStr, params, componentDescriptorRegistry);
+  return buildShadowTree(
+      *uiTemplate,
+      rootTag,
+      componentDescriptorRegistry,
+      nativeModuleRegistry,
+      reactNativeConfig);
+}
+
 } // namespace react
 } // namespace facebook
@@ -8,6 +8,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <folly/dynamic.h>
 
@@ -42,6 +44,57 @@ class NativeModuleRegistry {
   std::unordered_map<std::string, NativeModuleCallFn> modules_;
 };
 
+/*
+ * UI template compiled for a particular `ComponentDescriptorRegistry`: a flat
+ * list of instructions with component handles resolved and props objects
+ * built in advance, so running it only creates and assembles shadow nodes.
+ * Immutable; can be run any number of times on any thread.
+ */
+class UITemplate final {
+ public:
+  using Shared = std::shared_ptr<UITemplate const>;
+
+ private:
+  friend class UITemplateProcessor;
+
+  enum class Opcode {
+    CreateNode,
+    ReturnRoot,
+    LoadNativeBool,
+    JumpIfFalse,
+    Jump,
+  };
+
+  struct Instruction {
+    Opcode opcode;
+
+    /*
+     * `CreateNode` and `ReturnRoot`.
+     */
+    int tag{-1};
+    int parentTag{-1};
+    ComponentHandle componentHandle{};
+    SharedProps props{};
+
+    /*
+     * `LoadNativeBool` and `JumpIfFalse`.
+     */
+    int registerNumber{-1};
+    std::string param{};
+
+    /*
+     * `Jump` and `JumpIfFalse`: index of the instruction to continue with.
+     * `JumpIfFalse` also stores the index of the instruction after the whole
+     * conditional (used if the condition cannot be evaluated).
+     */
+    int jumpIndex{0};
+    int endIndex{0};
+  };
+
+  std::vector<Instruction> instructions_;
+  int nodeCount_{0};
+};
+
 class UITemplateProcessor {
  public:
   static SharedShadowNode buildShadowTree(
@@ -52,15 +105,44 @@ class UITemplateProcessor {
       const NativeModuleRegistry &nativeModuleRegistry,
       const std::shared_ptr<const ReactNativeConfig> reactNativeConfig);
 
- private:
-  static SharedShadowNode runCommand(
-      const folly::dynamic &command,
-      Tag rootTag,
-      std::vector<SharedShadowNode> &nodes,
-      std::vector<folly::dynamic> &registers,
+  /*
+   * Parses a JSON UI template (substituting given `params`) and compiles it
+   * for `componentDescriptorRegistry`.
+   * Throws if the template has no `returnRoot` command.
+   */
+  static UITemplate::Shared compileTemplate(
+      const std::string &jsonStr,
+      const folly::dynamic &params,
+      const ComponentDescriptorRegistry &componentDescriptorRegistry);
+
+  /*
+   * Builds a shadow tree from a template compiled for
+   * `componentDescriptorRegistry`.
+   */
+  static SharedShadowNode buildShadowTree(
+      const UITemplate &uiTemplate,
+      int rootTag,
       const ComponentDescriptorRegistry &componentDescriptorRegistry,
       const NativeModuleRegistry &nativeModuleRegistry,
       const std::shared_ptr<const ReactNativeConfig> reactNativeConfig);
+
+#ifdef ANDROID
+  /*
+   * Serializes a shadow tree (e.g. the child of a surface's root after its
+   * first render) into a UI template, so that a next launch can mount the
+   * same first frame from it before the JavaScript bundle is loaded. Layout
+   * isn't stored; it's computed again from the props, which are taken from
+   * `Props::rawProps` (the effective raw props of each node).
+   */
+  static std::string serializeShadowTree(const ShadowNode &shadowNode);
+#endif
+
+ private:
+  static void compileCommand(
+      const folly::dynamic &command,
+      bool isNested,
+      UITemplate &uiTemplate,
+      const ComponentDescriptorRegistry &componentDescriptorRegistry);
 };
 } // namespace react
 } // namespace facebook
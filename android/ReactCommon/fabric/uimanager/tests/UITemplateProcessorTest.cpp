@@ -107,12 +107,12 @@ TEST(UITemplateProcessorTest, testSimpleBytecode) {
 #endif
   auto props1 = std::dynamic_pointer_cast<const ViewProps>(root1->getProps());
   ASSERT_NEAR(props1->opacity, 0.5, 0.001);
-  ASSERT_STREQ(props1->testId.c_str(), "root");
+  ASSERT_STREQ(props1->testId().c_str(), "root");
   auto children1 = root1->getChildren();
   ASSERT_EQ(children1.size(), 1);
   auto child_props1 =
       std::dynamic_pointer_cast<const ViewProps>(children1.at(0)->getProps());
-  ASSERT_STREQ(child_props1->testId.c_str(), "child");
+  ASSERT_STREQ(child_props1->testId().c_str(), "child");
 }
 
 TEST(UITemplateProcessorTest, testConditionalBytecode) {
@@ -144,12 +144,13 @@ TEST(UITemplateProcessorTest, testConditionalBytecode) {
   LOG(INFO) << std::endl << root1->getDebugDescription();
 #endif
   auto props1 = std::dynamic_pointer_cast<const ViewProps>(root1->getProps());
-  ASSERT_STREQ(props1->testId.c_str(), "root");
+  ASSERT_STREQ(props1->testId().c_str(), "root");
   auto children1 = root1->getChildren();
   ASSERT_EQ(children1.size(), 1);
   auto child_props1 =
       std::dynamic_pointer_cast<const ViewProps>(children1.at(0)->getProps());
-  ASSERT_STREQ(child_props1->testId.c_str(), "cond_true");
+  ASSERT_STREQ(
+      child_props1->testId().c_str(), "cond_true");
 
   mockSimpleTestValue_ = false;
 
@@ -162,5 +163,104 @@ TEST(UITemplateProcessorTest, testConditionalBytecode) {
       mockReactNativeConfig_);
   auto child_props2 = std::dynamic_pointer_cast<const ViewProps>(
       root2->getChildren().at(0)->getProps());
-  ASSERT_STREQ(child_props2->testId.c_str(), "cond_false");
+  ASSERT_STREQ(
+      child_props2->testId().c_str(), "cond_false");
 }
+
+#ifdef ANDROID
+TEST(UITemplateProcessorTest, testSerializedShadowTreeBuildsTheSameTree) {
+  auto surfaceId = 11;
+  auto componentDescriptorRegistry =
+      getDefaultComponentRegistryFactory()(nullptr, nullptr);
+  auto nativeModuleRegistry = buildNativeModuleRegistry();
+
+  auto bytecode = R"delim({"version":0.1,"commands":[
+    ["createNode",2,"RCTView",-1,{"opacity": 0.5, "testId": "root"}],
+    ["createNode",4,"RCTView",2,{"testId": "first"}],
+    ["createNode",6,"RCTView",2,{"testId": "second"}],
+    ["returnRoot",2]
+  ]})delim";
+
+  auto root1 = UITemplateProcessor::buildShadowTree(
+      bytecode,
+      surfaceId,
+      folly::dynamic::object(),
+      *componentDescriptorRegistry,
+      nativeModuleRegistry,
+      mockReactNativeConfig_);
+
+  auto serialized = UITemplateProcessor::serializeShadowTree(*root1);
+  ASSERT_FALSE(serialized.empty());
+
+  auto root2 = UITemplateProcessor::buildShadowTree(
+      serialized,
+      surfaceId,
+      folly::dynamic::object(),
+      *componentDescriptorRegistry,
+      nativeModuleRegistry,
+      mockReactNativeConfig_);
+  auto props2 = std::dynamic_pointer_cast<const ViewProps>(root2->getProps());
+  ASSERT_NEAR(props2->opacity, 0.5, 0.001);
+  auto children2 = root2->getChildren();
+  ASSERT_EQ(children2.size(), 2);
+  ASSERT_STREQ(
+      std::dynamic_pointer_cast<const ViewProps>(children2.at(0)->getProps())
+          ->testId().c_str(),
+      "first");
+  ASSERT_STREQ(
+      std::dynamic_pointer_cast<const ViewProps>(children2.at(1)->getProps())
+          ->testId().c_str(),
+      "second");
+}
+
+TEST(UITemplateProcessorTest, testSerializedShadowTreeKeepsUpdatedProps) {
+  auto surfaceId = 11;
+  auto componentDescriptorRegistry =
+      getDefaultComponentRegistryFactory()(nullptr, nullptr);
+  auto nativeModuleRegistry = buildNativeModuleRegistry();
+
+  auto bytecode = R"delim({"version":0.1,"commands":[
+    ["createNode",2,"RCTView",-1,{"opacity": 0.5, "testId": "root"}],
+    ["createNode",4,"RCTView",2,{"testId": "child"}],
+    ["returnRoot",2]
+  ]})delim";
+
+  auto root1 = UITemplateProcessor::buildShadowTree(
+      bytecode,
+      surfaceId,
+      folly::dynamic::object(),
+      *componentDescriptorRegistry,
+      nativeModuleRegistry,
+      mockReactNativeConfig_);
+
+  // An update only carries the props that changed.
+  auto updatedProps = root1->getComponentDescriptor().cloneProps(
+      root1->getProps(), RawProps(folly::dynamic::object("opacity", 1)));
+  ASSERT_GT(updatedProps->revision, 1);
+  auto updatedRoot = root1->clone({
+      /* .tag = */ ShadowNodeFragment::tagPlaceholder(),
+      /* .surfaceId = */ ShadowNodeFragment::surfaceIdPlaceholder(),
+      /* .props = */ updatedProps,
+  });
+
+  auto serialized = UITemplateProcessor::serializeShadowTree(*updatedRoot);
+  ASSERT_FALSE(serialized.empty());
+
+  auto root2 = UITemplateProcessor::buildShadowTree(
+      serialized,
+      surfaceId,
+      folly::dynamic::object(),
+      *componentDescriptorRegistry,
+      nativeModuleRegistry,
+      mockReactNativeConfig_);
+  auto props2 = std::dynamic_pointer_cast<const ViewProps>(root2->getProps());
+  ASSERT_NEAR(props2->opacity, 1, 0.001);
+  ASSERT_STREQ(props2->testId().c_str(), "root");
+  auto children2 = root2->getChildren();
+  ASSERT_EQ(children2.size(), 1);
+  ASSERT_STREQ(
+      std::dynamic_pointer_cast<const ViewProps>(children2.at(0)->getProps())
+          ->testId().c_str(),
+      "child");
+}
+#endif
@@ -10,6 +10,10 @@ RuntimeAdapter::~RuntimeAdapter() = default;
 
 void RuntimeAdapter::tickleJs() {}
 
+bool RuntimeAdapter::runOnJSThread(std::function<void()> func) {
+  return false;
+}
+
 SharedRuntimeAdapter::SharedRuntimeAdapter(
     std::shared_ptr<HermesRuntime> runtime)
     : runtime_(std::move(runtime)) {}
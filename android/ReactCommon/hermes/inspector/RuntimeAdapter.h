@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include <hermes/hermes.h>
@@ -36,6 +37,14 @@ class RuntimeAdapter {
   ///
   /// The default implementation does nothing.
   virtual void tickleJs();
+
+  /// runOnJSThread is a method that subclasses can choose to override to run
+  /// func soon with the same locking as tickleJs. Profiler-only connections
+  /// use it to read heap statistics without the debugger pausing the VM. It
+  /// returns whether func will be run.
+  ///
+  /// The default implementation does nothing and returns false.
+  virtual bool runOnJSThread(std::function<void()> func);
 };
 
 /**
@@ -2,8 +2,12 @@
 
 #include "Connection.h"
 
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <mutex>
+#include <sstream>
+#include <type_traits>
 
 #include <folly/Conv.h>
 #include <folly/Executor.h>
@@ -12,8 +16,10 @@
 #include <hermes/inspector/Inspector.h>
 #include <hermes/inspector/chrome/MessageConverters.h>
 #include <hermes/inspector/chrome/RemoteObjectsTable.h>
+#include <hermes/inspector/chrome/SampledTraceConverter.h>
 #include <hermes/inspector/detail/SerialExecutor.h>
 #include <hermes/inspector/detail/Thread.h>
+#include <jsi/instrumentation.h>
 
 namespace facebook {
 namespace hermes {
@@ -35,10 +41,12 @@ namespace m = ::facebook::hermes::inspector::chrome::message;
 class Connection::Impl : public inspector::InspectorObserver,
                          public message::RequestHandler {
  public:
+  /// traceDirectory is only set in profiler-only mode (see ProfilerOnly).
   Impl(
       std::unique_ptr<RuntimeAdapter> adapter,
       const std::string &title,
-      bool waitForDebugger);
+      bool waitForDebugger,
+      folly::Optional<std::string> traceDirectory);
   ~Impl();
 
   HermesRuntime &getRuntime();
@@ -77,6 +85,15 @@ class Connection::Impl : public inspector::InspectorObserver,
   void handle(const m::runtime::GetPropertiesRequest &req) override;
 
  private:
+  /// In profiler-only mode, requests are dispatched by method name here
+  /// instead, since none of the typed requests are served.
+  void handleProfilerRequest(const m::Request &req);
+  void startProfiler(int id);
+  void stopProfiler(int id);
+  void stopProfilerIfRunning();
+  void getHeapUsage(int id);
+  void collectGarbage(int id);
+
   std::vector<m::runtime::PropertyDescriptor> makePropsFromScope(
       std::pair<uint32_t, uint32_t> frameAndScopeIndex,
       const std::string &objectGroup,
@@ -88,10 +105,16 @@ class Connection::Impl : public inspector::InspectorObserver,
 
   void sendToClient(const std::string &str);
   void sendResponseToClient(const m::Response &resp);
+  void sendResultToClient(int id, folly::dynamic result);
   folly::Function<void(const std::exception &)> sendErrorToClient(int id);
   void sendResponseToClientViaExecutor(int id);
   void sendResponseToClientViaExecutor(folly::Future<Unit> future, int id);
-  void sendNotificationToClientViaExecutor(const m::Notification &note);
+
+  /// Serializes and sends the notification on the executor, since it's
+  /// usually created on the JS thread (e.g. in an InspectorObserver callback),
+  /// which shouldn't also pay for turning it into JSON.
+  template <typename NotificationT>
+  void sendNotificationToClientViaExecutor(NotificationT note);
 
   std::shared_ptr<RuntimeAdapter> runtimeAdapter_;
   std::string title_;
@@ -113,7 +136,10 @@ class Connection::Impl : public inspector::InspectorObserver,
   // The rest of these member variables are only accessed via executor_.
   std::unique_ptr<folly::Executor> executor_;
   std::unique_ptr<IRemoteConnection> remoteConn_;
+  // inspector_ is null in profiler-only mode.
   std::shared_ptr<inspector::Inspector> inspector_;
+  folly::Optional<std::string> traceDirectory_;
+  bool isProfiling_ = false;
 
   // objTable_ is protected by the inspector lock. It should only be accessed
   // when the VM is paused, e.g. in an InspectorObserver callback or in an
@@ -124,18 +150,24 @@ class Connection::Impl : public inspector::InspectorObserver,
 Connection::Impl::Impl(
     std::unique_ptr<RuntimeAdapter> adapter,
     const std::string &title,
-    bool waitForDebugger)
+    bool waitForDebugger,
+    folly::Optional<std::string> traceDirectory)
     : runtimeAdapter_(std::move(adapter)),
       title_(title),
       connected_(false),
       executor_(std::make_unique<inspector::detail::SerialExecutor>(
           "hermes-chrome-inspector-conn")),
       remoteConn_(nullptr),
-      inspector_(std::make_shared<inspector::Inspector>(
-          runtimeAdapter_,
-          *this,
-          waitForDebugger)) {
-  inspector_->installLogHandler();
+      inspector_(
+          traceDirectory ? nullptr
+                         : std::make_shared<inspector::Inspector>(
+                               runtimeAdapter_,
+                               *this,
+                               waitForDebugger)),
+      traceDirectory_(std::move(traceDirectory)) {
+  if (inspector_) {
+    inspector_->installLogHandler();
+  }
 }
 
 Connection::Impl::~Impl() = default;
@@ -173,7 +205,11 @@ bool Connection::Impl::disconnect() {
 
   connected_ = false;
 
-  inspector_->disable().via(executor_.get()).thenValue([this](auto &&) {
+  folly::Future<Unit> detached =
+      inspector_ ? inspector_->disable() : folly::makeFuture();
+  detached.via(executor_.get()).thenValue([this](auto &&) {
+    stopProfilerIfRunning();
+
     // HACK:  We purposely call RemoteConnection::onDisconnect on a *different*
     // rather than on this thread (the executor thread). This is to prevent this
     // scenario:
@@ -219,7 +255,9 @@ void Connection::Impl::sendMessage(std::string str) {
     }
 
     auto &req = maybeReq.value();
-    if (req) {
+    if (req && !inspector_) {
+      handleProfilerRequest(*req);
+    } else if (req) {
       req->accept(*this);
     }
   });
@@ -235,7 +273,7 @@ void Connection::Impl::onBreakpointResolved(
   m::debugger::BreakpointResolvedNotification note;
   note.breakpointId = folly::to<std::string>(info.id);
   note.location = m::debugger::makeLocation(info.resolvedLocation);
-  sendNotificationToClientViaExecutor(note);
+  sendNotificationToClientViaExecutor(std::move(note));
 }
 
 void Connection::Impl::onContextCreated(Inspector &inspector) {
@@ -250,7 +288,7 @@ void Connection::Impl::onContextCreated(Inspector &inspector) {
   note.context.isDefault = true;
   note.context.isPageContext = true;
 
-  sendNotificationToClientViaExecutor(note);
+  sendNotificationToClientViaExecutor(std::move(note));
 }
 
 void Connection::Impl::onPause(
@@ -280,14 +318,14 @@ void Connection::Impl::onPause(
       break;
   }
 
-  sendNotificationToClientViaExecutor(note);
+  sendNotificationToClientViaExecutor(std::move(note));
 }
 
 void Connection::Impl::onResume(Inspector &inspector) {
   objTable_.releaseObjectGroup(BacktraceObjectGroup);
 
   m::debugger::ResumedNotification note;
-  sendNotificationToClientViaExecutor(note);
+  sendNotificationToClientViaExecutor(std::move(note));
 }
 
 void Connection::Impl::onScriptParsed(
@@ -306,7 +344,7 @@ void Connection::Impl::onScriptParsed(
     parsedScripts_.push_back(info.fileName);
   }
 
-  sendNotificationToClientViaExecutor(note);
+  sendNotificationToClientViaExecutor(std::move(note));
 }
 
 void Connection::Impl::onMessageAdded(
@@ -324,7 +362,7 @@ void Connection::Impl::onMessageAdded(
         "ConsoleObjectGroup"));
   }
 
-  sendNotificationToClientViaExecutor(apiCalledNote);
+  sendNotificationToClientViaExecutor(std::move(apiCalledNote));
 }
 
 /*
@@ -588,6 +626,146 @@ void Connection::Impl::handle(const m::runtime::GetPropertiesRequest &req) {
       .thenError<std::exception>(sendErrorToClient(req.id));
 }
 
+/*
+ * Profiler-only mode
+ */
+
+void Connection::Impl::handleProfilerRequest(const m::Request &req) {
+  const std::string &method = req.method;
+
+  if (method == "Profiler.start") {
+    startProfiler(req.id);
+  } else if (method == "Profiler.stop") {
+    stopProfiler(req.id);
+  } else if (method == "Runtime.getHeapUsage") {
+    getHeapUsage(req.id);
+  } else if (method == "HeapProfiler.collectGarbage") {
+    collectGarbage(req.id);
+  } else if (
+      method == "Profiler.enable" || method == "Profiler.disable" ||
+      method == "Profiler.setSamplingInterval" ||
+      method == "HeapProfiler.enable" || method == "HeapProfiler.disable") {
+    // Hermes samples at a fixed interval and always keeps heap statistics.
+    sendResponseToClient(m::makeOkResponse(req.id));
+  } else {
+    sendResponseToClient(m::makeErrorResponse(
+        req.id,
+        m::ErrorCode::MethodNotFound,
+        method + " is not available in profiler-only mode"));
+  }
+}
+
+void Connection::Impl::startProfiler(int id) {
+  HermesRuntime::enableSamplingProfiler();
+  isProfiling_ = true;
+  sendResponseToClient(m::makeOkResponse(id));
+}
+
+void Connection::Impl::stopProfiler(int id) {
+  if (!isProfiling_) {
+    sendResponseToClient(m::makeErrorResponse(
+        id, m::ErrorCode::ServerError, "Profiler is not started"));
+    return;
+  }
+
+  HermesRuntime::disableSamplingProfiler();
+  isProfiling_ = false;
+
+  // Hermes can only dump its samples to a file, which is removed as soon as
+  // it's been read back.
+  const std::string path = folly::to<std::string>(
+      *traceDirectory_,
+      "/hermes-sampled-trace-",
+      reinterpret_cast<uintptr_t>(this),
+      ".json");
+
+  try {
+    HermesRuntime::dumpSampledTraceToFile(path);
+
+    std::ifstream file(path);
+    std::stringstream trace;
+    trace << file.rdbuf();
+    file.close();
+    std::remove(path.c_str());
+
+    sendResultToClient(
+        id,
+        folly::dynamic::object(
+            "profile", makeProfile(folly::parseJson(trace.str()))));
+  } catch (const std::exception &e) {
+    std::remove(path.c_str());
+    sendResponseToClient(
+        m::makeErrorResponse(id, m::ErrorCode::ServerError, e.what()));
+  }
+}
+
+void Connection::Impl::stopProfilerIfRunning() {
+  if (isProfiling_) {
+    HermesRuntime::disableSamplingProfiler();
+    isProfiling_ = false;
+  }
+}
+
+void Connection::Impl::getHeapUsage(int id) {
+  auto promise = std::make_shared<folly::Promise<folly::dynamic>>();
+  auto future = promise->getFuture();
+
+  // The heap may only be inspected on the JS thread. Only the adapter is
+  // captured, since the callback may outlive this request.
+  std::shared_ptr<RuntimeAdapter> adapter = runtimeAdapter_;
+  bool isScheduled = adapter->runOnJSThread([adapter, promise]() {
+    promise->setWith([&adapter] {
+      HermesRuntime &runtime = adapter->getRuntime();
+      jsi::Object info =
+          runtime.instrumentation().getHeapInfo(false).getObject(runtime);
+
+      auto getNumber = [&runtime, &info](const char *name) {
+        jsi::Value value = info.getProperty(runtime, name);
+        return value.isNumber() ? value.getNumber() : 0.0;
+      };
+      return folly::dynamic::object(
+          "usedSize", getNumber("hermes_allocatedBytes"))(
+          "totalSize", getNumber("hermes_heapSize"));
+    });
+  });
+
+  if (!isScheduled) {
+    sendResponseToClient(m::makeErrorResponse(
+        id,
+        m::ErrorCode::ServerError,
+        "Heap statistics are not available for this runtime"));
+    return;
+  }
+
+  std::move(future)
+      .via(executor_.get())
+      .thenValue([this, id](folly::dynamic result) {
+        sendResultToClient(id, std::move(result));
+      })
+      .thenError<std::exception>(sendErrorToClient(id));
+}
+
+void Connection::Impl::collectGarbage(int id) {
+  auto promise = std::make_shared<folly::Promise<Unit>>();
+  auto future = promise->getFuture();
+
+  std::shared_ptr<RuntimeAdapter> adapter = runtimeAdapter_;
+  bool isScheduled = adapter->runOnJSThread([adapter, promise]() {
+    promise->setWith(
+        [&adapter] { adapter->getRuntime().instrumentation().collectGarbage(); });
+  });
+
+  if (!isScheduled) {
+    sendResponseToClient(m::makeErrorResponse(
+        id,
+        m::ErrorCode::ServerError,
+        "Garbage collection is not available for this runtime"));
+    return;
+  }
+
+  sendResponseToClientViaExecutor(std::move(future), id);
+}
+
 /*
  * Send-to-client methods
  */
@@ -602,6 +780,11 @@ void Connection::Impl::sendResponseToClient(const m::Response &resp) {
   sendToClient(resp.toJson());
 }
 
+void Connection::Impl::sendResultToClient(int id, folly::dynamic result) {
+  sendToClient(folly::toJson(
+      folly::dynamic::object("id", id)("result", std::move(result))));
+}
+
 folly::Function<void(const std::exception &)>
 Connection::Impl::sendErrorToClient(int id) {
   return [this, id](const std::exception &e) {
@@ -624,10 +807,14 @@ void Connection::Impl::sendResponseToClientViaExecutor(
       .thenError<std::exception>(sendErrorToClient(id));
 }
 
-void Connection::Impl::sendNotificationToClientViaExecutor(
-    const m::Notification &note) {
-  executor_->add(
-      [this, noteJson = note.toJson()]() { sendToClient(noteJson); });
+template <typename NotificationT>
+void Connection::Impl::sendNotificationToClientViaExecutor(NotificationT note) {
+  static_assert(
+      std::is_base_of<m::Notification, NotificationT>::value,
+      "Only notifications can be sent");
+  executor_->add([this, note = std::move(note)]() {
+    sendToClient(note.toJson());
+  });
 }
 
 /*
@@ -637,8 +824,21 @@ Connection::Connection(
     std::unique_ptr<RuntimeAdapter> adapter,
     const std::string &title,
     bool waitForDebugger)
-    : impl_(
-          std::make_unique<Impl>(std::move(adapter), title, waitForDebugger)) {}
+    : impl_(std::make_unique<Impl>(
+          std::move(adapter),
+          title,
+          waitForDebugger,
+          folly::none)) {}
+
+Connection::Connection(
+    std::unique_ptr<RuntimeAdapter> adapter,
+    const std::string &title,
+    ProfilerOnly profilerOnly)
+    : impl_(std::make_unique<Impl>(
+          std::move(adapter),
+          title,
+          false,
+          std::move(profilerOnly.traceDirectory))) {}
 
 Connection::~Connection() = default;
 
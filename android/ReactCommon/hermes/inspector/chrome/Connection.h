@@ -16,6 +16,18 @@ namespace hermes {
 namespace inspector {
 namespace chrome {
 
+/// ProfilerOnly selects the profiler-only mode of a Connection. It never
+/// installs the debugger on the runtime, so there are no breakpoints, pauses
+/// or debugger hooks slowing down execution, and only serves the sampling
+/// profiler (Profiler.start and Profiler.stop) and heap statistics
+/// (Runtime.getHeapUsage and HeapProfiler.collectGarbage). Every other request
+/// fails with MethodNotFound.
+struct ProfilerOnly {
+  /// traceDirectory is a writable directory where sampled traces are dumped
+  /// while they're converted into a profile for the client.
+  std::string traceDirectory;
+};
+
 /// Connection is a duplex connection between the client and the debugger.
 class Connection {
  public:
@@ -25,6 +37,13 @@ class Connection {
       std::unique_ptr<RuntimeAdapter> adapter,
       const std::string &title,
       bool waitForDebugger = false);
+
+  /// This Connection constructor attaches to the provided runtime in
+  /// profiler-only mode, and can be called at any time.
+  Connection(
+      std::unique_ptr<RuntimeAdapter> adapter,
+      const std::string &title,
+      ProfilerOnly profilerOnly);
   ~Connection();
 
   /// getRuntime returns the underlying runtime being debugged.
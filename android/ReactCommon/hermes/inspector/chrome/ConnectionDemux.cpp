@@ -63,22 +63,7 @@ int ConnectionDemux::enableDebugging(
     const std::string &title) {
   std::lock_guard<std::mutex> lock(mutex_);
 
-  // TODO(#22976087): workaround for ComponentScript contexts never being
-  // destroyed.
-  //
-  // After a reload, the old ComponentScript VM instance stays alive. When we
-  // register the new CS VM instance, check for any previous CS VM (via strcmp
-  // of title) and remove them.
-  std::vector<int> pagesToDelete;
-  for (auto it = conns_.begin(); it != conns_.end(); ++it) {
-    if (it->second->getTitle() == title) {
-      pagesToDelete.push_back(it->first);
-    }
-  }
-
-  for (auto pageId : pagesToDelete) {
-    removePage(pageId);
-  }
+  removePagesWithTitle(title);
 
   // TODO(hypuk): Provide real app and device names.
   auto waitForDebugger =
@@ -89,6 +74,18 @@ int ConnectionDemux::enableDebugging(
       std::make_shared<Connection>(std::move(adapter), title, waitForDebugger));
 }
 
+int ConnectionDemux::enableProfiling(
+    std::unique_ptr<RuntimeAdapter> adapter,
+    const std::string &title,
+    const std::string &traceDirectory) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  removePagesWithTitle(title);
+
+  return addPage(std::make_shared<Connection>(
+      std::move(adapter), title, ProfilerOnly{traceDirectory}));
+}
+
 void ConnectionDemux::disableDebugging(HermesRuntime &runtime) {
   std::lock_guard<std::mutex> lock(mutex_);
 
@@ -106,6 +103,25 @@ void ConnectionDemux::disableDebugging(HermesRuntime &runtime) {
   }
 }
 
+void ConnectionDemux::removePagesWithTitle(const std::string &title) {
+  // TODO(#22976087): workaround for ComponentScript contexts never being
+  // destroyed.
+  //
+  // After a reload, the old ComponentScript VM instance stays alive. When we
+  // register the new CS VM instance, check for any previous CS VM (via strcmp
+  // of title) and remove them.
+  std::vector<int> pagesToDelete;
+  for (auto it = conns_.begin(); it != conns_.end(); ++it) {
+    if (it->second->getTitle() == title) {
+      pagesToDelete.push_back(it->first);
+    }
+  }
+
+  for (auto pageId : pagesToDelete) {
+    removePage(pageId);
+  }
+}
+
 int ConnectionDemux::addPage(std::shared_ptr<Connection> conn) {
   auto connectFunc = [conn, this](std::unique_ptr<IRemoteConnection> remoteConn)
       -> std::unique_ptr<ILocalConnection> {
@@ -33,9 +33,14 @@ class ConnectionDemux {
   int enableDebugging(
       std::unique_ptr<RuntimeAdapter> adapter,
       const std::string &title);
+  int enableProfiling(
+      std::unique_ptr<RuntimeAdapter> adapter,
+      const std::string &title,
+      const std::string &traceDirectory);
   void disableDebugging(HermesRuntime &runtime);
 
  private:
+  void removePagesWithTitle(const std::string &title);
   int addPage(std::shared_ptr<Connection> conn);
   void removePage(int pageId);
 
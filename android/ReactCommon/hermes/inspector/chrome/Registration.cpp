@@ -23,6 +23,13 @@ void enableDebugging(
   demux().enableDebugging(std::move(adapter), title);
 }
 
+void enableProfiling(
+    std::unique_ptr<RuntimeAdapter> adapter,
+    const std::string &title,
+    const std::string &traceDirectory) {
+  demux().enableProfiling(std::move(adapter), title, traceDirectory);
+}
+
 void disableDebugging(HermesRuntime &runtime) {
   demux().disableDebugging(runtime);
 }
@@ -22,9 +22,22 @@ extern void enableDebugging(
     std::unique_ptr<RuntimeAdapter> adapter,
     const std::string &title);
 
+/*
+ * enableProfiling adds this runtime to the list of JS targets like
+ * enableDebugging, but in profiler-only mode (see ProfilerOnly in
+ * Connection.h): the debugger is never installed, so clients can only use the
+ * sampling profiler and heap statistics. Unlike enableDebugging, it can be
+ * called after JS started running. Sampled traces are dumped to
+ * traceDirectory while they're sent to the client.
+ */
+extern void enableProfiling(
+    std::unique_ptr<RuntimeAdapter> adapter,
+    const std::string &title,
+    const std::string &traceDirectory);
+
 /*
  * disableDebugging removes this runtime from the list of debuggable JS targets
- * in this process.
+ * in this process. It also removes runtimes added with enableProfiling.
  */
 extern void disableDebugging(HermesRuntime &runtime);
 
@@ -2,6 +2,7 @@
 
 #include "RemoteObjectsTable.h"
 
+#include <algorithm>
 #include <cstdlib>
 
 #include <folly/Conv.h>
@@ -35,7 +36,10 @@ const char *BacktraceObjectGroup = "backtrace";
 
 const char *ConsoleObjectGroup = "console";
 
-RemoteObjectsTable::RemoteObjectsTable() = default;
+constexpr size_t RemoteObjectsTable::kDefaultMaxValues;
+
+RemoteObjectsTable::RemoteObjectsTable(size_t maxValues)
+    : maxValues_(std::max<size_t>(maxValues, 1)) {}
 
 RemoteObjectsTable::~RemoteObjectsTable() = default;
 
@@ -58,12 +62,15 @@ std::string RemoteObjectsTable::addValue(
     const std::string &objectGroup) {
   int64_t id = valueId_++;
   values_[id] = std::move(value);
+  valueIds_.push_back(id);
 
   if (!objectGroup.empty()) {
     idToGroup_[id] = objectGroup;
     groupToIds_[objectGroup].push_back(id);
   }
 
+  releaseOldestValues();
+
   return toObjId(id);
 }
 
@@ -114,6 +121,41 @@ void RemoteObjectsTable::releaseObject(int64_t id) {
   } else if (isValueId(id)) {
     values_.erase(id);
   }
+  idToGroup_.erase(id);
+}
+
+void RemoteObjectsTable::releaseOldestValues() {
+  while (values_.size() > maxValues_) {
+    int64_t id = valueIds_.front();
+    valueIds_.pop_front();
+    releaseObject(id);
+  }
+
+  // Ids of values released otherwise are only dropped here, every once in a
+  // while, so bookkeeping stays proportional to the number of live objects.
+  if (valueIds_.size() > 2 * maxValues_) {
+    compactIds();
+  }
+}
+
+void RemoteObjectsTable::compactIds() {
+  auto isReleased = [this](int64_t id) {
+    return isScopeId(id) ? scopes_.count(id) == 0 : values_.count(id) == 0;
+  };
+
+  valueIds_.erase(
+      std::remove_if(valueIds_.begin(), valueIds_.end(), isReleased),
+      valueIds_.end());
+
+  for (auto it = groupToIds_.begin(); it != groupToIds_.end();) {
+    auto &ids = it->second;
+    ids.erase(std::remove_if(ids.begin(), ids.end(), isReleased), ids.end());
+    if (ids.empty()) {
+      it = groupToIds_.erase(it);
+    } else {
+      ++it;
+    }
+  }
 }
 
 void RemoteObjectsTable::releaseObject(const std::string &objId) {
@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -41,10 +43,17 @@ extern const char *ConsoleObjectGroup;
  * to object id "objId" and is also in object group "objGroup". Then *either* of
  * `releaseObject("objId")` or `releaseObjectGroup("objGroup")` will remove foo
  * from the table. This matches the behavior of object groups in CDT.
+ *
+ * The table holds at most maxValues JSI values (and keeps them alive): adding
+ * more releases the oldest ones, so that e.g. logging to the console with a
+ * debugger attached doesn't retain every logged value forever. Clients see
+ * released objects as not found.
  */
 class RemoteObjectsTable {
  public:
-  RemoteObjectsTable();
+  static constexpr size_t kDefaultMaxValues = 10000;
+
+  explicit RemoteObjectsTable(size_t maxValues = kDefaultMaxValues);
   ~RemoteObjectsTable();
 
   RemoteObjectsTable(const RemoteObjectsTable &) = delete;
@@ -103,6 +112,10 @@ class RemoteObjectsTable {
 
  private:
   void releaseObject(int64_t id);
+  void releaseOldestValues();
+  void compactIds();
+
+  const size_t maxValues_;
 
   int64_t scopeId_ = -1;
   int64_t valueId_ = 1;
@@ -111,6 +124,10 @@ class RemoteObjectsTable {
   std::unordered_map<int64_t, ::facebook::jsi::Value> values_;
   std::unordered_map<int64_t, std::string> idToGroup_;
   std::unordered_map<std::string, std::vector<int64_t>> groupToIds_;
+
+  // The ids of values in the order they were added, including some which
+  // have been released since.
+  std::deque<int64_t> valueIds_;
 };
 
 } // namespace chrome
@@ -0,0 +1,148 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "SampledTraceConverter.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include <folly/Conv.h>
+
+namespace facebook {
+namespace hermes {
+namespace inspector {
+namespace chrome {
+
+using folly::dynamic;
+
+namespace {
+
+/// The trace writes most numbers as strings, so this accepts both.
+int64_t toInt(const dynamic *value, int64_t defaultValue) {
+  if (value == nullptr) {
+    return defaultValue;
+  }
+  if (value->isInt()) {
+    return value->getInt();
+  }
+  if (value->isDouble()) {
+    return static_cast<int64_t>(value->getDouble());
+  }
+  if (value->isString()) {
+    auto result = folly::tryTo<int64_t>(value->getString());
+    if (result.hasValue()) {
+      return result.value();
+    }
+  }
+  return defaultValue;
+}
+
+/// Hermes names frames like "foo(1:2:3)", while the client only wants "foo".
+std::string functionName(const dynamic &frame) {
+  const dynamic *name = frame.get_ptr("name");
+  if (name == nullptr || !name->isString()) {
+    return "";
+  }
+
+  const std::string &str = name->getString();
+  size_t paren = str.find('(');
+  return paren == std::string::npos || paren == 0 ? str : str.substr(0, paren);
+}
+
+dynamic makeCallFrame(std::string name, int64_t line, int64_t column) {
+  return dynamic::object("functionName", std::move(name))("scriptId", "0")(
+      "url", "")("lineNumber", line)("columnNumber", column);
+}
+
+dynamic makeNode(int64_t id, dynamic callFrame) {
+  return dynamic::object("id", id)("callFrame", std::move(callFrame))(
+      "hitCount", 0)("children", dynamic::array());
+}
+
+} // namespace
+
+dynamic makeProfile(const dynamic &sampledTrace) {
+  const dynamic *stackFrames = sampledTrace.get_ptr("stackFrames");
+  const dynamic *samples = sampledTrace.get_ptr("samples");
+
+  // Nodes are keyed by the id of their frame, and kept ordered so that the
+  // profile doesn't depend on the order of the trace's object keys.
+  std::map<int64_t, dynamic> nodes;
+  int64_t rootId = 1;
+
+  if (stackFrames != nullptr && stackFrames->isObject()) {
+    for (const auto &frame : stackFrames->items()) {
+      int64_t id = toInt(&frame.first, -1);
+      if (id < 0 || !frame.second.isObject()) {
+        continue;
+      }
+
+      // Hermes' lines and columns are 1-based, the client's are 0-based.
+      nodes.emplace(
+          id,
+          makeNode(
+              id,
+              makeCallFrame(
+                  functionName(frame.second),
+                  toInt(frame.second.get_ptr("line"), 0) - 1,
+                  toInt(frame.second.get_ptr("column"), 0) - 1)));
+      rootId = std::max(rootId, id + 1);
+    }
+  }
+
+  dynamic root = makeNode(rootId, makeCallFrame("(root)", -1, -1));
+
+  if (stackFrames != nullptr && stackFrames->isObject()) {
+    for (const auto &frame : stackFrames->items()) {
+      int64_t id = toInt(&frame.first, -1);
+      auto node = nodes.find(id);
+      if (node == nodes.end()) {
+        continue;
+      }
+
+      auto parent = nodes.find(toInt(frame.second.get_ptr("parent"), -1));
+      dynamic &parentNode =
+          parent == nodes.end() || parent == node ? root : parent->second;
+      parentNode["children"].push_back(id);
+    }
+  }
+
+  dynamic sampleIds = dynamic::array();
+  dynamic timeDeltas = dynamic::array();
+  int64_t startTime = 0;
+  int64_t lastTime = 0;
+
+  if (samples != nullptr && samples->isArray()) {
+    for (const auto &sample : *samples) {
+      if (!sample.isObject()) {
+        continue;
+      }
+
+      auto node = nodes.find(toInt(sample.get_ptr("sf"), -1));
+      dynamic &sampleNode = node == nodes.end() ? root : node->second;
+      sampleNode["hitCount"] = sampleNode["hitCount"].asInt() + 1;
+
+      int64_t time = toInt(sample.get_ptr("ts"), lastTime);
+      if (sampleIds.empty()) {
+        startTime = lastTime = time;
+      }
+      sampleIds.push_back(sampleNode["id"]);
+      timeDeltas.push_back(time - lastTime);
+      lastTime = time;
+    }
+  }
+
+  dynamic nodeList = dynamic::array(std::move(root));
+  for (auto &node : nodes) {
+    nodeList.push_back(std::move(node.second));
+  }
+
+  return dynamic::object("nodes", std::move(nodeList))("startTime", startTime)(
+      "endTime", lastTime)("samples", std::move(sampleIds))(
+      "timeDeltas", std::move(timeDeltas));
+}
+
+} // namespace chrome
+} // namespace inspector
+} // namespace hermes
+} // namespace facebook
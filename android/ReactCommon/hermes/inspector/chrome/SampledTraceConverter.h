@@ -0,0 +1,27 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <folly/dynamic.h>
+
+namespace facebook {
+namespace hermes {
+namespace inspector {
+namespace chrome {
+
+/*
+ * makeProfile converts a trace written by
+ * HermesRuntime::dumpSampledTraceToFile (in the Chrome trace event format,
+ * with "stackFrames" and "samples") to the Profiler.Profile object that
+ * Profiler.stop returns to the client.
+ *
+ * Every stack frame becomes a node, under a synthetic "(root)" node which is
+ * always the first one. Each sample is attributed to the node of its leaf
+ * frame, and timeDeltas are in microseconds like the trace's timestamps.
+ */
+folly::dynamic makeProfile(const folly::dynamic &sampledTrace);
+
+} // namespace chrome
+} // namespace inspector
+} // namespace hermes
+} // namespace facebook
@@ -100,6 +100,35 @@ TEST(RemoteObjectsTableTest, TestReleaseObjectGroup) {
   EXPECT_EQ(ctx.table.getValue(value4)->asNumber(), 4.5);
 }
 
+TEST(RemoteObjectsTableTest, TestMaxValues) {
+  RemoteObjectsTable table(2);
+
+  std::string scope1 = table.addScope(std::make_pair(1, 1), "");
+  std::string value1 = table.addValue(jsi::Value(1.5), ConsoleObjectGroup);
+  std::string value2 = table.addValue(jsi::Value(2.5), "");
+  std::string value3 = table.addValue(jsi::Value(3.5), ConsoleObjectGroup);
+
+  EXPECT_EQ(table.getScope(scope1)->first, 1);
+  EXPECT_EQ(table.getValue(value1), nullptr);
+  EXPECT_EQ(table.getObjectGroup(value1), "");
+  EXPECT_EQ(table.getValue(value2)->asNumber(), 2.5);
+  EXPECT_EQ(table.getValue(value3)->asNumber(), 3.5);
+
+  // Many more values than the table holds.
+  for (int i = 0; i < 100; i++) {
+    table.addValue(jsi::Value(i), ConsoleObjectGroup);
+  }
+  std::string value4 = table.addValue(jsi::Value(4.5), "");
+
+  EXPECT_EQ(table.getValue(value2), nullptr);
+  EXPECT_EQ(table.getValue(value3), nullptr);
+  EXPECT_EQ(table.getValue(value4)->asNumber(), 4.5);
+
+  table.releaseObjectGroup(ConsoleObjectGroup);
+  EXPECT_EQ(table.getValue(value4)->asNumber(), 4.5);
+  EXPECT_EQ(table.getScope(scope1)->first, 1);
+}
+
 } // namespace chrome
 } // namespace inspector
 } // namespace hermes
@@ -0,0 +1,94 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <hermes/inspector/chrome/SampledTraceConverter.h>
+
+#include <folly/dynamic.h>
+#include <folly/json.h>
+#include <gtest/gtest.h>
+
+namespace facebook {
+namespace hermes {
+namespace inspector {
+namespace chrome {
+
+using folly::dynamic;
+
+TEST(SampledTraceConverterTests, testMakeProfile) {
+  dynamic trace = folly::parseJson(R"JSON({
+    "traceEvents": [],
+    "stackFrames": {
+      "1": {"name": "[root]", "category": "root"},
+      "2": {"name": "foo(1:10:5)", "line": "10", "column": "5", "parent": 1},
+      "3": {"name": "bar(1:20:1)", "line": "20", "column": "1", "parent": "2"}
+    },
+    "samples": [
+      {"cpu": "-1", "name": "", "ts": "1000", "weight": "1", "sf": "3"},
+      {"cpu": "-1", "name": "", "ts": "1250", "weight": "1", "sf": 2},
+      {"cpu": "-1", "name": "", "ts": "1300", "weight": "1", "sf": "3"}
+    ]
+  })JSON");
+
+  dynamic expected = folly::parseJson(R"JSON({
+    "nodes": [
+      {
+        "id": 4,
+        "callFrame": {"functionName": "(root)", "scriptId": "0", "url": "",
+                      "lineNumber": -1, "columnNumber": -1},
+        "hitCount": 0,
+        "children": [1]
+      },
+      {
+        "id": 1,
+        "callFrame": {"functionName": "[root]", "scriptId": "0", "url": "",
+                      "lineNumber": -1, "columnNumber": -1},
+        "hitCount": 0,
+        "children": [2]
+      },
+      {
+        "id": 2,
+        "callFrame": {"functionName": "foo", "scriptId": "0", "url": "",
+                      "lineNumber": 9, "columnNumber": 4},
+        "hitCount": 1,
+        "children": [3]
+      },
+      {
+        "id": 3,
+        "callFrame": {"functionName": "bar", "scriptId": "0", "url": "",
+                      "lineNumber": 19, "columnNumber": 0},
+        "hitCount": 2,
+        "children": []
+      }
+    ],
+    "startTime": 1000,
+    "endTime": 1300,
+    "samples": [3, 2, 3],
+    "timeDeltas": [0, 250, 50]
+  })JSON");
+
+  EXPECT_EQ(makeProfile(trace), expected);
+}
+
+TEST(SampledTraceConverterTests, testMakeProfileFromEmptyTrace) {
+  dynamic expected = folly::parseJson(R"JSON({
+    "nodes": [
+      {
+        "id": 1,
+        "callFrame": {"functionName": "(root)", "scriptId": "0", "url": "",
+                      "lineNumber": -1, "columnNumber": -1},
+        "hitCount": 0,
+        "children": []
+      }
+    ],
+    "startTime": 0,
+    "endTime": 0,
+    "samples": [],
+    "timeDeltas": []
+  })JSON");
+
+  EXPECT_EQ(makeProfile(dynamic::object()), expected);
+}
+
+} // namespace chrome
+} // namespace inspector
+} // namespace hermes
+} // namespace facebook
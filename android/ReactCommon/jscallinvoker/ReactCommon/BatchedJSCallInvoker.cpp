@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <ReactCommon/BatchedJSCallInvoker.h>
+
+namespace facebook {
+namespace react {
+
+BatchedJSCallInvoker::BatchedJSCallInvoker(
+    std::shared_ptr<JSCallInvoker> jsInvoker)
+    : jsInvoker_(std::move(jsInvoker)) {}
+
+void BatchedJSCallInvoker::invokeAsync(std::function<void()> &&func) {
+  invokeAsync(std::move(func), MessageQueuePriority::Normal);
+}
+
+void BatchedJSCallInvoker::invokeAsync(
+    std::function<void()> &&func,
+    MessageQueuePriority priority) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &batch = batches_[static_cast<size_t>(priority)];
+    batch.push_back(std::move(func));
+    if (batch.size() > 1) {
+      // The batch is already scheduled.
+      return;
+    }
+  }
+
+  scheduleBatch(priority);
+}
+
+void BatchedJSCallInvoker::scheduleBatch(MessageQueuePriority priority) {
+  std::weak_ptr<BatchedJSCallInvoker> weakThis = shared_from_this();
+  jsInvoker_->invokeAsync(
+      [weakThis, priority]() {
+        if (auto strongThis = weakThis.lock()) {
+          strongThis->runBatch(priority);
+        }
+      },
+      priority);
+}
+
+void BatchedJSCallInvoker::runBatch(MessageQueuePriority priority) {
+  Batch batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch.swap(batches_[static_cast<size_t>(priority)]);
+  }
+
+  for (size_t i = 0; i < batch.size(); i++) {
+    try {
+      batch[i]();
+    } catch (...) {
+      // The calls after the failing one run in a new batch, like they would
+      // have run in their own tasks.
+      if (i + 1 < batch.size()) {
+        Batch rest(
+            std::make_move_iterator(batch.begin() + i + 1),
+            std::make_move_iterator(batch.end()));
+        bool isScheduled;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          auto &pending = batches_[static_cast<size_t>(priority)];
+          isScheduled = !pending.empty();
+          rest.insert(
+              rest.end(),
+              std::make_move_iterator(pending.begin()),
+              std::make_move_iterator(pending.end()));
+          pending.swap(rest);
+        }
+        if (!isScheduled) {
+          scheduleBatch(priority);
+        }
+      }
+      throw;
+    }
+  }
+}
+
+} // namespace react
+} // namespace facebook
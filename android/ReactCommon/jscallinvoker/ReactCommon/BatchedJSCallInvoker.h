@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <ReactCommon/JSCallInvoker.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * A native-to-JS call invoker which batches the calls made while a batch is
+ * pending, and runs all of them in one task of another invoker. Modules which
+ * resolve many callbacks in a burst (e.g. streaming rows from a database)
+ * then schedule a single JS thread task instead of one per callback.
+ *
+ * Calls run in the order they were made, and calls with different priorities
+ * are batched separately.
+ */
+class BatchedJSCallInvoker
+    : public JSCallInvoker,
+      public std::enable_shared_from_this<BatchedJSCallInvoker> {
+ public:
+  BatchedJSCallInvoker(std::shared_ptr<JSCallInvoker> jsInvoker);
+
+  void invokeAsync(std::function<void()> &&func) override;
+  void invokeAsync(
+      std::function<void()> &&func,
+      MessageQueuePriority priority) override;
+
+ private:
+  using Batch = std::vector<std::function<void()>>;
+
+  void scheduleBatch(MessageQueuePriority priority);
+  void runBatch(MessageQueuePriority priority);
+
+  std::shared_ptr<JSCallInvoker> jsInvoker_;
+  std::mutex mutex_;
+  // One batch per MessageQueuePriority. A batch is pending while it's not
+  // empty.
+  std::array<Batch, 3> batches_;
+};
+
+} // namespace react
+} // namespace facebook
@@ -15,11 +15,17 @@ BridgeJSCallInvoker::BridgeJSCallInvoker(std::weak_ptr<Instance> reactInstance)
     : reactInstance_(reactInstance) {}
 
 void BridgeJSCallInvoker::invokeAsync(std::function<void()> &&func) {
+  invokeAsync(std::move(func), MessageQueuePriority::Normal);
+}
+
+void BridgeJSCallInvoker::invokeAsync(
+    std::function<void()> &&func,
+    MessageQueuePriority priority) {
   auto instance = reactInstance_.lock();
   if (instance == nullptr) {
     return;
   }
-  instance->invokeAsync(std::move(func));
+  instance->invokeAsync(std::move(func), priority);
 }
 
 } // namespace react
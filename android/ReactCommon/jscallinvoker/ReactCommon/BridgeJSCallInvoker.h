@@ -32,6 +32,9 @@ class BridgeJSCallInvoker : public JSCallInvoker {
   BridgeJSCallInvoker(std::weak_ptr<Instance> reactInstance);
 
   void invokeAsync(std::function<void()> &&func) override;
+  void invokeAsync(
+      std::function<void()> &&func,
+      MessageQueuePriority priority) override;
   // TODO: add sync support
 
  private:
@@ -10,6 +10,8 @@
 #include <functional>
 #include <memory>
 
+#include <cxxreact/MessageQueueThread.h>
+
 namespace facebook {
 namespace react {
 
@@ -20,6 +22,13 @@ namespace react {
 class JSCallInvoker {
  public:
   virtual void invokeAsync(std::function<void()> &&func) = 0;
+  // Calls with a higher priority run before queued calls with a lower one.
+  virtual void invokeAsync(
+      std::function<void()> &&func,
+      MessageQueuePriority priority) {
+    (void)priority;
+    invokeAsync(std::move(func));
+  }
   // TODO: add sync support
   virtual ~JSCallInvoker() {}
 };
@@ -14,6 +14,7 @@
 #include <queue>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 
 namespace facebook {
 namespace jsc {
@@ -53,6 +54,8 @@ class JSCRuntime : public jsi::Runtime {
 
   bool isInspectable() override;
 
+  bool drainMicrotasks() override;
+
   void setDescription(const std::string& desc);
 
   // Please don't use the following two functions, only exposed for
@@ -189,6 +192,19 @@ class JSCRuntime : public jsi::Runtime {
   void setValueAtIndexImpl(jsi::Array&, size_t i, const jsi::Value& value)
       override;
 
+  jsi::ArrayBuffer createArrayBuffer(
+      std::shared_ptr<jsi::MutableBuffer> buffer) override;
+  bool isTypedArray(const jsi::Object&) const override;
+  jsi::TypedArray createTypedArray(
+      jsi::TypedArrayKind kind,
+      const jsi::ArrayBuffer& buffer,
+      size_t byteOffset,
+      size_t length) override;
+  jsi::TypedArrayKind kind(const jsi::TypedArray&) override;
+  size_t size(const jsi::TypedArray&) override;
+  size_t byteOffset(const jsi::TypedArray&) override;
+  jsi::ArrayBuffer buffer(const jsi::TypedArray&) override;
+
   jsi::Function createFunctionFromHostFunction(
       const jsi::PropNameID& name,
       unsigned int paramCount,
@@ -223,6 +239,7 @@ class JSCRuntime : public jsi::Runtime {
   jsi::Symbol createSymbol(JSValueRef symbolRef) const;
   jsi::String createString(JSStringRef stringRef) const;
   jsi::PropNameID createPropNameID(JSStringRef stringRef);
+  jsi::PropNameID createInternedPropNameID(std::string&& ascii);
   jsi::Object createObject(JSObjectRef objectRef) const;
 
   // Used by factory methods and clone methods
@@ -238,6 +255,13 @@ class JSCRuntime : public jsi::Runtime {
   JSGlobalContextRef ctx_;
   std::atomic<bool> ctxInvalid_;
   std::string desc_;
+  // The same property names are created over and over again (e.g. by host
+  // objects), so ASCII names keep their (retained) JSStringRefs, which saves
+  // converting them to UTF-16 every time. Only the first
+  // kMaxInternedPropNameCount names are kept, in case a caller creates
+  // unbounded numbers of distinct names.
+  static constexpr size_t kMaxInternedPropNameCount = 1024;
+  std::unordered_map<std::string, JSStringRef> internedPropNames_;
 #ifndef NDEBUG
   mutable std::atomic<intptr_t> objectCounter_;
   mutable std::atomic<intptr_t> symbolCounter_;
@@ -351,6 +375,9 @@ JSCRuntime::~JSCRuntime() {
   // has started.
   ctxInvalid_ = true;
   JSGlobalContextRelease(ctx_);
+  for (auto& propName : internedPropNames_) {
+    JSStringRelease(propName.second);
+  }
 #ifndef NDEBUG
   assert(
       objectCounter_ == 0 && "JSCRuntime destroyed with a dangling API object");
@@ -412,6 +439,12 @@ bool JSCRuntime::isInspectable() {
   return false;
 }
 
+bool JSCRuntime::drainMicrotasks() {
+  // JSC drains its microtask queue whenever the outermost call into it
+  // returns, and has no public API to defer or trigger that.
+  return false;
+}
+
 namespace {
 
 bool smellsLikeES6Symbol(JSGlobalContextRef ctx, JSValueRef ref) {
@@ -583,17 +616,23 @@ jsi::PropNameID JSCRuntime::createPropNameIDFromAscii(
     const char* str,
     size_t length) {
   // For system JSC this must is identical to a string
-  std::string tmp(str, length);
-  JSStringRef strRef = JSStringCreateWithUTF8CString(tmp.c_str());
-  auto res = createPropNameID(strRef);
-  JSStringRelease(strRef);
-  return res;
+  return createInternedPropNameID(std::string(str, length));
 }
 
 jsi::PropNameID JSCRuntime::createPropNameIDFromUtf8(
     const uint8_t* utf8,
     size_t length) {
   std::string tmp(reinterpret_cast<const char*>(utf8), length);
+  bool isAscii = true;
+  for (size_t i = 0; i < length; i++) {
+    if (utf8[i] >= 0x80) {
+      isAscii = false;
+      break;
+    }
+  }
+  if (isAscii) {
+    return createInternedPropNameID(std::move(tmp));
+  }
   JSStringRef strRef = JSStringCreateWithUTF8CString(tmp.c_str());
   auto res = createPropNameID(strRef);
   JSStringRelease(strRef);
@@ -609,7 +648,10 @@ std::string JSCRuntime::utf8(const jsi::PropNameID& sym) {
 }
 
 bool JSCRuntime::compare(const jsi::PropNameID& a, const jsi::PropNameID& b) {
-  return JSStringIsEqual(stringRef(a), stringRef(b));
+  // Interned names are usually the same JSStringRef.
+  JSStringRef aRef = stringRef(a);
+  JSStringRef bRef = stringRef(b);
+  return aRef == bRef || JSStringIsEqual(aRef, bRef);
 }
 
 std::string JSCRuntime::symbolToString(const jsi::Symbol& sym) {
@@ -888,24 +930,120 @@ bool JSCRuntime::isArray(const jsi::Object& obj) const {
 #endif
 }
 
-bool JSCRuntime::isArrayBuffer(const jsi::Object& /*obj*/) const {
-  // TODO: T23270523 - This would fail on builds that use our custom JSC
-  // auto typedArrayType = JSValueGetTypedArrayType(ctx_, objectRef(obj),
-  // nullptr);  return typedArrayType == kJSTypedArrayTypeArrayBuffer;
-  throw std::runtime_error("Unsupported");
+// The typed array API needs a JSC which supports it, like the JSC of
+// iOS 10 and jsc-android.
+namespace {
+const JSTypedArrayType kTypedArrayTypes[] = {
+    kJSTypedArrayTypeInt8Array,
+    kJSTypedArrayTypeUint8Array,
+    kJSTypedArrayTypeUint8ClampedArray,
+    kJSTypedArrayTypeInt16Array,
+    kJSTypedArrayTypeUint16Array,
+    kJSTypedArrayTypeInt32Array,
+    kJSTypedArrayTypeUint32Array,
+    kJSTypedArrayTypeFloat32Array,
+    kJSTypedArrayTypeFloat64Array,
+};
+
+JSTypedArrayType typedArrayType(jsi::TypedArrayKind kind) {
+  return kTypedArrayTypes[static_cast<size_t>(kind)];
+}
+} // namespace
+
+bool JSCRuntime::isArrayBuffer(const jsi::Object& obj) const {
+  JSValueRef exc = nullptr;
+  auto type = JSValueGetTypedArrayType(ctx_, objectRef(obj), &exc);
+  const_cast<JSCRuntime*>(this)->checkException(exc);
+  return type == kJSTypedArrayTypeArrayBuffer;
+}
+
+uint8_t* JSCRuntime::data(const jsi::ArrayBuffer& obj) {
+  JSValueRef exc = nullptr;
+  auto data = JSObjectGetArrayBufferBytesPtr(ctx_, objectRef(obj), &exc);
+  checkException(exc);
+  return static_cast<uint8_t*>(data);
+}
+
+size_t JSCRuntime::size(const jsi::ArrayBuffer& obj) {
+  JSValueRef exc = nullptr;
+  auto size = JSObjectGetArrayBufferByteLength(ctx_, objectRef(obj), &exc);
+  checkException(exc);
+  return size;
+}
+
+jsi::ArrayBuffer JSCRuntime::createArrayBuffer(
+    std::shared_ptr<jsi::MutableBuffer> buffer) {
+  // JSC calls the deallocator once the ArrayBuffer is collected.
+  auto context = new std::shared_ptr<jsi::MutableBuffer>(buffer);
+  JSValueRef exc = nullptr;
+  JSObjectRef obj = JSObjectMakeArrayBufferWithBytesNoCopy(
+      ctx_,
+      buffer->data(),
+      buffer->size(),
+      [](void*, void* context) {
+        delete static_cast<std::shared_ptr<jsi::MutableBuffer>*>(context);
+      },
+      context,
+      &exc);
+  if (!obj) {
+    delete context;
+  }
+  checkException(obj, exc);
+  return createObject(obj).getArrayBuffer(*this);
+}
+
+bool JSCRuntime::isTypedArray(const jsi::Object& obj) const {
+  JSValueRef exc = nullptr;
+  auto type = JSValueGetTypedArrayType(ctx_, objectRef(obj), &exc);
+  const_cast<JSCRuntime*>(this)->checkException(exc);
+  return type != kJSTypedArrayTypeNone && type != kJSTypedArrayTypeArrayBuffer;
+}
+
+jsi::TypedArray JSCRuntime::createTypedArray(
+    jsi::TypedArrayKind kind,
+    const jsi::ArrayBuffer& buffer,
+    size_t byteOffset,
+    size_t length) {
+  JSValueRef exc = nullptr;
+  JSObjectRef obj = JSObjectMakeTypedArrayWithArrayBufferAndOffset(
+      ctx_, typedArrayType(kind), objectRef(buffer), byteOffset, length, &exc);
+  checkException(obj, exc);
+  return createObject(obj).getTypedArray(*this);
+}
+
+jsi::TypedArrayKind JSCRuntime::kind(const jsi::TypedArray& obj) {
+  JSValueRef exc = nullptr;
+  auto type = JSValueGetTypedArrayType(ctx_, objectRef(obj), &exc);
+  checkException(exc);
+  for (size_t i = 0; i < sizeof(kTypedArrayTypes) / sizeof(*kTypedArrayTypes);
+       i++) {
+    if (kTypedArrayTypes[i] == type) {
+      return static_cast<jsi::TypedArrayKind>(i);
+    }
+  }
+  throw jsi::JSINativeException("Object is not a TypedArray");
+}
+
+size_t JSCRuntime::size(const jsi::TypedArray& obj) {
+  JSValueRef exc = nullptr;
+  auto length = JSObjectGetTypedArrayLength(ctx_, objectRef(obj), &exc);
+  checkException(exc);
+  return length;
 }
 
-uint8_t* JSCRuntime::data(const jsi::ArrayBuffer& /*obj*/) {
-  // TODO: T23270523 - This would fail on builds that use our custom JSC
-  // return static_cast<uint8_t*>(
-  //    JSObjectGetArrayBufferBytesPtr(ctx_, objectRef(obj), nullptr));
-  throw std::runtime_error("Unsupported");
+size_t JSCRuntime::byteOffset(const jsi::TypedArray& obj) {
+  JSValueRef exc = nullptr;
+  auto byteOffset =
+      JSObjectGetTypedArrayByteOffset(ctx_, objectRef(obj), &exc);
+  checkException(exc);
+  return byteOffset;
 }
 
-size_t JSCRuntime::size(const jsi::ArrayBuffer& /*obj*/) {
-  // TODO: T23270523 - This would fail on builds that use our custom JSC
-  // return JSObjectGetArrayBufferByteLength(ctx_, objectRef(obj), nullptr);
-  throw std::runtime_error("Unsupported");
+jsi::ArrayBuffer JSCRuntime::buffer(const jsi::TypedArray& obj) {
+  JSValueRef exc = nullptr;
+  JSObjectRef buffer = JSObjectGetTypedArrayBuffer(ctx_, objectRef(obj), &exc);
+  checkException(buffer, exc);
+  return createObject(buffer).getArrayBuffer(*this);
 }
 
 bool JSCRuntime::isFunction(const jsi::Object& obj) const {
@@ -1295,6 +1433,23 @@ jsi::PropNameID JSCRuntime::createPropNameID(JSStringRef str) {
   return make<jsi::PropNameID>(makeStringValue(str));
 }
 
+jsi::PropNameID JSCRuntime::createInternedPropNameID(std::string&& ascii) {
+  auto it = internedPropNames_.find(ascii);
+  if (it != internedPropNames_.end()) {
+    return createPropNameID(it->second);
+  }
+
+  JSStringRef strRef = JSStringCreateWithUTF8CString(ascii.c_str());
+  auto res = createPropNameID(strRef);
+  if (internedPropNames_.size() < kMaxInternedPropNameCount) {
+    // The map takes over the reference from JSStringCreateWithUTF8CString.
+    internedPropNames_.emplace(std::move(ascii), strRef);
+  } else {
+    JSStringRelease(strRef);
+  }
+  return res;
+}
+
 jsi::Runtime::PointerValue* JSCRuntime::makeObjectValue(
     JSObjectRef objectRef) const {
   if (!objectRef) {
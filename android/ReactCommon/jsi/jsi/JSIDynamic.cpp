@@ -6,6 +6,11 @@
  */
 #include "JSIDynamic.h"
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include <glog/logging.h>
 
 #include <folly/dynamic.h>
@@ -16,17 +21,18 @@ using namespace facebook::jsi;
 namespace facebook {
 namespace jsi {
 
-Value valueFromDynamic(Runtime& runtime, const folly::dynamic& dyn) {
+namespace {
+
+// Both conversions walk containers with an explicit stack instead of
+// recursing, so deeply nested payloads can't overflow the native stack, and
+// keep what's reusable between the objects of one conversion: arrays of
+// objects (rows, list items, props of children...) usually repeat the same
+// keys in the same order.
+
+Value valueFromScalar(Runtime& runtime, const folly::dynamic& dyn) {
   switch (dyn.type()) {
     case folly::dynamic::NULLT:
       return Value::null();
-    case folly::dynamic::ARRAY: {
-      Array ret = Array(runtime, dyn.size());
-      for (size_t i = 0; i < dyn.size(); ++i) {
-        ret.setValueAtIndex(runtime, i, valueFromDynamic(runtime, dyn[i]));
-      }
-      return std::move(ret);
-    }
     case folly::dynamic::BOOL:
       return dyn.getBool();
     case folly::dynamic::DOUBLE:
@@ -36,67 +42,274 @@ Value valueFromDynamic(Runtime& runtime, const folly::dynamic& dyn) {
       // represented precisely as a double, folly will throw an
       // exception.
       return (double)dyn.getInt();
-    case folly::dynamic::OBJECT: {
-      Object ret(runtime);
-      for (const auto& element : dyn.items()) {
-        Value value = valueFromDynamic(runtime, element.second);
-        if (element.first.isNumber() || element.first.isString()) {
-          ret.setProperty(
-              runtime,
-              PropNameID::forUtf8(runtime, element.first.asString()),
-              value);
-        }
-      }
-      return std::move(ret);
-    }
     case folly::dynamic::STRING:
       return String::createFromUtf8(runtime, dyn.getString());
+    case folly::dynamic::ARRAY:
+    case folly::dynamic::OBJECT:
+      break;
   }
   CHECK(false);
 }
 
-folly::dynamic dynamicFromValue(Runtime& runtime, const Value& value) {
-  if (value.isUndefined() || value.isNull()) {
-    return nullptr;
-  } else if (value.isBool()) {
-    return value.getBool();
-  } else if (value.isNumber()) {
-    return value.getNumber();
-  } else if (value.isString()) {
-    return value.getString(runtime).utf8(runtime);
-  } else {
-    Object obj = value.getObject(runtime);
-    if (obj.isArray(runtime)) {
-      Array array = obj.getArray(runtime);
-      folly::dynamic ret = folly::dynamic::array();
-      for (size_t i = 0; i < array.size(runtime); ++i) {
-        ret.push_back(
-            dynamicFromValue(runtime, array.getValueAtIndex(runtime, i)));
+struct ArrayFromDynamic {
+  Array array;
+  const folly::dynamic* dyn;
+  size_t index;
+};
+
+struct ObjectFromDynamic {
+  Object object;
+  folly::dynamic::const_item_iterator item;
+  folly::dynamic::const_item_iterator end;
+};
+
+class ValueFromDynamicConverter {
+ public:
+  explicit ValueFromDynamicConverter(Runtime& runtime) : runtime_(runtime) {}
+
+  Value convert(const folly::dynamic& dyn) {
+    if (!dyn.isArray() && !dyn.isObject()) {
+      return valueFromScalar(runtime_, dyn);
+    }
+    Value result;
+    begin(dyn, [&](const Object& child) { result = Value(runtime_, child); });
+    while (!isArray_.empty()) {
+      if (isArray_.back()) {
+        auto& frame = arrays_.back();
+        if (frame.index == frame.dyn->size()) {
+          arrays_.pop_back();
+          isArray_.pop_back();
+          continue;
+        }
+        size_t index = frame.index++;
+        const folly::dynamic& element = (*frame.dyn)[index];
+        if (element.isArray() || element.isObject()) {
+          begin(element, [&](const Object& child) {
+            frame.array.setValueAtIndex(runtime_, index, Value(runtime_, child));
+          });
+        } else {
+          frame.array.setValueAtIndex(
+              runtime_, index, valueFromScalar(runtime_, element));
+        }
+      } else {
+        auto& frame = objects_.back();
+        if (frame.item == frame.end) {
+          objects_.pop_back();
+          isArray_.pop_back();
+          continue;
+        }
+        const auto& element = *frame.item++;
+        if (!element.first.isNumber() && !element.first.isString()) {
+          continue;
+        }
+        const PropNameID& name = propName(element.first);
+        if (element.second.isArray() || element.second.isObject()) {
+          begin(element.second, [&](const Object& child) {
+            frame.object.setProperty(runtime_, name, Value(runtime_, child));
+          });
+        } else {
+          frame.object.setProperty(
+              runtime_, name, valueFromScalar(runtime_, element.second));
+        }
       }
-      return ret;
-    } else if (obj.isFunction(runtime)) {
-      throw JSError(runtime, "JS Functions are not convertible to dynamic");
+    }
+    return result;
+  }
+
+ private:
+  // Makes the empty array or object for `dyn`, hands it to `attach` to be
+  // put into its parent (before the frame of the parent can move), and pushes
+  // the frame filling it.
+  template <typename F>
+  void begin(const folly::dynamic& dyn, F&& attach) {
+    if (dyn.isArray()) {
+      Array array(runtime_, dyn.size());
+      attach(array);
+      arrays_.push_back(ArrayFromDynamic{std::move(array), &dyn, 0});
+      isArray_.push_back(true);
     } else {
-      folly::dynamic ret = folly::dynamic::object();
-      Array names = obj.getPropertyNames(runtime);
-      for (size_t i = 0; i < names.size(runtime); ++i) {
-        String name = names.getValueAtIndex(runtime, i).getString(runtime);
-        Value prop = obj.getProperty(runtime, name);
-        if (prop.isUndefined()) {
+      Object object(runtime_);
+      attach(object);
+      auto items = dyn.items();
+      objects_.push_back(
+          ObjectFromDynamic{std::move(object), items.begin(), items.end()});
+      isArray_.push_back(false);
+    }
+  }
+
+  const PropNameID& propName(const folly::dynamic& key) {
+    if (!key.isString()) {
+      scratchName_ = std::make_unique<PropNameID>(
+          PropNameID::forUtf8(runtime_, key.asString()));
+      return *scratchName_;
+    }
+    const std::string& string = key.getString();
+    auto it = propNames_.find(string);
+    if (it != propNames_.end()) {
+      return it->second;
+    }
+    auto name = PropNameID::forUtf8(runtime_, string);
+    if (propNames_.size() >= kMaxCachedPropNames) {
+      scratchName_ = std::make_unique<PropNameID>(std::move(name));
+      return *scratchName_;
+    }
+    return propNames_.emplace(string, std::move(name)).first->second;
+  }
+
+  // Enough for the keys of typical payloads, not for maps keyed by ids.
+  static constexpr size_t kMaxCachedPropNames = 256;
+
+  Runtime& runtime_;
+  std::vector<ArrayFromDynamic> arrays_;
+  std::vector<ObjectFromDynamic> objects_;
+  // Whether each open container, innermost last, is an array or an object.
+  std::vector<bool> isArray_;
+  std::unordered_map<std::string, PropNameID> propNames_;
+  std::unique_ptr<PropNameID> scratchName_;
+};
+
+} // namespace
+
+Value valueFromDynamic(Runtime& runtime, const folly::dynamic& dyn) {
+  return ValueFromDynamicConverter(runtime).convert(dyn);
+}
+
+namespace {
+
+struct DynamicFromContainer {
+  // The object converted, and its elements for an array or its property
+  // names otherwise.
+  Object object;
+  Array elements;
+  size_t index;
+  size_t size;
+  bool isArray;
+  folly::dynamic* out;
+};
+
+// A property name seen at some index of an object, with its std::string.
+struct CachedPropName {
+  String jsName;
+  std::string name;
+};
+
+class DynamicFromValueConverter {
+ public:
+  explicit DynamicFromValueConverter(Runtime& runtime) : runtime_(runtime) {}
+
+  folly::dynamic convert(const Value& value) {
+    folly::dynamic result;
+    if (!value.isObject()) {
+      result = scalar(value);
+      return result;
+    }
+    begin(value.getObject(runtime_), result);
+    while (!stack_.empty()) {
+      auto& frame = stack_.back();
+      if (frame.index == frame.size) {
+        stack_.pop_back();
+        continue;
+      }
+      size_t index = frame.index++;
+      folly::dynamic* out;
+      Value child;
+      if (frame.isArray) {
+        out = &(*frame.out)[index];
+        child = frame.elements.getValueAtIndex(runtime_, index);
+      } else {
+        String jsName =
+            frame.elements.getValueAtIndex(runtime_, index).getString(runtime_);
+        child = frame.object.getProperty(runtime_, jsName);
+        if (child.isUndefined()) {
           continue;
         }
         // The JSC conversion uses JSON.stringify, which substitutes
         // null for a function, so we do the same here.  Just dropping
         // the pair might also work, but would require more testing.
-        if (prop.isObject() && prop.getObject(runtime).isFunction(runtime)) {
-          prop = Value::null();
+        if (child.isObject() && child.getObject(runtime_).isFunction(runtime_)) {
+          child = Value::null();
         }
-        ret.insert(
-            name.utf8(runtime), dynamicFromValue(runtime, std::move(prop)));
+        out = &(*frame.out)[propName(std::move(jsName), index)];
+      }
+      if (child.isObject()) {
+        // Invalidates `frame`
+        begin(child.getObject(runtime_), *out);
+      } else {
+        *out = scalar(child);
       }
-      return ret;
     }
+    return result;
+  }
+
+ private:
+  folly::dynamic scalar(const Value& value) {
+    if (value.isBool()) {
+      return value.getBool();
+    } else if (value.isNumber()) {
+      return value.getNumber();
+    } else if (value.isString()) {
+      return value.getString(runtime_).utf8(runtime_);
+    }
+    return nullptr;
+  }
+
+  // Pushes the frame converting `object` into `out`. Elements and values are
+  // written in place, which is safe as neither the (pre-sized) arrays nor the
+  // node-based maps of folly::dynamic move them while they're filled.
+  void begin(Object object, folly::dynamic& out) {
+    if (object.isArray(runtime_)) {
+      Array array = object.getArray(runtime_);
+      size_t size = array.size(runtime_);
+      out = folly::dynamic::array();
+      out.resize(size);
+      stack_.push_back(DynamicFromContainer{
+          std::move(object), std::move(array), 0, size, true, &out});
+    } else if (object.isFunction(runtime_)) {
+      throw JSError(runtime_, "JS Functions are not convertible to dynamic");
+    } else {
+      Array names = object.getPropertyNames(runtime_);
+      size_t size = names.size(runtime_);
+      out = folly::dynamic::object();
+      stack_.push_back(DynamicFromContainer{
+          std::move(object), std::move(names), 0, size, false, &out});
+    }
+  }
+
+  // The std::string of the name at `index` of an object at the current depth,
+  // reused from the last object there when it has the same name at the same
+  // index, as comparing engine strings is cheaper than converting them.
+  const std::string& propName(String jsName, size_t index) {
+    size_t depth = stack_.size() - 1;
+    if (depth >= propNames_.size()) {
+      propNames_.resize(depth + 1);
+    }
+    auto& names = propNames_[depth];
+    if (index < names.size() &&
+        String::strictEquals(runtime_, names[index].jsName, jsName)) {
+      return names[index].name;
+    }
+    std::string name = jsName.utf8(runtime_);
+    if (index < names.size()) {
+      names[index] = CachedPropName{std::move(jsName), std::move(name)};
+    } else if (index == names.size()) {
+      names.push_back(CachedPropName{std::move(jsName), std::move(name)});
+    } else {
+      scratchName_ = std::move(name);
+      return scratchName_;
+    }
+    return names[index].name;
   }
+
+  Runtime& runtime_;
+  std::vector<DynamicFromContainer> stack_;
+  std::vector<std::vector<CachedPropName>> propNames_;
+  std::string scratchName_;
+};
+
+} // namespace
+
+folly::dynamic dynamicFromValue(Runtime& runtime, const Value& value) {
+  return DynamicFromValueConverter(runtime).convert(value);
 }
 
 } // namespace jsi
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <jsi/jsi.h>
+
+namespace facebook {
+namespace jsi {
+
+// Identifies a script: where it was loaded from, and a version (e.g. a hash
+// of its contents) which changes whenever the script does.
+struct ScriptSignature {
+  std::string url;
+  uint64_t version;
+};
+
+// Identifies the runtime which prepared a script, as prepared scripts can
+// only be run by the runtime (and version of it) which prepared them.
+struct JSRuntimeSignature {
+  std::string runtimeName;
+  uint64_t version;
+};
+
+// Persistent storage of prepared scripts (e.g. bytecode), so a script only
+// has to be prepared once and not on every launch. prepareTag tells apart the
+// different preparations of the same script by the same runtime (e.g. with
+// different compiler settings).
+class PreparedScriptStore {
+ public:
+  virtual ~PreparedScriptStore() = default;
+
+  // Returns the prepared script which was persisted for the given script,
+  // runtime and tag, or nullptr if there is none.
+  virtual std::shared_ptr<const Buffer> tryGetPreparedScript(
+      const ScriptSignature& scriptSignature,
+      const JSRuntimeSignature& runtimeSignature,
+      const char* prepareTag) noexcept = 0;
+
+  // Persists a prepared script. Failures are ignored: the script is just
+  // prepared again next time.
+  virtual void persistPreparedScript(
+      std::shared_ptr<const Buffer> preparedScript,
+      const ScriptSignature& scriptSignature,
+      const JSRuntimeSignature& runtimeSignature,
+      const char* prepareTag) noexcept = 0;
+};
+
+} // namespace jsi
+} // namespace facebook
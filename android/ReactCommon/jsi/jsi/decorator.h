@@ -137,6 +137,9 @@ class RuntimeDecorator : public Base, private jsi::Instrumentation {
   Instrumentation& instrumentation() override {
     return *this;
   }
+  bool drainMicrotasks() override {
+    return plain().drainMicrotasks();
+  }
 
  protected:
   // plain is generally going to be a reference to an object managed
@@ -278,6 +281,33 @@ class RuntimeDecorator : public Base, private jsi::Instrumentation {
     plain_.setValueAtIndexImpl(a, i, value);
   };
 
+  ArrayBuffer createArrayBuffer(
+      std::shared_ptr<MutableBuffer> buffer) override {
+    return plain_.createArrayBuffer(std::move(buffer));
+  };
+  bool isTypedArray(const Object& o) const override {
+    return plain_.isTypedArray(o);
+  };
+  TypedArray createTypedArray(
+      TypedArrayKind kind,
+      const ArrayBuffer& buffer,
+      size_t byteOffset,
+      size_t length) override {
+    return plain_.createTypedArray(kind, buffer, byteOffset, length);
+  };
+  TypedArrayKind kind(const TypedArray& ta) override {
+    return plain_.kind(ta);
+  };
+  size_t size(const TypedArray& ta) override {
+    return plain_.size(ta);
+  };
+  size_t byteOffset(const TypedArray& ta) override {
+    return plain_.byteOffset(ta);
+  };
+  ArrayBuffer buffer(const TypedArray& ta) override {
+    return plain_.buffer(ta);
+  };
+
   Function createFunctionFromHostFunction(
       const PropNameID& name,
       unsigned int paramCount,
@@ -341,6 +371,14 @@ class RuntimeDecorator : public Base, private jsi::Instrumentation {
     return plain().instrumentation().createSnapshotToStream(os, compact);
   }
 
+  bool startHeapSampling(size_t samplingInterval) override {
+    return plain().instrumentation().startHeapSampling(samplingInterval);
+  }
+
+  bool stopHeapSampling(std::ostream& os) override {
+    return plain().instrumentation().stopHeapSampling(os);
+  }
+
   void writeBridgeTrafficTraceToFile(
       const std::string& fileName) const override {
     const_cast<Plain&>(plain()).instrumentation().writeBridgeTrafficTraceToFile(
@@ -451,6 +489,10 @@ class WithRuntimeDecorator : public RuntimeDecorator<Plain, Base> {
     Around around{with_};
     return RD::instrumentation();
   }
+  bool drainMicrotasks() override {
+    Around around{with_};
+    return RD::drainMicrotasks();
+  }
 
  protected:
   Runtime::PointerValue* cloneSymbol(const Runtime::PointerValue* pv) override {
@@ -615,6 +657,40 @@ class WithRuntimeDecorator : public RuntimeDecorator<Plain, Base> {
     RD::setValueAtIndexImpl(a, i, value);
   };
 
+  ArrayBuffer createArrayBuffer(
+      std::shared_ptr<MutableBuffer> buffer) override {
+    Around around{with_};
+    return RD::createArrayBuffer(std::move(buffer));
+  };
+  bool isTypedArray(const Object& o) const override {
+    Around around{with_};
+    return RD::isTypedArray(o);
+  };
+  TypedArray createTypedArray(
+      TypedArrayKind kind,
+      const ArrayBuffer& buffer,
+      size_t byteOffset,
+      size_t length) override {
+    Around around{with_};
+    return RD::createTypedArray(kind, buffer, byteOffset, length);
+  };
+  TypedArrayKind kind(const TypedArray& ta) override {
+    Around around{with_};
+    return RD::kind(ta);
+  };
+  size_t size(const TypedArray& ta) override {
+    Around around{with_};
+    return RD::size(ta);
+  };
+  size_t byteOffset(const TypedArray& ta) override {
+    Around around{with_};
+    return RD::byteOffset(ta);
+  };
+  ArrayBuffer buffer(const TypedArray& ta) override {
+    Around around{with_};
+    return RD::buffer(ta);
+  };
+
   Function createFunctionFromHostFunction(
       const PropNameID& name,
       unsigned int paramCount,
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include <jsi/hostcalltracing.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <typeinfo>
+#include <vector>
+
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+
+namespace facebook {
+namespace jsi {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string demangledTypeName(const HostObject& ho) {
+  const char* name = typeid(ho).name();
+#ifdef __GNUC__
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  if (status == 0 && demangled) {
+    std::string result(demangled);
+    std::free(demangled);
+    return result;
+  }
+#endif
+  return name;
+}
+
+void appendJSONString(std::string& out, const std::string& s) {
+  out += '"';
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[7];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+// Records the time until it goes out of scope, even if the call throws.
+class ScopedHostCall {
+ public:
+  ScopedHostCall(HostCallStatsCollector& collector, HostCallStats* stats)
+      : collector_(collector), stats_(stats), start_(Clock::now()) {}
+
+  ~ScopedHostCall() {
+    collector_.record(stats_, Clock::now() - start_);
+  }
+
+ private:
+  HostCallStatsCollector& collector_;
+  HostCallStats* stats_;
+  Clock::time_point start_;
+};
+
+} // namespace
+
+constexpr size_t HostCallStats::kBucketCount;
+
+void HostCallStats::record(std::chrono::nanoseconds duration) {
+  const uint64_t nanos = static_cast<uint64_t>(duration.count());
+  ++count;
+  totalNanos += nanos;
+  maxNanos = std::max(maxNanos, nanos);
+
+  uint64_t micros = nanos / 1000;
+  size_t bucket = 0;
+  while (micros != 0 && bucket < kBucketCount - 1) {
+    micros >>= 1;
+    ++bucket;
+  }
+  ++histogram[bucket];
+}
+
+HostCallStats* HostCallStatsCollector::statsFor(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Elements of an unordered_map are never moved, and reset() does not
+  // remove them.
+  return &stats_[name];
+}
+
+void HostCallStatsCollector::record(
+    HostCallStats* stats,
+    std::chrono::nanoseconds duration) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats->record(duration);
+}
+
+std::unordered_map<std::string, HostCallStats>
+HostCallStatsCollector::snapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unordered_map<std::string, HostCallStats> result;
+  for (const auto& entry : stats_) {
+    if (entry.second.count != 0) {
+      result.emplace(entry.first, entry.second);
+    }
+  }
+  return result;
+}
+
+void HostCallStatsCollector::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : stats_) {
+    entry.second = HostCallStats{};
+  }
+}
+
+std::string HostCallStatsCollector::toJSON() const {
+  auto stats = snapshot();
+  std::vector<const std::pair<const std::string, HostCallStats>*> sorted;
+  sorted.reserve(stats.size());
+  for (const auto& entry : stats) {
+    sorted.push_back(&entry);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) {
+    return a->second.totalNanos > b->second.totalNanos;
+  });
+
+  std::string out = "[";
+  for (const auto* entry : sorted) {
+    const HostCallStats& s = entry->second;
+    if (out.size() > 1) {
+      out += ',';
+    }
+    out += "{\"name\":";
+    appendJSONString(out, entry->first);
+    out += ",\"count\":" + std::to_string(s.count);
+    out += ",\"totalNanos\":" + std::to_string(s.totalNanos);
+    out += ",\"maxNanos\":" + std::to_string(s.maxNanos);
+    out += ",\"histogram\":[";
+    for (size_t i = 0; i < s.histogram.size(); ++i) {
+      if (i != 0) {
+        out += ',';
+      }
+      out += std::to_string(s.histogram[i]);
+    }
+    out += "]}";
+  }
+  out += ']';
+  return out;
+}
+
+class HostCallTracingRuntime::TracedHostFunction {
+ public:
+  TracedHostFunction(
+      HostCallStatsCollector& collector,
+      HostCallStats* stats,
+      HostFunctionType func)
+      : collector_(collector), stats_(stats), func_(std::move(func)) {}
+
+  Value operator()(
+      Runtime& rt,
+      const Value& thisVal,
+      const Value* args,
+      size_t count) {
+    ScopedHostCall call(collector_, stats_);
+    return func_(rt, thisVal, args, count);
+  }
+
+ private:
+  friend class HostCallTracingRuntime;
+
+  HostCallStatsCollector& collector_;
+  HostCallStats* stats_;
+  HostFunctionType func_;
+};
+
+class HostCallTracingRuntime::TracedHostObject : public HostObject {
+ public:
+  TracedHostObject(
+      HostCallTracingRuntime& rt,
+      std::shared_ptr<HostObject> ho,
+      std::string name)
+      : rt_(rt),
+        ho_(std::move(ho)),
+        name_(std::move(name)),
+        getPropertyNamesStats_(
+            rt.collector_->statsFor(name_ + " [getPropertyNames]")) {}
+
+  Value get(Runtime& rt, const PropNameID& name) override {
+    ScopedHostCall call(*rt_.collector_, statsFor(rt, name, " [get]"));
+    // Host functions created by the getter are named after this object.
+    const std::string* previousName = rt_.currentHostObjectName_;
+    rt_.currentHostObjectName_ = &name_;
+    struct Restore {
+      HostCallTracingRuntime& rt;
+      const std::string* name;
+      ~Restore() {
+        rt.currentHostObjectName_ = name;
+      }
+    } restore{rt_, previousName};
+    return ho_->get(rt, name);
+  }
+
+  void set(Runtime& rt, const PropNameID& name, const Value& value) override {
+    ScopedHostCall call(*rt_.collector_, statsFor(rt, name, " [set]"));
+    ho_->set(rt, name, value);
+  }
+
+  std::vector<PropNameID> getPropertyNames(Runtime& rt) override {
+    ScopedHostCall call(*rt_.collector_, getPropertyNamesStats_);
+    return ho_->getPropertyNames(rt);
+  }
+
+ private:
+  friend class HostCallTracingRuntime;
+
+  HostCallStats*
+  statsFor(Runtime& rt, const PropNameID& name, const char* kind) {
+    return rt_.collector_->statsFor(name_ + "." + name.utf8(rt) + kind);
+  }
+
+  HostCallTracingRuntime& rt_;
+  std::shared_ptr<HostObject> ho_;
+  const std::string name_;
+  HostCallStats* getPropertyNamesStats_;
+};
+
+HostCallTracingRuntime::HostCallTracingRuntime(
+    std::unique_ptr<Runtime> plain,
+    std::shared_ptr<HostCallStatsCollector> collector,
+    HostObjectNamer namer)
+    : RuntimeDecorator<Runtime>(*plain),
+      runtime_(std::move(plain)),
+      collector_(std::move(collector)),
+      namer_(std::move(namer)) {
+  if (!namer_) {
+    namer_ = demangledTypeName;
+  }
+}
+
+Object HostCallTracingRuntime::createObject(std::shared_ptr<HostObject> ho) {
+  std::string name = namer_(*ho);
+  return RuntimeDecorator<Runtime>::createObject(
+      std::make_shared<TracedHostObject>(*this, std::move(ho), std::move(name)));
+}
+
+std::shared_ptr<HostObject> HostCallTracingRuntime::getHostObject(
+    const jsi::Object& o) {
+  std::shared_ptr<HostObject> tho = RuntimeDecorator<Runtime>::getHostObject(o);
+  return static_cast<TracedHostObject&>(*tho).ho_;
+}
+
+HostFunctionType& HostCallTracingRuntime::getHostFunction(
+    const jsi::Function& f) {
+  HostFunctionType& thf = RuntimeDecorator<Runtime>::getHostFunction(f);
+  return thf.target<TracedHostFunction>()->func_;
+}
+
+Function HostCallTracingRuntime::createFunctionFromHostFunction(
+    const PropNameID& name,
+    unsigned int paramCount,
+    HostFunctionType func) {
+  std::string statsName = name.utf8(*this);
+  if (currentHostObjectName_) {
+    statsName = *currentHostObjectName_ + "." + statsName;
+  }
+  return RuntimeDecorator<Runtime>::createFunctionFromHostFunction(
+      name,
+      paramCount,
+      TracedHostFunction(
+          *collector_, collector_->statsFor(statsName), std::move(func)));
+}
+
+} // namespace jsi
+} // namespace facebook
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <jsi/decorator.h>
+#include <jsi/jsi.h>
+
+namespace facebook {
+namespace jsi {
+
+/// Number of calls and time spent in one host function or host object
+/// method.  Times include everything the call did, including nested calls
+/// back into JS and into other host functions.
+struct HostCallStats {
+  /// Bucket i counts the calls which took less than 2^i microseconds (and at
+  /// least 2^(i-1)); the last bucket also counts all longer calls.
+  static constexpr size_t kBucketCount = 20;
+
+  uint64_t count{0};
+  uint64_t totalNanos{0};
+  uint64_t maxNanos{0};
+  std::array<uint64_t, kBucketCount> histogram{};
+
+  void record(std::chrono::nanoseconds duration);
+};
+
+/// Collects HostCallStats by name.  Calls are recorded on the JS thread, and
+/// the results can be read or reset from any thread.
+class HostCallStatsCollector {
+ public:
+  /// Returns the stats of \p name, which stay valid (but may be reset) for
+  /// the lifetime of the collector.  Must be passed to record().
+  HostCallStats* statsFor(const std::string& name);
+  void record(HostCallStats* stats, std::chrono::nanoseconds duration);
+
+  std::unordered_map<std::string, HostCallStats> snapshot() const;
+  void reset();
+
+  /// The stats as a JSON array of objects with the name, count, totalNanos,
+  /// maxNanos and histogram of each host call, sorted by decreasing total
+  /// time.
+  std::string toJSON() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, HostCallStats> stats_;
+};
+
+/// A decorator which measures how long each call into a HostFunction or
+/// HostObject created through it takes, and records it in a
+/// HostCallStatsCollector.
+///
+/// Host functions are recorded under their name.  Host functions created
+/// while a host object property is read (as TurboModules and
+/// UIManagerBinding do for their methods) are recorded under the name of the
+/// object and their own, e.g. "NativeModule.getConstants".  Host object
+/// property accesses are recorded as "<object>.<property> [get]" and
+/// "<object>.<property> [set]".  Objects are named by the HostObjectNamer,
+/// which defaults to the demangled type of the host object.
+class HostCallTracingRuntime : public RuntimeDecorator<Runtime> {
+ public:
+  using HostObjectNamer = std::function<std::string(const HostObject&)>;
+
+  HostCallTracingRuntime(
+      std::unique_ptr<Runtime> plain,
+      std::shared_ptr<HostCallStatsCollector> collector,
+      HostObjectNamer namer = nullptr);
+
+  const std::shared_ptr<HostCallStatsCollector>& collector() const {
+    return collector_;
+  }
+
+  Object createObject(std::shared_ptr<HostObject> ho) override;
+  std::shared_ptr<HostObject> getHostObject(const jsi::Object& o) override;
+  HostFunctionType& getHostFunction(const jsi::Function& f) override;
+
+  Function createFunctionFromHostFunction(
+      const PropNameID& name,
+      unsigned int paramCount,
+      HostFunctionType func) override;
+
+ private:
+  class TracedHostFunction;
+  class TracedHostObject;
+
+  std::unique_ptr<Runtime> runtime_;
+  std::shared_ptr<HostCallStatsCollector> collector_;
+  HostObjectNamer namer_;
+  // The name of the host object whose property is being read, if any.
+  const std::string* currentHostObjectName_{nullptr};
+};
+
+} // namespace jsi
+} // namespace facebook
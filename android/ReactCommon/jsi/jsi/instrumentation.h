@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <iosfwd>
 #include <string>
 
@@ -65,6 +66,21 @@ class Instrumentation {
   /// \return true iff the heap capture succeeded.
   virtual bool createSnapshotToStream(std::ostream& os, bool compact) = 0;
 
+  /// Starts recording a sample of the allocations and the JS stack trace
+  /// which made each of them, about one allocation every \p samplingInterval
+  /// bytes.  This is cheap enough to leave on for a long time.
+  ///
+  /// \return true iff the runtime supports heap sampling.
+  virtual bool startHeapSampling(size_t samplingInterval);
+
+  /// Stops recording allocations, and writes the sampled allocations which
+  /// are still alive to an output stream, as a Chrome heap profile.
+  ///
+  /// \param os output stream to write to.
+  ///
+  /// \return true iff heap sampling was started and the profile was written.
+  virtual bool stopHeapSampling(std::ostream& os);
+
   /// Write a trace of bridge traffic to the given file name.
   virtual void writeBridgeTrafficTraceToFile(
       const std::string& fileName) const = 0;
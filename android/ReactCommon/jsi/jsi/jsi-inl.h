@@ -146,6 +146,20 @@ inline ArrayBuffer Object::getArrayBuffer(Runtime& runtime) && {
   return ArrayBuffer(value);
 }
 
+inline TypedArray Object::getTypedArray(Runtime& runtime) const& {
+  assert(runtime.isTypedArray(*this));
+  (void)runtime; // when assert is disabled we need to mark this as used
+  return TypedArray(runtime.cloneObject(ptr_));
+}
+
+inline TypedArray Object::getTypedArray(Runtime& runtime) && {
+  assert(runtime.isTypedArray(*this));
+  (void)runtime; // when assert is disabled we need to mark this as used
+  Runtime::PointerValue* value = ptr_;
+  ptr_ = nullptr;
+  return TypedArray(value);
+}
+
 inline Function Object::getFunction(Runtime& runtime) const& {
   assert(runtime.isFunction(*this));
   return Function(runtime.cloneObject(ptr_));
@@ -48,6 +48,8 @@ void throwJSError(Runtime& rt, const char* msg) {
 
 Buffer::~Buffer() = default;
 
+MutableBuffer::~MutableBuffer() = default;
+
 PreparedJavaScript::~PreparedJavaScript() = default;
 
 Value HostObject::get(Runtime&, const PropNameID&) {
@@ -65,6 +67,47 @@ HostObject::~HostObject() {}
 
 Runtime::~Runtime() {}
 
+ArrayBuffer Runtime::createArrayBuffer(std::shared_ptr<MutableBuffer>) {
+  throw JSINativeException("createArrayBuffer not implemented");
+}
+
+bool Runtime::isTypedArray(const Object&) const {
+  return false;
+}
+
+TypedArray
+Runtime::createTypedArray(TypedArrayKind, const ArrayBuffer&, size_t, size_t) {
+  throw JSINativeException("createTypedArray not implemented");
+}
+
+TypedArrayKind Runtime::kind(const TypedArray&) {
+  throw JSINativeException("TypedArray kind not implemented");
+}
+
+size_t Runtime::size(const TypedArray&) {
+  throw JSINativeException("TypedArray size not implemented");
+}
+
+size_t Runtime::byteOffset(const TypedArray&) {
+  throw JSINativeException("TypedArray byteOffset not implemented");
+}
+
+ArrayBuffer Runtime::buffer(const TypedArray&) {
+  throw JSINativeException("TypedArray buffer not implemented");
+}
+
+bool Instrumentation::startHeapSampling(size_t) {
+  return false;
+}
+
+bool Instrumentation::stopHeapSampling(std::ostream&) {
+  return false;
+}
+
+bool Runtime::drainMicrotasks() {
+  return false;
+}
+
 Instrumentation& Runtime::instrumentation() {
   class NoInstrumentation : public Instrumentation {
     std::string getRecordedGCStats() override {
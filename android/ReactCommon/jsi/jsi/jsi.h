@@ -51,6 +51,16 @@ class StringBuffer : public Buffer {
   std::string s_;
 };
 
+/// Native memory which JS can read and write through an ArrayBuffer created
+/// with ArrayBuffer(Runtime&, std::shared_ptr<MutableBuffer>). The buffer is
+/// released once the runtime no longer needs it, which may be on any thread.
+class JSI_EXPORT MutableBuffer {
+ public:
+  virtual ~MutableBuffer();
+  virtual size_t size() const = 0;
+  virtual uint8_t* data() = 0;
+};
+
 /// PreparedJavaScript is a base class representing JavaScript which is in a form
 /// optimized for execution, in a runtime-specific way. Construct one via
 /// jsi::Runtime::prepareJavaScript().
@@ -72,6 +82,7 @@ class Object;
 class WeakObject;
 class Array;
 class ArrayBuffer;
+class TypedArray;
 class Function;
 class Value;
 class Instrumentation;
@@ -79,6 +90,19 @@ class Scope;
 class JSIException;
 class JSError;
 
+/// The kinds of TypedArrays.
+enum class TypedArrayKind {
+  Int8Array,
+  Uint8Array,
+  Uint8ClampedArray,
+  Int16Array,
+  Uint16Array,
+  Int32Array,
+  Uint32Array,
+  Float32Array,
+  Float64Array,
+};
+
 /// A function which has this type can be registered as a function
 /// callable from JavaScript using Function::createFromHostFunction().
 /// When the function is called, args will point to the arguments, and
@@ -205,6 +229,16 @@ class Runtime {
   /// which returns no metrics.
   virtual Instrumentation& instrumentation();
 
+  /// Runs the jobs (e.g. promise reactions) in the runtime's microtask queue,
+  /// for runtimes which leave it to the host to decide when that happens.
+  /// Hosts call this once at the end of a batch of calls, so that all the
+  /// promises which were resolved during the batch share one checkpoint.
+  ///
+  /// \return whether any job was run.  The default implementation, for
+  /// runtimes which drain the queue on their own, runs nothing and returns
+  /// false.
+  virtual bool drainMicrotasks();
+
  protected:
   friend class Pointer;
   friend class PropNameID;
@@ -214,6 +248,7 @@ class Runtime {
   friend class WeakObject;
   friend class Array;
   friend class ArrayBuffer;
+  friend class TypedArray;
   friend class Function;
   friend class Value;
   friend class Scope;
@@ -283,6 +318,21 @@ class Runtime {
   virtual Value getValueAtIndex(const Array&, size_t i) = 0;
   virtual void setValueAtIndexImpl(Array&, size_t i, const Value& value) = 0;
 
+  // Binary data beyond reading ArrayBuffers is optional. The default
+  // implementations throw JSINativeException, except isTypedArray which
+  // returns false: a runtime without typed arrays has none.
+  virtual ArrayBuffer createArrayBuffer(std::shared_ptr<MutableBuffer> buffer);
+  virtual bool isTypedArray(const Object&) const;
+  virtual TypedArray createTypedArray(
+      TypedArrayKind kind,
+      const ArrayBuffer& buffer,
+      size_t byteOffset,
+      size_t length);
+  virtual TypedArrayKind kind(const TypedArray&);
+  virtual size_t size(const TypedArray&);
+  virtual size_t byteOffset(const TypedArray&);
+  virtual ArrayBuffer buffer(const TypedArray&);
+
   virtual Function createFunctionFromHostFunction(
       const PropNameID& name,
       unsigned int paramCount,
@@ -580,6 +630,12 @@ class Object : public Pointer {
     return runtime.isArrayBuffer(*this);
   }
 
+  /// \return true iff the Object is a TypedArray (e.g. a Uint8Array). If
+  /// so, then \c getTypedArray() will succeed.
+  bool isTypedArray(Runtime& runtime) const {
+    return runtime.isTypedArray(*this);
+  }
+
   /// \return true iff the Object is callable.  If so, then \c
   /// getFunction will succeed.
   bool isFunction(Runtime& runtime) const {
@@ -618,6 +674,14 @@ class Object : public Pointer {
   /// object.  If \c isArrayBuffer() would return false, this will assert.
   ArrayBuffer getArrayBuffer(Runtime& runtime) &&;
 
+  /// \return a TypedArray instance which refers to the same underlying
+  /// object.  If \c isTypedArray() would return false, this will assert.
+  TypedArray getTypedArray(Runtime& runtime) const&;
+
+  /// \return a TypedArray instance which refers to the same underlying
+  /// object.  If \c isTypedArray() would return false, this will assert.
+  TypedArray getTypedArray(Runtime& runtime) &&;
+
   /// \return a Function instance which refers to the same underlying
   /// object.  If \c isFunction() would return false, this will assert.
   Function getFunction(Runtime& runtime) const&;
@@ -767,6 +831,11 @@ class ArrayBuffer : public Object {
   ArrayBuffer(ArrayBuffer&&) = default;
   ArrayBuffer& operator=(ArrayBuffer&&) = default;
 
+  /// Creates an ArrayBuffer over the memory of \c buffer, without copying
+  /// it. The ArrayBuffer keeps \c buffer alive.
+  ArrayBuffer(Runtime& runtime, std::shared_ptr<MutableBuffer> buffer)
+      : ArrayBuffer(runtime.createArrayBuffer(std::move(buffer))) {}
+
   /// \return the size of the ArrayBuffer, according to its byteLength property.
   /// (C++ naming convention)
   size_t size(Runtime& runtime) const {
@@ -784,10 +853,64 @@ class ArrayBuffer : public Object {
  private:
   friend class Object;
   friend class Value;
+  friend class Runtime;
 
   ArrayBuffer(Runtime::PointerValue* value) : Object(value) {}
 };
 
+/// Represents a JS TypedArray (e.g. a Float32Array), a view of part of an
+/// ArrayBuffer.
+class TypedArray : public Object {
+ public:
+  TypedArray(TypedArray&&) = default;
+  TypedArray& operator=(TypedArray&&) = default;
+
+  /// Creates a TypedArray of \c length elements of \c buffer, starting at
+  /// \c byteOffset bytes into it.
+  TypedArray(
+      Runtime& runtime,
+      TypedArrayKind kind,
+      const ArrayBuffer& buffer,
+      size_t byteOffset,
+      size_t length)
+      : TypedArray(
+            runtime.createTypedArray(kind, buffer, byteOffset, length)) {}
+
+  TypedArrayKind kind(Runtime& runtime) const {
+    return runtime.kind(*this);
+  }
+
+  /// \return the number of elements, according to its length property.
+  size_t size(Runtime& runtime) const {
+    return runtime.size(*this);
+  }
+
+  size_t length(Runtime& runtime) const {
+    return runtime.size(*this);
+  }
+
+  size_t byteOffset(Runtime& runtime) const {
+    return runtime.byteOffset(*this);
+  }
+
+  /// \return the ArrayBuffer which this is a view of.
+  ArrayBuffer buffer(Runtime& runtime) const {
+    return runtime.buffer(*this);
+  }
+
+  /// \return a pointer to the first element.
+  uint8_t* data(Runtime& runtime) const {
+    return runtime.buffer(*this).data(runtime) + runtime.byteOffset(*this);
+  }
+
+ private:
+  friend class Object;
+  friend class Value;
+  friend class Runtime;
+
+  TypedArray(Runtime::PointerValue* value) : Object(value) {}
+};
+
 /// Represents a JS Object which is guaranteed to be Callable.
 class Function : public Object {
  public:
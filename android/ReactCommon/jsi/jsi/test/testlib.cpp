@@ -7,6 +7,7 @@
 #include <jsi/test/testlib.h>
 #include <gtest/gtest.h>
 #include <jsi/decorator.h>
+#include <jsi/hostcalltracing.h>
 #include <jsi/jsi.h>
 
 #include <stdlib.h>
@@ -461,6 +462,49 @@ TEST_P(JSITest, ArrayTest) {
   EXPECT_EQ(alpha2.size(rt), 4);
 }
 
+TEST_P(JSITest, ArrayBufferTest) {
+  class VectorBuffer : public MutableBuffer {
+   public:
+    explicit VectorBuffer(size_t size) : data_(size) {}
+    size_t size() const override {
+      return data_.size();
+    }
+    uint8_t* data() override {
+      return data_.data();
+    }
+
+   private:
+    std::vector<uint8_t> data_;
+  };
+
+  auto buffer = std::make_shared<VectorBuffer>(8);
+  buffer->data()[1] = 42;
+  ArrayBuffer arrayBuffer(rt, buffer);
+  EXPECT_EQ(arrayBuffer.size(rt), 8);
+  // The ArrayBuffer refers to the native memory instead of copying it.
+  EXPECT_EQ(arrayBuffer.data(rt), buffer->data());
+  rt.global().setProperty(rt, "ab", arrayBuffer);
+  EXPECT_EQ(eval("new Uint8Array(ab)[1]").getNumber(), 42);
+  EXPECT_TRUE(eval("ab").getObject(rt).isArrayBuffer(rt));
+  EXPECT_FALSE(eval("ab").getObject(rt).isTypedArray(rt));
+
+  TypedArray floats(rt, TypedArrayKind::Float32Array, arrayBuffer, 4, 1);
+  EXPECT_EQ(floats.kind(rt), TypedArrayKind::Float32Array);
+  EXPECT_EQ(floats.size(rt), 1);
+  EXPECT_EQ(floats.byteOffset(rt), 4);
+  EXPECT_EQ(floats.data(rt), buffer->data() + 4);
+  rt.global().setProperty(rt, "floats", floats);
+  eval("floats[0] = 1.5");
+  EXPECT_EQ(*reinterpret_cast<float*>(buffer->data() + 4), 1.5);
+
+  Object view = eval("new Int16Array(ab, 2, 1)").getObject(rt);
+  EXPECT_TRUE(view.isTypedArray(rt));
+  TypedArray int16s = view.getTypedArray(rt);
+  EXPECT_EQ(int16s.kind(rt), TypedArrayKind::Int16Array);
+  EXPECT_EQ(int16s.buffer(rt).data(rt), buffer->data());
+  EXPECT_FALSE(eval("[1, 2]").getObject(rt).isTypedArray(rt));
+}
+
 TEST_P(JSITest, FunctionTest) {
   // test move ctor
   Function fmove = function("function() { return 1 }");
@@ -1156,6 +1200,65 @@ TEST_P(JSITest, MultiDecoratorTest) {
   EXPECT_EQ(mrt.nest(), 0);
 }
 
+TEST_P(JSITest, HostCallTracingTest) {
+  class Module : public HostObject {
+   public:
+    Value get(Runtime& rt, const PropNameID& name) override {
+      return Function::createFromHostFunction(
+          rt,
+          name,
+          0,
+          [](Runtime&, const Value&, const Value*, size_t) { return 42; });
+    }
+  };
+
+  auto collector = std::make_shared<HostCallStatsCollector>();
+  HostCallTracingRuntime trt(
+      factory(), collector, [](const HostObject&) { return "Module"; });
+
+  auto module = std::make_shared<Module>();
+  Object moduleObject = Object::createFromHostObject(trt, module);
+  EXPECT_EQ(moduleObject.getHostObject<Module>(trt), module);
+  trt.global().setProperty(trt, "module", moduleObject);
+  trt.global().setProperty(
+      trt,
+      "add",
+      Function::createFromHostFunction(
+          trt,
+          PropNameID::forAscii(trt, "add"),
+          2,
+          [](Runtime&, const Value&, const Value* args, size_t) {
+            return args[0].getNumber() + args[1].getNumber();
+          }));
+  EXPECT_TRUE(trt.global().getPropertyAsFunction(trt, "add").isHostFunction(
+      trt));
+
+  EXPECT_EQ(
+      trt.evaluateJavaScript(
+             std::make_unique<StringBuffer>(
+                 "add(1, 2) + add(3, 4) + module.answer()"),
+             "")
+          .getNumber(),
+      52);
+
+  auto stats = collector->snapshot();
+  EXPECT_EQ(stats.size(), 3u);
+  EXPECT_EQ(stats["add"].count, 2u);
+  EXPECT_EQ(stats["Module.answer [get]"].count, 1u);
+  EXPECT_EQ(stats["Module.answer"].count, 1u);
+  uint64_t histogramCount = 0;
+  for (uint64_t count : stats["add"].histogram) {
+    histogramCount += count;
+  }
+  EXPECT_EQ(histogramCount, 2u);
+  EXPECT_NE(
+      collector->toJSON().find("{\"name\":\"add\",\"count\":2,"),
+      std::string::npos);
+
+  collector->reset();
+  EXPECT_TRUE(collector->snapshot().empty());
+}
+
 TEST_P(JSITest, SymbolTest) {
   if (!rt.global().hasProperty(rt, "Symbol")) {
     // Symbol is an es6 feature which doesn't exist in older VMs.  So
@@ -0,0 +1,108 @@
+//  Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "jsireact/FilePreparedScriptStore.h"
+
+#include <cxxreact/JSBigString.h>
+#include <fcntl.h>
+#include <folly/Conv.h>
+#include <folly/hash/SpookyHashV2.h>
+#include <glog/logging.h>
+#include <jsireact/JSIExecutor.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+
+namespace facebook {
+namespace react {
+
+FilePreparedScriptStore::FilePreparedScriptStore(std::string directory)
+    : directory_(std::move(directory)) {}
+
+std::string FilePreparedScriptStore::pathFor(
+    const jsi::ScriptSignature &scriptSignature,
+    const jsi::JSRuntimeSignature &runtimeSignature,
+    const char *prepareTag) const {
+  auto key = folly::to<std::string>(
+      scriptSignature.url,
+      '\0',
+      scriptSignature.version,
+      '\0',
+      runtimeSignature.runtimeName,
+      '\0',
+      runtimeSignature.version,
+      '\0',
+      prepareTag);
+  auto hash = folly::hash::SpookyHashV2::Hash64(key.data(), key.size(), 0);
+  return folly::to<std::string>(
+      directory_, "/", folly::to<std::string>(hash), ".", prepareTag);
+}
+
+std::shared_ptr<const jsi::Buffer>
+FilePreparedScriptStore::tryGetPreparedScript(
+    const jsi::ScriptSignature &scriptSignature,
+    const jsi::JSRuntimeSignature &runtimeSignature,
+    const char *prepareTag) noexcept {
+  auto path = pathFor(scriptSignature, runtimeSignature, prepareTag);
+  if (::access(path.c_str(), R_OK) != 0) {
+    return nullptr;
+  }
+  try {
+    auto file = JSBigFileString::fromPath(path);
+    if (file->size() == 0) {
+      return nullptr;
+    }
+    return std::make_shared<BigStringBuffer>(std::move(file));
+  } catch (const std::exception &e) {
+    LOG(WARNING) << "Could not map prepared script " << path << ": "
+                 << e.what();
+    return nullptr;
+  }
+}
+
+void FilePreparedScriptStore::persistPreparedScript(
+    std::shared_ptr<const jsi::Buffer> preparedScript,
+    const jsi::ScriptSignature &scriptSignature,
+    const jsi::JSRuntimeSignature &runtimeSignature,
+    const char *prepareTag) noexcept {
+  auto path = pathFor(scriptSignature, runtimeSignature, prepareTag);
+  // Written to a temporary file first which is then renamed, so a process
+  // which is killed while writing never leaves a truncated script behind.
+  auto temporaryPath = folly::to<std::string>(path, ".", ::getpid(), ".tmp");
+
+  int fd = ::open(
+      temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    LOG(WARNING) << "Could not create " << temporaryPath << ": errno "
+                 << errno;
+    return;
+  }
+
+  auto data = preparedScript->data();
+  auto remaining = preparedScript->size();
+  while (remaining > 0) {
+    auto written = ::write(fd, data, remaining);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    data += written;
+    remaining -= written;
+  }
+
+  bool succeeded = remaining == 0 && ::fsync(fd) == 0;
+  succeeded = ::close(fd) == 0 && succeeded;
+  if (!succeeded || ::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Could not write prepared script " << path << ": errno "
+                 << errno;
+    ::unlink(temporaryPath.c_str());
+  }
+}
+
+} // namespace react
+} // namespace facebook
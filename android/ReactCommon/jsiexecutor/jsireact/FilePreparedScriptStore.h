@@ -0,0 +1,44 @@
+//  Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <jsi/ScriptStore.h>
+
+#include <string>
+
+namespace facebook {
+namespace react {
+
+// A PreparedScriptStore which keeps each prepared script in a file of its own
+// in a directory, e.g. in the app's code cache directory. Prepared scripts are
+// mmapped rather than read, so only the parts of them which run are paged in.
+class FilePreparedScriptStore : public jsi::PreparedScriptStore {
+ public:
+  // The directory must exist.
+  explicit FilePreparedScriptStore(std::string directory);
+
+  std::shared_ptr<const jsi::Buffer> tryGetPreparedScript(
+      const jsi::ScriptSignature &scriptSignature,
+      const jsi::JSRuntimeSignature &runtimeSignature,
+      const char *prepareTag) noexcept override;
+
+  void persistPreparedScript(
+      std::shared_ptr<const jsi::Buffer> preparedScript,
+      const jsi::ScriptSignature &scriptSignature,
+      const jsi::JSRuntimeSignature &runtimeSignature,
+      const char *prepareTag) noexcept override;
+
+ private:
+  std::string pathFor(
+      const jsi::ScriptSignature &scriptSignature,
+      const jsi::JSRuntimeSignature &runtimeSignature,
+      const char *prepareTag) const;
+
+  std::string directory_;
+};
+
+} // namespace react
+} // namespace facebook
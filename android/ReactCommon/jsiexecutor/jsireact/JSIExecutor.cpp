@@ -6,14 +6,20 @@
 #include "jsireact/JSIExecutor.h"
 
 #include <cxxreact/JSBigString.h>
+#include <cxxreact/JSBundleType.h>
+#include <cxxreact/MethodCall.h>
 #include <cxxreact/ModuleRegistry.h>
 #include <cxxreact/ReactMarker.h>
 #include <cxxreact/SystraceSection.h>
 #include <folly/Conv.h>
+#include <folly/hash/SpookyHashV2.h>
 #include <folly/json.h>
 #include <glog/logging.h>
 #include <jsi/JSIDynamic.h>
+#include <microprofiler/MicroProfiler.h>
+#include <sys/resource.h>
 
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
 
@@ -51,6 +57,42 @@ std::string simpleBasename(const std::string &path) {
   return (pos != std::string::npos) ? path.substr(pos) : path;
 }
 
+// Number of major page faults of the calling thread (or of the whole process
+// where per-thread numbers are not available) so far.
+long getMajorPageFaultCount() {
+  struct rusage usage;
+#ifdef RUSAGE_THREAD
+  const int who = RUSAGE_THREAD;
+#else
+  const int who = RUSAGE_SELF;
+#endif
+  if (getrusage(who, &usage) != 0) {
+    return 0;
+  }
+  return usage.ru_majflt;
+}
+
+// The tag of prepared scripts which are Hermes bytecode.
+constexpr const char *kBytecodePrepareTag = "hbc";
+
+bool isHermesBytecode(const jsi::Buffer &buffer) {
+  BundleHeader header;
+  if (buffer.size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, buffer.data(), sizeof(header));
+  return parseTypeFromHeader(header) == ScriptTag::HBCBundle;
+}
+
+// The arguments of a call as a JS value, skipping folly::dynamic if they're
+// encoded (see JSArguments).
+Value argumentsValue(Runtime &runtime, const JSCall &call) {
+  if (call.encodedArguments) {
+    return call.encodedArguments->toJSValue(runtime);
+  }
+  return valueFromDynamic(runtime, call.arguments);
+}
+
 } // namespace
 
 JSIExecutor::JSIExecutor(
@@ -72,8 +114,6 @@ void JSIExecutor::loadApplicationScript(
     std::string sourceURL) {
   SystraceSection s("JSIExecutor::loadApplicationScript");
 
-  // TODO: check for and use precompiled HBC
-
   runtime_->global().setProperty(
       *runtime_,
       "nativeModuleProxy",
@@ -134,18 +174,91 @@ void JSIExecutor::loadApplicationScript(
 
   bool hasLogger(ReactMarker::logTaggedMarker);
   std::string scriptName = simpleBasename(sourceURL);
+  long majorPageFaultCount = 0;
   if (hasLogger) {
     ReactMarker::logTaggedMarker(
         ReactMarker::RUN_JS_BUNDLE_START, scriptName.c_str());
+    majorPageFaultCount = getMajorPageFaultCount();
+  }
+  auto buffer = std::make_shared<BigStringBuffer>(std::move(script));
+  if (isHermesBytecode(*buffer)) {
+    // Precompiled already, there is nothing to cache.
+    evaluateBytecode(buffer, sourceURL);
+  } else if (preparedScriptStore_) {
+    evaluateWithPreparedScriptStore(buffer, sourceURL);
+  } else {
+    runtime_->evaluateJavaScript(buffer, sourceURL);
   }
-  runtime_->evaluateJavaScript(
-      std::make_unique<BigStringBuffer>(std::move(script)), sourceURL);
   flush();
   if (hasLogger) {
+    majorPageFaultCount = getMajorPageFaultCount() - majorPageFaultCount;
     ReactMarker::logMarker(ReactMarker::CREATE_REACT_CONTEXT_STOP);
     ReactMarker::logTaggedMarker(
         ReactMarker::RUN_JS_BUNDLE_STOP, scriptName.c_str());
+    ReactMarker::logTaggedMarker(
+        ReactMarker::RUN_JS_BUNDLE_MAJOR_PAGE_FAULTS,
+        folly::to<std::string>(majorPageFaultCount).c_str());
+  }
+}
+
+void JSIExecutor::setPreparedScriptStore(
+    std::shared_ptr<jsi::PreparedScriptStore> preparedScriptStore) {
+  preparedScriptStore_ = std::move(preparedScriptStore);
+}
+
+void JSIExecutor::evaluateWithPreparedScriptStore(
+    std::shared_ptr<const BigStringBuffer> buffer,
+    const std::string &sourceURL) {
+  SystraceSection s("JSIExecutor::evaluateWithPreparedScriptStore");
+
+  // The bundle at a URL changes whenever it is reloaded in development, or
+  // updated, so the version is a hash of its contents rather than of the URL.
+  jsi::ScriptSignature scriptSignature{
+      sourceURL,
+      folly::hash::SpookyHashV2::Hash64(buffer->data(), buffer->size(), 0)};
+  jsi::JSRuntimeSignature runtimeSignature{runtime_->description(), 0};
+
+  auto bytecode = preparedScriptStore_->tryGetPreparedScript(
+      scriptSignature, runtimeSignature, kBytecodePrepareTag);
+  if (bytecode && isHermesBytecode(*bytecode)) {
+    evaluateBytecode(bytecode, sourceURL);
+    return;
   }
+
+  auto prepared = runtime_->prepareJavaScript(buffer, sourceURL);
+  // Preparations are opaque, except for those which are just the bytecode
+  // they were compiled to.
+  auto preparedBytecode =
+      std::dynamic_pointer_cast<const jsi::Buffer>(prepared);
+  if (preparedBytecode && isHermesBytecode(*preparedBytecode)) {
+    preparedScriptStore_->persistPreparedScript(
+        preparedBytecode,
+        scriptSignature,
+        runtimeSignature,
+        kBytecodePrepareTag);
+  }
+  runtime_->evaluatePreparedJavaScript(prepared);
+}
+
+void JSIExecutor::evaluateBytecode(
+    std::shared_ptr<const jsi::Buffer> bytecode,
+    const std::string &sourceURL) {
+  SystraceSection s("JSIExecutor::evaluateBytecode");
+
+  // Preparing bytecode only loads it: the runtime reads it where it is (e.g.
+  // in a file mapping) instead of copying it, and runs none of it yet.
+  bool hasLogger(ReactMarker::logTaggedMarker);
+  std::string scriptName = simpleBasename(sourceURL);
+  if (hasLogger) {
+    ReactMarker::logTaggedMarker(
+        ReactMarker::LOAD_BYTECODE_START, scriptName.c_str());
+  }
+  auto prepared = runtime_->prepareJavaScript(bytecode, sourceURL);
+  if (hasLogger) {
+    ReactMarker::logTaggedMarker(
+        ReactMarker::LOAD_BYTECODE_STOP, scriptName.c_str());
+  }
+  runtime_->evaluatePreparedJavaScript(prepared);
 }
 
 void JSIExecutor::setBundleRegistry(std::unique_ptr<RAMBundleRegistry> r) {
@@ -175,7 +288,9 @@ void JSIExecutor::registerBundle(
   if (bundleRegistry_) {
     bundleRegistry_->registerBundle(bundleId, bundlePath);
   } else {
-    auto script = JSBigFileString::fromPath(bundlePath);
+    auto policy = JSBigFileMappingPolicy{};
+    policy.access = JSBigFileMappingPolicy::Access::Sequential;
+    auto script = JSBigFileString::fromPath(bundlePath, policy);
     if (script->size() == 0) {
       throw std::invalid_argument(
           "Empty bundle registered with ID " + tag + " from " + bundlePath);
@@ -246,6 +361,74 @@ void JSIExecutor::invokeCallback(
   callNativeModules(ret, true);
 }
 
+void JSIExecutor::callFunctions(std::vector<JSCall> &&calls) {
+  SystraceSection s("JSIExecutor::callFunctions");
+  if (!callFunctionReturnFlushedQueue_) {
+    bindBridge();
+  }
+
+  // All but the last call skip flushing the queue where the bridge allows
+  // it. Otherwise their queues are still executed without ending the batch.
+  for (size_t i = 0; i < calls.size(); i++) {
+    const auto &call = calls[i];
+    const bool isLast = i + 1 == calls.size();
+    Value ret = Value::undefined();
+    if (call.isCallback()) {
+      try {
+        auto arguments = argumentsValue(*runtime_, call);
+        if (!isLast && invokeCallbackWithoutFlush_) {
+          invokeCallbackWithoutFlush_->callWithThis(
+              *runtime_, *batchedBridge_, call.callbackId, arguments);
+        } else {
+          ret = invokeCallbackAndReturnFlushedQueue_->call(
+              *runtime_, call.callbackId, arguments);
+        }
+      } catch (...) {
+        std::throw_with_nested(std::runtime_error(folly::to<std::string>(
+            "Error invoking callback ", call.callbackId)));
+      }
+    } else {
+      auto errorProducer = [moduleId = call.moduleId,
+                            methodId = call.methodId,
+                            arguments = call.arguments,
+                            encodedArguments = call.encodedArguments] {
+        std::stringstream ss;
+        ss << "moduleID: " << moduleId << " methodID: " << methodId
+           << " arguments: "
+           << folly::toJson(
+                  encodedArguments ? encodedArguments->toDynamic() : arguments);
+        return ss.str();
+      };
+
+      try {
+        scopedTimeoutInvoker_(
+            [&] {
+              auto arguments = argumentsValue(*runtime_, call);
+              if (!isLast && callFunctionWithoutFlush_) {
+                callFunctionWithoutFlush_->callWithThis(
+                    *runtime_,
+                    *batchedBridge_,
+                    call.moduleId,
+                    call.methodId,
+                    arguments);
+              } else {
+                ret = callFunctionReturnFlushedQueue_->call(
+                    *runtime_, call.moduleId, call.methodId, arguments);
+              }
+            },
+            std::move(errorProducer));
+      } catch (...) {
+        std::throw_with_nested(std::runtime_error(
+            "Error calling " + call.moduleId + "." + call.methodId));
+      }
+    }
+
+    if (isLast || !ret.isUndefined()) {
+      callNativeModules(ret, isLast);
+    }
+  }
+}
+
 void JSIExecutor::setGlobalVariable(
     std::string propName,
     std::unique_ptr<const JSBigString> jsonValue) {
@@ -259,6 +442,76 @@ void JSIExecutor::setGlobalVariable(
           jsonValue->size()));
 }
 
+void JSIExecutor::setGlobalVariableLazily(
+    std::string propName,
+    std::unique_ptr<const JSBigString> jsonValue) {
+  SystraceSection s(
+      "JSIExecutor::setGlobalVariableLazily", "propName", propName);
+
+  // The variable is an accessor until it is first read or written, and a
+  // plain value from then on, so the JSON is parsed once at most.
+  auto json = std::make_shared<std::unique_ptr<const JSBigString>>(
+      std::move(jsonValue));
+  auto defineProperty = [propName](
+                            Runtime &runtime, const Object &descriptor) {
+    runtime.global()
+        .getPropertyAsObject(runtime, "Object")
+        .getPropertyAsFunction(runtime, "defineProperty")
+        .call(
+            runtime,
+            runtime.global(),
+            jsi::String::createFromUtf8(runtime, propName),
+            descriptor);
+  };
+  auto defineValue = [defineProperty](Runtime &runtime, const Value &value) {
+    Object descriptor(runtime);
+    descriptor.setProperty(runtime, "value", value);
+    descriptor.setProperty(runtime, "writable", true);
+    descriptor.setProperty(runtime, "enumerable", true);
+    descriptor.setProperty(runtime, "configurable", true);
+    defineProperty(runtime, descriptor);
+  };
+
+  auto getter = Function::createFromHostFunction(
+      *runtime_,
+      PropNameID::forAscii(*runtime_, "get"),
+      0,
+      [json, defineValue, propName](
+          Runtime &runtime, const Value &, const Value *, size_t) {
+        if (!*json) {
+          // Only reachable through a reference to the getter taken before the
+          // value was parsed.
+          return runtime.global().getProperty(runtime, propName.c_str());
+        }
+        SystraceSection s("JSIExecutor::parseLazyGlobalVariable");
+        auto value = Value::createFromJsonUtf8(
+            runtime,
+            reinterpret_cast<const uint8_t *>((*json)->c_str()),
+            (*json)->size());
+        json->reset();
+        defineValue(runtime, value);
+        return value;
+      });
+  auto setter = Function::createFromHostFunction(
+      *runtime_,
+      PropNameID::forAscii(*runtime_, "set"),
+      1,
+      [json, defineValue](
+          Runtime &runtime, const Value &, const Value *args, size_t count) {
+        json->reset();
+        defineValue(
+            runtime, count > 0 ? Value(runtime, args[0]) : Value::undefined());
+        return Value::undefined();
+      });
+
+  Object descriptor(*runtime_);
+  descriptor.setProperty(*runtime_, "get", getter);
+  descriptor.setProperty(*runtime_, "set", setter);
+  descriptor.setProperty(*runtime_, "enumerable", true);
+  descriptor.setProperty(*runtime_, "configurable", true);
+  defineProperty(*runtime_, descriptor);
+}
+
 std::string JSIExecutor::getDescription() {
   return "JSI (" + runtime_->description() + ")";
 }
@@ -291,11 +544,42 @@ void JSIExecutor::bindBridge() {
     callFunctionReturnResultAndFlushedQueue_ =
         batchedBridge.getPropertyAsFunction(
             *runtime_, "callFunctionReturnResultAndFlushedQueue");
+
+    Value callFunction =
+        batchedBridge.getProperty(*runtime_, "__callFunction");
+    Value invokeCallback =
+        batchedBridge.getProperty(*runtime_, "__invokeCallback");
+    if (callFunction.isObject() && invokeCallback.isObject() &&
+        callFunction.getObject(*runtime_).isFunction(*runtime_) &&
+        invokeCallback.getObject(*runtime_).isFunction(*runtime_)) {
+      callFunctionWithoutFlush_ =
+          callFunction.getObject(*runtime_).getFunction(*runtime_);
+      invokeCallbackWithoutFlush_ =
+          invokeCallback.getObject(*runtime_).getFunction(*runtime_);
+      batchedBridge_ = std::move(batchedBridge);
+    }
   });
 }
 
 void JSIExecutor::callNativeModules(const Value &queue, bool isEndOfBatch) {
   SystraceSection s("JSIExecutor::callNativeModules");
+  MICRO_PROFILER_SCOPE("JSIExecutor::callNativeModules");
+
+  // Promise reactions of the whole batch run at a single checkpoint here, for
+  // runtimes which let the host drain their microtasks. The calls they queue
+  // belong to the same batch, after the ones which were already flushed.
+  if (isEndOfBatch && runtime_->drainMicrotasks() && flushedQueue_) {
+    dispatchNativeModuleCalls(queue, false);
+    dispatchNativeModuleCalls(flushedQueue_->call(*runtime_), true);
+    return;
+  }
+
+  dispatchNativeModuleCalls(queue, isEndOfBatch);
+}
+
+void JSIExecutor::dispatchNativeModuleCalls(
+    const Value &queue,
+    bool isEndOfBatch) {
   // If this fails, you need to pass a fully functional delegate with a
   // module registry to the factory/ctor.
   CHECK(delegate_) << "Attempting to use native modules without a delegate";
@@ -304,6 +588,18 @@ void JSIExecutor::callNativeModules(const Value &queue, bool isEndOfBatch) {
     .getPropertyAsFunction(*runtime_, "stringify").call(*runtime_, queue)
     .getString(*runtime_).utf8(*runtime_);
 #endif
+  if (queue.isObject()) {
+    auto object = queue.getObject(*runtime_);
+    if (object.isArrayBuffer(*runtime_)) {
+      // The binary format is parsed straight out of the JS heap.
+      auto buffer = object.getArrayBuffer(*runtime_);
+      delegate_->callNativeModules(
+          *this,
+          parseMethodCalls(buffer.data(*runtime_), buffer.size(*runtime_)),
+          isEndOfBatch);
+      return;
+    }
+  }
   delegate_->callNativeModules(
       *this, dynamicFromValue(*runtime_, queue), isEndOfBatch);
 }
@@ -346,8 +642,14 @@ Value JSIExecutor::nativeRequire(const Value *args, size_t count) {
   uint32_t bundleId = count == 2 ? folly::to<uint32_t>(args[1].getNumber()) : 0;
   auto module = bundleRegistry_->getModule(bundleId, moduleId);
 
-  runtime_->evaluateJavaScript(
-      std::make_unique<StringBuffer>(module.code), module.name);
+  if (module.source) {
+    runtime_->evaluateJavaScript(
+        std::make_unique<BigStringBuffer>(std::move(module.source)),
+        module.name);
+  } else {
+    runtime_->evaluateJavaScript(
+        std::make_unique<StringBuffer>(std::move(module.code)), module.name);
+  }
   return facebook::jsi::Value();
 }
 
@@ -361,11 +663,33 @@ Value JSIExecutor::nativeCallSyncHook(const Value *args, size_t count) {
         folly::to<std::string>("method parameters should be array"));
   }
 
+  auto moduleId = static_cast<unsigned int>(args[0].getNumber());
+  auto methodId = static_cast<unsigned int>(args[1].getNumber());
+  auto params = args[2].getObject(*runtime_).getArray(*runtime_);
+  size_t paramCount = params.size(*runtime_);
+  std::vector<Value> values;
+  values.reserve(paramCount);
+  for (size_t i = 0; i < paramCount; i++) {
+    values.push_back(params.getValueAtIndex(*runtime_, i));
+  }
+
+  // Methods which take JS values as they are skip folly::dynamic entirely.
+  if (auto jsiResult = delegate_->callJSINativeHook(
+          *this,
+          *runtime_,
+          moduleId,
+          methodId,
+          values.data(),
+          values.size())) {
+    return std::move(*jsiResult);
+  }
+
+  folly::dynamic dynamicParams = folly::dynamic::array();
+  for (const auto &value : values) {
+    dynamicParams.push_back(dynamicFromValue(*runtime_, value));
+  }
   MethodCallResult result = delegate_->callSerializableNativeHook(
-      *this,
-      static_cast<unsigned int>(args[0].getNumber()), // moduleId
-      static_cast<unsigned int>(args[1].getNumber()), // methodId
-      dynamicFromValue(*runtime_, args[2])); // args
+      *this, moduleId, methodId, std::move(dynamicParams));
 
   if (!result.hasValue()) {
     return Value::undefined();
@@ -392,6 +716,13 @@ Value JSIExecutor::globalEvalWithSourceUrl(const Value *args, size_t count) {
 #endif
 
 void bindNativeLogger(Runtime &runtime, Logger logger) {
+  bindNativeLogger(runtime, std::move(logger), nullptr);
+}
+
+void bindNativeLogger(
+    Runtime &runtime,
+    Logger logger,
+    LogLevelFilter shouldLog) {
   runtime.global().setProperty(
       runtime,
       "nativeLoggingHook",
@@ -399,7 +730,7 @@ void bindNativeLogger(Runtime &runtime, Logger logger) {
           runtime,
           PropNameID::forAscii(runtime, "nativeLoggingHook"),
           2,
-          [logger = std::move(logger)](
+          [logger = std::move(logger), shouldLog = std::move(shouldLog)](
               jsi::Runtime &runtime,
               const jsi::Value &,
               const jsi::Value *args,
@@ -408,9 +739,11 @@ void bindNativeLogger(Runtime &runtime, Logger logger) {
               throw std::invalid_argument(
                   "nativeLoggingHook takes 2 arguments");
             }
-            logger(
-                args[0].asString(runtime).utf8(runtime),
-                folly::to<unsigned int>(args[1].asNumber()));
+            auto logLevel = folly::to<unsigned int>(args[1].asNumber());
+            if (shouldLog && !shouldLog(logLevel)) {
+              return Value::undefined();
+            }
+            logger(args[0].asString(runtime).utf8(runtime), logLevel);
             return Value::undefined();
           }));
 }
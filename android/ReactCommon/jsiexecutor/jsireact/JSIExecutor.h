@@ -10,6 +10,7 @@
 #include <cxxreact/JSBigString.h>
 #include <cxxreact/JSExecutor.h>
 #include <cxxreact/RAMBundleRegistry.h>
+#include <jsi/ScriptStore.h>
 #include <jsi/jsi.h>
 #include <functional>
 #include <mutex>
@@ -87,9 +88,13 @@ class JSIExecutor : public JSExecutor {
       const folly::dynamic &arguments) override;
   void invokeCallback(const double callbackId, const folly::dynamic &arguments)
       override;
+  void callFunctions(std::vector<JSCall> &&calls) override;
   void setGlobalVariable(
       std::string propName,
       std::unique_ptr<const JSBigString> jsonValue) override;
+  void setGlobalVariableLazily(
+      std::string propName,
+      std::unique_ptr<const JSBigString> jsonValue) override;
   std::string getDescription() override;
   void *getJavaScriptContext() override;
   bool isInspectable() override;
@@ -105,16 +110,29 @@ class JSIExecutor : public JSExecutor {
 
   void flush() override;
 
+  // With a store, loadApplicationScript runs the bytecode it has for the
+  // script instead of the script itself, and persists the bytecode of scripts
+  // the runtime compiles, so they are only compiled once.
+  void setPreparedScriptStore(
+      std::shared_ptr<jsi::PreparedScriptStore> preparedScriptStore);
+
  private:
   class NativeModuleProxy;
 
   void bindBridge();
   void callNativeModules(const jsi::Value &queue, bool isEndOfBatch);
+  void dispatchNativeModuleCalls(const jsi::Value &queue, bool isEndOfBatch);
   jsi::Value nativeCallSyncHook(const jsi::Value *args, size_t count);
   jsi::Value nativeRequire(const jsi::Value *args, size_t count);
 #ifdef DEBUG
   jsi::Value globalEvalWithSourceUrl(const jsi::Value *args, size_t count);
 #endif
+  void evaluateWithPreparedScriptStore(
+      std::shared_ptr<const BigStringBuffer> buffer,
+      const std::string &sourceURL);
+  void evaluateBytecode(
+      std::shared_ptr<const jsi::Buffer> bytecode,
+      const std::string &sourceURL);
 
   std::shared_ptr<jsi::Runtime> runtime_;
   std::shared_ptr<ExecutorDelegate> delegate_;
@@ -123,15 +141,29 @@ class JSIExecutor : public JSExecutor {
   std::unique_ptr<RAMBundleRegistry> bundleRegistry_;
   JSIScopedTimeoutInvoker scopedTimeoutInvoker_;
   RuntimeInstaller runtimeInstaller_;
+  std::shared_ptr<jsi::PreparedScriptStore> preparedScriptStore_;
 
   folly::Optional<jsi::Function> callFunctionReturnFlushedQueue_;
   folly::Optional<jsi::Function> invokeCallbackAndReturnFlushedQueue_;
   folly::Optional<jsi::Function> flushedQueue_;
   folly::Optional<jsi::Function> callFunctionReturnResultAndFlushedQueue_;
+  // The methods underlying callFunctionReturnFlushedQueue and
+  // invokeCallbackAndReturnFlushedQueue, which don't flush the queue; unset
+  // if the bridge doesn't have them.
+  folly::Optional<jsi::Object> batchedBridge_;
+  folly::Optional<jsi::Function> callFunctionWithoutFlush_;
+  folly::Optional<jsi::Function> invokeCallbackWithoutFlush_;
 };
 
 using Logger =
     std::function<void(const std::string &message, unsigned int logLevel)>;
+// Whether messages of a log level are logged at all. Messages which aren't
+// are dropped before they are converted to std::string.
+using LogLevelFilter = std::function<bool(unsigned int logLevel)>;
 void bindNativeLogger(jsi::Runtime &runtime, Logger logger);
+void bindNativeLogger(
+    jsi::Runtime &runtime,
+    Logger logger,
+    LogLevelFilter shouldLog);
 } // namespace react
 } // namespace facebook
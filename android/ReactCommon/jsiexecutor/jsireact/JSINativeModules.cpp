@@ -5,9 +5,8 @@
 
 #include "jsireact/JSINativeModules.h"
 
-#include <glog/logging.h>
-
 #include <cxxreact/ReactMarker.h>
+#include <cxxreact/SystraceSection.h>
 
 #include <jsi/JSIDynamic.h>
 
@@ -18,10 +17,179 @@ using namespace facebook::jsi;
 namespace facebook {
 namespace react {
 
+/**
+ * A module whose methods are only generated by JS once they're first read,
+ * and whose constants are only converted to JS (or, for modules with lazy
+ * constants, computed) once JS reads one of them or calls getConstants().
+ * Apps often use a few methods of modules which have dozens.
+ */
+class JSINativeModules::LazyModule
+    : public HostObject,
+      public std::enable_shared_from_this<LazyModule> {
+ public:
+  LazyModule(
+      Runtime& rt,
+      Function genNativeModule,
+      std::shared_ptr<ModuleRegistry> moduleRegistry,
+      ModuleConfig&& config)
+      : m_moduleRegistry(std::move(moduleRegistry)),
+        m_moduleId(config.index),
+        m_hasLazyConstants(config.hasLazyConstants) {
+    // See ModuleRegistry::getConfig() for the layout of the config.
+    auto& dynamicConfig = config.config;
+    m_name = dynamicConfig[0].getString();
+    if (!m_hasLazyConstants) {
+      m_constants = std::move(dynamicConfig[1]);
+    }
+    if (dynamicConfig.size() > 2) {
+      const auto& methodNames = dynamicConfig[2];
+      for (size_t i = 0; i < methodNames.size(); i++) {
+        m_methodIds.emplace(methodNames[i].getString(), i);
+      }
+    }
+    m_state = State{
+        std::move(genNativeModule),
+        Object(rt),
+        dynamicConfig.size() > 3 ? valueFromDynamic(rt, dynamicConfig[3])
+                                 : Value::null(),
+        dynamicConfig.size() > 4 ? valueFromDynamic(rt, dynamicConfig[4])
+                                 : Value::null(),
+        folly::none};
+  }
+
+  Value get(Runtime& rt, const PropNameID& name) override {
+    if (!m_state) {
+      return Value::undefined();
+    }
+
+    // Methods which were already generated, and values set by JS.
+    auto value = m_state->properties.getProperty(rt, name);
+    if (!value.isUndefined()) {
+      return value;
+    }
+
+    auto propName = name.utf8(rt);
+    auto methodId = m_methodIds.find(propName);
+    if (methodId != m_methodIds.end()) {
+      auto method = genMethod(rt, propName, methodId->second);
+      m_state->properties.setProperty(rt, name, method);
+      return method;
+    }
+
+    if (propName == "getConstants") {
+      auto self = shared_from_this();
+      return Function::createFromHostFunction(
+          rt,
+          name,
+          0,
+          [self](Runtime& rt, const Value&, const Value*, size_t) -> Value {
+            if (!self->m_state) {
+              return Value::undefined();
+            }
+            return Value(rt, self->getConstants(rt));
+          });
+    }
+
+    return getConstants(rt).getProperty(rt, name);
+  }
+
+  void set(Runtime& rt, const PropNameID& name, const Value& value) override {
+    if (m_state) {
+      m_state->properties.setProperty(rt, name, value);
+    }
+  }
+
+  std::vector<PropNameID> getPropertyNames(Runtime& rt) override {
+    std::vector<PropNameID> names;
+    if (!m_state) {
+      return names;
+    }
+    for (const auto& method : m_methodIds) {
+      names.push_back(PropNameID::forUtf8(rt, method.first));
+    }
+    for (auto object : {&m_state->properties, &getConstants(rt)}) {
+      auto objectNames = object->getPropertyNames(rt);
+      for (size_t i = 0; i < objectNames.size(rt); i++) {
+        auto objectName = objectNames.getValueAtIndex(rt, i).getString(rt);
+        if (m_methodIds.find(objectName.utf8(rt)) == m_methodIds.end()) {
+          names.push_back(PropNameID::forString(rt, objectName));
+        }
+      }
+    }
+    return names;
+  }
+
+  void release() {
+    m_state = folly::none;
+  }
+
+ private:
+  // The JS values, which must be released before the runtime is destroyed.
+  struct State {
+    Function genNativeModule;
+    Object properties;
+    Value promiseMethodIds;
+    Value syncMethodIds;
+    folly::Optional<Object> constants;
+  };
+
+  Value genMethod(Runtime& rt, const std::string& name, size_t methodId) {
+    TraceSection<TraceCategory::NativeModules> s(
+        "LazyModule::genMethod", "method", name);
+
+    // JS generates a method for every element of the method names. The array
+    // has no other elements, so it only generates this one, with the right id.
+    Array methodNames(rt, methodId + 1);
+    methodNames.setValueAtIndex(
+        rt, methodId, String::createFromUtf8(rt, name));
+
+    Array config(rt, 5);
+    config.setValueAtIndex(rt, 0, String::createFromUtf8(rt, m_name));
+    config.setValueAtIndex(rt, 1, Value::null());
+    config.setValueAtIndex(rt, 2, std::move(methodNames));
+    config.setValueAtIndex(rt, 3, m_state->promiseMethodIds);
+    config.setValueAtIndex(rt, 4, m_state->syncMethodIds);
+
+    Value moduleInfo = m_state->genNativeModule.call(
+        rt, std::move(config), static_cast<double>(m_moduleId));
+    return moduleInfo.asObject(rt)
+        .getPropertyAsObject(rt, "module")
+        .getProperty(rt, name.c_str());
+  }
+
+  Object& getConstants(Runtime& rt) {
+    if (!m_state->constants) {
+      TraceSection<TraceCategory::NativeModules> s(
+          "LazyModule::getConstants");
+      if (m_hasLazyConstants) {
+        m_constants = m_moduleRegistry->getConstants(m_moduleId);
+      }
+      m_state->constants = m_constants.isObject()
+          ? valueFromDynamic(rt, m_constants).getObject(rt)
+          : Object(rt);
+      m_constants = nullptr;
+    }
+    return *m_state->constants;
+  }
+
+  folly::Optional<State> m_state;
+  std::shared_ptr<ModuleRegistry> m_moduleRegistry;
+  size_t m_moduleId;
+  bool m_hasLazyConstants;
+  std::string m_name;
+  std::unordered_map<std::string, size_t> m_methodIds;
+  // Until they're converted.
+  folly::dynamic m_constants;
+};
+
 JSINativeModules::JSINativeModules(
     std::shared_ptr<ModuleRegistry> moduleRegistry)
     : m_moduleRegistry(std::move(moduleRegistry)) {}
 
+JSINativeModules::~JSINativeModules() {
+  reset();
+}
+
 Value JSINativeModules::getModule(Runtime& rt, const PropNameID& name) {
   if (!m_moduleRegistry) {
     return nullptr;
@@ -49,6 +217,12 @@ Value JSINativeModules::getModule(Runtime& rt, const PropNameID& name) {
 void JSINativeModules::reset() {
   m_genNativeModuleJS = folly::none;
   m_objects.clear();
+  for (auto& weakModule : m_lazyModules) {
+    if (auto module = weakModule.lock()) {
+      module->release();
+    }
+  }
+  m_lazyModules.clear();
 }
 
 folly::Optional<Object> JSINativeModules::createModule(
@@ -65,19 +239,19 @@ folly::Optional<Object> JSINativeModules::createModule(
         rt.global().getPropertyAsFunction(rt, "__fbGenNativeModule");
   }
 
-  auto result = m_moduleRegistry->getConfig(name);
+  auto result = m_moduleRegistry->getConfig(name, true);
   if (!result.hasValue()) {
     return folly::none;
   }
 
-  Value moduleInfo = m_genNativeModuleJS->call(
+  auto lazyModule = std::make_shared<LazyModule>(
       rt,
-      valueFromDynamic(rt, result->config),
-      static_cast<double>(result->index));
-  CHECK(!moduleInfo.isNull()) << "Module returned from genNativeModule is null";
-
+      Value(rt, *m_genNativeModuleJS).getObject(rt).getFunction(rt),
+      m_moduleRegistry,
+      std::move(*result));
+  m_lazyModules.push_back(lazyModule);
   folly::Optional<Object> module(
-      moduleInfo.asObject(rt).getPropertyAsObject(rt, "module"));
+      Object::createFromHostObject(rt, std::move(lazyModule)));
 
   if (hasLogger) {
     ReactMarker::logTaggedMarker(
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <cxxreact/ModuleRegistry.h>
 #include <folly/Optional.h>
@@ -21,13 +22,19 @@ namespace react {
 class JSINativeModules {
  public:
   explicit JSINativeModules(std::shared_ptr<ModuleRegistry> moduleRegistry);
+  ~JSINativeModules();
   jsi::Value getModule(jsi::Runtime& rt, const jsi::PropNameID& name);
   void reset();
 
  private:
+  class LazyModule;
+
   folly::Optional<jsi::Function> m_genNativeModuleJS;
   std::shared_ptr<ModuleRegistry> m_moduleRegistry;
   std::unordered_map<std::string, jsi::Object> m_objects;
+  // These hold JS values, which must be released before the runtime is
+  // destroyed (which is when it destroys the host objects).
+  std::vector<std::weak_ptr<LazyModule>> m_lazyModules;
 
   folly::Optional<jsi::Object> createModule(
       jsi::Runtime& rt,
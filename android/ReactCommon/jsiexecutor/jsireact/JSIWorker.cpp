@@ -0,0 +1,561 @@
+//  Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "jsireact/JSIWorker.h"
+
+#include <cstring>
+#include <vector>
+
+#include <folly/MoveWrapper.h>
+#include <glog/logging.h>
+#include <jsireact/JSIExecutor.h>
+
+using namespace facebook::jsi;
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+// The memory of a cloned ArrayBuffer, which the recreated ArrayBuffers use.
+class ClonedBuffer : public MutableBuffer {
+ public:
+  ClonedBuffer(const uint8_t *data, size_t size) : data_(data, data + size) {}
+
+  size_t size() const override {
+    return data_.size();
+  }
+
+  uint8_t *data() override {
+    return data_.data();
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+size_t elementSize(TypedArrayKind kind) {
+  switch (kind) {
+    case TypedArrayKind::Int8Array:
+    case TypedArrayKind::Uint8Array:
+    case TypedArrayKind::Uint8ClampedArray:
+      return 1;
+    case TypedArrayKind::Int16Array:
+    case TypedArrayKind::Uint16Array:
+      return 2;
+    case TypedArrayKind::Int32Array:
+    case TypedArrayKind::Uint32Array:
+    case TypedArrayKind::Float32Array:
+      return 4;
+    case TypedArrayKind::Float64Array:
+      return 8;
+  }
+  return 1;
+}
+
+} // namespace
+
+struct JSIClonedValue::Node {
+  enum class Kind {
+    Undefined,
+    Null,
+    Boolean,
+    Number,
+    String,
+    Array,
+    Object,
+    ArrayBuffer,
+    TypedArray,
+    HostObject,
+  };
+
+  Kind kind{Kind::Undefined};
+  // The value of booleans and numbers.
+  double number{0};
+  // The value of strings.
+  std::string string;
+  // The elements of arrays, and the property values of objects.
+  std::vector<Node> values;
+  // The property names of objects.
+  std::vector<std::string> names;
+  // The memory of ArrayBuffers and typed arrays. A typed array gets its own
+  // copy of just the part of its buffer it is a view of.
+  std::shared_ptr<ClonedBuffer> buffer;
+  TypedArrayKind typedArrayKind{TypedArrayKind::Uint8Array};
+  size_t length{0};
+  std::shared_ptr<HostObject> hostObject;
+
+  static Node clone(Runtime &runtime, const Value &value, size_t depth);
+  Value recreate(Runtime &runtime) const;
+};
+
+JSIClonedValue::Node JSIClonedValue::Node::clone(
+    Runtime &runtime,
+    const Value &value,
+    size_t depth) {
+  auto node = Node{};
+
+  if (value.isUndefined()) {
+    return node;
+  }
+  if (value.isNull()) {
+    node.kind = Kind::Null;
+    return node;
+  }
+  if (value.isBool()) {
+    node.kind = Kind::Boolean;
+    node.number = value.getBool() ? 1 : 0;
+    return node;
+  }
+  if (value.isNumber()) {
+    node.kind = Kind::Number;
+    node.number = value.getNumber();
+    return node;
+  }
+  if (value.isString()) {
+    node.kind = Kind::String;
+    node.string = value.getString(runtime).utf8(runtime);
+    return node;
+  }
+  if (!value.isObject()) {
+    throw JSError(runtime, "Symbols could not be cloned");
+  }
+  if (depth >= kMaxDepth) {
+    throw JSError(
+        runtime, "Values nested this deep (or cyclic) could not be cloned");
+  }
+
+  auto object = value.getObject(runtime);
+
+  if (object.isHostObject(runtime)) {
+    node.kind = Kind::HostObject;
+    node.hostObject = object.getHostObject(runtime);
+    return node;
+  }
+  if (object.isFunction(runtime)) {
+    throw JSError(runtime, "Functions could not be cloned");
+  }
+  if (object.isArrayBuffer(runtime)) {
+    auto arrayBuffer = object.getArrayBuffer(runtime);
+    node.kind = Kind::ArrayBuffer;
+    node.buffer = std::make_shared<ClonedBuffer>(
+        arrayBuffer.data(runtime), arrayBuffer.size(runtime));
+    return node;
+  }
+  if (object.isTypedArray(runtime)) {
+    auto typedArray = object.getTypedArray(runtime);
+    node.kind = Kind::TypedArray;
+    node.typedArrayKind = typedArray.kind(runtime);
+    node.length = typedArray.size(runtime);
+    node.buffer = std::make_shared<ClonedBuffer>(
+        typedArray.data(runtime),
+        node.length * elementSize(node.typedArrayKind));
+    return node;
+  }
+  if (object.isArray(runtime)) {
+    auto array = object.getArray(runtime);
+    auto length = array.size(runtime);
+    node.kind = Kind::Array;
+    node.values.reserve(length);
+    for (size_t index = 0; index < length; index++) {
+      node.values.push_back(
+          clone(runtime, array.getValueAtIndex(runtime, index), depth + 1));
+    }
+    return node;
+  }
+
+  auto names = object.getPropertyNames(runtime);
+  auto count = names.size(runtime);
+  node.kind = Kind::Object;
+  node.names.reserve(count);
+  node.values.reserve(count);
+  for (size_t index = 0; index < count; index++) {
+    auto name = names.getValueAtIndex(runtime, index).getString(runtime);
+    node.values.push_back(
+        clone(runtime, object.getProperty(runtime, name), depth + 1));
+    node.names.push_back(name.utf8(runtime));
+  }
+  return node;
+}
+
+Value JSIClonedValue::Node::recreate(Runtime &runtime) const {
+  switch (kind) {
+    case Kind::Undefined:
+      return Value::undefined();
+    case Kind::Null:
+      return Value::null();
+    case Kind::Boolean:
+      return Value(number != 0);
+    case Kind::Number:
+      return Value(number);
+    case Kind::String:
+      return String::createFromUtf8(runtime, string);
+    case Kind::Array: {
+      auto array = Array(runtime, values.size());
+      for (size_t index = 0; index < values.size(); index++) {
+        array.setValueAtIndex(runtime, index, values[index].recreate(runtime));
+      }
+      return std::move(array);
+    }
+    case Kind::Object: {
+      auto object = Object(runtime);
+      for (size_t index = 0; index < names.size(); index++) {
+        object.setProperty(
+            runtime, names[index].c_str(), values[index].recreate(runtime));
+      }
+      return std::move(object);
+    }
+    case Kind::ArrayBuffer:
+      return ArrayBuffer(runtime, buffer);
+    case Kind::TypedArray:
+      return TypedArray(
+          runtime, typedArrayKind, ArrayBuffer(runtime, buffer), 0, length);
+    case Kind::HostObject:
+      return Object::createFromHostObject(runtime, hostObject);
+  }
+  return Value::undefined();
+}
+
+JSIClonedValue::JSIClonedValue() : root_(std::make_shared<const Node>()) {}
+
+JSIClonedValue::JSIClonedValue(std::shared_ptr<const Node> root)
+    : root_(std::move(root)) {}
+
+JSIClonedValue JSIClonedValue::fromValue(
+    Runtime &runtime,
+    const Value &value) {
+  return JSIClonedValue(
+      std::make_shared<const Node>(Node::clone(runtime, value, 0)));
+}
+
+Value JSIClonedValue::toValue(Runtime &runtime) const {
+  return root_->recreate(runtime);
+}
+
+std::shared_ptr<JSIWorker> JSIWorker::start(
+    RuntimeFactory runtimeFactory,
+    RuntimeInstaller runtimeInstaller,
+    std::shared_ptr<MessageQueueThread> workerQueue,
+    std::shared_ptr<MessageQueueThread> hostQueue,
+    std::unique_ptr<const JSBigString> script,
+    std::string sourceURL,
+    MessageHandler onMessage,
+    ErrorHandler onError) {
+  auto worker = std::shared_ptr<JSIWorker>(new JSIWorker(
+      workerQueue, hostQueue, std::move(onMessage), std::move(onError)));
+
+  auto scriptWrapper = folly::makeMoveWrapper(std::move(script));
+  workerQueue->runOnQueue([worker,
+                           runtimeFactory = std::move(runtimeFactory),
+                           runtimeInstaller = std::move(runtimeInstaller),
+                           scriptWrapper,
+                           sourceURL = std::move(sourceURL)]() mutable {
+    if (worker->isTerminated_) {
+      return;
+    }
+    worker->initialize(
+        std::move(runtimeFactory),
+        std::move(runtimeInstaller),
+        std::move(*scriptWrapper),
+        std::move(sourceURL));
+  });
+
+  return worker;
+}
+
+JSIWorker::JSIWorker(
+    std::shared_ptr<MessageQueueThread> workerQueue,
+    std::shared_ptr<MessageQueueThread> hostQueue,
+    MessageHandler onMessage,
+    ErrorHandler onError)
+    : workerQueue_(std::move(workerQueue)),
+      hostQueue_(std::move(hostQueue)),
+      onMessage_(std::move(onMessage)),
+      onError_(std::move(onError)) {}
+
+JSIWorker::~JSIWorker() = default;
+
+void JSIWorker::initialize(
+    RuntimeFactory runtimeFactory,
+    RuntimeInstaller runtimeInstaller,
+    std::unique_ptr<const JSBigString> script,
+    std::string sourceURL) {
+  try {
+    runtime_ = runtimeFactory();
+    auto &runtime = *runtime_;
+
+    if (runtimeInstaller) {
+      runtimeInstaller(runtime);
+    }
+
+    // The functions only hold the worker weakly, since its runtime holds them.
+    auto weakWorker = std::weak_ptr<JSIWorker>(shared_from_this());
+    runtime.global().setProperty(
+        runtime,
+        "postMessage",
+        Function::createFromHostFunction(
+            runtime,
+            PropNameID::forAscii(runtime, "postMessage"),
+            1,
+            [weakWorker](
+                Runtime &rt, const Value &, const Value *args, size_t count) {
+              auto message = count > 0 ? JSIClonedValue::fromValue(rt, args[0])
+                                       : JSIClonedValue();
+              if (auto worker = weakWorker.lock()) {
+                worker->sendToHost([message](JSIWorker &worker) {
+                  worker.onMessage_(message);
+                });
+              }
+              return Value::undefined();
+            }));
+    runtime.global().setProperty(
+        runtime,
+        "close",
+        Function::createFromHostFunction(
+            runtime,
+            PropNameID::forAscii(runtime, "close"),
+            0,
+            [weakWorker](Runtime &, const Value &, const Value *, size_t) {
+              if (auto worker = weakWorker.lock()) {
+                worker->terminate();
+              }
+              return Value::undefined();
+            }));
+
+    runtime.evaluateJavaScript(
+        std::make_unique<BigStringBuffer>(std::move(script)), sourceURL);
+  } catch (const JSError &error) {
+    reportError(error.getMessage());
+  } catch (const std::exception &exception) {
+    reportError(exception.what());
+  }
+}
+
+void JSIWorker::postMessage(JSIClonedValue message) {
+  if (isTerminated_) {
+    return;
+  }
+
+  workerQueue_->runOnQueue(
+      [self = shared_from_this(), message = std::move(message)]() {
+        if (!self->isTerminated_) {
+          self->receiveMessage(message);
+        }
+      });
+}
+
+void JSIWorker::receiveMessage(JSIClonedValue const &message) {
+  if (!runtime_) {
+    // The script failed to start.
+    return;
+  }
+  auto &runtime = *runtime_;
+
+  try {
+    auto onmessage = runtime.global().getProperty(runtime, "onmessage");
+    if (!onmessage.isObject() ||
+        !onmessage.getObject(runtime).isFunction(runtime)) {
+      return;
+    }
+
+    auto event = Object(runtime);
+    event.setProperty(runtime, "data", message.toValue(runtime));
+    onmessage.getObject(runtime).getFunction(runtime).call(runtime, event);
+  } catch (const JSError &error) {
+    reportError(error.getMessage());
+  } catch (const std::exception &exception) {
+    reportError(exception.what());
+  }
+}
+
+void JSIWorker::terminate() {
+  if (isTerminated_.exchange(true)) {
+    return;
+  }
+
+  // Work which is still queued returns right away, so once the runtime is
+  // destroyed the queue can be quit without waiting for anything.
+  workerQueue_->runOnQueue([self = shared_from_this()]() {
+    self->runtime_.reset();
+    self->hostQueue_->runOnQueue(
+        [self]() { self->workerQueue_->quitSynchronous(); });
+  });
+}
+
+void JSIWorker::sendToHost(std::function<void(JSIWorker &worker)> &&work) {
+  hostQueue_->runOnQueue([self = shared_from_this(), work = std::move(work)]() {
+    if (!self->isTerminated_) {
+      work(*self);
+    }
+  });
+}
+
+void JSIWorker::reportError(std::string message) {
+  sendToHost([message = std::move(message)](JSIWorker &worker) {
+    if (worker.onError_) {
+      worker.onError_(message);
+    }
+  });
+}
+
+namespace {
+
+// The handlers which the host's JS set on a worker object. They are only
+// owned by the object, so that they are released together with it on the
+// host's JS thread.
+struct JSIWorkerHandlers {
+  Value onmessage;
+  Value onerror;
+};
+
+// Calls a handler with an event object which has the given property.
+void dispatchEvent(
+    Runtime &runtime,
+    const Value &handler,
+    const char *name,
+    Value value) {
+  if (!handler.isObject() || !handler.getObject(runtime).isFunction(runtime)) {
+    return;
+  }
+
+  try {
+    auto event = Object(runtime);
+    event.setProperty(runtime, name, std::move(value));
+    handler.getObject(runtime).getFunction(runtime).call(runtime, event);
+  } catch (const JSError &error) {
+    LOG(ERROR) << "Uncaught error in JSIWorker handler: "
+               << error.getMessage();
+  }
+}
+
+class JSIWorkerHostObject : public HostObject {
+ public:
+  JSIWorkerHostObject(
+      std::shared_ptr<JSIWorker> worker,
+      std::shared_ptr<JSIWorkerHandlers> handlers)
+      : worker_(std::move(worker)), handlers_(std::move(handlers)) {}
+
+  ~JSIWorkerHostObject() override {
+    worker_->terminate();
+  }
+
+  Value get(Runtime &runtime, const PropNameID &name) override {
+    auto propName = name.utf8(runtime);
+
+    if (propName == "postMessage") {
+      return Function::createFromHostFunction(
+          runtime,
+          name,
+          1,
+          [worker = worker_](
+              Runtime &rt, const Value &, const Value *args, size_t count) {
+            worker->postMessage(
+                count > 0 ? JSIClonedValue::fromValue(rt, args[0])
+                          : JSIClonedValue());
+            return Value::undefined();
+          });
+    }
+    if (propName == "terminate") {
+      return Function::createFromHostFunction(
+          runtime,
+          name,
+          0,
+          [worker = worker_](Runtime &, const Value &, const Value *, size_t) {
+            worker->terminate();
+            return Value::undefined();
+          });
+    }
+    if (propName == "onmessage") {
+      return Value(runtime, handlers_->onmessage);
+    }
+    if (propName == "onerror") {
+      return Value(runtime, handlers_->onerror);
+    }
+    return Value::undefined();
+  }
+
+  void set(Runtime &runtime, const PropNameID &name, const Value &value)
+      override {
+    auto propName = name.utf8(runtime);
+
+    if (propName == "onmessage") {
+      handlers_->onmessage = Value(runtime, value);
+    } else if (propName == "onerror") {
+      handlers_->onerror = Value(runtime, value);
+    } else {
+      throw JSError(runtime, "Unable to put " + propName + " on a JSIWorker");
+    }
+  }
+
+  std::vector<PropNameID> getPropertyNames(Runtime &runtime) override {
+    return PropNameID::names(
+        runtime, "postMessage", "terminate", "onmessage", "onerror");
+  }
+
+ private:
+  std::shared_ptr<JSIWorker> worker_;
+  std::shared_ptr<JSIWorkerHandlers> handlers_;
+};
+
+} // namespace
+
+void installJSIWorkerBindings(
+    Runtime &runtime,
+    std::shared_ptr<MessageQueueThread> hostQueue,
+    JSIWorkerEnvironment environment) {
+  runtime.global().setProperty(
+      runtime,
+      "__startJSIWorker",
+      Function::createFromHostFunction(
+          runtime,
+          PropNameID::forAscii(runtime, "__startJSIWorker"),
+          1,
+          [hostQueue = std::move(hostQueue),
+           environment = std::move(environment)](
+              Runtime &rt, const Value &, const Value *args, size_t count) {
+            if (count < 1 || !args[0].isString()) {
+              throw JSError(rt, "__startJSIWorker expects a script name");
+            }
+            auto scriptName = args[0].getString(rt).utf8(rt);
+            auto script = environment.scriptLoader(scriptName);
+            if (!script) {
+              throw JSError(rt, "Could not load worker script " + scriptName);
+            }
+
+            auto handlers = std::make_shared<JSIWorkerHandlers>();
+            auto weakHandlers = std::weak_ptr<JSIWorkerHandlers>(handlers);
+            // The handlers only run on the host queue, i.e. on rt's thread.
+            auto worker = JSIWorker::start(
+                environment.runtimeFactory,
+                environment.runtimeInstaller,
+                environment.queueFactory(),
+                hostQueue,
+                std::move(script),
+                scriptName,
+                [&rt, weakHandlers](JSIClonedValue message) {
+                  if (auto handlers = weakHandlers.lock()) {
+                    dispatchEvent(
+                        rt, handlers->onmessage, "data", message.toValue(rt));
+                  }
+                },
+                [&rt, weakHandlers](std::string message) {
+                  if (auto handlers = weakHandlers.lock()) {
+                    dispatchEvent(
+                        rt,
+                        handlers->onerror,
+                        "message",
+                        String::createFromUtf8(rt, message));
+                  }
+                });
+
+            return Object::createFromHostObject(
+                rt,
+                std::make_shared<JSIWorkerHostObject>(
+                    std::move(worker), std::move(handlers)));
+          }));
+}
+
+} // namespace react
+} // namespace facebook
@@ -0,0 +1,154 @@
+//  Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <cxxreact/JSBigString.h>
+#include <cxxreact/MessageQueueThread.h>
+#include <jsi/jsi.h>
+
+namespace facebook {
+namespace react {
+
+// A value copied out of one runtime so that it can be recreated in another
+// one, following the structured clone algorithm for the values JSI can tell
+// apart: primitives, arrays, plain objects (their own enumerable properties),
+// ArrayBuffers and typed arrays. The memory of ArrayBuffers is copied once
+// when cloning, and the ArrayBuffers which toValue() creates use it without
+// copying it again. Host objects (e.g. TurboModules) are shared rather than
+// copied, since they are native objects anyway.
+//
+// Cloning anything else (functions, symbols, or values nested more than
+// kMaxDepth deep, which includes cyclic ones) throws a JSError, like the
+// DataCloneError of postMessage in browsers.
+class JSIClonedValue {
+ public:
+  static constexpr size_t kMaxDepth = 64;
+
+  // The clone of undefined.
+  JSIClonedValue();
+
+  static JSIClonedValue fromValue(
+      jsi::Runtime &runtime,
+      const jsi::Value &value);
+
+  // Recreates the value in the given runtime. ArrayBuffers recreated from the
+  // same clone share its memory, so messages should only be recreated once.
+  jsi::Value toValue(jsi::Runtime &runtime) const;
+
+ private:
+  struct Node;
+
+  explicit JSIClonedValue(std::shared_ptr<const Node> root);
+
+  std::shared_ptr<const Node> root_;
+};
+
+// A JS worker: a secondary runtime with its own MessageQueueThread, which
+// exchanges cloned messages with the runtime which started it. Unlike with
+// ThreadSafeRuntime, the runtimes share nothing but the messages (and the
+// host objects in them), so both run in parallel without any locking.
+//
+// In the worker, `postMessage(value)` sends a message to the host,
+// `onmessage` is called with `{data}` for each message from the host, and
+// `close()` terminates the worker.
+class JSIWorker : public std::enable_shared_from_this<JSIWorker> {
+ public:
+  // Makes the worker's runtime. Executor factories provide one which makes
+  // runtimes configured like their own (see e.g.
+  // HermesExecutorFactory::workerRuntimeFactory).
+  using RuntimeFactory = std::function<std::unique_ptr<jsi::Runtime>()>;
+  // Runs in the worker's runtime before its script. Installing the same
+  // TurboModule binding as the host's makes TurboModules available in
+  // workers; only their synchronous methods can be used there, since
+  // callbacks and promises are invoked on the host's JS thread.
+  using RuntimeInstaller = std::function<void(jsi::Runtime &runtime)>;
+  using MessageHandler = std::function<void(JSIClonedValue message)>;
+  using ErrorHandler = std::function<void(std::string message)>;
+
+  // Creates the runtime on workerQueue and evaluates the script there.
+  // Messages and uncaught errors of the worker are passed to the handlers on
+  // hostQueue.
+  static std::shared_ptr<JSIWorker> start(
+      RuntimeFactory runtimeFactory,
+      RuntimeInstaller runtimeInstaller,
+      std::shared_ptr<MessageQueueThread> workerQueue,
+      std::shared_ptr<MessageQueueThread> hostQueue,
+      std::unique_ptr<const JSBigString> script,
+      std::string sourceURL,
+      MessageHandler onMessage,
+      ErrorHandler onError);
+
+  ~JSIWorker();
+
+  // Queues a message for the worker's `onmessage`. Can be called from any
+  // thread.
+  void postMessage(JSIClonedValue message);
+
+  // Destroys the worker's runtime on its queue. Messages which are still
+  // queued in either direction are dropped. Can be called from any thread.
+  void terminate();
+
+  bool isTerminated() const {
+    return isTerminated_;
+  }
+
+ private:
+  JSIWorker(
+      std::shared_ptr<MessageQueueThread> workerQueue,
+      std::shared_ptr<MessageQueueThread> hostQueue,
+      MessageHandler onMessage,
+      ErrorHandler onError);
+
+  // [worker thread]
+  void initialize(
+      RuntimeFactory runtimeFactory,
+      RuntimeInstaller runtimeInstaller,
+      std::unique_ptr<const JSBigString> script,
+      std::string sourceURL);
+  void receiveMessage(JSIClonedValue const &message);
+
+  // [any thread]
+  void sendToHost(std::function<void(JSIWorker &worker)> &&work);
+  void reportError(std::string message);
+
+  std::shared_ptr<MessageQueueThread> workerQueue_;
+  std::shared_ptr<MessageQueueThread> hostQueue_;
+  // Only called on hostQueue_.
+  MessageHandler onMessage_;
+  ErrorHandler onError_;
+  std::atomic<bool> isTerminated_{false};
+  // Only accessed on workerQueue_.
+  std::unique_ptr<jsi::Runtime> runtime_;
+};
+
+// Everything needed to start workers from JS (see installJSIWorkerBindings).
+struct JSIWorkerEnvironment {
+  JSIWorker::RuntimeFactory runtimeFactory;
+  JSIWorker::RuntimeInstaller runtimeInstaller;
+  // Makes a new queue for each worker.
+  std::function<std::shared_ptr<MessageQueueThread>()> queueFactory;
+  // Loads the script of a worker by name (e.g. from the app's assets).
+  std::function<std::unique_ptr<const JSBigString>(std::string const &name)>
+      scriptLoader;
+};
+
+// Installs `global.__startJSIWorker(scriptName)` in the host runtime, whose
+// JS thread is hostQueue. It returns a worker object with `postMessage(value)`
+// and `terminate()` methods and settable `onmessage` and `onerror`
+// properties, which are called with `{data}` and `{message}`. The worker is
+// terminated once the object is garbage collected.
+void installJSIWorkerBindings(
+    jsi::Runtime &runtime,
+    std::shared_ptr<MessageQueueThread> hostQueue,
+    JSIWorkerEnvironment environment);
+
+} // namespace react
+} // namespace facebook
@@ -5,11 +5,16 @@
 
 #include <algorithm>
 #include <chrono>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <vector>
 #include <time.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 #include <glog/logging.h>
 
 #include "MicroProfiler.h"
@@ -26,43 +31,125 @@ namespace facebook {
 namespace react {
 
 #if !MICRO_PROFILER_STUB_IMPLEMENTATION
+// Bucket i of a histogram counts the sections which took [2^i, 2^(i+1)) ticks
+// (the first one also counts those which took none).
+static constexpr int kHistogramBuckets = 40;
+
+struct SectionStats {
+  std::atomic_uint_fast64_t calls_{0};
+  std::atomic_uint_fast64_t ticks_{0};
+  std::atomic_uint_fast64_t maxTicks_{0};
+  std::atomic_uint_fast64_t childProfileSections_{0};
+  std::atomic_uint_fast32_t histogram_[kHistogramBuckets] = {};
+};
+
+// The counters of one thread. Only that thread writes them, so it does so with
+// plain loads and stores instead of read-modify-write operations, which would
+// cost about as much as what is being measured. Other threads only read them
+// for reports.
 struct TraceData {
   TraceData();
   ~TraceData();
 
-  void addTime(MicroProfilerName name, uint_fast64_t time, uint_fast32_t internalClockCalls);
+  void addTime(MicroProfilerSectionId id, uint_fast64_t ticks, uint_fast32_t childProfileSections);
+  void clear();
 
   std::thread::id threadId_;
-  uint_fast64_t startTime_;
-  std::atomic_uint_fast64_t times_[MicroProfilerName::__LENGTH__] = {};
-  std::atomic_uint_fast32_t calls_[MicroProfilerName::__LENGTH__] = {};
-  std::atomic_uint_fast32_t childProfileSections_[MicroProfilerName::__LENGTH__] = {};
+  SectionStats sections_[MicroProfiler::kMaxSections];
 };
 
+static void clearStats(SectionStats (&sections)[MicroProfiler::kMaxSections]) {
+  for (auto& section : sections) {
+    section.calls_ = 0;
+    section.ticks_ = 0;
+    section.maxTicks_ = 0;
+    section.childProfileSections_ = 0;
+    for (auto& bucket : section.histogram_) {
+      bucket = 0;
+    }
+  }
+}
+
 struct ProfilingImpl {
   std::mutex mutex_;
   std::vector<TraceData*> allTraceData_;
-  bool isProfiling_ = false;
+  std::atomic<bool> isProfiling_{false};
   uint_fast64_t startTime_;
   uint_fast64_t endTime_;
+  double nsPerTick_ = 1.0;
   uint_fast64_t clockOverhead_;
   uint_fast64_t profileSectionOverhead_;
+  // What threads which have exited since profiling started recorded.
+  SectionStats exitedThreads_[MicroProfiler::kMaxSections];
+};
+
+struct SectionRegistry {
+  SectionRegistry() {
+    for (int i = 0; i < MicroProfilerName::__LENGTH__; i++) {
+      names_.push_back(MicroProfiler::profilingNameToString(static_cast<MicroProfilerName>(i)));
+    }
+  }
+
+  std::mutex mutex_;
+  // Indexed by id.
+  std::vector<std::string> names_;
 };
 
 static ProfilingImpl profiling;
-thread_local TraceData myTraceData;
+// The counters are too big for thread local storage, so they are only allocated
+// for threads which actually run profiled sections.
+thread_local std::unique_ptr<TraceData> myTraceData;
 thread_local uint_fast32_t profileSections = 0;
 
+static SectionRegistry& sectionRegistry() {
+  static SectionRegistry registry;
+  return registry;
+}
+
+static TraceData& traceData() {
+  if (!myTraceData) {
+    myTraceData = std::make_unique<TraceData>();
+  }
+  return *myTraceData;
+}
+
 static uint_fast64_t nowNs() {
   struct timespec time;
-  clock_gettime(CLOCK_REALTIME, &time);
+  clock_gettime(CLOCK_MONOTONIC, &time);
   return uint_fast64_t(1000000000) * time.tv_sec + time.tv_nsec;
 }
 
+static inline uint_fast64_t nowTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ticks;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return nowNs();
+#endif
+}
+
 static uint_fast64_t diffNs(uint_fast64_t start, uint_fast64_t end) {
   return end - start;
 }
 
+static uint_fast64_t ticksToNs(uint_fast64_t ticks) {
+  return static_cast<uint_fast64_t>(ticks * profiling.nsPerTick_);
+}
+
+static inline void increase(std::atomic_uint_fast64_t& counter, uint_fast64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static inline int histogramBucket(uint_fast64_t ticks) {
+  if (ticks < 2) {
+    return 0;
+  }
+  return std::min(63 - __builtin_clzll(ticks), kHistogramBuckets - 1);
+}
+
 static std::string formatTimeNs(uint_fast64_t timeNs) {
   std::ostringstream out;
   out.precision(2);
@@ -76,23 +163,23 @@ static std::string formatTimeNs(uint_fast64_t timeNs) {
   return out.str();
 }
 
-MicroProfilerSection::MicroProfilerSection(MicroProfilerName name) :
-    isProfiling_(profiling.isProfiling_),
-    name_(name),
+MicroProfilerSection::MicroProfilerSection(MicroProfilerSectionId id) :
+    isProfiling_(profiling.isProfiling_.load(std::memory_order_relaxed)),
+    id_(id),
     startNumProfileSections_(profileSections) {
   if (!isProfiling_) {
     return;
   }
   profileSections++;
-  startTime_ = nowNs();
+  startTime_ = nowTicks();
 }
 MicroProfilerSection::~MicroProfilerSection() {
-  if (!isProfiling_ || !profiling.isProfiling_) {
+  if (!isProfiling_ || !profiling.isProfiling_.load(std::memory_order_relaxed)) {
     return;
   }
-  auto endTime = nowNs();
+  auto endTime = nowTicks();
   auto endNumProfileSections = profileSections;
-  myTraceData.addTime(name_, endTime - startTime_, endNumProfileSections - startNumProfileSections_ - 1);
+  traceData().addTime(id_, endTime - startTime_, endNumProfileSections - startNumProfileSections_ - 1);
 }
 
 TraceData::TraceData() :
@@ -103,78 +190,192 @@ TraceData::TraceData() :
 
 TraceData::~TraceData() {
   std::lock_guard<std::mutex> lock(profiling.mutex_);
+  for (MicroProfilerSectionId i = 0; i < MicroProfiler::kMaxSections; i++) {
+    auto& from = sections_[i];
+    auto& to = profiling.exitedThreads_[i];
+    increase(to.calls_, from.calls_);
+    increase(to.ticks_, from.ticks_);
+    increase(to.childProfileSections_, from.childProfileSections_);
+    to.maxTicks_ = std::max<uint_fast64_t>(to.maxTicks_, from.maxTicks_);
+    for (int bucket = 0; bucket < kHistogramBuckets; bucket++) {
+      to.histogram_[bucket] += from.histogram_[bucket];
+    }
+  }
   auto& infos = profiling.allTraceData_;
   infos.erase(std::remove(infos.begin(), infos.end(), this), infos.end());
 }
 
-void TraceData::addTime(MicroProfilerName name, uint_fast64_t time, uint_fast32_t childprofileSections) {
-  times_[name] += time;
-  calls_[name]++;
-  childProfileSections_[name] += childprofileSections;
+void TraceData::addTime(MicroProfilerSectionId id, uint_fast64_t ticks, uint_fast32_t childProfileSections) {
+  auto& section = sections_[std::min(id, MicroProfiler::kMaxSections - 1)];
+  increase(section.calls_, 1);
+  increase(section.ticks_, ticks);
+  increase(section.childProfileSections_, childProfileSections);
+  if (ticks > section.maxTicks_.load(std::memory_order_relaxed)) {
+    section.maxTicks_.store(ticks, std::memory_order_relaxed);
+  }
+  auto& bucket = section.histogram_[histogramBucket(ticks)];
+  bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 }
 
-static void printReport() {
-  LOG(ERROR) << "======= MICRO PROFILER REPORT =======";
-  LOG(ERROR) << "- Total Time: " << formatTimeNs(diffNs(profiling.startTime_, profiling.endTime_));
-  LOG(ERROR) << "- Clock Overhead: " << formatTimeNs(profiling.clockOverhead_);
-  LOG(ERROR) << "- Profiler Section Overhead: " << formatTimeNs(profiling.profileSectionOverhead_);
-  for (auto info : profiling.allTraceData_) {
-    LOG(ERROR) << "--- Thread ID 0x" << std::hex << info->threadId_ << " ---";
-    for (int i = 0; i < MicroProfilerName::__LENGTH__; i++) {
-      if (info->times_[i] > 0) {
-        auto totalTime = info->times_[i].load();
-        auto calls = info->calls_[i].load();
-        auto clockOverhead = profiling.clockOverhead_ * calls + profiling.profileSectionOverhead_ * info->childProfileSections_[i].load();
-        if (totalTime < clockOverhead) {
-          LOG(ERROR) << "- " << MicroProfiler::profilingNameToString(static_cast<MicroProfilerName>(i)) << ": "
-              << "ERROR: Total time was " << totalTime << "ns but clock overhead was calculated to be " << clockOverhead << "ns!";
-        } else {
-          auto correctedTime = totalTime - clockOverhead;
-          auto timePerCall = correctedTime / calls;
-          LOG(ERROR) << "- " << MicroProfiler::profilingNameToString(static_cast<MicroProfilerName>(i)) << ": "
-              << formatTimeNs(correctedTime) << " (" << calls << " calls, " << formatTimeNs(timePerCall) << "/call)";
-        }
+void TraceData::clear() {
+  clearStats(sections_);
+}
+
+// The totals of one section over all threads.
+struct SectionReport {
+  std::string name;
+  uint_fast64_t calls = 0;
+  uint_fast64_t ticks = 0;
+  uint_fast64_t maxTicks = 0;
+  uint_fast64_t childProfileSections = 0;
+  uint_fast64_t histogram[kHistogramBuckets] = {};
+
+  void add(const SectionStats& stats) {
+    calls += stats.calls_.load(std::memory_order_relaxed);
+    ticks += stats.ticks_.load(std::memory_order_relaxed);
+    maxTicks = std::max<uint_fast64_t>(maxTicks, stats.maxTicks_.load(std::memory_order_relaxed));
+    childProfileSections += stats.childProfileSections_.load(std::memory_order_relaxed);
+    for (int bucket = 0; bucket < kHistogramBuckets; bucket++) {
+      histogram[bucket] += stats.histogram_[bucket].load(std::memory_order_relaxed);
+    }
+  }
+
+  // The upper bound of the given fraction of the times, from the histogram.
+  uint_fast64_t percentileNs(double fraction) const {
+    uint_fast64_t count = 0;
+    for (int i = 0; i < kHistogramBuckets; i++) {
+      count += histogram[i];
+      if (count >= fraction * calls) {
+        return ticksToNs(uint_fast64_t(2) << i);
       }
     }
+    return ticksToNs(maxTicks);
+  }
+};
+
+// Must be called with profiling.mutex_ held.
+static std::vector<std::string> makeReport(uint_fast64_t endTime) {
+  std::vector<SectionReport> sections;
+  {
+    auto& registry = sectionRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex_);
+    sections.resize(registry.names_.size() + 1);
+    for (size_t i = 0; i < registry.names_.size(); i++) {
+      sections[i].name = registry.names_[i];
+    }
+  }
+  sections.back().name = "(too many sections)";
+
+  auto const addStats = [&](const SectionStats (&stats)[MicroProfiler::kMaxSections]) {
+    for (size_t i = 0; i < sections.size(); i++) {
+      sections[i].add(stats[i < sections.size() - 1 ? i : MicroProfiler::kMaxSections - 1]);
+    }
+  };
+  for (auto info : profiling.allTraceData_) {
+    addStats(info->sections_);
+  }
+  addStats(profiling.exitedThreads_);
+
+  std::sort(sections.begin(), sections.end(), [](const SectionReport& a, const SectionReport& b) {
+    return a.ticks > b.ticks;
+  });
+
+  std::vector<std::string> lines;
+  lines.push_back("======= MICRO PROFILER REPORT =======");
+  lines.push_back("- Total Time: " + formatTimeNs(diffNs(profiling.startTime_, endTime)));
+  lines.push_back("- Clock Overhead: " + formatTimeNs(ticksToNs(profiling.clockOverhead_)));
+  lines.push_back("- Profiler Section Overhead: " + formatTimeNs(ticksToNs(profiling.profileSectionOverhead_)));
+  for (const auto& section : sections) {
+    if (section.calls == 0) {
+      continue;
+    }
+    std::ostringstream line;
+    auto clockOverhead = profiling.clockOverhead_ * section.calls +
+        profiling.profileSectionOverhead_ * section.childProfileSections;
+    if (section.ticks < clockOverhead) {
+      line << "- " << section.name << ": "
+          << "ERROR: Total time was " << ticksToNs(section.ticks) << "ns but clock overhead was calculated to be "
+          << ticksToNs(clockOverhead) << "ns!";
+    } else {
+      auto correctedTime = ticksToNs(section.ticks - clockOverhead);
+      line << "- " << section.name << ": " << formatTimeNs(correctedTime) << " (" << section.calls << " calls, "
+          << formatTimeNs(correctedTime / section.calls) << "/call, p50 < " << formatTimeNs(section.percentileNs(0.5))
+          << ", p90 < " << formatTimeNs(section.percentileNs(0.9)) << ", p99 < "
+          << formatTimeNs(section.percentileNs(0.99)) << ", max " << formatTimeNs(ticksToNs(section.maxTicks)) << ")";
+    }
+    lines.push_back(line.str());
+  }
+  return lines;
+}
+
+static std::string printReport(uint_fast64_t endTime) {
+  std::string report;
+  for (const auto& line : makeReport(endTime)) {
+    LOG(ERROR) << line;
+    report += line + "\n";
   }
+  return report;
 }
 
 static void clearProfiling() {
   CHECK(!profiling.isProfiling_) << "Trying to clear profiling but profiling was already started!";
   for (auto info : profiling.allTraceData_) {
-    for (unsigned int i = 0; i < MicroProfilerName::__LENGTH__; i++) {
-      info->times_[i] = 0;
-      info->calls_[i] = 0;
-      info->childProfileSections_[i] = 0;
-    }
+    info->clear();
   }
+  clearStats(profiling.exitedThreads_);
+}
+
+// The system clock is only sampled here, to convert ticks to time for reports.
+static double calculateNsPerTick() {
+  auto startNs = nowNs();
+  auto startTicks = nowTicks();
+  while (nowNs() - startNs < 10000000) {
+  }
+  auto ticks = nowTicks() - startTicks;
+  return ticks > 0 ? double(nowNs() - startNs) / ticks : 1.0;
 }
 
 static uint_fast64_t calculateClockOverhead() {
   int numCalls = 1000000;
-  uint_fast64_t start = nowNs();
+  uint_fast64_t start = nowTicks();
   for (int i = 0; i < numCalls; i++) {
-    nowNs();
+    nowTicks();
   }
-  uint_fast64_t end = nowNs();
+  uint_fast64_t end = nowTicks();
   return (end - start) / numCalls;
 }
 
 static uint_fast64_t calculateProfileSectionOverhead() {
   int numCalls = 1000000;
-  uint_fast64_t start = nowNs();
+  uint_fast64_t start = nowTicks();
   profiling.isProfiling_ = true;
   for (int i = 0; i < numCalls; i++) {
-    MICRO_PROFILER_SECTION(static_cast<MicroProfilerName>(0));
+    MicroProfilerSection section(static_cast<MicroProfilerName>(0));
   }
-  uint_fast64_t end = nowNs();
+  uint_fast64_t end = nowTicks();
   profiling.isProfiling_ = false;
   return (end - start) / numCalls;
 }
 
+MicroProfilerSectionId MicroProfiler::registerSection(const std::string& name) {
+  auto& registry = sectionRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex_);
+  auto& names = registry.names_;
+  auto it = std::find(names.begin(), names.end(), name);
+  if (it != names.end()) {
+    return it - names.begin();
+  }
+  if (names.size() == kMaxSections - 1) {
+    return kMaxSections - 1;
+  }
+  names.push_back(name);
+  return names.size() - 1;
+}
+
 void MicroProfiler::startProfiling() {
   CHECK(!profiling.isProfiling_) << "Trying to start profiling but profiling was already started!";
 
+  profiling.nsPerTick_ = calculateNsPerTick();
   profiling.clockOverhead_ = calculateClockOverhead();
   profiling.profileSectionOverhead_ = calculateProfileSectionOverhead();
 
@@ -193,7 +394,7 @@ void MicroProfiler::stopProfiling() {
 
   std::lock_guard<std::mutex> lock(profiling.mutex_);
 
-  printReport();
+  printReport(profiling.endTime_);
 
   clearProfiling();
 }
@@ -202,17 +403,31 @@ bool MicroProfiler::isProfiling() {
   return profiling.isProfiling_;
 }
 
+std::string MicroProfiler::dump() {
+  std::lock_guard<std::mutex> lock(profiling.mutex_);
+  return printReport(profiling.isProfiling_ ? nowNs() : profiling.endTime_);
+}
+
 void MicroProfiler::runInternalBenchmark() {
   MicroProfiler::startProfiling();
   for (int i = 0; i < 1000000; i++) {
-    MICRO_PROFILER_SECTION_NAMED(outer, __INTERNAL_BENCHMARK_OUTER);
+    MicroProfilerSection outer(__INTERNAL_BENCHMARK_OUTER);
     {
-      MICRO_PROFILER_SECTION_NAMED(inner, __INTERNAL_BENCHMARK_INNER);
+      MicroProfilerSection inner(__INTERNAL_BENCHMARK_INNER);
     }
   }
   MicroProfiler::stopProfiling();
 }
 #else
+MicroProfilerSection::MicroProfilerSection(MicroProfilerSectionId id) :
+    isProfiling_(false),
+    id_(id) {
+}
+MicroProfilerSection::~MicroProfilerSection() {
+}
+MicroProfilerSectionId MicroProfiler::registerSection(const std::string&) {
+  return 0;
+}
 void MicroProfiler::startProfiling() {
   CHECK(false) << "This platform has a stub implementation of the micro profiler and cannot collect traces";
 }
@@ -221,6 +436,9 @@ void MicroProfiler::stopProfiling() {
 bool MicroProfiler::isProfiling() {
   return false;
 }
+std::string MicroProfiler::dump() {
+  return "";
+}
 void MicroProfiler::runInternalBenchmark() {
 }
 #endif
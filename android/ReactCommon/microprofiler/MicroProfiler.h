@@ -6,16 +6,30 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
 #include <thread>
 
 // #define WITH_MICRO_PROFILER 1
 
+#define MICRO_PROFILER_CONCAT_IMPL(a, b) a##b
+#define MICRO_PROFILER_CONCAT(a, b) MICRO_PROFILER_CONCAT_IMPL(a, b)
+
 #ifdef WITH_MICRO_PROFILER
 #define MICRO_PROFILER_SECTION(name) MicroProfilerSection __b(name)
 #define MICRO_PROFILER_SECTION_NAMED(var_name, name) MicroProfilerSection var_name(name)
+// Profiles the rest of the enclosing scope as the section with the given name
+// (a string literal), which is registered the first time the scope is entered.
+#define MICRO_PROFILER_SCOPE(name)                                                  \
+  static const auto MICRO_PROFILER_CONCAT(__microProfilerId, __LINE__) =           \
+      ::facebook::react::MicroProfiler::registerSection(name);                      \
+  ::facebook::react::MicroProfilerSection MICRO_PROFILER_CONCAT(__microProfiler, __LINE__)( \
+      MICRO_PROFILER_CONCAT(__microProfilerId, __LINE__))
 #else
 #define MICRO_PROFILER_SECTION(name)
 #define MICRO_PROFILER_SECTION_NAMED(var_name, name)
+#define MICRO_PROFILER_SCOPE(name)
 #endif
 
 namespace facebook {
@@ -27,6 +41,10 @@ enum MicroProfilerName {
   __LENGTH__,
 };
 
+// Identifies a section: either a MicroProfilerName or an id returned by
+// MicroProfiler::registerSection.
+using MicroProfilerSectionId = uint_fast32_t;
+
 /**
  * MicroProfiler is a performance profiler for measuring the cumulative impact of
  * a large number of small-ish calls. This is normally a problem for standard profilers
@@ -38,6 +56,12 @@ enum MicroProfilerName {
  * MicroProfiler attempts to be low overhead by 1) aggregating timings in memory and
  * 2) trying to remove estimated profiling overhead from the returned timings.
  *
+ * Timings are measured with the CPU's cycle counter where it can be read cheaply
+ * (rdtsc on x86, cntvct_el0 on arm64), which is calibrated against the system clock
+ * when profiling starts, and with the system clock everywhere else. Each thread
+ * accumulates the count, total and maximum time, and a histogram of the times of
+ * each section into its own counters, without any locks or shared writes.
+ *
  * To remove estimated overhead, at the beginning of each trace we calculate the
  * average cost of profiling a no-op code section, as well as invoking the average
  * cost of invoking the system clock. The former is subtracted out for each child
@@ -45,9 +69,13 @@ enum MicroProfilerName {
  * subtracted from each section, child or not.
  *
  * After MicroProfiler::stopProfiling() is called, a table of tracing data is emitted
- * to glog (which shows up in logcat on Android).
+ * to glog (which shows up in logcat on Android). MicroProfiler::dump() does the same
+ * while profiling continues, e.g. from a dev menu item.
  */
 struct MicroProfiler {
+  // Sections beyond this many are all counted as one "(too many sections)".
+  static constexpr MicroProfilerSectionId kMaxSections = 256;
+
   static const char* profilingNameToString(MicroProfilerName name) {
     switch (name) {
       case __INTERNAL_BENCHMARK_INNER:
@@ -61,20 +89,28 @@ struct MicroProfiler {
     }
   }
 
+  // Returns the id of the section with the given name, registering it if there is
+  // none yet. Meant to be called once per call site (see MICRO_PROFILER_SCOPE), as
+  // it takes a lock.
+  static MicroProfilerSectionId registerSection(const std::string& name);
+
   static void startProfiling();
   static void stopProfiling();
   static bool isProfiling();
+  // Logs the report of everything recorded since profiling started, without
+  // stopping it, and returns it.
+  static std::string dump();
   static void runInternalBenchmark();
 };
 
 class MicroProfilerSection {
 public:
-  MicroProfilerSection(MicroProfilerName name);
+  MicroProfilerSection(MicroProfilerSectionId id);
   ~MicroProfilerSection();
 
 private:
   bool isProfiling_;
-  MicroProfilerName name_;
+  MicroProfilerSectionId id_;
   uint_fast64_t startTime_;
   uint_fast32_t startNumProfileSections_;
 };
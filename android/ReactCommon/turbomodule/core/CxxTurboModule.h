@@ -0,0 +1,279 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <jsi/jsi.h>
+
+#include "TurboModule.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * Converts between jsi::Values and the C++ types which CxxTurboModule methods
+ * take and return: bool, arithmetic types (as JS numbers), std::string,
+ * jsi::Value, and jsi::String, jsi::Object, jsi::Array, jsi::Function and
+ * jsi::ArrayBuffer (which are moved, not copied, when returned).
+ */
+template <typename T, typename Enable = void>
+struct CxxTurboModuleConverter;
+
+namespace detail {
+
+[[noreturn]] inline void throwCxxTurboModuleArgumentError(
+    const char *expectedType,
+    size_t index) {
+  throw std::invalid_argument(
+      "Expected argument " + std::to_string(index) + " to be " +
+      expectedType);
+}
+
+template <typename T>
+struct CxxTurboModuleObjectConverter {
+  static jsi::Value toJSI(jsi::Runtime &, T &&value) {
+    return jsi::Value(std::move(value));
+  }
+  static jsi::Value toJSI(jsi::Runtime &rt, const T &value) {
+    return jsi::Value(rt, value);
+  }
+};
+
+} // namespace detail
+
+template <>
+struct CxxTurboModuleConverter<bool> {
+  static bool fromJSI(jsi::Runtime &, const jsi::Value &value, size_t index) {
+    if (!value.isBool()) {
+      detail::throwCxxTurboModuleArgumentError("a boolean", index);
+    }
+    return value.getBool();
+  }
+  static jsi::Value toJSI(jsi::Runtime &, bool value) {
+    return jsi::Value(value);
+  }
+};
+
+template <typename T>
+struct CxxTurboModuleConverter<
+    T,
+    typename std::enable_if<
+        std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type> {
+  static T fromJSI(jsi::Runtime &, const jsi::Value &value, size_t index) {
+    if (!value.isNumber()) {
+      detail::throwCxxTurboModuleArgumentError("a number", index);
+    }
+    return static_cast<T>(value.getNumber());
+  }
+  static jsi::Value toJSI(jsi::Runtime &, T value) {
+    return jsi::Value(static_cast<double>(value));
+  }
+};
+
+template <>
+struct CxxTurboModuleConverter<std::string> {
+  static std::string
+  fromJSI(jsi::Runtime &rt, const jsi::Value &value, size_t index) {
+    if (!value.isString()) {
+      detail::throwCxxTurboModuleArgumentError("a string", index);
+    }
+    return value.getString(rt).utf8(rt);
+  }
+  static jsi::Value toJSI(jsi::Runtime &rt, const std::string &value) {
+    return jsi::String::createFromUtf8(rt, value);
+  }
+};
+
+template <>
+struct CxxTurboModuleConverter<jsi::Value> {
+  static jsi::Value
+  fromJSI(jsi::Runtime &rt, const jsi::Value &value, size_t) {
+    return jsi::Value(rt, value);
+  }
+  static jsi::Value toJSI(jsi::Runtime &, jsi::Value &&value) {
+    return std::move(value);
+  }
+  static jsi::Value toJSI(jsi::Runtime &rt, const jsi::Value &value) {
+    return jsi::Value(rt, value);
+  }
+};
+
+template <>
+struct CxxTurboModuleConverter<jsi::String>
+    : detail::CxxTurboModuleObjectConverter<jsi::String> {
+  static jsi::String
+  fromJSI(jsi::Runtime &rt, const jsi::Value &value, size_t index) {
+    if (!value.isString()) {
+      detail::throwCxxTurboModuleArgumentError("a string", index);
+    }
+    return value.getString(rt);
+  }
+};
+
+template <>
+struct CxxTurboModuleConverter<jsi::Object>
+    : detail::CxxTurboModuleObjectConverter<jsi::Object> {
+  static jsi::Object
+  fromJSI(jsi::Runtime &rt, const jsi::Value &value, size_t index) {
+    if (!value.isObject()) {
+      detail::throwCxxTurboModuleArgumentError("an Object", index);
+    }
+    return value.getObject(rt);
+  }
+};
+
+template <>
+struct CxxTurboModuleConverter<jsi::Array>
+    : detail::CxxTurboModuleObjectConverter<jsi::Array> {
+  static jsi::Array
+  fromJSI(jsi::Runtime &rt, const jsi::Value &value, size_t index) {
+    if (!(value.isObject() && value.getObject(rt).isArray(rt))) {
+      detail::throwCxxTurboModuleArgumentError("an Array", index);
+    }
+    return value.getObject(rt).getArray(rt);
+  }
+};
+
+template <>
+struct CxxTurboModuleConverter<jsi::Function>
+    : detail::CxxTurboModuleObjectConverter<jsi::Function> {
+  static jsi::Function
+  fromJSI(jsi::Runtime &rt, const jsi::Value &value, size_t index) {
+    if (!(value.isObject() && value.getObject(rt).isFunction(rt))) {
+      detail::throwCxxTurboModuleArgumentError("a Function", index);
+    }
+    return value.getObject(rt).getFunction(rt);
+  }
+};
+
+template <>
+struct CxxTurboModuleConverter<jsi::ArrayBuffer>
+    : detail::CxxTurboModuleObjectConverter<jsi::ArrayBuffer> {
+  static jsi::ArrayBuffer
+  fromJSI(jsi::Runtime &rt, const jsi::Value &value, size_t index) {
+    if (!(value.isObject() && value.getObject(rt).isArrayBuffer(rt))) {
+      detail::throwCxxTurboModuleArgumentError("an ArrayBuffer", index);
+    }
+    return value.getObject(rt).getArrayBuffer(rt);
+  }
+};
+
+namespace detail {
+
+template <typename T>
+using CxxTurboModuleConverterFor =
+    CxxTurboModuleConverter<typename std::decay<T>::type>;
+
+// Calls the method with the converted arguments and converts its result.
+template <typename R>
+struct CxxTurboModuleCall {
+  template <typename Function>
+  static jsi::Value call(jsi::Runtime &rt, Function &&function) {
+    return CxxTurboModuleConverterFor<R>::toJSI(rt, function());
+  }
+};
+
+template <>
+struct CxxTurboModuleCall<void> {
+  template <typename Function>
+  static jsi::Value call(jsi::Runtime &, Function &&function) {
+    function();
+    return jsi::Value::undefined();
+  }
+};
+
+template <typename Module, typename R, typename... Args>
+struct CxxTurboModuleMethodTraits {
+  using ModuleType = Module;
+  using ReturnType = R;
+  static constexpr size_t argCount = sizeof...(Args);
+
+  template <typename Method, size_t... Indices>
+  static jsi::Value invoke(
+      jsi::Runtime &rt,
+      Module &module,
+      Method method,
+      const jsi::Value *args,
+      std::index_sequence<Indices...>) {
+    return CxxTurboModuleCall<R>::call(rt, [&]() -> R {
+      return (module.*method)(
+          rt,
+          CxxTurboModuleConverterFor<Args>::fromJSI(
+              rt, args[Indices], Indices)...);
+    });
+  }
+};
+
+template <typename Method>
+struct CxxTurboModuleMethodTraitsFor;
+
+template <typename Module, typename R, typename... Args>
+struct CxxTurboModuleMethodTraitsFor<R (Module::*)(jsi::Runtime &, Args...)>
+    : CxxTurboModuleMethodTraits<Module, R, Args...> {};
+
+template <typename Module, typename R, typename... Args>
+struct CxxTurboModuleMethodTraitsFor<R (Module::*)(jsi::Runtime &, Args...)
+                                         const>
+    : CxxTurboModuleMethodTraits<const Module, R, Args...> {};
+
+} // namespace detail
+
+/**
+ * Base class for TurboModules implemented in C++. Unlike TurboCxxModule, which
+ * adapts legacy CxxModules, the arguments and results of its methods are
+ * converted between jsi::Values and typed C++ values directly rather than
+ * through folly::dynamic.
+ *
+ * Subclasses register their methods in their constructors, e.g.
+ *
+ *   registerMethod<decltype(&FileSystem::read), &FileSystem::read>("read");
+ *
+ * for `jsi::ArrayBuffer read(jsi::Runtime &rt, const std::string &path)`.
+ * Methods take the runtime first, followed by their arguments by value or
+ * const reference, and are called on the JS thread.
+ */
+class JSI_EXPORT CxxTurboModule : public TurboModule {
+ public:
+  using TurboModule::TurboModule;
+
+ protected:
+  template <typename Method, Method method>
+  void registerMethod(const std::string &name) {
+    using Traits = detail::CxxTurboModuleMethodTraitsFor<Method>;
+    methodMap_[name] = MethodMetadata{Traits::argCount, &invoke<Method, method>};
+  }
+
+ private:
+  template <typename Method, Method method>
+  static jsi::Value invoke(
+      jsi::Runtime &rt,
+      TurboModule &turboModule,
+      const jsi::Value *args,
+      size_t count) {
+    using Traits = detail::CxxTurboModuleMethodTraitsFor<Method>;
+    if (count != Traits::argCount) {
+      throw std::invalid_argument(
+          "TurboModule method called with " + std::to_string(count) +
+          " arguments (expected argument count: " +
+          std::to_string(Traits::argCount) + ").");
+    }
+    return Traits::invoke(
+        rt,
+        static_cast<typename Traits::ModuleType &>(turboModule),
+        method,
+        args,
+        std::make_index_sequence<Traits::argCount>());
+  }
+};
+
+} // namespace react
+} // namespace facebook
@@ -12,37 +12,62 @@ namespace react {
 
 // LongLivedObjectCollection
 LongLivedObjectCollection &LongLivedObjectCollection::get() {
-  static LongLivedObjectCollection instance;
-  return instance;
+  // Leaked, so that objects released during static destruction still find it.
+  static auto instance =
+      new std::shared_ptr<LongLivedObjectCollection>(create());
+  return **instance;
+}
+
+std::shared_ptr<LongLivedObjectCollection> LongLivedObjectCollection::create() {
+  return std::shared_ptr<LongLivedObjectCollection>(
+      new LongLivedObjectCollection());
 }
 
 LongLivedObjectCollection::LongLivedObjectCollection() {}
 
 void LongLivedObjectCollection::add(std::shared_ptr<LongLivedObject> so) {
-  collection_.insert(so);
+  so->collection_ = shared_from_this();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto key = so.get();
+  collection_.emplace(key, std::move(so));
 }
 
 void LongLivedObjectCollection::remove(const LongLivedObject *o) {
-  auto p = collection_.begin();
-  for (; p != collection_.end(); p++) {
-    if (p->get() == o) {
-      break;
+  std::shared_ptr<LongLivedObject> removed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto p = collection_.find(o);
+    if (p == collection_.end()) {
+      return;
     }
-  }
-  if (p != collection_.end()) {
+    removed = std::move(p->second);
     collection_.erase(p);
   }
+  // The object is destroyed (if this was its last owner) outside of the lock,
+  // since its destructor may release other objects.
 }
 
 void LongLivedObjectCollection::clear() {
-  collection_.clear();
+  std::unordered_map<const LongLivedObject *, std::shared_ptr<LongLivedObject>>
+      removed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    removed.swap(collection_);
+  }
+}
+
+size_t LongLivedObjectCollection::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return collection_.size();
 }
 
 // LongLivedObject
 LongLivedObject::LongLivedObject() {}
 
 void LongLivedObject::allowRelease() {
-  LongLivedObjectCollection::get().remove(this);
+  if (auto collection = collection_.lock()) {
+    collection->remove(this);
+  }
 }
 
 } // namespace react
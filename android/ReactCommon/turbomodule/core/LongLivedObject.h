@@ -8,11 +8,14 @@
 #pragma once
 
 #include <memory>
-#include <unordered_set>
+#include <mutex>
+#include <unordered_map>
 
 namespace facebook {
 namespace react {
 
+class LongLivedObjectCollection;
+
 /**
  * A simple wrapper class that can be registered to a collection that keep it
  * alive for extended period of time. This object can be removed from the
@@ -21,7 +24,7 @@ namespace react {
  * The subclass of this class must be created using std::make_shared<T>().
  * After creation, add it to the `LongLivedObjectCollection`.
  * When done with the object, call `allowRelease()` to allow the OS to release
- * it.
+ * it. It's removed from the collection it was added to, in constant time.
  */
 class LongLivedObject {
  public:
@@ -29,14 +32,26 @@ class LongLivedObject {
 
  protected:
   LongLivedObject();
+
+ private:
+  friend class LongLivedObjectCollection;
+
+  // Set by `add()`, which must happen before `allowRelease()`.
+  std::weak_ptr<LongLivedObjectCollection> collection_;
 };
 
 /**
- * A singleton collection for the `LongLivedObject`s.
+ * A collection for the `LongLivedObject`s, keyed by their address.
+ * `get()` is the process-wide collection; `create()` makes one for a single
+ * runtime, whose objects are released together with it.
+ * Can be used from any thread, e.g. module threads resolving promises while
+ * the JS thread adds new ones.
  */
-class LongLivedObjectCollection {
+class LongLivedObjectCollection
+    : public std::enable_shared_from_this<LongLivedObjectCollection> {
  public:
   static LongLivedObjectCollection &get();
+  static std::shared_ptr<LongLivedObjectCollection> create();
 
   LongLivedObjectCollection(LongLivedObjectCollection const &) = delete;
   void operator=(LongLivedObjectCollection const &) = delete;
@@ -44,10 +59,14 @@ class LongLivedObjectCollection {
   void add(std::shared_ptr<LongLivedObject> o);
   void remove(const LongLivedObject *o);
   void clear();
+  size_t size() const;
 
  private:
   LongLivedObjectCollection();
-  std::unordered_set<std::shared_ptr<LongLivedObject>> collection_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<const LongLivedObject *, std::shared_ptr<LongLivedObject>>
+      collection_;
 };
 
 } // namespace react
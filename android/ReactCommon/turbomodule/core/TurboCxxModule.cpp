@@ -22,17 +22,19 @@ static CxxModule::Callback makeTurboCxxModuleCallback(
     jsi::Runtime &runtime,
     std::shared_ptr<CallbackWrapper> callbackWrapper) {
   return [callbackWrapper](std::vector<folly::dynamic> args) {
-    callbackWrapper->jsInvoker().invokeAsync([callbackWrapper, args]() {
-      std::vector<jsi::Value> innerArgs;
-      for (auto &a : args) {
-        innerArgs.push_back(
-            jsi::valueFromDynamic(callbackWrapper->runtime(), a));
-      }
-      callbackWrapper->callback().call(
-          callbackWrapper->runtime(),
-          (const jsi::Value *)innerArgs.data(),
-          innerArgs.size());
-    });
+    callbackWrapper->jsInvoker().invokeAsync(
+        [callbackWrapper, args]() {
+          std::vector<jsi::Value> innerArgs;
+          for (auto &a : args) {
+            innerArgs.push_back(
+                jsi::valueFromDynamic(callbackWrapper->runtime(), a));
+          }
+          callbackWrapper->callback().call(
+              callbackWrapper->runtime(),
+              (const jsi::Value *)innerArgs.data(),
+              innerArgs.size());
+        },
+        callbackWrapper->priority());
   };
 }
 
@@ -132,17 +134,17 @@ jsi::Value TurboCxxModule::invokeMethod(
     }
 
     if (method.callbacks == 1) {
-      auto wrapper = std::make_shared<CallbackWrapper>(
+      auto wrapper = CallbackWrapper::createShared(
           args[count - 1].getObject(runtime).getFunction(runtime),
           runtime,
           jsInvoker_);
       first = makeTurboCxxModuleCallback(runtime, wrapper);
     } else if (method.callbacks == 2) {
-      auto wrapper1 = std::make_shared<CallbackWrapper>(
+      auto wrapper1 = CallbackWrapper::createShared(
           args[count - 2].getObject(runtime).getFunction(runtime),
           runtime,
           jsInvoker_);
-      auto wrapper2 = std::make_shared<CallbackWrapper>(
+      auto wrapper2 = CallbackWrapper::createShared(
           args[count - 1].getObject(runtime).getFunction(runtime),
           runtime,
           jsInvoker_);
@@ -161,9 +163,9 @@ jsi::Value TurboCxxModule::invokeMethod(
         runtime,
         [method, args, count, this](
             jsi::Runtime &rt, std::shared_ptr<Promise> promise) {
-          auto resolveWrapper = std::make_shared<CallbackWrapper>(
+          auto resolveWrapper = CallbackWrapper::createShared(
               promise->resolve_.getFunction(rt), rt, jsInvoker_);
-          auto rejectWrapper = std::make_shared<CallbackWrapper>(
+          auto rejectWrapper = CallbackWrapper::createShared(
               promise->reject_.getFunction(rt), rt, jsInvoker_);
           CxxModule::Callback resolve =
               makeTurboCxxModuleCallback(rt, resolveWrapper);
@@ -8,6 +8,7 @@
 #include "TurboModuleBinding.h"
 
 #include <string>
+#include <utility>
 
 #include <ReactCommon/LongLivedObject.h>
 #include <cxxreact/SystraceSection.h>
@@ -55,14 +56,53 @@ void TurboModuleBinding::invalidate() const {
 
 std::shared_ptr<TurboModule> TurboModuleBinding::getModule(
     const std::string &name) {
+  {
+    std::lock_guard<std::mutex> lock(moduleCacheMutex_);
+    auto iterator = moduleCache_.find(name);
+    if (iterator != moduleCache_.end()) {
+      return iterator->second;
+    }
+  }
+
+  std::lock_guard<std::recursive_mutex> providerLock(moduleProviderMutex_);
+
+  // The module may have been created while waiting for the provider.
+  {
+    std::lock_guard<std::mutex> lock(moduleCacheMutex_);
+    auto iterator = moduleCache_.find(name);
+    if (iterator != moduleCache_.end()) {
+      return iterator->second;
+    }
+  }
+
   std::shared_ptr<TurboModule> module = nullptr;
   {
-    SystraceSection s("TurboModuleBinding::getModule", "module", name);
+    TraceSection<TraceCategory::TurboModules> s(
+        "TurboModuleBinding::getModule", "module", name);
     module = moduleProvider_(name);
   }
+
+  if (module) {
+    std::lock_guard<std::mutex> lock(moduleCacheMutex_);
+    moduleCache_.emplace(name, module);
+  }
   return module;
 }
 
+void TurboModuleBinding::prebindModules(
+    std::shared_ptr<TurboModuleBinding> binding,
+    std::vector<std::string> moduleNames,
+    std::function<void(std::function<void()> &&work)> executor) {
+  executor([binding = std::move(binding),
+            moduleNames = std::move(moduleNames)]() {
+    TraceSection<TraceCategory::TurboModules> s(
+        "TurboModuleBinding::prebindModules");
+    for (const auto &name : moduleNames) {
+      binding->getModule(name);
+    }
+  });
+}
+
 jsi::Value TurboModuleBinding::jsProxy(
     jsi::Runtime &runtime,
     const jsi::Value &thisVal,
@@ -7,7 +7,11 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <ReactCommon/TurboModule.h>
 #include <jsi/jsi.h>
@@ -40,9 +44,23 @@ class TurboModuleBinding {
 
   /**
    * Get an TurboModule instance for the given module name.
+   * Modules which are found are cached, so the provider is only asked once
+   * for each of them.
+   * Can be called in any thread.
    */
   std::shared_ptr<TurboModule> getModule(const std::string &name);
 
+  /**
+   * Creates the given modules with the executor (e.g. on a background thread
+   * while the bundle loads), so that the first lookup from JS finds them in
+   * the cache instead of creating them on the JS thread. The executor must
+   * keep the binding's provider usable (e.g. attached to the JVM).
+   */
+  static void prebindModules(
+      std::shared_ptr<TurboModuleBinding> binding,
+      std::vector<std::string> moduleNames,
+      std::function<void(std::function<void()> &&work)> executor);
+
  private:
   /**
    * A lookup function exposed to JS to get an instance of a TurboModule
@@ -55,6 +73,14 @@ class TurboModuleBinding {
       size_t count);
 
   TurboModuleProviderFunctionType moduleProvider_;
+
+  // Providers aren't thread-safe, so calls to them are serialized (recursively,
+  // since creating a module may look up others). The cache has a lock of its
+  // own, so that lookups of cached modules don't wait while a module is being
+  // created.
+  std::recursive_mutex moduleProviderMutex_;
+  std::mutex moduleCacheMutex_;
+  std::unordered_map<std::string, std::shared_ptr<TurboModule>> moduleCache_;
 };
 
 } // namespace react
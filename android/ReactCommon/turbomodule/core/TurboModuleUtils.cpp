@@ -7,9 +7,86 @@
 
 #include "TurboModuleUtils.h"
 
+#include <vector>
+
 namespace facebook {
 namespace react {
 
+namespace {
+
+// An allocator for single objects which keeps up to kMaxPoolSize freed
+// blocks per thread for reuse. Blocks may be freed on a different thread than
+// the one they were allocated on, which just moves them to that thread's pool.
+template <typename T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  PoolAllocator() = default;
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U> &) {}
+
+  T *allocate(size_t n) {
+    auto &blocks = pool().blocks;
+    if (n == 1 && !blocks.empty()) {
+      void *block = blocks.back();
+      blocks.pop_back();
+      return static_cast<T *>(block);
+    }
+    return static_cast<T *>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T *p, size_t n) {
+    auto &blocks = pool().blocks;
+    if (n == 1 && blocks.size() < kMaxPoolSize) {
+      blocks.push_back(p);
+      return;
+    }
+    ::operator delete(p);
+  }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U> &) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const PoolAllocator<U> &) const {
+    return false;
+  }
+
+ private:
+  static constexpr size_t kMaxPoolSize = 64;
+
+  struct Pool {
+    std::vector<void *> blocks;
+    ~Pool() {
+      for (void *block : blocks) {
+        ::operator delete(block);
+      }
+    }
+  };
+
+  static Pool &pool() {
+    static thread_local Pool pool;
+    return pool;
+  }
+};
+
+} // namespace
+
+std::shared_ptr<CallbackWrapper> CallbackWrapper::createShared(
+    jsi::Function callback,
+    jsi::Runtime &runtime,
+    std::shared_ptr<react::JSCallInvoker> jsInvoker,
+    MessageQueuePriority priority) {
+  return std::allocate_shared<CallbackWrapper>(
+      PoolAllocator<CallbackWrapper>(),
+      std::move(callback),
+      runtime,
+      std::move(jsInvoker),
+      priority);
+}
+
 static jsi::Value deepCopyJSIValue(jsi::Runtime &rt, const jsi::Value &value) {
   if (value.isNull()) {
     return jsi::Value::null();
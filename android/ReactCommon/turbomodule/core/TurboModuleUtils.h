@@ -8,6 +8,7 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 #include <string>
 
 #include <folly/Optional.h>
@@ -58,13 +59,24 @@ class CallbackWrapper {
   };
 
   folly::Optional<Data> data_;
+  MessageQueuePriority priority_;
 
  public:
   CallbackWrapper(
       jsi::Function callback,
       jsi::Runtime &runtime,
-      std::shared_ptr<react::JSCallInvoker> jsInvoker)
-      : data_(Data{std::move(callback), runtime, jsInvoker}) {}
+      std::shared_ptr<react::JSCallInvoker> jsInvoker,
+      MessageQueuePriority priority = MessageQueuePriority::Normal)
+      : data_(Data{std::move(callback), runtime, jsInvoker}),
+        priority_(priority) {}
+
+  // Like std::make_shared, but reuses the memory of recently destroyed
+  // wrappers, since modules which stream results create a lot of them.
+  static std::shared_ptr<CallbackWrapper> createShared(
+      jsi::Function callback,
+      jsi::Runtime &runtime,
+      std::shared_ptr<react::JSCallInvoker> jsInvoker,
+      MessageQueuePriority priority = MessageQueuePriority::Normal);
 
   // Delete the enclosed jsi::Function
   void destroy() {
@@ -89,6 +101,11 @@ class CallbackWrapper {
     assert(!isDestroyed());
     return *(data_->jsInvoker);
   }
+
+  // The priority with which the callback is invoked on the JS thread.
+  MessageQueuePriority priority() const {
+    return priority_;
+  }
 };
 
 } // namespace react
@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <cstring>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -34,8 +35,8 @@ JavaTurboModule::createJavaCallbackFromJSIFunction(
     jsi::Function &function,
     jsi::Runtime &rt,
     std::shared_ptr<JSCallInvoker> jsInvoker) {
-  auto wrapper = std::make_shared<react::CallbackWrapper>(
-      std::move(function), rt, jsInvoker);
+  auto wrapper =
+      react::CallbackWrapper::createShared(std::move(function), rt, jsInvoker);
   callbackWrappers_.insert(wrapper);
 
   std::function<void(folly::dynamic)> fn = [this,
@@ -74,7 +75,7 @@ JavaTurboModule::createJavaCallbackFromJSIFunction(
        */
       wrapper->destroy();
       callbackWrappers_.erase(wrapper);
-    });
+    }, wrapper->priority());
   };
   return JCxxCallbackImpl::newObjectCxxArgs(fn);
 }
@@ -210,8 +211,115 @@ std::vector<std::string> getMethodArgTypesFromSignature(
   return methodArgs;
 }
 
+/**
+ * Classes and methods used to box, unbox and create arguments. They are
+ * looked up once, since FindClass and GetMethodID are slow.
+ */
+struct JavaClasses {
+  jclass doubleClass;
+  jmethodID doubleConstructor;
+  jmethodID doubleValue;
+  jclass booleanClass;
+  jmethodID booleanConstructor;
+  jmethodID booleanValue;
+  jclass promiseClass;
+  jmethodID promiseConstructor;
+
+  static const JavaClasses &get(JNIEnv *env) {
+    static const JavaClasses classes(env);
+    return classes;
+  }
+
+ private:
+  explicit JavaClasses(JNIEnv *env) {
+    doubleClass = findClass(env, "java/lang/Double");
+    doubleConstructor = env->GetMethodID(doubleClass, "<init>", "(D)V");
+    doubleValue = env->GetMethodID(doubleClass, "doubleValue", "()D");
+    booleanClass = findClass(env, "java/lang/Boolean");
+    booleanConstructor = env->GetMethodID(booleanClass, "<init>", "(Z)V");
+    booleanValue = env->GetMethodID(booleanClass, "booleanValue", "()Z");
+    promiseClass = findClass(env, "com/facebook/react/bridge/PromiseImpl");
+    promiseConstructor = env->GetMethodID(
+        promiseClass,
+        "<init>",
+        "(Lcom/facebook/react/bridge/Callback;Lcom/facebook/react/bridge/Callback;)V");
+  }
+
+  static jclass findClass(JNIEnv *env, const char *name) {
+    jclass localClass = env->FindClass(name);
+    auto globalClass = (jclass)env->NewGlobalRef(localClass);
+    env->DeleteLocalRef(localClass);
+    return globalClass;
+  }
+};
+
 } // namespace
 
+JavaTurboModule::JavaType JavaTurboModule::getJavaType(
+    const std::string &type) {
+  if (type == "D") {
+    return JavaType::Double;
+  }
+  if (type == "I") {
+    return JavaType::Int;
+  }
+  if (type == "Z") {
+    return JavaType::Boolean;
+  }
+  if (type == "Ljava/lang/Double;") {
+    return JavaType::BoxedDouble;
+  }
+  if (type == "Ljava/lang/Boolean;") {
+    return JavaType::BoxedBoolean;
+  }
+  if (type == "Ljava/lang/String;") {
+    return JavaType::String;
+  }
+  if (type == "Lcom/facebook/react/bridge/ReadableArray;") {
+    return JavaType::ReadableArray;
+  }
+  if (type == "Lcom/facebook/react/bridge/ReadableMap;") {
+    return JavaType::ReadableMap;
+  }
+  if (type == "Lcom/facebook/react/bridge/Callback;") {
+    return JavaType::Callback;
+  }
+  if (type == "Lcom/facebook/react/bridge/Promise;") {
+    return JavaType::Promise;
+  }
+  if (type == "Ljava/nio/ByteBuffer;") {
+    return JavaType::ByteBuffer;
+  }
+  return JavaType::Other;
+}
+
+const JavaTurboModule::MethodMetadata &JavaTurboModule::getMethodMetadata(
+    JNIEnv *env,
+    const std::string &methodName,
+    const std::string &methodSignature) {
+  auto it = methodMetadata_.find(methodName);
+  if (it != methodMetadata_.end()) {
+    return it->second;
+  }
+
+  MethodMetadata method;
+  jclass cls = env->GetObjectClass(instance_.get());
+  method.methodID =
+      env->GetMethodID(cls, methodName.c_str(), methodSignature.c_str());
+  env->DeleteLocalRef(cls);
+  // Not caching methods which don't exist keeps reporting them on every call.
+  FACEBOOK_JNI_THROW_PENDING_EXCEPTION();
+
+  method.argTypeNames = getMethodArgTypesFromSignature(methodSignature);
+  for (const auto &type : method.argTypeNames) {
+    method.argTypes.push_back(getJavaType(type));
+  }
+  method.returnType = getJavaType(
+      methodSignature.substr(methodSignature.find_last_of(')') + 1));
+
+  return methodMetadata_.emplace(methodName, std::move(method)).first->second;
+}
+
 // fnjni already does this conversion, but since we are using plain JNI, this
 // needs to be done again
 // TODO (axe) Reuse existing implementation as needed - the exist in
@@ -219,15 +327,15 @@ std::vector<std::string> getMethodArgTypesFromSignature(
 std::vector<jvalue> JavaTurboModule::convertJSIArgsToJNIArgs(
     JNIEnv *env,
     jsi::Runtime &rt,
-    std::string methodName,
-    std::vector<std::string> methodArgTypes,
+    const std::string &methodName,
+    const MethodMetadata &method,
     const jsi::Value *args,
     size_t count,
     std::shared_ptr<JSCallInvoker> jsInvoker,
     TurboModuleMethodValueKind valueKind) {
   unsigned int expectedArgumentCount = valueKind == PromiseKind
-      ? methodArgTypes.size() - 1
-      : methodArgTypes.size();
+      ? method.argTypes.size() - 1
+      : method.argTypes.size();
 
   if (expectedArgumentCount != count) {
     throw JavaTurboModuleInvalidArgumentCountException(
@@ -238,12 +346,12 @@ std::vector<jvalue> JavaTurboModule::convertJSIArgsToJNIArgs(
       std::vector<jvalue>(valueKind == PromiseKind ? count + 1 : count);
 
   for (unsigned int argIndex = 0; argIndex < count; argIndex += 1) {
-    std::string type = methodArgTypes.at(argIndex);
+    JavaType type = method.argTypes.at(argIndex);
 
     const jsi::Value *arg = &args[argIndex];
     jvalue *jarg = &jargs[argIndex];
 
-    if (type == "D") {
+    if (type == JavaType::Double) {
       if (!arg->isNumber()) {
         throw JavaTurboModuleArgumentConversionException(
             "number", argIndex, methodName, arg, &rt);
@@ -253,7 +361,17 @@ std::vector<jvalue> JavaTurboModule::convertJSIArgsToJNIArgs(
       continue;
     }
 
-    if (type == "Z") {
+    if (type == JavaType::Int) {
+      if (!arg->isNumber()) {
+        throw JavaTurboModuleArgumentConversionException(
+            "number", argIndex, methodName, arg, &rt);
+      }
+
+      jarg->i = (jint)arg->getNumber();
+      continue;
+    }
+
+    if (type == JavaType::Boolean) {
       if (!arg->isBool()) {
         throw JavaTurboModuleArgumentConversionException(
             "boolean", argIndex, methodName, arg, &rt);
@@ -263,13 +381,9 @@ std::vector<jvalue> JavaTurboModule::convertJSIArgsToJNIArgs(
       continue;
     }
 
-    if (!(type == "Ljava/lang/Double;" || type == "Ljava/lang/Boolean;" ||
-          type == "Ljava/lang/String;" ||
-          type == "Lcom/facebook/react/bridge/ReadableArray;" ||
-          type == "Lcom/facebook/react/bridge/Callback;" ||
-          type == "Lcom/facebook/react/bridge/ReadableMap;")) {
+    if (type == JavaType::Promise || type == JavaType::Other) {
       throw JavaTurboModuleInvalidArgumentTypeException(
-          type, argIndex, methodName);
+          method.argTypeNames.at(argIndex), argIndex, methodName);
     }
 
     if (arg->isNull() || arg->isUndefined()) {
@@ -277,35 +391,33 @@ std::vector<jvalue> JavaTurboModule::convertJSIArgsToJNIArgs(
       continue;
     }
 
-    if (type == "Ljava/lang/Double;") {
+    if (type == JavaType::BoxedDouble) {
       if (!arg->isNumber()) {
         throw JavaTurboModuleArgumentConversionException(
             "number", argIndex, methodName, arg, &rt);
       }
 
-      jclass doubleClass = env->FindClass("java/lang/Double");
-      jmethodID doubleConstructor =
-          env->GetMethodID(doubleClass, "<init>", "(D)V");
-      jarg->l =
-          env->NewObject(doubleClass, doubleConstructor, arg->getNumber());
+      const auto &classes = JavaClasses::get(env);
+      jarg->l = env->NewObject(
+          classes.doubleClass, classes.doubleConstructor, arg->getNumber());
       continue;
     }
 
-    if (type == "Ljava/lang/Boolean;") {
+    if (type == JavaType::BoxedBoolean) {
       if (!arg->isBool()) {
         throw JavaTurboModuleArgumentConversionException(
             "boolean", argIndex, methodName, arg, &rt);
       }
 
-      jclass booleanClass = env->FindClass("java/lang/Boolean");
-      jmethodID booleanConstructor =
-          env->GetMethodID(booleanClass, "<init>", "(Z)V");
-      jarg->l =
-          env->NewObject(booleanClass, booleanConstructor, arg->getBool());
+      const auto &classes = JavaClasses::get(env);
+      jarg->l = env->NewObject(
+          classes.booleanClass,
+          classes.booleanConstructor,
+          (jboolean)arg->getBool());
       continue;
     }
 
-    if (type == "Ljava/lang/String;") {
+    if (type == JavaType::String) {
       if (!arg->isString()) {
         throw JavaTurboModuleArgumentConversionException(
             "string", argIndex, methodName, arg, &rt);
@@ -315,7 +427,21 @@ std::vector<jvalue> JavaTurboModule::convertJSIArgsToJNIArgs(
       continue;
     }
 
-    if (type == "Lcom/facebook/react/bridge/ReadableArray;") {
+    if (type == JavaType::ByteBuffer) {
+      if (!(arg->isObject() && arg->getObject(rt).isArrayBuffer(rt))) {
+        throw JavaTurboModuleArgumentConversionException(
+            "ArrayBuffer", argIndex, methodName, arg, &rt);
+      }
+
+      // The buffer refers to the memory of the ArrayBuffer, so it's only valid
+      // until the method returns.
+      auto arrayBuffer = arg->getObject(rt).getArrayBuffer(rt);
+      jarg->l = env->NewDirectByteBuffer(
+          arrayBuffer.data(rt), (jlong)arrayBuffer.size(rt));
+      continue;
+    }
+
+    if (type == JavaType::ReadableArray) {
       if (!(arg->isObject() && arg->getObject(rt).isArray(rt))) {
         throw JavaTurboModuleArgumentConversionException(
             "Array", argIndex, methodName, arg, &rt);
@@ -328,7 +454,7 @@ std::vector<jvalue> JavaTurboModule::convertJSIArgsToJNIArgs(
       continue;
     }
 
-    if (type == "Lcom/facebook/react/bridge/Callback;") {
+    if (type == JavaType::Callback) {
       if (!(arg->isObject() && arg->getObject(rt).isFunction(rt))) {
         throw JavaTurboModuleArgumentConversionException(
             "Function", argIndex, methodName, arg, &rt);
@@ -339,7 +465,7 @@ std::vector<jvalue> JavaTurboModule::convertJSIArgsToJNIArgs(
       continue;
     }
 
-    if (type == "Lcom/facebook/react/bridge/ReadableMap;") {
+    if (type == JavaType::ReadableMap) {
       if (!(arg->isObject())) {
         throw JavaTurboModuleArgumentConversionException(
             "Object", argIndex, methodName, arg, &rt);
@@ -373,6 +499,28 @@ jsi::Value convertFromJMapToValue(JNIEnv *env, jsi::Runtime &rt, jobject arg) {
   return jsi::valueFromDynamic(rt, result->cthis()->consume());
 }
 
+jsi::Value
+convertFromJByteBufferToValue(JNIEnv *env, jsi::Runtime &rt, jobject buffer) {
+  // jsi can't wrap memory it doesn't own into an ArrayBuffer, so the contents
+  // are copied into a new one. Only direct buffers have an address to copy
+  // from.
+  auto data = (uint8_t *)env->GetDirectBufferAddress(buffer);
+  jlong size = env->GetDirectBufferCapacity(buffer);
+  if (data == nullptr || size < 0) {
+    throw std::invalid_argument(
+        "TurboModule methods can only return direct ByteBuffers");
+  }
+
+  auto arrayBuffer =
+      rt.global()
+          .getPropertyAsFunction(rt, "ArrayBuffer")
+          .callAsConstructor(rt, (double)size)
+          .getObject(rt)
+          .getArrayBuffer(rt);
+  memcpy(arrayBuffer.data(rt), data, (size_t)size);
+  return jsi::Value(rt, arrayBuffer);
+}
+
 jsi::Value JavaTurboModule::invokeJavaMethod(
     jsi::Runtime &runtime,
     TurboModuleMethodValueKind valueKind,
@@ -383,9 +531,9 @@ jsi::Value JavaTurboModule::invokeJavaMethod(
   JNIEnv *env = jni::Environment::current();
   auto instance = instance_.get();
 
-  jclass cls = env->GetObjectClass(instance);
-  jmethodID methodID =
-      env->GetMethodID(cls, methodName.c_str(), methodSignature.c_str());
+  const MethodMetadata &method =
+      getMethodMetadata(env, methodName, methodSignature);
+  jmethodID methodID = method.methodID;
 
   // TODO(T43933641): Refactor to remove this special-casing
   if (methodName == "getConstants") {
@@ -399,13 +547,11 @@ jsi::Value JavaTurboModule::invokeJavaMethod(
     return convertFromJMapToValue(env, runtime, constantsMap);
   }
 
-  std::vector<std::string> methodArgTypes =
-      getMethodArgTypesFromSignature(methodSignature);
   std::vector<jvalue> jargs = convertJSIArgsToJNIArgs(
       env,
       runtime,
       methodName,
-      methodArgTypes,
+      method,
       args,
       count,
       jsInvoker_,
@@ -419,9 +565,7 @@ jsi::Value JavaTurboModule::invokeJavaMethod(
       return jsi::Value::undefined();
     }
     case BooleanKind: {
-      std::string returnType =
-          methodSignature.substr(methodSignature.find_last_of(')') + 1);
-      if (returnType == "Ljava/lang/Boolean;") {
+      if (method.returnType == JavaType::BoxedBoolean) {
         auto returnObject =
             (jobject)env->CallObjectMethodA(instance, methodID, jargs.data());
         FACEBOOK_JNI_THROW_PENDING_EXCEPTION();
@@ -430,11 +574,8 @@ jsi::Value JavaTurboModule::invokeJavaMethod(
           return jsi::Value::null();
         }
 
-        jclass booleanClass = env->FindClass("java/lang/Boolean");
-        jmethodID booleanValueMethod =
-            env->GetMethodID(booleanClass, "booleanValue", "()Z");
-        bool returnBoolean =
-            (bool)env->CallBooleanMethod(returnObject, booleanValueMethod);
+        bool returnBoolean = (bool)env->CallBooleanMethod(
+            returnObject, JavaClasses::get(env).booleanValue);
         FACEBOOK_JNI_THROW_PENDING_EXCEPTION();
 
         return jsi::Value(returnBoolean);
@@ -447,9 +588,7 @@ jsi::Value JavaTurboModule::invokeJavaMethod(
       return jsi::Value(returnBoolean);
     }
     case NumberKind: {
-      std::string returnType =
-          methodSignature.substr(methodSignature.find_last_of(')') + 1);
-      if (returnType == "Ljava/lang/Double;") {
+      if (method.returnType == JavaType::BoxedDouble) {
         auto returnObject =
             (jobject)env->CallObjectMethodA(instance, methodID, jargs.data());
         FACEBOOK_JNI_THROW_PENDING_EXCEPTION();
@@ -458,16 +597,21 @@ jsi::Value JavaTurboModule::invokeJavaMethod(
           return jsi::Value::null();
         }
 
-        jclass doubleClass = env->FindClass("java/lang/Double");
-        jmethodID doubleValueMethod =
-            env->GetMethodID(doubleClass, "doubleValue", "()D");
-        double returnDouble =
-            (double)env->CallDoubleMethod(returnObject, doubleValueMethod);
+        double returnDouble = (double)env->CallDoubleMethod(
+            returnObject, JavaClasses::get(env).doubleValue);
         FACEBOOK_JNI_THROW_PENDING_EXCEPTION();
 
         return jsi::Value(returnDouble);
       }
 
+      if (method.returnType == JavaType::Int) {
+        int returnInt =
+            (int)env->CallIntMethodA(instance, methodID, jargs.data());
+        FACEBOOK_JNI_THROW_PENDING_EXCEPTION();
+
+        return jsi::Value(returnInt);
+      }
+
       double returnDouble =
           (double)env->CallDoubleMethodA(instance, methodID, jargs.data());
       FACEBOOK_JNI_THROW_PENDING_EXCEPTION();
@@ -496,6 +640,9 @@ jsi::Value JavaTurboModule::invokeJavaMethod(
         return jsi::Value::null();
       }
       auto jResult = jni::adopt_local(returnObject);
+      if (method.returnType == JavaType::ByteBuffer) {
+        return convertFromJByteBufferToValue(env, runtime, jResult.get());
+      }
       auto result = jni::static_ref_cast<NativeMap::jhybridobject>(jResult);
       return jsi::valueFromDynamic(runtime, result->cthis()->consume());
     }
@@ -542,13 +689,12 @@ jsi::Value JavaTurboModule::invokeJavaMethod(
                               rejectJSIFn, runtime, jsInvoker_)
                               .release();
 
-            jclass cls =
-                env->FindClass("com/facebook/react/bridge/PromiseImpl");
-            jmethodID constructor = env->GetMethodID(
-                cls,
-                "<init>",
-                "(Lcom/facebook/react/bridge/Callback;Lcom/facebook/react/bridge/Callback;)V");
-            jobject promise = env->NewObject(cls, constructor, resolve, reject);
+            const auto &classes = JavaClasses::get(env);
+            jobject promise = env->NewObject(
+                classes.promiseClass,
+                classes.promiseConstructor,
+                resolve,
+                reject);
 
             jargs[count].l = promise;
             env->CallVoidMethodA(instance, methodID, jargs.data());
@@ -8,7 +8,9 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <ReactCommon/TurboModule.h>
 #include <ReactCommon/TurboModuleUtils.h>
@@ -46,8 +48,48 @@ class JSI_EXPORT JavaTurboModule : public TurboModule {
   virtual ~JavaTurboModule();
 
  private:
+  /**
+   * The kinds of arguments and return values which JavaTurboModules support,
+   * parsed from JNI method signatures.
+   */
+  enum class JavaType {
+    Double,
+    Int,
+    Boolean,
+    BoxedDouble,
+    BoxedBoolean,
+    String,
+    ReadableArray,
+    ReadableMap,
+    Callback,
+    Promise,
+    // Passed to and from JS as an ArrayBuffer.
+    ByteBuffer,
+    Other,
+  };
+
+  /**
+   * Everything needed to call a method, which is looked up and parsed from
+   * its signature on its first call only.
+   */
+  struct MethodMetadata {
+    jmethodID methodID;
+    std::vector<JavaType> argTypes;
+    // The JNI type of each argument, for error messages.
+    std::vector<std::string> argTypeNames;
+    JavaType returnType;
+  };
+
   jni::global_ref<JTurboModule> instance_;
   std::unordered_set<std::shared_ptr<CallbackWrapper>> callbackWrappers_;
+  // Only used from the JS thread, like invokeJavaMethod().
+  std::unordered_map<std::string, MethodMetadata> methodMetadata_;
+
+  static JavaType getJavaType(const std::string &type);
+  const MethodMetadata &getMethodMetadata(
+      JNIEnv *env,
+      const std::string &methodName,
+      const std::string &methodSignature);
 
   /**
    * This method must be called from the JS Thread, since it accesses
@@ -60,8 +102,8 @@ class JSI_EXPORT JavaTurboModule : public TurboModule {
   std::vector<jvalue> convertJSIArgsToJNIArgs(
       JNIEnv *env,
       jsi::Runtime &rt,
-      std::string methodName,
-      std::vector<std::string> methodArgTypes,
+      const std::string &methodName,
+      const MethodMetadata &method,
       const jsi::Value *args,
       size_t count,
       std::shared_ptr<JSCallInvoker> jsInvoker,
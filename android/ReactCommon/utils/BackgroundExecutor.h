@@ -0,0 +1,23 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <functional>
+
+namespace facebook {
+namespace react {
+
+/*
+ * Takes a function and calls it asynchronously on a background thread.
+ * Functions must be called one at a time and in the order they were given
+ * (i.e. the implementation is a serial queue), so work scheduled on it can
+ * rely on the order of scheduling.
+ */
+using BackgroundExecutor =
+    std::function<void(std::function<void()> &&callback)>;
+
+} // namespace react
+} // namespace facebook
@@ -5,9 +5,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <cassert>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <typeinfo>
 
 #include <better/map.h>
 #include <better/mutex.h>
@@ -19,11 +22,47 @@ namespace react {
 /*
  * General purpose dependency injection container.
  * Instance types must be copyable.
+ * Once set up, the container can be frozen: it can't be changed anymore and
+ * reads from then on don't lock. Hot paths should resolve a `Key` once instead
+ * of looking an instance up by name every time.
  */
 class ContextContainer final {
  public:
   using Shared = std::shared_ptr<ContextContainer const>;
 
+  /*
+   * A resolved reference to an instance in a container, which refers to the
+   * instance directly: dereferencing it takes neither a lock nor a lookup.
+   * Instances are never replaced or removed, so a key stays valid for as long
+   * as it exists (even after the container is gone).
+   * A default-constructed key (or one for a missing instance) is empty.
+   */
+  template <typename T>
+  class Key final {
+   public:
+    Key() = default;
+
+    T const &operator*() const {
+      assert(instance_ && "Key doesn't refer to an instance.");
+      return *instance_;
+    }
+
+    T const *operator->() const {
+      return &operator*();
+    }
+
+    explicit operator bool() const {
+      return instance_ != nullptr;
+    }
+
+   private:
+    friend class ContextContainer;
+
+    Key(std::shared_ptr<T const> instance) : instance_(std::move(instance)) {}
+
+    std::shared_ptr<T const> instance_;
+  };
+
   /*
    * Registers an instance of the particular type `T` in the container
    * using the provided `key`. Only one instance can be registered per key.
@@ -39,6 +78,11 @@ class ContextContainer final {
   void insert(std::string const &key, T const &instance) const {
     std::unique_lock<better::shared_mutex> lock(mutex_);
 
+    if (frozen_.load(std::memory_order_relaxed)) {
+      assert(false && "ContextContainer is frozen.");
+      return;
+    }
+
     instances_.insert({key, std::make_shared<T>(instance)});
 
 #ifndef NDEBUG
@@ -53,7 +97,7 @@ class ContextContainer final {
    */
   template <typename T>
   T at(std::string const &key) const {
-    std::shared_lock<better::shared_mutex> lock(mutex_);
+    auto lock = lockForReading();
 
     assert(
         instances_.find(key) != instances_.end() &&
@@ -71,7 +115,7 @@ class ContextContainer final {
    */
   template <typename T>
   better::optional<T> find(std::string const &key) const {
-    std::shared_lock<better::shared_mutex> lock(mutex_);
+    auto lock = lockForReading();
 
     auto iterator = instances_.find(key);
     if (iterator == instances_.end()) {
@@ -85,9 +129,52 @@ class ContextContainer final {
     return *std::static_pointer_cast<T>(iterator->second);
   }
 
+  /*
+   * Returns a key for the previously registered instance of the particular
+   * type `T` for `key`, which is empty if the instance could not be found.
+   */
+  template <typename T>
+  Key<T> resolve(std::string const &key) const {
+    auto lock = lockForReading();
+
+    auto iterator = instances_.find(key);
+    if (iterator == instances_.end()) {
+      return {};
+    }
+
+    assert(
+        typeNames_.at(key) == typeid(T).name() &&
+        "ContextContainer stores an instance of different type for given key.");
+
+    return Key<T>(std::static_pointer_cast<T const>(iterator->second));
+  }
+
+  /*
+   * Makes the container immutable: `insert` does nothing from then on and
+   * reads don't take the lock anymore.
+   * Must be called once setting up the container is done (e.g. once the
+   * `Scheduler` is built), before it's shared with other threads.
+   */
+  void freeze() const {
+    std::unique_lock<better::shared_mutex> lock(mutex_);
+    frozen_.store(true, std::memory_order_release);
+  }
+
  private:
+  /*
+   * Returns a shared lock of `mutex_`, or an empty lock if the container is
+   * frozen (and therefore can't change anymore).
+   */
+  std::shared_lock<better::shared_mutex> lockForReading() const {
+    if (frozen_.load(std::memory_order_acquire)) {
+      return {};
+    }
+    return std::shared_lock<better::shared_mutex>(mutex_);
+  }
+
   mutable better::shared_mutex mutex_;
-  // Protected by mutex_`.
+  mutable std::atomic<bool> frozen_{false};
+  // Protected by mutex_` until frozen.
   mutable better::map<std::string, std::shared_ptr<void>> instances_;
 #ifndef NDEBUG
   mutable better::map<std::string, std::string> typeNames_;
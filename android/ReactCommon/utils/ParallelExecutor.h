@@ -0,0 +1,24 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace facebook {
+namespace react {
+
+/*
+ * Calls `task(index)` for every index in [0, count) and returns once all of
+ * them have run. The calls may run concurrently, on any threads (including
+ * the calling one), and in any order. If calls throw, one of their exceptions
+ * is rethrown once all of them have run.
+ */
+using ParallelExecutor = std::function<
+    void(size_t count, std::function<void(size_t index)> const &task)>;
+
+} // namespace react
+} // namespace facebook
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace facebook {
+namespace react {
+
+/*
+ * Standard-compliant allocator that recycles the memory of single objects
+ * through a per-thread free list instead of returning it to the heap.
+ * Is meant to be used with `std::allocate_shared` for objects that are
+ * created and destroyed at a high rate (e.g. lists of children of shadow
+ * nodes that every commit clones); memory freed on one thread is reused by
+ * allocations on that thread. Every free list keeps at most `maxFreeBlocks`
+ * blocks; the rest goes back to the heap.
+ */
+template <typename T, int maxFreeBlocks = 1024>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = PoolAllocator<U, maxFreeBlocks>;
+  };
+
+  PoolAllocator() noexcept = default;
+
+  template <typename U>
+  PoolAllocator(PoolAllocator<U, maxFreeBlocks> const &) noexcept {}
+
+  T *allocate(size_t count) {
+    auto &freeList = getFreeList();
+    if (count != 1 || freeList.head == nullptr) {
+      return static_cast<T *>(::operator new(count * sizeof(Block)));
+    }
+
+    auto block = freeList.head;
+    freeList.head = block->next;
+    freeList.size--;
+    return reinterpret_cast<T *>(block);
+  }
+
+  void deallocate(T *pointer, size_t count) noexcept {
+    auto &freeList = getFreeList();
+    if (count != 1 || freeList.size == maxFreeBlocks) {
+      ::operator delete(pointer);
+      return;
+    }
+
+    auto block = reinterpret_cast<Block *>(pointer);
+    block->next = freeList.head;
+    freeList.head = block;
+    freeList.size++;
+  }
+
+  template <typename U>
+  bool operator==(PoolAllocator<U, maxFreeBlocks> const &) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(PoolAllocator<U, maxFreeBlocks> const &) const noexcept {
+    return false;
+  }
+
+ private:
+  union Block {
+    Block *next;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  struct FreeList {
+    Block *head{nullptr};
+    int size{0};
+
+    ~FreeList() {
+      while (head) {
+        auto next = head->next;
+        ::operator delete(head);
+        head = next;
+      }
+    }
+  };
+
+  static FreeList &getFreeList() {
+    static thread_local FreeList freeList;
+    return freeList;
+  }
+};
+
+} // namespace react
+} // namespace facebook
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace facebook {
+namespace react {
+
+/*
+ * `RCUSharedFunction` is a `SharedFunction` for callbacks which are called
+ * very often from several threads (e.g. for every event or state update) but
+ * replaced rarely. Calling it does not lock anything, it's only an acquire
+ * load of a pointer to the current (immutable) function.
+ *
+ * `assign` publishes a new function without touching the previous one, since
+ * other threads may still be calling it. Replaced functions (and their
+ * captured values) are only destroyed when the last copy of the
+ * `RCUSharedFunction` is, so every `assign` keeps its function alive until
+ * then; it shouldn't be used for functions which are replaced over and over.
+ */
+template <typename ReturnT = void, typename... ArgumentT>
+class RCUSharedFunction {
+  using T = ReturnT(ArgumentT...);
+
+  struct Holder {
+    Holder(std::function<T> &&function) : function(std::move(function)) {}
+    std::function<T> const function;
+  };
+
+  struct State {
+    State(std::function<T> &&function) {
+      holders.push_back(std::make_unique<Holder const>(std::move(function)));
+      current.store(holders.back().get(), std::memory_order_relaxed);
+    }
+
+    std::atomic<Holder const *> current;
+    // Every function that was assigned, including the current one.
+    std::vector<std::unique_ptr<Holder const>> holders;
+    std::mutex mutex{};
+  };
+
+ public:
+  RCUSharedFunction(std::function<T> &&function = nullptr)
+      : state_(std::make_shared<State>(std::move(function))) {}
+
+  RCUSharedFunction(const RCUSharedFunction &other) = default;
+  RCUSharedFunction(RCUSharedFunction &&other) noexcept = default;
+
+  RCUSharedFunction &operator=(const RCUSharedFunction &other) = default;
+  RCUSharedFunction &operator=(RCUSharedFunction &&other) noexcept = default;
+
+  void assign(std::function<T> function) const {
+    auto holder = std::make_unique<Holder const>(std::move(function));
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->current.store(holder.get(), std::memory_order_release);
+    state_->holders.push_back(std::move(holder));
+  }
+
+  ReturnT operator()(ArgumentT... args) const {
+    return state_->current.load(std::memory_order_acquire)->function(args...);
+  }
+
+ private:
+  std::shared_ptr<State> state_;
+};
+
+} // namespace react
+} // namespace facebook
@@ -23,6 +23,8 @@ namespace react {
  * scenarios, such as:
  * - When captured by `std::function` arguments are not copyable;
  * - When we need to replace the content of the callable later on the go.
+ * Callbacks on hot paths which are rarely replaced can use `RCUSharedFunction`
+ * instead, which calls without taking the lock.
  */
 template <typename ReturnT = void, typename... ArgumentT>
 class SharedFunction {
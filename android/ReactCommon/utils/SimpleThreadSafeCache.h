@@ -5,9 +5,17 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include <better/optional.h>
 #include <folly/container/EvictingCacheMap.h>
@@ -15,30 +23,86 @@
 namespace facebook {
 namespace react {
 
+/*
+ * Counters of a `SimpleThreadSafeCache`, for diagnostics.
+ */
+struct SimpleThreadSafeCacheStatistics {
+  int64_t hitCount;
+  int64_t missCount;
+  int64_t evictionCount;
+};
+
 /*
  * Simple thread-safe LRU cache.
+ * Keys are distributed between `shardCount` independently locked shards, each
+ * of which keeps the least recently used entries among its keys.
+ * Values are generated outside of the locks; concurrent requests of a key that
+ * is being generated wait for the result instead of generating it again.
+ * `maxSize` is the default capacity which can be overridden per instance.
  */
-template<typename KeyT, typename ValueT, int maxSize>
+template<typename KeyT, typename ValueT, int maxSize, int shardCount = 8>
 class SimpleThreadSafeCache {
 public:
-  SimpleThreadSafeCache() : map_{maxSize} {}
+  SimpleThreadSafeCache() : SimpleThreadSafeCache(maxSize) {}
+
+  explicit SimpleThreadSafeCache(size_t size) {
+    auto count = std::max<size_t>(1, std::min<size_t>(shardCount, size));
+    auto shardSize = std::max<size_t>(1, size / count);
+    shards_.reserve(count);
+    for (size_t index = 0; index < count; index++) {
+      shards_.push_back(std::make_unique<Shard>(shardSize));
+    }
+  }
 
   /*
    * Returns a value from the map with a given key.
    * If the value wasn't found in the cache, constructs the value using given
    * generator function, stores it inside a cache and returns it.
+   * The generator is called without holding any lock; if it throws, the
+   * exception is propagated to all callers waiting for the key.
    * Can be called from any thread.
    */
   ValueT get(const KeyT &key, std::function<ValueT(const KeyT &key)> generator) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto iterator = map_.find(key);
-    if (iterator == map_.end()) {
-      auto value = generator(key);
-      map_.set(key, value);
-      return value;
+    auto &shard = getShard(key);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+
+    auto iterator = shard.map.find(key);
+    if (iterator != shard.map.end()) {
+      hitCount_++;
+      return iterator->second;
     }
 
-    return iterator->second;
+    auto pending = shard.pending.find(key);
+    if (pending != shard.pending.end()) {
+      hitCount_++;
+      auto future = pending->second;
+      lock.unlock();
+      return future.get();
+    }
+
+    missCount_++;
+    auto promise = std::promise<ValueT>{};
+    shard.pending.emplace(key, promise.get_future().share());
+    lock.unlock();
+
+    auto value = ValueT{};
+    try {
+      value = generator(key);
+    } catch (...) {
+      lock.lock();
+      shard.pending.erase(key);
+      lock.unlock();
+      promise.set_exception(std::current_exception());
+      throw;
+    }
+
+    lock.lock();
+    setLocked(shard, key, value);
+    shard.pending.erase(key);
+    lock.unlock();
+
+    promise.set_value(value);
+    return value;
   }
 
   /*
@@ -47,12 +111,15 @@ public:
    * Can be called from any thread.
    */
   better::optional<ValueT> get(const KeyT &key) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto iterator = map_.find(key);
-    if (iterator == map_.end()) {
+    auto &shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iterator = shard.map.find(key);
+    if (iterator == shard.map.end()) {
+      missCount_++;
       return {};
     }
 
+    hitCount_++;
     return iterator->second;
   }
 
@@ -61,13 +128,45 @@ public:
    * Can be called from any thread.
    */
   void set(const KeyT &key, const ValueT &value) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    map_.set(std::move(key), std::move(value));
+    auto &shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    setLocked(shard, key, value);
+  }
+
+  /*
+   * Returns the numbers of hits, misses and evictions so far.
+   * Waiting for a value that another thread is generating counts as a hit.
+   * Can be called from any thread.
+   */
+  SimpleThreadSafeCacheStatistics getStatistics() const {
+    return {hitCount_, missCount_, evictionCount_};
   }
 
 private:
-  mutable folly::EvictingCacheMap<KeyT, ValueT> map_;
-  mutable std::mutex mutex_;
+  struct Shard {
+    Shard(size_t size) : map{size}, size{size} {}
+
+    folly::EvictingCacheMap<KeyT, ValueT> map;
+    std::unordered_map<KeyT, std::shared_future<ValueT>> pending;
+    size_t const size;
+    std::mutex mutex;
+  };
+
+  Shard &getShard(const KeyT &key) const {
+    return *shards_[std::hash<KeyT>{}(key) % shards_.size()];
+  }
+
+  void setLocked(Shard &shard, const KeyT &key, const ValueT &value) const {
+    if (shard.map.size() == shard.size && !shard.map.exists(key)) {
+      evictionCount_++;
+    }
+    shard.map.set(key, value);
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  mutable std::atomic<int64_t> hitCount_{0};
+  mutable std::atomic<int64_t> missCount_{0};
+  mutable std::atomic<int64_t> evictionCount_{0};
 };
 
 } // namespace react
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "MeasureCache.h"
+
+#include <functional>
+
+namespace facebook {
+namespace yoga {
+namespace detail {
+
+namespace {
+
+// Undefined sizes come as NaN, which never compares equal, and only matter
+// with a measure mode that looks at them
+float normalizedSize(float size, YGMeasureMode mode) {
+  return mode == YGMeasureModeUndefined || YGFloatIsUndefined(size) ? 0 : size;
+}
+
+void hashCombine(size_t& seed, size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+} // namespace
+
+MeasureCache::Key::Key(
+    uintptr_t measureFunc,
+    uint64_t content,
+    float width,
+    YGMeasureMode widthMode,
+    float height,
+    YGMeasureMode heightMode)
+    : measureFunc{measureFunc},
+      content{content},
+      width{normalizedSize(width, widthMode)},
+      height{normalizedSize(height, heightMode)},
+      widthMode{widthMode},
+      heightMode{heightMode} {}
+
+size_t MeasureCache::KeyHash::operator()(const Key& key) const {
+  size_t seed = std::hash<uintptr_t>{}(key.measureFunc);
+  hashCombine(seed, std::hash<uint64_t>{}(key.content));
+  hashCombine(seed, std::hash<float>{}(key.width));
+  hashCombine(seed, std::hash<float>{}(key.height));
+  hashCombine(seed, key.widthMode | (key.heightMode << 2));
+  return seed;
+}
+
+bool MeasureCache::get(const Key& key, YGSize& size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = results_.find(key);
+  if (it == results_.end()) {
+    return false;
+  }
+  size = it->second;
+  return true;
+}
+
+void MeasureCache::put(const Key& key, YGSize size) {
+  if (capacity_ == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!results_.emplace(key, size).second) {
+    return;
+  }
+  if (order_.size() < capacity_) {
+    order_.push_back(key);
+    return;
+  }
+  results_.erase(order_[oldest_]);
+  order_[oldest_] = key;
+  oldest_ = (oldest_ + 1) % capacity_;
+}
+
+} // namespace detail
+} // namespace yoga
+} // namespace facebook
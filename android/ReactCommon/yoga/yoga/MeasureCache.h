@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "Yoga.h"
+
+namespace facebook {
+namespace yoga {
+
+namespace detail {
+
+// Results of measure functions shared by all the nodes of a config, and kept
+// across layout passes. Nodes opt in with a key identifying everything their
+// measure function depends on (YGNodeSetMeasureCacheKey), so a node that is
+// cloned, dirtied or recreated with the same content doesn't get measured
+// again. Holds up to `capacity` results, the oldest ones are dropped first.
+// Safe to use from several threads.
+class MeasureCache {
+public:
+  struct Key {
+    uintptr_t measureFunc;
+    uint64_t content;
+    float width;
+    float height;
+    YGMeasureMode widthMode;
+    YGMeasureMode heightMode;
+
+    Key(uintptr_t measureFunc,
+        uint64_t content,
+        float width,
+        YGMeasureMode widthMode,
+        float height,
+        YGMeasureMode heightMode);
+
+    bool operator==(const Key& other) const {
+      return measureFunc == other.measureFunc && content == other.content &&
+          width == other.width && height == other.height &&
+          widthMode == other.widthMode && heightMode == other.heightMode;
+    }
+  };
+
+  explicit MeasureCache(size_t capacity) : capacity_{capacity} {}
+
+  size_t capacity() const { return capacity_; }
+
+  bool get(const Key& key, YGSize& size);
+  void put(const Key& key, YGSize size);
+
+private:
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::unordered_map<Key, YGSize, KeyHash> results_;
+  // Keys in the order they were added, used as a ring once full
+  std::vector<Key> order_;
+  size_t oldest_ = 0;
+};
+
+} // namespace detail
+} // namespace yoga
+} // namespace facebook
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "NodePool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <new>
+
+namespace facebook {
+namespace yoga {
+namespace detail {
+
+namespace {
+
+struct Registry {
+  std::mutex mutex;
+  // Pool of every slab, by the slab's start address
+  std::map<const char*, NodePool*> slabs;
+  // Lets nodes be freed without locking as long as no pool is in use
+  std::atomic<size_t> slabCount{0};
+};
+
+Registry& registry() {
+  // Leaked, pools may be destroyed during static destruction
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+} // namespace
+
+NodePool::NodePool(size_t slotSize, size_t slotAlignment)
+    : slotAlignment_{slotAlignment},
+      slotSize_{(std::max(slotSize, sizeof(FreeSlot)) + slotAlignment - 1) /
+                slotAlignment * slotAlignment} {}
+
+NodePool::~NodePool() {
+  std::lock_guard<std::mutex> lock(registry().mutex);
+  for (auto slab = registry().slabs.begin();
+       slab != registry().slabs.end();) {
+    slab = slab->second == this ? registry().slabs.erase(slab) : ++slab;
+  }
+  registry().slabCount.fetch_sub(slabs_.size(), std::memory_order_relaxed);
+}
+
+void* NodePool::allocate() {
+  std::lock_guard<std::mutex> lock(registry().mutex);
+  if (freeSlots_ != nullptr) {
+    FreeSlot* slot = freeSlots_;
+    freeSlots_ = slot->next;
+    return slot;
+  }
+  if (next_ == end_) {
+    slabs_.emplace_back(new char[slotSize_ * slotsPerSlab + slotAlignment_]);
+    const uintptr_t start = reinterpret_cast<uintptr_t>(slabs_.back().get());
+    next_ = reinterpret_cast<char*>(
+        (start + slotAlignment_ - 1) / slotAlignment_ * slotAlignment_);
+    end_ = next_ + slotSize_ * slotsPerSlab;
+    registry().slabs.emplace(next_, this);
+    registry().slabCount.fetch_add(1, std::memory_order_release);
+  }
+  void* slot = next_;
+  next_ += slotSize_;
+  return slot;
+}
+
+NodePool* NodePool::find(const void* slot) {
+  if (registry().slabCount.load(std::memory_order_acquire) == 0) {
+    return nullptr;
+  }
+  const char* address = static_cast<const char*>(slot);
+  std::lock_guard<std::mutex> lock(registry().mutex);
+  auto& slabs = registry().slabs;
+  auto slab = slabs.upper_bound(address);
+  if (slab == slabs.begin()) {
+    return nullptr;
+  }
+  --slab;
+  NodePool* pool = slab->second;
+  return address < slab->first + pool->slotSize_ * slotsPerSlab ? pool
+                                                                : nullptr;
+}
+
+void NodePool::release(void* slot) {
+  std::lock_guard<std::mutex> lock(registry().mutex);
+  freeSlots_ = new (slot) FreeSlot{freeSlots_};
+}
+
+} // namespace detail
+} // namespace yoga
+} // namespace facebook
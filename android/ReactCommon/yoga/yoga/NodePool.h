@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace facebook {
+namespace yoga {
+
+namespace detail {
+
+// Storage for the nodes of a config (YGConfigSetNodePoolEnabled). Nodes are
+// carved out of slabs of `slotsPerSlab` consecutive slots, so the nodes of a
+// tree built in one go sit next to each other in memory and the layout walk
+// streams through them instead of chasing pointers across the heap. Slots
+// start at multiples of `slotAlignment`. Freed slots are reused first, slabs
+// are only returned to the system along with the pool, which has to outlive
+// its nodes like the config does.
+//
+// Slabs are registered process-wide so that a node can be given back without
+// looking at its config, which may already be gone for deep clones. All pools
+// share one lock, that is safe to use from several threads.
+class NodePool {
+public:
+  static constexpr size_t slotsPerSlab = 128;
+
+  NodePool(size_t slotSize, size_t slotAlignment);
+  ~NodePool();
+  NodePool(const NodePool&) = delete;
+  NodePool& operator=(const NodePool&) = delete;
+
+  void* allocate();
+
+  // The pool a slot comes from, nullptr for memory from anywhere else
+  static NodePool* find(const void* slot);
+  void release(void* slot);
+
+private:
+  struct FreeSlot {
+    FreeSlot* next;
+  };
+
+  const size_t slotAlignment_;
+  const size_t slotSize_;
+  std::vector<std::unique_ptr<char[]>> slabs_;
+  FreeSlot* freeSlots_ = nullptr;
+  // Slots of the newest slab that were never handed out
+  char* next_ = nullptr;
+  char* end_ = nullptr;
+};
+
+} // namespace detail
+} // namespace yoga
+} // namespace facebook
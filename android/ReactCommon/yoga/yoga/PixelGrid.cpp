@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "PixelGrid.h"
+
+#include <cmath>
+#include "Yoga.h"
+
+namespace facebook {
+namespace yoga {
+namespace detail {
+
+namespace {
+
+// Tolerance of YGFloatsEqual
+constexpr float kEpsilon = 0.0001f;
+
+} // namespace
+
+void roundValuesToPixelGrid(
+    float* values,
+    const PixelRounding* rounding,
+    size_t count,
+    float pointScaleFactor) {
+  for (size_t i = 0; i < count; i++) {
+    const float scaledValue = values[i] * pointScaleFactor;
+    // fmodf(scaledValue, 1.0f) moved into [0, 1] for negative values. Adding
+    // the selected constant keeps this free of branches.
+    float fractial = scaledValue - std::trunc(scaledValue);
+    fractial += fractial < 0 ? 1.0f : 0.0f;
+    const float floored = scaledValue - fractial;
+
+    // The checks of YGRoundValueToPixelGrid in the same order, combined with
+    // `&` and `|` to keep the loop free of branches. Comparisons with NaN are
+    // false, so undefined values stay undefined.
+    const bool isRounded = std::fabs(fractial) < kEpsilon;
+    const bool isAlmostRounded = std::fabs(fractial - 1.0f) < kEpsilon;
+    const bool isHalfOrMore =
+        (fractial > 0.5f) | (std::fabs(fractial - 0.5f) < kEpsilon);
+    const bool roundsUp = (!isRounded) &
+        (isAlmostRounded | (rounding[i] == PixelRounding::Ceil) |
+         ((rounding[i] == PixelRounding::Nearest) & isHalfOrMore));
+
+    // Only differs from YGRoundValueToPixelGrid in the sign of zero results
+    // before the division, which the addition turns into +0 like there
+    const float rounded =
+        (floored + (roundsUp ? 1.0f : 0.0f)) / pointScaleFactor;
+    values[i] = std::isnan(rounded) ? YGUndefined : rounded;
+  }
+}
+
+} // namespace detail
+} // namespace yoga
+} // namespace facebook
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace facebook {
+namespace yoga {
+
+namespace detail {
+
+// Which way a value that isn't on the pixel grid yet gets moved, see the
+// `forceCeil` and `forceFloor` arguments of YGRoundValueToPixelGrid
+enum class PixelRounding : uint8_t { Nearest, Ceil, Floor };
+
+// Rounds `count` values in place, with the same results as calling
+// YGRoundValueToPixelGrid on each of them. The loop has no branches or libm
+// calls so that compilers can vectorise it (NEON, SSE).
+void roundValuesToPixelGrid(
+    float* values,
+    const PixelRounding* rounding,
+    size_t count,
+    float pointScaleFactor);
+
+} // namespace detail
+} // namespace yoga
+} // namespace facebook
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace facebook {
+namespace yoga {
+namespace detail {
+
+namespace {
+
+struct Job {
+  const std::function<void(size_t)>& task;
+  const size_t count;
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> done{0};
+
+  Job(const std::function<void(size_t)>& task, size_t count)
+      : task(task), count(count) {}
+
+  // Runs one task, returns false once every task has been taken
+  bool runOne() {
+    const size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    if (index >= count) {
+      return false;
+    }
+    task(index);
+    done.fetch_add(1, std::memory_order_release);
+    return true;
+  }
+
+  bool isDone() const {
+    return done.load(std::memory_order_acquire) == count;
+  }
+};
+
+class Pool {
+public:
+  static Pool& shared() {
+    // Leaked so that the workers never outlive it during static destruction
+    static Pool* pool = new Pool();
+    return *pool;
+  }
+
+  void forEach(size_t count, const std::function<void(size_t)>& task) {
+    auto job = std::make_shared<Job>(task, count);
+    if (count > 1 && !workers_.empty()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back(job);
+      available_.notify_all();
+    }
+
+    while (job->runOne()) {
+    }
+    // The remaining tasks are running on other threads, help with whatever is
+    // queued until they're done
+    while (!job->isDone()) {
+      if (!runQueued()) {
+        std::this_thread::yield();
+      }
+    }
+    remove(job);
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable available_;
+  std::deque<std::shared_ptr<Job>> jobs_;
+  std::vector<std::thread> workers_;
+
+  Pool() {
+    const unsigned cores = std::thread::hardware_concurrency();
+    for (unsigned i = 1; i < cores; i++) {
+      workers_.emplace_back([this] { work(); });
+      workers_.back().detach();
+    }
+  }
+
+  // Oldest job that still has tasks to take, retires the exhausted ones
+  std::shared_ptr<Job> front() {
+    while (!jobs_.empty()) {
+      auto& job = jobs_.front();
+      if (job->next.load(std::memory_order_relaxed) < job->count) {
+        return job;
+      }
+      jobs_.pop_front();
+    }
+    return nullptr;
+  }
+
+  bool runQueued() {
+    std::shared_ptr<Job> job;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job = front();
+    }
+    return job && job->runOne();
+  }
+
+  void remove(const std::shared_ptr<Job>& job) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.erase(std::remove(jobs_.begin(), jobs_.end(), job), jobs_.end());
+  }
+
+  void work() {
+    for (;;) {
+      std::shared_ptr<Job> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        available_.wait(lock, [&] { return (job = front()) != nullptr; });
+      }
+      while (job->runOne()) {
+      }
+    }
+  }
+};
+
+} // namespace
+
+void WorkerPool::forEach(
+    size_t count,
+    const std::function<void(size_t)>& task) {
+  Pool::shared().forEach(count, task);
+}
+
+} // namespace detail
+} // namespace yoga
+} // namespace facebook
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace facebook {
+namespace yoga {
+
+namespace detail {
+
+// Process-wide pool of worker threads used by parallel layout. The threads are
+// started on first use, one less than there are cores.
+struct WorkerPool {
+  // Calls `task(i)` for every `i` in [0, count) and returns once all of them
+  // have run. The calling thread takes tasks too, and while it waits for the
+  // last ones it helps with the tasks of other `forEach` calls, so nested and
+  // concurrent calls from several threads can't starve each other. Tasks must
+  // not throw.
+  static void forEach(size_t count, const std::function<void(size_t)>& task);
+};
+
+} // namespace detail
+} // namespace yoga
+} // namespace facebook
@@ -5,6 +5,9 @@
  * file in the root directory of this source tree.
  */
 #pragma once
+#include <memory>
+#include "MeasureCache.h"
+#include "NodePool.h"
 #include "Yoga-internal.h"
 #include "Yoga.h"
 
@@ -39,10 +42,17 @@ public:
   bool useLegacyStretchBehaviour = false;
   bool shouldDiffLayoutWithoutLegacyStretchBehaviour = false;
   bool printTree = false;
+  bool parallelLayout = false;
   float pointScaleFactor = 1.0f;
   std::array<bool, facebook::yoga::enums::count<YGExperimentalFeature>()>
       experimentalFeatures = {};
   void* context = nullptr;
+  // Shared by copies of the config, nullptr when disabled
+  std::shared_ptr<facebook::yoga::detail::MeasureCache> measureCache;
+  bool useNodePool = false;
+  // Created on first use and kept after that, shared by copies of the config
+  std::shared_ptr<facebook::yoga::detail::NodePool> nodePool;
+  bool incrementalLayout = false;
 
   YGConfig(YGLogger logger);
   void log(YGConfig*, YGNode*, YGLogLevel, void*, const char*, va_list);
@@ -21,8 +21,9 @@ private:
   static constexpr size_t didUseLegacyFlagIdx = 1;
   static constexpr size_t doesLegacyStretchFlagAffectsLayoutIdx = 2;
   static constexpr size_t hadOverflowIdx = 3;
-  facebook::yoga::Bitfield<uint8_t, YGDirection, bool, bool, bool> flags_ =
-      {YGDirectionInherit, false, false, false};
+  static constexpr size_t hasReusableChildLayoutsIdx = 4;
+  facebook::yoga::Bitfield<uint8_t, YGDirection, bool, bool, bool, bool>
+      flags_ = {YGDirectionInherit, false, false, false, false};
 
 public:
   uint32_t computedFlexBasisGeneration = 0;
@@ -33,13 +34,22 @@ public:
   uint32_t generationCount = 0;
   YGDirection lastOwnerDirection = (YGDirection) -1;
 
-  uint32_t nextCachedMeasurementsIndex = 0;
-  std::array<YGCachedMeasurement, YG_MAX_CACHED_RESULT_COUNT>
-      cachedMeasurements = {};
   std::array<float, 2> measuredDimensions = {{YGUndefined, YGUndefined}};
 
   YGCachedMeasurement cachedLayout = YGCachedMeasurement();
 
+  // Inner size and direction the children were last laid out in, only
+  // meaningful while hasReusableChildLayouts() is set
+  std::array<float, 2> childLayoutInnerDimensions = {
+      {YGUndefined, YGUndefined}};
+  YGDirection childLayoutDirection = YGDirectionInherit;
+
+  // Only a few of the measurements are used most of the time, last so that
+  // the fields above stay together
+  uint32_t nextCachedMeasurementsIndex = 0;
+  std::array<YGCachedMeasurement, YG_MAX_CACHED_RESULT_COUNT>
+      cachedMeasurements = {};
+
   YGDirection direction() const { return flags_.at<directionIdx>(); }
   decltype(flags_)::Ref<directionIdx> direction() {
     return flags_.at<directionIdx>();
@@ -63,6 +73,16 @@ public:
     return flags_.at<hadOverflowIdx>();
   }
 
+  // Set while the layouts of the children are still the ones from the last
+  // time the node was laid out, and neither the node itself nor its list of
+  // children changed since. See YGConfigSetIncrementalLayoutEnabled
+  bool hasReusableChildLayouts() const {
+    return flags_.at<hasReusableChildLayoutsIdx>();
+  }
+  decltype(flags_)::Ref<hasReusableChildLayoutsIdx> hasReusableChildLayouts() {
+    return flags_.at<hasReusableChildLayoutsIdx>();
+  }
+
   bool operator==(YGLayout layout) const;
   bool operator!=(YGLayout layout) const { return !(*this == layout); }
 };
@@ -20,6 +20,7 @@ YGNode::YGNode(YGNode&& node) {
   baseline_ = node.baseline_;
   print_ = node.print_;
   dirtied_ = node.dirtied_;
+  measureCacheKey_ = node.measureCacheKey_;
   style_ = node.style_;
   layout_ = node.layout_;
   lineIndex_ = node.lineIndex_;
@@ -207,6 +208,10 @@ void YGNode::insertChild(YGNodeRef child, uint32_t index) {
 }
 
 void YGNode::setDirty(bool isDirty) {
+  if (isDirty) {
+    // Whoever dirties the node directly may have changed anything about it
+    layout_.hasReusableChildLayouts() = false;
+  }
   if (isDirty == flags_.at<isDirty_>()) {
     return;
   }
@@ -368,6 +373,41 @@ void YGNode::resolveDimension() {
   }
 }
 
+namespace {
+
+bool isPointOrUndefined(const CompactValue value) {
+  return value.isUndefined() ||
+      (!value.isAuto() && YGValue(value).unit == YGUnitPoint);
+}
+
+bool hasPointEdges(const YGStyle::Edges& edges) {
+  for (int edge = 0; edge < yoga::enums::count<YGEdge>(); edge++) {
+    if (!isPointOrUndefined(edges[edge])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+// An absolute child with a width and height in points and without min or max
+// sizes, relative margins or paddings is sized without looking at its owner
+void YGNode::updateStaticGeometry() {
+  const YGStyle& style = style_;
+  bool hasStaticGeometry = style.positionType() == YGPositionTypeAbsolute &&
+      style.display() == YGDisplayFlex && hasPointEdges(style.margin()) &&
+      hasPointEdges(style.padding()) && hasPointEdges(style.border());
+  for (auto dim : {YGDimensionWidth, YGDimensionHeight}) {
+    const CompactValue size = style.dimensions()[dim];
+    hasStaticGeometry = hasStaticGeometry && !size.isUndefined() &&
+        isPointOrUndefined(size) && YGValue(size).value >= 0.0f &&
+        style.minDimensions()[dim].isUndefined() &&
+        style.maxDimensions()[dim].isUndefined();
+  }
+  flags_.at<hasStaticGeometry_>() = hasStaticGeometry;
+}
+
 YGDirection YGNode::resolveDirection(const YGDirection ownerDirection) {
   if (style_.direction() == YGDirectionInherit) {
     return ownerDirection > YGDirectionInherit ? ownerDirection
@@ -389,17 +429,33 @@ void YGNode::cloneChildrenIfNeeded(void* cloneContext) {
 }
 
 void YGNode::markDirtyAndPropogate() {
+  layout_.hasReusableChildLayouts() = false;
   if (!flags_.at<isDirty_>()) {
     setDirty(true);
     setLayoutComputedFlexBasis(YGFloatOptional());
     if (owner_) {
-      owner_->markDirtyAndPropogate();
+      owner_->markDirtyFromChild();
+    }
+  }
+}
+
+void YGNode::markDirtyFromChild() {
+  // Unlike setDirty, keeps the layouts of the other children reusable
+  if (!flags_.at<isDirty_>()) {
+    flags_.at<isDirty_>() = true;
+    if (dirtied_) {
+      dirtied_(this);
+    }
+    setLayoutComputedFlexBasis(YGFloatOptional());
+    if (owner_) {
+      owner_->markDirtyFromChild();
     }
   }
 }
 
 void YGNode::markDirtyAndPropogateDownwards() {
   flags_.at<isDirty_>() = true;
+  layout_.hasReusableChildLayouts() = false;
   for_each(children_.begin(), children_.end(), [](YGNodeRef childNode) {
     childNode->markDirtyAndPropogateDownwards();
   });
@@ -32,13 +32,39 @@ private:
   static constexpr size_t baselineUsesContext_ = 5;
   static constexpr size_t printUsesContext_ = 6;
   static constexpr size_t useWebDefaults_ = 7;
+  static constexpr size_t hasStaticGeometry_ = 8;
 
   void* context_ = nullptr;
-  using Flags = facebook::yoga::
-      Bitfield<uint8_t, bool, bool, bool, YGNodeType, bool, bool, bool, bool>;
-  Flags flags_ =
-      {true, false, false, YGNodeTypeDefault, false, false, false, false};
+  using Flags = facebook::yoga::Bitfield<
+      uint16_t,
+      bool,
+      bool,
+      bool,
+      YGNodeType,
+      bool,
+      bool,
+      bool,
+      bool,
+      bool>;
+  Flags flags_ = {
+      true,
+      false,
+      false,
+      YGNodeTypeDefault,
+      false,
+      false,
+      false,
+      false,
+      false};
   uint8_t reserved_ = 0;
+  // Ordered by how often the layout walk touches them, so that the fields it
+  // needs for every node share as few cache lines as possible
+  uint32_t lineIndex_ = 0;
+  YGNodeRef owner_ = nullptr;
+  YGVector children_ = {};
+  YGConfigRef config_;
+  std::array<YGValue, 2> resolvedDimensions_ = {
+      {YGValueUndefined, YGValueUndefined}};
   union {
     YGMeasureFunc noContext;
     MeasureWithContextFn withContext;
@@ -47,19 +73,14 @@ private:
     YGBaselineFunc noContext;
     BaselineWithContextFn withContext;
   } baseline_ = {nullptr};
+  YGStyle style_ = {};
+  YGLayout layout_ = {};
   union {
     YGPrintFunc noContext;
     PrintWithContextFn withContext;
   } print_ = {nullptr};
   YGDirtiedFunc dirtied_ = nullptr;
-  YGStyle style_ = {};
-  YGLayout layout_ = {};
-  uint32_t lineIndex_ = 0;
-  YGNodeRef owner_ = nullptr;
-  YGVector children_ = {};
-  YGConfigRef config_;
-  std::array<YGValue, 2> resolvedDimensions_ = {
-      {YGValueUndefined, YGValueUndefined}};
+  uint64_t measureCacheKey_ = 0;
 
   YGFloatOptional relativePosition(
       const YGFlexDirection axis,
@@ -67,6 +88,7 @@ private:
 
   void setMeasureFunc(decltype(measure_));
   void setBaselineFunc(decltype(baseline_));
+  void markDirtyFromChild();
 
   void useWebDefaults() {
     flags_.at<useWebDefaults_>() = true;
@@ -119,8 +141,19 @@ public:
 
   bool hasMeasureFunc() const noexcept { return measure_.noContext != nullptr; }
 
+  // Whether the style alone determines the size of the node when it's laid out
+  // as an absolute child, see updateStaticGeometry()
+  bool hasStaticGeometry() const { return flags_.at<hasStaticGeometry_>(); }
+
   YGSize measure(float, YGMeasureMode, float, YGMeasureMode, void*);
 
+  // Identifies the measure function, whether it takes a context or not
+  uintptr_t getMeasureFuncId() const noexcept {
+    return reinterpret_cast<uintptr_t>(measure_.noContext);
+  }
+
+  uint64_t getMeasureCacheKey() const { return measureCacheKey_; }
+
   bool hasBaselineFunc() const noexcept {
     return baseline_.noContext != nullptr;
   }
@@ -256,7 +289,17 @@ public:
 
   void setDirtiedFunc(YGDirtiedFunc dirtiedFunc) { dirtied_ = dirtiedFunc; }
 
-  void setStyle(const YGStyle& style) { style_ = style; }
+  void setMeasureCacheKey(uint64_t measureCacheKey) {
+    measureCacheKey_ = measureCacheKey;
+  }
+
+  void setStyle(const YGStyle& style) {
+    style_ = style;
+    updateStaticGeometry();
+  }
+
+  // Has to be called after every change to the style
+  void updateStaticGeometry();
 
   void setLayout(const YGLayout& layout) { layout_ = layout; }
 
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "YGNodeJson.h"
+#include <cmath>
+#include <cstdio>
+#include "Utils.h"
+#include "YGConfig.h"
+#include "YGEnums.h"
+#include "YGNode.h"
+
+namespace facebook {
+namespace yoga {
+
+namespace {
+
+using detail::CompactValue;
+
+class JsonWriter {
+public:
+  explicit JsonWriter(std::string& str) : str_(str) {}
+
+  void beginObject(const char* key = nullptr) {
+    appendKey(key);
+    str_.push_back('{');
+    first_ = true;
+  }
+
+  void endObject() {
+    str_.push_back('}');
+    first_ = false;
+  }
+
+  void beginArray(const char* key) {
+    appendKey(key);
+    str_.push_back('[');
+    first_ = true;
+  }
+
+  void endArray() {
+    str_.push_back(']');
+    first_ = false;
+  }
+
+  void number(const char* key, float value) {
+    appendKey(key);
+    if (std::isnan(value)) {
+      str_.append("null");
+    } else {
+      // Enough digits for the float to survive the round trip
+      char buffer[32];
+      snprintf(buffer, sizeof(buffer), "%.9g", value);
+      str_.append(buffer);
+    }
+  }
+
+  void boolean(const char* key, bool value) {
+    appendKey(key);
+    str_.append(value ? "true" : "false");
+  }
+
+  void string(const char* key, const char* value) {
+    appendKey(key);
+    str_.push_back('"');
+    str_.append(value);
+    str_.push_back('"');
+  }
+
+  void value(const char* key, const YGValue value) {
+    switch (value.unit) {
+      case YGUnitUndefined:
+        number(key, YGUndefined);
+        break;
+      case YGUnitPoint:
+        number(key, value.value);
+        break;
+      case YGUnitPercent: {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.9g%%", value.value);
+        string(key, buffer);
+        break;
+      }
+      case YGUnitAuto:
+        string(key, "auto");
+        break;
+    }
+  }
+
+private:
+  std::string& str_;
+  bool first_ = true;
+
+  void appendKey(const char* key) {
+    if (!first_) {
+      str_.push_back(',');
+    }
+    first_ = false;
+    if (key != nullptr) {
+      str_.push_back('"');
+      str_.append(key);
+      str_.append("\":");
+    }
+  }
+};
+
+template <typename T>
+void appendEnumIfChanged(
+    JsonWriter& json,
+    const char* key,
+    T value,
+    T defaultValue,
+    const char* (*toString)(T)) {
+  if (value != defaultValue) {
+    json.string(key, toString(value));
+  }
+}
+
+void appendFloatOptionalIfChanged(
+    JsonWriter& json,
+    const char* key,
+    YGFloatOptional value,
+    YGFloatOptional defaultValue) {
+  if (value != defaultValue) {
+    json.number(key, value.unwrap());
+  }
+}
+
+void appendValueIfChanged(
+    JsonWriter& json,
+    const char* key,
+    CompactValue value,
+    CompactValue defaultValue) {
+  if (!YGValueEqual(value, defaultValue)) {
+    json.value(key, value);
+  }
+}
+
+// Only the edges that are set, keyed by YGEdgeToString
+template <typename Edges>
+void appendEdgesIfChanged(
+    JsonWriter& json,
+    const char* key,
+    const Edges& edges,
+    const Edges& defaultEdges) {
+  bool hasChanges = false;
+  for (int edge = 0; edge < enums::count<YGEdge>(); edge++) {
+    if (YGValueEqual(edges[edge], defaultEdges[edge])) {
+      continue;
+    }
+    if (!hasChanges) {
+      json.beginObject(key);
+      hasChanges = true;
+    }
+    json.value(YGEdgeToString(static_cast<YGEdge>(edge)), edges[edge]);
+  }
+  if (hasChanges) {
+    json.endObject();
+  }
+}
+
+void appendStyle(JsonWriter& json, const YGStyle& style, const YGStyle& def) {
+  json.beginObject("style");
+  appendEnumIfChanged(
+      json,
+      "direction",
+      style.direction(),
+      def.direction(),
+      YGDirectionToString);
+  appendEnumIfChanged(
+      json,
+      "flexDirection",
+      style.flexDirection(),
+      def.flexDirection(),
+      YGFlexDirectionToString);
+  appendEnumIfChanged(
+      json,
+      "justifyContent",
+      style.justifyContent(),
+      def.justifyContent(),
+      YGJustifyToString);
+  appendEnumIfChanged(
+      json,
+      "alignContent",
+      style.alignContent(),
+      def.alignContent(),
+      YGAlignToString);
+  appendEnumIfChanged(
+      json,
+      "alignItems",
+      style.alignItems(),
+      def.alignItems(),
+      YGAlignToString);
+  appendEnumIfChanged(
+      json, "alignSelf", style.alignSelf(), def.alignSelf(), YGAlignToString);
+  appendEnumIfChanged(
+      json,
+      "positionType",
+      style.positionType(),
+      def.positionType(),
+      YGPositionTypeToString);
+  appendEnumIfChanged(
+      json, "flexWrap", style.flexWrap(), def.flexWrap(), YGWrapToString);
+  appendEnumIfChanged(
+      json, "overflow", style.overflow(), def.overflow(), YGOverflowToString);
+  appendEnumIfChanged(
+      json, "display", style.display(), def.display(), YGDisplayToString);
+
+  appendFloatOptionalIfChanged(json, "flex", style.flex(), def.flex());
+  appendFloatOptionalIfChanged(
+      json, "flexGrow", style.flexGrow(), def.flexGrow());
+  appendFloatOptionalIfChanged(
+      json, "flexShrink", style.flexShrink(), def.flexShrink());
+  appendValueIfChanged(json, "flexBasis", style.flexBasis(), def.flexBasis());
+  appendFloatOptionalIfChanged(
+      json, "aspectRatio", style.aspectRatio(), def.aspectRatio());
+
+  appendEdgesIfChanged(json, "margin", style.margin(), def.margin());
+  appendEdgesIfChanged(json, "position", style.position(), def.position());
+  appendEdgesIfChanged(json, "padding", style.padding(), def.padding());
+  appendEdgesIfChanged(json, "border", style.border(), def.border());
+
+  appendValueIfChanged(
+      json,
+      "width",
+      style.dimensions()[YGDimensionWidth],
+      def.dimensions()[YGDimensionWidth]);
+  appendValueIfChanged(
+      json,
+      "height",
+      style.dimensions()[YGDimensionHeight],
+      def.dimensions()[YGDimensionHeight]);
+  appendValueIfChanged(
+      json,
+      "minWidth",
+      style.minDimensions()[YGDimensionWidth],
+      def.minDimensions()[YGDimensionWidth]);
+  appendValueIfChanged(
+      json,
+      "minHeight",
+      style.minDimensions()[YGDimensionHeight],
+      def.minDimensions()[YGDimensionHeight]);
+  appendValueIfChanged(
+      json,
+      "maxWidth",
+      style.maxDimensions()[YGDimensionWidth],
+      def.maxDimensions()[YGDimensionWidth]);
+  appendValueIfChanged(
+      json,
+      "maxHeight",
+      style.maxDimensions()[YGDimensionHeight],
+      def.maxDimensions()[YGDimensionHeight]);
+  json.endObject();
+}
+
+void appendNode(JsonWriter& json, const char* key, const YGNodeRef node) {
+  json.beginObject(key);
+  // Nodes start out with the defaults of their config
+  const YGNode defaults{node->getConfig()};
+  appendStyle(json, node->getStyle(), defaults.getStyle());
+  if (node->getNodeType() != YGNodeTypeDefault) {
+    json.string("nodeType", YGNodeTypeToString(node->getNodeType()));
+  }
+  if (node->hasMeasureFunc()) {
+    json.beginObject("measured");
+    json.number(
+        "width", node->getLayout().measuredDimensions[YGDimensionWidth]);
+    json.number(
+        "height", node->getLayout().measuredDimensions[YGDimensionHeight]);
+    json.endObject();
+  }
+  if (!node->getChildren().empty()) {
+    json.beginArray("children");
+    for (const auto child : node->getChildren()) {
+      appendNode(json, nullptr, child);
+    }
+    json.endArray();
+  }
+  json.endObject();
+}
+
+} // namespace
+
+void YGNodeToJson(
+    std::string& str,
+    YGNodeRef root,
+    float ownerWidth,
+    float ownerHeight,
+    YGDirection ownerDirection) {
+  JsonWriter json{str};
+  json.beginObject();
+  json.number("ownerWidth", ownerWidth);
+  json.number("ownerHeight", ownerHeight);
+  json.string("ownerDirection", YGDirectionToString(ownerDirection));
+
+  const YGConfigRef config = root->getConfig();
+  json.beginObject("config");
+  json.number("pointScaleFactor", config->pointScaleFactor);
+  json.boolean("useWebDefaults", config->useWebDefaults);
+  json.boolean("useLegacyStretchBehaviour", config->useLegacyStretchBehaviour);
+  json.endObject();
+
+  appendNode(json, "root", root);
+  json.endObject();
+}
+
+} // namespace yoga
+} // namespace facebook
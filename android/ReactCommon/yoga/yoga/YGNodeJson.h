@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#pragma once
+#include <string>
+
+#include "Yoga.h"
+
+namespace facebook {
+namespace yoga {
+
+// Appends a JSON snapshot of the tree under `root` to `str`, for replaying a
+// layout outside of the app it was taken in. It holds the arguments the root
+// is laid out with, the config of the root, and for every node the style
+// properties that differ from the defaults and its children. Nodes with a
+// measure function record the size they got measured to instead, so that
+// their content doesn't need to be replayed. The layout results aren't part
+// of it. Edges and dimensions use the names YGEdgeToString and
+// YGDimensionToString give them, enums use those of the matching ToString.
+// Point values are numbers, percentages strings ending in '%', "auto" and null
+// stand for auto and undefined.
+//
+//   {"ownerWidth": 390, "ownerHeight": 844, "ownerDirection": "ltr",
+//    "config": {"pointScaleFactor": 3, "useWebDefaults": false,
+//               "useLegacyStretchBehaviour": false},
+//    "root": {"style": {"flex": 1, "padding": {"all": 8}},
+//             "children": [{"measured": {"width": 120, "height": 17}}]}}
+void YGNodeToJson(
+    std::string& str,
+    YGNodeRef root,
+    float ownerWidth,
+    float ownerHeight,
+    YGDirection ownerDirection);
+
+} // namespace yoga
+} // namespace facebook
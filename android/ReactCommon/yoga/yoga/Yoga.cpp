@@ -9,8 +9,12 @@
 #include <float.h>
 #include <string.h>
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <unordered_map>
+#include "PixelGrid.h"
 #include "Utils.h"
+#include "WorkerPool.h"
 #include "YGNode.h"
 #include "YGNodePrint.h"
 #include "Yoga-internal.h"
@@ -154,6 +158,14 @@ void YGNodeSetMeasureFunc(YGNodeRef node, YGMeasureFunc measureFunc) {
   node->setMeasureFunc(measureFunc);
 }
 
+void YGNodeSetMeasureCacheKey(YGNodeRef node, uint64_t key) {
+  node->setMeasureCacheKey(key);
+}
+
+uint64_t YGNodeGetMeasureCacheKey(YGNodeRef node) {
+  return node->getMeasureCacheKey();
+}
+
 bool YGNodeHasBaselineFunc(YGNodeRef node) {
   return node->hasBaselineFunc();
 }
@@ -206,10 +218,30 @@ void YGNodeMarkDirtyAndPropogateToDescendants(const YGNodeRef node) {
   return node->markDirtyAndPropogateDownwards();
 }
 
-int32_t gConfigInstanceCount = 0;
+// Configs are created and freed from whichever thread lays out with them
+std::atomic<int32_t> gConfigInstanceCount{0};
+
+// Allocates nodes from the pool of the config when it has one in use
+template <typename... Args>
+static YGNodeRef YGNodeAllocate(const YGConfigRef config, Args&&... args) {
+  if (!config->useNodePool) {
+    return new YGNode{std::forward<Args>(args)...};
+  }
+  return new (config->nodePool->allocate())
+      YGNode{std::forward<Args>(args)...};
+}
+
+static void YGNodeDeallocate(const YGNodeRef node) {
+  if (detail::NodePool* pool = detail::NodePool::find(node)) {
+    node->~YGNode();
+    pool->release(node);
+  } else {
+    delete node;
+  }
+}
 
 WIN_EXPORT YGNodeRef YGNodeNewWithConfig(const YGConfigRef config) {
-  const YGNodeRef node = new YGNode{config};
+  const YGNodeRef node = YGNodeAllocate(config, config);
   YGAssertWithConfig(
       config, node != nullptr, "Could not allocate memory for node");
   Event::publish<Event::NodeAllocation>(node, {config});
@@ -227,7 +259,7 @@ YGNodeRef YGNodeNew(void) {
 }
 
 YGNodeRef YGNodeClone(YGNodeRef oldNode) {
-  YGNodeRef node = new YGNode(*oldNode);
+  YGNodeRef node = YGNodeAllocate(oldNode->getConfig(), *oldNode);
   YGAssertWithConfig(
       oldNode->getConfig(),
       node != nullptr,
@@ -243,7 +275,7 @@ static YGConfigRef YGConfigClone(const YGConfig& oldConfig) {
   if (config == nullptr) {
     abort();
   }
-  gConfigInstanceCount++;
+  gConfigInstanceCount.fetch_add(1, std::memory_order_relaxed);
   return config;
 }
 
@@ -280,12 +312,12 @@ void YGNodeFree(const YGNodeRef node) {
 
   node->clearChildren();
   Event::publish<Event::NodeDeallocation>(node, {node->getConfig()});
-  delete node;
+  YGNodeDeallocate(node);
 }
 
 static void YGConfigFreeRecursive(const YGNodeRef root) {
   if (root->getConfig() != nullptr) {
-    gConfigInstanceCount--;
+    gConfigInstanceCount.fetch_sub(1, std::memory_order_relaxed);
     delete root->getConfig();
   }
   // Delete configs recursively for childrens
@@ -323,7 +355,7 @@ void YGNodeReset(YGNodeRef node) {
 }
 
 int32_t YGConfigGetInstanceCount(void) {
-  return gConfigInstanceCount;
+  return gConfigInstanceCount.load(std::memory_order_relaxed);
 }
 
 YGConfigRef YGConfigNew(void) {
@@ -332,17 +364,17 @@ YGConfigRef YGConfigNew(void) {
 #else
   const YGConfigRef config = new YGConfig(YGDefaultLog);
 #endif
-  gConfigInstanceCount++;
+  gConfigInstanceCount.fetch_add(1, std::memory_order_relaxed);
   return config;
 }
 
 void YGConfigFree(const YGConfigRef config) {
   delete config;
-  gConfigInstanceCount--;
+  gConfigInstanceCount.fetch_sub(1, std::memory_order_relaxed);
 }
 
 void YGConfigCopy(const YGConfigRef dest, const YGConfigRef src) {
-  memcpy(dest, src, sizeof(YGConfig));
+  *dest = *src;
 }
 
 void YGNodeSetIsReferenceBaseline(YGNodeRef node, bool isReferenceBaseline) {
@@ -527,6 +559,7 @@ void updateStyle(
     Update&& update) {
   if (needsUpdate(node->getStyle(), value)) {
     update(node->getStyle(), value);
+    node->updateStaticGeometry();
     node->markDirtyAndPropogate();
   }
 }
@@ -926,7 +959,129 @@ bool YGNodeLayoutGetDidLegacyStretchFlagAffectLayout(const YGNodeRef node) {
   return node->getLayout().doesLegacyStretchFlagAffectsLayout();
 }
 
-uint32_t gCurrentGenerationCount = 0;
+std::atomic<uint32_t> gCurrentGenerationCount{0};
+
+namespace {
+
+// Arguments of a YGLayoutNodeInternal call put off by parallel layout
+struct YGDeferredLayout {
+  YGNodeRef node;
+  float availableWidth;
+  float availableHeight;
+  YGDirection ownerDirection;
+  float ownerWidth;
+  float ownerHeight;
+  LayoutPassReason reason;
+  YGConfigRef config;
+  void* layoutContext;
+  uint32_t depth;
+};
+
+class YGDeferredLayouts {
+  // Node the pass started from
+  const YGNodeRef root_;
+  // Whether the subtree of the root is known to have no baseline layout
+  const bool withoutBaselines_;
+  std::vector<YGDeferredLayout> layouts_;
+  std::unordered_map<YGNodeRef, size_t> indices_;
+  // Number of pending layouts in the subtree of every node
+  std::unordered_map<YGNodeRef, uint32_t> pendingBelow_;
+  // Owners take in the overflow of the children laid out by their flex
+  // distribution. Remembers which children that was for the last layout of
+  // every owner in the pass, by the number of layouts the owner had so far.
+  std::unordered_map<YGNodeRef, uint32_t> layoutCounts_;
+  std::unordered_map<YGNodeRef, uint32_t> flexLayoutOwnerCounts_;
+
+  void updatePendingBelow(YGNodeRef node, int32_t delta) {
+    for (YGNodeRef owner = node->getOwner(); owner != nullptr;
+         owner = owner->getOwner()) {
+      pendingBelow_[owner] += delta;
+      if (owner == root_) {
+        break;
+      }
+    }
+  }
+
+public:
+  // Subtrees with a baseline layout, see YGNodeDeferLayout
+  std::unordered_map<YGNodeRef, bool> baselineSubtrees;
+
+  YGDeferredLayouts(YGNodeRef root, bool withoutBaselines)
+      : root_(root), withoutBaselines_(withoutBaselines) {}
+
+  bool withoutBaselines() const {
+    return withoutBaselines_;
+  }
+
+  // Supersedes a pending layout of the node
+  void willLayout(YGNodeRef node, LayoutPassReason reason) {
+    ++layoutCounts_[node];
+    if (reason == LayoutPassReason::kFlexLayout &&
+        node->getOwner() != nullptr) {
+      flexLayoutOwnerCounts_[node] = layoutCounts_[node->getOwner()];
+    }
+    if (indices_.empty()) {
+      return;
+    }
+    auto it = indices_.find(node);
+    if (it != indices_.end()) {
+      layouts_[it->second].node = nullptr;
+      indices_.erase(it);
+      updatePendingBelow(node, -1);
+    }
+  }
+
+  // A node with pending layouts below it is laid out in place. Its layout may
+  // come from the cache and leave them as they are, so they can't be folded
+  // into a deferred layout of the node and mustn't run alongside one.
+  bool hasPendingBelow(YGNodeRef node) const {
+    auto it = pendingBelow_.find(node);
+    return it != pendingBelow_.end() && it->second != 0;
+  }
+
+  void add(const YGDeferredLayout& layout) {
+    indices_.emplace(layout.node, layouts_.size());
+    layouts_.push_back(layout);
+    updatePendingBelow(layout.node, 1);
+  }
+
+  // Whether the last layout of the node's owner laid it out by distributing
+  // free space
+  bool isFlexLayout(YGNodeRef node) const {
+    auto flex = flexLayoutOwnerCounts_.find(node);
+    if (flex == flexLayoutOwnerCounts_.end()) {
+      return false;
+    }
+    auto owner = layoutCounts_.find(node->getOwner());
+    return owner != layoutCounts_.end() && owner->second == flex->second;
+  }
+
+  // Pending layouts, none of them is in the subtree of another
+  std::vector<YGDeferredLayout>& layouts() {
+    layouts_.erase(
+        std::remove_if(
+            layouts_.begin(),
+            layouts_.end(),
+            [](const YGDeferredLayout& layout) {
+              return layout.node == nullptr;
+            }),
+        layouts_.end());
+    return layouts_;
+  }
+};
+
+} // namespace
+
+// State of one YGNodeCalculateLayoutWithContext call. There is no other state
+// shared between calls, so separate trees can be laid out at the same time.
+struct YGLayoutPass {
+  uint32_t generationCount;
+  // Node the pass started from
+  YGNodeRef root;
+  // Subtrees whose layout waits for the rest of the pass, nullptr when
+  // parallel layout is off
+  YGDeferredLayouts* deferred;
+};
 
 bool YGLayoutNodeInternal(
     const YGNodeRef node,
@@ -943,7 +1098,7 @@ bool YGLayoutNodeInternal(
     LayoutData& layoutMarkerData,
     void* const layoutContext,
     const uint32_t depth,
-    const uint32_t generationCount);
+    YGLayoutPass& pass);
 
 #ifdef DEBUG
 static void YGNodePrintInternal(
@@ -1193,7 +1348,7 @@ static void YGNodeComputeFlexBasisForChild(
     LayoutData& layoutMarkerData,
     void* const layoutContext,
     const uint32_t depth,
-    const uint32_t generationCount) {
+    YGLayoutPass& pass) {
   const YGFlexDirection mainAxis =
       YGResolveFlexDirection(node->getStyle().flexDirection(), direction);
   const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
@@ -1216,7 +1371,8 @@ static void YGNodeComputeFlexBasisForChild(
     if (child->getLayout().computedFlexBasis.isUndefined() ||
         (YGConfigIsExperimentalFeatureEnabled(
              child->getConfig(), YGExperimentalFeatureWebFlexBasis) &&
-         child->getLayout().computedFlexBasisGeneration != generationCount)) {
+         child->getLayout().computedFlexBasisGeneration !=
+             pass.generationCount)) {
       const YGFloatOptional paddingAndBorder = YGFloatOptional(
           YGNodePaddingAndBorderForAxis(child, mainAxis, ownerWidth));
       child->setLayoutComputedFlexBasis(
@@ -1369,13 +1525,142 @@ static void YGNodeComputeFlexBasisForChild(
         layoutMarkerData,
         layoutContext,
         depth,
-        generationCount);
+        pass);
 
     child->setLayoutComputedFlexBasis(YGFloatOptional(YGFloatMax(
         child->getLayout().measuredDimensions[dim[mainAxis]],
         YGNodePaddingAndBorderForAxis(child, mainAxis, ownerWidth))));
   }
-  child->setLayoutComputedFlexBasisGeneration(generationCount);
+  child->setLayoutComputedFlexBasisGeneration(pass.generationCount);
+}
+
+// Sets the resolved direction, margins, borders and paddings in the node's
+// layout
+static YGDirection YGNodeSetLayoutDirectionAndEdges(
+    const YGNodeRef node,
+    const YGDirection ownerDirection,
+    const float ownerWidth) {
+  const YGDirection direction = node->resolveDirection(ownerDirection);
+  node->setLayoutDirection(direction);
+
+  const YGFlexDirection flexRowDirection =
+      YGResolveFlexDirection(YGFlexDirectionRow, direction);
+  const YGFlexDirection flexColumnDirection =
+      YGResolveFlexDirection(YGFlexDirectionColumn, direction);
+
+  const YGEdge startEdge =
+      direction == YGDirectionLTR ? YGEdgeLeft : YGEdgeRight;
+  const YGEdge endEdge = direction == YGDirectionLTR ? YGEdgeRight : YGEdgeLeft;
+  node->setLayoutMargin(
+      node->getLeadingMargin(flexRowDirection, ownerWidth).unwrap(), startEdge);
+  node->setLayoutMargin(
+      node->getTrailingMargin(flexRowDirection, ownerWidth).unwrap(), endEdge);
+  node->setLayoutMargin(
+      node->getLeadingMargin(flexColumnDirection, ownerWidth).unwrap(),
+      YGEdgeTop);
+  node->setLayoutMargin(
+      node->getTrailingMargin(flexColumnDirection, ownerWidth).unwrap(),
+      YGEdgeBottom);
+
+  node->setLayoutBorder(node->getLeadingBorder(flexRowDirection), startEdge);
+  node->setLayoutBorder(node->getTrailingBorder(flexRowDirection), endEdge);
+  node->setLayoutBorder(node->getLeadingBorder(flexColumnDirection), YGEdgeTop);
+  node->setLayoutBorder(
+      node->getTrailingBorder(flexColumnDirection), YGEdgeBottom);
+
+  node->setLayoutPadding(
+      node->getLeadingPadding(flexRowDirection, ownerWidth).unwrap(),
+      startEdge);
+  node->setLayoutPadding(
+      node->getTrailingPadding(flexRowDirection, ownerWidth).unwrap(), endEdge);
+  node->setLayoutPadding(
+      node->getLeadingPadding(flexColumnDirection, ownerWidth).unwrap(),
+      YGEdgeTop);
+  node->setLayoutPadding(
+      node->getTrailingPadding(flexColumnDirection, ownerWidth).unwrap(),
+      YGEdgeBottom);
+
+  return direction;
+}
+
+// The layout of an absolute child with static geometry and nothing to lay out
+// inside it. Comes up with the same as YGLayoutNodeInternal would for its exact
+// size, without going through the layout algorithm.
+static void YGNodeLayoutStaticGeometry(
+    const YGNodeRef node,
+    const float width,
+    const float height,
+    const YGDirection ownerDirection,
+    LayoutData& layoutMarkerData,
+    void* const layoutContext,
+    const uint32_t depth,
+    YGLayoutPass& pass) {
+  layoutMarkerData.maxDepth =
+      std::max(layoutMarkerData.maxDepth, static_cast<int>(depth + 1));
+  if (pass.deferred != nullptr) {
+    pass.deferred->willLayout(node, LayoutPassReason::kAbsLayout);
+  }
+
+  YGLayout& layout = node->getLayout();
+  YGCachedMeasurement& cachedLayout = layout.cachedLayout;
+  const bool needToVisitNode =
+      (node->isDirty() && layout.generationCount != pass.generationCount) ||
+      layout.lastOwnerDirection != ownerDirection;
+  const bool isCached = !needToVisitNode &&
+      cachedLayout.widthMeasureMode == YGMeasureModeExactly &&
+      cachedLayout.heightMeasureMode == YGMeasureModeExactly &&
+      YGFloatsEqual(cachedLayout.availableWidth, width) &&
+      YGFloatsEqual(cachedLayout.availableHeight, height);
+
+  if (isCached) {
+    layoutMarkerData.cachedLayouts += 1;
+    layout.measuredDimensions[YGDimensionWidth] = cachedLayout.computedWidth;
+    layout.measuredDimensions[YGDimensionHeight] = cachedLayout.computedHeight;
+  } else {
+    layoutMarkerData.layouts += 1;
+    YGNodeSetLayoutDirectionAndEdges(node, ownerDirection, width);
+    node->setLayoutMeasuredDimension(
+        YGNodeBoundAxis(
+            node,
+            YGFlexDirectionRow,
+            width - node->getMarginForAxis(YGFlexDirectionRow, width).unwrap(),
+            width,
+            width),
+        YGDimensionWidth);
+    node->setLayoutMeasuredDimension(
+        YGNodeBoundAxis(
+            node,
+            YGFlexDirectionColumn,
+            height -
+                node->getMarginForAxis(YGFlexDirectionColumn, width).unwrap(),
+            height,
+            width),
+        YGDimensionHeight);
+
+    if (needToVisitNode) {
+      layout.nextCachedMeasurementsIndex = 0;
+    }
+    layout.lastOwnerDirection = ownerDirection;
+    cachedLayout.availableWidth = width;
+    cachedLayout.availableHeight = height;
+    cachedLayout.widthMeasureMode = YGMeasureModeExactly;
+    cachedLayout.heightMeasureMode = YGMeasureModeExactly;
+    cachedLayout.computedWidth = layout.measuredDimensions[YGDimensionWidth];
+    cachedLayout.computedHeight = layout.measuredDimensions[YGDimensionHeight];
+  }
+
+  node->setLayoutDimension(
+      layout.measuredDimensions[YGDimensionWidth], YGDimensionWidth);
+  node->setLayoutDimension(
+      layout.measuredDimensions[YGDimensionHeight], YGDimensionHeight);
+  node->setHasNewLayout(true);
+  node->setDirty(false);
+  layout.generationCount = pass.generationCount;
+
+  Event::publish<Event::NodeLayout>(
+      node,
+      {isCached ? LayoutType::kCachedLayout : LayoutType::kLayout,
+       layoutContext});
 }
 
 static void YGNodeAbsoluteLayoutChild(
@@ -1389,7 +1674,7 @@ static void YGNodeAbsoluteLayoutChild(
     LayoutData& layoutMarkerData,
     void* const layoutContext,
     const uint32_t depth,
-    const uint32_t generationCount) {
+    YGLayoutPass& pass) {
   const YGFlexDirection mainAxis =
       YGResolveFlexDirection(node->getStyle().flexDirection(), direction);
   const YGFlexDirection crossAxis = YGFlexDirectionCross(mainAxis, direction);
@@ -1497,29 +1782,42 @@ static void YGNodeAbsoluteLayoutChild(
         layoutMarkerData,
         layoutContext,
         depth,
-        generationCount);
+        pass);
     childWidth = child->getLayout().measuredDimensions[YGDimensionWidth] +
         child->getMarginForAxis(YGFlexDirectionRow, width).unwrap();
     childHeight = child->getLayout().measuredDimensions[YGDimensionHeight] +
         child->getMarginForAxis(YGFlexDirectionColumn, width).unwrap();
   }
 
-  YGLayoutNodeInternal(
-      child,
-      childWidth,
-      childHeight,
-      direction,
-      YGMeasureModeExactly,
-      YGMeasureModeExactly,
-      childWidth,
-      childHeight,
-      true,
-      LayoutPassReason::kAbsLayout,
-      config,
-      layoutMarkerData,
-      layoutContext,
-      depth,
-      generationCount);
+  if (child->hasStaticGeometry() && child->getChildren().empty() &&
+      !child->hasMeasureFunc()) {
+    YGNodeLayoutStaticGeometry(
+        child,
+        childWidth,
+        childHeight,
+        direction,
+        layoutMarkerData,
+        layoutContext,
+        depth,
+        pass);
+  } else {
+    YGLayoutNodeInternal(
+        child,
+        childWidth,
+        childHeight,
+        direction,
+        YGMeasureModeExactly,
+        YGMeasureModeExactly,
+        childWidth,
+        childHeight,
+        true,
+        LayoutPassReason::kAbsLayout,
+        config,
+        layoutMarkerData,
+        layoutContext,
+        depth,
+        pass);
+  }
 
   if (child->isTrailingPosDefined(mainAxis) &&
       !child->isLeadingPositionDefined(mainAxis)) {
@@ -1579,6 +1877,61 @@ static void YGNodeAbsoluteLayoutChild(
   }
 }
 
+// Calls the measure function of the node, unless the measure cache of its
+// config already has the result.
+static YGSize YGNodeMeasure(
+    const YGNodeRef node,
+    const float width,
+    const YGMeasureMode widthMeasureMode,
+    const float height,
+    const YGMeasureMode heightMeasureMode,
+    LayoutData& layoutMarkerData,
+    void* const layoutContext,
+    const LayoutPassReason reason) {
+  const auto& measureCache = node->getConfig()->measureCache;
+  const uint64_t measureCacheKey = node->getMeasureCacheKey();
+  const bool useMeasureCache = measureCache != nullptr && measureCacheKey != 0;
+  const detail::MeasureCache::Key key{node->getMeasureFuncId(),
+                                      measureCacheKey,
+                                      width,
+                                      widthMeasureMode,
+                                      height,
+                                      heightMeasureMode};
+  YGSize measuredSize;
+  if (useMeasureCache && measureCache->get(key, measuredSize)) {
+    return measuredSize;
+  }
+
+  Event::publish<Event::MeasureCallbackStart>(node);
+
+  measuredSize = node->measure(
+      width,
+      widthMeasureMode,
+      height,
+      heightMeasureMode,
+      layoutContext);
+
+  layoutMarkerData.measureCallbacks += 1;
+  layoutMarkerData.measureCallbackReasonsCount[static_cast<size_t>(reason)] +=
+      1;
+
+  Event::publish<Event::MeasureCallbackEnd>(
+      node,
+      {layoutContext,
+       width,
+       widthMeasureMode,
+       height,
+       heightMeasureMode,
+       measuredSize.width,
+       measuredSize.height,
+       reason});
+
+  if (useMeasureCache) {
+    measureCache->put(key, measuredSize);
+  }
+  return measuredSize;
+}
+
 static void YGNodeWithMeasureFuncSetMeasuredDimensions(
     const YGNodeRef node,
     const float availableWidth,
@@ -1633,30 +1986,16 @@ static void YGNodeWithMeasureFuncSetMeasuredDimensions(
             ownerWidth),
         YGDimensionHeight);
   } else {
-    Event::publish<Event::MeasureCallbackStart>(node);
-
     // Measure the text under the current constraints.
-    const YGSize measuredSize = node->measure(
+    const YGSize measuredSize = YGNodeMeasure(
+        node,
         innerWidth,
         widthMeasureMode,
         innerHeight,
         heightMeasureMode,
-        layoutContext);
-
-    layoutMarkerData.measureCallbacks += 1;
-    layoutMarkerData.measureCallbackReasonsCount[static_cast<size_t>(reason)] +=
-        1;
-
-    Event::publish<Event::MeasureCallbackEnd>(
-        node,
-        {layoutContext,
-         innerWidth,
-         widthMeasureMode,
-         innerHeight,
-         heightMeasureMode,
-         measuredSize.width,
-         measuredSize.height,
-         reason});
+        layoutMarkerData,
+        layoutContext,
+        reason);
 
     node->setLayoutMeasuredDimension(
         YGNodeBoundAxis(
@@ -1829,6 +2168,30 @@ static float YGNodeCalculateAvailableInnerDim(
   return availableInnerDim;
 }
 
+// Whether `child` would get the same layout as the last time `node` was laid
+// out, see YGConfigSetIncrementalLayoutEnabled. That's only known for the
+// children that don't flex, the size of the others depends on their siblings.
+static inline bool YGNodeCanKeepChildLayout(
+    const YGNodeRef node,
+    const YGNodeRef child) {
+  return node->getLayout().hasReusableChildLayouts() && !child->isDirty() &&
+      child->getStyle().positionType() == YGPositionTypeRelative &&
+      !child->isNodeFlexible();
+}
+
+// Does what laying out `child` again would do when all of its subtree is
+// cached
+static void YGNodeKeepChildLayout(const YGNodeRef child, YGLayoutPass& pass) {
+  child->setLayoutDimension(
+      child->getLayout().measuredDimensions[YGDimensionWidth],
+      YGDimensionWidth);
+  child->setLayoutDimension(
+      child->getLayout().measuredDimensions[YGDimensionHeight],
+      YGDimensionHeight);
+  child->setHasNewLayout(true);
+  child->getLayout().generationCount = pass.generationCount;
+}
+
 static float YGNodeComputeFlexBasisForChildren(
     const YGNodeRef node,
     const float availableInnerWidth,
@@ -1842,7 +2205,7 @@ static float YGNodeComputeFlexBasisForChildren(
     LayoutData& layoutMarkerData,
     void* const layoutContext,
     const uint32_t depth,
-    const uint32_t generationCount) {
+    YGLayoutPass& pass) {
   float totalOuterFlexBasis = 0.0f;
   YGNodeRef singleFlexChild = nullptr;
   const YGVector &children = node->getChildren();
@@ -1893,8 +2256,10 @@ static float YGNodeComputeFlexBasisForChildren(
       continue;
     }
     if (child == singleFlexChild) {
-      child->setLayoutComputedFlexBasisGeneration(generationCount);
+      child->setLayoutComputedFlexBasisGeneration(pass.generationCount);
       child->setLayoutComputedFlexBasis(YGFloatOptional(0));
+    } else if (YGNodeCanKeepChildLayout(node, child)) {
+      // The flex basis from last time still holds
     } else {
       YGNodeComputeFlexBasisForChild(
           node,
@@ -1910,7 +2275,7 @@ static float YGNodeComputeFlexBasisForChildren(
           layoutMarkerData,
           layoutContext,
           depth,
-          generationCount);
+          pass);
     }
 
     totalOuterFlexBasis +=
@@ -2026,7 +2391,7 @@ static float YGDistributeFreeSpaceSecondPass(
     LayoutData& layoutMarkerData,
     void* const layoutContext,
     const uint32_t depth,
-    const uint32_t generationCount) {
+    YGLayoutPass& pass) {
   float childFlexBasis = 0;
   float flexShrinkScaledFactor = 0;
   float flexGrowFactor = 0;
@@ -2035,6 +2400,14 @@ static float YGDistributeFreeSpaceSecondPass(
   const bool isNodeFlexWrap = node->getStyle().flexWrap() != YGWrapNoWrap;
 
   for (auto currentRelativeChild : collectedFlexItemsValues.relativeChildren) {
+    if (YGNodeCanKeepChildLayout(node, currentRelativeChild)) {
+      // Its main size is the flex basis again, which didn't change either
+      YGNodeKeepChildLayout(currentRelativeChild, pass);
+      node->setLayoutHadOverflow(
+          node->getLayout().hadOverflow() |
+          currentRelativeChild->getLayout().hadOverflow());
+      continue;
+    }
     childFlexBasis = YGNodeBoundAxisWithinMinAndMax(
                          currentRelativeChild,
                          mainAxis,
@@ -2196,7 +2569,7 @@ static float YGDistributeFreeSpaceSecondPass(
         layoutMarkerData,
         layoutContext,
         depth,
-        generationCount);
+        pass);
     node->setLayoutHadOverflow(
         node->getLayout().hadOverflow() |
         currentRelativeChild->getLayout().hadOverflow());
@@ -2329,7 +2702,7 @@ static void YGResolveFlexibleLength(
     LayoutData& layoutMarkerData,
     void* const layoutContext,
     const uint32_t depth,
-    const uint32_t generationCount) {
+    YGLayoutPass& pass) {
   const float originalFreeSpace = collectedFlexItemsValues.remainingFreeSpace;
   // First pass: detect the flex items whose min/max constraints trigger
   YGDistributeFreeSpaceFirstPass(
@@ -2357,7 +2730,7 @@ static void YGResolveFlexibleLength(
       layoutMarkerData,
       layoutContext,
       depth,
-      generationCount);
+      pass);
 
   collectedFlexItemsValues.remainingFreeSpace =
       originalFreeSpace - distributedFreeSpace;
@@ -2659,7 +3032,7 @@ static void YGNodelayoutImpl(
     LayoutData& layoutMarkerData,
     void* const layoutContext,
     const uint32_t depth,
-    const uint32_t generationCount,
+    YGLayoutPass& pass,
     const LayoutPassReason reason) {
   YGAssertWithNode(
       node,
@@ -2678,46 +3051,8 @@ static void YGNodelayoutImpl(
 
   (performLayout ? layoutMarkerData.layouts : layoutMarkerData.measures) += 1;
 
-  // Set the resolved resolution in the node's layout.
-  const YGDirection direction = node->resolveDirection(ownerDirection);
-  node->setLayoutDirection(direction);
-
-  const YGFlexDirection flexRowDirection =
-      YGResolveFlexDirection(YGFlexDirectionRow, direction);
-  const YGFlexDirection flexColumnDirection =
-      YGResolveFlexDirection(YGFlexDirectionColumn, direction);
-
-  const YGEdge startEdge =
-      direction == YGDirectionLTR ? YGEdgeLeft : YGEdgeRight;
-  const YGEdge endEdge = direction == YGDirectionLTR ? YGEdgeRight : YGEdgeLeft;
-  node->setLayoutMargin(
-      node->getLeadingMargin(flexRowDirection, ownerWidth).unwrap(), startEdge);
-  node->setLayoutMargin(
-      node->getTrailingMargin(flexRowDirection, ownerWidth).unwrap(), endEdge);
-  node->setLayoutMargin(
-      node->getLeadingMargin(flexColumnDirection, ownerWidth).unwrap(),
-      YGEdgeTop);
-  node->setLayoutMargin(
-      node->getTrailingMargin(flexColumnDirection, ownerWidth).unwrap(),
-      YGEdgeBottom);
-
-  node->setLayoutBorder(node->getLeadingBorder(flexRowDirection), startEdge);
-  node->setLayoutBorder(node->getTrailingBorder(flexRowDirection), endEdge);
-  node->setLayoutBorder(node->getLeadingBorder(flexColumnDirection), YGEdgeTop);
-  node->setLayoutBorder(
-      node->getTrailingBorder(flexColumnDirection), YGEdgeBottom);
-
-  node->setLayoutPadding(
-      node->getLeadingPadding(flexRowDirection, ownerWidth).unwrap(),
-      startEdge);
-  node->setLayoutPadding(
-      node->getTrailingPadding(flexRowDirection, ownerWidth).unwrap(), endEdge);
-  node->setLayoutPadding(
-      node->getLeadingPadding(flexColumnDirection, ownerWidth).unwrap(),
-      YGEdgeTop);
-  node->setLayoutPadding(
-      node->getTrailingPadding(flexColumnDirection, ownerWidth).unwrap(),
-      YGEdgeBottom);
+  const YGDirection direction =
+      YGNodeSetLayoutDirectionAndEdges(node, ownerDirection, ownerWidth);
 
   if (node->hasMeasureFunc()) {
     YGNodeWithMeasureFuncSetMeasuredDimensions(
@@ -2829,6 +3164,27 @@ static void YGNodelayoutImpl(
   const float availableInnerCrossDim =
       isMainAxisRow ? availableInnerHeight : availableInnerWidth;
 
+  // Within a single line with an exact cross size, the flex basis and the
+  // layout of a child that doesn't flex only depend on the inner size of the
+  // node and on the child itself. If neither changed since the node was last
+  // laid out, the clean children keep theirs and only get positioned again.
+  // Measuring the node only needs the flex basis, laying it out also needs an
+  // exact main size so that the lengths don't depend on the content.
+  const bool canKeepChildLayouts = node->getConfig()->incrementalLayout &&
+      measureModeCrossDim == YGMeasureModeExactly &&
+      (!performLayout || measureModeMainDim == YGMeasureModeExactly) &&
+      !isNodeFlexWrap && !YGIsBaselineLayout(node);
+  YGLayout& layout = node->getLayout();
+  layout.hasReusableChildLayouts() = canKeepChildLayouts &&
+      layout.hasReusableChildLayouts() &&
+      layout.childLayoutDirection == direction &&
+      YGFloatsEqual(
+          layout.childLayoutInnerDimensions[YGDimensionWidth],
+          availableInnerWidth) &&
+      YGFloatsEqual(
+          layout.childLayoutInnerDimensions[YGDimensionHeight],
+          availableInnerHeight);
+
   // STEP 3: DETERMINE FLEX BASIS FOR EACH ITEM
 
   float totalOuterFlexBasis = YGNodeComputeFlexBasisForChildren(
@@ -2844,7 +3200,7 @@ static void YGNodelayoutImpl(
       layoutMarkerData,
       layoutContext,
       depth,
-      generationCount);
+      pass);
 
   const bool flexBasisOverflows = measureModeMainDim == YGMeasureModeUndefined
       ? false
@@ -2954,7 +3310,7 @@ static void YGNodelayoutImpl(
           layoutMarkerData,
           layoutContext,
           depth,
-          generationCount);
+          pass);
     }
 
     node->setLayoutHadOverflow(
@@ -3063,7 +3419,8 @@ static void YGNodelayoutImpl(
             // If the child defines a definite size for its cross axis, there's
             // no need to stretch.
             if (!YGNodeIsStyleDimDefined(
-                    child, crossAxis, availableInnerCrossDim)) {
+                    child, crossAxis, availableInnerCrossDim) &&
+                !YGNodeCanKeepChildLayout(node, child)) {
               float childMainSize =
                   child->getLayout().measuredDimensions[dim[mainAxis]];
               const auto& childStyle = child->getStyle();
@@ -3130,7 +3487,7 @@ static void YGNodelayoutImpl(
                   layoutMarkerData,
                   layoutContext,
                   depth,
-                  generationCount);
+                  pass);
             }
           } else {
             const float remainingCrossDim = containerCrossAxis -
@@ -3340,7 +3697,7 @@ static void YGNodelayoutImpl(
                         layoutMarkerData,
                         layoutContext,
                         depth,
-                        generationCount);
+                        pass);
                   }
                 }
                 break;
@@ -3482,7 +3839,7 @@ static void YGNodelayoutImpl(
           layoutMarkerData,
           layoutContext,
           depth,
-          generationCount);
+          pass);
     }
 
     // STEP 11: SETTING TRAILING POSITIONS FOR CHILDREN
@@ -3508,6 +3865,15 @@ static void YGNodelayoutImpl(
       }
     }
   }
+
+  // Measuring leaves the children that weren't kept with their measured size
+  // rather than their final one, so only laying out refreshes what's kept
+  if (performLayout) {
+    layout.hasReusableChildLayouts() = canKeepChildLayouts;
+    layout.childLayoutInnerDimensions = {
+        {availableInnerWidth, availableInnerHeight}};
+    layout.childLayoutDirection = direction;
+  }
 }
 
 bool gPrintChanges = false;
@@ -3694,6 +4060,164 @@ bool YGNodeCanUseCachedMeasurement(
   return widthIsCompatible && heightIsCompatible;
 }
 
+static bool YGNodeHasBaselineLayout(
+    const YGNodeRef node,
+    std::unordered_map<YGNodeRef, bool>& memo) {
+  auto it = memo.find(node);
+  if (it != memo.end()) {
+    return it->second;
+  }
+  bool hasBaselineLayout = YGIsBaselineLayout(node);
+  for (auto child : node->getChildren()) {
+    if (hasBaselineLayout) {
+      break;
+    }
+    hasBaselineLayout = YGNodeHasBaselineLayout(child, memo);
+  }
+  memo.emplace(node, hasBaselineLayout);
+  return hasBaselineLayout;
+}
+
+// With parallel layout a container of definite size hands the subtrees of its
+// children with exact sizes over to the worker pool instead of laying them out
+// in place. The owner only needs their measured dimensions and those are known
+// upfront, nodes below them aren't looked at until rounding. Baselines are the
+// exception: they are read from the positions of descendants, even when only
+// measuring. Nothing under a baseline layout is deferred, and neither is a
+// subtree with a baseline layout in it, as measuring it again would read the
+// positions its deferred layout hasn't set yet.
+static bool YGNodeDeferLayout(
+    const YGNodeRef node,
+    const float availableWidth,
+    const float availableHeight,
+    const YGDirection ownerDirection,
+    const YGMeasureMode widthMeasureMode,
+    const YGMeasureMode heightMeasureMode,
+    const float ownerWidth,
+    const float ownerHeight,
+    const bool performLayout,
+    const LayoutPassReason reason,
+    const YGConfigRef config,
+    void* const layoutContext,
+    const uint32_t depth,
+    YGLayoutPass& pass) {
+  if (pass.deferred == nullptr || !performLayout || node == pass.root ||
+      widthMeasureMode != YGMeasureModeExactly ||
+      heightMeasureMode != YGMeasureModeExactly || node->hasMeasureFunc() ||
+      node->getChildren().empty() || pass.deferred->hasPendingBelow(node)) {
+    return false;
+  }
+  if (!pass.deferred->withoutBaselines()) {
+    for (YGNodeRef owner = node->getOwner(); owner != nullptr;
+         owner = owner->getOwner()) {
+      if (YGIsBaselineLayout(owner)) {
+        return false;
+      }
+      if (owner == pass.root) {
+        break;
+      }
+    }
+    if (YGNodeHasBaselineLayout(node, pass.deferred->baselineSubtrees)) {
+      return false;
+    }
+  }
+
+  node->setLayoutDirection(node->resolveDirection(ownerDirection));
+  YGNodeFixedSizeSetMeasuredDimensions(
+      node,
+      availableWidth,
+      availableHeight,
+      widthMeasureMode,
+      heightMeasureMode,
+      ownerWidth,
+      ownerHeight);
+  pass.deferred->add({node,
+                      availableWidth,
+                      availableHeight,
+                      ownerDirection,
+                      ownerWidth,
+                      ownerHeight,
+                      reason,
+                      config,
+                      layoutContext,
+                      depth});
+  return true;
+}
+
+// Owners take in the overflow of children laid out in place, do the same for
+// a deferred one. Stops short of `root`, which belongs to an outer pass.
+static void YGNodePropagateHadOverflow(
+    const YGNodeRef node,
+    const YGNodeRef root,
+    const YGDeferredLayouts& deferred) {
+  if (!node->getLayout().hadOverflow()) {
+    return;
+  }
+  for (YGNodeRef child = node; child != root; child = child->getOwner()) {
+    const YGNodeRef owner = child->getOwner();
+    if (owner == nullptr || !deferred.isFlexLayout(child)) {
+      return;
+    }
+    owner->setLayoutHadOverflow(true);
+  }
+}
+
+static void YGLayoutDeferredNodes(
+    YGDeferredLayouts& deferred,
+    const YGNodeRef root,
+    const uint32_t generationCount,
+    LayoutData& layoutMarkerData) {
+  auto& layouts = deferred.layouts();
+  if (layouts.empty()) {
+    return;
+  }
+
+  std::vector<LayoutData> markerData(layouts.size(), LayoutData{});
+  detail::WorkerPool::forEach(layouts.size(), [&](size_t i) {
+    const YGDeferredLayout& layout = layouts[i];
+    // Subtrees of the deferred node can be split off again, which keeps the
+    // workers busy when the tree only fans out further down
+    YGDeferredLayouts nested{layout.node, true};
+    YGLayoutPass pass = {generationCount, layout.node, &nested};
+    YGLayoutNodeInternal(
+        layout.node,
+        layout.availableWidth,
+        layout.availableHeight,
+        layout.ownerDirection,
+        YGMeasureModeExactly,
+        YGMeasureModeExactly,
+        layout.ownerWidth,
+        layout.ownerHeight,
+        true,
+        layout.reason,
+        layout.config,
+        markerData[i],
+        layout.layoutContext,
+        layout.depth,
+        pass);
+    YGLayoutDeferredNodes(nested, layout.node, generationCount, markerData[i]);
+  });
+
+  for (size_t i = 0; i < layouts.size(); i++) {
+    YGNodePropagateHadOverflow(layouts[i].node, root, deferred);
+    const LayoutData& data = markerData[i];
+    layoutMarkerData.layouts += data.layouts;
+    layoutMarkerData.measures += data.measures;
+    layoutMarkerData.maxMeasureCache =
+        std::max(layoutMarkerData.maxMeasureCache, data.maxMeasureCache);
+    layoutMarkerData.maxDepth =
+        std::max(layoutMarkerData.maxDepth, data.maxDepth);
+    layoutMarkerData.cachedLayouts += data.cachedLayouts;
+    layoutMarkerData.cachedMeasures += data.cachedMeasures;
+    layoutMarkerData.measureCallbacks += data.measureCallbacks;
+    for (size_t reason = 0; reason < data.measureCallbackReasonsCount.size();
+         reason++) {
+      layoutMarkerData.measureCallbackReasonsCount[reason] +=
+          data.measureCallbackReasonsCount[reason];
+    }
+  }
+}
+
 //
 // This is a wrapper around the YGNodelayoutImpl function. It determines whether
 // the layout request is redundant and can be skipped.
@@ -3717,13 +4241,19 @@ bool YGLayoutNodeInternal(
     LayoutData& layoutMarkerData,
     void* const layoutContext,
     uint32_t depth,
-    const uint32_t generationCount) {
+    YGLayoutPass& pass) {
   YGLayout* layout = &node->getLayout();
 
   depth++;
+  layoutMarkerData.maxDepth =
+      std::max(layoutMarkerData.maxDepth, static_cast<int>(depth));
+
+  if (performLayout && pass.deferred != nullptr) {
+    pass.deferred->willLayout(node, reason);
+  }
 
   const bool needToVisitNode =
-      (node->isDirty() && layout->generationCount != generationCount) ||
+      (node->isDirty() && layout->generationCount != pass.generationCount) ||
       layout->lastOwnerDirection != ownerDirection;
 
   if (needToVisitNode) {
@@ -3842,6 +4372,24 @@ bool YGLayoutNodeInternal(
           LayoutPassReasonToString(reason));
     }
   } else {
+    if (YGNodeDeferLayout(
+            node,
+            availableWidth,
+            availableHeight,
+            ownerDirection,
+            widthMeasureMode,
+            heightMeasureMode,
+            ownerWidth,
+            ownerHeight,
+            performLayout,
+            reason,
+            config,
+            layoutContext,
+            depth - 1,
+            pass)) {
+      return true;
+    }
+
     if (gPrintChanges) {
       Log::log(
           node,
@@ -3878,7 +4426,7 @@ bool YGLayoutNodeInternal(
         layoutMarkerData,
         layoutContext,
         depth,
-        generationCount,
+        pass,
         reason);
 
     if (gPrintChanges) {
@@ -3952,7 +4500,7 @@ bool YGLayoutNodeInternal(
     node->setDirty(false);
   }
 
-  layout->generationCount = generationCount;
+  layout->generationCount = pass.generationCount;
 
   LayoutType layoutType;
   if (performLayout) {
@@ -3985,15 +4533,31 @@ void YGConfigSetPointScaleFactor(
   }
 }
 
-static void YGRoundToPixelGrid(
+using detail::PixelRounding;
+
+namespace {
+
+// Rounding inputs of a tree, six values per node: the position relative to
+// the owner, then the absolute right, left, bottom and top edges
+struct YGPixelGridValues {
+  std::vector<YGNodeRef> nodes;
+  std::vector<float> values;
+  std::vector<PixelRounding> rounding;
+
+  void push(float value, PixelRounding valueRounding) {
+    values.push_back(value);
+    rounding.push_back(valueRounding);
+  }
+};
+
+} // namespace
+
+static void YGCollectPixelGridValues(
     const YGNodeRef node,
     const float pointScaleFactor,
     const float absoluteLeft,
-    const float absoluteTop) {
-  if (pointScaleFactor == 0.0f) {
-    return;
-  }
-
+    const float absoluteTop,
+    YGPixelGridValues& grid) {
   const float nodeLeft = node->getLayout().position[YGEdgeLeft];
   const float nodeTop = node->getLayout().position[YGEdgeTop];
 
@@ -4009,52 +4573,79 @@ static void YGRoundToPixelGrid(
   // If a node has a custom measure function we never want to round down its
   // size as this could lead to unwanted text truncation.
   const bool textRounding = node->getNodeType() == YGNodeTypeText;
+  const PixelRounding originRounding =
+      textRounding ? PixelRounding::Floor : PixelRounding::Nearest;
+  PixelRounding rightRounding = PixelRounding::Nearest;
+  PixelRounding bottomRounding = PixelRounding::Nearest;
+
+  if (textRounding) {
+    // We multiply dimension by scale factor and if the result is close to the
+    // whole number, we don't have any fraction To verify if the result is
+    // close to whole number we want to check both floor and ceil numbers
+    const bool hasFractionalWidth =
+        !YGFloatsEqual(fmodf(nodeWidth * pointScaleFactor, 1.0), 0) &&
+        !YGFloatsEqual(fmodf(nodeWidth * pointScaleFactor, 1.0), 1.0);
+    const bool hasFractionalHeight =
+        !YGFloatsEqual(fmodf(nodeHeight * pointScaleFactor, 1.0), 0) &&
+        !YGFloatsEqual(fmodf(nodeHeight * pointScaleFactor, 1.0), 1.0);
+    rightRounding =
+        hasFractionalWidth ? PixelRounding::Ceil : PixelRounding::Floor;
+    bottomRounding =
+        hasFractionalHeight ? PixelRounding::Ceil : PixelRounding::Floor;
+  }
 
-  node->setLayoutPosition(
-      YGRoundValueToPixelGrid(nodeLeft, pointScaleFactor, false, textRounding),
-      YGEdgeLeft);
-
-  node->setLayoutPosition(
-      YGRoundValueToPixelGrid(nodeTop, pointScaleFactor, false, textRounding),
-      YGEdgeTop);
-
-  // We multiply dimension by scale factor and if the result is close to the
-  // whole number, we don't have any fraction To verify if the result is close
-  // to whole number we want to check both floor and ceil numbers
-  const bool hasFractionalWidth =
-      !YGFloatsEqual(fmodf(nodeWidth * pointScaleFactor, 1.0), 0) &&
-      !YGFloatsEqual(fmodf(nodeWidth * pointScaleFactor, 1.0), 1.0);
-  const bool hasFractionalHeight =
-      !YGFloatsEqual(fmodf(nodeHeight * pointScaleFactor, 1.0), 0) &&
-      !YGFloatsEqual(fmodf(nodeHeight * pointScaleFactor, 1.0), 1.0);
-
-  node->setLayoutDimension(
-      YGRoundValueToPixelGrid(
-          absoluteNodeRight,
-          pointScaleFactor,
-          (textRounding && hasFractionalWidth),
-          (textRounding && !hasFractionalWidth)) -
-          YGRoundValueToPixelGrid(
-              absoluteNodeLeft, pointScaleFactor, false, textRounding),
-      YGDimensionWidth);
-
-  node->setLayoutDimension(
-      YGRoundValueToPixelGrid(
-          absoluteNodeBottom,
-          pointScaleFactor,
-          (textRounding && hasFractionalHeight),
-          (textRounding && !hasFractionalHeight)) -
-          YGRoundValueToPixelGrid(
-              absoluteNodeTop, pointScaleFactor, false, textRounding),
-      YGDimensionHeight);
+  grid.nodes.push_back(node);
+  grid.push(nodeLeft, originRounding);
+  grid.push(nodeTop, originRounding);
+  grid.push(absoluteNodeRight, rightRounding);
+  grid.push(absoluteNodeLeft, originRounding);
+  grid.push(absoluteNodeBottom, bottomRounding);
+  grid.push(absoluteNodeTop, originRounding);
 
   const uint32_t childCount = YGNodeGetChildCount(node);
   for (uint32_t i = 0; i < childCount; i++) {
-    YGRoundToPixelGrid(
+    YGCollectPixelGridValues(
         YGNodeGetChild(node, i),
         pointScaleFactor,
         absoluteNodeLeft,
-        absoluteNodeTop);
+        absoluteNodeTop,
+        grid);
+  }
+}
+
+// Rounds the layout of the whole tree in one batch. All values are collected
+// first, as the absolute edges of the children depend on the unrounded
+// layout of their owners.
+static void YGRoundToPixelGrid(
+    const YGNodeRef node,
+    const float pointScaleFactor,
+    const float absoluteLeft,
+    const float absoluteTop) {
+  if (pointScaleFactor == 0.0f) {
+    return;
+  }
+
+  // Reused to keep relayouts from allocating
+  static thread_local YGPixelGridValues grid;
+  grid.nodes.clear();
+  grid.values.clear();
+  grid.rounding.clear();
+
+  YGCollectPixelGridValues(
+      node, pointScaleFactor, absoluteLeft, absoluteTop, grid);
+  detail::roundValuesToPixelGrid(
+      grid.values.data(),
+      grid.rounding.data(),
+      grid.values.size(),
+      pointScaleFactor);
+
+  for (size_t i = 0; i < grid.nodes.size(); i++) {
+    const YGNodeRef gridNode = grid.nodes[i];
+    const float* values = &grid.values[i * 6];
+    gridNode->setLayoutPosition(values[0], YGEdgeLeft);
+    gridNode->setLayoutPosition(values[1], YGEdgeTop);
+    gridNode->setLayoutDimension(values[2] - values[3], YGDimensionWidth);
+    gridNode->setLayoutDimension(values[4] - values[5], YGDimensionHeight);
   }
 }
 
@@ -4075,10 +4666,20 @@ void YGNodeCalculateLayoutWithContext(
   Event::publish<Event::LayoutPassStart>(node, {layoutContext});
   LayoutData markerData = {};
 
+  if (node->getOwner() != nullptr) {
+    // The owner can't keep the layout this gives the node, that depends on
+    // what it's called with here
+    node->getOwner()->getLayout().hasReusableChildLayouts() = false;
+  }
+
+  YGDeferredLayouts deferred{node, false};
   // Increment the generation count. This will force the recursive routine to
   // visit all dirty nodes at least once. Subsequent visits will be skipped if
   // the input parameters don't change.
-  gCurrentGenerationCount++;
+  YGLayoutPass pass = {
+      ++gCurrentGenerationCount,
+      node,
+      node->getConfig()->parallelLayout ? &deferred : nullptr};
   node->resolveDimension();
   float width = YGUndefined;
   YGMeasureMode widthMeasureMode = YGMeasureModeUndefined;
@@ -4135,7 +4736,8 @@ void YGNodeCalculateLayoutWithContext(
           markerData,
           layoutContext,
           0, // tree root
-          gCurrentGenerationCount)) {
+          pass)) {
+    YGLayoutDeferredNodes(deferred, node, pass.generationCount, markerData);
     node->setPosition(
         node->getLayout().direction(), ownerWidth, ownerHeight, ownerWidth);
     YGRoundToPixelGrid(node, node->getConfig()->pointScaleFactor, 0.0f, 0.0f);
@@ -4166,7 +4768,8 @@ void YGNodeCalculateLayoutWithContext(
     nodeWithoutLegacyFlag->resolveDimension();
     // Recursively mark nodes as dirty
     nodeWithoutLegacyFlag->markDirtyAndPropogateDownwards();
-    gCurrentGenerationCount++;
+    YGLayoutPass passWithoutLegacyFlag = {
+        ++gCurrentGenerationCount, nodeWithoutLegacyFlag, nullptr};
     // Rerun the layout, and calculate the diff
     unsetUseLegacyFlagRecursively(nodeWithoutLegacyFlag);
     LayoutData layoutMarkerData = {};
@@ -4185,7 +4788,7 @@ void YGNodeCalculateLayoutWithContext(
             layoutMarkerData,
             layoutContext,
             0, // tree root
-            gCurrentGenerationCount)) {
+            passWithoutLegacyFlag)) {
       nodeWithoutLegacyFlag->setPosition(
           nodeWithoutLegacyFlag->getLayout().direction(),
           ownerWidth,
@@ -4291,6 +4894,56 @@ void YGConfigSetUseLegacyStretchBehaviour(
   config->useLegacyStretchBehaviour = useLegacyStretchBehaviour;
 }
 
+void YGConfigSetParallelLayoutEnabled(
+    const YGConfigRef config,
+    const bool enabled) {
+  config->parallelLayout = enabled;
+}
+
+bool YGConfigGetParallelLayoutEnabled(const YGConfigRef config) {
+  return config->parallelLayout;
+}
+
+void YGConfigSetMeasureCacheCapacity(
+    const YGConfigRef config,
+    const uint32_t capacity) {
+  if (capacity == YGConfigGetMeasureCacheCapacity(config)) {
+    return;
+  }
+  config->measureCache = capacity == 0
+      ? nullptr
+      : std::make_shared<facebook::yoga::detail::MeasureCache>(capacity);
+}
+
+uint32_t YGConfigGetMeasureCacheCapacity(const YGConfigRef config) {
+  return config->measureCache != nullptr
+      ? static_cast<uint32_t>(config->measureCache->capacity())
+      : 0;
+}
+
+void YGConfigSetNodePoolEnabled(const YGConfigRef config, const bool enabled) {
+  if (enabled && config->nodePool == nullptr) {
+    // Nodes start on a cache line, the fields used the most come first
+    config->nodePool = std::make_shared<facebook::yoga::detail::NodePool>(
+        sizeof(YGNode), 64);
+  }
+  config->useNodePool = enabled;
+}
+
+bool YGConfigGetNodePoolEnabled(const YGConfigRef config) {
+  return config->useNodePool;
+}
+
+void YGConfigSetIncrementalLayoutEnabled(
+    const YGConfigRef config,
+    const bool enabled) {
+  config->incrementalLayout = enabled;
+}
+
+bool YGConfigGetIncrementalLayoutEnabled(const YGConfigRef config) {
+  return config->incrementalLayout;
+}
+
 bool YGConfigGetUseWebDefaults(const YGConfigRef config) {
   return config->useWebDefaults;
 }
@@ -131,6 +131,12 @@ WIN_EXPORT void YGNodeSetContext(YGNodeRef node, void* context);
 void YGConfigSetPrintTreeFlag(YGConfigRef config, bool enabled);
 bool YGNodeHasMeasureFunc(YGNodeRef node);
 WIN_EXPORT void YGNodeSetMeasureFunc(YGNodeRef node, YGMeasureFunc measureFunc);
+// Key for the results of the measure function in the measure cache of the
+// config, see YGConfigSetMeasureCacheCapacity. Has to change whenever anything
+// the measure function reads does, for instance a hash of the text and its
+// attributes. 0, the default, keeps the node out of the cache.
+WIN_EXPORT void YGNodeSetMeasureCacheKey(YGNodeRef node, uint64_t key);
+WIN_EXPORT uint64_t YGNodeGetMeasureCacheKey(YGNodeRef node);
 bool YGNodeHasBaselineFunc(YGNodeRef node);
 void YGNodeSetBaselineFunc(YGNodeRef node, YGBaselineFunc baselineFunc);
 YGDirtiedFunc YGNodeGetDirtiedFunc(YGNodeRef node);
@@ -316,6 +322,41 @@ WIN_EXPORT void YGConfigSetUseLegacyStretchBehaviour(
     YGConfigRef config,
     bool useLegacyStretchBehaviour);
 
+// Lays out the subtrees of children that have an exact size in parallel, on a
+// pool of worker threads shared by the process. Measure, baseline, clone and
+// logger callbacks as well as event subscribers are then called from several
+// threads at once and have to be thread-safe. Decided by the root's config.
+WIN_EXPORT void YGConfigSetParallelLayoutEnabled(
+    YGConfigRef config,
+    bool enabled);
+WIN_EXPORT bool YGConfigGetParallelLayoutEnabled(YGConfigRef config);
+
+// Keeps up to `capacity` results of measure functions, for the nodes of the
+// config that have a measure cache key. Unlike the cache of every node it
+// survives cloning, dirtying and freeing nodes. 0, the default, disables it
+// and drops the results kept so far. Copies of the config share the cache.
+WIN_EXPORT void YGConfigSetMeasureCacheCapacity(
+    YGConfigRef config,
+    uint32_t capacity);
+WIN_EXPORT uint32_t YGConfigGetMeasureCacheCapacity(YGConfigRef config);
+
+// Allocates the nodes of the config next to each other, from slabs that are
+// kept until the config is freed. Nodes from the pool can be freed after the
+// pool got disabled again, but not after their config.
+WIN_EXPORT void YGConfigSetNodePoolEnabled(YGConfigRef config, bool enabled);
+WIN_EXPORT bool YGConfigGetNodePoolEnabled(YGConfigRef config);
+
+// When a single line node of the config with an exact cross size is laid out
+// again with the same inner size, its clean children that neither grow nor
+// shrink keep their layout and only get positioned again, instead of being
+// measured and laid out from scratch. Laying out, as opposed to measuring,
+// also needs an exact main size. That's the case for long lists of which a few
+// items changed. The children being kept don't publish events.
+WIN_EXPORT void YGConfigSetIncrementalLayoutEnabled(
+    YGConfigRef config,
+    bool enabled);
+WIN_EXPORT bool YGConfigGetIncrementalLayoutEnabled(YGConfigRef config);
+
 // YGConfig
 WIN_EXPORT YGConfigRef YGConfigNew(void);
 WIN_EXPORT void YGConfigFree(YGConfigRef config);
@@ -37,6 +37,9 @@ const char* LayoutPassReasonToString(const LayoutPassReason value) {
 
 namespace {
 
+// Subscribers are never unlinked one by one, so publishing can walk the list
+// without locking while other threads subscribe. Each node is complete before
+// it becomes the head, publishers acquire the head to see it that way.
 struct Node {
   std::function<Event::Subscriber> subscriber = nullptr;
   Node* next = nullptr;
@@ -55,7 +58,7 @@ Node* push(Node* newHead) {
       newHead->next = oldHead;
     }
   } while (!subscribers.compare_exchange_weak(
-      oldHead, newHead, std::memory_order_release, std::memory_order_relaxed));
+      oldHead, newHead, std::memory_order_acq_rel, std::memory_order_relaxed));
   return oldHead;
 }
 
@@ -75,7 +78,7 @@ void Event::subscribe(std::function<Subscriber>&& subscriber) {
 }
 
 void Event::publish(const YGNode& node, Type eventType, const Data& eventData) {
-  for (auto subscriber = subscribers.load(std::memory_order_relaxed);
+  for (auto subscriber = subscribers.load(std::memory_order_acquire);
        subscriber != nullptr;
        subscriber = subscriber->next) {
     subscriber->subscriber(node, eventType, eventData);
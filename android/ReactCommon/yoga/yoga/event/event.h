@@ -40,6 +40,7 @@ struct LayoutData {
   int layouts;
   int measures;
   int maxMeasureCache;
+  int maxDepth;
   int cachedLayouts;
   int cachedMeasures;
   int measureCallbacks;
@@ -81,8 +82,12 @@ struct Event {
     };
   };
 
+  // Drops all subscribers. Must not run while any thread publishes, i.e. lays
+  // out, meant for tests.
   static void reset();
 
+  // Can be called from any thread, also during layout on other threads.
+  // Subscribers are called on the thread that publishes.
   static void subscribe(std::function<Subscriber>&& subscriber);
 
   template <Type E>
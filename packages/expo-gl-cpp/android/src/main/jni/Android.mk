@@ -6,23 +6,53 @@ include $(CLEAR_VARS)
 LOCAL_MODULE := expo-gl
 
 LOCAL_C_INCLUDES += ../../../../cpp/
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../../../../../android/ReactCommon/jsi
 LOCAL_SRC_FILES := \
   ../../../../cpp/UEXGL.cpp \
   ../../../../cpp/EXJSUtils.c \
   ../../../../cpp/EXJSConvertTypedArray.c \
+  ../../../../cpp/EXGLAImageDecoder.cpp \
+  ../../../../cpp/EXGLCompressedTexture.cpp \
   ../../../../cpp/EXGLContext.cpp \
+  ../../../../cpp/EXGLEGLImage.cpp \
+  ../../../../cpp/EXGLImageLoader.cpp \
   ../../../../cpp/EXGLInstallMethods.cpp \
   ../../../../cpp/EXGLInstallConstants.cpp \
+  ../../../../cpp/EXGLJsiContext.cpp \
+  ../../../../cpp/EXGLMappedImage.cpp \
   ../../../../cpp/EXGLNativeMethods.cpp \
+  ../../../../cpp/EXGLPixelKernels.cpp \
+  ../../../../cpp/EXGLProgramCache.cpp \
+  ../../../../cpp/EXGLRenderPool.cpp \
+  ../../../../cpp/EXGLSnapshot.cpp \
+  ../../../../cpp/EXGLSystrace.cpp \
+  ../../../../cpp/EXGLTextRasterizer.cpp \
+  ../../../../cpp/EXGLTrace.cpp \
+  ../../../../cpp/EXGLWindowRenderer.cpp \
   EXGL.cpp
 
 # weird hack that lets us mix C++ with -std=c++11 and C with -std=c99
 LOCAL_C99_FILES := $(filter %.c, $(LOCAL_SRC_FILES))
 TARGET-process-src-files-tags += $(call add-src-files-target-cflags, $(LOCAL_C99_FILES), -std=c99)
 
+# jsi::JSError and friends
+LOCAL_CPP_FEATURES := rtti exceptions
+
+# pbuffers and contexts of the render pool, encoder surfaces, ATrace lookup,
+# bitmaps of rasterized text
+LOCAL_LDLIBS := -lEGL -landroid -ldl -ljnigraphics
+
 LOCAL_ALLOW_UNDEFINED_SYMBOLS := true
-LOCAL_SHARED_LIBRARIES := libjsc
+LOCAL_SHARED_LIBRARIES := libjsc libjsi
 
 include $(BUILD_SHARED_LIBRARY)
 
+# React Native's own JSI (REACT_NATIVE_SO_DIR is the jni/ directory of its
+# AAR): jsi::Runtime and jsi::JSError must have a single definition in the app
+# or exceptions thrown across the two libraries wouldn't be caught
+include $(CLEAR_VARS)
+LOCAL_MODULE := libjsi
+LOCAL_SRC_FILES := $(REACT_NATIVE_SO_DIR)/$(TARGET_ARCH_ABI)/libjsi.so
+include $(PREBUILT_SHARED_LIBRARY)
+
 $(call import-module,jsc)
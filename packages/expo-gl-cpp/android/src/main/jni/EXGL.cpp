@@ -1,18 +1,423 @@
 #include <stdint.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <jni.h>
+#include <string>
 #include <thread>
+#include <android/bitmap.h>
 #include <android/log.h>
+#include <android/native_window_jni.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
 
 #include <JavaScriptCore/JSContextRef.h>
 
 
 #include "UEXGL.h"
 
+// OES_EGL_image_external
+#ifndef GL_TEXTURE_EXTERNAL_OES
+#define GL_TEXTURE_EXTERNAL_OES 0x8D65
+#endif
+#ifndef GL_TEXTURE_BINDING_EXTERNAL_OES
+#define GL_TEXTURE_BINDING_EXTERNAL_OES 0x8D67
+#endif
+
+// An android.graphics.SurfaceTexture (camera preview...) feeding an EXGL texture.
+// It's attached to the GL context on the first update, its frames are then
+// latched with `updateTexImage()` and sampled as GL_TEXTURE_EXTERNAL_OES.
+struct EXGLSurfaceTextureSource {
+  JavaVM *vm = nullptr;
+  jobject surfaceTexture = nullptr;
+  jmethodID attachToGLContext = nullptr;
+  jmethodID detachFromGLContext = nullptr;
+  jmethodID updateTexImage = nullptr;
+  GLuint texture = 0; // [GL thread]
+
+  EXGLSurfaceTextureSource(JNIEnv *env, jobject object) {
+    env->GetJavaVM(&vm);
+    surfaceTexture = env->NewGlobalRef(object);
+    jclass clazz = env->GetObjectClass(object);
+    attachToGLContext = env->GetMethodID(clazz, "attachToGLContext", "(I)V");
+    detachFromGLContext = env->GetMethodID(clazz, "detachFromGLContext", "()V");
+    updateTexImage = env->GetMethodID(clazz, "updateTexImage", "()V");
+    env->DeleteLocalRef(clazz);
+  }
+
+  // [GL thread] Runs when the source is replaced or the texture deleted
+  ~EXGLSurfaceTextureSource() {
+    JNIEnv *env = getEnv();
+    if (texture != 0) {
+      // Also deletes the GL texture
+      env->CallVoidMethod(surfaceTexture, detachFromGLContext);
+      checkException(env, "detachFromGLContext");
+    }
+    env->DeleteGlobalRef(surfaceTexture);
+  }
+
+  // [GL thread]
+  GLuint latchFrame() {
+    JNIEnv *env = getEnv();
+    GLint boundTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_EXTERNAL_OES, &boundTexture);
+    if (texture == 0) {
+      glGenTextures(1, &texture);
+      env->CallVoidMethod(surfaceTexture, attachToGLContext, (jint) texture);
+      if (checkException(env, "attachToGLContext")) {
+        // Most likely still attached to the GL context of its producer
+        glDeleteTextures(1, &texture);
+        texture = 0;
+        return 0;
+      }
+    }
+    // Binds the texture to GL_TEXTURE_EXTERNAL_OES
+    env->CallVoidMethod(surfaceTexture, updateTexImage);
+    checkException(env, "updateTexImage");
+    glBindTexture(GL_TEXTURE_EXTERNAL_OES, boundTexture);
+    return texture;
+  }
+
+  JNIEnv *getEnv() {
+    JNIEnv *env = nullptr;
+    if (vm->GetEnv((void **) &env, JNI_VERSION_1_6) == JNI_EDETACHED) {
+      // Render pool threads aren't Java threads, they stay attached until exit
+      vm->AttachCurrentThread(&env, nullptr);
+    }
+    return env;
+  }
+
+  static bool checkException(JNIEnv *env, const char *method) {
+    if (!env->ExceptionCheck()) {
+      return false;
+    }
+    env->ExceptionClear();
+    __android_log_print(ANDROID_LOG_ERROR, "EXGL", "SurfaceTexture.%s() failed!", method);
+    return true;
+  }
+};
+
+// The input surface of a MediaCodec encoder (or any android.view.Surface) a
+// recording is sent to. An EGL window surface is created for it on the first
+// frame with the config of the GL context, which is then made current on it for
+// the time it takes to blit the frame and swap it with its timestamp.
+struct EXGLEncoderSurfaceSink {
+  ANativeWindow *window = nullptr;
+  EGLDisplay display = EGL_NO_DISPLAY;
+  EGLSurface surface = EGL_NO_SURFACE;
+  PFNEGLPRESENTATIONTIMEANDROIDPROC presentationTime = nullptr;
+
+  EXGLEncoderSurfaceSink(JNIEnv *env, jobject object)
+    : window(ANativeWindow_fromSurface(env, object)) {
+    presentationTime = reinterpret_cast<PFNEGLPRESENTATIONTIMEANDROIDPROC>(
+      eglGetProcAddress("eglPresentationTimeANDROID"));
+  }
+
+  ~EXGLEncoderSurfaceSink() {
+    destroySurface();
+    if (window) {
+      ANativeWindow_release(window);
+    }
+  }
+
+  void destroySurface() {
+    if (surface != EGL_NO_SURFACE) {
+      eglDestroySurface(display, surface);
+      surface = EGL_NO_SURFACE;
+    }
+  }
+
+  // [GL thread]
+  bool createSurface(EGLContext context) {
+    display = eglGetCurrentDisplay();
+    EGLint configId = 0;
+    eglQueryContext(display, context, EGL_CONFIG_ID, &configId);
+    const EGLint attribs[] = { EGL_CONFIG_ID, configId, EGL_NONE };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, attribs, &config, 1, &configCount) || configCount == 0) {
+      return false;
+    }
+    surface = eglCreateWindowSurface(display, config, window, nullptr);
+    return surface != EGL_NO_SURFACE;
+  }
+
+  // [GL thread]
+  void recordFrame(GLint framebuffer, GLsizei width, GLsizei height, int64_t timeNanos) {
+    if (framebuffer < 0) {
+      // The encoder gets its end of stream from Java
+      destroySurface();
+      return;
+    }
+    EGLContext context = eglGetCurrentContext();
+    if (!window || context == EGL_NO_CONTEXT) {
+      return;
+    }
+    if (surface == EGL_NO_SURFACE && !createSurface(context)) {
+      __android_log_print(ANDROID_LOG_ERROR, "EXGL", "Couldn't create a surface for the encoder (0x%x)!",
+                          eglGetError());
+      return;
+    }
+
+    EGLSurface drawSurface = eglGetCurrentSurface(EGL_DRAW);
+    EGLSurface readSurface = eglGetCurrentSurface(EGL_READ);
+    GLint drawFramebuffer, readFramebuffer;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+    GLboolean scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+
+    // Framebuffer 0 draws to the encoder and still reads from the view
+    if (!eglMakeCurrent(display, surface, readSurface, context)) {
+      __android_log_print(ANDROID_LOG_ERROR, "EXGL", "Couldn't make the encoder surface current (0x%x)!",
+                          eglGetError());
+      return;
+    }
+    EGLint surfaceWidth = width, surfaceHeight = height;
+    eglQuerySurface(display, surface, EGL_WIDTH, &surfaceWidth);
+    eglQuerySurface(display, surface, EGL_HEIGHT, &surfaceHeight);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glDisable(GL_SCISSOR_TEST);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, surfaceWidth, surfaceHeight,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    if (presentationTime) {
+      presentationTime(display, surface, timeNanos);
+    }
+    eglSwapBuffers(display, surface);
+
+    eglMakeCurrent(display, drawSurface, readSurface, context);
+    if (scissorTest) {
+      glEnable(GL_SCISSOR_TEST);
+    }
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+  }
+};
+
+// Rasterizes `gl.texImage2DTextEXP()` text with android.graphics: a StaticLayout
+// of the text is drawn to an ARGB_8888 Bitmap, whose pixels already are
+// premultiplied RGBA in memory. Classes and methods are looked up once, in
+// JNI_OnLoad, as the JS thread may not find them with its class loader.
+struct EXGLAndroidTextRasterizer {
+  JavaVM *vm = nullptr;
+  jclass textPaintClass = nullptr;
+  jclass typefaceClass = nullptr;
+  jclass layoutClass = nullptr;
+  jclass staticLayoutClass = nullptr;
+  jclass bitmapClass = nullptr;
+  jclass canvasClass = nullptr;
+  jobject alignments[3] = {}; // Layout.Alignment NORMAL, CENTER, OPPOSITE
+  jobject argb8888 = nullptr;
+  jmethodID textPaintInit, setTextSize, setColor, setTypeface, typefaceCreate, getDesiredWidth;
+  jmethodID staticLayoutInit, getHeight, getLineCount, getLineRight, getLineBaseline, draw;
+  jmethodID createBitmap, recycle, canvasInit;
+
+  bool init(JNIEnv *env) {
+    env->GetJavaVM(&vm);
+    textPaintClass = globalClass(env, "android/text/TextPaint");
+    typefaceClass = globalClass(env, "android/graphics/Typeface");
+    layoutClass = globalClass(env, "android/text/Layout");
+    staticLayoutClass = globalClass(env, "android/text/StaticLayout");
+    bitmapClass = globalClass(env, "android/graphics/Bitmap");
+    canvasClass = globalClass(env, "android/graphics/Canvas");
+    jclass alignmentClass = env->FindClass("android/text/Layout$Alignment");
+    jclass configClass = env->FindClass("android/graphics/Bitmap$Config");
+    if (env->ExceptionCheck() || !textPaintClass || !typefaceClass || !layoutClass ||
+        !staticLayoutClass || !bitmapClass || !canvasClass) {
+      env->ExceptionClear();
+      return false;
+    }
+    const char *alignmentNames[] = { "ALIGN_NORMAL", "ALIGN_CENTER", "ALIGN_OPPOSITE" };
+    for (int i = 0; i < 3; i++) {
+      jfieldID field = env->GetStaticFieldID(alignmentClass, alignmentNames[i], "Landroid/text/Layout$Alignment;");
+      alignments[i] = env->NewGlobalRef(env->GetStaticObjectField(alignmentClass, field));
+    }
+    jfieldID argb8888Field = env->GetStaticFieldID(configClass, "ARGB_8888", "Landroid/graphics/Bitmap$Config;");
+    argb8888 = env->NewGlobalRef(env->GetStaticObjectField(configClass, argb8888Field));
+    env->DeleteLocalRef(alignmentClass);
+    env->DeleteLocalRef(configClass);
+
+    textPaintInit = env->GetMethodID(textPaintClass, "<init>", "(I)V");
+    setTextSize = env->GetMethodID(textPaintClass, "setTextSize", "(F)V");
+    setColor = env->GetMethodID(textPaintClass, "setColor", "(I)V");
+    setTypeface = env->GetMethodID(textPaintClass, "setTypeface",
+                                   "(Landroid/graphics/Typeface;)Landroid/graphics/Typeface;");
+    typefaceCreate = env->GetStaticMethodID(typefaceClass, "create",
+                                            "(Ljava/lang/String;I)Landroid/graphics/Typeface;");
+    getDesiredWidth = env->GetStaticMethodID(layoutClass, "getDesiredWidth",
+                                             "(Ljava/lang/CharSequence;Landroid/text/TextPaint;)F");
+    // Deprecated by StaticLayout.Builder (API 23) but available everywhere
+    staticLayoutInit = env->GetMethodID(staticLayoutClass, "<init>",
+                                        "(Ljava/lang/CharSequence;Landroid/text/TextPaint;I"
+                                        "Landroid/text/Layout$Alignment;FFZ)V");
+    getHeight = env->GetMethodID(layoutClass, "getHeight", "()I");
+    getLineCount = env->GetMethodID(layoutClass, "getLineCount", "()I");
+    getLineRight = env->GetMethodID(layoutClass, "getLineRight", "(I)F");
+    getLineBaseline = env->GetMethodID(layoutClass, "getLineBaseline", "(I)I");
+    draw = env->GetMethodID(layoutClass, "draw", "(Landroid/graphics/Canvas;)V");
+    createBitmap = env->GetStaticMethodID(bitmapClass, "createBitmap",
+                                          "(IILandroid/graphics/Bitmap$Config;)Landroid/graphics/Bitmap;");
+    recycle = env->GetMethodID(bitmapClass, "recycle", "()V");
+    canvasInit = env->GetMethodID(canvasClass, "<init>", "(Landroid/graphics/Bitmap;)V");
+    if (env->ExceptionCheck()) {
+      env->ExceptionClear();
+      return false;
+    }
+    return true;
+  }
+
+  static jclass globalClass(JNIEnv *env, const char *name) {
+    jclass clazz = env->FindClass(name);
+    if (!clazz) {
+      return nullptr;
+    }
+    jclass global = (jclass) env->NewGlobalRef(clazz);
+    env->DeleteLocalRef(clazz);
+    return global;
+  }
+
+  // NewStringUTF takes modified UTF-8, which encodes characters outside the
+  // BMP (emoji...) differently, so the UTF-16 is made here
+  static jstring newString(JNIEnv *env, const std::string &text) {
+    std::u16string utf16;
+    utf16.reserve(text.size());
+    for (size_t i = 0; i < text.size();) {
+      unsigned char c = text[i];
+      size_t length = c < 0x80 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+      uint32_t codePoint = length == 1 ? c : c & (0x3f >> (length - 1));
+      for (size_t j = 1; j < length && i + j < text.size(); j++) {
+        codePoint = (codePoint << 6) | (text[i + j] & 0x3f);
+      }
+      i += length;
+      if (codePoint >= 0x10000) {
+        codePoint -= 0x10000;
+        utf16.push_back((char16_t) (0xd800 + (codePoint >> 10)));
+        utf16.push_back((char16_t) (0xdc00 + (codePoint & 0x3ff)));
+      } else {
+        utf16.push_back((char16_t) codePoint);
+      }
+    }
+    return env->NewString((const jchar *) utf16.data(), (jsize) utf16.size());
+  }
+
+  // [JS thread]
+  void *rasterize(const std::string &text, const UEXGLTextStyle &style,
+                  GLsizei *width, GLsizei *height, float *baseline) {
+    JNIEnv *env = nullptr;
+    if (vm->GetEnv((void **) &env, JNI_VERSION_1_6) == JNI_EDETACHED) {
+      vm->AttachCurrentThread(&env, nullptr);
+    }
+    // The JS thread may not return to Java between many calls
+    if (env->PushLocalFrame(16) != JNI_OK) {
+      env->ExceptionClear();
+      return nullptr;
+    }
+    void *pixels = rasterizeInFrame(env, text, style, width, height, baseline);
+    if (env->ExceptionCheck()) {
+      env->ExceptionClear();
+      __android_log_print(ANDROID_LOG_ERROR, "EXGL", "Couldn't rasterize text!");
+      free(pixels);
+      pixels = nullptr;
+    }
+    env->PopLocalFrame(nullptr);
+    return pixels;
+  }
+
+  void *rasterizeInFrame(JNIEnv *env, const std::string &text, const UEXGLTextStyle &style,
+                         GLsizei *width, GLsizei *height, float *baseline) {
+    jstring string = newString(env, text);
+    jobject paint = env->NewObject(textPaintClass, textPaintInit, (jint) 1 /* ANTI_ALIAS_FLAG */);
+    if (env->ExceptionCheck()) {
+      return nullptr;
+    }
+    env->CallVoidMethod(paint, setTextSize, (jfloat) style.fontSize);
+    // 0xRRGGBBAA to 0xAARRGGBB
+    env->CallVoidMethod(paint, setColor, (jint) ((style.color >> 8) | (style.color << 24)));
+    jstring family = style.fontFamily.empty() ? nullptr : env->NewStringUTF(style.fontFamily.c_str());
+    jint typefaceStyle = (style.bold ? 1 /* BOLD */ : 0) | (style.italic ? 2 /* ITALIC */ : 0);
+    jobject typeface = env->CallStaticObjectMethod(typefaceClass, typefaceCreate, family, typefaceStyle);
+    env->CallObjectMethod(paint, setTypeface, typeface);
+
+    jint layoutWidth = (jint) ceil(style.maxWidth > 0 ? style.maxWidth
+                                   : env->CallStaticFloatMethod(layoutClass, getDesiredWidth, string, paint));
+    jobject alignment = alignments[style.align >= 0 && style.align < 3 ? style.align : 0];
+    jobject layout = env->NewObject(staticLayoutClass, staticLayoutInit, string, paint,
+                                    std::max(layoutWidth, 1), alignment, 1.0f, 0.0f, (jboolean) false);
+    if (env->ExceptionCheck()) {
+      return nullptr;
+    }
+    // Like CoreText, left-aligned wrapped text is as wide as its longest line
+    if (style.maxWidth > 0 && style.align == 0) {
+      float right = 0;
+      jint lineCount = env->CallIntMethod(layout, getLineCount);
+      for (jint i = 0; i < lineCount; i++) {
+        right = std::max(right, env->CallFloatMethod(layout, getLineRight, i));
+      }
+      layoutWidth = std::min(layoutWidth, (jint) ceil(right));
+    }
+    jint layoutHeight = env->CallIntMethod(layout, getHeight);
+    if (layoutWidth <= 0 || layoutHeight <= 0) {
+      return nullptr;
+    }
+
+    jobject bitmap = env->CallStaticObjectMethod(bitmapClass, createBitmap, layoutWidth, layoutHeight,
+                                                 argb8888);
+    if (env->ExceptionCheck()) {
+      return nullptr;
+    }
+    jobject canvas = env->NewObject(canvasClass, canvasInit, bitmap);
+    env->CallVoidMethod(layout, draw, canvas);
+
+    void *pixels = nullptr;
+    AndroidBitmapInfo info;
+    void *bitmapPixels = nullptr;
+    if (!env->ExceptionCheck() &&
+        AndroidBitmap_getInfo(env, bitmap, &info) == ANDROID_BITMAP_RESULT_SUCCESS &&
+        AndroidBitmap_lockPixels(env, bitmap, &bitmapPixels) == ANDROID_BITMAP_RESULT_SUCCESS) {
+      size_t bytesPerRow = (size_t) info.width * 4;
+      pixels = malloc(bytesPerRow * info.height);
+      if (pixels) {
+        for (uint32_t row = 0; row < info.height; row++) {
+          memcpy((uint8_t *) pixels + row * bytesPerRow,
+                 (const uint8_t *) bitmapPixels + row * info.stride, bytesPerRow);
+        }
+        *width = info.width;
+        *height = info.height;
+        *baseline = env->CallIntMethod(layout, getLineBaseline, (jint) 0);
+      }
+      AndroidBitmap_unlockPixels(env, bitmap);
+    }
+    env->CallVoidMethod(bitmap, recycle);
+    return pixels;
+  }
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+JNIEXPORT jint JNICALL
+JNI_OnLoad(JavaVM *vm, void *reserved) {
+  JNIEnv *env = nullptr;
+  if (vm->GetEnv((void **) &env, JNI_VERSION_1_6) != JNI_OK) {
+    return JNI_VERSION_1_6;
+  }
+  // Never destroyed, the library isn't unloaded
+  auto textRasterizer = new EXGLAndroidTextRasterizer();
+  if (textRasterizer->init(env)) {
+    UEXGLSetTextRasterizer([textRasterizer](const std::string &text, const UEXGLTextStyle &style,
+                                            GLsizei *width, GLsizei *height, float *baseline) {
+      return textRasterizer->rasterize(text, style, width, height, baseline);
+    });
+  } else {
+    __android_log_print(ANDROID_LOG_WARN, "EXGL", "No text rasterizer, android.graphics isn't available!");
+    delete textRasterizer;
+  }
+  return JNI_VERSION_1_6;
+}
+
 JNIEXPORT jint JNICALL
 Java_expo_modules_gl_cpp_EXGL_EXGLContextCreate
 (JNIEnv *env, jclass clazz, jlong jsCtxPtr) {
@@ -36,12 +441,52 @@ Java_expo_modules_gl_cpp_EXGL_EXGLContextCreateV2
   return 0;
 }
 
+JNIEXPORT jint JNICALL
+Java_expo_modules_gl_cpp_EXGL_EXGLContextCreateHeadless
+(JNIEnv *env, jclass clazz, jlong jsCtxPtr, jint width, jint height) {
+  JSGlobalContextRef jsCtx = (JSGlobalContextRef) (intptr_t) jsCtxPtr;
+  if (jsCtx) {
+    return UEXGLContextCreateHeadless(jsCtx, width, height);
+  }
+  return 0;
+}
+
+JNIEXPORT void JNICALL
+Java_expo_modules_gl_cpp_EXGL_EXGLContextDestroyHeadless
+(JNIEnv *env, jclass clazz, jint exglCtxId) {
+  UEXGLContextDestroyHeadless(exglCtxId);
+}
+
+JNIEXPORT void JNICALL
+Java_expo_modules_gl_cpp_EXGL_EXGLRenderPoolSetThreadCount
+(JNIEnv *env, jclass clazz, jint threadCount) {
+  UEXGLRenderPoolSetThreadCount(threadCount);
+}
+
+JNIEXPORT void JNICALL
+Java_expo_modules_gl_cpp_EXGL_EXGLSetProgramCacheDirectory
+(JNIEnv *env, jclass clazz, jstring path) {
+  if (!path) {
+    UEXGLSetProgramCacheDirectory(nullptr);
+    return;
+  }
+  const char *chars = env->GetStringUTFChars(path, nullptr);
+  UEXGLSetProgramCacheDirectory(chars);
+  env->ReleaseStringUTFChars(path, chars);
+}
+
 JNIEXPORT void JNICALL
 Java_expo_modules_gl_cpp_EXGL_EXGLContextDestroy
 (JNIEnv *env, jclass clazz, jint exglCtxId) {
   UEXGLContextDestroy(exglCtxId);
 }
 
+JNIEXPORT void JNICALL
+Java_expo_modules_gl_cpp_EXGL_EXGLContextSetContextLost
+(JNIEnv *env, jclass clazz, jint exglCtxId, jboolean contextLost) {
+  UEXGLContextSetContextLost(exglCtxId, contextLost);
+}
+
 JNIEXPORT void JNICALL
 Java_expo_modules_gl_cpp_EXGL_EXGLContextFlush
 (JNIEnv *env, jclass clazz, jint exglCtxId) {
@@ -85,12 +530,111 @@ Java_expo_modules_gl_cpp_EXGL_EXGLContextSetFlushMethod
   UEXGLContextSetFlushMethod(exglCtxId, flushMethod);
 }
 
+// Render the context into a Surface (eg. `new Surface(textureView.getSurfaceTexture())`)
+// on a GL thread owned by EXGL, with no flush method needed, see
+// UEXGLContextAttachNativeWindow. Returns false if it couldn't.
+JNIEXPORT jboolean JNICALL
+Java_expo_modules_gl_cpp_EXGL_EXGLContextAttachSurface
+(JNIEnv *env, jclass clazz, jint exglCtxId, jobject surface) {
+  ANativeWindow *window = surface ? ANativeWindow_fromSurface(env, surface) : nullptr;
+  if (!window) {
+    return false;
+  }
+  // The renderer holds its own reference
+  bool attached = UEXGLContextAttachNativeWindow(exglCtxId, window);
+  ANativeWindow_release(window);
+  return attached;
+}
+
+// Before the Surface is released (`onSurfaceTextureDestroyed`...) or the context
+// destroyed
+JNIEXPORT void JNICALL
+Java_expo_modules_gl_cpp_EXGL_EXGLContextDetachSurface
+(JNIEnv *env, jclass clazz, jint exglCtxId) {
+  UEXGLContextDetachNativeWindow(exglCtxId);
+}
+
+// Feed an EXGL texture from a SurfaceTexture created detached from any GL
+// context (or detached by its producer), null to stop
+JNIEXPORT void JNICALL
+Java_expo_modules_gl_cpp_EXGL_EXGLContextSetSurfaceTexture
+(JNIEnv *env, jclass clazz, jint exglCtxId, jint exglObjId, jobject surfaceTexture) {
+  if (!surfaceTexture) {
+    UEXGLContextSetExternalTextureSource(exglCtxId, exglObjId, nullptr);
+    return;
+  }
+  auto source = std::make_shared<EXGLSurfaceTextureSource>(env, surfaceTexture);
+  UEXGLContextSetExternalTextureSource(exglCtxId, exglObjId, [source] {
+    return source->latchFrame();
+  });
+}
+
+// Record the frames started with `gl.startRecordingEXP()` to a MediaCodec input
+// surface (`MediaCodec.createInputSurface()`), null to stop
+JNIEXPORT void JNICALL
+Java_expo_modules_gl_cpp_EXGL_EXGLContextSetEncoderSurface
+(JNIEnv *env, jclass clazz, jint exglCtxId, jobject surface) {
+  if (!surface) {
+    UEXGLContextSetFrameSink(exglCtxId, nullptr);
+    return;
+  }
+  auto sink = std::make_shared<EXGLEncoderSurfaceSink>(env, surface);
+  UEXGLContextSetFrameSink(exglCtxId, [sink](GLint framebuffer, GLsizei width, GLsizei height,
+                                             int64_t timeNanos) {
+    sink->recordFrame(framebuffer, width, height, timeNanos);
+  });
+}
+
+// Snapshot a framebuffer without blocking the GL thread: `callback` has its
+// `onSnapshot(ByteBuffer pixels, int width, int height)` called on a background
+// thread with a direct buffer of RGBA8 rows, top-down (null if it failed), eg. for
+// `Bitmap.copyPixelsFromBuffer()` and `Bitmap.compress()`. The buffer is only
+// valid during the call.
+JNIEXPORT void JNICALL
+Java_expo_modules_gl_cpp_EXGL_EXGLContextTakeSnapshot
+(JNIEnv *env, jclass clazz, jint exglCtxId, jint exglFramebuffer,
+ jint x, jint y, jint width, jint height, jobject callback) {
+  JavaVM *vm = nullptr;
+  env->GetJavaVM(&vm);
+  jobject callbackRef = env->NewGlobalRef(callback);
+  jclass callbackClass = env->GetObjectClass(callback);
+  jmethodID onSnapshot = env->GetMethodID(callbackClass, "onSnapshot", "(Ljava/nio/ByteBuffer;II)V");
+  env->DeleteLocalRef(callbackClass);
+
+  UEXGLContextTakeSnapshot(exglCtxId, exglFramebuffer, x, y, width, height,
+                           [vm, callbackRef, onSnapshot](const void *pixels, GLsizei width, GLsizei height) {
+    JNIEnv *env = nullptr;
+    if (vm->GetEnv((void **) &env, JNI_VERSION_1_6) == JNI_EDETACHED) {
+      // The snapshot thread isn't a Java thread, it stays attached until exit
+      vm->AttachCurrentThread(&env, nullptr);
+    }
+    jobject buffer = pixels ?
+      env->NewDirectByteBuffer(const_cast<void *>(pixels), (jlong) width * height * 4) : nullptr;
+    env->CallVoidMethod(callbackRef, onSnapshot, buffer, (jint) width, (jint) height);
+    if (env->ExceptionCheck()) {
+      env->ExceptionClear();
+      __android_log_print(ANDROID_LOG_ERROR, "EXGL", "Snapshot callback failed!");
+    }
+    if (buffer) {
+      env->DeleteLocalRef(buffer);
+    }
+    env->DeleteGlobalRef(callbackRef);
+  });
+}
+
 JNIEXPORT bool JNICALL
 Java_expo_modules_gl_cpp_EXGL_EXGLContextNeedsRedraw
 (JNIEnv *env, jclass clazz, jint exglCtxId) {
   return UEXGLContextNeedsRedraw(exglCtxId);
 }
 
+// From a Choreographer.FrameCallback, true if the context should be flushed
+JNIEXPORT jboolean JNICALL
+Java_expo_modules_gl_cpp_EXGL_EXGLContextVsync
+(JNIEnv *env, jclass clazz, jint exglCtxId, jlong frameTimeNanos, jlong intervalNanos) {
+  return UEXGLContextVsync(exglCtxId, frameTimeNanos, intervalNanos);
+}
+
 JNIEXPORT void JNICALL
 Java_expo_modules_gl_cpp_EXGL_EXGLContextDrawEnded
 (JNIEnv *env, jclass clazz, jint exglCtxId) {
@@ -0,0 +1,111 @@
+#include "EXGLAImageDecoder.h"
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdlib>
+
+#include "EXGLPixelKernels.h"
+
+// From <android/imagedecoder.h> and <android/bitmap.h>, which older NDKs don't
+// ship
+struct AImageDecoder;
+struct AImageDecoderHeaderInfo;
+static const int ANDROID_IMAGE_DECODER_SUCCESS = 0;
+static const int32_t ANDROID_BITMAP_FORMAT_RGBA_8888 = 1;
+
+namespace {
+
+struct AImageDecoderAPI {
+  int (*createFromFd)(int, AImageDecoder **);
+  void (*destroy)(AImageDecoder *);
+  const AImageDecoderHeaderInfo *(*getHeaderInfo)(const AImageDecoder *);
+  int32_t (*getWidth)(const AImageDecoderHeaderInfo *);
+  int32_t (*getHeight)(const AImageDecoderHeaderInfo *);
+  int (*setAndroidBitmapFormat)(AImageDecoder *, int32_t);
+  int (*setUnpremultipliedRequired)(AImageDecoder *, bool);
+  size_t (*getMinimumStride)(AImageDecoder *);
+  int (*decodeImage)(AImageDecoder *, void *, size_t, size_t);
+};
+
+class EXGLAImageDecoder : public EXGLImageDecoder {
+public:
+  explicit EXGLAImageDecoder(const AImageDecoderAPI &api) : api(api) {}
+
+  EXGLImage decode(const std::string &path, bool flipY, bool premultiplyAlpha) override {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return EXGLImage();
+    }
+    AImageDecoder *decoder = nullptr;
+    int result = api.createFromFd(fd, &decoder);
+    // The decoder keeps its own reference to the file
+    close(fd);
+    if (result != ANDROID_IMAGE_DECODER_SUCCESS) {
+      return EXGLImage();
+    }
+
+    EXGLImage image;
+    const AImageDecoderHeaderInfo *info = api.getHeaderInfo(decoder);
+    int width = api.getWidth(info);
+    int height = api.getHeight(info);
+    size_t stride = (size_t) width * 4;
+    if (api.setAndroidBitmapFormat(decoder, ANDROID_BITMAP_FORMAT_RGBA_8888) ==
+            ANDROID_IMAGE_DECODER_SUCCESS &&
+        api.setUnpremultipliedRequired(decoder, !premultiplyAlpha) ==
+            ANDROID_IMAGE_DECODER_SUCCESS &&
+        api.getMinimumStride(decoder) <= stride) {
+      size_t byteLength = stride * height;
+      std::shared_ptr<void> data(malloc(byteLength), free);
+      if (data &&
+          api.decodeImage(decoder, data.get(), stride, byteLength) ==
+              ANDROID_IMAGE_DECODER_SUCCESS) {
+        image.data = data;
+        image.width = width;
+        image.height = height;
+      }
+    }
+    api.destroy(decoder);
+
+    if (image.data && flipY) {
+      EXGLFlipRows(image.data.get(), stride, image.height);
+    }
+    return image;
+  }
+
+private:
+  const AImageDecoderAPI api;
+};
+
+} // namespace
+
+std::shared_ptr<EXGLImageDecoder> EXGLAImageDecoderCreate() {
+  void *library = dlopen("libjnigraphics.so", RTLD_NOW);
+  if (!library) {
+    return nullptr;
+  }
+  AImageDecoderAPI api;
+  api.createFromFd = (decltype(api.createFromFd)) dlsym(library, "AImageDecoder_createFromFd");
+  api.destroy = (decltype(api.destroy)) dlsym(library, "AImageDecoder_delete");
+  api.getHeaderInfo = (decltype(api.getHeaderInfo)) dlsym(library, "AImageDecoder_getHeaderInfo");
+  api.getWidth = (decltype(api.getWidth)) dlsym(library, "AImageDecoderHeaderInfo_getWidth");
+  api.getHeight = (decltype(api.getHeight)) dlsym(library, "AImageDecoderHeaderInfo_getHeight");
+  api.setAndroidBitmapFormat = (decltype(api.setAndroidBitmapFormat))
+      dlsym(library, "AImageDecoder_setAndroidBitmapFormat");
+  api.setUnpremultipliedRequired = (decltype(api.setUnpremultipliedRequired))
+      dlsym(library, "AImageDecoder_setUnpremultipliedRequired");
+  api.getMinimumStride = (decltype(api.getMinimumStride))
+      dlsym(library, "AImageDecoder_getMinimumStride");
+  api.decodeImage = (decltype(api.decodeImage)) dlsym(library, "AImageDecoder_decodeImage");
+
+  // All or nothing, a partial API is treated as missing
+  if (!api.createFromFd || !api.destroy || !api.getHeaderInfo || !api.getWidth ||
+      !api.getHeight || !api.setAndroidBitmapFormat || !api.setUnpremultipliedRequired ||
+      !api.getMinimumStride || !api.decodeImage) {
+    dlclose(library);
+    return nullptr;
+  }
+  // The library stays loaded for the decoder, which lives as long as the process
+  return std::make_shared<EXGLAImageDecoder>(api);
+}
@@ -0,0 +1,19 @@
+#ifndef __EXGLAIMAGEDECODER_H__
+#define __EXGLAIMAGEDECODER_H__
+
+#include <memory>
+
+#include "EXGLImageLoader.h"
+
+
+// --- EXGLAImageDecoder -------------------------------------------------------
+
+// Decodes images with the platform's codecs through `AImageDecoder` (Android
+// 11+), the ones backing `BitmapFactory` (libjpeg-turbo, libpng with NEON),
+// straight into our buffer. The NDK API is looked up in libjnigraphics.so at
+// runtime so that older devices keep using stb_image.
+
+// [Any thread] Null if `AImageDecoder` isn't available
+std::shared_ptr<EXGLImageDecoder> EXGLAImageDecoderCreate();
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef __EXGLBATCHRING_H__
+#define __EXGLBATCHRING_H__
+
+#include <atomic>
+#include <cstddef>
+
+
+// --- EXGLBatchRing -----------------------------------------------------------
+
+// Bounded lock-free single-producer/single-consumer ring used to hand batches
+// from the JS thread (producer) to the GL thread (consumer). The slots are
+// never destroyed while the ring is alive: the consumer clears a slot after
+// running it and the producer swaps its next batch into it, so the arenas of
+// previous batches get reused instead of reallocated.
+//
+// Protocol:
+//   producer: `if (auto slot = acquire()) { fill(*slot); publish(); }`
+//   consumer: `while (auto slot = front()) { run(*slot); pop(); }`
+
+template<typename T, size_t Capacity>
+class EXGLBatchRing {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "EXGL: ring capacity must be a power of two");
+
+public:
+  static constexpr size_t capacity = Capacity;
+
+  // [Producer] Free slot to fill, nullptr if the consumer is `Capacity` batches
+  // behind
+  inline T *acquire() noexcept {
+    size_t tailIndex = tail.load(std::memory_order_relaxed);
+    if (tailIndex - head.load(std::memory_order_acquire) == Capacity) {
+      return nullptr;
+    }
+    return &slots[tailIndex & (Capacity - 1)];
+  }
+
+  // [Producer] Hand the slot returned by `acquire()` to the consumer
+  inline void publish() noexcept {
+    tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // [Consumer] Oldest published slot, nullptr if there's none
+  inline T *front() noexcept {
+    size_t headIndex = head.load(std::memory_order_relaxed);
+    if (headIndex == tail.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &slots[headIndex & (Capacity - 1)];
+  }
+
+  // [Consumer] Give the slot returned by `front()` back to the producer
+  inline void pop() noexcept {
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // [Any thread] Approximate number of published slots
+  inline size_t size() const noexcept {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+  }
+
+private:
+  T slots[Capacity];
+
+  // Padded apart so the two threads don't false-share a cache line (padding
+  // rather than `alignas` since contexts are heap-allocated and C++14 `new`
+  // doesn't honor over-alignment)
+  std::atomic<size_t> head { 0 }; // next slot to consume
+  char headPadding[64 - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> tail { 0 }; // next slot to produce
+};
+
+#endif
@@ -0,0 +1,435 @@
+#ifndef __EXGLCOMMANDBUFFER_H__
+#define __EXGLCOMMANDBUFFER_H__
+
+#ifdef __ANDROID__
+#include <GLES3/gl3.h>
+#endif
+#ifdef __APPLE__
+#include <OpenGLES/ES3/gl.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "UEXGL.h"
+
+
+// --- EXGLCommandBuffer -------------------------------------------------------
+
+// A batch of GL work encoded as a flat stream of commands. Each command is an
+// EXGLCommandHeader immediately followed by its POD arguments, everything padded
+// to 8 bytes. The stream lives in a single growable arena, so encoding a command
+// on the JS thread does not allocate (apart from the occasional arena growth)
+// and decoding it on the GL thread is a plain switch over the opcode.
+//
+// Ops that still need to capture non-POD state (strings, shared buffers,
+// blocking handshakes...) are kept as std::function closures in a side table and
+// referenced from the stream by an `Closure` command, so ordering is preserved.
+
+enum class EXGLOpcode : uint32_t {
+  // Run `closures[index]`
+  Closure,
+
+  // Call a GL function taking only scalar arguments, each stored as a double
+  // (same conversion rules as the JS numbers they come from)
+  Call,
+
+  // glBind*(target, lookupObject(id)) style calls
+  BindObject,
+
+  // glUseProgram(lookupObject(id)) style calls
+  UseObject,
+
+  // glUniform*v(location, count, data) with the data stored inline
+  UniformFloatv,
+  UniformIntv,
+  UniformUintv,
+
+  // glUniformMatrix*fv(location, count, transpose, data) with the data stored inline
+  UniformMatrixv,
+
+  // A run of glUniform* calls for the program in use: a table of
+  // EXGLUniformBlockEntry followed by the data they all read from
+  UniformBlock,
+};
+
+struct EXGLCommandHeader {
+  EXGLOpcode opcode;
+  // Total size of the command in 8-byte words, including this header
+  uint32_t words;
+};
+
+// Any function pointer can be round-tripped through this type
+using EXGLGenericFunc = void (*)(void);
+
+// Converts an encoded argument back to the type of the GL parameter. Pointer
+// parameters are byte offsets into the bound buffer (`vertexAttribPointer`,
+// `drawElements`...).
+template<typename T>
+struct EXGLArgCast {
+  static inline T from(double value) noexcept {
+    return static_cast<T>(value);
+  }
+};
+
+template<typename T>
+struct EXGLArgCast<T *> {
+  static inline T *from(double value) noexcept {
+    return reinterpret_cast<T *>((intptr_t) value);
+  }
+};
+
+// Decodes an argument list of doubles and forwards it to a GL function with the
+// right signature
+template<typename... Params>
+struct EXGLCallTrampoline {
+  template<size_t... I>
+  static inline void invoke(void (*glFunc)(Params...), const double *args, std::index_sequence<I...>) {
+    glFunc(EXGLArgCast<Params>::from(args[I])...);
+  }
+
+  static void execute(EXGLGenericFunc glFunc, const double *args) {
+    invoke(reinterpret_cast<void (*)(Params...)>(glFunc), args, std::index_sequence_for<Params...>{});
+  }
+};
+
+struct EXGLCallArgs {
+  void (*trampoline)(EXGLGenericFunc, const double *);
+  EXGLGenericFunc glFunc;
+  uint32_t argc;
+  // `argc` doubles follow
+};
+
+struct EXGLBindObjectArgs {
+  void (*glFunc)(GLenum, GLuint);
+  GLenum target;
+  UEXGLObjectId exglObjId;
+};
+
+struct EXGLUseObjectArgs {
+  void (*glFunc)(GLuint);
+  UEXGLObjectId exglObjId;
+};
+
+template<typename T>
+struct EXGLUniformvArgs {
+  void (*glFunc)(GLint, GLsizei, const T *);
+  GLint location;
+  GLsizei count;
+  uint32_t byteLength;
+  // `byteLength` bytes of data follow
+};
+
+struct EXGLUniformMatrixvArgs {
+  void (*glFunc)(GLint, GLsizei, GLboolean, const GLfloat *);
+  GLint location;
+  GLsizei count;
+  GLboolean transpose;
+  uint32_t byteLength;
+  // `byteLength` bytes of data follow
+};
+
+struct EXGLUniformBlockEntry {
+  GLint location;
+  GLenum type; // GL_FLOAT_VEC4, GL_FLOAT_MAT4, GL_SAMPLER_2D...
+  GLsizei count;
+  uint32_t offset; // in bytes from the start of the data
+};
+
+// Number of 4-byte components of a uniform of GL type `type`, 0 if it can't
+// be set with glUniform*
+static inline GLsizei EXGLUniformComponents(GLenum type) noexcept {
+  switch (type) {
+    case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL:
+    case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_2D_ARRAY: case GL_SAMPLER_2D_ARRAY_SHADOW:
+    case GL_SAMPLER_CUBE_SHADOW:
+    case GL_INT_SAMPLER_2D: case GL_INT_SAMPLER_3D: case GL_INT_SAMPLER_CUBE:
+    case GL_INT_SAMPLER_2D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE: case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+      return 1;
+    case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2:
+      return 2;
+    case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3:
+      return 3;
+    case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4:
+    case GL_FLOAT_MAT2:
+      return 4;
+    case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT3x2:
+      return 6;
+    case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT4x2:
+      return 8;
+    case GL_FLOAT_MAT3:
+      return 9;
+    case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x3:
+      return 12;
+    case GL_FLOAT_MAT4:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+// glUniform* call matching a uniform's GL type
+static inline void EXGLUploadUniform(GLenum type, GLint location, GLsizei count, const void *data) noexcept {
+  auto f = (const GLfloat *) data;
+  auto i = (const GLint *) data;
+  auto u = (const GLuint *) data;
+  switch (type) {
+    case GL_FLOAT: glUniform1fv(location, count, f); break;
+    case GL_FLOAT_VEC2: glUniform2fv(location, count, f); break;
+    case GL_FLOAT_VEC3: glUniform3fv(location, count, f); break;
+    case GL_FLOAT_VEC4: glUniform4fv(location, count, f); break;
+    case GL_INT_VEC2: case GL_BOOL_VEC2: glUniform2iv(location, count, i); break;
+    case GL_INT_VEC3: case GL_BOOL_VEC3: glUniform3iv(location, count, i); break;
+    case GL_INT_VEC4: case GL_BOOL_VEC4: glUniform4iv(location, count, i); break;
+    case GL_UNSIGNED_INT: glUniform1uiv(location, count, u); break;
+    case GL_UNSIGNED_INT_VEC2: glUniform2uiv(location, count, u); break;
+    case GL_UNSIGNED_INT_VEC3: glUniform3uiv(location, count, u); break;
+    case GL_UNSIGNED_INT_VEC4: glUniform4uiv(location, count, u); break;
+    case GL_FLOAT_MAT2: glUniformMatrix2fv(location, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT3: glUniformMatrix3fv(location, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT4: glUniformMatrix4fv(location, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT2x3: glUniformMatrix2x3fv(location, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT3x2: glUniformMatrix3x2fv(location, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT2x4: glUniformMatrix2x4fv(location, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT4x2: glUniformMatrix4x2fv(location, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT3x4: glUniformMatrix3x4fv(location, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT4x3: glUniformMatrix4x3fv(location, count, GL_FALSE, f); break;
+    default: glUniform1iv(location, count, i); break; // int, bool and samplers
+  }
+}
+
+struct EXGLUniformBlockArgs {
+  uint32_t entryCount;
+  uint32_t byteLength;
+  // `entryCount` entries then `byteLength` bytes of data follow
+};
+
+class EXGLCommandBuffer {
+public:
+  using Closure = std::function<void(void)>;
+
+  EXGLCommandBuffer() = default;
+  EXGLCommandBuffer(EXGLCommandBuffer &&) = default;
+  EXGLCommandBuffer &operator=(EXGLCommandBuffer &&) = default;
+
+  EXGLCommandBuffer(const EXGLCommandBuffer &) = delete;
+  EXGLCommandBuffer &operator=(const EXGLCommandBuffer &) = delete;
+
+  // Number of encoded commands
+  inline size_t size() const noexcept {
+    return count;
+  }
+
+  inline bool empty() const noexcept {
+    return count == 0;
+  }
+
+  // Size of the encoded stream in bytes
+  inline size_t byteSize() const noexcept {
+    return used * sizeof(uint64_t);
+  }
+
+  // Make sure at least `bytes` bytes can be encoded without growing
+  inline void reserve(size_t bytes) {
+    size_t words = (bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    if (words > capacity) {
+      grow(words);
+    }
+  }
+
+  inline void clear() noexcept {
+    used = 0;
+    count = 0;
+    closures.clear();
+  }
+
+  inline void swap(EXGLCommandBuffer &other) noexcept {
+    std::swap(arena, other.arena);
+    std::swap(capacity, other.capacity);
+    std::swap(used, other.used);
+    std::swap(count, other.count);
+    closures.swap(other.closures);
+  }
+
+  // Move the commands of `other` after these ones, leaving `other` empty
+  void append(EXGLCommandBuffer &other) {
+    if (empty()) {
+      swap(other);
+      return;
+    }
+    if (used + other.used > capacity) {
+      grow(used + other.used);
+    }
+    uint64_t *cursor = arena.get() + used;
+    uint64_t *end = cursor + other.used;
+    memcpy(cursor, other.arena.get(), other.used * sizeof(uint64_t));
+    // Closure commands hold the index of their closure, which moves too
+    uint64_t closureOffset = closures.size();
+    while (cursor < end) {
+      auto header = reinterpret_cast<EXGLCommandHeader *>(cursor);
+      if (header->opcode == EXGLOpcode::Closure) {
+        cursor[headerWords] += closureOffset;
+      }
+      cursor += header->words;
+    }
+    for (auto &closure : other.closures) {
+      closures.push_back(std::move(closure));
+    }
+    used += other.used;
+    count += other.count;
+    other.clear();
+  }
+
+  // Encode a closure
+  template<typename F>
+  inline void pushClosure(F &&f) {
+    auto index = (uint64_t) closures.size();
+    closures.emplace_back(std::forward<F>(f));
+    push(EXGLOpcode::Closure, &index, sizeof(index));
+  }
+
+  // Encode a call of `glFunc` (which must take only scalar arguments, pointer
+  // parameters are passed as offsets)
+  template<typename... Params, typename... Args>
+  inline void pushCall(void (*glFunc)(Params...), Args... args) {
+    static_assert(sizeof...(Params) == sizeof...(Args), "EXGL: wrong number of arguments");
+    const double values[] = { 0, static_cast<double>(args)... };
+    EXGLCallArgs header {
+      &EXGLCallTrampoline<Params...>::execute,
+      reinterpret_cast<EXGLGenericFunc>(glFunc),
+      (uint32_t) sizeof...(Args),
+    };
+    push(EXGLOpcode::Call, &header, sizeof(header), values + 1, sizeof...(Args) * sizeof(double));
+  }
+
+  inline void pushBindObject(void (*glFunc)(GLenum, GLuint), GLenum target, UEXGLObjectId exglObjId) {
+    EXGLBindObjectArgs args { glFunc, target, exglObjId };
+    push(EXGLOpcode::BindObject, &args, sizeof(args));
+  }
+
+  inline void pushUseObject(void (*glFunc)(GLuint), UEXGLObjectId exglObjId) {
+    EXGLUseObjectArgs args { glFunc, exglObjId };
+    push(EXGLOpcode::UseObject, &args, sizeof(args));
+  }
+
+  template<typename T>
+  inline void pushUniformv(void (*glFunc)(GLint, GLsizei, const T *), GLint location,
+                           GLsizei count, const void *data, size_t byteLength) {
+    EXGLUniformvArgs<T> args { glFunc, location, count, (uint32_t) byteLength };
+    push(uniformOpcode<T>(), &args, sizeof(args), data, byteLength);
+  }
+
+  inline void pushUniformMatrixv(void (*glFunc)(GLint, GLsizei, GLboolean, const GLfloat *),
+                                 GLint location, GLsizei count, GLboolean transpose,
+                                 const void *data, size_t byteLength) {
+    EXGLUniformMatrixvArgs args { glFunc, location, count, transpose, (uint32_t) byteLength };
+    push(EXGLOpcode::UniformMatrixv, &args, sizeof(args), data, byteLength);
+  }
+
+  inline void pushUniformBlock(const EXGLUniformBlockEntry *entries, size_t entryCount,
+                               const void *data, size_t byteLength) {
+    EXGLUniformBlockArgs args { (uint32_t) entryCount, (uint32_t) byteLength };
+    push(EXGLOpcode::UniformBlock, &args, sizeof(args),
+         entries, entryCount * sizeof(EXGLUniformBlockEntry), data, byteLength);
+  }
+
+  // Visit every command in order. `visitor(header, payload)` gets the header
+  // and a pointer to the arguments that follow it.
+  template<typename F>
+  inline void forEach(F &&visitor) const {
+    const uint64_t *cursor = arena.get();
+    const uint64_t *end = cursor + used;
+    while (cursor < end) {
+      auto header = reinterpret_cast<const EXGLCommandHeader *>(cursor);
+      visitor(*header, reinterpret_cast<const void *>(cursor + headerWords));
+      cursor += header->words;
+    }
+  }
+
+  inline const Closure &closureAt(const void *payload) const {
+    return closures[closureIndex(payload)];
+  }
+
+  static inline size_t closureIndex(const void *payload) noexcept {
+    return (size_t) *reinterpret_cast<const uint64_t *>(payload);
+  }
+
+  // Index the next encoded closure will get
+  inline size_t closureCount() const noexcept {
+    return closures.size();
+  }
+
+  // Pointer to the trailing blob of a command whose fixed arguments are `Args`
+  template<typename Args>
+  static inline const void *trailingData(const void *payload) noexcept {
+    return reinterpret_cast<const uint64_t *>(payload) + wordsFor(sizeof(Args));
+  }
+
+private:
+  static constexpr size_t headerWords =
+    (sizeof(EXGLCommandHeader) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  static inline size_t wordsFor(size_t bytes) noexcept {
+    return (bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  }
+
+  template<typename T> static constexpr EXGLOpcode uniformOpcode();
+
+  void grow(size_t minWords) {
+    size_t newCapacity = capacity ? capacity : 256;
+    while (newCapacity < minWords) {
+      newCapacity *= 2;
+    }
+    std::unique_ptr<uint64_t[]> newArena(new uint64_t[newCapacity]);
+    if (used) {
+      memcpy(newArena.get(), arena.get(), used * sizeof(uint64_t));
+    }
+    arena.swap(newArena);
+    capacity = newCapacity;
+  }
+
+  // Append a command made of a header, a fixed-size arguments struct and up to
+  // two trailing blobs, stored back to back
+  inline void push(EXGLOpcode opcode, const void *args, size_t argsBytes,
+                   const void *blob = nullptr, size_t blobBytes = 0,
+                   const void *blob2 = nullptr, size_t blob2Bytes = 0) {
+    size_t argsWords = wordsFor(argsBytes);
+    size_t words = headerWords + argsWords + wordsFor(blobBytes + blob2Bytes);
+    if (used + words > capacity) {
+      grow(used + words);
+    }
+    uint64_t *cursor = arena.get() + used;
+    auto header = reinterpret_cast<EXGLCommandHeader *>(cursor);
+    header->opcode = opcode;
+    header->words = (uint32_t) words;
+    memcpy(cursor + headerWords, args, argsBytes);
+    if (blobBytes) {
+      memcpy(cursor + headerWords + argsWords, blob, blobBytes);
+    }
+    if (blob2Bytes) {
+      memcpy((uint8_t *) (cursor + headerWords + argsWords) + blobBytes, blob2, blob2Bytes);
+    }
+    used += words;
+    ++count;
+  }
+
+  std::unique_ptr<uint64_t[]> arena;
+  size_t capacity = 0; // in words
+  size_t used = 0;     // in words
+  size_t count = 0;
+  std::vector<Closure> closures;
+
+};
+
+template<> constexpr EXGLOpcode EXGLCommandBuffer::uniformOpcode<GLfloat>() { return EXGLOpcode::UniformFloatv; }
+template<> constexpr EXGLOpcode EXGLCommandBuffer::uniformOpcode<GLint>() { return EXGLOpcode::UniformIntv; }
+template<> constexpr EXGLOpcode EXGLCommandBuffer::uniformOpcode<GLuint>() { return EXGLOpcode::UniformUintv; }
+
+#endif
@@ -0,0 +1,347 @@
+#include "EXGLCompressedTexture.h"
+#include "EXGLMappedImage.h"
+#include "EXGLProgramCache.h"
+
+#include <cstring>
+#include <sstream>
+
+namespace {
+
+const uint8_t ktx1Identifier[12] = {
+  0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+const uint8_t ktx2Identifier[12] = {
+  0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+template<typename T>
+inline T readAt(const uint8_t *bytes, size_t offset) noexcept {
+  T value;
+  memcpy(&value, bytes + offset, sizeof(T));
+  return value;
+}
+
+// Set the formats of a KTX2 texture from its `vkFormat`, false if unsupported
+bool internalFormatFromVkFormat(uint32_t vkFormat, EXGLCompressedTexture &texture) {
+  // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK ... VK_FORMAT_EAC_R11G11_SNORM_BLOCK
+  static const GLenum etc[] = {
+    GL_COMPRESSED_RGB8_ETC2, GL_COMPRESSED_SRGB8_ETC2,
+    GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2,
+    GL_COMPRESSED_RGBA8_ETC2_EAC, GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC,
+    GL_COMPRESSED_R11_EAC, GL_COMPRESSED_SIGNED_R11_EAC,
+    GL_COMPRESSED_RG11_EAC, GL_COMPRESSED_SIGNED_RG11_EAC,
+  };
+  // VK_FORMAT_BC1_RGB_UNORM_BLOCK ... VK_FORMAT_BC3_SRGB_BLOCK, without sRGB
+  // variants since WEBGL_compressed_texture_s3tc_srgb isn't exposed
+  static const GLenum s3tc[] = {
+    GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 0,
+    GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 0,
+    GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, 0,
+    GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 0,
+  };
+
+  if (vkFormat == 37 || vkFormat == 43) { // VK_FORMAT_R8G8B8A8_UNORM / _SRGB
+    texture.internalFormat = vkFormat == 37 ? GL_RGBA8 : GL_SRGB8_ALPHA8;
+    texture.format = GL_RGBA;
+    texture.type = GL_UNSIGNED_BYTE;
+  } else if (vkFormat >= 131 && vkFormat <= 138) {
+    texture.internalFormat = s3tc[vkFormat - 131];
+  } else if (vkFormat >= 147 && vkFormat <= 156) {
+    texture.internalFormat = etc[vkFormat - 147];
+  } else if (vkFormat >= 157 && vkFormat <= 184) {
+    // Alternating UNORM and SRGB for every block size
+    uint32_t index = vkFormat - 157;
+    texture.internalFormat = (index % 2 ? GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR
+                                        : GL_COMPRESSED_RGBA_ASTC_4x4_KHR) + index / 2;
+  } else if (vkFormat == 1000054000) { // VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG
+    texture.internalFormat = GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG;
+  } else if (vkFormat == 1000054001) { // VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG
+    texture.internalFormat = GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG;
+  }
+  return texture.internalFormat != 0;
+}
+
+bool loadKTX1(const uint8_t *bytes, size_t byteLength, EXGLCompressedTexture &texture,
+              std::string &error) {
+  const size_t headerLength = 64;
+  if (byteLength < headerLength) {
+    error = "truncated header";
+    return false;
+  }
+  if (readAt<uint32_t>(bytes, 12) != 0x04030201) {
+    error = "big-endian KTX files aren't supported";
+    return false;
+  }
+  uint32_t glType = readAt<uint32_t>(bytes, 16);
+  uint32_t glFormat = readAt<uint32_t>(bytes, 24);
+  uint32_t glInternalFormat = readAt<uint32_t>(bytes, 28);
+  uint32_t pixelWidth = readAt<uint32_t>(bytes, 36);
+  uint32_t pixelHeight = readAt<uint32_t>(bytes, 40);
+  uint32_t pixelDepth = readAt<uint32_t>(bytes, 44);
+  uint32_t arrayElements = readAt<uint32_t>(bytes, 48);
+  uint32_t faces = readAt<uint32_t>(bytes, 52);
+  uint32_t levels = readAt<uint32_t>(bytes, 56);
+  uint32_t keyValueLength = readAt<uint32_t>(bytes, 60);
+
+  texture.internalFormat = glInternalFormat;
+  if (glType != 0) {
+    texture.format = glFormat;
+    texture.type = glType;
+  }
+  texture.width = pixelWidth;
+  texture.height = pixelHeight;
+  texture.depth = pixelDepth ? pixelDepth : 1;
+  texture.layers = arrayElements ? arrayElements : 1;
+  texture.faces = faces;
+  texture.levels = levels ? levels : 1;
+
+  size_t offset = headerLength + keyValueLength;
+  for (GLsizei level = 0; level < texture.levels; ++level) {
+    if (offset + 4 > byteLength) {
+      error = "truncated image data";
+      return false;
+    }
+    size_t imageSize = readAt<uint32_t>(bytes, offset);
+    offset += 4;
+    // `imageSize` is per face for non-array cube maps, for the whole level otherwise
+    GLsizei images = (faces == 6 && arrayElements == 0) ? 6 : 1;
+    for (GLsizei i = 0; i < images; ++i) {
+      if (offset + imageSize > byteLength) {
+        error = "truncated image data";
+        return false;
+      }
+      texture.images.push_back({ bytes + offset, imageSize });
+      offset += (imageSize + 3) & ~(size_t) 3; // cubePadding / mipPadding
+    }
+  }
+  return true;
+}
+
+bool loadKTX2(const uint8_t *bytes, size_t byteLength, EXGLCompressedTexture &texture,
+              std::string &error) {
+  const size_t headerLength = 80;
+  if (byteLength < headerLength) {
+    error = "truncated header";
+    return false;
+  }
+  uint32_t vkFormat = readAt<uint32_t>(bytes, 12);
+  uint32_t pixelWidth = readAt<uint32_t>(bytes, 20);
+  uint32_t pixelHeight = readAt<uint32_t>(bytes, 24);
+  uint32_t pixelDepth = readAt<uint32_t>(bytes, 28);
+  uint32_t layers = readAt<uint32_t>(bytes, 32);
+  uint32_t faces = readAt<uint32_t>(bytes, 36);
+  uint32_t levels = readAt<uint32_t>(bytes, 40);
+  uint32_t supercompression = readAt<uint32_t>(bytes, 44);
+
+  if (supercompression != 0) {
+    error = "supercompressed (BasisLZ, zstd...) KTX2 files aren't supported";
+    return false;
+  }
+  if (!internalFormatFromVkFormat(vkFormat, texture)) {
+    std::stringstream ss;
+    ss << "unsupported vkFormat " << vkFormat;
+    error = ss.str();
+    return false;
+  }
+  texture.width = pixelWidth;
+  texture.height = pixelHeight;
+  texture.depth = pixelDepth ? pixelDepth : 1;
+  texture.layers = layers ? layers : 1;
+  texture.faces = faces;
+  texture.levels = levels ? levels : 1;
+
+  if (faces != 1 && faces != 6) {
+    error = "invalid number of faces";
+    return false;
+  }
+  if (headerLength + texture.levels * 24 > byteLength) {
+    error = "truncated level index";
+    return false;
+  }
+  for (GLsizei level = 0; level < texture.levels; ++level) {
+    size_t entry = headerLength + level * 24;
+    uint64_t offset = readAt<uint64_t>(bytes, entry);
+    uint64_t length = readAt<uint64_t>(bytes, entry + 8);
+    if (offset + length > byteLength || length % faces != 0) {
+      error = "invalid level index";
+      return false;
+    }
+    // Faces are stored one after the other, each spanning all layers
+    size_t faceLength = length / faces;
+    for (uint32_t face = 0; face < faces; ++face) {
+      texture.images.push_back({ bytes + offset + face * faceLength, faceLength });
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+bool EXGLCompressedTexture::load(const std::string &path, EXGLCompressedTexture &texture,
+                                 std::string &error) {
+  size_t byteLength = 0;
+  // Mapped, the images are used in place and only paged in by the upload
+  texture.storage = EXGLMapFile(path, byteLength);
+  if (!texture.storage) {
+    error = "couldn't read '" + path + "'";
+    return false;
+  }
+
+  auto bytes = (const uint8_t *) texture.storage.get();
+  bool loaded = false;
+  if (byteLength >= 12 && memcmp(bytes, ktx1Identifier, 12) == 0) {
+    loaded = loadKTX1(bytes, byteLength, texture, error);
+  } else if (byteLength >= 12 && memcmp(bytes, ktx2Identifier, 12) == 0) {
+    loaded = loadKTX2(bytes, byteLength, texture, error);
+  } else {
+    error = "not a KTX or KTX2 file";
+  }
+  if (!loaded) {
+    return false;
+  }
+
+  if (texture.images.size() != (size_t) (texture.levels * texture.faces)) {
+    error = "unexpected number of images";
+    return false;
+  }
+  if (texture.width == 0 || texture.height == 0) {
+    error = "1D textures aren't supported";
+    return false;
+  }
+  if (texture.faces != 1 && texture.faces != 6) {
+    error = "invalid number of faces";
+    return false;
+  }
+  if (texture.faces == 6 && (texture.layers > 1 || texture.depth > 1)) {
+    error = "cube map arrays aren't supported";
+    return false;
+  }
+  if (texture.layers > 1 && texture.depth > 1) {
+    error = "3D texture arrays aren't supported";
+    return false;
+  }
+  return true;
+}
+
+GLenum EXGLCompressedTexture::target() const noexcept {
+  if (faces == 6) {
+    return GL_TEXTURE_CUBE_MAP;
+  } else if (depth > 1) {
+    return GL_TEXTURE_3D;
+  } else if (layers > 1) {
+    return GL_TEXTURE_2D_ARRAY;
+  }
+  return GL_TEXTURE_2D;
+}
+
+void EXGLCompressedTexture::upload(GLenum target) const noexcept {
+  bool is3D = target == GL_TEXTURE_3D || target == GL_TEXTURE_2D_ARRAY;
+
+  // Compressed images aren't padded to UNPACK_ALIGNMENT
+  GLint unpackAlignment;
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  for (GLsizei level = 0; level < levels; ++level) {
+    GLsizei levelWidth = width >> level ? width >> level : 1;
+    GLsizei levelHeight = height >> level ? height >> level : 1;
+    GLsizei levelDepth = layers > 1 ? layers : (depth >> level ? depth >> level : 1);
+    for (GLsizei face = 0; face < faces; ++face) {
+      const Image &image = images[level * faces + face];
+      GLenum imageTarget = faces == 6 ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : target;
+      if (isCompressed()) {
+        if (is3D) {
+          glCompressedTexImage3D(imageTarget, level, internalFormat, levelWidth, levelHeight,
+                                 levelDepth, 0, (GLsizei) image.byteLength, image.data);
+        } else {
+          glCompressedTexImage2D(imageTarget, level, internalFormat, levelWidth, levelHeight,
+                                 0, (GLsizei) image.byteLength, image.data);
+        }
+      } else {
+        if (is3D) {
+          glTexImage3D(imageTarget, level, internalFormat, levelWidth, levelHeight, levelDepth,
+                       0, format, type, image.data);
+        } else {
+          glTexImage2D(imageTarget, level, internalFormat, levelWidth, levelHeight, 0,
+                       format, type, image.data);
+        }
+      }
+    }
+  }
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+}
+
+const std::vector<EXGLCompressedTextureExtension> &EXGLCompressedTextureExtensions() {
+  static const std::vector<EXGLCompressedTextureExtension> extensions {
+    {
+      "WEBGL_compressed_texture_etc", {}, {
+        { "COMPRESSED_R11_EAC", GL_COMPRESSED_R11_EAC },
+        { "COMPRESSED_SIGNED_R11_EAC", GL_COMPRESSED_SIGNED_R11_EAC },
+        { "COMPRESSED_RG11_EAC", GL_COMPRESSED_RG11_EAC },
+        { "COMPRESSED_SIGNED_RG11_EAC", GL_COMPRESSED_SIGNED_RG11_EAC },
+        { "COMPRESSED_RGB8_ETC2", GL_COMPRESSED_RGB8_ETC2 },
+        { "COMPRESSED_RGBA8_ETC2_EAC", GL_COMPRESSED_RGBA8_ETC2_EAC },
+        { "COMPRESSED_SRGB8_ETC2", GL_COMPRESSED_SRGB8_ETC2 },
+        { "COMPRESSED_SRGB8_ALPHA8_ETC2_EAC", GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC },
+        { "COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2", GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 },
+        { "COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2", GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2 },
+      },
+    },
+    {
+      "WEBGL_compressed_texture_etc1", { "GL_OES_compressed_ETC1_RGB8_texture" }, {
+        { "COMPRESSED_RGB_ETC1_WEBGL", GL_ETC1_RGB8_OES },
+      },
+    },
+    {
+      "WEBGL_compressed_texture_s3tc", {
+        "GL_EXT_texture_compression_s3tc",
+        "GL_NV_texture_compression_s3tc",
+      }, {
+        { "COMPRESSED_RGB_S3TC_DXT1_EXT", GL_COMPRESSED_RGB_S3TC_DXT1_EXT },
+        { "COMPRESSED_RGBA_S3TC_DXT1_EXT", GL_COMPRESSED_RGBA_S3TC_DXT1_EXT },
+        { "COMPRESSED_RGBA_S3TC_DXT3_EXT", GL_COMPRESSED_RGBA_S3TC_DXT3_EXT },
+        { "COMPRESSED_RGBA_S3TC_DXT5_EXT", GL_COMPRESSED_RGBA_S3TC_DXT5_EXT },
+      },
+    },
+    {
+      "WEBGL_compressed_texture_pvrtc", { "GL_IMG_texture_compression_pvrtc" }, {
+        { "COMPRESSED_RGB_PVRTC_4BPPV1_IMG", GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG },
+        { "COMPRESSED_RGB_PVRTC_2BPPV1_IMG", GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG },
+        { "COMPRESSED_RGBA_PVRTC_4BPPV1_IMG", GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG },
+        { "COMPRESSED_RGBA_PVRTC_2BPPV1_IMG", GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG },
+      },
+    },
+    {
+      "WEBGL_compressed_texture_astc", { "GL_KHR_texture_compression_astc_ldr" }, [] {
+        static const char *blockSizes[EXGL_ASTC_BLOCK_SIZE_COUNT] = {
+          "4x4", "5x4", "5x5", "6x5", "6x6", "8x5", "8x6",
+          "8x8", "10x5", "10x6", "10x8", "10x10", "12x10", "12x12",
+        };
+        // The names have to outlive the table, which is never destroyed
+        static std::vector<std::string> names;
+        std::vector<EXGLCompressedTextureExtension::Constant> constants;
+        for (int i = 0; i < EXGL_ASTC_BLOCK_SIZE_COUNT; ++i) {
+          names.push_back(std::string("COMPRESSED_RGBA_ASTC_") + blockSizes[i] + "_KHR");
+          names.push_back(std::string("COMPRESSED_SRGB8_ALPHA8_ASTC_") + blockSizes[i] + "_KHR");
+        }
+        for (int i = 0; i < EXGL_ASTC_BLOCK_SIZE_COUNT; ++i) {
+          constants.push_back({ names[2 * i].c_str(),
+                                (GLenum) (GL_COMPRESSED_RGBA_ASTC_4x4_KHR + i) });
+          constants.push_back({ names[2 * i + 1].c_str(),
+                                (GLenum) (GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR + i) });
+        }
+        return constants;
+      }(),
+    },
+    {
+      // Not a texture format, but advertised the same way. Links and compiles
+      // run asynchronously on the GL thread anyway, EXGLContext answers
+      // COMPLETION_STATUS_KHR without waiting for them.
+      "KHR_parallel_shader_compile", {}, {
+        { "COMPLETION_STATUS_KHR", GL_COMPLETION_STATUS_KHR },
+      },
+    },
+  };
+  return extensions;
+}
@@ -0,0 +1,122 @@
+#ifndef __EXGLCOMPRESSEDTEXTURE_H__
+#define __EXGLCOMPRESSEDTEXTURE_H__
+
+#ifdef __ANDROID__
+#include <GLES3/gl3.h>
+#endif
+#ifdef __APPLE__
+#include <OpenGLES/ES3/gl.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Compressed formats from extensions that aren't in the ES 3 headers
+
+#ifndef GL_ETC1_RGB8_OES
+#define GL_ETC1_RGB8_OES 0x8D64
+#endif
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+#ifndef GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG
+#define GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG 0x8C00
+#endif
+#ifndef GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG
+#define GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG 0x8C01
+#endif
+#ifndef GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG
+#define GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG 0x8C02
+#endif
+#ifndef GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG
+#define GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG 0x8C03
+#endif
+
+// 14 block sizes from 4x4 to 12x12, in the same order as the VkFormats
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
+#ifndef GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR
+#define GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR 0x93D0
+#endif
+#define EXGL_ASTC_BLOCK_SIZE_COUNT 14
+
+
+// --- EXGLCompressedTexture ---------------------------------------------------
+
+// Texture read from a KTX (1.1) or KTX2 container: every mip level (and cube map
+// face) ready to be handed to glCompressedTexImage*. The images point into
+// `storage`, a read-only mapping of the file.
+
+struct EXGLCompressedTexture {
+  struct Image {
+    const void *data;
+    size_t byteLength;
+  };
+
+  GLenum internalFormat = 0;
+  // Only set for uncompressed textures
+  GLenum format = 0;
+  GLenum type = 0;
+
+  GLsizei width = 0;
+  GLsizei height = 0;
+  GLsizei depth = 1;  // > 1 for 3D textures
+  GLsizei layers = 1; // > 1 for 2D array textures
+  GLsizei faces = 1;  // 6 for cube maps
+  GLsizei levels = 1;
+
+  // `levels` * `faces` images, level-major. An image spans all layers/slices.
+  std::vector<Image> images;
+  std::shared_ptr<void> storage;
+
+  bool isCompressed() const noexcept {
+    return format == 0;
+  }
+
+  // [Any thread] Parse a KTX or KTX2 file, returns false and sets `error` if it
+  // can't be used
+  static bool load(const std::string &path, EXGLCompressedTexture &texture, std::string &error);
+
+  // [GL thread] Upload every image to the texture bound to `target`, which must
+  // be TEXTURE_2D, TEXTURE_CUBE_MAP, TEXTURE_3D or TEXTURE_2D_ARRAY depending on
+  // the texture's shape
+  void upload(GLenum target) const noexcept;
+
+  // WebGL target the texture has to be uploaded to
+  GLenum target() const noexcept;
+};
+
+
+// --- Compressed texture extensions -------------------------------------------
+
+// A `WEBGL_compressed_texture_*` extension, advertised when one of the
+// underlying GL extensions is there
+struct EXGLCompressedTextureExtension {
+  struct Constant {
+    const char *name;
+    GLenum value;
+  };
+
+  const char *webglName;
+  std::vector<const char *> glNames; // empty if core in ES 3
+  std::vector<Constant> constants;
+};
+
+const std::vector<EXGLCompressedTextureExtension> &EXGLCompressedTextureExtensions();
+
+#endif
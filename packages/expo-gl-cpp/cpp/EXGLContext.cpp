@@ -5,40 +5,117 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
-static std::unordered_map<UEXGLContextId, EXGLContext *> EXGLContextMap;
-static std::mutex EXGLContextMapMutex;
+// Live contexts, looked up without a lock by every native JS call and every
+// flush. A context sits in the slot of its id modulo the slot count. Each slot
+// keeps the id of its context next to the pointer, so a lookup never touches a
+// context before it knows it's the right one, along with the number of
+// references to the context and whether it's being destroyed: a destroyed
+// context is freed by whoever drops its last reference, and only then is the
+// slot free for a later id. Creating and destroying is serialized by the mutex.
+#define EXGL_CONTEXT_SLOT_COUNT 1024
+namespace {
+struct EXGLContextSlot {
+  // Id (high 32 bits), destroying flag and reference count (low 31 bits)
+  std::atomic<uint64_t> state { 0 };
+  std::atomic<EXGLContext *> exglCtx { nullptr };
+};
+
+constexpr uint64_t EXGLContextSlotDestroying = 1ull << 31;
+constexpr uint64_t EXGLContextSlotReferences = EXGLContextSlotDestroying - 1;
+}
+static EXGLContextSlot EXGLContextSlots[EXGL_CONTEXT_SLOT_COUNT];
+static std::mutex EXGLContextSlotsMutex;
 static UEXGLContextId EXGLContextNextId = 1;
 
-std::atomic_uint EXGLContext::nextObjectId { 1 };
+// Once a destroyed context has no references left
+static void EXGLContextSlotFree(EXGLContextSlot &slot) {
+  EXGLContext *exglCtx = slot.exglCtx.exchange(nullptr, std::memory_order_acq_rel);
+  slot.state.store(0, std::memory_order_release);
+  delete exglCtx;
+}
 
-EXGLContext *EXGLContext::ContextGet(UEXGLContextId exglCtxId) {
-  std::lock_guard<decltype(EXGLContextMapMutex)> lock(EXGLContextMapMutex);
-  auto iter = EXGLContextMap.find(exglCtxId);
-  if (iter != EXGLContextMap.end()) {
-    return iter->second;
+EXGLContextRef EXGLContext::ContextGet(UEXGLContextId exglCtxId) {
+  unsigned int index = exglCtxId % EXGL_CONTEXT_SLOT_COUNT;
+  auto &slot = EXGLContextSlots[index];
+  uint64_t state = slot.state.load(std::memory_order_acquire);
+  do {
+    if ((state >> 32) != exglCtxId || (state & EXGLContextSlotDestroying)) {
+      return {};
+    }
+  } while (!slot.state.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel,
+                                             std::memory_order_acquire));
+  return EXGLContextRef(slot.exglCtx.load(std::memory_order_acquire), index);
+}
+
+void EXGLContextRef::reset() noexcept {
+  if (!exglCtx) {
+    return;
+  }
+  exglCtx = nullptr;
+  auto &slot = EXGLContextSlots[this->slot];
+  uint64_t state = slot.state.fetch_sub(1, std::memory_order_acq_rel) - 1;
+  if ((state & EXGLContextSlotDestroying) && (state & EXGLContextSlotReferences) == 0) {
+    EXGLContextSlotFree(slot);
   }
-  return nullptr;
 }
 
-UEXGLContextId EXGLContext::ContextCreate(JSGlobalContextRef jsCtx) {
-  // Out of ids?
-  if (EXGLContextNextId >= std::numeric_limits<UEXGLContextId>::max()) {
-    EXGLSysLog("Ran out of EXGLContext ids!");
-    return 0;
+// [EXGLContextSlotsMutex held] Next id whose slot is free, 0 if there's none
+static UEXGLContextId EXGLContextReserveId() {
+  for (unsigned int i = 0; i < EXGL_CONTEXT_SLOT_COUNT; ++i) {
+    if (EXGLContextNextId >= std::numeric_limits<UEXGLContextId>::max()) {
+      EXGLSysLog("Ran out of EXGLContext ids!");
+      return 0;
+    }
+    UEXGLContextId exglCtxId = EXGLContextNextId++;
+    if (EXGLContextSlots[exglCtxId % EXGL_CONTEXT_SLOT_COUNT].state.load(std::memory_order_acquire) == 0) {
+      return exglCtxId;
+    }
   }
+  EXGLSysLog("Too many live EXGLContexts!");
+  return 0;
+}
+
+// [EXGLContextSlotsMutex held] Publish a context in the slot of its reserved id
+static void EXGLContextPublish(EXGLContext *exglCtx) {
+  auto &slot = EXGLContextSlots[exglCtx->exglCtxId % EXGL_CONTEXT_SLOT_COUNT];
+  slot.exglCtx.store(exglCtx, std::memory_order_release);
+  slot.state.store((uint64_t) exglCtx->exglCtxId << 32, std::memory_order_release);
+}
+
+JSClassRef EXGLContext::getJSClass() {
+  static JSClassRef jsClass = [] {
+    // The tables are copied into the class, they're null-terminated
+    std::vector<JSStaticFunction> staticFunctions;
+    installMethods(staticFunctions);
+    staticFunctions.push_back({nullptr, nullptr, 0});
+    std::vector<JSStaticValue> staticValues;
+    installConstants(staticValues);
+    staticValues.push_back({nullptr, nullptr, nullptr, 0});
+
+    auto definition = kJSClassDefinitionEmpty;
+    // Methods are looked up on the object itself rather than on a prototype,
+    // so they survive JS replacing the prototype (e.g. for `instanceof`)
+    definition.attributes = kJSClassAttributeNoAutomaticPrototype;
+    definition.staticFunctions = staticFunctions.data();
+    definition.staticValues = staticValues.data();
+    // Never released, it's shared by all contexts of all JS runtimes
+    return JSClassCreate(&definition);
+  }();
+  return jsClass;
+}
 
+UEXGLContextId EXGLContext::ContextCreate(JSGlobalContextRef jsCtx) {
   // Create C++ object
   EXGLContext *exglCtx;
   UEXGLContextId exglCtxId;
   {
-    std::lock_guard<decltype(EXGLContextMapMutex)> lock(EXGLContextMapMutex);
-    exglCtxId = EXGLContextNextId++;
-    if (EXGLContextMap.find(exglCtxId) != EXGLContextMap.end()) {
-      EXGLSysLog("Tried to reuse an EXGLContext id. This shouldn't really happen...");
+    std::lock_guard<decltype(EXGLContextSlotsMutex)> lock(EXGLContextSlotsMutex);
+    exglCtxId = EXGLContextReserveId();
+    if (exglCtxId == 0) {
       return 0;
     }
     exglCtx = new EXGLContext(jsCtx, exglCtxId);
-    EXGLContextMap[exglCtxId] = exglCtx;
+    EXGLContextPublish(exglCtx);
   }
 
   // Save JavaScript object
@@ -57,37 +134,1059 @@ UEXGLContextId EXGLContext::ContextCreate(JSGlobalContextRef jsCtx) {
   return exglCtxId;
 }
 
+UEXGLContextId EXGLContext::ContextCreate() {
+  std::lock_guard<decltype(EXGLContextSlotsMutex)> lock(EXGLContextSlotsMutex);
+  UEXGLContextId exglCtxId = EXGLContextReserveId();
+  if (exglCtxId == 0) {
+    return 0;
+  }
+  EXGLContextPublish(new EXGLContext(exglCtxId));
+  return exglCtxId;
+}
+
 void EXGLContext::ContextDestroy(UEXGLContextId exglCtxId) {
-  std::lock_guard<decltype(EXGLContextMapMutex)> lock(EXGLContextMapMutex);
+  std::lock_guard<decltype(EXGLContextSlotsMutex)> lock(EXGLContextSlotsMutex);
 
-  // Destroy C++ object, JavaScript side should just know...
-  auto iter = EXGLContextMap.find(exglCtxId);
-  if (iter != EXGLContextMap.end()) {
-    delete iter->second;
-    EXGLContextMap.erase(iter);
+  // Destroy C++ object, JavaScript side should just know... Lookups fail from
+  // now on, references still alive free it once they're dropped.
+  auto &slot = EXGLContextSlots[exglCtxId % EXGL_CONTEXT_SLOT_COUNT];
+  uint64_t state = slot.state.load(std::memory_order_acquire);
+  do {
+    if ((state >> 32) != exglCtxId || (state & EXGLContextSlotDestroying)) {
+      return;
+    }
+  } while (!slot.state.compare_exchange_weak(state, state | EXGLContextSlotDestroying,
+                                             std::memory_order_acq_rel, std::memory_order_acquire));
+  if ((state & EXGLContextSlotReferences) == 0) {
+    EXGLContextSlotFree(slot);
   }
 }
 
-// Load image data from an object with a `.localUri` member
-std::shared_ptr<void> EXGLContext::loadImage(
-        JSContextRef jsCtx,
-        JSObjectRef jsPixels,
-        int *fileWidth,
-        int *fileHeight,
-        int *fileComp) {
+// Get the local file path of an object with a `.localUri` member
+bool EXGLContext::localPathFromImage(JSContextRef jsCtx, JSObjectRef jsPixels, std::string &path) {
   JSValueRef jsLocalUri = EXJSObjectGetPropertyNamed(jsCtx, jsPixels, "localUri");
   if (jsLocalUri && JSValueIsString(jsCtx, jsLocalUri)) {
     // TODO(nikki): Check that this file is in the right scope
     auto localUri = jsValueToSharedStr(jsCtx, jsLocalUri);
     if (strncmp(localUri.get(), "file://", 7) != 0) {
-      return std::shared_ptr<void>(nullptr);
+      return false;
     }
     char localPath[strlen(localUri.get())];
     decodeURI(localPath, localUri.get() + 7);
-    return std::shared_ptr<void>(stbi_load(localPath,
-                                           fileWidth, fileHeight, fileComp,
-                                           STBI_rgb_alpha),
-                                 stbi_image_free);
+    path = localPath;
+    return true;
+  }
+  return false;
+}
+
+void EXGLContext::imageSizeFromObject(JSContextRef jsCtx, JSObjectRef jsPixels,
+                                      GLsizei *width, GLsizei *height) {
+  JSValueRef jsWidth = EXJSObjectGetPropertyNamed(jsCtx, jsPixels, "width");
+  JSValueRef jsHeight = EXJSObjectGetPropertyNamed(jsCtx, jsPixels, "height");
+  *width = jsWidth && JSValueIsNumber(jsCtx, jsWidth) ? (GLsizei) JSValueToNumber(jsCtx, jsWidth, nullptr) : 0;
+  *height = jsHeight && JSValueIsNumber(jsCtx, jsHeight) ? (GLsizei) JSValueToNumber(jsCtx, jsHeight, nullptr) : 0;
+}
+
+UEXGLTextStyle EXGLContext::textStyleFromObject(JSContextRef jsCtx, JSValueRef jsStyle) {
+  UEXGLTextStyle style;
+  if (!jsStyle || !JSValueIsObject(jsCtx, jsStyle)) {
+    return style;
+  }
+  JSObjectRef jsObject = (JSObjectRef) jsStyle;
+  auto stringNamed = [&](const char *name) -> std::string {
+    JSValueRef jsValue = EXJSObjectGetPropertyNamed(jsCtx, jsObject, name);
+    if (!jsValue || !JSValueIsString(jsCtx, jsValue)) {
+      return "";
+    }
+    return jsValueToSharedStr(jsCtx, jsValue).get();
+  };
+  auto numberNamed = [&](const char *name, double fallback) -> double {
+    JSValueRef jsValue = EXJSObjectGetPropertyNamed(jsCtx, jsObject, name);
+    return jsValue && JSValueIsNumber(jsCtx, jsValue) ? JSValueToNumber(jsCtx, jsValue, nullptr) : fallback;
+  };
+  style.fontFamily = stringNamed("fontFamily");
+  style.fontSize = numberNamed("fontSize", style.fontSize);
+  style.bold = EXGLFontWeightIsBold(stringNamed("fontWeight")) || numberNamed("fontWeight", 400) >= 600;
+  style.italic = stringNamed("fontStyle") == "italic";
+  style.color = (uint32_t) numberNamed("color", style.color);
+  style.maxWidth = numberNamed("maxWidth", style.maxWidth);
+  style.align = EXGLTextAlignFromString(stringNamed("textAlign"));
+  return style;
+}
+
+// Load image data from an object with a `.localUri` member
+std::shared_ptr<void> EXGLContext::loadImage(
+        JSContextRef jsCtx,
+        JSObjectRef jsPixels,
+        int *fileWidth,
+        int *fileHeight,
+        int *fileComp) {
+  std::string localPath;
+  if (localPathFromImage(jsCtx, jsPixels, localPath)) {
+    EXGLImage image = EXGLImageLoader::shared().decode(localPath, false, false);
+    *fileWidth = image.width;
+    *fileHeight = image.height;
+    if (fileComp) {
+      *fileComp = 4;
+    }
+    return image.data;
   }
   return std::shared_ptr<void>(nullptr);
 }
+
+// Start decoding the image of an object with a `.localUri` member on the image
+// loader's workers, returns an invalid future if there's no such member
+EXGLImageLoader::Future EXGLContext::loadImageAsync(JSContextRef jsCtx, JSObjectRef jsPixels) {
+  std::string localPath;
+  if (localPathFromImage(jsCtx, jsPixels, localPath)) {
+    return EXGLImageLoader::shared().load(localPath, unpackFLipY, unpackPremultiplyAlpha);
+  }
+  return EXGLImageLoader::Future();
+}
+
+bool EXGLContext::addMappedImageToNextBatch(const std::string &path, GLsizei width, GLsizei height,
+                                            GLenum target, GLint level, GLint internalformat,
+                                            GLenum format, GLenum type,
+                                            bool sub, GLint xoffset, GLint yoffset) {
+  auto image = std::make_shared<EXGLMappedImage>();
+  std::string error;
+  if (!EXGLMappedImage::load(path, width, height, format, type, bytesPerPixel(type, format),
+                             *image, error)) {
+    if (!error.empty()) {
+      throw std::runtime_error("EXGL: Couldn't upload '" + path + "': " + error);
+    }
+    return false;
+  }
+  if (!sub) {
+    residency.textureImage(target, level,
+                           imageBytes(internalformat, format, type, image->width, image->height));
+  }
+  bool flipY = unpackFLipY, premultiplyAlpha = unpackPremultiplyAlpha;
+  size_t tileBytes = uploadBudget;
+  addToNextBatch([=] {
+    image->upload(target, level, internalformat, format, type, sub, xoffset, yoffset,
+                  tileBytes, flipY, premultiplyAlpha);
+  });
+  return true;
+}
+
+void EXGLContext::addTexStorageToNextBatch(bool is3D, GLenum target, GLsizei levels,
+                                           GLenum internalformat, GLsizei width, GLsizei height,
+                                           GLsizei depth) {
+  if (!is3D) {
+    depth = 1;
+  }
+  residency.textureStorage(target, levels, width, height, depth,
+                           EXGLResidency::bytesPerTexel(internalformat, GL_NONE, GL_NONE));
+  // GL rejects invalid sizes and a second allocation, the texture keeps its
+  // storage then
+  UEXGLObjectId texture = residency.boundTexture(target);
+  if (texture && levels > 0 && width > 0 && height > 0 && depth > 0) {
+    textureStorages.emplace(texture, TextureStorage { levels, internalformat, width, height, depth });
+  }
+  if (is3D) {
+    addCallToNextBatch(glTexStorage3D, target, levels, internalformat, width, height, depth);
+  } else {
+    addCallToNextBatch(glTexStorage2D, target, levels, internalformat, width, height);
+  }
+}
+
+void EXGLContext::addTexStorageLevelsToNextBatch(GLenum target, GLsizei levels, GLenum internalformat,
+                                                 GLsizei width, GLsizei height, GLenum format, GLenum type,
+                                                 std::shared_ptr<void> data, size_t length) {
+  if (target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP) {
+    throw std::runtime_error("EXGL: gl.texStorage2DLevelsEXP() only takes TEXTURE_2D and TEXTURE_CUBE_MAP!");
+  }
+  if (residency.boundBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+    throw std::runtime_error("EXGL: gl.texStorage2DLevelsEXP() can't be used with a PIXEL_UNPACK_BUFFER bound!");
+  }
+  GLsizei faces = target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+  size_t texels = 0;
+  for (GLsizei level = 0; level < levels; ++level) {
+    texels += (size_t) std::max(1, width >> level) * std::max(1, height >> level) * faces;
+  }
+  // Every level has the same bytes per texel, whatever the format
+  if (levels <= 0 || width <= 0 || height <= 0 || length == 0 || length % texels != 0) {
+    throw std::runtime_error("EXGL: gl.texStorage2DLevelsEXP() data doesn't match the size of the mip chain!");
+  }
+  size_t bytesPerTexel = length / texels;
+
+  addTexStorageToNextBatch(false, target, levels, internalformat, width, height, 1);
+  bool flipY = unpackFLipY;
+  bool premultiplyAlpha = unpackPremultiplyAlpha && format == GL_RGBA && type == GL_UNSIGNED_BYTE;
+  addToNextBatch([=] {
+    GLint previousAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    // Converted in place, the data is a copy
+    auto pixels = (uint8_t *) data.get();
+    for (GLsizei level = 0; level < levels; ++level) {
+      GLsizei levelWidth = std::max(1, width >> level);
+      GLsizei levelHeight = std::max(1, height >> level);
+      size_t bytesPerRow = levelWidth * bytesPerTexel;
+      for (GLsizei face = 0; face < faces; ++face) {
+        if (flipY) {
+          EXGLFlipRows(pixels, bytesPerRow, levelHeight);
+        }
+        if (premultiplyAlpha) {
+          EXGLPremultiplyAlpha(pixels, (size_t) levelWidth * levelHeight);
+        }
+        GLenum imageTarget = faces == 6 ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : target;
+        glTexSubImage2D(imageTarget, level, 0, 0, levelWidth, levelHeight, format, type, pixels);
+        pixels += bytesPerRow * levelHeight;
+      }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+  });
+}
+
+EXGLTextImage EXGLContext::addTextImageToNextBatch(GLenum target, GLint level, bool sub,
+                                                   GLint xoffset, GLint yoffset,
+                                                   const std::string &text, const UEXGLTextStyle &style) {
+  if (residency.boundBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+    throw std::runtime_error("EXGL: Text can't be uploaded with a PIXEL_UNPACK_BUFFER bound!");
+  }
+  EXGLTextImage image = EXGLRasterizeText(text, style);
+  if (!image.data) {
+    throw std::runtime_error("EXGL: Couldn't rasterize text!");
+  }
+
+  std::shared_ptr<void> data = image.data;
+  GLsizei width = image.width, height = image.height;
+  if (!sub) {
+    residency.textureImage(target, level, imageBytes(GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, width, height));
+  }
+  bool flipY = unpackFLipY;
+  addToNextBatch([=] {
+    if (flipY) {
+      // Flipped in place, the pixels aren't used after the upload
+      EXGLFlipRows(data.get(), (size_t) width * 4, height);
+    }
+    // Rows of 4-byte pixels satisfy any UNPACK_ALIGNMENT
+    if (sub) {
+      glTexSubImage2D(target, level, xoffset, yoffset, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+                      data.get());
+    } else {
+      glTexImage2D(target, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.get());
+    }
+  });
+  return image;
+}
+
+bool EXGLContext::textureStorageParameter(GLenum target, GLenum pname, GLint *out) noexcept {
+  const TextureStorage *storage = boundTextureStorage(target);
+  switch (pname) {
+    case GL_TEXTURE_IMMUTABLE_FORMAT:
+      *out = storage ? GL_TRUE : GL_FALSE;
+      return true;
+    case GL_TEXTURE_IMMUTABLE_LEVELS:
+      *out = storage ? storage->levels : 0;
+      return true;
+  }
+  return false;
+}
+
+// [GL thread] Do all the remaining work we can do on the GL thread
+void EXGLContext::flush(void) noexcept {
+  EXGLSystraceSection section("EXGL flush");
+  bool timed = frameStatsEnabled;
+  std::chrono::steady_clock::time_point start;
+  if (timed) {
+    start = std::chrono::steady_clock::now();
+  }
+
+  if (multisampleChanged) {
+    updateMultisampleFramebuffer();
+  }
+
+  // Only run what was published when we started, so a JS thread producing
+  // faster than we consume can't keep us here forever
+  size_t count = backlog.size();
+  for (size_t i = 0; i < count; ++i) {
+    Batch *batch = backlog.front();
+    executeBatch(*batch);
+    batch->clear();
+    backlog.pop();
+  }
+  if (hasCoalescedBatch) {
+    {
+      std::lock_guard<decltype(coalescedBatchMutex)> lock(coalescedBatchMutex);
+      // Batches still in the ring were published before it, it waits for the
+      // next flush then. `vsync()` keeps asking for one until it has run.
+      if (!backlog.front()) {
+        coalescedRunBatch.swap(coalescedBatch);
+        hasCoalescedBatch = false;
+      }
+    }
+    if (!coalescedRunBatch.empty()) {
+      executeBatch(coalescedRunBatch);
+      coalescedRunBatch.clear();
+      ++count;
+    }
+  }
+  if (!pendingPixelPacks.empty()) {
+    pollPixelPacks();
+  }
+  releaseExternalTextures();
+  if (count > 0 && deferredErrors) {
+    GLenum error = glGetError();
+    GLenum noError = GL_NO_ERROR;
+    if (error != GL_NO_ERROR) {
+      // Like the GL error flag, keep the first one until it's read
+      deferredError.compare_exchange_strong(noError, error);
+    }
+  }
+
+  if (timed) {
+    flushNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+// [GL thread] Decode and run every command of a batch
+void EXGLContext::executeBatch(const Batch &batch) noexcept {
+  EXGLSystraceSection section("EXGL batch");
+  batch.forEach([&](const EXGLCommandHeader &header, const void *payload) {
+    switch (header.opcode) {
+      case EXGLOpcode::Closure:
+        batch.closureAt(payload)();
+        break;
+      case EXGLOpcode::Call: {
+        auto args = reinterpret_cast<const EXGLCallArgs *>(payload);
+        args->trampoline(args->glFunc, (const double *) Batch::trailingData<EXGLCallArgs>(payload));
+        break;
+      }
+      case EXGLOpcode::BindObject: {
+        auto args = reinterpret_cast<const EXGLBindObjectArgs *>(payload);
+        args->glFunc(args->target, lookupObject(args->exglObjId));
+        break;
+      }
+      case EXGLOpcode::UseObject: {
+        auto args = reinterpret_cast<const EXGLUseObjectArgs *>(payload);
+        args->glFunc(lookupObject(args->exglObjId));
+        break;
+      }
+      case EXGLOpcode::UniformFloatv: {
+        auto args = reinterpret_cast<const EXGLUniformvArgs<GLfloat> *>(payload);
+        auto data = (const GLfloat *) Batch::trailingData<EXGLUniformvArgs<GLfloat>>(payload);
+        args->glFunc(args->location, args->count, data);
+        break;
+      }
+      case EXGLOpcode::UniformIntv: {
+        auto args = reinterpret_cast<const EXGLUniformvArgs<GLint> *>(payload);
+        auto data = (const GLint *) Batch::trailingData<EXGLUniformvArgs<GLint>>(payload);
+        args->glFunc(args->location, args->count, data);
+        break;
+      }
+      case EXGLOpcode::UniformUintv: {
+        auto args = reinterpret_cast<const EXGLUniformvArgs<GLuint> *>(payload);
+        auto data = (const GLuint *) Batch::trailingData<EXGLUniformvArgs<GLuint>>(payload);
+        args->glFunc(args->location, args->count, data);
+        break;
+      }
+      case EXGLOpcode::UniformMatrixv: {
+        auto args = reinterpret_cast<const EXGLUniformMatrixvArgs *>(payload);
+        auto data = (const GLfloat *) Batch::trailingData<EXGLUniformMatrixvArgs>(payload);
+        args->glFunc(args->location, args->count, args->transpose, data);
+        break;
+      }
+      case EXGLOpcode::UniformBlock: {
+        auto args = reinterpret_cast<const EXGLUniformBlockArgs *>(payload);
+        auto entries = (const EXGLUniformBlockEntry *) Batch::trailingData<EXGLUniformBlockArgs>(payload);
+        auto data = (const uint8_t *) (entries + args->entryCount);
+        for (uint32_t i = 0; i < args->entryCount; ++i) {
+          const auto &entry = entries[i];
+          EXGLUploadUniform(entry.type, entry.location, entry.count, data + entry.offset);
+        }
+        break;
+      }
+    }
+  });
+}
+
+void EXGLContext::addUniformBlockToNextBatch(UEXGLObjectId program, const GLint *layout,
+                                             size_t layoutLength, const void *data,
+                                             size_t byteLength) {
+  if (layoutLength % 4 != 0) {
+    throw std::runtime_error("EXGL: gl.uniformBlockUpdateEXP() layout must be made of "
+                             "(location, type, count, offset) quadruples!");
+  }
+  size_t entryCount = layoutLength / 4;
+  std::vector<EXGLUniformBlockEntry> entries(entryCount);
+  for (size_t i = 0; i < entryCount; ++i) {
+    const GLint *quad = layout + 4 * i;
+    GLsizei components = EXGLUniformComponents(quad[1]);
+    if (components == 0) {
+      throw std::runtime_error("EXGL: Unsupported uniform type in gl.uniformBlockUpdateEXP() layout!");
+    }
+    if (quad[2] < 0 || quad[3] < 0 ||
+        4 * ((size_t) quad[3] + (size_t) quad[2] * components) > byteLength) {
+      throw std::runtime_error("EXGL: gl.uniformBlockUpdateEXP() layout reads past the end of the data!");
+    }
+    entries[i] = { quad[0], (GLenum) quad[1], quad[2], 4 * (uint32_t) quad[3] };
+  }
+
+  const double args[] = { (double) program };
+  if (shadowState.update(EXGLShadowState::Program, args, 1)) {
+    addUseToNextBatch(glUseProgram, program);
+  }
+  nextBatch.pushUniformBlock(entries.data(), entryCount, data, byteLength);
+}
+
+void EXGLContext::addMultiDrawToNextBatch(GLenum mode, GLenum type, const void *records,
+                                          size_t recordsByteLength, GLint location, GLenum uniformType,
+                                          const void *uniformData, size_t uniformByteLength) {
+  if (recordsByteLength % sizeof(EXGLDrawRecord) != 0) {
+    throw std::runtime_error("EXGL: gl.multiDrawElementsEXP() records must be made of "
+                             "(offset, count, instanceCount, slot) quadruples!");
+  }
+  size_t recordCount = recordsByteLength / sizeof(EXGLDrawRecord);
+  if (recordCount == 0) {
+    return;
+  }
+
+  size_t slotCount = 0;
+  if (location != -1) {
+    GLsizei components = EXGLUniformComponents(uniformType);
+    if (components == 0) {
+      throw std::runtime_error("EXGL: Unsupported uniform type for gl.multiDrawElementsEXP()!");
+    }
+    slotCount = uniformByteLength / (components * sizeof(GLfloat));
+  } else {
+    uniformByteLength = 0;
+  }
+  auto drawRecords = reinterpret_cast<const EXGLDrawRecord *>(records);
+  for (size_t i = 0; i < recordCount; ++i) {
+    const EXGLDrawRecord &record = drawRecords[i];
+    if (record.offset < 0 || record.count < 0 || record.instanceCount < 0) {
+      throw std::runtime_error("EXGL: Negative offset or count in gl.multiDrawElementsEXP() records!");
+    }
+    if (location != -1 && record.slot >= 0 && (size_t) record.slot >= slotCount) {
+      throw std::runtime_error("EXGL: gl.multiDrawElementsEXP() record reads past the end of the uniform data!");
+    }
+  }
+
+  // One allocation for both, the uniforms first to keep them aligned
+  std::shared_ptr<uint8_t> copy(new uint8_t[uniformByteLength + recordsByteLength],
+                                std::default_delete<uint8_t[]>());
+  if (uniformByteLength) {
+    memcpy(copy.get(), uniformData, uniformByteLength);
+  }
+  memcpy(copy.get() + uniformByteLength, records, recordsByteLength);
+  frameStats.bytesCopied += uniformByteLength + recordsByteLength;
+
+  addToNextBatch([=] {
+    auto copiedRecords = reinterpret_cast<const EXGLDrawRecord *>(copy.get() + uniformByteLength);
+    EXGLMultiDraw::execute(mode, type, copiedRecords, recordCount, location, uniformType, copy.get());
+  });
+}
+
+// [GL thread] Start a readback into a pixel pack buffer
+void EXGLContext::beginPixelPack(PixelPackRequest request, GLint x, GLint y,
+                                 GLsizei width, GLsizei height,
+                                 GLenum format, GLenum type) noexcept {
+  if (freePixelPackBuffers.empty()) {
+    glGenBuffers(1, &request.buffer);
+  } else {
+    request.buffer = freePixelPackBuffers.back();
+    freePixelPackBuffers.pop_back();
+  }
+
+  // Don't disturb the pixel pack buffer JS may have bound
+  GLint boundBuffer;
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &boundBuffer);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, request.buffer);
+  glBufferData(GL_PIXEL_PACK_BUFFER, request.byteLength, nullptr, GL_STREAM_READ);
+  glReadPixels(x, y, width, height, format, type, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, boundBuffer);
+
+  request.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  pendingPixelPacks.push_back(request);
+}
+
+// [GL thread] Start a readback of a buffer range
+void EXGLContext::beginBufferPack(PixelPackRequest request, GLenum target, GLintptr offset) noexcept {
+  if (freePixelPackBuffers.empty()) {
+    glGenBuffers(1, &request.buffer);
+  } else {
+    request.buffer = freePixelPackBuffers.back();
+    freePixelPackBuffers.pop_back();
+  }
+  // Copy on the GPU into our own buffer so that JS can overwrite the source
+  // (next transform feedback pass...) while the readback is pending
+  GLenum copyTarget = target == GL_COPY_WRITE_BUFFER ? GL_COPY_READ_BUFFER : GL_COPY_WRITE_BUFFER;
+  GLint boundBuffer;
+  glGetIntegerv(copyTarget == GL_COPY_WRITE_BUFFER ? GL_COPY_WRITE_BUFFER_BINDING
+                                                   : GL_COPY_READ_BUFFER_BINDING, &boundBuffer);
+  glBindBuffer(copyTarget, request.buffer);
+  glBufferData(copyTarget, request.byteLength, nullptr, GL_STREAM_READ);
+  glCopyBufferSubData(target, copyTarget, offset, 0, request.byteLength);
+  glBindBuffer(copyTarget, boundBuffer);
+
+  request.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  pendingPixelPacks.push_back(request);
+}
+
+void EXGLContext::takeSnapshot(UEXGLObjectId exglFramebuffer, GLint x, GLint y,
+                               GLsizei width, GLsizei height, UEXGLSnapshotEncoder encode) noexcept {
+  if (width <= 0 || height <= 0) {
+    EXGLSnapshotQueue::shared().encode(nullptr, 0, 0, std::move(encode));
+    return;
+  }
+  PixelPackRequest request;
+  request.byteLength = (size_t) width * height * 4;
+  request.width = width;
+  request.height = height;
+  request.snapshotEncoder = std::move(encode);
+
+  GLint readFramebuffer;
+  glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER,
+                    exglFramebuffer == 0 ? displayFramebuffer : lookupObject(exglFramebuffer));
+  beginPixelPack(std::move(request), x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+  // Get the copy going even if nothing else is drawn for a while
+  glFlush();
+}
+
+// [GL thread] Collect readbacks whose fence has been signaled
+void EXGLContext::pollPixelPacks() noexcept {
+  EXGLSystraceSection section("EXGL poll readbacks");
+  std::vector<PixelPackRequest> completed;
+  GLint boundBuffer;
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &boundBuffer);
+
+  // Readbacks complete in order, stop at the first one that isn't ready
+  auto iter = pendingPixelPacks.begin();
+  for (; iter != pendingPixelPacks.end(); ++iter) {
+    GLenum status = glClientWaitSync(iter->fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+      break;
+    }
+    glDeleteSync(iter->fence);
+    iter->fence = nullptr;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, iter->buffer);
+    void *mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, iter->byteLength, GL_MAP_READ_BIT);
+    if (mapped) {
+      iter->result = malloc(iter->byteLength);
+      memcpy(iter->result, mapped, iter->byteLength);
+      glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    freePixelPackBuffers.push_back(iter->buffer);
+    if (iter->snapshotEncoder) {
+      // Flipped and encoded off the GL thread
+      EXGLSnapshotQueue::shared().encode(iter->result, iter->width, iter->height,
+                                         std::move(iter->snapshotEncoder));
+    } else {
+      completed.push_back(*iter);
+    }
+  }
+  pendingPixelPacks.erase(pendingPixelPacks.begin(), iter);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, boundBuffer);
+
+  if (!completed.empty()) {
+    std::lock_guard<decltype(completedPixelPacksMutex)> lock(completedPixelPacksMutex);
+    completedPixelPacks.insert(completedPixelPacks.end(), completed.begin(), completed.end());
+  }
+}
+
+// [JS thread] Call the callbacks of completed readbacks
+void EXGLContext::resolvePixelPacks(JSContextRef jsCtx) noexcept {
+  std::vector<PixelPackRequest> completed;
+  {
+    std::lock_guard<decltype(completedPixelPacksMutex)> lock(completedPixelPacksMutex);
+    completed.swap(completedPixelPacks);
+  }
+  for (auto &request : completed) {
+    JSValueRef jsResult;
+    if (!request.result) {
+      jsResult = JSValueMakeNull(jsCtx);
+    } else if (usingTypedArrayHack) {
+      jsResult = makeTypedArray(jsCtx, request.arrayType, request.result, request.byteLength);
+      free(request.result);
+    } else {
+      // Hand the buffer over to JavaScriptCore, no need for another copy
+      jsResult = JSObjectMakeTypedArrayWithBytesNoCopy(jsCtx, request.arrayType,
+                                                       request.result, request.byteLength,
+                                                       jsTypedArrayFreeDeallocator, nullptr, nullptr);
+    }
+    JSObjectCallAsFunction(jsCtx, request.jsCallback, nullptr, 1, &jsResult, nullptr);
+    JSValueUnprotect(jsCtx, request.jsCallback);
+  }
+}
+
+void EXGLContext::setExternalTextureSource(UEXGLObjectId exglObjId,
+                                           std::function<GLuint(void)> latchFrame) {
+  std::lock_guard<decltype(externalTexturesMutex)> lock(externalTexturesMutex);
+  auto iter = externalTextures.find(exglObjId);
+  if (iter != externalTextures.end()) {
+    releasedExternalTextures.push_back(std::move(iter->second));
+    externalTextures.erase(iter);
+  }
+  if (latchFrame) {
+    externalTextures[exglObjId] = std::move(latchFrame);
+  }
+}
+
+void EXGLContext::latchExternalTexture(UEXGLObjectId exglObjId) noexcept {
+  std::function<GLuint(void)> latchFrame;
+  {
+    std::lock_guard<decltype(externalTexturesMutex)> lock(externalTexturesMutex);
+    auto iter = externalTextures.find(exglObjId);
+    if (iter == externalTextures.end()) {
+      return;
+    }
+    // Called unlocked, the source may be replaced meanwhile
+    latchFrame = iter->second;
+  }
+  GLuint texture = latchFrame();
+  if (texture != 0) {
+    mapObject(exglObjId, texture);
+  }
+}
+
+bool EXGLContext::removeExternalTexture(UEXGLObjectId exglObjId) noexcept {
+  std::function<GLuint(void)> latchFrame;
+  {
+    std::lock_guard<decltype(externalTexturesMutex)> lock(externalTexturesMutex);
+    auto iter = externalTextures.find(exglObjId);
+    if (iter == externalTextures.end()) {
+      return false;
+    }
+    latchFrame = std::move(iter->second);
+    externalTextures.erase(iter);
+  }
+  return true;
+}
+
+void EXGLContext::releaseExternalTextures() noexcept {
+  std::vector<std::function<GLuint(void)>> released;
+  {
+    std::lock_guard<decltype(externalTexturesMutex)> lock(externalTexturesMutex);
+    if (releasedExternalTextures.empty()) {
+      return;
+    }
+    released.swap(releasedExternalTextures);
+  }
+}
+
+void EXGLContext::updateMultisampleFramebuffer() noexcept {
+  MultisampleConfig config;
+  {
+    std::lock_guard<std::mutex> lock(multisampleMutex);
+    config = requestedMultisample;
+    multisampleChanged = false;
+  }
+  if (config.samples == multisample.samples && config.width == multisample.width &&
+      config.height == multisample.height) {
+    return;
+  }
+
+  GLint drawFramebuffer, readFramebuffer, renderbuffer;
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+  glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+  glGetIntegerv(GL_RENDERBUFFER_BINDING, &renderbuffer);
+  GLint previousDefaultFramebuffer = defaultFramebuffer;
+
+  releaseMultisampleFramebuffer();
+  GLint maxSamples = 0;
+  if (config.samples > 0 && config.width > 0 && config.height > 0) {
+    // Not an enum before OpenGL ES 3.0, don't leave that error for JS to find
+    glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    glGetError();
+  }
+  if (maxSamples > 0) {
+    GLsizei samples = std::min<GLsizei>(config.samples, maxSamples);
+    GLuint renderbuffers[2];
+    glGenRenderbuffers(2, renderbuffers);
+    multisampleColorRenderbuffer = renderbuffers[0];
+    multisampleDepthStencilRenderbuffer = renderbuffers[1];
+    glBindRenderbuffer(GL_RENDERBUFFER, multisampleColorRenderbuffer);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, config.width, config.height);
+    glBindRenderbuffer(GL_RENDERBUFFER, multisampleDepthStencilRenderbuffer);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH24_STENCIL8,
+                                     config.width, config.height);
+
+    glGenFramebuffers(1, &multisampleFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, multisampleFramebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                              multisampleColorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                              multisampleDepthStencilRenderbuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE) {
+      multisample = config;
+      defaultFramebuffer = multisampleFramebuffer;
+      clearMultisampleFramebuffer();
+    } else {
+      releaseMultisampleFramebuffer();
+    }
+  }
+
+  // What JS had bound as the default framebuffer is the new one now
+  auto rebind = [&](GLint framebuffer) {
+    return framebuffer == previousDefaultFramebuffer ? defaultFramebuffer : framebuffer;
+  };
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, rebind(drawFramebuffer));
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, rebind(readFramebuffer));
+  glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+}
+
+void EXGLContext::clearMultisampleFramebuffer() noexcept {
+  // Storage starts out undefined. Clear it without touching the clear values
+  // or masks JS set, which the shadow state may have remembered
+  GLboolean scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+  GLboolean colorMask[4], depthMask;
+  GLint stencilMask;
+  glGetBooleanv(GL_COLOR_WRITEMASK, colorMask);
+  glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+  glGetIntegerv(GL_STENCIL_WRITEMASK, &stencilMask);
+  glDisable(GL_SCISSOR_TEST);
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  glDepthMask(GL_TRUE);
+  glStencilMask(0xff);
+
+  static const GLfloat transparent[] = { 0, 0, 0, 0 };
+  glClearBufferfv(GL_COLOR, 0, transparent);
+  glClearBufferfi(GL_DEPTH_STENCIL, 0, 1, 0);
+
+  if (scissorTest) {
+    glEnable(GL_SCISSOR_TEST);
+  }
+  glColorMask(colorMask[0], colorMask[1], colorMask[2], colorMask[3]);
+  glDepthMask(depthMask);
+  glStencilMask(stencilMask);
+}
+
+void EXGLContext::releaseMultisampleFramebuffer() noexcept {
+  if (multisampleFramebuffer) {
+    glDeleteFramebuffers(1, &multisampleFramebuffer);
+    GLuint renderbuffers[2] = { multisampleColorRenderbuffer, multisampleDepthStencilRenderbuffer };
+    glDeleteRenderbuffers(2, renderbuffers);
+  }
+  multisampleFramebuffer = multisampleColorRenderbuffer = multisampleDepthStencilRenderbuffer = 0;
+  multisample = MultisampleConfig();
+  defaultFramebuffer = displayFramebuffer;
+}
+
+void EXGLContext::resolveMultisampleFramebuffer() noexcept {
+  if (!multisampleFramebuffer) {
+    return;
+  }
+  EXGLSystraceSection section("EXGL resolve");
+  GLint drawFramebuffer, readFramebuffer;
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+  glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+  GLboolean scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+  GLboolean rasterizerDiscard = glIsEnabled(GL_RASTERIZER_DISCARD);
+  if (scissorTest) {
+    glDisable(GL_SCISSOR_TEST);
+  }
+  if (rasterizerDiscard) {
+    glDisable(GL_RASTERIZER_DISCARD);
+  }
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, multisampleFramebuffer);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, displayFramebuffer);
+  glBlitFramebuffer(0, 0, multisample.width, multisample.height,
+                    0, 0, multisample.width, multisample.height,
+                    GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  // Like a WebGL drawing buffer (without `preserveDrawingBuffer`) the contents
+  // are undefined after the frame, so the samples never leave the GPU's tiles
+  static const GLenum attachments[] = { GL_COLOR_ATTACHMENT0, GL_DEPTH_STENCIL_ATTACHMENT };
+  glInvalidateFramebuffer(GL_READ_FRAMEBUFFER, 2, attachments);
+
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+  if (scissorTest) {
+    glEnable(GL_SCISSOR_TEST);
+  }
+  if (rasterizerDiscard) {
+    glEnable(GL_RASTERIZER_DISCARD);
+  }
+}
+
+void EXGLContext::discardAndClear(GLbitfield mask) noexcept {
+  // A scissor test, write masks or rasterizer discard leave parts as they were
+  GLenum attachments[3];
+  GLsizei count = 0;
+  if (!glIsEnabled(GL_SCISSOR_TEST) && !glIsEnabled(GL_RASTERIZER_DISCARD)) {
+    GLint framebuffer;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+    bool isWindow = framebuffer == 0;
+    if (mask & GL_COLOR_BUFFER_BIT) {
+      GLboolean colorMask[4];
+      GLint drawBuffer;
+      glGetBooleanv(GL_COLOR_WRITEMASK, colorMask);
+      glGetIntegerv(GL_DRAW_BUFFER0, &drawBuffer);
+      if (colorMask[0] && colorMask[1] && colorMask[2] && colorMask[3] &&
+          drawBuffer == (isWindow ? GL_BACK : GL_COLOR_ATTACHMENT0)) {
+        attachments[count++] = isWindow ? GL_COLOR : GL_COLOR_ATTACHMENT0;
+      }
+    }
+    if (mask & GL_DEPTH_BUFFER_BIT) {
+      GLboolean depthMask;
+      glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+      if (depthMask) {
+        attachments[count++] = isWindow ? GL_DEPTH : GL_DEPTH_ATTACHMENT;
+      }
+    }
+    if (mask & GL_STENCIL_BUFFER_BIT) {
+      GLint frontMask, backMask;
+      glGetIntegerv(GL_STENCIL_WRITEMASK, &frontMask);
+      glGetIntegerv(GL_STENCIL_BACK_WRITEMASK, &backMask);
+      if ((frontMask & 0xff) == 0xff && (backMask & 0xff) == 0xff) {
+        attachments[count++] = isWindow ? GL_STENCIL : GL_STENCIL_ATTACHMENT;
+      }
+    }
+  }
+  if (count > 0) {
+    glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, count, attachments);
+  }
+  glClear(mask);
+}
+
+void EXGLContext::discardDisplayDepthStencil() noexcept {
+  if (!supportsWebGL2) {
+    return;
+  }
+  GLint drawFramebuffer;
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+  if (drawFramebuffer != displayFramebuffer) {
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, displayFramebuffer);
+  }
+  if (displayFramebuffer == 0) {
+    static const GLenum attachments[] = { GL_DEPTH, GL_STENCIL };
+    glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, 2, attachments);
+  } else {
+    static const GLenum attachments[] = { GL_DEPTH_ATTACHMENT, GL_STENCIL_ATTACHMENT };
+    glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, 2, attachments);
+  }
+  if (drawFramebuffer != displayFramebuffer) {
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+  }
+}
+
+void EXGLContext::setFrameSink(UEXGLFrameSink sink) {
+  auto newSink = sink ? std::make_shared<UEXGLFrameSink>(std::move(sink)) : nullptr;
+  std::lock_guard<decltype(frameSinkMutex)> lock(frameSinkMutex);
+  frameSink.swap(newSink);
+}
+
+void EXGLContext::recordFrame() noexcept {
+  if (!recording.active) {
+    return;
+  }
+  auto sink = getFrameSink();
+  if (!sink) {
+    return;
+  }
+  GLint framebuffer = recording.framebuffer == 0 ?
+    displayFramebuffer : (GLint) lookupObject(recording.framebuffer);
+  (*sink)(framebuffer, recording.width, recording.height, steadyNanos());
+}
+
+void EXGLContext::stopRecording() noexcept {
+  if (!recording.active) {
+    return;
+  }
+  recording.active = false;
+  auto sink = getFrameSink();
+  if (sink) {
+    (*sink)(-1, 0, 0, 0);
+  }
+}
+
+void EXGLContext::reflectProgram(GLuint program, ProgramInfo &info) noexcept {
+  glGetProgramiv(program, GL_LINK_STATUS, &info.linkStatus);
+  if (info.linkStatus) {
+    auto reflect = [&](GLenum countParam, GLenum lengthParam, auto &&glGetActive,
+                       auto &&glGetLocation, std::vector<ActiveInfo> &actives,
+                       std::unordered_map<std::string, GLint> &locations) {
+      GLint count = 0, maxLength = 0;
+      glGetProgramiv(program, countParam, &count);
+      glGetProgramiv(program, lengthParam, &maxLength);
+      std::vector<char> name(maxLength > 0 ? maxLength : 1);
+      for (GLint i = 0; i < count; ++i) {
+        ActiveInfo active;
+        GLsizei length = 0;
+        glGetActive(program, i, (GLsizei) name.size(), &length, &active.size, &active.type, name.data());
+        active.name.assign(name.data(), length);
+
+        GLint location = glGetLocation(program, active.name.c_str());
+        if (location != -1) { // -1 for members of uniform blocks
+          // Arrays are reported as `name[0]` but can be looked up as `name` too
+          std::string base = active.name;
+          bool isArray = base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0;
+          if (isArray) {
+            base.resize(base.size() - 3);
+          }
+          locations[base] = location;
+          if (isArray) {
+            for (GLint element = 0; element < active.size; ++element) {
+              std::stringstream elementName;
+              elementName << base << '[' << element << ']';
+              locations[elementName.str()] = glGetLocation(program, elementName.str().c_str());
+            }
+          }
+        }
+        actives.push_back(std::move(active));
+      }
+    };
+    reflect(GL_ACTIVE_UNIFORMS, GL_ACTIVE_UNIFORM_MAX_LENGTH, glGetActiveUniform,
+            glGetUniformLocation, info.uniforms, info.uniformLocations);
+    reflect(GL_ACTIVE_ATTRIBUTES, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, glGetActiveAttrib,
+            glGetAttribLocation, info.attributes, info.attribLocations);
+  }
+  info.ready = true;
+}
+
+EXGLContext::ProgramInfo *EXGLContext::programInfo(UEXGLObjectId exglObjId) {
+  auto iter = programInfos.find(exglObjId);
+  if (iter == programInfos.end()) {
+    return nullptr;
+  }
+  if (!iter->second->ready) {
+    // The link is still queued, wait for it once
+    addBlockingToNextBatch([] {});
+  }
+  return iter->second.get();
+}
+
+uint64_t EXGLContext::programCacheKey(UEXGLObjectId fProgram) {
+  if (!EXGLProgramCache::shared().enabled()) {
+    return 0;
+  }
+  auto shaders = programShaders.find(fProgram);
+  if (shaders == programShaders.end() || shaders->second.empty()) {
+    return 0;
+  }
+  // Independent of the attachment order
+  std::vector<uint64_t> hashes;
+  for (UEXGLObjectId fShader : shaders->second) {
+    auto iter = shaderSourceHashes.find(fShader);
+    if (iter == shaderSourceHashes.end()) {
+      return 0;
+    }
+    hashes.push_back(iter->second);
+  }
+  std::sort(hashes.begin(), hashes.end());
+  uint64_t key = EXGLProgramCache::hash(hashes.data(), hashes.size() * sizeof(uint64_t));
+  auto bindings = programBindingHashes.find(fProgram);
+  if (bindings != programBindingHashes.end()) {
+    key = EXGLProgramCache::hash(&bindings->second, sizeof(bindings->second), key);
+  }
+  return key == 0 ? 1 : key;
+}
+
+void EXGLContext::addLinkProgramToNextBatch(UEXGLObjectId fProgram) {
+  auto info = std::make_shared<ProgramInfo>();
+  programInfos[fProgram] = info;
+  uint64_t cacheKey = programCacheKey(fProgram);
+  addToNextBatch([=] {
+    GLuint program = lookupObject(fProgram);
+    if (cacheKey == 0) {
+      glLinkProgram(program);
+    } else if (!EXGLProgramCache::shared().load(program, cacheKey)) {
+      glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+      glLinkProgram(program);
+      EXGLProgramCache::shared().store(program, cacheKey);
+    }
+    reflectProgram(program, *info);
+  });
+  traceLastClosure(EXGLTraceEvent::LinkProgram, { (double) fProgram });
+}
+
+void EXGLContext::addCompileShaderToNextBatch(UEXGLObjectId fShader) {
+  shaderCompileStatus.erase(fShader);
+  addUseToNextBatch(glCompileShader, fShader);
+  auto done = std::make_shared<std::atomic<bool>>(false);
+  shaderCompiles[fShader] = done;
+  addToNextBatch([=] { *done = true; });
+}
+
+bool EXGLContext::programCompletionStatus(UEXGLObjectId fProgram) {
+  auto iter = programInfos.find(fProgram);
+  if (iter == programInfos.end() || iter->second->ready) {
+    return true;
+  }
+  if (!nextBatch.empty()) {
+    endNextBatch();
+    flushOnGLThread();
+  }
+  return iter->second->ready;
+}
+
+bool EXGLContext::shaderCompletionStatus(UEXGLObjectId fShader) {
+  auto iter = shaderCompiles.find(fShader);
+  if (iter == shaderCompiles.end()) {
+    return true;
+  }
+  if (*iter->second) {
+    shaderCompiles.erase(iter);
+    return true;
+  }
+  if (!nextBatch.empty()) {
+    endNextBatch();
+    flushOnGLThread();
+  }
+  return *iter->second;
+}
+
+void EXGLContext::endFrameStats() noexcept {
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  lastFrameStats[FrameStatOps] = frameStats.ops;
+  lastFrameStats[FrameStatBytesCopied] = frameStats.bytesCopied;
+  lastFrameStats[FrameStatBlockingCalls] = frameStats.blockingCalls;
+  lastFrameStats[FrameStatBlockedMs] = Milliseconds(frameStats.blocked).count();
+  // Flushes are asynchronous, this is the GL thread time spent since the last
+  // frame ended rather than on this exact frame
+  lastFrameStats[FrameStatFlushMs] = flushNanoseconds.exchange(0) / 1e6;
+  lastFrameStats[FrameStatBacklogDepth] = backlog.size();
+  lastFrameStats[FrameStatResidentBytes] = residency.totalBytes();
+  lastFrameStats[FrameStatTextureBytes] = residency.bytes(EXGLResidency::Texture);
+  lastFrameStats[FrameStatBufferBytes] = residency.bytes(EXGLResidency::Buffer);
+  lastFrameStats[FrameStatRenderbufferBytes] = residency.bytes(EXGLResidency::Renderbuffer);
+  lastFrameStats[FrameStatContextLost] = contextLost ? 1 : 0;
+  frameStats = FrameStats();
+}
+
+void EXGLContext::setResidencyBudget(JSContextRef jsCtx, size_t bytes, JSObjectRef jsCallback) noexcept {
+  residency.budget = bytes;
+  if (jsResidencyCallback) {
+    JSValueUnprotect(jsCtx, jsResidencyCallback);
+  }
+  jsResidencyCallback = jsCallback;
+  if (jsResidencyCallback) {
+    JSValueProtect(jsCtx, jsResidencyCallback);
+  }
+}
+
+void EXGLContext::endFrameResidency(JSContextRef jsCtx) noexcept {
+  std::vector<ResidencyReport> reports;
+  {
+    std::lock_guard<decltype(residencyReportsMutex)> lock(residencyReportsMutex);
+    reports.swap(residencyReports);
+  }
+  if (contextLost) {
+    residency.clear();
+  } else {
+    for (const auto &report : reports) {
+      residency.textureImage(report.exglObjId, report.target, report.level, report.bytes);
+    }
+  }
+
+  if (jsCtx && jsResidencyCallback && residency.overBudget()) {
+    auto candidates = residency.evictionCandidates();
+    if (!candidates.empty()) {
+      static_assert(sizeof(UEXGLObjectId) == sizeof(uint32_t), "EXGL object ids are sent as a Uint32Array");
+      JSValueRef jsArgs[] = {
+        makeTypedArray(jsCtx, kJSTypedArrayTypeUint32Array,
+                       candidates.data(), candidates.size() * sizeof(UEXGLObjectId)),
+        JSValueMakeNumber(jsCtx, residency.totalBytes()),
+      };
+      JSObjectCallAsFunction(jsCtx, jsResidencyCallback, nullptr, 2, jsArgs, nullptr);
+    }
+  }
+  residency.endFrame();
+}
@@ -1,4 +1,20 @@
 #include "UEXGL.h"
+#include "EXGLBatchRing.h"
+#include "EXGLCommandBuffer.h"
+#include "EXGLCompressedTexture.h"
+#include "EXGLImageLoader.h"
+#include "EXGLMappedImage.h"
+#include "EXGLMultiDraw.h"
+#include "EXGLPixelKernels.h"
+#include "EXGLProgramCache.h"
+#include "EXGLResidency.h"
+#include "EXGLShadowState.h"
+#include "EXGLSnapshot.h"
+#include "EXGLStagingArena.h"
+#include "EXGLSystrace.h"
+#include "EXGLTextRasterizer.h"
+#include "EXGLTrace.h"
+#include "EXGLVertexArrayState.h"
 #include "EXJSUtils.h"
 #include "EXJSConvertTypedArray.h"
 
@@ -12,10 +28,16 @@
 #include <OpenGLES/EAGL.h>
 #endif
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <future>
+#include <mutex>
 #include <unordered_map>
 #include <exception>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 // Constants in WebGL that aren't in OpenGL ES
@@ -28,16 +50,85 @@
 #define GL_BROWSER_DEFAULT_WEBGL 0x9244
 #define GL_MAX_CLIENT_WAIT_TIMEOUT_WEBGL 0x9247
 
+// Target of external textures (OES_EGL_image_external), only backed on Android
+#ifndef GL_TEXTURE_EXTERNAL_OES
+#define GL_TEXTURE_EXTERNAL_OES 0x8D65
+#endif
+
 #define GL_STENCIL_INDEX 0x1901
 #define GL_DEPTH_STENCIL 0x84F9
 #define GL_DEPTH_STENCIL_ATTACHMENT 0x821A
 
 
+// --- EXGLContextRef ----------------------------------------------------------
+
+class EXGLContext;
+
+// A context found by `EXGLContext::ContextGet`. It keeps the context alive while
+// it's in scope: a context destroyed meanwhile is only freed once the last
+// reference to it goes away.
+class EXGLContextRef {
+public:
+  EXGLContextRef() noexcept = default;
+
+  EXGLContextRef(EXGLContextRef &&other) noexcept : exglCtx(other.exglCtx), slot(other.slot) {
+    other.exglCtx = nullptr;
+  }
+
+  EXGLContextRef &operator=(EXGLContextRef &&other) noexcept {
+    if (this != &other) {
+      reset();
+      exglCtx = other.exglCtx;
+      slot = other.slot;
+      other.exglCtx = nullptr;
+    }
+    return *this;
+  }
+
+  EXGLContextRef(const EXGLContextRef &) = delete;
+  EXGLContextRef &operator=(const EXGLContextRef &) = delete;
+
+  ~EXGLContextRef() {
+    reset();
+  }
+
+  explicit operator bool() const noexcept {
+    return exglCtx != nullptr;
+  }
+
+  EXGLContext *get() const noexcept {
+    return exglCtx;
+  }
+
+  EXGLContext *operator->() const noexcept {
+    return exglCtx;
+  }
+
+  EXGLContext &operator*() const noexcept {
+    return *exglCtx;
+  }
+
+  // Drop the reference, freeing the context if it was destroyed meanwhile
+  void reset() noexcept;
+
+private:
+  friend class EXGLContext;
+
+  EXGLContextRef(EXGLContext *exglCtx, unsigned int slot) noexcept : exglCtx(exglCtx), slot(slot) {}
+
+  EXGLContext *exglCtx = nullptr;
+  unsigned int slot = 0;
+};
+
+
 // --- EXGLContext -------------------------------------------------------------
 
 // Class of the C++ object representing an EXGL rendering context.
 
 class EXGLContext {
+  // The JSI binding drives the same op queue as the JavaScriptCore methods
+  friend class EXGLJsiContext;
+
   // --- Queue handling --------------------------------------------------------
 
   // There are two threads: the input thread (henceforth "JS thread") feeds new GL
@@ -48,38 +139,135 @@ class EXGLContext {
   // JS work is done on the GL thread
 
 private:
-  // The smallest unit of work
+  // The smallest unit of work that can't be encoded as a plain command
   using Op = std::function<void(void)>;
 
   // Ops are combined into batches:
   //   1. A batch is always executed entirely in one go on the GL thread
   //   2. The last add to a batch always precedes the first remove
-  // #2 means that it's good to use an std::vector<...> for this
-  using Batch = std::vector<Op>;
+  // #2 means that a flat append-only command buffer works well for this
+  using Batch = EXGLCommandBuffer;
+
+  // TypedArrays pinned by the no-copy upload paths whose op has run on the GL
+  // thread and that are waiting to be unprotected on the JS thread. Declared
+  // before the batches so that it outlives them.
+  std::vector<JSObjectRef> pinnedArraysToRelease;
+  std::mutex pinnedArraysMutex;
+
+  // [JS thread] Copies of TypedArrays for ops, see `stageCopy`
+  EXGLStagingArena stagingArena;
 
   Batch nextBatch;
-  std::vector<Batch> backlog;
-  std::mutex backlogMutex;
+  EXGLBatchRing<Batch, 8> backlog;
+
+  // Batches ended while the ring was full under the Coalesce policy. The JS
+  // thread appends to it, the GL thread runs it once it has run every batch
+  // of the ring, and the next batch to go through the ring takes it along.
+  Batch coalescedBatch;
+  std::mutex coalescedBatchMutex;
+  // Set by the JS thread and cleared by whichever thread empties it, so that
+  // neither takes the lock while there's nothing coalesced
+  std::atomic<bool> hasCoalescedBatch { false };
+  // [GL thread] `coalescedBatch` taken out to run it without holding the lock
+  Batch coalescedRunBatch;
+
+public:
+  // What `endNextBatch` does when the GL thread is a full backlog behind
+  enum class BacklogPolicy {
+    // Append to a single batch outside of the ring instead, which the GL
+    // thread runs after the ring, so it catches up on fewer, bigger batches
+    Coalesce,
+    // Wait for the GL thread to make room
+    Block,
+  };
 
-  // [JS thread] Send the current 'next' batch to GL and make a new 'next' batch
-  void endNextBatch() noexcept {
-    std::lock_guard<decltype(backlogMutex)> lock(backlogMutex);
-    backlog.emplace_back();
-    backlog.back().reserve(nextBatch.size());
-    backlog.back().swap(nextBatch);
+private:
+  std::atomic<BacklogPolicy> backlogPolicy { BacklogPolicy::Coalesce };
+
+  // [JS thread] Send the current 'next' batch to GL and make a new 'next' batch.
+  // Blocking ops pass `mustSend` since they wait for their batch to go through
+  // the ring.
+  void endNextBatch(bool mustSend = false) noexcept {
+    size_t byteSize = nextBatch.byteSize();
+    frameStats.ops += nextBatch.size();
+    if (trace) {
+      trace->writeBatch(nextBatch);
+    }
+    Batch *slot = backlog.acquire();
+    if (!slot) {
+      if (!mustSend && backlogPolicy == BacklogPolicy::Coalesce) {
+        std::lock_guard<decltype(coalescedBatchMutex)> lock(coalescedBatchMutex);
+        coalescedBatch.append(nextBatch);
+        hasCoalescedBatch = true;
+        return;
+      }
+      flushOnGLThread();
+      while (!(slot = backlog.acquire())) {
+        std::this_thread::yield();
+      }
+    }
+    if (hasCoalescedBatch) {
+      // Batches coalesced earlier go first
+      std::lock_guard<decltype(coalescedBatchMutex)> lock(coalescedBatchMutex);
+      coalescedBatch.append(nextBatch);
+      coalescedBatch.swap(nextBatch);
+      hasCoalescedBatch = false;
+    }
+    // The slot holds a batch that already ran (cleared on the GL thread), reuse
+    // its arena for the new 'next' batch
+    slot->swap(nextBatch);
+    backlog.publish();
+    // Frames tend to be similar, size the new batch like the last one
+    nextBatch.reserve(byteSize);
   }
 
   // [JS thread] Add an Op to the 'next' batch -- the arguments are any form of
   // constructor arguments for Op
   template<typename... Args>
   inline void addToNextBatch(Args &&...args) noexcept {
-    nextBatch.emplace_back(std::forward<Args>(args)...);
+    nextBatch.pushClosure(Op(std::forward<Args>(args)...));
   }
 
+  // [JS thread] Add a call of a GL function taking only scalar arguments to the
+  // 'next' batch -- encoded without any allocation
+  template<typename... Params, typename... Args>
+  inline void addCallToNextBatch(void (*glFunc)(Params...), Args... args) noexcept {
+    nextBatch.pushCall(glFunc, args...);
+  }
+
+  // [JS thread] Add a `glFunc(target, lookupObject(exglObjId))` call to the 'next' batch
+  inline void addBindToNextBatch(void (*glFunc)(GLenum, GLuint), GLenum target,
+                                 UEXGLObjectId exglObjId) noexcept {
+    nextBatch.pushBindObject(glFunc, target, exglObjId);
+  }
+
+  // [JS thread] Add a `glFunc(lookupObject(exglObjId))` call to the 'next' batch
+  inline void addUseToNextBatch(void (*glFunc)(GLuint), UEXGLObjectId exglObjId) noexcept {
+    nextBatch.pushUseObject(glFunc, exglObjId);
+  }
+
+  // [JS thread] Use `program` and add the uniform uploads described by `layout`
+  // to the 'next' batch as a single command holding one copy of `data`. `layout`
+  // is a list of (location, type, count, offset) quadruples, `type` being the
+  // GL type of the uniform (GL_FLOAT_MAT4, GL_SAMPLER_2D...) and `offset` counted
+  // in 4-byte elements of `data`. Throws if an entry reads past the data.
+  void addUniformBlockToNextBatch(UEXGLObjectId program, const GLint *layout, size_t layoutLength,
+                                  const void *data, size_t byteLength);
+
+  // [JS thread] Add the draws of `records` (see EXGLMultiDraw.h) to the 'next'
+  // batch as a single command holding one copy of the records and of the slots
+  // of uniform `location` (-1 for none) in `uniformData`. Throws on malformed
+  // records or slots past the end of the data.
+  void addMultiDrawToNextBatch(GLenum mode, GLenum type, const void *records, size_t recordsByteLength,
+                               GLint location, GLenum uniformType,
+                               const void *uniformData, size_t uniformByteLength);
+
   // [JS thread] Add a blocking operation to the 'next' batch -- waits for the
   // queued function to run before returning
   template<typename F>
   inline void addBlockingToNextBatch(F &&f) noexcept {
+    EXGLSystraceSection section("EXGL blocking call");
+    BlockedTimer timer(*this);
 #ifdef __ANDROID__
     // std::packaged_task + std::future segfaults on Android... :|
 
@@ -98,7 +286,7 @@ private:
 
     {
       std::unique_lock<decltype(mutex)> lock(mutex);
-      endNextBatch();
+      endNextBatch(true);
       flushOnGLThread();
       cv.wait(lock, [&] { return done; });
     }
@@ -106,7 +294,7 @@ private:
     std::packaged_task<decltype(f())(void)> task(std::move(f));
     auto future = task.get_future();
     addToNextBatch([&] { task(); });
-    endNextBatch();
+    endNextBatch(true);
     flushOnGLThread();
     future.wait();
 #endif
@@ -122,13 +310,18 @@ private:
   // and is only needed when method calls after it ask for the value, and those
   // are queued for even later.
   template<typename F>
-  inline JSValueRef addFutureToNextBatch(JSContextRef jsCtx, F &&f) noexcept {
+  inline UEXGLObjectId addFutureToNextBatch(F &&f) noexcept {
     auto exglObjId = createObject();
     addToNextBatch([=] {
-      assert(objects.find(exglObjId) == objects.end());
+      assert(lookupObject(exglObjId) == 0);
       mapObject(exglObjId, f());
     });
-    return JSValueMakeNumber(jsCtx, exglObjId);
+    return exglObjId;
+  }
+
+  template<typename F>
+  inline JSValueRef addFutureToNextBatch(JSContextRef jsCtx, F &&f) noexcept {
+    return JSValueMakeNumber(jsCtx, addFutureToNextBatch(std::forward<F>(f)));
   }
 
 public:
@@ -136,70 +329,156 @@ public:
   std::function<void(void)> flushOnGLThread = [&]{};
 
   // [GL thread] Do all the remaining work we can do on the GL thread
-  void flush(void) noexcept {
-    // Keep a copy and clear backlog to minimize lock time
-    decltype(backlog) copy;
-    {
-      std::lock_guard<decltype(backlogMutex)> lock(backlogMutex);
-      backlog.swap(copy);
-    }
-    for (const auto &batch : copy) {
-      for (const auto &op : batch) {
-        op();
-      }
-    }
-  }
+  void flush(void) noexcept;
+
+private:
+  // [GL thread] Decode and run every command of a batch
+  void executeBatch(const Batch &batch) noexcept;
 
 
   // --- Object mapping --------------------------------------------------------
 
-  // We err on the side of performance and hope that a global incrementing atomic
-  // unsigned int is enough for object ids. On 'creating' an object we simply
-  // 'reserve' the id by incrementing the atomic counter. Since the mapping is only
-  // set and read on the GL thread, this prevents us from having to maintain a
-  // mutex on the mapping.
+  // We err on the side of performance and hope that an incrementing atomic
+  // unsigned int per context is enough for object ids. On 'creating' an object
+  // we simply 'reserve' the id by incrementing the atomic counter. Since the
+  // mapping is only set and read on the GL thread, this prevents us from having
+  // to maintain a mutex on the mapping.
+  //
+  // The low bits of an id index a flat table split in fixed-size pages that
+  // never move once allocated: a lookup is two loads and no hashing. Slots
+  // released with `destroyObject` are handed out again by `createObject` with
+  // the next generation in the high bits, and lookups only match the current
+  // generation of a slot, so a JS handle of a deleted object never aliases the
+  // object that reuses its slot. A slot is retired once its generations run out.
 
 private:
-  std::unordered_map<UEXGLObjectId, GLuint> objects;
-  static std::atomic_uint nextObjectId;
+  static constexpr size_t objectIndexBits = 22;
+  static constexpr UEXGLObjectId objectIndexMask = (1u << objectIndexBits) - 1;
+  static constexpr UEXGLObjectId objectGenerationMax = ~0u >> objectIndexBits;
+  static constexpr size_t objectPageBits = 10;
+  static constexpr size_t objectPageSize = 1 << objectPageBits;
+
+  struct ObjectSlot {
+    GLuint glObj = 0;
+    UEXGLObjectId generation = 0;
+  };
+  using ObjectPage = std::array<ObjectSlot, objectPageSize>;
+
+  std::vector<std::unique_ptr<ObjectPage>> objectPages;
+  std::vector<UEXGLObjectId> freeObjectIds;
+  std::mutex freeObjectIdsMutex;
+  std::atomic<UEXGLObjectId> nextObjectIndex { 1 };
+
+  // [GL thread] Slot of `exglObjId` whatever its generation, nullptr if its page
+  // doesn't exist
+  inline ObjectSlot *objectSlot(UEXGLObjectId exglObjId) noexcept {
+    size_t index = exglObjId & objectIndexMask;
+    size_t page = index >> objectPageBits;
+    if (page >= objectPages.size() || !objectPages[page]) {
+      return nullptr;
+    }
+    return &(*objectPages[page])[index & (objectPageSize - 1)];
+  }
 
 public:
   inline UEXGLObjectId createObject(void) noexcept {
-    return nextObjectId++;
+    {
+      std::lock_guard<decltype(freeObjectIdsMutex)> lock(freeObjectIdsMutex);
+      if (!freeObjectIds.empty()) {
+        auto exglObjId = freeObjectIds.back();
+        freeObjectIds.pop_back();
+        return exglObjId;
+      }
+    }
+    auto exglObjId = nextObjectIndex++;
+    assert(exglObjId <= objectIndexMask);
+    return exglObjId;
   }
 
   inline void destroyObject(UEXGLObjectId exglObjId) noexcept {
-    objects.erase(exglObjId);
+    ObjectSlot *slot = objectSlot(exglObjId);
+    UEXGLObjectId generation = exglObjId >> objectIndexBits;
+    if (!slot || slot->generation != generation || slot->glObj == 0) {
+      // Never mapped, already destroyed or stale, don't risk handing the slot
+      // out twice
+      return;
+    }
+    slot->glObj = 0;
+    if (generation == objectGenerationMax) {
+      return;
+    }
+    std::lock_guard<decltype(freeObjectIdsMutex)> lock(freeObjectIdsMutex);
+    freeObjectIds.push_back(((generation + 1) << objectIndexBits) | (exglObjId & objectIndexMask));
   }
 
   inline void mapObject(UEXGLObjectId exglObjId, GLuint glObj) noexcept {
-    objects[exglObjId] = glObj;
+    size_t page = (exglObjId & objectIndexMask) >> objectPageBits;
+    if (page >= objectPages.size()) {
+      objectPages.resize(page + 1);
+    }
+    if (!objectPages[page]) {
+      objectPages[page].reset(new ObjectPage());
+    }
+    ObjectSlot *slot = objectSlot(exglObjId);
+    slot->glObj = glObj;
+    slot->generation = exglObjId >> objectIndexBits;
   }
 
   inline GLuint lookupObject(UEXGLObjectId exglObjId) noexcept {
-    auto iter = objects.find(exglObjId);
-    return iter == objects.end() ? 0 : iter->second;
+    ObjectSlot *slot = objectSlot(exglObjId);
+    if (!slot || slot->generation != exglObjId >> objectIndexBits) {
+      return 0;
+    }
+    return slot->glObj;
+  }
+
+  // Reverse lookup, returns 0 if no EXGL object maps to `glObj`. This is a linear
+  // scan, only use it to answer queries.
+  inline UEXGLObjectId findObject(GLuint glObj) noexcept {
+    if (glObj == 0) {
+      return 0;
+    }
+    for (size_t page = 0; page < objectPages.size(); ++page) {
+      if (!objectPages[page]) {
+        continue;
+      }
+      const auto &slots = *objectPages[page];
+      for (size_t i = 0; i < objectPageSize; ++i) {
+        if (slots[i].glObj == glObj) {
+          return (slots[i].generation << objectIndexBits) | (UEXGLObjectId) ((page << objectPageBits) | i);
+        }
+      }
+    }
+    return 0;
   }
 
 
   // --- Init/destroy and JS object binding ------------------------------------
 private:
-  JSObjectRef jsGl;
+  JSObjectRef jsGl = nullptr;
   bool supportsWebGL2 = false;
 
 public:
-  EXGLContext(JSGlobalContextRef jsCtx, UEXGLContextId exglCtxId) {
+  const UEXGLContextId exglCtxId;
+
+  EXGLContext(JSGlobalContextRef jsCtx, UEXGLContextId exglCtxId) : exglCtxId(exglCtxId) {
     // Prepare for TypedArray usage
     prepareTypedArrayAPI(jsCtx);
 
-    // Create JS version of us
-    auto jsClass = JSClassCreate(&kJSClassDefinitionEmpty);
-    jsGl = JSObjectMake(jsCtx, jsClass, (void *) (intptr_t) exglCtxId);
-    JSClassRelease(jsClass);
-    installMethods(jsCtx);
-    installConstants(jsCtx);
+    // Create JS version of us, the methods and constants come with its class
+    jsGl = JSObjectMake(jsCtx, getJSClass(), (void *) (intptr_t) exglCtxId);
+
+    addInitialStateToNextBatch();
+  }
+
+  // Without a JS object, for contexts driven through JSI (see EXGLJsiContext)
+  explicit EXGLContext(UEXGLContextId exglCtxId) : exglCtxId(exglCtxId) {
+    addInitialStateToNextBatch();
+  }
 
-    // Clear everything to initial values
+private:
+  // [JS thread] Clear everything to initial values
+  void addInitialStateToNextBatch() noexcept {
     addToNextBatch([this] {
       std::string version = (char *) glGetString(GL_VERSION);
       double glesVersion = strtod(version.substr(10).c_str(), 0);
@@ -224,24 +503,45 @@ public:
     });
   }
 
+public:
   JSObjectRef getJSObject(void) const noexcept {
     return jsGl;
   }
 
-  static EXGLContext* ContextGet(UEXGLContextId exglCtxId);
+  // [Any thread] Lock-free, null if the context was destroyed
+  static EXGLContextRef ContextGet(UEXGLContextId exglCtxId);
   static UEXGLContextId ContextCreate(JSGlobalContextRef jsCtx);
+  // Without a JS object, the caller binds it to JS
+  static UEXGLContextId ContextCreate();
   static void ContextDestroy(UEXGLContextId exglCtxId);
 
   // --- GL state --------------------------------------------------------------
 private:
+  // [GL thread] What JS binding 0 binds: the multisampled framebuffer when
+  // antialiasing, otherwise the one the platform displays
   GLint defaultFramebuffer = 0;
+  GLint displayFramebuffer = 0;
   bool unpackFLipY = false;
+  bool unpackPremultiplyAlpha = false;
+
+  // [JS thread] Opt-in with `gl.enableStateCachingEXP(true)`
+  EXGLShadowState shadowState;
+
+  // [JS thread] Always on, drops vertex attribute calls that wouldn't change the
+  // bound vertex array
+  EXGLVertexArrayState vertexArrays;
+
+  // [JS thread] Answer `getParameter` from the shadow state, nullptr if it can't
+  JSValueRef getParameterFromShadowState(JSContextRef jsCtx, GLenum pname);
 
 public:
   bool needsRedraw = false;
 
   void setDefaultFramebuffer(GLint framebuffer) {
-    defaultFramebuffer = framebuffer;
+    if (defaultFramebuffer == displayFramebuffer) {
+      defaultFramebuffer = framebuffer;
+    }
+    displayFramebuffer = framebuffer;
   }
 
   void setNeedsRedraw(bool needsRedraw) {
@@ -249,9 +549,652 @@ public:
   }
 
 
+  // --- Multisampling ---------------------------------------------------------
+
+  // With `UEXGLContextSetMultisampling()` JS draws the default framebuffer into
+  // a multisampled one instead, which each `endFrameEXP` resolves into the
+  // display framebuffer with `glBlitFramebuffer` and then invalidates, so tiled
+  // GPUs resolve the samples on chip and never write them to memory. Much
+  // cheaper than antialiasing by rendering at a higher resolution. Needs
+  // OpenGL ES 3.0, without it the default framebuffer is drawn directly.
+
+private:
+  struct MultisampleConfig {
+    GLsizei samples = 0;
+    GLsizei width = 0;
+    GLsizei height = 0;
+  };
+
+  // [Any thread] The configuration asked for, picked up by the next flush
+  std::mutex multisampleMutex;
+  MultisampleConfig requestedMultisample;
+  std::atomic<bool> multisampleChanged { false };
+
+  // [GL thread] The multisampled framebuffer and its attachments, 0 if none
+  MultisampleConfig multisample;
+  GLuint multisampleFramebuffer = 0;
+  GLuint multisampleColorRenderbuffer = 0;
+  GLuint multisampleDepthStencilRenderbuffer = 0;
+
+  // [GL thread] (Re)make the multisampled framebuffer if it was reconfigured
+  void updateMultisampleFramebuffer() noexcept;
+  void clearMultisampleFramebuffer() noexcept;
+  void releaseMultisampleFramebuffer() noexcept;
+  // [GL thread] Resolve the frame into the display framebuffer
+  void resolveMultisampleFramebuffer() noexcept;
+
+public:
+  // [Any thread] Whether JS asked for antialiasing, see `getContextAttributes`
+  std::atomic<bool> antialias { false };
+
+  // [Any thread] Antialias with `samples` samples (clamped to GL_MAX_SAMPLES) at
+  // `width` x `height`, the size of the display framebuffer. 0 samples draws
+  // the display framebuffer directly again.
+  void setMultisampling(GLsizei samples, GLsizei width, GLsizei height) noexcept {
+    std::lock_guard<std::mutex> lock(multisampleMutex);
+    requestedMultisample = { samples, width, height };
+    antialias = samples > 0;
+    multisampleChanged = true;
+  }
+
+
+  // --- Framebuffer discard ---------------------------------------------------
+
+  // Tiled GPUs keep a framebuffer in tile memory while drawing to it. Contents
+  // still valid when they switch away get written back to memory, contents
+  // valid when they switch to it get loaded. Invalidating what won't be needed
+  // saves that bandwidth: depth and stencil at the end of a frame, and what a
+  // `clear` right after binding overwrites anyway.
+
+public:
+  // [Any thread] `UEXGLFramebufferDiscard` flags
+  std::atomic<unsigned int> framebufferDiscard {
+    UEXGLFramebufferDiscardDepthStencilAtEndFrame | UEXGLFramebufferDiscardOnClear };
+
+  // [JS thread] Note a `bindFramebuffer`, the next `clear` may discard
+  inline void framebufferBound(GLenum target) noexcept {
+    if (target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER) {
+      drawFramebufferFresh = true;
+    }
+  }
+
+  // [JS thread] Add a `glClear(mask)` call to the 'next' batch, invalidating
+  // what it overwrites first if it's the first one since binding
+  void addClearToNextBatch(GLbitfield mask) noexcept {
+    if (drawFramebufferFresh && supportsWebGL2 &&
+        (framebufferDiscard & UEXGLFramebufferDiscardOnClear)) {
+      addToNextBatch([=] { discardAndClear(mask); });
+    } else {
+      addCallToNextBatch(glClear, mask);
+    }
+    drawFramebufferFresh = false;
+  }
+
+private:
+  // [JS thread] Whether nothing was cleared since the draw framebuffer was bound
+  // or the frame ended
+  bool drawFramebufferFresh = true;
+
+  // [GL thread]
+  void discardAndClear(GLbitfield mask) noexcept;
+  void discardDisplayDepthStencil() noexcept;
+
+
+  // --- Frame pacing ----------------------------------------------------------
+
+  // Without vsync reports every `endFrameEXP` asks the platform for a flush
+  // straight away. Once the platform reports display refreshes with
+  // `UEXGLContextVsync()` (from Choreographer or a CADisplayLink), frames ended
+  // between two refreshes are flushed together at the next one instead, so they
+  // don't stack up on the GL thread within a single vsync. If refreshes stop
+  // coming (view paused...) frames go back to being flushed right away.
+  //
+  // `gl.getFrameDeadlineEXP()` tells JS how long until the next refresh and how
+  // many ended frames the GL thread hasn't run yet, so producers can skip work
+  // when it's behind.
+
+private:
+  // [Any thread] steady_clock nanoseconds of the last refresh, 0 before the first
+  std::atomic<int64_t> lastVsyncNanos { 0 };
+  std::atomic<int64_t> vsyncIntervalNanos { 16666667 };
+  // A frame ended since the last refresh and is waiting for the next one
+  std::atomic<bool> framePending { false };
+
+  // Frames ended by JS and run by the GL thread
+  std::atomic<uint64_t> framesEnded { 0 };
+  std::atomic<uint64_t> framesExecuted { 0 };
+
+  static inline int64_t steadyNanos() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  // Whether refreshes are being reported, allowing for a couple of late ones
+  inline bool vsyncPaced(int64_t now) const noexcept {
+    int64_t last = lastVsyncNanos;
+    return last != 0 && now - last < 3 * vsyncIntervalNanos;
+  }
+
+public:
+  // [JS thread] Send the frame JS just ended to the GL thread, now or at the
+  // next refresh
+  void endFrame() noexcept {
+    addToNextBatch([this] {
+      resolveMultisampleFramebuffer();
+      if (framebufferDiscard & UEXGLFramebufferDiscardDepthStencilAtEndFrame) {
+        discardDisplayDepthStencil();
+      }
+      setNeedsRedraw(true);
+      ++framesExecuted;
+      recordFrame();
+    });
+    ++framesEnded;
+    drawFramebufferFresh = true;
+    endNextBatch();
+    if (vsyncPaced(steadyNanos())) {
+      framePending = true;
+    } else {
+      flushOnGLThread();
+    }
+  }
+
+  // [Any thread] A display refresh at `frameTimeNanos` (steady_clock), returns
+  // whether frames are waiting for the platform to flush. Coalesced batches
+  // are retried at every refresh until a flush gets to them.
+  bool vsync(int64_t frameTimeNanos, int64_t intervalNanos) noexcept {
+    if (intervalNanos > 0) {
+      vsyncIntervalNanos = intervalNanos;
+    }
+    lastVsyncNanos = frameTimeNanos > 0 ? frameTimeNanos : steadyNanos();
+    return framePending.exchange(false) || hasCoalescedBatch;
+  }
+
+  // [JS thread] Milliseconds until the next expected refresh (the frame
+  // deadline), the refresh interval, and the frames ended but not run yet.
+  // Without vsync reports the deadline is a refresh interval away.
+  void frameDeadline(double result[3]) const noexcept {
+    int64_t now = steadyNanos();
+    int64_t interval = vsyncIntervalNanos;
+    int64_t untilNext = interval;
+    if (vsyncPaced(now)) {
+      int64_t sinceLast = now - lastVsyncNanos;
+      untilNext = interval - (sinceLast >= 0 ? sinceLast % interval : 0);
+    }
+    result[0] = untilNext / 1e6;
+    result[1] = interval / 1e6;
+    result[2] = (double) (framesEnded - framesExecuted);
+  }
+
+
+  // --- Async pixel readback --------------------------------------------------
+
+  // `readPixelsAsyncEXP` reads into a pixel pack buffer and fences it instead of
+  // blocking. Each GL thread flush polls the fences, copies out the ready ones
+  // and the JS thread hands them to their callbacks at the next `endFrameEXP`.
+  // Pixel pack buffers are recycled so steady-state capture doesn't allocate
+  // GL storage every frame. `getBufferSubDataAsyncEXP` goes through the same
+  // machinery with a GPU-side copy of the buffer range instead of a readback,
+  // and so do native snapshots, whose pixels go to the snapshot queue instead of
+  // JS (see EXGLSnapshot.h).
+
+private:
+  struct PixelPackRequest {
+    GLuint buffer = 0;
+    GLsync fence = nullptr;
+    size_t byteLength = 0;
+    JSTypedArrayType arrayType = kJSTypedArrayTypeUint8Array;
+    JSObjectRef jsCallback = nullptr;
+    void *result = nullptr;
+
+    // Snapshots only, RGBA8 pixels
+    GLsizei width = 0;
+    GLsizei height = 0;
+    UEXGLSnapshotEncoder snapshotEncoder;
+  };
+
+  // Only touched on the GL thread
+  std::vector<PixelPackRequest> pendingPixelPacks;
+  std::vector<GLuint> freePixelPackBuffers;
+
+  // Filled on the GL thread, drained on the JS thread
+  std::vector<PixelPackRequest> completedPixelPacks;
+  std::mutex completedPixelPacksMutex;
+
+  // [GL thread] Start a readback into a pixel pack buffer
+  void beginPixelPack(PixelPackRequest request, GLint x, GLint y, GLsizei width, GLsizei height,
+                      GLenum format, GLenum type) noexcept;
+
+  // [GL thread] Start a readback of `byteLength` bytes at `offset` of the buffer
+  // bound to `target`
+  void beginBufferPack(PixelPackRequest request, GLenum target, GLintptr offset) noexcept;
+
+  // [GL thread] Collect readbacks whose fence has been signaled
+  void pollPixelPacks() noexcept;
+
+  // [JS thread] Call the callbacks of completed readbacks
+  void resolvePixelPacks(JSContextRef jsCtx) noexcept;
+
+public:
+  // [GL thread] Start a snapshot of the EXGL framebuffer `exglFramebuffer` (0 for
+  // the default one), `encode` gets the pixels on the snapshot queue
+  void takeSnapshot(UEXGLObjectId exglFramebuffer, GLint x, GLint y, GLsizei width, GLsizei height,
+                    UEXGLSnapshotEncoder encode) noexcept;
+
+
+  // --- External textures -----------------------------------------------------
+
+  // Textures fed by a platform video source (camera frames...) without any CPU
+  // copy. Native code registers a source for an EXGL texture object, then
+  // `gl.updateExternalTextureEXP(texture)` latches the source's latest frame on
+  // the GL thread and maps the object to the GL texture holding it.
+
+public:
+  // [Any thread] Feed `exglObjId` from `latchFrame`, or stop if it's empty. The
+  // function being replaced is destroyed on the GL thread, so it can own GL
+  // objects.
+  void setExternalTextureSource(UEXGLObjectId exglObjId, std::function<GLuint(void)> latchFrame);
+
+private:
+  std::unordered_map<UEXGLObjectId, std::function<GLuint(void)>> externalTextures;
+  std::vector<std::function<GLuint(void)>> releasedExternalTextures;
+  std::mutex externalTexturesMutex;
+
+  // [GL thread] Map `exglObjId` to the latest frame of its source, if it has one
+  void latchExternalTexture(UEXGLObjectId exglObjId) noexcept;
+
+  // [GL thread] Destroy the source of `exglObjId`, returns false if it has none.
+  // The GL texture belongs to the source then, it mustn't be deleted again.
+  bool removeExternalTexture(UEXGLObjectId exglObjId) noexcept;
+
+  // [GL thread] Destroy the sources that were replaced since the last flush
+  void releaseExternalTextures() noexcept;
+
+
+  // --- Recording -------------------------------------------------------------
+
+  // Frames rendered by JS can be fed to a video encoder without reading them
+  // back to JS. Native code attaches a sink (a MediaCodec input surface, an
+  // AVAssetWriter pixel buffer pool...), then `gl.startRecordingEXP()` hands it
+  // the recorded framebuffer on the GL thread at the end of every frame, until
+  // `gl.stopRecordingEXP()`. The sink copies the frame on the GPU.
+
+public:
+  // [Any thread] Send recorded frames to `sink`, or detach it if it's empty.
+  // The sink being replaced may still get the frame in progress.
+  void setFrameSink(UEXGLFrameSink sink);
+
+private:
+  std::shared_ptr<UEXGLFrameSink> frameSink;
+  std::mutex frameSinkMutex;
+
+  inline std::shared_ptr<UEXGLFrameSink> getFrameSink() noexcept {
+    std::lock_guard<decltype(frameSinkMutex)> lock(frameSinkMutex);
+    return frameSink;
+  }
+
+  // [GL thread] What `gl.startRecordingEXP()` asked for
+  struct {
+    UEXGLObjectId framebuffer = 0;
+    GLsizei width = 0;
+    GLsizei height = 0;
+    bool active = false;
+  } recording;
+
+  // [GL thread] Hand the frame that just ended to the sink
+  void recordFrame() noexcept;
+
+  // [GL thread] Tell the sink the recording is over
+  void stopRecording() noexcept;
+
+
+  // --- Immutable textures ----------------------------------------------------
+
+  // `texStorage2D` / `texStorage3D` allocate a texture's whole mip chain once
+  // and for all, so its shape is recorded by texture object on the JS thread.
+  // `getTexParameter` answers TEXTURE_IMMUTABLE_FORMAT / TEXTURE_IMMUTABLE_LEVELS
+  // from it, and sub-uploads into these textures are handed to GL as they are
+  // when there's nothing to flip or premultiply. `gl.texStorage2DLevelsEXP()`
+  // allocates a texture and fills its whole mip chain from one typed array in a
+  // single op.
+
+private:
+  struct TextureStorage {
+    GLsizei levels = 0;
+    GLenum internalformat = 0;
+    GLsizei width = 0;
+    GLsizei height = 0;
+    GLsizei depth = 0;
+  };
+
+  // [JS thread]
+  std::unordered_map<UEXGLObjectId, TextureStorage> textureStorages;
+
+public:
+  // [JS thread] Storage of the texture bound to `target`, null if it's mutable
+  inline const TextureStorage *boundTextureStorage(GLenum target) noexcept {
+    auto iter = textureStorages.find(residency.boundTexture(target));
+    return iter != textureStorages.end() ? &iter->second : nullptr;
+  }
+
+  // [JS thread] Whether a sub-upload to the texture bound to `target` skips the
+  // WebGL unpack pass
+  inline bool uploadsUnpacked(GLenum target) noexcept {
+    return !unpackFLipY && !unpackPremultiplyAlpha && boundTextureStorage(target);
+  }
+
+  inline void forgetTextureStorage(UEXGLObjectId exglObjId) noexcept {
+    textureStorages.erase(exglObjId);
+  }
+
+  // [JS thread] `texStorage2D` (`depth` is ignored) or `texStorage3D`
+  void addTexStorageToNextBatch(bool is3D, GLenum target, GLsizei levels, GLenum internalformat,
+                                GLsizei width, GLsizei height, GLsizei depth);
+
+  // [JS thread] `texStorage2D` followed by a `texSubImage2D` of every level
+  // (and every face of cube maps, +X -X +Y -Y +Z -Z) from `data`, which holds
+  // them tightly packed one after the other. Throws if `length` doesn't match.
+  void addTexStorageLevelsToNextBatch(GLenum target, GLsizei levels, GLenum internalformat,
+                                      GLsizei width, GLsizei height, GLenum format, GLenum type,
+                                      std::shared_ptr<void> data, size_t length);
+
+  // [JS thread] `getTexParameter` of the immutable texture parameters, returns
+  // false if `pname` isn't one
+  bool textureStorageParameter(GLenum target, GLenum pname, GLint *out) noexcept;
+
+  // [JS thread] Rasterize `text` (see EXGLTextRasterizer.h) and upload it as
+  // premultiplied RGBA / UNSIGNED_BYTE to `level` of the texture bound to
+  // `target`: with `texImage2D` sized to the text, or with `texSubImage2D` at
+  // `xoffset`, `yoffset` if `sub` is set. Rows are flipped with
+  // UNPACK_FLIP_Y_WEBGL. Returns the rasterized image, throws if it failed.
+  EXGLTextImage addTextImageToNextBatch(GLenum target, GLint level, bool sub,
+                                        GLint xoffset, GLint yoffset,
+                                        const std::string &text, const UEXGLTextStyle &style);
+
+
+  // --- Query cache -----------------------------------------------------------
+
+  // Programs are reflected on the GL thread right after they're linked, so that
+  // `getUniformLocation`, `getAttribLocation`, `getActiveUniform`... can be
+  // answered on the JS thread. Only a query made before the link got flushed has
+  // to wait for the GL thread. With `gl.enableDeferredErrorsEXP(true)`,
+  // `getError` returns the error seen at the end of the last flush instead.
+
+private:
+  struct ActiveInfo {
+    std::string name;
+    GLint size = 0;
+    GLenum type = 0;
+  };
+
+  struct ProgramInfo {
+    std::atomic<bool> ready { false };
+    GLint linkStatus = GL_FALSE;
+    std::vector<ActiveInfo> uniforms;
+    std::vector<ActiveInfo> attributes;
+    std::unordered_map<std::string, GLint> uniformLocations;
+    std::unordered_map<std::string, GLint> attribLocations;
+  };
+
+  // [JS thread] Filled in on the GL thread, readable once `ready` is set
+  std::unordered_map<UEXGLObjectId, std::shared_ptr<ProgramInfo>> programInfos;
+
+  // [JS thread] Last `COMPILE_STATUS` seen for a shader since its last compile
+  std::unordered_map<UEXGLObjectId, GLint> shaderCompileStatus;
+
+  std::atomic<bool> deferredErrors { false };
+  std::atomic<GLenum> deferredError { GL_NO_ERROR };
+
+  // [GL thread] Read back everything the query cache needs about a linked program
+  static void reflectProgram(GLuint program, ProgramInfo &info) noexcept;
+
+  // [JS thread] Reflection of a program, waits for its link if it's still queued.
+  // Returns nullptr if the program was never linked.
+  ProgramInfo *programInfo(UEXGLObjectId exglObjId);
+
+  // [JS thread] Hash of the last source given to each shader, of the shaders
+  // attached to each program and of its attribute bindings and transform
+  // feedback varyings: the key of its binary in EXGLProgramCache
+  std::unordered_map<UEXGLObjectId, uint64_t> shaderSourceHashes;
+  std::unordered_map<UEXGLObjectId, std::vector<UEXGLObjectId>> programShaders;
+  std::unordered_map<UEXGLObjectId, uint64_t> programBindingHashes;
+
+  // [JS thread] Set on the GL thread once the compile queued last ran
+  std::unordered_map<UEXGLObjectId, std::shared_ptr<std::atomic<bool>>> shaderCompiles;
+
+  inline void noteShaderSource(UEXGLObjectId fShader, const char *source, size_t length) noexcept {
+    shaderSourceHashes[fShader] = EXGLProgramCache::hash(source, length);
+  }
+
+  inline void noteAttachShader(UEXGLObjectId fProgram, UEXGLObjectId fShader) {
+    auto &shaders = programShaders[fProgram];
+    if (std::find(shaders.begin(), shaders.end(), fShader) == shaders.end()) {
+      shaders.push_back(fShader);
+    }
+  }
+
+  inline void noteDetachShader(UEXGLObjectId fProgram, UEXGLObjectId fShader) {
+    auto &shaders = programShaders[fProgram];
+    shaders.erase(std::remove(shaders.begin(), shaders.end(), fShader), shaders.end());
+  }
+
+  inline void noteProgramBinding(UEXGLObjectId fProgram, const void *data, size_t byteLength) noexcept {
+    auto iter = programBindingHashes.find(fProgram);
+    uint64_t seed = iter == programBindingHashes.end() ? EXGLProgramCache::hash(nullptr, 0) : iter->second;
+    programBindingHashes[fProgram] = EXGLProgramCache::hash(data, byteLength, seed);
+  }
+
+  inline void forgetProgramSources(UEXGLObjectId fProgram) noexcept {
+    programShaders.erase(fProgram);
+    programBindingHashes.erase(fProgram);
+  }
+
+  // [JS thread] Key of the program's binary in EXGLProgramCache, 0 if it isn't
+  // cacheable (cache disabled, a shader's source unknown)
+  uint64_t programCacheKey(UEXGLObjectId fProgram);
+
+public:
+  // [JS thread] Queue a link of `fProgram` that loads its cached binary if
+  // there's one, and saves it otherwise
+  void addLinkProgramToNextBatch(UEXGLObjectId fProgram);
+
+  // [JS thread] Queue a compile of `fShader`
+  void addCompileShaderToNextBatch(UEXGLObjectId fShader);
+
+  // [JS thread] KHR_parallel_shader_compile's COMPLETION_STATUS_KHR: whether
+  // the last link or compile queued ran, without waiting for it. Sends the
+  // 'next' batch to the GL thread if it's still in there, so that polling
+  // eventually returns true.
+  bool programCompletionStatus(UEXGLObjectId fProgram);
+  bool shaderCompletionStatus(UEXGLObjectId fShader);
+
+private:
+
+  // [JS thread] WebGL extensions the GL context can back, queried once
+  std::vector<const EXGLCompressedTextureExtension *> supportedExtensions;
+  bool supportedExtensionsKnown = false;
+  const std::vector<const EXGLCompressedTextureExtension *> &getSupportedExtensionList();
+
+  inline JSValueRef makeActiveInfo(JSContextRef jsCtx, const char *name, GLint size, GLenum type) {
+    JSObjectRef jsResult = JSObjectMake(jsCtx, nullptr, nullptr);
+    EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "name",
+                                          EXJSValueMakeStringFromUTF8CString(jsCtx, name));
+    EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "size", JSValueMakeNumber(jsCtx, size));
+    EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "type", JSValueMakeNumber(jsCtx, type));
+    return jsResult;
+  }
+
+
+  // --- Frame stats -----------------------------------------------------------
+
+  // Counters for one `endFrameEXP` worth of work, enabled with
+  // `gl.enableFrameStatsEXP(true)` and read with `gl.getFrameStatsEXP()`. Only
+  // the timers depend on the flag, the counters are always kept since they're
+  // plain increments on the JS thread.
+
+public:
+  // Order of the values in the Float64Array returned by `getFrameStatsEXP`
+  enum FrameStat {
+    FrameStatOps,           // commands sent to the GL thread
+    FrameStatBytesCopied,   // bytes copied out of TypedArrays for later ops
+    FrameStatBlockingCalls, // queries that waited for the GL thread
+    FrameStatBlockedMs,     // JS thread time spent waiting for the GL thread
+    FrameStatFlushMs,       // GL thread time spent in `flush()`
+    FrameStatBacklogDepth,  // batches waiting for the GL thread at the end of the frame
+    FrameStatResidentBytes, // estimated GPU memory held by the context's objects
+    FrameStatTextureBytes,  // ... by its textures
+    FrameStatBufferBytes,   // ... by its buffers
+    FrameStatRenderbufferBytes, // ... by its renderbuffers
+    FrameStatContextLost,   // 1 once the context is lost
+    FrameStatCount,
+  };
+
 private:
-  void installMethods(JSContextRef jsCtx);
-  void installConstants(JSContextRef jsCtx);
+  // [JS thread]
+  struct FrameStats {
+    size_t ops = 0;
+    size_t bytesCopied = 0;
+    size_t blockingCalls = 0;
+    std::chrono::steady_clock::duration blocked { 0 };
+  };
+  FrameStats frameStats;
+  double lastFrameStats[FrameStatCount] = {};
+
+  std::atomic<bool> frameStatsEnabled { false };
+  // [GL thread] Added to by `flush()`, taken by the JS thread at the end of a frame
+  std::atomic<int64_t> flushNanoseconds { 0 };
+
+  struct BlockedTimer {
+    EXGLContext &context;
+    // Read once, the stats can be toggled while the call blocks
+    const bool timed;
+    std::chrono::steady_clock::time_point start;
+
+    BlockedTimer(EXGLContext &context) : context(context), timed(context.frameStatsEnabled) {
+      ++context.frameStats.blockingCalls;
+      if (timed) {
+        start = std::chrono::steady_clock::now();
+      }
+    }
+
+    ~BlockedTimer() {
+      if (timed) {
+        context.frameStats.blocked += std::chrono::steady_clock::now() - start;
+      }
+    }
+  };
+
+  // [JS thread] Record the stats of the frame that just ended and start over
+  void endFrameStats() noexcept;
+
+
+  // --- Tracing ---------------------------------------------------------------
+
+  // Records the batches sent to the GL thread to a file, between
+  // `gl.startTraceEXP(path)` and `gl.stopTraceEXP()`, for the replay tool (see
+  // EXGLTrace.h). Objects created before the trace starts are unknown to the
+  // replay, so traces should start before the scene is set up.
+
+private:
+  // [JS thread]
+  std::unique_ptr<EXGLTraceWriter> trace;
+
+public:
+  // [JS thread] Throws if `path` can't be written
+  void startTrace(const std::string &path) {
+    // Ops already queued aren't in the trace, send them first
+    if (!nextBatch.empty()) {
+      endNextBatch(true);
+    }
+    trace.reset(new EXGLTraceWriter(path));
+  }
+
+  // [JS thread] Waits for the trace to be written, returns its size in bytes
+  size_t stopTrace() noexcept {
+    if (!trace) {
+      return 0;
+    }
+    if (!nextBatch.empty()) {
+      endNextBatch(true);
+    }
+    size_t bytesWritten = trace->finish();
+    trace.reset();
+    return bytesWritten;
+  }
+
+private:
+  // [JS thread] Describe the closure just added to the 'next' batch so that it
+  // can be replayed, when tracing
+  inline void traceLastClosure(EXGLTraceEvent event, std::initializer_list<double> args,
+                               const void *data = nullptr, size_t byteLength = 0) {
+    if (trace) {
+      trace->annotate(nextBatch.closureCount() - 1, event, args, data, byteLength);
+    }
+  }
+
+
+  // --- Residency -------------------------------------------------------------
+
+  // Estimate of the GPU memory held by the context's objects (see
+  // EXGLResidency.h), reported with the frame stats. `gl.setResidencyBudgetEXP()`
+  // sets a budget; at the end of a frame spent over it the least recently used
+  // objects are handed to JS, which decides what to delete.
+  //
+  // The platform reports context loss with `UEXGLContextSetContextLost()`, all
+  // the objects are then gone and the estimate starts over from zero.
+
+public:
+  // [JS thread]
+  EXGLResidency residency;
+
+  // [Any thread]
+  std::atomic<bool> contextLost { false };
+
+  // [GL thread] Account for an image whose size is only known once decoded
+  void reportTextureImage(UEXGLObjectId exglObjId, GLenum target, GLint level, size_t bytes) {
+    std::lock_guard<std::mutex> lock(residencyReportsMutex);
+    residencyReports.push_back({ exglObjId, target, level, bytes });
+  }
+
+  // [JS thread] Bytes of an image upload, 0 if the format is unknown
+  static inline size_t imageBytes(GLenum internalformat, GLenum format, GLenum type,
+                                  GLsizei width, GLsizei height, GLsizei depth = 1) noexcept {
+    return EXGLResidency::bytesPerTexel(internalformat, format, type) *
+      (size_t) std::max(width, 0) * (size_t) std::max(height, 0) * (size_t) std::max(depth, 0);
+  }
+
+private:
+  struct ResidencyReport {
+    UEXGLObjectId exglObjId;
+    GLenum target;
+    GLint level;
+    size_t bytes;
+  };
+  std::vector<ResidencyReport> residencyReports;
+  std::mutex residencyReportsMutex;
+
+  // [JS thread] Called with the eviction candidates as a Uint32Array of objects
+  // and the estimated total in bytes, protected while set
+  JSObjectRef jsResidencyCallback = nullptr;
+
+public:
+  // [JS thread] `bytes` 0 for no budget, `jsCallback` may be null
+  void setResidencyBudget(JSContextRef jsCtx, size_t bytes, JSObjectRef jsCallback) noexcept;
+
+  // [JS thread] Apply the reports of the GL thread, forget everything if the
+  // context got lost and call the eviction callback when over budget
+  void endFrameResidency(JSContextRef jsCtx) noexcept;
+
+
+private:
+  // [Any thread] The class of all `jsGl` objects, created once. Its static
+  // functions and values are the WebGL methods and constants, so a new
+  // context doesn't set hundreds of properties (and create a `JSStringRef`
+  // for each). JSC creates the function objects lazily and caches them on
+  // the object on first access. Assigning to a method or constant shadows it
+  // on that object only, like the plain properties that this replaces.
+  static JSClassRef getJSClass();
+  static void installMethods(std::vector<JSStaticFunction> &staticFunctions);
+  static void installConstants(std::vector<JSStaticValue> &staticValues);
 
   // Utilities
   static inline void jsThrow(JSContextRef jsCtx, const char *msg, JSValueRef *jsException) {
@@ -285,6 +1228,22 @@ private:
     return (char *) 0 + offset;
   }
 
+  static inline size_t typedArrayElementSize(JSTypedArrayType type) noexcept {
+    switch (type) {
+      case kJSTypedArrayTypeInt16Array:
+      case kJSTypedArrayTypeUint16Array:
+        return 2;
+      case kJSTypedArrayTypeInt32Array:
+      case kJSTypedArrayTypeUint32Array:
+      case kJSTypedArrayTypeFloat32Array:
+        return 4;
+      case kJSTypedArrayTypeFloat64Array:
+        return 8;
+      default:
+        return 1;
+    }
+  }
+
   static inline GLuint bytesPerPixel(GLenum type, GLenum format) {
     int bytesPerComponent = 0;
     switch (type) {
@@ -317,37 +1276,34 @@ private:
     return 0;
   }
 
-  static inline void flipPixels(GLubyte *pixels, size_t bytesPerRow, size_t rows) {
+  // Bytes an upload of `depth` images reads from client memory. EXGL keeps the
+  // default UNPACK_ALIGNMENT of 4, every row but the last one is padded to it.
+  static inline size_t unpackedImageBytes(GLsizei width, GLsizei height, GLsizei depth,
+                                          GLenum format, GLenum type) noexcept {
+    size_t rows = (size_t) std::max(height, 0) * (size_t) std::max(depth, 0);
+    size_t bytesPerRow = (size_t) std::max(width, 0) * bytesPerPixel(type, format);
+    if (rows == 0 || bytesPerRow == 0) {
+      return 0;
+    }
+    return (rows - 1) * ((bytesPerRow + 3) & ~(size_t) 3) + bytesPerRow;
+  }
+
+  // Apply `UNPACK_FLIP_Y_WEBGL` and `UNPACK_PREMULTIPLY_ALPHA_WEBGL` to the
+  // `depth` layers of an upload in place. Only RGBA8 data is premultiplied.
+  static inline void unpackPixels(void *pixels, GLsizei width, GLsizei height, GLsizei depth,
+                                  GLenum format, GLenum type, bool flipY, bool premultiplyAlpha) {
     if (!pixels) {
       return;
     }
-
-    GLuint middle = (GLuint)rows / 2;
-    GLuint intsPerRow = (GLuint)bytesPerRow / sizeof(GLuint);
-    GLuint remainingBytes = (GLuint)bytesPerRow - intsPerRow * sizeof(GLuint);
-
-    for (GLuint rowTop = 0, rowBottom = (GLuint)rows - 1; rowTop < middle; ++rowTop, --rowBottom) {
-      // Swap in packs of sizeof(GLuint) bytes
-      GLuint *iTop = (GLuint *) (pixels + rowTop * bytesPerRow);
-      GLuint *iBottom = (GLuint *) (pixels + rowBottom * bytesPerRow);
-      GLuint iTmp;
-      GLuint n = intsPerRow;
-      do {
-        iTmp = *iTop;
-        *iTop++ = *iBottom;
-        *iBottom++ = iTmp;
-      } while(--n > 0);
-
-      // Swap remainder bytes
-      GLubyte *bTop = (GLubyte *) iTop;
-      GLubyte *bBottom = (GLubyte *) iBottom;
-      GLubyte bTmp;
-      switch (remainingBytes) {
-        case 3: bTmp = *bTop; *bTop++ = *bBottom; *bBottom++ = bTmp;
-        case 2: bTmp = *bTop; *bTop++ = *bBottom; *bBottom++ = bTmp;
-        case 1: bTmp = *bTop; *bTop = *bBottom; *bBottom = bTmp;
+    size_t bytesPerRow = width * bytesPerPixel(type, format);
+    if (flipY) {
+      for (GLsizei z = 0; z < depth; ++z) {
+        EXGLFlipRows((GLubyte *) pixels + z * bytesPerRow * height, bytesPerRow, height);
       }
     }
+    if (premultiplyAlpha && format == GL_RGBA && type == GL_UNSIGNED_BYTE) {
+      EXGLPremultiplyAlpha((uint8_t *) pixels, (size_t) width * height * depth);
+    }
   }
 
 
@@ -362,7 +1318,15 @@ private:
       return;
     }
 #endif
+#ifdef __ANDROID__
+    // Newer JavaScriptCore builds export the C TypedArray API without shipping
+    // its header, the backing store can be read directly then
+    if (EXJSTypedArrayAPIAvailable()) {
+      return;
+    }
+#endif
 
+    // Every TypedArray goes through a conversion in JS and a fresh malloc
     JSContextPrepareTypedArrayAPI(jsCtx);
     usingTypedArrayHack = true;
   }
@@ -370,8 +1334,14 @@ private:
   inline std::shared_ptr<void> jsValueToSharedArray(JSContextRef jsCtx, JSValueRef jsVal,
                                                     size_t *pByteLength) noexcept {
     if (usingTypedArrayHack) {
-      return std::shared_ptr<void>(JSObjectGetTypedArrayDataMalloc(jsCtx, (JSObjectRef) jsVal,
-                                                                   pByteLength), free);
+      size_t byteLength = 0;
+      auto data = std::shared_ptr<void>(JSObjectGetTypedArrayDataMalloc(jsCtx, (JSObjectRef) jsVal,
+                                                                        &byteLength), free);
+      if (pByteLength) {
+        *pByteLength = byteLength;
+      }
+      frameStats.bytesCopied += byteLength;
+      return data;
     } else {
       void *data = nullptr;
       size_t byteLength = 0;
@@ -386,7 +1356,7 @@ private:
       } else if (type != kJSTypedArrayTypeNone) {
         byteLength = JSObjectGetTypedArrayByteLength(jsCtx, jsObject, nullptr);
         data = JSObjectGetTypedArrayBytesPtr(jsCtx, jsObject, nullptr);
-        byteOffset = JSObjectGetTypedArrayByteOffsetHack(jsCtx, jsObject);
+        byteOffset = JSObjectGetTypedArrayByteOffset(jsCtx, jsObject, nullptr);
       }
 
       if (pByteLength) {
@@ -398,9 +1368,118 @@ private:
       if (!data) {
         return std::shared_ptr<void>(nullptr);
       }
-      void *dataMalloc = malloc(byteLength);
-      memcpy(dataMalloc, ((char*) data) + byteOffset, byteLength);
-      return std::shared_ptr<void>(dataMalloc, free);
+      return stageCopy(((char*) data) + byteOffset, byteLength);
+    }
+  }
+
+  // [JS thread] Copy of the `byteLength` bytes an op reads from an
+  // ArrayBufferView starting `srcOffset` elements in, for WebGL2's `srcOffset`
+  // overloads: only the referenced bytes are copied, so uploading one layer of
+  // a large volume costs one layer. Null if `jsVal` isn't an ArrayBufferView,
+  // throws if the bytes run past its end.
+  inline std::shared_ptr<void> jsValueToSharedSubarray(JSContextRef jsCtx, JSValueRef jsVal,
+                                                       size_t srcOffset, size_t byteLength,
+                                                       const char *method) {
+    JSTypedArrayType type = JSValueGetTypedArrayType(jsCtx, jsVal, nullptr);
+    if (type == kJSTypedArrayTypeNone || type == kJSTypedArrayTypeArrayBuffer) {
+      return std::shared_ptr<void>(nullptr);
+    }
+    size_t byteOffset = srcOffset * typedArrayElementSize(type);
+    std::shared_ptr<void> copy;
+    withTypedArrayData(jsCtx, jsVal, [&](void *data, size_t length) {
+      if (!data || byteOffset > length || byteLength > length - byteOffset) {
+        throw std::runtime_error(std::string("EXGL: gl.") + method + "() reads past the end of srcData!");
+      }
+      copy = stageCopy((char *) data + byteOffset, byteLength);
+    });
+    return copy;
+  }
+
+  // [JS thread] Copy of `byteLength` bytes for an op, taken from the staging
+  // arena when it fits so that it's recycled with the batch instead of freed
+  // on the GL thread
+  inline std::shared_ptr<void> stageCopy(const void *data, size_t byteLength) {
+    frameStats.bytesCopied += byteLength;
+    auto copy = stagingArena.allocate(byteLength);
+    if (!copy) {
+      copy = std::shared_ptr<void>(malloc(byteLength), free);
+    }
+    memcpy(copy.get(), data, byteLength);
+    return copy;
+  }
+
+  // Call `f(data, byteLength)` with the contents of a TypedArray. `data` is only
+  // valid during the call, so this avoids an extra copy when the contents are
+  // immediately copied somewhere else (eg. into the command buffer).
+  template<typename F>
+  inline void withTypedArrayData(JSContextRef jsCtx, JSValueRef jsVal, F &&f) {
+    if (usingTypedArrayHack) {
+      size_t byteLength = 0;
+      auto data = std::shared_ptr<void>(JSObjectGetTypedArrayDataMalloc(jsCtx, (JSObjectRef) jsVal,
+                                                                        &byteLength), free);
+      f(data.get(), data ? byteLength : 0);
+      return;
+    }
+
+    void *data = nullptr;
+    size_t byteLength = 0;
+    JSObjectRef jsObject = (JSObjectRef) jsVal;
+    JSTypedArrayType type = JSValueGetTypedArrayType(jsCtx, jsVal, nullptr);
+    if (type == kJSTypedArrayTypeArrayBuffer) {
+      byteLength = JSObjectGetArrayBufferByteLength(jsCtx, jsObject, nullptr);
+      data = JSObjectGetArrayBufferBytesPtr(jsCtx, jsObject, nullptr);
+    } else if (type != kJSTypedArrayTypeNone) {
+      byteLength = JSObjectGetTypedArrayByteLength(jsCtx, jsObject, nullptr);
+      data = JSObjectGetTypedArrayBytesPtr(jsCtx, jsObject, nullptr);
+      if (data) {
+        data = ((char *) data) + JSObjectGetTypedArrayByteOffset(jsCtx, jsObject, nullptr);
+      }
+    }
+    f(data, data ? byteLength : 0);
+  }
+
+  // Like `jsValueToSharedArray` but doesn't copy: the TypedArray is protected
+  // from garbage collection and its backing store is handed out directly until
+  // the returned pointer is released. JS must not write to the array until the
+  // op that uses it has run. Falls back to copying when the TypedArray API hack
+  // is in use since there's no stable pointer to give out then.
+  inline std::shared_ptr<void> jsValueToPinnedArray(JSContextRef jsCtx, JSValueRef jsVal,
+                                                    size_t *pByteLength) noexcept {
+    if (usingTypedArrayHack) {
+      return jsValueToSharedArray(jsCtx, jsVal, pByteLength);
+    }
+
+    void *data = nullptr;
+    size_t byteLength = 0;
+    withTypedArrayData(jsCtx, jsVal, [&](void *bytes, size_t length) {
+      data = bytes;
+      byteLength = length;
+    });
+    if (pByteLength) {
+      *pByteLength = byteLength;
+    }
+    if (!data) {
+      return std::shared_ptr<void>(nullptr);
+    }
+
+    JSObjectRef jsObject = (JSObjectRef) jsVal;
+    JSValueProtect(jsCtx, jsObject);
+    return std::shared_ptr<void>(data, [this, jsObject](void *) {
+      // Usually runs on the GL thread, unprotecting has to wait for the JS thread
+      std::lock_guard<decltype(pinnedArraysMutex)> lock(pinnedArraysMutex);
+      pinnedArraysToRelease.push_back(jsObject);
+    });
+  }
+
+  // [JS thread] Unprotect the TypedArrays that aren't used by any op anymore
+  inline void releasePinnedArrays(JSContextRef jsCtx) noexcept {
+    std::vector<JSObjectRef> released;
+    {
+      std::lock_guard<decltype(pinnedArraysMutex)> lock(pinnedArraysMutex);
+      released.swap(pinnedArraysToRelease);
+    }
+    for (auto jsObject : released) {
+      JSValueUnprotect(jsCtx, jsObject);
     }
   }
 
@@ -432,6 +1511,32 @@ private:
   std::shared_ptr<void> loadImage(JSContextRef jsCtx, JSObjectRef jsPixels,
                                   int *fileWidth, int *fileHeight, int *fileComp);
 
+  // Same as `loadImage` but decodes off the JS thread, rows are already flipped
+  // if UNPACK_FLIP_Y_WEBGL is set
+  EXGLImageLoader::Future loadImageAsync(JSContextRef jsCtx, JSObjectRef jsPixels);
+
+  bool localPathFromImage(JSContextRef jsCtx, JSObjectRef jsPixels, std::string &path);
+
+  // `.width` and `.height` of an image source, 0 if missing
+  void imageSizeFromObject(JSContextRef jsCtx, JSObjectRef jsPixels, GLsizei *width, GLsizei *height);
+
+  // `{ fontFamily, fontSize, fontWeight, fontStyle, color, maxWidth, textAlign }`,
+  // missing members keep their defaults
+  UEXGLTextStyle textStyleFromObject(JSContextRef jsCtx, JSValueRef jsStyle);
+
+  // Largest upload `texImage2D` / `texSubImage2D` hand to GL in one call for
+  // mapped sources (see EXGLMappedImage.h), bigger ones are streamed in bands
+  // of rows. Set with `gl.setUploadBudgetEXP()`.
+  size_t uploadBudget = 4 * 1024 * 1024;
+
+  // [JS thread] Upload the file at `path` straight from a mapping if it's a KTX
+  // file or raw pixels of the `width` x `height` the source gave. Returns false
+  // if it's neither, it's then decoded as usual.
+  bool addMappedImageToNextBatch(const std::string &path, GLsizei width, GLsizei height,
+                                 GLenum target, GLint level, GLint internalformat,
+                                 GLenum format, GLenum type,
+                                 bool sub, GLint xoffset, GLint yoffset);
+
   void decodeURI(char *dst, const char *src) {
     char a, b;
     while (*src) {
@@ -515,12 +1620,7 @@ private:
       return JSValueMakeNull(jsCtx);
     }
 
-    JSObjectRef jsResult = JSObjectMake(jsCtx, nullptr, nullptr);
-    EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "name",
-                                          EXJSValueMakeStringFromUTF8CString(jsCtx, name.c_str()));
-    EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "size", JSValueMakeNumber(jsCtx, size));
-    EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "type", JSValueMakeNumber(jsCtx, type));
-    return jsResult;
+    return makeActiveInfo(jsCtx, name.c_str(), size, type);
   }
 
 
@@ -817,4 +1917,29 @@ private:
   // Exponent extensions
   _WRAP_METHOD_DECLARATION(endFrameEXP);
   _WRAP_METHOD_DECLARATION(flushEXP);
+  _WRAP_METHOD_DECLARATION(bufferDataNoCopyEXP);
+  _WRAP_METHOD_DECLARATION(bufferSubDataNoCopyEXP);
+  _WRAP_METHOD_DECLARATION(texImage2DNoCopyEXP);
+  _WRAP_METHOD_DECLARATION(readPixelsAsyncEXP);
+  _WRAP_METHOD_DECLARATION(enableStateCachingEXP);
+  _WRAP_METHOD_DECLARATION(enableDeferredErrorsEXP);
+  _WRAP_METHOD_DECLARATION(setBacklogPolicyEXP);
+  _WRAP_METHOD_DECLARATION(compressedTexImageKTXEXP);
+  _WRAP_METHOD_DECLARATION(enableFrameStatsEXP);
+  _WRAP_METHOD_DECLARATION(getFrameStatsEXP);
+  _WRAP_METHOD_DECLARATION(uniformBlockUpdateEXP);
+  _WRAP_METHOD_DECLARATION(updateExternalTextureEXP);
+  _WRAP_METHOD_DECLARATION(startTraceEXP);
+  _WRAP_METHOD_DECLARATION(stopTraceEXP);
+  _WRAP_METHOD_DECLARATION(getBufferSubDataAsyncEXP);
+  _WRAP_METHOD_DECLARATION(getFrameDeadlineEXP);
+  _WRAP_METHOD_DECLARATION(setResidencyBudgetEXP);
+  _WRAP_METHOD_DECLARATION(getResidencyCandidatesEXP);
+  _WRAP_METHOD_DECLARATION(multiDrawElementsEXP);
+  _WRAP_METHOD_DECLARATION(setUploadBudgetEXP);
+  _WRAP_METHOD_DECLARATION(startRecordingEXP);
+  _WRAP_METHOD_DECLARATION(stopRecordingEXP);
+  _WRAP_METHOD_DECLARATION(texStorage2DLevelsEXP);
+  _WRAP_METHOD_DECLARATION(texImage2DTextEXP);
+  _WRAP_METHOD_DECLARATION(texSubImage2DTextEXP);
 };
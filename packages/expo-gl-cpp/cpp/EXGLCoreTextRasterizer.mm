@@ -0,0 +1,110 @@
+#include <EXGL_CPP/EXGLTextRasterizer.h>
+
+#include <cmath>
+#include <cstdlib>
+
+#import <CoreGraphics/CoreGraphics.h>
+#import <CoreText/CoreText.h>
+
+void *EXGLCoreTextRasterize(const std::string &text, const UEXGLTextStyle &style,
+                            GLsizei *width, GLsizei *height, float *baseline) {
+  CFStringRef string = CFStringCreateWithBytes(kCFAllocatorDefault, (const UInt8 *) text.data(),
+                                               text.size(), kCFStringEncodingUTF8, false);
+  if (!string) {
+    return nullptr;
+  }
+
+  CTFontRef font = nullptr;
+  if (!style.fontFamily.empty()) {
+    CFStringRef family = CFStringCreateWithCString(kCFAllocatorDefault, style.fontFamily.c_str(),
+                                                   kCFStringEncodingUTF8);
+    if (family) {
+      font = CTFontCreateWithName(family, style.fontSize, nullptr);
+      CFRelease(family);
+    }
+  }
+  if (!font) {
+    font = CTFontCreateUIFontForLanguage(kCTFontUIFontSystem, style.fontSize, nullptr);
+  }
+  CTFontSymbolicTraits traits = (style.bold ? kCTFontTraitBold : 0) |
+                                (style.italic ? kCTFontTraitItalic : 0);
+  if (traits) {
+    // Null if the family has no such face, the regular one is used then
+    CTFontRef styledFont = CTFontCreateCopyWithSymbolicTraits(font, 0, nullptr, traits, traits);
+    if (styledFont) {
+      CFRelease(font);
+      font = styledFont;
+    }
+  }
+
+  CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+  CGFloat components[] = {
+    ((style.color >> 24) & 0xff) / 255.0,
+    ((style.color >> 16) & 0xff) / 255.0,
+    ((style.color >> 8) & 0xff) / 255.0,
+    (style.color & 0xff) / 255.0,
+  };
+  CGColorRef color = CGColorCreate(colorSpace, components);
+
+  CTTextAlignment alignment = style.align == 1 ? kCTTextAlignmentCenter
+                            : style.align == 2 ? kCTTextAlignmentRight : kCTTextAlignmentLeft;
+  CTParagraphStyleSetting setting = { kCTParagraphStyleSpecifierAlignment, sizeof(alignment), &alignment };
+  CTParagraphStyleRef paragraphStyle = CTParagraphStyleCreate(&setting, 1);
+
+  const void *keys[] = { kCTFontAttributeName, kCTForegroundColorAttributeName,
+                         kCTParagraphStyleAttributeName };
+  const void *values[] = { font, color, paragraphStyle };
+  CFDictionaryRef attributes = CFDictionaryCreate(kCFAllocatorDefault, keys, values, 3,
+                                                  &kCFTypeDictionaryKeyCallBacks,
+                                                  &kCFTypeDictionaryValueCallBacks);
+  CFAttributedStringRef attributedString = CFAttributedStringCreate(kCFAllocatorDefault, string,
+                                                                    attributes);
+  CFRelease(attributes);
+  CFRelease(paragraphStyle);
+  CFRelease(color);
+  CFRelease(font);
+  CFRelease(string);
+
+  CTFramesetterRef framesetter = CTFramesetterCreateWithAttributedString(attributedString);
+  CFRelease(attributedString);
+  CGSize constraints = CGSizeMake(style.maxWidth > 0 ? style.maxWidth : CGFLOAT_MAX, CGFLOAT_MAX);
+  CGSize size = CTFramesetterSuggestFrameSizeWithConstraints(framesetter, CFRangeMake(0, 0),
+                                                             nullptr, constraints, nullptr);
+  // Aligned lines are laid out across the whole wrapping width
+  GLsizei frameWidth = (GLsizei) ceil(style.maxWidth > 0 && style.align != 0 ? style.maxWidth
+                                                                              : size.width);
+  GLsizei frameHeight = (GLsizei) ceil(size.height);
+
+  void *pixels = nullptr;
+  if (frameWidth > 0 && frameHeight > 0) {
+    pixels = calloc((size_t) frameWidth * frameHeight, 4);
+  }
+  CGContextRef context = pixels ? CGBitmapContextCreate(pixels, frameWidth, frameHeight, 8,
+                                                        (size_t) frameWidth * 4, colorSpace,
+                                                        kCGImageAlphaPremultipliedLast |
+                                                            kCGBitmapByteOrder32Big)
+                                : nullptr;
+  if (context) {
+    CGPathRef path = CGPathCreateWithRect(CGRectMake(0, 0, frameWidth, frameHeight), nullptr);
+    CTFrameRef frame = CTFramesetterCreateFrame(framesetter, CFRangeMake(0, 0), path, nullptr);
+    CGPathRelease(path);
+    CTFrameDraw(frame, context);
+
+    // Line origins are from the bottom, the first row in memory is the top one
+    CGPoint origin = CGPointZero;
+    if (CFArrayGetCount(CTFrameGetLines(frame)) > 0) {
+      CTFrameGetLineOrigins(frame, CFRangeMake(0, 1), &origin);
+    }
+    *baseline = frameHeight - origin.y;
+    *width = frameWidth;
+    *height = frameHeight;
+    CFRelease(frame);
+    CGContextRelease(context);
+  } else {
+    free(pixels);
+    pixels = nullptr;
+  }
+  CFRelease(framesetter);
+  CGColorSpaceRelease(colorSpace);
+  return pixels;
+}
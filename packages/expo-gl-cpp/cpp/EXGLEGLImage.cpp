@@ -0,0 +1,231 @@
+#include "EXGLEGLImage.h"
+
+#ifdef __ANDROID__
+
+#include "EXGLContext.h"
+#include "EXGLSystrace.h"
+
+#include <GLES2/gl2ext.h>
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#ifndef GL_TEXTURE_BINDING_EXTERNAL_OES
+#define GL_TEXTURE_BINDING_EXTERNAL_OES 0x8D67
+#endif
+
+namespace {
+
+struct EGLImageAPI {
+  PFNEGLCREATEIMAGEKHRPROC createImage = nullptr;
+  PFNEGLDESTROYIMAGEKHRPROC destroyImage = nullptr;
+  PFNEGLCREATESYNCKHRPROC createSync = nullptr;
+  PFNEGLDESTROYSYNCKHRPROC destroySync = nullptr;
+  PFNEGLCLIENTWAITSYNCKHRPROC clientWaitSync = nullptr;
+  // EGL_KHR_wait_sync, null if the driver doesn't have it
+  PFNEGLWAITSYNCKHRPROC waitSync = nullptr;
+  PFNGLEGLIMAGETARGETTEXTURE2DOESPROC imageTargetTexture = nullptr;
+
+  EGLImageAPI() {
+    createImage = (PFNEGLCREATEIMAGEKHRPROC) eglGetProcAddress("eglCreateImageKHR");
+    destroyImage = (PFNEGLDESTROYIMAGEKHRPROC) eglGetProcAddress("eglDestroyImageKHR");
+    createSync = (PFNEGLCREATESYNCKHRPROC) eglGetProcAddress("eglCreateSyncKHR");
+    destroySync = (PFNEGLDESTROYSYNCKHRPROC) eglGetProcAddress("eglDestroySyncKHR");
+    clientWaitSync = (PFNEGLCLIENTWAITSYNCKHRPROC) eglGetProcAddress("eglClientWaitSyncKHR");
+    waitSync = (PFNEGLWAITSYNCKHRPROC) eglGetProcAddress("eglWaitSyncKHR");
+    imageTargetTexture = (PFNGLEGLIMAGETARGETTEXTURE2DOESPROC)
+      eglGetProcAddress("glEGLImageTargetTexture2DOES");
+  }
+
+  bool hasImages() const {
+    return createImage && destroyImage && imageTargetTexture;
+  }
+
+  bool hasFences() const {
+    return createSync && destroySync && clientWaitSync;
+  }
+};
+
+const EGLImageAPI &api() {
+  static const EGLImageAPI api;
+  return api;
+}
+
+// The display of every context of the app
+EGLDisplay display() {
+  return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+void destroyFence(EGLSyncKHR fence) {
+  if (fence != EGL_NO_SYNC_KHR && api().destroySync) {
+    api().destroySync(display(), fence);
+  }
+}
+
+// Latest EGLImage handed to EXGLEGLImageSetTexture for a texture, and the GL
+// texture it's bound into
+struct EGLImageSource {
+  std::mutex mutex;
+  EGLImageKHR pendingImage = EGL_NO_IMAGE_KHR;
+  GLenum pendingTarget = GL_TEXTURE_2D;
+  EGLSyncKHR pendingFence = EGL_NO_SYNC_KHR;
+
+  // [GL thread]
+  GLuint texture = 0;
+  GLenum target = GL_TEXTURE_2D;
+
+  // Destroyed on the GL thread (see `EXGLContext::setExternalTextureSource`)
+  ~EGLImageSource() {
+    releasePending();
+    if (texture != 0) {
+      glDeleteTextures(1, &texture);
+    }
+  }
+
+  void releasePending() {
+    if (pendingImage != EGL_NO_IMAGE_KHR) {
+      api().destroyImage(display(), pendingImage);
+      pendingImage = EGL_NO_IMAGE_KHR;
+    }
+    destroyFence(pendingFence);
+    pendingFence = EGL_NO_SYNC_KHR;
+  }
+
+  void setImage(EGLImageKHR image, GLenum imageTarget, EGLSyncKHR fence) {
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    // Never latched, only the latest image matters
+    releasePending();
+    pendingImage = image;
+    pendingTarget = imageTarget;
+    pendingFence = fence;
+  }
+
+  // [GL thread]
+  GLuint latchImage() {
+    EGLImageKHR image;
+    GLenum imageTarget;
+    EGLSyncKHR fence;
+    {
+      std::lock_guard<decltype(mutex)> lock(mutex);
+      image = pendingImage;
+      imageTarget = pendingTarget;
+      fence = pendingFence;
+      pendingImage = EGL_NO_IMAGE_KHR;
+      pendingFence = EGL_NO_SYNC_KHR;
+    }
+    if (image == EGL_NO_IMAGE_KHR) {
+      return 0;
+    }
+    EXGLSystraceSection section("EXGL latch EGLImage");
+
+    if (fence != EGL_NO_SYNC_KHR) {
+      EXGLEGLImageWaitFence(fence);
+    }
+    // A texture keeps its target forever
+    if (texture != 0 && target != imageTarget) {
+      glDeleteTextures(1, &texture);
+      texture = 0;
+    }
+    if (texture == 0) {
+      glGenTextures(1, &texture);
+      target = imageTarget;
+    }
+
+    GLint boundTexture = 0;
+    glGetIntegerv(target == GL_TEXTURE_EXTERNAL_OES ? GL_TEXTURE_BINDING_EXTERNAL_OES
+                                                    : GL_TEXTURE_BINDING_2D,
+                  &boundTexture);
+    glBindTexture(target, texture);
+    api().imageTargetTexture(target, (GLeglImageOES) image);
+    // Images aren't mipmapped and rarely a power of two
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(target, boundTexture);
+
+    // The texture is a sibling of the image now, it keeps the buffer alive
+    api().destroyImage(display(), image);
+    return texture;
+  }
+};
+
+}
+
+void EXGLEGLImageSetTexture(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId,
+                            EGLImageKHR image, GLenum target, UEXGLFence fence) {
+  // Sources stay owned by their context, this only finds them again
+  static std::mutex sourcesMutex;
+  static std::unordered_map<uint64_t, std::weak_ptr<EGLImageSource>> sources;
+
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (!exglCtx || (image != EGL_NO_IMAGE_KHR && !api().hasImages())) {
+    if (image != EGL_NO_IMAGE_KHR && api().destroyImage) {
+      EXGLSysLog("EXGL: Can't bind an EGLImage to a texture!");
+      api().destroyImage(display(), image);
+    }
+    destroyFence(fence);
+    return;
+  }
+  uint64_t key = ((uint64_t) exglCtxId << 32) | exglObjId;
+  std::lock_guard<decltype(sourcesMutex)> lock(sourcesMutex);
+  if (image == EGL_NO_IMAGE_KHR) {
+    destroyFence(fence);
+    sources.erase(key);
+    exglCtx->setExternalTextureSource(exglObjId, nullptr);
+    return;
+  }
+  auto source = sources[key].lock();
+  if (!source) {
+    source = std::make_shared<EGLImageSource>();
+    sources[key] = source;
+    exglCtx->setExternalTextureSource(exglObjId, [source] { return source->latchImage(); });
+  }
+  source->setImage(image, target, fence);
+}
+
+EGLImageKHR EXGLEGLImageExportTexture(GLuint texture) {
+  if (texture == 0 || !api().hasImages()) {
+    return EGL_NO_IMAGE_KHR;
+  }
+  const EGLint attribs[] = {
+    EGL_GL_TEXTURE_LEVEL_KHR, 0,
+    // Consumers see what EXGL drew, not undefined contents
+    EGL_IMAGE_PRESERVED_KHR, EGL_TRUE,
+    EGL_NONE,
+  };
+  EGLImageKHR image = api().createImage(eglGetCurrentDisplay(), eglGetCurrentContext(),
+                                        EGL_GL_TEXTURE_2D_KHR,
+                                        (EGLClientBuffer) (uintptr_t) texture, attribs);
+  if (image == EGL_NO_IMAGE_KHR) {
+    EXGLSysLog("EXGL: Couldn't export texture %u as an EGLImage (0x%x)!", texture, eglGetError());
+  }
+  return image;
+}
+
+EGLSyncKHR EXGLEGLImageCreateFence() {
+  if (!api().hasFences()) {
+    // Flushing is all other contexts can count on then
+    glFlush();
+    return EGL_NO_SYNC_KHR;
+  }
+  EGLSyncKHR fence = api().createSync(eglGetCurrentDisplay(), EGL_SYNC_FENCE_KHR, nullptr);
+  // Other contexts only see the fence signaled once it got to the GPU
+  glFlush();
+  return fence;
+}
+
+void EXGLEGLImageWaitFence(EGLSyncKHR fence) {
+  if (fence == EGL_NO_SYNC_KHR || !api().hasFences()) {
+    return;
+  }
+  if (!api().waitSync || !api().waitSync(display(), fence, 0)) {
+    // No GPU side wait, block until the producer's work is done
+    EXGLSystraceSection section("EXGL wait for fence");
+    api().clientWaitSync(display(), fence, 0, EGL_FOREVER_KHR);
+  }
+  api().destroySync(display(), fence);
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef __EXGLEGLIMAGE_H__
+#define __EXGLEGLIMAGE_H__
+
+#ifdef __ANDROID__
+
+#include <memory>
+
+#include "UEXGL.h"
+
+
+// --- EXGLEGLImage ------------------------------------------------------------
+
+// Shares textures with other EGL contexts and APIs of the app (camera and
+// video pipelines, image processing...) without copying them: EGLImages are
+// bound into EXGL textures, EXGL textures are exported as EGLImages, and EGL
+// fences synchronize the contexts writing and reading them. The
+// EGL_KHR_image_base, EGL_KHR_fence_sync and OES_EGL_image functions are
+// looked up at runtime, EGL_KHR_wait_sync is optional (fences are then waited
+// for on the CPU).
+
+// [Any thread] Feed `exglObjId` from EGLImages through its external texture
+// source (see `EXGLContext::setExternalTextureSource`), taking ownership of
+// `image` and `fence`. A null image detaches the texture from its images.
+void EXGLEGLImageSetTexture(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId,
+                            EGLImageKHR image, GLenum target, UEXGLFence fence);
+
+// [GL thread] EGLImage of level 0 of the GL texture `texture`, EGL_NO_IMAGE_KHR
+// if it couldn't be made
+EGLImageKHR EXGLEGLImageExportTexture(GLuint texture);
+
+// [GL thread] Fence the GL work issued so far and flush it, EGL_NO_SYNC_KHR if
+// fences aren't supported
+EGLSyncKHR EXGLEGLImageCreateFence();
+
+// [GL thread] Make the current context wait for `fence`, then destroy it
+void EXGLEGLImageWaitFence(EGLSyncKHR fence);
+
+#endif
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef __EXGLIMAGEIODECODER_H__
+#define __EXGLIMAGEIODECODER_H__
+
+#include <memory>
+
+#include "EXGLImageLoader.h"
+
+
+// --- EXGLImageIODecoder ------------------------------------------------------
+
+// Decodes images with ImageIO, whose codecs are much faster than stb_image on
+// large JPEGs and PNGs. Core Graphics only draws premultiplied RGBA, so images
+// with alpha requested without UNPACK_PREMULTIPLY_ALPHA_WEBGL are left to
+// stb_image, which keeps the exact colors of transparent pixels.
+
+// [Any thread]
+std::shared_ptr<EXGLImageDecoder> EXGLImageIODecoderCreate();
+
+#endif
@@ -0,0 +1,68 @@
+#include <EXGL_CPP/EXGLImageIODecoder.h>
+
+#include <cstdlib>
+
+#import <CoreGraphics/CoreGraphics.h>
+#import <ImageIO/ImageIO.h>
+
+namespace {
+
+class EXGLImageIODecoder : public EXGLImageDecoder {
+public:
+  EXGLImage decode(const std::string &path, bool flipY, bool premultiplyAlpha) override {
+    CFURLRef url = CFURLCreateFromFileSystemRepresentation(kCFAllocatorDefault,
+                                                           (const UInt8 *) path.c_str(),
+                                                           path.size(), false);
+    if (!url) {
+      return EXGLImage();
+    }
+    CGImageSourceRef source = CGImageSourceCreateWithURL(url, nullptr);
+    CFRelease(url);
+    if (!source) {
+      return EXGLImage();
+    }
+    CGImageRef cgImage = CGImageSourceCreateImageAtIndex(source, 0, nullptr);
+    CFRelease(source);
+    if (!cgImage) {
+      return EXGLImage();
+    }
+
+    EXGLImage image;
+    CGImageAlphaInfo alphaInfo = CGImageGetAlphaInfo(cgImage);
+    bool opaque = alphaInfo == kCGImageAlphaNone || alphaInfo == kCGImageAlphaNoneSkipFirst ||
+                  alphaInfo == kCGImageAlphaNoneSkipLast;
+    int width = (int) CGImageGetWidth(cgImage);
+    int height = (int) CGImageGetHeight(cgImage);
+    size_t stride = (size_t) width * 4;
+    std::shared_ptr<void> data(opaque || premultiplyAlpha ? malloc(stride * height) : nullptr, free);
+    if (data) {
+      CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+      CGContextRef context = CGBitmapContextCreate(data.get(), width, height, 8, stride, colorSpace,
+                                                   kCGImageAlphaPremultipliedLast |
+                                                       kCGBitmapByteOrder32Big);
+      CGColorSpaceRelease(colorSpace);
+      if (context) {
+        // The first row in memory is the top one, unless drawn upside down
+        if (flipY) {
+          CGContextTranslateCTM(context, 0, height);
+          CGContextScaleCTM(context, 1, -1);
+        }
+        // Replace the uninitialized pixels instead of blending over them
+        CGContextSetBlendMode(context, kCGBlendModeCopy);
+        CGContextDrawImage(context, CGRectMake(0, 0, width, height), cgImage);
+        CGContextRelease(context);
+        image.data = data;
+        image.width = width;
+        image.height = height;
+      }
+    }
+    CGImageRelease(cgImage);
+    return image;
+  }
+};
+
+} // namespace
+
+std::shared_ptr<EXGLImageDecoder> EXGLImageIODecoderCreate() {
+  return std::make_shared<EXGLImageIODecoder>();
+}
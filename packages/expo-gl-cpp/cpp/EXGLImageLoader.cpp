@@ -0,0 +1,189 @@
+#include "EXGLImageLoader.h"
+
+#include <sys/stat.h>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include "EXGLPixelKernels.h"
+#include "EXGLSystrace.h"
+#include "stb_image.h"
+
+#ifdef __ANDROID__
+#include "EXGLAImageDecoder.h"
+#endif
+#ifdef __APPLE__
+#include "EXGLImageIODecoder.h"
+#endif
+
+EXGLImageLoader &EXGLImageLoader::shared() {
+  // Never destroyed: the workers live as long as the process
+  static auto loader = new EXGLImageLoader();
+  return *loader;
+}
+
+EXGLImageLoader::EXGLImageLoader() {
+#ifdef __ANDROID__
+  if (auto decoder = EXGLAImageDecoderCreate()) {
+    decoders.push_back(decoder);
+  }
+#endif
+#ifdef __APPLE__
+  decoders.push_back(EXGLImageIODecoderCreate());
+#endif
+
+  unsigned int count = std::thread::hardware_concurrency();
+  count = count > 2 ? 2 : (count == 0 ? 1 : count);
+  for (unsigned int i = 0; i < count; ++i) {
+    workers.emplace_back(&EXGLImageLoader::workerLoop, this);
+    workers.back().detach();
+  }
+}
+
+EXGLImageLoader::Future EXGLImageLoader::load(const std::string &path, bool flipY,
+                                              bool premultiplyAlpha) {
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0) {
+    std::promise<EXGLImage> failed;
+    failed.set_value(EXGLImage());
+    return failed.get_future().share();
+  }
+
+  std::stringstream ss;
+  ss << path << '\n' << (long long) info.st_mtime << '\n' << flipY << premultiplyAlpha;
+  auto key = ss.str();
+
+  auto promise = std::make_shared<std::promise<EXGLImage>>();
+  Future future = promise->get_future().share();
+  {
+    std::lock_guard<decltype(cacheMutex)> lock(cacheMutex);
+    auto iter = cache.find(key);
+    if (iter != cache.end()) {
+      lru.splice(lru.begin(), lru, iter->second);
+      return iter->second->future;
+    }
+    lru.push_front(CacheEntry { key, future, 0 });
+    cache[key] = lru.begin();
+  }
+
+  {
+    std::lock_guard<decltype(queueMutex)> lock(queueMutex);
+    queue.push_back(Job { key, path, flipY, premultiplyAlpha, promise });
+  }
+  queueCondition.notify_one();
+  return future;
+}
+
+void EXGLImageLoader::addDecoder(std::shared_ptr<EXGLImageDecoder> decoder) {
+  std::lock_guard<decltype(decodersMutex)> lock(decodersMutex);
+  decoders.insert(decoders.begin(), std::move(decoder));
+}
+
+void EXGLImageLoader::purge() {
+  std::lock_guard<decltype(cacheMutex)> lock(cacheMutex);
+  lru.clear();
+  cache.clear();
+  cacheBytes = 0;
+}
+
+void EXGLImageLoader::setCacheBudget(size_t bytes) {
+  std::lock_guard<decltype(cacheMutex)> lock(cacheMutex);
+  cacheBudget = bytes;
+  trimCache();
+}
+
+void EXGLImageLoader::workerLoop() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<decltype(queueMutex)> lock(queueMutex);
+      queueCondition.wait(lock, [this] { return !queue.empty(); });
+      job = std::move(queue.front());
+      queue.pop_front();
+    }
+
+    EXGLImage image = decode(job.path, job.flipY, job.premultiplyAlpha);
+    size_t byteLength = (size_t) image.width * image.height * 4;
+    job.promise->set_value(image);
+
+    std::lock_guard<decltype(cacheMutex)> lock(cacheMutex);
+    auto iter = cache.find(job.key);
+    if (iter == cache.end()) {
+      // Purged while decoding
+      continue;
+    }
+    if (!image.data) {
+      // Don't remember failures, the file may become readable later
+      lru.erase(iter->second);
+      cache.erase(iter);
+      continue;
+    }
+    if (iter->second->byteLength == 0) {
+      iter->second->byteLength = byteLength;
+      cacheBytes += byteLength;
+    }
+    trimCache();
+  }
+}
+
+EXGLImage EXGLImageLoader::decode(const std::string &path, bool flipY, bool premultiplyAlpha) {
+  EXGLSystraceSection section("EXGL decode image");
+  std::vector<std::shared_ptr<EXGLImageDecoder>> decoders;
+  {
+    std::lock_guard<decltype(decodersMutex)> lock(decodersMutex);
+    decoders = this->decoders;
+  }
+  for (const auto &decoder : decoders) {
+    EXGLImage image = decoder->decode(path, flipY, premultiplyAlpha);
+    if (image.data) {
+      return image;
+    }
+  }
+  return decodeWithStb(path, flipY, premultiplyAlpha);
+}
+
+EXGLImage EXGLImageLoader::decodeWithStb(const std::string &path, bool flipY, bool premultiplyAlpha) {
+  EXGLImage image;
+  int comp = 0;
+  if (stbi_info(path.c_str(), &image.width, &image.height, &comp) && comp == 3) {
+    // Most photos, camera frames... expanding them is cheaper than stb's scalar
+    // conversion
+    std::shared_ptr<void> rgb(stbi_load(path.c_str(), &image.width, &image.height, &comp, STBI_rgb),
+                              stbi_image_free);
+    if (rgb) {
+      size_t pixelCount = (size_t) image.width * image.height;
+      image.data = std::shared_ptr<void>(malloc(pixelCount * 4), free);
+      EXGLExpandRGBToRGBA((const uint8_t *) rgb.get(), (uint8_t *) image.data.get(), pixelCount);
+    }
+  } else {
+    image.data = std::shared_ptr<void>(stbi_load(path.c_str(), &image.width, &image.height,
+                                                 &comp, STBI_rgb_alpha),
+                                       stbi_image_free);
+  }
+  if (!image.data) {
+    image.width = image.height = 0;
+    return image;
+  }
+
+  if (flipY) {
+    EXGLFlipRows(image.data.get(), (size_t) image.width * 4, image.height);
+  }
+  if (premultiplyAlpha && comp != 3) {
+    EXGLPremultiplyAlpha((uint8_t *) image.data.get(), (size_t) image.width * image.height);
+  }
+  return image;
+}
+
+void EXGLImageLoader::trimCache() {
+  auto iter = lru.end();
+  while (cacheBytes > cacheBudget && iter != lru.begin()) {
+    --iter;
+    if (iter->byteLength == 0) {
+      // Still decoding (or failed), nothing to reclaim
+      continue;
+    }
+    cacheBytes -= iter->byteLength;
+    cache.erase(iter->key);
+    iter = lru.erase(iter);
+  }
+}
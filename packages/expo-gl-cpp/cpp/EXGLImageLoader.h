@@ -0,0 +1,107 @@
+#ifndef __EXGLIMAGELOADER_H__
+#define __EXGLIMAGELOADER_H__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+// --- EXGLImageLoader ---------------------------------------------------------
+
+// Decodes `{ localUri }` texture sources to RGBA8 on a small pool of worker
+// threads so that `texImage2D` doesn't block the JS thread. Decoded images are
+// kept in a cache keyed by path and modification time (and whether the rows were
+// flipped and the alpha premultiplied), so loading the same file again, eg. when a GLView is remounted,
+// skips decoding entirely. The cache is shared by all EXGL contexts.
+
+struct EXGLImage {
+  std::shared_ptr<void> data; // RGBA8, null if decoding failed
+  int width = 0;
+  int height = 0;
+};
+
+// A decoder of image files, eg. backed by the platform's codecs which are much
+// faster than stb_image on large JPEGs and PNGs. Decoders are tried in turn,
+// stb_image being the fallback for anything they don't handle.
+class EXGLImageDecoder {
+public:
+  virtual ~EXGLImageDecoder() = default;
+
+  // [Worker thread] Decode the image at `path` to tightly packed RGBA8 rows,
+  // the bottom row first if `flipY` is set, with colors multiplied by alpha
+  // if `premultiplyAlpha` is. Return an image without data to let the next
+  // decoder try, eg. for formats or options it doesn't support.
+  virtual EXGLImage decode(const std::string &path, bool flipY, bool premultiplyAlpha) = 0;
+};
+
+class EXGLImageLoader {
+public:
+  using Future = std::shared_future<EXGLImage>;
+
+  static EXGLImageLoader &shared();
+
+  // [Any thread] Decode the image at `path`, flipping rows if `flipY` is set and
+  // multiplying colors by alpha if `premultiplyAlpha` is. Returns a cached result
+  // when the file hasn't changed.
+  Future load(const std::string &path, bool flipY, bool premultiplyAlpha);
+
+  // [Any thread] Decode the image at `path` right away, without the cache
+  EXGLImage decode(const std::string &path, bool flipY, bool premultiplyAlpha);
+
+  // [Any thread] Try `decoder` before the ones added earlier, the platform's
+  // decoder (if any) is added first
+  void addDecoder(std::shared_ptr<EXGLImageDecoder> decoder);
+
+  // [Any thread] Drop every cached image
+  void purge();
+
+  // Maximum number of bytes of decoded pixels kept in the cache
+  void setCacheBudget(size_t bytes);
+
+private:
+  EXGLImageLoader();
+
+  struct Job {
+    std::string key;
+    std::string path;
+    bool flipY;
+    bool premultiplyAlpha;
+    std::shared_ptr<std::promise<EXGLImage>> promise;
+  };
+
+  struct CacheEntry {
+    std::string key;
+    Future future;
+    size_t byteLength = 0; // 0 until decoded
+  };
+
+  void workerLoop();
+  static EXGLImage decodeWithStb(const std::string &path, bool flipY, bool premultiplyAlpha);
+
+  // [Any thread, cacheMutex held] Evict the least recently used images over budget
+  void trimCache();
+
+  std::mutex queueMutex;
+  std::condition_variable queueCondition;
+  std::deque<Job> queue;
+  std::vector<std::thread> workers;
+
+  std::mutex decodersMutex;
+  std::vector<std::shared_ptr<EXGLImageDecoder>> decoders; // most recently added first
+
+  std::mutex cacheMutex;
+  std::list<CacheEntry> lru; // most recently used first
+  std::unordered_map<std::string, std::list<CacheEntry>::iterator> cache;
+  size_t cacheBytes = 0;
+  size_t cacheBudget = 64 * 1024 * 1024;
+};
+
+#endif
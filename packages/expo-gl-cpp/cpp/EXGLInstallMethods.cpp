@@ -1,10 +1,10 @@
 #include "EXGLContext.h"
 
 #define _INSTALL_METHOD(name)                                                       \
-  EXJSObjectSetFunctionWithUTF8CStringName(jsCtx, jsGl, #name,                      \
-                                         &EXGLContext::exglNativeStatic_##name)
+  staticFunctions.push_back({#name, &EXGLContext::exglNativeStatic_##name,         \
+                             kJSPropertyAttributeNone})
 
-void EXGLContext::installMethods(JSContextRef jsCtx) {
+void EXGLContext::installMethods(std::vector<JSStaticFunction> &staticFunctions) {
   // This listing follows the order in
   // https://developer.mozilla.org/en-US/docs/Web/API/WebGLRenderingContext
 
@@ -282,4 +282,29 @@ void EXGLContext::installMethods(JSContextRef jsCtx) {
   // Exponent extensions
   _INSTALL_METHOD(endFrameEXP);
   _INSTALL_METHOD(flushEXP);
+  _INSTALL_METHOD(bufferDataNoCopyEXP);
+  _INSTALL_METHOD(bufferSubDataNoCopyEXP);
+  _INSTALL_METHOD(texImage2DNoCopyEXP);
+  _INSTALL_METHOD(readPixelsAsyncEXP);
+  _INSTALL_METHOD(enableStateCachingEXP);
+  _INSTALL_METHOD(enableDeferredErrorsEXP);
+  _INSTALL_METHOD(setBacklogPolicyEXP);
+  _INSTALL_METHOD(compressedTexImageKTXEXP);
+  _INSTALL_METHOD(enableFrameStatsEXP);
+  _INSTALL_METHOD(getFrameStatsEXP);
+  _INSTALL_METHOD(uniformBlockUpdateEXP);
+  _INSTALL_METHOD(updateExternalTextureEXP);
+  _INSTALL_METHOD(startTraceEXP);
+  _INSTALL_METHOD(stopTraceEXP);
+  _INSTALL_METHOD(getBufferSubDataAsyncEXP);
+  _INSTALL_METHOD(getFrameDeadlineEXP);
+  _INSTALL_METHOD(setResidencyBudgetEXP);
+  _INSTALL_METHOD(getResidencyCandidatesEXP);
+  _INSTALL_METHOD(multiDrawElementsEXP);
+  _INSTALL_METHOD(setUploadBudgetEXP);
+  _INSTALL_METHOD(startRecordingEXP);
+  _INSTALL_METHOD(stopRecordingEXP);
+  _INSTALL_METHOD(texStorage2DLevelsEXP);
+  _INSTALL_METHOD(texImage2DTextEXP);
+  _INSTALL_METHOD(texSubImage2DTextEXP);
 }
@@ -0,0 +1,3216 @@
+#include "EXGLJsiContext.h"
+
+#include "EXGLRenderPool.h"
+
+namespace jsi = facebook::jsi;
+
+// Method wrapper, run on JS thread, same checks as `_WRAP_METHOD` in
+// EXGLNativeMethods.cpp
+#define _JSI_METHOD_INTERNAL(name, minArgc, requiresWebGL2)                                             \
+  jsi::Value EXGLJsiContext::jsiStatic_##name(jsi::Runtime &runtime,                                    \
+                                              UEXGLContextId exglCtxId,                                 \
+                                              const jsi::Value *args,                                   \
+                                              size_t argc)                                              \
+  {                                                                                                     \
+    auto exglCtx = EXGLContext::ContextGet(exglCtxId);                                                  \
+    if (!exglCtx) {                                                                                     \
+      return jsi::Value::undefined();                                                                   \
+    }                                                                                                   \
+    try {                                                                                               \
+      if (argc < minArgc) {                                                                             \
+        throw std::runtime_error("EXGL: Too few arguments to " #name "()!");                            \
+      }                                                                                                 \
+      if (requiresWebGL2 && !exglCtx->supportsWebGL2) {                                                 \
+        throw std::runtime_error("EXGL: This device doesn't support WebGL2 method: " #name "()!");      \
+      }                                                                                                 \
+      return EXGLJsiContext(*exglCtx, runtime).name(args, argc);                                        \
+    } catch (const jsi::JSIException &) {                                                               \
+      /* already a JS error (a callback threw...), keep its value and stack */                          \
+      throw;                                                                                            \
+    } catch (const std::exception &e) {                                                                 \
+      throw jsi::JSError(runtime, e.what());                                                            \
+    }                                                                                                   \
+  }                                                                                                     \
+  jsi::Value EXGLJsiContext::name(const jsi::Value *args, size_t argc)
+
+#define _JSI_METHOD(name, minArgc) _JSI_METHOD_INTERNAL(name, minArgc, false)
+#define _JSI_WEBGL2_METHOD(name, minArgc) _JSI_METHOD_INTERNAL(name, minArgc, true)
+
+#define _JSI_UNPACK_ARGS(...) _JSI_UNPACK_ARGS_OFFSET(0, __VA_ARGS__)
+#define _JSI_UNPACK_ARGS_OFFSET(OFFSET, ...) \
+  EXJS_MAP_EXT(OFFSET, _EXJS_LITERAL(;), _JSI_UNPACK_NUMBER, __VA_ARGS__)
+#define _JSI_UNPACK_NUMBER(INDEX, NAME) NAME = number(args[INDEX])
+
+  // Wrapper that takes only scalar arguments and returns nothing
+#define _JSI_METHOD_SIMPLE_INTERNAL(name, isWebGL2Method, glFunc, ...)  \
+  _JSI_METHOD_INTERNAL(name, EXJS_ARGC(__VA_ARGS__), isWebGL2Method) {  \
+    ctx.addCallToNextBatch(glFunc, EXJS_MAP_EXT(0, _EXJS_COMMA, _JSI_METHOD_SIMPLE_UNPACK, __VA_ARGS__)); \
+    return jsi::Value::undefined();                                     \
+  }
+#define _JSI_METHOD_SIMPLE(name, glFunc, ...) _JSI_METHOD_SIMPLE_INTERNAL(name, false, glFunc, __VA_ARGS__)
+#define _JSI_WEBGL2_METHOD_SIMPLE(name, glFunc, ...) _JSI_METHOD_SIMPLE_INTERNAL(name, true, glFunc, __VA_ARGS__)
+
+#define _JSI_METHOD_SIMPLE_UNPACK(i, _) number(args[i])
+
+  // Like `_JSI_METHOD_SIMPLE` but the call is dropped if it wouldn't change
+  // `slot` in the shadow state
+#define _JSI_METHOD_SIMPLE_SHADOWED(name, glFunc, slot, ...)            \
+  _JSI_METHOD(name, EXJS_ARGC(__VA_ARGS__)) {                           \
+    const double values[] = { EXJS_MAP_EXT(0, _EXJS_COMMA, _JSI_METHOD_SIMPLE_UNPACK, __VA_ARGS__) }; \
+    if (ctx.shadowState.update(EXGLShadowState::slot, values, EXJS_ARGC(__VA_ARGS__))) { \
+      ctx.addCallToNextBatch(glFunc, EXJS_MAP_EXT(0, _EXJS_COMMA, _JSI_METHOD_SHADOWED_ARG, __VA_ARGS__)); \
+    }                                                                   \
+    return jsi::Value::undefined();                                     \
+  }
+
+#define _JSI_METHOD_SHADOWED_ARG(i, _) values[i]
+
+
+// Installation
+// ------------
+
+#define _JSI_INSTALL_METHOD(name)                                                         \
+  jsGl.setProperty(runtime, #name, jsi::Function::createFromHostFunction(                \
+    runtime, jsi::PropNameID::forAscii(runtime, #name), 0,                                \
+    [exglCtxId](jsi::Runtime &runtime, const jsi::Value &, const jsi::Value *args, size_t argc) { \
+      return jsiStatic_##name(runtime, exglCtxId, args, argc);                            \
+    }))
+
+UEXGLContextId EXGLJsiContext::install(jsi::Runtime &runtime) {
+  UEXGLContextId exglCtxId = EXGLContext::ContextCreate();
+  if (exglCtxId == 0) {
+    return 0;
+  }
+
+  jsi::Object jsGl(runtime);
+
+  // The WebGL context
+  _JSI_INSTALL_METHOD(getContextAttributes);
+  _JSI_INSTALL_METHOD(isContextLost);
+
+  // Viewing and clipping
+  _JSI_INSTALL_METHOD(scissor);
+  _JSI_INSTALL_METHOD(viewport);
+
+  // State information
+  _JSI_INSTALL_METHOD(activeTexture);
+  _JSI_INSTALL_METHOD(blendColor);
+  _JSI_INSTALL_METHOD(blendEquation);
+  _JSI_INSTALL_METHOD(blendEquationSeparate);
+  _JSI_INSTALL_METHOD(blendFunc);
+  _JSI_INSTALL_METHOD(blendFuncSeparate);
+  _JSI_INSTALL_METHOD(clearColor);
+  _JSI_INSTALL_METHOD(clearDepth);
+  _JSI_INSTALL_METHOD(clearStencil);
+  _JSI_INSTALL_METHOD(colorMask);
+  _JSI_INSTALL_METHOD(cullFace);
+  _JSI_INSTALL_METHOD(depthFunc);
+  _JSI_INSTALL_METHOD(depthMask);
+  _JSI_INSTALL_METHOD(depthRange);
+  _JSI_INSTALL_METHOD(disable);
+  _JSI_INSTALL_METHOD(enable);
+  _JSI_INSTALL_METHOD(frontFace);
+  _JSI_INSTALL_METHOD(getParameter);
+  _JSI_INSTALL_METHOD(getError);
+  _JSI_INSTALL_METHOD(hint);
+  _JSI_INSTALL_METHOD(isEnabled);
+  _JSI_INSTALL_METHOD(lineWidth);
+  _JSI_INSTALL_METHOD(pixelStorei);
+  _JSI_INSTALL_METHOD(polygonOffset);
+  _JSI_INSTALL_METHOD(sampleCoverage);
+  _JSI_INSTALL_METHOD(stencilFunc);
+  _JSI_INSTALL_METHOD(stencilFuncSeparate);
+  _JSI_INSTALL_METHOD(stencilMask);
+  _JSI_INSTALL_METHOD(stencilMaskSeparate);
+  _JSI_INSTALL_METHOD(stencilOp);
+  _JSI_INSTALL_METHOD(stencilOpSeparate);
+
+  // Buffers
+  _JSI_INSTALL_METHOD(bindBuffer);
+  _JSI_INSTALL_METHOD(bufferData);
+  _JSI_INSTALL_METHOD(bufferSubData);
+  _JSI_INSTALL_METHOD(createBuffer);
+  _JSI_INSTALL_METHOD(deleteBuffer);
+  _JSI_INSTALL_METHOD(getBufferParameter);
+  _JSI_INSTALL_METHOD(isBuffer);
+
+  // Buffers (WebGL2)
+  _JSI_INSTALL_METHOD(copyBufferSubData);
+  _JSI_INSTALL_METHOD(getBufferSubData);
+
+  // Framebuffers
+  _JSI_INSTALL_METHOD(bindFramebuffer);
+  _JSI_INSTALL_METHOD(checkFramebufferStatus);
+  _JSI_INSTALL_METHOD(createFramebuffer);
+  _JSI_INSTALL_METHOD(deleteFramebuffer);
+  _JSI_INSTALL_METHOD(framebufferRenderbuffer);
+  _JSI_INSTALL_METHOD(framebufferTexture2D);
+  _JSI_INSTALL_METHOD(getFramebufferAttachmentParameter);
+  _JSI_INSTALL_METHOD(isFramebuffer);
+  _JSI_INSTALL_METHOD(readPixels);
+
+  // Framebuffers (WebGL2)
+  _JSI_INSTALL_METHOD(blitFramebuffer);
+  _JSI_INSTALL_METHOD(framebufferTextureLayer);
+  _JSI_INSTALL_METHOD(invalidateFramebuffer);
+  _JSI_INSTALL_METHOD(invalidateSubFramebuffer);
+  _JSI_INSTALL_METHOD(readBuffer);
+
+  // Renderbuffers
+  _JSI_INSTALL_METHOD(bindRenderbuffer);
+  _JSI_INSTALL_METHOD(createRenderbuffer);
+  _JSI_INSTALL_METHOD(deleteRenderbuffer);
+  _JSI_INSTALL_METHOD(getRenderbufferParameter);
+  _JSI_INSTALL_METHOD(isRenderbuffer);
+  _JSI_INSTALL_METHOD(renderbufferStorage);
+
+  // Renderbuffers (WebGL2)
+  _JSI_INSTALL_METHOD(getInternalformatParameter);
+  _JSI_INSTALL_METHOD(renderbufferStorageMultisample);
+
+  // Textures
+  _JSI_INSTALL_METHOD(bindTexture);
+  _JSI_INSTALL_METHOD(compressedTexImage2D);
+  _JSI_INSTALL_METHOD(compressedTexSubImage2D);
+  _JSI_INSTALL_METHOD(copyTexImage2D);
+  _JSI_INSTALL_METHOD(copyTexSubImage2D);
+  _JSI_INSTALL_METHOD(createTexture);
+  _JSI_INSTALL_METHOD(deleteTexture);
+  _JSI_INSTALL_METHOD(generateMipmap);
+  _JSI_INSTALL_METHOD(texImage2D);
+  _JSI_INSTALL_METHOD(texSubImage2D);
+  _JSI_INSTALL_METHOD(texParameterf);
+  _JSI_INSTALL_METHOD(texParameteri);
+  _JSI_INSTALL_METHOD(getTexParameter);
+  _JSI_INSTALL_METHOD(isTexture);
+
+  // Textures (WebGL2)
+  _JSI_INSTALL_METHOD(texStorage2D);
+  _JSI_INSTALL_METHOD(texStorage3D);
+  _JSI_INSTALL_METHOD(texImage3D);
+  _JSI_INSTALL_METHOD(texSubImage3D);
+  _JSI_INSTALL_METHOD(copyTexSubImage3D);
+  _JSI_INSTALL_METHOD(compressedTexImage3D);
+  _JSI_INSTALL_METHOD(compressedTexSubImage3D);
+
+  // Programs and shaders
+  _JSI_INSTALL_METHOD(attachShader);
+  _JSI_INSTALL_METHOD(bindAttribLocation);
+  _JSI_INSTALL_METHOD(compileShader);
+  _JSI_INSTALL_METHOD(createProgram);
+  _JSI_INSTALL_METHOD(createShader);
+  _JSI_INSTALL_METHOD(deleteProgram);
+  _JSI_INSTALL_METHOD(deleteShader);
+  _JSI_INSTALL_METHOD(detachShader);
+  _JSI_INSTALL_METHOD(getAttachedShaders);
+  _JSI_INSTALL_METHOD(getProgramParameter);
+  _JSI_INSTALL_METHOD(getShaderParameter);
+  _JSI_INSTALL_METHOD(getShaderPrecisionFormat);
+  _JSI_INSTALL_METHOD(getProgramInfoLog);
+  _JSI_INSTALL_METHOD(getShaderInfoLog);
+  _JSI_INSTALL_METHOD(getShaderSource);
+  _JSI_INSTALL_METHOD(isProgram);
+  _JSI_INSTALL_METHOD(isShader);
+  _JSI_INSTALL_METHOD(linkProgram);
+  _JSI_INSTALL_METHOD(shaderSource);
+  _JSI_INSTALL_METHOD(useProgram);
+  _JSI_INSTALL_METHOD(validateProgram);
+
+  // Programs and shaders (WebGL2)
+  _JSI_INSTALL_METHOD(getFragDataLocation);
+
+  // Uniforms and attributes
+  _JSI_INSTALL_METHOD(disableVertexAttribArray);
+  _JSI_INSTALL_METHOD(enableVertexAttribArray);
+  _JSI_INSTALL_METHOD(getActiveAttrib);
+  _JSI_INSTALL_METHOD(getActiveUniform);
+  _JSI_INSTALL_METHOD(getAttribLocation);
+  _JSI_INSTALL_METHOD(getUniform);
+  _JSI_INSTALL_METHOD(getUniformLocation);
+  _JSI_INSTALL_METHOD(getVertexAttrib);
+  _JSI_INSTALL_METHOD(getVertexAttribOffset);
+  _JSI_INSTALL_METHOD(uniform1f);
+  _JSI_INSTALL_METHOD(uniform2f);
+  _JSI_INSTALL_METHOD(uniform3f);
+  _JSI_INSTALL_METHOD(uniform4f);
+  _JSI_INSTALL_METHOD(uniform1fv);
+  _JSI_INSTALL_METHOD(uniform2fv);
+  _JSI_INSTALL_METHOD(uniform3fv);
+  _JSI_INSTALL_METHOD(uniform4fv);
+  _JSI_INSTALL_METHOD(uniform1i);
+  _JSI_INSTALL_METHOD(uniform2i);
+  _JSI_INSTALL_METHOD(uniform3i);
+  _JSI_INSTALL_METHOD(uniform4i);
+  _JSI_INSTALL_METHOD(uniform1iv);
+  _JSI_INSTALL_METHOD(uniform2iv);
+  _JSI_INSTALL_METHOD(uniform3iv);
+  _JSI_INSTALL_METHOD(uniform4iv);
+  _JSI_INSTALL_METHOD(uniformMatrix2fv);
+  _JSI_INSTALL_METHOD(uniformMatrix3fv);
+  _JSI_INSTALL_METHOD(uniformMatrix4fv);
+  _JSI_INSTALL_METHOD(vertexAttrib1fv);
+  _JSI_INSTALL_METHOD(vertexAttrib2fv);
+  _JSI_INSTALL_METHOD(vertexAttrib3fv);
+  _JSI_INSTALL_METHOD(vertexAttrib4fv);
+  _JSI_INSTALL_METHOD(vertexAttrib1f);
+  _JSI_INSTALL_METHOD(vertexAttrib2f);
+  _JSI_INSTALL_METHOD(vertexAttrib3f);
+  _JSI_INSTALL_METHOD(vertexAttrib4f);
+  _JSI_INSTALL_METHOD(vertexAttribPointer);
+
+  // Uniforms and attributes (WebGL2)
+  _JSI_INSTALL_METHOD(uniform1ui);
+  _JSI_INSTALL_METHOD(uniform2ui);
+  _JSI_INSTALL_METHOD(uniform3ui);
+  _JSI_INSTALL_METHOD(uniform4ui);
+  _JSI_INSTALL_METHOD(uniform1uiv);
+  _JSI_INSTALL_METHOD(uniform2uiv);
+  _JSI_INSTALL_METHOD(uniform3uiv);
+  _JSI_INSTALL_METHOD(uniform4uiv);
+  _JSI_INSTALL_METHOD(uniformMatrix3x2fv);
+  _JSI_INSTALL_METHOD(uniformMatrix4x2fv);
+  _JSI_INSTALL_METHOD(uniformMatrix2x3fv);
+  _JSI_INSTALL_METHOD(uniformMatrix4x3fv);
+  _JSI_INSTALL_METHOD(uniformMatrix2x4fv);
+  _JSI_INSTALL_METHOD(uniformMatrix3x4fv);
+  _JSI_INSTALL_METHOD(vertexAttribI4i);
+  _JSI_INSTALL_METHOD(vertexAttribI4ui);
+  _JSI_INSTALL_METHOD(vertexAttribI4iv);
+  _JSI_INSTALL_METHOD(vertexAttribI4uiv);
+  _JSI_INSTALL_METHOD(vertexAttribIPointer);
+
+  // Drawing buffers
+  _JSI_INSTALL_METHOD(clear);
+  _JSI_INSTALL_METHOD(drawArrays);
+  _JSI_INSTALL_METHOD(drawElements);
+  _JSI_INSTALL_METHOD(finish);
+  _JSI_INSTALL_METHOD(flush);
+
+  // Drawing buffers (WebGL2)
+  _JSI_INSTALL_METHOD(vertexAttribDivisor);
+  _JSI_INSTALL_METHOD(drawArraysInstanced);
+  _JSI_INSTALL_METHOD(drawElementsInstanced);
+  _JSI_INSTALL_METHOD(drawRangeElements);
+  _JSI_INSTALL_METHOD(drawBuffers);
+  _JSI_INSTALL_METHOD(clearBufferfv);
+  _JSI_INSTALL_METHOD(clearBufferiv);
+  _JSI_INSTALL_METHOD(clearBufferuiv);
+  _JSI_INSTALL_METHOD(clearBufferfi);
+
+  // Query objects (WebGL2)
+  _JSI_INSTALL_METHOD(createQuery);
+  _JSI_INSTALL_METHOD(deleteQuery);
+  _JSI_INSTALL_METHOD(isQuery);
+  _JSI_INSTALL_METHOD(beginQuery);
+  _JSI_INSTALL_METHOD(endQuery);
+  _JSI_INSTALL_METHOD(getQuery);
+  _JSI_INSTALL_METHOD(getQueryParameter);
+
+  // Samplers (WebGL2)
+  _JSI_INSTALL_METHOD(createSampler);
+  _JSI_INSTALL_METHOD(deleteSampler);
+  _JSI_INSTALL_METHOD(bindSampler);
+  _JSI_INSTALL_METHOD(isSampler);
+  _JSI_INSTALL_METHOD(samplerParameteri);
+  _JSI_INSTALL_METHOD(samplerParameterf);
+  _JSI_INSTALL_METHOD(getSamplerParameter);
+
+  // Sync objects (WebGL2)
+  _JSI_INSTALL_METHOD(fenceSync);
+  _JSI_INSTALL_METHOD(isSync);
+  _JSI_INSTALL_METHOD(deleteSync);
+  _JSI_INSTALL_METHOD(clientWaitSync);
+  _JSI_INSTALL_METHOD(waitSync);
+  _JSI_INSTALL_METHOD(getSyncParameter);
+
+  // Transform feedback (WebGL2)
+  _JSI_INSTALL_METHOD(createTransformFeedback);
+  _JSI_INSTALL_METHOD(deleteTransformFeedback);
+  _JSI_INSTALL_METHOD(isTransformFeedback);
+  _JSI_INSTALL_METHOD(bindTransformFeedback);
+  _JSI_INSTALL_METHOD(beginTransformFeedback);
+  _JSI_INSTALL_METHOD(endTransformFeedback);
+  _JSI_INSTALL_METHOD(transformFeedbackVaryings);
+  _JSI_INSTALL_METHOD(getTransformFeedbackVarying);
+  _JSI_INSTALL_METHOD(pauseTransformFeedback);
+  _JSI_INSTALL_METHOD(resumeTransformFeedback);
+
+  // Uniform buffer objects (WebGL2)
+  _JSI_INSTALL_METHOD(bindBufferBase);
+  _JSI_INSTALL_METHOD(bindBufferRange);
+  _JSI_INSTALL_METHOD(getUniformIndices);
+  _JSI_INSTALL_METHOD(getActiveUniforms);
+  _JSI_INSTALL_METHOD(getUniformBlockIndex);
+  _JSI_INSTALL_METHOD(getActiveUniformBlockParameter);
+  _JSI_INSTALL_METHOD(getActiveUniformBlockName);
+  _JSI_INSTALL_METHOD(uniformBlockBinding);
+
+  // Vertex Array Objects (WebGL2)
+  _JSI_INSTALL_METHOD(createVertexArray);
+  _JSI_INSTALL_METHOD(deleteVertexArray);
+  _JSI_INSTALL_METHOD(bindVertexArray);
+  _JSI_INSTALL_METHOD(isVertexArray);
+
+  // Extensions
+  _JSI_INSTALL_METHOD(getSupportedExtensions);
+  _JSI_INSTALL_METHOD(getExtension);
+
+  // Exponent extensions
+  _JSI_INSTALL_METHOD(endFrameEXP);
+  _JSI_INSTALL_METHOD(flushEXP);
+  _JSI_INSTALL_METHOD(bufferDataNoCopyEXP);
+  _JSI_INSTALL_METHOD(bufferSubDataNoCopyEXP);
+  _JSI_INSTALL_METHOD(texImage2DNoCopyEXP);
+  _JSI_INSTALL_METHOD(readPixelsAsyncEXP);
+  _JSI_INSTALL_METHOD(getBufferSubDataAsyncEXP);
+  _JSI_INSTALL_METHOD(enableStateCachingEXP);
+  _JSI_INSTALL_METHOD(enableDeferredErrorsEXP);
+  _JSI_INSTALL_METHOD(setBacklogPolicyEXP);
+  _JSI_INSTALL_METHOD(compressedTexImageKTXEXP);
+  _JSI_INSTALL_METHOD(enableFrameStatsEXP);
+  _JSI_INSTALL_METHOD(getFrameStatsEXP);
+  _JSI_INSTALL_METHOD(uniformBlockUpdateEXP);
+  _JSI_INSTALL_METHOD(multiDrawElementsEXP);
+  _JSI_INSTALL_METHOD(updateExternalTextureEXP);
+  _JSI_INSTALL_METHOD(startTraceEXP);
+  _JSI_INSTALL_METHOD(stopTraceEXP);
+  _JSI_INSTALL_METHOD(getFrameDeadlineEXP);
+  _JSI_INSTALL_METHOD(setResidencyBudgetEXP);
+  _JSI_INSTALL_METHOD(getResidencyCandidatesEXP);
+  _JSI_INSTALL_METHOD(setUploadBudgetEXP);
+  _JSI_INSTALL_METHOD(startRecordingEXP);
+  _JSI_INSTALL_METHOD(stopRecordingEXP);
+  _JSI_INSTALL_METHOD(texStorage2DLevelsEXP);
+  _JSI_INSTALL_METHOD(texImage2DTextEXP);
+  _JSI_INSTALL_METHOD(texSubImage2DTextEXP);
+
+#define _INSTALL_CONSTANT(name) jsGl.setProperty(runtime, #name, (double) GL_##name)
+#include "EXGLConstantsList.h"
+#undef _INSTALL_CONSTANT
+
+  // Save JavaScript object
+  auto jsGlobal = runtime.global();
+  auto jsEXGLContextMap = jsGlobal.getProperty(runtime, "__EXGLContexts");
+  if (!jsEXGLContextMap.isObject()) {
+    jsEXGLContextMap = jsi::Object(runtime);
+    jsGlobal.setProperty(runtime, "__EXGLContexts", jsEXGLContextMap);
+  }
+  std::stringstream ss;
+  ss << exglCtxId;
+  jsEXGLContextMap.getObject(runtime).setProperty(runtime, ss.str().c_str(), std::move(jsGl));
+
+  return exglCtxId;
+}
+
+#undef _JSI_INSTALL_METHOD
+
+
+// Conversions
+// -----------
+
+double EXGLJsiContext::number(const jsi::Value &value) noexcept {
+  if (value.isNumber()) {
+    return value.getNumber();
+  }
+  if (value.isBool()) {
+    return value.getBool() ? 1 : 0;
+  }
+  // null, undefined and objects, same as `EXJSValueToNumberFast`
+  return 0;
+}
+
+// Backing store of an ArrayBuffer or TypedArray, false if `value` is neither
+bool EXGLJsiContext::arrayData(const jsi::Value &value, uint8_t *&data, size_t &byteLength) {
+  if (!value.isObject()) {
+    return false;
+  }
+  auto object = value.getObject(runtime);
+  if (object.isArrayBuffer(runtime)) {
+    auto buffer = object.getArrayBuffer(runtime);
+    data = buffer.data(runtime);
+    byteLength = buffer.size(runtime);
+    return true;
+  }
+  auto jsBuffer = object.getProperty(runtime, "buffer");
+  if (!jsBuffer.isObject() || !jsBuffer.getObject(runtime).isArrayBuffer(runtime)) {
+    return false;
+  }
+  auto buffer = jsBuffer.getObject(runtime).getArrayBuffer(runtime);
+  data = buffer.data(runtime) + (size_t) number(object.getProperty(runtime, "byteOffset"));
+  byteLength = (size_t) number(object.getProperty(runtime, "byteLength"));
+  return true;
+}
+
+// Copy of the contents of an ArrayBuffer or TypedArray, for ops that run later
+std::shared_ptr<void> EXGLJsiContext::copyArray(const jsi::Value &value, size_t *pByteLength) {
+  uint8_t *data = nullptr;
+  size_t byteLength = 0;
+  if (!arrayData(value, data, byteLength) || !data) {
+    if (pByteLength) {
+      *pByteLength = 0;
+    }
+    return std::shared_ptr<void>(nullptr);
+  }
+  if (pByteLength) {
+    *pByteLength = byteLength;
+  }
+  return ctx.stageCopy(data, byteLength);
+}
+
+std::string EXGLJsiContext::string(const jsi::Value &value) {
+  return value.toString(runtime).utf8(runtime);
+}
+
+// `new constructor(byteLength / BYTES_PER_ELEMENT)` filled with `data`
+jsi::Value EXGLJsiContext::makeTypedArray(const char *constructor, const void *data, size_t byteLength) {
+  auto jsBuffer = runtime.global()
+    .getPropertyAsFunction(runtime, "ArrayBuffer")
+    .callAsConstructor(runtime, (double) byteLength)
+    .getObject(runtime);
+  if (byteLength > 0) {
+    memcpy(jsBuffer.getArrayBuffer(runtime).data(runtime), data, byteLength);
+  }
+  return runtime.global()
+    .getPropertyAsFunction(runtime, constructor)
+    .callAsConstructor(runtime, std::move(jsBuffer));
+}
+
+jsi::Value EXGLJsiContext::makeActiveInfo(const char *name, GLint size, GLenum type) {
+  jsi::Object jsResult(runtime);
+  jsResult.setProperty(runtime, "name", jsi::String::createFromUtf8(runtime, name));
+  jsResult.setProperty(runtime, "size", (double) size);
+  jsResult.setProperty(runtime, "type", (double) type);
+  return jsi::Value(runtime, jsResult);
+}
+
+jsi::Value EXGLJsiContext::objectOrNull(UEXGLObjectId exglObjId) noexcept {
+  return exglObjId == 0 ? jsi::Value::null() : jsi::Value((double) exglObjId);
+}
+
+// Elements of an Array or a Uint32Array/Int32Array (attachments, indices...)
+std::vector<GLuint> EXGLJsiContext::uintArray(const jsi::Value &value) {
+  std::vector<GLuint> results;
+  if (!value.isObject()) {
+    return results;
+  }
+  auto object = value.getObject(runtime);
+  if (object.isArray(runtime)) {
+    auto array = object.getArray(runtime);
+    results.resize(array.size(runtime));
+    for (size_t i = 0; i < results.size(); ++i) {
+      results[i] = (GLuint) number(array.getValueAtIndex(runtime, i));
+    }
+    return results;
+  }
+  uint8_t *data = nullptr;
+  size_t byteLength = 0;
+  if (arrayData(value, data, byteLength) && data) {
+    results.resize(byteLength / sizeof(GLuint));
+    memcpy(results.data(), data, results.size() * sizeof(GLuint));
+  }
+  return results;
+}
+
+std::vector<std::string> EXGLJsiContext::stringArray(const jsi::Value &value) {
+  std::vector<std::string> results;
+  if (!value.isObject() || !value.getObject(runtime).isArray(runtime)) {
+    return results;
+  }
+  auto array = value.getObject(runtime).getArray(runtime);
+  results.reserve(array.size(runtime));
+  for (size_t i = 0; i < array.size(runtime); ++i) {
+    results.push_back(string(array.getValueAtIndex(runtime, i)));
+  }
+  return results;
+}
+
+// `BYTES_PER_ELEMENT` of a TypedArray, 1 for DataViews and ArrayBuffers
+size_t EXGLJsiContext::bytesPerElement(const jsi::Value &value) {
+  if (!value.isObject()) {
+    return 1;
+  }
+  auto jsBytes = value.getObject(runtime).getProperty(runtime, "BYTES_PER_ELEMENT");
+  return jsBytes.isNumber() && jsBytes.getNumber() >= 1 ? (size_t) jsBytes.getNumber() : 1;
+}
+
+// Same as `EXGLContext::jsValueToSharedSubarray`
+std::shared_ptr<void> EXGLJsiContext::copySubarray(const jsi::Value &value, size_t srcOffset,
+                                                   size_t byteLength, const char *method) {
+  uint8_t *data = nullptr;
+  size_t length = 0;
+  if (!arrayData(value, data, length) || !data) {
+    return std::shared_ptr<void>(nullptr);
+  }
+  size_t byteOffset = srcOffset * bytesPerElement(value);
+  if (byteOffset > length || byteLength > length - byteOffset) {
+    throw std::runtime_error(std::string("EXGL: gl.") + method + "() reads past the end of srcData!");
+  }
+  return ctx.stageCopy(data + byteOffset, byteLength);
+}
+
+// Callbacks of the pending async readbacks, in the order they were requested.
+// They live on the JS object so that no jsi::Value has to outlive the call.
+jsi::Array EXGLJsiContext::readbackCallbacks() {
+  std::stringstream ss;
+  ss << ctx.exglCtxId;
+  auto jsGl = runtime.global()
+    .getPropertyAsObject(runtime, "__EXGLContexts")
+    .getPropertyAsObject(runtime, ss.str().c_str());
+  auto jsCallbacks = jsGl.getProperty(runtime, "__readbackCallbacksEXP");
+  if (jsCallbacks.isObject() && jsCallbacks.getObject(runtime).isArray(runtime)) {
+    return jsCallbacks.getObject(runtime).getArray(runtime);
+  }
+  jsi::Array jsNewCallbacks(runtime, 0);
+  jsGl.setProperty(runtime, "__readbackCallbacksEXP", jsNewCallbacks);
+  return jsNewCallbacks;
+}
+
+// Readbacks complete in order (see `EXGLContext::pollPixelPacks`), so each one
+// goes to the oldest callback
+void EXGLJsiContext::resolveReadbacks() {
+  std::vector<EXGLContext::PixelPackRequest> completed;
+  {
+    std::lock_guard<decltype(ctx.completedPixelPacksMutex)> lock(ctx.completedPixelPacksMutex);
+    completed.swap(ctx.completedPixelPacks);
+  }
+  if (completed.empty()) {
+    return;
+  }
+  // Take every callback and result first: a callback that throws then only
+  // drops the ones after it instead of handing them the wrong results
+  auto jsCallbacks = readbackCallbacks();
+  auto jsShift = jsCallbacks.getPropertyAsFunction(runtime, "shift");
+  std::vector<std::pair<jsi::Value, jsi::Value>> calls;
+  for (auto &request : completed) {
+    jsi::Value jsResult = jsi::Value::null();
+    if (request.result) {
+      const char *constructor = request.arrayType == kJSTypedArrayTypeFloat32Array ? "Float32Array"
+        : request.arrayType == kJSTypedArrayTypeUint16Array ? "Uint16Array"
+        : "Uint8Array";
+      jsResult = makeTypedArray(constructor, request.result, request.byteLength);
+      free(request.result);
+    }
+    calls.emplace_back(jsShift.callWithThis(runtime, jsCallbacks), std::move(jsResult));
+  }
+  for (auto &call : calls) {
+    if (call.first.isObject() && call.first.getObject(runtime).isFunction(runtime)) {
+      call.first.getObject(runtime).getFunction(runtime).call(runtime, std::move(call.second));
+    }
+  }
+}
+
+
+// This listing follows the order of EXGLNativeMethods.cpp
+
+
+// The WebGL context
+// -----------------
+
+_JSI_METHOD(getContextAttributes, 0) {
+  jsi::Object jsResult(runtime);
+  jsResult.setProperty(runtime, "alpha", true);
+  jsResult.setProperty(runtime, "depth", true);
+  jsResult.setProperty(runtime, "stencil", false);
+  jsResult.setProperty(runtime, "antialias", ctx.antialias.load());
+  jsResult.setProperty(runtime, "premultipliedAlpha", false);
+  return jsi::Value(runtime, jsResult);
+}
+
+_JSI_METHOD(isContextLost, 0) {
+  return ctx.contextLost.load();
+}
+
+
+// Viewing and clipping
+// --------------------
+
+_JSI_METHOD_SIMPLE_SHADOWED(scissor, glScissor, Scissor, x, y, width, height)
+
+_JSI_METHOD_SIMPLE_SHADOWED(viewport, glViewport, Viewport, x, y, width, height)
+
+
+// State information
+// -----------------
+
+_JSI_METHOD(activeTexture, 1) {
+  _JSI_UNPACK_ARGS(GLenum texture);
+  ctx.residency.activeTexture(texture);
+  const double values[] = { (double) texture };
+  if (ctx.shadowState.update(EXGLShadowState::ActiveTexture, values, 1)) {
+    ctx.addCallToNextBatch(glActiveTexture, texture);
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD_SIMPLE_SHADOWED(blendColor, glBlendColor, BlendColor, red, green, blue, alpha)
+
+_JSI_METHOD(blendEquation, 1) {
+  _JSI_UNPACK_ARGS(GLenum mode);
+  const double values[] = { (double) mode, (double) mode };
+  if (ctx.shadowState.update(EXGLShadowState::BlendEquation, values, 2)) {
+    ctx.addCallToNextBatch(glBlendEquation, mode);
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD_SIMPLE_SHADOWED(blendEquationSeparate, glBlendEquationSeparate, BlendEquation, modeRGB, modeAlpha)
+
+_JSI_METHOD(blendFunc, 2) {
+  _JSI_UNPACK_ARGS(GLenum sfactor, GLenum dfactor);
+  const double values[] = { (double) sfactor, (double) dfactor, (double) sfactor, (double) dfactor };
+  if (ctx.shadowState.update(EXGLShadowState::BlendFunc, values, 4)) {
+    ctx.addCallToNextBatch(glBlendFunc, sfactor, dfactor);
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD_SIMPLE_SHADOWED(blendFuncSeparate, glBlendFuncSeparate, BlendFunc, srcRGB, dstRGB, srcAlpha, dstAlpha)
+
+_JSI_METHOD_SIMPLE_SHADOWED(clearColor, glClearColor, ClearColor, red, green, blue, alpha)
+
+_JSI_METHOD_SIMPLE_SHADOWED(clearDepth, glClearDepthf, ClearDepth, depth)
+
+_JSI_METHOD_SIMPLE_SHADOWED(clearStencil, glClearStencil, ClearStencil, s)
+
+_JSI_METHOD_SIMPLE_SHADOWED(colorMask, glColorMask, ColorMask, red, green, blue, alpha)
+
+_JSI_METHOD_SIMPLE_SHADOWED(cullFace, glCullFace, CullFace, mode)
+
+_JSI_METHOD_SIMPLE_SHADOWED(depthFunc, glDepthFunc, DepthFunc, func)
+
+_JSI_METHOD_SIMPLE_SHADOWED(depthMask, glDepthMask, DepthMask, flag)
+
+_JSI_METHOD_SIMPLE_SHADOWED(depthRange, glDepthRangef, DepthRange, zNear, zFar)
+
+_JSI_METHOD(disable, 1) {
+  _JSI_UNPACK_ARGS(GLenum cap);
+  if (ctx.shadowState.updateCapability(cap, false)) {
+    ctx.addCallToNextBatch(glDisable, cap);
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(enable, 1) {
+  _JSI_UNPACK_ARGS(GLenum cap);
+  if (ctx.shadowState.updateCapability(cap, true)) {
+    ctx.addCallToNextBatch(glEnable, cap);
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD_SIMPLE_SHADOWED(frontFace, glFrontFace, FrontFace, mode)
+
+_JSI_METHOD(getParameter, 1) {
+  _JSI_UNPACK_ARGS(GLenum pname);
+
+  // Bindings are tracked natively, always
+  UEXGLObjectId binding;
+  if (ctx.residency.binding(pname, &binding)) {
+    return objectOrNull(binding);
+  }
+
+  // The common state from the shadow state, when it's enabled
+  double values[4];
+  switch (pname) {
+    case GL_VIEWPORT:
+    case GL_SCISSOR_BOX:
+      if (ctx.shadowState.get(pname == GL_VIEWPORT ? EXGLShadowState::Viewport : EXGLShadowState::Scissor,
+                              values, 4)) {
+        GLint results[4];
+        std::copy(values, values + 4, results);
+        return makeTypedArray("Int32Array", results, sizeof(results));
+      }
+      break;
+    default: {
+      int capability = ctx.shadowState.getCapability(pname);
+      if (capability >= 0) {
+        return capability != 0;
+      }
+      break;
+    }
+  }
+
+  switch (pname) {
+      // Float32Array[2]
+    case GL_ALIASED_LINE_WIDTH_RANGE:
+    case GL_ALIASED_POINT_SIZE_RANGE:
+    case GL_DEPTH_RANGE: {
+      GLfloat glResults[2];
+      ctx.addBlockingToNextBatch([&] { glGetFloatv(pname, glResults); });
+      return makeTypedArray("Float32Array", glResults, sizeof(glResults));
+    }
+      // Float32Array[4]
+    case GL_BLEND_COLOR:
+    case GL_COLOR_CLEAR_VALUE: {
+      GLfloat glResults[4];
+      ctx.addBlockingToNextBatch([&] { glGetFloatv(pname, glResults); });
+      return makeTypedArray("Float32Array", glResults, sizeof(glResults));
+    }
+
+      // Int32Array[2]
+    case GL_MAX_VIEWPORT_DIMS: {
+      GLint glResults[2];
+      ctx.addBlockingToNextBatch([&] { glGetIntegerv(pname, glResults); });
+      return makeTypedArray("Int32Array", glResults, sizeof(glResults));
+    }
+      // Int32Array[4]
+    case GL_SCISSOR_BOX:
+    case GL_VIEWPORT: {
+      GLint glResults[4];
+      ctx.addBlockingToNextBatch([&] { glGetIntegerv(pname, glResults); });
+      return makeTypedArray("Int32Array", glResults, sizeof(glResults));
+    }
+
+      // boolean
+    case GL_UNPACK_FLIP_Y_WEBGL:
+      return ctx.unpackFLipY;
+    case GL_UNPACK_PREMULTIPLY_ALPHA_WEBGL:
+      return ctx.unpackPremultiplyAlpha;
+    case GL_UNPACK_COLORSPACE_CONVERSION_WEBGL:
+      return false;
+
+      // string
+    case GL_RENDERER:
+    case GL_SHADING_LANGUAGE_VERSION:
+    case GL_VENDOR:
+    case GL_VERSION: {
+      const GLubyte *glStr;
+      ctx.addBlockingToNextBatch([&] { glStr = glGetString(pname); });
+      return jsi::String::createFromUtf8(runtime, (const char *) glStr);
+    }
+
+      // float
+    case GL_DEPTH_CLEAR_VALUE:
+    case GL_LINE_WIDTH:
+    case GL_POLYGON_OFFSET_FACTOR:
+    case GL_POLYGON_OFFSET_UNITS:
+    case GL_SAMPLE_COVERAGE_VALUE:
+    case GL_MAX_TEXTURE_LOD_BIAS: {
+      GLfloat glFloat;
+      ctx.addBlockingToNextBatch([&] { glGetFloatv(pname, &glFloat); });
+      return (double) glFloat;
+    }
+
+    case GL_COLOR_WRITEMASK:
+      throw std::runtime_error("EXGL: getParameter() doesn't support this parameter through JSI yet!");
+
+      // int
+    default: {
+      GLint glInt;
+      ctx.addBlockingToNextBatch([&] { glGetIntegerv(pname, &glInt); });
+      return glInt;
+    }
+  }
+}
+
+_JSI_METHOD(getError, 0) {
+  if (ctx.deferredErrors) {
+    return (double) ctx.deferredError.exchange(GL_NO_ERROR);
+  }
+  GLenum glResult;
+  ctx.addBlockingToNextBatch([&] { glResult = glGetError(); });
+  return (double) glResult;
+}
+
+_JSI_METHOD_SIMPLE(hint, glHint, target, mode)
+
+_JSI_METHOD(isEnabled, 1) {
+  _JSI_UNPACK_ARGS(GLenum cap);
+  int capability = ctx.shadowState.getCapability(cap);
+  if (capability >= 0) {
+    return capability != 0;
+  }
+  GLboolean glResult;
+  ctx.addBlockingToNextBatch([&] { glResult = glIsEnabled(cap); });
+  return glResult != GL_FALSE;
+}
+
+_JSI_METHOD_SIMPLE_SHADOWED(lineWidth, glLineWidth, LineWidth, width)
+
+_JSI_METHOD(pixelStorei, 2) {
+  _JSI_UNPACK_ARGS(GLenum pname, GLint param);
+  switch (pname) {
+    case GL_UNPACK_FLIP_Y_WEBGL:
+      ctx.unpackFLipY = param;
+      break;
+    case GL_UNPACK_PREMULTIPLY_ALPHA_WEBGL:
+      ctx.unpackPremultiplyAlpha = param;
+      break;
+    default:
+      EXGLSysLog("EXGL: gl.pixelStorei() doesn't support this parameter yet!");
+      break;
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD_SIMPLE_SHADOWED(polygonOffset, glPolygonOffset, PolygonOffset, factor, units)
+
+_JSI_METHOD_SIMPLE(sampleCoverage, glSampleCoverage, value, invert)
+
+_JSI_METHOD_SIMPLE(stencilFunc, glStencilFunc, func, ref, mask)
+
+_JSI_METHOD_SIMPLE(stencilFuncSeparate, glStencilFuncSeparate, face, func, ref, mask)
+
+_JSI_METHOD_SIMPLE(stencilMask, glStencilMask, mask)
+
+_JSI_METHOD_SIMPLE(stencilMaskSeparate, glStencilMaskSeparate, face, mask)
+
+_JSI_METHOD_SIMPLE(stencilOp, glStencilOp, fail, zfail, zpass)
+
+_JSI_METHOD_SIMPLE(stencilOpSeparate, glStencilOpSeparate, face, fail, zfail, zpass)
+
+
+// Buffers
+// -------
+
+_JSI_METHOD(bindBuffer, 2) {
+  _JSI_UNPACK_ARGS(GLenum target, UEXGLObjectId fBuffer);
+  ctx.residency.bindBuffer(target, fBuffer);
+  const double values[] = { (double) fBuffer };
+  if (target == GL_ARRAY_BUFFER && !ctx.shadowState.update(EXGLShadowState::ArrayBuffer, values, 1)) {
+    return jsi::Value::undefined();
+  }
+  if (target == GL_ELEMENT_ARRAY_BUFFER &&
+      !ctx.shadowState.update(EXGLShadowState::ElementArrayBuffer, values, 1)) {
+    return jsi::Value::undefined();
+  }
+  ctx.addBindToNextBatch(glBindBuffer, target, fBuffer);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(bufferData, 3) {
+  _JSI_UNPACK_ARGS(GLenum target);
+  _JSI_UNPACK_ARGS_OFFSET(2, GLenum usage);
+
+  if (args[1].isNumber()) {
+    GLsizeiptr length = args[1].getNumber();
+    ctx.residency.bufferStorage(target, length);
+    ctx.addToNextBatch([=] { glBufferData(target, length, nullptr, usage); });
+    ctx.traceLastClosure(EXGLTraceEvent::BufferData, { (double) target, (double) length, (double) usage });
+  } else if (args[1].isNull()) {
+    ctx.residency.bufferStorage(target, 0);
+    ctx.addToNextBatch([=] { glBufferData(target, 0, nullptr, usage); });
+    ctx.traceLastClosure(EXGLTraceEvent::BufferData, { (double) target, 0, (double) usage });
+  } else {
+    size_t length;
+    auto data = copyArray(args[1], &length);
+    ctx.residency.bufferStorage(target, length);
+    ctx.addToNextBatch([=] { glBufferData(target, length, data.get(), usage); });
+    ctx.traceLastClosure(EXGLTraceEvent::BufferData, { (double) target, (double) length, (double) usage },
+                         data.get(), length);
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(bufferSubData, 3) {
+  if (!args[2].isNull()) {
+    _JSI_UNPACK_ARGS(GLenum target, GLintptr offset);
+    size_t length;
+    auto data = copyArray(args[2], &length);
+    ctx.addToNextBatch([=] { glBufferSubData(target, offset, length, data.get()); });
+    ctx.traceLastClosure(EXGLTraceEvent::BufferSubData, { (double) target, (double) offset }, data.get(), length);
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(createBuffer, 0) {
+  return (double) ctx.addFutureToNextBatch([] {
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    return buffer;
+  });
+}
+
+_JSI_METHOD(deleteBuffer, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fBuffer);
+  ctx.shadowState.forgetObject(fBuffer);
+  ctx.residency.forget(fBuffer);
+  ctx.vertexArrays.forgetBuffer(fBuffer);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    GLuint buffer = exglCtx.lookupObject(fBuffer);
+    glDeleteBuffers(1, &buffer);
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(getBufferParameter, 2) {
+  _JSI_UNPACK_ARGS(GLenum target, GLenum pname);
+  GLint glResult;
+  ctx.addBlockingToNextBatch([&] { glGetBufferParameteriv(target, pname, &glResult); });
+  return glResult;
+}
+
+#define _JSI_METHOD_IS_OBJECT_INTERNAL(type, requiresWebGL2)     \
+_JSI_METHOD_INTERNAL(is ## type, 1, requiresWebGL2) {          \
+  _JSI_UNPACK_ARGS(UEXGLObjectId f);                           \
+  GLboolean glResult;                                          \
+  ctx.addBlockingToNextBatch([&] {                             \
+    glResult = glIs ## type(ctx.lookupObject(f));              \
+  });                                                          \
+  return glResult != GL_FALSE;                                 \
+}
+
+#define _JSI_METHOD_IS_OBJECT(type)        _JSI_METHOD_IS_OBJECT_INTERNAL(type, false)
+#define _JSI_WEBGL2_METHOD_IS_OBJECT(type) _JSI_METHOD_IS_OBJECT_INTERNAL(type, true)
+
+_JSI_METHOD_IS_OBJECT(Buffer)
+
+
+// Buffers (WebGL2)
+// ----------------
+
+_JSI_WEBGL2_METHOD_SIMPLE(copyBufferSubData, glCopyBufferSubData,
+                          readTarget, writeTarget, readOffset, writeOffset, size)
+
+// Same as the JavaScriptCore binding: the range is mapped, `dstOffset` and
+// `length` count elements of `dstData`
+_JSI_WEBGL2_METHOD(getBufferSubData, 3) {
+  _JSI_UNPACK_ARGS(GLenum target, GLintptr srcByteOffset);
+  uint8_t *dst = nullptr;
+  size_t dstByteLength = 0;
+  if (!args[2].isObject() || args[2].getObject(runtime).isArrayBuffer(runtime) ||
+      !arrayData(args[2], dst, dstByteLength)) {
+    throw std::runtime_error("EXGL: gl.getBufferSubData() expects an ArrayBufferView!");
+  }
+  size_t elementSize = bytesPerElement(args[2]);
+  size_t dstOffset = argc > 3 ? number(args[3]) : 0;
+  size_t length = argc > 4 ? number(args[4]) : 0;
+  if (dstOffset * elementSize > dstByteLength) {
+    throw std::runtime_error("EXGL: gl.getBufferSubData() dstOffset is past the end of dstData!");
+  }
+  if (length == 0) {
+    length = dstByteLength / elementSize - dstOffset;
+  }
+  size_t byteLength = length * elementSize;
+  if ((dstOffset + length) * elementSize > dstByteLength) {
+    throw std::runtime_error("EXGL: gl.getBufferSubData() reads past the end of dstData!");
+  }
+  if (byteLength == 0) {
+    return jsi::Value::undefined();
+  }
+
+  // The JS thread waits, the GL thread can write straight into the ArrayBuffer
+  bool mapped = false;
+  ctx.addBlockingToNextBatch([&] {
+    void *data = glMapBufferRange(target, srcByteOffset, byteLength, GL_MAP_READ_BIT);
+    if (data) {
+      memcpy(dst + dstOffset * elementSize, data, byteLength);
+      glUnmapBuffer(target);
+      mapped = true;
+    }
+  });
+  if (!mapped) {
+    throw std::runtime_error("EXGL: gl.getBufferSubData() couldn't map the buffer range!");
+  }
+  return jsi::Value::undefined();
+}
+
+
+// Framebuffers
+// ------------
+
+_JSI_METHOD(bindFramebuffer, 2) {
+  _JSI_UNPACK_ARGS(GLenum target);
+  ctx.framebufferBound(target);
+  if (args[1].isNull()) {
+    // Read on the GL thread, where it's set
+    ctx.residency.bindFramebuffer(target, 0);
+    auto &exglCtx = ctx;
+    ctx.addToNextBatch([=, &exglCtx] { glBindFramebuffer(target, exglCtx.defaultFramebuffer); });
+  } else {
+    _JSI_UNPACK_ARGS_OFFSET(1, UEXGLObjectId fFramebuffer);
+    ctx.residency.bindFramebuffer(target, fFramebuffer);
+    ctx.addBindToNextBatch(glBindFramebuffer, target, fFramebuffer);
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(checkFramebufferStatus, 1) {
+  GLenum glResult;
+  _JSI_UNPACK_ARGS(GLenum target);
+  ctx.addBlockingToNextBatch([&] { glResult = glCheckFramebufferStatus(target); });
+  return (double) glResult;
+}
+
+_JSI_METHOD(createFramebuffer, 0) {
+  return (double) ctx.addFutureToNextBatch([] {
+    GLuint framebuffer;
+    glGenFramebuffers(1, &framebuffer);
+    return framebuffer;
+  });
+}
+
+_JSI_METHOD(deleteFramebuffer, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fFramebuffer);
+  ctx.residency.forget(fFramebuffer);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    GLuint framebuffer = exglCtx.lookupObject(fFramebuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(framebufferRenderbuffer, 4) {
+  _JSI_UNPACK_ARGS(GLenum target, GLenum attachment, GLenum renderbuffertarget, UEXGLObjectId fRenderbuffer);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    glFramebufferRenderbuffer(target, attachment, renderbuffertarget, exglCtx.lookupObject(fRenderbuffer));
+  });
+  exglCtx.traceLastClosure(EXGLTraceEvent::FramebufferRenderbuffer,
+                           { (double) target, (double) attachment, (double) renderbuffertarget, (double) fRenderbuffer });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(framebufferTexture2D, 5) {
+  _JSI_UNPACK_ARGS(GLenum target, GLenum attachment, GLenum textarget, UEXGLObjectId fTexture, GLint level);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    glFramebufferTexture2D(target, attachment, textarget, exglCtx.lookupObject(fTexture), level);
+  });
+  exglCtx.traceLastClosure(EXGLTraceEvent::FramebufferTexture2D,
+                           { (double) target, (double) attachment, (double) textarget, (double) fTexture, (double) level });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(getFramebufferAttachmentParameter, 3) {
+  _JSI_UNPACK_ARGS(GLenum target, GLenum attachment, GLenum pname);
+  GLint glResult = 0;
+  UEXGLObjectId exglObjId = 0;
+  ctx.addBlockingToNextBatch([&] {
+    glGetFramebufferAttachmentParameteriv(target, attachment, pname, &glResult);
+    if (pname == GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME) {
+      exglObjId = ctx.findObject(glResult);
+    }
+  });
+  if (pname == GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME) {
+    return objectOrNull(exglObjId);
+  }
+  return glResult;
+}
+
+_JSI_METHOD_IS_OBJECT(Framebuffer)
+
+_JSI_METHOD(readPixels, 7) {
+  _JSI_UNPACK_ARGS(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type);
+  uint8_t *pixels = nullptr;
+  size_t pixelsByteLength = 0;
+  if (!arrayData(args[6], pixels, pixelsByteLength) || !pixels) {
+    throw std::runtime_error("EXGL: gl.readPixels() expects an ArrayBufferView!");
+  }
+  if (format == GL_RGB && type == GL_UNSIGNED_BYTE) {
+    // Read RGBA and drop the alpha, like the JavaScriptCore binding. Rows follow
+    // the default PACK_ALIGNMENT of 4.
+    size_t rgbBytesPerRow = ((size_t) width * 3 + 3) & ~(size_t) 3;
+    if (pixelsByteLength < rgbBytesPerRow * height) {
+      throw std::runtime_error("EXGL: gl.readPixels() buffer is too small!");
+    }
+    auto rgba = std::shared_ptr<void>(malloc((size_t) width * height * 4), free);
+    ctx.addBlockingToNextBatch([&] {
+      glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.get());
+      for (GLsizei row = 0; row < height; ++row) {
+        EXGLPackRGBAToRGB((const uint8_t *) rgba.get() + (size_t) row * width * 4,
+                          pixels + row * rgbBytesPerRow, width);
+      }
+    });
+    return jsi::Value::undefined();
+  }
+  if (pixelsByteLength < (size_t) width * height * EXGLContext::bytesPerPixel(type, format)) {
+    throw std::runtime_error("EXGL: gl.readPixels() buffer is too small!");
+  }
+  // The JS thread waits, the GL thread can write straight into the ArrayBuffer
+  ctx.addBlockingToNextBatch([&] {
+    glReadPixels(x, y, width, height, format, type, pixels);
+  });
+  return jsi::Value::undefined();
+}
+
+
+// Framebuffers (WebGL2)
+// ---------------------
+
+_JSI_METHOD_SIMPLE(blitFramebuffer, glBlitFramebuffer,
+                   srcX0, srcY0, srcX1, srcY1,
+                   dstX0, dstY0, dstX1, dstY1,
+                   mask, filter)
+
+_JSI_WEBGL2_METHOD(framebufferTextureLayer, 5) {
+  _JSI_UNPACK_ARGS(GLenum target, GLenum attachment, UEXGLObjectId fTexture, GLint level, GLint layer);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    glFramebufferTextureLayer(target, attachment, exglCtx.lookupObject(fTexture), level, layer);
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(invalidateFramebuffer, 2) {
+  _JSI_UNPACK_ARGS(GLenum target);
+  auto attachments = uintArray(args[1]);
+  ctx.addToNextBatch([=] {
+    glInvalidateFramebuffer(target, (GLsizei) attachments.size(), attachments.data());
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(invalidateSubFramebuffer, 6) {
+  _JSI_UNPACK_ARGS(GLenum target);
+  _JSI_UNPACK_ARGS_OFFSET(2, GLint x, GLint y, GLsizei width, GLsizei height);
+  auto attachments = uintArray(args[1]);
+  ctx.addToNextBatch([=] {
+    glInvalidateSubFramebuffer(target, (GLsizei) attachments.size(), attachments.data(),
+                               x, y, width, height);
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD_SIMPLE(readBuffer, glReadBuffer, mode)
+
+
+// Renderbuffers
+// -------------
+
+_JSI_METHOD(bindRenderbuffer, 2) {
+  _JSI_UNPACK_ARGS(GLenum target, UEXGLObjectId fRenderbuffer);
+  ctx.residency.bindRenderbuffer(fRenderbuffer);
+  ctx.addBindToNextBatch(glBindRenderbuffer, target, fRenderbuffer);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(createRenderbuffer, 0) {
+  return (double) ctx.addFutureToNextBatch([] {
+    GLuint renderbuffer;
+    glGenRenderbuffers(1, &renderbuffer);
+    return renderbuffer;
+  });
+}
+
+_JSI_METHOD(deleteRenderbuffer, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fRenderbuffer);
+  ctx.residency.forget(fRenderbuffer);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    GLuint renderbuffer = exglCtx.lookupObject(fRenderbuffer);
+    glDeleteRenderbuffers(1, &renderbuffer);
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(getRenderbufferParameter, 2) {
+  _JSI_UNPACK_ARGS(GLenum target, GLenum pname);
+  GLint glResult;
+  ctx.addBlockingToNextBatch([&] { glGetRenderbufferParameteriv(target, pname, &glResult); });
+  return glResult;
+}
+
+_JSI_METHOD_IS_OBJECT(Renderbuffer)
+
+_JSI_METHOD(renderbufferStorage, 4) {
+  _JSI_UNPACK_ARGS(GLenum target, GLint internalformat, GLsizei width, GLsizei height);
+
+  // Same fallback as the JavaScriptCore binding
+  internalformat = internalformat == GL_DEPTH_STENCIL ? GL_DEPTH24_STENCIL8 : internalformat;
+
+  ctx.residency.renderbufferStorage(EXGLContext::imageBytes(internalformat, GL_NONE, GL_NONE, width, height));
+  ctx.addCallToNextBatch(glRenderbufferStorage, target, internalformat, width, height);
+  return jsi::Value::undefined();
+}
+
+
+// Renderbuffers (WebGL2)
+// ----------------------
+
+_JSI_WEBGL2_METHOD(getInternalformatParameter, 3) {
+  _JSI_UNPACK_ARGS(GLenum target, GLenum internalformat, GLenum pname);
+  if (pname != GL_SAMPLES) {
+    throw std::runtime_error("EXGL: Invalid pname for gl.getInternalformatParameter()!");
+  }
+  std::vector<GLint> samples;
+  ctx.addBlockingToNextBatch([&] {
+    GLint count = 0;
+    glGetInternalformativ(target, internalformat, GL_NUM_SAMPLE_COUNTS, 1, &count);
+    samples.resize(std::max(count, 0));
+    if (count > 0) {
+      glGetInternalformativ(target, internalformat, GL_SAMPLES, count, samples.data());
+    }
+  });
+  return makeTypedArray("Int32Array", samples.data(), samples.size() * sizeof(GLint));
+}
+
+_JSI_WEBGL2_METHOD(renderbufferStorageMultisample, 5) {
+  _JSI_UNPACK_ARGS(GLenum target, GLsizei samples, GLint internalformat, GLsizei width, GLsizei height);
+  internalformat = internalformat == GL_DEPTH_STENCIL ? GL_DEPTH24_STENCIL8 : internalformat;
+
+  // Each sample takes as much as a pixel of a single sampled renderbuffer
+  ctx.residency.renderbufferStorage(
+      std::max(samples, 1) * EXGLContext::imageBytes(internalformat, GL_NONE, GL_NONE, width, height));
+  ctx.addCallToNextBatch(glRenderbufferStorageMultisample, target, samples, internalformat, width, height);
+  return jsi::Value::undefined();
+}
+
+
+// Textures
+// --------
+
+_JSI_METHOD(bindTexture, 2) {
+  _JSI_UNPACK_ARGS(GLenum target);
+  if (args[1].isNull()) {
+    ctx.residency.bindTexture(target, 0);
+    if (ctx.shadowState.updateTexture(target, 0)) {
+      ctx.addCallToNextBatch(glBindTexture, target, 0);
+    }
+  } else {
+    _JSI_UNPACK_ARGS_OFFSET(1, UEXGLObjectId fTexture);
+    ctx.residency.bindTexture(target, fTexture);
+    if (ctx.shadowState.updateTexture(target, fTexture)) {
+      ctx.addBindToNextBatch(glBindTexture, target, fTexture);
+    }
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(compressedTexImage2D, 7) {
+  _JSI_UNPACK_ARGS(GLenum target, GLint level, GLenum internalformat,
+                   GLsizei width, GLsizei height, GLint border);
+  if (args[6].isNumber()) {
+    // WebGL2: (imageSize, offset) into the bound PIXEL_UNPACK_BUFFER
+    if (argc < 8) {
+      throw std::runtime_error("EXGL: Too few arguments to compressedTexImage2D()!");
+    }
+    _JSI_UNPACK_ARGS_OFFSET(6, GLsizei imageSize, GLintptr offset);
+    ctx.residency.textureImage(target, level, imageSize);
+    ctx.addToNextBatch([=] {
+      glCompressedTexImage2D(target, level, internalformat, width, height, border,
+                             imageSize, (const void *) offset);
+    });
+    return jsi::Value::undefined();
+  }
+  size_t byteLength;
+  auto data = copyArray(args[6], &byteLength);
+  if (!data) {
+    throw std::runtime_error("EXGL: Invalid data argument for gl.compressedTexImage2D()!");
+  }
+  ctx.residency.textureImage(target, level, byteLength);
+  ctx.addToNextBatch([=] {
+    glCompressedTexImage2D(target, level, internalformat, width, height, border,
+                           (GLsizei) byteLength, data.get());
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(compressedTexSubImage2D, 8) {
+  _JSI_UNPACK_ARGS(GLenum target, GLint level, GLint xoffset, GLint yoffset,
+                   GLsizei width, GLsizei height, GLenum format);
+  if (args[7].isNumber()) {
+    if (argc < 9) {
+      throw std::runtime_error("EXGL: Too few arguments to compressedTexSubImage2D()!");
+    }
+    _JSI_UNPACK_ARGS_OFFSET(7, GLsizei imageSize, GLintptr offset);
+    ctx.addToNextBatch([=] {
+      glCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format,
+                                imageSize, (const void *) offset);
+    });
+    return jsi::Value::undefined();
+  }
+  size_t byteLength;
+  auto data = copyArray(args[7], &byteLength);
+  if (!data) {
+    throw std::runtime_error("EXGL: Invalid data argument for gl.compressedTexSubImage2D()!");
+  }
+  ctx.addToNextBatch([=] {
+    glCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format,
+                              (GLsizei) byteLength, data.get());
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(copyTexImage2D, 8) {
+  _JSI_UNPACK_ARGS(GLenum target, GLint level, GLenum internalformat,
+                   GLint x, GLint y, GLsizei width, GLsizei height, GLint border);
+  // Unsized formats take the framebuffer's, assume 8 bits per component
+  ctx.residency.textureImage(target, level, EXGLContext::imageBytes(internalformat, internalformat,
+                                                                    GL_UNSIGNED_BYTE, width, height));
+  ctx.addCallToNextBatch(glCopyTexImage2D, target, level, internalformat, x, y, width, height, border);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD_SIMPLE(copyTexSubImage2D, glCopyTexSubImage2D,
+                   target, level,
+                   xoffset, yoffset, x, y, width, height)
+
+_JSI_METHOD(createTexture, 0) {
+  return (double) ctx.addFutureToNextBatch([] {
+    GLuint texture;
+    glGenTextures(1, &texture);
+    return texture;
+  });
+}
+
+_JSI_METHOD(deleteTexture, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fTexture);
+  ctx.shadowState.forgetObject(fTexture);
+  ctx.residency.forget(fTexture);
+  ctx.forgetTextureStorage(fTexture);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    if (!exglCtx.removeExternalTexture(fTexture)) {
+      GLuint texture = exglCtx.lookupObject(fTexture);
+      glDeleteTextures(1, &texture);
+    }
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(generateMipmap, 1) {
+  _JSI_UNPACK_ARGS(GLenum target);
+  ctx.residency.textureMipmaps(target);
+  ctx.addCallToNextBatch(glGenerateMipmap, target);
+  return jsi::Value::undefined();
+}
+
+// Local file path of an object with a `.localUri` member
+bool EXGLJsiContext::localPathFromImage(const jsi::Value &value, std::string &path) {
+  if (!value.isObject()) {
+    return false;
+  }
+  auto jsLocalUri = value.getObject(runtime).getProperty(runtime, "localUri");
+  if (!jsLocalUri.isString()) {
+    return false;
+  }
+  auto localUri = jsLocalUri.getString(runtime).utf8(runtime);
+  if (localUri.compare(0, 7, "file://") != 0) {
+    return false;
+  }
+  std::vector<char> localPath(localUri.size() + 1);
+  ctx.decodeURI(localPath.data(), localUri.c_str() + 7);
+  path = localPath.data();
+  return true;
+}
+
+// `.width` and `.height` of an image source, 0 if missing
+void EXGLJsiContext::imageSizeFromObject(const jsi::Value &value, GLsizei *width, GLsizei *height) {
+  auto object = value.getObject(runtime);
+  auto jsWidth = object.getProperty(runtime, "width");
+  auto jsHeight = object.getProperty(runtime, "height");
+  *width = jsWidth.isNumber() ? (GLsizei) jsWidth.getNumber() : 0;
+  *height = jsHeight.isNumber() ? (GLsizei) jsHeight.getNumber() : 0;
+}
+
+// `{ fontFamily, fontSize, fontWeight, fontStyle, color, maxWidth, textAlign }`,
+// missing members keep their defaults
+UEXGLTextStyle EXGLJsiContext::textStyleFromObject(const jsi::Value &value) {
+  UEXGLTextStyle style;
+  if (!value.isObject()) {
+    return style;
+  }
+  auto object = value.getObject(runtime);
+  auto stringNamed = [&](const char *name) -> std::string {
+    auto jsValue = object.getProperty(runtime, name);
+    return jsValue.isString() ? jsValue.getString(runtime).utf8(runtime) : "";
+  };
+  auto numberNamed = [&](const char *name, double fallback) -> double {
+    auto jsValue = object.getProperty(runtime, name);
+    return jsValue.isNumber() ? jsValue.getNumber() : fallback;
+  };
+  style.fontFamily = stringNamed("fontFamily");
+  style.fontSize = numberNamed("fontSize", style.fontSize);
+  style.bold = EXGLFontWeightIsBold(stringNamed("fontWeight")) || numberNamed("fontWeight", 400) >= 600;
+  style.italic = stringNamed("fontStyle") == "italic";
+  style.color = (uint32_t) numberNamed("color", style.color);
+  style.maxWidth = numberNamed("maxWidth", style.maxWidth);
+  style.align = EXGLTextAlignFromString(stringNamed("textAlign"));
+  return style;
+}
+
+_JSI_METHOD(texImage2D, 6) {
+  GLenum target;
+  GLint level, internalformat;
+  GLsizei width = 0, height = 0, border = 0;
+  GLenum format, type;
+  const jsi::Value *jsPixels;
+
+  if (argc == 9) {
+    // 9-argument version
+    _JSI_UNPACK_ARGS(target, level, internalformat, width, height, border, format, type);
+    jsPixels = &args[8];
+  } else if (argc == 6) {
+    // 6-argument version
+    _JSI_UNPACK_ARGS(target, level, internalformat, format, type);
+    jsPixels = &args[5];
+  } else {
+    throw std::runtime_error("EXGL: Invalid number of arguments to gl.texImage2D()!");
+  }
+
+  // Null?
+  if (jsPixels->isNull()) {
+    ctx.residency.textureImage(target, level,
+                               EXGLContext::imageBytes(internalformat, format, type, width, height));
+    ctx.addToNextBatch([=] {
+      glTexImage2D(target, level, internalformat, width, height, border, format, type, nullptr);
+    });
+    ctx.traceLastClosure(EXGLTraceEvent::TexImage2D, { (double) target, (double) level, (double) internalformat,
+                         (double) width, (double) height, (double) border, (double) format, (double) type });
+    return jsi::Value::undefined();
+  }
+
+  // Try TypedArray
+  std::shared_ptr<void> data(nullptr);
+  size_t length = 0;
+  if (argc == 9) {
+    data = copyArray(*jsPixels, &length);
+  }
+  if (data) {
+    // Converted on the GL thread, the data is a copy
+    bool flipY = ctx.unpackFLipY, premultiplyAlpha = ctx.unpackPremultiplyAlpha;
+    ctx.residency.textureImage(target, level,
+                               EXGLContext::imageBytes(internalformat, format, type, width, height));
+    ctx.addToNextBatch([=] {
+      EXGLContext::unpackPixels(data.get(), width, height, 1, format, type, flipY, premultiplyAlpha);
+      glTexImage2D(target, level, internalformat, width, height, border, format, type, data.get());
+    });
+    ctx.traceLastClosure(EXGLTraceEvent::TexImage2D, { (double) target, (double) level, (double) internalformat,
+                         (double) width, (double) height, (double) border, (double) format, (double) type },
+                         data.get(), length);
+    return jsi::Value::undefined();
+  }
+
+  // Try object with `.localUri` member, used from a mapping if it's pre-baked
+  // pixels and decoded off the JS thread otherwise
+  std::string localPath;
+  if (localPathFromImage(*jsPixels, localPath)) {
+    GLsizei fileWidth, fileHeight;
+    imageSizeFromObject(*jsPixels, &fileWidth, &fileHeight);
+    if (ctx.addMappedImageToNextBatch(localPath, fileWidth, fileHeight, target, level,
+                                      internalformat, format, type, false, 0, 0)) {
+      return jsi::Value::undefined();
+    }
+    auto image = EXGLImageLoader::shared().load(localPath, ctx.unpackFLipY, ctx.unpackPremultiplyAlpha);
+    UEXGLObjectId fTexture = ctx.residency.boundTexture(target);
+    auto &exglCtx = ctx;
+    exglCtx.addToNextBatch([=, &exglCtx] {
+      const EXGLImage &decoded = image.get();
+      if (!decoded.data) {
+        EXGLSysLog("EXGL: Couldn't decode image for gl.texImage2D()!");
+        return;
+      }
+      glTexImage2D(target, level, internalformat, decoded.width, decoded.height, border,
+                   format, type, decoded.data.get());
+      exglCtx.reportTextureImage(fTexture, target, level,
+                                 EXGLContext::imageBytes(internalformat, format, type,
+                                                         decoded.width, decoded.height));
+    });
+    return jsi::Value::undefined();
+  }
+
+  // Nothing worked...
+  throw std::runtime_error("EXGL: Invalid pixel data argument for gl.texImage2D()!");
+}
+
+_JSI_METHOD(texSubImage2D, 7) {
+  GLenum target;
+  GLint level, xoffset, yoffset;
+  GLsizei width = 0, height = 0;
+  GLenum format, type;
+  const jsi::Value *jsPixels;
+
+  if (argc == 9) {
+    // 9-argument version
+    _JSI_UNPACK_ARGS(target, level, xoffset, yoffset, width, height, format, type);
+    jsPixels = &args[8];
+  } else if (argc == 7) {
+    // 7-argument version
+    _JSI_UNPACK_ARGS(target, level, xoffset, yoffset, format, type);
+    jsPixels = &args[6];
+  } else {
+    throw std::runtime_error("EXGL: Invalid number of arguments to gl.texSubImage2D()!");
+  }
+
+  // Null?
+  if (jsPixels->isNull()) {
+    ctx.addToNextBatch([=] {
+      void *nulled = calloc(width * height, EXGLContext::bytesPerPixel(type, format));
+      glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, nulled);
+      free(nulled);
+    });
+    return jsi::Value::undefined();
+  }
+
+  // Try TypedArray
+  std::shared_ptr<void> data(nullptr);
+  size_t length = 0;
+  if (argc == 9) {
+    data = copyArray(*jsPixels, &length);
+  }
+  if (data) {
+    if (ctx.uploadsUnpacked(target)) {
+      ctx.addToNextBatch([=] {
+        glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, data.get());
+      });
+    } else {
+      // Converted on the GL thread, the data is a copy
+      bool flipY = ctx.unpackFLipY, premultiplyAlpha = ctx.unpackPremultiplyAlpha;
+      ctx.addToNextBatch([=] {
+        EXGLContext::unpackPixels(data.get(), width, height, 1, format, type, flipY, premultiplyAlpha);
+        glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, data.get());
+      });
+    }
+    ctx.traceLastClosure(EXGLTraceEvent::TexSubImage2D, { (double) target, (double) level, (double) xoffset,
+                         (double) yoffset, (double) width, (double) height, (double) format, (double) type },
+                         data.get(), length);
+    return jsi::Value::undefined();
+  }
+
+  // Try object with `.localUri` member, used from a mapping if it's pre-baked
+  // pixels and decoded off the JS thread otherwise
+  std::string localPath;
+  if (localPathFromImage(*jsPixels, localPath)) {
+    GLsizei fileWidth, fileHeight;
+    imageSizeFromObject(*jsPixels, &fileWidth, &fileHeight);
+    if (ctx.addMappedImageToNextBatch(localPath, fileWidth, fileHeight, target, level, 0,
+                                      format, type, true, xoffset, yoffset)) {
+      return jsi::Value::undefined();
+    }
+    auto image = EXGLImageLoader::shared().load(localPath, ctx.unpackFLipY, ctx.unpackPremultiplyAlpha);
+    ctx.addToNextBatch([=] {
+      const EXGLImage &decoded = image.get();
+      if (!decoded.data) {
+        EXGLSysLog("EXGL: Couldn't decode image for gl.texSubImage2D()!");
+        return;
+      }
+      glTexSubImage2D(target, level, xoffset, yoffset, decoded.width, decoded.height,
+                      format, type, decoded.data.get());
+    });
+    return jsi::Value::undefined();
+  }
+
+  // Nothing worked...
+  throw std::runtime_error("EXGL: Invalid pixel data argument for gl.texSubImage2D()!");
+}
+
+_JSI_METHOD_SIMPLE(texParameterf, glTexParameterf, target, pname, param)
+
+_JSI_METHOD_SIMPLE(texParameteri, glTexParameteri, target, pname, param)
+
+_JSI_METHOD(getTexParameter, 2) {
+  _JSI_UNPACK_ARGS(GLenum target, GLenum pname);
+  GLint glInt;
+  if (ctx.textureStorageParameter(target, pname, &glInt)) {
+    if (pname == GL_TEXTURE_IMMUTABLE_FORMAT) {
+      return (bool) glInt;
+    }
+    return (double) glInt;
+  }
+  switch (pname) {
+    case GL_TEXTURE_MIN_LOD:
+    case GL_TEXTURE_MAX_LOD: {
+      GLfloat glFloat;
+      ctx.addBlockingToNextBatch([&] { glGetTexParameterfv(target, pname, &glFloat); });
+      return (double) glFloat;
+    }
+    default:
+      ctx.addBlockingToNextBatch([&] { glGetTexParameteriv(target, pname, &glInt); });
+      return (double) glInt;
+  }
+}
+
+_JSI_METHOD_IS_OBJECT(Texture)
+
+
+// Textures (WebGL2)
+// -----------------
+
+_JSI_METHOD(texStorage2D, 5) {
+  _JSI_UNPACK_ARGS(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height);
+  ctx.addTexStorageToNextBatch(false, target, levels, internalformat, width, height, 1);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(texStorage3D, 6) {
+  _JSI_UNPACK_ARGS(GLenum target, GLsizei levels, GLenum internalformat,
+                   GLsizei width, GLsizei height, GLsizei depth);
+  ctx.addTexStorageToNextBatch(true, target, levels, internalformat, width, height, depth);
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(texImage3D, 10) {
+  _JSI_UNPACK_ARGS(GLenum target, GLint level, GLint internalformat,
+                   GLsizei width, GLsizei height, GLsizei depth, GLint border,
+                   GLenum format, GLenum type);
+  const jsi::Value &jsPixels = args[9];
+
+  // Null?
+  if (jsPixels.isNull()) {
+    ctx.residency.textureImage(target, level,
+                               EXGLContext::imageBytes(internalformat, format, type, width, height, depth));
+    ctx.addToNextBatch([=] {
+      glTexImage3D(target, level, internalformat, width, height, depth, border, format, type, nullptr);
+    });
+    return jsi::Value::undefined();
+  }
+
+  // Try TypedArray, only the part read from `srcOffset` on if it's given
+  std::shared_ptr<void> data(nullptr);
+  if (argc > 10) {
+    data = copySubarray(jsPixels, (size_t) number(args[10]),
+                        EXGLContext::unpackedImageBytes(width, height, depth, format, type), "texImage3D");
+  } else {
+    data = copyArray(jsPixels, nullptr);
+  }
+  if (data) {
+    // Converted on the GL thread, the data is a copy
+    bool flipY = ctx.unpackFLipY, premultiplyAlpha = ctx.unpackPremultiplyAlpha;
+    ctx.residency.textureImage(target, level,
+                               EXGLContext::imageBytes(internalformat, format, type, width, height, depth));
+    ctx.addToNextBatch([=] {
+      EXGLContext::unpackPixels(data.get(), width, height, depth, format, type, flipY, premultiplyAlpha);
+      glTexImage3D(target, level, internalformat, width, height, depth, border, format, type, data.get());
+    });
+    return jsi::Value::undefined();
+  }
+
+  // Try object with `.localUri` member, decoded off the JS thread
+  std::string localPath;
+  if (localPathFromImage(jsPixels, localPath)) {
+    auto image = EXGLImageLoader::shared().load(localPath, ctx.unpackFLipY, ctx.unpackPremultiplyAlpha);
+    UEXGLObjectId fTexture = ctx.residency.boundTexture(target);
+    auto &exglCtx = ctx;
+    exglCtx.addToNextBatch([=, &exglCtx] {
+      const EXGLImage &decoded = image.get();
+      if (!decoded.data) {
+        EXGLSysLog("EXGL: Couldn't decode image for gl.texImage3D()!");
+        return;
+      }
+      glTexImage3D(target, level, internalformat, decoded.width, decoded.height, depth, border,
+                   format, type, decoded.data.get());
+      exglCtx.reportTextureImage(fTexture, target, level,
+                                 EXGLContext::imageBytes(internalformat, format, type,
+                                                         decoded.width, decoded.height, depth));
+    });
+    return jsi::Value::undefined();
+  }
+
+  // Nothing worked...
+  throw std::runtime_error("EXGL: Invalid pixel data argument for gl.texImage3D()!");
+}
+
+_JSI_WEBGL2_METHOD(texSubImage3D, 11) {
+  _JSI_UNPACK_ARGS(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset,
+                   GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type);
+  const jsi::Value &jsPixels = args[10];
+
+  // Null?
+  if (jsPixels.isNull()) {
+    ctx.addToNextBatch([=] {
+      void *nulled = calloc(EXGLContext::unpackedImageBytes(width, height, depth, format, type), 1);
+      glTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, nulled);
+      free(nulled);
+    });
+    return jsi::Value::undefined();
+  }
+
+  // Try TypedArray, only the part read from `srcOffset` on if it's given
+  std::shared_ptr<void> data(nullptr);
+  if (argc > 11) {
+    data = copySubarray(jsPixels, (size_t) number(args[11]),
+                        EXGLContext::unpackedImageBytes(width, height, depth, format, type), "texSubImage3D");
+  } else {
+    data = copyArray(jsPixels, nullptr);
+  }
+  if (data) {
+    bool unpack = !ctx.uploadsUnpacked(target);
+    bool flipY = ctx.unpackFLipY, premultiplyAlpha = ctx.unpackPremultiplyAlpha;
+    ctx.addToNextBatch([=] {
+      if (unpack) {
+        EXGLContext::unpackPixels(data.get(), width, height, depth, format, type, flipY, premultiplyAlpha);
+      }
+      glTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, data.get());
+    });
+    return jsi::Value::undefined();
+  }
+
+  // Try object with `.localUri` member, decoded off the JS thread
+  std::string localPath;
+  if (localPathFromImage(jsPixels, localPath)) {
+    auto image = EXGLImageLoader::shared().load(localPath, ctx.unpackFLipY, ctx.unpackPremultiplyAlpha);
+    ctx.addToNextBatch([=] {
+      const EXGLImage &decoded = image.get();
+      if (!decoded.data) {
+        EXGLSysLog("EXGL: Couldn't decode image for gl.texSubImage3D()!");
+        return;
+      }
+      glTexSubImage3D(target, level, xoffset, yoffset, zoffset, decoded.width, decoded.height, depth,
+                      format, type, decoded.data.get());
+    });
+    return jsi::Value::undefined();
+  }
+
+  // Nothing worked...
+  throw std::runtime_error("EXGL: Invalid pixel data argument for gl.texSubImage3D()!");
+}
+
+_JSI_WEBGL2_METHOD_SIMPLE(copyTexSubImage3D, glCopyTexSubImage3D,
+                          target, level, xoffset, yoffset, zoffset, x, y, width, height)
+
+_JSI_WEBGL2_METHOD(compressedTexImage3D, 8) {
+  _JSI_UNPACK_ARGS(GLenum target, GLint level, GLenum internalformat,
+                   GLsizei width, GLsizei height, GLsizei depth, GLint border);
+  if (args[7].isNumber()) {
+    if (argc < 9) {
+      throw std::runtime_error("EXGL: Too few arguments to compressedTexImage3D()!");
+    }
+    _JSI_UNPACK_ARGS_OFFSET(7, GLsizei imageSize, GLintptr offset);
+    ctx.residency.textureImage(target, level, imageSize);
+    ctx.addToNextBatch([=] {
+      glCompressedTexImage3D(target, level, internalformat, width, height, depth, border,
+                             imageSize, (const void *) offset);
+    });
+    return jsi::Value::undefined();
+  }
+  size_t byteLength;
+  auto data = copyArray(args[7], &byteLength);
+  if (!data) {
+    throw std::runtime_error("EXGL: Invalid data argument for gl.compressedTexImage3D()!");
+  }
+  ctx.residency.textureImage(target, level, byteLength);
+  ctx.addToNextBatch([=] {
+    glCompressedTexImage3D(target, level, internalformat, width, height, depth, border,
+                           (GLsizei) byteLength, data.get());
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(compressedTexSubImage3D, 10) {
+  _JSI_UNPACK_ARGS(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset,
+                   GLsizei width, GLsizei height, GLsizei depth, GLenum format);
+  if (args[9].isNumber()) {
+    if (argc < 11) {
+      throw std::runtime_error("EXGL: Too few arguments to compressedTexSubImage3D()!");
+    }
+    _JSI_UNPACK_ARGS_OFFSET(9, GLsizei imageSize, GLintptr offset);
+    ctx.addToNextBatch([=] {
+      glCompressedTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth,
+                                format, imageSize, (const void *) offset);
+    });
+    return jsi::Value::undefined();
+  }
+  size_t byteLength;
+  auto data = copyArray(args[9], &byteLength);
+  if (!data) {
+    throw std::runtime_error("EXGL: Invalid data argument for gl.compressedTexSubImage3D()!");
+  }
+  ctx.addToNextBatch([=] {
+    glCompressedTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth,
+                              format, (GLsizei) byteLength, data.get());
+  });
+  return jsi::Value::undefined();
+}
+
+
+// Programs and shaders
+// --------------------
+
+_JSI_METHOD(attachShader, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram, UEXGLObjectId fShader);
+  ctx.noteAttachShader(fProgram, fShader);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] { glAttachShader(exglCtx.lookupObject(fProgram), exglCtx.lookupObject(fShader)); });
+  exglCtx.traceLastClosure(EXGLTraceEvent::AttachShader, { (double) fProgram, (double) fShader });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(bindAttribLocation, 3) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram, GLuint index);
+  auto name = std::make_shared<std::string>(string(args[2]));
+  ctx.noteProgramBinding(fProgram, &index, sizeof(index));
+  ctx.noteProgramBinding(fProgram, name->c_str(), name->size() + 1);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] { glBindAttribLocation(exglCtx.lookupObject(fProgram), index, name->c_str()); });
+  exglCtx.traceLastClosure(EXGLTraceEvent::BindAttribLocation, { (double) fProgram, (double) index },
+                           name->data(), name->size());
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(compileShader, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fShader);
+  ctx.addCompileShaderToNextBatch(fShader);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(createProgram, 0) {
+  auto fProgram = ctx.addFutureToNextBatch(&glCreateProgram);
+  ctx.traceLastClosure(EXGLTraceEvent::CreateProgram, { (double) fProgram });
+  return (double) fProgram;
+}
+
+_JSI_METHOD(createShader, 1) {
+  _JSI_UNPACK_ARGS(GLenum type);
+  if (type == GL_VERTEX_SHADER || type == GL_FRAGMENT_SHADER) {
+    auto fShader = ctx.addFutureToNextBatch(std::bind(glCreateShader, type));
+    ctx.traceLastClosure(EXGLTraceEvent::CreateShader, { (double) fShader, (double) type });
+    return (double) fShader;
+  } else {
+    return jsi::Value::null();
+  }
+}
+
+_JSI_METHOD(deleteProgram, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+  ctx.programInfos.erase(fProgram);
+  ctx.forgetProgramSources(fProgram);
+  ctx.addUseToNextBatch(glDeleteProgram, fProgram);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(deleteShader, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fShader);
+  ctx.shaderCompileStatus.erase(fShader);
+  ctx.shaderSourceHashes.erase(fShader);
+  ctx.shaderCompiles.erase(fShader);
+  ctx.addUseToNextBatch(glDeleteShader, fShader);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(detachShader, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram, UEXGLObjectId fShader);
+  ctx.noteDetachShader(fProgram, fShader);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] { glDetachShader(exglCtx.lookupObject(fProgram), exglCtx.lookupObject(fShader)); });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(getAttachedShaders, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+  std::vector<UEXGLObjectId> shaders;
+  ctx.addBlockingToNextBatch([&] {
+    GLuint program = ctx.lookupObject(fProgram);
+    GLint count = 0;
+    glGetProgramiv(program, GL_ATTACHED_SHADERS, &count);
+    std::vector<GLuint> glResults(std::max(count, 0));
+    glGetAttachedShaders(program, count, nullptr, glResults.data());
+    for (auto glResult : glResults) {
+      shaders.push_back(ctx.findObject(glResult));
+    }
+  });
+
+  jsi::Array jsResults(runtime, shaders.size());
+  for (size_t i = 0; i < shaders.size(); ++i) {
+    if (shaders[i] == 0) {
+      throw std::runtime_error("EXGL: Internal error: couldn't find UEXGLObjectId "
+                               "associated with shader in getAttachedShaders()!");
+    }
+    jsResults.setValueAtIndex(runtime, i, (double) shaders[i]);
+  }
+  return jsi::Value(runtime, jsResults);
+}
+
+_JSI_METHOD(getProgramParameter, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram, GLenum pname);
+  if (pname == GL_COMPLETION_STATUS_KHR) {
+    return ctx.programCompletionStatus(fProgram);
+  }
+  if (pname == GL_LINK_STATUS || pname == GL_ACTIVE_UNIFORMS || pname == GL_ACTIVE_ATTRIBUTES) {
+    // Fixed at link time
+    if (auto info = ctx.programInfo(fProgram)) {
+      switch (pname) {
+        case GL_LINK_STATUS:
+          return info->linkStatus != GL_FALSE;
+        case GL_ACTIVE_UNIFORMS:
+          return (double) info->uniforms.size();
+        default:
+          return (double) info->attributes.size();
+      }
+    }
+  }
+  GLint glResult;
+  ctx.addBlockingToNextBatch([&] { glGetProgramiv(ctx.lookupObject(fProgram), pname, &glResult); });
+  if (pname == GL_DELETE_STATUS || pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) {
+    return glResult != GL_FALSE;
+  } else {
+    return glResult;
+  }
+}
+
+_JSI_METHOD(getShaderParameter, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fShader, GLenum pname);
+  if (pname == GL_COMPLETION_STATUS_KHR) {
+    return ctx.shaderCompletionStatus(fShader);
+  }
+  if (pname == GL_COMPILE_STATUS) {
+    auto iter = ctx.shaderCompileStatus.find(fShader);
+    if (iter != ctx.shaderCompileStatus.end()) {
+      return iter->second != GL_FALSE;
+    }
+  }
+  GLint glResult;
+  ctx.addBlockingToNextBatch([&] { glGetShaderiv(ctx.lookupObject(fShader), pname, &glResult); });
+  if (pname == GL_COMPILE_STATUS) {
+    ctx.shaderCompileStatus[fShader] = glResult;
+  }
+  if (pname == GL_DELETE_STATUS || pname == GL_COMPILE_STATUS) {
+    return glResult != GL_FALSE;
+  } else {
+    return glResult;
+  }
+}
+
+_JSI_METHOD(getShaderPrecisionFormat, 2) {
+  _JSI_UNPACK_ARGS(GLenum shaderType, GLenum precisionType);
+  GLint range[2], precision;
+  ctx.addBlockingToNextBatch([&] {
+    glGetShaderPrecisionFormat(shaderType, precisionType, range, &precision);
+  });
+  jsi::Object jsResult(runtime);
+  jsResult.setProperty(runtime, "rangeMin", range[0]);
+  jsResult.setProperty(runtime, "rangeMax", range[1]);
+  jsResult.setProperty(runtime, "precision", precision);
+  return jsi::Value(runtime, jsResult);
+}
+
+_JSI_METHOD(getProgramInfoLog, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+  std::string str;
+  ctx.addBlockingToNextBatch([&] {
+    GLuint program = ctx.lookupObject(fProgram);
+    GLint length;
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+    str.resize(length);
+    glGetProgramInfoLog(program, length, nullptr, &str[0]);
+  });
+  return jsi::String::createFromUtf8(runtime, str.c_str());
+}
+
+_JSI_METHOD(getShaderInfoLog, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fShader);
+  std::string str;
+  ctx.addBlockingToNextBatch([&] {
+    GLuint shader = ctx.lookupObject(fShader);
+    GLint length;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+    str.resize(length);
+    glGetShaderInfoLog(shader, length, nullptr, &str[0]);
+  });
+  return jsi::String::createFromUtf8(runtime, str.c_str());
+}
+
+_JSI_METHOD(getShaderSource, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fShader);
+  std::string str;
+  ctx.addBlockingToNextBatch([&] {
+    GLuint shader = ctx.lookupObject(fShader);
+    GLint length;
+    glGetShaderiv(shader, GL_SHADER_SOURCE_LENGTH, &length);
+    str.resize(length);
+    glGetShaderSource(shader, length, nullptr, &str[0]);
+  });
+  return jsi::String::createFromUtf8(runtime, str.c_str());
+}
+
+_JSI_METHOD_IS_OBJECT(Program)
+
+_JSI_METHOD_IS_OBJECT(Shader)
+
+_JSI_METHOD(linkProgram, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+  ctx.addLinkProgramToNextBatch(fProgram);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(shaderSource, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fShader);
+  auto str = std::make_shared<std::string>(string(args[1]));
+  ctx.noteShaderSource(fShader, str->data(), str->size());
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    const char *pstr = str->c_str();
+    glShaderSource(exglCtx.lookupObject(fShader), 1, &pstr, nullptr);
+  });
+  exglCtx.traceLastClosure(EXGLTraceEvent::ShaderSource, { (double) fShader }, str->data(), str->size());
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(useProgram, 1) {
+  const double values[] = { number(args[0]) };
+  ctx.residency.useProgram((UEXGLObjectId) values[0]);
+  if (!ctx.shadowState.update(EXGLShadowState::Program, values, 1)) {
+    return jsi::Value::undefined();
+  }
+  if (args[0].isNull()) {
+    ctx.addCallToNextBatch(glUseProgram, 0);
+  } else {
+    _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+    ctx.addUseToNextBatch(glUseProgram, fProgram);
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(validateProgram, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+  ctx.addUseToNextBatch(glValidateProgram, fProgram);
+  return jsi::Value::undefined();
+}
+
+
+// Programs and shaders (WebGL2)
+// -----------------------------
+
+_JSI_METHOD(getFragDataLocation, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+  auto name = string(args[1]);
+  GLint location;
+  ctx.addBlockingToNextBatch([&] {
+    location = glGetFragDataLocation(ctx.lookupObject(fProgram), name.c_str());
+  });
+  return location == -1 ? jsi::Value::null() : jsi::Value(location);
+}
+
+
+// Uniforms and attributes
+// -----------------------
+
+_JSI_METHOD(disableVertexAttribArray, 1) {
+  _JSI_UNPACK_ARGS(GLuint index);
+  if (ctx.vertexArrays.enable(index, false)) {
+    ctx.addCallToNextBatch(glDisableVertexAttribArray, index);
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(enableVertexAttribArray, 1) {
+  _JSI_UNPACK_ARGS(GLuint index);
+  if (ctx.vertexArrays.enable(index, true)) {
+    ctx.addCallToNextBatch(glEnableVertexAttribArray, index);
+  }
+  return jsi::Value::undefined();
+}
+
+// Active attributes and uniforms only come from the query cache here, programs
+// are always reflected when they're linked
+#define _JSI_METHOD_ACTIVE_INFO(method, member)                                \
+_JSI_METHOD(method, 2) {                                                       \
+  if (args[0].isNull()) {                                                      \
+    return jsi::Value::null();                                                 \
+  }                                                                            \
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram, GLuint index);                      \
+  auto info = ctx.programInfo(fProgram);                                       \
+  if (!info || index >= info->member.size()) {                                 \
+    return jsi::Value::null();                                                 \
+  }                                                                            \
+  const auto &active = info->member[index];                                    \
+  return makeActiveInfo(active.name.c_str(), active.size, active.type);        \
+}
+_JSI_METHOD_ACTIVE_INFO(getActiveAttrib, attributes)
+_JSI_METHOD_ACTIVE_INFO(getActiveUniform, uniforms)
+
+_JSI_METHOD(getAttribLocation, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+  auto name = string(args[1]);
+  if (auto info = ctx.programInfo(fProgram)) {
+    auto iter = info->attribLocations.find(name);
+    return iter == info->attribLocations.end() ? -1 : iter->second;
+  }
+  GLint location;
+  ctx.addBlockingToNextBatch([&] {
+    location = glGetAttribLocation(ctx.lookupObject(fProgram), name.c_str());
+  });
+  return location;
+}
+
+// How `getUniform` reads and returns a uniform of type `type`, false if it
+// isn't a GLSL ES 3.00 type
+enum class EXGLUniformKind { Float, Int, UInt, Bool };
+static bool EXGLUniformTypeInfo(GLenum type, EXGLUniformKind &kind, GLint &components) noexcept {
+  switch (type) {
+    case GL_FLOAT: kind = EXGLUniformKind::Float; components = 1; return true;
+    case GL_FLOAT_VEC2: kind = EXGLUniformKind::Float; components = 2; return true;
+    case GL_FLOAT_VEC3: kind = EXGLUniformKind::Float; components = 3; return true;
+    case GL_FLOAT_VEC4: kind = EXGLUniformKind::Float; components = 4; return true;
+    case GL_FLOAT_MAT2: kind = EXGLUniformKind::Float; components = 4; return true;
+    case GL_FLOAT_MAT3: kind = EXGLUniformKind::Float; components = 9; return true;
+    case GL_FLOAT_MAT4: kind = EXGLUniformKind::Float; components = 16; return true;
+    case GL_FLOAT_MAT2x3: kind = EXGLUniformKind::Float; components = 6; return true;
+    case GL_FLOAT_MAT2x4: kind = EXGLUniformKind::Float; components = 8; return true;
+    case GL_FLOAT_MAT3x2: kind = EXGLUniformKind::Float; components = 6; return true;
+    case GL_FLOAT_MAT3x4: kind = EXGLUniformKind::Float; components = 12; return true;
+    case GL_FLOAT_MAT4x2: kind = EXGLUniformKind::Float; components = 8; return true;
+    case GL_FLOAT_MAT4x3: kind = EXGLUniformKind::Float; components = 12; return true;
+    case GL_INT: kind = EXGLUniformKind::Int; components = 1; return true;
+    case GL_INT_VEC2: kind = EXGLUniformKind::Int; components = 2; return true;
+    case GL_INT_VEC3: kind = EXGLUniformKind::Int; components = 3; return true;
+    case GL_INT_VEC4: kind = EXGLUniformKind::Int; components = 4; return true;
+    case GL_UNSIGNED_INT: kind = EXGLUniformKind::UInt; components = 1; return true;
+    case GL_UNSIGNED_INT_VEC2: kind = EXGLUniformKind::UInt; components = 2; return true;
+    case GL_UNSIGNED_INT_VEC3: kind = EXGLUniformKind::UInt; components = 3; return true;
+    case GL_UNSIGNED_INT_VEC4: kind = EXGLUniformKind::UInt; components = 4; return true;
+    case GL_BOOL: kind = EXGLUniformKind::Bool; components = 1; return true;
+    case GL_BOOL_VEC2: kind = EXGLUniformKind::Bool; components = 2; return true;
+    case GL_BOOL_VEC3: kind = EXGLUniformKind::Bool; components = 3; return true;
+    case GL_BOOL_VEC4: kind = EXGLUniformKind::Bool; components = 4; return true;
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_2D_SHADOW:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_2D_ARRAY_SHADOW:
+    case GL_SAMPLER_CUBE_SHADOW:
+    case GL_INT_SAMPLER_2D:
+    case GL_INT_SAMPLER_3D:
+    case GL_INT_SAMPLER_CUBE:
+    case GL_INT_SAMPLER_2D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D:
+    case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE:
+    case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+      kind = EXGLUniformKind::Int;
+      components = 1;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// GL doesn't tell the type of a location, it's found by matching the locations
+// of the active uniforms (and of each element of the arrays)
+_JSI_METHOD(getUniform, 2) {
+  if (args[1].isNull()) {
+    return jsi::Value::null();
+  }
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram, GLint location);
+  EXGLUniformKind kind = EXGLUniformKind::Float;
+  GLint components = 0;
+  GLfloat floats[16];
+  GLint ints[16];
+  GLuint uints[16];
+  ctx.addBlockingToNextBatch([&] {
+    GLuint program = ctx.lookupObject(fProgram);
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> name(maxLength + 1);
+    GLenum type = GL_NONE;
+    for (GLint i = 0; i < count && type == GL_NONE; ++i) {
+      GLsizei length = 0;
+      GLint size = 0;
+      GLenum activeType;
+      glGetActiveUniform(program, i, (GLsizei) name.size(), &length, &size, &activeType, name.data());
+      std::string base(name.data(), length);
+      if (size > 1 && base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0) {
+        base.resize(base.size() - 3);
+      }
+      for (GLint element = 0; element < size; ++element) {
+        std::string elementName = size > 1 ? base + "[" + std::to_string(element) + "]" : base;
+        if (glGetUniformLocation(program, elementName.c_str()) == location) {
+          type = activeType;
+          break;
+        }
+      }
+    }
+    if (type == GL_NONE || !EXGLUniformTypeInfo(type, kind, components)) {
+      components = 0;
+      return;
+    }
+    switch (kind) {
+      case EXGLUniformKind::Float:
+        glGetUniformfv(program, location, floats);
+        break;
+      case EXGLUniformKind::UInt:
+        glGetUniformuiv(program, location, uints);
+        break;
+      default:
+        glGetUniformiv(program, location, ints);
+        break;
+    }
+  });
+
+  if (components == 0) {
+    throw std::runtime_error("EXGL: gl.getUniform() couldn't find the uniform at this location!");
+  }
+  switch (kind) {
+    case EXGLUniformKind::Float:
+      return components == 1 ? jsi::Value((double) floats[0])
+        : makeTypedArray("Float32Array", floats, components * sizeof(GLfloat));
+    case EXGLUniformKind::Int:
+      return components == 1 ? jsi::Value(ints[0])
+        : makeTypedArray("Int32Array", ints, components * sizeof(GLint));
+    case EXGLUniformKind::UInt:
+      return components == 1 ? jsi::Value((double) uints[0])
+        : makeTypedArray("Uint32Array", uints, components * sizeof(GLuint));
+    case EXGLUniformKind::Bool: {
+      if (components == 1) {
+        return ints[0] != 0;
+      }
+      jsi::Array jsResults(runtime, components);
+      for (GLint i = 0; i < components; ++i) {
+        jsResults.setValueAtIndex(runtime, i, ints[i] != 0);
+      }
+      return jsi::Value(runtime, jsResults);
+    }
+  }
+  return jsi::Value::null();
+}
+
+_JSI_METHOD(getUniformLocation, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+  auto name = string(args[1]);
+  if (auto info = ctx.programInfo(fProgram)) {
+    auto iter = info->uniformLocations.find(name);
+    return iter == info->uniformLocations.end() ? jsi::Value::null() : jsi::Value(iter->second);
+  }
+  GLint location;
+  ctx.addBlockingToNextBatch([&] {
+    location = glGetUniformLocation(ctx.lookupObject(fProgram), name.c_str());
+  });
+  return location == -1 ? jsi::Value::null() : jsi::Value(location);
+}
+
+_JSI_METHOD(getVertexAttrib, 2) {
+  _JSI_UNPACK_ARGS(GLuint index, GLenum pname);
+  if (pname == GL_CURRENT_VERTEX_ATTRIB) {
+    GLfloat values[4];
+    ctx.addBlockingToNextBatch([&] { glGetVertexAttribfv(index, pname, values); });
+    return makeTypedArray("Float32Array", values, sizeof(values));
+  }
+  GLint glResult = 0;
+  UEXGLObjectId exglObjId = 0;
+  ctx.addBlockingToNextBatch([&] {
+    glGetVertexAttribiv(index, pname, &glResult);
+    if (pname == GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING) {
+      exglObjId = ctx.findObject(glResult);
+    }
+  });
+  switch (pname) {
+    case GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING:
+      return objectOrNull(exglObjId);
+    case GL_VERTEX_ATTRIB_ARRAY_ENABLED:
+    case GL_VERTEX_ATTRIB_ARRAY_NORMALIZED:
+    case GL_VERTEX_ATTRIB_ARRAY_INTEGER:
+      return glResult != GL_FALSE;
+    default:
+      return glResult;
+  }
+}
+
+_JSI_METHOD(getVertexAttribOffset, 2) {
+  _JSI_UNPACK_ARGS(GLuint index, GLenum pname);
+  void *pointer = nullptr;
+  ctx.addBlockingToNextBatch([&] { glGetVertexAttribPointerv(index, pname, &pointer); });
+  return (double) (uintptr_t) pointer;
+}
+
+_JSI_METHOD_SIMPLE(uniform1f, glUniform1f, uniform, x)
+_JSI_METHOD_SIMPLE(uniform2f, glUniform2f, uniform, x, y)
+_JSI_METHOD_SIMPLE(uniform3f, glUniform3f, uniform, x, y, z)
+_JSI_METHOD_SIMPLE(uniform4f, glUniform4f, uniform, x, y, z, w)
+_JSI_METHOD_SIMPLE(uniform1i, glUniform1i, uniform, x)
+_JSI_METHOD_SIMPLE(uniform2i, glUniform2i, uniform, x, y)
+_JSI_METHOD_SIMPLE(uniform3i, glUniform3i, uniform, x, y, z)
+_JSI_METHOD_SIMPLE(uniform4i, glUniform4i, uniform, x, y, z, w)
+
+// The values go straight from the JS heap into the command buffer
+#define _JSI_METHOD_UNIFORM_V(suffix, dim, Type)                      \
+_JSI_METHOD(uniform##suffix, 2) {                                   \
+  _JSI_UNPACK_ARGS(GLuint uniform);                                 \
+  uint8_t *data = nullptr;                                          \
+  size_t bytes = 0;                                                 \
+  if (!arrayData(args[1], data, bytes)) {                           \
+    throw std::runtime_error("EXGL: gl.uniform" #suffix "() expects a TypedArray!"); \
+  }                                                                 \
+  GLsizei count = (GLsizei) bytes / sizeof(Type);                   \
+  ctx.nextBatch.pushUniformv<Type>(glUniform##suffix, uniform,      \
+                                   count / dim, data, bytes);       \
+  return jsi::Value::undefined();                                   \
+}
+_JSI_METHOD_UNIFORM_V(1fv, 1, GLfloat)
+_JSI_METHOD_UNIFORM_V(2fv, 2, GLfloat)
+_JSI_METHOD_UNIFORM_V(3fv, 3, GLfloat)
+_JSI_METHOD_UNIFORM_V(4fv, 4, GLfloat)
+_JSI_METHOD_UNIFORM_V(1iv, 1, GLint)
+_JSI_METHOD_UNIFORM_V(2iv, 2, GLint)
+_JSI_METHOD_UNIFORM_V(3iv, 3, GLint)
+_JSI_METHOD_UNIFORM_V(4iv, 4, GLint)
+
+#define _JSI_METHOD_UNIFORM_MATRIX(suffix, dim)                         \
+_JSI_METHOD(uniformMatrix##suffix, 3) {                               \
+  _JSI_UNPACK_ARGS(GLuint uniform);                                   \
+  GLboolean transpose = number(args[1]) != 0;                         \
+  uint8_t *data = nullptr;                                            \
+  size_t bytes = 0;                                                   \
+  if (!arrayData(args[2], data, bytes)) {                             \
+    throw std::runtime_error("EXGL: gl.uniformMatrix" #suffix "() expects a TypedArray!"); \
+  }                                                                   \
+  GLsizei count = (GLsizei) bytes / sizeof(GLfloat);                  \
+  ctx.nextBatch.pushUniformMatrixv(glUniformMatrix##suffix, uniform,  \
+                                   count / dim, transpose, data, bytes); \
+  return jsi::Value::undefined();                                     \
+}
+_JSI_METHOD_UNIFORM_MATRIX(2fv, 4)
+_JSI_METHOD_UNIFORM_MATRIX(3fv, 9)
+_JSI_METHOD_UNIFORM_MATRIX(4fv, 16)
+
+#define _JSI_METHOD_VERTEX_ATTRIB_V(suffix, dim, Type)                   \
+_JSI_METHOD(vertexAttrib##suffix, 2) {                                 \
+  _JSI_UNPACK_ARGS(GLuint index);                                      \
+  size_t bytes = 0;                                                    \
+  auto data = copyArray(args[1], &bytes);                              \
+  if (!data || bytes < dim * sizeof(Type)) {                           \
+    throw std::runtime_error("EXGL: gl.vertexAttrib" #suffix "() expects a TypedArray of " #dim " values!"); \
+  }                                                                    \
+  ctx.addToNextBatch([=] { glVertexAttrib##suffix(index, (const Type *) data.get()); }); \
+  return jsi::Value::undefined();                                      \
+}
+_JSI_METHOD_VERTEX_ATTRIB_V(1fv, 1, GLfloat)
+_JSI_METHOD_VERTEX_ATTRIB_V(2fv, 2, GLfloat)
+_JSI_METHOD_VERTEX_ATTRIB_V(3fv, 3, GLfloat)
+_JSI_METHOD_VERTEX_ATTRIB_V(4fv, 4, GLfloat)
+
+_JSI_METHOD_SIMPLE(vertexAttrib1f, glVertexAttrib1f, index, x)
+_JSI_METHOD_SIMPLE(vertexAttrib2f, glVertexAttrib2f, index, x, y)
+_JSI_METHOD_SIMPLE(vertexAttrib3f, glVertexAttrib3f, index, x, y, z)
+_JSI_METHOD_SIMPLE(vertexAttrib4f, glVertexAttrib4f, index, x, y, z, w)
+
+_JSI_METHOD(vertexAttribPointer, 6) {
+  _JSI_UNPACK_ARGS(GLuint index, GLuint itemSize, GLenum type, GLboolean normalized, GLsizei stride, GLint offset);
+  if (ctx.vertexArrays.pointer(index, itemSize, type, normalized, false, stride, offset,
+                               ctx.residency.boundBuffer(GL_ARRAY_BUFFER))) {
+    ctx.addCallToNextBatch(glVertexAttribPointer, index, itemSize, type, normalized, stride, offset);
+  }
+  return jsi::Value::undefined();
+}
+
+
+// Uniforms and attributes (WebGL2)
+// --------------------------------
+
+_JSI_METHOD_SIMPLE(uniform1ui, glUniform1ui, location, x)
+_JSI_METHOD_SIMPLE(uniform2ui, glUniform2ui, location, x, y)
+_JSI_METHOD_SIMPLE(uniform3ui, glUniform3ui, location, x, y, z)
+_JSI_METHOD_SIMPLE(uniform4ui, glUniform4ui, location, x, y, z, w)
+
+_JSI_METHOD_UNIFORM_V(1uiv, 1, GLuint)
+_JSI_METHOD_UNIFORM_V(2uiv, 2, GLuint)
+_JSI_METHOD_UNIFORM_V(3uiv, 3, GLuint)
+_JSI_METHOD_UNIFORM_V(4uiv, 4, GLuint)
+
+_JSI_METHOD_UNIFORM_MATRIX(3x2fv, 6)
+_JSI_METHOD_UNIFORM_MATRIX(4x2fv, 8)
+_JSI_METHOD_UNIFORM_MATRIX(2x3fv, 6)
+_JSI_METHOD_UNIFORM_MATRIX(4x3fv, 12)
+_JSI_METHOD_UNIFORM_MATRIX(2x4fv, 8)
+_JSI_METHOD_UNIFORM_MATRIX(3x4fv, 12)
+
+_JSI_METHOD_SIMPLE(vertexAttribI4i, glVertexAttribI4i, index, x, y, z, w)
+_JSI_METHOD_SIMPLE(vertexAttribI4ui, glVertexAttribI4ui, index, x, y, z, w)
+
+_JSI_METHOD_VERTEX_ATTRIB_V(I4iv, 4, GLint)
+_JSI_METHOD_VERTEX_ATTRIB_V(I4uiv, 4, GLuint)
+
+_JSI_METHOD(vertexAttribIPointer, 5) {
+  _JSI_UNPACK_ARGS(GLuint index, GLuint size, GLenum type, GLsizei stride, GLint offset);
+  if (ctx.vertexArrays.pointer(index, size, type, false, true, stride, offset,
+                               ctx.residency.boundBuffer(GL_ARRAY_BUFFER))) {
+    ctx.addCallToNextBatch(glVertexAttribIPointer, index, size, type, stride, offset);
+  }
+  return jsi::Value::undefined();
+}
+
+#undef _JSI_METHOD_UNIFORM_V
+#undef _JSI_METHOD_UNIFORM_MATRIX
+#undef _JSI_METHOD_VERTEX_ATTRIB_V
+
+
+// Drawing buffers
+// ---------------
+
+_JSI_METHOD(clear, 1) {
+  _JSI_UNPACK_ARGS(GLbitfield mask);
+  ctx.addClearToNextBatch(mask);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD_SIMPLE(drawArrays, glDrawArrays, mode, first, count)
+
+_JSI_METHOD(drawElements, 4) {
+  _JSI_UNPACK_ARGS(GLenum mode, GLsizei count, GLenum type, GLint offset);
+  ctx.addCallToNextBatch(glDrawElements, mode, count, type, offset);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(finish, 0) {
+  ctx.addCallToNextBatch(glFinish);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(flush, 0) {
+  ctx.addCallToNextBatch(glFlush);
+  return jsi::Value::undefined();
+}
+
+
+// Drawing buffers (WebGL2)
+// ------------------------
+
+_JSI_WEBGL2_METHOD(vertexAttribDivisor, 2) {
+  _JSI_UNPACK_ARGS(GLuint index, GLuint divisor);
+  if (ctx.vertexArrays.divisor(index, divisor)) {
+    ctx.addCallToNextBatch(glVertexAttribDivisor, index, divisor);
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD_SIMPLE(drawArraysInstanced, glDrawArraysInstanced, mode, first, count, instancecount)
+
+_JSI_WEBGL2_METHOD(drawElementsInstanced, 5) {
+  _JSI_UNPACK_ARGS(GLenum mode, GLsizei count, GLenum type, GLint offset, GLsizei instanceCount);
+  ctx.addCallToNextBatch(glDrawElementsInstanced, mode, count, type, offset, instanceCount);
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(drawRangeElements, 6) {
+  _JSI_UNPACK_ARGS(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, GLint offset);
+  ctx.addCallToNextBatch(glDrawRangeElements, mode, start, end, count, type, offset);
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(drawBuffers, 1) {
+  auto buffers = uintArray(args[0]);
+  ctx.addToNextBatch([=] { glDrawBuffers((GLsizei) buffers.size(), buffers.data()); });
+  return jsi::Value::undefined();
+}
+
+// Up to 4 values from an Array or a TypedArray, the rest stay 0
+#define _JSI_METHOD_CLEAR_BUFFER(suffix, Type)                             \
+_JSI_WEBGL2_METHOD(clearBuffer##suffix, 3) {                             \
+  _JSI_UNPACK_ARGS(GLenum buffer, GLint drawbuffer);                     \
+  std::array<Type, 4> values {};                                         \
+  uint8_t *data = nullptr;                                               \
+  size_t bytes = 0;                                                      \
+  if (args[2].isObject() && args[2].getObject(runtime).isArray(runtime)) { \
+    auto array = args[2].getObject(runtime).getArray(runtime);           \
+    for (size_t i = 0; i < std::min(array.size(runtime), values.size()); ++i) { \
+      values[i] = (Type) number(array.getValueAtIndex(runtime, i));      \
+    }                                                                    \
+  } else if (arrayData(args[2], data, bytes) && data) {                  \
+    memcpy(values.data(), data, std::min(bytes, sizeof(values)));        \
+  } else {                                                               \
+    throw std::runtime_error("EXGL: gl.clearBuffer" #suffix "() expects an Array or a TypedArray!"); \
+  }                                                                      \
+  ctx.addToNextBatch([=] { glClearBuffer##suffix(buffer, drawbuffer, values.data()); }); \
+  return jsi::Value::undefined();                                        \
+}
+_JSI_METHOD_CLEAR_BUFFER(fv, GLfloat)
+_JSI_METHOD_CLEAR_BUFFER(iv, GLint)
+_JSI_METHOD_CLEAR_BUFFER(uiv, GLuint)
+#undef _JSI_METHOD_CLEAR_BUFFER
+
+_JSI_WEBGL2_METHOD_SIMPLE(clearBufferfi, glClearBufferfi, buffer, drawbuffer, depth, stencil)
+
+
+// Query objects (WebGL2)
+// ----------------------
+
+_JSI_WEBGL2_METHOD(createQuery, 0) {
+  return (double) ctx.addFutureToNextBatch([] {
+    GLuint query;
+    glGenQueries(1, &query);
+    return query;
+  });
+}
+
+_JSI_WEBGL2_METHOD(deleteQuery, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fQuery);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    GLuint query = exglCtx.lookupObject(fQuery);
+    glDeleteQueries(1, &query);
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD_IS_OBJECT(Query)
+
+_JSI_WEBGL2_METHOD(beginQuery, 2) {
+  _JSI_UNPACK_ARGS(GLenum target, UEXGLObjectId fQuery);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] { glBeginQuery(target, exglCtx.lookupObject(fQuery)); });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD_SIMPLE(endQuery, glEndQuery, target)
+
+_JSI_WEBGL2_METHOD(getQuery, 2) {
+  _JSI_UNPACK_ARGS(GLenum target, GLenum pname);
+  GLint params;
+  ctx.addBlockingToNextBatch([&] { glGetQueryiv(target, pname, &params); });
+  return params == 0 ? jsi::Value::null() : jsi::Value(params);
+}
+
+_JSI_WEBGL2_METHOD(getQueryParameter, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fQuery, GLenum pname);
+  GLuint params;
+  ctx.addBlockingToNextBatch([&] { glGetQueryObjectuiv(ctx.lookupObject(fQuery), pname, &params); });
+  return params == 0 ? jsi::Value::null() : jsi::Value((double) params);
+}
+
+
+// Samplers (WebGL2)
+// -----------------
+
+_JSI_WEBGL2_METHOD(createSampler, 0) {
+  return (double) ctx.addFutureToNextBatch([] {
+    GLuint sampler;
+    glGenSamplers(1, &sampler);
+    return sampler;
+  });
+}
+
+_JSI_WEBGL2_METHOD(deleteSampler, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fSampler);
+  ctx.residency.forget(fSampler);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    GLuint sampler = exglCtx.lookupObject(fSampler);
+    glDeleteSamplers(1, &sampler);
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(bindSampler, 2) {
+  _JSI_UNPACK_ARGS(GLuint unit, UEXGLObjectId fSampler);
+  ctx.residency.bindSampler(unit, fSampler);
+  ctx.addBindToNextBatch(glBindSampler, unit, fSampler);
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD_IS_OBJECT(Sampler)
+
+_JSI_WEBGL2_METHOD(samplerParameteri, 3) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fSampler, GLenum pname, GLint param);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] { glSamplerParameteri(exglCtx.lookupObject(fSampler), pname, param); });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(samplerParameterf, 3) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fSampler, GLenum pname, GLfloat param);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] { glSamplerParameterf(exglCtx.lookupObject(fSampler), pname, param); });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(getSamplerParameter, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fSampler, GLenum pname);
+  bool isFloatParam = pname == GL_TEXTURE_MAX_LOD || pname == GL_TEXTURE_MIN_LOD;
+  GLfloat paramf;
+  GLint parami;
+  ctx.addBlockingToNextBatch([&] {
+    GLuint sampler = ctx.lookupObject(fSampler);
+    if (isFloatParam) {
+      glGetSamplerParameterfv(sampler, pname, &paramf);
+    } else {
+      glGetSamplerParameteriv(sampler, pname, &parami);
+    }
+  });
+  return isFloatParam ? (double) paramf : (double) parami;
+}
+
+
+// Sync objects (WebGL2)
+// ---------------------
+
+// GLsync handles don't fit the object table, same as the JavaScriptCore binding
+#define _JSI_METHOD_UNIMPL(name)                                        \
+  _JSI_METHOD(name, 0) {                                                \
+    throw std::runtime_error("EXGL: " #name "() isn't implemented yet!"); \
+  }
+
+_JSI_METHOD_UNIMPL(fenceSync)
+
+_JSI_METHOD_UNIMPL(isSync)
+
+_JSI_METHOD_UNIMPL(deleteSync)
+
+_JSI_METHOD_UNIMPL(clientWaitSync)
+
+_JSI_METHOD_UNIMPL(waitSync)
+
+_JSI_METHOD_UNIMPL(getSyncParameter)
+
+#undef _JSI_METHOD_UNIMPL
+
+
+// Transform feedback (WebGL2)
+// ---------------------------
+
+_JSI_WEBGL2_METHOD(createTransformFeedback, 0) {
+  return (double) ctx.addFutureToNextBatch([] {
+    GLuint transformFeedback;
+    glGenTransformFeedbacks(1, &transformFeedback);
+    return transformFeedback;
+  });
+}
+
+_JSI_WEBGL2_METHOD(deleteTransformFeedback, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fTransformFeedback);
+  ctx.residency.forget(fTransformFeedback);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    GLuint transformFeedback = exglCtx.lookupObject(fTransformFeedback);
+    glDeleteTransformFeedbacks(1, &transformFeedback);
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD_IS_OBJECT(TransformFeedback)
+
+_JSI_WEBGL2_METHOD(bindTransformFeedback, 2) {
+  _JSI_UNPACK_ARGS(GLenum target, UEXGLObjectId fTransformFeedback);
+  ctx.residency.bindTransformFeedback(fTransformFeedback);
+  ctx.addBindToNextBatch(glBindTransformFeedback, target, fTransformFeedback);
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD_SIMPLE(beginTransformFeedback, glBeginTransformFeedback, primitiveMode)
+
+_JSI_WEBGL2_METHOD(endTransformFeedback, 0) {
+  ctx.addCallToNextBatch(glEndTransformFeedback);
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(transformFeedbackVaryings, 3) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+  _JSI_UNPACK_ARGS_OFFSET(2, GLenum bufferMode);
+  auto varyings = std::make_shared<std::vector<std::string>>(stringArray(args[1]));
+  ctx.noteProgramBinding(fProgram, &bufferMode, sizeof(bufferMode));
+  for (const auto &varying : *varyings) {
+    ctx.noteProgramBinding(fProgram, varying.c_str(), varying.size() + 1);
+  }
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    std::vector<const GLchar *> names;
+    for (const auto &varying : *varyings) {
+      names.push_back(varying.c_str());
+    }
+    glTransformFeedbackVaryings(exglCtx.lookupObject(fProgram), (GLsizei) names.size(), names.data(), bufferMode);
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(getTransformFeedbackVarying, 2) {
+  if (args[0].isNull()) {
+    return jsi::Value::null();
+  }
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram, GLuint index);
+  GLsizei length = 0;
+  GLint size;
+  GLenum type;
+  std::string name;
+  ctx.addBlockingToNextBatch([&] {
+    GLuint program = ctx.lookupObject(fProgram);
+    GLint maxNameLength = 0;
+    glGetProgramiv(program, GL_TRANSFORM_FEEDBACK_VARYING_MAX_LENGTH, &maxNameLength);
+    name.resize(std::max(maxNameLength, 1));
+    glGetTransformFeedbackVarying(program, index, (GLsizei) name.size(), &length, &size, &type, &name[0]);
+  });
+  if (length <= 0) {
+    return jsi::Value::null();
+  }
+  name.resize(length);
+  return makeActiveInfo(name.c_str(), size, type);
+}
+
+_JSI_WEBGL2_METHOD(pauseTransformFeedback, 0) {
+  ctx.addCallToNextBatch(glPauseTransformFeedback);
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(resumeTransformFeedback, 0) {
+  ctx.addCallToNextBatch(glResumeTransformFeedback);
+  return jsi::Value::undefined();
+}
+
+
+// Uniform buffer objects (WebGL2)
+// -------------------------------
+
+_JSI_WEBGL2_METHOD(bindBufferBase, 3) {
+  _JSI_UNPACK_ARGS(GLenum target, GLuint index, UEXGLObjectId fBuffer);
+  // Also binds the buffer to `target`
+  ctx.residency.bindBuffer(target, fBuffer);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] { glBindBufferBase(target, index, exglCtx.lookupObject(fBuffer)); });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(bindBufferRange, 5) {
+  _JSI_UNPACK_ARGS(GLenum target, GLuint index, UEXGLObjectId fBuffer, GLintptr offset, GLsizeiptr size);
+  ctx.residency.bindBuffer(target, fBuffer);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    glBindBufferRange(target, index, exglCtx.lookupObject(fBuffer), offset, size);
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(getUniformIndices, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+  auto uniformNames = stringArray(args[1]);
+  std::vector<const GLchar *> names;
+  for (const auto &uniformName : uniformNames) {
+    names.push_back(uniformName.c_str());
+  }
+  std::vector<GLuint> indices(names.size());
+  ctx.addBlockingToNextBatch([&] {
+    glGetUniformIndices(ctx.lookupObject(fProgram), (GLsizei) names.size(), names.data(), indices.data());
+  });
+  return makeTypedArray("Uint32Array", indices.data(), indices.size() * sizeof(GLuint));
+}
+
+_JSI_WEBGL2_METHOD(getActiveUniforms, 3) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+  _JSI_UNPACK_ARGS_OFFSET(2, GLenum pname);
+  auto uniformIndices = uintArray(args[1]);
+  std::vector<GLint> params(uniformIndices.size());
+  ctx.addBlockingToNextBatch([&] {
+    glGetActiveUniformsiv(ctx.lookupObject(fProgram), (GLsizei) uniformIndices.size(),
+                          uniformIndices.data(), pname, params.data());
+  });
+  return makeTypedArray("Int32Array", params.data(), params.size() * sizeof(GLint));
+}
+
+_JSI_WEBGL2_METHOD(getUniformBlockIndex, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram);
+  auto uniformBlockName = string(args[1]);
+  GLuint blockIndex;
+  ctx.addBlockingToNextBatch([&] {
+    blockIndex = glGetUniformBlockIndex(ctx.lookupObject(fProgram), uniformBlockName.c_str());
+  });
+  return (double) blockIndex;
+}
+
+_JSI_WEBGL2_METHOD(getActiveUniformBlockParameter, 3) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram, GLuint uniformBlockIndex, GLenum pname);
+  switch (pname) {
+    case GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES: {
+      std::vector<GLint> indices;
+      ctx.addBlockingToNextBatch([&] {
+        GLuint program = ctx.lookupObject(fProgram);
+        GLint count = 0;
+        glGetActiveUniformBlockiv(program, uniformBlockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &count);
+        indices.resize(std::max(count, 0));
+        if (count > 0) {
+          glGetActiveUniformBlockiv(program, uniformBlockIndex, pname, indices.data());
+        }
+      });
+      return makeTypedArray("Uint32Array", indices.data(), indices.size() * sizeof(GLint));
+    }
+    case GL_UNIFORM_BLOCK_BINDING:
+    case GL_UNIFORM_BLOCK_DATA_SIZE:
+    case GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS:
+    case GL_UNIFORM_BLOCK_REFERENCED_BY_VERTEX_SHADER:
+    case GL_UNIFORM_BLOCK_REFERENCED_BY_FRAGMENT_SHADER: {
+      GLint glResult = 0;
+      ctx.addBlockingToNextBatch([&] {
+        glGetActiveUniformBlockiv(ctx.lookupObject(fProgram), uniformBlockIndex, pname, &glResult);
+      });
+      if (pname == GL_UNIFORM_BLOCK_REFERENCED_BY_VERTEX_SHADER ||
+          pname == GL_UNIFORM_BLOCK_REFERENCED_BY_FRAGMENT_SHADER) {
+        return glResult != GL_FALSE;
+      }
+      return (double) (GLuint) glResult;
+    }
+    default:
+      throw std::runtime_error("EXGL: Invalid pname for gl.getActiveUniformBlockParameter()!");
+  }
+}
+
+_JSI_WEBGL2_METHOD(getActiveUniformBlockName, 2) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram, GLuint uniformBlockIndex);
+  std::string blockName;
+  ctx.addBlockingToNextBatch([&] {
+    GLuint program = ctx.lookupObject(fProgram);
+    GLint bufSize = 0;
+    glGetActiveUniformBlockiv(program, uniformBlockIndex, GL_UNIFORM_BLOCK_NAME_LENGTH, &bufSize);
+    blockName.resize(std::max(bufSize, 1));
+    GLsizei length = 0;
+    glGetActiveUniformBlockName(program, uniformBlockIndex, (GLsizei) blockName.size(), &length, &blockName[0]);
+    blockName.resize(std::max(length, 0));
+  });
+  return jsi::String::createFromUtf8(runtime, blockName);
+}
+
+_JSI_WEBGL2_METHOD(uniformBlockBinding, 3) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fProgram, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    glUniformBlockBinding(exglCtx.lookupObject(fProgram), uniformBlockIndex, uniformBlockBinding);
+  });
+  return jsi::Value::undefined();
+}
+
+
+// Vertex Array Objects (WebGL2)
+// -----------------------------
+
+_JSI_WEBGL2_METHOD(createVertexArray, 0) {
+  return (double) ctx.addFutureToNextBatch([] {
+    GLuint vertexArray;
+    glGenVertexArrays(1, &vertexArray);
+    return vertexArray;
+  });
+}
+
+_JSI_WEBGL2_METHOD(deleteVertexArray, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fVertexArray);
+  ctx.shadowState.forgetObject(fVertexArray);
+  ctx.residency.forget(fVertexArray);
+  ctx.vertexArrays.forgetVertexArray(fVertexArray);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    GLuint vertexArray = exglCtx.lookupObject(fVertexArray);
+    glDeleteVertexArrays(1, &vertexArray);
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(bindVertexArray, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId vertexArray);
+  ctx.residency.bindVertexArray(vertexArray);
+  const double values[] = { (double) vertexArray };
+  ctx.shadowState.update(EXGLShadowState::VertexArray, values, 1);
+  // The attribute setup comes with the vertex array, calls re-issuing it after
+  // this are dropped by `vertexArrays`
+  if (ctx.vertexArrays.bind(vertexArray)) {
+    ctx.addUseToNextBatch(glBindVertexArray, vertexArray);
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD_IS_OBJECT(VertexArray)
+
+
+// Extensions
+// ----------
+
+_JSI_METHOD(getSupportedExtensions, 0) {
+  const auto &extensions = ctx.getSupportedExtensionList();
+  jsi::Array jsResults(runtime, extensions.size());
+  for (size_t i = 0; i < extensions.size(); ++i) {
+    jsResults.setValueAtIndex(runtime, i, jsi::String::createFromAscii(runtime, extensions[i]->webglName));
+  }
+  return jsi::Value(runtime, jsResults);
+}
+
+_JSI_METHOD(getExtension, 1) {
+  auto name = string(args[0]);
+  for (auto extension : ctx.getSupportedExtensionList()) {
+    if (name == extension->webglName) {
+      jsi::Object jsResult(runtime);
+      for (const auto &constant : extension->constants) {
+        jsResult.setProperty(runtime, constant.name, (double) constant.value);
+      }
+      return jsi::Value(runtime, jsResult);
+    }
+  }
+  return jsi::Value::null();
+}
+
+
+// Exponent extensions
+// -------------------
+
+// No pinned arrays to release, the `NoCopyEXP` uploads copy with JSI
+_JSI_METHOD(endFrameEXP, 0) {
+  ctx.endFrame();
+  ctx.endFrameResidency(nullptr);
+  ctx.endFrameStats();
+  resolveReadbacks();
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(flushEXP, 0) {
+  ctx.addBlockingToNextBatch([&] {
+    // nothing, it's just a helper so that we can measure how much time some operations take
+  });
+  return jsi::Value::undefined();
+}
+
+// A jsi::ArrayBuffer can't be pinned until the end of the frame, these are the
+// regular copying uploads
+_JSI_METHOD(bufferDataNoCopyEXP, 3) {
+  return bufferData(args, argc);
+}
+
+_JSI_METHOD(bufferSubDataNoCopyEXP, 3) {
+  return bufferSubData(args, argc);
+}
+
+_JSI_METHOD(texImage2DNoCopyEXP, 9) {
+  return texImage2D(args, argc);
+}
+
+// The callback waits in `readbackCallbacks()` until the pixels get to
+// `endFrameEXP`, usually a frame or two later
+_JSI_WEBGL2_METHOD(readPixelsAsyncEXP, 7) {
+  _JSI_UNPACK_ARGS(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type);
+  if (!args[6].isObject() || !args[6].getObject(runtime).isFunction(runtime)) {
+    throw std::runtime_error("EXGL: gl.readPixelsAsyncEXP() expects a callback!");
+  }
+
+  EXGLContext::PixelPackRequest request;
+  request.byteLength = width * height * EXGLContext::bytesPerPixel(type, format);
+  request.arrayType = type == GL_FLOAT ? kJSTypedArrayTypeFloat32Array
+    : type == GL_UNSIGNED_BYTE ? kJSTypedArrayTypeUint8Array
+    : kJSTypedArrayTypeUint16Array;
+  auto jsCallbacks = readbackCallbacks();
+  jsCallbacks.getPropertyAsFunction(runtime, "push").callWithThis(runtime, jsCallbacks, args[6]);
+
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    exglCtx.beginPixelPack(request, x, y, width, height, format, type);
+  });
+  return jsi::Value::undefined();
+}
+
+// Like `getBufferSubData` but doesn't wait for the GPU, see the JavaScriptCore
+// binding
+_JSI_WEBGL2_METHOD(getBufferSubDataAsyncEXP, 4) {
+  _JSI_UNPACK_ARGS(GLenum target, GLintptr srcByteOffset, GLsizeiptr byteLength);
+  if (!args[3].isObject() || !args[3].getObject(runtime).isFunction(runtime)) {
+    throw std::runtime_error("EXGL: gl.getBufferSubDataAsyncEXP() expects a callback!");
+  }
+  if (srcByteOffset < 0 || byteLength <= 0) {
+    throw std::runtime_error("EXGL: Invalid range for gl.getBufferSubDataAsyncEXP()!");
+  }
+
+  EXGLContext::PixelPackRequest request;
+  request.byteLength = byteLength;
+  request.arrayType = kJSTypedArrayTypeUint8Array;
+  auto jsCallbacks = readbackCallbacks();
+  jsCallbacks.getPropertyAsFunction(runtime, "push").callWithThis(runtime, jsCallbacks, args[3]);
+
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    exglCtx.beginBufferPack(request, target, srcByteOffset);
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(enableStateCachingEXP, 1) {
+  ctx.shadowState.enabled = number(args[0]) != 0;
+  ctx.shadowState.invalidate();
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(enableDeferredErrorsEXP, 1) {
+  ctx.deferredErrors = number(args[0]) != 0;
+  ctx.deferredError = GL_NO_ERROR;
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(setBacklogPolicyEXP, 1) {
+  auto policy = string(args[0]);
+  if (policy == "coalesce") {
+    ctx.backlogPolicy = EXGLContext::BacklogPolicy::Coalesce;
+  } else if (policy == "block") {
+    ctx.backlogPolicy = EXGLContext::BacklogPolicy::Block;
+  } else {
+    throw std::runtime_error("EXGL: setBacklogPolicyEXP() expects 'coalesce' or 'block'!");
+  }
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(compressedTexImageKTXEXP, 2) {
+  _JSI_UNPACK_ARGS(GLenum target);
+  std::string localPath;
+  if (!localPathFromImage(args[1], localPath)) {
+    throw std::runtime_error("EXGL: gl.compressedTexImageKTXEXP() expects an object with a `localUri`!");
+  }
+
+  auto texture = std::make_shared<EXGLCompressedTexture>();
+  std::string error;
+  if (!EXGLCompressedTexture::load(localPath, *texture, error)) {
+    throw std::runtime_error("EXGL: gl.compressedTexImageKTXEXP() couldn't load the texture: " + error);
+  }
+  bool isSingleLayer = texture->target() == GL_TEXTURE_2D &&
+    (target == GL_TEXTURE_2D_ARRAY || target == GL_TEXTURE_3D);
+  if (texture->target() != target && !isSingleLayer) {
+    throw std::runtime_error("EXGL: gl.compressedTexImageKTXEXP() target doesn't match the texture's shape!");
+  }
+  ctx.addToNextBatch([=] { texture->upload(target); });
+
+  jsi::Object jsResult(runtime);
+  jsResult.setProperty(runtime, "width", (double) texture->width);
+  jsResult.setProperty(runtime, "height", (double) texture->height);
+  jsResult.setProperty(runtime, "depth", (double) (texture->layers > 1 ? texture->layers : texture->depth));
+  jsResult.setProperty(runtime, "levels", (double) texture->levels);
+  jsResult.setProperty(runtime, "internalFormat", (double) texture->internalFormat);
+  return jsi::Value(runtime, jsResult);
+}
+
+_JSI_METHOD(enableFrameStatsEXP, 1) {
+  ctx.frameStatsEnabled = number(args[0]) != 0;
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(getFrameStatsEXP, 0) {
+  return makeTypedArray("Float64Array", ctx.lastFrameStats, sizeof(ctx.lastFrameStats));
+}
+
+_JSI_METHOD(getFrameDeadlineEXP, 0) {
+  double deadline[3];
+  ctx.frameDeadline(deadline);
+  return makeTypedArray("Float64Array", deadline, sizeof(deadline));
+}
+
+// No eviction callback here, it would have to keep a jsi::Value alive: poll
+// `getResidencyCandidatesEXP` after `endFrameEXP` instead
+_JSI_METHOD(setResidencyBudgetEXP, 1) {
+  _JSI_UNPACK_ARGS(double bytes);
+  if (argc > 1 && !args[1].isNull() && !args[1].isUndefined()) {
+    throw std::runtime_error("EXGL: gl.setResidencyBudgetEXP() doesn't take a callback with JSI, "
+                             "poll gl.getResidencyCandidatesEXP() instead!");
+  }
+  ctx.setResidencyBudget(nullptr, bytes > 0 ? (size_t) bytes : 0, nullptr);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(setUploadBudgetEXP, 1) {
+  _JSI_UNPACK_ARGS(double bytes);
+  ctx.uploadBudget = bytes > 0 ? (size_t) bytes : SIZE_MAX;
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(startRecordingEXP, 2) {
+  _JSI_UNPACK_ARGS(GLsizei width, GLsizei height);
+  UEXGLObjectId fFramebuffer = 0;
+  if (argc > 2 && !args[2].isNull() && !args[2].isUndefined()) {
+    fFramebuffer = (UEXGLObjectId) args[2].asNumber();
+  }
+  if (width <= 0 || height <= 0) {
+    throw std::runtime_error("EXGL: gl.startRecordingEXP() needs a width and a height!");
+  }
+  if (!ctx.getFrameSink()) {
+    throw std::runtime_error("EXGL: No video encoder is attached to this context!");
+  }
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] {
+    exglCtx.recording.framebuffer = fFramebuffer;
+    exglCtx.recording.width = width;
+    exglCtx.recording.height = height;
+    exglCtx.recording.active = true;
+  });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(stopRecordingEXP, 0) {
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([&exglCtx] { exglCtx.stopRecording(); });
+  return jsi::Value::undefined();
+}
+
+_JSI_WEBGL2_METHOD(texStorage2DLevelsEXP, 8) {
+  _JSI_UNPACK_ARGS(GLenum target, GLsizei levels, GLenum internalformat,
+                   GLsizei width, GLsizei height, GLenum format, GLenum type);
+  size_t length = 0;
+  auto data = copyArray(args[7], &length);
+  if (!data) {
+    throw std::runtime_error("EXGL: gl.texStorage2DLevelsEXP() takes its pixels as a typed array!");
+  }
+  ctx.addTexStorageLevelsToNextBatch(target, levels, internalformat, width, height, format, type,
+                                     std::move(data), length);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(texImage2DTextEXP, 3) {
+  _JSI_UNPACK_ARGS(GLenum target, GLint level);
+  auto style = argc > 3 ? textStyleFromObject(args[3]) : UEXGLTextStyle();
+  auto image = ctx.addTextImageToNextBatch(target, level, false, 0, 0, string(args[2]), style);
+  const double size[] = { (double) image.width, (double) image.height, image.baseline };
+  return makeTypedArray("Float64Array", size, sizeof(size));
+}
+
+_JSI_METHOD(texSubImage2DTextEXP, 5) {
+  _JSI_UNPACK_ARGS(GLenum target, GLint level, GLint xoffset, GLint yoffset);
+  auto style = argc > 5 ? textStyleFromObject(args[5]) : UEXGLTextStyle();
+  auto image = ctx.addTextImageToNextBatch(target, level, true, xoffset, yoffset, string(args[4]), style);
+  const double size[] = { (double) image.width, (double) image.height, image.baseline };
+  return makeTypedArray("Float64Array", size, sizeof(size));
+}
+
+_JSI_METHOD(getResidencyCandidatesEXP, 0) {
+  std::vector<UEXGLObjectId> candidates;
+  if (ctx.residency.overBudget()) {
+    candidates = ctx.residency.evictionCandidates();
+  }
+  return makeTypedArray("Uint32Array", candidates.data(), candidates.size() * sizeof(UEXGLObjectId));
+}
+
+_JSI_METHOD(uniformBlockUpdateEXP, 3) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId program);
+  uint8_t *data = nullptr, *layout = nullptr;
+  size_t bytes = 0, layoutBytes = 0;
+  if (!arrayData(args[1], data, bytes) || !arrayData(args[2], layout, layoutBytes)) {
+    throw std::runtime_error("EXGL: gl.uniformBlockUpdateEXP() expects TypedArrays!");
+  }
+  ctx.addUniformBlockToNextBatch(program, (const GLint *) layout, layoutBytes / sizeof(GLint),
+                                 data, bytes);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(multiDrawElementsEXP, 3) {
+  _JSI_UNPACK_ARGS(GLenum mode, GLenum type);
+  uint8_t *records = nullptr;
+  size_t recordsBytes = 0;
+  if (!arrayData(args[2], records, recordsBytes)) {
+    throw std::runtime_error("EXGL: gl.multiDrawElementsEXP() expects Int32Array records!");
+  }
+  if (argc <= 3 || !args[3].isNumber()) {
+    ctx.addMultiDrawToNextBatch(mode, type, records, recordsBytes, -1, GL_NONE, nullptr, 0);
+    return jsi::Value::undefined();
+  }
+  if (argc < 6) {
+    throw std::runtime_error("EXGL: gl.multiDrawElementsEXP() needs a uniform type and data with a location!");
+  }
+  _JSI_UNPACK_ARGS_OFFSET(3, GLint location, GLenum uniformType);
+  uint8_t *uniformData = nullptr;
+  size_t uniformBytes = 0;
+  if (!arrayData(args[5], uniformData, uniformBytes)) {
+    throw std::runtime_error("EXGL: gl.multiDrawElementsEXP() expects a TypedArray of uniform data!");
+  }
+  ctx.addMultiDrawToNextBatch(mode, type, records, recordsBytes, location, uniformType,
+                              uniformData, uniformBytes);
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(updateExternalTextureEXP, 1) {
+  _JSI_UNPACK_ARGS(UEXGLObjectId fTexture);
+  ctx.shadowState.forgetObject(fTexture);
+  auto &exglCtx = ctx;
+  exglCtx.addToNextBatch([=, &exglCtx] { exglCtx.latchExternalTexture(fTexture); });
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(startTraceEXP, 1) {
+  ctx.startTrace(string(args[0]));
+  return jsi::Value::undefined();
+}
+
+_JSI_METHOD(stopTraceEXP, 0) {
+  return (double) ctx.stopTrace();
+}
+
+
+// C API
+// -----
+
+UEXGLContextId UEXGLContextCreateWithJSI(jsi::Runtime &runtime) {
+  return EXGLJsiContext::install(runtime);
+}
+
+UEXGLContextId UEXGLContextCreateHeadlessWithJSI(jsi::Runtime &runtime, GLsizei width, GLsizei height) {
+  UEXGLContextId exglCtxId = EXGLJsiContext::install(runtime);
+  if (exglCtxId != 0 && !EXGLRenderPool::shared().attach(exglCtxId, width, height)) {
+    EXGLContext::ContextDestroy(exglCtxId);
+    return 0;
+  }
+  return exglCtxId;
+}
@@ -0,0 +1,376 @@
+#ifndef __EXGLJSICONTEXT_H__
+#define __EXGLJSICONTEXT_H__
+
+#include <jsi/jsi.h>
+
+#include "EXGLContext.h"
+
+
+// --- EXGLJsiContext ----------------------------------------------------------
+
+// JSI binding for an EXGL context, so that GLViews also work on JS engines other
+// than JavaScriptCore (Hermes...). It drives the same op queue, object table and
+// caches as the JavaScriptCore methods in EXGLNativeMethods.cpp, only the
+// argument unpacking and result creation differ.
+//
+// The JS object is a plain object holding host functions and constants rather
+// than a jsi::HostObject: property lookups then stay in the engine's fast paths
+// and no jsi::Value has to be kept alive on the native side. Methods look up
+// their EXGLContext by id on every call, like the JavaScriptCore methods do, so
+// a destroyed context just turns them into no-ops.
+//
+// TypedArrays are accessed through their jsi::ArrayBuffer: uniforms are copied
+// straight from the JS heap into the command buffer, other uploads make a
+// single copy for the GL thread.
+//
+// The binding covers the same methods as the JavaScriptCore one. Async
+// readbacks keep their callbacks in a queue on the JS object rather than in
+// native code, and the `NoCopyEXP` uploads copy like the regular ones since a
+// jsi::ArrayBuffer can't be pinned.
+
+class EXGLJsiContext {
+public:
+  // [JS thread] Create an EXGL context and save its JavaScript interface object
+  // at `global.__EXGLContexts[id]`
+  static UEXGLContextId install(facebook::jsi::Runtime &runtime);
+
+private:
+  EXGLJsiContext(EXGLContext &ctx, facebook::jsi::Runtime &runtime) : ctx(ctx), runtime(runtime) {}
+
+  EXGLContext &ctx;
+  facebook::jsi::Runtime &runtime;
+
+  // Argument conversions, same rules as EXJSValueToNumberFast & co.
+  static double number(const facebook::jsi::Value &value) noexcept;
+  bool arrayData(const facebook::jsi::Value &value, uint8_t *&data, size_t &byteLength);
+  std::shared_ptr<void> copyArray(const facebook::jsi::Value &value, size_t *pByteLength);
+  std::string string(const facebook::jsi::Value &value);
+  bool localPathFromImage(const facebook::jsi::Value &value, std::string &path);
+  void imageSizeFromObject(const facebook::jsi::Value &value, GLsizei *width, GLsizei *height);
+  UEXGLTextStyle textStyleFromObject(const facebook::jsi::Value &value);
+  std::vector<GLuint> uintArray(const facebook::jsi::Value &value);
+  std::vector<std::string> stringArray(const facebook::jsi::Value &value);
+  size_t bytesPerElement(const facebook::jsi::Value &value);
+  std::shared_ptr<void> copySubarray(const facebook::jsi::Value &value, size_t srcOffset,
+                                     size_t byteLength, const char *method);
+
+  // Result creation
+  facebook::jsi::Value makeTypedArray(const char *constructor, const void *data, size_t byteLength);
+  facebook::jsi::Value makeActiveInfo(const char *name, GLint size, GLenum type);
+  static facebook::jsi::Value objectOrNull(UEXGLObjectId exglObjId) noexcept;
+
+  // Async readbacks, see `readPixelsAsyncEXP`
+  facebook::jsi::Array readbackCallbacks();
+  void resolveReadbacks();
+
+#define _JSI_METHOD_DECLARATION(name)                                             \
+  static facebook::jsi::Value jsiStatic_##name(facebook::jsi::Runtime &runtime,   \
+                                               UEXGLContextId exglCtxId,          \
+                                               const facebook::jsi::Value *args,  \
+                                               size_t argc);                      \
+  facebook::jsi::Value name(const facebook::jsi::Value *args, size_t argc)
+
+  // The WebGL context
+  _JSI_METHOD_DECLARATION(getContextAttributes);
+  _JSI_METHOD_DECLARATION(isContextLost);
+
+  // Viewing and clipping
+  _JSI_METHOD_DECLARATION(scissor);
+  _JSI_METHOD_DECLARATION(viewport);
+
+  // State information
+  _JSI_METHOD_DECLARATION(activeTexture);
+  _JSI_METHOD_DECLARATION(blendColor);
+  _JSI_METHOD_DECLARATION(blendEquation);
+  _JSI_METHOD_DECLARATION(blendEquationSeparate);
+  _JSI_METHOD_DECLARATION(blendFunc);
+  _JSI_METHOD_DECLARATION(blendFuncSeparate);
+  _JSI_METHOD_DECLARATION(clearColor);
+  _JSI_METHOD_DECLARATION(clearDepth);
+  _JSI_METHOD_DECLARATION(clearStencil);
+  _JSI_METHOD_DECLARATION(colorMask);
+  _JSI_METHOD_DECLARATION(cullFace);
+  _JSI_METHOD_DECLARATION(depthFunc);
+  _JSI_METHOD_DECLARATION(depthMask);
+  _JSI_METHOD_DECLARATION(depthRange);
+  _JSI_METHOD_DECLARATION(disable);
+  _JSI_METHOD_DECLARATION(enable);
+  _JSI_METHOD_DECLARATION(frontFace);
+  _JSI_METHOD_DECLARATION(getParameter);
+  _JSI_METHOD_DECLARATION(getError);
+  _JSI_METHOD_DECLARATION(hint);
+  _JSI_METHOD_DECLARATION(isEnabled);
+  _JSI_METHOD_DECLARATION(lineWidth);
+  _JSI_METHOD_DECLARATION(pixelStorei);
+  _JSI_METHOD_DECLARATION(polygonOffset);
+  _JSI_METHOD_DECLARATION(sampleCoverage);
+  _JSI_METHOD_DECLARATION(stencilFunc);
+  _JSI_METHOD_DECLARATION(stencilFuncSeparate);
+  _JSI_METHOD_DECLARATION(stencilMask);
+  _JSI_METHOD_DECLARATION(stencilMaskSeparate);
+  _JSI_METHOD_DECLARATION(stencilOp);
+  _JSI_METHOD_DECLARATION(stencilOpSeparate);
+
+  // Buffers
+  _JSI_METHOD_DECLARATION(bindBuffer);
+  _JSI_METHOD_DECLARATION(bufferData);
+  _JSI_METHOD_DECLARATION(bufferSubData);
+  _JSI_METHOD_DECLARATION(createBuffer);
+  _JSI_METHOD_DECLARATION(deleteBuffer);
+  _JSI_METHOD_DECLARATION(getBufferParameter);
+  _JSI_METHOD_DECLARATION(isBuffer);
+
+  // Buffers (WebGL2)
+  _JSI_METHOD_DECLARATION(copyBufferSubData);
+  _JSI_METHOD_DECLARATION(getBufferSubData);
+
+  // Framebuffers
+  _JSI_METHOD_DECLARATION(bindFramebuffer);
+  _JSI_METHOD_DECLARATION(checkFramebufferStatus);
+  _JSI_METHOD_DECLARATION(createFramebuffer);
+  _JSI_METHOD_DECLARATION(deleteFramebuffer);
+  _JSI_METHOD_DECLARATION(framebufferRenderbuffer);
+  _JSI_METHOD_DECLARATION(framebufferTexture2D);
+  _JSI_METHOD_DECLARATION(getFramebufferAttachmentParameter);
+  _JSI_METHOD_DECLARATION(isFramebuffer);
+  _JSI_METHOD_DECLARATION(readPixels);
+
+  // Framebuffers (WebGL2)
+  _JSI_METHOD_DECLARATION(blitFramebuffer);
+  _JSI_METHOD_DECLARATION(framebufferTextureLayer);
+  _JSI_METHOD_DECLARATION(invalidateFramebuffer);
+  _JSI_METHOD_DECLARATION(invalidateSubFramebuffer);
+  _JSI_METHOD_DECLARATION(readBuffer);
+
+  // Renderbuffers
+  _JSI_METHOD_DECLARATION(bindRenderbuffer);
+  _JSI_METHOD_DECLARATION(createRenderbuffer);
+  _JSI_METHOD_DECLARATION(deleteRenderbuffer);
+  _JSI_METHOD_DECLARATION(getRenderbufferParameter);
+  _JSI_METHOD_DECLARATION(isRenderbuffer);
+  _JSI_METHOD_DECLARATION(renderbufferStorage);
+
+  // Renderbuffers (WebGL2)
+  _JSI_METHOD_DECLARATION(getInternalformatParameter);
+  _JSI_METHOD_DECLARATION(renderbufferStorageMultisample);
+
+  // Textures
+  _JSI_METHOD_DECLARATION(bindTexture);
+  _JSI_METHOD_DECLARATION(compressedTexImage2D);
+  _JSI_METHOD_DECLARATION(compressedTexSubImage2D);
+  _JSI_METHOD_DECLARATION(copyTexImage2D);
+  _JSI_METHOD_DECLARATION(copyTexSubImage2D);
+  _JSI_METHOD_DECLARATION(createTexture);
+  _JSI_METHOD_DECLARATION(deleteTexture);
+  _JSI_METHOD_DECLARATION(generateMipmap);
+  _JSI_METHOD_DECLARATION(texImage2D);
+  _JSI_METHOD_DECLARATION(texSubImage2D);
+  _JSI_METHOD_DECLARATION(texParameterf);
+  _JSI_METHOD_DECLARATION(texParameteri);
+  _JSI_METHOD_DECLARATION(getTexParameter);
+  _JSI_METHOD_DECLARATION(isTexture);
+
+  // Textures (WebGL2)
+  _JSI_METHOD_DECLARATION(texStorage2D);
+  _JSI_METHOD_DECLARATION(texStorage3D);
+  _JSI_METHOD_DECLARATION(texImage3D);
+  _JSI_METHOD_DECLARATION(texSubImage3D);
+  _JSI_METHOD_DECLARATION(copyTexSubImage3D);
+  _JSI_METHOD_DECLARATION(compressedTexImage3D);
+  _JSI_METHOD_DECLARATION(compressedTexSubImage3D);
+
+  // Programs and shaders
+  _JSI_METHOD_DECLARATION(attachShader);
+  _JSI_METHOD_DECLARATION(bindAttribLocation);
+  _JSI_METHOD_DECLARATION(compileShader);
+  _JSI_METHOD_DECLARATION(createProgram);
+  _JSI_METHOD_DECLARATION(createShader);
+  _JSI_METHOD_DECLARATION(deleteProgram);
+  _JSI_METHOD_DECLARATION(deleteShader);
+  _JSI_METHOD_DECLARATION(detachShader);
+  _JSI_METHOD_DECLARATION(getAttachedShaders);
+  _JSI_METHOD_DECLARATION(getProgramParameter);
+  _JSI_METHOD_DECLARATION(getShaderParameter);
+  _JSI_METHOD_DECLARATION(getShaderPrecisionFormat);
+  _JSI_METHOD_DECLARATION(getProgramInfoLog);
+  _JSI_METHOD_DECLARATION(getShaderInfoLog);
+  _JSI_METHOD_DECLARATION(getShaderSource);
+  _JSI_METHOD_DECLARATION(isProgram);
+  _JSI_METHOD_DECLARATION(isShader);
+  _JSI_METHOD_DECLARATION(linkProgram);
+  _JSI_METHOD_DECLARATION(shaderSource);
+  _JSI_METHOD_DECLARATION(useProgram);
+  _JSI_METHOD_DECLARATION(validateProgram);
+
+  // Programs and shaders (WebGL2)
+  _JSI_METHOD_DECLARATION(getFragDataLocation);
+
+  // Uniforms and attributes
+  _JSI_METHOD_DECLARATION(disableVertexAttribArray);
+  _JSI_METHOD_DECLARATION(enableVertexAttribArray);
+  _JSI_METHOD_DECLARATION(getActiveAttrib);
+  _JSI_METHOD_DECLARATION(getActiveUniform);
+  _JSI_METHOD_DECLARATION(getAttribLocation);
+  _JSI_METHOD_DECLARATION(getUniform);
+  _JSI_METHOD_DECLARATION(getUniformLocation);
+  _JSI_METHOD_DECLARATION(getVertexAttrib);
+  _JSI_METHOD_DECLARATION(getVertexAttribOffset);
+  _JSI_METHOD_DECLARATION(uniform1f);
+  _JSI_METHOD_DECLARATION(uniform2f);
+  _JSI_METHOD_DECLARATION(uniform3f);
+  _JSI_METHOD_DECLARATION(uniform4f);
+  _JSI_METHOD_DECLARATION(uniform1fv);
+  _JSI_METHOD_DECLARATION(uniform2fv);
+  _JSI_METHOD_DECLARATION(uniform3fv);
+  _JSI_METHOD_DECLARATION(uniform4fv);
+  _JSI_METHOD_DECLARATION(uniform1i);
+  _JSI_METHOD_DECLARATION(uniform2i);
+  _JSI_METHOD_DECLARATION(uniform3i);
+  _JSI_METHOD_DECLARATION(uniform4i);
+  _JSI_METHOD_DECLARATION(uniform1iv);
+  _JSI_METHOD_DECLARATION(uniform2iv);
+  _JSI_METHOD_DECLARATION(uniform3iv);
+  _JSI_METHOD_DECLARATION(uniform4iv);
+  _JSI_METHOD_DECLARATION(uniformMatrix2fv);
+  _JSI_METHOD_DECLARATION(uniformMatrix3fv);
+  _JSI_METHOD_DECLARATION(uniformMatrix4fv);
+  _JSI_METHOD_DECLARATION(vertexAttrib1fv);
+  _JSI_METHOD_DECLARATION(vertexAttrib2fv);
+  _JSI_METHOD_DECLARATION(vertexAttrib3fv);
+  _JSI_METHOD_DECLARATION(vertexAttrib4fv);
+  _JSI_METHOD_DECLARATION(vertexAttrib1f);
+  _JSI_METHOD_DECLARATION(vertexAttrib2f);
+  _JSI_METHOD_DECLARATION(vertexAttrib3f);
+  _JSI_METHOD_DECLARATION(vertexAttrib4f);
+  _JSI_METHOD_DECLARATION(vertexAttribPointer);
+
+  // Uniforms and attributes (WebGL2)
+  _JSI_METHOD_DECLARATION(uniform1ui);
+  _JSI_METHOD_DECLARATION(uniform2ui);
+  _JSI_METHOD_DECLARATION(uniform3ui);
+  _JSI_METHOD_DECLARATION(uniform4ui);
+  _JSI_METHOD_DECLARATION(uniform1uiv);
+  _JSI_METHOD_DECLARATION(uniform2uiv);
+  _JSI_METHOD_DECLARATION(uniform3uiv);
+  _JSI_METHOD_DECLARATION(uniform4uiv);
+  _JSI_METHOD_DECLARATION(uniformMatrix3x2fv);
+  _JSI_METHOD_DECLARATION(uniformMatrix4x2fv);
+  _JSI_METHOD_DECLARATION(uniformMatrix2x3fv);
+  _JSI_METHOD_DECLARATION(uniformMatrix4x3fv);
+  _JSI_METHOD_DECLARATION(uniformMatrix2x4fv);
+  _JSI_METHOD_DECLARATION(uniformMatrix3x4fv);
+  _JSI_METHOD_DECLARATION(vertexAttribI4i);
+  _JSI_METHOD_DECLARATION(vertexAttribI4ui);
+  _JSI_METHOD_DECLARATION(vertexAttribI4iv);
+  _JSI_METHOD_DECLARATION(vertexAttribI4uiv);
+  _JSI_METHOD_DECLARATION(vertexAttribIPointer);
+
+  // Drawing buffers
+  _JSI_METHOD_DECLARATION(clear);
+  _JSI_METHOD_DECLARATION(drawArrays);
+  _JSI_METHOD_DECLARATION(drawElements);
+  _JSI_METHOD_DECLARATION(finish);
+  _JSI_METHOD_DECLARATION(flush);
+
+  // Drawing buffers (WebGL2)
+  _JSI_METHOD_DECLARATION(vertexAttribDivisor);
+  _JSI_METHOD_DECLARATION(drawArraysInstanced);
+  _JSI_METHOD_DECLARATION(drawElementsInstanced);
+  _JSI_METHOD_DECLARATION(drawRangeElements);
+  _JSI_METHOD_DECLARATION(drawBuffers);
+  _JSI_METHOD_DECLARATION(clearBufferfv);
+  _JSI_METHOD_DECLARATION(clearBufferiv);
+  _JSI_METHOD_DECLARATION(clearBufferuiv);
+  _JSI_METHOD_DECLARATION(clearBufferfi);
+
+  // Query objects (WebGL2)
+  _JSI_METHOD_DECLARATION(createQuery);
+  _JSI_METHOD_DECLARATION(deleteQuery);
+  _JSI_METHOD_DECLARATION(isQuery);
+  _JSI_METHOD_DECLARATION(beginQuery);
+  _JSI_METHOD_DECLARATION(endQuery);
+  _JSI_METHOD_DECLARATION(getQuery);
+  _JSI_METHOD_DECLARATION(getQueryParameter);
+
+  // Samplers (WebGL2)
+  _JSI_METHOD_DECLARATION(createSampler);
+  _JSI_METHOD_DECLARATION(deleteSampler);
+  _JSI_METHOD_DECLARATION(bindSampler);
+  _JSI_METHOD_DECLARATION(isSampler);
+  _JSI_METHOD_DECLARATION(samplerParameteri);
+  _JSI_METHOD_DECLARATION(samplerParameterf);
+  _JSI_METHOD_DECLARATION(getSamplerParameter);
+
+  // Sync objects (WebGL2)
+  _JSI_METHOD_DECLARATION(fenceSync);
+  _JSI_METHOD_DECLARATION(isSync);
+  _JSI_METHOD_DECLARATION(deleteSync);
+  _JSI_METHOD_DECLARATION(clientWaitSync);
+  _JSI_METHOD_DECLARATION(waitSync);
+  _JSI_METHOD_DECLARATION(getSyncParameter);
+
+  // Transform feedback (WebGL2)
+  _JSI_METHOD_DECLARATION(createTransformFeedback);
+  _JSI_METHOD_DECLARATION(deleteTransformFeedback);
+  _JSI_METHOD_DECLARATION(isTransformFeedback);
+  _JSI_METHOD_DECLARATION(bindTransformFeedback);
+  _JSI_METHOD_DECLARATION(beginTransformFeedback);
+  _JSI_METHOD_DECLARATION(endTransformFeedback);
+  _JSI_METHOD_DECLARATION(transformFeedbackVaryings);
+  _JSI_METHOD_DECLARATION(getTransformFeedbackVarying);
+  _JSI_METHOD_DECLARATION(pauseTransformFeedback);
+  _JSI_METHOD_DECLARATION(resumeTransformFeedback);
+
+  // Uniform buffer objects (WebGL2)
+  _JSI_METHOD_DECLARATION(bindBufferBase);
+  _JSI_METHOD_DECLARATION(bindBufferRange);
+  _JSI_METHOD_DECLARATION(getUniformIndices);
+  _JSI_METHOD_DECLARATION(getActiveUniforms);
+  _JSI_METHOD_DECLARATION(getUniformBlockIndex);
+  _JSI_METHOD_DECLARATION(getActiveUniformBlockParameter);
+  _JSI_METHOD_DECLARATION(getActiveUniformBlockName);
+  _JSI_METHOD_DECLARATION(uniformBlockBinding);
+
+  // Vertex Array Objects (WebGL2)
+  _JSI_METHOD_DECLARATION(createVertexArray);
+  _JSI_METHOD_DECLARATION(deleteVertexArray);
+  _JSI_METHOD_DECLARATION(bindVertexArray);
+  _JSI_METHOD_DECLARATION(isVertexArray);
+
+  // Extensions
+  _JSI_METHOD_DECLARATION(getSupportedExtensions);
+  _JSI_METHOD_DECLARATION(getExtension);
+
+  // Exponent extensions
+  _JSI_METHOD_DECLARATION(endFrameEXP);
+  _JSI_METHOD_DECLARATION(flushEXP);
+  _JSI_METHOD_DECLARATION(bufferDataNoCopyEXP);
+  _JSI_METHOD_DECLARATION(bufferSubDataNoCopyEXP);
+  _JSI_METHOD_DECLARATION(texImage2DNoCopyEXP);
+  _JSI_METHOD_DECLARATION(readPixelsAsyncEXP);
+  _JSI_METHOD_DECLARATION(getBufferSubDataAsyncEXP);
+  _JSI_METHOD_DECLARATION(enableStateCachingEXP);
+  _JSI_METHOD_DECLARATION(enableDeferredErrorsEXP);
+  _JSI_METHOD_DECLARATION(setBacklogPolicyEXP);
+  _JSI_METHOD_DECLARATION(compressedTexImageKTXEXP);
+  _JSI_METHOD_DECLARATION(enableFrameStatsEXP);
+  _JSI_METHOD_DECLARATION(getFrameStatsEXP);
+  _JSI_METHOD_DECLARATION(uniformBlockUpdateEXP);
+  _JSI_METHOD_DECLARATION(multiDrawElementsEXP);
+  _JSI_METHOD_DECLARATION(updateExternalTextureEXP);
+  _JSI_METHOD_DECLARATION(startTraceEXP);
+  _JSI_METHOD_DECLARATION(stopTraceEXP);
+  _JSI_METHOD_DECLARATION(getFrameDeadlineEXP);
+  _JSI_METHOD_DECLARATION(setResidencyBudgetEXP);
+  _JSI_METHOD_DECLARATION(getResidencyCandidatesEXP);
+  _JSI_METHOD_DECLARATION(setUploadBudgetEXP);
+  _JSI_METHOD_DECLARATION(startRecordingEXP);
+  _JSI_METHOD_DECLARATION(stopRecordingEXP);
+  _JSI_METHOD_DECLARATION(texStorage2DLevelsEXP);
+  _JSI_METHOD_DECLARATION(texImage2DTextEXP);
+  _JSI_METHOD_DECLARATION(texSubImage2DTextEXP);
+
+#undef _JSI_METHOD_DECLARATION
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include "EXGLMappedImage.h"
+#include "EXGLCompressedTexture.h"
+#include "EXGLPixelKernels.h"
+#include "stb_image.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+std::shared_ptr<void> EXGLMapFile(const std::string &path, size_t &byteLength) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+    close(fd);
+    return nullptr;
+  }
+  size_t length = (size_t) info.st_size;
+  void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping holds its own reference to the file
+  close(fd);
+  if (address == MAP_FAILED) {
+    return nullptr;
+  }
+  byteLength = length;
+  return std::shared_ptr<void>(address, [length](void *p) { munmap(p, length); });
+}
+
+bool EXGLMappedImage::load(const std::string &path, GLsizei width, GLsizei height,
+                           GLenum format, GLenum type, size_t bytesPerPixel,
+                           EXGLMappedImage &image, std::string &error) {
+  size_t byteLength = 0;
+  auto mapping = EXGLMapFile(path, byteLength);
+  if (!mapping) {
+    return false;
+  }
+  auto bytes = (const uint8_t *) mapping.get();
+
+  static const uint8_t ktxPrefix[5] = { 0xAB, 'K', 'T', 'X', ' ' };
+  if (byteLength >= sizeof(ktxPrefix) && memcmp(bytes, ktxPrefix, sizeof(ktxPrefix)) == 0) {
+    EXGLCompressedTexture texture;
+    if (!EXGLCompressedTexture::load(path, texture, error)) {
+      return false;
+    }
+    if (texture.isCompressed()) {
+      error = "compressed textures have to be uploaded with gl.compressedTexImageKTXEXP()";
+      return false;
+    }
+    if (texture.target() != GL_TEXTURE_2D) {
+      error = "only 2D textures can be uploaded with texImage2D";
+      return false;
+    }
+    if (texture.format != format || texture.type != type) {
+      error = "the file's format and type don't match the upload's";
+      return false;
+    }
+    const auto &level0 = texture.images[0];
+    size_t packedRow = (size_t) texture.width * bytesPerPixel;
+    size_t bytesPerRow = level0.byteLength / texture.height;
+    if (packedRow == 0 || bytesPerRow * texture.height != level0.byteLength) {
+      error = "unexpected image size";
+      return false;
+    }
+    if (bytesPerRow == packedRow) {
+      image.unpackAlignment = 1;
+    } else if (bytesPerRow == ((packedRow + 3) & ~(size_t) 3)) {
+      // KTX 1.1 pads rows to 4 bytes
+      image.unpackAlignment = 4;
+    } else {
+      error = "unexpected row padding";
+      return false;
+    }
+    image.mapping = texture.storage;
+    image.pixels = (const uint8_t *) level0.data;
+    image.width = texture.width;
+    image.height = texture.height;
+    image.bytesPerRow = bytesPerRow;
+    return true;
+  }
+
+  // Raw pixels are only recognized by their size, make sure it's not a PNG or
+  // JPEG that happens to match
+  size_t bytesPerRow = (size_t) width * bytesPerPixel;
+  int infoWidth, infoHeight, infoComp;
+  if (width <= 0 || height <= 0 || bytesPerRow == 0 || bytesPerRow * height != byteLength ||
+      byteLength > INT32_MAX ||
+      stbi_info_from_memory(bytes, (int) byteLength, &infoWidth, &infoHeight, &infoComp)) {
+    return false;
+  }
+  image.mapping = std::move(mapping);
+  image.pixels = bytes;
+  image.width = width;
+  image.height = height;
+  image.bytesPerRow = bytesPerRow;
+  image.unpackAlignment = 1;
+  return true;
+}
+
+void EXGLMappedImage::upload(GLenum target, GLint level, GLint internalformat, GLenum format,
+                             GLenum type, bool sub, GLint xoffset, GLint yoffset, size_t tileBytes,
+                             bool flipY, bool premultiplyAlpha) const noexcept {
+  premultiplyAlpha = premultiplyAlpha && format == GL_RGBA && type == GL_UNSIGNED_BYTE;
+  bool convert = flipY || premultiplyAlpha;
+  GLsizei rowsPerTile = (GLsizei) std::max<size_t>(1, std::min<size_t>(tileBytes / bytesPerRow, height));
+
+  GLint previousAlignment;
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+
+  if (!sub) {
+    if (rowsPerTile == height && !convert) {
+      // Fits the budget, handed over as it is
+      glTexImage2D(target, level, internalformat, width, height, 0, format, type, pixels);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+      return;
+    }
+    glTexImage2D(target, level, internalformat, width, height, 0, format, type, nullptr);
+  }
+
+  // Reused by every upload on this thread
+  thread_local std::vector<uint8_t> scratch;
+  for (GLsizei y = 0; y < height; y += rowsPerTile) {
+    GLsizei rows = std::min(rowsPerTile, height - y);
+    const uint8_t *band = pixels + (size_t) y * bytesPerRow;
+    GLint bandY = flipY ? height - y - rows : y;
+    if (convert) {
+      scratch.assign(band, band + (size_t) rows * bytesPerRow);
+      if (flipY) {
+        EXGLFlipRows(scratch.data(), bytesPerRow, rows);
+      }
+      if (premultiplyAlpha) {
+        // RGBA8 rows are never padded
+        EXGLPremultiplyAlpha(scratch.data(), (size_t) width * rows);
+      }
+      band = scratch.data();
+    }
+    glTexSubImage2D(target, level, xoffset, yoffset + bandY, width, rows, format, type, band);
+  }
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+}
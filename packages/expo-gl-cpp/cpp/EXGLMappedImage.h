@@ -0,0 +1,62 @@
+#ifndef __EXGLMAPPEDIMAGE_H__
+#define __EXGLMAPPEDIMAGE_H__
+
+#ifdef __ANDROID__
+#include <GLES3/gl3.h>
+#endif
+#ifdef __APPLE__
+#include <OpenGLES/ES3/gl.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+
+// [Any thread] Map the file at `path` read-only, null if it can't be. The pages
+// stay mapped until the last copy of the pointer is gone.
+std::shared_ptr<void> EXGLMapFile(const std::string &path, size_t &byteLength);
+
+
+// --- EXGLMappedImage ---------------------------------------------------------
+
+// Pre-baked pixels used by `texImage2D` / `texSubImage2D` straight from a
+// read-only mapping of their file, instead of being decoded into a heap buffer
+// first. Two kinds of `{ localUri }` sources are mapped:
+//
+//   - uncompressed 2D KTX and KTX2 files, level 0 is uploaded
+//   - raw files of tightly packed pixels in the upload's format and type, for
+//     sources that also give `width` and `height` matching the file size
+//
+// Uploads bigger than the context's upload budget are streamed in bands of
+// rows with `glTexSubImage2D`, so the driver never stages the whole image at
+// once. UNPACK_FLIP_Y_WEBGL and UNPACK_PREMULTIPLY_ALPHA_WEBGL are applied per
+// band in a scratch buffer since the mapping can't be written to.
+
+struct EXGLMappedImage {
+  std::shared_ptr<void> mapping; // keeps `pixels` valid
+  const uint8_t *pixels = nullptr;
+  GLsizei width = 0;
+  GLsizei height = 0;
+  size_t bytesPerRow = 0;
+  GLint unpackAlignment = 1;
+
+  // [Any thread] Map `path` if it's a KTX file or raw pixels of `width` x
+  // `height` (0 if the source didn't say). Returns false with an empty `error`
+  // if it's neither, the file should then be decoded as usual, and false with
+  // `error` set if it's a KTX file that can't be uploaded with `format` and
+  // `type`.
+  static bool load(const std::string &path, GLsizei width, GLsizei height,
+                   GLenum format, GLenum type, size_t bytesPerPixel,
+                   EXGLMappedImage &image, std::string &error);
+
+  // [GL thread] Upload to `level` of the texture bound to `target`. Defines the
+  // image with `internalformat` if `sub` isn't set, updates the region at
+  // `xoffset`, `yoffset` otherwise. `tileBytes` bounds each upload call.
+  void upload(GLenum target, GLint level, GLint internalformat, GLenum format, GLenum type,
+              bool sub, GLint xoffset, GLint yoffset, size_t tileBytes,
+              bool flipY, bool premultiplyAlpha) const noexcept;
+};
+
+#endif
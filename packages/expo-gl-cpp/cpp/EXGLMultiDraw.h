@@ -0,0 +1,127 @@
+#ifndef __EXGLMULTIDRAW_H__
+#define __EXGLMULTIDRAW_H__
+
+#ifdef __ANDROID__
+#include <EGL/egl.h>
+#include <GLES3/gl3.h>
+#endif
+#ifdef __APPLE__
+#include <OpenGLES/ES3/gl.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "EXGLCommandBuffer.h"
+
+
+// --- EXGLMultiDraw -----------------------------------------------------------
+
+// Many `drawElements` calls with a uniform change in between, sent to the GL
+// thread as a single op by `gl.multiDrawElementsEXP`. Each draw is a record of
+// four int32s:
+//
+//   offset          byte offset into the bound ELEMENT_ARRAY_BUFFER
+//   count           number of indices
+//   instanceCount   1 for a plain draw, more for an instanced one, 0 skips it
+//   slot            index of the uniform value to set before drawing, -1 to
+//                   keep the current one
+//
+// Slots index an array of values of one uniform (a model matrix, a color...),
+// all of the same type. Runs of plain draws sharing a slot become a single
+// `glMultiDrawElementsEXT` where GL_EXT_multi_draw_arrays is available.
+
+struct EXGLDrawRecord {
+  int32_t offset;
+  int32_t count;
+  int32_t instanceCount;
+  int32_t slot;
+};
+
+static_assert(sizeof(EXGLDrawRecord) == 4 * sizeof(int32_t), "EXGLDrawRecord must be packed");
+
+class EXGLMultiDraw {
+public:
+  // [GL thread] Run `recordCount` records. `uniformData` holds the values of
+  // `uniformType` for every slot, it's only read when `location` isn't -1.
+  static void execute(GLenum mode, GLenum type, const EXGLDrawRecord *records, size_t recordCount,
+                      GLint location, GLenum uniformType, const void *uniformData) {
+    MultiDrawElements multiDrawElements = multiDrawElementsFunction();
+    size_t slotBytes = EXGLUniformComponents(uniformType) * sizeof(GLfloat);
+    auto uniformBytes = reinterpret_cast<const uint8_t *>(uniformData);
+    int32_t currentSlot = -1;
+
+    // Reused by the runs of plain draws
+    thread_local std::vector<GLsizei> counts;
+    thread_local std::vector<const void *> offsets;
+
+    size_t i = 0;
+    while (i < recordCount) {
+      const EXGLDrawRecord &record = records[i];
+      if (location != -1 && record.slot >= 0 && record.slot != currentSlot) {
+        EXGLUploadUniform(uniformType, location, 1, uniformBytes + record.slot * slotBytes);
+        currentSlot = record.slot;
+      }
+
+      if (record.instanceCount != 1) {
+        if (record.instanceCount > 1) {
+          glDrawElementsInstanced(mode, record.count, type, offsetPointer(record.offset),
+                                  record.instanceCount);
+        }
+        ++i;
+        continue;
+      }
+
+      // Plain draws up to the next uniform change
+      size_t end = i + 1;
+      while (end < recordCount && records[end].instanceCount == 1 &&
+             (location == -1 || records[end].slot < 0 || records[end].slot == currentSlot)) {
+        ++end;
+      }
+      if (end - i == 1 || !multiDrawElements) {
+        for (; i < end; ++i) {
+          glDrawElements(mode, records[i].count, type, offsetPointer(records[i].offset));
+        }
+        continue;
+      }
+      counts.clear();
+      offsets.clear();
+      for (; i < end; ++i) {
+        counts.push_back(records[i].count);
+        offsets.push_back(offsetPointer(records[i].offset));
+      }
+      multiDrawElements(mode, counts.data(), type, offsets.data(), (GLsizei) counts.size());
+    }
+  }
+
+private:
+  typedef void (*MultiDrawElements)(GLenum mode, const GLsizei *count, GLenum type,
+                                    const void *const *indices, GLsizei drawcount);
+
+  static inline const void *offsetPointer(int32_t offset) noexcept {
+    return reinterpret_cast<const void *>((intptr_t) offset);
+  }
+
+  // [GL thread] glMultiDrawElementsEXT if the context has it, looked up once
+  static MultiDrawElements multiDrawElementsFunction() {
+    static MultiDrawElements function = [] {
+      MultiDrawElements found = nullptr;
+#ifdef __ANDROID__
+      GLint count = 0;
+      glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+      for (GLint i = 0; i < count; ++i) {
+        if (strcmp((const char *) glGetStringi(GL_EXTENSIONS, i), "GL_EXT_multi_draw_arrays") == 0) {
+          found = (MultiDrawElements) eglGetProcAddress("glMultiDrawElementsEXT");
+          break;
+        }
+      }
+#endif
+      // iOS doesn't expose GL_EXT_multi_draw_arrays, draws stay separate calls
+      return found;
+    }();
+    return function;
+  }
+};
+
+#endif
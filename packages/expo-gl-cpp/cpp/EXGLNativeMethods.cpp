@@ -48,7 +48,7 @@
   // Wrapper that takes only scalar arguments and returns nothing
 #define _WRAP_METHOD_SIMPLE_INTERNAL(name, isWebGL2Method, glFunc, ...) \
   _WRAP_METHOD_INTERNAL(name, EXJS_ARGC(__VA_ARGS__), isWebGL2Method) { \
-    addToNextBatch(std::bind(glFunc, EXJS_MAP_EXT(0, _EXJS_COMMA, _WRAP_METHOD_SIMPLE_UNPACK, __VA_ARGS__))); \
+    addCallToNextBatch(glFunc, EXJS_MAP_EXT(0, _EXJS_COMMA, _WRAP_METHOD_SIMPLE_UNPACK, __VA_ARGS__)); \
     return nullptr;                                                     \
   }
 #define _WRAP_METHOD_SIMPLE(name, glFunc, ...) _WRAP_METHOD_SIMPLE_INTERNAL(name, false, glFunc, __VA_ARGS__)
@@ -56,6 +56,19 @@
 
 #define _WRAP_METHOD_SIMPLE_UNPACK(i, _) EXJSValueToNumberFast(jsCtx, jsArgv[i])
 
+  // Like `_WRAP_METHOD_SIMPLE` but the call is dropped if it wouldn't change
+  // `slot` in the shadow state
+#define _WRAP_METHOD_SIMPLE_SHADOWED(name, glFunc, slot, ...)           \
+  _WRAP_METHOD(name, EXJS_ARGC(__VA_ARGS__)) {                          \
+    const double args[] = { EXJS_MAP_EXT(0, _EXJS_COMMA, _WRAP_METHOD_SIMPLE_UNPACK, __VA_ARGS__) }; \
+    if (shadowState.update(EXGLShadowState::slot, args, EXJS_ARGC(__VA_ARGS__))) { \
+      addCallToNextBatch(glFunc, EXJS_MAP_EXT(0, _EXJS_COMMA, _WRAP_METHOD_SHADOWED_ARG, __VA_ARGS__)); \
+    }                                                                   \
+    return nullptr;                                                     \
+  }
+
+#define _WRAP_METHOD_SHADOWED_ARG(i, _) args[i]
+
 
 // This listing follows the order in
 // https://developer.mozilla.org/en-US/docs/Web/API/WebGLRenderingContext
@@ -74,64 +87,175 @@ _WRAP_METHOD(getContextAttributes, 0) {
   EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "stencil",
                                         JSValueMakeBoolean(jsCtx, false));
   EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "antialias",
-                                        JSValueMakeBoolean(jsCtx, false));
+                                        JSValueMakeBoolean(jsCtx, antialias));
   EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "premultipliedAlpha",
                                         JSValueMakeBoolean(jsCtx, false));
   return jsResult;
 }
 
 _WRAP_METHOD(isContextLost, 0) {
-  return JSValueMakeBoolean(jsCtx, false);
+  return JSValueMakeBoolean(jsCtx, contextLost);
 }
 
 
 // Viewing and clipping
 // --------------------
 
-_WRAP_METHOD_SIMPLE(scissor, glScissor, x, y, width, height)
+_WRAP_METHOD_SIMPLE_SHADOWED(scissor, glScissor, Scissor, x, y, width, height)
 
-_WRAP_METHOD_SIMPLE(viewport, glViewport, x, y, width, height)
+_WRAP_METHOD_SIMPLE_SHADOWED(viewport, glViewport, Viewport, x, y, width, height)
 
 
 // State information
 // -----------------
 
-_WRAP_METHOD_SIMPLE(activeTexture, glActiveTexture, texture)
+_WRAP_METHOD(activeTexture, 1) {
+  EXJS_UNPACK_ARGV(GLenum texture);
+  residency.activeTexture(texture);
+  const double args[] = { (double) texture };
+  if (shadowState.update(EXGLShadowState::ActiveTexture, args, 1)) {
+    addCallToNextBatch(glActiveTexture, texture);
+  }
+  return nullptr;
+}
+
+_WRAP_METHOD_SIMPLE_SHADOWED(blendColor, glBlendColor, BlendColor, red, green, blue, alpha)
+
+_WRAP_METHOD(blendEquation, 1) {
+  EXJS_UNPACK_ARGV(GLenum mode);
+  const double args[] = { (double) mode, (double) mode };
+  if (shadowState.update(EXGLShadowState::BlendEquation, args, 2)) {
+    addCallToNextBatch(glBlendEquation, mode);
+  }
+  return nullptr;
+}
 
-_WRAP_METHOD_SIMPLE(blendColor, glBlendColor, red, green, blue, alpha)
+_WRAP_METHOD_SIMPLE_SHADOWED(blendEquationSeparate, glBlendEquationSeparate, BlendEquation, modeRGB, modeAlpha)
 
-_WRAP_METHOD_SIMPLE(blendEquation, glBlendEquation, mode)
+_WRAP_METHOD(blendFunc, 2) {
+  EXJS_UNPACK_ARGV(GLenum sfactor, GLenum dfactor);
+  const double args[] = { (double) sfactor, (double) dfactor, (double) sfactor, (double) dfactor };
+  if (shadowState.update(EXGLShadowState::BlendFunc, args, 4)) {
+    addCallToNextBatch(glBlendFunc, sfactor, dfactor);
+  }
+  return nullptr;
+}
 
-_WRAP_METHOD_SIMPLE(blendEquationSeparate, glBlendEquationSeparate, modeRGB, modeAlpha)
+_WRAP_METHOD_SIMPLE_SHADOWED(blendFuncSeparate, glBlendFuncSeparate, BlendFunc, srcRGB, dstRGB, srcAlpha, dstAlpha)
 
-_WRAP_METHOD_SIMPLE(blendFunc, glBlendFunc, sfactor, dfactor)
+_WRAP_METHOD_SIMPLE_SHADOWED(clearColor, glClearColor, ClearColor, red, green, blue, alpha)
 
-_WRAP_METHOD_SIMPLE(blendFuncSeparate, glBlendFuncSeparate, srcRGB, dstRGB, srcAlpha, dstAlpha)
+_WRAP_METHOD_SIMPLE_SHADOWED(clearDepth, glClearDepthf, ClearDepth, depth)
 
-_WRAP_METHOD_SIMPLE(clearColor, glClearColor, red, green, blue, alpha)
+_WRAP_METHOD_SIMPLE_SHADOWED(clearStencil, glClearStencil, ClearStencil, s)
 
-_WRAP_METHOD_SIMPLE(clearDepth, glClearDepthf, depth)
+_WRAP_METHOD_SIMPLE_SHADOWED(colorMask, glColorMask, ColorMask, red, green, blue, alpha)
 
-_WRAP_METHOD_SIMPLE(clearStencil, glClearStencil, s)
+_WRAP_METHOD_SIMPLE_SHADOWED(cullFace, glCullFace, CullFace, mode)
 
-_WRAP_METHOD_SIMPLE(colorMask, glColorMask, red, green, blue, alpha)
+_WRAP_METHOD_SIMPLE_SHADOWED(depthFunc, glDepthFunc, DepthFunc, func)
 
-_WRAP_METHOD_SIMPLE(cullFace, glCullFace, mode)
+_WRAP_METHOD_SIMPLE_SHADOWED(depthMask, glDepthMask, DepthMask, flag)
 
-_WRAP_METHOD_SIMPLE(depthFunc, glDepthFunc, func)
+_WRAP_METHOD_SIMPLE_SHADOWED(depthRange, glDepthRangef, DepthRange, zNear, zFar)
 
-_WRAP_METHOD_SIMPLE(depthMask, glDepthMask, flag)
+_WRAP_METHOD(disable, 1) {
+  EXJS_UNPACK_ARGV(GLenum cap);
+  if (shadowState.updateCapability(cap, false)) {
+    addCallToNextBatch(glDisable, cap);
+  }
+  return nullptr;
+}
 
-_WRAP_METHOD_SIMPLE(depthRange, glDepthRangef, zNear, zFar)
+_WRAP_METHOD(enable, 1) {
+  EXJS_UNPACK_ARGV(GLenum cap);
+  if (shadowState.updateCapability(cap, true)) {
+    addCallToNextBatch(glEnable, cap);
+  }
+  return nullptr;
+}
 
-_WRAP_METHOD_SIMPLE(disable, glDisable, cap)
+_WRAP_METHOD_SIMPLE_SHADOWED(frontFace, glFrontFace, FrontFace, mode)
 
-_WRAP_METHOD_SIMPLE(enable, glEnable, cap)
+JSValueRef EXGLContext::getParameterFromShadowState(JSContextRef jsCtx, GLenum pname) {
+  double values[4];
+  auto floats = [&](EXGLShadowState::Slot slot, size_t count) -> JSValueRef {
+    if (!shadowState.get(slot, values, count)) {
+      return nullptr;
+    }
+    GLfloat results[4];
+    std::copy(values, values + count, results);
+    return makeTypedArray(jsCtx, kJSTypedArrayTypeFloat32Array, results, count * sizeof(GLfloat));
+  };
+  auto ints = [&](EXGLShadowState::Slot slot, size_t count) -> JSValueRef {
+    if (!shadowState.get(slot, values, count)) {
+      return nullptr;
+    }
+    GLint results[4];
+    std::copy(values, values + count, results);
+    return makeTypedArray(jsCtx, kJSTypedArrayTypeInt32Array, results, count * sizeof(GLint));
+  };
+  auto number = [&](EXGLShadowState::Slot slot, size_t index) -> JSValueRef {
+    if (!shadowState.get(slot, values, index + 1)) {
+      return nullptr;
+    }
+    return JSValueMakeNumber(jsCtx, (GLfloat) values[index]);
+  };
 
-_WRAP_METHOD_SIMPLE(frontFace, glFrontFace, mode)
+  switch (pname) {
+    case GL_VIEWPORT: return ints(EXGLShadowState::Viewport, 4);
+    case GL_SCISSOR_BOX: return ints(EXGLShadowState::Scissor, 4);
+    case GL_BLEND_COLOR: return floats(EXGLShadowState::BlendColor, 4);
+    case GL_COLOR_CLEAR_VALUE: return floats(EXGLShadowState::ClearColor, 4);
+    case GL_DEPTH_RANGE: return floats(EXGLShadowState::DepthRange, 2);
+    case GL_COLOR_WRITEMASK: {
+      if (!shadowState.get(EXGLShadowState::ColorMask, values, 4)) {
+        return nullptr;
+      }
+      JSValueRef jsResults[4];
+      for (unsigned int i = 0; i < 4; ++i) {
+        jsResults[i] = JSValueMakeBoolean(jsCtx, values[i] != 0);
+      }
+      return JSObjectMakeArray(jsCtx, 4, jsResults, nullptr);
+    }
+    case GL_DEPTH_WRITEMASK: {
+      if (!shadowState.get(EXGLShadowState::DepthMask, values, 1)) {
+        return nullptr;
+      }
+      return JSValueMakeBoolean(jsCtx, values[0] != 0);
+    }
+    case GL_BLEND_EQUATION_RGB: return number(EXGLShadowState::BlendEquation, 0);
+    case GL_BLEND_EQUATION_ALPHA: return number(EXGLShadowState::BlendEquation, 1);
+    case GL_BLEND_SRC_RGB: return number(EXGLShadowState::BlendFunc, 0);
+    case GL_BLEND_DST_RGB: return number(EXGLShadowState::BlendFunc, 1);
+    case GL_BLEND_SRC_ALPHA: return number(EXGLShadowState::BlendFunc, 2);
+    case GL_BLEND_DST_ALPHA: return number(EXGLShadowState::BlendFunc, 3);
+    case GL_DEPTH_CLEAR_VALUE: return number(EXGLShadowState::ClearDepth, 0);
+    case GL_STENCIL_CLEAR_VALUE: return number(EXGLShadowState::ClearStencil, 0);
+    case GL_CULL_FACE_MODE: return number(EXGLShadowState::CullFace, 0);
+    case GL_DEPTH_FUNC: return number(EXGLShadowState::DepthFunc, 0);
+    case GL_FRONT_FACE: return number(EXGLShadowState::FrontFace, 0);
+    case GL_LINE_WIDTH: return number(EXGLShadowState::LineWidth, 0);
+    case GL_POLYGON_OFFSET_FACTOR: return number(EXGLShadowState::PolygonOffset, 0);
+    case GL_POLYGON_OFFSET_UNITS: return number(EXGLShadowState::PolygonOffset, 1);
+    case GL_ACTIVE_TEXTURE: return number(EXGLShadowState::ActiveTexture, 0);
+    default: {
+      int capability = shadowState.getCapability(pname);
+      return capability < 0 ? nullptr : JSValueMakeBoolean(jsCtx, capability);
+    }
+  }
+}
 
 _WRAP_METHOD(getParameter, 1) {
   EXJS_UNPACK_ARGV(GLenum pname);
+  // Bindings are tracked natively, always
+  UEXGLObjectId binding;
+  if (residency.binding(pname, &binding)) {
+    return binding == 0 ? JSValueMakeNull(jsCtx) : JSValueMakeNumber(jsCtx, binding);
+  }
+  if (auto jsCached = getParameterFromShadowState(jsCtx, pname)) {
+    return jsCached;
+  }
   switch (pname) {
       // Float32Array[0]
     case GL_COMPRESSED_TEXTURE_FORMATS:
@@ -170,6 +294,7 @@ _WRAP_METHOD(getParameter, 1) {
     case GL_UNPACK_FLIP_Y_WEBGL:
       return JSValueMakeBoolean(jsCtx, unpackFLipY);
     case GL_UNPACK_PREMULTIPLY_ALPHA_WEBGL:
+      return JSValueMakeBoolean(jsCtx, unpackPremultiplyAlpha);
     case GL_UNPACK_COLORSPACE_CONVERSION_WEBGL:
       return JSValueMakeBoolean(jsCtx, false);
     case GL_RASTERIZER_DISCARD:
@@ -204,41 +329,6 @@ _WRAP_METHOD(getParameter, 1) {
       return JSValueMakeNumber(jsCtx, glFloat);
     }
 
-      // UEXGLObjectId
-    case GL_ARRAY_BUFFER_BINDING:
-    case GL_ELEMENT_ARRAY_BUFFER_BINDING:
-    case GL_CURRENT_PROGRAM: {
-      GLint glInt;
-      addBlockingToNextBatch([&] { glGetIntegerv(pname, &glInt); });
-      for (const auto &pair : objects) {
-        if (pair.second == glInt) {
-          return JSValueMakeNumber(jsCtx, pair.first);
-        }
-      }
-      return nullptr;
-    }
-
-      // Unimplemented...
-#define _GET_PARAMETER_UNIMPL(param)                                         \
-    case GL_##param:                                                       \
-      throw std::runtime_error("EXGL: getParameter() doesn't support gl."  \
-                               #param " yet!");
-      _GET_PARAMETER_UNIMPL(COPY_READ_BUFFER_BINDING)
-      _GET_PARAMETER_UNIMPL(COPY_WRITE_BUFFER_BINDING)
-      _GET_PARAMETER_UNIMPL(DRAW_FRAMEBUFFER_BINDING)
-      _GET_PARAMETER_UNIMPL(READ_FRAMEBUFFER_BINDING)
-      _GET_PARAMETER_UNIMPL(RENDERBUFFER)
-      _GET_PARAMETER_UNIMPL(SAMPLER_BINDING)
-      _GET_PARAMETER_UNIMPL(TEXTURE_BINDING_2D_ARRAY)
-      _GET_PARAMETER_UNIMPL(TEXTURE_BINDING_2D)
-      _GET_PARAMETER_UNIMPL(TEXTURE_BINDING_3D)
-      _GET_PARAMETER_UNIMPL(TEXTURE_BINDING_CUBE_MAP)
-      _GET_PARAMETER_UNIMPL(TRANSFORM_FEEDBACK_BINDING)
-      _GET_PARAMETER_UNIMPL(TRANSFORM_FEEDBACK_BUFFER_BINDING)
-      _GET_PARAMETER_UNIMPL(UNIFORM_BUFFER_BINDING)
-      _GET_PARAMETER_UNIMPL(VERTEX_ARRAY_BINDING)
-#undef _GET_PARAMETER_UNIMPL
-
       // int
     default: {
       GLint glInt;
@@ -249,6 +339,9 @@ _WRAP_METHOD(getParameter, 1) {
 }
 
 _WRAP_METHOD(getError, 0) {
+  if (deferredErrors) {
+    return JSValueMakeNumber(jsCtx, deferredError.exchange(GL_NO_ERROR));
+  }
   GLenum glResult;
   addBlockingToNextBatch([&] { glResult = glGetError(); });
   return JSValueMakeNumber(jsCtx, glResult);
@@ -258,12 +351,16 @@ _WRAP_METHOD_SIMPLE(hint, glHint, target, mode)
 
 _WRAP_METHOD(isEnabled, 1) {
   EXJS_UNPACK_ARGV(GLenum cap);
+  int capability = shadowState.getCapability(cap);
+  if (capability >= 0) {
+    return JSValueMakeBoolean(jsCtx, capability);
+  }
   GLboolean glResult;
   addBlockingToNextBatch([&] { glResult = glIsEnabled(cap); });
   return JSValueMakeBoolean(jsCtx, glResult);
 }
 
-_WRAP_METHOD_SIMPLE(lineWidth, glLineWidth, width)
+_WRAP_METHOD_SIMPLE_SHADOWED(lineWidth, glLineWidth, LineWidth, width)
 
 _WRAP_METHOD(pixelStorei, 2) {
   EXJS_UNPACK_ARGV(GLenum pname, GLint param);
@@ -271,6 +368,9 @@ _WRAP_METHOD(pixelStorei, 2) {
     case GL_UNPACK_FLIP_Y_WEBGL:
       unpackFLipY = param;
       break;
+    case GL_UNPACK_PREMULTIPLY_ALPHA_WEBGL:
+      unpackPremultiplyAlpha = param;
+      break;
     default:
       EXGLSysLog("EXGL: gl.pixelStorei() doesn't support this parameter yet!");
       break;
@@ -278,7 +378,7 @@ _WRAP_METHOD(pixelStorei, 2) {
   return nullptr;
 }
 
-_WRAP_METHOD_SIMPLE(polygonOffset, glPolygonOffset, factor, units)
+_WRAP_METHOD_SIMPLE_SHADOWED(polygonOffset, glPolygonOffset, PolygonOffset, factor, units)
 
 _WRAP_METHOD_SIMPLE(sampleCoverage, glSampleCoverage, value, invert)
 
@@ -300,7 +400,15 @@ _WRAP_METHOD_SIMPLE(stencilOpSeparate, glStencilOpSeparate, face, fail, zfail, z
 
 _WRAP_METHOD(bindBuffer, 2) {
   EXJS_UNPACK_ARGV(GLenum target, UEXGLObjectId fBuffer);
-  addToNextBatch([=] { glBindBuffer(target, lookupObject(fBuffer)); });
+  residency.bindBuffer(target, fBuffer);
+  const double args[] = { (double) fBuffer };
+  if (target == GL_ARRAY_BUFFER && !shadowState.update(EXGLShadowState::ArrayBuffer, args, 1)) {
+    return nullptr;
+  }
+  if (target == GL_ELEMENT_ARRAY_BUFFER && !shadowState.update(EXGLShadowState::ElementArrayBuffer, args, 1)) {
+    return nullptr;
+  }
+  addBindToNextBatch(glBindBuffer, target, fBuffer);
   return nullptr;
 }
 
@@ -311,13 +419,20 @@ _WRAP_METHOD(bufferData, 3) {
 
   if (JSValueIsNumber(jsCtx, jsSecond)) {
     GLsizeiptr length = EXJSValueToNumberFast(jsCtx, jsSecond);
+    residency.bufferStorage(target, length);
     addToNextBatch([=] { glBufferData(target, length, nullptr, usage); });
+    traceLastClosure(EXGLTraceEvent::BufferData, { (double) target, (double) length, (double) usage });
   } else if (JSValueIsNull(jsCtx, jsSecond)) {
+    residency.bufferStorage(target, 0);
     addToNextBatch([=] { glBufferData(target, 0, nullptr, usage); });
+    traceLastClosure(EXGLTraceEvent::BufferData, { (double) target, 0, (double) usage });
   } else {
     size_t length;
     auto data = jsValueToSharedArray(jsCtx, jsSecond, &length);
+    residency.bufferStorage(target, length);
     addToNextBatch([=] { glBufferData(target, length, data.get(), usage); });
+    traceLastClosure(EXGLTraceEvent::BufferData, { (double) target, (double) length, (double) usage },
+                     data.get(), length);
   }
   return nullptr;
 }
@@ -328,6 +443,7 @@ _WRAP_METHOD(bufferSubData, 3) {
     size_t length;
     auto data = jsValueToSharedArray(jsCtx, jsArgv[2], &length);
     addToNextBatch([=] { glBufferSubData(target, offset, length, data.get()); });
+    traceLastClosure(EXGLTraceEvent::BufferSubData, { (double) target, (double) offset }, data.get(), length);
   }
   return nullptr;
 }
@@ -342,6 +458,9 @@ _WRAP_METHOD(createBuffer, 0) {
 
 _WRAP_METHOD(deleteBuffer, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fBuffer);
+  shadowState.forgetObject(fBuffer);
+  residency.forget(fBuffer);
+  vertexArrays.forgetBuffer(fBuffer);
   addToNextBatch([=] {
     GLuint buffer = lookupObject(fBuffer);
     glDeleteBuffers(1, &buffer);
@@ -377,8 +496,59 @@ _WRAP_METHOD_IS_OBJECT(Buffer)
 _WRAP_WEBGL2_METHOD_SIMPLE(copyBufferSubData, glCopyBufferSubData,
                     readTarget, writeTarget, readOffset, writeOffset, size)
 
-// glGetBufferSubData is not available in OpenGL ES
-_WRAP_METHOD_UNIMPL(getBufferSubData)
+// glGetBufferSubData is not available in OpenGL ES, map the range instead.
+// `dstOffset` and `length` count elements of `dstData`, as in WebGL.
+_WRAP_WEBGL2_METHOD(getBufferSubData, 3) {
+  EXJS_UNPACK_ARGV(GLenum target, GLintptr srcByteOffset);
+  JSObjectRef jsDst = (JSObjectRef) jsArgv[2];
+  JSTypedArrayType arrayType = JSValueGetTypedArrayType(jsCtx, jsArgv[2], nullptr);
+  if (arrayType == kJSTypedArrayTypeNone || arrayType == kJSTypedArrayTypeArrayBuffer) {
+    throw std::runtime_error("EXGL: gl.getBufferSubData() expects an ArrayBufferView!");
+  }
+  size_t elementSize = typedArrayElementSize(arrayType);
+  size_t dstByteLength = JSObjectGetTypedArrayByteLength(jsCtx, jsDst, nullptr);
+  size_t dstOffset = jsArgc > 3 ? EXJSValueToNumberFast(jsCtx, jsArgv[3]) : 0;
+  size_t length = jsArgc > 4 ? EXJSValueToNumberFast(jsCtx, jsArgv[4]) : 0;
+  if (dstOffset * elementSize > dstByteLength) {
+    throw std::runtime_error("EXGL: gl.getBufferSubData() dstOffset is past the end of dstData!");
+  }
+  if (length == 0) {
+    length = dstByteLength / elementSize - dstOffset;
+  }
+  size_t byteLength = length * elementSize;
+  if ((dstOffset + length) * elementSize > dstByteLength) {
+    throw std::runtime_error("EXGL: gl.getBufferSubData() reads past the end of dstData!");
+  }
+  if (byteLength == 0) {
+    return nullptr;
+  }
+
+  // The JS thread waits, the GL thread can write straight into the TypedArray
+  std::shared_ptr<void> copy;
+  auto dst = (uint8_t *) JSObjectGetTypedArrayBytesPtr(jsCtx, jsDst, nullptr);
+  if (usingTypedArrayHack || !dst) {
+    copy = std::shared_ptr<void>(JSObjectGetTypedArrayDataMalloc(jsCtx, jsDst, &dstByteLength), free);
+    dst = (uint8_t *) copy.get();
+  } else {
+    dst += JSObjectGetTypedArrayByteOffset(jsCtx, jsDst, nullptr);
+  }
+  bool mapped = false;
+  addBlockingToNextBatch([&] {
+    void *data = glMapBufferRange(target, srcByteOffset, byteLength, GL_MAP_READ_BIT);
+    if (data) {
+      memcpy(dst + dstOffset * elementSize, data, byteLength);
+      glUnmapBuffer(target);
+      mapped = true;
+    }
+  });
+  if (!mapped) {
+    throw std::runtime_error("EXGL: gl.getBufferSubData() couldn't map the buffer range!");
+  }
+  if (copy) {
+    JSObjectSetTypedArrayData(jsCtx, jsDst, copy.get(), dstByteLength);
+  }
+  return nullptr;
+}
 
 
 // Framebuffers
@@ -386,11 +556,14 @@ _WRAP_METHOD_UNIMPL(getBufferSubData)
 
 _WRAP_METHOD(bindFramebuffer, 2) {
   EXJS_UNPACK_ARGV(GLenum target);
+  framebufferBound(target);
   if (JSValueIsNull(jsCtx, jsArgv[1])) {
+    residency.bindFramebuffer(target, 0);
     addToNextBatch([=] { glBindFramebuffer(target, defaultFramebuffer); });
   } else {
     UEXGLObjectId fFramebuffer = EXJSValueToNumberFast(jsCtx, jsArgv[1]);
-    addToNextBatch([=] { glBindFramebuffer(target, lookupObject(fFramebuffer)); });
+    residency.bindFramebuffer(target, fFramebuffer);
+    addBindToNextBatch(glBindFramebuffer, target, fFramebuffer);
   }
   return nullptr;
 }
@@ -412,6 +585,7 @@ _WRAP_METHOD(createFramebuffer, 0) {
 
 _WRAP_METHOD(deleteFramebuffer, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fFramebuffer);
+  residency.forget(fFramebuffer);
   addToNextBatch([=] {
     GLuint framebuffer = lookupObject(fFramebuffer);
     glDeleteFramebuffers(1, &framebuffer);
@@ -425,6 +599,8 @@ _WRAP_METHOD(framebufferRenderbuffer, 4) {
     GLuint renderbuffer = lookupObject(fRenderbuffer);
     glFramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
   });
+  traceLastClosure(EXGLTraceEvent::FramebufferRenderbuffer,
+                   { (double) target, (double) attachment, (double) renderbuffertarget, (double) fRenderbuffer });
   return nullptr;
 }
 
@@ -433,6 +609,8 @@ _WRAP_METHOD(framebufferTexture2D, 5) {
   addToNextBatch([=] {
     glFramebufferTexture2D(target, attachment, textarget, lookupObject(fTexture), level);
   });
+  traceLastClosure(EXGLTraceEvent::FramebufferTexture2D,
+                   { (double) target, (double) attachment, (double) textarget, (double) fTexture, (double) level });
   return nullptr;
 }
 
@@ -442,6 +620,36 @@ _WRAP_METHOD_IS_OBJECT(Framebuffer)
 
 _WRAP_METHOD(readPixels, 7) {
   EXJS_UNPACK_ARGV(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type);
+  if (format == GL_RGB && type == GL_UNSIGNED_BYTE) {
+    // Not a readable format on every GLES implementation, read RGBA and drop
+    // the alpha. Rows follow the default PACK_ALIGNMENT of 4.
+    size_t rgbBytesPerRow = ((size_t) width * 3 + 3) & ~(size_t) 3;
+    size_t byteLength = rgbBytesPerRow * height;
+    auto pixels = std::shared_ptr<void>(malloc((size_t) width * height * 4), free);
+    auto packed = (GLubyte *) JSObjectGetTypedArrayBytesPtr(jsCtx, (JSObjectRef) jsArgv[6], nullptr);
+    std::shared_ptr<void> packedCopy;
+    if (packed && JSObjectGetTypedArrayByteLength(jsCtx, (JSObjectRef) jsArgv[6], nullptr) < byteLength) {
+      throw std::runtime_error("EXGL: gl.readPixels() buffer is too small!");
+    }
+    if (packed && !usingTypedArrayHack) {
+      packed += JSObjectGetTypedArrayByteOffset(jsCtx, (JSObjectRef) jsArgv[6], nullptr);
+    }
+    if (usingTypedArrayHack || !packed) {
+      packedCopy = std::shared_ptr<void>(malloc(byteLength), free);
+      packed = (GLubyte *) packedCopy.get();
+    }
+    addBlockingToNextBatch([&] {
+      glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.get());
+      for (GLsizei row = 0; row < height; ++row) {
+        EXGLPackRGBAToRGB((const uint8_t *) pixels.get() + (size_t) row * width * 4,
+                          packed + row * rgbBytesPerRow, width);
+      }
+    });
+    if (packedCopy) {
+      JSObjectSetTypedArrayData(jsCtx, (JSObjectRef) jsArgv[6], packedCopy.get(), byteLength);
+    }
+    return nullptr;
+  }
   if (usingTypedArrayHack) {
     size_t byteLength = width * height * bytesPerPixel(type, format);
     auto pixels = std::shared_ptr<void>(malloc(byteLength), free);
@@ -450,7 +658,10 @@ _WRAP_METHOD(readPixels, 7) {
     });
     JSObjectSetTypedArrayData(jsCtx, (JSObjectRef) jsArgv[6], pixels.get(), byteLength);
   } else {
-    void *pixels = JSObjectGetTypedArrayBytesPtr(jsCtx, (JSObjectRef) jsArgv[6], nullptr);
+    auto pixels = (uint8_t *) JSObjectGetTypedArrayBytesPtr(jsCtx, (JSObjectRef) jsArgv[6], nullptr);
+    if (pixels) {
+      pixels += JSObjectGetTypedArrayByteOffset(jsCtx, (JSObjectRef) jsArgv[6], nullptr);
+    }
     addBlockingToNextBatch([&] {
       glReadPixels(x, y, width, height, format, type, pixels);
     });
@@ -504,10 +715,8 @@ _WRAP_WEBGL2_METHOD_SIMPLE(readBuffer, glReadBuffer, mode)
 
 _WRAP_METHOD(bindRenderbuffer, 2) {
   EXJS_UNPACK_ARGV(GLenum target, UEXGLObjectId fRenderbuffer);
-  addToNextBatch([=] {
-    GLuint renderbuffer = lookupObject(fRenderbuffer);
-    glBindRenderbuffer(target, renderbuffer);
-  });
+  residency.bindRenderbuffer(fRenderbuffer);
+  addBindToNextBatch(glBindRenderbuffer, target, fRenderbuffer);
   return nullptr;
 }
 
@@ -521,6 +730,7 @@ _WRAP_METHOD(createRenderbuffer, 0) {
 
 _WRAP_METHOD(deleteRenderbuffer, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fRenderbuffer);
+  residency.forget(fRenderbuffer);
   addToNextBatch([=] {
     GLuint renderbuffer = lookupObject(fRenderbuffer);
     glDeleteRenderbuffers(1, &renderbuffer);
@@ -539,6 +749,7 @@ _WRAP_METHOD(renderbufferStorage, 4) {
   // however OpenGL ES seems to require sized format, so we fall back to `GL_DEPTH24_STENCIL8`.
   internalformat = internalformat == GL_DEPTH_STENCIL ? GL_DEPTH24_STENCIL8 : internalformat;
 
+  residency.renderbufferStorage(imageBytes(internalformat, GL_NONE, GL_NONE, width, height));
   addToNextBatch([=] {
     glRenderbufferStorage(target, internalformat, width, height);
   });
@@ -551,7 +762,17 @@ _WRAP_METHOD(renderbufferStorage, 4) {
 
 _WRAP_METHOD_UNIMPL(getInternalformatParameter)
 
-_WRAP_METHOD_UNIMPL(renderbufferStorageMultisample)
+_WRAP_WEBGL2_METHOD(renderbufferStorageMultisample, 5) {
+  EXJS_UNPACK_ARGV(GLenum target, GLsizei samples, GLint internalformat, GLsizei width, GLsizei height);
+  internalformat = internalformat == GL_DEPTH_STENCIL ? GL_DEPTH24_STENCIL8 : internalformat;
+
+  // Each sample takes as much as a pixel of a single sampled renderbuffer
+  residency.renderbufferStorage(std::max(samples, 1) * imageBytes(internalformat, GL_NONE, GL_NONE, width, height));
+  addToNextBatch([=] {
+    glRenderbufferStorageMultisample(target, samples, internalformat, width, height);
+  });
+  return nullptr;
+}
 
 
 // Textures
@@ -560,21 +781,78 @@ _WRAP_METHOD_UNIMPL(renderbufferStorageMultisample)
 _WRAP_METHOD(bindTexture, 2) {
   EXJS_UNPACK_ARGV(GLenum target);
   if (JSValueIsNull(jsCtx, jsArgv[1])) {
-    addToNextBatch(std::bind(glBindTexture, target, 0));
+    residency.bindTexture(target, 0);
+    if (shadowState.updateTexture(target, 0)) {
+      addCallToNextBatch(glBindTexture, target, 0);
+    }
   } else {
     UEXGLObjectId fTexture = EXJSValueToNumberFast(jsCtx, jsArgv[1]);
-    addToNextBatch([=] { glBindTexture(target, lookupObject(fTexture)); });
+    residency.bindTexture(target, fTexture);
+    if (shadowState.updateTexture(target, fTexture)) {
+      addBindToNextBatch(glBindTexture, target, fTexture);
+    }
   }
   return nullptr;
 }
 
-_WRAP_METHOD_UNIMPL(compressedTexImage2D)
+_WRAP_METHOD(compressedTexImage2D, 7) {
+  EXJS_UNPACK_ARGV(GLenum target, GLint level, GLenum internalformat,
+                   GLsizei width, GLsizei height, GLint border);
+  if (JSValueIsNumber(jsCtx, jsArgv[6])) {
+    // WebGL2: (imageSize, offset) into the bound PIXEL_UNPACK_BUFFER
+    EXJS_UNPACK_ARGV_OFFSET(6, GLsizei imageSize, GLintptr offset);
+    residency.textureImage(target, level, imageSize);
+    addToNextBatch([=] {
+      glCompressedTexImage2D(target, level, internalformat, width, height, border,
+                             imageSize, (const void *) offset);
+    });
+    return nullptr;
+  }
+  size_t byteLength;
+  auto data = jsValueToSharedArray(jsCtx, jsArgv[6], &byteLength);
+  if (!data) {
+    throw std::runtime_error("EXGL: Invalid data argument for gl.compressedTexImage2D()!");
+  }
+  residency.textureImage(target, level, byteLength);
+  addToNextBatch([=] {
+    glCompressedTexImage2D(target, level, internalformat, width, height, border,
+                           (GLsizei) byteLength, data.get());
+  });
+  return nullptr;
+}
 
-_WRAP_METHOD_UNIMPL(compressedTexSubImage2D)
+_WRAP_METHOD(compressedTexSubImage2D, 8) {
+  EXJS_UNPACK_ARGV(GLenum target, GLint level, GLint xoffset, GLint yoffset,
+                   GLsizei width, GLsizei height, GLenum format);
+  if (JSValueIsNumber(jsCtx, jsArgv[7])) {
+    EXJS_UNPACK_ARGV_OFFSET(7, GLsizei imageSize, GLintptr offset);
+    addToNextBatch([=] {
+      glCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format,
+                                imageSize, (const void *) offset);
+    });
+    return nullptr;
+  }
+  size_t byteLength;
+  auto data = jsValueToSharedArray(jsCtx, jsArgv[7], &byteLength);
+  if (!data) {
+    throw std::runtime_error("EXGL: Invalid data argument for gl.compressedTexSubImage2D()!");
+  }
+  addToNextBatch([=] {
+    glCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format,
+                              (GLsizei) byteLength, data.get());
+  });
+  return nullptr;
+}
 
-_WRAP_METHOD_SIMPLE(copyTexImage2D, glCopyTexImage2D,
-                    target, level, internalformat,
-                    x, y, width, height, border)
+_WRAP_METHOD(copyTexImage2D, 8) {
+  EXJS_UNPACK_ARGV(GLenum target, GLint level, GLenum internalformat,
+                   GLint x, GLint y, GLsizei width, GLsizei height, GLint border);
+  // Unsized formats take the framebuffer's, assume 8 bits per component
+  residency.textureImage(target, level, imageBytes(internalformat, internalformat, GL_UNSIGNED_BYTE,
+                                                   width, height));
+  addCallToNextBatch(glCopyTexImage2D, target, level, internalformat, x, y, width, height, border);
+  return nullptr;
+}
 
 _WRAP_METHOD_SIMPLE(copyTexSubImage2D, glCopyTexSubImage2D,
                     target, level,
@@ -590,16 +868,46 @@ _WRAP_METHOD(createTexture, 0) {
 
 _WRAP_METHOD(deleteTexture, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fTexture);
+  shadowState.forgetObject(fTexture);
+  residency.forget(fTexture);
+  forgetTextureStorage(fTexture);
   addToNextBatch([=] {
-    GLuint texture = lookupObject(fTexture);
-    glDeleteTextures(1, &texture);
+    if (!removeExternalTexture(fTexture)) {
+      GLuint texture = lookupObject(fTexture);
+      glDeleteTextures(1, &texture);
+    }
   });
   return nullptr;
 }
 
-_WRAP_METHOD_SIMPLE(generateMipmap, glGenerateMipmap, target)
+_WRAP_METHOD(generateMipmap, 1) {
+  EXJS_UNPACK_ARGV(GLenum target);
+  residency.textureMipmaps(target);
+  addCallToNextBatch(glGenerateMipmap, target);
+  return nullptr;
+}
 
-_WRAP_METHOD_UNIMPL(getTexParameter)
+_WRAP_METHOD(getTexParameter, 2) {
+  EXJS_UNPACK_ARGV(GLenum target, GLenum pname);
+  GLint glInt;
+  if (textureStorageParameter(target, pname, &glInt)) {
+    if (pname == GL_TEXTURE_IMMUTABLE_FORMAT) {
+      return JSValueMakeBoolean(jsCtx, glInt);
+    }
+    return JSValueMakeNumber(jsCtx, glInt);
+  }
+  switch (pname) {
+    case GL_TEXTURE_MIN_LOD:
+    case GL_TEXTURE_MAX_LOD: {
+      GLfloat glFloat;
+      addBlockingToNextBatch([&] { glGetTexParameterfv(target, pname, &glFloat); });
+      return JSValueMakeNumber(jsCtx, glFloat);
+    }
+    default:
+      addBlockingToNextBatch([&] { glGetTexParameteriv(target, pname, &glInt); });
+      return JSValueMakeNumber(jsCtx, glInt);
+  }
+}
 
 _WRAP_METHOD_IS_OBJECT(Texture)
 
@@ -624,30 +932,62 @@ _WRAP_METHOD(texImage2D, 6) {
 
   // Null?
   if (JSValueIsNull(jsCtx, jsPixels)) {
+    residency.textureImage(target, level, imageBytes(internalformat, format, type, width, height));
     addToNextBatch([=] {
       glTexImage2D(target, level, internalformat, width, height, border, format, type, nullptr);
     });
+    traceLastClosure(EXGLTraceEvent::TexImage2D, { (double) target, (double) level, (double) internalformat,
+                     (double) width, (double) height, (double) border, (double) format, (double) type });
     return nullptr;
   }
 
   std::shared_ptr<void> data(nullptr);
+  size_t length = 0;
 
   // Try TypedArray
   if (jsArgc == 9) {
-    data = jsValueToSharedArray(jsCtx, jsPixels, nullptr);
+    data = jsValueToSharedArray(jsCtx, jsPixels, &length);
   }
 
-  // Try object with `.localUri` member
-  if (!data) {
-    data = loadImage(jsCtx, jsPixels, &width, &height, nullptr);
+  if (data) {
+    // Converted on the GL thread, the data is a copy
+    bool flipY = unpackFLipY, premultiplyAlpha = unpackPremultiplyAlpha;
+    residency.textureImage(target, level, imageBytes(internalformat, format, type, width, height));
+    addToNextBatch([=] {
+      unpackPixels(data.get(), width, height, 1, format, type, flipY, premultiplyAlpha);
+      glTexImage2D(target, level, internalformat, width, height, border, format, type, data.get());
+    });
+    traceLastClosure(EXGLTraceEvent::TexImage2D, { (double) target, (double) level, (double) internalformat,
+                     (double) width, (double) height, (double) border, (double) format, (double) type },
+                     data.get(), length);
+    return nullptr;
   }
 
-  if (data) {
-    if (unpackFLipY) {
-      flipPixels((GLubyte *) data.get(), width * bytesPerPixel(type, format), height);
+  // Try object with `.localUri` member of pre-baked pixels, used from a mapping
+  std::string localPath;
+  if (localPathFromImage(jsCtx, jsPixels, localPath)) {
+    GLsizei fileWidth, fileHeight;
+    imageSizeFromObject(jsCtx, jsPixels, &fileWidth, &fileHeight);
+    if (addMappedImageToNextBatch(localPath, fileWidth, fileHeight, target, level, internalformat,
+                                  format, type, false, 0, 0)) {
+      return nullptr;
     }
+  }
+
+  // Try object with `.localUri` member, decoded off the JS thread
+  auto image = loadImageAsync(jsCtx, jsPixels);
+  if (image.valid()) {
+    UEXGLObjectId fTexture = residency.boundTexture(target);
     addToNextBatch([=] {
-      glTexImage2D(target, level, internalformat, width, height, border, format, type, data.get());
+      const EXGLImage &decoded = image.get();
+      if (!decoded.data) {
+        EXGLSysLog("EXGL: Couldn't decode image for gl.texImage2D()!");
+        return;
+      }
+      glTexImage2D(target, level, internalformat, decoded.width, decoded.height, border,
+                   format, type, decoded.data.get());
+      reportTextureImage(fTexture, target, level,
+                         imageBytes(internalformat, format, type, decoded.width, decoded.height));
     });
     return nullptr;
   }
@@ -686,23 +1026,54 @@ _WRAP_METHOD(texSubImage2D, 7) {
   }
 
   std::shared_ptr<void> data(nullptr);
+  size_t length = 0;
 
   // Try TypedArray
   if (jsArgc == 9) {
-    data = jsValueToSharedArray(jsCtx, jsPixels, nullptr);
+    data = jsValueToSharedArray(jsCtx, jsPixels, &length);
   }
 
-  // Try object with `.localUri` member
-  if (!data) {
-    data = loadImage(jsCtx, jsPixels, &width, &height, nullptr);
+  if (data) {
+    if (uploadsUnpacked(target)) {
+      addToNextBatch([=] {
+        glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, data.get());
+      });
+    } else {
+      // Converted on the GL thread, the data is a copy
+      bool flipY = unpackFLipY, premultiplyAlpha = unpackPremultiplyAlpha;
+      addToNextBatch([=] {
+        unpackPixels(data.get(), width, height, 1, format, type, flipY, premultiplyAlpha);
+        glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, data.get());
+      });
+    }
+    traceLastClosure(EXGLTraceEvent::TexSubImage2D, { (double) target, (double) level, (double) xoffset,
+                     (double) yoffset, (double) width, (double) height, (double) format, (double) type },
+                     data.get(), length);
+    return nullptr;
   }
 
-  if (data) {
-    if (unpackFLipY) {
-      flipPixels((GLubyte *) data.get(), width * bytesPerPixel(type, format), height);
+  // Try object with `.localUri` member of pre-baked pixels, used from a mapping
+  std::string localPath;
+  if (localPathFromImage(jsCtx, jsPixels, localPath)) {
+    GLsizei fileWidth, fileHeight;
+    imageSizeFromObject(jsCtx, jsPixels, &fileWidth, &fileHeight);
+    if (addMappedImageToNextBatch(localPath, fileWidth, fileHeight, target, level, 0,
+                                  format, type, true, xoffset, yoffset)) {
+      return nullptr;
     }
+  }
+
+  // Try object with `.localUri` member, decoded off the JS thread
+  auto image = loadImageAsync(jsCtx, jsPixels);
+  if (image.valid()) {
     addToNextBatch([=] {
-      glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, data.get());
+      const EXGLImage &decoded = image.get();
+      if (!decoded.data) {
+        EXGLSysLog("EXGL: Couldn't decode image for gl.texSubImage2D()!");
+        return;
+      }
+      glTexSubImage2D(target, level, xoffset, yoffset, decoded.width, decoded.height,
+                      format, type, decoded.data.get());
     });
     return nullptr;
   }
@@ -719,9 +1090,18 @@ _WRAP_METHOD_SIMPLE(texParameteri, glTexParameteri, target, pname, param)
 // Textures (WebGL2)
 // -----------------
 
-_WRAP_METHOD_SIMPLE(texStorage2D, glTexStorage2D, target, levels, internalformat, width, height)
+_WRAP_METHOD(texStorage2D, 5) {
+  EXJS_UNPACK_ARGV(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height);
+  addTexStorageToNextBatch(false, target, levels, internalformat, width, height, 1);
+  return nullptr;
+}
 
-_WRAP_METHOD_SIMPLE(texStorage3D, glTexStorage3D, target, levels, internalformat, width, height, depth)
+_WRAP_METHOD(texStorage3D, 6) {
+  EXJS_UNPACK_ARGV(GLenum target, GLsizei levels, GLenum internalformat,
+                   GLsizei width, GLsizei height, GLsizei depth);
+  addTexStorageToNextBatch(true, target, levels, internalformat, width, height, depth);
+  return nullptr;
+}
 
 _WRAP_WEBGL2_METHOD(texImage3D, 10) {
   GLenum target;
@@ -735,6 +1115,7 @@ _WRAP_WEBGL2_METHOD(texImage3D, 10) {
 
   // Null?
   if (JSValueIsNull(jsCtx, jsPixels)) {
+    residency.textureImage(target, level, imageBytes(internalformat, format, type, width, height, depth));
     addToNextBatch([=] {
       glTexImage3D(target, level, internalformat, width, height, depth, border, format, type, nullptr);
     });
@@ -743,8 +1124,14 @@ _WRAP_WEBGL2_METHOD(texImage3D, 10) {
 
   std::shared_ptr<void> data(nullptr);
 
-  // Try TypedArray
-  data = jsValueToSharedArray(jsCtx, jsPixels, nullptr);
+  // Try TypedArray, only the part read from `srcOffset` on if it's given
+  if (jsArgc > 10) {
+    size_t srcOffset = EXJSValueToNumberFast(jsCtx, jsArgv[10]);
+    data = jsValueToSharedSubarray(jsCtx, jsPixels, srcOffset,
+                                   unpackedImageBytes(width, height, depth, format, type), "texImage3D");
+  } else {
+    data = jsValueToSharedArray(jsCtx, jsPixels, nullptr);
+  }
 
   // Try object with `.localUri` member
   if (!data) {
@@ -752,14 +1139,8 @@ _WRAP_WEBGL2_METHOD(texImage3D, 10) {
   }
 
   if (data) {
-    if (unpackFLipY) {
-      GLubyte *texels = (GLubyte *) data.get();
-      GLubyte *texelLayer = texels;
-      for (int z = 0; z < depth; z++) {
-        flipPixels(texelLayer, width * bytesPerPixel(type, format), height);
-        texelLayer += bytesPerPixel(type, format) * width * height;
-      }
-    }
+    unpackPixels(data.get(), width, height, depth, format, type, unpackFLipY, unpackPremultiplyAlpha);
+    residency.textureImage(target, level, imageBytes(internalformat, format, type, width, height, depth));
     addToNextBatch([=] {
       glTexImage3D(target, level, internalformat, width, height, depth, border, format, type, data.get());
     });
@@ -792,8 +1173,14 @@ _WRAP_WEBGL2_METHOD(texSubImage3D, 11) {
 
   std::shared_ptr<void> data(nullptr);
 
-  // Try TypedArray
-  data = jsValueToSharedArray(jsCtx, jsPixels, nullptr);
+  // Try TypedArray, only the part read from `srcOffset` on if it's given
+  if (jsArgc > 11) {
+    size_t srcOffset = EXJSValueToNumberFast(jsCtx, jsArgv[11]);
+    data = jsValueToSharedSubarray(jsCtx, jsPixels, srcOffset,
+                                   unpackedImageBytes(width, height, depth, format, type), "texSubImage3D");
+  } else {
+    data = jsValueToSharedArray(jsCtx, jsPixels, nullptr);
+  }
 
   // Try object with `.localUri` member
   if (!data) {
@@ -801,13 +1188,8 @@ _WRAP_WEBGL2_METHOD(texSubImage3D, 11) {
   }
 
   if (data) {
-    if (unpackFLipY) {
-      GLubyte *texels = (GLubyte *) data.get();
-      GLubyte *texelLayer = texels;
-      for (int z = 0; z < depth; z++) {
-        flipPixels(texelLayer, width * bytesPerPixel(type, format), height);
-        texelLayer += bytesPerPixel(type, format) * width * height;
-      }
+    if (!uploadsUnpacked(target)) {
+      unpackPixels(data.get(), width, height, depth, format, type, unpackFLipY, unpackPremultiplyAlpha);
     }
     addToNextBatch([=] {
       glTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, data.get());
@@ -822,9 +1204,53 @@ _WRAP_WEBGL2_METHOD(texSubImage3D, 11) {
 _WRAP_WEBGL2_METHOD_SIMPLE(copyTexSubImage3D, glCopyTexSubImage3D,
   target, level, xoffset, yoffset, zoffset, x, y, width, height)
 
-_WRAP_METHOD_UNIMPL(compressedTexImage3D)
+_WRAP_WEBGL2_METHOD(compressedTexImage3D, 8) {
+  EXJS_UNPACK_ARGV(GLenum target, GLint level, GLenum internalformat,
+                   GLsizei width, GLsizei height, GLsizei depth, GLint border);
+  if (JSValueIsNumber(jsCtx, jsArgv[7])) {
+    EXJS_UNPACK_ARGV_OFFSET(7, GLsizei imageSize, GLintptr offset);
+    residency.textureImage(target, level, imageSize);
+    addToNextBatch([=] {
+      glCompressedTexImage3D(target, level, internalformat, width, height, depth, border,
+                             imageSize, (const void *) offset);
+    });
+    return nullptr;
+  }
+  size_t byteLength;
+  auto data = jsValueToSharedArray(jsCtx, jsArgv[7], &byteLength);
+  if (!data) {
+    throw std::runtime_error("EXGL: Invalid data argument for gl.compressedTexImage3D()!");
+  }
+  residency.textureImage(target, level, byteLength);
+  addToNextBatch([=] {
+    glCompressedTexImage3D(target, level, internalformat, width, height, depth, border,
+                           (GLsizei) byteLength, data.get());
+  });
+  return nullptr;
+}
 
-_WRAP_METHOD_UNIMPL(compressedTexSubImage3D)
+_WRAP_WEBGL2_METHOD(compressedTexSubImage3D, 10) {
+  EXJS_UNPACK_ARGV(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset,
+                   GLsizei width, GLsizei height, GLsizei depth, GLenum format);
+  if (JSValueIsNumber(jsCtx, jsArgv[9])) {
+    EXJS_UNPACK_ARGV_OFFSET(9, GLsizei imageSize, GLintptr offset);
+    addToNextBatch([=] {
+      glCompressedTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth,
+                                format, imageSize, (const void *) offset);
+    });
+    return nullptr;
+  }
+  size_t byteLength;
+  auto data = jsValueToSharedArray(jsCtx, jsArgv[9], &byteLength);
+  if (!data) {
+    throw std::runtime_error("EXGL: Invalid data argument for gl.compressedTexSubImage3D()!");
+  }
+  addToNextBatch([=] {
+    glCompressedTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth,
+                              format, (GLsizei) byteLength, data.get());
+  });
+  return nullptr;
+}
 
 
 // Programs and shaders
@@ -832,31 +1258,41 @@ _WRAP_METHOD_UNIMPL(compressedTexSubImage3D)
 
 _WRAP_METHOD(attachShader, 2) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fProgram, UEXGLObjectId fShader);
+  noteAttachShader(fProgram, fShader);
   addToNextBatch([=] { glAttachShader(lookupObject(fProgram), lookupObject(fShader)); });
+  traceLastClosure(EXGLTraceEvent::AttachShader, { (double) fProgram, (double) fShader });
   return nullptr;
 }
 
 _WRAP_METHOD(bindAttribLocation, 3) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fProgram, GLuint index);
   auto name = jsValueToSharedStr(jsCtx, jsArgv[2]);
+  noteProgramBinding(fProgram, &index, sizeof(index));
+  noteProgramBinding(fProgram, name.get(), strlen(name.get()) + 1);
   addToNextBatch([=] { glBindAttribLocation(lookupObject(fProgram), index, name.get()); });
+  traceLastClosure(EXGLTraceEvent::BindAttribLocation, { (double) fProgram, (double) index },
+                   name.get(), strlen(name.get()));
   return nullptr;
 }
 
 _WRAP_METHOD(compileShader, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fShader);
-  addToNextBatch([=] { glCompileShader(lookupObject(fShader)); });
+  addCompileShaderToNextBatch(fShader);
   return nullptr;
 }
 
 _WRAP_METHOD(createProgram, 0) {
-  return addFutureToNextBatch(jsCtx, &glCreateProgram);
+  auto fProgram = addFutureToNextBatch(&glCreateProgram);
+  traceLastClosure(EXGLTraceEvent::CreateProgram, { (double) fProgram });
+  return JSValueMakeNumber(jsCtx, fProgram);
 }
 
 _WRAP_METHOD(createShader, 1) {
   EXJS_UNPACK_ARGV(GLenum type);
   if (type == GL_VERTEX_SHADER || type == GL_FRAGMENT_SHADER) {
-    return addFutureToNextBatch(jsCtx, std::bind(glCreateShader, type));
+    auto fShader = addFutureToNextBatch(std::bind(glCreateShader, type));
+    traceLastClosure(EXGLTraceEvent::CreateShader, { (double) fShader, (double) type });
+    return JSValueMakeNumber(jsCtx, fShader);
   } else {
     return JSValueMakeNull(jsCtx);
   }
@@ -864,18 +1300,24 @@ _WRAP_METHOD(createShader, 1) {
 
 _WRAP_METHOD(deleteProgram, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fProgram);
-  addToNextBatch([=] { glDeleteProgram(lookupObject(fProgram)); });
+  programInfos.erase(fProgram);
+  forgetProgramSources(fProgram);
+  addUseToNextBatch(glDeleteProgram, fProgram);
   return nullptr;
 }
 
 _WRAP_METHOD(deleteShader, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fShader);
-  addToNextBatch([=] { glDeleteShader(lookupObject(fShader)); });
+  shaderCompileStatus.erase(fShader);
+  shaderSourceHashes.erase(fShader);
+  shaderCompiles.erase(fShader);
+  addUseToNextBatch(glDeleteShader, fShader);
   return nullptr;
 }
 
 _WRAP_METHOD(detachShader, 2) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fProgram, UEXGLObjectId fShader);
+  noteDetachShader(fProgram, fShader);
   addToNextBatch([=] { glDetachShader(lookupObject(fProgram), lookupObject(fShader)); });
   return nullptr;
 }
@@ -894,12 +1336,7 @@ _WRAP_METHOD(getAttachedShaders, 1) {
 
   JSValueRef jsResults[count];
   for (auto i = 0; i < count; ++i) {
-    UEXGLObjectId exglObjId = 0;
-    for (const auto &pair : objects) {
-      if (pair.second == glResults[i]) {
-        exglObjId = pair.first;
-      }
-    }
+    UEXGLObjectId exglObjId = findObject(glResults[i]);
     if (exglObjId == 0) {
       throw new std::runtime_error("EXGL: Internal error: couldn't find UEXGLObjectId "
                                    "associated with shader in getAttachedShaders()!");
@@ -911,6 +1348,22 @@ _WRAP_METHOD(getAttachedShaders, 1) {
 
 _WRAP_METHOD(getProgramParameter, 2) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fProgram, GLenum pname);
+  if (pname == GL_COMPLETION_STATUS_KHR) {
+    return JSValueMakeBoolean(jsCtx, programCompletionStatus(fProgram));
+  }
+  if (pname == GL_LINK_STATUS || pname == GL_ACTIVE_UNIFORMS || pname == GL_ACTIVE_ATTRIBUTES) {
+    // Fixed at link time
+    if (auto info = programInfo(fProgram)) {
+      switch (pname) {
+        case GL_LINK_STATUS:
+          return JSValueMakeBoolean(jsCtx, info->linkStatus);
+        case GL_ACTIVE_UNIFORMS:
+          return JSValueMakeNumber(jsCtx, info->uniforms.size());
+        default:
+          return JSValueMakeNumber(jsCtx, info->attributes.size());
+      }
+    }
+  }
   GLint glResult;
   addBlockingToNextBatch([&] { glGetProgramiv(lookupObject(fProgram), pname, &glResult); });
   if (pname == GL_DELETE_STATUS || pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) {
@@ -922,8 +1375,20 @@ _WRAP_METHOD(getProgramParameter, 2) {
 
 _WRAP_METHOD(getShaderParameter, 2) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fShader, GLenum pname);
+  if (pname == GL_COMPLETION_STATUS_KHR) {
+    return JSValueMakeBoolean(jsCtx, shaderCompletionStatus(fShader));
+  }
+  if (pname == GL_COMPILE_STATUS) {
+    auto iter = shaderCompileStatus.find(fShader);
+    if (iter != shaderCompileStatus.end()) {
+      return JSValueMakeBoolean(jsCtx, iter->second);
+    }
+  }
   GLint glResult;
   addBlockingToNextBatch([&] { glGetShaderiv(lookupObject(fShader), pname, &glResult); });
+  if (pname == GL_COMPILE_STATUS) {
+    shaderCompileStatus[fShader] = glResult;
+  }
   if (pname == GL_DELETE_STATUS || pname == GL_COMPILE_STATUS) {
     return JSValueMakeBoolean(jsCtx, glResult);
   } else {
@@ -973,33 +1438,40 @@ _WRAP_METHOD_IS_OBJECT(Shader)
 
 _WRAP_METHOD(linkProgram, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fProgram);
-  addToNextBatch([=] { glLinkProgram(lookupObject(fProgram)); });
+  addLinkProgramToNextBatch(fProgram);
   return nullptr;
 }
 
 _WRAP_METHOD(shaderSource, 2) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fShader);
   auto str = jsValueToSharedStr(jsCtx, jsArgv[1]);
+  noteShaderSource(fShader, str.get(), strlen(str.get()));
   addToNextBatch([=] {
     char *pstr = str.get();
     glShaderSource(lookupObject(fShader), 1, (const char **) &pstr, nullptr);
   });
+  traceLastClosure(EXGLTraceEvent::ShaderSource, { (double) fShader }, str.get(), strlen(str.get()));
   return nullptr;
 }
 
 _WRAP_METHOD(useProgram, 1) {
+  const double args[] = { EXJSValueToNumberFast(jsCtx, jsArgv[0]) };
+  residency.useProgram((UEXGLObjectId) args[0]);
+  if (!shadowState.update(EXGLShadowState::Program, args, 1)) {
+    return nullptr;
+  }
   if (JSValueIsNull(jsCtx, jsArgv[0])) {
-    addToNextBatch(std::bind(glUseProgram, 0));
+    addCallToNextBatch(glUseProgram, 0);
   } else {
     EXJS_UNPACK_ARGV(UEXGLObjectId fProgram);
-    addToNextBatch([=] { glUseProgram(lookupObject(fProgram)); });
+    addUseToNextBatch(glUseProgram, fProgram);
   }
   return nullptr;
 }
 
 _WRAP_METHOD(validateProgram, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fProgram);
-  addToNextBatch([=] { glValidateProgram(lookupObject(fProgram)); });
+  addUseToNextBatch(glValidateProgram, fProgram);
   return nullptr;
 }
 
@@ -1020,21 +1492,57 @@ _WRAP_METHOD(getFragDataLocation, 2) {
 // Uniforms and attributes
 // -----------------------
 
-_WRAP_METHOD_SIMPLE(disableVertexAttribArray, glDisableVertexAttribArray, index)
+_WRAP_METHOD(disableVertexAttribArray, 1) {
+  EXJS_UNPACK_ARGV(GLuint index);
+  if (vertexArrays.enable(index, false)) {
+    addCallToNextBatch(glDisableVertexAttribArray, index);
+  }
+  return nullptr;
+}
 
-_WRAP_METHOD_SIMPLE(enableVertexAttribArray, glEnableVertexAttribArray, index)
+_WRAP_METHOD(enableVertexAttribArray, 1) {
+  EXJS_UNPACK_ARGV(GLuint index);
+  if (vertexArrays.enable(index, true)) {
+    addCallToNextBatch(glEnableVertexAttribArray, index);
+  }
+  return nullptr;
+}
 
 _WRAP_METHOD(getActiveAttrib, 2) {
+  if (!JSValueIsNull(jsCtx, jsArgv[0])) {
+    EXJS_UNPACK_ARGV(UEXGLObjectId fProgram, GLuint index);
+    if (auto info = programInfo(fProgram)) {
+      if (index >= info->attributes.size()) {
+        return JSValueMakeNull(jsCtx);
+      }
+      const auto &active = info->attributes[index];
+      return makeActiveInfo(jsCtx, active.name.c_str(), active.size, active.type);
+    }
+  }
   return getActiveInfo(jsCtx, jsArgv, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, glGetActiveAttrib);
 }
 
 _WRAP_METHOD(getActiveUniform, 2) {
+  if (!JSValueIsNull(jsCtx, jsArgv[0])) {
+    EXJS_UNPACK_ARGV(UEXGLObjectId fProgram, GLuint index);
+    if (auto info = programInfo(fProgram)) {
+      if (index >= info->uniforms.size()) {
+        return JSValueMakeNull(jsCtx);
+      }
+      const auto &active = info->uniforms[index];
+      return makeActiveInfo(jsCtx, active.name.c_str(), active.size, active.type);
+    }
+  }
   return getActiveInfo(jsCtx, jsArgv, GL_ACTIVE_UNIFORM_MAX_LENGTH, glGetActiveUniform);
 }
 
 _WRAP_METHOD(getAttribLocation, 2) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fProgram);
   auto name = jsValueToSharedStr(jsCtx, jsArgv[1]);
+  if (auto info = programInfo(fProgram)) {
+    auto iter = info->attribLocations.find(name.get());
+    return JSValueMakeNumber(jsCtx, iter == info->attribLocations.end() ? -1 : iter->second);
+  }
   GLint location;
   addBlockingToNextBatch([&] {
     location = glGetAttribLocation(lookupObject(fProgram), name.get());
@@ -1047,6 +1555,10 @@ _WRAP_METHOD_UNIMPL(getUniform)
 _WRAP_METHOD(getUniformLocation, 2) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fProgram);
   auto name = jsValueToSharedStr(jsCtx, jsArgv[1]);
+  if (auto info = programInfo(fProgram)) {
+    auto iter = info->uniformLocations.find(name.get());
+    return iter == info->uniformLocations.end() ? JSValueMakeNull(jsCtx) : JSValueMakeNumber(jsCtx, iter->second);
+  }
   GLint location;
   addBlockingToNextBatch([&] {
     location = glGetUniformLocation(lookupObject(fProgram), name.get());
@@ -1070,11 +1582,10 @@ _WRAP_METHOD_SIMPLE(uniform4i, glUniform4i, uniform, x, y, z, w)
 #define _WRAP_METHOD_UNIFORM_V(suffix, dim, Type)                     \
 _WRAP_METHOD(uniform##suffix, 2) {                                  \
   GLuint uniform = EXJSValueToNumberFast(jsCtx, jsArgv[0]);         \
-  size_t bytes;                                                     \
-  auto data = jsValueToSharedArray(jsCtx, jsArgv[1], &bytes);       \
-  GLsizei count = (GLsizei) bytes / sizeof(Type);                   \
-  addToNextBatch([=] {                                              \
-    glUniform##suffix(uniform, count / dim, (Type *) data.get());   \
+  withTypedArrayData(jsCtx, jsArgv[1], [&](void *data, size_t bytes) { \
+    GLsizei count = (GLsizei) bytes / sizeof(Type);                 \
+    nextBatch.pushUniformv<Type>(glUniform##suffix, uniform,        \
+                                 count / dim, data, bytes);         \
   });                                                               \
   return nullptr;                                                   \
 }
@@ -1091,11 +1602,10 @@ _WRAP_METHOD_UNIFORM_V(4iv, 4, GLint)
 _WRAP_METHOD(uniformMatrix##suffix, 3) {                              \
   GLuint uniform = EXJSValueToNumberFast(jsCtx, jsArgv[0]);           \
   GLboolean transpose = JSValueToBoolean(jsCtx, jsArgv[1]);           \
-  size_t bytes;                                                       \
-  auto data = jsValueToSharedArray(jsCtx, jsArgv[2], &bytes);         \
-  GLsizei count = (GLsizei) bytes / sizeof(GLfloat);                  \
-  addToNextBatch([=] {                                                \
-    glUniformMatrix##suffix(uniform, count / dim, transpose, (GLfloat *) data.get()); \
+  withTypedArrayData(jsCtx, jsArgv[2], [&](void *data, size_t bytes) { \
+    GLsizei count = (GLsizei) bytes / sizeof(GLfloat);                \
+    nextBatch.pushUniformMatrixv(glUniformMatrix##suffix, uniform,    \
+                                 count / dim, transpose, data, bytes); \
   });                                                                 \
   return nullptr;                                                     \
 }
@@ -1123,8 +1633,10 @@ _WRAP_METHOD_SIMPLE(vertexAttrib4f, glVertexAttrib4f, index, x, y, z, w)
 _WRAP_METHOD(vertexAttribPointer, 6) {
   EXJS_UNPACK_ARGV(GLuint index, GLuint itemSize, GLenum type,
                    GLboolean normalized, GLsizei stride, GLint offset);
-  addToNextBatch(std::bind(glVertexAttribPointer, index, itemSize, type,
-                           normalized, stride, bufferOffset(offset)));
+  if (vertexArrays.pointer(index, itemSize, type, normalized, false, stride, offset,
+                           residency.boundBuffer(GL_ARRAY_BUFFER))) {
+    addCallToNextBatch(glVertexAttribPointer, index, itemSize, type, normalized, stride, offset);
+  }
   return nullptr;
 }
 
@@ -1157,7 +1669,10 @@ _WRAP_METHOD_VERTEX_ATTRIB_V(I4uiv, GLuint)
 
 _WRAP_METHOD(vertexAttribIPointer, 5) {
   EXJS_UNPACK_ARGV(GLuint index, GLuint size, GLenum type, GLsizei stride, GLint offset);
-  addToNextBatch(std::bind(glVertexAttribIPointer, index, size, type, stride, bufferOffset(offset)));
+  if (vertexArrays.pointer(index, size, type, false, true, stride, offset,
+                           residency.boundBuffer(GL_ARRAY_BUFFER))) {
+    addCallToNextBatch(glVertexAttribIPointer, index, size, type, stride, offset);
+  }
   return nullptr;
 }
 
@@ -1169,23 +1684,27 @@ _WRAP_METHOD(vertexAttribIPointer, 5) {
 // Drawing buffers
 // ---------------
 
-_WRAP_METHOD_SIMPLE(clear, glClear, mask)
+_WRAP_METHOD(clear, 1) {
+  EXJS_UNPACK_ARGV(GLbitfield mask);
+  addClearToNextBatch(mask);
+  return nullptr;
+}
 
 _WRAP_METHOD_SIMPLE(drawArrays, glDrawArrays, mode, first, count)
 
 _WRAP_METHOD(drawElements, 4) {
   EXJS_UNPACK_ARGV(GLenum mode, GLsizei count, GLenum type, GLint offset);
-  addToNextBatch(std::bind(glDrawElements, mode, count, type, bufferOffset(offset)));
+  addCallToNextBatch(glDrawElements, mode, count, type, offset);
   return nullptr;
 }
 
 _WRAP_METHOD(finish, 0) {
-  addToNextBatch(glFinish);
+  addCallToNextBatch(glFinish);
   return nullptr;
 }
 
 _WRAP_METHOD(flush, 0) {
-  addToNextBatch(glFlush);
+  addCallToNextBatch(glFlush);
   return nullptr;
 }
 
@@ -1193,23 +1712,25 @@ _WRAP_METHOD(flush, 0) {
 // Drawing buffers (WebGL2)
 // ------------------------
 
-_WRAP_WEBGL2_METHOD_SIMPLE(vertexAttribDivisor, glVertexAttribDivisor, index, divisor)
+_WRAP_WEBGL2_METHOD(vertexAttribDivisor, 2) {
+  EXJS_UNPACK_ARGV(GLuint index, GLuint divisor);
+  if (vertexArrays.divisor(index, divisor)) {
+    addCallToNextBatch(glVertexAttribDivisor, index, divisor);
+  }
+  return nullptr;
+}
 
 _WRAP_WEBGL2_METHOD_SIMPLE(drawArraysInstanced, glDrawArraysInstanced, mode, first, count, instancecount)
 
 _WRAP_WEBGL2_METHOD(drawElementsInstanced, 5) {
   EXJS_UNPACK_ARGV(GLenum mode, GLsizei count, GLenum type, GLint offset, GLsizei instanceCount);
-  addToNextBatch([=] {
-    glDrawElementsInstanced(mode, count, type, bufferOffset(offset), instanceCount);
-  });
+  addCallToNextBatch(glDrawElementsInstanced, mode, count, type, offset, instanceCount);
   return nullptr;
 }
 
 _WRAP_WEBGL2_METHOD(drawRangeElements, 6) {
   EXJS_UNPACK_ARGV(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, GLint offset);
-  addToNextBatch([=] {
-    glDrawRangeElements(mode, start, end, count, type, bufferOffset(offset));
-  });
+  addCallToNextBatch(glDrawRangeElements, mode, start, end, count, type, offset);
   return nullptr;
 }
 
@@ -1296,6 +1817,7 @@ _WRAP_WEBGL2_METHOD(createSampler, 0) {
 
 _WRAP_WEBGL2_METHOD(deleteSampler, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fSampler);
+  residency.forget(fSampler);
   addToNextBatch([=] {
     GLuint sampler = lookupObject(fSampler);
     glDeleteSamplers(1, &sampler);
@@ -1305,7 +1827,8 @@ _WRAP_WEBGL2_METHOD(deleteSampler, 1) {
 
 _WRAP_WEBGL2_METHOD(bindSampler, 2) {
   EXJS_UNPACK_ARGV(GLuint unit, UEXGLObjectId sampler);
-  addToNextBatch([=] { glBindSampler(unit, lookupObject(sampler)); });
+  residency.bindSampler(unit, sampler);
+  addBindToNextBatch(glBindSampler, unit, sampler);
   return nullptr;
 }
 
@@ -1371,6 +1894,7 @@ _WRAP_WEBGL2_METHOD(createTransformFeedback, 0) {
 
 _WRAP_WEBGL2_METHOD(deleteTransformFeedback, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fTransformFeedback);
+  residency.forget(fTransformFeedback);
   addToNextBatch([=] {
     GLuint transformFeedback = lookupObject(fTransformFeedback);
     glDeleteTransformFeedbacks(1, &transformFeedback);
@@ -1382,14 +1906,15 @@ _WRAP_WEBGL2_METHOD_IS_OBJECT(TransformFeedback)
 
 _WRAP_WEBGL2_METHOD(bindTransformFeedback, 1) {
   EXJS_UNPACK_ARGV(GLenum target, UEXGLObjectId transformFeedback);
-  addToNextBatch([=] { glBindTransformFeedback(target, lookupObject(transformFeedback)); });
+  residency.bindTransformFeedback(transformFeedback);
+  addBindToNextBatch(glBindTransformFeedback, target, transformFeedback);
   return nullptr;
 }
 
 _WRAP_WEBGL2_METHOD_SIMPLE(beginTransformFeedback, glBeginTransformFeedback, primitiveMode)
 
 _WRAP_WEBGL2_METHOD(endTransformFeedback, 0) {
-  addToNextBatch([=] { glEndTransformFeedback(); });
+  addCallToNextBatch(glEndTransformFeedback);
   return nullptr;
 }
 
@@ -1398,6 +1923,10 @@ _WRAP_WEBGL2_METHOD(transformFeedbackVaryings, 3) {
   EXJS_UNPACK_ARGV_OFFSET(2, GLenum bufferMode);
   int length;
   auto varyings = jsValueToSharedStringArray(jsCtx, jsArgv[1], &length);
+  noteProgramBinding(program, &bufferMode, sizeof(bufferMode));
+  for (int i = 0; i < length; ++i) {
+    noteProgramBinding(program, varyings.get()[i], strlen(varyings.get()[i]) + 1);
+  }
 
   addToNextBatch([=] {
     glTransformFeedbackVaryings(lookupObject(program), length, (const GLchar *const *) varyings.get(), bufferMode);
@@ -1410,12 +1939,12 @@ _WRAP_WEBGL2_METHOD(getTransformFeedbackVarying, 2) {
 }
 
 _WRAP_WEBGL2_METHOD(pauseTransformFeedback, 0) {
-  addToNextBatch([=] { glPauseTransformFeedback(); });
+  addCallToNextBatch(glPauseTransformFeedback);
   return nullptr;
 }
 
 _WRAP_WEBGL2_METHOD(resumeTransformFeedback, 0) {
-  addToNextBatch([=] { glResumeTransformFeedback(); });
+  addCallToNextBatch(glResumeTransformFeedback);
   return nullptr;
 }
 
@@ -1425,12 +1954,15 @@ _WRAP_WEBGL2_METHOD(resumeTransformFeedback, 0) {
 
 _WRAP_WEBGL2_METHOD(bindBufferBase, 3) {
   EXJS_UNPACK_ARGV(GLenum target, GLuint index, UEXGLObjectId buffer);
+  // Also binds the buffer to `target`
+  residency.bindBuffer(target, buffer);
   addToNextBatch([=] { glBindBufferBase(target, index, lookupObject(buffer)); });
   return nullptr;
 }
 
 _WRAP_WEBGL2_METHOD(bindBufferRange, 5) {
   EXJS_UNPACK_ARGV(GLenum target, GLuint index, UEXGLObjectId buffer, GLint offset, GLsizei size);
+  residency.bindBuffer(target, buffer);
   addToNextBatch([=] { glBindBufferRange(target, index, lookupObject(buffer), offset, size); });
   return nullptr;
 }
@@ -1472,7 +2004,42 @@ _WRAP_WEBGL2_METHOD(getUniformBlockIndex, 2) {
   return JSValueMakeNumber(jsCtx, blockIndex);
 }
 
-_WRAP_METHOD_UNIMPL(getActiveUniformBlockParameter)
+_WRAP_WEBGL2_METHOD(getActiveUniformBlockParameter, 3) {
+  EXJS_UNPACK_ARGV(UEXGLObjectId fProgram, GLuint uniformBlockIndex, GLenum pname);
+  switch (pname) {
+    case GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES: {
+      std::vector<GLint> indices;
+      addBlockingToNextBatch([&] {
+        GLuint program = lookupObject(fProgram);
+        GLint count = 0;
+        glGetActiveUniformBlockiv(program, uniformBlockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &count);
+        indices.resize(count);
+        if (count > 0) {
+          glGetActiveUniformBlockiv(program, uniformBlockIndex, pname, indices.data());
+        }
+      });
+      return makeTypedArray(jsCtx, kJSTypedArrayTypeUint32Array,
+                            indices.data(), indices.size() * sizeof(GLint));
+    }
+    case GL_UNIFORM_BLOCK_BINDING:
+    case GL_UNIFORM_BLOCK_DATA_SIZE:
+    case GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS:
+    case GL_UNIFORM_BLOCK_REFERENCED_BY_VERTEX_SHADER:
+    case GL_UNIFORM_BLOCK_REFERENCED_BY_FRAGMENT_SHADER: {
+      GLint glResult = 0;
+      addBlockingToNextBatch([&] {
+        glGetActiveUniformBlockiv(lookupObject(fProgram), uniformBlockIndex, pname, &glResult);
+      });
+      if (pname == GL_UNIFORM_BLOCK_REFERENCED_BY_VERTEX_SHADER ||
+          pname == GL_UNIFORM_BLOCK_REFERENCED_BY_FRAGMENT_SHADER) {
+        return JSValueMakeBoolean(jsCtx, glResult);
+      }
+      return JSValueMakeNumber(jsCtx, (GLuint) glResult);
+    }
+    default:
+      throw std::runtime_error("EXGL: Invalid pname for gl.getActiveUniformBlockParameter()!");
+  }
+}
 
 _WRAP_WEBGL2_METHOD(getActiveUniformBlockName, 2) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fProgram, GLuint uniformBlockIndex);
@@ -1509,6 +2076,9 @@ _WRAP_WEBGL2_METHOD(createVertexArray, 0) {
 
 _WRAP_WEBGL2_METHOD(deleteVertexArray, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId fVertexArray);
+  shadowState.forgetObject(fVertexArray);
+  residency.forget(fVertexArray);
+  vertexArrays.forgetVertexArray(fVertexArray);
   addToNextBatch([=] {
     GLuint vertexArray = lookupObject(fVertexArray);
     glDeleteVertexArrays(1, &vertexArray);
@@ -1520,7 +2090,14 @@ _WRAP_WEBGL2_METHOD_IS_OBJECT(VertexArray)
 
 _WRAP_WEBGL2_METHOD(bindVertexArray, 1) {
   EXJS_UNPACK_ARGV(UEXGLObjectId vertexArray);
-  addToNextBatch([=] { glBindVertexArray(lookupObject(vertexArray)); });
+  residency.bindVertexArray(vertexArray);
+  const double args[] = { (double) vertexArray };
+  shadowState.update(EXGLShadowState::VertexArray, args, 1);
+  // The attribute setup comes with the vertex array, calls re-issuing it after
+  // this are dropped by `vertexArrays`
+  if (vertexArrays.bind(vertexArray)) {
+    addUseToNextBatch(glBindVertexArray, vertexArray);
+  }
   return nullptr;
 }
 
@@ -1528,11 +2105,51 @@ _WRAP_WEBGL2_METHOD(bindVertexArray, 1) {
 // Extensions
 // ----------
 
+const std::vector<const EXGLCompressedTextureExtension *> &EXGLContext::getSupportedExtensionList() {
+  if (!supportedExtensionsKnown) {
+    std::vector<std::string> glExtensions;
+    addBlockingToNextBatch([&] {
+      GLint count = 0;
+      glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+      for (GLint i = 0; i < count; ++i) {
+        glExtensions.push_back((const char *) glGetStringi(GL_EXTENSIONS, i));
+      }
+    });
+    for (const auto &extension : EXGLCompressedTextureExtensions()) {
+      bool supported = extension.glNames.empty();
+      for (auto glName : extension.glNames) {
+        supported = supported ||
+          std::find(glExtensions.begin(), glExtensions.end(), glName) != glExtensions.end();
+      }
+      if (supported) {
+        supportedExtensions.push_back(&extension);
+      }
+    }
+    supportedExtensionsKnown = true;
+  }
+  return supportedExtensions;
+}
+
 _WRAP_METHOD(getSupportedExtensions, 0) {
-  return JSObjectMakeArray(jsCtx, 0, NULL, NULL);
+  std::vector<JSValueRef> jsResults;
+  for (auto extension : getSupportedExtensionList()) {
+    jsResults.push_back(EXJSValueMakeStringFromUTF8CString(jsCtx, extension->webglName));
+  }
+  return JSObjectMakeArray(jsCtx, jsResults.size(), jsResults.data(), nullptr);
 }
 
 _WRAP_METHOD(getExtension, 1) {
+  auto name = jsValueToSharedStr(jsCtx, jsArgv[0]);
+  for (auto extension : getSupportedExtensionList()) {
+    if (strcmp(extension->webglName, name.get()) == 0) {
+      JSObjectRef jsResult = JSObjectMake(jsCtx, nullptr, nullptr);
+      for (const auto &constant : extension->constants) {
+        EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, constant.name,
+                                              JSValueMakeNumber(jsCtx, constant.value));
+      }
+      return jsResult;
+    }
+  }
   return JSValueMakeNull(jsCtx);
 }
 
@@ -1541,11 +2158,11 @@ _WRAP_METHOD(getExtension, 1) {
 // -------------------
 
 _WRAP_METHOD(endFrameEXP, 0) {
-  addToNextBatch([=] {
-    setNeedsRedraw(true);
-  });
-  endNextBatch();
-  flushOnGLThread();
+  releasePinnedArrays(jsCtx);
+  resolvePixelPacks(jsCtx);
+  endFrame();
+  endFrameResidency(jsCtx);
+  endFrameStats();
   return nullptr;
 }
 
@@ -1555,3 +2172,392 @@ _WRAP_METHOD(flushEXP, 0) {
   });
   return nullptr;
 }
+
+// Same as `bufferData`/`bufferSubData`/`texImage2D` with a TypedArray, but the
+// data is read straight from the TypedArray when the op runs on the GL thread
+// instead of being copied when the method is called. The TypedArray must not be
+// modified until then (in practice, until the next `endFrameEXP`).
+
+_WRAP_METHOD(bufferDataNoCopyEXP, 3) {
+  releasePinnedArrays(jsCtx);
+  EXJS_UNPACK_ARGV(GLenum target);
+  EXJS_UNPACK_ARGV_OFFSET(2, GLenum usage);
+  size_t length;
+  auto data = jsValueToPinnedArray(jsCtx, jsArgv[1], &length);
+  residency.bufferStorage(target, length);
+  addToNextBatch([=] { glBufferData(target, length, data.get(), usage); });
+  traceLastClosure(EXGLTraceEvent::BufferData, { (double) target, (double) length, (double) usage },
+                   data.get(), data ? length : 0);
+  return nullptr;
+}
+
+_WRAP_METHOD(bufferSubDataNoCopyEXP, 3) {
+  releasePinnedArrays(jsCtx);
+  EXJS_UNPACK_ARGV(GLenum target, GLintptr offset);
+  size_t length;
+  auto data = jsValueToPinnedArray(jsCtx, jsArgv[2], &length);
+  if (data) {
+    addToNextBatch([=] { glBufferSubData(target, offset, length, data.get()); });
+    traceLastClosure(EXGLTraceEvent::BufferSubData, { (double) target, (double) offset }, data.get(), length);
+  }
+  return nullptr;
+}
+
+_WRAP_METHOD(texImage2DNoCopyEXP, 9) {
+  releasePinnedArrays(jsCtx);
+  EXJS_UNPACK_ARGV(GLenum target, GLint level, GLint internalformat,
+                   GLsizei width, GLsizei height, GLint border,
+                   GLenum format, GLenum type);
+
+  // Flipping rows or premultiplying would write into the TypedArray, that's the
+  // regular path's job
+  if (unpackFLipY || unpackPremultiplyAlpha) {
+    return exglNativeInstance_texImage2D(jsCtx, jsFunction, jsThis, jsArgc, jsArgv, jsException);
+  }
+
+  size_t length = 0;
+  auto data = jsValueToPinnedArray(jsCtx, jsArgv[8], &length);
+  if (!data && !JSValueIsNull(jsCtx, jsArgv[8])) {
+    throw std::runtime_error("EXGL: Invalid pixel data argument for gl.texImage2DNoCopyEXP()!");
+  }
+  residency.textureImage(target, level, imageBytes(internalformat, format, type, width, height));
+  addToNextBatch([=] {
+    glTexImage2D(target, level, internalformat, width, height, border, format, type, data.get());
+  });
+  traceLastClosure(EXGLTraceEvent::TexImage2D, { (double) target, (double) level, (double) internalformat,
+                   (double) width, (double) height, (double) border, (double) format, (double) type },
+                   data.get(), data ? length : 0);
+  return nullptr;
+}
+
+// Like `readPixels` but doesn't wait for the GPU: the pixels are passed to
+// `callback` as a TypedArray once they're ready, usually one or two frames later.
+_WRAP_WEBGL2_METHOD(readPixelsAsyncEXP, 7) {
+  EXJS_UNPACK_ARGV(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type);
+  JSObjectRef jsCallback = JSValueToObject(jsCtx, jsArgv[6], nullptr);
+  if (!jsCallback || !JSObjectIsFunction(jsCtx, jsCallback)) {
+    throw std::runtime_error("EXGL: gl.readPixelsAsyncEXP() expects a callback!");
+  }
+
+  PixelPackRequest request;
+  request.byteLength = width * height * bytesPerPixel(type, format);
+  request.arrayType = type == GL_FLOAT ? kJSTypedArrayTypeFloat32Array
+    : type == GL_UNSIGNED_BYTE ? kJSTypedArrayTypeUint8Array
+    : kJSTypedArrayTypeUint16Array;
+  request.jsCallback = jsCallback;
+  JSValueProtect(jsCtx, jsCallback);
+
+  addToNextBatch([=] {
+    beginPixelPack(request, x, y, width, height, format, type);
+  });
+  return nullptr;
+}
+
+// Like `getBufferSubData` but doesn't wait for the GPU: `byteLength` bytes at
+// `srcByteOffset` of the buffer bound to `target` are passed to `callback` as a
+// Uint8Array once they're ready, usually a frame or two later. Wrap its
+// `.buffer` in another TypedArray type to read other element types.
+_WRAP_WEBGL2_METHOD(getBufferSubDataAsyncEXP, 4) {
+  EXJS_UNPACK_ARGV(GLenum target, GLintptr srcByteOffset, GLsizeiptr byteLength);
+  JSObjectRef jsCallback = JSValueToObject(jsCtx, jsArgv[3], nullptr);
+  if (!jsCallback || !JSObjectIsFunction(jsCtx, jsCallback)) {
+    throw std::runtime_error("EXGL: gl.getBufferSubDataAsyncEXP() expects a callback!");
+  }
+  if (srcByteOffset < 0 || byteLength <= 0) {
+    throw std::runtime_error("EXGL: Invalid range for gl.getBufferSubDataAsyncEXP()!");
+  }
+
+  PixelPackRequest request;
+  request.byteLength = byteLength;
+  request.arrayType = kJSTypedArrayTypeUint8Array;
+  request.jsCallback = jsCallback;
+  JSValueProtect(jsCtx, jsCallback);
+
+  addToNextBatch([=] {
+    beginBufferPack(request, target, srcByteOffset);
+  });
+  return nullptr;
+}
+
+// Keep a shadow copy of the GL state on the JS thread: redundant state changes
+// are dropped and most `getParameter` queries don't have to wait for the GL thread
+_WRAP_METHOD(enableStateCachingEXP, 1) {
+  shadowState.enabled = JSValueToBoolean(jsCtx, jsArgv[0]);
+  shadowState.invalidate();
+  return nullptr;
+}
+
+// Make `getError` return the error seen at the end of the last flush instead of
+// waiting for the GL thread
+_WRAP_METHOD(enableDeferredErrorsEXP, 1) {
+  deferredErrors = JSValueToBoolean(jsCtx, jsArgv[0]);
+  deferredError = GL_NO_ERROR;
+  return nullptr;
+}
+
+// What to do when the GL thread falls a full backlog behind: 'coalesce' (the
+// default) merges the batches into one that runs after the backlog, 'block' waits
+_WRAP_METHOD(setBacklogPolicyEXP, 1) {
+  auto policy = jsValueToSharedStr(jsCtx, jsArgv[0]);
+  if (strcmp(policy.get(), "coalesce") == 0) {
+    backlogPolicy = BacklogPolicy::Coalesce;
+  } else if (strcmp(policy.get(), "block") == 0) {
+    backlogPolicy = BacklogPolicy::Block;
+  } else {
+    throw std::runtime_error("EXGL: setBacklogPolicyEXP() expects 'coalesce' or 'block'!");
+  }
+  return nullptr;
+}
+
+// Upload every level of a KTX or KTX2 file (`{ localUri }`) to the texture bound
+// to `target`. The container is parsed natively and its images are handed to GL
+// as they are. Returns `{ width, height, depth, levels, internalFormat }`.
+_WRAP_METHOD(compressedTexImageKTXEXP, 2) {
+  EXJS_UNPACK_ARGV(GLenum target);
+  std::string localPath;
+  if (!JSValueIsObject(jsCtx, jsArgv[1]) ||
+      !localPathFromImage(jsCtx, (JSObjectRef) jsArgv[1], localPath)) {
+    throw std::runtime_error("EXGL: gl.compressedTexImageKTXEXP() expects an object with a `localUri`!");
+  }
+
+  auto texture = std::make_shared<EXGLCompressedTexture>();
+  std::string error;
+  if (!EXGLCompressedTexture::load(localPath, *texture, error)) {
+    throw std::runtime_error("EXGL: gl.compressedTexImageKTXEXP() couldn't load the texture: " + error);
+  }
+  bool isSingleLayer = texture->target() == GL_TEXTURE_2D &&
+    (target == GL_TEXTURE_2D_ARRAY || target == GL_TEXTURE_3D);
+  if (texture->target() != target && !isSingleLayer) {
+    throw std::runtime_error("EXGL: gl.compressedTexImageKTXEXP() target doesn't match the texture's shape!");
+  }
+  addToNextBatch([=] { texture->upload(target); });
+
+  JSObjectRef jsResult = JSObjectMake(jsCtx, nullptr, nullptr);
+  EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "width",
+                                        JSValueMakeNumber(jsCtx, texture->width));
+  EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "height",
+                                        JSValueMakeNumber(jsCtx, texture->height));
+  EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "depth",
+                                        JSValueMakeNumber(jsCtx, texture->layers > 1 ? texture->layers : texture->depth));
+  EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "levels",
+                                        JSValueMakeNumber(jsCtx, texture->levels));
+  EXJSObjectSetValueWithUTF8CStringName(jsCtx, jsResult, "internalFormat",
+                                        JSValueMakeNumber(jsCtx, texture->internalFormat));
+  return jsResult;
+}
+
+// Largest number of bytes a mapped `{ localUri }` upload hands to GL in one
+// call, 0 for no limit
+_WRAP_METHOD(setUploadBudgetEXP, 1) {
+  EXJS_UNPACK_ARGV(double bytes);
+  uploadBudget = bytes > 0 ? (size_t) bytes : SIZE_MAX;
+  return nullptr;
+}
+
+// Hand `width` x `height` of a framebuffer (the default one if omitted) to the
+// video encoder attached natively at the end of every frame, see
+// `UEXGLContextSetFrameSink`
+_WRAP_METHOD(startRecordingEXP, 2) {
+  EXJS_UNPACK_ARGV(GLsizei width, GLsizei height);
+  UEXGLObjectId fFramebuffer = 0;
+  if (jsArgc > 2 && !JSValueIsUndefined(jsCtx, jsArgv[2]) && !JSValueIsNull(jsCtx, jsArgv[2])) {
+    fFramebuffer = EXJSValueToNumberFast(jsCtx, jsArgv[2]);
+  }
+  if (width <= 0 || height <= 0) {
+    throw std::runtime_error("EXGL: gl.startRecordingEXP() needs a width and a height!");
+  }
+  if (!getFrameSink()) {
+    throw std::runtime_error("EXGL: No video encoder is attached to this context!");
+  }
+  addToNextBatch([=] {
+    recording.framebuffer = fFramebuffer;
+    recording.width = width;
+    recording.height = height;
+    recording.active = true;
+  });
+  return nullptr;
+}
+
+// The frame in progress is the last one recorded
+_WRAP_METHOD(stopRecordingEXP, 0) {
+  addToNextBatch([=] { stopRecording(); });
+  return nullptr;
+}
+
+// `texStorage2D` and every level of the mip chain from one typed array, level 0
+// first (with the 6 faces of each level for cube maps), rows tightly packed
+_WRAP_WEBGL2_METHOD(texStorage2DLevelsEXP, 8) {
+  EXJS_UNPACK_ARGV(GLenum target, GLsizei levels, GLenum internalformat,
+                   GLsizei width, GLsizei height, GLenum format, GLenum type);
+  size_t length = 0;
+  std::shared_ptr<void> data = jsValueToSharedArray(jsCtx, jsArgv[7], &length);
+  if (!data) {
+    throw std::runtime_error("EXGL: gl.texStorage2DLevelsEXP() takes its pixels as a typed array!");
+  }
+  addTexStorageLevelsToNextBatch(target, levels, internalformat, width, height, format, type,
+                                 std::move(data), length);
+  return nullptr;
+}
+
+// Start or stop timing frames for `getFrameStatsEXP`
+_WRAP_METHOD(enableFrameStatsEXP, 1) {
+  frameStatsEnabled = JSValueToBoolean(jsCtx, jsArgv[0]);
+  return nullptr;
+}
+
+// Stats of the last frame as a Float64Array:
+// [ops, bytesCopied, blockingCalls, blockedMs, flushMs, backlogDepth,
+//  residentBytes, textureBytes, bufferBytes, renderbufferBytes, contextLost]
+_WRAP_METHOD(getFrameStatsEXP, 0) {
+  return makeTypedArray(jsCtx, kJSTypedArrayTypeFloat64Array,
+                        lastFrameStats, sizeof(lastFrameStats));
+}
+
+// When the next frame is due, as a Float64Array:
+// [msUntilDeadline, refreshIntervalMs, framesBehind], `framesBehind` counting
+// the frames ended with `endFrameEXP` that the GL thread hasn't run yet
+_WRAP_METHOD(getFrameDeadlineEXP, 0) {
+  double deadline[3];
+  frameDeadline(deadline);
+  return makeTypedArray(jsCtx, kJSTypedArrayTypeFloat64Array, deadline, sizeof(deadline));
+}
+
+// Budget the estimated GPU memory of the context:
+// `gl.setResidencyBudgetEXP(bytes, callback)`, 0 bytes for no budget. At the end
+// of a frame spent over budget `callback(objects, totalBytes)` gets the least
+// recently used buffers, textures and renderbuffers (a Uint32Array of object
+// ids) whose deletion would bring the total back under it. Objects used during
+// the frame are spared. Without a callback `getResidencyCandidatesEXP` polls.
+_WRAP_METHOD(setResidencyBudgetEXP, 1) {
+  EXJS_UNPACK_ARGV(double bytes);
+  JSObjectRef jsCallback = nullptr;
+  if (jsArgc > 1 && !JSValueIsNull(jsCtx, jsArgv[1]) && !JSValueIsUndefined(jsCtx, jsArgv[1])) {
+    jsCallback = JSValueToObject(jsCtx, jsArgv[1], nullptr);
+    if (!jsCallback || !JSObjectIsFunction(jsCtx, jsCallback)) {
+      throw std::runtime_error("EXGL: gl.setResidencyBudgetEXP() expects a function or null!");
+    }
+  }
+  setResidencyBudget(jsCtx, bytes > 0 ? (size_t) bytes : 0, jsCallback);
+  return nullptr;
+}
+
+// What `setResidencyBudgetEXP`'s callback would get now, as a Uint32Array
+_WRAP_METHOD(getResidencyCandidatesEXP, 0) {
+  std::vector<UEXGLObjectId> candidates;
+  if (residency.overBudget()) {
+    candidates = residency.evictionCandidates();
+  }
+  return makeTypedArray(jsCtx, kJSTypedArrayTypeUint32Array,
+                        candidates.data(), candidates.size() * sizeof(UEXGLObjectId));
+}
+
+// Set many uniforms of `program` from one buffer with a single copy:
+// `gl.uniformBlockUpdateEXP(program, data, layout)`. `layout` is an Int32Array
+// of (location, type, count, offset) quadruples, `offset` counted in 4-byte
+// elements of `data`. Values are read as floats, ints or uints depending on the
+// uniform's type, int uniforms can be written through an Int32Array view of the
+// same buffer. Leaves `program` in use.
+_WRAP_METHOD(uniformBlockUpdateEXP, 3) {
+  EXJS_UNPACK_ARGV(UEXGLObjectId program);
+  JSTypedArrayType layoutType = JSValueGetTypedArrayType(jsCtx, jsArgv[2], nullptr);
+  if (layoutType != kJSTypedArrayTypeInt32Array && layoutType != kJSTypedArrayTypeUint32Array) {
+    throw std::runtime_error("EXGL: gl.uniformBlockUpdateEXP() expects an Int32Array layout!");
+  }
+  withTypedArrayData(jsCtx, jsArgv[2], [&](void *layout, size_t layoutBytes) {
+    withTypedArrayData(jsCtx, jsArgv[1], [&](void *data, size_t bytes) {
+      if (!data) {
+        throw std::runtime_error("EXGL: gl.uniformBlockUpdateEXP() expects a TypedArray!");
+      }
+      addUniformBlockToNextBatch(program, (const GLint *) layout, layoutBytes / sizeof(GLint),
+                                 data, bytes);
+    });
+  });
+  return nullptr;
+}
+
+// Run many `drawElements` as one op:
+// `gl.multiDrawElementsEXP(mode, type, records, location, uniformType, uniformData)`.
+// `records` is an Int32Array of (offset, count, instanceCount, slot) quadruples,
+// before each draw the uniform at `location` is set to value `slot` of
+// `uniformData`, an array of values of `uniformType` (GL_FLOAT_MAT4...). Draws
+// with a slot of -1, or all of them when `location` is null, keep the current
+// value. See EXGLMultiDraw.h.
+_WRAP_METHOD(multiDrawElementsEXP, 3) {
+  EXJS_UNPACK_ARGV(GLenum mode, GLenum type);
+  JSTypedArrayType recordsType = JSValueGetTypedArrayType(jsCtx, jsArgv[2], nullptr);
+  if (recordsType != kJSTypedArrayTypeInt32Array) {
+    throw std::runtime_error("EXGL: gl.multiDrawElementsEXP() expects Int32Array records!");
+  }
+  GLint location = -1;
+  GLenum uniformType = GL_NONE;
+  if (jsArgc > 3 && JSValueIsNumber(jsCtx, jsArgv[3])) {
+    if (jsArgc < 6) {
+      throw std::runtime_error("EXGL: gl.multiDrawElementsEXP() needs a uniform type and data with a location!");
+    }
+    location = EXJSValueToNumberFast(jsCtx, jsArgv[3]);
+    uniformType = EXJSValueToNumberFast(jsCtx, jsArgv[4]);
+  }
+  withTypedArrayData(jsCtx, jsArgv[2], [&](void *records, size_t recordsBytes) {
+    if (location == -1) {
+      addMultiDrawToNextBatch(mode, type, records, recordsBytes, -1, GL_NONE, nullptr, 0);
+      return;
+    }
+    withTypedArrayData(jsCtx, jsArgv[5], [&](void *uniformData, size_t uniformBytes) {
+      if (!uniformData) {
+        throw std::runtime_error("EXGL: gl.multiDrawElementsEXP() expects a TypedArray of uniform data!");
+      }
+      addMultiDrawToNextBatch(mode, type, records, recordsBytes, location, uniformType,
+                              uniformData, uniformBytes);
+    });
+  });
+  return nullptr;
+}
+
+// Latch the latest frame of a texture fed by a native video source (see
+// `UEXGLContextSetExternalTextureSource`). The texture may map to another GL
+// texture afterwards, bind it again before drawing with it.
+_WRAP_METHOD(updateExternalTextureEXP, 1) {
+  EXJS_UNPACK_ARGV(UEXGLObjectId fTexture);
+  shadowState.forgetObject(fTexture);
+  addToNextBatch([=] { latchExternalTexture(fTexture); });
+  return nullptr;
+}
+
+// Record the batches sent to the GL thread to the file at `path` (a plain
+// filesystem path, not a URI) until `stopTraceEXP`, see EXGLTrace.h
+_WRAP_METHOD(startTraceEXP, 1) {
+  auto path = jsValueToSharedStr(jsCtx, jsArgv[0]);
+  startTrace(path.get());
+  return nullptr;
+}
+
+// Returns the size of the trace in bytes
+_WRAP_METHOD(stopTraceEXP, 0) {
+  return JSValueMakeNumber(jsCtx, stopTrace());
+}
+
+// Rasterize `text` natively and upload it to `level` of the bound texture as
+// premultiplied RGBA / UNSIGNED_BYTE, sized to fit: `gl.texImage2DTextEXP(target,
+// level, text, style)`. `style` is `{ fontFamily, fontSize, fontWeight,
+// fontStyle, color (0xRRGGBBAA), maxWidth (wraps if > 0), textAlign }`. Returns
+// [width, height, baseline] as a Float64Array.
+_WRAP_METHOD(texImage2DTextEXP, 3) {
+  EXJS_UNPACK_ARGV(GLenum target, GLint level);
+  auto text = jsValueToSharedStr(jsCtx, jsArgv[2]);
+  auto style = textStyleFromObject(jsCtx, jsArgc > 3 ? jsArgv[3] : nullptr);
+  auto image = addTextImageToNextBatch(target, level, false, 0, 0, text.get(), style);
+  double size[3] = { (double) image.width, (double) image.height, image.baseline };
+  return makeTypedArray(jsCtx, kJSTypedArrayTypeFloat64Array, size, sizeof(size));
+}
+
+// Like `texImage2DTextEXP` into a region of an existing texture, e.g. to pack
+// labels into an atlas: `gl.texSubImage2DTextEXP(target, level, xoffset,
+// yoffset, text, style)`
+_WRAP_METHOD(texSubImage2DTextEXP, 5) {
+  EXJS_UNPACK_ARGV(GLenum target, GLint level, GLint xoffset, GLint yoffset);
+  auto text = jsValueToSharedStr(jsCtx, jsArgv[4]);
+  auto style = textStyleFromObject(jsCtx, jsArgc > 5 ? jsArgv[5] : nullptr);
+  auto image = addTextImageToNextBatch(target, level, true, xoffset, yoffset, text.get(), style);
+  double size[3] = { (double) image.width, (double) image.height, image.baseline };
+  return makeTypedArray(jsCtx, kJSTypedArrayTypeFloat64Array, size, sizeof(size));
+}
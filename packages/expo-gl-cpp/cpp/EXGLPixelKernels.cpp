@@ -0,0 +1,152 @@
+#include "EXGLPixelKernels.h"
+
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define EXGL_NEON 1
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#define EXGL_SSE2 1
+#include <emmintrin.h>
+#ifdef __SSSE3__
+#define EXGL_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#endif
+
+// c * a / 255 rounded to nearest, exact for 8-bit inputs
+static inline uint8_t mulDiv255(unsigned int c, unsigned int a) noexcept {
+  unsigned int x = c * a + 128;
+  return (uint8_t) ((x + (x >> 8)) >> 8);
+}
+
+void EXGLFlipRows(void *pixels, size_t bytesPerRow, size_t rows) noexcept {
+  if (!pixels || rows < 2) {
+    return;
+  }
+  auto bytes = (uint8_t *) pixels;
+  for (size_t rowTop = 0, rowBottom = rows - 1; rowTop < rowBottom; ++rowTop, --rowBottom) {
+    uint8_t *top = bytes + rowTop * bytesPerRow;
+    uint8_t *bottom = bytes + rowBottom * bytesPerRow;
+    size_t i = 0;
+#if EXGL_NEON
+    for (; i + 16 <= bytesPerRow; i += 16) {
+      uint8x16_t a = vld1q_u8(top + i);
+      uint8x16_t b = vld1q_u8(bottom + i);
+      vst1q_u8(top + i, b);
+      vst1q_u8(bottom + i, a);
+    }
+#elif EXGL_SSE2
+    for (; i + 16 <= bytesPerRow; i += 16) {
+      __m128i a = _mm_loadu_si128((const __m128i *) (top + i));
+      __m128i b = _mm_loadu_si128((const __m128i *) (bottom + i));
+      _mm_storeu_si128((__m128i *) (top + i), b);
+      _mm_storeu_si128((__m128i *) (bottom + i), a);
+    }
+#endif
+    for (; i < bytesPerRow; ++i) {
+      uint8_t tmp = top[i];
+      top[i] = bottom[i];
+      bottom[i] = tmp;
+    }
+  }
+}
+
+void EXGLPremultiplyAlpha(uint8_t *rgba, size_t pixelCount) noexcept {
+  if (!rgba) {
+    return;
+  }
+  size_t i = 0;
+#if EXGL_NEON
+  for (; i + 8 <= pixelCount; i += 8) {
+    uint8x8x4_t p = vld4_u8(rgba + 4 * i);
+    for (int c = 0; c < 3; ++c) {
+      // (t + ((t + 128) >> 8) + 128) >> 8, same as mulDiv255
+      uint16x8_t t = vmull_u8(p.val[c], p.val[3]);
+      p.val[c] = vraddhn_u16(t, vrshrq_n_u16(t, 8));
+    }
+    vst4_u8(rgba + 4 * i, p);
+  }
+#elif EXGL_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i half = _mm_set1_epi16(128);
+  // Alpha is multiplied by 255 so that it comes out unchanged
+  const __m128i colorLanes = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+  const __m128i alphaLanes = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+  auto premultiply = [&](__m128i p) {
+    __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, 0xFF), 0xFF);
+    a = _mm_or_si128(_mm_and_si128(a, colorLanes), alphaLanes);
+    __m128i x = _mm_add_epi16(_mm_mullo_epi16(p, a), half);
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+  };
+  for (; i + 4 <= pixelCount; i += 4) {
+    __m128i p = _mm_loadu_si128((const __m128i *) (rgba + 4 * i));
+    __m128i lo = premultiply(_mm_unpacklo_epi8(p, zero));
+    __m128i hi = premultiply(_mm_unpackhi_epi8(p, zero));
+    _mm_storeu_si128((__m128i *) (rgba + 4 * i), _mm_packus_epi16(lo, hi));
+  }
+#endif
+  for (; i < pixelCount; ++i) {
+    uint8_t *p = rgba + 4 * i;
+    p[0] = mulDiv255(p[0], p[3]);
+    p[1] = mulDiv255(p[1], p[3]);
+    p[2] = mulDiv255(p[2], p[3]);
+  }
+}
+
+void EXGLExpandRGBToRGBA(const uint8_t *rgb, uint8_t *rgba, size_t pixelCount) noexcept {
+  size_t i = 0;
+#if EXGL_NEON
+  for (; i + 16 <= pixelCount; i += 16) {
+    uint8x16x3_t src = vld3q_u8(rgb + 3 * i);
+    uint8x16x4_t dst;
+    dst.val[0] = src.val[0];
+    dst.val[1] = src.val[1];
+    dst.val[2] = src.val[2];
+    dst.val[3] = vdupq_n_u8(255);
+    vst4q_u8(rgba + 4 * i, dst);
+  }
+#elif EXGL_SSSE3
+  const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const __m128i opaque = _mm_set1_epi32((int) 0xFF000000);
+  // Loads 16 bytes for 4 pixels, stop while there are 16 left to read
+  for (; i + 6 <= pixelCount; i += 4) {
+    __m128i p = _mm_loadu_si128((const __m128i *) (rgb + 3 * i));
+    _mm_storeu_si128((__m128i *) (rgba + 4 * i), _mm_or_si128(_mm_shuffle_epi8(p, shuffle), opaque));
+  }
+#endif
+  for (; i < pixelCount; ++i) {
+    rgba[4 * i + 0] = rgb[3 * i + 0];
+    rgba[4 * i + 1] = rgb[3 * i + 1];
+    rgba[4 * i + 2] = rgb[3 * i + 2];
+    rgba[4 * i + 3] = 255;
+  }
+}
+
+void EXGLPackRGBAToRGB(const uint8_t *rgba, uint8_t *rgb, size_t pixelCount) noexcept {
+  size_t i = 0;
+  // In place, every store lands before the bytes the next load reads
+#if EXGL_NEON
+  for (; i + 16 <= pixelCount; i += 16) {
+    uint8x16x4_t src = vld4q_u8(rgba + 4 * i);
+    uint8x16x3_t dst;
+    dst.val[0] = src.val[0];
+    dst.val[1] = src.val[1];
+    dst.val[2] = src.val[2];
+    vst3q_u8(rgb + 3 * i, dst);
+  }
+#elif EXGL_SSSE3
+  const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  // Stores 16 bytes for 4 pixels, stop while there are 16 left to write
+  for (; i + 6 <= pixelCount; i += 4) {
+    __m128i p = _mm_loadu_si128((const __m128i *) (rgba + 4 * i));
+    _mm_storeu_si128((__m128i *) (rgb + 3 * i), _mm_shuffle_epi8(p, shuffle));
+  }
+#endif
+  for (; i < pixelCount; ++i) {
+    uint8_t r = rgba[4 * i + 0], g = rgba[4 * i + 1], b = rgba[4 * i + 2];
+    rgb[3 * i + 0] = r;
+    rgb[3 * i + 1] = g;
+    rgb[3 * i + 2] = b;
+  }
+}
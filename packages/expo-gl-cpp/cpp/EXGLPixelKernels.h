@@ -0,0 +1,32 @@
+#ifndef __EXGLPIXELKERNELS_H__
+#define __EXGLPIXELKERNELS_H__
+
+#include <cstddef>
+#include <cstdint>
+
+
+// --- EXGLPixelKernels --------------------------------------------------------
+
+// Pixel conversions applied to texture uploads and readbacks. They run over
+// whole camera frames and decoded images, so each has a NEON (ARM) or SSE2
+// (x86, simulators) path processing 16 bytes at a time with a scalar loop for
+// the tail. Buffers don't need to be aligned.
+
+// Reverse the order of `rows` rows of `bytesPerRow` bytes in place
+// (`UNPACK_FLIP_Y_WEBGL`). Any stride works, including ones that aren't a
+// multiple of 4 such as tightly packed RGB rows.
+void EXGLFlipRows(void *pixels, size_t bytesPerRow, size_t rows) noexcept;
+
+// Multiply the color of `pixelCount` RGBA8 pixels by their alpha in place
+// (`UNPACK_PREMULTIPLY_ALPHA_WEBGL`), rounding like `c * a / 255`
+void EXGLPremultiplyAlpha(uint8_t *rgba, size_t pixelCount) noexcept;
+
+// Expand `pixelCount` RGB8 pixels to RGBA8 with an opaque alpha. `rgba` must not
+// overlap `rgb`.
+void EXGLExpandRGBToRGBA(const uint8_t *rgb, uint8_t *rgba, size_t pixelCount) noexcept;
+
+// Drop the alpha of `pixelCount` RGBA8 pixels. `rgb` may be `rgba`, to pack in
+// place.
+void EXGLPackRGBAToRGB(const uint8_t *rgba, uint8_t *rgb, size_t pixelCount) noexcept;
+
+#endif
@@ -0,0 +1,138 @@
+#include "EXGLProgramCache.h"
+#include "EXJSUtils.h"
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+// Binary file layout, integers in native byte order: the magic, u32 binary
+// format, u32 byte length, the binary
+#define EXGL_PROGRAM_CACHE_MAGIC "EXGLPRG1"
+
+EXGLProgramCache &EXGLProgramCache::shared() {
+  static EXGLProgramCache cache;
+  return cache;
+}
+
+void EXGLProgramCache::setDirectory(const std::string &path) {
+  std::lock_guard<decltype(mutex)> lock(mutex);
+  directory = path;
+  while (!directory.empty() && directory.back() == '/') {
+    directory.pop_back();
+  }
+}
+
+bool EXGLProgramCache::enabled() {
+  std::lock_guard<decltype(mutex)> lock(mutex);
+  return !directory.empty();
+}
+
+std::string EXGLProgramCache::pathFor(uint64_t key) {
+  // Same for every context of the process, the driver doesn't change under us
+  static const uint64_t driverHash = [] {
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount == 0) {
+      return (uint64_t) 0;
+    }
+    uint64_t result = hash(nullptr, 0);
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+      auto str = (const char *) glGetString(name);
+      if (str) {
+        result = hash(str, strlen(str) + 1, result);
+      }
+    }
+    return result;
+  }();
+  if (driverHash == 0) {
+    return std::string();
+  }
+
+  std::lock_guard<decltype(mutex)> lock(mutex);
+  if (directory.empty()) {
+    return std::string();
+  }
+  std::stringstream ss;
+  ss << directory << "/exgl-" << std::hex << hash(&driverHash, sizeof(driverHash), key) << ".bin";
+  return ss.str();
+}
+
+bool EXGLProgramCache::load(GLuint program, uint64_t key) {
+  std::string path = pathFor(key);
+  if (path.empty()) {
+    return false;
+  }
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+
+  char magic[sizeof(EXGL_PROGRAM_CACHE_MAGIC) - 1];
+  uint32_t format = 0, byteLength = 0;
+  std::vector<uint8_t> binary;
+  bool valid = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+    memcmp(magic, EXGL_PROGRAM_CACHE_MAGIC, sizeof(magic)) == 0 &&
+    fread(&format, sizeof(format), 1, file) == 1 &&
+    fread(&byteLength, sizeof(byteLength), 1, file) == 1;
+  if (valid) {
+    binary.resize(byteLength);
+    valid = fread(binary.data(), 1, byteLength, file) == byteLength;
+  }
+  fclose(file);
+  if (!valid) {
+    remove(path.c_str());
+    return false;
+  }
+
+  glProgramBinary(program, format, binary.data(), (GLsizei) binary.size());
+  GLint linkStatus = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+  if (!linkStatus) {
+    // Rejected by the driver, the program gets relinked from source
+    EXGLSysLog("EXGL: Dropping a stale cached program binary");
+    remove(path.c_str());
+    return false;
+  }
+  return true;
+}
+
+void EXGLProgramCache::store(GLuint program, uint64_t key) {
+  GLint linkStatus = GL_FALSE, byteLength = 0;
+  glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &byteLength);
+  if (!linkStatus || byteLength <= 0) {
+    return;
+  }
+  std::string path = pathFor(key);
+  if (path.empty()) {
+    return;
+  }
+
+  std::vector<uint8_t> binary(byteLength);
+  GLenum format = 0;
+  GLsizei length = 0;
+  glGetProgramBinary(program, byteLength, &length, &format, binary.data());
+  if (length <= 0) {
+    return;
+  }
+
+  // Written next to its final path and renamed, so a concurrent or interrupted
+  // write never leaves a truncated binary behind
+  std::string tmpPath = path + ".tmp";
+  FILE *file = fopen(tmpPath.c_str(), "wb");
+  if (!file) {
+    EXGLSysLog("EXGL: Couldn't write to the program cache at '%s'", tmpPath.c_str());
+    return;
+  }
+  uint32_t format32 = format, length32 = length;
+  bool written = fwrite(EXGL_PROGRAM_CACHE_MAGIC, 1, sizeof(EXGL_PROGRAM_CACHE_MAGIC) - 1, file) ==
+      sizeof(EXGL_PROGRAM_CACHE_MAGIC) - 1 &&
+    fwrite(&format32, sizeof(format32), 1, file) == 1 &&
+    fwrite(&length32, sizeof(length32), 1, file) == 1 &&
+    fwrite(binary.data(), 1, length, file) == (size_t) length;
+  written = fclose(file) == 0 && written;
+  if (!written || rename(tmpPath.c_str(), path.c_str()) != 0) {
+    remove(tmpPath.c_str());
+  }
+}
@@ -0,0 +1,76 @@
+#ifndef __EXGLPROGRAMCACHE_H__
+#define __EXGLPROGRAMCACHE_H__
+
+#ifdef __ANDROID__
+#include <GLES3/gl3.h>
+#endif
+#ifdef __APPLE__
+#include <OpenGLES/ES3/gl.h>
+#endif
+
+// KHR_parallel_shader_compile
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+
+// --- EXGLProgramCache --------------------------------------------------------
+
+// Persistent cache of linked program binaries (`glGetProgramBinary`), so that
+// programs linked in an earlier run of the app are loaded with `glProgramBinary`
+// instead of going through the driver's compiler again. Binaries are keyed by a
+// hash of everything a link depends on: the sources of the attached shaders,
+// attribute bindings and transform feedback varyings (hashed on the JS thread
+// by EXGLContext), and the GL renderer and driver version (so driver updates
+// don't load stale binaries). A binary the driver rejects is just relinked and
+// overwritten.
+//
+// The cache is shared by all EXGL contexts and stays disabled until the
+// platform gives it a directory with `UEXGLSetProgramCacheDirectory()`, usually
+// under the app's cache dir. Each binary is one file in there.
+
+class EXGLProgramCache {
+public:
+  static EXGLProgramCache &shared();
+
+  // [Any thread] Empty to disable the cache
+  void setDirectory(const std::string &path);
+
+  // [Any thread]
+  bool enabled();
+
+  // [GL thread] Try loading the binary cached for `key` into `program`. Returns
+  // true if the program is now successfully linked.
+  bool load(GLuint program, uint64_t key);
+
+  // [GL thread] Save the binary of `program` for `key` if it's linked
+  void store(GLuint program, uint64_t key);
+
+  // FNV-1a, chain calls through `seed`
+  static inline uint64_t hash(const void *data, size_t byteLength,
+                              uint64_t seed = 14695981039346656037ull) noexcept {
+    auto bytes = reinterpret_cast<const uint8_t *>(data);
+    uint64_t result = seed;
+    for (size_t i = 0; i < byteLength; ++i) {
+      result = (result ^ bytes[i]) * 1099511628211ull;
+    }
+    return result;
+  }
+
+private:
+  EXGLProgramCache() = default;
+
+  // [GL thread] File holding the binary for `key`, empty if disabled or if the
+  // context can't save binaries
+  std::string pathFor(uint64_t key);
+
+  std::mutex mutex;
+  std::string directory;
+};
+
+#endif
@@ -0,0 +1,268 @@
+#include "EXGLRenderPool.h"
+
+#include "EXGLContext.h"
+
+#ifdef __ANDROID__
+#ifndef EGL_OPENGL_ES3_BIT_KHR
+#define EGL_OPENGL_ES3_BIT_KHR 0x0040
+#endif
+#endif
+
+EXGLRenderPool &EXGLRenderPool::shared() {
+  // Never destroyed: the threads live as long as the process
+  static auto pool = new EXGLRenderPool();
+  return *pool;
+}
+
+void EXGLRenderPool::setThreadCount(unsigned int count) noexcept {
+  std::lock_guard<decltype(mutex)> lock(mutex);
+  if (started) {
+    EXGLSysLog("EXGL: The render pool is already running, its thread count can't change!");
+    return;
+  }
+  threadCount = count;
+}
+
+
+// GL contexts
+// -----------
+
+#ifdef __ANDROID__
+void EXGLRenderPool::start() {
+  started = true;
+
+  display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+    EXGLSysLog("EXGL: Couldn't initialize EGL for the render pool!");
+    return;
+  }
+  const EGLint configAttribs[] = {
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT_KHR,
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_ALPHA_SIZE, 8,
+    EGL_NONE,
+  };
+  EGLint configCount = 0;
+  if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+    EXGLSysLog("EXGL: No EGL config for the render pool!");
+    return;
+  }
+  shareContext = createGLContext();
+  if (shareContext == EGL_NO_CONTEXT) {
+    EXGLSysLog("EXGL: Couldn't create a GL context for the render pool!");
+    return;
+  }
+
+  unsigned int count = threadCount;
+  if (count == 0) {
+    // Leave cores for the JS and UI threads
+    unsigned int cores = std::thread::hardware_concurrency();
+    count = cores / 2 > 4 ? 4 : (cores / 2 == 0 ? 1 : cores / 2);
+  }
+  const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+  for (unsigned int i = 0; i < count; ++i) {
+    std::unique_ptr<Worker> worker(new Worker());
+    worker->pbuffer = eglCreatePbufferSurface(display, config, pbufferAttribs);
+    if (worker->pbuffer == EGL_NO_SURFACE) {
+      EXGLSysLog("EXGL: Couldn't create a pbuffer for the render pool!");
+      break;
+    }
+    std::thread(&Worker::run, worker.get()).detach();
+    workers.push_back(std::move(worker));
+  }
+}
+
+EXGLRenderPool::GLContextRef EXGLRenderPool::createGLContext() {
+  const EGLint contextAttribs[] = { EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE };
+  return eglCreateContext(display, config, shareContext, contextAttribs);
+}
+
+void EXGLRenderPool::makeCurrent(Worker &worker, GLContextRef context) {
+  if (worker.current == context) {
+    return;
+  }
+  if (context == EGL_NO_CONTEXT) {
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  } else {
+    eglMakeCurrent(display, worker.pbuffer, worker.pbuffer, context);
+  }
+  worker.current = context;
+}
+#endif
+
+#ifdef __APPLE__
+void EXGLRenderPool::start() {
+  started = true;
+
+  shareContext = createGLContext();
+  if (!shareContext) {
+    EXGLSysLog("EXGL: Couldn't create a GL context for the render pool!");
+    return;
+  }
+
+  unsigned int count = threadCount;
+  if (count == 0) {
+    // Leave cores for the JS and UI threads
+    unsigned int cores = std::thread::hardware_concurrency();
+    count = cores / 2 > 4 ? 4 : (cores / 2 == 0 ? 1 : cores / 2);
+  }
+  for (unsigned int i = 0; i < count; ++i) {
+    std::unique_ptr<Worker> worker(new Worker());
+    std::thread(&Worker::run, worker.get()).detach();
+    workers.push_back(std::move(worker));
+  }
+}
+
+EXGLRenderPool::GLContextRef EXGLRenderPool::createGLContext() {
+  return [[EAGLContext alloc] initWithAPI:kEAGLRenderingAPIOpenGLES3
+                               sharegroup:shareContext ? shareContext.sharegroup : nil];
+}
+
+void EXGLRenderPool::makeCurrent(Worker &worker, GLContextRef context) {
+  if (worker.current == context) {
+    return;
+  }
+  [EAGLContext setCurrentContext:context];
+  worker.current = context;
+}
+#endif
+
+
+// Workers
+// -------
+
+void EXGLRenderPool::Worker::post(std::function<void(void)> job) {
+  {
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    jobs.push_back(std::move(job));
+  }
+  condition.notify_one();
+}
+
+void EXGLRenderPool::Worker::run() {
+  while (true) {
+    std::function<void(void)> job;
+    {
+      std::unique_lock<decltype(mutex)> lock(mutex);
+      condition.wait(lock, [&] { return !jobs.empty(); });
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+    job();
+  }
+}
+
+
+// Headless contexts
+// -----------------
+
+bool EXGLRenderPool::attach(UEXGLContextId exglCtxId, GLsizei width, GLsizei height) {
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (!exglCtx) {
+    return false;
+  }
+
+  auto surface = std::make_shared<Surface>();
+  {
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    if (!started) {
+      start();
+    }
+    for (const auto &worker : workers) {
+      if (!surface->worker || worker->contextCount < surface->worker->contextCount) {
+        surface->worker = worker.get();
+      }
+    }
+    if (!surface->worker) {
+      return false;
+    }
+    surface->context = createGLContext();
+    if (!surface->context) {
+      EXGLSysLog("EXGL: Couldn't create a GL context for a headless context!");
+      return false;
+    }
+    ++surface->worker->contextCount;
+    surfaces[exglCtxId] = surface;
+  }
+
+  // Runs before the context's first flush since jobs run in order
+  Worker *worker = surface->worker;
+  worker->post([=] {
+    makeCurrent(*worker, surface->context);
+
+    glGenFramebuffers(1, &surface->framebuffer);
+    glGenRenderbuffers(2, surface->renderbuffers);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, surface->renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, surface->renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, surface->framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                              GL_RENDERBUFFER, surface->renderbuffers[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                              GL_RENDERBUFFER, surface->renderbuffers[1]);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+      EXGLSysLog("EXGL: Couldn't create a %dx%d framebuffer for a headless context!", width, height);
+    }
+    // The initial viewport is the size of the pbuffer the context was first made
+    // current with
+    glViewport(0, 0, width, height);
+
+    if (auto exglCtx = EXGLContext::ContextGet(exglCtxId)) {
+      exglCtx->setDefaultFramebuffer(surface->framebuffer);
+    }
+  });
+
+  exglCtx->flushOnGLThread = [=] {
+    if (surface->flushPending.exchange(true)) {
+      return;
+    }
+    worker->post([=] {
+      // Cleared first: batches sent while flushing need another flush
+      surface->flushPending = false;
+      if (auto exglCtx = EXGLContext::ContextGet(exglCtxId)) {
+        makeCurrent(*worker, surface->context);
+        exglCtx->flush();
+      }
+    });
+  };
+  return true;
+}
+
+void EXGLRenderPool::detach(UEXGLContextId exglCtxId) {
+  std::shared_ptr<Surface> surface;
+  {
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    auto iter = surfaces.find(exglCtxId);
+    if (iter == surfaces.end()) {
+      return;
+    }
+    surface = iter->second;
+    surfaces.erase(iter);
+    --surface->worker->contextCount;
+  }
+
+  Worker *worker = surface->worker;
+  worker->post([=] {
+    makeCurrent(*worker, surface->context);
+    if (auto exglCtx = EXGLContext::ContextGet(exglCtxId)) {
+      exglCtx->flush();
+    }
+    glDeleteFramebuffers(1, &surface->framebuffer);
+    glDeleteRenderbuffers(2, surface->renderbuffers);
+    makeCurrent(*worker, GLContextRef {});
+    EXGLContext::ContextDestroy(exglCtxId);
+#ifdef __ANDROID__
+    eglDestroyContext(display, surface->context);
+#endif
+#ifdef __APPLE__
+    surface->context = nil;
+#endif
+  });
+}
@@ -0,0 +1,118 @@
+#ifndef __EXGLRENDERPOOL_H__
+#define __EXGLRENDERPOOL_H__
+
+#ifdef __ANDROID__
+#include <EGL/egl.h>
+#include <GLES3/gl3.h>
+#endif
+#ifdef __APPLE__
+#include <OpenGLES/ES3/gl.h>
+#include <OpenGLES/EAGL.h>
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "UEXGL.h"
+
+
+// --- EXGLRenderPool ----------------------------------------------------------
+
+// Small pool of GL threads for headless contexts, so that independent offscreen
+// jobs (thumbnails, filters...) render in parallel instead of queueing on one GL
+// thread. Every headless context gets its own GL context, so their GL state
+// stays separate, and they're all in one share group: textures and buffers
+// created by one of them can be used by another through `UEXGLContextGetObject`.
+//
+// An attached EXGL context is pinned to one thread for its whole life, which
+// keeps the one-GL-thread-per-context assumption of EXGLContext: its
+// `flushOnGLThread` posts a flush to that thread and its default framebuffer is
+// an FBO of the requested size created there. Contexts go to the thread with the
+// fewest of them.
+
+class EXGLRenderPool {
+public:
+  static EXGLRenderPool &shared();
+
+  // [Any thread] Number of GL threads, only has effect before the first attach.
+  // 0 picks one from the number of cores.
+  void setThreadCount(unsigned int count) noexcept;
+
+  // [JS thread] Render an EXGL context without a view into a `width`x`height`
+  // framebuffer on one of the pool's threads. Returns false if no GL context
+  // could be created for it.
+  bool attach(UEXGLContextId exglCtxId, GLsizei width, GLsizei height);
+
+  // [Any thread] Run the context's remaining work, then release its framebuffer
+  // and GL context and destroy it on its GL thread
+  void detach(UEXGLContextId exglCtxId);
+
+private:
+  EXGLRenderPool() = default;
+
+#ifdef __ANDROID__
+  using GLContextRef = EGLContext;
+#endif
+#ifdef __APPLE__
+  using GLContextRef = EAGLContext *;
+#endif
+
+  struct Worker {
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void(void)>> jobs;
+    size_t contextCount = 0; // guarded by the pool's mutex
+
+    // [Worker thread]
+    GLContextRef current {};
+#ifdef __ANDROID__
+    // Only there to make contexts current, rendering goes to framebuffers
+    EGLSurface pbuffer = EGL_NO_SURFACE;
+#endif
+
+    // [Any thread] Queue a job for the worker's thread
+    void post(std::function<void(void)> job);
+    void run();
+  };
+
+  struct Surface {
+    Worker *worker = nullptr;
+    GLContextRef context {};
+    GLuint framebuffer = 0;
+    GLuint renderbuffers[2] = { 0, 0 }; // color, depth + stencil
+    // Set while a flush is queued, so repeated `flushOnGLThread` calls between
+    // two flushes don't pile up jobs
+    std::atomic<bool> flushPending { false };
+  };
+
+  // [pool mutex held] Set up the share group and start the threads
+  void start();
+
+  // [Any thread] GL context in the pool's share group
+  GLContextRef createGLContext();
+
+  // [Worker thread] Make `context` current on `worker`'s thread, or none
+  void makeCurrent(Worker &worker, GLContextRef context);
+
+  std::mutex mutex;
+  unsigned int threadCount = 0;
+  bool started = false;
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::unordered_map<UEXGLContextId, std::shared_ptr<Surface>> surfaces;
+
+  // Never current, only anchors the share group
+  GLContextRef shareContext {};
+#ifdef __ANDROID__
+  EGLDisplay display = EGL_NO_DISPLAY;
+  EGLConfig config = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,453 @@
+#ifndef __EXGLRESIDENCY_H__
+#define __EXGLRESIDENCY_H__
+
+#ifdef __ANDROID__
+#include <GLES3/gl3.h>
+#endif
+#ifdef __APPLE__
+#include <OpenGLES/ES3/gl.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "UEXGL.h"
+
+
+// --- EXGLResidency -----------------------------------------------------------
+
+// [JS thread] Estimate of the GPU memory held by the buffers, textures and
+// renderbuffers of a context, from the sizes passed to `bufferData`,
+// `texImage*`, `texStorage*`, `renderbufferStorage`... Drivers pad and compress
+// behind our back so it's a lower bound, but it's tracked per object which is
+// what's needed to decide what to drop.
+//
+// Allocations apply to the object bound to the target they're made through, so
+// the bindings are tracked too, always (unlike EXGLShadowState which can be
+// turned off). Binding an object marks it as used, objects not used for the
+// longest time come first in `evictionCandidates()`. Since every binding starts
+// out null and only changes through the WebGL API, they're exact and answer the
+// binding queries of `getParameter` without a round trip to the GL thread.
+
+class EXGLResidency {
+public:
+  enum Kind {
+    Buffer,
+    Texture,
+    Renderbuffer,
+    KindCount,
+  };
+
+  // Bytes budgeted for all kinds together, 0 for no budget
+  size_t budget = 0;
+
+  // --- Bindings --------------------------------------------------------------
+
+  inline void activeTexture(GLenum unit) noexcept {
+    activeUnit = (size_t) (unit - GL_TEXTURE0);
+  }
+
+  inline void bindBuffer(GLenum target, UEXGLObjectId exglObjId) noexcept {
+    if (UEXGLObjectId *slot = bufferSlot(target)) {
+      *slot = exglObjId;
+    }
+    touch(exglObjId);
+  }
+
+  inline void bindVertexArray(UEXGLObjectId exglObjId) noexcept {
+    vertexArray = exglObjId;
+  }
+
+  inline void bindTexture(GLenum target, UEXGLObjectId exglObjId) noexcept {
+    if (UEXGLObjectId *slot = textureSlot(target)) {
+      *slot = exglObjId;
+    }
+    touch(exglObjId);
+  }
+
+  inline void bindRenderbuffer(UEXGLObjectId exglObjId) noexcept {
+    renderbuffer = exglObjId;
+    touch(exglObjId);
+  }
+
+  // 0 for the default framebuffer
+  inline void bindFramebuffer(GLenum target, UEXGLObjectId exglObjId) noexcept {
+    if (target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER) {
+      drawFramebuffer = exglObjId;
+    }
+    if (target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER) {
+      readFramebuffer = exglObjId;
+    }
+  }
+
+  inline void bindSampler(GLuint unit, UEXGLObjectId exglObjId) noexcept {
+    if (unit < samplers.size()) {
+      samplers[unit] = exglObjId;
+    }
+  }
+
+  inline void bindTransformFeedback(UEXGLObjectId exglObjId) noexcept {
+    transformFeedback = exglObjId;
+  }
+
+  inline void useProgram(UEXGLObjectId exglObjId) noexcept {
+    program = exglObjId;
+  }
+
+  inline UEXGLObjectId boundTexture(GLenum target) noexcept {
+    UEXGLObjectId *slot = textureSlot(target);
+    return slot ? *slot : 0;
+  }
+
+  inline UEXGLObjectId boundBuffer(GLenum target) noexcept {
+    UEXGLObjectId *slot = bufferSlot(target);
+    return slot ? *slot : 0;
+  }
+
+  // Object bound for a binding query (`ARRAY_BUFFER_BINDING`,
+  // `TEXTURE_BINDING_2D`, `SAMPLER_BINDING`...), returns false if `pname`
+  // isn't one
+  inline bool binding(GLenum pname, UEXGLObjectId *out) noexcept {
+    UEXGLObjectId *slot = nullptr;
+    switch (pname) {
+      case GL_ARRAY_BUFFER_BINDING: slot = bufferSlot(GL_ARRAY_BUFFER); break;
+      case GL_ELEMENT_ARRAY_BUFFER_BINDING: slot = bufferSlot(GL_ELEMENT_ARRAY_BUFFER); break;
+      case GL_COPY_READ_BUFFER_BINDING: slot = bufferSlot(GL_COPY_READ_BUFFER); break;
+      case GL_COPY_WRITE_BUFFER_BINDING: slot = bufferSlot(GL_COPY_WRITE_BUFFER); break;
+      case GL_PIXEL_PACK_BUFFER_BINDING: slot = bufferSlot(GL_PIXEL_PACK_BUFFER); break;
+      case GL_PIXEL_UNPACK_BUFFER_BINDING: slot = bufferSlot(GL_PIXEL_UNPACK_BUFFER); break;
+      case GL_TRANSFORM_FEEDBACK_BUFFER_BINDING: slot = bufferSlot(GL_TRANSFORM_FEEDBACK_BUFFER); break;
+      case GL_UNIFORM_BUFFER_BINDING: slot = bufferSlot(GL_UNIFORM_BUFFER); break;
+      case GL_TEXTURE_BINDING_2D: slot = textureSlot(GL_TEXTURE_2D); break;
+      case GL_TEXTURE_BINDING_CUBE_MAP: slot = textureSlot(GL_TEXTURE_CUBE_MAP); break;
+      case GL_TEXTURE_BINDING_3D: slot = textureSlot(GL_TEXTURE_3D); break;
+      case GL_TEXTURE_BINDING_2D_ARRAY: slot = textureSlot(GL_TEXTURE_2D_ARRAY); break;
+      case GL_SAMPLER_BINDING: slot = activeUnit < samplers.size() ? &samplers[activeUnit] : nullptr; break;
+      case GL_VERTEX_ARRAY_BINDING: slot = &vertexArray; break;
+      case GL_RENDERBUFFER_BINDING: slot = &renderbuffer; break;
+      case GL_DRAW_FRAMEBUFFER_BINDING: slot = &drawFramebuffer; break;
+      case GL_READ_FRAMEBUFFER_BINDING: slot = &readFramebuffer; break;
+      case GL_TRANSFORM_FEEDBACK_BINDING: slot = &transformFeedback; break;
+      case GL_CURRENT_PROGRAM: slot = &program; break;
+      default: return false;
+    }
+    *out = slot ? *slot : 0;
+    return true;
+  }
+
+  // --- Allocations -----------------------------------------------------------
+
+  // `bufferData` on the buffer bound to `target`
+  inline void bufferStorage(GLenum target, size_t bytes) noexcept {
+    UEXGLObjectId *slot = bufferSlot(target);
+    if (slot && *slot) {
+      setImage(*slot, Buffer, 0, bytes);
+    }
+  }
+
+  // `texImage2D` and friends: one level of one face of `texture`
+  inline void textureImage(UEXGLObjectId texture, GLenum target, GLint level, size_t bytes) noexcept {
+    if (texture) {
+      setImage(texture, Texture, imageKey(target, level), bytes);
+    }
+  }
+
+  inline void textureImage(GLenum target, GLint level, size_t bytes) noexcept {
+    textureImage(boundTexture(target), target, level, bytes);
+  }
+
+  // `texStorage2D/3D`: the whole immutable mip chain at once
+  inline void textureStorage(GLenum target, GLsizei levels, GLsizei width, GLsizei height,
+                             GLsizei depth, size_t bytesPerTexel) noexcept {
+    UEXGLObjectId texture = boundTexture(target);
+    if (!texture) {
+      return;
+    }
+    size_t bytes = 0;
+    size_t faces = target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+    for (GLsizei level = 0; level < levels; ++level) {
+      size_t w = std::max(1, width >> level);
+      size_t h = std::max(1, height >> level);
+      // Array layers don't shrink
+      size_t d = target == GL_TEXTURE_3D ? std::max(1, depth >> level) : std::max(1, depth);
+      bytes += w * h * d * faces * bytesPerTexel;
+    }
+    // Replaces whatever the texture had
+    Resource &resource = resourceFor(texture, Texture);
+    kindBytes[Texture] -= resource.bytes;
+    resource.bytes = 0;
+    resource.images.clear();
+    setImage(texture, Texture, 0, bytes);
+  }
+
+  // `generateMipmap`: the levels below 0 add up to a third of it
+  inline void textureMipmaps(GLenum target) noexcept {
+    UEXGLObjectId texture = boundTexture(target);
+    auto iter = resources.find(texture);
+    if (iter == resources.end()) {
+      return;
+    }
+    size_t baseBytes = 0;
+    for (const auto &image : iter->second.images) {
+      if ((image.first & 0xFFFF) == 0) {
+        baseBytes += image.second;
+      }
+    }
+    setImage(texture, Texture, mipmapKey, baseBytes / 3);
+  }
+
+  // `renderbufferStorage` on the bound renderbuffer
+  inline void renderbufferStorage(size_t bytes) noexcept {
+    if (renderbuffer) {
+      setImage(renderbuffer, Renderbuffer, 0, bytes);
+    }
+  }
+
+  // The object got deleted
+  inline void forget(UEXGLObjectId exglObjId) noexcept {
+    auto iter = resources.find(exglObjId);
+    if (iter != resources.end()) {
+      kindBytes[iter->second.kind] -= iter->second.bytes;
+      lru.erase(iter->second.lruEntry);
+      resources.erase(iter);
+    }
+    if (exglObjId == 0) {
+      return;
+    }
+    // GL unbinds deleted objects from the context, a program stays in use until
+    // another one replaces it
+    elementArrayBuffers.erase(exglObjId);
+    auto unbind = [exglObjId](UEXGLObjectId &slot) {
+      if (slot == exglObjId) {
+        slot = 0;
+      }
+    };
+    unbind(vertexArray);
+    unbind(elementArrayBuffers[vertexArray]);
+    unbind(renderbuffer);
+    unbind(drawFramebuffer);
+    unbind(readFramebuffer);
+    unbind(transformFeedback);
+    std::for_each(buffers.begin(), buffers.end(), unbind);
+    std::for_each(samplers.begin(), samplers.end(), unbind);
+    for (auto &unit : textures) {
+      std::for_each(unit.begin(), unit.end(), unbind);
+    }
+  }
+
+  // Everything is gone (context lost)
+  inline void clear() noexcept {
+    resources.clear();
+    lru.clear();
+    kindBytes.fill(0);
+  }
+
+  // --- Totals and eviction ---------------------------------------------------
+
+  inline size_t bytes(Kind kind) const noexcept {
+    return kindBytes[kind];
+  }
+
+  inline size_t totalBytes() const noexcept {
+    return kindBytes[Buffer] + kindBytes[Texture] + kindBytes[Renderbuffer];
+  }
+
+  inline bool overBudget() const noexcept {
+    return budget != 0 && totalBytes() > budget;
+  }
+
+  // Least recently used objects first, just enough of them to get back under
+  // the budget. Objects used during the current frame aren't candidates.
+  std::vector<UEXGLObjectId> evictionCandidates() const {
+    std::vector<UEXGLObjectId> candidates;
+    size_t total = totalBytes();
+    for (auto iter = lru.rbegin(); iter != lru.rend() && total > budget; ++iter) {
+      const Resource &resource = resources.at(*iter);
+      if (resource.lastUsedFrame == frame || resource.bytes == 0) {
+        continue;
+      }
+      candidates.push_back(*iter);
+      total -= resource.bytes;
+    }
+    return candidates;
+  }
+
+  inline void endFrame() noexcept {
+    ++frame;
+  }
+
+  // --- Sizes -----------------------------------------------------------------
+
+  // Bytes per texel of a texture or renderbuffer of `internalformat`, unsized
+  // formats are sized from `format` and `type` like WebGL 1 uploads. 0 if
+  // unknown.
+  static size_t bytesPerTexel(GLenum internalformat, GLenum format, GLenum type) noexcept {
+    switch (internalformat) {
+      case GL_R8: case GL_R8I: case GL_R8UI: case GL_R8_SNORM: case GL_STENCIL_INDEX8:
+        return 1;
+      case GL_RG8: case GL_RG8I: case GL_RG8UI: case GL_RG8_SNORM:
+      case GL_R16F: case GL_R16I: case GL_R16UI:
+      case GL_RGB565: case GL_RGBA4: case GL_RGB5_A1: case GL_DEPTH_COMPONENT16:
+        return 2;
+      case GL_RGB8: case GL_SRGB8: case GL_RGB8I: case GL_RGB8UI: case GL_RGB8_SNORM:
+        return 3;
+      case GL_RGBA8: case GL_SRGB8_ALPHA8: case GL_RGBA8I: case GL_RGBA8UI: case GL_RGBA8_SNORM:
+      case GL_RGB10_A2: case GL_RGB10_A2UI: case GL_R11F_G11F_B10F: case GL_RGB9_E5:
+      case GL_RG16F: case GL_RG16I: case GL_RG16UI:
+      case GL_R32F: case GL_R32I: case GL_R32UI:
+      case GL_DEPTH_COMPONENT24: case GL_DEPTH24_STENCIL8: case GL_DEPTH_COMPONENT32F:
+        return 4;
+      case GL_RGB16F: case GL_RGB16I: case GL_RGB16UI:
+        return 6;
+      case GL_RGBA16F: case GL_RGBA16I: case GL_RGBA16UI:
+      case GL_RG32F: case GL_RG32I: case GL_RG32UI: case GL_DEPTH32F_STENCIL8:
+        return 8;
+      case GL_RGB32F: case GL_RGB32I: case GL_RGB32UI:
+        return 12;
+      case GL_RGBA32F: case GL_RGBA32I: case GL_RGBA32UI:
+        return 16;
+    }
+
+    size_t components = 0;
+    switch (format) {
+      case GL_ALPHA: case GL_LUMINANCE: case GL_RED: case GL_RED_INTEGER:
+      case GL_DEPTH_COMPONENT:
+        components = 1;
+        break;
+      case GL_LUMINANCE_ALPHA: case GL_RG: case GL_RG_INTEGER: case GL_DEPTH_STENCIL:
+        components = 2;
+        break;
+      case GL_RGB: case GL_RGB_INTEGER:
+        components = 3;
+        break;
+      case GL_RGBA: case GL_RGBA_INTEGER:
+        components = 4;
+        break;
+    }
+    switch (type) {
+      case GL_UNSIGNED_BYTE: case GL_BYTE:
+        return components;
+      case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT:
+        return components * 2;
+      case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT:
+        return components * 4;
+      case GL_UNSIGNED_SHORT_5_6_5: case GL_UNSIGNED_SHORT_4_4_4_4: case GL_UNSIGNED_SHORT_5_5_5_1:
+        return 2;
+      case GL_UNSIGNED_INT_24_8: case GL_UNSIGNED_INT_2_10_10_10_REV:
+      case GL_UNSIGNED_INT_10F_11F_11F_REV: case GL_UNSIGNED_INT_5_9_9_9_REV:
+        return 4;
+      case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+        return 8;
+    }
+    return 0;
+  }
+
+private:
+  struct Resource {
+    Kind kind;
+    size_t bytes = 0;
+    // Bytes of each (face, level) image, see `imageKey`
+    std::unordered_map<uint32_t, size_t> images;
+    std::list<UEXGLObjectId>::iterator lruEntry;
+    uint64_t lastUsedFrame = 0;
+  };
+
+  static constexpr uint32_t mipmapKey = 0xFFFFFFFF;
+
+  static inline uint32_t imageKey(GLenum target, GLint level) noexcept {
+    uint32_t face = 0;
+    if (target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z) {
+      face = target - GL_TEXTURE_CUBE_MAP_POSITIVE_X;
+    }
+    return (face << 16) | ((uint32_t) level & 0xFFFF);
+  }
+
+  inline Resource &resourceFor(UEXGLObjectId exglObjId, Kind kind) {
+    auto iter = resources.find(exglObjId);
+    if (iter != resources.end()) {
+      return iter->second;
+    }
+    Resource &resource = resources[exglObjId];
+    resource.kind = kind;
+    lru.push_front(exglObjId);
+    resource.lruEntry = lru.begin();
+    resource.lastUsedFrame = frame;
+    return resource;
+  }
+
+  inline void setImage(UEXGLObjectId exglObjId, Kind kind, uint32_t key, size_t bytes) {
+    Resource &resource = resourceFor(exglObjId, kind);
+    size_t &image = resource.images[key];
+    resource.bytes += bytes - image;
+    kindBytes[kind] += bytes - image;
+    image = bytes;
+  }
+
+  inline void touch(UEXGLObjectId exglObjId) noexcept {
+    if (exglObjId == 0 || (!lru.empty() && lru.front() == exglObjId)) {
+      return;
+    }
+    auto iter = resources.find(exglObjId);
+    if (iter != resources.end()) {
+      lru.splice(lru.begin(), lru, iter->second.lruEntry);
+      iter->second.lastUsedFrame = frame;
+    }
+  }
+
+  inline UEXGLObjectId *bufferSlot(GLenum target) noexcept {
+    switch (target) {
+      case GL_ARRAY_BUFFER: return &buffers[0];
+      // Part of the vertex array state
+      case GL_ELEMENT_ARRAY_BUFFER: return &elementArrayBuffers[vertexArray];
+      case GL_COPY_READ_BUFFER: return &buffers[1];
+      case GL_COPY_WRITE_BUFFER: return &buffers[2];
+      case GL_PIXEL_PACK_BUFFER: return &buffers[3];
+      case GL_PIXEL_UNPACK_BUFFER: return &buffers[4];
+      case GL_TRANSFORM_FEEDBACK_BUFFER: return &buffers[5];
+      case GL_UNIFORM_BUFFER: return &buffers[6];
+      default: return nullptr;
+    }
+  }
+
+  inline UEXGLObjectId *textureSlot(GLenum target) noexcept {
+    if (activeUnit >= textures.size()) {
+      return nullptr;
+    }
+    if (target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z) {
+      target = GL_TEXTURE_CUBE_MAP;
+    }
+    switch (target) {
+      case GL_TEXTURE_2D: return &textures[activeUnit][0];
+      case GL_TEXTURE_CUBE_MAP: return &textures[activeUnit][1];
+      case GL_TEXTURE_3D: return &textures[activeUnit][2];
+      case GL_TEXTURE_2D_ARRAY: return &textures[activeUnit][3];
+      default: return nullptr;
+    }
+  }
+
+  std::unordered_map<UEXGLObjectId, Resource> resources;
+  // Most recently used first
+  std::list<UEXGLObjectId> lru;
+  std::array<size_t, KindCount> kindBytes {};
+  uint64_t frame = 1;
+
+  size_t activeUnit = 0;
+  std::array<std::array<UEXGLObjectId, 4>, 32> textures {};
+  std::array<UEXGLObjectId, 7> buffers {};
+  // Element array buffer of each vertex array, 0 being the default one
+  std::unordered_map<UEXGLObjectId, UEXGLObjectId> elementArrayBuffers;
+  UEXGLObjectId vertexArray = 0;
+  UEXGLObjectId renderbuffer = 0;
+  std::array<UEXGLObjectId, 32> samplers {};
+  UEXGLObjectId drawFramebuffer = 0;
+  UEXGLObjectId readFramebuffer = 0;
+  UEXGLObjectId transformFeedback = 0;
+  UEXGLObjectId program = 0;
+};
+
+#endif
@@ -0,0 +1,215 @@
+#ifndef __EXGLSHADOWSTATE_H__
+#define __EXGLSHADOWSTATE_H__
+
+#ifdef __ANDROID__
+#include <GLES3/gl3.h>
+#endif
+#ifdef __APPLE__
+#include <OpenGLES/ES3/gl.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+
+#include "UEXGL.h"
+
+
+// --- EXGLShadowState ---------------------------------------------------------
+
+// [JS thread] Shadow copy of the GL state set through the WebGL API. When it's
+// enabled, state changes that wouldn't change anything are dropped before they
+// get into a batch and some queries (`isEnabled`, `getParameter`) can be answered
+// without a round trip to the GL thread.
+//
+// Every slot starts out unknown and only becomes known once JS sets it, so the
+// shadow never has to guess the initial GL state. It only tracks state changed
+// through the WebGL API: native code touching the same GL state behind EXGL's
+// back should `invalidate()` it.
+
+class EXGLShadowState {
+public:
+  enum Slot {
+    Viewport,
+    Scissor,
+    BlendColor,
+    BlendEquation,
+    BlendFunc,
+    ClearColor,
+    ClearDepth,
+    ClearStencil,
+    ColorMask,
+    CullFace,
+    DepthFunc,
+    DepthMask,
+    DepthRange,
+    FrontFace,
+    LineWidth,
+    PolygonOffset,
+    ActiveTexture,
+    Program,
+    ArrayBuffer,
+    ElementArrayBuffer,
+    VertexArray,
+    SlotCount,
+  };
+
+  static constexpr size_t maxTextureUnits = 32;
+
+  bool enabled = false;
+
+  EXGLShadowState() {
+    invalidate();
+  }
+
+  inline void invalidate() noexcept {
+    std::fill(std::begin(known), std::end(known), false);
+    std::fill(std::begin(capabilityKnown), std::end(capabilityKnown), false);
+    for (auto &unit : textures) {
+      for (auto &texture : unit) {
+        texture = unknownObject;
+      }
+    }
+  }
+
+  // Record new values for `slot`, returns whether the GL call has to be made
+  inline bool update(Slot slot, const double *newValues, size_t count) noexcept {
+    if (!enabled) {
+      return true;
+    }
+    auto &slotValues = values[slot];
+    count = std::min(count, (size_t) 4);
+    if (known[slot] && std::equal(newValues, newValues + count, slotValues)) {
+      return false;
+    }
+    std::copy(newValues, newValues + count, slotValues);
+    known[slot] = true;
+    if (slot == VertexArray) {
+      // The element array buffer binding is part of the vertex array state
+      known[ElementArrayBuffer] = false;
+    }
+    return true;
+  }
+
+  // Get the recorded values of `slot`, returns false if they aren't known
+  inline bool get(Slot slot, double *out, size_t count) const noexcept {
+    if (!enabled || !known[slot]) {
+      return false;
+    }
+    std::copy(values[slot], values[slot] + std::min(count, (size_t) 4), out);
+    return true;
+  }
+
+  // Record a capability change, returns whether the GL call has to be made
+  inline bool updateCapability(GLenum cap, bool value) noexcept {
+    int index = capabilityIndex(cap);
+    if (!enabled || index < 0) {
+      return true;
+    }
+    if (capabilityKnown[index] && capabilities[index] == value) {
+      return false;
+    }
+    capabilities[index] = value;
+    capabilityKnown[index] = true;
+    return true;
+  }
+
+  // Returns 0 or 1 for a known capability, -1 otherwise
+  inline int getCapability(GLenum cap) const noexcept {
+    int index = capabilityIndex(cap);
+    if (!enabled || index < 0 || !capabilityKnown[index]) {
+      return -1;
+    }
+    return capabilities[index] ? 1 : 0;
+  }
+
+  // Record a texture binding on the active unit, returns whether the GL call has
+  // to be made
+  inline bool updateTexture(GLenum target, UEXGLObjectId texture) noexcept {
+    UEXGLObjectId *slot = textureSlot(target);
+    if (!slot) {
+      return true;
+    }
+    if (*slot == texture) {
+      return false;
+    }
+    *slot = texture;
+    return true;
+  }
+
+  inline bool getTexture(GLenum target, UEXGLObjectId *out) const noexcept {
+    const UEXGLObjectId *slot = const_cast<EXGLShadowState *>(this)->textureSlot(target);
+    if (!slot || *slot == unknownObject) {
+      return false;
+    }
+    *out = *slot;
+    return true;
+  }
+
+  // An object got deleted, GL unbinds it wherever it's bound in the context
+  inline void forgetObject(UEXGLObjectId exglObjId) noexcept {
+    if (known[VertexArray] && values[VertexArray][0] == exglObjId) {
+      // Falls back to the default vertex array and its element array buffer
+      known[ElementArrayBuffer] = false;
+    }
+    for (Slot slot : { Program, ArrayBuffer, ElementArrayBuffer, VertexArray }) {
+      if (known[slot] && values[slot][0] == exglObjId) {
+        known[slot] = false;
+      }
+    }
+    for (auto &unit : textures) {
+      for (auto &texture : unit) {
+        if (texture == exglObjId) {
+          texture = unknownObject;
+        }
+      }
+    }
+  }
+
+private:
+  static constexpr UEXGLObjectId unknownObject = (UEXGLObjectId) -1;
+
+  static inline int capabilityIndex(GLenum cap) noexcept {
+    switch (cap) {
+      case GL_BLEND: return 0;
+      case GL_CULL_FACE: return 1;
+      case GL_DEPTH_TEST: return 2;
+      case GL_DITHER: return 3;
+      case GL_POLYGON_OFFSET_FILL: return 4;
+      case GL_SAMPLE_ALPHA_TO_COVERAGE: return 5;
+      case GL_SAMPLE_COVERAGE: return 6;
+      case GL_SCISSOR_TEST: return 7;
+      case GL_STENCIL_TEST: return 8;
+      case GL_RASTERIZER_DISCARD: return 9;
+      default: return -1;
+    }
+  }
+
+  inline UEXGLObjectId *textureSlot(GLenum target) noexcept {
+    if (!enabled || !known[ActiveTexture]) {
+      return nullptr;
+    }
+    size_t unit = (size_t) values[ActiveTexture][0] - GL_TEXTURE0;
+    if (unit >= maxTextureUnits) {
+      return nullptr;
+    }
+    switch (target) {
+      case GL_TEXTURE_2D: return &textures[unit][0];
+      case GL_TEXTURE_CUBE_MAP: return &textures[unit][1];
+      case GL_TEXTURE_3D: return &textures[unit][2];
+      case GL_TEXTURE_2D_ARRAY: return &textures[unit][3];
+      default: return nullptr;
+    }
+  }
+
+  bool known[SlotCount] = {};
+  double values[SlotCount][4] = {};
+
+  static constexpr size_t capabilityCount = 10;
+  bool capabilityKnown[capabilityCount] = {};
+  bool capabilities[capabilityCount] = {};
+
+  UEXGLObjectId textures[maxTextureUnits][4];
+};
+
+#endif
@@ -0,0 +1,46 @@
+#include "EXGLSnapshot.h"
+
+#include <cstdlib>
+#include <thread>
+
+#include "EXGLPixelKernels.h"
+#include "EXGLSystrace.h"
+
+EXGLSnapshotQueue &EXGLSnapshotQueue::shared() {
+  // Never destroyed: the worker lives as long as the process
+  static auto queue = new EXGLSnapshotQueue();
+  return *queue;
+}
+
+EXGLSnapshotQueue::EXGLSnapshotQueue() {
+  std::thread(&EXGLSnapshotQueue::workerLoop, this).detach();
+}
+
+void EXGLSnapshotQueue::encode(void *pixels, GLsizei width, GLsizei height,
+                               UEXGLSnapshotEncoder encode) {
+  {
+    std::lock_guard<decltype(queueMutex)> lock(queueMutex);
+    queue.push_back(Job { pixels, width, height, std::move(encode) });
+  }
+  queueCondition.notify_one();
+}
+
+void EXGLSnapshotQueue::workerLoop() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<decltype(queueMutex)> lock(queueMutex);
+      queueCondition.wait(lock, [this] { return !queue.empty(); });
+      job = std::move(queue.front());
+      queue.pop_front();
+    }
+    EXGLSystraceSection section("EXGL encode snapshot");
+    if (!job.pixels) {
+      job.encode(nullptr, 0, 0);
+      continue;
+    }
+    EXGLFlipRows(job.pixels, (size_t) job.width * 4, job.height);
+    job.encode(job.pixels, job.width, job.height);
+    free(job.pixels);
+  }
+}
@@ -0,0 +1,47 @@
+#ifndef __EXGLSNAPSHOT_H__
+#define __EXGLSNAPSHOT_H__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include "UEXGL.h"
+
+
+// --- EXGLSnapshotQueue -------------------------------------------------------
+
+// Background thread finishing the snapshots taken with
+// `UEXGLContextTakeSnapshot`. The GL thread only reads the framebuffer into a
+// pixel pack buffer and copies the pixels out once its fence is signaled; rows
+// are flipped top-down here and the platform's PNG/JPEG encoder runs here, so
+// encoding a full resolution frame never holds up rendering. One thread serves
+// every context and runs snapshots in the order they completed.
+
+class EXGLSnapshotQueue {
+public:
+  static EXGLSnapshotQueue &shared();
+
+  // [Any thread] Flip the `height` RGBA8 rows of `pixels` as read by GL
+  // (bottom-up), then pass them to `encode` on the queue's thread. Takes
+  // ownership of `pixels` (malloc'd), which is null if the readback failed.
+  void encode(void *pixels, GLsizei width, GLsizei height, UEXGLSnapshotEncoder encode);
+
+private:
+  EXGLSnapshotQueue();
+
+  struct Job {
+    void *pixels;
+    GLsizei width;
+    GLsizei height;
+    UEXGLSnapshotEncoder encode;
+  };
+
+  void workerLoop();
+
+  std::mutex queueMutex;
+  std::condition_variable queueCondition;
+  std::deque<Job> queue;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef __EXGLSTAGINGARENA_H__
+#define __EXGLSTAGINGARENA_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+// --- EXGLStagingArena --------------------------------------------------------
+
+// [JS thread] Ring of large blocks holding the copies of TypedArrays that ops
+// take for the GL thread. Payloads are carved out of the current block with a
+// bump pointer and share its reference count (aliasing `shared_ptr`), so there
+// is no malloc, free or control block per payload and the GL thread never
+// touches the allocator when a batch is cleared.
+//
+// A block is recycled once every payload in it has been released, which for
+// ops that only live as long as their batch is right after the `flush()` that
+// ran them. Payloads that are kept longer just pin their block. Allocations
+// return nullptr when they're too large for a block or when the ring is full
+// of pinned blocks, the caller falls back to malloc then.
+
+class EXGLStagingArena {
+public:
+  static constexpr size_t blockSize = 1 << 20;
+  static constexpr size_t maxBlocks = 8;
+  // Payloads above this would waste too much of a block
+  static constexpr size_t maxPayloadSize = blockSize / 4;
+  static constexpr size_t alignment = 16;
+
+  inline std::shared_ptr<void> allocate(size_t byteLength) {
+    if (byteLength == 0 || byteLength > maxPayloadSize) {
+      return nullptr;
+    }
+    size_t alignedLength = (byteLength + alignment - 1) & ~(alignment - 1);
+
+    if (!blocks.empty()) {
+      Block &block = *blocks[current];
+      if (isFree(blocks[current])) {
+        // Everything carved out of it already ran
+        block.used = 0;
+      }
+      if (block.used + alignedLength <= blockSize) {
+        return carve(blocks[current], alignedLength);
+      }
+    }
+
+    // Move on to the next free block in the ring, or grow it
+    for (size_t i = 1; i <= blocks.size(); ++i) {
+      size_t index = (current + i) % blocks.size();
+      if (isFree(blocks[index])) {
+        current = index;
+        blocks[index]->used = 0;
+        return carve(blocks[index], alignedLength);
+      }
+    }
+    if (blocks.size() == maxBlocks) {
+      return nullptr;
+    }
+    blocks.push_back(std::make_shared<Block>());
+    current = blocks.size() - 1;
+    return carve(blocks[current], alignedLength);
+  }
+
+private:
+  struct Block {
+    std::unique_ptr<uint8_t[]> data { new uint8_t[blockSize] };
+    size_t used = 0;
+  };
+
+  inline bool isFree(const std::shared_ptr<Block> &block) const noexcept {
+    if (block.use_count() != 1) {
+      return false;
+    }
+    // Pairs with the release of the last payload on the GL thread, its reads
+    // have to be done before the block is written again
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+  }
+
+  inline std::shared_ptr<void> carve(const std::shared_ptr<Block> &block, size_t alignedLength) {
+    void *payload = block->data.get() + block->used;
+    block->used += alignedLength;
+    return std::shared_ptr<void>(block, payload);
+  }
+
+  std::vector<std::shared_ptr<Block>> blocks;
+  size_t current = 0;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include "EXGLSystrace.h"
+
+#ifdef __ANDROID__
+#include <dlfcn.h>
+#endif
+#ifdef __APPLE__
+#include <os/log.h>
+#include <os/signpost.h>
+#endif
+
+#ifdef __ANDROID__
+// ATrace is only in the NDK from API 23, it's looked up for older targets
+struct EXGLATrace {
+  bool (*isEnabled)(void) = nullptr;
+  void (*beginSection)(const char *) = nullptr;
+  void (*endSection)(void) = nullptr;
+
+  EXGLATrace() {
+    void *library = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+    if (!library) {
+      return;
+    }
+    isEnabled = (bool (*)(void)) dlsym(library, "ATrace_isEnabled");
+    beginSection = (void (*)(const char *)) dlsym(library, "ATrace_beginSection");
+    endSection = (void (*)(void)) dlsym(library, "ATrace_endSection");
+    if (!isEnabled || !beginSection || !endSection) {
+      isEnabled = nullptr;
+    }
+  }
+};
+
+static const EXGLATrace &EXGLATraceShared() {
+  static EXGLATrace atrace;
+  return atrace;
+}
+
+static uint64_t EXGLSystraceDefaultBegin(const char *name) {
+  const EXGLATrace &atrace = EXGLATraceShared();
+  if (!atrace.isEnabled || !atrace.isEnabled()) {
+    return 0;
+  }
+  atrace.beginSection(name);
+  return 1;
+}
+
+static void EXGLSystraceDefaultEnd(uint64_t cookie) {
+  EXGLATraceShared().endSection();
+}
+#elif defined(__APPLE__)
+static os_log_t EXGLSignpostLog() API_AVAILABLE(ios(12.0)) {
+  static os_log_t log = os_log_create("host.exp.exponent.gl", "EXGL");
+  return log;
+}
+
+// os_signpost names have to be literals, the section's name is its message
+static uint64_t EXGLSystraceDefaultBegin(const char *name) {
+  if (__builtin_available(iOS 12.0, *)) {
+    os_log_t log = EXGLSignpostLog();
+    if (!os_signpost_enabled(log)) {
+      return 0;
+    }
+    os_signpost_id_t spid = os_signpost_id_generate(log);
+    os_signpost_interval_begin(log, spid, "EXGL", "%{public}s", name);
+    return spid;
+  }
+  return 0;
+}
+
+static void EXGLSystraceDefaultEnd(uint64_t cookie) {
+  if (__builtin_available(iOS 12.0, *)) {
+    os_signpost_interval_end(EXGLSignpostLog(), (os_signpost_id_t) cookie, "EXGL");
+  }
+}
+#else
+static uint64_t EXGLSystraceDefaultBegin(const char *name) {
+  return 0;
+}
+
+static void EXGLSystraceDefaultEnd(uint64_t cookie) {}
+#endif
+
+static const EXGLSystrace::Hooks EXGLSystraceDefaultHooks { EXGLSystraceDefaultBegin, EXGLSystraceDefaultEnd };
+
+std::atomic<const EXGLSystrace::Hooks *> EXGLSystrace::current { &EXGLSystraceDefaultHooks };
+
+void EXGLSystrace::setHooks(UEXGLTraceBeginHook begin, UEXGLTraceEndHook end) noexcept {
+  if (!begin || !end) {
+    current.store(&EXGLSystraceDefaultHooks, std::memory_order_release);
+    return;
+  }
+  // Never freed, sections in progress may still end with the previous hooks
+  current.store(new Hooks { begin, end }, std::memory_order_release);
+}
@@ -0,0 +1,61 @@
+#ifndef __EXGLSYSTRACE_H__
+#define __EXGLSYSTRACE_H__
+
+#include <atomic>
+#include <cstdint>
+
+#include "UEXGL.h"
+
+
+// --- EXGLSystrace ------------------------------------------------------------
+
+// Trace points around the work that can stall a frame: flushes and the batches
+// they run on the GL thread, calls blocking the JS thread on the GL thread,
+// image decoding and snapshot encoding. They are emitted through the hooks set
+// with `UEXGLSetTraceHooks`, by default as ATrace sections on Android (API 23+)
+// and os_signpost intervals on iOS (12+), so they show up next to the JS
+// thread, systrace sections and Fabric commits in the same profile. When no
+// profiler is recording a section costs an atomic load and a check.
+//
+// Not to be confused with EXGLTrace.h, which records the batches themselves.
+
+class EXGLSystrace {
+public:
+  struct Hooks {
+    UEXGLTraceBeginHook begin;
+    UEXGLTraceEndHook end;
+  };
+
+  // [Any thread] Null hooks restore the platform defaults
+  static void setHooks(UEXGLTraceBeginHook begin, UEXGLTraceEndHook end) noexcept;
+
+  static inline const Hooks *hooks() noexcept {
+    return current.load(std::memory_order_acquire);
+  }
+
+private:
+  static std::atomic<const Hooks *> current;
+};
+
+// Traces the scope it lives in as `name`, which must outlive it
+class EXGLSystraceSection {
+public:
+  explicit inline EXGLSystraceSection(const char *name) noexcept
+      : hooks(EXGLSystrace::hooks()), cookie(hooks->begin(name)) {}
+
+  inline ~EXGLSystraceSection() noexcept {
+    if (cookie != 0) {
+      hooks->end(cookie);
+    }
+  }
+
+  EXGLSystraceSection(const EXGLSystraceSection &) = delete;
+  EXGLSystraceSection &operator=(const EXGLSystraceSection &) = delete;
+
+private:
+  // A section always ends with the hooks it began with
+  const EXGLSystrace::Hooks *hooks;
+  uint64_t cookie;
+};
+
+#endif
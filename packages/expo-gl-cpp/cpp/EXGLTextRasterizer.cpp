@@ -0,0 +1,64 @@
+#include "EXGLTextRasterizer.h"
+
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+
+#include "EXGLSystrace.h"
+
+namespace {
+
+std::mutex rasterizerMutex;
+
+UEXGLTextRasterizer &rasterizer() {
+  // Never destroyed, like the other process-wide EXGL state
+  static auto rasterizer = new UEXGLTextRasterizer();
+  return *rasterizer;
+}
+
+} // namespace
+
+void EXGLSetTextRasterizer(UEXGLTextRasterizer newRasterizer) {
+  std::lock_guard<decltype(rasterizerMutex)> lock(rasterizerMutex);
+  rasterizer() = std::move(newRasterizer);
+}
+
+EXGLTextImage EXGLRasterizeText(const std::string &text, const UEXGLTextStyle &style) {
+  UEXGLTextRasterizer rasterize;
+  {
+    std::lock_guard<decltype(rasterizerMutex)> lock(rasterizerMutex);
+    rasterize = rasterizer();
+  }
+#ifdef __APPLE__
+  if (!rasterize) {
+    rasterize = EXGLCoreTextRasterize;
+  }
+#endif
+  if (!rasterize) {
+    throw std::runtime_error("EXGL: No text rasterizer on this platform!");
+  }
+
+  EXGLSystraceSection section("EXGL rasterize text");
+  EXGLTextImage image;
+  void *pixels = rasterize(text, style, &image.width, &image.height, &image.baseline);
+  if (!pixels || image.width <= 0 || image.height <= 0) {
+    free(pixels);
+    return EXGLTextImage();
+  }
+  image.data = std::shared_ptr<void>(pixels, free);
+  return image;
+}
+
+int EXGLTextAlignFromString(const std::string &textAlign) {
+  if (textAlign == "center") {
+    return 1;
+  }
+  if (textAlign == "right") {
+    return 2;
+  }
+  return 0;
+}
+
+bool EXGLFontWeightIsBold(const std::string &fontWeight) {
+  return fontWeight == "bold" || atoi(fontWeight.c_str()) >= 600;
+}
@@ -0,0 +1,44 @@
+#ifndef __EXGLTEXTRASTERIZER_H__
+#define __EXGLTEXTRASTERIZER_H__
+
+#include <memory>
+#include <string>
+
+#include "UEXGL.h"
+
+
+// --- EXGLTextRasterizer ------------------------------------------------------
+
+// Text for `gl.texImage2DTextEXP()` / `gl.texSubImage2DTextEXP()`, rasterized
+// with the platform's text stack straight into a buffer the GL thread uploads
+// to a texture of the context. Labels of 3D scenes, chart legends... then
+// change without being drawn to a canvas in JS and their pixels copied through
+// JS with `texImage2D`. Several labels can be packed into one atlas texture with
+// the sub-image variant.
+
+struct EXGLTextImage {
+  std::shared_ptr<void> data; // premultiplied RGBA8 rows top-down, null if it failed
+  GLsizei width = 0;
+  GLsizei height = 0;
+  float baseline = 0; // of the first line, from the top
+};
+
+// [Any thread] See UEXGLSetTextRasterizer
+void EXGLSetTextRasterizer(UEXGLTextRasterizer rasterizer);
+
+// [JS thread] Rasterize with the rasterizer set, or the platform's default.
+// Throws if there's none.
+EXGLTextImage EXGLRasterizeText(const std::string &text, const UEXGLTextStyle &style);
+
+// CSS-like values of the style objects given by JS. `textAlign` is "left",
+// "center" or "right", `fontWeight` "bold" or a number, 600 and up being bold.
+int EXGLTextAlignFromString(const std::string &textAlign);
+bool EXGLFontWeightIsBold(const std::string &fontWeight);
+
+#ifdef __APPLE__
+// The default on iOS, with CoreText (EXGLCoreTextRasterizer.mm)
+void *EXGLCoreTextRasterize(const std::string &text, const UEXGLTextStyle &style,
+                            GLsizei *width, GLsizei *height, float *baseline);
+#endif
+
+#endif
@@ -0,0 +1,213 @@
+#include "EXGLTrace.h"
+
+#include <stdexcept>
+
+#include "EXGLSystrace.h"
+
+// Spare records kept around, more are only needed if the disk falls behind
+static const size_t EXGLTraceMaxSpareRecords = 4;
+
+template<typename Func>
+struct EXGLTraceTrampoline;
+
+// The trampoline of a GL function, from its type
+template<typename... Params>
+struct EXGLTraceTrampoline<void (*)(Params...)> : EXGLCallTrampoline<Params...> {};
+
+const std::vector<EXGLTraceFunction> &EXGLTraceFunctions() {
+#define _EXGL_TRACE_FUNCTION(name) \
+  { #name, reinterpret_cast<EXGLGenericFunc>(&name), &EXGLTraceTrampoline<decltype(&name)>::execute },
+  static const std::vector<EXGLTraceFunction> functions {
+    EXGL_TRACE_FUNCTIONS(_EXGL_TRACE_FUNCTION)
+  };
+#undef _EXGL_TRACE_FUNCTION
+  return functions;
+}
+
+EXGLTraceWriter::EXGLTraceWriter(const std::string &path) {
+  file = fopen(path.c_str(), "wb");
+  if (!file) {
+    throw std::runtime_error("EXGL: Couldn't open the trace file '" + path + "' for writing!");
+  }
+  // Each record is a write of its own, turn them into a few big ones
+  setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+  const auto &functions = EXGLTraceFunctions();
+  record.clear();
+  putBytes(record, EXGL_TRACE_MAGIC, sizeof(EXGL_TRACE_MAGIC) - 1);
+  put<uint32_t>(record, (uint32_t) functions.size());
+  for (uint32_t i = 0; i < functions.size(); ++i) {
+    auto length = (uint16_t) strlen(functions[i].name);
+    put<uint16_t>(record, length);
+    putBytes(record, functions[i].name, length);
+    functionIndices[functions[i].glFunc] = i;
+  }
+  queueRecord();
+  thread = std::thread(&EXGLTraceWriter::writerLoop, this);
+}
+
+EXGLTraceWriter::~EXGLTraceWriter() {
+  finish();
+}
+
+size_t EXGLTraceWriter::finish() noexcept {
+  if (thread.joinable()) {
+    {
+      std::lock_guard<decltype(queueMutex)> lock(queueMutex);
+      finishing = true;
+    }
+    queueCondition.notify_one();
+    thread.join();
+  }
+  if (file) {
+    fclose(file);
+    file = nullptr;
+  }
+  return written;
+}
+
+void EXGLTraceWriter::queueRecord() {
+  {
+    std::lock_guard<decltype(queueMutex)> lock(queueMutex);
+    queue.push_back(std::move(record));
+    if (!spareRecords.empty()) {
+      record = std::move(spareRecords.back());
+      spareRecords.pop_back();
+    }
+  }
+  queueCondition.notify_one();
+  record.clear();
+}
+
+void EXGLTraceWriter::writerLoop() {
+  std::unique_lock<decltype(queueMutex)> lock(queueMutex);
+  while (true) {
+    queueCondition.wait(lock, [this] { return !queue.empty() || finishing; });
+    if (queue.empty()) {
+      return;
+    }
+    auto out = std::move(queue.front());
+    queue.pop_front();
+    lock.unlock();
+    {
+      EXGLSystraceSection section("EXGL write trace");
+      written += fwrite(out.data(), 1, out.size(), file);
+    }
+    lock.lock();
+    if (spareRecords.size() < EXGLTraceMaxSpareRecords) {
+      spareRecords.push_back(std::move(out));
+    }
+  }
+}
+
+uint32_t EXGLTraceWriter::functionIndex(EXGLGenericFunc glFunc) const noexcept {
+  auto iter = functionIndices.find(glFunc);
+  return iter == functionIndices.end() ? EXGLTraceUnknownFunction : iter->second;
+}
+
+void EXGLTraceWriter::annotate(size_t closureIndex, EXGLTraceEvent event,
+                               std::initializer_list<double> args,
+                               const void *data, size_t byteLength) {
+  auto &op = annotations[closureIndex];
+  op.clear();
+  put<uint16_t>(op, (uint16_t) EXGLOpcode::Closure);
+  put<uint16_t>(op, (uint16_t) event);
+  put<uint32_t>(op, (uint32_t) (sizeof(uint32_t) + args.size() * sizeof(double) + byteLength));
+  put<uint32_t>(op, (uint32_t) args.size());
+  for (double arg : args) {
+    put<double>(op, arg);
+  }
+  if (byteLength) {
+    putBytes(op, data, byteLength);
+  }
+}
+
+void EXGLTraceWriter::writeBatch(const EXGLCommandBuffer &batch) {
+  record.clear();
+  put<uint32_t>(record, (uint32_t) EXGLTraceRecord::Batch);
+  put<uint32_t>(record, 0); // patched below
+  put<uint32_t>(record, (uint32_t) batch.size());
+  batch.forEach([&](const EXGLCommandHeader &header, const void *payload) {
+    writeOp(header, payload);
+  });
+  annotations.clear();
+
+  auto byteLength = (uint32_t) (record.size() - 2 * sizeof(uint32_t));
+  memcpy(record.data() + sizeof(uint32_t), &byteLength, sizeof(byteLength));
+  queueRecord();
+}
+
+void EXGLTraceWriter::writeOp(const EXGLCommandHeader &header, const void *payload) {
+  if (header.opcode == EXGLOpcode::Closure) {
+    auto iter = annotations.find(EXGLCommandBuffer::closureIndex(payload));
+    if (iter != annotations.end()) {
+      putBytes(record, iter->second.data(), iter->second.size());
+    } else {
+      put<uint16_t>(record, (uint16_t) EXGLOpcode::Closure);
+      put<uint16_t>(record, (uint16_t) EXGLTraceEvent::Opaque);
+      put<uint32_t>(record, 0);
+    }
+    return;
+  }
+
+  put<uint16_t>(record, (uint16_t) header.opcode);
+  put<uint16_t>(record, 0);
+  size_t lengthOffset = record.size();
+  put<uint32_t>(record, 0); // patched below
+  size_t start = record.size();
+
+  switch (header.opcode) {
+    case EXGLOpcode::Closure:
+      break;
+    case EXGLOpcode::Call: {
+      auto args = reinterpret_cast<const EXGLCallArgs *>(payload);
+      put<uint32_t>(record, functionIndex(args->glFunc));
+      put<uint32_t>(record, args->argc);
+      putBytes(record, EXGLCommandBuffer::trailingData<EXGLCallArgs>(payload), args->argc * sizeof(double));
+      break;
+    }
+    case EXGLOpcode::BindObject: {
+      auto args = reinterpret_cast<const EXGLBindObjectArgs *>(payload);
+      put<uint32_t>(record, functionIndex(reinterpret_cast<EXGLGenericFunc>(args->glFunc)));
+      put<uint32_t>(record, args->target);
+      put<uint32_t>(record, args->exglObjId);
+      break;
+    }
+    case EXGLOpcode::UseObject: {
+      auto args = reinterpret_cast<const EXGLUseObjectArgs *>(payload);
+      put<uint32_t>(record, functionIndex(reinterpret_cast<EXGLGenericFunc>(args->glFunc)));
+      put<uint32_t>(record, args->exglObjId);
+      break;
+    }
+    case EXGLOpcode::UniformFloatv:
+    case EXGLOpcode::UniformIntv:
+    case EXGLOpcode::UniformUintv: {
+      // Only the type of `glFunc` differs
+      auto args = reinterpret_cast<const EXGLUniformvArgs<GLfloat> *>(payload);
+      put<uint32_t>(record, functionIndex(reinterpret_cast<EXGLGenericFunc>(args->glFunc)));
+      put<int32_t>(record, args->location);
+      put<int32_t>(record, args->count);
+      putBytes(record, EXGLCommandBuffer::trailingData<EXGLUniformvArgs<GLfloat>>(payload), args->byteLength);
+      break;
+    }
+    case EXGLOpcode::UniformMatrixv: {
+      auto args = reinterpret_cast<const EXGLUniformMatrixvArgs *>(payload);
+      put<uint32_t>(record, functionIndex(reinterpret_cast<EXGLGenericFunc>(args->glFunc)));
+      put<int32_t>(record, args->location);
+      put<int32_t>(record, args->count);
+      put<uint32_t>(record, args->transpose);
+      putBytes(record, EXGLCommandBuffer::trailingData<EXGLUniformMatrixvArgs>(payload), args->byteLength);
+      break;
+    }
+    case EXGLOpcode::UniformBlock: {
+      auto args = reinterpret_cast<const EXGLUniformBlockArgs *>(payload);
+      put<EXGLUniformBlockArgs>(record, *args);
+      putBytes(record, EXGLCommandBuffer::trailingData<EXGLUniformBlockArgs>(payload),
+               args->entryCount * sizeof(EXGLUniformBlockEntry) + args->byteLength);
+      break;
+    }
+  }
+
+  auto byteLength = (uint32_t) (record.size() - start);
+  memcpy(record.data() + lengthOffset, &byteLength, sizeof(byteLength));
+}
@@ -0,0 +1,191 @@
+#ifndef __EXGLTRACE_H__
+#define __EXGLTRACE_H__
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "EXGLCommandBuffer.h"
+
+
+// --- EXGLTrace ---------------------------------------------------------------
+
+// Recording of the command stream of a context, replayed offline against a
+// headless GL context by tools/replay to benchmark the GL thread side on its
+// own: batch execution time, op throughput and allocations.
+//
+// A trace holds every batch sent to the GL thread, in the order they ran. The
+// function pointers of the commands are replaced with indices into a table of
+// names so that a trace outlives the process that recorded it. Closures are
+// opaque: the recorder only knows the ones described with `annotate()` (object
+// setup and uploads), the others are recorded as `Opaque` and skipped on replay
+// (queries, readbacks, image loading...).
+//
+// Records are encoded on the JS thread and handed to a thread of the writer
+// that writes them to the file, so the JS thread never waits for the disk.
+//
+// File layout, integers in native byte order (little-endian on every platform
+// we ship on):
+//
+//   "EXGLTRC1"
+//   u32 function count, then each function name as a u16 length and its chars
+//   records: u32 type (EXGLTraceRecord), u32 byte length, payload
+//
+// A Batch record is a u32 op count followed by the ops, each a u16 opcode
+// (EXGLOpcode), a u16 event (EXGLTraceEvent, closures only), a u32 byte length
+// and a payload:
+//
+//   Call            u32 function, u32 argc, argc f64 arguments
+//   BindObject      u32 function, u32 target, u32 object
+//   UseObject       u32 function, u32 object
+//   Uniform*v       u32 function, i32 location, i32 count, data
+//   UniformMatrixv  u32 function, i32 location, i32 count, u32 transpose, data
+//   UniformBlock    the EXGLUniformBlockArgs payload as encoded
+//   Closure         u32 argc, argc f64 arguments, data
+//
+// Objects are EXGL object ids, the replay maps them to its own GL objects.
+
+#define EXGL_TRACE_MAGIC "EXGLTRC1"
+
+enum class EXGLTraceRecord : uint32_t {
+  Batch,
+};
+
+// Closures the recorder knows how to replay, with their arguments and data
+enum class EXGLTraceEvent : uint16_t {
+  Opaque,
+  CreateShader,            // shader, type
+  CreateProgram,           // program
+  ShaderSource,            // shader; source
+  AttachShader,            // program, shader
+  BindAttribLocation,      // program, index; name
+  LinkProgram,             // program
+  BufferData,              // target, size, usage; data unless only sized
+  BufferSubData,           // target, offset; data
+  TexImage2D,              // target, level, internalformat, width, height, border, format, type; pixels
+  TexSubImage2D,           // target, level, xoffset, yoffset, width, height, format, type; pixels
+  FramebufferTexture2D,    // target, attachment, textarget, texture, level
+  FramebufferRenderbuffer, // target, attachment, renderbuffertarget, renderbuffer
+};
+
+// Every GL function the binding methods encode as commands rather than closures
+#define EXGL_TRACE_FUNCTIONS(X)                                               \
+  X(glActiveTexture) X(glBeginTransformFeedback) X(glBindBuffer)              \
+  X(glBindFramebuffer) X(glBindRenderbuffer) X(glBindSampler)                 \
+  X(glBindTexture) X(glBindTransformFeedback) X(glBindVertexArray)            \
+  X(glBlendColor) X(glBlendEquation) X(glBlendEquationSeparate)               \
+  X(glBlendFunc) X(glBlendFuncSeparate) X(glBlitFramebuffer) X(glClear)       \
+  X(glClearBufferfi) X(glClearColor) X(glClearDepthf) X(glClearStencil)       \
+  X(glColorMask) X(glCompileShader) X(glCopyBufferSubData)                    \
+  X(glCopyTexImage2D) X(glCopyTexSubImage2D) X(glCopyTexSubImage3D)           \
+  X(glCullFace) X(glDeleteProgram) X(glDeleteShader) X(glDepthFunc)           \
+  X(glDepthMask) X(glDepthRangef) X(glDisable) X(glDisableVertexAttribArray)  \
+  X(glDrawArrays) X(glDrawArraysInstanced) X(glDrawElements)                  \
+  X(glDrawElementsInstanced) X(glDrawRangeElements) X(glEnable)               \
+  X(glEnableVertexAttribArray) X(glEndQuery) X(glEndTransformFeedback)        \
+  X(glFinish) X(glFlush) X(glFrontFace) X(glGenerateMipmap) X(glHint)         \
+  X(glLineWidth) X(glPauseTransformFeedback) X(glPixelStorei)                 \
+  X(glPolygonOffset) X(glReadBuffer) X(glRenderbufferStorage)                 \
+  X(glRenderbufferStorageMultisample) X(glResumeTransformFeedback)            \
+  X(glSampleCoverage) X(glScissor) X(glStencilFunc) X(glStencilFuncSeparate)  \
+  X(glStencilMask) X(glStencilMaskSeparate) X(glStencilOp)                    \
+  X(glStencilOpSeparate) X(glTexParameterf) X(glTexParameteri)                \
+  X(glTexStorage2D) X(glTexStorage3D)                                         \
+  X(glUniform1f) X(glUniform2f) X(glUniform3f) X(glUniform4f)                 \
+  X(glUniform1i) X(glUniform2i) X(glUniform3i) X(glUniform4i)                 \
+  X(glUniform1ui) X(glUniform2ui) X(glUniform3ui) X(glUniform4ui)             \
+  X(glUniform1fv) X(glUniform2fv) X(glUniform3fv) X(glUniform4fv)             \
+  X(glUniform1iv) X(glUniform2iv) X(glUniform3iv) X(glUniform4iv)             \
+  X(glUniform1uiv) X(glUniform2uiv) X(glUniform3uiv) X(glUniform4uiv)         \
+  X(glUniformMatrix2fv) X(glUniformMatrix3fv) X(glUniformMatrix4fv)           \
+  X(glUniformMatrix2x3fv) X(glUniformMatrix3x2fv) X(glUniformMatrix2x4fv)     \
+  X(glUniformMatrix4x2fv) X(glUniformMatrix3x4fv) X(glUniformMatrix4x3fv)     \
+  X(glUseProgram) X(glValidateProgram) X(glVertexAttrib1f)                    \
+  X(glVertexAttrib2f) X(glVertexAttrib3f) X(glVertexAttrib4f)                 \
+  X(glVertexAttribDivisor) X(glVertexAttribI4i) X(glVertexAttribI4ui)         \
+  X(glVertexAttribIPointer) X(glVertexAttribPointer) X(glViewport)
+
+// Index of functions missing from the table, skipped on replay
+static const uint32_t EXGLTraceUnknownFunction = 0xFFFFFFFF;
+
+struct EXGLTraceFunction {
+  const char *name;
+  EXGLGenericFunc glFunc;
+  // Decodes `Call` arguments for `glFunc`
+  void (*trampoline)(EXGLGenericFunc, const double *);
+};
+
+// The table of `EXGL_TRACE_FUNCTIONS`, in order
+const std::vector<EXGLTraceFunction> &EXGLTraceFunctions();
+
+class EXGLTraceWriter {
+public:
+  // Throws if `path` can't be written
+  explicit EXGLTraceWriter(const std::string &path);
+  // Finishes the trace (see `finish()`)
+  ~EXGLTraceWriter();
+
+  EXGLTraceWriter(const EXGLTraceWriter &) = delete;
+  EXGLTraceWriter &operator=(const EXGLTraceWriter &) = delete;
+
+  // [JS thread] Describe closure `closureIndex` of the batch being encoded
+  void annotate(size_t closureIndex, EXGLTraceEvent event, std::initializer_list<double> args,
+                const void *data = nullptr, size_t byteLength = 0);
+
+  // [JS thread] Append a batch that is about to be sent to the GL thread
+  void writeBatch(const EXGLCommandBuffer &batch);
+
+  // [JS thread] Wait for the records queued so far to be written and close the
+  // file. Returns the size of the trace in bytes.
+  size_t finish() noexcept;
+
+private:
+  template<typename T>
+  static inline void put(std::vector<uint8_t> &out, T value) {
+    auto bytes = reinterpret_cast<const uint8_t *>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+  }
+
+  static inline void putBytes(std::vector<uint8_t> &out, const void *data, size_t byteLength) {
+    auto bytes = reinterpret_cast<const uint8_t *>(data);
+    out.insert(out.end(), bytes, bytes + byteLength);
+  }
+
+  uint32_t functionIndex(EXGLGenericFunc glFunc) const noexcept;
+
+  void writeOp(const EXGLCommandHeader &header, const void *payload);
+
+  // [JS thread] Hand `record` over to the writer thread
+  void queueRecord();
+
+  // [Writer thread]
+  void writerLoop();
+
+  std::unordered_map<EXGLGenericFunc, uint32_t> functionIndices;
+
+  // Encoded op of each annotated closure of the batch being encoded, by index
+  std::unordered_map<size_t, std::vector<uint8_t>> annotations;
+
+  // [JS thread] The record being encoded
+  std::vector<uint8_t> record;
+
+  // [Writer thread] Owned by the JS thread again once the thread is joined
+  FILE *file = nullptr;
+  size_t written = 0;
+
+  std::mutex queueMutex;
+  std::condition_variable queueCondition;
+  std::deque<std::vector<uint8_t>> queue;
+  // Written records, reused for the next ones
+  std::vector<std::vector<uint8_t>> spareRecords;
+  bool finishing = false;
+  std::thread thread;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef __EXGLVERTEXARRAYSTATE_H__
+#define __EXGLVERTEXARRAYSTATE_H__
+
+#ifdef __ANDROID__
+#include <GLES3/gl3.h>
+#endif
+#ifdef __APPLE__
+#include <OpenGLES/ES3/gl.h>
+#endif
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+#include "UEXGL.h"
+
+
+// --- EXGLVertexArrayState ----------------------------------------------------
+
+// [JS thread] Attribute setup of every vertex array object: which attributes
+// are enabled, their pointers and divisors. Engines often re-issue the whole
+// setup before each draw in case something changed it; calls that match what
+// the bound vertex array already holds are dropped before they get into a
+// batch, so switching meshes costs the `bindVertexArray` alone.
+//
+// Vertex arrays start out with GL's defaults and only change through the WebGL
+// API, so the state is exact and always on. Deleting a buffer forgets the
+// pointers sourcing from it, GL detaches it from the bound vertex array.
+
+class EXGLVertexArrayState {
+public:
+  // Attributes above this aren't tracked, their calls always go through
+  static constexpr GLuint maxAttributes = 16;
+
+  // Record a binding, returns whether the GL call has to be made
+  inline bool bind(UEXGLObjectId vertexArray) noexcept {
+    if (vertexArray == bound) {
+      return false;
+    }
+    bound = vertexArray;
+    return true;
+  }
+
+  inline UEXGLObjectId boundVertexArray() const noexcept {
+    return bound;
+  }
+
+  // `enableVertexAttribArray` / `disableVertexAttribArray`
+  inline bool enable(GLuint index, bool enabled) noexcept {
+    Attribute *attribute = attributeAt(index);
+    if (!attribute) {
+      return true;
+    }
+    if (attribute->enabled == enabled) {
+      return false;
+    }
+    attribute->enabled = enabled;
+    return true;
+  }
+
+  // `vertexAttribPointer` / `vertexAttribIPointer` sourcing from `buffer`
+  inline bool pointer(GLuint index, GLint size, GLenum type, bool normalized, bool integer,
+                      GLsizei stride, int64_t offset, UEXGLObjectId buffer) noexcept {
+    Attribute *attribute = attributeAt(index);
+    if (!attribute) {
+      return true;
+    }
+    Pointer pointer { size, type, normalized, integer, stride, offset, buffer };
+    if (attribute->pointerKnown && attribute->pointer == pointer) {
+      return false;
+    }
+    attribute->pointer = pointer;
+    attribute->pointerKnown = true;
+    return true;
+  }
+
+  inline bool divisor(GLuint index, GLuint divisor) noexcept {
+    Attribute *attribute = attributeAt(index);
+    if (!attribute) {
+      return true;
+    }
+    if (attribute->divisor == divisor) {
+      return false;
+    }
+    attribute->divisor = divisor;
+    return true;
+  }
+
+  inline void forgetVertexArray(UEXGLObjectId vertexArray) noexcept {
+    if (vertexArray == 0) {
+      return;
+    }
+    arrays.erase(vertexArray);
+    if (bound == vertexArray) {
+      // Falls back to the default vertex array
+      bound = 0;
+    }
+  }
+
+  inline void forgetBuffer(UEXGLObjectId buffer) noexcept {
+    for (auto &array : arrays) {
+      for (auto &attribute : array.second) {
+        if (attribute.pointer.buffer == buffer) {
+          attribute.pointerKnown = false;
+        }
+      }
+    }
+  }
+
+private:
+  struct Pointer {
+    GLint size = 4;
+    GLenum type = GL_FLOAT;
+    bool normalized = false;
+    bool integer = false;
+    GLsizei stride = 0;
+    int64_t offset = 0;
+    UEXGLObjectId buffer = 0;
+
+    inline bool operator==(const Pointer &other) const noexcept {
+      return size == other.size && type == other.type && normalized == other.normalized &&
+        integer == other.integer && stride == other.stride && offset == other.offset &&
+        buffer == other.buffer;
+    }
+  };
+
+  struct Attribute {
+    bool enabled = false;
+    GLuint divisor = 0;
+    bool pointerKnown = true;
+    Pointer pointer;
+  };
+
+  inline Attribute *attributeAt(GLuint index) noexcept {
+    if (index >= maxAttributes) {
+      return nullptr;
+    }
+    // Created with the defaults on first use, 0 is the default vertex array
+    return &arrays[bound][index];
+  }
+
+  UEXGLObjectId bound = 0;
+  std::unordered_map<UEXGLObjectId, std::array<Attribute, maxAttributes>> arrays;
+};
+
+#endif
@@ -0,0 +1,181 @@
+#include "EXGLWindowRenderer.h"
+
+#ifdef __ANDROID__
+
+#include "EXGLContext.h"
+#include "EXGLSystrace.h"
+
+#include <unordered_map>
+
+#ifndef EGL_OPENGL_ES3_BIT_KHR
+#define EGL_OPENGL_ES3_BIT_KHR 0x0040
+#endif
+
+namespace {
+struct Renderers {
+  std::mutex mutex;
+  std::unordered_map<UEXGLContextId, std::shared_ptr<EXGLWindowRenderer>> map;
+};
+
+Renderers &renderers() {
+  // Never destroyed: destroying a renderer whose thread still runs would abort
+  static auto renderers = new Renderers();
+  return *renderers;
+}
+}
+
+EXGLWindowRenderer::EXGLWindowRenderer(UEXGLContextId exglCtxId, ANativeWindow *window)
+  : exglCtxId(exglCtxId), window(window) {
+  ANativeWindow_acquire(window);
+}
+
+EXGLWindowRenderer::~EXGLWindowRenderer() {
+  if (surface != EGL_NO_SURFACE) {
+    eglDestroySurface(display, surface);
+  }
+  if (context != EGL_NO_CONTEXT) {
+    eglDestroyContext(display, context);
+  }
+  ANativeWindow_release(window);
+}
+
+bool EXGLWindowRenderer::createSurface() {
+  display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+    EXGLSysLog("EXGL: Couldn't initialize EGL for a window!");
+    return false;
+  }
+  const EGLint configAttribs[] = {
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT_KHR,
+    EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_ALPHA_SIZE, 8,
+    EGL_DEPTH_SIZE, 16,
+    EGL_STENCIL_SIZE, 8,
+    EGL_NONE,
+  };
+  EGLConfig config = nullptr;
+  EGLint configCount = 0;
+  if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+    EXGLSysLog("EXGL: No EGL config for a window!");
+    return false;
+  }
+  const EGLint contextAttribs[] = { EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE };
+  context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+  if (context == EGL_NO_CONTEXT) {
+    EXGLSysLog("EXGL: Couldn't create a GL context for a window!");
+    return false;
+  }
+  surface = eglCreateWindowSurface(display, config, window, nullptr);
+  if (surface == EGL_NO_SURFACE) {
+    EXGLSysLog("EXGL: Couldn't create an EGL surface for a window!");
+    return false;
+  }
+  return true;
+}
+
+void EXGLWindowRenderer::flush() {
+  {
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    if (flushRequested) {
+      return;
+    }
+    flushRequested = true;
+  }
+  condition.notify_one();
+}
+
+void EXGLWindowRenderer::run() {
+  eglMakeCurrent(display, surface, surface, context);
+  while (true) {
+    bool stopping;
+    {
+      std::unique_lock<decltype(mutex)> lock(mutex);
+      condition.wait(lock, [&] { return flushRequested || stopRequested; });
+      // Cleared first: batches sent while flushing need another flush
+      flushRequested = false;
+      stopping = stopRequested;
+    }
+
+    if (auto exglCtx = EXGLContext::ContextGet(exglCtxId)) {
+      exglCtx->flush();
+      if (exglCtx->needsRedraw) {
+        EXGLSystraceSection section("EXGL swap");
+        eglSwapBuffers(display, surface);
+        exglCtx->setNeedsRedraw(false);
+      }
+    }
+    if (stopping) {
+      break;
+    }
+  }
+  eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
+
+// Attaching
+// ---------
+
+bool EXGLWindowRenderer::attach(UEXGLContextId exglCtxId, ANativeWindow *window) {
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (!exglCtx || !window) {
+    return false;
+  }
+  detach(exglCtxId);
+
+  std::shared_ptr<EXGLWindowRenderer> renderer(new EXGLWindowRenderer(exglCtxId, window));
+  if (!renderer->createSurface()) {
+    return false;
+  }
+  renderer->thread = std::thread(&EXGLWindowRenderer::run, renderer.get());
+  {
+    std::lock_guard<std::mutex> lock(renderers().mutex);
+    renderers().map[exglCtxId] = renderer;
+  }
+
+  std::weak_ptr<EXGLWindowRenderer> weakRenderer = renderer;
+  exglCtx->flushOnGLThread = [weakRenderer] {
+    if (auto renderer = weakRenderer.lock()) {
+      renderer->flush();
+    }
+  };
+  return true;
+}
+
+void EXGLWindowRenderer::detach(UEXGLContextId exglCtxId) {
+  std::shared_ptr<EXGLWindowRenderer> renderer;
+  {
+    std::lock_guard<std::mutex> lock(renderers().mutex);
+    auto iter = renderers().map.find(exglCtxId);
+    if (iter == renderers().map.end()) {
+      return;
+    }
+    renderer = iter->second;
+    renderers().map.erase(iter);
+  }
+
+  {
+    std::lock_guard<decltype(renderer->mutex)> lock(renderer->mutex);
+    renderer->stopRequested = true;
+  }
+  renderer->condition.notify_one();
+  renderer->thread.join();
+}
+
+bool EXGLWindowRenderer::requestFlush(UEXGLContextId exglCtxId) {
+  std::shared_ptr<EXGLWindowRenderer> renderer;
+  {
+    std::lock_guard<std::mutex> lock(renderers().mutex);
+    auto iter = renderers().map.find(exglCtxId);
+    if (iter == renderers().map.end()) {
+      return false;
+    }
+    renderer = iter->second;
+  }
+  renderer->flush();
+  return true;
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef __EXGLWINDOWRENDERER_H__
+#define __EXGLWINDOWRENDERER_H__
+
+#ifdef __ANDROID__
+
+#include <android/native_window.h>
+#include <EGL/egl.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "UEXGL.h"
+
+
+// --- EXGLWindowRenderer ------------------------------------------------------
+
+// Renders an EXGL context into an ANativeWindow (the Surface of a TextureView's
+// SurfaceTexture...) on a GL thread and EGL context owned by EXGL, instead of
+// the platform's GL thread. The context's `flushOnGLThread` then only wakes
+// that thread up, so flushes and blocking calls are a condition variable
+// handoff rather than a JNI call into `GLContext.flush()` which posts a
+// runnable that calls back into `UEXGLContextFlush`. Every flush which ran a
+// frame swaps it to the window.
+//
+// Flush requests made while one is pending are merged, like the render pool
+// does for headless contexts.
+
+class EXGLWindowRenderer {
+public:
+  // [Any thread] Start rendering the context into `window`, replacing its flush
+  // method. Returns false if no EGL context or window surface could be made.
+  static bool attach(UEXGLContextId exglCtxId, ANativeWindow *window);
+
+  // [Any thread] Run the context's remaining work and release the window, its
+  // EGL context and its thread. Returns once done.
+  static void detach(UEXGLContextId exglCtxId);
+
+  // [Any thread] Flush the context on its thread if it's attached to a window,
+  // returns whether it is
+  static bool requestFlush(UEXGLContextId exglCtxId);
+
+  ~EXGLWindowRenderer();
+
+private:
+  EXGLWindowRenderer(UEXGLContextId exglCtxId, ANativeWindow *window);
+
+  // [Any thread] Create the EGL context and window surface
+  bool createSurface();
+
+  // [Any thread] Wake the render thread up for a flush
+  void flush();
+
+  // [Render thread]
+  void run();
+
+  UEXGLContextId exglCtxId;
+  ANativeWindow *window = nullptr;
+  EGLDisplay display = EGL_NO_DISPLAY;
+  EGLContext context = EGL_NO_CONTEXT;
+  EGLSurface surface = EGL_NO_SURFACE;
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool flushRequested = false;
+  bool stopRequested = false;
+  std::thread thread;
+};
+
+#endif
+
+#endif
@@ -47,28 +47,106 @@ void EXJSObjectSetFunctionWithUTF8CStringName(JSContextRef ctx,
 
 #ifndef EXJS_USE_JSC_TYPEDARRAY_HEADER
 
+// Newer JavaScriptCore builds on Android export the C TypedArray API even
+// though its headers aren't shipped. Our definitions below shadow those
+// symbols inside this library, so the engine's own are looked up by name in
+// libjsc.so and called through when present. They read the backing store
+// directly instead of converting through JS.
+
+#include <dlfcn.h>
+#include <pthread.h>
+
+static struct {
+  JSTypedArrayType (*getTypedArrayType)(JSContextRef, JSValueRef, JSValueRef *);
+  size_t (*getArrayBufferByteLength)(JSContextRef, JSObjectRef, JSValueRef *);
+  void *(*getArrayBufferBytesPtr)(JSContextRef, JSObjectRef, JSValueRef *);
+  size_t (*getTypedArrayByteLength)(JSContextRef, JSObjectRef, JSValueRef *);
+  size_t (*getTypedArrayByteOffset)(JSContextRef, JSObjectRef, JSValueRef *);
+  void *(*getTypedArrayBytesPtr)(JSContextRef, JSObjectRef, JSValueRef *);
+  JSObjectRef (*makeTypedArrayWithBytesNoCopy)(JSContextRef, JSTypedArrayType, void *, size_t,
+                                               JSTypedArrayBytesDeallocator, void *, JSValueRef *);
+  JSObjectRef (*makeTypedArray)(JSContextRef, JSTypedArrayType, size_t, JSValueRef *);
+} jscTypedArrayAPI;
+static int jscTypedArrayAPIAvailable = 0;
+static pthread_once_t jscTypedArrayAPIOnce = PTHREAD_ONCE_INIT;
+
+static void EXJSResolveTypedArrayAPI(void) {
+  // Already loaded by the time a GL context is created, this only takes a reference
+  void *jsc = dlopen("libjsc.so", RTLD_NOW);
+  if (!jsc) {
+    return;
+  }
+  jscTypedArrayAPI.getTypedArrayType = dlsym(jsc, "JSValueGetTypedArrayType");
+  jscTypedArrayAPI.getArrayBufferByteLength = dlsym(jsc, "JSObjectGetArrayBufferByteLength");
+  jscTypedArrayAPI.getArrayBufferBytesPtr = dlsym(jsc, "JSObjectGetArrayBufferBytesPtr");
+  jscTypedArrayAPI.getTypedArrayByteLength = dlsym(jsc, "JSObjectGetTypedArrayByteLength");
+  jscTypedArrayAPI.getTypedArrayByteOffset = dlsym(jsc, "JSObjectGetTypedArrayByteOffset");
+  jscTypedArrayAPI.getTypedArrayBytesPtr = dlsym(jsc, "JSObjectGetTypedArrayBytesPtr");
+  jscTypedArrayAPI.makeTypedArrayWithBytesNoCopy = dlsym(jsc, "JSObjectMakeTypedArrayWithBytesNoCopy");
+  jscTypedArrayAPI.makeTypedArray = dlsym(jsc, "JSObjectMakeTypedArray");
+
+  // All or nothing, a partial API is treated as missing
+  jscTypedArrayAPIAvailable =
+    jscTypedArrayAPI.getTypedArrayType && jscTypedArrayAPI.getArrayBufferByteLength &&
+    jscTypedArrayAPI.getArrayBufferBytesPtr && jscTypedArrayAPI.getTypedArrayByteLength &&
+    jscTypedArrayAPI.getTypedArrayByteOffset && jscTypedArrayAPI.getTypedArrayBytesPtr &&
+    jscTypedArrayAPI.makeTypedArrayWithBytesNoCopy && jscTypedArrayAPI.makeTypedArray;
+  if (!jscTypedArrayAPIAvailable) {
+    dlclose(jsc);
+  }
+}
+
+int EXJSTypedArrayAPIAvailable(void) {
+  pthread_once(&jscTypedArrayAPIOnce, EXJSResolveTypedArrayAPI);
+  return jscTypedArrayAPIAvailable;
+}
+
 JS_EXPORT JSTypedArrayType JSValueGetTypedArrayType(JSContextRef ctx, JSValueRef value, JSValueRef* exception) {
+  if (EXJSTypedArrayAPIAvailable()) {
+    return jscTypedArrayAPI.getTypedArrayType(ctx, value, exception);
+  }
   return kJSTypedArrayTypeNone;
 }
 
 JS_EXPORT size_t JSObjectGetArrayBufferByteLength(JSContextRef ctx, JSObjectRef object, JSValueRef* exception) {
+  if (EXJSTypedArrayAPIAvailable()) {
+    return jscTypedArrayAPI.getArrayBufferByteLength(ctx, object, exception);
+  }
   EXJSConsoleLog(ctx, "EXJS: Tried to use non-existent TypedArray API");
   return 0;
 }
 
 JS_EXPORT void* JSObjectGetArrayBufferBytesPtr(JSContextRef ctx, JSObjectRef object, JSValueRef* exception) {
+  if (EXJSTypedArrayAPIAvailable()) {
+    return jscTypedArrayAPI.getArrayBufferBytesPtr(ctx, object, exception);
+  }
   EXJSConsoleLog(ctx, "EXJS: Tried to use non-existent TypedArray API");
   return NULL;
 }
 
 JS_EXPORT size_t JSObjectGetTypedArrayByteLength(JSContextRef ctx, JSObjectRef object,
                                                  JSValueRef* exception) {
+  if (EXJSTypedArrayAPIAvailable()) {
+    return jscTypedArrayAPI.getTypedArrayByteLength(ctx, object, exception);
+  }
+  EXJSConsoleLog(ctx, "EXJS: Tried to use non-existent TypedArray API");
+  return 0;
+}
+
+JS_EXPORT size_t JSObjectGetTypedArrayByteOffset(JSContextRef ctx, JSObjectRef object,
+                                                 JSValueRef* exception) {
+  if (EXJSTypedArrayAPIAvailable()) {
+    return jscTypedArrayAPI.getTypedArrayByteOffset(ctx, object, exception);
+  }
   EXJSConsoleLog(ctx, "EXJS: Tried to use non-existent TypedArray API");
   return 0;
 }
 
 JS_EXPORT void* JSObjectGetTypedArrayBytesPtr(JSContextRef ctx, JSObjectRef object,
                                               JSValueRef* exception) {
+  if (EXJSTypedArrayAPIAvailable()) {
+    return jscTypedArrayAPI.getTypedArrayBytesPtr(ctx, object, exception);
+  }
   EXJSConsoleLog(ctx, "EXJS: Tried to use non-existent TypedArray API");
   return NULL;
 }
@@ -78,12 +156,20 @@ JS_EXPORT JSObjectRef JSObjectMakeTypedArrayWithBytesNoCopy(JSContextRef ctx, JS
                                                             JSTypedArrayBytesDeallocator bytesDeallocator,
                                                             void* deallocatorContext,
                                                             JSValueRef* exception) {
+  if (EXJSTypedArrayAPIAvailable()) {
+    return jscTypedArrayAPI.makeTypedArrayWithBytesNoCopy(ctx, arrayType, bytes, byteLength,
+                                                          bytesDeallocator, deallocatorContext,
+                                                          exception);
+  }
   EXJSConsoleLog(ctx, "EXJS: Tried to use non-existent TypedArray API");
   return (JSObjectRef) JSValueMakeNull(ctx);
 }
 
 JS_EXPORT JSObjectRef JSObjectMakeTypedArray(JSContextRef ctx, JSTypedArrayType arrayType,
                                              size_t length, JSValueRef* exception) {
+  if (EXJSTypedArrayAPIAvailable()) {
+    return jscTypedArrayAPI.makeTypedArray(ctx, arrayType, length, exception);
+  }
   EXJSConsoleLog(ctx, "EXJS: Tried to use non-existent TypedArray API");
   return (JSObjectRef) JSValueMakeNull(ctx);
 }
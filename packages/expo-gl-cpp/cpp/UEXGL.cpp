@@ -4,12 +4,48 @@
 #include <JavaScriptCore/JSObjectRef.h>
 #include <JavaScriptCore/JSValueRef.h>
 
+#ifdef __APPLE__
+#include <CoreVideo/CVOpenGLESTextureCache.h>
+#endif
+
 #include "EXGLContext.h"
+#include "EXGLEGLImage.h"
+#include "EXGLProgramCache.h"
+#include "EXGLRenderPool.h"
+#include "EXGLSnapshot.h"
+#include "EXGLSystrace.h"
+#include "EXGLTextRasterizer.h"
+#include "EXGLWindowRenderer.h"
 
 UEXGLContextId UEXGLContextCreate(JSGlobalContextRef jsCtx) {
   return EXGLContext::ContextCreate(jsCtx);
 }
 
+UEXGLContextId UEXGLContextCreateHeadless(JSGlobalContextRef jsCtx, GLsizei width, GLsizei height) {
+  UEXGLContextId exglCtxId = EXGLContext::ContextCreate(jsCtx);
+  if (exglCtxId != 0 && !EXGLRenderPool::shared().attach(exglCtxId, width, height)) {
+    EXGLContext::ContextDestroy(exglCtxId);
+    return 0;
+  }
+  return exglCtxId;
+}
+
+void UEXGLContextDestroyHeadless(UEXGLContextId exglCtxId) {
+  EXGLRenderPool::shared().detach(exglCtxId);
+}
+
+void UEXGLRenderPoolSetThreadCount(unsigned int threadCount) {
+  EXGLRenderPool::shared().setThreadCount(threadCount);
+}
+
+void UEXGLSetProgramCacheDirectory(const char *path) {
+  EXGLProgramCache::shared().setDirectory(path ? path : "");
+}
+
+void UEXGLSetTraceHooks(UEXGLTraceBeginHook begin, UEXGLTraceEndHook end) {
+  EXGLSystrace::setHooks(begin, end);
+}
+
 void UEXGLContextSetFlushMethod(UEXGLContextId exglCtxId, std::function<void(void)> flushMethod) {
   auto exglCtx = EXGLContext::ContextGet(exglCtxId);
   if (exglCtx) {
@@ -25,6 +61,16 @@ void UEXGLContextSetFlushMethodObjc(UEXGLContextId exglCtxId, UEXGLFlushMethodBl
 }
 #endif
 
+#ifdef __ANDROID__
+bool UEXGLContextAttachNativeWindow(UEXGLContextId exglCtxId, ANativeWindow *window) {
+  return EXGLWindowRenderer::attach(exglCtxId, window);
+}
+
+void UEXGLContextDetachNativeWindow(UEXGLContextId exglCtxId) {
+  EXGLWindowRenderer::detach(exglCtxId);
+}
+#endif
+
 bool UEXGLContextNeedsRedraw(UEXGLContextId exglCtxId) {
   auto exglCtx = EXGLContext::ContextGet(exglCtxId);
   if (exglCtx) {
@@ -33,6 +79,20 @@ bool UEXGLContextNeedsRedraw(UEXGLContextId exglCtxId) {
   return false;
 }
 
+bool UEXGLContextVsync(UEXGLContextId exglCtxId, int64_t frameTimeNanos, int64_t intervalNanos) {
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (exglCtx) {
+    bool framesPending = exglCtx->vsync(frameTimeNanos, intervalNanos);
+#ifdef __ANDROID__
+    if (framesPending && EXGLWindowRenderer::requestFlush(exglCtxId)) {
+      return false;
+    }
+#endif
+    return framesPending;
+  }
+  return false;
+}
+
 void UEXGLContextDrawEnded(UEXGLContextId exglCtxId) {
   auto exglCtx = EXGLContext::ContextGet(exglCtxId);
   if (exglCtx) {
@@ -40,6 +100,13 @@ void UEXGLContextDrawEnded(UEXGLContextId exglCtxId) {
   }
 }
 
+void UEXGLContextSetContextLost(UEXGLContextId exglCtxId, bool contextLost) {
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (exglCtx) {
+    exglCtx->contextLost = contextLost;
+  }
+}
+
 void UEXGLContextDestroy(UEXGLContextId exglCtxId) {
   EXGLContext::ContextDestroy(exglCtxId);
 }
@@ -58,6 +125,21 @@ void UEXGLContextSetDefaultFramebuffer(UEXGLContextId exglCtxId, GLint framebuff
   }
 }
 
+void UEXGLContextSetMultisampling(UEXGLContextId exglCtxId, GLsizei samples,
+                                  GLsizei width, GLsizei height) {
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (exglCtx) {
+    exglCtx->setMultisampling(samples, width, height);
+  }
+}
+
+void UEXGLContextSetFramebufferDiscard(UEXGLContextId exglCtxId, unsigned int discard) {
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (exglCtx) {
+    exglCtx->framebufferDiscard = discard;
+  }
+}
+
 
 UEXGLObjectId UEXGLContextCreateObject(UEXGLContextId exglCtxId) {
   auto exglCtx = EXGLContext::ContextGet(exglCtxId);
@@ -88,3 +170,453 @@ GLuint UEXGLContextGetObject(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId)
   }
   return 0;
 }
+
+void UEXGLContextSetExternalTextureSource(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId,
+                                          std::function<GLuint(void)> latchFrame) {
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (exglCtx) {
+    exglCtx->setExternalTextureSource(exglObjId, std::move(latchFrame));
+  }
+}
+
+#ifdef __APPLE__
+// Latest CVPixelBuffer handed to UEXGLContextSetPixelBuffer for a texture, and
+// the texture cache turning it into a GL texture
+struct UEXGLPixelBufferSource {
+  std::mutex mutex;
+  CVPixelBufferRef pendingFrame = nullptr;
+  GLsync pendingFence = nullptr;
+  // Fences of frames replaced before they were latched, sync objects can only
+  // be deleted on the GL thread
+  std::vector<GLsync> staleFences;
+
+  // [GL thread]
+  CVOpenGLESTextureCacheRef cache = nullptr;
+  CVOpenGLESTextureRef texture = nullptr;
+
+  // Destroyed on the GL thread (see `EXGLContext::setExternalTextureSource`)
+  ~UEXGLPixelBufferSource() {
+    if (pendingFrame) {
+      CFRelease(pendingFrame);
+    }
+    if (pendingFence) {
+      glDeleteSync(pendingFence);
+    }
+    for (GLsync fence : staleFences) {
+      glDeleteSync(fence);
+    }
+    if (texture) {
+      CFRelease(texture);
+    }
+    if (cache) {
+      CFRelease(cache);
+    }
+  }
+
+  void setFrame(CVPixelBufferRef frame, GLsync fence) {
+    CVPixelBufferRetain(frame);
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    if (pendingFrame) {
+      // Never latched, only the latest frame matters
+      CFRelease(pendingFrame);
+    }
+    if (pendingFence) {
+      staleFences.push_back(pendingFence);
+    }
+    pendingFrame = frame;
+    pendingFence = fence;
+  }
+
+  // [GL thread]
+  GLuint latchFrame() {
+    CVPixelBufferRef frame;
+    GLsync fence;
+    std::vector<GLsync> stale;
+    {
+      std::lock_guard<decltype(mutex)> lock(mutex);
+      frame = pendingFrame;
+      fence = pendingFence;
+      pendingFrame = nullptr;
+      pendingFence = nullptr;
+      stale.swap(staleFences);
+    }
+    for (GLsync staleFence : stale) {
+      glDeleteSync(staleFence);
+    }
+    if (!frame) {
+      return 0;
+    }
+    // The producer's GPU work must be done before the frame is sampled
+    UEXGLFenceWait(fence);
+
+    if (!cache) {
+      CVReturn status = CVOpenGLESTextureCacheCreate(kCFAllocatorDefault, nullptr,
+                                                     [EAGLContext currentContext], nullptr, &cache);
+      if (status != kCVReturnSuccess) {
+        EXGLSysLog("EXGL: Couldn't create a texture cache for camera frames (%d)!", status);
+        cache = nullptr;
+        CFRelease(frame);
+        return 0;
+      }
+    }
+    CVOpenGLESTextureRef newTexture = nullptr;
+    CVReturn status = CVOpenGLESTextureCacheCreateTextureFromImage(
+      kCFAllocatorDefault, cache, frame, nullptr, GL_TEXTURE_2D, GL_RGBA,
+      (GLsizei) CVPixelBufferGetWidth(frame), (GLsizei) CVPixelBufferGetHeight(frame),
+      GL_BGRA_EXT, GL_UNSIGNED_BYTE, 0, &newTexture);
+    CFRelease(frame);
+    if (status != kCVReturnSuccess) {
+      EXGLSysLog("EXGL: Couldn't map a camera frame to a texture (%d)!", status);
+      return 0;
+    }
+    // The previous frame's texture is recycled by the cache
+    if (texture) {
+      CFRelease(texture);
+    }
+    texture = newTexture;
+    CVOpenGLESTextureCacheFlush(cache, 0);
+
+    // Frames aren't mipmapped and rarely a power of two
+    GLuint name = CVOpenGLESTextureGetName(texture);
+    GLenum target = CVOpenGLESTextureGetTarget(texture);
+    GLint boundTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+    glBindTexture(target, name);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(target, boundTexture);
+    return name;
+  }
+};
+
+static void UEXGLContextSetPixelBufferWithFence(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId,
+                                                CVPixelBufferRef pixelBuffer, GLsync fence) {
+  // Sources stay owned by their context, this only finds them again
+  static std::mutex sourcesMutex;
+  static std::unordered_map<uint64_t, std::weak_ptr<UEXGLPixelBufferSource>> sources;
+
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (!exglCtx) {
+    return;
+  }
+  uint64_t key = ((uint64_t) exglCtxId << 32) | exglObjId;
+  std::lock_guard<decltype(sourcesMutex)> lock(sourcesMutex);
+  if (!pixelBuffer) {
+    sources.erase(key);
+    exglCtx->setExternalTextureSource(exglObjId, nullptr);
+    return;
+  }
+  auto source = sources[key].lock();
+  if (!source) {
+    source = std::make_shared<UEXGLPixelBufferSource>();
+    sources[key] = source;
+    exglCtx->setExternalTextureSource(exglObjId, [source] { return source->latchFrame(); });
+  }
+  source->setFrame(pixelBuffer, fence);
+}
+
+void UEXGLContextSetPixelBuffer(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId,
+                                CVPixelBufferRef pixelBuffer) {
+  UEXGLContextSetPixelBufferWithFence(exglCtxId, exglObjId, pixelBuffer, nullptr);
+}
+
+void UEXGLContextSetIOSurface(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId,
+                              IOSurfaceRef surface, UEXGLFence fence) {
+  if (!surface) {
+    UEXGLContextSetPixelBufferWithFence(exglCtxId, exglObjId, nullptr, nullptr);
+    return;
+  }
+  CVPixelBufferRef pixelBuffer = nullptr;
+  CVReturn status = CVPixelBufferCreateWithIOSurface(kCFAllocatorDefault, surface, nullptr,
+                                                     &pixelBuffer);
+  if (status != kCVReturnSuccess) {
+    EXGLSysLog("EXGL: Couldn't wrap an IOSurface in a pixel buffer (%d)!", status);
+    return;
+  }
+  UEXGLContextSetPixelBufferWithFence(exglCtxId, exglObjId, pixelBuffer, fence);
+  CVPixelBufferRelease(pixelBuffer);
+}
+
+CVPixelBufferRef UEXGLContextExportPixelBuffer(UEXGLContextId exglCtxId, UEXGLObjectId exglTexture,
+                                               GLsizei width, GLsizei height, UEXGLFence *fence) {
+  if (fence) {
+    *fence = nullptr;
+  }
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (!exglCtx || width <= 0 || height <= 0) {
+    return nullptr;
+  }
+  GLuint source = exglCtx->lookupObject(exglTexture);
+  if (source == 0) {
+    return nullptr;
+  }
+
+  CFDictionaryRef surfaceProperties = CFDictionaryCreate(kCFAllocatorDefault, nullptr, nullptr, 0,
+                                                         &kCFTypeDictionaryKeyCallBacks,
+                                                         &kCFTypeDictionaryValueCallBacks);
+  const void *keys[] = { kCVPixelBufferIOSurfacePropertiesKey };
+  const void *values[] = { surfaceProperties };
+  CFDictionaryRef attributes = CFDictionaryCreate(kCFAllocatorDefault, keys, values, 1,
+                                                  &kCFTypeDictionaryKeyCallBacks,
+                                                  &kCFTypeDictionaryValueCallBacks);
+  CVPixelBufferRef pixelBuffer = nullptr;
+  CVReturn status = CVPixelBufferCreate(kCFAllocatorDefault, width, height, kCVPixelFormatType_32BGRA,
+                                        attributes, &pixelBuffer);
+  CFRelease(attributes);
+  CFRelease(surfaceProperties);
+  if (status != kCVReturnSuccess) {
+    EXGLSysLog("EXGL: Couldn't create a pixel buffer to export a texture (%d)!", status);
+    return nullptr;
+  }
+
+  // The cache retains the EAGLContext, so it doesn't outlive the export
+  CVOpenGLESTextureCacheRef cache = nullptr;
+  status = CVOpenGLESTextureCacheCreate(kCFAllocatorDefault, nullptr, [EAGLContext currentContext],
+                                        nullptr, &cache);
+  if (status != kCVReturnSuccess) {
+    EXGLSysLog("EXGL: Couldn't create a texture cache to export a texture (%d)!", status);
+    CVPixelBufferRelease(pixelBuffer);
+    return nullptr;
+  }
+  CVOpenGLESTextureRef texture = nullptr;
+  status = CVOpenGLESTextureCacheCreateTextureFromImage(
+    kCFAllocatorDefault, cache, pixelBuffer, nullptr, GL_TEXTURE_2D, GL_RGBA,
+    width, height, GL_BGRA_EXT, GL_UNSIGNED_BYTE, 0, &texture);
+  if (status != kCVReturnSuccess) {
+    EXGLSysLog("EXGL: Couldn't map a pixel buffer to a texture to export a texture (%d)!", status);
+    CFRelease(cache);
+    CVPixelBufferRelease(pixelBuffer);
+    return nullptr;
+  }
+
+  GLint drawFramebuffer, readFramebuffer;
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+  glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+  GLboolean scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+  GLuint framebuffers[2];
+  glGenFramebuffers(2, framebuffers);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffers[0]);
+  glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                         CVOpenGLESTextureGetTarget(texture), CVOpenGLESTextureGetName(texture), 0);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffers[1]);
+  glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, source, 0);
+  glDisable(GL_SCISSOR_TEST);
+  glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  if (scissorTest) {
+    glEnable(GL_SCISSOR_TEST);
+  }
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+  glDeleteFramebuffers(2, framebuffers);
+
+  // Other contexts read the IOSurface once the copy got to the GPU
+  if (fence) {
+    *fence = UEXGLFenceCreate();
+  } else {
+    glFlush();
+  }
+  CFRelease(texture);
+  CFRelease(cache);
+  return pixelBuffer;
+}
+#endif
+
+#ifdef __ANDROID__
+void UEXGLContextSetEGLImage(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId,
+                             EGLImageKHR image, GLenum target, UEXGLFence fence) {
+  EXGLEGLImageSetTexture(exglCtxId, exglObjId, image, target, fence);
+}
+
+EGLImageKHR UEXGLContextExportEGLImage(UEXGLContextId exglCtxId, UEXGLObjectId exglTexture,
+                                       UEXGLFence *fence) {
+  if (fence) {
+    *fence = EGL_NO_SYNC_KHR;
+  }
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (!exglCtx) {
+    return EGL_NO_IMAGE_KHR;
+  }
+  EGLImageKHR image = EXGLEGLImageExportTexture(exglCtx->lookupObject(exglTexture));
+  if (image != EGL_NO_IMAGE_KHR && fence) {
+    *fence = EXGLEGLImageCreateFence();
+  }
+  return image;
+}
+#endif
+
+UEXGLFence UEXGLFenceCreate(void) {
+#ifdef __ANDROID__
+  return EXGLEGLImageCreateFence();
+#else
+  GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  // Other contexts only see the fence signaled once it got to the GPU
+  glFlush();
+  return fence;
+#endif
+}
+
+void UEXGLFenceWait(UEXGLFence fence) {
+#ifdef __ANDROID__
+  EXGLEGLImageWaitFence(fence);
+#else
+  if (fence) {
+    glWaitSync(fence, 0, GL_TIMEOUT_IGNORED);
+    glDeleteSync(fence);
+  }
+#endif
+}
+
+void UEXGLContextSetFrameSink(UEXGLContextId exglCtxId, UEXGLFrameSink sink) {
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (exglCtx) {
+    exglCtx->setFrameSink(std::move(sink));
+  }
+}
+
+void UEXGLSetTextRasterizer(UEXGLTextRasterizer rasterizer) {
+  EXGLSetTextRasterizer(std::move(rasterizer));
+}
+
+#ifdef __APPLE__
+// Copies recorded frames into buffers of a pixel buffer pool, rendering to the
+// buffers' IOSurfaces through a texture cache
+struct UEXGLPixelBufferPoolSink {
+  CVPixelBufferPoolRef pool;
+  UEXGLPixelBufferSinkBlock append;
+
+  // [GL thread]
+  CVOpenGLESTextureCacheRef cache = nullptr;
+  GLuint framebuffer = 0;
+
+  UEXGLPixelBufferPoolSink(CVPixelBufferPoolRef pool, UEXGLPixelBufferSinkBlock append)
+    : pool(CVPixelBufferPoolRetain(pool)), append(append) {}
+
+  // The framebuffer object is deleted when the recording stops, or with the GL
+  // context
+  ~UEXGLPixelBufferPoolSink() {
+    if (cache) {
+      CFRelease(cache);
+    }
+    CVPixelBufferPoolRelease(pool);
+  }
+
+  // [GL thread]
+  void recordFrame(GLint source, GLsizei width, GLsizei height, int64_t timeNanos) {
+    if (source < 0) {
+      if (framebuffer != 0) {
+        glDeleteFramebuffers(1, &framebuffer);
+        framebuffer = 0;
+      }
+      append(nullptr, 0);
+      return;
+    }
+    if (!cache) {
+      CVReturn status = CVOpenGLESTextureCacheCreate(kCFAllocatorDefault, nullptr,
+                                                     [EAGLContext currentContext], nullptr, &cache);
+      if (status != kCVReturnSuccess) {
+        EXGLSysLog("EXGL: Couldn't create a texture cache for recording (%d)!", status);
+        cache = nullptr;
+        return;
+      }
+    }
+    CVPixelBufferRef pixelBuffer = nullptr;
+    CVReturn status = CVPixelBufferPoolCreatePixelBuffer(kCFAllocatorDefault, pool, &pixelBuffer);
+    if (status != kCVReturnSuccess) {
+      // All the buffers are still queued up in the encoder, drop the frame
+      return;
+    }
+    GLsizei bufferWidth = (GLsizei) CVPixelBufferGetWidth(pixelBuffer);
+    GLsizei bufferHeight = (GLsizei) CVPixelBufferGetHeight(pixelBuffer);
+    CVOpenGLESTextureRef texture = nullptr;
+    status = CVOpenGLESTextureCacheCreateTextureFromImage(
+      kCFAllocatorDefault, cache, pixelBuffer, nullptr, GL_TEXTURE_2D, GL_RGBA,
+      bufferWidth, bufferHeight, GL_BGRA_EXT, GL_UNSIGNED_BYTE, 0, &texture);
+    if (status != kCVReturnSuccess) {
+      EXGLSysLog("EXGL: Couldn't map a pixel buffer to a texture for recording (%d)!", status);
+      CVPixelBufferRelease(pixelBuffer);
+      return;
+    }
+
+    GLint drawFramebuffer, readFramebuffer;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+    GLboolean scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+    if (framebuffer == 0) {
+      glGenFramebuffers(1, &framebuffer);
+    }
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                           CVOpenGLESTextureGetTarget(texture), CVOpenGLESTextureGetName(texture), 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, source);
+    glDisable(GL_SCISSOR_TEST);
+    // GL rows go bottom-up, pixel buffer rows top-down
+    glBlitFramebuffer(0, 0, width, height, 0, bufferHeight, bufferWidth, 0,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    if (scissorTest) {
+      glEnable(GL_SCISSOR_TEST);
+    }
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+    // The encoder reads the IOSurface once the copy got to the GPU
+    glFlush();
+
+    append(pixelBuffer, timeNanos);
+    CFRelease(texture);
+    CVPixelBufferRelease(pixelBuffer);
+    CVOpenGLESTextureCacheFlush(cache, 0);
+  }
+};
+
+void UEXGLContextSetPixelBufferSink(UEXGLContextId exglCtxId, CVPixelBufferPoolRef pool,
+                                    UEXGLPixelBufferSinkBlock append) {
+  if (!pool || !append) {
+    UEXGLContextSetFrameSink(exglCtxId, nullptr);
+    return;
+  }
+  auto sink = std::make_shared<UEXGLPixelBufferPoolSink>(pool, append);
+  UEXGLContextSetFrameSink(exglCtxId, [sink](GLint framebuffer, GLsizei width, GLsizei height,
+                                             int64_t timeNanos) {
+    sink->recordFrame(framebuffer, width, height, timeNanos);
+  });
+}
+#endif
+
+void UEXGLContextTakeSnapshot(UEXGLContextId exglCtxId, UEXGLObjectId exglFramebuffer,
+                              GLint x, GLint y, GLsizei width, GLsizei height,
+                              UEXGLSnapshotEncoder encode) {
+  auto exglCtx = EXGLContext::ContextGet(exglCtxId);
+  if (!exglCtx) {
+    EXGLSnapshotQueue::shared().encode(nullptr, 0, 0, std::move(encode));
+    return;
+  }
+  exglCtx->takeSnapshot(exglFramebuffer, x, y, width, height, std::move(encode));
+}
+
+#ifdef __APPLE__
+void UEXGLContextTakeSnapshotObjc(UEXGLContextId exglCtxId, UEXGLObjectId exglFramebuffer,
+                                  GLint x, GLint y, GLsizei width, GLsizei height,
+                                  UEXGLSnapshotBlock completion) {
+  UEXGLContextTakeSnapshot(exglCtxId, exglFramebuffer, x, y, width, height,
+                           [completion](const void *pixels, GLsizei width, GLsizei height) {
+    if (!pixels) {
+      completion(nullptr);
+      return;
+    }
+    // The block may keep the image, it gets its own copy of the pixels
+    CFDataRef data = CFDataCreate(kCFAllocatorDefault, (const UInt8 *) pixels, (CFIndex) width * height * 4);
+    CGDataProviderRef provider = CGDataProviderCreateWithCFData(data);
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGImageRef image = CGImageCreate(width, height, 8, 32, (size_t) width * 4, colorSpace,
+                                     kCGBitmapByteOrderDefault | kCGImageAlphaPremultipliedLast,
+                                     provider, nullptr, false, kCGRenderingIntentDefault);
+    completion(image);
+    CGImageRelease(image);
+    CGColorSpaceRelease(colorSpace);
+    CGDataProviderRelease(provider);
+    CFRelease(data);
+  });
+}
+#endif
@@ -4,15 +4,30 @@
 
 #ifdef __ANDROID__
 #include <GLES3/gl3.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <android/native_window.h>
 #endif
 #ifdef __APPLE__
 #include <OpenGLES/ES3/gl.h>
+#include <CoreVideo/CVPixelBuffer.h>
+#include <CoreVideo/CVPixelBufferIOSurface.h>
+#include <CoreVideo/CVPixelBufferPool.h>
+#include <CoreGraphics/CGImage.h>
 #endif
 
 #ifdef __cplusplus
 #include <functional>
+#include <string>
+
+namespace facebook {
+namespace jsi {
+class Runtime;
+}
+}
 #endif
 
+#include <stdint.h>
 #include <JavaScriptCore/JSBase.h>
 
 
@@ -39,7 +54,45 @@ typedef unsigned int UEXGLObjectId;
 // `global.__EXGLContexts[id]` in JavaScript.
 UEXGLContextId UEXGLContextCreate(JSGlobalContextRef jsCtx);
 
+// [JS thread] Create an EXGL context without a view that renders into a
+// `width`x`height` framebuffer on one of the render pool's GL threads, so that
+// several of them can work in parallel. Returns 0 if no GL context could be
+// created. Release it with UEXGLContextDestroyHeadless.
+UEXGLContextId UEXGLContextCreateHeadless(JSGlobalContextRef jsCtx, GLsizei width, GLsizei height);
+
+// [Any thread] Run the headless context's remaining work, then release it
+void UEXGLContextDestroyHeadless(UEXGLContextId exglCtxId);
+
+// [Any thread] Number of GL threads of the render pool, only has effect before
+// the first headless context is created. 0 (the default) picks one from the
+// number of cores.
+void UEXGLRenderPoolSetThreadCount(unsigned int threadCount);
+
+// [Any thread] Directory where linked program binaries are cached across runs
+// (see EXGLProgramCache.h), usually under the app's cache directory. NULL or
+// an empty path disables the cache, which is the default.
+void UEXGLSetProgramCacheDirectory(const char *path);
+
+// Profiler hooks for the trace points of every context (see EXGLSystrace.h):
+// `begin` is called with the name of a section starting on the current thread
+// and returns a cookie, 0 if it isn't traced, and `end` is given the cookie
+// back when the section ends. Sections on a thread nest.
+typedef uint64_t (*UEXGLTraceBeginHook)(const char *name);
+typedef void (*UEXGLTraceEndHook)(uint64_t cookie);
+
+// [Any thread] Send trace points to other hooks than ATrace on Android and
+// os_signpost on iOS (the defaults), NULL to go back to those
+void UEXGLSetTraceHooks(UEXGLTraceBeginHook begin, UEXGLTraceEndHook end);
+
 #ifdef __cplusplus
+// [JS thread] Same as UEXGLContextCreate for any JSI runtime (Hermes...), the
+// interface object is bound through JSI instead of the JavaScriptCore C API
+UEXGLContextId UEXGLContextCreateWithJSI(facebook::jsi::Runtime &runtime);
+
+// [JS thread] Same as UEXGLContextCreateHeadless for any JSI runtime
+UEXGLContextId UEXGLContextCreateHeadlessWithJSI(facebook::jsi::Runtime &runtime,
+                                                 GLsizei width, GLsizei height);
+
 // [JS thread] Pass function to cpp that will run GL operations on GL thread
 void UEXGLContextSetFlushMethod(UEXGLContextId exglCtxId, std::function<void(void)> flushMethod);
 #endif
@@ -50,12 +103,42 @@ typedef void(^UEXGLFlushMethodBlock)(void);
 void UEXGLContextSetFlushMethodObjc(UEXGLContextId exglCtxId, UEXGLFlushMethodBlock flushMethod);
 #endif
 
+#ifdef __ANDROID__
+// [Any thread] Render the context into `window` (eg. from the Surface of a
+// TextureView's SurfaceTexture) on a GL thread and EGL context of its own,
+// instead of flushing it through a flush method: flushes and blocking calls
+// then stay in native code, and every frame is swapped to the window once it
+// ran. Frames waiting for a refresh reported with UEXGLContextVsync are flushed
+// by it too. Returns false if no EGL context or surface could be made.
+bool UEXGLContextAttachNativeWindow(UEXGLContextId exglCtxId, ANativeWindow *window);
+
+// [Any thread] Run the context's remaining work on its own GL thread, then
+// release the window, the EGL context and the thread. Call it before
+// destroying the context or the window.
+void UEXGLContextDetachNativeWindow(UEXGLContextId exglCtxId);
+#endif
+
 // [Any thread] Check whether we should redraw the surface
 bool UEXGLContextNeedsRedraw(UEXGLContextId exglCtxId);
 
 // [GL thread] Tell cpp that we finished drawing to the surface
 void UEXGLContextDrawEnded(UEXGLContextId exglCtxId);
 
+// [Any thread] Report a display refresh, eg. from a Choreographer frame callback
+// or a CADisplayLink. `frameTimeNanos` is on the steady clock
+// (`System.nanoTime()` on Android, `CACurrentMediaTime()` * 1e9 on iOS),
+// `intervalNanos` the refresh interval (0 if unknown). Once refreshes are
+// reported, frames ended by JS are flushed together once per refresh: returns
+// true if frames are waiting and the platform should flush the context on its
+// GL thread now (never true for contexts attached to a native window, which
+// get flushed right away).
+bool UEXGLContextVsync(UEXGLContextId exglCtxId, int64_t frameTimeNanos, int64_t intervalNanos);
+
+// [Any thread] Tell cpp that the GL context was lost (app backgrounded, GPU
+// reset...) or restored. `gl.isContextLost()` reports it and the context's GPU
+// memory estimate starts over.
+void UEXGLContextSetContextLost(UEXGLContextId exglCtxId, bool contextLost);
+
 // [Any thread] Release the resources for an EXGL context. The same id is never
 // reused.
 void UEXGLContextDestroy(UEXGLContextId exglCtxId);
@@ -67,6 +150,29 @@ void UEXGLContextFlush(UEXGLContextId exglCtxId);
 // platform-specific extensions on the default framebuffer, such as MSAA.
 void UEXGLContextSetDefaultFramebuffer(UEXGLContextId exglCtxId, GLint framebuffer);
 
+// [Any thread] Antialias: JS draws the default framebuffer into one with
+// `samples` samples (clamped to GL_MAX_SAMPLES) and `width` x `height` pixels,
+// which is resolved into the default framebuffer at each `endFrameEXP`. Call
+// again with the new size when the default framebuffer is resized, 0 samples
+// goes back to drawing the default framebuffer directly. Needs OpenGL ES 3.0.
+void UEXGLContextSetMultisampling(UEXGLContextId exglCtxId, GLsizei samples,
+                                  GLsizei width, GLsizei height);
+
+// Framebuffer contents EXGL invalidates (`glInvalidateFramebuffer`) once they
+// can't be needed anymore, so tiled GPUs neither write them back to memory nor
+// load them into tile memory. Needs OpenGL ES 3.0.
+typedef enum {
+  UEXGLFramebufferDiscardNone = 0,
+  // Depth and stencil of the default framebuffer after each `endFrameEXP`
+  UEXGLFramebufferDiscardDepthStencilAtEndFrame = 1 << 0,
+  // What the first `clear` after binding a framebuffer (or ending a frame)
+  // overwrites completely, i.e. without scissor test or write masks
+  UEXGLFramebufferDiscardOnClear = 1 << 1,
+} UEXGLFramebufferDiscard;
+
+// [Any thread] Set the `UEXGLFramebufferDiscard` flags, all of them by default.
+void UEXGLContextSetFramebufferDiscard(UEXGLContextId exglCtxId, unsigned int discard);
+
 // [Any thread] Create an EXGL object. Initially maps to the OpenGL object zero.
 UEXGLObjectId UEXGLContextCreateObject(UEXGLContextId exglCtxId);
 
@@ -79,6 +185,162 @@ void UEXGLContextMapObject(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId, GL
 // [GL thread] Get the underlying OpenGL object an EXGL object maps to.
 GLuint UEXGLContextGetObject(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId);
 
+#ifdef __cplusplus
+// [Any thread] Feed the EXGL texture object `exglObjId` from a platform video
+// source (camera frames...) without any CPU copy. `latchFrame` runs on the GL
+// thread whenever JS calls `gl.updateExternalTextureEXP(texture)`: it must latch
+// the source's latest frame and return the GL texture holding it (0 to keep the
+// current one), which the object is then mapped to. An empty function detaches
+// the source. Replaced functions are destroyed on the GL thread.
+void UEXGLContextSetExternalTextureSource(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId,
+                                          std::function<GLuint(void)> latchFrame);
+#endif
+
+#ifdef __APPLE__
+// [Any thread] Feed the EXGL texture object `exglObjId` from 32BGRA
+// CVPixelBuffers, eg. camera frames, through a CVOpenGLESTextureCache so the
+// texture samples the frame's IOSurface directly. Call it with every new frame,
+// `gl.updateExternalTextureEXP(texture)` picks up the latest one. NULL detaches
+// the texture from its frames.
+void UEXGLContextSetPixelBuffer(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId,
+                                CVPixelBufferRef pixelBuffer);
+#endif
+
+// Textures shared with other native producers and consumers (image
+// manipulators, camera, video players...) without any CPU copy. Fences order
+// the GPU work of the contexts writing and reading them.
+#ifdef __ANDROID__
+// An EGL_SYNC_FENCE_KHR of the default display
+typedef EGLSyncKHR UEXGLFence;
+#endif
+#ifdef __APPLE__
+// A sync object of a context in the EAGLSharegroup of EXGL's context. Across
+// sharegroups there are none, flushing the producer's context is enough there.
+typedef GLsync UEXGLFence;
+#endif
+
+// [GL thread] Fence the GL work of the current context issued so far and flush
+// it, so another context can wait for it with UEXGLFenceWait. Null (after
+// flushing) if fences aren't supported.
+UEXGLFence UEXGLFenceCreate(void);
+
+// [GL thread] Make the GPU wait for `fence` before running the later GL
+// commands of the current context, then destroy it. Null is ignored.
+void UEXGLFenceWait(UEXGLFence fence);
+
+#ifdef __ANDROID__
+// [Any thread] Feed the EXGL texture object `exglObjId` from `image`, an
+// EGLImage of the default display (from an AHardwareBuffer, another context's
+// texture...), which `gl.updateExternalTextureEXP(texture)` binds to it. `target`
+// is GL_TEXTURE_2D, or GL_TEXTURE_EXTERNAL_OES for YUV buffers. The GPU waits
+// for the producer's `fence` (may be EGL_NO_SYNC_KHR) first. EXGL owns `image`
+// and `fence` and destroys them once the image is bound or replaced by a newer
+// one, the texture keeps the buffer alive. EGL_NO_IMAGE_KHR detaches the
+// texture from its images.
+void UEXGLContextSetEGLImage(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId,
+                             EGLImageKHR image, GLenum target, UEXGLFence fence);
+
+// [GL thread] Export level 0 of the EXGL 2D texture `exglTexture` as an
+// EGLImage sharing its storage, so other contexts and APIs read what JS draws
+// into it without a copy. EGL_NO_IMAGE_KHR if it failed. `fence` (may be NULL)
+// receives a fence over the GL work so far, to wait for before reading. The
+// caller destroys both.
+EGLImageKHR UEXGLContextExportEGLImage(UEXGLContextId exglCtxId, UEXGLObjectId exglTexture,
+                                       UEXGLFence *fence);
+#endif
+
+#ifdef __APPLE__
+// [Any thread] UEXGLContextSetPixelBuffer for a 32BGRA IOSurface, eg. one
+// another EAGLContext or Metal rendered to. The GPU waits for the producer's
+// `fence` (may be NULL) before latching it, EXGL deletes the fence once done.
+// NULL detaches the texture from its surfaces.
+void UEXGLContextSetIOSurface(UEXGLContextId exglCtxId, UEXGLObjectId exglObjId,
+                              IOSurfaceRef surface, UEXGLFence fence);
+
+// [GL thread] Copy `width` x `height` of the EXGL 2D texture `exglTexture` on
+// the GPU into a new IOSurface-backed 32BGRA pixel buffer (see
+// CVPixelBufferGetIOSurface), rows in texture order (t = 0 first). NULL if it
+// failed, the caller releases it. `fence` (may be NULL) receives a fence over
+// the copy, which is flushed either way.
+CVPixelBufferRef UEXGLContextExportPixelBuffer(UEXGLContextId exglCtxId, UEXGLObjectId exglTexture,
+                                               GLsizei width, GLsizei height, UEXGLFence *fence);
+#endif
+
+#ifdef __cplusplus
+// [GL thread] Receives the frames recorded with `gl.startRecordingEXP()`: the GL
+// framebuffer to copy `width` x `height` from and the frame's steady_clock time.
+// It's called with a `framebuffer` of -1 once the recording is stopped.
+typedef std::function<void(GLint framebuffer, GLsizei width, GLsizei height, int64_t timeNanos)> UEXGLFrameSink;
+
+// [Any thread] Send recorded frames to a video encoder. An empty function
+// detaches the current sink, `gl.startRecordingEXP()` fails without one.
+void UEXGLContextSetFrameSink(UEXGLContextId exglCtxId, UEXGLFrameSink sink);
+#endif
+
+#ifdef __APPLE__
+// [Any thread] Record frames to 32BGRA pixel buffers from `pool` (eg. the pool
+// of an AVAssetWriterInputPixelBufferAdaptor): each frame is copied on the GPU
+// into a buffer through a CVOpenGLESTextureCache, then handed to `append` on
+// the GL thread with the frame's time. `append` gets a NULL buffer once the
+// recording is stopped. A NULL pool detaches the sink.
+typedef void(^UEXGLPixelBufferSinkBlock)(CVPixelBufferRef pixelBuffer, int64_t timeNanos);
+void UEXGLContextSetPixelBufferSink(UEXGLContextId exglCtxId, CVPixelBufferPoolRef pool,
+                                    UEXGLPixelBufferSinkBlock append);
+#endif
+
+#ifdef __cplusplus
+// [Snapshot thread] Encodes a snapshot: `width` x `height` tightly packed RGBA8
+// pixels, rows top-down, or null if the snapshot failed. `pixels` is freed
+// once it returns.
+typedef std::function<void(const void *pixels, GLsizei width, GLsizei height)> UEXGLSnapshotEncoder;
+
+// [GL thread] Snapshot `width` x `height` at `x`, `y` of the EXGL framebuffer
+// `exglFramebuffer` (0 for the default one) without waiting for the GPU. The GL
+// thread only starts the copy into a pixel pack buffer, a later
+// UEXGLContextFlush picks up the pixels once they're ready and `encode` runs on
+// a background thread shared by all contexts, where it can take its time
+// encoding PNG or JPEG with the platform's encoder.
+void UEXGLContextTakeSnapshot(UEXGLContextId exglCtxId, UEXGLObjectId exglFramebuffer,
+                              GLint x, GLint y, GLsizei width, GLsizei height,
+                              UEXGLSnapshotEncoder encode);
+#endif
+
+#ifdef __cplusplus
+// How `gl.texImage2DTextEXP()` and `gl.texSubImage2DTextEXP()` lay out text
+struct UEXGLTextStyle {
+  std::string fontFamily; // empty for the system font
+  float fontSize = 16;
+  bool bold = false;
+  bool italic = false;
+  uint32_t color = 0x000000ff; // 0xRRGGBBAA
+  float maxWidth = 0; // lines wrap at this width, 0 to never wrap
+  int align = 0; // 0 left, 1 center, 2 right
+};
+
+// [JS thread] Rasterizes `text` (UTF-8) with the platform's text stack into
+// `width` x `height` tightly packed RGBA8 pixels, premultiplied and rows
+// top-down, sized to fit the text. `baseline` is the distance of the first
+// line's baseline from the top. Returns the pixels (freed with `free`) or null
+// if it failed.
+typedef std::function<void *(const std::string &text, const UEXGLTextStyle &style,
+                             GLsizei *width, GLsizei *height, float *baseline)> UEXGLTextRasterizer;
+
+// [Any thread] Rasterize the text of every context with `rasterizer`, an empty
+// function to go back to the default, CoreText on iOS and none on Android
+// (where the JNI binding sets one backed by android.graphics)
+void UEXGLSetTextRasterizer(UEXGLTextRasterizer rasterizer);
+#endif
+
+#ifdef __APPLE__
+// [GL thread] UEXGLContextTakeSnapshot handing `completion` a CGImage of the
+// pixels on the snapshot thread (NULL if it failed), eg. to encode it with
+// ImageIO there.
+typedef void(^UEXGLSnapshotBlock)(CGImageRef image);
+void UEXGLContextTakeSnapshotObjc(UEXGLContextId exglCtxId, UEXGLObjectId exglFramebuffer,
+                                  GLint x, GLint y, GLsizei width, GLsizei height,
+                                  UEXGLSnapshotBlock completion);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,21 @@
+# exgl-replay, replays EXGL traces on a device:
+#   ndk-build NDK_PROJECT_PATH=. NDK_APPLICATION_MK=Application.mk JSC_DIR=<path to jsc-android>
+
+LOCAL_PATH := $(call my-dir)
+
+include $(CLEAR_VARS)
+LOCAL_MODULE := exgl-replay
+
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../cpp
+LOCAL_SRC_FILES := \
+  ../../cpp/EXGLTrace.cpp \
+  EXGLTraceReplay.cpp
+
+# Only for the JavaScriptCore headers UEXGL.h includes
+LOCAL_SHARED_LIBRARIES := libjsc
+
+LOCAL_LDLIBS := -lEGL -lGLESv3
+
+include $(BUILD_EXECUTABLE)
+
+$(call import-module,jsc)
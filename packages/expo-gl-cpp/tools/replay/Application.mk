@@ -0,0 +1,11 @@
+APP_BUILD_SCRIPT := Android.mk
+
+APP_ABI := armeabi-v7a arm64-v8a x86 x86_64
+APP_PLATFORM := android-21
+
+NDK_MODULE_PATH := .$(HOST_DIRSEP)$(JSC_DIR)
+
+APP_STL := c++_static
+APP_CPPFLAGS := -std=c++1y -fexceptions -pthread
+
+NDK_TOOLCHAIN_VERSION := clang
@@ -0,0 +1,500 @@
+// Replays a trace recorded with `gl.startTraceEXP(path)` (see EXGLTrace.h)
+// against an offscreen EGL pbuffer and reports how long the GL thread side
+// takes, without JS or a view in the way:
+//
+//   adb push exgl-replay trace.bin /data/local/tmp
+//   adb shell /data/local/tmp/exgl-replay /data/local/tmp/trace.bin --iterations 5
+//
+// Options:
+//   --size WxH        size of the pbuffer, 1024x1024 by default
+//   --iterations N    number of times the whole trace is replayed, 3 by default
+//   --finish          glFinish() after each batch so GPU time is included
+//
+// Objects are replayed from the events recorded for them; buffers, textures,
+// framebuffers... are created on their first bind. Closures the recorder
+// couldn't describe are skipped and counted.
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES3/gl3.h>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "EXGLTrace.h"
+
+
+// --- Allocation counting -----------------------------------------------------
+
+static std::atomic<bool> countAllocations { false };
+static std::atomic<size_t> allocationCount { 0 };
+static std::atomic<size_t> allocationBytes { 0 };
+
+void *operator new(size_t size) {
+  if (countAllocations) {
+    ++allocationCount;
+    allocationBytes += size;
+  }
+  if (void *memory = malloc(size ? size : 1)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+  free(memory);
+}
+
+
+// --- Trace parsing -----------------------------------------------------------
+
+struct Reader {
+  const uint8_t *cursor;
+  const uint8_t *end;
+
+  template<typename T>
+  T get() {
+    T value;
+    if (cursor + sizeof(T) > end) {
+      fprintf(stderr, "exgl-replay: Truncated trace!\n");
+      exit(1);
+    }
+    memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return value;
+  }
+};
+
+struct Batch {
+  const uint8_t *ops;
+  const uint8_t *end;
+  uint32_t opCount;
+};
+
+class Replay {
+public:
+  // Functions of the trace, by index in the trace
+  std::vector<const EXGLTraceFunction *> functions;
+  std::vector<Batch> batches;
+
+  size_t opCount = 0;
+  size_t skippedClosures = 0;
+  size_t skippedCalls = 0;
+  size_t payloadBytes = 0;
+
+  void parse(const std::vector<uint8_t> &trace) {
+    Reader reader { trace.data(), trace.data() + trace.size() };
+    const size_t magicLength = sizeof(EXGL_TRACE_MAGIC) - 1;
+    if (trace.size() < magicLength || memcmp(trace.data(), EXGL_TRACE_MAGIC, magicLength) != 0) {
+      fprintf(stderr, "exgl-replay: Not an EXGL trace!\n");
+      exit(1);
+    }
+    reader.cursor += magicLength;
+
+    std::unordered_map<std::string, const EXGLTraceFunction *> known;
+    for (const auto &function : EXGLTraceFunctions()) {
+      known[function.name] = &function;
+    }
+    auto functionCount = reader.get<uint32_t>();
+    for (uint32_t i = 0; i < functionCount; ++i) {
+      auto length = reader.get<uint16_t>();
+      std::string name((const char *) reader.cursor, std::min<size_t>(length, reader.end - reader.cursor));
+      reader.cursor += name.size();
+      auto iter = known.find(name);
+      functions.push_back(iter == known.end() ? nullptr : iter->second);
+    }
+
+    while (reader.cursor < reader.end) {
+      auto type = reader.get<uint32_t>();
+      auto byteLength = reader.get<uint32_t>();
+      const uint8_t *recordEnd = reader.cursor + byteLength;
+      if (recordEnd > reader.end) {
+        fprintf(stderr, "exgl-replay: Truncated trace!\n");
+        exit(1);
+      }
+      if (type == (uint32_t) EXGLTraceRecord::Batch) {
+        Batch batch;
+        batch.opCount = reader.get<uint32_t>();
+        batch.ops = reader.cursor;
+        batch.end = recordEnd;
+        batches.push_back(batch);
+        opCount += batch.opCount;
+      }
+      reader.cursor = recordEnd;
+    }
+  }
+
+  void run(const Batch &batch) {
+    Reader reader { batch.ops, batch.end };
+    for (uint32_t i = 0; i < batch.opCount; ++i) {
+      auto opcode = (EXGLOpcode) reader.get<uint16_t>();
+      auto event = (EXGLTraceEvent) reader.get<uint16_t>();
+      auto byteLength = reader.get<uint32_t>();
+      Reader op { reader.cursor, reader.cursor + byteLength };
+      reader.cursor += byteLength;
+      if (opcode == EXGLOpcode::Closure) {
+        runClosure(event, op);
+      } else {
+        runCommand(opcode, op);
+      }
+    }
+  }
+
+  // Delete what an iteration created so that the next one starts over
+  void reset() {
+    for (auto &object : objects) {
+      GLuint name = object.second.name;
+      switch (object.second.kind) {
+        case Kind::Buffer: glDeleteBuffers(1, &name); break;
+        case Kind::Framebuffer: glDeleteFramebuffers(1, &name); break;
+        case Kind::Renderbuffer: glDeleteRenderbuffers(1, &name); break;
+        case Kind::Sampler: glDeleteSamplers(1, &name); break;
+        case Kind::Texture: glDeleteTextures(1, &name); break;
+        case Kind::TransformFeedback: glDeleteTransformFeedbacks(1, &name); break;
+        case Kind::VertexArray: glDeleteVertexArrays(1, &name); break;
+        case Kind::Program: glDeleteProgram(name); break;
+        case Kind::Shader: glDeleteShader(name); break;
+      }
+    }
+    objects.clear();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glUseProgram(0);
+  }
+
+private:
+  enum class Kind { Buffer, Framebuffer, Renderbuffer, Sampler, Texture, TransformFeedback,
+                    VertexArray, Program, Shader };
+
+  struct Object {
+    GLuint name;
+    Kind kind;
+  };
+
+  struct Generator {
+    void (*glGen)(GLsizei, GLuint *);
+    Kind kind;
+  };
+
+  // How to create the objects bound by each glBind* function
+  static const Generator *generatorFor(const char *bindFunction) {
+    static const std::unordered_map<std::string, Generator> generators {
+      { "glBindBuffer", { glGenBuffers, Kind::Buffer } },
+      { "glBindFramebuffer", { glGenFramebuffers, Kind::Framebuffer } },
+      { "glBindRenderbuffer", { glGenRenderbuffers, Kind::Renderbuffer } },
+      { "glBindSampler", { glGenSamplers, Kind::Sampler } },
+      { "glBindTexture", { glGenTextures, Kind::Texture } },
+      { "glBindTransformFeedback", { glGenTransformFeedbacks, Kind::TransformFeedback } },
+      { "glBindVertexArray", { glGenVertexArrays, Kind::VertexArray } },
+    };
+    auto iter = generators.find(bindFunction);
+    return iter == generators.end() ? nullptr : &iter->second;
+  }
+
+  std::unordered_map<uint32_t, Object> objects;
+
+  GLuint lookup(uint32_t exglObjId) const {
+    auto iter = objects.find(exglObjId);
+    return iter == objects.end() ? 0 : iter->second.name;
+  }
+
+  // The object bound by `function`, created on its first bind
+  GLuint lookupOrGenerate(const EXGLTraceFunction *function, uint32_t exglObjId) {
+    if (exglObjId == 0) {
+      return 0;
+    }
+    auto iter = objects.find(exglObjId);
+    if (iter != objects.end()) {
+      return iter->second.name;
+    }
+    auto generator = generatorFor(function->name);
+    if (!generator) {
+      return 0;
+    }
+    GLuint name = 0;
+    generator->glGen(1, &name);
+    objects[exglObjId] = { name, generator->kind };
+    return name;
+  }
+
+  const EXGLTraceFunction *function(uint32_t index) {
+    if (index >= functions.size() || !functions[index]) {
+      ++skippedCalls;
+      return nullptr;
+    }
+    return functions[index];
+  }
+
+  void runCommand(EXGLOpcode opcode, Reader &op) {
+    switch (opcode) {
+      case EXGLOpcode::Closure:
+        break;
+      case EXGLOpcode::Call: {
+        auto f = function(op.get<uint32_t>());
+        auto argc = op.get<uint32_t>();
+        double args[16] = {};
+        for (uint32_t i = 0; i < argc && i < 16; ++i) {
+          args[i] = op.get<double>();
+        }
+        if (f) {
+          f->trampoline(f->glFunc, args);
+        }
+        break;
+      }
+      case EXGLOpcode::BindObject: {
+        auto f = function(op.get<uint32_t>());
+        auto target = op.get<uint32_t>();
+        auto exglObjId = op.get<uint32_t>();
+        if (f) {
+          reinterpret_cast<void (*)(GLenum, GLuint)>(f->glFunc)(target, lookupOrGenerate(f, exglObjId));
+        }
+        break;
+      }
+      case EXGLOpcode::UseObject: {
+        auto f = function(op.get<uint32_t>());
+        auto exglObjId = op.get<uint32_t>();
+        if (f) {
+          reinterpret_cast<void (*)(GLuint)>(f->glFunc)(lookupOrGenerate(f, exglObjId));
+        }
+        break;
+      }
+      case EXGLOpcode::UniformFloatv:
+      case EXGLOpcode::UniformIntv:
+      case EXGLOpcode::UniformUintv: {
+        auto f = function(op.get<uint32_t>());
+        auto location = op.get<int32_t>();
+        auto count = op.get<int32_t>();
+        if (f) {
+          // Any of glUniform*v, they only differ by the type of the data
+          auto data = aligned(op);
+          reinterpret_cast<void (*)(GLint, GLsizei, const void *)>(f->glFunc)(location, count, data);
+        }
+        break;
+      }
+      case EXGLOpcode::UniformMatrixv: {
+        auto f = function(op.get<uint32_t>());
+        auto location = op.get<int32_t>();
+        auto count = op.get<int32_t>();
+        auto transpose = op.get<uint32_t>();
+        if (f) {
+          auto data = (const GLfloat *) aligned(op);
+          reinterpret_cast<void (*)(GLint, GLsizei, GLboolean, const GLfloat *)>(f->glFunc)(
+            location, count, (GLboolean) transpose, data);
+        }
+        break;
+      }
+      case EXGLOpcode::UniformBlock: {
+        auto args = op.get<EXGLUniformBlockArgs>();
+        auto entries = (const EXGLUniformBlockEntry *) aligned(op);
+        auto data = (const uint8_t *) (entries + args.entryCount);
+        for (uint32_t i = 0; i < args.entryCount; ++i) {
+          EXGLUploadUniform(entries[i].type, entries[i].location, entries[i].count, data + entries[i].offset);
+        }
+        break;
+      }
+    }
+  }
+
+  void runClosure(EXGLTraceEvent event, Reader &op) {
+    if (event == EXGLTraceEvent::Opaque) {
+      ++skippedClosures;
+      return;
+    }
+    double args[8] = {};
+    auto argc = op.get<uint32_t>();
+    for (uint32_t i = 0; i < argc && i < 8; ++i) {
+      args[i] = op.get<double>();
+    }
+    auto a = [&](int i) { return (GLuint) args[i]; };
+    const uint8_t *data = op.cursor < op.end ? op.cursor : nullptr;
+    size_t dataLength = op.end - op.cursor;
+    payloadBytes += dataLength;
+
+    switch (event) {
+      case EXGLTraceEvent::Opaque:
+        break;
+      case EXGLTraceEvent::CreateShader:
+        objects[a(0)] = { glCreateShader(a(1)), Kind::Shader };
+        break;
+      case EXGLTraceEvent::CreateProgram:
+        objects[a(0)] = { glCreateProgram(), Kind::Program };
+        break;
+      case EXGLTraceEvent::ShaderSource: {
+        auto source = (const char *) data;
+        auto length = (GLint) dataLength;
+        glShaderSource(lookup(a(0)), 1, &source, &length);
+        break;
+      }
+      case EXGLTraceEvent::AttachShader:
+        glAttachShader(lookup(a(0)), lookup(a(1)));
+        break;
+      case EXGLTraceEvent::BindAttribLocation: {
+        std::string name((const char *) data, dataLength);
+        glBindAttribLocation(lookup(a(0)), a(1), name.c_str());
+        break;
+      }
+      case EXGLTraceEvent::LinkProgram:
+        glLinkProgram(lookup(a(0)));
+        break;
+      case EXGLTraceEvent::BufferData:
+        glBufferData(a(0), (GLsizeiptr) args[1], data, a(2));
+        break;
+      case EXGLTraceEvent::BufferSubData:
+        glBufferSubData(a(0), (GLintptr) args[1], dataLength, data);
+        break;
+      case EXGLTraceEvent::TexImage2D:
+        glTexImage2D(a(0), args[1], args[2], args[3], args[4], args[5], a(6), a(7), data);
+        break;
+      case EXGLTraceEvent::TexSubImage2D:
+        if (data) {
+          glTexSubImage2D(a(0), args[1], args[2], args[3], args[4], args[5], a(6), a(7), data);
+        }
+        break;
+      case EXGLTraceEvent::FramebufferTexture2D:
+        glFramebufferTexture2D(a(0), a(1), a(2), lookup(a(3)), args[4]);
+        break;
+      case EXGLTraceEvent::FramebufferRenderbuffer:
+        glFramebufferRenderbuffer(a(0), a(1), a(2), lookup(a(3)));
+        break;
+    }
+  }
+
+  // The rest of `op`, copied if it isn't 8-byte aligned
+  const void *aligned(Reader &op) {
+    if (((uintptr_t) op.cursor & 7) == 0) {
+      return op.cursor;
+    }
+    scratch.resize((op.end - op.cursor + 7) / 8);
+    memcpy(scratch.data(), op.cursor, op.end - op.cursor);
+    return scratch.data();
+  }
+
+  std::vector<uint64_t> scratch;
+};
+
+
+// --- Main --------------------------------------------------------------------
+
+static bool createContext(EGLint width, EGLint height) {
+  EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+    return false;
+  }
+  const EGLint configAttribs[] = {
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT_KHR,
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+    EGL_DEPTH_SIZE, 16, EGL_STENCIL_SIZE, 8,
+    EGL_NONE,
+  };
+  EGLConfig config;
+  EGLint configCount = 0;
+  if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+    return false;
+  }
+  const EGLint surfaceAttribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+  EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+  const EGLint contextAttribs[] = { EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE };
+  EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+  return surface != EGL_NO_SURFACE && context != EGL_NO_CONTEXT &&
+    eglMakeCurrent(display, surface, surface, context);
+}
+
+static double percentile(const std::vector<double> &sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  return sorted[std::min(sorted.size() - 1, (size_t) (p * sorted.size()))];
+}
+
+int main(int argc, char **argv) {
+  const char *path = nullptr;
+  int width = 1024, height = 1024, iterations = 3;
+  bool finish = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+      sscanf(argv[++i], "%dx%d", &width, &height);
+    } else if (!strcmp(argv[i], "--iterations") && i + 1 < argc) {
+      iterations = std::max(1, atoi(argv[++i]));
+    } else if (!strcmp(argv[i], "--finish")) {
+      finish = true;
+    } else {
+      path = argv[i];
+    }
+  }
+  if (!path) {
+    fprintf(stderr, "usage: exgl-replay <trace> [--size WxH] [--iterations N] [--finish]\n");
+    return 1;
+  }
+
+  // Read all of it upfront, file IO isn't part of the measurements
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    fprintf(stderr, "exgl-replay: Couldn't open '%s'!\n", path);
+    return 1;
+  }
+  std::vector<uint8_t> trace;
+  uint8_t chunk[1 << 16];
+  size_t read;
+  while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    trace.insert(trace.end(), chunk, chunk + read);
+  }
+  fclose(file);
+
+  Replay replay;
+  replay.parse(trace);
+  if (!createContext(width, height)) {
+    fprintf(stderr, "exgl-replay: Couldn't create an OpenGL ES 3 pbuffer context!\n");
+    return 1;
+  }
+
+  using Clock = std::chrono::steady_clock;
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  std::vector<double> batchMs;
+  batchMs.reserve(replay.batches.size() * iterations);
+  double totalMs = 0;
+
+  countAllocations = true;
+  for (int iteration = 0; iteration < iterations; ++iteration) {
+    for (const auto &batch : replay.batches) {
+      auto start = Clock::now();
+      replay.run(batch);
+      if (finish) {
+        glFinish();
+      }
+      double ms = Milliseconds(Clock::now() - start).count();
+      batchMs.push_back(ms);
+      totalMs += ms;
+    }
+    glFinish();
+    replay.reset();
+  }
+  countAllocations = false;
+
+  std::vector<double> sorted(batchMs);
+  std::sort(sorted.begin(), sorted.end());
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  size_t replayedOps = replay.opCount * iterations;
+
+  printf("trace:      %zu batches, %zu ops, %zu bytes\n", replay.batches.size(), replay.opCount, trace.size());
+  printf("skipped:    %zu opaque closures, %zu calls of unknown functions\n",
+         replay.skippedClosures / iterations, replay.skippedCalls / iterations);
+  printf("flush:      %.3f ms total, per batch mean %.3f / p50 %.3f / p95 %.3f / max %.3f ms\n",
+         totalMs / iterations, totalMs / std::max<size_t>(1, batchMs.size()),
+         percentile(sorted, 0.5), percentile(sorted, 0.95), sorted.empty() ? 0 : sorted.back());
+  printf("throughput: %.0f ops/s, %.1f MB/s of uploads\n",
+         replayedOps / (totalMs / 1000), replay.payloadBytes / (totalMs / 1000) / (1 << 20));
+  printf("memory:     %zu allocations (%zu bytes) per iteration, peak RSS %ld KB\n",
+         allocationCount / iterations, allocationBytes / iterations, usage.ru_maxrss);
+  return 0;
+}